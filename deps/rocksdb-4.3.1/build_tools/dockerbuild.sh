@@ -0,0 +1,2 @@
+#!/bin/bash
+docker run -v $PWD:/rocks -w /rocks buildpack-deps make
@@ -0,0 +1,38 @@
+// Copyright (c) 2014, Facebook, Inc.  All rights reserved.
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#ifndef ROCKSDB_LITE
+
+#include "util/options_sanity_check.h"
+
+namespace rocksdb {
+
+namespace {
+OptionsSanityCheckLevel SanityCheckLevelHelper(
+    const std::unordered_map<std::string, OptionsSanityCheckLevel>& smap,
+    const std::string& name) {
+  auto iter = smap.find(name);
+  return iter != smap.end() ? iter->second : kSanityLevelExactMatch;
+}
+}
+
+OptionsSanityCheckLevel DBOptionSanityCheckLevel(
+    const std::string& option_name) {
+  return SanityCheckLevelHelper(sanity_level_db_options, option_name);
+}
+
+OptionsSanityCheckLevel CFOptionSanityCheckLevel(
+    const std::string& option_name) {
+  return SanityCheckLevelHelper(sanity_level_cf_options, option_name);
+}
+
+OptionsSanityCheckLevel BBTOptionSanityCheckLevel(
+    const std::string& option_name) {
+  return SanityCheckLevelHelper(sanity_level_bbt_options, option_name);
+}
+
+}  // namespace rocksdb
+
+#endif  // !ROCKSDB_LITE
@@ -0,0 +1,15 @@
+//  Copyright (c) 2013, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+#pragma once
+#ifndef ROCKSDB_LITE
+#include <string>
+
+namespace rocksdb {
+namespace test {
+extern bool TEST_GetFileSizeFromBackupFileName(const std::string full_name,
+                                               uint64_t* size);
+}  // namespace test
+}  // namespace rocksdb
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,280 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bgjobs.hpp"
+#include "thread/lock_guard.hpp"
+#include <unistd.h>
+#include <string.h>
+
+OP_NAMESPACE_BEGIN
+
+    struct BackgroundJobSetting
+    {
+            const char* name;
+            BackgroundJobPriority priority;
+            uint32 max_running;
+    };
+    static const BackgroundJobSetting kJobSettings[BGJOB_TYPE_MAX] = {
+            { "expire", BGJOB_PRIORITY_HIGH, 1 },
+            { "lazyfree", BGJOB_PRIORITY_HIGH, 1 },
+            { "list-compact", BGJOB_PRIORITY_NORMAL, 1 },
+            { "compaction", BGJOB_PRIORITY_LOW, 1 },
+            { "snapshot", BGJOB_PRIORITY_LOW, 1 } };
+
+    BackgroundJobs::BackgroundJobs() :
+            m_cpu_share(100), m_max_bytes_per_sec(0), m_latency_target(0), m_io_rate(0), m_io_tokens(0), m_io_refill_ustime(0), m_io_bytes(
+                    0), m_io_wait_micros(0), m_foreground_p99(0)
+    {
+        memset(m_classes, 0, sizeof(m_classes));
+        for (uint32 i = 0; i < BGJOB_TYPE_MAX; i++)
+        {
+            m_classes[i].name = kJobSettings[i].name;
+            m_classes[i].priority = kJobSettings[i].priority;
+            m_classes[i].max_running = kJobSettings[i].max_running;
+        }
+    }
+
+    BackgroundJobs& BackgroundJobs::GetSingleton()
+    {
+        static BackgroundJobs jobs;
+        return jobs;
+    }
+
+    int BackgroundJobs::GetJobType(const std::string& name)
+    {
+        for (uint32 i = 0; i < BGJOB_TYPE_MAX; i++)
+        {
+            if (!strcasecmp(name.c_str(), kJobSettings[i].name))
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void BackgroundJobs::SetCpuShare(int64 percent)
+    {
+        m_cpu_share = (percent <= 0 || percent > 100) ? 100 : percent;
+    }
+
+    void BackgroundJobs::SetMaxMBPerSec(int64 mb)
+    {
+        SetMaxBytesPerSec(mb > 0 ? mb * 1024 * 1024 : 0);
+    }
+
+    void BackgroundJobs::SetMaxBytesPerSec(int64 bytes)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        m_max_bytes_per_sec = bytes > 0 ? bytes : 0;
+        if (m_io_rate <= 0 || m_io_rate > m_max_bytes_per_sec || m_latency_target <= 0)
+        {
+            m_io_rate = m_max_bytes_per_sec;
+        }
+    }
+
+    void BackgroundJobs::SetLatencyTarget(int64 micros)
+    {
+        m_latency_target = micros > 0 ? micros : 0;
+    }
+
+    bool BackgroundJobs::CanStart(BackgroundJobClass& job, uint64 now)
+    {
+        if (job.running >= job.max_running || now < job.next_start_ustime)
+        {
+            return false;
+        }
+        if (job.priority == BGJOB_PRIORITY_LOW)
+        {
+            for (uint32 i = 0; i < BGJOB_TYPE_MAX; i++)
+            {
+                if (m_classes[i].priority == BGJOB_PRIORITY_HIGH && m_classes[i].running > 0)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool BackgroundJobs::Begin(BackgroundJobType type, bool wait)
+    {
+        BackgroundJobClass& job = m_classes[type];
+        while (true)
+        {
+            {
+                LockGuard<SpinMutexLock> guard(m_lock);
+                if (job.paused)
+                {
+                    job.skipped++;
+                    return false;
+                }
+                if (CanStart(job, get_current_epoch_micros()))
+                {
+                    job.running++;
+                    return true;
+                }
+                if (!wait)
+                {
+                    job.skipped++;
+                    return false;
+                }
+            }
+            usleep(10 * 1000);
+        }
+        return false;
+    }
+
+    void BackgroundJobs::End(BackgroundJobType type, uint64 start_ustime)
+    {
+        uint64 now = get_current_epoch_micros();
+        uint64 cost = now > start_ustime ? now - start_ustime : 0;
+        int64 share = m_cpu_share;
+        LockGuard<SpinMutexLock> guard(m_lock);
+        BackgroundJobClass& job = m_classes[type];
+        job.running--;
+        job.runs++;
+        job.total_micros += cost;
+        if (cost > job.max_micros)
+        {
+            job.max_micros = cost;
+        }
+        if (job.priority != BGJOB_PRIORITY_HIGH && share < 100)
+        {
+            /*
+             * idle for (100 - share)% of the time, e.g. a 50% share waits as long as the job ran
+             */
+            job.next_start_ustime = now + cost * (100 - share) / share;
+        }
+    }
+
+    bool BackgroundJobs::Pause(BackgroundJobType type, bool pause)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        bool changed = m_classes[type].paused != pause;
+        m_classes[type].paused = pause;
+        return changed;
+    }
+
+    /*
+     * charges never wait longer than this, the debt is paid by the following requests
+     */
+    static const uint64 kMaxIOWaitMicros = 1000000;
+
+    uint64 BackgroundJobs::Acquire(uint64 bytes, bool high)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        m_io_bytes += bytes;
+        if (m_max_bytes_per_sec <= 0 || m_io_rate <= 0)
+        {
+            return 0;
+        }
+        uint64 now = get_current_epoch_micros();
+        if (now > m_io_refill_ustime)
+        {
+            uint64 elapsed = now - m_io_refill_ustime < 1000000 ? now - m_io_refill_ustime : 1000000;
+            m_io_tokens += (int64) (elapsed * m_io_rate / 1000000);
+            if (m_io_tokens > m_io_rate)
+            {
+                m_io_tokens = m_io_rate; //at most one second burst
+            }
+            m_io_refill_ustime = now;
+        }
+        m_io_tokens -= (int64) bytes;
+        if (high || m_io_tokens >= 0)
+        {
+            return 0;
+        }
+        uint64 wait = (uint64) (-m_io_tokens) * 1000000 / m_io_rate;
+        if (wait > kMaxIOWaitMicros)
+        {
+            wait = kMaxIOWaitMicros;
+        }
+        m_io_wait_micros += wait;
+        return wait;
+    }
+
+    void BackgroundJobs::Request(uint64 bytes, bool high)
+    {
+        uint64 wait = Acquire(bytes, high);
+        if (wait > 0)
+        {
+            usleep(wait);
+        }
+    }
+
+    void BackgroundJobs::TuneRate()
+    {
+        int64 max_rate = m_max_bytes_per_sec;
+        int64 target = m_latency_target;
+        uint64 p99 = 0;
+        if (max_rate > 0 && target > 0)
+        {
+            CostHistogram hist;
+            m_foreground_cost.GetHistogram(hist);
+            m_foreground_cost.ClearHistogram();
+            p99 = cost_hist_percentile(hist, 99);
+        }
+        LockGuard<SpinMutexLock> guard(m_lock);
+        m_foreground_p99 = p99;
+        if (max_rate <= 0 || target <= 0)
+        {
+            m_io_rate = max_rate;
+            return;
+        }
+        int64 step = max_rate / 16 > 0 ? max_rate / 16 : 1;
+        if (p99 > (uint64) target)
+        {
+            m_io_rate = m_io_rate / 2 > step ? m_io_rate / 2 : step;
+        }
+        else
+        {
+            m_io_rate = m_io_rate + step < max_rate ? m_io_rate + step : max_rate;
+        }
+    }
+
+    int64 BackgroundJobs::GetRate()
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        return m_io_rate;
+    }
+
+    void BackgroundJobs::GetIOStats(uint64& bytes, uint64& wait_micros, uint64& foreground_p99)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        bytes = m_io_bytes;
+        wait_micros = m_io_wait_micros;
+        foreground_p99 = m_foreground_p99;
+    }
+
+    void BackgroundJobs::GetClasses(std::vector<BackgroundJobClass>& classes)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        classes.assign(m_classes, m_classes + BGJOB_TYPE_MAX);
+    }
+
+OP_NAMESPACE_END
@@ -0,0 +1,153 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BGJOBS_HPP_
+#define BGJOBS_HPP_
+#include "common/common.hpp"
+#include "util/time_helper.hpp"
+#include "thread/spin_mutex_lock.hpp"
+#include "statistics.hpp"
+#include <vector>
+
+OP_NAMESPACE_BEGIN
+
+    enum BackgroundJobType
+    {
+        BGJOB_EXPIRE = 0, BGJOB_LAZYFREE, BGJOB_LIST_COMPACT, BGJOB_COMPACTION, BGJOB_SNAPSHOT, BGJOB_TYPE_MAX
+    };
+
+    enum BackgroundJobPriority
+    {
+        BGJOB_PRIORITY_HIGH = 0, BGJOB_PRIORITY_NORMAL, BGJOB_PRIORITY_LOW
+    };
+
+    struct BackgroundJobClass
+    {
+            const char* name;
+            BackgroundJobPriority priority;
+            uint32 max_running;
+            uint32 running;
+            bool paused;
+            uint64 runs;
+            uint64 skipped;
+            uint64 total_micros;
+            uint64 max_micros;
+            uint64 next_start_ustime; //cpu share back off
+    };
+
+    /*
+     * Coordinates the background work of the cron threads, compactions & snapshots:
+     *  - a paused job class starts no new jobs(BGJOBS PAUSE/RESUME),
+     *  - at most 'max_running' jobs of a class run at once,
+     *  - normal & low priority classes back off after every run to use at most 'bgjobs-cpu-share' percent of a cpu,
+     *    low priority jobs also wait for running high priority jobs,
+     *  - engine compactions/flushes, snapshot writes, sst ingestion, lazyfree reclaim & slot migration charge one
+     *    token bucket of 'bgjobs-max-mb-per-sec', with 'bgjobs-latency-target' the bucket shrinks while the p99 of
+     *    the foreground commands is above the target & grows back otherwise.
+     */
+    class BackgroundJobs
+    {
+        private:
+            SpinMutexLock m_lock;
+            BackgroundJobClass m_classes[BGJOB_TYPE_MAX];
+            volatile int64 m_cpu_share;
+            volatile int64 m_max_bytes_per_sec;
+            volatile int64 m_latency_target;
+            int64 m_io_rate; //current bytes per second, tuned within (0, m_max_bytes_per_sec]
+            int64 m_io_tokens; //negative while the charged bytes are ahead of the rate
+            uint64 m_io_refill_ustime;
+            uint64 m_io_bytes;
+            uint64 m_io_wait_micros;
+            uint64 m_foreground_p99;
+            CostTrack m_foreground_cost;
+            bool CanStart(BackgroundJobClass& job, uint64 now);
+            BackgroundJobs();
+        public:
+            static BackgroundJobs& GetSingleton();
+            /*
+             * -1 for an unknown class name
+             */
+            static int GetJobType(const std::string& name);
+            void SetCpuShare(int64 percent);
+            void SetMaxMBPerSec(int64 mb);
+            void SetMaxBytesPerSec(int64 bytes);
+            /*
+             * target p99 of the foreground commands in microseconds, 0 keeps the rate at its maximum
+             */
+            void SetLatencyTarget(int64 micros);
+            /*
+             * Returns false if the job may not start now, with 'wait' it blocks until the job may start unless
+             * its class is paused.
+             */
+            bool Begin(BackgroundJobType type, bool wait = false);
+            void End(BackgroundJobType type, uint64 start_ustime);
+            bool Pause(BackgroundJobType type, bool pause);
+            /*
+             * Charges the written bytes & returns the microseconds the caller should wait, high priority writes(memtable
+             * flushes) only charge.
+             */
+            uint64 Acquire(uint64 bytes, bool high = false);
+            /*
+             * Acquire & sleep, for callers which may block their thread
+             */
+            void Request(uint64 bytes, bool high = false);
+            void AddForegroundLatency(uint64 micros)
+            {
+                m_foreground_cost.AddCost(micros);
+            }
+            /*
+             * Called every second, halves the rate while the foreground p99 of the last second is above the target,
+             * raises it by 1/16 of the maximum otherwise.
+             */
+            void TuneRate();
+            int64 GetRate();
+            void GetIOStats(uint64& bytes, uint64& wait_micros, uint64& foreground_p99);
+            void GetClasses(std::vector<BackgroundJobClass>& classes);
+    };
+
+    struct BackgroundJobScope
+    {
+            BackgroundJobType type;
+            bool started;
+            uint64 start;
+            BackgroundJobScope(BackgroundJobType t, bool wait = false) :
+                    type(t), started(BackgroundJobs::GetSingleton().Begin(t, wait)), start(get_current_epoch_micros())
+            {
+            }
+            ~BackgroundJobScope()
+            {
+                if (started)
+                {
+                    BackgroundJobs::GetSingleton().End(type, start);
+                }
+            }
+    };
+
+OP_NAMESPACE_END
+
+#endif /* BGJOBS_HPP_ */
@@ -0,0 +1,701 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "db/db.hpp"
+#include <algorithm>
+
+/*
+ * Redis cluster compatible slot routing(cluster-enabled). The slot table is built from 'cluster-slots' and changed by
+ * CLUSTER SETSLOT, nodes are named by their addresses. Replicas of a node serve reads of READONLY connections, changes
+ * of the slot table are published on kClusterTopologyChannel. Keys are laid out by slot with key-codec-version 3, which
+ * makes the keys of a slot(CLUSTER COUNTKEYSINSLOT/GETKEYSINSLOT) one range scan.
+ */
+OP_NAMESPACE_BEGIN
+
+    static const char* kClusterSyntaxError = "Syntax error, try CLUSTER (INFO | SLOTS | NODES | KEYSLOT key | COUNTKEYSINSLOT slot | "
+            "GETKEYSINSLOT slot count | SETSLOT slot (NODE addr | MIGRATING addr | IMPORTING addr | STABLE))";
+    static const char* kClusterTopologyChannel = "__cluster__:topology";
+
+    void Ardb::InitClusterSlots()
+    {
+        WriteLockGuard<BigReaderLock> guard(m_cluster_lock);
+        m_cluster_nodes.clear();
+        m_cluster_replicas.clear();
+        m_cluster_migrating.clear();
+        m_cluster_importing.clear();
+        std::string myself = GetConf().cluster_announce_addr;
+        if (myself.empty())
+        {
+            myself = "127.0.0.1:" + stringfromll(GetConf().PrimaryPort());
+        }
+        m_cluster_nodes.push_back(myself);
+        m_cluster_replicas.resize(1);
+        for (uint32 i = 0; i < kClusterSlots; i++)
+        {
+            m_cluster_slots[i] = kClusterNoNode;
+        }
+        const ClusterSlotRangeArray& ranges = GetConf().cluster_slots;
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            uint16 node = ranges[i].addr.empty() ? 0 : GetClusterNode(ranges[i].addr);
+            for (uint32 slot = ranges[i].start; slot <= ranges[i].end; slot++)
+            {
+                m_cluster_slots[slot] = node;
+            }
+            StringArray& replicas = m_cluster_replicas[node];
+            for (size_t j = 0; j < ranges[i].replicas.size(); j++)
+            {
+                if (std::find(replicas.begin(), replicas.end(), ranges[i].replicas[j]) == replicas.end())
+                {
+                    replicas.push_back(ranges[i].replicas[j]);
+                }
+            }
+        }
+        m_cluster_epoch++;
+        if (GetConf().cluster_enabled && get_key_codec_version() != KEY_CODEC_V3)
+        {
+            WARN_LOG("Keys are not laid out by cluster slot without key-codec-version 3, CLUSTER COUNTKEYSINSLOT/GETKEYSINSLOT are not available.");
+        }
+    }
+
+    /*
+     * Index of the node, added if unknown. Called with the cluster write lock held.
+     */
+    uint16 Ardb::GetClusterNode(const std::string& addr)
+    {
+        for (size_t i = 0; i < m_cluster_nodes.size(); i++)
+        {
+            if (m_cluster_nodes[i] == addr)
+            {
+                return (uint16) i;
+            }
+        }
+        m_cluster_nodes.push_back(addr);
+        m_cluster_replicas.resize(m_cluster_nodes.size());
+        return (uint16) (m_cluster_nodes.size() - 1);
+    }
+
+    /*
+     * True if this server replicates the node, by 'cluster-slots' or by being the slave of its address. Called with
+     * the cluster lock held.
+     */
+    bool Ardb::IsClusterReplicaOf(uint16 node)
+    {
+        if (node == 0 || node >= m_cluster_nodes.size())
+        {
+            return false;
+        }
+        const ArdbConfig& conf = GetConf();
+        if (!conf.master_host.empty() && m_cluster_nodes[node] == conf.master_host + ":" + stringfromll(conf.master_port))
+        {
+            return true;
+        }
+        const StringArray& replicas = m_cluster_replicas[node];
+        return std::find(replicas.begin(), replicas.end(), m_cluster_nodes[0]) != replicas.end();
+    }
+
+    /*
+     * Key arguments of a command, commands without keys(or with keys in their own syntax like MIGRATE) have none.
+     */
+    void Ardb::GetCommandKeys(RedisCommandFrame& cmd, StringArray& keys)
+    {
+        const ArgumentArray& args = cmd.GetArguments();
+        size_t first = 0, last = args.size(), step = 1;
+        switch (cmd.GetType())
+        {
+            case REDIS_CMD_PING:
+            case REDIS_CMD_MULTI:
+            case REDIS_CMD_DISCARD:
+            case REDIS_CMD_EXEC:
+            case REDIS_CMD_UNWATCH:
+            case REDIS_CMD_INFO:
+            case REDIS_CMD_LASTSAVE:
+            case REDIS_CMD_SLOWLOG:
+            case REDIS_CMD_DBSIZE:
+            case REDIS_CMD_FLUSHDB:
+            case REDIS_CMD_FLUSHALL:
+            case REDIS_CMD_ECHO:
+            case REDIS_CMD_QUIT:
+            case REDIS_CMD_WAIT:
+            case REDIS_CMD_CDC:
+            case REDIS_CMD_SELECT:
+            case REDIS_CMD_KEYS:
+            case REDIS_CMD_KEYSCOUNT:
+            case REDIS_CMD_SCRIPT:
+            case REDIS_CMD_RANDOMKEY:
+            case REDIS_CMD_SCAN:
+            case REDIS_CMD_AUTH:
+            case REDIS_CMD_MIGRATE:
+            case REDIS_CMD_MIGRATEDB:
+            case REDIS_CMD_RESTORECHUNK:
+            case REDIS_CMD_RESTOREDB:
+            case REDIS_CMD_CACHEMEMORY:
+            case REDIS_CMD_ASKING:
+            case REDIS_CMD_READONLY:
+            case REDIS_CMD_READWRITE:
+            case REDIS_CMD_IDXCREATE:
+            case REDIS_CMD_IDXDROP:
+            case REDIS_CMD_IDXLIST:
+            case REDIS_CMD_IDXRANGE:
+            {
+                return;
+            }
+            case REDIS_CMD_MSET:
+            case REDIS_CMD_MSET2:
+            case REDIS_CMD_MSETNX:
+            case REDIS_CMD_MSETNX2:
+            {
+                step = 2;
+                break;
+            }
+            case REDIS_CMD_BLPOP:
+            case REDIS_CMD_BRPOP:
+            case REDIS_CMD_BRPOPLPUSH:
+            {
+                last = args.size() - 1;
+                break;
+            }
+            case REDIS_CMD_SMOVE:
+            {
+                last = 2;
+                break;
+            }
+            case REDIS_CMD_XREAD:
+            {
+                /*
+                 * [COUNT n] [BLOCK ms] STREAMS key... id...
+                 */
+                while (first < args.size() && strcasecmp(args[first].c_str(), "streams"))
+                {
+                    first++;
+                }
+                first++;
+                last = first < args.size() ? first + (args.size() - first) / 2 : first;
+                break;
+            }
+            case REDIS_CMD_BITOP:
+            case REDIS_CMD_BITOPCUNT:
+            {
+                first = 1;
+                break;
+            }
+            case REDIS_CMD_EVAL:
+            case REDIS_CMD_EVALSHA:
+            case REDIS_CMD_ZINTERSTORE:
+            case REDIS_CMD_ZUNIONSTORE:
+            {
+                /*
+                 * script|dest numkeys key...
+                 */
+                uint32 numkeys = 0;
+                if (!string_touint32(args[1], numkeys) || numkeys > args.size() - 2)
+                {
+                    return;
+                }
+                if (cmd.GetType() == REDIS_CMD_ZINTERSTORE || cmd.GetType() == REDIS_CMD_ZUNIONSTORE)
+                {
+                    keys.push_back(args[0]);
+                }
+                first = 2;
+                last = 2 + numkeys;
+                break;
+            }
+            case REDIS_CMD_DEL:
+            case REDIS_CMD_UNLINK:
+            case REDIS_CMD_EXISTS:
+            case REDIS_CMD_WATCH:
+            case REDIS_CMD_MGET:
+            case REDIS_CMD_RENAME:
+            case REDIS_CMD_RENAMENX:
+            case REDIS_CMD_RPOPLPUSH:
+            case REDIS_CMD_SDIFF:
+            case REDIS_CMD_SDIFFCOUNT:
+            case REDIS_CMD_SDIFFSTORE:
+            case REDIS_CMD_SINTER:
+            case REDIS_CMD_SINTERCOUNT:
+            case REDIS_CMD_SINTERSTORE:
+            case REDIS_CMD_SUNION:
+            case REDIS_CMD_SUNIONCOUNT:
+            case REDIS_CMD_SUNIONSTORE:
+            case REDIS_CMD_PFCOUNT:
+            case REDIS_CMD_PFMERGE:
+            {
+                break;
+            }
+            default:
+            {
+                last = args.empty() ? 0 : 1;
+                break;
+            }
+        }
+        for (size_t i = first; i < last; i += step)
+        {
+            keys.push_back(args[i]);
+        }
+    }
+
+    /*
+     * Reply -MOVED/-ASK/-CROSSSLOT/-TRYAGAIN/-CLUSTERDOWN & return true if the command can not be served here.
+     * Keys of a slot migrating to another node are served while they are still here, new keys are asked there.
+     * Reads of READONLY connections('readonly') on slots of a node this server replicates are served here.
+     */
+    bool Ardb::RedirectClusterCommand(Context& ctx, RedisCommandFrame& cmd, bool asking, bool readonly)
+    {
+        StringArray keys;
+        GetCommandKeys(cmd, keys);
+        if (keys.empty())
+        {
+            return false;
+        }
+        RedisReply& reply = ctx.GetReply();
+        uint16 slot = key_hash_slot(keys[0].data(), keys[0].size());
+        for (size_t i = 1; i < keys.size(); i++)
+        {
+            if (key_hash_slot(keys[i].data(), keys[i].size()) != slot)
+            {
+                reply.SetErrorReason("-CROSSSLOT Keys in request don't hash to the same slot");
+                return true;
+            }
+        }
+        std::string addr;
+        bool migrating = false;
+        {
+            ReadLockGuard<BigReaderLock> guard(m_cluster_lock);
+            uint16 node = m_cluster_slots[slot];
+            if (node == 0)
+            {
+                ClusterSlotNodeTable::iterator found = m_cluster_migrating.find(slot);
+                if (found == m_cluster_migrating.end())
+                {
+                    return false;
+                }
+                migrating = true;
+                addr = m_cluster_nodes[found->second];
+            }
+            else if (asking && m_cluster_importing.count(slot) > 0)
+            {
+                return false;
+            }
+            else if (node == kClusterNoNode)
+            {
+                reply.SetErrorReason("-CLUSTERDOWN Hash slot not served");
+                return true;
+            }
+            else if (readonly && IsClusterReplicaOf(node))
+            {
+                return false;
+            }
+            else
+            {
+                addr = m_cluster_nodes[node];
+            }
+        }
+        if (!migrating)
+        {
+            reply.SetErrorReason("-MOVED " + stringfromll(slot) + " " + addr);
+            return true;
+        }
+        size_t missing = 0;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            KeyObject meta(ctx.ns, KEY_META, keys[i]);
+            if (!m_engine->Exists(ctx, meta))
+            {
+                missing++;
+            }
+        }
+        if (missing == 0)
+        {
+            return false;
+        }
+        if (missing < keys.size())
+        {
+            reply.SetErrorReason("-TRYAGAIN Multiple keys request during rehashing of slot");
+        }
+        else
+        {
+            reply.SetErrorReason("-ASK " + stringfromll(slot) + " " + addr);
+        }
+        return true;
+    }
+
+    static void split_node_addr(const std::string& addr, std::string& host, int64& port)
+    {
+        size_t pos = addr.rfind(':');
+        port = 0;
+        if (pos == std::string::npos || !string_toint64(addr.substr(pos + 1), port))
+        {
+            host = addr;
+            return;
+        }
+        host = addr.substr(0, pos);
+    }
+
+    static std::string cluster_node_id(const std::string& addr)
+    {
+        return sha1_sum_data(addr.data(), addr.size());
+    }
+
+    void Ardb::ClusterSlotsReply(RedisReply& reply)
+    {
+        reply.ReserveMember(0);
+        ReadLockGuard<BigReaderLock> guard(m_cluster_lock);
+        uint32 start = 0;
+        while (start < kClusterSlots)
+        {
+            uint16 node = m_cluster_slots[start];
+            uint32 end = start;
+            while (end + 1 < kClusterSlots && m_cluster_slots[end + 1] == node)
+            {
+                end++;
+            }
+            if (node != kClusterNoNode)
+            {
+                std::string host;
+                int64 port;
+                split_node_addr(m_cluster_nodes[node], host, port);
+                RedisReply& range = reply.AddMember();
+                range.ReserveMember(0);
+                range.AddMember().SetInteger(start);
+                range.AddMember().SetInteger(end);
+                RedisReply& master = range.AddMember();
+                master.ReserveMember(0);
+                master.AddMember().SetString(host);
+                master.AddMember().SetInteger(port);
+                master.AddMember().SetString(cluster_node_id(m_cluster_nodes[node]));
+                const StringArray& replicas = m_cluster_replicas[node];
+                for (size_t i = 0; i < replicas.size(); i++)
+                {
+                    split_node_addr(replicas[i], host, port);
+                    RedisReply& replica = range.AddMember();
+                    replica.ReserveMember(0);
+                    replica.AddMember().SetString(host);
+                    replica.AddMember().SetInteger(port);
+                    replica.AddMember().SetString(cluster_node_id(replicas[i]));
+                }
+            }
+            start = end + 1;
+        }
+    }
+
+    /*
+     * CLUSTER NODES lines, slot owners are masters & their replicas slaves, all in the current topology epoch.
+     */
+    std::string Ardb::ClusterNodesInfo()
+    {
+        ReadLockGuard<BigReaderLock> guard(m_cluster_lock);
+        std::vector<std::string> slots(m_cluster_nodes.size());
+        uint32 start = 0;
+        while (start < kClusterSlots)
+        {
+            uint16 node = m_cluster_slots[start];
+            uint32 end = start;
+            while (end + 1 < kClusterSlots && m_cluster_slots[end + 1] == node)
+            {
+                end++;
+            }
+            if (node != kClusterNoNode)
+            {
+                slots[node].append(" ").append(stringfromll(start));
+                if (end > start)
+                {
+                    slots[node].append("-").append(stringfromll(end));
+                }
+            }
+            start = end + 1;
+        }
+        ClusterSlotNodeTable::iterator it = m_cluster_migrating.begin();
+        for (; it != m_cluster_migrating.end(); it++)
+        {
+            slots[0].append(" [").append(stringfromll(it->first)).append("->-").append(cluster_node_id(m_cluster_nodes[it->second])).append("]");
+        }
+        for (it = m_cluster_importing.begin(); it != m_cluster_importing.end(); it++)
+        {
+            slots[0].append(" [").append(stringfromll(it->first)).append("-<-").append(cluster_node_id(m_cluster_nodes[it->second])).append("]");
+        }
+        std::string info;
+        std::string epoch = stringfromll(m_cluster_epoch);
+        for (size_t i = 0; i < m_cluster_nodes.size(); i++)
+        {
+            std::string host;
+            int64 port;
+            std::string role = " master -";
+            for (size_t j = 1; i == 0 && j < m_cluster_nodes.size(); j++)
+            {
+                if (IsClusterReplicaOf(j))
+                {
+                    role = " slave " + cluster_node_id(m_cluster_nodes[j]);
+                    break;
+                }
+            }
+            split_node_addr(m_cluster_nodes[i], host, port);
+            info.append(cluster_node_id(m_cluster_nodes[i])).append(" ").append(m_cluster_nodes[i]).append("@").append(stringfromll(port + 10000));
+            info.append(i == 0 ? " myself," : " ").append(role.substr(1)).append(" 0 0 ").append(epoch).append(" connected").append(slots[i]).append("\n");
+        }
+        for (size_t i = 0; i < m_cluster_replicas.size(); i++)
+        {
+            for (size_t j = 0; j < m_cluster_replicas[i].size(); j++)
+            {
+                const std::string& replica = m_cluster_replicas[i][j];
+                if (std::find(m_cluster_nodes.begin(), m_cluster_nodes.end(), replica) != m_cluster_nodes.end())
+                {
+                    continue;
+                }
+                std::string host;
+                int64 port;
+                split_node_addr(replica, host, port);
+                info.append(cluster_node_id(replica)).append(" ").append(replica).append("@").append(stringfromll(port + 10000));
+                info.append(" slave ").append(cluster_node_id(m_cluster_nodes[i])).append(" 0 0 ").append(epoch).append(" connected\n");
+            }
+        }
+        return info;
+    }
+
+    /*
+     * Count the keys of the slot, or add up to 'limit' of them to 'keys' if not NULL. One range scan of the slot,
+     * only with KEY_CODEC_V3.
+     */
+    /*
+     * Count a change of the slot table & push the CLUSTER NODES lines to the subscribers of kClusterTopologyChannel,
+     * called without the cluster lock held.
+     */
+    void Ardb::ClusterTopologyChanged(Context& ctx)
+    {
+        {
+            WriteLockGuard<BigReaderLock> guard(m_cluster_lock);
+            m_cluster_epoch++;
+        }
+        PublishMessage(ctx, kClusterTopologyChannel, ClusterNodesInfo());
+    }
+
+    int Ardb::ClusterKeysInSlot(Context& ctx, uint16 slot, int64 limit, RedisReply* keys)
+    {
+        int64 count = 0;
+        KeyObject start(ctx.ns, KEY_META, "");
+        start.SetSlot(slot);
+        IterateOptions options;
+        options.streaming = true;
+        options.lower_bound = start;
+        if (slot + 1 < (int) kClusterSlots)
+        {
+            options.upper_bound = start;
+            options.upper_bound.SetSlot(slot + 1);
+        }
+        Iterator* iter = m_engine->Find(ctx, start, options);
+        while (NULL != iter && iter->Valid() && (NULL == keys || count < limit))
+        {
+            KeyObject& k = iter->Key();
+            if (k.GetSlot() != slot)
+            {
+                break;
+            }
+            if (k.GetType() == KEY_META)
+            {
+                if (NULL != keys)
+                {
+                    keys->AddMember().SetString(k.GetKey());
+                }
+                count++;
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        return count;
+    }
+
+    int Ardb::Cluster(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        if (!GetConf().cluster_enabled)
+        {
+            reply.SetErrorReason("This instance has cluster support disabled");
+            return 0;
+        }
+        std::string subcmd = string_tolower(cmd.GetArguments()[0]);
+        uint32 slot = 0;
+        if ((subcmd == "countkeysinslot" || subcmd == "getkeysinslot" || subcmd == "setslot") && (cmd.GetArguments().size() < 2
+                || !string_touint32(cmd.GetArguments()[1], slot) || slot >= kClusterSlots))
+        {
+            reply.SetErrorReason("Invalid or out of range slot");
+            return 0;
+        }
+        if (subcmd == "info" && cmd.GetArguments().size() == 1)
+        {
+            uint32 assigned = 0;
+            uint64 epoch = 0;
+            std::vector<bool> owners;
+            {
+                ReadLockGuard<BigReaderLock> guard(m_cluster_lock);
+                epoch = m_cluster_epoch;
+                owners.resize(m_cluster_nodes.size());
+                for (uint32 i = 0; i < kClusterSlots; i++)
+                {
+                    if (m_cluster_slots[i] != kClusterNoNode)
+                    {
+                        assigned++;
+                        owners[m_cluster_slots[i]] = true;
+                    }
+                }
+            }
+            std::string info;
+            info.append("cluster_state:").append(assigned == kClusterSlots ? "ok" : "fail").append("\r\n");
+            info.append("cluster_slots_assigned:").append(stringfromll(assigned)).append("\r\n");
+            info.append("cluster_slots_ok:").append(stringfromll(assigned)).append("\r\n");
+            info.append("cluster_slots_pfail:0\r\ncluster_slots_fail:0\r\n");
+            info.append("cluster_known_nodes:").append(stringfromll(owners.size())).append("\r\n");
+            info.append("cluster_size:").append(stringfromll(std::count(owners.begin(), owners.end(), true))).append("\r\n");
+            info.append("cluster_current_epoch:").append(stringfromll(epoch)).append("\r\n");
+            info.append("cluster_my_epoch:").append(stringfromll(epoch)).append("\r\n");
+            reply.SetString(info);
+        }
+        else if (subcmd == "slots" && cmd.GetArguments().size() == 1)
+        {
+            ClusterSlotsReply(reply);
+        }
+        else if (subcmd == "nodes" && cmd.GetArguments().size() == 1)
+        {
+            reply.SetString(ClusterNodesInfo());
+        }
+        else if (subcmd == "keyslot" && cmd.GetArguments().size() == 2)
+        {
+            const std::string& key = cmd.GetArguments()[1];
+            reply.SetInteger(key_hash_slot(key.data(), key.size()));
+        }
+        else if ((subcmd == "countkeysinslot" && cmd.GetArguments().size() == 2) || (subcmd == "getkeysinslot" && cmd.GetArguments().size() == 3))
+        {
+            if (get_key_codec_version() != KEY_CODEC_V3)
+            {
+                reply.SetErrorReason("keys are laid out by slot only with key-codec-version 3");
+                return 0;
+            }
+            if (subcmd == "countkeysinslot")
+            {
+                reply.SetInteger(ClusterKeysInSlot(ctx, slot, 0, NULL));
+                return 0;
+            }
+            int64 limit;
+            if (!string_toint64(cmd.GetArguments()[2], limit) || limit < 0)
+            {
+                reply.SetErrorReason("Invalid number of keys");
+                return 0;
+            }
+            reply.ReserveMember(0);
+            ClusterKeysInSlot(ctx, slot, limit, &reply);
+        }
+        else if (subcmd == "setslot" && cmd.GetArguments().size() >= 3)
+        {
+            std::string action = string_tolower(cmd.GetArguments()[2]);
+            if ((action == "stable" && cmd.GetArguments().size() != 3) || (action != "stable" && cmd.GetArguments().size() != 4))
+            {
+                reply.SetErrorReason(kClusterSyntaxError);
+                return 0;
+            }
+            bool changed = false;
+            {
+                WriteLockGuard<BigReaderLock> guard(m_cluster_lock);
+                uint16 node = 0;
+                if (action != "stable" && strcasecmp(cmd.GetArguments()[3].c_str(), "myself"))
+                {
+                    node = GetClusterNode(cmd.GetArguments()[3]);
+                }
+                if (action == "stable")
+                {
+                    m_cluster_migrating.erase(slot);
+                    m_cluster_importing.erase(slot);
+                }
+                else if (action == "node")
+                {
+                    changed = m_cluster_slots[slot] != node;
+                    m_cluster_slots[slot] = node;
+                    m_cluster_migrating.erase(slot);
+                    m_cluster_importing.erase(slot);
+                }
+                else if (action == "migrating" && m_cluster_slots[slot] == 0 && node != 0)
+                {
+                    m_cluster_migrating[slot] = node;
+                }
+                else if (action == "importing" && m_cluster_slots[slot] != 0 && node != 0)
+                {
+                    m_cluster_importing[slot] = node;
+                }
+                else
+                {
+                    reply.SetErrorReason("Can not " + action + " slot " + stringfromll(slot) + " in this state");
+                    return 0;
+                }
+            }
+            if (changed)
+            {
+                ClusterTopologyChanged(ctx);
+            }
+            reply.SetStatusCode(STATUS_OK);
+        }
+        else
+        {
+            reply.SetErrorReason(kClusterSyntaxError);
+        }
+        return 0;
+    }
+
+    int Ardb::Asking(Context& ctx, RedisCommandFrame& cmd)
+    {
+        if (!GetConf().cluster_enabled)
+        {
+            ctx.GetReply().SetErrorReason("This instance has cluster support disabled");
+            return 0;
+        }
+        ctx.asking = true;
+        ctx.GetReply().SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
+    int Ardb::ReadOnly(Context& ctx, RedisCommandFrame& cmd)
+    {
+        if (!GetConf().cluster_enabled)
+        {
+            ctx.GetReply().SetErrorReason("This instance has cluster support disabled");
+            return 0;
+        }
+        ctx.readonly = true;
+        ctx.GetReply().SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
+    int Ardb::ReadWrite(Context& ctx, RedisCommandFrame& cmd)
+    {
+        if (!GetConf().cluster_enabled)
+        {
+            ctx.GetReply().SetErrorReason("This instance has cluster support disabled");
+            return 0;
+        }
+        ctx.readonly = false;
+        ctx.GetReply().SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
+OP_NAMESPACE_END
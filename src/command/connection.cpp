@@ -57,6 +57,17 @@ OP_NAMESPACE_BEGIN
             ctx.GetReply().SetErrorReason("Can NOT select TTL DB.");
             return 0;
         }
+        if(!strcmp(ZSET_STORE_NAMESPACE, cmd.GetArguments()[0].c_str()) || !strcmp(LAZYFREE_DB_NAMESPACE, cmd.GetArguments()[0].c_str())
+                || !strcmp(INDEX_DB_NAMESPACE, cmd.GetArguments()[0].c_str()))
+        {
+            ctx.GetReply().SetErrorReason("Can NOT select internal DB.");
+            return 0;
+        }
+        if (has_prefix(cmd.GetArguments()[0], SHADOW_NAMESPACE_PREFIX))
+        {
+            ctx.GetReply().SetErrorReason("Can NOT select internal DB.");
+            return 0;
+        }
         ctx.ns.SetString(cmd.GetArguments()[0], false);
         ctx.GetReply().SetStatusCode(STATUS_OK);
         return 0;
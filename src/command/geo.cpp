@@ -29,9 +29,12 @@
 
 #include "db/db.hpp"
 #include "geo/geohash_helper.hpp"
+#include "util/vecops.hpp"
 #include <algorithm>
 #include <math.h>
 #define GEO_STEP_MAX 26
+#define GEO_COVER_CELLS_MAX 32
+#define GEO_FILTER_BATCH 256
 namespace ardb
 {
 
@@ -380,6 +383,73 @@ namespace ardb
         return v1.distance > v2.distance;
     }
 
+    /*
+     * score range [min, max) of one covering cell aligned to GEO_STEP_MAX
+     */
+    struct GeoScanRange
+    {
+            uint64 min;
+            uint64 max;
+            double min_distance;
+    };
+    typedef std::vector<GeoScanRange> GeoScanRangeArray;
+
+    static bool less_by_min_distance(const GeoScanRange& v1, const GeoScanRange& v2)
+    {
+        return v1.min_distance < v2.min_distance;
+    }
+
+    static bool less_by_range_min(const GeoScanRange& v1, const GeoScanRange& v2)
+    {
+        return v1.min < v2.min;
+    }
+
+    /*
+     * Decoded candidates of a radius search, the bounding box of the circle drops most of the ones out of it
+     * by the vectorized prefilter before the haversine distance of the rest is computed.
+     */
+    struct GeoCandidateBatch
+    {
+            GeoPointArray candidates;
+            std::vector<double> lons;
+            std::vector<double> lats;
+            std::vector<uint8_t> keeps;
+            double lon_delta;
+            double lat_delta;
+            void Add(GeoPoint& point)
+            {
+                candidates.push_back(point);
+                lons.push_back(point.x);
+                lats.push_back(point.y);
+            }
+            void Filter(double x, double y, double radius, GeoPointArray& points)
+            {
+                if (candidates.empty())
+                {
+                    return;
+                }
+                keeps.resize(candidates.size());
+                size_t kept = vecops_geo_box_filter(&lons[0], &lats[0], candidates.size(), x, y, lon_delta, lat_delta, &keeps[0]);
+                for (size_t i = 0; i < candidates.size() && kept > 0; i++)
+                {
+                    if (!keeps[i])
+                    {
+                        continue;
+                    }
+                    kept--;
+                    GeoPoint& point = candidates[i];
+                    point.distance = GeoHashHelper::GetWGS84Distance(x, y, point.x, point.y);
+                    if (point.distance < radius)
+                    {
+                        points.push_back(point);
+                    }
+                }
+                candidates.clear();
+                lons.clear();
+                lats.clear();
+            }
+    };
+
     /*
      *  GEORADIUS key x y              <GeoOptions>
      *  GEORADIUSBYMEMBER key member   <GeoOptions>
@@ -469,59 +539,77 @@ namespace ardb
         }
 
         /*
-         * 1. Get all neighbors area by radius
+         * 1. Cover the circle with geohash cells of mixed steps, each one is a score range of the zset
          */
-        GeoHashBitsSet ress;
-        GeoHashHelper::GetAreasByRadius(GEO_WGS84_TYPE, y, x, radius, ress);
-
+        GeoHashCoverCellArray cells;
+        GeoHashHelper::GetCoveringCells(GEO_WGS84_TYPE, y, x, radius, GEO_STEP_MAX, GEO_COVER_CELLS_MAX, cells);
+        GeoScanRangeArray ranges;
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            GeoHashBits next = cells[i].hash;
+            next.bits++;
+            GeoScanRange range;
+            range.min = GeoHashHelper::AllignHashBits(GEO_STEP_MAX, cells[i].hash);
+            range.max = GeoHashHelper::AllignHashBits(GEO_STEP_MAX, next);
+            range.min_distance = cells[i].min_distance;
+            ranges.push_back(range);
+        }
         /*
-         * 2. Merge neighbors areas if possible to avoid more tree search
+         * 2. With ascending order & a limit, visit the nearest ranges first so that the scan may stop early,
+         *    otherwise merge adjacent ranges & visit them in score order to avoid more tree search
          */
-        std::vector<ZRangeSpec> range_array;
-        GeoHashBitsSet::iterator rit = ress.begin();
-        typedef TreeMap<uint64, uint64>::Type HashRangeMap;
-        HashRangeMap tmp;
-        while (rit != ress.end())
+        size_t nearest_limit = 0;
+        if (!options.nosort && options.asc && options.limit > 0)
         {
-            GeoHashBits& hash = *rit;
-            GeoHashBits next = hash;
-            next.bits++;
-            tmp[GeoHashHelper::AllignHashBits(GEO_STEP_MAX, hash)] = GeoHashHelper::AllignHashBits(GEO_STEP_MAX, next);
-            rit++;
+            nearest_limit = options.offset + options.limit;
+            std::sort(ranges.begin(), ranges.end(), less_by_min_distance);
         }
-        HashRangeMap::iterator tit = tmp.begin();
-        HashRangeMap::iterator nit = tmp.begin();
-        nit++;
-        while (tit != tmp.end())
+        else
         {
-            ZRangeSpec range;
-            range.contain_min = true;
-            range.contain_max = true;
-            range.min.SetInt64(tit->first);
-            range.max.SetInt64(tit->second);
-            while (nit != tmp.end() && nit->first == range.max.GetInt64())
+            std::sort(ranges.begin(), ranges.end(), less_by_range_min);
+            size_t merged = 0;
+            for (size_t i = 1; i < ranges.size(); i++)
+            {
+                if (ranges[i].min <= ranges[merged].max)
+                {
+                    if (ranges[i].max > ranges[merged].max)
+                    {
+                        ranges[merged].max = ranges[i].max;
+                    }
+                }
+                else
+                {
+                    ranges[++merged] = ranges[i];
+                }
+            }
+            if (!ranges.empty())
             {
-                range.max.SetInt64(nit->second);
-                nit++;
-                tit++;
+                ranges.resize(merged + 1);
             }
-            range_array.push_back(range);
-            nit++;
-            tit++;
         }
 
         /*
-         * 3. Get all data by iterate areas
+         * 3. Get all data by iterate ranges
          */
         GeoPointArray points;
-        std::vector<ZRangeSpec>::iterator hit = range_array.begin();
+        GeoCandidateBatch batch;
+        GeoHashHelper::GetWGS84BoundingBox(x, y, radius, batch.lon_delta, batch.lat_delta);
         Iterator* iter = NULL;
-        //printf("###%d \n", range_array.size());
-        while (hit != range_array.end())
+        for (size_t i = 0; i < ranges.size(); i++)
         {
-            ZRangeSpec& range = *hit;
+            GeoScanRange& range = ranges[i];
+            if (nearest_limit > 0 && points.size() >= nearest_limit)
+            {
+                GeoPointArray::iterator nth = points.begin() + (nearest_limit - 1);
+                std::nth_element(points.begin(), nth, points.end(), less_by_distance);
+                points.erase(nth + 1, points.end());
+                if (range.min_distance > nth->distance)
+                {
+                    break;
+                }
+            }
             KeyObject zmember(ctx.ns, KEY_ZSET_SORT, cmd.GetArguments()[0]);
-            zmember.SetZSetScore(range.min.GetFloat64());
+            zmember.SetZSetScore((double) range.min);
             if (NULL == iter)
             {
                 iter = m_engine->Find(ctx, zmember);
@@ -530,7 +618,6 @@ namespace ardb
             {
                 iter->Jump(zmember);
             }
-            //printf("###%.2f\n", range.min.GetFloat64());
             while (iter->Valid())
             {
                 KeyObject& zkey = iter->Key(true);
@@ -538,33 +625,29 @@ namespace ardb
                 {
                     break;
                 }
-                int inrange = range.InRange(zkey.GetZSetScore());
-                if (0 == inrange)
+                uint64 score = (uint64) zkey.GetZSetScore();
+                if (score >= range.max)
+                {
+                    break;
+                }
+                GeoPoint point;
+                point.score = (int64_t) score;
+                if (GeoHashHelper::GetXYByHash(GEO_WGS84_TYPE, GEO_STEP_MAX, score, point.x, point.y))
                 {
-                    GeoPoint point;
-                    point.score = (int64_t) zkey.GetZSetScore();
                     point.value = zkey.GetZSetMember();
-                    //printf("###Find %lld %s\n", point.score, point.value.AsString().c_str());
-                    if (GeoHashHelper::GetXYByHash(GEO_WGS84_TYPE, GEO_STEP_MAX, (uint64) point.score, point.x, point.y))
+                    batch.Add(point);
+                    if (batch.candidates.size() >= GEO_FILTER_BATCH)
                     {
-                        point.distance = GeoHashHelper::GetWGS84Distance(x, y, point.x, point.y);
-                        if (point.distance < radius)
-                        {
-                            points.push_back(point);
-                        }
+                        batch.Filter(x, y, radius, points);
                     }
                 }
-                else if (inrange > 0)
-                {
-                    break;
-                }
                 iter->Next();
             }
-            if (!iter->Valid())
+            batch.Filter(x, y, radius, points);
+            if (!iter->Valid() && 0 == nearest_limit)
             {
                 break;
             }
-            hit++;
         }
         DELETE(iter);
 
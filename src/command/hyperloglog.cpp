@@ -31,6 +31,7 @@
 
 #include "db/db.hpp"
 #include "util/sds.h"
+#include "util/bitops.hpp"
 
 #include <stdint.h>
 #include <math.h>
@@ -515,6 +516,34 @@ int hllDenseAdd(uint8_t *registers, unsigned char *ele, size_t elesize)
     }
 }
 
+/* Unpack the 6 bits dense registers into one byte per register, working on
+ * 3 bytes holding 4 registers at a time. Unlike HLL_DENSE_GET_REGISTER it
+ * never reads past the last register byte. */
+void hllDenseUnpack(uint8_t *dst, const uint8_t *registers)
+{
+    for (int i = 0; i < HLL_REGISTERS; i += 4)
+    {
+        uint8_t b0 = registers[0], b1 = registers[1], b2 = registers[2];
+        dst[i] = b0 & HLL_REGISTER_MAX;
+        dst[i + 1] = ((b0 >> 6) | (b1 << 2)) & HLL_REGISTER_MAX;
+        dst[i + 2] = ((b1 >> 4) | (b2 << 4)) & HLL_REGISTER_MAX;
+        dst[i + 3] = b2 >> 2;
+        registers += 3;
+    }
+}
+
+/* The reverse of hllDenseUnpack(), 'src' values must fit in 6 bits. */
+void hllDensePack(uint8_t *registers, const uint8_t *src)
+{
+    for (int i = 0; i < HLL_REGISTERS; i += 4)
+    {
+        registers[0] = src[i] | (src[i + 1] << 6);
+        registers[1] = (src[i + 1] >> 2) | (src[i + 2] << 4);
+        registers[2] = (src[i + 2] >> 4) | (src[i + 3] << 2);
+        registers += 3;
+    }
+}
+
 /* Compute SUM(2^-reg) in the dense representation.
  * PE is an array with a pre-computer table of values 2^-reg indexed by reg.
  * As a side effect the integer pointed by 'ezp' is set to the number
@@ -1054,54 +1083,37 @@ double hllSparseSum(uint8_t *sparse, int sparselen, double *PE, int *ezp, int *i
  * internally as speedup for PFCOUNT with multiple keys. */
 double hllRawSum(uint8_t *registers, double *PE, int *ezp)
 {
+    /* Build a histogram of the register values first, the 4 interleaved
+     * tables avoid store-to-load stalls when neighbor registers are equal,
+     * and all zero words are counted at once. */
+    uint32_t hist[4][HLL_REGISTER_MAX + 1];
+    uint32_t zero_words = 0;
+    const uint64_t *word = (const uint64_t*) registers;
+    int j, ez;
     double E = 0;
-    int j, ez = 0;
-    uint64_t *word = (uint64_t*) registers;
-    uint8_t *bytes;
 
+    memset(hist, 0, sizeof(hist));
     for (j = 0; j < HLL_REGISTERS / 8; j++)
     {
-        if (*word == 0)
-        {
-            ez += 8;
-        }
-        else
+        uint64_t w = word[j];
+        if (w == 0)
         {
-            bytes = (uint8_t*) word;
-            if (bytes[0])
-                E += PE[bytes[0]];
-            else
-                ez++;
-            if (bytes[1])
-                E += PE[bytes[1]];
-            else
-                ez++;
-            if (bytes[2])
-                E += PE[bytes[2]];
-            else
-                ez++;
-            if (bytes[3])
-                E += PE[bytes[3]];
-            else
-                ez++;
-            if (bytes[4])
-                E += PE[bytes[4]];
-            else
-                ez++;
-            if (bytes[5])
-                E += PE[bytes[5]];
-            else
-                ez++;
-            if (bytes[6])
-                E += PE[bytes[6]];
-            else
-                ez++;
-            if (bytes[7])
-                E += PE[bytes[7]];
-            else
-                ez++;
+            zero_words++;
+            continue;
         }
-        word++;
+        hist[0][w & HLL_REGISTER_MAX]++;
+        hist[1][(w >> 8) & HLL_REGISTER_MAX]++;
+        hist[2][(w >> 16) & HLL_REGISTER_MAX]++;
+        hist[3][(w >> 24) & HLL_REGISTER_MAX]++;
+        hist[0][(w >> 32) & HLL_REGISTER_MAX]++;
+        hist[1][(w >> 40) & HLL_REGISTER_MAX]++;
+        hist[2][(w >> 48) & HLL_REGISTER_MAX]++;
+        hist[3][(w >> 56) & HLL_REGISTER_MAX]++;
+    }
+    ez = zero_words * 8 + hist[0][0] + hist[1][0] + hist[2][0] + hist[3][0];
+    for (j = 1; j <= HLL_REGISTER_MAX; j++)
+    {
+        E += (hist[0][j] + hist[1][j] + hist[2][j] + hist[3][j]) * PE[j];
     }
     E += ez; /* 2^(-reg[j]) is 1 when m is 0, add it 'ez' times for every
      zero register in the HLL. */
@@ -1221,25 +1233,20 @@ int hllAdd(std::string& value, unsigned char *ele, size_t elesize, uint32_t hll_
  *
  * If the HyperLogLog is sparse and is found to be invalid, REDIS_ERR
  * is returned, otherwise the function always succeeds. */
-int hllMerge(uint8_t *max, std::string& hll)
+int hllMerge(uint8_t *max, const uint8_t *hll, size_t hlllen)
 {
-    struct hllhdr *hdr = (struct hllhdr *) &(hll[0]);
+    struct hllhdr *hdr = (struct hllhdr *) hll;
     int i;
 
     if (hdr->encoding == HLL_DENSE)
     {
-        uint8_t val;
-
-        for (i = 0; i < HLL_REGISTERS; i++)
-        {
-            HLL_DENSE_GET_REGISTER(val, hdr->registers, i);
-            if (val > max[i])
-                max[i] = val;
-        }
+        uint8_t regs[HLL_REGISTERS];
+        hllDenseUnpack(regs, hdr->registers);
+        bitops_max(max, regs, HLL_REGISTERS);
     }
     else
     {
-        uint8_t *p = (uint8_t*) &(hll[0]), *end = p + hll.size();
+        const uint8_t *p = hll, *end = p + hlllen;
         long runlen, regval;
 
         p += HLL_HDR_SIZE;
@@ -1262,6 +1269,8 @@ int hllMerge(uint8_t *max, std::string& hll)
             {
                 runlen = HLL_SPARSE_VAL_LEN(p);
                 regval = HLL_SPARSE_VAL_VALUE(p);
+                if (i + runlen > HLL_REGISTERS)
+                    return -1;
                 while (runlen--)
                 {
                     if (regval > max[i])
@@ -1316,12 +1325,12 @@ void createHLLObject(std::string& value)
 /* Check if the object is a String with a valid HLL representation.
  * Return REDIS_OK if this is true, otherwise reply to the client
  * with an error and return REDIS_ERR. */
-bool isHLLObjectOrReply(std::string& value)
+bool isHLLObject(const uint8_t *value, size_t len)
 {
-    struct hllhdr *hdr;
-    if (value.size() < sizeof(*hdr))
+    const struct hllhdr *hdr;
+    if (len < sizeof(*hdr))
         goto invalid;
-    hdr = (struct hllhdr *) (&value[0]);
+    hdr = (const struct hllhdr *) value;
 
     /* Magic should be "HYLL". */
     if (hdr->magic[0] != 'H' || hdr->magic[1] != 'Y' || hdr->magic[2] != 'L' || hdr->magic[3] != 'L')
@@ -1331,7 +1340,7 @@ bool isHLLObjectOrReply(std::string& value)
         goto invalid;
 
     /* Dense representation string length should match exactly. */
-    if (hdr->encoding == HLL_DENSE && value.size() != HLL_DENSE_SIZE)
+    if (hdr->encoding == HLL_DENSE && len != HLL_DENSE_SIZE)
         goto invalid;
 
     /* All tests passed. */
@@ -1342,6 +1351,18 @@ bool isHLLObjectOrReply(std::string& value)
     return false;
 }
 
+bool isHLLObjectOrReply(std::string& value)
+{
+    return isHLLObject((const uint8_t*) value.data(), value.size());
+}
+
+/* Same as above on a value decoded by the engine, which is checked in
+ * place without copying it out. */
+static bool isHLLValue(const Data& value)
+{
+    return value.IsString() && isHLLObject((const uint8_t*) value.CStr(), value.StringLength());
+}
+
 namespace ardb
 {
     int Ardb::MergePFAdd(Context& ctx, const KeyObject& key, ValueObject& meta, const DataArray& ms, int* up)
@@ -1460,18 +1481,18 @@ namespace ardb
             {
                 return 0;
             }
-            std::string hllvalue;
-            meta.GetStringValue().ToString(hllvalue);
-            if (!isHLLObjectOrReply(hllvalue))
+            /*
+             * the value is read in place, it is copied out only to write back the cached cardinality
+             */
+            const Data& value = meta.GetStringValue();
+            if (!isHLLValue(value))
             {
                 reply.SetErrCode(ERR_INVALID_HLL_STRING);
                 return 0;
             }
-            struct hllhdr *hdr;
-            uint64_t card = 0;
+            struct hllhdr *hdr = (struct hllhdr *) value.CStr();
 
             /* Check if the cached cardinality is valid. */
-            hdr = (struct hllhdr *) (&hllvalue[0]);
             if (HLL_VALID_CACHE(hdr))
             {
                 /* Just return the cached value. */
@@ -1488,12 +1509,15 @@ namespace ardb
             {
                 int invalid = 0;
                 /* Recompute it and update the cached value. */
-                card = hllCount(hdr, hllvalue.size(), &invalid);
+                card = hllCount(hdr, value.StringLength(), &invalid);
                 if (invalid)
                 {
                     reply.SetErrCode(ERR_CORRUPTED_HLL_OBJECT);
                     return 0;
                 }
+                std::string hllvalue;
+                value.ToString(hllvalue);
+                hdr = (struct hllhdr *) (&hllvalue[0]);
                 hdr->card[0] = card & 0xff;
                 hdr->card[1] = (card >> 8) & 0xff;
                 hdr->card[2] = (card >> 16) & 0xff;
@@ -1519,41 +1543,81 @@ namespace ardb
             reply.SetInteger(card);
             return 0;
         }
-        uint8_t max[HLL_HDR_SIZE + HLL_REGISTERS], *registers;
 
-        /* Compute an HLL with M[i] = MAX(M[i]_j). */
-        memset(max, 0, sizeof(max));
-        struct hllhdr *hdr = (struct hllhdr*) max;
-        hdr->encoding = HLL_RAW; /* Special internal-only encoding. */
-        registers = max + HLL_HDR_SIZE;
-        for (uint32 i = 0; i < cmd.GetArguments().size(); i++)
+        /*
+         * Multiple keys have no stored cache, the merged cardinality is cached in memory by the
+         * key list together with a digest of every source value, a hit needs no register merge.
+         */
+        size_t numkeys = cmd.GetArguments().size();
+        ValueObjectArray hlls(numkeys);
+        std::string ns, cache_key;
+        ctx.ns.ToString(ns);
+        uint32 nslen = ns.size();
+        cache_key.append((const char*) &nslen, sizeof(nslen)).append(ns);
+        uint64_t digest = numkeys;
+        for (uint32 i = 0; i < numkeys; i++)
         {
-            ValueObject hll;
-            if (!CheckMeta(ctx, cmd.GetArguments()[i], KEY_STRING, hll))
+            const std::string& keystr = cmd.GetArguments()[i];
+            uint32 keylen = keystr.size();
+            cache_key.append((const char*) &keylen, sizeof(keylen)).append(keystr);
+            if (!CheckMeta(ctx, keystr, KEY_STRING, hlls[i]))
             {
                 return 0;
             }
-            if (hll.GetType() == 0)
+            uint64_t h = 0;
+            if (hlls[i].GetType() != 0)
             {
-                continue;
+                const Data& value = hlls[i].GetStringValue();
+                if (!isHLLValue(value))
+                {
+                    reply.SetErrCode(ERR_INVALID_HLL_STRING);
+                    return 0;
+                }
+                h = MurmurHash64A(value.CStr(), value.StringLength(), i);
             }
-            std::string hllvalue;
-            hll.GetStringValue().ToString(hllvalue);
-            if (!isHLLObjectOrReply(hllvalue))
+            digest ^= h + 0x9e3779b97f4a7c15ULL + (digest << 6) + (digest >> 2);
+        }
+        {
+            LockGuard<SpinMutexLock> guard(m_pfcount_cache_lock);
+            PFCountCacheEntry cached;
+            if (m_pfcount_cache.Get(cache_key, cached) && cached.digest == digest)
             {
-                reply.SetErrCode(ERR_INVALID_HLL_STRING);
+                reply.SetInteger(cached.card);
                 return 0;
             }
+        }
 
+        uint8_t max[HLL_HDR_SIZE + HLL_REGISTERS], *registers;
+
+        /* Compute an HLL with M[i] = MAX(M[i]_j). */
+        memset(max, 0, sizeof(max));
+        struct hllhdr *hdr = (struct hllhdr*) max;
+        hdr->encoding = HLL_RAW; /* Special internal-only encoding. */
+        registers = max + HLL_HDR_SIZE;
+        for (uint32 i = 0; i < numkeys; i++)
+        {
+            if (hlls[i].GetType() == 0)
+            {
+                continue;
+            }
             /* Merge with this HLL with our 'max' HHL by setting max[i]
              * to MAX(max[i],hll[i]). */
-            if (hllMerge(registers, hllvalue) == -1)
+            const Data& value = hlls[i].GetStringValue();
+            if (hllMerge(registers, (const uint8_t*) value.CStr(), value.StringLength()) == -1)
             {
                 reply.SetErrCode(ERR_CORRUPTED_HLL_OBJECT);
                 return 0;
             }
         }
         card = hllCount(hdr, sizeof(max), NULL);
+        {
+            LockGuard<SpinMutexLock> guard(m_pfcount_cache_lock);
+            PFCountCacheEntry cached;
+            cached.digest = digest;
+            cached.card = card;
+            PFCountCache::CacheEntry erased;
+            m_pfcount_cache.Insert(cache_key, cached, erased);
+        }
         reply.SetInteger(card);
         return 0;
     }
@@ -1563,7 +1627,6 @@ namespace ardb
         RedisReply& reply = ctx.GetReply();
         uint8_t max[HLL_REGISTERS];
         struct hllhdr *hdr;
-        uint32 j = 0;
 
         /* Compute an HLL with M[i] = MAX(M[i]_j).
          * We we the maximum into the max array of registers. We'll write
@@ -1588,7 +1651,7 @@ namespace ardb
         {
             if (errs[i] != 0 && errs[i] != ERR_ENTRY_NOT_EXIST)
             {
-                reply.SetErrCode(err);
+                reply.SetErrCode(errs[i]);
                 return 0;
             }
             if (vals[i].GetType() != 0 && vals[i].GetType() != KEY_STRING)
@@ -1596,59 +1659,38 @@ namespace ardb
                 reply.SetErrCode(ERR_WRONG_TYPE);
                 return 0;
             }
-            std::string hllvalue;
             if (vals[i].GetType() == 0)
             {
                 continue;
             }
-            else
+            const Data& value = vals[i].GetStringValue();
+            if (!isHLLValue(value))
             {
-                vals[i].GetStringValue().ToString(hllvalue);
-                if (!isHLLObjectOrReply(hllvalue))
-                {
-                    reply.SetErrCode(ERR_INVALID_HLL_STRING);
-                    return 0;
-                }
-                /* Merge with this HLL with our 'max' HHL by setting max[i]
-                 * to MAX(max[i],hll[i]). */
-                if (hllMerge(max, hllvalue) == -1)
-                {
-                    reply.SetErrCode(ERR_CORRUPTED_HLL_OBJECT);
-                    return 0;
-                }
+                reply.SetErrCode(ERR_INVALID_HLL_STRING);
+                return 0;
+            }
+            /* Merge with this HLL with our 'max' HHL by setting max[i]
+             * to MAX(max[i],hll[i]). */
+            if (hllMerge(max, (const uint8_t*) value.CStr(), value.StringLength()) == -1)
+            {
+                reply.SetErrCode(ERR_CORRUPTED_HLL_OBJECT);
+                return 0;
             }
         }
-        std::string hllvalue;
         if (vals[0].GetType() == 0)
         {
             vals[0].SetType(KEY_STRING);
-            createHLLObject(hllvalue);
-        }
-        else
-        {
-            vals[0].GetStringValue().ToString(hllvalue);
         }
 
-        /* Only support dense objects as destination. */
-        sds hlls = sdsnewlen(hllvalue.data(), hllvalue.size());
-        if (hllSparseToDense(&hlls) == -1)
-        {
-            sdsfree(hlls);
-            reply.SetErrCode(ERR_CORRUPTED_HLL_OBJECT);
-            return 0;
-        }
-
-        /* Write the resulting HLL to the destination HLL registers and
-         * invalidate the cached value. */
-        hdr = (struct hllhdr *) hlls;
-        for (j = 0; j < HLL_REGISTERS; j++)
-        {
-            HLL_DENSE_SET_REGISTER(hdr->registers, j, max[j]);
-        }
+        /* Only support dense objects as destination, so the merged registers
+         * are packed straight into a new dense value and the cached value is
+         * invalidated. */
+        std::string hllvalue(HLL_DENSE_SIZE, 0);
+        hdr = (struct hllhdr *) (&hllvalue[0]);
+        memcpy(hdr->magic, "HYLL", 4);
+        hdr->encoding = HLL_DENSE;
+        hllDensePack(hdr->registers, max);
         HLL_INVALIDATE_CACHE(hdr);
-        hllvalue.clear();
-        hllvalue.append(hlls, sdslen(hlls));
-        sdsfree(hlls);
         vals[0].GetStringValue().SetString(hllvalue, false);
         err = SetKeyValue(ctx, keys[0], vals[0]);
         if (0 != err)
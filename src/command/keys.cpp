@@ -53,11 +53,12 @@ OP_NAMESPACE_BEGIN
             KeyType ele_type = element_type(type);
             int64_t len = 0;
             KeyObject key(ctx.ns, ele_type, keystr);
+            key.SetObjectId(meta.GetObjectId());
             Iterator* iter = m_engine->Find(ctx, key);
             while (NULL != iter && iter->Valid())
             {
                 KeyObject& field = iter->Key();
-                if (field.GetType() != ele_type || field.GetNameSpace() != key.GetNameSpace() || field.GetKey() != key.GetKey())
+                if (field.GetType() != ele_type || !field.IsSameObject(key))
                 {
                     break;
                 }
@@ -167,6 +168,12 @@ OP_NAMESPACE_BEGIN
     int Ardb::Randomkey(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
+        std::string randkey;
+        if (IsKeyCacheNameSpace(ctx.ns) && m_key_cache->RandomKey(randkey))
+        {
+            reply.SetString(randkey);
+            return 0;
+        }
         KeyObject startkey(ctx.ns, KEY_META, "");
         ctx.flags.iterate_multi_keys = 1;
         ctx.flags.iterate_no_upperbound = 1;
@@ -184,12 +191,136 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
+    /*
+     * FILTER op operand of the element scans, values are compared as numbers if both sides are numbers,
+     * bytewise otherwise.
+     */
+    struct ScanValueFilter
+    {
+            enum
+            {
+                NONE, EQ, NE, LT, LE, GT, GE
+            };
+            int op;
+            std::string operand;
+            double operand_num;
+            bool numeric;
+            ScanValueFilter() :
+                    op(NONE), operand_num(0), numeric(false)
+            {
+            }
+            bool Parse(const std::string& opstr, const std::string& v)
+            {
+                static const char* names[] = { "", "eq", "ne", "lt", "le", "gt", "ge" };
+                static const char* symbols[] = { "", "==", "!=", "<", "<=", ">", ">=" };
+                for (int i = EQ; i <= GE; i++)
+                {
+                    if (!strcasecmp(opstr.c_str(), names[i]) || opstr == symbols[i])
+                    {
+                        op = i;
+                    }
+                }
+                operand = v;
+                numeric = string_todouble(v, operand_num);
+                return op != NONE;
+            }
+            bool Match(const std::string& value) const
+            {
+                int cmp = 0;
+                double num;
+                if (numeric && string_todouble(value, num))
+                {
+                    cmp = num < operand_num ? -1 : (num > operand_num ? 1 : 0);
+                }
+                else
+                {
+                    cmp = value.compare(operand);
+                }
+                switch (op)
+                {
+                    case EQ:
+                        return cmp == 0;
+                    case NE:
+                        return cmp != 0;
+                    case LT:
+                        return cmp < 0;
+                    case LE:
+                        return cmp <= 0;
+                    case GT:
+                        return cmp > 0;
+                    case GE:
+                        return cmp >= 0;
+                    default:
+                        return true;
+                }
+            }
+    };
+
+    /*
+     * Name of the type of a key as TYPE replies it, from the meta alone.
+     */
+    const char* Ardb::KeyTypeName(ValueObject& meta)
+    {
+        switch (meta.GetType())
+        {
+            case 0:
+            {
+                return "none";
+            }
+            case KEY_HASH:
+            {
+                return "hash";
+            }
+            case KEY_LIST:
+            {
+                return "list";
+            }
+            case KEY_SET:
+            {
+                return "set";
+            }
+            case KEY_ZSET:
+            {
+                return "zset";
+            }
+            case KEY_STRING:
+            {
+                if (meta.IsChunked())
+                {
+                    if (IsStream(meta))
+                    {
+                        return "stream";
+                    }
+                    if (IsVectorSet(meta))
+                    {
+                        return "vectorset";
+                    }
+                }
+                return "string";
+            }
+            default:
+            {
+                return "invalid";
+            }
+        }
+    }
+
+    /*
+     * SCAN cursor [MATCH pattern] [COUNT count] [TYPE type] [PREDICATE sha1]
+     * HSCAN/SSCAN/ZSCAN key cursor [MATCH pattern] [COUNT count] [NOVALUES] [FILTER op operand] [PREDICATE sha1]
+     *
+     * TYPE is checked on the meta without reading elements. FILTER compares hash values, zset scores or set members.
+     * PREDICATE calls a loaded script with KEYS[1] the key & ARGV the type(SCAN) or the element & its value, the
+     * element is returned if the script returns true. At most COUNT*10 keys/elements are visited in one call.
+     */
     int Ardb::Scan(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
         reply.ReserveMember(0);
         uint32 limit = 1000; //return max 1000 keys one time
-        std::string pattern;
+        std::string pattern, type_filter, predicate;
+        bool novalues = false;
+        ScanValueFilter value_filter;
         KeyObject startkey;
         startkey.SetNameSpace(ctx.ns);
         uint32 cursor_pos = 0;
@@ -200,8 +331,13 @@ OP_NAMESPACE_BEGIN
             FindElementByRedisCursor(cmd.GetArguments()[cursor_pos], cursor_element);
             startkey.SetType(KEY_HASH_FIELD);
             startkey.SetKey(cmd.GetArguments()[0]);
-            startkey.SetHashField(cursor_element);
-
+            /*
+             * an empty field is a string which sorts after integer ones, start from a nil field for cursor 0
+             */
+            if (!cursor_element.empty())
+            {
+                startkey.SetHashField(cursor_element);
+            }
         }
         else if (cmd.GetType() == REDIS_CMD_SSCAN)
         {
@@ -209,15 +345,24 @@ OP_NAMESPACE_BEGIN
             FindElementByRedisCursor(cmd.GetArguments()[cursor_pos], cursor_element);
             startkey.SetType(KEY_SET_MEMBER);
             startkey.SetKey(cmd.GetArguments()[0]);
-            startkey.SetSetMember(cursor_element);
+            if (!cursor_element.empty())
+            {
+                startkey.SetSetMember(cursor_element);
+            }
         }
         else if (cmd.GetType() == REDIS_CMD_ZSCAN)
         {
             cursor_pos = 1;
             FindElementByRedisCursor(cmd.GetArguments()[cursor_pos], cursor_element);
-            startkey.SetType(KEY_ZSET_SORT);
+            /*
+             * iterate the member keyed score keys, the cursor is a member so that the scan resumes after it
+             */
+            startkey.SetType(KEY_ZSET_SCORE);
             startkey.SetKey(cmd.GetArguments()[0]);
-            startkey.SetZSetMember(cursor_element);
+            if (!cursor_element.empty())
+            {
+                startkey.SetZSetMember(cursor_element);
+            }
         }
         else
         {
@@ -259,6 +404,36 @@ OP_NAMESPACE_BEGIN
                     }
                     i++;
                 }
+                else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "type") && cmd.GetType() == REDIS_CMD_SCAN
+                        && i + 1 < cmd.GetArguments().size())
+                {
+                    type_filter = cmd.GetArguments()[i + 1];
+                    i++;
+                }
+                else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "novalues") && cmd.GetType() == REDIS_CMD_HSCAN)
+                {
+                    novalues = true;
+                }
+                else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "filter") && cmd.GetType() != REDIS_CMD_SCAN
+                        && i + 2 < cmd.GetArguments().size())
+                {
+                    if (!value_filter.Parse(cmd.GetArguments()[i + 1], cmd.GetArguments()[i + 2]))
+                    {
+                        reply.SetErrorReason("invalid FILTER operator");
+                        return 0;
+                    }
+                    i += 2;
+                }
+                else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "predicate") && i + 1 < cmd.GetArguments().size())
+                {
+                    if (ctx.flags.lua)
+                    {
+                        reply.SetErrorReason("PREDICATE is not allowed from scripts");
+                        return 0;
+                    }
+                    predicate = cmd.GetArguments()[i + 1];
+                    i++;
+                }
                 else
                 {
                     reply.SetErrorReason("Syntax error, try scan 0");
@@ -269,11 +444,70 @@ OP_NAMESPACE_BEGIN
         RedisReply& r1 = reply.AddMember();
         RedisReply& r2 = reply.AddMember();
         r2.ReserveMember(0);
+        std::string match_element;
+        if (cmd.GetType() == REDIS_CMD_HSCAN)
+        {
+            /*
+             * a packed hash is small, return all its fields in one reply like redis does for ziplist encoding
+             */
+            KeyObject meta_key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+            ValueObject meta;
+            if (0 == m_engine->Get(ctx, meta_key, meta) && meta.GetType() == KEY_HASH)
+            {
+                startkey.SetObjectId(meta.GetObjectId());
+            }
+            if (meta.GetType() == KEY_HASH && meta.IsPacked())
+            {
+                for (size_t i = 0; i < meta.PackedCount(); i++)
+                {
+                    meta.PackedField(i).ToString(match_element);
+                    if (!pattern.empty())
+                    {
+                        if (stringmatchlen(pattern.c_str(), pattern.size(), match_element.c_str(), match_element.size(), 0) != 1)
+                        {
+                            continue;
+                        }
+                    }
+                    if (value_filter.op != ScanValueFilter::NONE || !predicate.empty())
+                    {
+                        std::string value, err;
+                        meta.PackedValue(i).ToString(value);
+                        if (!value_filter.Match(value))
+                        {
+                            continue;
+                        }
+                        if (!predicate.empty() && !EvalScanPredicate(ctx, predicate, cmd.GetArguments()[0], match_element, value, err))
+                        {
+                            if (!err.empty())
+                            {
+                                reply.SetErrorReason(err);
+                                return 0;
+                            }
+                            continue;
+                        }
+                    }
+                    RedisReply& rr = r2.AddMember();
+                    rr.SetString(meta.PackedField(i));
+                    if (!novalues)
+                    {
+                        RedisReply& rr1 = r2.AddMember();
+                        rr1.SetString(meta.PackedValue(i));
+                    }
+                }
+                r1.SetString("0");
+                return 0;
+            }
+        }
         uint32 scan_count_limit = limit * 10;
         uint32 scan_count = 0;
         int64_t result_count = 0;
+        /*
+         * keys are ordered by slot first in KEY_CODEC_V3, the key after 'key\0' may be in another slot, so the
+         * cursor is the last returned key which is skipped when resuming.
+         */
+        bool resume_after_cursor = cmd.GetType() == REDIS_CMD_SCAN && get_key_codec_version() == KEY_CODEC_V3;
+        int64 now = get_current_epoch_millis();
         Iterator* iter = m_engine->Find(ctx, startkey);
-        std::string match_element;
         while (iter->Valid())
         {
             KeyObject& k = iter->Key();
@@ -285,68 +519,121 @@ OP_NAMESPACE_BEGIN
                     continue;
                 }
                 k.GetKey().ToString(match_element);
+                if (resume_after_cursor && !cursor_element.empty() && match_element == cursor_element)
+                {
+                    iter->Next();
+                    continue;
+                }
             }
             else
             {
-                if (k.GetType() != startkey.GetType() || k.GetKey() != startkey.GetKey() || k.GetNameSpace() != startkey.GetNameSpace())
+                if (k.GetType() != startkey.GetType() || !k.IsSameObject(startkey))
                 {
                     break;
                 }
-                if (!pattern.empty())
+                if (k.GetType() == KEY_ZSET_SCORE)
                 {
-                    if (k.GetType() == KEY_ZSET_SORT)
-                    {
-                        k.GetZSetMember().ToString(match_element);
-                    }
-                    else
-                    {
-                        k.GetElement(0).ToString(match_element);
-                    }
+                    k.GetZSetMember().ToString(match_element);
+                }
+                else
+                {
+                    k.GetElement(0).ToString(match_element);
                 }
             }
             scan_count++;
-            if (!pattern.empty())
+            bool matched = k.GetType() != KEY_HASH_FIELD || !iter->Value().IsHashFieldExpired(now);
+            if (matched && !pattern.empty())
             {
-                if (stringmatchlen(pattern.c_str(), pattern.size(), match_element.c_str(), match_element.size(), 0) != 1)
-                {
-                    iter->Next();
-                    continue;
-                }
+                matched = stringmatchlen(pattern.c_str(), pattern.size(), match_element.c_str(), match_element.size(), 0) == 1;
             }
-            result_count++;
-            switch (k.GetType())
+            if (matched && !type_filter.empty())
             {
-                case KEY_META:
-                {
-                    RedisReply& rr = r2.AddMember();
-                    rr.SetString(k.GetKey());
-                    break;
-                }
-                case KEY_HASH_FIELD:
-                {
-                    RedisReply& rr = r2.AddMember();
-                    rr.SetString(k.GetHashField());
-                    RedisReply& rr1 = r2.AddMember();
-                    rr1.SetString(iter->Value().GetHashValue());
-                    break;
-                }
-                case KEY_ZSET_SORT:
+                matched = !strcasecmp(KeyTypeName(iter->Value()), type_filter.c_str());
+            }
+            if (matched && (value_filter.op != ScanValueFilter::NONE || !predicate.empty()))
+            {
+                std::string value, err;
+                switch (k.GetType())
                 {
-                    RedisReply& rr = r2.AddMember();
-                    rr.SetString(k.GetZSetMember());
-                    RedisReply& rr1 = r2.AddMember();
-                    rr1.SetString(k.GetElement(0));
-                    break;
+                    case KEY_META:
+                    {
+                        value = KeyTypeName(iter->Value());
+                        break;
+                    }
+                    case KEY_HASH_FIELD:
+                    {
+                        iter->Value().GetHashValue().ToString(value);
+                        break;
+                    }
+                    case KEY_ZSET_SCORE:
+                    {
+                        Data score;
+                        score.SetFloat64(iter->Value().GetZSetScore());
+                        score.ToString(value);
+                        break;
+                    }
+                    default:
+                    {
+                        value = match_element;
+                        break;
+                    }
                 }
-                case KEY_SET_MEMBER:
+                matched = value_filter.Match(value);
+                if (matched && !predicate.empty())
                 {
-                    RedisReply& rr = r2.AddMember();
-                    rr.SetString(k.GetSetMember());
-                    break;
+                    const std::string& key = cmd.GetType() == REDIS_CMD_SCAN ? match_element : cmd.GetArguments()[0];
+                    matched = EvalScanPredicate(ctx, predicate, key, cmd.GetType() == REDIS_CMD_SCAN ? "" : match_element, value, err);
+                    if (!err.empty())
+                    {
+                        DELETE(iter);
+                        reply.Clear();
+                        reply.SetErrorReason(err);
+                        return 0;
+                    }
                 }
-                default:
+            }
+            if (matched)
+            {
+                result_count++;
+                switch (k.GetType())
                 {
-                    break;
+                    case KEY_META:
+                    {
+                        RedisReply& rr = r2.AddMember();
+                        rr.SetString(k.GetKey());
+                        break;
+                    }
+                    case KEY_HASH_FIELD:
+                    {
+                        RedisReply& rr = r2.AddMember();
+                        rr.SetString(k.GetHashField());
+                        if (!novalues)
+                        {
+                            RedisReply& rr1 = r2.AddMember();
+                            rr1.SetString(iter->Value().GetHashValue());
+                        }
+                        break;
+                    }
+                    case KEY_ZSET_SCORE:
+                    {
+                        RedisReply& rr = r2.AddMember();
+                        rr.SetString(k.GetZSetMember());
+                        RedisReply& rr1 = r2.AddMember();
+                        Data score;
+                        score.SetFloat64(iter->Value().GetZSetScore());
+                        rr1.SetString(score);
+                        break;
+                    }
+                    case KEY_SET_MEMBER:
+                    {
+                        RedisReply& rr = r2.AddMember();
+                        rr.SetString(k.GetSetMember());
+                        break;
+                    }
+                    default:
+                    {
+                        break;
+                    }
                 }
             }
             if (scan_count >= scan_count_limit || result_count >= limit)
@@ -362,9 +649,11 @@ OP_NAMESPACE_BEGIN
         else
         {
             std::string next = match_element;
-            next.append(1, 0);
-            uint64 newcursor = GetNewRedisCursor(next);
-            r1.SetString(stringfromll(newcursor));
+            if (!resume_after_cursor)
+            {
+                next.append(1, 0);
+            }
+            r1.SetString(GetNewRedisCursor(next));
         }
         DELETE(iter);
         return 0;
@@ -421,6 +710,7 @@ OP_NAMESPACE_BEGIN
             DelKey(ctx, dst);
         }
         int64_t moved = 0;
+        uint64 object_id = 0;
         Iterator* iter = m_engine->Find(ctx, src);
         while (iter->Valid())
         {
@@ -429,6 +719,10 @@ OP_NAMESPACE_BEGIN
             {
                 break;
             }
+            if (k.GetType() == KEY_META && iter->Value().GetType() == KEY_HASH)
+            {
+                object_id = iter->Value().GetObjectId();
+            }
             k.SetNameSpace(dstdb);
             k.SetKey(dstkey);
             SetKeyValue(ctx, k, iter->Value());
@@ -437,6 +731,24 @@ OP_NAMESPACE_BEGIN
             moved++;
         }
         DELETE(iter);
+        /*
+         * fields keyed by object id stay in place on rename, they only follow the meta to another db
+         */
+        if (object_id > 0 && srcdb.Compare(dstdb, false) != 0)
+        {
+            KeyObject fields(srcdb, KEY_HASH_FIELD, "");
+            fields.SetObjectId(object_id);
+            iter = m_engine->Find(ctx, fields);
+            while (iter->Valid() && iter->Key().GetType() == KEY_HASH_FIELD && iter->Key().IsSameObject(fields))
+            {
+                KeyObject& k = iter->Key();
+                k.SetNameSpace(dstdb);
+                SetKeyValue(ctx, k, iter->Value());
+                iter->Del();
+                iter->Next();
+            }
+            DELETE(iter);
+        }
         reply.SetInteger(moved > 0 ? 1 : 0);
         return 0;
     }
@@ -466,44 +778,7 @@ OP_NAMESPACE_BEGIN
         {
             return 0;
         }
-        switch (meta_value.GetType())
-        {
-            case 0:
-            {
-                reply.SetString("none");
-                break;
-            }
-            case KEY_HASH:
-            {
-                reply.SetString("hash");
-                break;
-            }
-            case KEY_LIST:
-            {
-                reply.SetString("list");
-                break;
-            }
-            case KEY_SET:
-            {
-                reply.SetString("set");
-                break;
-            }
-            case KEY_ZSET:
-            {
-                reply.SetString("zset");
-                break;
-            }
-            case KEY_STRING:
-            {
-                reply.SetString("string");
-                break;
-            }
-            default:
-            {
-                reply.SetString("invalid");
-                break;
-            }
-        }
+        reply.SetString(std::string(KeyTypeName(meta_value)));
         return 0;
     }
 
@@ -692,10 +967,39 @@ OP_NAMESPACE_BEGIN
     int Ardb::Exists(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
-        const std::string& keystr = cmd.GetArguments()[0];
-        KeyObject key(ctx.ns, KEY_META, keystr);
-        bool existed = m_engine->Exists(ctx, key);
-        reply.SetInteger(existed ? 1 : 0);
+        if (cmd.GetArguments().size() == 1)
+        {
+            const std::string& keystr = cmd.GetArguments()[0];
+            KeyObject key(ctx.ns, KEY_META, keystr);
+            bool existed = m_engine->Exists(ctx, key);
+            reply.SetInteger(existed ? 1 : 0);
+            return 0;
+        }
+        /*
+         * a key given several times is counted as many times
+         */
+        KeyObjectArray ks;
+        for (size_t i = 0; i < cmd.GetArguments().size(); i++)
+        {
+            ks.push_back(KeyObject(ctx.ns, KEY_META, cmd.GetArguments()[i]));
+        }
+        ValueObjectArray vs;
+        ErrCodeArray errs;
+        int err = m_engine->MultiGet(ctx, ks, vs, errs);
+        if (0 != err && ERR_ENTRY_NOT_EXIST != err)
+        {
+            reply.SetErrCode(err);
+            return 0;
+        }
+        int64 existed = 0;
+        for (size_t i = 0; i < ks.size(); i++)
+        {
+            if (i < errs.size() && 0 == errs[i])
+            {
+                existed++;
+            }
+        }
+        reply.SetInteger(existed);
         return 0;
     }
 
@@ -714,11 +1018,48 @@ OP_NAMESPACE_BEGIN
         return ret;
     }
 
-    int Ardb::DelKey(Context& ctx, const KeyObject& meta_key, Iterator*& iter)
+    /*
+     * Fields keyed by object id are out of the key range of their meta, they are deleted synchronously
+     * instead of left to the lazyfree reclaimer which works on key names.
+     */
+    void Ardb::DelObjectFields(Context& ctx, const Data& ns, uint64 object_id)
+    {
+        KeyObject start(ns, KEY_HASH_FIELD, "");
+        start.SetObjectId(object_id);
+        if (m_engine->GetFeatureSet().support_delete_range)
+        {
+            KeyObject end(ns, KEY_HASH_FIELD + 1, "");
+            end.SetObjectId(object_id);
+            if (0 == m_engine->DelRange(ctx, start, end))
+            {
+                return;
+            }
+        }
+        Iterator* iter = m_engine->Find(ctx, start);
+        while (NULL != iter && iter->Valid() && iter->Key().GetType() == KEY_HASH_FIELD && iter->Key().IsSameObject(start))
+        {
+            iter->Del();
+            iter->Next();
+        }
+        DELETE(iter);
+    }
+
+    int Ardb::DelKey(Context& ctx, const KeyObject& meta_key, Iterator*& iter, bool lazy)
     {
         ValueObject meta_obj;
-        if (0 == m_engine->Get(ctx, meta_key, meta_obj))
+        bool found = 0 == m_engine->Get(ctx, meta_key, meta_obj);
+        return DelKey(ctx, meta_key, found ? &meta_obj : NULL, iter, lazy);
+    }
+
+    /*
+     * 'meta' is the value of 'meta_key' read by the caller, NULL if it had none. Elements of a key without meta are
+     * still looked for & deleted.
+     */
+    int Ardb::DelKey(Context& ctx, const KeyObject& meta_key, ValueObject* meta, Iterator*& iter, bool lazy)
+    {
+        if (NULL != meta)
         {
+            ValueObject& meta_obj = *meta;
             /*
              * need delete ttl sort key with ttl value
              */
@@ -735,11 +1076,51 @@ OP_NAMESPACE_BEGIN
                     m_engine->Del(ctx, new_ttl_key);
                 }
             }
-            if (meta_obj.GetType() == KEY_STRING)
+            RemoveHashIndexes(ctx, meta_key, meta_obj);
+            if (meta_obj.GetObjectLen() > 0)
+            {
+                NoteDeletedEntries((uint64) meta_obj.GetObjectLen());
+            }
+            if (meta_obj.GetType() == KEY_STRING && !meta_obj.IsChunked())
             {
                 int err = RemoveKey(ctx, meta_key);
                 return err == 0 ? 1 : 0;
             }
+            if (meta_obj.GetType() == KEY_HASH && meta_obj.GetObjectId() > 0)
+            {
+                DelObjectFields(ctx, meta_key.GetNameSpace(), meta_obj.GetObjectId());
+                RemoveKey(ctx, meta_key);
+                TouchWatchKey(ctx, meta_key);
+                ctx.dirty++;
+                return 1;
+            }
+            /*
+             * drop the meta & all elements of the object in one range delete instead of one delete per element
+             */
+            if (m_engine->GetFeatureSet().support_delete_range)
+            {
+                KeyObject end_key(meta_key.GetNameSpace(), KEY_END, meta_key.GetKey());
+                if (0 == m_engine->DelRange(ctx, meta_key, end_key))
+                {
+                    TouchWatchKey(ctx, meta_key);
+                    ctx.dirty++;
+                    return 1;
+                }
+            }
+            /*
+             * elements of a large object are left to the reclaimer, only allowed if the key is not
+             * written again in the same command.
+             */
+            else if (lazy && GetConf().lazyfree_threshold > 0 && !meta_obj.IsPacked()
+                    && (meta_obj.GetObjectLen() < 0 || meta_obj.GetObjectLen() >= GetConf().lazyfree_threshold))
+            {
+                if (0 == LazyFreeKey(ctx, meta_key))
+                {
+                    TouchWatchKey(ctx, meta_key);
+                    ctx.dirty++;
+                    return 1;
+                }
+            }
         }
 
         if (NULL == iter)
@@ -778,26 +1159,193 @@ OP_NAMESPACE_BEGIN
         RedisReply& reply = ctx.GetReply();
         Iterator* iter = NULL;
         int removed = 0;
-        ctx.flags.iterate_no_upperbound = cmd.GetArguments().size() > 1 ? 1 : 0;
-        for (size_t i = 0; i < cmd.GetArguments().size(); i++)
+        if (cmd.GetArguments().size() == 1)
         {
-            const string& keystr = cmd.GetArguments()[i];
+            const string& keystr = cmd.GetArguments()[0];
             KeyObject meta(ctx.ns, KEY_META, keystr);
             KeyLockGuard guard(ctx, meta);
-            int curRemoved = DelKey(ctx, meta, iter);
-            if (curRemoved)
+            ctx.flags.iterate_no_upperbound = 0;
+            removed = DelKey(ctx, meta, iter, true);
+            if (removed)
                 m_key_cache->Delete(keystr);
-            removed += curRemoved;
+            DELETE(iter);
+            reply.SetInteger(removed);
+            return 0;
+        }
+        /*
+         * all keys locked at once & their metas read by one MultiGet, keys without meta do not exist, plain strings
+         * are removed in one write batch, larger objects one by one by range delete or lazy free.
+         */
+        StringTreeSet uniq_keys(cmd.GetArguments().begin(), cmd.GetArguments().end());
+        KeyObjectArray ks;
+        StringTreeSet::iterator it = uniq_keys.begin();
+        while (it != uniq_keys.end())
+        {
+            ks.push_back(KeyObject(ctx.ns, KEY_META, *it));
+            it++;
+        }
+        KeysLockGuard guard(ctx, ks);
+        ValueObjectArray vs;
+        ErrCodeArray errs;
+        int err = m_engine->MultiGet(ctx, ks, vs, errs);
+        if (0 != err && ERR_ENTRY_NOT_EXIST != err)
+        {
+            reply.SetErrCode(err);
+            return 0;
+        }
+        std::vector<size_t> objects;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            for (size_t i = 0; i < ks.size(); i++)
+            {
+                if (i >= errs.size() || 0 != errs[i])
+                {
+                    continue;
+                }
+                if (vs[i].GetType() != KEY_STRING || vs[i].IsChunked())
+                {
+                    objects.push_back(i);
+                    continue;
+                }
+                if (DelKey(ctx, ks[i], &vs[i], iter, true) > 0)
+                {
+                    m_key_cache->Delete(ks[i].GetKey().AsString());
+                    removed++;
+                }
+            }
+        }
+        if (0 != ctx.transc_err)
+        {
+            reply.SetErrCode(ctx.transc_err);
+            return 0;
+        }
+        ctx.flags.iterate_no_upperbound = objects.size() > 1 ? 1 : 0;
+        for (size_t i = 0; i < objects.size(); i++)
+        {
+            size_t idx = objects[i];
+            int cur_removed = DelKey(ctx, ks[idx], &vs[idx], iter, true);
+            if (cur_removed)
+                m_key_cache->Delete(ks[idx].GetKey().AsString());
+            removed += cur_removed;
         }
         DELETE(iter);
-
         reply.SetInteger(removed);
         return 0;
     }
 
+    static const uint64 kDumpChunkSize = 512 * 1024;
+
+    /*
+     * DUMP key CHUNK cursor [SIZE bytes]
+     * Reply the next chunk of raw entries of the key & the cursor to resume from, '0' after the last chunk. A chunk holds
+     * about 'SIZE' bytes of entries. The meta is in the last chunk, so the key only exists where the chunks are restored
+     * by RESTORE ... APPEND once all of them are applied. Writes to the key between two chunks may be partly dumped.
+     */
+    int Ardb::DumpChunk(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        uint64 chunk_size = kDumpChunkSize;
+        if (args.size() == 5 && !strcasecmp(args[3].c_str(), "size"))
+        {
+            if (!string_touint64(args[4], chunk_size) || 0 == chunk_size)
+            {
+                reply.SetErrCode(ERR_INVALID_INTEGER_ARGS);
+                return 0;
+            }
+        }
+        else if (args.size() != 3)
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
+        /*
+         * fields of hashes keyed by object id are out of the key ranges, as with raw MIGRATE
+         */
+        if (ObjectIdEnabled())
+        {
+            reply.SetErrorReason("DUMP CHUNK does not work with hash-object-id");
+            return 0;
+        }
+        KeyObject meta_key(ctx.ns, KEY_META, args[0]);
+        KeyObject start(ctx.ns, KEY_META, args[0]);
+        std::string element;
+        if (0 != FindElementByRedisCursor(args[2], element))
+        {
+            reply.SetErrorReason("invalid cursor");
+            return 0;
+        }
+        if (!element.empty())
+        {
+            Buffer keybuf(const_cast<char*>(element.data()), 0, element.size());
+            if (!start.Decode(keybuf, true, false) || start.GetKey() != meta_key.GetKey())
+            {
+                reply.SetErrorReason("invalid cursor");
+                return 0;
+            }
+            start.SetNameSpace(ctx.ns);
+        }
+        KeyLockGuard guard(ctx, meta_key);
+        if (!m_engine->Exists(ctx, meta_key))
+        {
+            reply.Clear();
+            return 0;
+        }
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(meta_key);
+        iter_opts.streaming = true;
+        ObjectBuffer obuffer;
+        Buffer buffer;
+        std::string next;
+        Iterator* iter = m_engine->Find(ctx, start, iter_opts);
+        while (iter->Valid())
+        {
+            KeyObject& k = iter->Key();
+            if (k.GetKey() != meta_key.GetKey() || k.GetNameSpace() != meta_key.GetNameSpace())
+            {
+                break;
+            }
+            if (buffer.ReadableBytes() >= chunk_size)
+            {
+                next.assign(iter->RawKey().data(), iter->RawKey().size());
+                break;
+            }
+            if (k.GetType() != KEY_META)
+            {
+                obuffer.ArdbSaveRawKeyValue(iter->RawKey(), iter->RawValue(), buffer, 0);
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        if (next.empty())
+        {
+            iter = m_engine->Find(ctx, meta_key, iter_opts);
+            if (iter->Valid() && iter->Key().GetType() == KEY_META && iter->Key().GetKey() == meta_key.GetKey())
+            {
+                obuffer.ArdbSaveRawKeyValue(iter->RawKey(), iter->RawValue(), buffer, iter->Value().GetTTL());
+            }
+            DELETE(iter);
+        }
+        obuffer.ArdbWriteKeyCodec();
+        obuffer.ArdbFlushWriteBuffer(buffer);
+        reply.ReserveMember(2);
+        reply.MemberAt(0).SetString(next.empty() ? "0" : GetNewRedisCursor(next));
+        reply.MemberAt(1).SetString(std::string(obuffer.GetInternalBuffer().GetRawReadBuffer(), obuffer.GetInternalBuffer().ReadableBytes()));
+        return 0;
+    }
+
     int Ardb::Dump(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
+        if (cmd.GetArguments().size() > 1)
+        {
+            if (strcasecmp(cmd.GetArguments()[1].c_str(), "chunk"))
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            return DumpChunk(ctx, cmd);
+        }
         ObjectBuffer buffer;
         KeyObject meta(ctx.ns, KEY_META, cmd.GetArguments()[0]);
         KeyLockGuard guard(ctx, meta);
@@ -812,15 +1360,19 @@ OP_NAMESPACE_BEGIN
     int Ardb::Restore(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
-        bool replace = false;
+        bool replace = false, append = false;
         int64 ttl = 0;
         bool delete_exist = true;
-        if (cmd.GetArguments().size() == 4)
+        for (size_t i = 3; i < cmd.GetArguments().size(); i++)
         {
-            if (!strcasecmp(cmd.GetArguments()[3].c_str(), "replace"))
+            if (!strcasecmp(cmd.GetArguments()[i].c_str(), "replace"))
             {
                 replace = true;
             }
+            else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "append"))
+            {
+                append = true;
+            }
             else
             {
                 reply.SetErrCode(ERR_INVALID_SYNTAX);
@@ -836,6 +1388,10 @@ OP_NAMESPACE_BEGIN
         {
             ttl += get_current_epoch_millis();
         }
+        if (append)
+        {
+            return RestoreAppend(ctx, cmd, replace, ttl);
+        }
         ObjectBuffer buffer(cmd.GetArguments()[2]);
         if (!buffer.CheckReadPayload())
         {
@@ -870,5 +1426,58 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
-OP_NAMESPACE_END
+    /*
+     * RESTORE key ttl chunk APPEND [REPLACE]
+     * Apply one chunk of DUMP key CHUNK, the chunks are written as they arrive in one write batch each. An existing key
+     * is busy, or deleted first with REPLACE, it does not exist before the last chunk carrying the meta is applied.
+     */
+    int Ardb::RestoreAppend(Context& ctx, RedisCommandFrame& cmd, bool replace, int64 ttl)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const std::string& keystr = cmd.GetArguments()[0];
+        KeyObject meta_key(ctx.ns, KEY_META, keystr);
+        KeyLockGuard guard(ctx, meta_key);
+        ValueObject meta;
+        if (0 == m_engine->Get(ctx, meta_key, meta))
+        {
+            if (!replace)
+            {
+                reply.SetErrorReason("-BUSYKEY Target key name already exists.");
+                return 0;
+            }
+            DelKey(ctx, meta_key);
+        }
+        ObjectBuffer buffer(cmd.GetArguments()[2]);
+        buffer.RestrictLoadKey(&keystr);
+        ctx.flags.create_if_notexist = 1;
+        bool loaded = false;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            loaded = buffer.ArdbLoad(ctx);
+            if (!loaded)
+            {
+                batch.MarkFailed(-1);
+            }
+        }
+        if (!loaded)
+        {
+            reply.SetErrorReason("Bad chunk format");
+            return 0;
+        }
+        if (ttl > 0 && 0 == m_engine->Get(ctx, meta_key, meta))
+        {
+            int64 old_ttl = meta.GetTTL();
+            if (0 == MergeExpire(ctx, meta_key, meta, ttl))
+            {
+                SetKeyValue(ctx, meta_key, meta);
+                if (!m_engine->GetFeatureSet().support_compactfilter)
+                {
+                    SaveTTL(ctx, ctx.ns, keystr, old_ttl, ttl);
+                }
+            }
+        }
+        reply.SetStatusCode(STATUS_OK);
+        return 0;
+    }
 
+OP_NAMESPACE_END
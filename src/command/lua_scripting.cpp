@@ -35,6 +35,8 @@
 #include "thread/spin_mutex_lock.hpp"
 #include "thread/thread_mutex_lock.hpp"
 #include "util/file_helper.hpp"
+#include "util/mem_arena.hpp"
+#include "util/atomic.hpp"
 #include <string.h>
 #include <limits>
 #include <math.h>
@@ -330,46 +332,69 @@ namespace ardb
         return 0;
     }
 
-    typedef TreeMap<std::string, std::string>::Type ScriptCache;
+    /*
+     * Scripts are shared by the interpreters of all threads, 'bytecode' is the dumped chunk defining
+     * the script function, so a script is compiled once & the other threads only load it.
+     */
+    struct LuaScript
+    {
+            std::string body;
+            std::string bytecode;
+    };
+    typedef TreeMap<std::string, LuaScript>::Type ScriptCache;
     typedef TreeSet<LuaExecContext*>::Type ExecContextSet;
     static SpinMutexLock g_lua_lock;
     static ScriptCache g_script_cache;
     static ExecContextSet g_script_ctxs;
+    /*
+     * bumped by SCRIPT FLUSH, interpreters drop their functions once they see a new generation
+     */
+    static volatile uint32_t g_script_generation = 0;
 
     LUAInterpreter::LUAInterpreter() :
-            m_lua(NULL)
+            m_lua(NULL), m_script_generation(g_script_generation)
     {
         Init();
     }
 
-    static std::string* get_script_from_cache(const std::string& funcname)
+    static bool get_script_from_cache(const std::string& funcname, std::string* body, std::string* bytecode)
     {
         LockGuard<SpinMutexLock> guard(g_lua_lock);
         ScriptCache::iterator found = g_script_cache.find(funcname);
         if (found == g_script_cache.end())
         {
-            return NULL;
+            return false;
         }
-        return &(found->second);
-    }
-
-    static void save_script_to_cache(const std::string& funcname, const std::string& body)
-    {
-        LockGuard<SpinMutexLock> guard(g_lua_lock);
-        if (body == "")
+        if (NULL != body)
         {
-            g_script_cache.erase(funcname);
+            *body = found->second.body;
         }
-        else
+        if (NULL != bytecode)
         {
-            g_script_cache[funcname] = body;
+            *bytecode = found->second.bytecode;
         }
+        return true;
+    }
+
+    static void save_script_to_cache(const std::string& funcname, const std::string& body, const std::string& bytecode)
+    {
+        LockGuard<SpinMutexLock> guard(g_lua_lock);
+        LuaScript& script = g_script_cache[funcname];
+        script.body = body;
+        script.bytecode = bytecode;
     }
 
     static void clear_script_cache()
     {
         LockGuard<SpinMutexLock> guard(g_lua_lock);
         g_script_cache.clear();
+        atomic_add_uint32(&g_script_generation, 1);
+    }
+
+    static int lua_bytecode_writer(lua_State *lua, const void* p, size_t size, void* data)
+    {
+        ((std::string*) data)->append((const char*) p, size);
+        return 0;
     }
 
     static void save_exec_ctx(LuaExecContext* ctx)
@@ -408,17 +433,35 @@ namespace ardb
      * client context. */
     int LUAInterpreter::CreateLuaFunction(const std::string& funcname, const std::string& body, std::string& err)
     {
-        std::string funcdef = "function ";
-        funcdef.append(funcname);
-        funcdef.append("() ");
-        funcdef.append(body);
-        funcdef.append(" end");
-
-        if (luaL_loadbuffer(m_lua, funcdef.c_str(), funcdef.size(), "@user_script"))
+        std::string bytecode;
+        get_script_from_cache(funcname, NULL, &bytecode);
+        if (!bytecode.empty())
         {
-            err.append("Error compiling script (new function): ").append(lua_tostring(m_lua, -1)).append("\n");
-            lua_pop(m_lua, 1);
-            return -1;
+            /*
+             * compiled by another thread already
+             */
+            if (luaL_loadbuffer(m_lua, bytecode.data(), bytecode.size(), "@user_script"))
+            {
+                err.append("Error loading script (new function): ").append(lua_tostring(m_lua, -1)).append("\n");
+                lua_pop(m_lua, 1);
+                return -1;
+            }
+        }
+        else
+        {
+            std::string funcdef = "function ";
+            funcdef.append(funcname);
+            funcdef.append("() ");
+            funcdef.append(body);
+            funcdef.append(" end");
+
+            if (luaL_loadbuffer(m_lua, funcdef.c_str(), funcdef.size(), "@user_script"))
+            {
+                err.append("Error compiling script (new function): ").append(lua_tostring(m_lua, -1)).append("\n");
+                lua_pop(m_lua, 1);
+                return -1;
+            }
+            lua_dump(m_lua, lua_bytecode_writer, &bytecode);
         }
         if (lua_pcall(m_lua, 0, 0, 0))
         {
@@ -426,14 +469,37 @@ namespace ardb
             lua_pop(m_lua, 1);
             return -1;
         }
+        m_functions.insert(funcname);
 
         /* We also save a SHA1 -> Original script map in a dictionary
          * so that we can replicate / write in the AOF all the
          * EVALSHA commands as EVAL using the original script. */
-        save_script_to_cache(funcname, body);
+        save_script_to_cache(funcname, body, bytecode);
         return 0;
     }
 
+    /*
+     * Undefine the script functions of this interpreter if SCRIPT FLUSH was called since they were defined.
+     */
+    void LUAInterpreter::CheckScriptGeneration()
+    {
+        uint32 generation = g_script_generation;
+        if (generation == m_script_generation)
+        {
+            return;
+        }
+        m_script_generation = generation;
+        StringTreeSet::iterator it = m_functions.begin();
+        while (it != m_functions.end())
+        {
+            lua_pushnil(m_lua);
+            lua_setglobal(m_lua, it->c_str());
+            it++;
+        }
+        m_functions.clear();
+        lua_gc(m_lua, LUA_GCCOLLECT, 0);
+    }
+
     int LUAInterpreter::LoadLibs()
     {
         luaLoadLib(m_lua, "", luaopen_base);
@@ -445,6 +511,12 @@ namespace ardb
         luaLoadLib(m_lua, "cjson", luaopen_cjson);
         luaLoadLib(m_lua, "struct", luaopen_struct);
         luaLoadLib(m_lua, "cmsgpack", luaopen_cmsgpack);
+#ifdef USE_LUAJIT
+        /*
+         * the compiler is only turned on by opening the jit library, whose global is removed afterwards
+         */
+        luaLoadLib(m_lua, LUA_JITLIBNAME, luaopen_jit);
+#endif
         return 0;
     }
 
@@ -452,6 +524,10 @@ namespace ardb
     {
         lua_pushnil(m_lua);
         lua_setglobal(m_lua, "loadfile");
+#ifdef USE_LUAJIT
+        lua_pushnil(m_lua);
+        lua_setglobal(m_lua, LUA_JITLIBNAME);
+#endif
         return 0;
     }
 
@@ -475,6 +551,15 @@ namespace ardb
     {
         int j, argc = lua_gettop(lua);
         ArgumentArray cmdargs;
+#ifdef USE_LUAJIT
+        /*
+         * JIT compiled code never runs the count hook, check the time limit & SCRIPT KILL on every call too.
+         */
+        if (g_db->GetConf().lua_time_limit > 0)
+        {
+            MaskCountHook(lua, NULL);
+        }
+#endif
 
         /* Require at least one argument */
         if (argc == 0)
@@ -568,6 +653,207 @@ namespace ardb
         return CallArdb(lua, false);
     }
 
+    /*
+     * Parse the command of redis.mcall() at the top of the stack, return an error message if it can not be
+     * executed from the script.
+     */
+    const char* LUAInterpreter::ParseBatchCommand(lua_State *lua, RedisCommandFrame& cmd)
+    {
+        if (!lua_istable(lua, -1) || lua_objlen(lua, -1) == 0)
+        {
+            return "Every command of redis.mcall() must be an array of at least one argument";
+        }
+        ArgumentArray cmdargs;
+        size_t argc = lua_objlen(lua, -1);
+        for (size_t i = 1; i <= argc; i++)
+        {
+            lua_rawgeti(lua, -1, i);
+            if (!lua_isstring(lua, -1))
+            {
+                lua_pop(lua, 1);
+                return "Lua redis() command arguments must be strings or integers";
+            }
+            size_t len = 0;
+            const char* arg = lua_tolstring(lua, -1, &len);
+            cmdargs.push_back(std::string(arg, len));
+            lua_pop(lua, 1);
+        }
+        cmd = RedisCommandFrame(cmdargs);
+        Ardb::RedisCommandHandlerSetting* setting = g_db->FindRedisCommandHandlerSetting(cmd);
+        if (NULL == setting)
+        {
+            return "Unknown Redis command called from Lua script";
+        }
+        if (!setting->IsAllowedInScript())
+        {
+            return "This Redis command is not allowed from scripts";
+        }
+        size_t arity = cmd.GetArguments().size();
+        if ((setting->min_arity > 0 && arity < (size_t) setting->min_arity) || (setting->max_arity >= 0 && arity > (size_t) setting->max_arity))
+        {
+            return "Wrong number of args calling Redis command From Lua script";
+        }
+        LuaExecContext* ctx = g_lua_exec_ctx.GetValue();
+        if (setting->IsWriteCommand() && !g_db->GetConf().master_host.empty() && g_db->GetConf().slave_readonly && !g_db->IsLoadingData()
+                && !(ctx->caller->flags.slave))
+        {
+            return "-READONLY You can't write against a read only slave.";
+        }
+        cmd.SetType(setting->type);
+        return NULL;
+    }
+
+    /*
+     * Execute a command like redis.pcall() & push its result.
+     */
+    void LUAInterpreter::ExecBatchCommand(lua_State *lua, Context& lua_ctx, RedisCommandFrame& cmd)
+    {
+        Ardb::RedisCommandHandlerSetting* setting = g_db->FindRedisCommandHandlerSetting(cmd);
+        RedisReply& reply = lua_ctx.GetReply();
+        reply.Clear();
+        lua_ctx.ClearFlags();
+        lua_ctx.flags.no_wal = 1;
+        lua_ctx.flags.lua = 1;
+        /*
+         * consecutive single key writes share one engine write batch, any other command commits it first
+         */
+        g_db->JoinPipelineBatch(lua_ctx, cmd);
+        g_db->DoCall(lua_ctx, *setting, cmd);
+        redisProtocolToLuaType(lua, reply);
+    }
+
+    /*
+     * GETs are read with one engine MultiGet, values needing more than a plain read(expired, chunked, wrong type)
+     * fall back to GET.
+     */
+    void LUAInterpreter::BatchGet(lua_State *lua, Context& lua_ctx, std::vector<RedisCommandFrame>& cmds, size_t begin, size_t end)
+    {
+        KeyObjectArray keys;
+        for (size_t i = begin; i < end; i++)
+        {
+            keys.push_back(KeyObject(lua_ctx.ns, KEY_META, cmds[i].GetArguments()[0]));
+        }
+        ValueObjectArray vals;
+        ErrCodeArray errs;
+        lua_ctx.ClearFlags();
+        int err = g_engine->MultiGet(lua_ctx, keys, vals, errs);
+        int64 now = get_current_epoch_millis();
+        for (size_t i = begin; i < end; i++)
+        {
+            size_t k = i - begin;
+            if (0 == err && errs[k] == ERR_ENTRY_NOT_EXIST)
+            {
+                lua_pushboolean(lua, 0);
+            }
+            else if (0 == err && 0 == errs[k] && vals[k].GetType() == KEY_STRING && !vals[k].IsChunked() && !(vals[k].GetTTL() > 0 && vals[k].GetTTL() < now))
+            {
+                std::string str;
+                vals[k].GetStringValue().ToString(str);
+                lua_pushlstring(lua, str.data(), str.size());
+            }
+            else
+            {
+                ExecBatchCommand(lua, lua_ctx, cmds[i]);
+            }
+            lua_rawseti(lua, -2, i + 1);
+        }
+    }
+
+    /*
+     * HGETs of the same key are executed as one HMGET.
+     */
+    void LUAInterpreter::BatchHGet(lua_State *lua, Context& lua_ctx, std::vector<RedisCommandFrame>& cmds, size_t begin, size_t end)
+    {
+        RedisCommandFrame hmget("hmget");
+        hmget.AddArg(cmds[begin].GetArguments()[0]);
+        for (size_t i = begin; i < end; i++)
+        {
+            hmget.AddArg(cmds[i].GetArguments()[1]);
+        }
+        Ardb::RedisCommandHandlerSetting* setting = g_db->FindRedisCommandHandlerSetting(hmget);
+        RedisReply& reply = lua_ctx.GetReply();
+        reply.Clear();
+        lua_ctx.ClearFlags();
+        lua_ctx.flags.no_wal = 1;
+        lua_ctx.flags.lua = 1;
+        g_db->DoCall(lua_ctx, *setting, hmget);
+        for (size_t i = begin; i < end; i++)
+        {
+            if (reply.type == REDIS_REPLY_ARRAY && reply.MemberSize() == end - begin)
+            {
+                redisProtocolToLuaType(lua, reply.MemberAt(i - begin));
+            }
+            else
+            {
+                redisProtocolToLuaType(lua, reply);
+            }
+            lua_rawseti(lua, -2, i + 1);
+        }
+    }
+
+    /*
+     * redis.mcall({{'hget', 'h', 'f1'}, {'hget', 'h', 'f2'}, {'set', 'k', 'v'}}) executes an array of commands
+     * & returns the array of their results, errors are returned like redis.pcall() does & do not stop the rest.
+     * Runs of GET, runs of HGET on one key & runs of single key writes are executed as batches.
+     */
+    int LUAInterpreter::MCall(lua_State *lua)
+    {
+        if (lua_gettop(lua) != 1 || !lua_istable(lua, 1))
+        {
+            luaPushError(lua, "Please specify an array of commands for redis.mcall()");
+            return 1;
+        }
+        size_t count = lua_objlen(lua, 1);
+        std::vector<RedisCommandFrame> cmds(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            lua_rawgeti(lua, 1, i + 1);
+            const char* err = ParseBatchCommand(lua, cmds[i]);
+            lua_pop(lua, 1);
+            if (NULL != err)
+            {
+                luaPushError(lua, err);
+                return 1;
+            }
+        }
+
+        Context& lua_ctx = g_lua_exec_ctx.GetValue()->exec;
+        lua_createtable(lua, count, 0);
+        size_t i = 0;
+        while (i < count)
+        {
+            RedisCommandType type = cmds[i].GetType();
+            size_t end = i + 1;
+            if (type == REDIS_CMD_GET || type == REDIS_CMD_HGET)
+            {
+                while (end < count && cmds[end].GetType() == type && (type == REDIS_CMD_GET || cmds[end].GetArguments()[0] == cmds[i].GetArguments()[0]))
+                {
+                    end++;
+                }
+            }
+            if (end - i > 1)
+            {
+                g_db->CommitPipelineBatch(lua_ctx);
+                if (type == REDIS_CMD_GET)
+                {
+                    BatchGet(lua, lua_ctx, cmds, i, end);
+                }
+                else
+                {
+                    BatchHGet(lua, lua_ctx, cmds, i, end);
+                }
+            }
+            else
+            {
+                ExecBatchCommand(lua, lua_ctx, cmds[i]);
+                lua_rawseti(lua, -2, i + 1);
+            }
+            i = end;
+        }
+        g_db->CommitPipelineBatch(lua_ctx);
+        return 1;
+    }
+
     static void print_lua_table(lua_State *L, int index, std::string& str)
     {
         // Push another reference to the table on top of the stack (so we know
@@ -830,9 +1116,25 @@ namespace ardb
         }
     }
 
+    static void* lua_arena_alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+    {
+        if (0 == nsize)
+        {
+            arena_free(MEM_ARENA_LUA, ptr);
+            return NULL;
+        }
+        return arena_realloc(MEM_ARENA_LUA, ptr, nsize);
+    }
+    static int lua_panic(lua_State* lua)
+    {
+        ERROR_LOG("PANIC: unprotected error in call to Lua API (%s)", lua_tostring(lua, -1));
+        return 0;
+    }
+
     int LUAInterpreter::Init()
     {
-        m_lua = lua_open();
+        m_lua = lua_newstate(lua_arena_alloc, NULL);
+        lua_atpanic(m_lua, lua_panic);
 
         LoadLibs();
         RemoveUnsupportedFunctions();
@@ -850,6 +1152,11 @@ namespace ardb
         lua_pushcfunction(m_lua, LUAInterpreter::PCall);
         lua_settable(m_lua, -3);
 
+        /* redis.mcall */
+        lua_pushstring(m_lua, "mcall");
+        lua_pushcfunction(m_lua, LUAInterpreter::MCall);
+        lua_settable(m_lua, -3);
+
         /* redis.assert2 */
         lua_pushstring(m_lua, "assert2");
         lua_pushcfunction(m_lua, LUAInterpreter::Assert2);
@@ -945,8 +1252,10 @@ namespace ardb
         //g_local_ctx.SetValue(&ctx);
         LuaExecContextGuard guard;
         redisSrand48(0);
+        CheckScriptGeneration();
         std::string err;
         std::string funcname = "f_";
+        std::string body;
         const std::string* funptr = &func;
         if (isSHA1Func)
         {
@@ -974,18 +1283,14 @@ namespace ardb
              * return an error. */
             if (isSHA1Func)
             {
-                funptr = get_script_from_cache(funcname);
-                if (NULL == funptr)
+                if (!get_script_from_cache(funcname, &body, NULL))
                 {
                     lua_pop(m_lua, 1);
                     /* remove the error handler from the stack. */
                     reply.SetErrCode(ERR_NOSCRIPT);
                     return 0;
                 }
-            }
-            else
-            {
-                save_script_to_cache(funcname, func);
+                funptr = &body;
             }
             if (CreateLuaFunction(funcname, *funptr, err))
             {
@@ -1073,6 +1378,7 @@ namespace ardb
         ret.clear();
         ret = sha1_sum(func);
         funcname.append(ret);
+        CheckScriptGeneration();
         return CreateLuaFunction(funcname, func, ret) == 0;
     }
 
@@ -1130,6 +1436,57 @@ namespace ardb
         return 0;
     }
 
+    /*
+     * Calls the loaded script 'sha1' as a scan predicate with KEYS[1]=key, ARGV={element, value} or ARGV={type} for
+     * keys, true if it returns a non zero integer, a non empty string or array. 'err' is set if the script fails.
+     */
+    bool Ardb::EvalScanPredicate(Context& ctx, const std::string& sha1, const std::string& key, const std::string& element,
+            const std::string& value, std::string& err)
+    {
+        Context pctx;
+        pctx.ns = ctx.ns;
+        pctx.client = ctx.client;
+        pctx.flags.lua = 1;
+        StringArray keys, args;
+        keys.push_back(key);
+        if (!element.empty())
+        {
+            args.push_back(element);
+        }
+        args.push_back(value);
+        m_lua.GetValue().Eval(pctx, sha1, keys, args, true);
+        RedisReply& r = pctx.GetReply();
+        if (r.IsErr())
+        {
+            err = r.Error();
+            if (err.empty())
+            {
+                err = "PREDICATE script failed";
+            }
+            return false;
+        }
+        switch (r.type)
+        {
+            case REDIS_REPLY_INTEGER:
+            {
+                return r.GetInteger() != 0;
+            }
+            case REDIS_REPLY_STRING:
+            case REDIS_REPLY_STATUS:
+            {
+                return !r.GetString().empty();
+            }
+            case REDIS_REPLY_ARRAY:
+            {
+                return r.MemberSize() > 0;
+            }
+            default:
+            {
+                return false;
+            }
+        }
+    }
+
     int Ardb::EvalSHA(Context& ctx, RedisCommandFrame& cmd)
     {
         int old_dirty = ctx.dirty;
@@ -1143,10 +1500,10 @@ namespace ardb
                  */
                 cmd.SetCommand("eval");
                 cmd.SetType(REDIS_CMD_EVAL);
-                std::string* body = get_script_from_cache("f_" + cmd.GetArguments()[0]);
-                if(NULL != body)
+                std::string body;
+                if(get_script_from_cache("f_" + cmd.GetArguments()[0], &body, NULL))
                 {
-                    cmd.GetMutableArguments()[0] = *body;
+                    cmd.GetMutableArguments()[0] = body;
                 }
             }
         }
@@ -1165,7 +1522,7 @@ namespace ardb
                 RedisReply& r = reply.AddMember();
                 std::string funcname = "f_";
                 funcname.append(cmd.GetArguments()[i]);
-                r.SetInteger(get_script_from_cache(funcname) != NULL ? 1 : 0);
+                r.SetInteger(get_script_from_cache(funcname, NULL, NULL) ? 1 : 0);
             }
             return 0;
         }
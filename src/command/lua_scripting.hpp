@@ -30,11 +30,15 @@
 #define LUA_SCRIPTING_HPP_
 
 #include <string>
+#include <vector>
 extern "C"
 {
 #include <lua.h>
 #include <lauxlib.h>
 #include <lualib.h>
+#ifdef USE_LUAJIT
+#include <luajit.h>
+#endif
 }
 #include "context.hpp"
 
@@ -47,10 +51,17 @@ namespace ardb
     {
         private:
             lua_State *m_lua;
+            StringTreeSet m_functions; //f_<sha1> functions defined in this interpreter
+            uint32 m_script_generation;
 
             static int CallArdb(lua_State *lua, bool raise_error);
             static int PCall(lua_State *lua);
             static int Call(lua_State *lua);
+            static int MCall(lua_State *lua);
+            static const char* ParseBatchCommand(lua_State *lua, RedisCommandFrame& cmd);
+            static void ExecBatchCommand(lua_State *lua, Context& lua_ctx, RedisCommandFrame& cmd);
+            static void BatchGet(lua_State *lua, Context& lua_ctx, std::vector<RedisCommandFrame>& cmds, size_t begin, size_t end);
+            static void BatchHGet(lua_State *lua, Context& lua_ctx, std::vector<RedisCommandFrame>& cmds, size_t begin, size_t end);
             static int Log(lua_State *lua);
             static int Assert2(lua_State *lua);
             static int IsMergeSupported(lua_State *lua);
@@ -64,6 +75,7 @@ namespace ardb
             int LoadLibs();
             int RemoveUnsupportedFunctions();
             int CreateLuaFunction(const std::string& funcname, const std::string& body, std::string& err);
+            void CheckScriptGeneration();
             int Init();
             void Reset();
         public:
@@ -131,11 +131,34 @@ namespace ardb
                 op = REDIS_CMD_PFADD;
                 return true;
             }
+            case REDIS_CMD_BFADD:
+            case REDIS_CMD_BFMADD:
+            {
+                op = REDIS_CMD_BFADD;
+                return true;
+            }
+            case REDIS_CMD_CMSINCRBY:
+            {
+                op = REDIS_CMD_CMSINCRBY;
+                return true;
+            }
+            case REDIS_CMD_TOPKADD:
+            case REDIS_CMD_TOPKINCRBY:
+            {
+                op = REDIS_CMD_TOPKADD;
+                return true;
+            }
             case REDIS_CMD_PEXPIREAT:
             {
                 op = REDIS_CMD_PEXPIREAT;
                return true;
             }
+            case REDIS_CMD_SADD:
+            case REDIS_CMD_SADD2:
+            {
+                op = REDIS_CMD_SADD;
+                return true;
+            }
             default:
             {
                 ERROR_LOG("Not supported merge operation:%u", op);
@@ -163,6 +186,52 @@ namespace ardb
                 right_args[0].SetFloat64(right_args[0].GetFloat64() + left_args[0].GetFloat64());
                 return 0;
             }
+            case REDIS_CMD_SADD:
+            {
+                /*
+                 * added counts of set meta, -1 means unknown
+                 */
+                int64 left_added = left_args[0].GetInt64();
+                int64 right_added = right_args[0].GetInt64();
+                right_args[0].SetInt64(left_added < 0 || right_added < 0 ? -1 : left_added + right_added);
+                return 0;
+            }
+            case REDIS_CMD_BFADD:
+            {
+                /*
+                 * bits set in one bloom chunk, bounded by the one byte argument count of a merge value
+                 */
+                if (left_args.size() + right_args.size() > 255)
+                {
+                    return -1;
+                }
+                right_args.insert(right_args.end(), left_args.begin(), left_args.end());
+                return 0;
+            }
+            case REDIS_CMD_CMSINCRBY:
+            case REDIS_CMD_TOPKADD:
+            {
+                /*
+                 * item/increment pairs, top-k decays depend on the order so the older operands stay first
+                 */
+                if (left_args.size() + right_args.size() > 255)
+                {
+                    return -1;
+                }
+                right_args.insert(right_args.begin(), left_args.begin(), left_args.end());
+                return 0;
+            }
+            case REDIS_CMD_HSET:
+            {
+                /*
+                 * hash metas marked with unknown length, the later one wins
+                 */
+                if (left_args[0].IsInteger() || right_args[0].IsInteger())
+                {
+                    return -1;
+                }
+                return 0;
+            }
             default:
             {
                 return -1;
@@ -226,10 +295,26 @@ namespace ardb
             {
                 return MergePFAdd(merge_ctx, key, val, args, NULL);
             }
+            case REDIS_CMD_BFADD:
+            {
+                return MergeBloomBits(merge_ctx, key, val, args);
+            }
+            case REDIS_CMD_CMSINCRBY:
+            {
+                return MergeCMSIncrBy(merge_ctx, key, val, args);
+            }
+            case REDIS_CMD_TOPKADD:
+            {
+                return MergeTopKAdd(merge_ctx, key, val, args, NULL);
+            }
             case REDIS_CMD_PEXPIREAT:
             {
                 return MergeExpire(merge_ctx, key, val, args[0].GetInt64());
             }
+            case REDIS_CMD_SADD:
+            {
+                return MergeSAdd(merge_ctx, key, val, args[0].GetInt64());
+            }
             default:
             {
                 ERROR_LOG("Not supported merge operation:%u", op);
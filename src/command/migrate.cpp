@@ -30,6 +30,8 @@
 #include "db/db.hpp"
 #include "coro/coro_channel.hpp"
 #include "repl/rdb.hpp"
+#include "repl/repl.hpp"
+#include "bgjobs.hpp"
 
 OP_NAMESPACE_BEGIN
 
@@ -106,6 +108,10 @@ OP_NAMESPACE_BEGIN
                 return 0;
             }
             FlushDB(ctx, ctx.ns);
+            /*
+             * restored chunks are sorted into engine files and added at the end if the engine supports it
+             */
+            m_engine->BeginBulkIngest(ctx, ctx.ns);
             INFO_LOG("RestoreDB %s started, flush it first.", ctx.ns.AsString().c_str());
         }
         else if (!strcasecmp(cmd.GetArguments()[0].c_str(), "end"))
@@ -114,6 +120,13 @@ OP_NAMESPACE_BEGIN
             {
                 return 0;
             }
+            int err = m_engine->EndBulkIngest(ctx, ctx.ns, false);
+            if (0 != err && ERR_NOTSUPPORTED != err)
+            {
+                ctx.GetReply().SetErrorReason("failed to ingest restored data");
+                ERROR_LOG("RestoreDB %s failed to ingest restored data.", ctx.ns.AsString().c_str());
+                return 0;
+            }
             INFO_LOG("RestoreDB %s completed.", ctx.ns.AsString().c_str());
         }
         else if (!strcasecmp(cmd.GetArguments()[0].c_str(), "abort"))
@@ -122,6 +135,7 @@ OP_NAMESPACE_BEGIN
             {
                 return 0;
             }
+            m_engine->EndBulkIngest(ctx, ctx.ns, true);
             FlushDB(ctx, ctx.ns);
             INFO_LOG("RestoreDB %s aborted, flush broken content.", ctx.ns.AsString().c_str());
         }
@@ -217,6 +231,7 @@ OP_NAMESPACE_BEGIN
              */
             if (buffer.ReadableBytes() >= 512 * 1024 || !iter->Valid())
             {
+                obuffer.ArdbWriteKeyCodec();
                 obuffer.ArdbFlushWriteBuffer(buffer);
                 rawset.Clear();
                 rawset.SetCommand("RestoreChunk");
@@ -305,13 +320,34 @@ OP_NAMESPACE_BEGIN
             Data destination_db;
             bool copy;
             bool replace;
+            uint32 running; //raw transfer coroutines not finished
+            uint32 migrated;
+            std::string err;
 
             MigrateContext() :
-                    io_serv(NULL), clientid(0), port(0), timeout(1000), copy(false), replace(false)
+                    io_serv(NULL), clientid(0), port(0), timeout(1000), copy(false), replace(false), running(0), migrated(0)
             {
             }
     };
 
+    static std::string migrate_target_error(RedisReply* reply)
+    {
+        std::string err = "Target instance replied with error:";
+        if (NULL != reply)
+        {
+            const std::string& target_err = reply->Error();
+            if (!target_err.empty() && target_err[0] == '-')
+            {
+                err.append(target_err.c_str() + 1);
+            }
+            else
+            {
+                err.append(target_err);
+            }
+        }
+        return err;
+    }
+
     void Ardb::MigrateCoroTask(void* data)
     {
         Context migtare_dbctx;
@@ -383,20 +419,7 @@ OP_NAMESPACE_BEGIN
                     {
                         if (!r.IsErr())
                         {
-                            std::string err = "Target instance replied with error:";
-                            if (NULL != migrate_reply->at(i))
-                            {
-                                const std::string& target_err = migrate_reply->at(i)->Error();
-                                if (!target_err.empty() && target_err[0] == '-')
-                                {
-                                    err.append(target_err.c_str() + 1);
-                                }
-                                else
-                                {
-                                    err.append(target_err);
-                                }
-                            }
-                            r.SetErrorReason(err);
+                            r.SetErrorReason(migrate_target_error(migrate_reply->at(i)));
                         }
                         migrate_success = false;
                     }
@@ -436,12 +459,319 @@ OP_NAMESPACE_BEGIN
         DELETE(ctx);
     }
 
+    static const size_t kMigrateChunkSize = 512 * 1024;
+
+    /*
+     * Queue the raw entries in 'buffer' as one 'RestoreChunk' command.
+     */
+    static void migrate_add_chunk(Buffer& buffer, RedisCommandFrameArray& cmds)
+    {
+        if (!buffer.Readable())
+        {
+            return;
+        }
+        ObjectBuffer obuffer;
+        obuffer.ArdbWriteKeyCodec();
+        obuffer.ArdbFlushWriteBuffer(buffer);
+        cmds.resize(cmds.size() + 1);
+        RedisCommandFrame& chunk = cmds[cmds.size() - 1];
+        chunk.SetCommand("RestoreChunk");
+        chunk.ReserveArgs(1);
+        chunk.GetMutableArgument(0)->assign(obuffer.GetInternalBuffer().GetRawReadBuffer(), obuffer.GetInternalBuffer().ReadableBytes());
+    }
+
+    /*
+     * Send the queued commands in one round trip, all of them have to succeed.
+     */
+    static bool migrate_send(CoroRedisClient& client, RedisCommandFrameArray& cmds, uint32 timeout, std::string& err)
+    {
+        if (cmds.empty())
+        {
+            return true;
+        }
+        size_t count = cmds.size();
+        RedisReplyArray* replies = client.SyncMultiCall(cmds, timeout);
+        cmds.clear();
+        if (NULL == replies || replies->size() != count)
+        {
+            err = client.IsTimeout() ? "migrate keys timeout." : "migrate keys failed.";
+            return false;
+        }
+        for (size_t i = 0; i < replies->size(); i++)
+        {
+            if (NULL == replies->at(i) || replies->at(i)->IsErr())
+            {
+                err = migrate_target_error(replies->at(i));
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Append the raw entries of 'key' to 'buffer' but its meta which goes to 'meta', so the key does not exist on the
+     * target before its last chunk. A DEL of the key is queued first if 'del' is set and the key exists. Full chunks are
+     * queued to 'cmds', which is sent once 'migrate-pipeline-chunks' chunks are queued. Returns the number of entries,
+     * or -1 if sending failed. The size of the entries is added to 'bytes' if not NULL.
+     */
+    static int64 migrate_raw_key(Context& ctx, Engine* engine, CoroRedisClient& client, uint32 timeout, const KeyObject& key, bool del,
+            Buffer& buffer, Buffer& meta, RedisCommandFrameArray& cmds, std::string& err, int64* bytes = NULL)
+    {
+        ObjectBuffer obuffer;
+        int64 count = 0;
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(key);
+        iter_opts.streaming = true;
+        Iterator* iter = engine->Find(ctx, key, iter_opts);
+        while (NULL != iter && iter->Valid())
+        {
+            KeyObject& k = iter->Key();
+            if (k.GetKey() != key.GetKey() || k.GetNameSpace() != key.GetNameSpace())
+            {
+                break;
+            }
+            if (0 == count && del)
+            {
+                cmds.resize(cmds.size() + 1);
+                cmds[cmds.size() - 1].SetCommand("del");
+                cmds[cmds.size() - 1].AddArg(key.GetKey().AsString());
+            }
+            if (k.GetType() == KEY_META)
+            {
+                obuffer.ArdbSaveRawKeyValue(iter->RawKey(), iter->RawValue(), meta, iter->Value().GetTTL());
+            }
+            else
+            {
+                obuffer.ArdbSaveRawKeyValue(iter->RawKey(), iter->RawValue(), buffer, 0);
+            }
+            if (NULL != bytes)
+            {
+                *bytes += iter->RawKey().size() + iter->RawValue().size();
+            }
+            count++;
+            iter->Next();
+            if (buffer.ReadableBytes() >= kMigrateChunkSize)
+            {
+                migrate_add_chunk(buffer, cmds);
+                if (cmds.size() >= (size_t) g_db->GetConf().migrate_pipeline_chunks && !migrate_send(client, cmds, timeout, err))
+                {
+                    count = -1;
+                    break;
+                }
+            }
+        }
+        DELETE(iter);
+        return count;
+    }
+
+    struct MigrateRawTask
+    {
+            MigrateContext* ctx;
+            KeyObjectArray keys;
+
+            MigrateRawTask() :
+                    ctx(NULL)
+            {
+            }
+    };
+
+    /*
+     * Migrate a range of the keys of one MIGRATE call to an ardb target by their raw engine entries. Keys are
+     * watched and copied without lock, the keys of one final chunk are then locked together, keys written in
+     * between are sent again under the lock, and removed once the target has all chunks.
+     */
+    void Ardb::MigrateRawCoroTask(void* data)
+    {
+        MigrateRawTask* task = (MigrateRawTask*) data;
+        MigrateContext* ctx = task->ctx;
+        Context migtare_dbctx;
+        migtare_dbctx.ns = ctx->src_db;
+        std::string err;
+        uint32 migrated = 0;
+        RedisCommandFrameArray cmds;
+        Buffer chunk;
+        std::vector<bool> busy(task->keys.size(), false);
+        CoroRedisClient redis_client(ctx->io_serv->NewClientSocketChannel());
+        redis_client.Init();
+        SocketHostAddress remote_address(ctx->host, ctx->port);
+        bool success = redis_client.SyncConnect(&remote_address, ctx->timeout);
+
+        //1. select & find the keys existing on target unless REPLACE
+        if (success)
+        {
+            cmds.resize(1);
+            cmds[0].SetCommand("select");
+            cmds[0].AddArg(ctx->destination_db.AsString());
+            for (size_t i = 0; !ctx->replace && i < task->keys.size(); i++)
+            {
+                cmds.resize(cmds.size() + 1);
+                cmds[cmds.size() - 1].SetCommand("exists");
+                cmds[cmds.size() - 1].AddArg(task->keys[i].GetKey().AsString());
+            }
+            RedisReplyArray* replies = redis_client.SyncMultiCall(cmds, ctx->timeout);
+            if (NULL == replies || replies->size() != cmds.size() || NULL == replies->at(0) || replies->at(0)->IsErr())
+            {
+                if (NULL != replies && replies->size() == cmds.size())
+                {
+                    err = migrate_target_error(replies->at(0));
+                }
+                else if (redis_client.IsTimeout())
+                {
+                    err = "migrate keys timeout.";
+                }
+                success = false;
+            }
+            for (size_t i = 1; success && i < replies->size(); i++)
+            {
+                if (NULL != replies->at(i) && replies->at(i)->type == REDIS_REPLY_INTEGER && replies->at(i)->integer > 0)
+                {
+                    busy[i - 1] = true;
+                    if (ctx->err.empty())
+                    {
+                        ctx->err = "Target instance replied with error:BUSYKEY Target key name already exists.";
+                    }
+                }
+            }
+            cmds.clear();
+        }
+
+        //2. copy keys without lock, cut over the keys of each final chunk
+        std::vector<size_t> group;
+        std::vector<std::string> tails;
+        size_t group_bytes = 0;
+        for (size_t i = 0; success && i <= task->keys.size(); i++)
+        {
+            if (i < task->keys.size())
+            {
+                if (busy[i])
+                {
+                    continue;
+                }
+                const KeyObject& key = task->keys[i];
+                Buffer buffer, meta;
+                g_db->WatchForKey(migtare_dbctx, key.GetKey().AsString());
+                int64 count = migrate_raw_key(migtare_dbctx, g_db->m_engine, redis_client, ctx->timeout, key, ctx->replace, buffer, meta, cmds, err);
+                if (count < 0)
+                {
+                    success = false;
+                    break;
+                }
+                if (count > 0)
+                {
+                    buffer.Write(meta.GetRawReadBuffer(), meta.ReadableBytes());
+                    group.push_back(i);
+                    tails.push_back(std::string(buffer.GetRawReadBuffer(), buffer.ReadableBytes()));
+                    group_bytes += tails.back().size();
+                }
+                if (group_bytes < kMigrateChunkSize)
+                {
+                    continue;
+                }
+            }
+            if (group.empty())
+            {
+                continue;
+            }
+            KeyObjectArray lock_keys;
+            for (size_t j = 0; j < group.size(); j++)
+            {
+                lock_keys.push_back(task->keys[group[j]]);
+            }
+            {
+                KeysLockGuard guard(migtare_dbctx, lock_keys);
+                std::vector<bool> exists(group.size(), true);
+                for (size_t j = 0; j < group.size(); j++)
+                {
+                    const KeyObject& key = task->keys[group[j]];
+                    if (g_db->WatchedKeyTouched(migtare_dbctx, key.GetKey()))
+                    {
+                        /*
+                         * drop the chunks sent without lock, the key may also be deleted meanwhile
+                         */
+                        Buffer meta;
+                        cmds.resize(cmds.size() + 1);
+                        cmds[cmds.size() - 1].SetCommand("del");
+                        cmds[cmds.size() - 1].AddArg(key.GetKey().AsString());
+                        int64 count = migrate_raw_key(migtare_dbctx, g_db->m_engine, redis_client, ctx->timeout, key, false, chunk, meta, cmds, err);
+                        if (count < 0)
+                        {
+                            success = false;
+                            break;
+                        }
+                        exists[j] = count > 0;
+                        chunk.Write(meta.GetRawReadBuffer(), meta.ReadableBytes());
+                    }
+                    else
+                    {
+                        chunk.Write(tails[j].data(), tails[j].size());
+                    }
+                    if (chunk.ReadableBytes() >= kMigrateChunkSize)
+                    {
+                        migrate_add_chunk(chunk, cmds);
+                    }
+                }
+                if (success)
+                {
+                    migrate_add_chunk(chunk, cmds);
+                    success = migrate_send(redis_client, cmds, ctx->timeout, err);
+                }
+                for (size_t j = 0; success && j < group.size(); j++)
+                {
+                    if (exists[j])
+                    {
+                        if (!ctx->copy)
+                        {
+                            g_db->DelKey(migtare_dbctx, task->keys[group[j]]);
+                        }
+                        migrated++;
+                    }
+                }
+            }
+            g_db->UnwatchKeys(migtare_dbctx);
+            group.clear();
+            tails.clear();
+            group_bytes = 0;
+        }
+        g_db->UnwatchKeys(migtare_dbctx);
+        redis_client.Close();
+        if (!success && ctx->err.empty())
+        {
+            ctx->err = err.empty() ? "migrate keys failed." : err;
+        }
+        ctx->migrated += migrated;
+        DELETE(task);
+        if (--ctx->running > 0)
+        {
+            return;
+        }
+        RedisReply r;
+        if (!ctx->err.empty())
+        {
+            r.SetErrorReason(ctx->err);
+        }
+        else if (0 == ctx->migrated)
+        {
+            r.SetStatusCode(STATUS_NOKEY);
+        }
+        else
+        {
+            r.SetStatusCode(STATUS_OK);
+        }
+        Channel* src_client = ctx->io_serv->GetChannel(ctx->clientid);
+        if (NULL != src_client)
+        {
+            src_client->Write(r);
+            src_client->UnblockRead();
+        }
+        DELETE(ctx);
+    }
+
     int Ardb::Migrate(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
         const std::string& host = cmd.GetArguments()[0];
         uint32 port;
-        int copy = 0, replace = 0;
+        int copy = 0, replace = 0, raw = GetConf().migrate_raw_transfer;
         int64 timeout;
         if (!string_toint64(cmd.GetArguments()[4], timeout) || !string_touint32(cmd.GetArguments()[1], port))
         {
@@ -465,6 +795,10 @@ OP_NAMESPACE_BEGIN
             {
                 replace = 1;
             }
+            else if (!strcasecmp(cmd.GetArguments()[j].c_str(), "raw"))
+            {
+                raw = 1;
+            }
             else if (!strcasecmp(cmd.GetArguments()[j].c_str(), "keys"))
             {
                 if (cmd.GetArguments()[2].size() != 0)
@@ -500,10 +834,585 @@ OP_NAMESPACE_BEGIN
         migrate_ctx->destination_db.SetString(cmd.GetArguments()[3], false);
         migrate_ctx->src_db = ctx.ns;
         ctx.client->client->BlockRead(); //do not read any data from client until the migrate task finish
-        Scheduler::CurrentScheduler().StartCoro(0, MigrateCoroTask, migrate_ctx);
+        /*
+         * fields of hashes keyed by object id are out of the key ranges, those are migrated by RESTORE
+         */
+        if (raw && !ObjectIdEnabled())
+        {
+            size_t tasks = std::min(migrate_ctx->keys.size(), (size_t) GetConf().migrate_parallel_tasks);
+            tasks = tasks > 0 ? tasks : 1;
+            migrate_ctx->running = tasks;
+            for (size_t i = 0; i < tasks; i++)
+            {
+                MigrateRawTask* task = NULL;
+                NEW(task, MigrateRawTask);
+                task->ctx = migrate_ctx;
+                task->keys.assign(migrate_ctx->keys.begin() + i * migrate_ctx->keys.size() / tasks,
+                        migrate_ctx->keys.begin() + (i + 1) * migrate_ctx->keys.size() / tasks);
+                Scheduler::CurrentScheduler().StartCoro(0, MigrateRawCoroTask, task);
+            }
+        }
+        else
+        {
+            Scheduler::CurrentScheduler().StartCoro(0, MigrateCoroTask, migrate_ctx);
+        }
         reply.type = 0; //let coroutine task to reply client
         return 0;
     }
 
+    /*
+     * Keys written during a rebalance are copied again while at least this many are found, fewer are copied after
+     * its range is frozen.
+     */
+    static const size_t kRebalanceFrozenCopyKeys = 128;
+    static const int kRebalanceCatchupRounds = 16;
+
+    static bool rebalance_in_range(const Ardb::RebalanceState& state, const std::string& key)
+    {
+        if (state.start_slot < 0)
+        {
+            return true;
+        }
+        int32 slot = key_hash_slot(key.data(), key.size());
+        return slot >= state.start_slot && slot <= state.end_slot;
+    }
+
+    /*
+     * Sleep while the copied bytes or entries are ahead of the budgets per second since the rebalance started.
+     */
+    static void rebalance_throttle(CoroRedisClient& client, Ardb::RebalanceState& state)
+    {
+        int64 elapsed = get_current_epoch_millis() - state.start_time;
+        int64 ahead = 0;
+        if (state.max_bytes_per_sec > 0)
+        {
+            ahead = std::max(ahead, state.copied_bytes * 1000 / state.max_bytes_per_sec - elapsed);
+        }
+        if (state.max_ops_per_sec > 0)
+        {
+            ahead = std::max(ahead, state.copied_entries * 1000 / state.max_ops_per_sec - elapsed);
+        }
+        /*
+         * the copied bytes also wait for the io budget shared with the other background writers
+         */
+        ahead = std::max(ahead, (int64) (BackgroundJobs::GetSingleton().Acquire(state.copied_bytes - state.charged_bytes) / 1000));
+        state.charged_bytes = state.copied_bytes;
+        if (ahead > 0)
+        {
+            client.SyncSleep(std::min(ahead, (int64) 1000));
+        }
+    }
+
+    static int rebalance_read_wal(const void* log, size_t loglen, void* data)
+    {
+        Buffer* wal = (Buffer*) data;
+        wal->Write(log, loglen);
+        return 0;
+    }
+
+    /*
+     * Copy the keys again, each replaces the key on the target, or deletes it there if it is gone here.
+     */
+    static bool rebalance_copy_keys(Context& ctx, Engine* engine, CoroRedisClient& client, Ardb::RebalanceState& state, const StringTreeSet& keys,
+            bool throttle, RedisCommandFrameArray& cmds, Buffer& chunk, std::string& err)
+    {
+        StringTreeSet::const_iterator it = keys.begin();
+        while (it != keys.end())
+        {
+            if (state.abort)
+            {
+                err = "rebalance aborted.";
+                return false;
+            }
+            KeyObject key(state.ns, KEY_META, *it);
+            Buffer meta;
+            cmds.resize(cmds.size() + 1);
+            cmds[cmds.size() - 1].SetCommand("del");
+            cmds[cmds.size() - 1].AddArg(*it);
+            int64 count = migrate_raw_key(ctx, engine, client, state.timeout, key, false, chunk, meta, cmds, err, &state.copied_bytes);
+            if (count < 0)
+            {
+                return false;
+            }
+            chunk.Write(meta.GetRawReadBuffer(), meta.ReadableBytes());
+            state.copied_entries += count;
+            state.catchup_keys++;
+            if (chunk.ReadableBytes() >= kMigrateChunkSize)
+            {
+                migrate_add_chunk(chunk, cmds);
+                if (throttle)
+                {
+                    rebalance_throttle(client, state);
+                }
+            }
+            if (cmds.size() >= (size_t) g_db->GetConf().migrate_pipeline_chunks && !migrate_send(client, cmds, state.timeout, err))
+            {
+                return false;
+            }
+            it++;
+        }
+        migrate_add_chunk(chunk, cmds);
+        return migrate_send(client, cmds, state.timeout, err);
+    }
+
+    /*
+     * Add the keys of the rebalanced range written since 'state.wal_offset' to 'keys', 'wal_ns' is the db selected at
+     * that offset if known. Fails if the backlog does not hold the writes anymore, or the db was flushed.
+     */
+    bool Ardb::RebalanceWrittenKeys(RebalanceState& state, Buffer& wal, std::string& wal_ns, StringTreeSet& keys, std::string& err)
+    {
+        ReplicationBacklog& backlog = g_repl->GetReplLog();
+        uint64 end = backlog.WALEndOffset();
+        const std::string ns = state.ns.AsString();
+        while (state.wal_offset < end)
+        {
+            if (state.wal_offset < backlog.WALStartOffset())
+            {
+                err = "writes during the rebalance overran the replication backlog, increase repl-backlog-size.";
+                return false;
+            }
+            size_t readable = wal.ReadableBytes();
+            backlog.Replay(state.wal_offset, std::min(end - state.wal_offset, (uint64) kMigrateChunkSize), rebalance_read_wal, &wal);
+            if (wal.ReadableBytes() == readable)
+            {
+                err = "failed to read the replication backlog.";
+                return false;
+            }
+            state.wal_offset += wal.ReadableBytes() - readable;
+            while (wal.Readable())
+            {
+                RedisCommandFrame msg;
+                if (!RedisCommandDecoder::Decode(NULL, wal, msg))
+                {
+                    break;
+                }
+                RedisCommandHandlerSetting* setting = FindRedisCommandHandlerSetting(msg);
+                if (NULL == setting)
+                {
+                    continue;
+                }
+                if (setting->type == REDIS_CMD_SELECT)
+                {
+                    wal_ns = msg.GetArguments().empty() ? "" : msg.GetArguments()[0];
+                    continue;
+                }
+                if (setting->type == REDIS_CMD_FLUSHALL || (setting->type == REDIS_CMD_FLUSHDB && (wal_ns.empty() || wal_ns == ns)))
+                {
+                    err = "the db was flushed during the rebalance.";
+                    return false;
+                }
+                /*
+                 * writes before the first select are taken as writes of the rebalanced db
+                 */
+                if (!wal_ns.empty() && wal_ns != ns)
+                {
+                    continue;
+                }
+                StringArray cmd_keys;
+                GetCommandKeys(msg, cmd_keys);
+                for (size_t i = 0; i < cmd_keys.size(); i++)
+                {
+                    if (rebalance_in_range(state, cmd_keys[i]))
+                    {
+                        keys.insert(cmd_keys[i]);
+                    }
+                }
+            }
+            wal.DiscardReadedBytes();
+        }
+        return true;
+    }
+
+    /*
+     * Copy the db/slot range without lock, then copy the keys written meanwhile(found in the replication backlog)
+     * again until few are left. The range is then frozen, the in-flight writes are drained & the last written keys
+     * copied before its ownership flips to the target.
+     */
+    void Ardb::RebalanceCoroTask(void* data)
+    {
+        RebalanceState* state = (RebalanceState*) data;
+        Context rebalance_ctx;
+        rebalance_ctx.ns = state->ns;
+        std::string err;
+        std::string wal_ns;
+        RedisCommandFrameArray cmds;
+        Buffer chunk, wal;
+        StringTreeSet written;
+        ObjectBuffer obuffer;
+        Engine* engine = g_db->m_engine;
+        CoroRedisClient redis_client(state->io_serv->NewClientSocketChannel());
+        redis_client.Init();
+        SocketHostAddress remote_address(state->host, state->port);
+
+        g_repl->GetReplLog().WaitWALWritten();
+        state->wal_offset = g_repl->GetReplLog().WALEndOffset();
+        state->start_time = get_current_epoch_millis();
+        state->estimated_keys = engine->EstimateKeysNum(rebalance_ctx, state->ns);
+        if (state->start_slot >= 0)
+        {
+            state->estimated_keys = state->estimated_keys * (state->end_slot - state->start_slot + 1) / kClusterSlots;
+        }
+        bool success = redis_client.SyncConnect(&remote_address, state->timeout);
+        if (success)
+        {
+            cmds.resize(1);
+            cmds[0].SetCommand("select");
+            cmds[0].AddArg(state->ns.AsString());
+            success = migrate_send(redis_client, cmds, state->timeout, err);
+        }
+
+        //1. copy the range
+        if (success)
+        {
+            KeyObject start(state->ns, KEY_META, "");
+            IterateOptions iter_opts;
+            iter_opts.streaming = true;
+            if (state->start_slot >= 0 && get_key_codec_version() == KEY_CODEC_V3)
+            {
+                start.SetSlot(state->start_slot);
+                iter_opts.lower_bound = start;
+                if (state->end_slot + 1 < (int32) kClusterSlots)
+                {
+                    iter_opts.upper_bound = start;
+                    iter_opts.upper_bound.SetSlot(state->end_slot + 1);
+                }
+            }
+            Iterator* iter = engine->Find(rebalance_ctx, start, iter_opts);
+            std::string current_key;
+            bool in_range = false;
+            while (success && NULL != iter && iter->Valid())
+            {
+                KeyObject& k = iter->Key();
+                if (k.GetNameSpace() != state->ns)
+                {
+                    break;
+                }
+                if (current_key.empty() || k.GetKey().StringLength() != current_key.size()
+                        || memcmp(k.GetKey().CStr(), current_key.data(), current_key.size()) != 0)
+                {
+                    current_key = k.GetKey().AsString();
+                    in_range = rebalance_in_range(*state, current_key);
+                }
+                if (in_range)
+                {
+                    if (k.GetType() == KEY_META)
+                    {
+                        state->copied_keys++;
+                    }
+                    obuffer.ArdbSaveRawKeyValue(iter->RawKey(), iter->RawValue(), chunk, k.GetType() == KEY_META ? iter->Value().GetTTL() : 0);
+                    state->copied_entries++;
+                    state->copied_bytes += iter->RawKey().size() + iter->RawValue().size();
+                }
+                iter->Next();
+                if (chunk.ReadableBytes() >= kMigrateChunkSize)
+                {
+                    migrate_add_chunk(chunk, cmds);
+                    if (cmds.size() >= (size_t) g_db->GetConf().migrate_pipeline_chunks)
+                    {
+                        success = migrate_send(redis_client, cmds, state->timeout, err);
+                    }
+                    rebalance_throttle(redis_client, *state);
+                }
+                if (state->abort)
+                {
+                    err = "rebalance aborted.";
+                    success = false;
+                }
+            }
+            DELETE(iter);
+            if (success)
+            {
+                migrate_add_chunk(chunk, cmds);
+                success = migrate_send(redis_client, cmds, state->timeout, err);
+            }
+        }
+
+        //2. copy the keys written meanwhile again
+        state->phase = "catching up";
+        for (int round = 0; success && round < kRebalanceCatchupRounds; round++)
+        {
+            written.clear();
+            g_repl->GetReplLog().WaitWALWritten();
+            success = g_db->RebalanceWrittenKeys(*state, wal, wal_ns, written, err)
+                    && rebalance_copy_keys(rebalance_ctx, engine, redis_client, *state, written, true, cmds, chunk, err);
+            if ((size_t) written.size() < kRebalanceFrozenCopyKeys)
+            {
+                break;
+            }
+        }
+
+        //3. freeze the range, drain the in-flight writes & copy the last written keys
+        if (success)
+        {
+            state->phase = "frozen";
+            g_db->m_rebalance_frozen = true;
+            uint64 drain_start = get_current_epoch_millis();
+            while (g_db->m_rebalance_writes > 0 && get_current_epoch_millis() - drain_start < state->timeout)
+            {
+                redis_client.SyncSleep(1);
+            }
+            if (g_db->m_rebalance_writes > 0)
+            {
+                err = "in-flight writes not drained in time.";
+                success = false;
+            }
+        }
+        if (success)
+        {
+            written.clear();
+            g_repl->GetReplLog().WaitWALWritten();
+            success = g_db->RebalanceWrittenKeys(*state, wal, wal_ns, written, err)
+                    && rebalance_copy_keys(rebalance_ctx, engine, redis_client, *state, written, false, cmds, chunk, err);
+        }
+
+        //4. flip the ownership, the keys of moved slots are removed
+        if (success && state->start_slot >= 0)
+        {
+            {
+                WriteLockGuard<BigReaderLock> guard(g_db->m_cluster_lock);
+                uint16 node = g_db->GetClusterNode(state->host + ":" + stringfromll(state->port));
+                for (int32 slot = state->start_slot; slot <= state->end_slot; slot++)
+                {
+                    g_db->m_cluster_slots[slot] = node;
+                    g_db->m_cluster_migrating.erase(slot);
+                    g_db->m_cluster_importing.erase(slot);
+                }
+            }
+            g_db->m_rebalance_frozen = false;
+            g_db->ClusterTopologyChanged(rebalance_ctx);
+            state->phase = "deleting";
+            std::string last_key;
+            StringArray moved_keys;
+            do
+            {
+                moved_keys.clear();
+                KeyObject start(state->ns, KEY_META, last_key);
+                IterateOptions iter_opts;
+                iter_opts.streaming = true;
+                if (get_key_codec_version() == KEY_CODEC_V3 && last_key.empty())
+                {
+                    start.SetSlot(state->start_slot);
+                }
+                Iterator* iter = engine->Find(rebalance_ctx, start, iter_opts);
+                while (NULL != iter && iter->Valid() && moved_keys.size() < 1024)
+                {
+                    KeyObject& k = iter->Key();
+                    if (k.GetNameSpace() != state->ns || (get_key_codec_version() == KEY_CODEC_V3 && k.GetSlot() > state->end_slot))
+                    {
+                        break;
+                    }
+                    if (k.GetType() == KEY_META && rebalance_in_range(*state, k.GetKey().AsString()))
+                    {
+                        moved_keys.push_back(k.GetKey().AsString());
+                    }
+                    iter->Next();
+                }
+                DELETE(iter);
+                for (size_t i = 0; i < moved_keys.size(); i++)
+                {
+                    g_db->DelKey(rebalance_ctx, moved_keys[i]);
+                }
+                if (!moved_keys.empty())
+                {
+                    last_key = moved_keys.back();
+                    state->copied_entries += moved_keys.size();
+                    rebalance_throttle(redis_client, *state);
+                }
+            } while (moved_keys.size() >= 1024);
+        }
+        redis_client.Close();
+        {
+            LockGuard<SpinMutexLock> guard(g_db->m_rebalance_lock);
+            state->end_time = get_current_epoch_millis();
+            state->phase = success ? "done" : (state->abort ? "aborted" : "failed");
+            state->error = success ? "" : (err.empty() ? "rebalance failed." : err);
+            /*
+             * a moved db stays frozen until it is flushed
+             */
+            if (!success || state->start_slot >= 0)
+            {
+                g_db->m_rebalance_frozen = false;
+            }
+            g_db->m_rebalancing = false;
+        }
+        if (success)
+        {
+            INFO_LOG("Rebalance of db %s to %s:%u done, %lld keys copied & %lld copied again.", state->ns.AsString().c_str(), state->host.c_str(), state->port,
+                    state->copied_keys, state->catchup_keys);
+        }
+        else
+        {
+            WARN_LOG("Rebalance of db %s to %s:%u failed:%s", state->ns.AsString().c_str(), state->host.c_str(), state->port, state->error.c_str());
+        }
+    }
+
+    void Ardb::RebalanceInfo(std::string& info)
+    {
+        LockGuard<SpinMutexLock> guard(m_rebalance_lock);
+        if (NULL == m_rebalance)
+        {
+            info.append("rebalance_status:none\r\n");
+            return;
+        }
+        const RebalanceState& state = *m_rebalance;
+        uint64 now = state.end_time > 0 ? state.end_time : get_current_epoch_millis();
+        int64 elapsed = state.start_time > 0 ? now - state.start_time : 0;
+        int64 progress = state.estimated_keys > 0 ? std::min(state.copied_keys * 100 / state.estimated_keys, (int64) 99) : 0;
+        int64 eta = 0;
+        if (state.end_time > 0)
+        {
+            progress = state.error.empty() ? 100 : progress;
+        }
+        else if (state.copied_keys > 0 && state.estimated_keys > state.copied_keys)
+        {
+            eta = elapsed * (state.estimated_keys - state.copied_keys) / state.copied_keys / 1000;
+        }
+        info.append("rebalance_status:").append(state.phase).append("\r\n");
+        info.append("rebalance_target:").append(state.host).append(":").append(stringfromll(state.port)).append("\r\n");
+        info.append("rebalance_db:").append(state.ns.AsString()).append("\r\n");
+        if (state.start_slot >= 0)
+        {
+            info.append("rebalance_slots:").append(stringfromll(state.start_slot)).append("-").append(stringfromll(state.end_slot)).append("\r\n");
+        }
+        info.append("rebalance_estimated_keys:").append(stringfromll(state.estimated_keys)).append("\r\n");
+        info.append("rebalance_copied_keys:").append(stringfromll(state.copied_keys)).append("\r\n");
+        info.append("rebalance_copied_bytes:").append(stringfromll(state.copied_bytes)).append("\r\n");
+        info.append("rebalance_catchup_keys:").append(stringfromll(state.catchup_keys)).append("\r\n");
+        if (m_rebalancing && g_repl->IsInited())
+        {
+            info.append("rebalance_backlog_lag:").append(stringfromll(g_repl->GetReplLog().WALEndOffset() - state.wal_offset)).append("\r\n");
+        }
+        info.append("rebalance_progress:").append(stringfromll(progress)).append("%\r\n");
+        info.append("rebalance_elapsed_sec:").append(stringfromll(elapsed / 1000)).append("\r\n");
+        info.append("rebalance_eta_sec:").append(stringfromll(eta)).append("\r\n");
+        if (!state.error.empty())
+        {
+            info.append("rebalance_error:").append(state.error).append("\r\n");
+        }
+    }
+
+    /*
+     * REBALANCE <host> <port> [SLOTS <start> <end>] [MAXMB <n>] [MAXOPS <n>] [TIMEOUT <ms>]
+     * REBALANCE STATUS|ABORT
+     */
+    int Ardb::Rebalance(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        if (args.size() == 1 && !strcasecmp(args[0].c_str(), "status"))
+        {
+            std::string info;
+            RebalanceInfo(info);
+            reply.SetString(info);
+            return 0;
+        }
+        if (args.size() == 1 && !strcasecmp(args[0].c_str(), "abort"))
+        {
+            LockGuard<SpinMutexLock> guard(m_rebalance_lock);
+            if (!m_rebalancing)
+            {
+                reply.SetErrorReason("no rebalance in progress");
+                return 0;
+            }
+            m_rebalance->abort = true;
+            reply.SetStatusCode(STATUS_OK);
+            return 0;
+        }
+        uint32 port;
+        if (args.size() < 2 || !string_touint32(args[1], port) || port > 65535)
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
+        RebalanceState* state = NULL;
+        NEW(state, RebalanceState);
+        state->ns.SetString(ctx.ns.AsString(), false);
+        state->host = args[0];
+        state->port = port;
+        state->timeout = 10000;
+        state->max_bytes_per_sec = GetConf().rebalance_max_mb_per_sec * 1024 * 1024;
+        state->max_ops_per_sec = GetConf().rebalance_max_ops_per_sec;
+        for (size_t i = 2; i < args.size(); i++)
+        {
+            uint32 start, end;
+            int64 v;
+            if (!strcasecmp(args[i].c_str(), "slots") && i + 2 < args.size() && string_touint32(args[i + 1], start) && string_touint32(args[i + 2], end)
+                    && start <= end && end < kClusterSlots)
+            {
+                state->start_slot = start;
+                state->end_slot = end;
+                i += 2;
+            }
+            else if (!strcasecmp(args[i].c_str(), "maxmb") && i + 1 < args.size() && string_toint64(args[i + 1], v) && v >= 0)
+            {
+                state->max_bytes_per_sec = v * 1024 * 1024;
+                i++;
+            }
+            else if (!strcasecmp(args[i].c_str(), "maxops") && i + 1 < args.size() && string_toint64(args[i + 1], v) && v >= 0)
+            {
+                state->max_ops_per_sec = v;
+                i++;
+            }
+            else if (!strcasecmp(args[i].c_str(), "timeout") && i + 1 < args.size() && string_toint64(args[i + 1], v) && v > 0)
+            {
+                state->timeout = v;
+                i++;
+            }
+            else
+            {
+                DELETE(state);
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        if (state->start_slot >= 0 && !GetConf().cluster_enabled)
+        {
+            reply.SetErrorReason("REBALANCE SLOTS needs cluster-enabled");
+        }
+        else if (!GetConf().master_host.empty())
+        {
+            reply.SetErrorReason("REBALANCE is not allowed on a slave");
+        }
+        else if (!g_repl->IsInited())
+        {
+            reply.SetErrorReason("REBALANCE needs the replication backlog");
+        }
+        else if (ObjectIdEnabled())
+        {
+            reply.SetErrorReason("REBALANCE does not work with hash-object-id");
+        }
+        if (reply.IsErr())
+        {
+            DELETE(state);
+            return 0;
+        }
+        {
+            LockGuard<SpinMutexLock> guard(m_rebalance_lock);
+            if (m_rebalancing)
+            {
+                reply.SetErrorReason("rebalance already in progress");
+            }
+            else if (m_rebalance_frozen)
+            {
+                reply.SetErrorReason("db " + m_rebalance->ns.AsString() + " moved by the last rebalance is not flushed");
+            }
+            else
+            {
+                DELETE(m_rebalance);
+                m_rebalance = state;
+                m_rebalancing = true;
+            }
+        }
+        if (reply.IsErr())
+        {
+            DELETE(state);
+            return 0;
+        }
+        state->io_serv = &(ctx.client->client->GetService());
+        Scheduler::CurrentScheduler().StartCoro(0, RebalanceCoroTask, state);
+        reply.SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
 OP_NAMESPACE_END
 
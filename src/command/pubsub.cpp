@@ -28,9 +28,18 @@
  */
 
 #include "db/db.hpp"
+#include "util/atomic.hpp"
+#include "util/murmur3.h"
 
 namespace ardb
 {
+    Ardb::PubSubShard& Ardb::GetPubSubShard(const std::string& channel)
+    {
+        uint32 hash = 0;
+        MurmurHash3_x86_32(channel.data(), channel.size(), 0, &hash);
+        return m_pubsub_shards[hash % kPubSubShards];
+    }
+
     int Ardb::SubscribeChannel(Context& ctx, const std::string& channel, bool is_pattern)
     {
         if (is_pattern)
@@ -41,17 +50,21 @@ namespace ardb
         {
             ctx.GetPubsub().pubsub_channels.insert(channel);
         }
+        if (is_pattern)
         {
-            WriteLockGuard<SpinRWLock> guard(m_pubsub_lock);
-            if (is_pattern)
-            {
-                m_pubsub_patterns[channel].insert(&ctx);
-            }
-            else
+            WriteLockGuard<BigReaderLock> guard(m_pubsub_pattern_lock);
+            ContextSet& subscribers = m_pubsub_patterns[channel];
+            if (subscribers.empty())
             {
-                m_pubsub_channels[channel].insert(&ctx);
+                m_pubsub_pattern_index.Add(channel);
             }
-
+            subscribers.insert(&ctx);
+        }
+        else
+        {
+            PubSubShard& shard = GetPubSubShard(channel);
+            WriteLockGuard<BigReaderLock> guard(shard.lock);
+            shard.channels[channel].insert(&ctx);
         }
 
         RedisReply r;
@@ -71,27 +84,37 @@ namespace ardb
             return 0;
         }
         PubSubChannelTable* tables = NULL;
+        BigReaderLock* lock = NULL;
         if (is_pattern)
         {
             ctx.GetPubsub().pubsub_patterns.erase(channel);
             tables = &m_pubsub_patterns;
+            lock = &m_pubsub_pattern_lock;
         }
         else
         {
             ctx.GetPubsub().pubsub_channels.erase(channel);
-            tables = &m_pubsub_channels;
+            PubSubShard& shard = GetPubSubShard(channel);
+            tables = &shard.channels;
+            lock = &shard.lock;
         }
-        WriteLockGuard<SpinRWLock> guard(m_pubsub_lock);
-        PubSubChannelTable::iterator it = tables->find(channel);
         int ret = 0;
-        if (it != tables->end())
         {
-            it->second.erase(&ctx);
-            if (it->second.empty())
+            WriteLockGuard<BigReaderLock> guard(*lock);
+            PubSubChannelTable::iterator it = tables->find(channel);
+            if (it != tables->end())
             {
-                tables->erase(it);
+                it->second.erase(&ctx);
+                if (it->second.empty())
+                {
+                    tables->erase(it);
+                    if (is_pattern)
+                    {
+                        m_pubsub_pattern_index.Remove(channel);
+                    }
+                }
+                ret = 1;
             }
-            ret = 1;
         }
         if (notify)
         {
@@ -146,7 +169,10 @@ namespace ardb
 
     int Ardb::Subscribe(Context& ctx, RedisCommandFrame& cmd)
     {
-//        ctx.client->client->GetWritableOptions().max_write_buffer_size = (int32) (m_cfg.pubsub_client_output_buffer_limit);
+        if (NULL != ctx.client && NULL != ctx.client->client)
+        {
+            ctx.client->client->SetOutputLimits(0, (uint32) GetConf().pubsub_client_output_buffer_limit);
+        }
         ctx.GetReply().SetEmpty(); //let cleint not write this reply
         for (uint32 i = 0; i < cmd.GetArguments().size(); i++)
         {
@@ -178,7 +204,10 @@ namespace ardb
     }
     int Ardb::PSubscribe(Context& ctx, RedisCommandFrame& cmd)
     {
-//        ctx.client->GetWritableOptions().max_write_buffer_size = (int32)(m_cfg.pubsub_client_output_buffer_limit);
+        if (NULL != ctx.client && NULL != ctx.client->client)
+        {
+            ctx.client->client->SetOutputLimits(0, (uint32) GetConf().pubsub_client_output_buffer_limit);
+        }
         ctx.GetReply().SetEmpty(); //let cleint not write this reply
         for (uint32 i = 0; i < cmd.GetArguments().size(); i++)
         {
@@ -208,64 +237,483 @@ namespace ardb
         return 0;
     }
 
-    int Ardb::PublishMessage(Context& ctx, const std::string& channel, const std::string& message)
+    /*
+     * The messages of one PUBLISH are encoded once & shared by the event loop threads of all receivers,
+     * every thread gets one batch of writes, the last batch done frees the messages.
+     */
+    struct PublishFanout
     {
-        ReadLockGuard<SpinRWLock> guard(m_pubsub_lock);
-        PubSubChannelTable::iterator fit = m_pubsub_channels.find(channel);
+            std::vector<std::string> messages;
+            volatile uint32_t batches;
+            PublishFanout() :
+                    batches(0)
+            {
+            }
+    };
+
+    struct PublishBatch
+    {
+            ChannelService* serv;
+            PublishFanout* fanout;
+            std::vector<std::pair<size_t, uint32> > writes; //message index & channel id
+            PublishBatch(ChannelService* s, PublishFanout* f) :
+                    serv(s), fanout(f)
+            {
+            }
+    };
+    typedef std::map<ChannelService*, PublishBatch*> PublishBatchTable;
+
+    static size_t encode_published(PublishFanout& fanout, const std::string* pattern, const std::string& channel, const std::string& message)
+    {
+        RedisReply r;
+        r.AddMember().SetString(NULL != pattern ? "pmessage" : "message");
+        if (NULL != pattern)
+        {
+            r.AddMember().SetString(*pattern);
+        }
+        r.AddMember().SetString(channel);
+        r.AddMember().SetString(message);
+        Buffer buf;
+        RedisReplyEncoder::Encode(buf, r);
+        fanout.messages.push_back(std::string(buf.GetRawReadBuffer(), buf.ReadableBytes()));
+        return fanout.messages.size() - 1;
+    }
+
+    static int add_published(PublishBatchTable& batches, PublishFanout* fanout, const ContextSet& receivers, size_t msg_idx)
+    {
+        int count = 0;
+        ContextSet::const_iterator cit = receivers.begin();
+        while (cit != receivers.end())
+        {
+            Context* cc = *cit;
+            if (NULL != cc && cc->client != NULL && NULL != cc->client->client)
+            {
+                Channel* ch = cc->client->client;
+                PublishBatch*& batch = batches[&ch->GetService()];
+                if (NULL == batch)
+                {
+                    NEW(batch, PublishBatch(&ch->GetService(), fanout));
+                }
+                batch->writes.push_back(std::make_pair(msg_idx, ch->GetID()));
+                count++;
+            }
+            cit++;
+        }
+        return count;
+    }
+
+    static void write_published(PublishBatch* batch)
+    {
+        for (size_t i = 0; i < batch->writes.size(); i++)
+        {
+            Channel* ch = batch->serv->GetChannel(batch->writes[i].second);
+            if (NULL == ch)
+            {
+                continue;
+            }
+            std::string& msg = batch->fanout->messages[batch->writes[i].first];
+            Buffer content(const_cast<char*>(msg.data()), 0, msg.size());
+            if (!ch->Write(content))
+            {
+                ch->Close();
+            }
+        }
+        if (0 == atomic_sub_uint32(&batch->fanout->batches, 1))
+        {
+            DELETE(batch->fanout);
+        }
+        DELETE(batch);
+    }
 
+    static void async_write_published_callback(Channel* ch, void* data)
+    {
+        write_published((PublishBatch*) data);
+    }
+
+    static void dispatch_published(PublishBatchTable& batches, PublishFanout* fanout)
+    {
+        /*
+         * the fanout may be freed by any thread once the first batch is dispatched
+         */
+        fanout->batches = batches.size();
+        PublishBatchTable::iterator bit = batches.begin();
+        while (bit != batches.end())
+        {
+            ChannelService* serv = bit->first;
+            if (serv->IsInLoopThread())
+            {
+                write_published(bit->second);
+            }
+            else
+            {
+                serv->AsyncIO(0, async_write_published_callback, bit->second);
+            }
+            bit++;
+        }
+    }
+
+    int Ardb::PublishMessage(Context& ctx, const std::string& channel, const std::string& message)
+    {
+        PublishFanout* fanout = NULL;
+        NEW(fanout, PublishFanout);
+        PublishBatchTable batches;
         int receiver = 0;
-        if (fit != m_pubsub_channels.end())
         {
-            ContextSet::iterator cit = fit->second.begin();
-            while (cit != fit->second.end())
+            PubSubShard& shard = GetPubSubShard(channel);
+            ReadLockGuard<BigReaderLock> guard(shard.lock);
+            PubSubChannelTable::iterator fit = shard.channels.find(channel);
+            if (fit != shard.channels.end() && !fit->second.empty())
             {
-                Context* cc = *cit;
-                if (NULL != cc && cc->client != NULL)
+                size_t idx = encode_published(*fanout, NULL, channel, message);
+                receiver += add_published(batches, fanout, fit->second, idx);
+            }
+        }
+        {
+            ReadLockGuard<BigReaderLock> guard(m_pubsub_pattern_lock);
+            std::vector<const std::string*> patterns;
+            m_pubsub_pattern_index.Match(channel, patterns);
+            for (size_t i = 0; i < patterns.size(); i++)
+            {
+                PubSubChannelTable::iterator pit = m_pubsub_patterns.find(*patterns[i]);
+                if (pit != m_pubsub_patterns.end() && !pit->second.empty())
                 {
-                    RedisReply* r = NULL;
-                    NEW(r, RedisReply);
-                    RedisReply& r1 = r->AddMember();
-                    RedisReply& r2 = r->AddMember();
-                    RedisReply& r3 = r->AddMember();
-                    r1.SetString("message");
-                    r2.SetString(channel);
-                    r3.SetString(message);
-                    WriteReply(*cc, r, true);
-                    receiver++;
+                    size_t idx = encode_published(*fanout, &pit->first, channel, message);
+                    receiver += add_published(batches, fanout, pit->second, idx);
                 }
-                cit++;
             }
         }
-        PubSubChannelTable::iterator pit = m_pubsub_patterns.begin();
-        while (pit != m_pubsub_patterns.end())
+        if (batches.empty())
+        {
+            DELETE(fanout);
+            return receiver;
+        }
+        dispatch_published(batches, fanout);
+        return receiver;
+    }
+
+    static const char* kInvalidateChannel = "__redis__:invalidate";
+
+    /*
+     * CLIENT TRACKING ON|OFF [REDIRECT id] [BCAST] [PREFIX prefix]... [NOLOOP]
+     * Invalidations are only delivered over pubsub, so the REDIRECT connection is required.
+     */
+    int Ardb::EnableTracking(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        if (args.size() < 2 || NULL == ctx.client || NULL == ctx.client->client)
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
+        if (!strcasecmp(args[1].c_str(), "off"))
+        {
+            DisableTracking(ctx);
+            reply.SetStatusCode(STATUS_OK);
+            return 0;
+        }
+        if (strcasecmp(args[1].c_str(), "on"))
         {
-            const std::string& pattern = pit->first;
-            if (stringmatchlen(pattern.c_str(), pattern.size(), channel.c_str(), channel.size(), 0))
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
+        uint32 redirect = 0;
+        bool bcast = false, noloop = false;
+        StringTreeSet prefixes;
+        for (size_t i = 2; i < args.size(); i++)
+        {
+            if (!strcasecmp(args[i].c_str(), "redirect") && i + 1 < args.size())
             {
-                ContextSet::iterator cit = pit->second.begin();
-                while (cit != pit->second.end())
+                if (!string_touint32(args[i + 1], redirect))
+                {
+                    reply.SetErrorReason("Invalid client ID");
+                    return 0;
+                }
+                i++;
+            }
+            else if (!strcasecmp(args[i].c_str(), "prefix") && i + 1 < args.size())
+            {
+                prefixes.insert(args[i + 1]);
+                i++;
+            }
+            else if (!strcasecmp(args[i].c_str(), "bcast"))
+            {
+                bcast = true;
+            }
+            else if (!strcasecmp(args[i].c_str(), "noloop"))
+            {
+                noloop = true;
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        if (!prefixes.empty() && !bcast)
+        {
+            reply.SetErrorReason("PREFIX option requires BCAST mode to be enabled");
+            return 0;
+        }
+        if (0 == redirect)
+        {
+            reply.SetErrorReason("REDIRECT to a connection subscribed to __redis__:invalidate is required");
+            return 0;
+        }
+        bool redirect_found = false;
+        {
+            LockGuard<SpinMutexLock> guard(m_clients_lock);
+            ClientContext* client = m_all_clients.head;
+            while (NULL != client && !redirect_found)
+            {
+                redirect_found = NULL != client->client && client->client->GetID() == redirect;
+                client = client->next;
+            }
+        }
+        if (!redirect_found)
+        {
+            reply.SetErrorReason("The client ID you want redirect to does not exist");
+            return 0;
+        }
+        if (bcast && prefixes.empty())
+        {
+            prefixes.insert("");
+        }
+        DisableTracking(ctx);
+        TrackingContext& tracking = ctx.GetTracking();
+        tracking.redirect = redirect;
+        tracking.bcast = bcast;
+        tracking.noloop = noloop;
+        tracking.prefixes = prefixes;
+        uint32 id = ctx.client->client->GetID();
+        {
+            LockGuard<SpinMutexLock> guard(m_tracking_lock);
+            m_tracking_contexts[id] = &ctx;
+            StringTreeSet::iterator it = prefixes.begin();
+            while (it != prefixes.end())
+            {
+                m_tracking_prefixes[*it].insert(id);
+                it++;
+            }
+        }
+        atomic_add_uint32(&m_tracking_clients, 1);
+        reply.SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
+    /*
+     * Keys read by the client are left in the table, they are skipped once the client is gone.
+     */
+    int Ardb::DisableTracking(Context& ctx)
+    {
+        if (NULL == ctx.tracking)
+        {
+            return 0;
+        }
+        uint32 id = (NULL != ctx.client && NULL != ctx.client->client) ? ctx.client->client->GetID() : 0;
+        {
+            LockGuard<SpinMutexLock> guard(m_tracking_lock);
+            m_tracking_contexts.erase(id);
+            StringTreeSet::iterator it = ctx.tracking->prefixes.begin();
+            while (it != ctx.tracking->prefixes.end())
+            {
+                TrackingKeyTable::iterator found = m_tracking_prefixes.find(*it);
+                if (found != m_tracking_prefixes.end())
+                {
+                    found->second.erase(id);
+                    if (found->second.empty())
+                    {
+                        m_tracking_prefixes.erase(found);
+                    }
+                }
+                it++;
+            }
+            if (m_tracking_contexts.empty())
+            {
+                m_tracking_keys.clear();
+            }
+        }
+        atomic_sub_uint32(&m_tracking_clients, 1);
+        ctx.ClearTracking();
+        return 0;
+    }
+
+    /*
+     * Maps the tracking clients to their redirect connections, must be called with the tracking lock held.
+     * 'writer' is the connection changing the key, skipped for NOLOOP clients.
+     */
+    void Ardb::CollectTrackingTargets(uint32 writer, const TrackingClientSet& clients, TrackingClientSet& targets)
+    {
+        TrackingClientSet::const_iterator it = clients.begin();
+        while (it != clients.end())
+        {
+            TrackingContextTable::iterator found = m_tracking_contexts.find(*it);
+            if (found != m_tracking_contexts.end() && !(found->second->tracking->noloop && *it == writer))
+            {
+                targets.insert(found->second->tracking->redirect);
+            }
+            it++;
+        }
+    }
+
+    /*
+     * Called before a read command of a tracking client executes, so a write racing with the read always
+     * finds the key in the table.
+     */
+    void Ardb::TrackKeysRead(Context& ctx, RedisCommandFrame& cmd)
+    {
+        if (NULL == ctx.tracking || ctx.tracking->bcast || NULL == ctx.client || NULL == ctx.client->client)
+        {
+            return;
+        }
+        StringArray keys;
+        GetCommandKeys(cmd, keys);
+        if (keys.empty())
+        {
+            return;
+        }
+        uint32 id = ctx.client->client->GetID();
+        int64 max_keys = GetConf().tracking_table_max_keys;
+        std::vector<std::pair<std::string, TrackingClientSet> > evicted;
+        {
+            LockGuard<SpinMutexLock> guard(m_tracking_lock);
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                m_tracking_keys[keys[i]].insert(id);
+            }
+            while (max_keys > 0 && (int64) m_tracking_keys.size() > max_keys)
+            {
+                TrackingKeyTable::iterator it = m_tracking_keys.upper_bound(m_tracking_evict_cursor);
+                if (it == m_tracking_keys.end())
+                {
+                    it = m_tracking_keys.begin();
+                }
+                m_tracking_evict_cursor = it->first;
+                evicted.resize(evicted.size() + 1);
+                evicted.back().first = it->first;
+                CollectTrackingTargets(0, it->second, evicted.back().second);
+                m_tracking_keys.erase(it);
+            }
+        }
+        for (size_t i = 0; i < evicted.size(); i++)
+        {
+            SendInvalidation(&evicted[i].first, evicted[i].second);
+        }
+    }
+
+    int Ardb::FireKeyChangedEvent(Context& ctx, const KeyObject& key)
+    {
+        if (0 == m_tracking_clients)
+        {
+            return 0;
+        }
+        std::string k = key.GetKey().AsString();
+        uint32 writer = (NULL != ctx.client && NULL != ctx.client->client) ? ctx.client->client->GetID() : 0;
+        TrackingClientSet targets;
+        {
+            LockGuard<SpinMutexLock> guard(m_tracking_lock);
+            TrackingKeyTable::iterator found = m_tracking_keys.find(k);
+            if (found != m_tracking_keys.end())
+            {
+                CollectTrackingTargets(writer, found->second, targets);
+                m_tracking_keys.erase(found);
+            }
+            TrackingKeyTable::iterator it = m_tracking_prefixes.begin();
+            while (it != m_tracking_prefixes.end())
+            {
+                if (k.compare(0, it->first.size(), it->first) == 0)
+                {
+                    CollectTrackingTargets(writer, it->second, targets);
+                }
+                it++;
+            }
+        }
+        if (targets.empty())
+        {
+            return 0;
+        }
+        return SendInvalidation(&k, targets);
+    }
+
+    /*
+     * Every tracking client is told to drop its whole cache with a nil key list.
+     */
+    int Ardb::FireKeysFlushedEvent(Context& ctx)
+    {
+        if (0 == m_tracking_clients)
+        {
+            return 0;
+        }
+        TrackingClientSet targets;
+        {
+            LockGuard<SpinMutexLock> guard(m_tracking_lock);
+            TrackingContextTable::iterator it = m_tracking_contexts.begin();
+            while (it != m_tracking_contexts.end())
+            {
+                targets.insert(it->second->tracking->redirect);
+                it++;
+            }
+            m_tracking_keys.clear();
+        }
+        return SendInvalidation(NULL, targets);
+    }
+
+    /*
+     * Sends ["message", "__redis__:invalidate", [key]] to the 'targets' connections subscribed to the channel,
+     * a NULL 'key' sends a nil key list.
+     */
+    int Ardb::SendInvalidation(const std::string* key, const TrackingClientSet& targets)
+    {
+        if (targets.empty())
+        {
+            return 0;
+        }
+        std::string channel(kInvalidateChannel);
+        RedisReply r;
+        r.AddMember().SetString("message");
+        r.AddMember().SetString(channel);
+        RedisReply& keys = r.AddMember();
+        if (NULL != key)
+        {
+            keys.AddMember().SetString(*key);
+        }
+        else
+        {
+            keys.ReserveMember(-1);
+        }
+        PublishFanout* fanout = NULL;
+        NEW(fanout, PublishFanout);
+        Buffer buf;
+        RedisReplyEncoder::Encode(buf, r);
+        fanout->messages.push_back(std::string(buf.GetRawReadBuffer(), buf.ReadableBytes()));
+        PublishBatchTable batches;
+        int receiver = 0;
+        {
+            PubSubShard& shard = GetPubSubShard(channel);
+            ReadLockGuard<BigReaderLock> guard(shard.lock);
+            PubSubChannelTable::iterator fit = shard.channels.find(channel);
+            if (fit != shard.channels.end())
+            {
+                ContextSet receivers;
+                ContextSet::iterator cit = fit->second.begin();
+                while (cit != fit->second.end())
                 {
                     Context* cc = *cit;
-                    if (NULL != cc && cc->client != NULL)
+                    if (NULL != cc->client && NULL != cc->client->client && targets.count(cc->client->client->GetID()) > 0)
                     {
-                        RedisReply* r = NULL;
-                        NEW(r, RedisReply);
-                        RedisReply& r1 = r->AddMember();
-                        RedisReply& r2 = r->AddMember();
-                        RedisReply& r3 = r->AddMember();
-                        RedisReply& r4 = r->AddMember();
-                        r1.SetString("pmessage");
-                        r2.SetString(pattern);
-                        r3.SetString(channel);
-                        r4.SetString(message);
-                        WriteReply(*cc, r, true);
-                        receiver++;
+                        receivers.insert(cc);
                     }
                     cit++;
                 }
+                receiver = add_published(batches, fanout, receivers, 0);
             }
-            pit++;
         }
+        if (batches.empty())
+        {
+            DELETE(fanout);
+            return 0;
+        }
+        dispatch_published(batches, fanout);
         return receiver;
     }
 
@@ -285,42 +733,46 @@ namespace ardb
         const std::string& subcommand = cmd.GetArguments()[0];
         if (!strcasecmp(subcommand.c_str(), "channels") && (cmd.GetArguments().size() == 1 || cmd.GetArguments().size() == 2))
         {
-            ReadLockGuard<SpinRWLock> guard(m_pubsub_lock);
             reply.ReserveMember(0);
-            PubSubChannelTable::iterator fit = m_pubsub_channels.begin();
-            while (fit != m_pubsub_channels.end())
+            for (uint32 i = 0; i < kPubSubShards; i++)
             {
-                const std::string& channel = fit->first;
-                if (cmd.GetArguments().size() == 2)
+                ReadLockGuard<BigReaderLock> guard(m_pubsub_shards[i].lock);
+                PubSubChannelTable::iterator fit = m_pubsub_shards[i].channels.begin();
+                while (fit != m_pubsub_shards[i].channels.end())
                 {
-                    const std::string& pattern = cmd.GetArguments()[1];
-                    if (stringmatchlen(pattern.c_str(), pattern.size(), channel.c_str(), channel.size(), 0) != 1)
+                    const std::string& channel = fit->first;
+                    if (cmd.GetArguments().size() == 2)
                     {
-                        fit++;
-                        continue;
+                        const std::string& pattern = cmd.GetArguments()[1];
+                        if (stringmatchlen(pattern.c_str(), pattern.size(), channel.c_str(), channel.size(), 0) != 1)
+                        {
+                            fit++;
+                            continue;
+                        }
                     }
+                    RedisReply& rr = reply.AddMember();
+                    rr.SetString(channel);
+                    fit++;
                 }
-                RedisReply& rr = reply.AddMember();
-                rr.SetString(channel);
-                fit++;
             }
         }
         else if (!strcasecmp(subcommand.c_str(), "numsub") && (cmd.GetArguments().size() >= 1))
         {
-            ReadLockGuard<SpinRWLock> guard(m_pubsub_lock);
             reply.ReserveMember(0);
             for(size_t i = 1; i < cmd.GetArguments().size(); i++)
             {
                 RedisReply& r1 = reply.AddMember();
                 RedisReply& r2 = reply.AddMember();
                 r1.SetString(cmd.GetArguments()[i]);
-                PubSubChannelTable::iterator found = m_pubsub_channels.find(cmd.GetArguments()[i]);
-                r2.SetInteger(found == m_pubsub_channels.end()? 0 : found->second.size());
+                PubSubShard& shard = GetPubSubShard(cmd.GetArguments()[i]);
+                ReadLockGuard<BigReaderLock> guard(shard.lock);
+                PubSubChannelTable::iterator found = shard.channels.find(cmd.GetArguments()[i]);
+                r2.SetInteger(found == shard.channels.end()? 0 : found->second.size());
             }
         }
         else if (!strcasecmp(subcommand.c_str(), "numpat") && (cmd.GetArguments().size() == 1))
         {
-            ReadLockGuard<SpinRWLock> guard(m_pubsub_lock);
+            ReadLockGuard<BigReaderLock> guard(m_pubsub_pattern_lock);
             reply.SetInteger(m_pubsub_patterns.size());
         }
         else
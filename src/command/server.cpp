@@ -30,11 +30,17 @@
 #include "db/db.hpp"
 #include "repl/rdb.hpp"
 #include "repl/repl.hpp"
+#include "repl/backup.hpp"
 #include "util/socket_address.hpp"
 #include "util/lru.hpp"
 #include "util/system_helper.hpp"
+#include "util/mem_arena.hpp"
+#include "coro/scheduler.hpp"
 #include "statistics.hpp"
+#include "bgjobs.hpp"
+#include "network.hpp"
 #include <sstream>
+#include <algorithm>
 #include <sys/utsname.h>
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -114,6 +120,31 @@ namespace ardb
         return 0;
     }
 
+    /*
+     * The snapshot & db writer of the running IMPORT, published for INFO while the import holds them.
+     */
+    struct ImportState
+    {
+            ChannelService* io_serv;
+            Snapshot* snapshot;
+            DBWriter* writer;
+            uint64 start_time;
+    };
+    static SpinMutexLock g_import_lock;
+    static ImportState* g_import_state = NULL;
+
+    static int ImportLoadRoutine(SnapshotState state, Snapshot* snapshot, void* cb)
+    {
+        ImportState* import = (ImportState*) cb;
+        if (state == LODING)
+        {
+            INFO_LOG("Import progress:%llu/%llu bytes read, %llu entries written(%llu/s).", (unsigned long long) snapshot->ProcessedBytes(),
+                    (unsigned long long) snapshot->FileSize(), (unsigned long long) import->writer->WrittenCount(),
+                    (unsigned long long) import->writer->WrittenPerSecond());
+        }
+        return RDBSaveLoadRoutine(state, snapshot, import->io_serv);
+    }
+
     int Ardb::Import(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
@@ -123,6 +154,7 @@ namespace ardb
             return 0;
         }
         const std::string& file = cmd.GetArguments()[0];
+        m_loading_serve_reads = GetConf().import_serve_reads;
         m_loading_data = true;
         ChannelService* io_serv = NULL;
         uint32 conn_id = 0;
@@ -134,14 +166,28 @@ namespace ardb
         }
         Snapshot snapshot;
         /*
-         * use 4 threads to write db
+         * this thread decodes the records of the file, 'snapshot-threads' workers encode & write them
          */
-
-        KeyCacheWriter load_writer(g_db->m_key_cache);
+        KeyCacheWriter load_writer(g_db->m_key_cache, GetConf().snapshot_threads);
         snapshot.SetDBWriter(&load_writer);
-        int err = snapshot.Load(file, RDBSaveLoadRoutine, io_serv);
-        snapshot.SetDBWriter(NULL);
+        ImportState import;
+        import.io_serv = io_serv;
+        import.snapshot = &snapshot;
+        import.writer = &load_writer;
+        import.start_time = get_current_epoch_millis();
+        {
+            LockGuard<SpinMutexLock> guard(g_import_lock);
+            g_import_state = &import;
+        }
+        int err = snapshot.Load(file, ImportLoadRoutine, &import);
         load_writer.Stop();
+        {
+            LockGuard<SpinMutexLock> guard(g_import_lock);
+            g_import_state = NULL;
+        }
+        snapshot.SetDBWriter(NULL);
+        INFO_LOG("Import %s with %llu entries written in %llums.", 0 == err ? "finished" : "failed", (unsigned long long) load_writer.WrittenCount(),
+                (unsigned long long) (get_current_epoch_millis() - import.start_time));
         if (NULL == io_serv || io_serv->GetChannel(conn_id) != NULL)
         {
             if (err == 0)
@@ -154,6 +200,7 @@ namespace ardb
             }
         }
         m_loading_data = false;
+        m_loading_serve_reads = false;
         if (NULL != ctx.client && NULL != ctx.client->client)
         {
             ctx.client->client->UnblockRead();
@@ -161,6 +208,82 @@ namespace ardb
         return 0;
     }
 
+    /*
+     * BACKUP CREATE|LIST|RESTORE <id> [<repl-offset>]|PURGE <keep>
+     */
+    int Ardb::Backup(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        std::string subcmd = string_tolower(cmd.GetArguments()[0]);
+        if (subcmd == "create" && cmd.GetArguments().size() == 1)
+        {
+            if (0 == g_backup_manager->BGCreate())
+            {
+                reply.SetStatusCode(STATUS_OK);
+            }
+            else
+            {
+                reply.SetErrorReason("Backup already in progress.");
+            }
+            return 0;
+        }
+        if (subcmd == "list" && cmd.GetArguments().size() == 1)
+        {
+            std::vector<BackupInfo> infos;
+            g_backup_manager->List(infos);
+            reply.ReserveMember(0);
+            for (size_t i = 0; i < infos.size(); i++)
+            {
+                RedisReply& r = reply.AddMember();
+                r.ReserveMember(0);
+                r.AddMember().SetInteger(infos[i].id);
+                r.AddMember().SetInteger(infos[i].create_time);
+                r.AddMember().SetInteger(infos[i].repl_offset);
+                r.AddMember().SetInteger(infos[i].TotalSize());
+                r.AddMember().SetInteger(infos[i].copied_bytes);
+                r.AddMember().SetInteger(infos[i].wal_start);
+                r.AddMember().SetInteger(infos[i].wal_size);
+            }
+            return 0;
+        }
+        uint32 id = 0;
+        uint64 offset = 0;
+        if (subcmd == "purge" && cmd.GetArguments().size() == 2 && string_touint32(cmd.GetArguments()[1], id))
+        {
+            if (g_backup_manager->IsRunning())
+            {
+                reply.SetErrorReason("Backup already in progress.");
+                return 0;
+            }
+            reply.SetInteger(g_backup_manager->Purge(id));
+            return 0;
+        }
+        if (subcmd != "restore" || cmd.GetArguments().size() < 2 || cmd.GetArguments().size() > 3 || !string_touint32(cmd.GetArguments()[1], id)
+                || (cmd.GetArguments().size() == 3 && !string_touint64(cmd.GetArguments()[2], offset)))
+        {
+            reply.SetErrorReason("BACKUP subcommand must be one of CREATE, LIST, RESTORE <id> [<repl-offset>], PURGE <keep>");
+            return 0;
+        }
+        if (IsLoadingData() || g_backup_manager->IsRunning())
+        {
+            reply.SetErrCode(ERR_LOADING);
+            return 0;
+        }
+        m_loading_data = true;
+        int err = g_backup_manager->Restore(id, offset);
+        m_loading_data = false;
+        if (0 == err)
+        {
+            WARN_LOG("Data restored from backup:%u, connected slaves need a full resync.", id);
+            reply.SetStatusCode(STATUS_OK);
+        }
+        else
+        {
+            reply.SetErrorReason("Restore backup failed.");
+        }
+        return 0;
+    }
+
     void Ardb::FillInfoResponse(Context& ctx, const std::string& section, std::string& info)
     {
         const char* all = "all";
@@ -175,6 +298,7 @@ namespace ardb
             info.append("engine:").append(g_engine_name).append("\r\n");
             info.append("ardb_home:").append(GetConf().home).append("\r\n");
             info.append("os:").append(name.sysname).append(" ").append(name.release).append(" ").append(name.machine).append("\r\n");
+            info.append("multiplexing_api:").append(aeGetApiName()).append("\r\n");
             char tmp[256];
             sprintf(tmp, "%d.%d.%d",
 #ifdef __GNUC__
@@ -212,6 +336,7 @@ namespace ardb
             info.append("used_disk_space:").append(tmp).append("\r\n");
             std::string stats;
             m_engine->Stats(ctx, stats);
+            encode_buffer_stats(stats);
             info.append(stats).append("\r\n");
             info.append("\r\n");
         }
@@ -221,12 +346,16 @@ namespace ardb
             info.append("# Clients\r\n");
             {
                 LockGuard<SpinMutexLock> guard(m_clients_lock);
-                info.append("connected_clients:").append(stringfromll(m_all_clients.size())).append("\r\n");
+                info.append("connected_clients:").append(stringfromll(m_all_clients.size)).append("\r\n");
             }
+            info.append("blocked_clients:").append(stringfromll(m_blocked_clients)).append("\r\n");
             {
-                LockGuard<SpinMutexLock> guard(m_block_keys_lock);
-                info.append("blocked_clients:").append(stringfromll(m_blocked_ctxs.size())).append("\r\n");
+                LockGuard<SpinMutexLock> guard(m_tracking_lock);
+                info.append("tracking_clients:").append(stringfromll(m_tracking_contexts.size())).append("\r\n");
+                info.append("tracking_total_keys:").append(stringfromll(m_tracking_keys.size())).append("\r\n");
+                info.append("tracking_total_prefixes:").append(stringfromll(m_tracking_prefixes.size())).append("\r\n");
             }
+            info.append("instantaneous_connections_per_sec:").append(stringfromll(Server::ConnectionsPerSecond())).append("\r\n");
             info.append("\r\n");
         }
 
@@ -234,6 +363,18 @@ namespace ardb
         {
             info.append("# Persistence\r\n");
             info.append("loading:").append(IsLoadingData() ? " 1" : "0").append("\r\n");
+            {
+                LockGuard<SpinMutexLock> guard(g_import_lock);
+                info.append("import_in_progress:").append(NULL != g_import_state ? "1" : "0").append("\r\n");
+                if (NULL != g_import_state)
+                {
+                    info.append("import_loaded_bytes:").append(stringfromll(g_import_state->snapshot->ProcessedBytes())).append("\r\n");
+                    info.append("import_total_bytes:").append(stringfromll(g_import_state->snapshot->FileSize())).append("\r\n");
+                    info.append("import_written_entries:").append(stringfromll(g_import_state->writer->WrittenCount())).append("\r\n");
+                    info.append("import_entries_per_sec:").append(stringfromll(g_import_state->writer->WrittenPerSecond())).append("\r\n");
+                    info.append("import_elapsed_ms:").append(stringfromll(get_current_epoch_millis() - g_import_state->start_time)).append("\r\n");
+                }
+            }
             info.append("rdb_last_save_time:").append(stringfromll(g_snapshot_manager->LastSave())).append("\r\n");
             info.append("rdb_last_bgsave_status:").append(g_snapshot_manager->LastSaveErr() != 0 ? "error" : "ok").append("\r\n");
             info.append("rdb_last_bgsave_time_sec:").append(stringfromll(g_snapshot_manager->LastSaveCost())).append("\r\n");
@@ -244,6 +385,10 @@ namespace ardb
                 lastsave_elapsed = time(NULL) - g_snapshot_manager->LastSaveStartUnixTime();
             }
             info.append("rdb_current_bgsave_time_sec:").append(stringfromll(lastsave_elapsed)).append("\r\n");
+            info.append("backup_in_progress:").append(g_backup_manager->IsRunning() ? "1" : "0").append("\r\n");
+            info.append("backup_last_time:").append(stringfromll(g_backup_manager->LastBackupTime())).append("\r\n");
+            info.append("backup_last_status:").append(g_backup_manager->LastErr() != 0 ? "error" : "ok").append("\r\n");
+            CompactionInfo(info);
             info.append("\r\n");
         }
 
@@ -279,6 +424,13 @@ namespace ardb
             {
                 info.append("role: singleton\r\n");
             }
+            if (m_read_replica)
+            {
+                info.append("read_replica_of:").append(GetConf().rocksdb_read_replica_of).append("\r\n");
+                info.append("read_replica_refreshes:").append(stringfromll(m_replica_refreshes)).append("\r\n");
+                info.append("read_replica_refresh_skips:").append(stringfromll(m_replica_refresh_skips)).append("\r\n");
+                info.append("read_replica_lag_ms:").append(stringfromll(get_current_epoch_millis() - m_replica_refresh_time)).append("\r\n");
+            }
 //
             if (g_repl->IsInited())
             {
@@ -347,6 +499,36 @@ namespace ardb
             info.append("# Memory\r\n");
             std::string tmp;
             info.append("used_memory_rss:").append(stringfromll(mem_rss_size())).append("\r\n");
+            info.append("buffer_pool_allocated:").append(stringfromll(BufferPool::AllocatedBytes())).append("\r\n");
+            info.append("buffer_pool_shared_cached:").append(stringfromll(BufferPool::SharedCachedBytes())).append("\r\n");
+            CoroStackStats coro_stacks;
+            Scheduler::GetStackStats(coro_stacks);
+            info.append("coro_stacks_allocated:").append(stringfromll(coro_stacks.allocated)).append("\r\n");
+            info.append("coro_stacks_pooled:").append(stringfromll(coro_stacks.pooled)).append("\r\n");
+            info.append("coro_stacks_reused:").append(stringfromll(coro_stacks.reused)).append("\r\n");
+            info.append("coro_stacks_sampled:").append(stringfromll(coro_stacks.sampled)).append("\r\n");
+            info.append("coro_stack_max_used:").append(stringfromll(coro_stacks.max_used)).append("\r\n");
+            malloc_stats(info);
+            MallocFragStats frag;
+            if (malloc_frag_stats(frag) && frag.allocated > 0)
+            {
+                char ratio[32];
+                snprintf(ratio, sizeof(ratio), "%.2f", (double) frag.resident / frag.allocated);
+                info.append("mem_fragmentation_ratio:").append(ratio).append("\r\n");
+                info.append("allocator_dirty:").append(stringfromll(frag.dirty)).append("\r\n");
+            }
+            info.append("mem_purges:").append(stringfromll(m_mem_purges)).append("\r\n");
+            info.append("mem_purged_bytes:").append(stringfromll(m_mem_purged_bytes)).append("\r\n");
+            for (int i = 0; i < MEM_ARENA_MAX; i++)
+            {
+                MemArenaStats stats;
+                arena_stats((MemArenaKind) i, stats);
+                std::string prefix = std::string("arena_") + arena_name((MemArenaKind) i);
+                info.append(prefix).append("_allocated:").append(stringfromll(stats.allocated)).append("\r\n");
+                info.append(prefix).append("_active:").append(stringfromll(stats.active)).append("\r\n");
+                info.append(prefix).append("_dirty:").append(stringfromll(stats.dirty)).append("\r\n");
+                info.append(prefix).append("_allocs:").append(stringfromll(stats.allocs)).append("\r\n");
+            }
             info.append("\r\n");
         }
 
@@ -360,14 +542,55 @@ namespace ardb
             info.append("sync_partial_ok:").append(stringfromll(g_repl->GetMaster().ParitialSyncOKCount())).append("\r\n");
             info.append("sync_partial_err:").append(stringfromll(g_repl->GetMaster().ParitialSyncErrCount())).append("\r\n");
             {
-                ReadLockGuard<SpinRWLock> guard(m_pubsub_lock);
-                info.append("pubsub_channels:").append(stringfromll(m_pubsub_channels.size())).append("\r\n");
+                size_t channels = 0;
+                for (uint32 i = 0; i < kPubSubShards; i++)
+                {
+                    ReadLockGuard<BigReaderLock> guard(m_pubsub_shards[i].lock);
+                    channels += m_pubsub_shards[i].channels.size();
+                }
+                ReadLockGuard<BigReaderLock> guard(m_pubsub_pattern_lock);
+                info.append("pubsub_channels:").append(stringfromll(channels)).append("\r\n");
                 info.append("pubsub_patterns:").append(stringfromll(m_pubsub_patterns.size())).append("\r\n");
             }
             {
-                LockGuard<SpinMutexLock> guard(m_expires_lock);
-                info.append("expire_scan_keys:").append(stringfromll(m_expires.size())).append("\r\n");
+                size_t expire_scan_keys = 0;
+                for (uint32 i = 0; i < kExpireKeyShards; i++)
+                {
+                    LockGuard<SpinMutexLock> guard(m_expires[i].lock);
+                    expire_scan_keys += m_expires[i].keys.size();
+                }
+                info.append("expire_scan_keys:").append(stringfromll(expire_scan_keys)).append("\r\n");
+            }
+            {
+                LockGuard<SpinMutexLock> guard(m_list_compact_lock);
+                info.append("list_compact_keys:").append(stringfromll(m_list_compact_keys.size())).append("\r\n");
             }
+            {
+                LockGuard<SpinMutexLock> guard(m_lazyfree_lock);
+                info.append("lazyfree_pending_objects:").append(stringfromll(m_lazyfree_keys.size())).append("\r\n");
+            }
+            info.append("monitor_dropped_events:").append(stringfromll(m_monitor_dropped)).append("\r\n");
+            info.append("write_stalled:").append(m_engine->IsWriteStalled() ? "1" : "0").append("\r\n");
+            info.append("stall_pending_writes:").append(stringfromll(m_stall_pending_writes)).append("\r\n");
+            info.append("shed_writes:").append(stringfromll(m_shed_writes)).append("\r\n");
+            info.append("cost_rejected_commands:").append(stringfromll(m_cost_rejected)).append("\r\n");
+            info.append("cost_streamed_commands:").append(stringfromll(m_cost_streamed)).append("\r\n");
+            info.append("cost_rerouted_commands:").append(stringfromll(m_cost_rerouted)).append("\r\n");
+            info.append("log_dropped_records:").append(stringfromll(ArdbLogger::DroppedRecords())).append("\r\n");
+            info.append("\r\n");
+        }
+
+        if (!strcasecmp(section.c_str(), all) || !strcasecmp(section.c_str(), def) || !strcasecmp(section.c_str(), "rebalance"))
+        {
+            info.append("# Rebalance\r\n");
+            RebalanceInfo(info);
+            info.append("\r\n");
+        }
+
+        if (!strcasecmp(section.c_str(), "qos") || (TenantLimiter::GetSingleton().Enabled() && (!strcasecmp(section.c_str(), all) || !strcasecmp(section.c_str(), def))))
+        {
+            info.append("# QoS\r\n");
+            TenantLimiter::GetSingleton().GetUsages(info);
             info.append("\r\n");
         }
 
@@ -380,12 +603,19 @@ namespace ardb
                 info.append("# Keyspace\r\n");
                 for (size_t i = 0; i < nss.size(); i++)
                 {
-                    if (nss[i].AsString() == TTL_DB_NSMAESPACE)
+                    if (nss[i].AsString() == TTL_DB_NSMAESPACE || nss[i].AsString() == ZSET_STORE_NAMESPACE
+                            || nss[i].AsString() == LAZYFREE_DB_NAMESPACE || nss[i].AsString() == INDEX_DB_NAMESPACE)
                     {
                         continue;
                     }
-                    info.append("db").append(nss[i].AsString()).append(":").append("keys=").append(stringfromll(m_engine->EstimateKeysNum(ctx, nss[i]))).append(
-                            "\r\n");
+                    info.append("db").append(nss[i].AsString()).append(":").append("keys=").append(stringfromll(m_engine->EstimateKeysNum(ctx, nss[i])));
+                    uint64 hotkey_samples = 0, hottest = 0, biggest = 0;
+                    if (HotKeyTracker::GetSingleton().GetNamespaceSummary(nss[i].AsString(), hotkey_samples, hottest, biggest))
+                    {
+                        info.append(",hotkey_samples=").append(stringfromll(hotkey_samples)).append(",hottest_key_hits=").append(
+                                stringfromll(hottest)).append(",biggest_key_len=").append(stringfromll(biggest));
+                    }
+                    info.append("\r\n");
                 }
                 info.append("\r\n");
             }
@@ -398,10 +628,12 @@ namespace ardb
             while (cit != m_settings.end())
             {
                 RedisCommandHandlerSetting& setting = cit->second;
-                if (setting.calls > 0)
+                CostRecord total;
+                setting.cost_track->GetTotal(total);
+                if (total.count > 0)
                 {
-                    info.append("cmdstat_").append(setting.name).append(":").append("calls=").append(stringfromll(setting.calls)).append(",usec=").append(
-                            stringfromll(setting.microseconds)).append(",usecpercall=").append(stringfromll(setting.microseconds / setting.calls)).append(
+                    info.append("cmdstat_").append(setting.name).append(":").append("calls=").append(stringfromll(total.count)).append(",usec=").append(
+                            stringfromll(total.cost)).append(",usecpercall=").append(stringfromll(total.cost / total.count)).append(
                             "\r\n");
                 }
 
@@ -410,6 +642,38 @@ namespace ardb
             info.append("\r\n");
         }
 
+        if (!strcasecmp(section.c_str(), all) || !strcasecmp(section.c_str(), "latencystats"))
+        {
+            info.append("# Latencystats\r\n");
+            RedisCommandHandlerSettingTable::iterator cit = m_settings.begin();
+            while (cit != m_settings.end())
+            {
+                RedisCommandHandlerSetting& setting = cit->second;
+                CostHistogram hist;
+                setting.cost_track->GetHistogram(hist);
+                if (std::count(hist.begin(), hist.end(), 0) < (int64) hist.size())
+                {
+                    info.append("latency_percentiles_usec_").append(setting.name).append(":p50=").append(stringfromll(cost_hist_percentile(hist, 50))).append(",p99=").append(
+                            stringfromll(cost_hist_percentile(hist, 99))).append(",p99.9=").append(stringfromll(cost_hist_percentile(hist, 99.9))).append(
+                            ",max=").append(stringfromll(cost_hist_percentile(hist, 100))).append("\r\n");
+                }
+                cit++;
+            }
+            info.append("\r\n");
+        }
+
+        if (g_engine_profiling && (!strcasecmp(section.c_str(), all) || !strcasecmp(section.c_str(), "engineprofile")))
+        {
+            info.append("# Engineprofile\r\n");
+            RedisCommandHandlerSettingTable::iterator cit = m_settings.begin();
+            while (cit != m_settings.end())
+            {
+                cit->second.engine_profile->Dump(cit->second.name, info);
+                cit++;
+            }
+            info.append("\r\n");
+        }
+
         if (!strcasecmp(section.c_str(), all) || !strcasecmp(section.c_str(), "coststats"))
         {
             info.append("# Coststats\r\n");
@@ -433,10 +697,296 @@ namespace ardb
         return 0;
     }
 
+    /*
+     * LATENCY LATEST/HISTORY event/DOCTOR/RESET [event ...] report the spikes of the latency monitor like redis.
+     * LATENCY HISTOGRAM [command ...] replies the calls of the commands & their cumulative counts of calls taking up
+     * to each power of 2 microseconds, like redis 7, the histograms are cleared by CONFIG RESETSTAT.
+     */
+    int Ardb::Latency(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        std::string subcmd = string_tolower(cmd.GetArguments()[0]);
+        LatencyMonitor& monitor = LatencyMonitor::GetSingleton();
+        if (subcmd == "reset")
+        {
+            std::vector<std::string> events(cmd.GetArguments().begin() + 1, cmd.GetArguments().end());
+            reply.SetInteger(monitor.Reset(events));
+            return 0;
+        }
+        if (subcmd == "latest" || subcmd == "doctor" || (subcmd == "history" && cmd.GetArguments().size() == 2))
+        {
+            LatencyEventTable events;
+            monitor.GetEvents(events);
+            std::vector<LatencySample> samples;
+            if (subcmd == "history")
+            {
+                reply.ReserveMember(0);
+                LatencyEventTable::iterator found = events.find(cmd.GetArguments()[1]);
+                if (found != events.end())
+                {
+                    found->second.GetSamples(samples);
+                }
+                for (size_t i = 0; i < samples.size(); i++)
+                {
+                    RedisReply& r = reply.AddMember();
+                    r.ReserveMember(0);
+                    r.AddMember().SetInteger(samples[i].time);
+                    r.AddMember().SetInteger(samples[i].latency);
+                }
+                return 0;
+            }
+            std::string doctor;
+            if (subcmd == "latest")
+            {
+                reply.ReserveMember(0);
+            }
+            else if (!monitor.Enabled())
+            {
+                doctor.append("The latency monitor is disabled, set 'latency-monitor-threshold' to the milliseconds of the spikes to track.\n");
+            }
+            else if (events.empty())
+            {
+                doctor.append("No latency spikes were observed.\n");
+            }
+            LatencyEventTable::iterator it = events.begin();
+            for (; it != events.end(); it++)
+            {
+                it->second.GetSamples(samples);
+                if (samples.empty())
+                {
+                    continue;
+                }
+                const LatencySample& latest = samples[samples.size() - 1];
+                if (subcmd == "latest")
+                {
+                    RedisReply& r = reply.AddMember();
+                    r.ReserveMember(0);
+                    r.AddMember().SetString(it->first);
+                    r.AddMember().SetInteger(latest.time);
+                    r.AddMember().SetInteger(latest.latency);
+                    r.AddMember().SetInteger(it->second.max);
+                    continue;
+                }
+                uint64 sum = 0;
+                for (size_t i = 0; i < samples.size(); i++)
+                {
+                    sum += samples[i].latency;
+                }
+                doctor.append(it->first).append(": ").append(stringfromll(samples.size())).append(" latency spikes(average ").append(
+                        stringfromll(sum / samples.size())).append("ms), worst all time event ").append(stringfromll(it->second.max)).append(
+                        "ms, latest ").append(stringfromll(latest.latency)).append("ms ").append(stringfromll(time(NULL) - latest.time)).append(
+                        " seconds ago.\n");
+            }
+            if (subcmd == "doctor")
+            {
+                reply.SetString(doctor);
+            }
+            return 0;
+        }
+        if (subcmd != "histogram")
+        {
+            reply.SetErrorReason("LATENCY subcommand must be one of LATEST, HISTORY, DOCTOR, RESET, HISTOGRAM");
+            return 0;
+        }
+        std::vector<RedisCommandHandlerSetting*> settings;
+        if (cmd.GetArguments().size() == 1)
+        {
+            RedisCommandHandlerSettingTable::iterator cit = m_settings.begin();
+            for (; cit != m_settings.end(); cit++)
+            {
+                settings.push_back(&(cit->second));
+            }
+        }
+        for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+        {
+            RedisCommandHandlerSettingTable::iterator found = m_settings.find(cmd.GetArguments()[i]);
+            if (found != m_settings.end())
+            {
+                settings.push_back(&(found->second));
+            }
+        }
+        reply.ReserveMember(0);
+        for (size_t i = 0; i < settings.size(); i++)
+        {
+            CostHistogram hist;
+            settings[i]->cost_track->GetHistogram(hist);
+            uint64 calls = 0;
+            for (size_t j = 0; j < hist.size(); j++)
+            {
+                calls += hist[j];
+            }
+            if (0 == calls)
+            {
+                continue;
+            }
+            reply.AddMember().SetString(settings[i]->name);
+            RedisReply& stat = reply.AddMember();
+            stat.ReserveMember(0);
+            stat.AddMember().SetString("calls");
+            stat.AddMember().SetInteger(calls);
+            stat.AddMember().SetString("histogram_usec");
+            RedisReply& buckets = stat.AddMember();
+            buckets.ReserveMember(0);
+            uint64 bound = 1, seen = 0, last = 0;
+            size_t j = 0;
+            while (seen < calls)
+            {
+                while (j < hist.size() && cost_hist_lowest(j) <= bound)
+                {
+                    seen += hist[j++];
+                }
+                if (seen > last)
+                {
+                    buckets.AddMember().SetInteger(bound);
+                    buckets.AddMember().SetInteger(seen);
+                    last = seen;
+                }
+                bound <<= 1;
+            }
+        }
+        return 0;
+    }
+
+    static const char* hotkey_type_name(uint8 type)
+    {
+        switch (type)
+        {
+            case KEY_HASH:
+                return "hash";
+            case KEY_LIST:
+                return "list";
+            case KEY_SET:
+                return "set";
+            case KEY_ZSET:
+                return "zset";
+            default:
+                return "string";
+        }
+    }
+
+    /*
+     *  HOTKEYS HOT|BIG [count]
+     *  HOTKEYS RESET
+     */
+    int Ardb::HotKeys(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        std::string subcmd = string_tolower(cmd.GetArguments()[0]);
+        HotKeyTracker& tracker = HotKeyTracker::GetSingleton();
+        if (subcmd == "reset" && cmd.GetArguments().size() == 1)
+        {
+            tracker.Reset();
+            reply.SetStatusCode(STATUS_OK);
+            return 0;
+        }
+        if (subcmd != "hot" && subcmd != "big")
+        {
+            reply.SetErrorReason("HOTKEYS subcommand must be one of HOT, BIG, RESET");
+            return 0;
+        }
+        uint32 count = 10;
+        if (cmd.GetArguments().size() == 2 && !string_touint32(cmd.GetArguments()[1], count))
+        {
+            reply.SetErrCode(ERR_INVALID_INTEGER_ARGS);
+            return 0;
+        }
+        HotKeyArray keys;
+        if (subcmd == "hot")
+        {
+            tracker.GetHotKeys(keys, count);
+        }
+        else
+        {
+            tracker.GetBigKeys(keys, count);
+        }
+        reply.ReserveMember(0);
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            RedisReply& r = reply.AddMember();
+            r.ReserveMember(0);
+            r.AddMember().SetString(keys[i].ns);
+            r.AddMember().SetString(keys[i].key);
+            if (subcmd == "big")
+            {
+                r.AddMember().SetString(hotkey_type_name(keys[i].type));
+            }
+            r.AddMember().SetInteger(keys[i].count);
+        }
+        return 0;
+    }
+
+    int Ardb::BGJobs(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        BackgroundJobs& jobs = BackgroundJobs::GetSingleton();
+        std::string subcmd = cmd.GetArguments().empty() ? "list" : string_tolower(cmd.GetArguments()[0]);
+        if (subcmd == "list" && cmd.GetArguments().size() <= 1)
+        {
+            static const char* priority_names[] = { "high", "normal", "low" };
+            std::vector<BackgroundJobClass> classes;
+            jobs.GetClasses(classes);
+            reply.ReserveMember(0);
+            for (size_t i = 0; i < classes.size(); i++)
+            {
+                RedisReply& r = reply.AddMember();
+                r.ReserveMember(0);
+                r.AddMember().SetString(classes[i].name);
+                r.AddMember().SetString(priority_names[classes[i].priority]);
+                r.AddMember().SetString(classes[i].paused ? "paused" : (classes[i].running > 0 ? "running" : "idle"));
+                r.AddMember().SetInteger(classes[i].runs);
+                r.AddMember().SetInteger(classes[i].skipped);
+                r.AddMember().SetInteger(classes[i].runs > 0 ? classes[i].total_micros / classes[i].runs : 0);
+                r.AddMember().SetInteger(classes[i].max_micros);
+            }
+            return 0;
+        }
+        if (subcmd == "io" && cmd.GetArguments().size() == 1)
+        {
+            uint64 bytes = 0, wait_micros = 0, p99 = 0;
+            jobs.GetIOStats(bytes, wait_micros, p99);
+            reply.ReserveMember(0);
+            reply.AddMember().SetString("rate_bytes_per_sec");
+            reply.AddMember().SetInteger(jobs.GetRate());
+            reply.AddMember().SetString("max_bytes_per_sec");
+            reply.AddMember().SetInteger(m_conf.bgjobs_max_mb_per_sec * 1024 * 1024);
+            reply.AddMember().SetString("charged_bytes");
+            reply.AddMember().SetInteger(bytes);
+            reply.AddMember().SetString("wait_micros");
+            reply.AddMember().SetInteger(wait_micros);
+            reply.AddMember().SetString("foreground_p99_usec");
+            reply.AddMember().SetInteger(p99);
+            return 0;
+        }
+        if ((subcmd != "pause" && subcmd != "resume") || cmd.GetArguments().size() != 2)
+        {
+            reply.SetErrorReason("BGJOBS subcommand must be one of LIST, IO, PAUSE <class>, RESUME <class>");
+            return 0;
+        }
+        int type = BackgroundJobs::GetJobType(cmd.GetArguments()[1]);
+        if (type < 0)
+        {
+            reply.SetErrorReason("unknown background job class");
+            return 0;
+        }
+        jobs.Pause((BackgroundJobType) type, subcmd == "pause");
+        reply.SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
     int Ardb::DBSize(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
-        reply.SetInteger(m_engine->EstimateKeysNum(ctx, ctx.ns));
+        /*
+         * counted by the key cache like KEYSCOUNT for db 0, engine estimates differ a lot & some count element keys too
+         */
+        if (IsKeyCacheNameSpace(ctx.ns))
+        {
+            reply.SetInteger(m_key_cache->size());
+        }
+        else
+        {
+            reply.SetInteger(m_engine->EstimateKeysNum(ctx, ctx.ns));
+        }
         return 0;
     }
 
@@ -447,11 +997,30 @@ namespace ardb
             ch->Close();
         }
     }
-    static void channel_pause_callback(Channel* ch, void*)
+    struct ChannelResumeTask: public Runnable
+    {
+            ChannelService* service;
+            uint32 channel_id;
+            ChannelResumeTask(ChannelService* s, uint32 id) :
+                    service(s), channel_id(id)
+            {
+            }
+            void Run()
+            {
+                Channel* ch = service->GetChannel(channel_id);
+                if (NULL != ch)
+                {
+                    ch->AttachFD();
+                }
+            }
+    };
+    static void channel_pause_callback(Channel* ch, void* data)
     {
         if (NULL != ch)
         {
             ch->DetachFD();
+            int64 timeout = (int64) (long) data;
+            ch->GetService().GetTimer().ScheduleHeapTask(new ChannelResumeTask(&ch->GetService(), ch->GetID()), timeout, -1, MILLIS);
         }
     }
 
@@ -468,7 +1037,7 @@ namespace ardb
         {
             if (cmd.GetArguments().size() != 2)
             {
-                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout)");
+                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout | TRACKING on|off)");
                 return 0;
             }
             ctx.client->name = cmd.GetArguments()[1];
@@ -478,7 +1047,7 @@ namespace ardb
         {
             if (cmd.GetArguments().size() != 1)
             {
-                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout)");
+                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout | TRACKING on|off)");
                 return 0;
             }
             if (ctx.client->name.empty())
@@ -495,7 +1064,7 @@ namespace ardb
             //pause all clients
             if (cmd.GetArguments().size() != 2)
             {
-                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout)");
+                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout | TRACKING on|off)");
                 return 0;
             }
             uint32 timeout;
@@ -505,17 +1074,15 @@ namespace ardb
                 return 0;
             }
             LockGuard<SpinMutexLock> guard(m_clients_lock);
-            ContextSet::iterator it = m_all_clients.begin();
-            while (it != m_all_clients.end())
+            ClientContext* client = m_all_clients.head;
+            while (NULL != client)
             {
-                Context* client = *it;
-                if (NULL != client->client && NULL != client->client->client)
+                if (NULL != client->client)
                 {
-                    SocketChannel* conn = (SocketChannel*) (client->client->client);
-                    conn->GetService().AsyncIO(conn->GetID(), channel_pause_callback, NULL);
-                    client->client->resume_ustime = get_current_epoch_micros() + timeout * 1000;
+                    SocketChannel* conn = (SocketChannel*) (client->client);
+                    conn->GetService().AsyncIO(conn->GetID(), channel_pause_callback, (void*) (long) timeout);
                 }
-                it++;
+                client = client->next;
             }
             reply.SetStatusCode(STATUS_OK);
         }
@@ -523,21 +1090,20 @@ namespace ardb
         {
             if (cmd.GetArguments().size() != 2)
             {
-                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout)");
+                reply.SetErrorReason("Syntax error, try CLIENT (LIST | KILL ip:port | GETNAME | SETNAME connection-name | PAUSE timeout | TRACKING on|off)");
                 return 0;
             }
             LockGuard<SpinMutexLock> guard(m_clients_lock);
-            ContextSet::iterator it = m_all_clients.begin();
-            while (it != m_all_clients.end())
+            ClientContext* client = m_all_clients.head;
+            while (NULL != client)
             {
-                Context* client = *it;
-                SocketChannel* conn = (SocketChannel*) (client->client->client);
+                SocketChannel* conn = (SocketChannel*) (client->client);
                 if (conn->GetRemoteStringAddress() == cmd.GetArguments()[1])
                 {
                     conn->GetService().AsyncIO(conn->GetID(), channel_close_callback, NULL);
                     break;
                 }
-                it++;
+                client = client->next;
             }
             reply.SetStatusCode(STATUS_OK);
         }
@@ -545,11 +1111,11 @@ namespace ardb
         {
             std::string info;
             LockGuard<SpinMutexLock> guard(m_clients_lock);
-            ContextSet::iterator it = m_all_clients.begin();
+            ClientContext* client = m_all_clients.head;
             uint64 now = get_current_epoch_micros();
-            while (it != m_all_clients.end())
+            while (NULL != client)
             {
-                Context* client_ctx = *it;
+                Context* client_ctx = client->ctx;
                 SocketChannel* conn = (SocketChannel*) (client_ctx->client->client);
                 info.append("id=").append(stringfromll(conn->GetID())).append(" ");
                 info.append("addr=").append(conn->GetRemoteStringAddress()).append(" ");
@@ -575,25 +1141,139 @@ namespace ardb
                 }
                 info.append("cmd=").append(cmd).append(" ");
                 info.append("\n");
-                it++;
+                client = client->next;
             }
             reply.SetString(info);
         }
-        else
+        else if (subcmd == "tracking")
         {
-            reply.SetErrorReason("CLIENT subcommand must be one of LIST, GETNAME, SETNAME, KILL, PAUSE");
+            EnableTracking(ctx, cmd);
         }
-        return 0;
-    }
-
-    int Ardb::Config(Context& ctx, RedisCommandFrame& cmd)
-    {
-        RedisReply& reply = ctx.GetReply();
-        std::string arg0 = string_tolower(cmd.GetArguments()[0]);
-        if (arg0 != "get" && arg0 != "set" && arg0 != "resetstat" && arg0 != "reload" && arg0 != "rewrite")
+        else if (subcmd == "getredir")
         {
-            reply.SetErrorReason("CONFIG subcommand must be one of GET, SET, RESETSTAT, REWRITE, RELOAD");
-            return 0;
+            reply.SetInteger(NULL != ctx.tracking ? (int64) ctx.tracking->redirect : -1);
+        }
+        else if (subcmd == "qos")
+        {
+            /*
+             * CLIENT QOS [<ops/s> <bytes/s> | RESET] limits this connection instead of qos-client-ops-limit &
+             * qos-client-bytes-limit, RESET goes back to them. Replies the limits in effect.
+             */
+            ClientContext& client = *ctx.client;
+            if (cmd.GetArguments().size() == 2 && !strcasecmp(cmd.GetArguments()[1].c_str(), "reset"))
+            {
+                client.qos_custom = false;
+                client.qos_ops.SetRate(GetConf().qos_client_ops_limit);
+                client.qos_bytes.SetRate(GetConf().qos_client_bytes_limit);
+            }
+            else if (cmd.GetArguments().size() == 3)
+            {
+                int64 ops = 0, bytes = 0;
+                if (!string_toint64(cmd.GetArguments()[1], ops) || !string_toint64(cmd.GetArguments()[2], bytes) || ops < 0 || bytes < 0)
+                {
+                    reply.SetErrCode(ERR_INVALID_INTEGER_ARGS);
+                    return 0;
+                }
+                client.qos_custom = true;
+                client.qos_ops.SetRate(ops);
+                client.qos_bytes.SetRate(bytes);
+            }
+            else if (cmd.GetArguments().size() != 1)
+            {
+                reply.SetErrorReason("Syntax error, try CLIENT QOS [ops-per-sec bytes-per-sec | RESET]");
+                return 0;
+            }
+            reply.ReserveMember(0);
+            reply.AddMember().SetString("ops");
+            reply.AddMember().SetInteger(client.qos_custom ? client.qos_ops.rate : GetConf().qos_client_ops_limit);
+            reply.AddMember().SetString("bytes");
+            reply.AddMember().SetInteger(client.qos_custom ? client.qos_bytes.rate : GetConf().qos_client_bytes_limit);
+        }
+        else
+        {
+            reply.SetErrorReason("CLIENT subcommand must be one of LIST, GETNAME, SETNAME, KILL, PAUSE, TRACKING, GETREDIR, QOS");
+        }
+        return 0;
+    }
+
+    /*
+     * Replaces the value of option 'name' in an engine options string at any nesting level of '{}'(rocksdb's
+     * table factory options), or appends it at the top level, so CONFIG REWRITE persists the option set at runtime.
+     */
+    static std::string merge_engine_option(const std::string& options, char sep, const std::string& name, const std::string& value)
+    {
+        size_t pos = 0;
+        while (pos < options.size())
+        {
+            while (pos < options.size() && isspace(options[pos]))
+            {
+                pos++;
+            }
+            size_t eq = pos + name.size();
+            if (!options.compare(pos, name.size(), name) && eq < options.size() && options[eq] == '=')
+            {
+                size_t end = eq + 1;
+                int depth = 0;
+                while (end < options.size() && (depth > 0 || (options[end] != sep && options[end] != '}')))
+                {
+                    depth += options[end] == '{' ? 1 : (options[end] == '}' ? -1 : 0);
+                    end++;
+                }
+                return options.substr(0, eq + 1) + value + options.substr(end);
+            }
+            while (pos < options.size() && options[pos] != sep && options[pos] != '{' && options[pos] != '}')
+            {
+                pos++;
+            }
+            pos++;
+        }
+        std::string merged = trim_string(options, " \t");
+        if (!merged.empty() && merged[merged.size() - 1] != sep)
+        {
+            merged.push_back(sep);
+        }
+        if (!strcmp(g_engine_name, "rocksdb") && name == "block_cache")
+        {
+            return merged + "block_based_table_factory={block_cache=" + value + "}";
+        }
+        return merged + name + "=" + value;
+    }
+
+    /*
+     * CONFIG SET <engine>.<option> changes one option of '<engine>.options' on the running engine.
+     */
+    int Ardb::ConfigSetEngineOption(Context& ctx, const std::string& option, const std::string& value)
+    {
+        RedisReply& reply = ctx.GetReply();
+        int err = m_engine->SetOption(ctx, option, value);
+        if (ERR_NOTSUPPORTED == err)
+        {
+            reply.SetErrorReason("Option '" + option + "' of " + g_engine_name + " can not be changed at runtime");
+            return 0;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+            return 0;
+        }
+        std::string options_key = g_engine_name;
+        options_key.append(".options");
+        WriteLockGuard<SpinRWLock> guard(m_conf.lock);
+        std::string options;
+        conf_get_string(m_conf.conf_props, options_key, options);
+        conf_set(m_conf.conf_props, options_key, merge_engine_option(options, strcmp(g_engine_name, "rocksdb") ? ',' : ';', option, value));
+        reply.SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
+    int Ardb::Config(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        std::string arg0 = string_tolower(cmd.GetArguments()[0]);
+        if (arg0 != "get" && arg0 != "set" && arg0 != "resetstat" && arg0 != "reload" && arg0 != "rewrite")
+        {
+            reply.SetErrorReason("CONFIG subcommand must be one of GET, SET, RESETSTAT, REWRITE, RELOAD");
+            return 0;
         }
         if (arg0 == "resetstat")
         {
@@ -603,6 +1283,12 @@ namespace ardb
                 return 0;
             }
             Statistics::GetSingleton().Clear();
+            RedisCommandHandlerSettingTable::iterator cit = m_settings.begin();
+            for (; cit != m_settings.end(); cit++)
+            {
+                cit->second.engine_profile->Clear();
+                cit->second.cost_track->ClearHistogram();
+            }
             reply.SetStatusCode(STATUS_OK);
         }
         else if (arg0 == "get")
@@ -646,19 +1332,51 @@ namespace ardb
                 reply.SetErrorReason("Wrong number of arguments for CONFIG SET");
                 return 0;
             }
+            std::string engine_prefix = g_engine_name;
+            engine_prefix.append(".");
+            const std::string& name = cmd.GetArguments()[1];
+            if (has_prefix(name, engine_prefix) && name != engine_prefix + "options")
+            {
+                return ConfigSetEngineOption(ctx, name.substr(engine_prefix.size()), cmd.GetArguments()[2]);
+            }
             conf_set(m_conf.conf_props, cmd.GetArguments()[1], cmd.GetArguments()[2]);
             WriteLockGuard<SpinRWLock> guard(m_conf.lock);
             m_conf.Parse(m_conf.conf_props);
+            PublishConf();
+            set_value_compress_threshold(m_conf.value_compress_threshold);
+            LatencyMonitor::GetSingleton().SetThreshold(m_conf.latency_monitor_threshold);
+            HotKeyTracker::GetSingleton().SetSampleRate(m_conf.hotkeys_sample_rate);
+            HotKeyTracker::GetSingleton().SetBigKeyMinLength(m_conf.bigkeys_min_length);
+            BackgroundJobs::GetSingleton().SetCpuShare(m_conf.bgjobs_cpu_share);
+            BackgroundJobs::GetSingleton().SetLatencyTarget(m_conf.bgjobs_latency_target);
+            BackgroundJobs::GetSingleton().SetMaxMBPerSec(m_conf.bgjobs_max_mb_per_sec);
+            if (!TenantLimiter::GetSingleton().SetLimits(m_conf.qos_namespace_limits))
+            {
+                WARN_LOG("Invalid qos-namespace-limits:%s", m_conf.qos_namespace_limits.c_str());
+            }
             reply.SetStatusCode(STATUS_OK);
         }
         else if (arg0 == "reload")
         {
             if (!m_conf._conf_file.empty())
             {
+                WriteLockGuard<SpinRWLock> guard(m_conf.lock);
                 Properties props;
                 if (parse_conf_file(m_conf._conf_file, props, " ") && m_conf.Parse(props))
                 {
                     m_conf.conf_props = props;
+                    PublishConf();
+                    set_value_compress_threshold(m_conf.value_compress_threshold);
+                    LatencyMonitor::GetSingleton().SetThreshold(m_conf.latency_monitor_threshold);
+                    HotKeyTracker::GetSingleton().SetSampleRate(m_conf.hotkeys_sample_rate);
+                    HotKeyTracker::GetSingleton().SetBigKeyMinLength(m_conf.bigkeys_min_length);
+                    BackgroundJobs::GetSingleton().SetCpuShare(m_conf.bgjobs_cpu_share);
+                    BackgroundJobs::GetSingleton().SetLatencyTarget(m_conf.bgjobs_latency_target);
+                    BackgroundJobs::GetSingleton().SetMaxMBPerSec(m_conf.bgjobs_max_mb_per_sec);
+                    if (!TenantLimiter::GetSingleton().SetLimits(m_conf.qos_namespace_limits))
+                    {
+                        WARN_LOG("Invalid qos-namespace-limits:%s", m_conf.qos_namespace_limits.c_str());
+                    }
                     reply.SetStatusCode(STATUS_OK);
                     return 0;
                 }
@@ -693,19 +1411,119 @@ namespace ardb
         return 0;
     }
 
+    /*
+     * MEMORY STATS
+     * MEMORY PURGE [arena]
+     * PURGE without arena returns the unused pages of the keycache & reply arenas, the ones growing with traffic.
+     */
+    int Ardb::Memory(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        std::string subcmd = string_tolower(cmd.GetArguments()[0]);
+        if (subcmd == "stats")
+        {
+            reply.type = REDIS_REPLY_ARRAY;
+            reply.AddMember().SetString("used_memory_rss");
+            reply.AddMember().SetInteger(mem_rss_size());
+            reply.AddMember().SetString("buffer_pool_allocated");
+            reply.AddMember().SetInteger(BufferPool::AllocatedBytes());
+            reply.AddMember().SetString("buffer_pool_shared_cached");
+            reply.AddMember().SetInteger(BufferPool::SharedCachedBytes());
+            for (int i = 0; i < MEM_ARENA_MAX; i++)
+            {
+                MemArenaStats stats;
+                arena_stats((MemArenaKind) i, stats);
+                reply.AddMember().SetString(std::string("arena.") + arena_name((MemArenaKind) i));
+                RedisReply& r = reply.AddMember();
+                r.type = REDIS_REPLY_ARRAY;
+                r.AddMember().SetString("allocated");
+                r.AddMember().SetInteger(stats.allocated);
+                r.AddMember().SetString("active");
+                r.AddMember().SetInteger(stats.active);
+                r.AddMember().SetString("dirty");
+                r.AddMember().SetInteger(stats.dirty);
+                r.AddMember().SetString("allocs");
+                r.AddMember().SetInteger(stats.allocs);
+            }
+        }
+        else if (subcmd == "purge")
+        {
+            std::vector<MemArenaKind> kinds;
+            if (cmd.GetArguments().size() > 1)
+            {
+                MemArenaKind kind = arena_kind(cmd.GetArguments()[1]);
+                if (kind == MEM_ARENA_MAX)
+                {
+                    reply.SetErrorReason("unknown arena, must be one of keycache, reply, lua, repl");
+                    return 0;
+                }
+                kinds.push_back(kind);
+            }
+            else
+            {
+                kinds.push_back(MEM_ARENA_KEYCACHE);
+                kinds.push_back(MEM_ARENA_REPLY);
+            }
+            for (size_t i = 0; i < kinds.size(); i++)
+            {
+                if (kinds[i] == MEM_ARENA_REPLY)
+                {
+                    BufferPool::ReleaseShared();
+                }
+                arena_purge(kinds[i]);
+            }
+            reply.SetStatusCode(STATUS_OK);
+        }
+        else
+        {
+            reply.SetErrorReason("MEMORY subcommand must be one of STATS, PURGE");
+        }
+        return 0;
+    }
+
+    /*
+     * FLUSHDB/FLUSHALL [ASYNC|SYNC]
+     */
+    static bool parse_flush_mode(RedisCommandFrame& cmd, bool& async)
+    {
+        async = false;
+        if (cmd.GetArguments().empty())
+        {
+            return true;
+        }
+        if (!strcasecmp(cmd.GetArguments()[0].c_str(), "async"))
+        {
+            async = true;
+            return true;
+        }
+        return !strcasecmp(cmd.GetArguments()[0].c_str(), "sync");
+    }
+
     int Ardb::FlushDB(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
+        bool async = false;
+        if (!parse_flush_mode(cmd, async))
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
         reply.SetStatusCode(STATUS_OK);
-        FlushDB(ctx, ctx.ns);
+        FlushDB(ctx, ctx.ns, async);
         return 0;
     }
 
     int Ardb::FlushAll(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
+        bool async = false;
+        if (!parse_flush_mode(cmd, async))
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
         reply.SetStatusCode(STATUS_OK);
-        FlushAll(ctx);
+        FlushAll(ctx, async);
         return 0;
     }
 
@@ -716,20 +1534,52 @@ namespace ardb
         return -2;
     }
 
-    int Ardb::CompactDB(Context& ctx, RedisCommandFrame& cmd)
+    /*
+     * COMPACTDB/COMPACTALL [FULL|CANCEL]
+     */
+    static int start_compaction(Context& ctx, RedisCommandFrame& cmd, const Data& ns)
     {
         RedisReply& reply = ctx.GetReply();
+        bool full = false;
+        if (cmd.GetArguments().size() > 0)
+        {
+            if (!strcasecmp(cmd.GetArguments()[0].c_str(), "cancel"))
+            {
+                if (g_db->CancelCompaction())
+                {
+                    reply.SetStatusCode(STATUS_OK);
+                }
+                else
+                {
+                    reply.SetErrorReason("no compaction in progress");
+                }
+                return 0;
+            }
+            if (strcasecmp(cmd.GetArguments()[0].c_str(), "full"))
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            full = true;
+        }
+        if (0 != g_db->StartCompaction(ns, full))
+        {
+            reply.SetErrorReason("Background compaction already in progress");
+            return 0;
+        }
         reply.SetStatusCode(STATUS_OK);
-        CompactDB(ctx, ctx.ns);
         return 0;
     }
 
+    int Ardb::CompactDB(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return start_compaction(ctx, cmd, ctx.ns);
+    }
+
     int Ardb::CompactAll(Context& ctx, RedisCommandFrame& cmd)
     {
-        RedisReply& reply = ctx.GetReply();
-        reply.SetStatusCode(STATUS_OK);
-        CompactAll(ctx);
-        return 0;
+        Data all;
+        return start_compaction(ctx, cmd, all);
     }
     /*
      *  SlaveOf host port
@@ -743,6 +1593,11 @@ namespace ardb
             reply.SetErrorReason("not enough arguments for slaveof.");
             return 0;
         }
+        if (m_read_replica)
+        {
+            reply.SetErrorReason("slaveof is not allowed on a read replica.");
+            return 0;
+        }
         const std::string& host = cmd.GetArguments()[0];
         uint32 port = 0;
         if (!string_touint32(cmd.GetArguments()[1], port))
@@ -751,8 +1606,10 @@ namespace ardb
             {
                 reply.SetStatusCode(STATUS_OK);
                 g_repl->GetSlave().Stop();
+                WriteLockGuard<SpinRWLock> guard(m_conf.lock);
                 m_conf.master_host = "";
                 m_conf.master_port = 0;
+                PublishConf();
                 return 0;
             }
             reply.SetErrorReason("value is not an integer or out of range");
@@ -768,8 +1625,12 @@ namespace ardb
         {
             g_repl->GetSlave().Stop();
         }
-        m_conf.master_host = host;
-        m_conf.master_port = port;
+        {
+            WriteLockGuard<SpinRWLock> guard(m_conf.lock);
+            m_conf.master_host = host;
+            m_conf.master_port = port;
+            PublishConf();
+        }
         reply.SetStatusCode(STATUS_OK);
         return 0;
     }
@@ -782,6 +1643,7 @@ namespace ardb
             reply.SetErrorReason("ERR wrong number of arguments for ReplConf");
             return 0;
         }
+        bool compress_stream = false;
         for (uint32 i = 0; i < cmd.GetArguments().size(); i += 2)
         {
             if (!strcasecmp(cmd.GetArguments()[i].c_str(), "listening-port"))
@@ -794,9 +1656,41 @@ namespace ardb
             {
                 //do nothing
             }
+            else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "skip"))
+            {
+                //wal bytes dropped by the master's filter, replayed from the wal of a filtered slave, nothing to apply
+            }
+            else if (!strncasecmp(cmd.GetArguments()[i].c_str(), "filter-", 7))
+            {
+                /*
+                 * 'filter-ns' & 'filter-prefix' restrict the namespaces & keys replicated to the slave, 'filter-select'
+                 * is the namespace selected on the slave at its offset
+                 */
+                g_repl->GetMaster().SetSlaveFilter(ctx.client->client, cmd.GetArguments()[i], cmd.GetArguments()[i + 1]);
+            }
             else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "capa"))
             {
-                //do nothing
+                /*
+                 * ardb slaves advertise 'engine-<name>' to accept checkpoints of that engine at full resync,
+                 * suffixed by '-keycodec<version>' when their keys are not in KEY_CODEC_V1
+                 */
+                std::string engine_capa = std::string("engine-") + g_engine_name;
+                if (get_key_codec_version() != KEY_CODEC_V1)
+                {
+                    engine_capa.append("-keycodec").append(stringfromll(get_key_codec_version()));
+                }
+                if (cmd.GetArguments()[i + 1] == engine_capa)
+                {
+                    g_repl->GetMaster().SetSlaveEngineSync(ctx.client->client);
+                }
+                else if (cmd.GetArguments()[i + 1] == REPL_STREAM_CAPA && GetConf().repl_compress_stream)
+                {
+                    compress_stream = true;
+                }
+                else if (cmd.GetArguments()[i + 1] == "eof")
+                {
+                    g_repl->GetMaster().SetSlaveEOFCapa(ctx.client->client);
+                }
             }
             else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "getack"))
             {
@@ -811,6 +1705,205 @@ namespace ardb
             }
         }
         reply.SetStatusCode(STATUS_OK);
+        if (compress_stream)
+        {
+            /*
+             * the slave only switches to framing on this reply, older masters just reply OK
+             */
+            g_repl->GetMaster().SetSlaveCompressStream(ctx.client->client);
+            reply.str = "OK " REPL_STREAM_CAPA;
+        }
+        return 0;
+    }
+
+    /*
+     * WAIT numreplicas timeout
+     * The client is parked until 'numreplicas' slaves acked the wal end offset(which covers all writes of the client),
+     * or until 'timeout' milliseconds(0 for ever), replied with the number of slaves acked.
+     */
+    int Ardb::Wait(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        int64 numreplicas, timeout;
+        if (!string_toint64(cmd.GetArguments()[0], numreplicas) || !string_toint64(cmd.GetArguments()[1], timeout) || timeout < 0)
+        {
+            reply.SetErrCode(ERR_INVALID_INTEGER_ARGS);
+            return 0;
+        }
+        if (!GetConf().master_host.empty())
+        {
+            reply.SetErrorReason("WAIT cannot be used with slave instances.");
+            return 0;
+        }
+        if (!g_repl->IsInited())
+        {
+            reply.SetInteger(0);
+            return 0;
+        }
+        /*
+         * writes executed before are in the wal before the end offset
+         */
+        g_repl->GetReplLog().WaitWALWritten();
+        int64 offset = g_repl->GetReplLog().WALEndOffset();
+        int64 acked = 0;
+        if (!g_repl->GetMaster().WaitForAcks(ctx, offset, numreplicas, timeout, acked))
+        {
+            reply.SetInteger(acked);
+            return 0;
+        }
+        reply.type = 0; //wait
+        return 0;
+    }
+
+    /*
+     * CDC POS|READ <offset> [NS <ns>] [COUNT <n>]|COMMIT <consumer> <offset> [<ns>]|OFFSET <consumer>
+     * Change data capture from the wal backlog. POS replies the wal [start, end, namespace selected at end], READ replies
+     * [next offset, namespace selected at next offset, records], each record is [offset, ns, key, command, args...].
+     * Offsets must be the ones replied, 'ns' is the namespace selected at 'offset'. SELECT, PING, REPLCONF & MULTI/EXEC
+     * are not records. A consumer falling out of the backlog gets an error & has to rescan. COMMIT/OFFSET keep the
+     * position of named consumers. Reads copy the wal by chunks & never touch slaves' state.
+     */
+    int Ardb::CDC(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        std::string subcmd = string_tolower(args[0]);
+        if (!g_repl->IsInited())
+        {
+            reply.SetErrorReason("wal backlog is not inited.");
+            return 0;
+        }
+        if (subcmd == "pos" && args.size() == 1)
+        {
+            g_repl->GetReplLog().WaitWALWritten();
+            reply.ReserveMember(0);
+            reply.AddMember().SetInteger(g_repl->GetReplLog().WALStartOffset());
+            reply.AddMember().SetInteger(g_repl->GetReplLog().WALEndOffset());
+            reply.AddMember().SetString(g_repl->GetReplLog().CurrentNamespace());
+            return 0;
+        }
+        if (subcmd == "offset" && args.size() == 2)
+        {
+            CDCPosition pos;
+            if (!g_repl->GetCDCConsumers().Get(args[1], pos))
+            {
+                reply.Clear();
+                return 0;
+            }
+            reply.ReserveMember(0);
+            reply.AddMember().SetInteger(pos.offset);
+            reply.AddMember().SetString(pos.ns);
+            return 0;
+        }
+        CDCPosition pos;
+        if (subcmd == "commit" && (args.size() == 3 || args.size() == 4) && string_toint64(args[2], pos.offset))
+        {
+            if (args[1].find_first_of(" \r\n") != std::string::npos || (args.size() == 4 && args[3].find_first_of(" \r\n") != std::string::npos))
+            {
+                reply.SetErrorReason("consumer & namespace can not contain spaces.");
+                return 0;
+            }
+            pos.ns = args.size() == 4 ? args[3] : "";
+            if (0 != g_repl->GetCDCConsumers().Commit(args[1], pos))
+            {
+                reply.SetErrorReason("failed to save consumer offsets.");
+                return 0;
+            }
+            reply.SetStatusCode(STATUS_OK);
+            return 0;
+        }
+        if (subcmd != "read" || args.size() < 2 || !string_toint64(args[1], pos.offset))
+        {
+            reply.SetErrorReason("CDC subcommand must be one of POS, READ <offset> [NS <ns>] [COUNT <n>], COMMIT <consumer> <offset> [<ns>], OFFSET <consumer>");
+            return 0;
+        }
+        int64 count = 100;
+        for (size_t i = 2; i < args.size(); i += 2)
+        {
+            if (i + 1 < args.size() && !strcasecmp(args[i].c_str(), "ns"))
+            {
+                pos.ns = args[i + 1];
+            }
+            else if (i + 1 < args.size() && !strcasecmp(args[i].c_str(), "count") && string_toint64(args[i + 1], count) && count > 0)
+            {
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        int64 end = g_repl->GetReplLog().WALEndOffset();
+        if (pos.offset < (int64) g_repl->GetReplLog().WALStartOffset() || pos.offset > end)
+        {
+            reply.SetErrorReason("offset is out of the wal backlog, rescan & restart from CDC POS.");
+            return 0;
+        }
+        reply.ReserveMember(0);
+        RedisReply& next = reply.AddMember();
+        RedisReply& next_ns = reply.AddMember();
+        RedisReply& records = reply.AddMember();
+        records.ReserveMember(0);
+        int64 limit = 1024 * 1024;
+        int64 n = 0;
+        while (n < count && pos.offset < end)
+        {
+            Buffer wal;
+            if (0 != g_repl->GetReplLog().ReadWAL(pos.offset, limit, wal))
+            {
+                //the backlog was reset meanwhile
+                reply.SetErrorReason("offset is out of the wal backlog, rescan & restart from CDC POS.");
+                return 0;
+            }
+            while (n < count && wal.Readable())
+            {
+                size_t mark = wal.GetReadIndex();
+                RedisCommandFrame change;
+                if (!RedisCommandDecoder::Decode(NULL, wal, change))
+                {
+                    wal.SetReadIndex(mark);
+                    break;
+                }
+                int64 change_offset = pos.offset + mark;
+                const char* name = change.GetCommand().c_str();
+                if (!strcasecmp(name, "select"))
+                {
+                    pos.ns = change.GetArguments().empty() ? "" : change.GetArguments()[0];
+                    continue;
+                }
+                if (!strcasecmp(name, "ping") || !strcasecmp(name, "replconf") || !strcasecmp(name, "multi") || !strcasecmp(name, "exec"))
+                {
+                    continue;
+                }
+                FindRedisCommandHandlerSetting(change);
+                StringArray keys;
+                GetCommandKeys(change, keys);
+                RedisReply& r = records.AddMember();
+                r.ReserveMember(0);
+                r.AddMember().SetInteger(change_offset);
+                r.AddMember().SetString(pos.ns);
+                r.AddMember().SetString(keys.empty() ? "" : keys[0]);
+                r.AddMember().SetString(change.GetCommand());
+                for (size_t i = 0; i < change.GetArguments().size(); i++)
+                {
+                    r.AddMember().SetString(change.GetArguments()[i]);
+                }
+                n++;
+            }
+            if (0 == wal.GetReadIndex())
+            {
+                if (limit >= end - pos.offset)
+                {
+                    break;
+                }
+                //a command larger than the chunk
+                limit *= 2;
+                continue;
+            }
+            pos.offset += wal.GetReadIndex();
+        }
+        next.SetInteger(pos.offset);
+        next_ns.SetString(pos.ns);
         return 0;
     }
 
@@ -842,80 +1935,155 @@ namespace ardb
         return 0;
     }
 
-    static void monitor_write_callback(Channel* ch, void* data)
+    void Ardb::ReleaseMonitorFeed(MonitorFeed* feed)
     {
-        Buffer* buffer = (Buffer*) data;
+        if (0 == atomic_sub_uint32(&feed->refs, 1))
+        {
+            DELETE(feed);
+        }
+    }
+
+    void Ardb::MonitorWriteCallback(Channel* ch, void* data)
+    {
+        MonitorEvent* event = (MonitorEvent*) data;
+        MonitorFeed* feed = event->feed;
         if (NULL != ch && !ch->IsClosed())
         {
-            ch->GetOutputBuffer().Write(buffer, buffer->ReadableBytes());
+            uint64_t dropped = feed->dropped;
+            if (dropped > feed->reported)
+            {
+                struct timeval tv;
+                gettimeofday(&tv, NULL);
+                ch->GetOutputBuffer().Printf("+%ld.%06ld [monitor] %llu events dropped\r\n", (long) tv.tv_sec, (long) tv.tv_usec,
+                        (unsigned long long) (dropped - feed->reported));
+                feed->reported = dropped;
+            }
+            ch->GetOutputBuffer().Write(event->line->line.data(), event->line->line.size());
             ch->EnableWriting();
         }
-        DELETE(buffer);
+        atomic_sub_uint64(&feed->pending, event->line->line.size());
+        if (0 == atomic_sub_uint32(&event->line->refs, 1))
+        {
+            DELETE(event->line);
+        }
+        ReleaseMonitorFeed(feed);
+        DELETE(event);
     }
 
+    /*
+     * The command line is only formatted if one monitor takes the command, once for all of them. Each monitor gets it
+     * in its own IO thread, a monitor over 'monitor-output-limit' queued bytes misses it instead of growing its queue.
+     */
     void Ardb::FeedMonitors(Context& ctx, const Data& ns, RedisCommandFrame& cmd)
     {
-        ReadLockGuard<SpinRWLock> guard(m_monitors_lock);
+        ReadLockGuard<BigReaderLock> guard(m_monitors_lock);
         if (NULL == m_monitors)
         {
             return;
         }
-        Buffer buffer;
-        struct timeval tv;
-        gettimeofday(&tv, NULL);
-        buffer.Write("+", 1);
-        buffer.Printf("%ld.%06ld ", (long) tv.tv_sec, (long) tv.tv_usec);
-        if (ctx.flags.lua)
-        {
-            buffer.Printf("[%s lua] ", ns.AsString().c_str());
-        }
-        else
-        {
-            std::string addr;
-            ctx.client->client->GetRemoteAddress()->ToString(addr);
-            buffer.Printf("[%s %s] ", ns.AsString().c_str(), addr.c_str());
-        }
-        buffer.PrintString(cmd.GetCommand());
-        buffer.Write(" ", 1);
-        for (size_t j = 0; j < cmd.GetArguments().size(); j++)
+        uint64_t seq = atomic_add_uint64(&m_monitor_seq, 1);
+        uint64_t limit = GetConf().monitor_output_limit > 0 ? GetConf().monitor_output_limit : 0;
+        MonitorLine* line = NULL;
+        MonitorTable::iterator it = m_monitors->begin();
+        while (it != m_monitors->end())
         {
-            buffer.PrintString(cmd.GetArguments()[j]);
-            if (j != cmd.GetArguments().size() - 1)
+            Channel* client = it->first->client->client;
+            MonitorFeed* feed = it->second;
+            it++;
+            if (NULL == client || (seq % feed->sample) != 0)
             {
+                continue;
+            }
+            if (limit > 0 && feed->pending >= limit)
+            {
+                atomic_add_uint64(&feed->dropped, 1);
+                atomic_add_uint64(&m_monitor_dropped, 1);
+                continue;
+            }
+            if (NULL == line)
+            {
+                NEW(line, MonitorLine);
+                Buffer buffer;
+                struct timeval tv;
+                gettimeofday(&tv, NULL);
+                buffer.Write("+", 1);
+                buffer.Printf("%ld.%06ld ", (long) tv.tv_sec, (long) tv.tv_usec);
+                if (ctx.flags.lua)
+                {
+                    buffer.Printf("[%s lua] ", ns.AsString().c_str());
+                }
+                else
+                {
+                    std::string addr;
+                    ctx.client->client->GetRemoteAddress()->ToString(addr);
+                    buffer.Printf("[%s %s] ", ns.AsString().c_str(), addr.c_str());
+                }
+                buffer.PrintString(cmd.GetCommand());
                 buffer.Write(" ", 1);
+                for (size_t j = 0; j < cmd.GetArguments().size(); j++)
+                {
+                    buffer.PrintString(cmd.GetArguments()[j]);
+                    if (j != cmd.GetArguments().size() - 1)
+                    {
+                        buffer.Write(" ", 1);
+                    }
+                }
+                buffer.Write("\r\n", 2);
+                line->line.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+                line->refs = 1; //held until all events are queued
             }
+            MonitorEvent* event = NULL;
+            NEW(event, MonitorEvent);
+            event->line = line;
+            event->feed = feed;
+            atomic_add_uint32(&line->refs, 1);
+            atomic_add_uint32(&feed->refs, 1);
+            atomic_add_uint64(&feed->pending, line->line.size());
+            client->GetService().AsyncIO(client->GetID(), MonitorWriteCallback, event);
         }
-        buffer.Write("\r\n", 2);
-        ContextSet::iterator it = m_monitors->begin();
-        while (it != m_monitors->end())
+        if (NULL != line && 0 == atomic_sub_uint32(&line->refs, 1))
         {
-            Channel* client = (*it)->client->client;
-            if (NULL != client)
-            {
-                Buffer* send_buffer = NULL;
-                NEW(send_buffer, Buffer);
-                send_buffer->Write(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
-                client->GetService().AsyncIO(client->GetID(), monitor_write_callback, send_buffer);
-                //WriteReply()
-            }
-            it++;
+            DELETE(line);
         }
     }
 
+    /*
+     * MONITOR [SAMPLE <n>]
+     */
     int Ardb::Monitor(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
-        WriteLockGuard<SpinRWLock> guard(m_monitors_lock);
+        uint32 sample = 1;
+        if (cmd.GetArguments().size() > 0)
+        {
+            if (cmd.GetArguments().size() != 2 || strcasecmp(cmd.GetArguments()[0].c_str(), "sample"))
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            if (!string_touint32(cmd.GetArguments()[1], sample) || 0 == sample)
+            {
+                reply.SetErrCode(ERR_INVALID_INTEGER_ARGS);
+                return 0;
+            }
+        }
+        WriteLockGuard<BigReaderLock> guard(m_monitors_lock);
         if (NULL == m_monitors)
         {
-            NEW(m_monitors, ContextSet);
+            NEW(m_monitors, MonitorTable);
         }
-        if (!m_monitors->insert(&ctx).second)
+        MonitorTable::iterator found = m_monitors->find(&ctx);
+        if (found != m_monitors->end())
         {
+            found->second->sample = sample;
             reply.type = 0;
         }
         else
         {
+            MonitorFeed* feed = NULL;
+            NEW(feed, MonitorFeed);
+            feed->sample = sample;
+            m_monitors->insert(MonitorTable::value_type(&ctx, feed));
             reply.SetStatusCode(STATUS_OK);
         }
         return 0;
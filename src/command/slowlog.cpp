@@ -28,52 +28,158 @@
  */
 
 #include "db/db.hpp"
+#include "thread/thread_local.hpp"
+#include <algorithm>
 
 namespace ardb
 {
+    /*
+     * Arguments are truncated when captured like redis does, to bound the memory & copy cost of a slow command.
+     */
+    static const uint32 kSlowlogMaxArgc = 32;
+    static const uint32 kSlowlogMaxArgLen = 128;
+
     struct SlowLogRecord
     {
             uint64 id;
             uint64 ts;
             uint64 costs;
-            RedisCommandFrame cmd;
+            uint64 skipped_deletes;
+            bool profiled;
+            uint64 engine_micros;
+            uint64 lock_wait_micros;
+            int64 estimated_cost; //elements estimated by 'command-cost-limits', 0 if not estimated
+            int64 actual_cost;
+            StringArray cmd;
             SlowLogRecord() :
-                    id(0), ts(0), costs(0)
+                    id(0), ts(0), costs(0), skipped_deletes(0), profiled(false), engine_micros(0), lock_wait_micros(0), estimated_cost(0), actual_cost(0)
             {
             }
     };
     typedef std::deque<SlowLogRecord> SlowLogQueue;
-    static SlowLogQueue g_slowlog_queue;
-    static SpinMutexLock g_slowlog_queue_mutex;
-    static uint64 kSlowlogIDSeed = 0;
 
-    void Ardb::TryPushSlowCommand(const RedisCommandFrame& cmd, uint64 micros)
+    /*
+     * Each thread pushes into its own ring, so slow commands of different threads never meet on one lock, the ring's
+     * lock is only shared with SLOWLOG GET/LEN/RESET. Rings are kept after their thread exits since they are merged by
+     * id, every ring keeps 'slowlog-max-len' records which covers the newest ones of all threads.
+     */
+    struct SlowLogRing
     {
-        if (micros < GetConf().slowlog_log_slower_than)
+            SpinMutexLock lock;
+            SlowLogQueue queue;
+    };
+    typedef std::vector<SlowLogRing*> SlowLogRingArray;
+    static SpinMutexLock g_slowlog_rings_lock;
+    static SlowLogRingArray g_slowlog_rings;
+    static volatile uint64_t kSlowlogIDSeed = 0;
+
+    struct SlowLogThreadRing
+    {
+            SlowLogRing* ring;
+            SlowLogThreadRing() :
+                    ring(NULL)
+            {
+                NEW(ring, SlowLogRing);
+                LockGuard<SpinMutexLock> guard(g_slowlog_rings_lock);
+                g_slowlog_rings.push_back(ring);
+            }
+    };
+    static ThreadLocal<SlowLogThreadRing> g_slowlog_thread_ring;
+
+    static void slowlog_capture_args(const RedisCommandFrame& cmd, StringArray& args)
+    {
+        uint32 argc = cmd.GetArguments().size() + 1;
+        uint32 keep = argc > kSlowlogMaxArgc ? kSlowlogMaxArgc : argc;
+        args.resize(keep);
+        for (uint32 i = 0; i < keep; i++)
         {
-            return;
+            const std::string& arg = 0 == i ? cmd.GetCommand() : *(cmd.GetArgument(i - 1));
+            /*
+             * the last kept argument notes how many were left out
+             */
+            if (i == keep - 1 && keep < argc)
+            {
+                args[i] = "... (" + stringfromll(argc - keep + 1) + " more arguments)";
+            }
+            else if (arg.size() > kSlowlogMaxArgLen)
+            {
+                args[i].assign(arg.data(), kSlowlogMaxArgLen);
+                args[i].append("... (").append(stringfromll(arg.size() - kSlowlogMaxArgLen)).append(" more bytes)");
+            }
+            else
+            {
+                args[i] = arg;
+            }
         }
-        LockGuard<SpinMutexLock> guard(g_slowlog_queue_mutex);
-        while (GetConf().slowlog_max_len > 0 && g_slowlog_queue.size() >= (uint32) GetConf().slowlog_max_len)
+    }
+
+    void Ardb::TryPushSlowCommand(const RedisCommandFrame& cmd, uint64 micros, uint64 skipped_deletes, const EngineProfile* profile,
+            int64 estimated_cost, int64 actual_cost)
+    {
+        if (micros < GetConf().slowlog_log_slower_than)
         {
-            g_slowlog_queue.pop_front();
+            return;
         }
         SlowLogRecord log;
-        log.id = kSlowlogIDSeed++;
+        log.id = atomic_add_uint64(&kSlowlogIDSeed, 1) - 1;
         log.costs = micros;
+        log.skipped_deletes = skipped_deletes;
+        log.estimated_cost = estimated_cost;
+        log.actual_cost = actual_cost;
         log.ts = get_current_epoch_micros();
-        log.cmd = cmd;
-        g_slowlog_queue.push_back(log);
+        if (NULL != profile)
+        {
+            log.profiled = true;
+            log.engine_micros = (profile->engine_nanos + profile->iterate_nanos) / 1000;
+            log.lock_wait_micros = profile->lock_wait_nanos / 1000;
+        }
+        slowlog_capture_args(cmd, log.cmd);
+        SlowLogRing* ring = g_slowlog_thread_ring.GetValue().ring;
+        LockGuard<SpinMutexLock> guard(ring->lock);
+        while (GetConf().slowlog_max_len > 0 && ring->queue.size() >= (uint32) GetConf().slowlog_max_len)
+        {
+            ring->queue.pop_front();
+        }
+        ring->queue.resize(ring->queue.size() + 1);
+        std::swap(ring->queue.back(), log);
+    }
+
+    static bool slowlog_record_less(const SlowLogRecord& a, const SlowLogRecord& b)
+    {
+        return a.id < b.id;
+    }
+
+    /*
+     * Merge the records of all rings by id & keep the newest 'slowlog-max-len' of them.
+     */
+    static void slowlog_merge(SlowLogQueue& merged, int64 max_len)
+    {
+        SlowLogRingArray rings;
+        {
+            LockGuard<SpinMutexLock> guard(g_slowlog_rings_lock);
+            rings = g_slowlog_rings;
+        }
+        for (size_t i = 0; i < rings.size(); i++)
+        {
+            LockGuard<SpinMutexLock> guard(rings[i]->lock);
+            merged.insert(merged.end(), rings[i]->queue.begin(), rings[i]->queue.end());
+        }
+        std::sort(merged.begin(), merged.end(), slowlog_record_less);
+        while (max_len > 0 && merged.size() > (size_t) max_len)
+        {
+            merged.pop_front();
+        }
     }
 
     void Ardb::GetSlowlog(Context& ctx, uint32 len)
     {
         RedisReply& reply = ctx.GetReply();
         reply.type = REDIS_REPLY_ARRAY;
-        LockGuard<SpinMutexLock> guard(g_slowlog_queue_mutex);
-        for (uint32 i = 0; i < len && i < g_slowlog_queue.size(); i++)
+        SlowLogQueue queue;
+        slowlog_merge(queue, GetConf().slowlog_max_len);
+        for (uint32 i = 0; i < len && i < queue.size(); i++)
         {
-            SlowLogRecord& log = g_slowlog_queue[i];
+            SlowLogRecord& log = queue[i];
             RedisReply& r = reply.AddMember();
             RedisReply& rr1 = r.AddMember();
             RedisReply& rr2 = r.AddMember();
@@ -85,12 +191,38 @@ namespace ardb
             RedisReply& cmdreply = r.AddMember();
 
             cmdreply.type = REDIS_REPLY_ARRAY;
-            RedisReply& cmdname = cmdreply.AddMember();
-            cmdname.SetString(log.cmd.GetCommand());
-            for (uint32 j = 0; j < log.cmd.GetArguments().size(); j++)
+            for (uint32 j = 0; j < log.cmd.size(); j++)
             {
                 RedisReply& arg = cmdreply.AddMember();
-                arg.SetString(*(log.cmd.GetArgument(j)));
+                arg.SetString(log.cmd[j]);
+            }
+            /*
+             * deleted entries the engine skipped while reading, only for the commands which met some or were profiled
+             */
+            if (log.skipped_deletes > 0 || log.profiled || log.estimated_cost > 0)
+            {
+                RedisReply& skipped = r.AddMember();
+                skipped.SetInteger(log.skipped_deletes);
+            }
+            /*
+             * microseconds in engine calls & iterators, and waiting for key locks, with engine-profiling
+             */
+            if (log.profiled)
+            {
+                RedisReply& engine = r.AddMember();
+                engine.SetInteger(log.engine_micros);
+                RedisReply& lock_wait = r.AddMember();
+                lock_wait.SetInteger(log.lock_wait_micros);
+            }
+            /*
+             * elements estimated before the command ran by 'command-cost-limits' & the ones it returned, as a pair
+             */
+            if (log.estimated_cost > 0)
+            {
+                RedisReply& cost = r.AddMember();
+                cost.type = REDIS_REPLY_ARRAY;
+                cost.AddMember().SetInteger(log.estimated_cost);
+                cost.AddMember().SetInteger(log.actual_cost);
             }
         }
     }
@@ -101,13 +233,19 @@ namespace ardb
         RedisReply& reply =  ctx.GetReply();
         if (subcmd == "len")
         {
-            reply.SetInteger(g_slowlog_queue.size());
+            SlowLogQueue queue;
+            slowlog_merge(queue, GetConf().slowlog_max_len);
+            reply.SetInteger(queue.size());
         }
         else if (subcmd == "reset")
         {
             reply.SetStatusCode(STATUS_OK);
-            LockGuard<SpinMutexLock> guard(g_slowlog_queue_mutex);
-            g_slowlog_queue.clear();
+            LockGuard<SpinMutexLock> guard(g_slowlog_rings_lock);
+            for (size_t i = 0; i < g_slowlog_rings.size(); i++)
+            {
+                LockGuard<SpinMutexLock> ring_guard(g_slowlog_rings[i]->lock);
+                g_slowlog_rings[i]->queue.clear();
+            }
         }
         else if (subcmd == "get")
         {
@@ -170,6 +170,7 @@ namespace ardb
             }
             if (vv.GetType() > 0)
             {
+                LoadBitmapChunks(ctx, skey, vv);
                 value = vv.GetStringValue();
             }
             return 0;
@@ -187,10 +188,106 @@ namespace ardb
             {
                 value = hvalue.GetHashValue();
             }
+            else
+            {
+                KeyObject hkey(ctx.ns, KEY_META, keystr);
+                ValueObject meta;
+                if (0 == m_engine->Get(ctx, hkey, meta) && meta.GetType() == KEY_HASH && meta.IsPacked())
+                {
+                    Data* packed_value = meta.GetPackedValue(hfield.GetHashField());
+                    if (NULL != packed_value)
+                    {
+                        value = *packed_value;
+                    }
+                }
+                else if (meta.GetType() == KEY_HASH && meta.GetObjectId() > 0)
+                {
+                    hfield.SetObjectId(meta.GetObjectId());
+                    if (0 == m_engine->Get(ctx, hfield, hvalue))
+                    {
+                        value = hvalue.GetHashValue();
+                    }
+                }
+            }
             return 0;
         }
     }
 
+    /*
+     * GetValueByPattern for many substitutions, the keys are read with engine MultiGet in batches. Values which need
+     * more than a plain read(expired, missing hash field records of packed/object id hashes, wrong type) fall back
+     * to GetValueByPattern.
+     */
+    void Ardb::GetValuesByPattern(Context& ctx, const char* pattern, const DataArray& substs, DataArray& values)
+    {
+        static const size_t kBatchSize = 1024;
+        values.clear();
+        values.resize(substs.size());
+        const char* star = strchr(pattern, '*');
+        if (NULL == star || !strcmp(pattern, "#"))
+        {
+            for (size_t i = 0; i < substs.size(); i++)
+            {
+                GetValueByPattern(ctx, pattern, const_cast<Data&>(substs[i]), values[i]);
+            }
+            return;
+        }
+        size_t plen = strlen(pattern);
+        const char* f = strstr(pattern, "->");
+        if (NULL != f && (size_t) (f - pattern) == (plen - 2))
+        {
+            f = NULL;
+        }
+        int64 now = get_current_epoch_millis();
+        for (size_t begin = 0; begin < substs.size(); begin += kBatchSize)
+        {
+            size_t end = begin + kBatchSize < substs.size() ? begin + kBatchSize : substs.size();
+            KeyObjectArray keys;
+            keys.reserve(end - begin);
+            for (size_t i = begin; i < end; i++)
+            {
+                std::string vstr, keystr(pattern, plen);
+                substs[i].ToString(vstr);
+                string_replace(keystr, "*", vstr);
+                if (NULL == f)
+                {
+                    keys.push_back(KeyObject(ctx.ns, KEY_META, keystr));
+                }
+                else
+                {
+                    size_t pos = keystr.find("->");
+                    KeyObject hfield(ctx.ns, KEY_HASH_FIELD, keystr.substr(0, pos));
+                    hfield.SetHashField(keystr.substr(pos + 2));
+                    keys.push_back(hfield);
+                }
+            }
+            ValueObjectArray vals;
+            ErrCodeArray errs;
+            int err = m_engine->MultiGet(ctx, keys, vals, errs);
+            for (size_t i = begin; i < end; i++)
+            {
+                size_t k = i - begin;
+                if (0 == err && NULL == f && errs[k] == ERR_ENTRY_NOT_EXIST)
+                {
+                    continue;
+                }
+                if (0 == err && 0 == errs[k] && NULL == f && vals[k].GetType() == KEY_STRING && !(vals[k].GetTTL() > 0 && vals[k].GetTTL() < now))
+                {
+                    LoadBitmapChunks(ctx, keys[k], vals[k]);
+                    values[i] = vals[k].GetStringValue();
+                }
+                else if (0 == err && 0 == errs[k] && NULL != f)
+                {
+                    values[i] = vals[k].GetHashValue();
+                }
+                else
+                {
+                    GetValueByPattern(ctx, pattern, const_cast<Data&>(substs[i]), values[i]);
+                }
+            }
+        }
+    }
+
     int Ardb::Sort(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
@@ -262,55 +359,75 @@ namespace ardb
             DELETE(iter);
         }
 
+        if (!options.with_limit)
+        {
+            options.limit_offset = 0;
+            options.limit_count = sortvals.size();
+        }
+        size_t range_begin = options.limit_offset < 0 ? 0 : options.limit_offset;
+        size_t range_end = range_begin;
+        if (range_begin < sortvals.size() && options.limit_count > 0)
+        {
+            range_end = range_begin + options.limit_count < sortvals.size() ? range_begin + options.limit_count : sortvals.size();
+        }
         if (!options.nosort)
         {
-            for (size_t i = 0; i < sortvals.size(); i++)
+            if (NULL != options.by)
             {
-                if (NULL != options.by)
+                DataArray substs, weights;
+                substs.reserve(sortvals.size());
+                for (size_t i = 0; i < sortvals.size(); i++)
                 {
-                    if (GetValueByPattern(ctx, options.by, sortvals[i].value, sortvals[i].weight) < 0)
-                    {
-                        DEBUG_LOG("Failed to get value by pattern:%s", options.by);
-                        sortvals[i].weight.Clear();
-                        continue;
-                    }
+                    substs.push_back(sortvals[i].value);
+                }
+                GetValuesByPattern(ctx, options.by, substs, weights);
+                for (size_t i = 0; i < sortvals.size(); i++)
+                {
+                    sortvals[i].weight = weights[i];
                 }
             }
-            if (!options.is_desc)
+            /*
+             * with LIMIT only the first 'offset + count' elements need to be ordered
+             */
+            bool (*cmp)(const SortValue&, const SortValue&) = options.is_desc ? greater_value<SortValue> : less_value<SortValue>;
+            if (range_end < sortvals.size())
             {
-                std::sort(sortvals.begin(), sortvals.end(), less_value<SortValue>);
+                std::partial_sort(sortvals.begin(), sortvals.begin() + range_end, sortvals.end(), cmp);
             }
             else
             {
-                std::sort(sortvals.begin(), sortvals.end(), greater_value<SortValue>);
+                std::sort(sortvals.begin(), sortvals.end(), cmp);
             }
         }
-        if (!options.with_limit)
-        {
-            options.limit_offset = 0;
-            options.limit_count = sortvals.size();
-        }
 
         DataArray value_list;
-        value_list.reserve(sortvals.size());
-        uint32 count = 0;
-        for (uint32 i = options.limit_offset; i < sortvals.size() && count < (uint32) options.limit_count; i++, count++)
+        if (options.get_patterns.empty())
         {
-            if (options.get_patterns.empty())
+            value_list.reserve(range_end - range_begin);
+            for (size_t i = range_begin; i < range_end; i++)
             {
                 value_list.push_back(sortvals[i].value);
             }
-            else
+        }
+        else
+        {
+            DataArray substs;
+            substs.reserve(range_end - range_begin);
+            for (size_t i = range_begin; i < range_end; i++)
+            {
+                substs.push_back(sortvals[i].value);
+            }
+            std::vector<DataArray> gets(options.get_patterns.size());
+            for (uint32 j = 0; j < options.get_patterns.size(); j++)
             {
-                for (uint32 j = 0; j < options.get_patterns.size(); j++)
+                GetValuesByPattern(ctx, options.get_patterns[j], substs, gets[j]);
+            }
+            value_list.reserve(substs.size() * gets.size());
+            for (size_t i = 0; i < substs.size(); i++)
+            {
+                for (uint32 j = 0; j < gets.size(); j++)
                 {
-                    Data vo;
-                    if (GetValueByPattern(ctx, options.get_patterns[j], sortvals[i].value, vo) < 0)
-                    {
-                        DEBUG_LOG("Failed to get value by pattern for:%s", options.get_patterns[j]);
-                        vo.Clear();
-                    }
-                    value_list.push_back(vo);
+                    value_list.push_back(gets[j][i]);
                 }
             }
         }
@@ -28,6 +28,7 @@
  */
 
 #include "db/db.hpp"
+#include "util/bitops.hpp"
 
 OP_NAMESPACE_BEGIN
     static const unsigned long BITOP_AND = 0;
@@ -35,49 +36,6 @@ OP_NAMESPACE_BEGIN
     static const unsigned long BITOP_XOR = 2;
     static const unsigned long BITOP_NOT = 3;
 
-    //copy from redis
-    static long popcount(const void *s, long count)
-    {
-        long bits = 0;
-        unsigned char *p;
-        const uint32_t* p4 = (const uint32_t*) s;
-        static const unsigned char bitsinbyte[256] =
-        { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3,
-                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3,
-                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3,
-                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 2, 3,
-                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 4, 5,
-                5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8 };
-
-        /* Count bits 16 bytes at a time */
-        while (count >= 16)
-        {
-            uint32_t aux1, aux2, aux3, aux4;
-
-            aux1 = *p4++;
-            aux2 = *p4++;
-            aux3 = *p4++;
-            aux4 = *p4++;
-            count -= 16;
-
-            aux1 = aux1 - ((aux1 >> 1) & 0x55555555);
-            aux1 = (aux1 & 0x33333333) + ((aux1 >> 2) & 0x33333333);
-            aux2 = aux2 - ((aux2 >> 1) & 0x55555555);
-            aux2 = (aux2 & 0x33333333) + ((aux2 >> 2) & 0x33333333);
-            aux3 = aux3 - ((aux3 >> 1) & 0x55555555);
-            aux3 = (aux3 & 0x33333333) + ((aux3 >> 2) & 0x33333333);
-            aux4 = aux4 - ((aux4 >> 1) & 0x55555555);
-            aux4 = (aux4 & 0x33333333) + ((aux4 >> 2) & 0x33333333);
-            bits += ((((aux1 + (aux1 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24) + ((((aux2 + (aux2 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24)
-                    + ((((aux3 + (aux3 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24) + ((((aux4 + (aux4 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
-        }
-        /* Count the remaining bytes */
-        p = (unsigned char*) p4;
-        while (count--)
-            bits += bitsinbyte[*p++];
-        return bits;
-    }
-
     static long popcount_bitval(const std::string& val, int32 offset, int32 limit)
     {
         if (limit < 0)
@@ -87,7 +45,7 @@ OP_NAMESPACE_BEGIN
         if (val.size() > limit)
         {
             std::string tmp = val.substr(offset, limit - offset + 1);
-            return popcount(tmp.data(), tmp.size());
+            return bitops_popcount(tmp.data(), tmp.size());
         }
         else if (val.size() <= limit && val.size() <= offset)
         {
@@ -96,7 +54,7 @@ OP_NAMESPACE_BEGIN
         else if (val.size() > offset)
         {
             std::string tmp = val.substr(offset);
-            return popcount(tmp.data(), tmp.size());
+            return bitops_popcount(tmp.data(), tmp.size());
         }
         return 0;
     }
@@ -110,103 +68,6 @@ OP_NAMESPACE_BEGIN
         return true;
     }
 
-    /* Return the position of the first bit set to one (if 'bit' is 1) or
-     * zero (if 'bit' is 0) in the bitmap starting at 's' and long 'count' bytes.
-     *
-     * The function is guaranteed to return a value >= 0 if 'bit' is 0 since if
-     * no zero bit is found, it returns count*8 assuming the string is zero
-     * padded on the right. However if 'bit' is 1 it is possible that there is
-     * not a single set bit in the bitmap. In this special case -1 is returned. */
-    static long bitpos(void *s, unsigned long count, int bit)
-    {
-        unsigned long *l;
-        unsigned char *c;
-        unsigned long skipval, word = 0, one;
-        long pos = 0; /* Position of bit, to return to the caller. */
-        unsigned long j;
-
-        /* Process whole words first, seeking for first word that is not
-         * all ones or all zeros respectively if we are lookig for zeros
-         * or ones. This is much faster with large strings having contiguous
-         * blocks of 1 or 0 bits compared to the vanilla bit per bit processing.
-         *
-         * Note that if we start from an address that is not aligned
-         * to sizeof(unsigned long) we consume it byte by byte until it is
-         * aligned. */
-
-        /* Skip initial bits not aligned to sizeof(unsigned long) byte by byte. */
-        skipval = bit ? 0 : UCHAR_MAX;
-        c = (unsigned char*) s;
-        while ((unsigned long) c & (sizeof(*l) - 1) && count)
-        {
-            if (*c != skipval)
-                break;
-            c++;
-            count--;
-            pos += 8;
-        }
-
-        /* Skip bits with full word step. */
-        skipval = bit ? 0 : ULONG_MAX;
-        l = (unsigned long*) c;
-        while (count >= sizeof(*l))
-        {
-            if (*l != skipval)
-                break;
-            l++;
-            count -= sizeof(*l);
-            pos += sizeof(*l) * 8;
-        }
-
-        /* Load bytes into "word" considering the first byte as the most significant
-         * (we basically consider it as written in big endian, since we consider the
-         * string as a set of bits from left to right, with the first bit at position
-         * zero.
-         *
-         * Note that the loading is designed to work even when the bytes left
-         * (count) are less than a full word. We pad it with zero on the right. */
-        c = (unsigned char*) l;
-        for (j = 0; j < sizeof(*l); j++)
-        {
-            word <<= 8;
-            if (count)
-            {
-                word |= *c;
-                c++;
-                count--;
-            }
-        }
-
-        /* Special case:
-         * If bits in the string are all zero and we are looking for one,
-         * return -1 to signal that there is not a single "1" in the whole
-         * string. This can't happen when we are looking for "0" as we assume
-         * that the right of the string is zero padded. */
-        if (bit == 1 && word == 0)
-            return -1;
-
-        /* Last word left, scan bit by bit. The first thing we need is to
-         * have a single "1" set in the most significant position in an
-         * unsigned long. We don't know the size of the long so we use a
-         * simple trick. */
-        one = ULONG_MAX; /* All bits set to 1.*/
-        one >>= 1; /* All bits set to 1 but the MSB. */
-        one = ~one; /* All bits set to 0 but the MSB. */
-
-        while (one)
-        {
-            if (((one & word) != 0) == bit)
-                return pos;
-            pos++;
-            one >>= 1;
-        }
-
-        /* If we reached this point, there is a bug in the algorithm, since
-         * the case of no match is handled as a special case before. */
-        abort();
-        return 0; /* Just to avoid warnings. */
-    }
-
     int Ardb::MergeSetBit(Context& ctx, const KeyObject& key, ValueObject& meta, int64 offset, uint8 on, uint8* oldbit)
     {
         if (meta.GetType() > 0 && meta.GetType() != KEY_STRING)
@@ -234,6 +95,232 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
+    static bool is_zero_bytes(const char* p, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            if (p[i] != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void bitop_bytes(unsigned long op, std::vector<std::string>& srcs, std::string& res)
+    {
+        size_t len = srcs[0].size();
+        res = srcs[0];
+        unsigned char* out = (unsigned char*) (&res[0]);
+        if (op == BITOP_NOT)
+        {
+            bitops_not(out, len);
+            return;
+        }
+        for (size_t i = 1; i < srcs.size(); i++)
+        {
+            const unsigned char* in = (const unsigned char*) srcs[i].data();
+            if (op == BITOP_AND)
+                bitops_and(out, in, len);
+            else if (op == BITOP_OR)
+                bitops_or(out, in, len);
+            else if (op == BITOP_XOR)
+                bitops_xor(out, in, len);
+        }
+    }
+
+    int Ardb::SetBitmapChunk(Context& ctx, const KeyObject& key, int64 idx, const std::string& chunk)
+    {
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        chunk_key.SetBitmapChunk(idx);
+        /*
+         * all zero chunks are not stored, a missing chunk reads as zeros
+         */
+        if (is_zero_bytes(chunk.data(), chunk.size()))
+        {
+            return RemoveKey(ctx, chunk_key);
+        }
+        ValueObject chunk_val;
+        chunk_val.SetType(KEY_BITMAP_CHUNK);
+        chunk_val.GetStringValue().SetString(chunk, false);
+        return SetKeyValue(ctx, chunk_key, chunk_val);
+    }
+
+    int Ardb::GetBitmapChunk(Context& ctx, const KeyObject& key, int64 idx, std::string& chunk)
+    {
+        chunk.clear();
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        chunk_key.SetBitmapChunk(idx);
+        ValueObject chunk_val;
+        int err = m_engine->Get(ctx, chunk_key, chunk_val);
+        if (0 == err)
+        {
+            chunk_val.GetStringValue().ToString(chunk);
+        }
+        return err == ERR_ENTRY_NOT_EXIST ? 0 : err;
+    }
+
+    /*
+     * Read 'len' bytes from 'offset' of a plain or chunked string, bytes after the string end are zeros.
+     */
+    void Ardb::GetBitmapRange(Context& ctx, const KeyObject& key, ValueObject& meta, int64 offset, int64 len, std::string& bytes)
+    {
+        bytes.assign(len, 0);
+        if (meta.GetType() != KEY_STRING || len <= 0)
+        {
+            return;
+        }
+        if (!meta.IsChunked())
+        {
+            Data& str = meta.GetStringValue();
+            str.ToMutableStr();
+            int64 strlen = str.StringLength();
+            if (offset < strlen)
+            {
+                memcpy(&bytes[0], str.CStr() + offset, std::min(len, strlen - offset));
+            }
+            return;
+        }
+        int64 chunk_size = meta.GetChunkSize();
+        std::string chunk;
+        for (int64 idx = offset / chunk_size; idx * chunk_size < offset + len; idx++)
+        {
+            GetBitmapChunk(ctx, key, idx, chunk);
+            int64 chunk_start = idx * chunk_size;
+            int64 from = std::max(offset, chunk_start);
+            int64 to = std::min(offset + len, chunk_start + (int64) chunk.size());
+            if (from < to)
+            {
+                memcpy(&bytes[from - offset], chunk.data() + from - chunk_start, to - from);
+            }
+        }
+    }
+
+    void Ardb::ClearBitmapChunks(Context& ctx, const KeyObject& key)
+    {
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(chunk_key);
+        Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+        while (iter->Valid())
+        {
+            RemoveKey(ctx, iter->Key());
+            iter->Next();
+        }
+        DELETE(iter);
+    }
+
+    /*
+     * Assemble a chunked string into a plain one in memory for commands which need the whole value,
+     * return 1 if the value was chunked.
+     */
+    int Ardb::LoadBitmapChunks(Context& ctx, const KeyObject& key, ValueObject& meta)
+    {
+        if (meta.GetType() != KEY_STRING || !meta.IsChunked())
+        {
+            return 0;
+        }
+        std::string bytes;
+        GetBitmapRange(ctx, key, meta, 0, meta.GetChunkedLength(), bytes);
+        meta.SetChunked(false);
+        meta.GetStringValue().SetString(bytes, false);
+        return 1;
+    }
+
+    /*
+     * Write back a string which was chunked as a plain one, the chunks are removed in the same batch.
+     */
+    int Ardb::SetUnchunkedValue(Context& ctx, const KeyObject& key, ValueObject& meta)
+    {
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            ClearBitmapChunks(ctx, key);
+            meta.SetChunked(false);
+            int err = SetKeyValue(ctx, key, meta);
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+                return err;
+            }
+        }
+        return ctx.transc_err;
+    }
+
+    /*
+     * Set a bit of a chunked string, a new bitmap or a plain string 'plain' growing over one chunk is
+     * converted at first. Only the chunk holding the bit and the meta (when the length changes) are written.
+     */
+    int Ardb::ChunkedSetBit(Context& ctx, const KeyObject& key, ValueObject& meta, const std::string& plain, int64 offset, uint8 on,
+            uint8* oldbit)
+    {
+        int err = 0;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            bool converted = !meta.IsChunked();
+            if (converted)
+            {
+                /*
+                 * chunks left by a previous chunked value of the key are cleared first
+                 */
+                ClearBitmapChunks(ctx, key);
+                meta.SetType(KEY_STRING);
+                meta.SetChunked(true);
+                meta.SetChunkSize(GetConf().bitmap_chunk_size);
+                meta.SetChunkedLength(plain.size());
+            }
+            int64 chunk_size = meta.GetChunkSize();
+            int64 byte = offset >> 3;
+            int64 idx = byte / chunk_size;
+            std::string chunk;
+            if (converted)
+            {
+                for (size_t i = 0; i < plain.size(); i += chunk_size)
+                {
+                    if ((int64) i / chunk_size == idx)
+                    {
+                        chunk = plain.substr(i, chunk_size);
+                    }
+                    else
+                    {
+                        SetBitmapChunk(ctx, key, i / chunk_size, plain.substr(i, chunk_size));
+                    }
+                }
+            }
+            else
+            {
+                err = GetBitmapChunk(ctx, key, idx, chunk);
+            }
+            if (0 == err)
+            {
+                size_t pos = byte % chunk_size;
+                if (chunk.size() <= pos)
+                {
+                    chunk.resize(pos + 1);
+                }
+                int bit = 7 - (offset & 0x7);
+                int byteval = (unsigned char) chunk[pos];
+                if (NULL != oldbit)
+                {
+                    *oldbit = (byteval & (1 << bit)) ? 1 : 0;
+                }
+                byteval &= ~(1 << bit);
+                byteval |= ((on & 0x1) << bit);
+                chunk[pos] = byteval;
+                err = SetBitmapChunk(ctx, key, idx, chunk);
+            }
+            if (0 == err && (converted || byte >= meta.GetChunkedLength()))
+            {
+                meta.SetChunkedLength(std::max(meta.GetChunkedLength(), byte + 1));
+                err = SetKeyValue(ctx, key, meta);
+            }
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        return 0 != err ? err : ctx.transc_err;
+    }
+
     int Ardb::SetBit(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
@@ -252,10 +339,11 @@ OP_NAMESPACE_BEGIN
         KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
         uint8 bit = cmd.GetArguments()[2] != "0" ? 1 : 0;
         int err = 0;
+        int64 chunk_size = GetConf().bitmap_chunk_size;
         /*
-         * merge setbit
+         * merge setbit, chunked bitmaps need to read the meta first
          */
-        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        if (chunk_size <= 0 && !ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
         {
             DataArray args(2);
             args[0].SetInt64(offset);
@@ -271,16 +359,34 @@ OP_NAMESPACE_BEGIN
             }
             return 0;
         }
+        KeyLockGuard guard(ctx, key);
         ValueObject v;
         if (!CheckMeta(ctx, key, KEY_STRING, v))
         {
             return 0;
         }
         uint8 oldbit = 0;
-        err = MergeSetBit(ctx, key, v, offset, bit, &oldbit);
-        if (0 == err)
+        bool chunked = v.IsChunked();
+        std::string plain;
+        if (!chunked && chunk_size > 0)
         {
-            err = SetKeyValue(ctx, key, v);
+            if (v.GetType() > 0)
+            {
+                v.GetStringValue().ToString(plain);
+            }
+            chunked = std::max((int64) plain.size(), (offset >> 3) + 1) > chunk_size;
+        }
+        if (!chunked)
+        {
+            err = MergeSetBit(ctx, key, v, offset, bit, &oldbit);
+            if (0 == err)
+            {
+                err = SetKeyValue(ctx, key, v);
+            }
+        }
+        else
+        {
+            err = ChunkedSetBit(ctx, key, v, plain, offset, bit, &oldbit);
         }
         if (err < 0)
         {
@@ -306,8 +412,9 @@ OP_NAMESPACE_BEGIN
         size_t byte = bitoffset >> 3;
         size_t bit = 7 - (bitoffset & 0x7);
         reply.SetInteger(0); //default response
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
         ValueObject v;
-        if (!CheckMeta(ctx, cmd.GetArguments()[0], KEY_STRING, v))
+        if (!CheckMeta(ctx, key, KEY_STRING, v))
         {
             return 0;
         }
@@ -315,10 +422,25 @@ OP_NAMESPACE_BEGIN
         {
             return 0;
         }
+        if (v.IsChunked())
+        {
+            int64 chunk_size = v.GetChunkSize();
+            std::string chunk;
+            if ((int64) byte >= v.GetChunkedLength() || 0 != GetBitmapChunk(ctx, key, byte / chunk_size, chunk))
+            {
+                return 0;
+            }
+            size_t pos = byte % chunk_size;
+            if (chunk.size() > pos)
+            {
+                reply.SetInteger((chunk[pos] & (1 << bit)) ? 1 : 0);
+            }
+            return 0;
+        }
         Data& str = v.GetStringValue();
         if (str.IsString())
         {
-            if (str.StringLength() < byte)
+            if (str.StringLength() <= byte)
             {
                 return 0;
             }
@@ -329,7 +451,7 @@ OP_NAMESPACE_BEGIN
         {
             std::string ss;
             str.ToString(ss);
-            if (ss.size() < byte)
+            if (ss.size() <= byte)
             {
                 return 0;
             }
@@ -346,8 +468,9 @@ OP_NAMESPACE_BEGIN
         std::string strbuf;
         RedisReply& reply = ctx.GetReply();
         reply.SetInteger(0); //default response
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
         ValueObject v;
-        if (!CheckMeta(ctx, cmd.GetArguments()[0], KEY_STRING, v) || v.GetType() == 0)
+        if (!CheckMeta(ctx, key, KEY_STRING, v) || v.GetType() == 0)
         {
             return 0;
         }
@@ -356,7 +479,11 @@ OP_NAMESPACE_BEGIN
 
         /* Set the 'p' pointer to the string, that can be just a stack allocated
          * array if our string was integer encoded. */
-        if (!str.IsString())
+        if (v.IsChunked())
+        {
+            strlen = v.GetChunkedLength();
+        }
+        else if (!str.IsString())
         {
             str.ToString(strbuf);
             p = (const unsigned char*) (&strbuf[0]);
@@ -402,10 +529,42 @@ OP_NAMESPACE_BEGIN
 
         /* Precondition: end >= 0 && end < strlen, so the only condition where
          * zero can be returned is: start > end. */
-        if (start < end)
+        if (start <= end && v.IsChunked())
+        {
+            /*
+             * count the stored chunks overlapping the range, missing chunks have no bits set
+             */
+            int64 chunk_size = v.GetChunkSize();
+            long bits = 0;
+            KeyObject chunk_key(ctx.ns, KEY_BITMAP_CHUNK, cmd.GetArguments()[0]);
+            chunk_key.SetBitmapChunk(start / chunk_size);
+            IterateOptions iter_opts;
+            iter_opts.BoundToObject(chunk_key);
+            CheckStreamIterate((end - start) / chunk_size + 1, iter_opts);
+            Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+            while (iter->Valid())
+            {
+                int64 chunk_start = iter->Key().GetBitmapChunk() * chunk_size;
+                if (chunk_start > end)
+                {
+                    break;
+                }
+                Data& chunk = iter->Value().GetStringValue();
+                int64 from = std::max(start, chunk_start);
+                int64 to = std::min(end + 1, chunk_start + (int64) chunk.StringLength());
+                if (from < to)
+                {
+                    bits += bitops_popcount(chunk.CStr() + from - chunk_start, to - from);
+                }
+                iter->Next();
+            }
+            DELETE(iter);
+            reply.SetInteger(bits);
+        }
+        else if (start <= end)
         {
             long bytes = end - start + 1;
-            reply.SetInteger(popcount(p + start, bytes));
+            reply.SetInteger(bitops_popcount(p + start, bytes));
         }
         return 0;
     }
@@ -427,8 +586,9 @@ OP_NAMESPACE_BEGIN
             return 0;
         }
 
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
         ValueObject v;
-        if (!CheckMeta(ctx, cmd.GetArguments()[0], KEY_STRING, v) || v.GetType() == 0)
+        if (!CheckMeta(ctx, key, KEY_STRING, v))
         {
             return 0;
         }
@@ -441,7 +601,11 @@ OP_NAMESPACE_BEGIN
         Data& str = v.GetStringValue();
         /* Set the 'p' pointer to the string, that can be just a stack allocated
          * array if our string was integer encoded. */
-        if (!str.IsString())
+        if (v.IsChunked())
+        {
+            strlen = v.GetChunkedLength();
+        }
+        else if (!str.IsString())
         {
             str.ToString(strbuf);
             p = (const unsigned char *) &strbuf[0];
@@ -499,10 +663,64 @@ OP_NAMESPACE_BEGIN
         {
             reply.SetInteger(-1);
         }
+        else if (v.IsChunked())
+        {
+            /*
+             * scan the stored chunks from 'start', a gap before the next stored chunk is all zeros
+             */
+            int64 chunk_size = v.GetChunkSize();
+            int64 next = start; /* first byte not scanned yet */
+            long pos = -1;
+            KeyObject chunk_key(ctx.ns, KEY_BITMAP_CHUNK, cmd.GetArguments()[0]);
+            chunk_key.SetBitmapChunk(start / chunk_size);
+            IterateOptions iter_opts;
+            iter_opts.BoundToObject(chunk_key);
+            CheckStreamIterate((end - start) / chunk_size + 1, iter_opts);
+            Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+            while (iter->Valid())
+            {
+                int64 chunk_start = iter->Key().GetBitmapChunk() * chunk_size;
+                if (chunk_start > end)
+                {
+                    break;
+                }
+                Data& chunk = iter->Value().GetStringValue();
+                int64 from = std::max(start, chunk_start);
+                int64 to = std::min(end + 1, chunk_start + (int64) chunk.StringLength());
+                if (from < to)
+                {
+                    if (bit == 0 && from > next)
+                    {
+                        break;
+                    }
+                    long found = bitops_bitpos(chunk.CStr() + from - chunk_start, to - from, bit);
+                    if (bit ? found != -1 : found < (to - from) * 8)
+                    {
+                        pos = from * 8 + found;
+                        break;
+                    }
+                    next = to;
+                }
+                iter->Next();
+            }
+            DELETE(iter);
+            if (pos == -1 && bit == 0)
+            {
+                if (next <= end)
+                {
+                    pos = next * 8;
+                }
+                else if (!end_given)
+                {
+                    pos = (end + 1) * 8;
+                }
+            }
+            reply.SetInteger(pos);
+        }
         else
         {
             long bytes = end - start + 1;
-            long pos = bitpos((void*) (p + start), bytes, bit);
+            long pos = bitops_bitpos(p + start, bytes, bit);
 
             /* If we are looking for clear bits, and the user specified an exact
              * range with start-end, we can't consider the right of the range as
@@ -533,18 +751,13 @@ OP_NAMESPACE_BEGIN
 
         RedisReply& reply = ctx.GetReply();
         const std::string& opname = cmd.GetArguments()[0];
-        std::string targetkey;
         int destkey_count = 0;
         if (cmd.GetType() == REDIS_CMD_BITOP)
         {
-            targetkey = cmd.GetArguments()[1];
             destkey_count = 1;
         }
         unsigned long op;
-        unsigned long maxlen = 0; /* Array of length of src strings,
-         and max len. */
-        unsigned long minlen = 0; /* Min len among the input keys. */
-        std::string res; /* Resulting string. */
+        int64 maxlen = 0; /* Max len of src strings. */
 
         /* Parse the operation name. */
         if ((opname[0] == 'a' || opname[0] == 'A') && !strcasecmp(opname.c_str(), "and"))
@@ -578,6 +791,7 @@ OP_NAMESPACE_BEGIN
             KeyObject k(ctx.ns, KEY_META, cmd.GetArguments()[i]);
             keys.push_back(k);
         }
+        KeyLockGuard guard(ctx, keys[0], destkey_count > 0);
         m_engine->MultiGet(ctx, keys, vals, errs);
         if (cmd.GetType() == REDIS_CMD_BITOP)
         {
@@ -587,7 +801,6 @@ OP_NAMESPACE_BEGIN
                 return 0;
             }
         }
-        //printf("####%s %s\n", vals[0].GetStringValue().AsString().c_str(),vals[1].GetStringValue().AsString().c_str());
 
         size_t numkeys = keys.size() - destkey_count;
         for (size_t j = destkey_count; j < keys.size(); j++)
@@ -595,7 +808,6 @@ OP_NAMESPACE_BEGIN
             /* Handle non-existing keys as empty strings. */
             if (vals[j].GetType() == 0)
             {
-                minlen = 0;
                 continue;
             }
             /* Return an error if one of the keys is not a string. */
@@ -604,151 +816,94 @@ OP_NAMESPACE_BEGIN
                 reply.SetErrCode(ERR_WRONG_TYPE);
                 return 0;
             }
-            vals[j].GetStringValue().ToMutableStr();
-            size_t slen = vals[j].GetStringValue().StringLength();
+            int64 slen = 0;
+            if (vals[j].IsChunked())
+            {
+                slen = vals[j].GetChunkedLength();
+            }
+            else
+            {
+                vals[j].GetStringValue().ToMutableStr();
+                slen = vals[j].GetStringValue().StringLength();
+            }
             if (slen > maxlen)
                 maxlen = slen;
-            if (j == 0 || slen < minlen)
-                minlen = slen;
         }
 
-        /* Compute the bit operation, if at least one string is not empty. */
-        if (maxlen)
+        /*
+         * Compute the bit operation window by window, a window is one chunk when bitmaps are chunked,
+         * so chunked sources are never loaded as a whole.
+         */
+        int64 chunk_size = GetConf().bitmap_chunk_size;
+        int64 window = chunk_size > 0 ? chunk_size : maxlen;
+        bool chunked_dest = cmd.GetType() == REDIS_CMD_BITOP && chunk_size > 0 && maxlen > chunk_size;
+        std::string res; /* Resulting string. */
+        std::vector<std::string> srcs(numkeys);
+        std::string output;
+        long bits = 0;
+        int err = 0;
+        WriteBatchGuard* batch = NULL;
+        if (cmd.GetType() == REDIS_CMD_BITOP)
         {
-            res.resize(maxlen);
-            unsigned char output, byte;
-            unsigned long i;
-
-            /* Fast path: as far as we have data for all the input bitmaps we
-             * can take a fast path that performs much better than the
-             * vanilla algorithm. */
-            int j = 0;
-            if (minlen >= sizeof(unsigned long) * 4 && numkeys <= 16)
+            NEW(batch, WriteBatchGuard(ctx, m_engine));
+            if (vals[0].IsChunked())
             {
-                unsigned long *lp[16];
-                unsigned long *lres = (unsigned long*) (&res[0]);
-
-                /* Note: sds pointer is always aligned to 8 byte boundary. */
-                for (size_t k = 0; k < numkeys; i++)
-                {
-                    lp[k] = (unsigned long*) (vals[k + destkey_count].GetStringValue().CStr());
-                }
-                memcpy(&res[0], vals[destkey_count].GetStringValue().CStr(), minlen);
-
-                /* Different branches per different operations for speed (sorry). */
-                if (op == BITOP_AND)
-                {
-                    while (minlen >= sizeof(unsigned long) * 4)
-                    {
-                        for (i = 1; i < numkeys; i++)
-                        {
-                            lres[0] &= lp[i][0];
-                            lres[1] &= lp[i][1];
-                            lres[2] &= lp[i][2];
-                            lres[3] &= lp[i][3];
-                            lp[i] += 4;
-                        }
-                        lres += 4;
-                        j += sizeof(unsigned long) * 4;
-                        minlen -= sizeof(unsigned long) * 4;
-                    }
-                }
-                else if (op == BITOP_OR)
-                {
-                    while (minlen >= sizeof(unsigned long) * 4)
-                    {
-                        for (i = 1; i < numkeys; i++)
-                        {
-                            lres[0] |= lp[i][0];
-                            lres[1] |= lp[i][1];
-                            lres[2] |= lp[i][2];
-                            lres[3] |= lp[i][3];
-                            lp[i] += 4;
-                        }
-                        lres += 4;
-                        j += sizeof(unsigned long) * 4;
-                        minlen -= sizeof(unsigned long) * 4;
-                    }
-                }
-                else if (op == BITOP_XOR)
-                {
-                    while (minlen >= sizeof(unsigned long) * 4)
-                    {
-                        for (i = 1; i < numkeys; i++)
-                        {
-                            lres[0] ^= lp[i][0];
-                            lres[1] ^= lp[i][1];
-                            lres[2] ^= lp[i][2];
-                            lres[3] ^= lp[i][3];
-                            lp[i] += 4;
-                        }
-                        lres += 4;
-                        j += sizeof(unsigned long) * 4;
-                        minlen -= sizeof(unsigned long) * 4;
-                    }
-                }
-                else if (op == BITOP_NOT)
-                {
-                    while (minlen >= sizeof(unsigned long) * 4)
-                    {
-                        lres[0] = ~lres[0];
-                        lres[1] = ~lres[1];
-                        lres[2] = ~lres[2];
-                        lres[3] = ~lres[3];
-                        lres += 4;
-                        j += sizeof(unsigned long) * 4;
-                        minlen -= sizeof(unsigned long) * 4;
-                    }
-                }
+                ClearBitmapChunks(ctx, keys[0]);
             }
-
-            /* j is set to the next byte to process by the previous loop. */
-            for (; j < maxlen; j++)
+        }
+        for (int64 offset = 0; offset < maxlen; offset += window)
+        {
+            int64 len = std::min(window, maxlen - offset);
+            for (size_t k = 0; k < numkeys; k++)
             {
-                Data& first = vals[destkey_count].GetStringValue();
-                output = (first.StringLength() <= j) ? 0 : first.CStr()[j];
-                if (op == BITOP_NOT)
-                    output = ~output;
-                for (i = 1; i < numkeys; i++)
-                {
-                    byte = (vals[i + destkey_count].GetStringValue().StringLength() <= j) ? 0 : vals[destkey_count + 1].GetStringValue().CStr()[j];
-                    switch (op)
-                    {
-                        case BITOP_AND:
-                            output &= byte;
-                            break;
-                        case BITOP_OR:
-                            output |= byte;
-                            break;
-                        case BITOP_XOR:
-                            output ^= byte;
-                            break;
-                    }
-                }
-                res[j] = output;
+                GetBitmapRange(ctx, keys[k + destkey_count], vals[k + destkey_count], offset, len, srcs[k]);
+            }
+            bitop_bytes(op, srcs, output);
+            if (NULL == batch)
+            {
+                bits += bitops_popcount(output.data(), output.size());
+            }
+            else if (chunked_dest)
+            {
+                SetBitmapChunk(ctx, keys[0], offset / window, output);
+            }
+            else
+            {
+                res.append(output);
             }
         }
 
         /* Store the computed value into the target key */
-        int err = 0;
-        if (maxlen)
+        if (NULL != batch)
         {
-            if (cmd.GetType() == REDIS_CMD_BITOP)
+            if (maxlen)
             {
                 vals[0].SetType(KEY_STRING);
-                vals[0].GetStringValue().SetString(res, false);
+                if (chunked_dest)
+                {
+                    vals[0].SetChunked(true);
+                    vals[0].SetChunkSize(chunk_size);
+                    vals[0].SetChunkedLength(maxlen);
+                }
+                else
+                {
+                    vals[0].SetChunked(false);
+                    vals[0].GetStringValue().SetString(res, false);
+                }
                 err = SetKeyValue(ctx, keys[0], vals[0]);
             }
-            else
+            else if (vals[0].GetType() > 0)
+            {
+                err = RemoveKey(ctx, keys[0]);
+            }
+            if (0 != err)
             {
-                maxlen = popcount(res.c_str(), res.size());
+                batch->MarkFailed(err);
             }
-        }
-        else
-        {
-            if (vals[0].GetType() > 0)
+            DELETE(batch);
+            if (0 == err)
             {
-                err = RemoveKey(ctx, keys[0]);
+                err = ctx.transc_err;
             }
         }
         if (0 != err)
@@ -757,7 +912,7 @@ OP_NAMESPACE_BEGIN
         }
         else
         {
-            reply.SetInteger(maxlen);
+            reply.SetInteger(cmd.GetType() == REDIS_CMD_BITOP ? maxlen : bits);
         }
         return 0;
     }
@@ -0,0 +1,641 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "db/db.hpp"
+#include "util/murmur3.h"
+#include <math.h>
+
+/*
+ * Scalable bloom filters are chunked strings like large bitmaps: the bits of all layers are stored in
+ * KEY_BITMAP_CHUNK keys, the meta holds the layers in a header. A layer takes the bits after the previous one,
+ * a new layer is appended once the last one reached its capacity, with 'expansion' times the capacity and half
+ * the error rate. Items are hashed once with murmur3, the bits of every layer are derived by double hashing.
+ */
+OP_NAMESPACE_BEGIN
+    static const char* kBloomMagic = "BF01";
+    static const double kBloomDefaultErrorRate = 0.01;
+    static const int64 kBloomDefaultCapacity = 100;
+    static const int64 kBloomDefaultExpansion = 2;
+    static const int64 kBloomDefaultChunkSize = 4096;
+    static const size_t kBloomMaxLayers = 32;
+    static const size_t kBloomMaxMergeBits = 255; //one byte argument count of a merge value
+
+    struct BloomLayer
+    {
+            int64 offset; //first bit of the layer
+            int64 bits;
+            int64 hashes;
+            int64 capacity;
+            int64 count;
+            BloomLayer() :
+                    offset(0), bits(0), hashes(0), capacity(0), count(0)
+            {
+            }
+    };
+
+    struct BloomFilter
+    {
+            double error_rate;
+            int64 expansion; //0 for a non scaling filter
+            std::vector<BloomLayer> layers;
+            BloomFilter() :
+                    error_rate(kBloomDefaultErrorRate), expansion(kBloomDefaultExpansion)
+            {
+            }
+            int64 Bytes() const
+            {
+                if (layers.empty())
+                {
+                    return 0;
+                }
+                return (layers.back().offset + layers.back().bits + 7) / 8;
+            }
+            int64 Count() const
+            {
+                int64 count = 0;
+                for (size_t i = 0; i < layers.size(); i++)
+                {
+                    count += layers[i].count;
+                }
+                return count;
+            }
+            /*
+             * A new layer starts at a chunk boundary, so its chunks are never shared with the previous layers.
+             */
+            bool AddLayer(int64 capacity, int64 chunk_size)
+            {
+                if (layers.size() >= kBloomMaxLayers)
+                {
+                    return false;
+                }
+                BloomLayer layer;
+                if (!layers.empty())
+                {
+                    if (layers.back().capacity > INT64_MAX / expansion / 64)
+                    {
+                        return false;
+                    }
+                    layer.offset = (Bytes() + chunk_size - 1) / chunk_size * chunk_size * 8;
+                    capacity = layers.back().capacity * expansion;
+                }
+                double err = error_rate * pow(0.5, (double) layers.size());
+                layer.capacity = capacity;
+                layer.bits = (int64) ceil(-(double) capacity * log(err) / (M_LN2 * M_LN2));
+                layer.hashes = (int64) ceil(-log(err) / M_LN2);
+                if (layer.bits < 8)
+                {
+                    layer.bits = 8;
+                }
+                layers.push_back(layer);
+                return true;
+            }
+            void Encode(std::string& header) const
+            {
+                Buffer buffer;
+                buffer.Write(kBloomMagic, strlen(kBloomMagic));
+                BufferHelper::WriteFixDouble(buffer, error_rate);
+                BufferHelper::WriteVarInt64(buffer, expansion);
+                BufferHelper::WriteVarUInt32(buffer, layers.size());
+                for (size_t i = 0; i < layers.size(); i++)
+                {
+                    BufferHelper::WriteVarInt64(buffer, layers[i].offset);
+                    BufferHelper::WriteVarInt64(buffer, layers[i].bits);
+                    BufferHelper::WriteVarInt64(buffer, layers[i].hashes);
+                    BufferHelper::WriteVarInt64(buffer, layers[i].capacity);
+                    BufferHelper::WriteVarInt64(buffer, layers[i].count);
+                }
+                header.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+            }
+            bool Decode(const std::string& header)
+            {
+                size_t magic_len = strlen(kBloomMagic);
+                if (header.size() < magic_len || header.compare(0, magic_len, kBloomMagic) != 0)
+                {
+                    return false;
+                }
+                Buffer buffer(const_cast<char*>(header.data()), magic_len, header.size());
+                uint32 n = 0;
+                if (!BufferHelper::ReadFixDouble(buffer, error_rate) || !BufferHelper::ReadVarInt64(buffer, expansion)
+                        || !BufferHelper::ReadVarUInt32(buffer, n) || n == 0 || n > kBloomMaxLayers)
+                {
+                    return false;
+                }
+                layers.resize(n);
+                for (size_t i = 0; i < layers.size(); i++)
+                {
+                    if (!BufferHelper::ReadVarInt64(buffer, layers[i].offset) || !BufferHelper::ReadVarInt64(buffer, layers[i].bits)
+                            || !BufferHelper::ReadVarInt64(buffer, layers[i].hashes) || !BufferHelper::ReadVarInt64(buffer, layers[i].capacity)
+                            || !BufferHelper::ReadVarInt64(buffer, layers[i].count) || layers[i].bits <= 0)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+    };
+
+    static bool decode_bloom_filter(ValueObject& meta, BloomFilter& bf)
+    {
+        if (meta.GetType() != KEY_STRING || !meta.IsChunked())
+        {
+            return false;
+        }
+        std::string header;
+        meta.GetChunkedHeader().ToString(header);
+        return bf.Decode(header);
+    }
+
+    static void bloom_hash(const std::string& item, uint64 hash[2])
+    {
+        MurmurHash3_x64_128(item.data(), item.size(), 0, hash);
+    }
+
+    static int64 bloom_bit(const BloomLayer& layer, const uint64 hash[2], int64 i)
+    {
+        return layer.offset + (int64) ((hash[0] + (uint64) i * hash[1]) % (uint64) layer.bits);
+    }
+
+    static void bloom_layer_chunks(const BloomLayer& layer, const uint64 hash[2], int64 chunk_size, std::map<int64, std::string>& chunks)
+    {
+        for (int64 i = 0; i < layer.hashes; i++)
+        {
+            chunks[(bloom_bit(layer, hash, i) >> 3) / chunk_size];
+        }
+    }
+
+    static bool bloom_layer_contains(const BloomLayer& layer, const uint64 hash[2], int64 chunk_size, std::map<int64, std::string>& chunks)
+    {
+        for (int64 i = 0; i < layer.hashes; i++)
+        {
+            int64 bit = bloom_bit(layer, hash, i);
+            const std::string& chunk = chunks[(bit >> 3) / chunk_size];
+            size_t pos = (bit >> 3) % chunk_size;
+            if (chunk.size() <= pos || !(chunk[pos] & (1 << (7 - (bit & 0x7)))))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Fetch the chunks listed in 'chunks' with one MultiGet, missing chunks read as empty(all zero) strings.
+     */
+    int Ardb::GetBloomChunks(Context& ctx, const KeyObject& key, int64 chunk_size, std::map<int64, std::string>& chunks)
+    {
+        if (chunks.empty())
+        {
+            return 0;
+        }
+        KeyObjectArray chunk_keys;
+        std::map<int64, std::string>::iterator it = chunks.begin();
+        while (it != chunks.end())
+        {
+            KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+            chunk_key.SetBitmapChunk(it->first);
+            chunk_keys.push_back(chunk_key);
+            it++;
+        }
+        ValueObjectArray vals;
+        ErrCodeArray errs;
+        int err = m_engine->MultiGet(ctx, chunk_keys, vals, errs);
+        if (0 != err)
+        {
+            return err;
+        }
+        size_t i = 0;
+        for (it = chunks.begin(); it != chunks.end(); it++, i++)
+        {
+            if (0 == errs[i])
+            {
+                vals[i].GetStringValue().ToString(it->second);
+            }
+            else if (ERR_ENTRY_NOT_EXIST != errs[i])
+            {
+                return errs[i];
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * Sets the bit offsets 'bits' of a chunk.
+     */
+    int Ardb::MergeBloomBits(Context& ctx, const KeyObject& key, ValueObject& chunk, const DataArray& bits)
+    {
+        if (chunk.GetType() > 0 && chunk.GetType() != KEY_BITMAP_CHUNK)
+        {
+            return ERR_WRONG_TYPE;
+        }
+        std::string bytes;
+        if (chunk.GetType() > 0)
+        {
+            chunk.GetStringValue().ToString(bytes);
+        }
+        chunk.SetType(KEY_BITMAP_CHUNK);
+        for (size_t i = 0; i < bits.size(); i++)
+        {
+            int64 bit = bits[i].GetInt64();
+            size_t pos = bit >> 3;
+            if (bytes.size() <= pos)
+            {
+                bytes.resize(pos + 1);
+            }
+            bytes[pos] |= (1 << (7 - (bit & 0x7)));
+        }
+        chunk.GetStringValue().SetString(bytes, true);
+        return 0;
+    }
+
+    int Ardb::BFReserve(Context& ctx, RedisCommandFrame& cmd)
+    {
+        ctx.flags.create_if_notexist = 1;
+        RedisReply& reply = ctx.GetReply();
+        BloomFilter bf;
+        int64 capacity = 0;
+        if (!string_todouble(cmd.GetArguments()[1], bf.error_rate) || bf.error_rate <= 0 || bf.error_rate >= 1)
+        {
+            reply.SetErrorReason("ERR (0 < error rate range < 1)");
+            return 0;
+        }
+        if (!string_toint64(cmd.GetArguments()[2], capacity) || capacity <= 0)
+        {
+            reply.SetErrorReason("ERR (capacity should be larger than 0)");
+            return 0;
+        }
+        for (size_t i = 3; i < cmd.GetArguments().size(); i++)
+        {
+            if (!strcasecmp(cmd.GetArguments()[i].c_str(), "nonscaling"))
+            {
+                bf.expansion = 0;
+            }
+            else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "expansion") && i + 1 < cmd.GetArguments().size())
+            {
+                if (!string_toint64(cmd.GetArguments()[i + 1], bf.expansion) || bf.expansion < 1)
+                {
+                    reply.SetErrorReason("ERR expansion should be greater or equal to 1");
+                    return 0;
+                }
+                i++;
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_UNKNOWN, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() > 0)
+        {
+            reply.SetErrorReason("ERR item exists");
+            return 0;
+        }
+        int64 chunk_size = GetConf().bitmap_chunk_size > 0 ? GetConf().bitmap_chunk_size : kBloomDefaultChunkSize;
+        if (!bf.AddLayer(capacity, chunk_size))
+        {
+            reply.SetErrorReason("ERR capacity is too large");
+            return 0;
+        }
+        std::string header;
+        bf.Encode(header);
+        int err = 0;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            ClearBitmapChunks(ctx, key);
+            meta.SetType(KEY_STRING);
+            meta.SetChunked(true);
+            meta.SetChunkSize(chunk_size);
+            meta.SetChunkedLength(bf.Bytes());
+            meta.GetChunkedHeader().SetString(header, true);
+            err = SetKeyValue(ctx, key, meta);
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        if (0 == err)
+        {
+            err = ctx.transc_err;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetStatusCode(STATUS_OK);
+        }
+        return 0;
+    }
+
+    /*
+     * The chunks of all items are read with one MultiGet, an item is added to the last layer if no layer
+     * contains it. Changed chunks are written as merges of the bits set, without rewriting the whole chunk,
+     * if the engine supports merge.
+     */
+    int Ardb::BloomAdd(Context& ctx, RedisCommandFrame& cmd, bool multi)
+    {
+        ctx.flags.create_if_notexist = 1;
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        BloomFilter bf;
+        bool created = meta.GetType() == 0;
+        if (created)
+        {
+            int64 chunk_size = GetConf().bitmap_chunk_size > 0 ? GetConf().bitmap_chunk_size : kBloomDefaultChunkSize;
+            bf.AddLayer(kBloomDefaultCapacity, chunk_size);
+            meta.SetType(KEY_STRING);
+            meta.SetChunked(true);
+            meta.SetChunkSize(chunk_size);
+        }
+        else if (!decode_bloom_filter(meta, bf))
+        {
+            reply.SetErrCode(ERR_INVALID_BLOOM_FILTER);
+            return 0;
+        }
+        int64 chunk_size = meta.GetChunkSize();
+        size_t nitems = cmd.GetArguments().size() - 1;
+        std::vector<uint64> hashes(nitems * 2);
+        std::map<int64, std::string> chunks;
+        for (size_t i = 0; i < nitems; i++)
+        {
+            bloom_hash(cmd.GetArguments()[i + 1], &hashes[i * 2]);
+            for (size_t j = 0; j < bf.layers.size(); j++)
+            {
+                bloom_layer_chunks(bf.layers[j], &hashes[i * 2], chunk_size, chunks);
+            }
+        }
+        int err = created ? 0 : GetBloomChunks(ctx, key, chunk_size, chunks);
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+            return 0;
+        }
+        std::map<int64, DataArray> dirty; //chunk -> bits set in the chunk
+        std::vector<int64> added(nitems, 0);
+        for (size_t i = 0; i < nitems; i++)
+        {
+            const uint64* hash = &hashes[i * 2];
+            bool found = false;
+            for (size_t j = 0; j < bf.layers.size() && !found; j++)
+            {
+                found = bloom_layer_contains(bf.layers[j], hash, chunk_size, chunks);
+            }
+            if (found)
+            {
+                continue;
+            }
+            if (bf.layers.back().count >= bf.layers.back().capacity)
+            {
+                if (bf.expansion == 0 || !bf.AddLayer(0, chunk_size))
+                {
+                    if (!multi)
+                    {
+                        reply.SetErrorReason("ERR non scaling filter is full");
+                        return 0;
+                    }
+                    added[i] = -1;
+                    continue;
+                }
+            }
+            BloomLayer& layer = bf.layers.back();
+            for (int64 k = 0; k < layer.hashes; k++)
+            {
+                int64 bit = bloom_bit(layer, hash, k);
+                int64 byte = bit >> 3;
+                std::string& chunk = chunks[byte / chunk_size];
+                size_t pos = byte % chunk_size;
+                if (chunk.size() <= pos)
+                {
+                    chunk.resize(pos + 1);
+                }
+                chunk[pos] |= (1 << (7 - (bit & 0x7)));
+                Data offset;
+                offset.SetInt64(pos * 8 + (bit & 0x7));
+                dirty[byte / chunk_size].push_back(offset);
+            }
+            layer.count++;
+            added[i] = 1;
+        }
+        if (!dirty.empty())
+        {
+            std::string header;
+            bf.Encode(header);
+            bool merge = !ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge;
+            {
+                WriteBatchGuard batch(ctx, m_engine);
+                if (created)
+                {
+                    ClearBitmapChunks(ctx, key);
+                }
+                std::map<int64, DataArray>::iterator it = dirty.begin();
+                while (0 == err && it != dirty.end())
+                {
+                    if (merge && it->second.size() <= kBloomMaxMergeBits)
+                    {
+                        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+                        chunk_key.SetBitmapChunk(it->first);
+                        err = MergeKeyValue(ctx, chunk_key, REDIS_CMD_BFADD, it->second);
+                    }
+                    else
+                    {
+                        err = SetBitmapChunk(ctx, key, it->first, chunks[it->first]);
+                    }
+                    it++;
+                }
+                if (0 == err)
+                {
+                    meta.SetChunkedLength(bf.Bytes());
+                    meta.GetChunkedHeader().SetString(header, true);
+                    err = SetKeyValue(ctx, key, meta);
+                }
+                if (0 != err)
+                {
+                    batch.MarkFailed(err);
+                }
+            }
+            if (0 == err)
+            {
+                err = ctx.transc_err;
+            }
+            if (0 != err)
+            {
+                reply.SetErrCode(err);
+                return 0;
+            }
+        }
+        if (!multi)
+        {
+            reply.SetInteger(added[0]);
+            return 0;
+        }
+        reply.ReserveMember(0);
+        for (size_t i = 0; i < nitems; i++)
+        {
+            RedisReply& r = reply.AddMember();
+            if (added[i] < 0)
+            {
+                r.SetErrorReason("ERR non scaling filter is full");
+            }
+            else
+            {
+                r.SetInteger(added[i]);
+            }
+        }
+        return 0;
+    }
+
+    int Ardb::BloomExists(Context& ctx, RedisCommandFrame& cmd, bool multi)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        size_t nitems = cmd.GetArguments().size() - 1;
+        std::vector<int64> exists(nitems, 0);
+        BloomFilter bf;
+        if (meta.GetType() > 0)
+        {
+            if (!decode_bloom_filter(meta, bf))
+            {
+                reply.SetErrCode(ERR_INVALID_BLOOM_FILTER);
+                return 0;
+            }
+            int64 chunk_size = meta.GetChunkSize();
+            std::vector<uint64> hashes(nitems * 2);
+            std::map<int64, std::string> chunks;
+            for (size_t i = 0; i < nitems; i++)
+            {
+                bloom_hash(cmd.GetArguments()[i + 1], &hashes[i * 2]);
+                for (size_t j = 0; j < bf.layers.size(); j++)
+                {
+                    bloom_layer_chunks(bf.layers[j], &hashes[i * 2], chunk_size, chunks);
+                }
+            }
+            int err = GetBloomChunks(ctx, key, chunk_size, chunks);
+            if (0 != err)
+            {
+                reply.SetErrCode(err);
+                return 0;
+            }
+            for (size_t i = 0; i < nitems; i++)
+            {
+                for (size_t j = 0; j < bf.layers.size() && !exists[i]; j++)
+                {
+                    exists[i] = bloom_layer_contains(bf.layers[j], &hashes[i * 2], chunk_size, chunks) ? 1 : 0;
+                }
+            }
+        }
+        if (!multi)
+        {
+            reply.SetInteger(exists[0]);
+            return 0;
+        }
+        reply.ReserveMember(0);
+        for (size_t i = 0; i < nitems; i++)
+        {
+            reply.AddMember().SetInteger(exists[i]);
+        }
+        return 0;
+    }
+
+    int Ardb::BFAdd(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return BloomAdd(ctx, cmd, false);
+    }
+
+    int Ardb::BFMAdd(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return BloomAdd(ctx, cmd, true);
+    }
+
+    int Ardb::BFExists(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return BloomExists(ctx, cmd, false);
+    }
+
+    int Ardb::BFMExists(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return BloomExists(ctx, cmd, true);
+    }
+
+    int Ardb::BFInfo(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.SetErrorReason("ERR not found");
+            return 0;
+        }
+        BloomFilter bf;
+        if (!decode_bloom_filter(meta, bf))
+        {
+            reply.SetErrCode(ERR_INVALID_BLOOM_FILTER);
+            return 0;
+        }
+        int64 capacity = 0;
+        for (size_t i = 0; i < bf.layers.size(); i++)
+        {
+            capacity += bf.layers[i].capacity;
+        }
+        reply.ReserveMember(0);
+        reply.AddMember().SetString("Capacity");
+        reply.AddMember().SetInteger(capacity);
+        reply.AddMember().SetString("Size");
+        reply.AddMember().SetInteger(bf.Bytes());
+        reply.AddMember().SetString("Number of filters");
+        reply.AddMember().SetInteger(bf.layers.size());
+        reply.AddMember().SetString("Number of items inserted");
+        reply.AddMember().SetInteger(bf.Count());
+        reply.AddMember().SetString("Expansion rate");
+        reply.AddMember().SetInteger(bf.expansion);
+        return 0;
+    }
+OP_NAMESPACE_END
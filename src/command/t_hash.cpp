@@ -30,6 +30,136 @@
 #include "db/db.hpp"
 
 OP_NAMESPACE_BEGIN
+    bool Ardb::HashPackEnabled()
+    {
+        return GetConf().hash_max_packed_entries > 0;
+    }
+
+    /*
+     * Return true if the hash is packed, a new hash is initialized as a packed one while packing is enabled.
+     */
+    bool Ardb::PrepareHashPacked(ValueObject& meta)
+    {
+        if (meta.GetType() == 0)
+        {
+            if (!HashPackEnabled())
+            {
+                return false;
+            }
+            meta.SetType(KEY_HASH);
+            meta.SetPacked(true);
+            return true;
+        }
+        return meta.GetType() == KEY_HASH && meta.IsPacked();
+    }
+
+    bool Ardb::HashFitsPacked(ValueObject& meta)
+    {
+        if ((int64) meta.PackedCount() > GetConf().hash_max_packed_entries)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < meta.PackedCount(); i++)
+        {
+            if (meta.PackedField(i).StringLength() > GetConf().hash_max_packed_value
+                    || meta.PackedValue(i).StringLength() > GetConf().hash_max_packed_value)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Object id to key the fields of a hash by, an existing hash keeps its id(or the lack of one),
+     * a new one gets an id if enabled.
+     */
+    uint64 Ardb::HashObjectId(ValueObject& meta)
+    {
+        if (meta.GetType() == KEY_HASH)
+        {
+            return meta.GetObjectId();
+        }
+        return ObjectIdEnabled() ? AllocObjectId() : 0;
+    }
+
+    /*
+     * MultiGet of a hash meta(keys[0]) & fields of it, the fields are read after the meta while hashes may be
+     * keyed by object id. The object id of the hash is set to the field keys, also the id of a new hash
+     * if 'create'(vals[0] is left without type).
+     */
+    void Ardb::HashMultiGet(Context& ctx, KeyObjectArray& keys, ValueObjectArray& vals, ErrCodeArray& errs, bool create)
+    {
+        if (!ObjectIdEnabled())
+        {
+            m_engine->MultiGet(ctx, keys, vals, errs);
+            return;
+        }
+        vals.resize(keys.size());
+        errs.resize(keys.size());
+        errs[0] = m_engine->Get(ctx, keys[0], vals[0]);
+        uint64 object_id = 0;
+        if (0 == errs[0])
+        {
+            object_id = vals[0].GetType() == KEY_HASH ? vals[0].GetObjectId() : 0;
+        }
+        else if (ERR_ENTRY_NOT_EXIST == errs[0] && create)
+        {
+            object_id = AllocObjectId();
+            vals[0].SetObjectId(object_id);
+        }
+        if (keys.size() == 1)
+        {
+            return;
+        }
+        KeyObjectArray fields(keys.begin() + 1, keys.end());
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            fields[i].SetObjectId(object_id);
+            keys[i + 1].SetObjectId(object_id);
+        }
+        ValueObjectArray field_vals;
+        ErrCodeArray field_errs;
+        m_engine->MultiGet(ctx, fields, field_vals, field_errs);
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            vals[i + 1] = field_vals[i];
+            errs[i + 1] = field_errs[i];
+        }
+    }
+
+    /*
+     * Write back a packed hash, which is converted to one KEY_HASH_FIELD record per field once it is over
+     * the pack limits or if 'unpack'. Must be called in a write batch.
+     */
+    void Ardb::SavePackedHash(Context& ctx, const KeyObject& meta_key, ValueObject& meta, bool unpack)
+    {
+        if (meta.PackedCount() == 0)
+        {
+            RemoveKey(ctx, meta_key);
+            return;
+        }
+        if (unpack || !HashFitsPacked(meta))
+        {
+            uint64 object_id = ObjectIdEnabled() ? AllocObjectId() : 0;
+            for (size_t i = 0; i < meta.PackedCount(); i++)
+            {
+                KeyObject field(ctx.ns, KEY_HASH_FIELD, meta_key.GetKey());
+                field.SetObjectId(object_id);
+                field.SetHashField(meta.PackedField(i));
+                ValueObject field_value;
+                field_value.SetType(KEY_HASH_FIELD);
+                field_value.SetHashValue(meta.PackedValue(i));
+                SetKeyValue(ctx, field, field_value);
+            }
+            int64 len = meta.PackedCount();
+            meta.SetPacked(false);
+            meta.SetObjectId(object_id);
+            meta.SetObjectLen(len);
+        }
+        SetKeyValue(ctx, meta_key, meta);
+    }
+
     int Ardb::MergeHSet(Context& ctx, const KeyObject& key, ValueObject& value, uint16_t op, const Data& opv)
     {
         bool nx = (op == REDIS_CMD_HSETNX || op == REDIS_CMD_HSETNX2);
@@ -59,11 +189,12 @@ OP_NAMESPACE_BEGIN
                 {
                     return ERR_NOTPERFORMED;
                 }
-                if (value.GetHashValue() == opv)
+                if (value.GetHashValue() == opv && value.GetHashFieldTTL() == 0)
                 {
                     return ERR_NOTPERFORMED;
                 }
                 value.SetHashValue(opv);
+                value.SetHashFieldTTL(0); //overwriting a field clears its ttl
             }
             return 0;
         }
@@ -96,28 +227,68 @@ OP_NAMESPACE_BEGIN
         KeyObject key(ctx.ns, KEY_META, keystr);
         KeyLockGuard guard(ctx,key);
         ValueObject meta;
+        HashIndexArray idxs;
+        HashIndexValues old_index_values, new_index_values;
+        GetHashIndexes(ctx, keystr, idxs);
         {
             WriteBatchGuard batch(ctx, m_engine);
-            if (ctx.flags.redis_compatible)
+            bool packed = false;
+            if (ctx.flags.redis_compatible || HashPackEnabled() || ObjectIdEnabled() || !idxs.empty())
             {
-                if (!CheckMeta(ctx, key, KEY_HASH, meta))
+                if (!CheckMeta(ctx, key, ctx.flags.redis_compatible ? KEY_HASH : (KeyType) 0, meta))
                 {
                     return 0;
                 }
+                if (!idxs.empty())
+                {
+                    GetHashIndexValues(ctx, key, meta, idxs, old_index_values);
+                    new_index_values = old_index_values;
+                    for (size_t i = 1; i < cmd.GetArguments().size(); i += 2)
+                    {
+                        if (IsHashIndexField(idxs, cmd.GetArguments()[i]))
+                        {
+                            new_index_values[cmd.GetArguments()[i]] = cmd.GetArguments()[i + 1];
+                        }
+                    }
+                    UpdateHashIndexes(ctx, idxs, keystr, old_index_values, new_index_values);
+                }
+                packed = PrepareHashPacked(meta);
             }
-            meta.SetType(KEY_HASH);
-            meta.SetObjectLen(-1);
-            meta.SetTTL(0); //clear ttl setting
-            SetKeyValue(ctx, key, meta);
-
-            for (size_t i = 1; i < cmd.GetArguments().size(); i += 2)
+            if (packed)
             {
-                KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
-                field.SetHashField(cmd.GetArguments()[i]);
-                ValueObject field_value;
-                field_value.SetType(KEY_HASH_FIELD);
-                field_value.SetHashValue(cmd.GetArguments()[i + 1]);
-                SetKeyValue(ctx, field, field_value);
+                for (size_t i = 1; i < cmd.GetArguments().size(); i += 2)
+                {
+                    Data field, field_value;
+                    field.SetString(cmd.GetArguments()[i], true);
+                    field_value.SetString(cmd.GetArguments()[i + 1], true);
+                    meta.SetPackedValue(field, field_value);
+                }
+                meta.SetTTL(0); //clear ttl setting
+                SavePackedHash(ctx, key, meta);
+            }
+            else
+            {
+                uint64 object_id = HashObjectId(meta);
+                if (!ctx.flags.redis_compatible)
+                {
+                    meta.Clear();
+                }
+                meta.SetType(KEY_HASH);
+                meta.SetObjectId(object_id);
+                meta.SetObjectLen(-1);
+                meta.SetTTL(0); //clear ttl setting
+                SetKeyValue(ctx, key, meta);
+
+                for (size_t i = 1; i < cmd.GetArguments().size(); i += 2)
+                {
+                    KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
+                    field.SetObjectId(object_id);
+                    field.SetHashField(cmd.GetArguments()[i]);
+                    ValueObject field_value;
+                    field_value.SetType(KEY_HASH_FIELD);
+                    field_value.SetHashValue(cmd.GetArguments()[i + 1]);
+                    SetKeyValue(ctx, field, field_value);
+                }
             }
         }
         if (0 != ctx.transc_err)
@@ -142,12 +313,53 @@ OP_NAMESPACE_BEGIN
         KeyObject key(ctx.ns, KEY_META, keystr);
         ValueObject meta;
         int err = 0;
-        if (!ctx.flags.redis_compatible)
+        /*
+         * packed hash fields are stored in the meta value & fields may be keyed by the object id in the meta,
+         * which need to be read before writing
+         */
+        HashIndexArray idxs;
+        if (GetHashIndexes(ctx, keystr, idxs) > 0 && !IsHashIndexField(idxs, cmd.GetArguments()[1]))
+        {
+            idxs.clear();
+        }
+        bool read_meta = ctx.flags.redis_compatible || HashPackEnabled() || ObjectIdEnabled() || !idxs.empty();
+        KeyLockGuard guard(ctx, key, read_meta);
+        KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
+        field.SetHashField(cmd.GetArguments()[1]);
+        KeyObjectArray keys;
+        keys.push_back(key);
+        keys.push_back(field);
+        ValueObjectArray vals;
+        ErrCodeArray errs;
+        bool packed = false;
+        if (read_meta)
+        {
+            HashMultiGet(ctx, keys, vals, errs, !HashPackEnabled());
+            if (errs[0] != 0 && errs[0] != ERR_ENTRY_NOT_EXIST)
+            {
+                reply.SetErrCode(errs[0]);
+                return 0;
+            }
+            packed = PrepareHashPacked(vals[0]);
+            if (packed)
+            {
+                Data* packed_value = vals[0].GetPackedValue(field.GetHashField());
+                vals[1].Clear();
+                if (NULL != packed_value)
+                {
+                    vals[1].SetType(KEY_HASH_FIELD);
+                    vals[1].SetHashValue(*packed_value);
+                }
+            }
+            else if (vals[1].IsHashFieldExpired(get_current_epoch_millis()))
+            {
+                vals[1].Clear();
+            }
+        }
+        if (!ctx.flags.redis_compatible && !packed && !ObjectIdEnabled() && idxs.empty())
         {
             {
                 WriteBatchGuard batch(ctx, m_engine);
-                KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
-                field.SetHashField(cmd.GetArguments()[1]);
                 ValueObject field_value;
                 field_value.SetType(KEY_HASH_FIELD);
                 field_value.SetHashValue(cmd.GetArguments()[2]);
@@ -178,25 +390,16 @@ OP_NAMESPACE_BEGIN
             }
             return 0;
         }
-        KeyLockGuard guard(ctx,key);
-        KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
-        field.SetHashField(cmd.GetArguments()[1]);
-        KeyObjectArray keys;
-        keys.push_back(key);
-        keys.push_back(field);
-        ValueObjectArray vals;
-        ErrCodeArray errs;
-        m_engine->MultiGet(ctx, keys, vals, errs);
-        if (errs[0] != 0 && errs[0] != ERR_ENTRY_NOT_EXIST)
-        {
-            reply.SetErrCode(errs[0]);
-            return 0;
-        }
 
         Data meta_size;
         meta_size.SetInt64(1);
         err = MergeHSet(ctx, keys[0], vals[0], cmd.GetType(), meta_size);
         bool inserted = vals[1].GetType() == 0;
+        std::string old_index_value, new_index_value;
+        if (!inserted)
+        {
+            vals[1].GetHashValue().ToString(old_index_value);
+        }
         if (0 == err || ERR_NOTPERFORMED == err)
         {
             Data field_value;
@@ -208,8 +411,21 @@ OP_NAMESPACE_BEGIN
             vals[0].SetTTL(0);
             {
                 WriteBatchGuard batch(ctx, m_engine);
-                SetKeyValue(ctx, keys[0], vals[0]);
-                SetKeyValue(ctx, keys[1], vals[1]);
+                if (packed)
+                {
+                    vals[0].SetPackedValue(field.GetHashField(), vals[1].GetHashValue());
+                    SavePackedHash(ctx, keys[0], vals[0]);
+                }
+                else
+                {
+                    SetKeyValue(ctx, keys[0], vals[0]);
+                    SetKeyValue(ctx, keys[1], vals[1]);
+                }
+                if (!idxs.empty())
+                {
+                    vals[1].GetHashValue().ToString(new_index_value);
+                    UpdateHashIndexes(ctx, idxs, keystr, cmd.GetArguments()[1], inserted ? NULL : &old_index_value, &new_index_value);
+                }
             }
             err = ctx.transc_err;
         }
@@ -217,7 +433,14 @@ OP_NAMESPACE_BEGIN
         {
             if (err == ERR_NOTPERFORMED)
             {
-                reply.SetInteger(0);
+                if (ctx.flags.redis_compatible)
+                {
+                    reply.SetInteger(0);
+                }
+                else
+                {
+                    reply.SetStatusCode(STATUS_OK);
+                }
             }
             else
             {
@@ -228,7 +451,14 @@ OP_NAMESPACE_BEGIN
         {
             if (inserted)
                 m_key_cache->Put(keystr);
-            reply.SetInteger(inserted ? 1 : 0);
+            if (ctx.flags.redis_compatible)
+            {
+                reply.SetInteger(inserted ? 1 : 0);
+            }
+            else
+            {
+                reply.SetStatusCode(STATUS_OK);
+            }
         }
         return 0;
     }
@@ -243,38 +473,58 @@ OP_NAMESPACE_BEGIN
 
         reply.ReserveMember(0);
         const std::string& keystr = cmd.GetArguments()[0];
-        KeyObject key(ctx.ns, KEY_META, keystr);
-        Iterator* iter = m_engine->Find(ctx, key);
-
-        bool checked_meta = false;
-        while (NULL != iter && iter->Valid())
+        ValueObject meta;
+        if (!CheckMeta(ctx, keystr, KEY_HASH, meta))
         {
-            KeyObject& field = iter->Key();
-
-            if (!checked_meta)
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            return 0;
+        }
+        if (meta.IsPacked())
+        {
+            for (size_t i = 0; i < meta.PackedCount(); i++)
             {
-                if (field.GetType() == KEY_META && field.GetKey() == key.GetKey())
+                if (cmd.GetType() == REDIS_CMD_HKEYS || cmd.GetType() == REDIS_CMD_HGETALL)
                 {
-                    ValueObject& meta = iter->Value();
-                    if (meta.GetType() != KEY_HASH)
-                    {
-                        reply.SetErrCode(ERR_WRONG_TYPE);
-                        break;
-                    }
-                    checked_meta = true;
-                    iter->Next();
-                    continue;
+                    RedisReply& r = reply.AddMember();
+                    r.SetString(meta.PackedField(i));
                 }
-                else
+                if (cmd.GetType() == REDIS_CMD_HVALS || cmd.GetType() == REDIS_CMD_HGETALL)
                 {
-                    break;
+                    RedisReply& r = reply.AddMember();
+                    r.SetString(meta.PackedValue(i));
                 }
             }
-            if (field.GetType() != KEY_HASH_FIELD || field.GetNameSpace() != key.GetNameSpace() || field.GetKey() != key.GetKey())
+            return 0;
+        }
+        KeyObject key(ctx.ns, KEY_HASH_FIELD, keystr);
+        key.SetObjectId(meta.GetObjectId());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(key);
+        CheckStreamIterate(meta.GetObjectLen(), iter_opts);
+        /*
+         * the streamed count is declared first while expired fields are skipped below, so only a hash without field
+         * ttls is streamed. HEXPIRE drops the tracked length(-1) of a hash once one of its fields has a ttl, such a hash
+         * is replied as a whole.
+         */
+        int64 reply_count = 0;
+        if (meta.GetObjectLen() > 0)
+        {
+            reply_count = cmd.GetType() == REDIS_CMD_HGETALL ? meta.GetObjectLen() * 2 : meta.GetObjectLen();
+        }
+        bool streaming = reply_count > 0 && BeginStreamReply(ctx, reply, reply_count);
+        Iterator* iter = m_engine->Find(ctx, key, iter_opts);
+        int64 now = get_current_epoch_millis();
+        while (NULL != iter && iter->Valid())
+        {
+            KeyObject& field = iter->Key();
+            if (iter->Value().IsHashFieldExpired(now))
             {
-                break;
+                iter->Next();
+                continue;
             }
-
             if (cmd.GetType() == REDIS_CMD_HKEYS || cmd.GetType() == REDIS_CMD_HGETALL)
             {
                 RedisReply& r = reply.AddMember();
@@ -286,6 +536,10 @@ OP_NAMESPACE_BEGIN
                 RedisReply& r = reply.AddMember();
                 r.SetString(fv.GetHashValue());
             }
+            if (streaming)
+            {
+                StreamReplyMembers(ctx, reply);
+            }
             iter->Next();
         }
         DELETE(iter);
@@ -324,7 +578,7 @@ OP_NAMESPACE_BEGIN
         }
         ValueObjectArray vals;
         ErrCodeArray errs;
-        m_engine->MultiGet(ctx, keys, vals, errs);
+        HashMultiGet(ctx, keys, vals, errs, false);
         if (errs[0] != 0)
         {
             if (errs[0] != ERR_ENTRY_NOT_EXIST)
@@ -342,9 +596,22 @@ OP_NAMESPACE_BEGIN
             }
         }
 
+        int64 now = get_current_epoch_millis();
         for (size_t i = 1; i < errs.size(); i++)
         {
-            if (errs[i] != 0)
+            if (vals[0].IsPacked())
+            {
+                Data* packed_value = vals[0].GetPackedValue(keys[i].GetHashField());
+                if (NULL == packed_value)
+                {
+                    reply.MemberAt(i - 1).Clear();
+                }
+                else
+                {
+                    reply.MemberAt(i - 1).SetString(*packed_value);
+                }
+            }
+            else if (errs[i] != 0 || vals[i].IsHashFieldExpired(now))
             {
                 reply.MemberAt(i - 1).Clear();
             }
@@ -441,7 +708,12 @@ OP_NAMESPACE_BEGIN
         KeyObject field_key(ctx.ns, KEY_HASH_FIELD, keystr);
         field_key.SetHashField(cmd.GetArguments()[1]);
         int err = 0;
-        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        HashIndexArray idxs;
+        if (GetHashIndexes(ctx, keystr, idxs) > 0 && !IsHashIndexField(idxs, cmd.GetArguments()[1]))
+        {
+            idxs.clear();
+        }
+        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge && !HashPackEnabled() && !ObjectIdEnabled() && idxs.empty())
         {
             Data arg;
             if (inc_float)
@@ -454,10 +726,10 @@ OP_NAMESPACE_BEGIN
             }
             {
                 WriteBatchGuard batch(ctx, m_engine);
-                ValueObject meta;
-                meta.SetType(KEY_HASH);
-                meta.SetObjectLen(-1);
-                SetKeyValue(ctx, meta_key, meta);
+                /*
+                 * both writes are blind merges, the meta is only marked with unknown length, its ttl is kept
+                 */
+                m_engine->Merge(ctx, meta_key, REDIS_CMD_HSET, Data());
                 m_engine->Merge(ctx, field_key, cmd.GetType(), arg);
             }
             err = ctx.transc_err;
@@ -477,7 +749,7 @@ OP_NAMESPACE_BEGIN
         keys.push_back(field_key);
         ValueObjectArray vals;
         ErrCodeArray errs;
-        m_engine->MultiGet(ctx, keys, vals, errs);
+        HashMultiGet(ctx, keys, vals, errs, !HashPackEnabled());
         bool meta_change = false;
         if (errs[0] != 0 && ERR_ENTRY_NOT_EXIST != errs[0])
         {
@@ -489,7 +761,28 @@ OP_NAMESPACE_BEGIN
             reply.SetErrCode(ERR_WRONG_TYPE);
             return 0;
         }
+        bool packed = PrepareHashPacked(vals[0]);
+        if (packed)
+        {
+            Data* packed_value = vals[0].GetPackedValue(field_key.GetHashField());
+            vals[1].Clear();
+            if (NULL != packed_value)
+            {
+                vals[1].SetType(KEY_HASH_FIELD);
+                vals[1].SetHashValue(*packed_value);
+            }
+        }
+        else if (vals[1].IsHashFieldExpired(get_current_epoch_millis()))
+        {
+            vals[1].Clear();
+        }
 
+        bool field_exist = vals[1].GetType() != 0;
+        std::string old_index_value, new_index_value;
+        if (field_exist)
+        {
+            vals[1].GetHashValue().ToString(old_index_value);
+        }
         if (vals[0].GetType() == 0)
         {
             vals[0].SetType(KEY_HASH);
@@ -549,11 +842,24 @@ OP_NAMESPACE_BEGIN
         if (0 == err)
         {
             WriteBatchGuard batch(ctx, m_engine);
-            if (meta_change)
+            if (packed)
+            {
+                vals[0].SetPackedValue(field_key.GetHashField(), vals[1].GetHashValue());
+                SavePackedHash(ctx, keys[0], vals[0]);
+            }
+            else
+            {
+                if (meta_change)
+                {
+                    SetKeyValue(ctx, keys[0], vals[0]);
+                }
+                SetKeyValue(ctx, keys[1], vals[1]);
+            }
+            if (!idxs.empty())
             {
-                SetKeyValue(ctx, keys[0], vals[0]);
+                vals[1].GetHashValue().ToString(new_index_value);
+                UpdateHashIndexes(ctx, idxs, keystr, cmd.GetArguments()[1], field_exist ? &old_index_value : NULL, &new_index_value);
             }
-            SetKeyValue(ctx, keys[1], vals[1]);
         }
         err = ctx.transc_err;
 
@@ -561,6 +867,11 @@ OP_NAMESPACE_BEGIN
         {
             reply.SetErrCode(err);
         }
+        else if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        {
+            //same reply as the merge write
+            reply.SetStatusCode(STATUS_OK);
+        }
         else
         {
             if (inc_float)
@@ -587,7 +898,20 @@ OP_NAMESPACE_BEGIN
         keys.push_back(key);
         ValueObjectArray vals;
         ErrCodeArray errs;
-        m_engine->MultiGet(ctx, keys, vals, errs);
+        HashMultiGet(ctx, keys, vals, errs, false);
+        if (errs[0] == 0 && vals[0].GetType() == KEY_HASH && vals[0].IsPacked())
+        {
+            Data* packed_value = vals[0].GetPackedValue(key.GetHashField());
+            if (NULL == packed_value)
+            {
+                reply.Clear();
+            }
+            else
+            {
+                reply.SetString(*packed_value);
+            }
+            return 0;
+        }
         if (errs[0] != 0 || errs[1] != 0)
         {
             int err = errs[0] != 0 ? errs[0] : errs[1];
@@ -605,6 +929,10 @@ OP_NAMESPACE_BEGIN
         {
             reply.SetErrCode(ERR_WRONG_TYPE);
         }
+        else if (vals[1].IsHashFieldExpired(get_current_epoch_millis()))
+        {
+            reply.Clear();
+        }
         else
         {
             reply.SetString(vals[1].GetHashValue());
@@ -614,15 +942,26 @@ OP_NAMESPACE_BEGIN
 
     int Ardb::HExists(Context& ctx, RedisCommandFrame& cmd)
     {
-        if (!CheckMeta(ctx, cmd.GetArguments()[0], KEY_HASH))
+        ValueObject meta;
+        if (!CheckMeta(ctx, cmd.GetArguments()[0], KEY_HASH, meta))
         {
             return 0;
         }
         RedisReply& reply = ctx.GetReply();
         const std::string& keystr = cmd.GetArguments()[0];
         KeyObject key(ctx.ns, KEY_HASH_FIELD, keystr);
+        key.SetObjectId(meta.GetObjectId());
         key.SetHashField(cmd.GetArguments()[1]);
-        bool existed = m_engine->Exists(ctx, key);
+        bool existed = false;
+        if (meta.IsPacked())
+        {
+            existed = NULL != meta.GetPackedValue(key.GetHashField());
+        }
+        else
+        {
+            ValueObject field_value;
+            existed = 0 == m_engine->Get(ctx, key, field_value) && !field_value.IsHashFieldExpired(get_current_epoch_millis());
+        }
         reply.SetInteger(existed ? 1 : 0);
         return 0;
     }
@@ -634,19 +973,80 @@ OP_NAMESPACE_BEGIN
         KeyLockGuard guard(ctx,key);
         ValueObject meta;
         int err = 0;
+        HashIndexArray idxs;
+        HashIndexValues old_index_values, new_index_values;
+        GetHashIndexes(ctx, keystr, idxs);
+        if (ctx.flags.redis_compatible || HashPackEnabled() || ObjectIdEnabled() || !idxs.empty())
+        {
+            err = m_engine->Get(ctx, key, meta);
+            if (err != 0 && err != ERR_ENTRY_NOT_EXIST)
+            {
+                reply.SetErrCode(err);
+                return 0;
+            }
+            if (!idxs.empty())
+            {
+                GetHashIndexValues(ctx, key, meta, idxs, old_index_values);
+                new_index_values = old_index_values;
+                for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+                {
+                    new_index_values.erase(cmd.GetArguments()[i]);
+                }
+            }
+            if (meta.GetType() == KEY_HASH && meta.IsPacked())
+            {
+                int64_t del_num = 0;
+                for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+                {
+                    Data field;
+                    field.SetString(cmd.GetArguments()[i], true);
+                    if (meta.DelPackedValue(field))
+                    {
+                        del_num++;
+                    }
+                }
+                if (del_num > 0)
+                {
+                    {
+                        WriteBatchGuard batch(ctx, m_engine);
+                        SavePackedHash(ctx, key, meta);
+                        UpdateHashIndexes(ctx, idxs, keystr, old_index_values, new_index_values);
+                    }
+                    err = ctx.transc_err;
+                }
+                if (0 != err)
+                {
+                    reply.SetErrCode(err);
+                }
+                else if (ctx.flags.redis_compatible)
+                {
+                    reply.SetInteger(del_num);
+                }
+                else
+                {
+                    reply.SetStatusCode(STATUS_OK);
+                }
+                return 0;
+            }
+        }
         if (!ctx.flags.redis_compatible)
         {
             {
                 WriteBatchGuard batch(ctx, m_engine);
+                uint64 object_id = meta.GetType() == KEY_HASH ? meta.GetObjectId() : 0;
+                meta.Clear();
                 meta.SetType(KEY_HASH);
+                meta.SetObjectId(object_id);
                 meta.SetObjectLen(-1);
                 SetKeyValue(ctx, key, meta);
                 for (size_t i = 1; i < cmd.GetArguments().size(); i++)
                 {
                     KeyObject field(ctx.ns, KEY_HASH_FIELD, cmd.GetArguments()[0]);
+                    field.SetObjectId(object_id);
                     field.SetHashField(cmd.GetArguments()[i]);
                     RemoveKey(ctx, field);
                 }
+                UpdateHashIndexes(ctx, idxs, keystr, old_index_values, new_index_values);
             }
             if (0 != ctx.transc_err)
             {
@@ -658,12 +1058,6 @@ OP_NAMESPACE_BEGIN
             }
             return 0;
         }
-        err = m_engine->Get(ctx, key, meta);
-        if (err != 0 && err != ERR_ENTRY_NOT_EXIST)
-        {
-            reply.SetErrCode(err);
-            return 0;
-        }
         if (meta.GetType() != KEY_HASH)
         {
             reply.SetErrCode(ERR_WRONG_TYPE);
@@ -675,6 +1069,7 @@ OP_NAMESPACE_BEGIN
             for (size_t i = 1; i < cmd.GetArguments().size(); i++)
             {
                 KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
+                field.SetObjectId(meta.GetObjectId());
                 field.SetHashField(cmd.GetArguments()[i]);
                 if (m_engine->Exists(ctx, field))
                 {
@@ -694,6 +1089,7 @@ OP_NAMESPACE_BEGIN
                     SetKeyValue(ctx, key, meta);
                 }
             }
+            UpdateHashIndexes(ctx, idxs, keystr, old_index_values, new_index_values);
         }
         if (0 != ctx.transc_err)
         {
@@ -706,5 +1102,332 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
+    /*
+     * Remove 'fields' of an unpacked hash, with their index entries, the hash is removed with its last field.
+     * Must be called in a write batch with the key locked.
+     */
+    int64 Ardb::RemoveHashFields(Context& ctx, const KeyObject& meta_key, ValueObject& meta, const StringArray& fields)
+    {
+        std::string keystr = meta_key.GetKey().AsString();
+        HashIndexArray idxs;
+        HashIndexValues old_index_values, new_index_values;
+        if (GetHashIndexes(ctx, keystr, idxs) > 0)
+        {
+            GetHashIndexValues(ctx, meta_key, meta, idxs, old_index_values);
+            new_index_values = old_index_values;
+            for (size_t i = 0; i < fields.size(); i++)
+            {
+                new_index_values.erase(fields[i]);
+            }
+        }
+        int64 del_num = 0;
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            KeyObject field(meta_key.GetNameSpace(), KEY_HASH_FIELD, keystr);
+            field.SetObjectId(meta.GetObjectId());
+            field.SetHashField(fields[i]);
+            if (m_engine->Exists(ctx, field))
+            {
+                RemoveKey(ctx, field);
+                del_num++;
+            }
+        }
+        UpdateHashIndexes(ctx, idxs, keystr, old_index_values, new_index_values);
+        if (del_num == 0)
+        {
+            return 0;
+        }
+        bool empty = false;
+        if (meta.GetObjectLen() > 0)
+        {
+            meta.SetObjectLen(meta.GetObjectLen() - del_num);
+            empty = meta.GetObjectLen() <= 0;
+            if (!empty)
+            {
+                SetKeyValue(ctx, meta_key, meta);
+            }
+        }
+        else
+        {
+            /*
+             * the size is unknown, look for any field left(the removed ones are not visible before the batch is committed)
+             */
+            KeyObject first(meta_key.GetNameSpace(), KEY_HASH_FIELD, keystr);
+            first.SetObjectId(meta.GetObjectId());
+            IterateOptions iter_opts;
+            iter_opts.BoundToObject(first);
+            Iterator* iter = m_engine->Find(ctx, first, iter_opts);
+            empty = true;
+            while (empty && iter->Valid())
+            {
+                std::string name;
+                iter->Key().GetHashField().ToString(name);
+                empty = std::find(fields.begin(), fields.end(), name) != fields.end();
+                iter->Next();
+            }
+            DELETE(iter);
+        }
+        if (empty)
+        {
+            RemoveKey(ctx, meta_key);
+            m_key_cache->Delete(keystr);
+        }
+        return del_num;
+    }
+
+    /*
+     * Called by the expire scheduler for the ttl entry of a hash field, the field is deleted if its ttl is
+     * still the one of the entry, the deletion is replicated as a HDEL.
+     */
+    bool Ardb::ExpireHashField(Context& ctx, const KeyObject& meta_key, const std::string& field, int64 ttl)
+    {
+        ValueObject meta;
+        if (0 != m_engine->Get(ctx, meta_key, meta) || meta.GetType() != KEY_HASH || meta.IsPacked())
+        {
+            return false;
+        }
+        KeyObject field_key(meta_key.GetNameSpace(), KEY_HASH_FIELD, meta_key.GetKey());
+        field_key.SetObjectId(meta.GetObjectId());
+        field_key.SetHashField(field);
+        ValueObject field_value;
+        if (0 != m_engine->Get(ctx, field_key, field_value) || field_value.GetHashFieldTTL() != ttl)
+        {
+            return false;
+        }
+        ctx.ns = meta_key.GetNameSpace();
+        StringArray fields;
+        fields.push_back(field);
+        RemoveHashFields(ctx, meta_key, meta, fields);
+        RedisCommandFrame hdel("hdel");
+        hdel.AddArg(meta_key.GetKey().AsString());
+        hdel.AddArg(field);
+        FeedReplicationBacklog(ctx, meta_key.GetNameSpace(), hdel);
+        return true;
+    }
+
+    /*
+     * Parse 'FIELDS numfields field ...' from 'pos'.
+     */
+    static bool parse_hash_ttl_fields(RedisCommandFrame& cmd, size_t pos, StringArray& fields, RedisReply& reply)
+    {
+        uint32 num = 0;
+        if (pos + 1 >= cmd.GetArguments().size() || strcasecmp(cmd.GetArguments()[pos].c_str(), "fields")
+                || !string_touint32(cmd.GetArguments()[pos + 1], num) || num == 0 || pos + 2 + num != cmd.GetArguments().size())
+        {
+            reply.SetErrorReason("ERR the numfields parameter must match the number of arguments");
+            return false;
+        }
+        fields.assign(cmd.GetArguments().begin() + pos + 2, cmd.GetArguments().end());
+        return true;
+    }
+
+    /*
+     * HEXPIRE/HPEXPIRE/HEXPIREAT/HPEXPIREAT key time FIELDS numfields field ...
+     * Reply per field: -2 no such field, 1 the ttl is set, 2 the field is deleted as the time is already passed.
+     * The ttl is kept in the field value & indexed in the ttl db like key ttls, packed hashes are unpacked first.
+     * The command is replicated as HPEXPIREAT with the absolute time.
+     */
+    int Ardb::HExpire(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        if (ctx.flags.slave && GetConf().slave_ignore_expire)
+        {
+            return 0;
+        }
+        int64 mills = 0;
+        if (!string_toint64(cmd.GetArguments()[1], mills) || mills < 0)
+        {
+            reply.SetErrCode(ERR_OUTOFRANGE);
+            return 0;
+        }
+        StringArray fields;
+        if (!parse_hash_ttl_fields(cmd, 2, fields, reply))
+        {
+            return 0;
+        }
+        int64 now = get_current_epoch_millis();
+        switch (cmd.GetType())
+        {
+            case REDIS_CMD_HEXPIRE:
+            {
+                mills = mills * 1000 + now;
+                break;
+            }
+            case REDIS_CMD_HPEXPIRE:
+            {
+                mills += now;
+                break;
+            }
+            case REDIS_CMD_HEXPIREAT:
+            {
+                mills *= 1000;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+        const std::string& keystr = cmd.GetArguments()[0];
+        KeyObject key(ctx.ns, KEY_META, keystr);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_HASH, meta))
+        {
+            return 0;
+        }
+        reply.ReserveMember(0);
+        if (meta.GetType() == 0)
+        {
+            for (size_t i = 0; i < fields.size(); i++)
+            {
+                reply.AddMember().SetInteger(-2);
+            }
+            return 0;
+        }
+        if (meta.IsPacked())
+        {
+            /*
+             * committed first, the fields are read back below
+             */
+            {
+                WriteBatchGuard batch(ctx, m_engine);
+                SavePackedHash(ctx, key, meta, true);
+            }
+            if (0 != ctx.transc_err)
+            {
+                reply.Clear();
+                reply.SetErrCode(ctx.transc_err);
+                return 0;
+            }
+        }
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            for (size_t i = 0; i < fields.size(); i++)
+            {
+                KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
+                field.SetObjectId(meta.GetObjectId());
+                field.SetHashField(fields[i]);
+                ValueObject field_value;
+                if (0 != m_engine->Get(ctx, field, field_value) || field_value.IsHashFieldExpired(now))
+                {
+                    reply.AddMember().SetInteger(-2);
+                    continue;
+                }
+                if (mills <= now)
+                {
+                    StringArray expired(1, fields[i]);
+                    RemoveHashFields(ctx, key, meta, expired);
+                    reply.AddMember().SetInteger(2);
+                    continue;
+                }
+                int64 old_ttl = field_value.GetHashFieldTTL();
+                field_value.SetHashFieldTTL(mills);
+                SetKeyValue(ctx, field, field_value);
+                SaveTTL(ctx, ctx.ns, keystr, old_ttl, mills, &fields[i]);
+                /*
+                 * the size of a hash with expiring fields is counted by iterating, the fields may be dropped by the
+                 * compaction filter
+                 */
+                if (meta.GetObjectLen() >= 0)
+                {
+                    meta.SetObjectLen(-1);
+                    SetKeyValue(ctx, key, meta);
+                }
+                reply.AddMember().SetInteger(1);
+            }
+        }
+        if (0 != ctx.transc_err)
+        {
+            reply.Clear();
+            reply.SetErrCode(ctx.transc_err);
+            return 0;
+        }
+        if (cmd.GetType() != REDIS_CMD_HPEXPIREAT)
+        {
+            cmd.SetCommand("hpexpireat");
+            cmd.SetType(REDIS_CMD_HPEXPIREAT);
+            cmd.GetMutableArguments()[1] = stringfromll(mills);
+            cmd.ClearRawProtocolData();
+        }
+        return 0;
+    }
+
+    /*
+     * HTTL/HPTTL key FIELDS numfields field ...
+     * Reply per field: -2 no such field, -1 no ttl, else the remaining time to live.
+     * HPERSIST key FIELDS numfields field ...
+     * Reply per field: -2 no such field, -1 no ttl, 1 the ttl is removed.
+     */
+    int Ardb::HTTL(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        StringArray fields;
+        if (!parse_hash_ttl_fields(cmd, 1, fields, reply))
+        {
+            return 0;
+        }
+        bool persist = cmd.GetType() == REDIS_CMD_HPERSIST;
+        const std::string& keystr = cmd.GetArguments()[0];
+        KeyObject key(ctx.ns, KEY_META, keystr);
+        KeyLockGuard guard(ctx, key, persist);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_HASH, meta))
+        {
+            return 0;
+        }
+        reply.ReserveMember(0);
+        int64 now = get_current_epoch_millis();
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            for (size_t i = 0; i < fields.size(); i++)
+            {
+                if (meta.GetType() == 0)
+                {
+                    reply.AddMember().SetInteger(-2);
+                    continue;
+                }
+                if (meta.IsPacked())
+                {
+                    Data name;
+                    name.SetString(fields[i], false);
+                    reply.AddMember().SetInteger(NULL == meta.GetPackedValue(name) ? -2 : -1);
+                    continue;
+                }
+                KeyObject field(ctx.ns, KEY_HASH_FIELD, keystr);
+                field.SetObjectId(meta.GetObjectId());
+                field.SetHashField(fields[i]);
+                ValueObject field_value;
+                if (0 != m_engine->Get(ctx, field, field_value) || field_value.IsHashFieldExpired(now))
+                {
+                    reply.AddMember().SetInteger(-2);
+                    continue;
+                }
+                int64 ttl = field_value.GetHashFieldTTL();
+                if (ttl == 0)
+                {
+                    reply.AddMember().SetInteger(-1);
+                }
+                else if (persist)
+                {
+                    field_value.SetHashFieldTTL(0);
+                    SetKeyValue(ctx, field, field_value);
+                    SaveTTL(ctx, ctx.ns, keystr, ttl, 0, &fields[i]);
+                    reply.AddMember().SetInteger(1);
+                }
+                else
+                {
+                    reply.AddMember().SetInteger(cmd.GetType() == REDIS_CMD_HTTL ? (ttl - now + 500) / 1000 : ttl - now);
+                }
+            }
+        }
+        if (0 != ctx.transc_err)
+        {
+            reply.Clear();
+            reply.SetErrCode(ctx.transc_err);
+        }
+        return 0;
+    }
+
 OP_NAMESPACE_END
 
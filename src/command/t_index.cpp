@@ -0,0 +1,743 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "db/db.hpp"
+#include <math.h>
+
+/*
+ * Secondary indexes on hash fields. IDX.CREATE declares an index on the hashes whose keys start with a prefix,
+ * the definitions of all dbs are saved in one value of the index db. An indexed field of a hash has one entry,
+ * a KEY_ZSET_SORT key of the index db keyed by "<db>\0<index>\0<field>":
+ *
+ *   NUMERIC: score is the field value, member is the hash key
+ *   TAG:     score is 0, member is "<value>\0<hash key>"(values with '\0' are not indexed)
+ *
+ * Entries are written in the write batch of HSET/HMSET/HDEL/HINCRBY & of key deletions. Writes which replace
+ * hashes without them(RENAME, RESTORE...) may leave stale entries, so IDX.RANGE checks the current value of every
+ * entry it visits & skips the stale ones.
+ */
+OP_NAMESPACE_BEGIN
+    static const uint8 kIndexNumeric = 1;
+    static const uint8 kIndexTag = 2;
+    static const size_t kIndexBackfillBatch = 1024;
+
+    static KeyObject index_defs_key()
+    {
+        Data index_ns(INDEX_DB_NAMESPACE, false);
+        return KeyObject(index_ns, KEY_META, "");
+    }
+
+    static KeyObject index_entry_key(const Ardb::HashIndex& idx, size_t i)
+    {
+        Data index_ns(INDEX_DB_NAMESPACE, false);
+        std::string key = idx.ns;
+        key.push_back(0);
+        key.append(idx.name);
+        key.push_back(0);
+        key.append(idx.fields[i]);
+        return KeyObject(index_ns, KEY_ZSET_SORT, key);
+    }
+
+    static bool index_entry(const Ardb::HashIndex& idx, size_t i, const std::string& key, const std::string& value, KeyObject& entry)
+    {
+        entry = index_entry_key(idx, i);
+        if (idx.types[i] == kIndexNumeric)
+        {
+            double score;
+            if (!string_todouble(value, score) || isnan(score))
+            {
+                return false;
+            }
+            entry.SetZSetScore(score);
+            entry.SetZSetMember(key);
+            return true;
+        }
+        if (value.find('\0') != std::string::npos)
+        {
+            return false;
+        }
+        std::string member = value;
+        member.push_back(0);
+        member.append(key);
+        entry.SetZSetScore(0);
+        entry.SetZSetMember(member);
+        return true;
+    }
+
+    static void encode_hash_indexes(const Ardb::HashIndexArray& idxs, std::string& content)
+    {
+        Buffer buffer;
+        BufferHelper::WriteVarUInt32(buffer, idxs.size());
+        for (size_t i = 0; i < idxs.size(); i++)
+        {
+            BufferHelper::WriteVarString(buffer, idxs[i].ns);
+            BufferHelper::WriteVarString(buffer, idxs[i].name);
+            BufferHelper::WriteVarString(buffer, idxs[i].prefix);
+            BufferHelper::WriteVarUInt32(buffer, idxs[i].fields.size());
+            for (size_t j = 0; j < idxs[i].fields.size(); j++)
+            {
+                BufferHelper::WriteVarString(buffer, idxs[i].fields[j]);
+                buffer.WriteByte((char) idxs[i].types[j]);
+            }
+        }
+        content.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+    }
+
+    static bool decode_hash_indexes(const std::string& content, Ardb::HashIndexArray& idxs)
+    {
+        Buffer buffer(const_cast<char*>(content.data()), 0, content.size());
+        uint32 n = 0;
+        if (!BufferHelper::ReadVarUInt32(buffer, n))
+        {
+            return false;
+        }
+        idxs.resize(n);
+        for (uint32 i = 0; i < n; i++)
+        {
+            uint32 nfields = 0;
+            if (!BufferHelper::ReadVarString(buffer, idxs[i].ns) || !BufferHelper::ReadVarString(buffer, idxs[i].name)
+                    || !BufferHelper::ReadVarString(buffer, idxs[i].prefix) || !BufferHelper::ReadVarUInt32(buffer, nfields))
+            {
+                return false;
+            }
+            idxs[i].fields.resize(nfields);
+            idxs[i].types.resize(nfields);
+            for (uint32 j = 0; j < nfields; j++)
+            {
+                char type;
+                if (!BufferHelper::ReadVarString(buffer, idxs[i].fields[j]) || !buffer.ReadByte(type))
+                {
+                    return false;
+                }
+                idxs[i].types[j] = (uint8) type;
+            }
+        }
+        return true;
+    }
+
+    void Ardb::LoadHashIndexes()
+    {
+        Context ctx;
+        ValueObject defs;
+        HashIndexArray idxs;
+        if (0 == m_engine->Get(ctx, index_defs_key(), defs) && defs.GetType() == KEY_STRING)
+        {
+            std::string content;
+            defs.GetStringValue().ToString(content);
+            if (!decode_hash_indexes(content, idxs))
+            {
+                ERROR_LOG("Invalid hash index definitions.");
+                idxs.clear();
+            }
+        }
+        LockGuard<SpinMutexLock> guard(m_hash_indexes_lock);
+        m_hash_indexes = idxs;
+        m_hash_index_count = m_hash_indexes.size();
+    }
+
+    /*
+     * Must be called with the definitions key locked, the saved definitions are published after the write.
+     */
+    int Ardb::SaveHashIndexes(Context& ctx, const HashIndexArray& idxs)
+    {
+        std::string content;
+        encode_hash_indexes(idxs, content);
+        ValueObject defs;
+        defs.SetType(KEY_STRING);
+        defs.GetStringValue().SetString(content, false);
+        ctx.flags.create_if_notexist = 1;
+        int err = m_engine->Put(ctx, index_defs_key(), defs);
+        if (0 != err)
+        {
+            return err;
+        }
+        LockGuard<SpinMutexLock> guard(m_hash_indexes_lock);
+        m_hash_indexes = idxs;
+        m_hash_index_count = m_hash_indexes.size();
+        return 0;
+    }
+
+    void Ardb::ClearHashIndexes()
+    {
+        LockGuard<SpinMutexLock> guard(m_hash_indexes_lock);
+        m_hash_indexes.clear();
+        m_hash_index_count = 0;
+    }
+
+    /*
+     * Copy the indexes covering a hash key of the current db, returns the number of them.
+     */
+    size_t Ardb::GetHashIndexes(Context& ctx, const std::string& key, HashIndexArray& idxs)
+    {
+        idxs.clear();
+        if (0 == m_hash_index_count)
+        {
+            return 0;
+        }
+        std::string ns = ctx.ns.AsString();
+        LockGuard<SpinMutexLock> guard(m_hash_indexes_lock);
+        for (size_t i = 0; i < m_hash_indexes.size(); i++)
+        {
+            if (m_hash_indexes[i].ns == ns && has_prefix(key, m_hash_indexes[i].prefix))
+            {
+                idxs.push_back(m_hash_indexes[i]);
+            }
+        }
+        return idxs.size();
+    }
+
+    bool Ardb::IsHashIndexField(const HashIndexArray& idxs, const std::string& field)
+    {
+        for (size_t i = 0; i < idxs.size(); i++)
+        {
+            if (std::find(idxs[i].fields.begin(), idxs[i].fields.end(), field) != idxs[i].fields.end())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Current value of a field of the hash 'meta'(packed or not), false if the field does not exist.
+     */
+    bool Ardb::GetHashIndexValue(Context& ctx, const KeyObject& meta_key, ValueObject& meta, const std::string& field, std::string& value)
+    {
+        if (meta.GetType() != KEY_HASH)
+        {
+            return false;
+        }
+        KeyObject field_key(meta_key.GetNameSpace(), KEY_HASH_FIELD, meta_key.GetKey());
+        field_key.SetObjectId(meta.GetObjectId());
+        field_key.SetHashField(field);
+        if (meta.IsPacked())
+        {
+            Data* packed_value = meta.GetPackedValue(field_key.GetHashField());
+            if (NULL == packed_value)
+            {
+                return false;
+            }
+            packed_value->ToString(value);
+            return true;
+        }
+        ValueObject field_value;
+        if (0 != m_engine->Get(ctx, field_key, field_value) || field_value.GetType() != KEY_HASH_FIELD)
+        {
+            return false;
+        }
+        field_value.GetHashValue().ToString(value);
+        return true;
+    }
+
+    /*
+     * Values of the indexed fields of a hash, read before it is written.
+     */
+    void Ardb::GetHashIndexValues(Context& ctx, const KeyObject& meta_key, ValueObject& meta, const HashIndexArray& idxs,
+            HashIndexValues& values)
+    {
+        values.clear();
+        for (size_t i = 0; i < idxs.size(); i++)
+        {
+            for (size_t j = 0; j < idxs[i].fields.size(); j++)
+            {
+                const std::string& field = idxs[i].fields[j];
+                std::string value;
+                if (values.find(field) == values.end() && GetHashIndexValue(ctx, meta_key, meta, field, value))
+                {
+                    values[field] = value;
+                }
+            }
+        }
+    }
+
+    /*
+     * Move the entry of field 'pos' of an index from the old value to the new one(NULL if the field does not exist
+     * before/after), must be called in the write batch of the hash write.
+     */
+    void Ardb::UpdateHashIndexEntry(Context& ctx, const HashIndex& idx, size_t pos, const std::string& key, const std::string* old_value,
+            const std::string* new_value)
+    {
+        if (NULL != old_value && NULL != new_value && *old_value == *new_value)
+        {
+            return;
+        }
+        KeyObject entry;
+        if (NULL != old_value && index_entry(idx, pos, key, *old_value, entry))
+        {
+            m_engine->Del(ctx, entry);
+        }
+        if (NULL != new_value && index_entry(idx, pos, key, *new_value, entry))
+        {
+            ValueObject v;
+            v.SetType(KEY_ZSET_SORT);
+            ctx.flags.create_if_notexist = 1;
+            m_engine->Put(ctx, entry, v);
+        }
+    }
+
+    void Ardb::UpdateHashIndexes(Context& ctx, const HashIndexArray& idxs, const std::string& key, const std::string& field,
+            const std::string* old_value, const std::string* new_value)
+    {
+        for (size_t i = 0; i < idxs.size(); i++)
+        {
+            for (size_t j = 0; j < idxs[i].fields.size(); j++)
+            {
+                if (idxs[i].fields[j] == field)
+                {
+                    UpdateHashIndexEntry(ctx, idxs[i], j, key, old_value, new_value);
+                }
+            }
+        }
+    }
+
+    /*
+     * Update the entries of all the indexed fields from 'old_values' to 'new_values'.
+     */
+    void Ardb::UpdateHashIndexes(Context& ctx, const HashIndexArray& idxs, const std::string& key, const HashIndexValues& old_values,
+            const HashIndexValues& new_values)
+    {
+        for (size_t i = 0; i < idxs.size(); i++)
+        {
+            for (size_t j = 0; j < idxs[i].fields.size(); j++)
+            {
+                HashIndexValues::const_iterator oit = old_values.find(idxs[i].fields[j]);
+                HashIndexValues::const_iterator nit = new_values.find(idxs[i].fields[j]);
+                UpdateHashIndexEntry(ctx, idxs[i], j, key, oit == old_values.end() ? NULL : &(oit->second),
+                        nit == new_values.end() ? NULL : &(nit->second));
+            }
+        }
+    }
+
+    /*
+     * Drop the entries of a hash deleted as a whole, must be called in the write batch of the deletion.
+     */
+    void Ardb::RemoveHashIndexes(Context& ctx, const KeyObject& meta_key, ValueObject& meta)
+    {
+        HashIndexArray idxs;
+        if (meta.GetType() != KEY_HASH || 0 == GetHashIndexes(ctx, meta_key.GetKey().AsString(), idxs))
+        {
+            return;
+        }
+        HashIndexValues old_values, new_values;
+        GetHashIndexValues(ctx, meta_key, meta, idxs, old_values);
+        UpdateHashIndexes(ctx, idxs, meta_key.GetKey().AsString(), old_values, new_values);
+    }
+
+    void Ardb::ClearHashIndexEntries(Context& ctx, const HashIndex& idx)
+    {
+        for (size_t i = 0; i < idx.fields.size(); i++)
+        {
+            KeyObject start = index_entry_key(idx, i);
+            if (m_engine->GetFeatureSet().support_delete_range)
+            {
+                KeyObject end = start;
+                end.SetType(KEY_ZSET_SORT + 1);
+                if (0 == m_engine->DelRange(ctx, start, end))
+                {
+                    continue;
+                }
+            }
+            Iterator* iter = m_engine->Find(ctx, start);
+            while (NULL != iter && iter->Valid())
+            {
+                KeyObject& k = iter->Key();
+                if (k.GetType() != KEY_ZSET_SORT || k.GetNameSpace() != start.GetNameSpace() || k.GetKey() != start.GetKey())
+                {
+                    break;
+                }
+                iter->Del();
+                iter->Next();
+            }
+            DELETE(iter);
+        }
+    }
+
+    /*
+     * Drop the entries of the indexes of a flushed db, their definitions are kept.
+     */
+    void Ardb::FlushHashIndexes(Context& ctx, const Data& ns)
+    {
+        HashIndexArray idxs;
+        {
+            LockGuard<SpinMutexLock> guard(m_hash_indexes_lock);
+            for (size_t i = 0; i < m_hash_indexes.size(); i++)
+            {
+                if (m_hash_indexes[i].ns == ns.AsString())
+                {
+                    idxs.push_back(m_hash_indexes[i]);
+                }
+            }
+        }
+        for (size_t i = 0; i < idxs.size(); i++)
+        {
+            ClearHashIndexEntries(ctx, idxs[i]);
+        }
+    }
+
+    /*
+     * Index the existing hashes of a new index, the keys of the prefix are contiguous unless they are ordered by
+     * hash slot first(key codec 3), the whole db is scanned then. The hashes are not locked, the index is published
+     * before, so a concurrent write moves the entry itself & at worst a stale entry is left.
+     */
+    int64 Ardb::BackfillHashIndex(Context& ctx, const HashIndex& idx)
+    {
+        bool contiguous = get_key_codec_version() != KEY_CODEC_V3;
+        KeyObject start(ctx.ns, KEY_META, contiguous ? idx.prefix : "");
+        HashIndexArray idxs(1, idx);
+        int64 indexed = 0;
+        size_t batch_keys = 0;
+        ctx.flags.iterate_multi_keys = 1;
+        ctx.flags.iterate_total_order = 1;
+        Iterator* iter = m_engine->Find(ctx, start);
+        while (iter->Valid())
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            for (batch_keys = 0; iter->Valid() && batch_keys < kIndexBackfillBatch;)
+            {
+                KeyObject& k = iter->Key();
+                if (k.GetNameSpace() != ctx.ns)
+                {
+                    break;
+                }
+                if (k.GetType() != KEY_META)
+                {
+                    iter->Next();
+                    continue;
+                }
+                std::string keystr = k.GetKey().AsString();
+                if (!has_prefix(keystr, idx.prefix))
+                {
+                    if (contiguous)
+                    {
+                        break;
+                    }
+                    iter->Next();
+                    continue;
+                }
+                KeyObject meta_key(ctx.ns, KEY_META, keystr);
+                ValueObject& meta = iter->Value();
+                if (meta.GetType() == KEY_HASH)
+                {
+                    HashIndexValues old_values, new_values;
+                    GetHashIndexValues(ctx, meta_key, meta, idxs, new_values);
+                    UpdateHashIndexes(ctx, idxs, keystr, old_values, new_values);
+                    indexed++;
+                    batch_keys++;
+                }
+                /*
+                 * skip the elements of the object
+                 */
+                KeyObject next(ctx.ns, KEY_END, keystr);
+                iter->Jump(next);
+            }
+            if (batch_keys < kIndexBackfillBatch)
+            {
+                break;
+            }
+        }
+        DELETE(iter);
+        return indexed;
+    }
+
+    static Ardb::HashIndexArray::iterator find_hash_index(Ardb::HashIndexArray& idxs, const std::string& ns, const std::string& name)
+    {
+        for (Ardb::HashIndexArray::iterator it = idxs.begin(); it != idxs.end(); it++)
+        {
+            if (it->ns == ns && it->name == name)
+            {
+                return it;
+            }
+        }
+        return idxs.end();
+    }
+
+    /*
+     * IDX.CREATE index PREFIX prefix SCHEMA field NUMERIC|TAG [field NUMERIC|TAG ...]
+     */
+    int Ardb::IndexCreate(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        HashIndex idx;
+        idx.ns = ctx.ns.AsString();
+        idx.name = args[0];
+        if (strcasecmp(args[1].c_str(), "prefix") || strcasecmp(args[3].c_str(), "schema") || (args.size() - 4) % 2 != 0)
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
+        idx.prefix = args[2];
+        for (size_t i = 4; i < args.size(); i += 2)
+        {
+            uint8 type = 0;
+            if (!strcasecmp(args[i + 1].c_str(), "numeric"))
+            {
+                type = kIndexNumeric;
+            }
+            else if (!strcasecmp(args[i + 1].c_str(), "tag"))
+            {
+                type = kIndexTag;
+            }
+            if (0 == type || std::find(idx.fields.begin(), idx.fields.end(), args[i]) != idx.fields.end())
+            {
+                reply.SetErrorReason("ERR invalid index schema");
+                return 0;
+            }
+            idx.fields.push_back(args[i]);
+            idx.types.push_back(type);
+        }
+        KeyObject defs_key = index_defs_key();
+        KeyLockGuard guard(ctx, defs_key);
+        HashIndexArray idxs;
+        {
+            LockGuard<SpinMutexLock> lock(m_hash_indexes_lock);
+            idxs = m_hash_indexes;
+        }
+        if (find_hash_index(idxs, idx.ns, idx.name) != idxs.end())
+        {
+            reply.SetErrorReason("ERR index already exists");
+            return 0;
+        }
+        idxs.push_back(idx);
+        int err = SaveHashIndexes(ctx, idxs);
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+            return 0;
+        }
+        int64 indexed = BackfillHashIndex(ctx, idx);
+        INFO_LOG("Index:%s created on %lld hashes with prefix:%s", idx.name.c_str(), indexed, idx.prefix.c_str());
+        reply.SetStatusCode(STATUS_OK);
+        return 0;
+    }
+
+    int Ardb::IndexDrop(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject defs_key = index_defs_key();
+        KeyLockGuard guard(ctx, defs_key);
+        HashIndexArray idxs;
+        {
+            LockGuard<SpinMutexLock> lock(m_hash_indexes_lock);
+            idxs = m_hash_indexes;
+        }
+        HashIndexArray::iterator found = find_hash_index(idxs, ctx.ns.AsString(), cmd.GetArguments()[0]);
+        if (found == idxs.end())
+        {
+            reply.SetInteger(0);
+            return 0;
+        }
+        HashIndex idx = *found;
+        idxs.erase(found);
+        int err = SaveHashIndexes(ctx, idxs);
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+            return 0;
+        }
+        ClearHashIndexEntries(ctx, idx);
+        reply.SetInteger(1);
+        return 0;
+    }
+
+    int Ardb::IndexList(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        std::string ns = ctx.ns.AsString();
+        reply.ReserveMember(0);
+        LockGuard<SpinMutexLock> guard(m_hash_indexes_lock);
+        for (size_t i = 0; i < m_hash_indexes.size(); i++)
+        {
+            const HashIndex& idx = m_hash_indexes[i];
+            if (idx.ns != ns)
+            {
+                continue;
+            }
+            RedisReply& r = reply.AddMember();
+            r.ReserveMember(0);
+            r.AddMember().SetString(idx.name);
+            r.AddMember().SetString(idx.prefix);
+            for (size_t j = 0; j < idx.fields.size(); j++)
+            {
+                r.AddMember().SetString(idx.fields[j]);
+                r.AddMember().SetString(std::string(idx.types[j] == kIndexNumeric ? "NUMERIC" : "TAG"));
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * IDX.RANGE index field min max [LIMIT offset count] [RETURN n field ...]
+     *
+     * min & max are scores(ZRANGEBYSCORE syntax) for NUMERIC fields & values(ZRANGEBYLEX syntax) for TAG fields.
+     * Replies the hash keys in value order, or key & field/value pairs of the RETURN fields of each hash.
+     */
+    int Ardb::IndexRange(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        int64 limit_offset = 0, limit_count = -1;
+        StringArray return_fields;
+        bool with_return = false;
+        for (size_t i = 4; i < args.size(); i++)
+        {
+            if (!strcasecmp(args[i].c_str(), "limit") && i + 2 < args.size())
+            {
+                if (!string_toint64(args[i + 1], limit_offset) || !string_toint64(args[i + 2], limit_count))
+                {
+                    reply.SetErrCode(ERR_INVALID_INTEGER_ARGS);
+                    return 0;
+                }
+                i += 2;
+            }
+            else if (!strcasecmp(args[i].c_str(), "return") && i + 1 < args.size())
+            {
+                int64 n = 0;
+                if (!string_toint64(args[i + 1], n) || n < 0 || i + 1 + n >= args.size())
+                {
+                    reply.SetErrCode(ERR_INVALID_SYNTAX);
+                    return 0;
+                }
+                return_fields.assign(args.begin() + i + 2, args.begin() + i + 2 + n);
+                with_return = true;
+                i += 1 + n;
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        HashIndex idx;
+        {
+            LockGuard<SpinMutexLock> guard(m_hash_indexes_lock);
+            HashIndexArray::iterator found = find_hash_index(m_hash_indexes, ctx.ns.AsString(), args[0]);
+            if (found == m_hash_indexes.end())
+            {
+                reply.SetErrorReason("ERR no such index");
+                return 0;
+            }
+            idx = *found;
+        }
+        size_t pos = std::find(idx.fields.begin(), idx.fields.end(), args[1]) - idx.fields.begin();
+        if (pos == idx.fields.size())
+        {
+            reply.SetErrorReason("ERR field is not indexed");
+            return 0;
+        }
+        bool numeric = idx.types[pos] == kIndexNumeric;
+        ZRangeSpec score_range;
+        ZLexRangeSpec lex_range;
+        if (numeric ? !score_range.Parse(args[2], args[3]) : !lex_range.Parse(args[2], args[3]))
+        {
+            reply.SetErrorReason(numeric ? "min or max is not a float" : "min or max is not valid");
+            return 0;
+        }
+        reply.ReserveMember(0);
+        KeyObject entry_key = index_entry_key(idx, pos);
+        if (numeric)
+        {
+            entry_key.SetZSetScore(score_range.min.GetFloat64());
+        }
+        else
+        {
+            entry_key.SetZSetScore(0);
+            entry_key.SetZSetMember(lex_range.min);
+        }
+        int64 now = get_current_epoch_millis();
+        int64 cursor = 0, count = 0;
+        Iterator* iter = m_engine->Find(ctx, entry_key);
+        while (iter->Valid() && (limit_count < 0 || count < limit_count))
+        {
+            KeyObject& entry = iter->Key();
+            if (entry.GetType() != KEY_ZSET_SORT || entry.GetNameSpace() != entry_key.GetNameSpace() || entry.GetKey() != entry_key.GetKey())
+            {
+                break;
+            }
+            std::string member, key, value;
+            entry.GetZSetMember().ToString(member);
+            int inrange = 0;
+            if (numeric)
+            {
+                key = member;
+                inrange = score_range.InRange(entry.GetZSetScore());
+            }
+            else
+            {
+                size_t sep = member.find('\0');
+                value = member.substr(0, sep);
+                key = sep == std::string::npos ? "" : member.substr(sep + 1);
+                inrange = lex_range.InRange(value);
+            }
+            if (inrange > 0)
+            {
+                break;
+            }
+            if (inrange < 0)
+            {
+                iter->Next();
+                continue;
+            }
+            /*
+             * check the entry against the current value of the field
+             */
+            KeyObject meta_key(ctx.ns, KEY_META, key);
+            ValueObject meta;
+            std::string current;
+            double score = 0;
+            bool valid = 0 == m_engine->Get(ctx, meta_key, meta) && (meta.GetTTL() <= 0 || meta.GetTTL() >= now)
+                    && GetHashIndexValue(ctx, meta_key, meta, idx.fields[pos], current);
+            if (valid)
+            {
+                valid = numeric ? (string_todouble(current, score) && score == entry.GetZSetScore()) : current == value;
+            }
+            if (valid && cursor++ >= limit_offset)
+            {
+                reply.AddMember().SetString(key);
+                if (with_return)
+                {
+                    RedisReply& fields = reply.AddMember();
+                    fields.ReserveMember(0);
+                    for (size_t i = 0; i < return_fields.size(); i++)
+                    {
+                        if (GetHashIndexValue(ctx, meta_key, meta, return_fields[i], current))
+                        {
+                            fields.AddMember().SetString(return_fields[i]);
+                            fields.AddMember().SetString(current);
+                        }
+                    }
+                }
+                count++;
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        return 0;
+    }
+OP_NAMESPACE_END
@@ -30,6 +30,9 @@
 #include "db/db.hpp"
 #include <float.h>
 #include <cmath>
+#include <algorithm>
+#include <sys/socket.h>
+#include "util/atomic.hpp"
 
 OP_NAMESPACE_BEGIN
 
@@ -81,6 +84,7 @@ OP_NAMESPACE_BEGIN
         }
         else
         {
+            AddListCompactKey(ctx.ns, k.GetKey());
             KeyObject key(ctx.ns, KEY_LIST_ELEMENT, k.GetKey());
             key.SetListIndex(v.GetMin());
             Iterator* iter = m_engine->Find(ctx, key);
@@ -341,6 +345,7 @@ OP_NAMESPACE_BEGIN
             else
             {
                 reply.SetInteger(meta.GetObjectLen());
+                AddListCompactKey(ctx.ns, key.GetKey());
             }
         }
         return 0;
@@ -367,6 +372,34 @@ OP_NAMESPACE_BEGIN
                 reply.SetInteger(0);
                 return 0;
             }
+            /*
+             * a new list pushed by a client hands its elements to the clients blocked on it first
+             */
+            std::deque<std::string> rest;
+            std::vector<bool> handoff_lpops;
+            const ArgumentArray* elements = &(cmd.GetArguments());
+            size_t first = 1;
+            if (meta.GetType() == 0 && lock_key && m_blocked_clients > 0 && NULL != ctx.client && !ctx.flags.lua && !ctx.flags.no_wal
+                    && GetConf().master_host.empty())
+            {
+                for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+                {
+                    if (left_push)
+                    {
+                        rest.push_front(cmd.GetArguments()[i]);
+                    }
+                    else
+                    {
+                        rest.push_back(cmd.GetArguments()[i]);
+                    }
+                }
+                if (HandoffListElements(ctx, keystr, rest, handoff_lpops) > 0)
+                {
+                    elements = &rest;
+                    first = 0;
+                    left_push = false;
+                }
+            }
             if (meta.GetType() == 0)
             {
                 meta.SetType(KEY_LIST);
@@ -375,14 +408,15 @@ OP_NAMESPACE_BEGIN
                 meta.SetListMinIdx(0);
                 meta.GetMetaObject().list_sequential = true;
             }
+            if (first < elements->size())
             {
                 WriteBatchGuard batch(ctx, m_engine);
-                for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+                for (size_t i = first; i < elements->size(); i++)
                 {
                     KeyObject ele(ctx.ns, KEY_LIST_ELEMENT, keystr);
                     ValueObject ele_value;
                     ele_value.SetType(KEY_LIST_ELEMENT);
-                    ele_value.SetListElement(cmd.GetArguments()[i]);
+                    ele_value.SetListElement(elements->at(i));
                     int64 idx = 0;
                     if (meta.GetObjectLen() > 0)
                     {
@@ -419,6 +453,22 @@ OP_NAMESPACE_BEGIN
                 SetKeyValue(ctx, key, meta);
             }
             err = ctx.transc_err;
+            if (!handoff_lpops.empty())
+            {
+                /*
+                 * replicate the push & the pops of the served clients here under the key lock, in their order
+                 */
+                FeedReplicationBacklog(ctx, ctx.ns, cmd);
+                for (size_t i = 0; i < handoff_lpops.size(); i++)
+                {
+                    RedisCommandFrame list_pop(handoff_lpops[i] ? "lpop" : "rpop");
+                    list_pop.SetType(handoff_lpops[i] ? REDIS_CMD_LPOP : REDIS_CMD_RPOP);
+                    list_pop.AddArg(keystr);
+                    FeedReplicationBacklog(ctx, ctx.ns, list_pop);
+                }
+                ctx.dirty = 0;
+                meta.SetObjectLen(meta.GetObjectLen() + handoff_lpops.size());
+            }
         }
         if (err != 0)
         {
@@ -432,6 +482,108 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
+    /*
+     * Renumber a non-sequential list into consecutive integer indexes right below its current head,
+     * so that the new element keys never collide with the old ones. The new keys are written first,
+     * then the meta is switched over and the old keys are dropped, each step in bounded batches.
+     * Returns the number of renumbered elements.
+     */
+    static const int64 kListCompactBatchSize = 1024;
+    int Ardb::ListCompact(Context& ctx, const KeyObject& key)
+    {
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        int err = m_engine->Get(ctx, key, meta);
+        if (ERR_ENTRY_NOT_EXIST == err)
+        {
+            return 0;
+        }
+        if (0 != err)
+        {
+            return err;
+        }
+        if (meta.GetType() != KEY_LIST || meta.GetMetaObject().list_sequential)
+        {
+            return 0;
+        }
+        Data old_min = meta.GetMin();
+        int64_t new_min = (int64_t) std::floor(old_min.GetFloat64()) - meta.GetObjectLen();
+        KeyObject ele_key(key.GetNameSpace(), KEY_LIST_ELEMENT, key.GetKey());
+        ele_key.SetListIndex(old_min);
+        Iterator* iter = m_engine->Find(ctx, ele_key);
+        int64_t moved = 0;
+        bool more = true;
+        while (more && 0 == ctx.transc_err)
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            for (int64 i = 0; i < kListCompactBatchSize; i++)
+            {
+                if (NULL == iter || !iter->Valid())
+                {
+                    more = false;
+                    break;
+                }
+                KeyObject& field = iter->Key();
+                if (field.GetType() != KEY_LIST_ELEMENT || field.GetNameSpace() != ele_key.GetNameSpace() || field.GetKey() != ele_key.GetKey())
+                {
+                    more = false;
+                    break;
+                }
+                KeyObject renumbered(key.GetNameSpace(), KEY_LIST_ELEMENT, key.GetKey());
+                renumbered.SetListIndex(new_min + moved);
+                m_engine->Put(ctx, renumbered, iter->Value());
+                moved++;
+                iter->Next();
+            }
+        }
+        DELETE(iter);
+        if (0 != ctx.transc_err)
+        {
+            return ctx.transc_err;
+        }
+        if (0 == moved)
+        {
+            return m_engine->Del(ctx, key);
+        }
+        meta.SetObjectLen(moved);
+        meta.SetListMinIdx(new_min);
+        meta.SetListMaxIdx(new_min + moved - 1);
+        meta.GetMetaObject().list_sequential = true;
+        err = m_engine->Put(ctx, key, meta);
+        if (0 != err)
+        {
+            return err;
+        }
+        /*
+         * the old keys are all above the new tail now, sequential access never reaches them
+         */
+        ele_key.SetListIndex(old_min);
+        iter = m_engine->Find(ctx, ele_key);
+        more = true;
+        while (more && 0 == ctx.transc_err)
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            for (int64 i = 0; i < kListCompactBatchSize; i++)
+            {
+                if (NULL == iter || !iter->Valid())
+                {
+                    more = false;
+                    break;
+                }
+                KeyObject& field = iter->Key();
+                if (field.GetType() != KEY_LIST_ELEMENT || field.GetNameSpace() != ele_key.GetNameSpace() || field.GetKey() != ele_key.GetKey())
+                {
+                    more = false;
+                    break;
+                }
+                m_engine->Del(ctx, field);
+                iter->Next();
+            }
+        }
+        DELETE(iter);
+        return 0 == ctx.transc_err ? moved : ctx.transc_err;
+    }
+
     int Ardb::LPush(Context& ctx, RedisCommandFrame& cmd)
     {
         return ListPush(ctx, cmd);
@@ -485,11 +637,15 @@ OP_NAMESPACE_BEGIN
         }
         else
         {
+            AddListCompactKey(ctx.ns, key.GetKey());
             ele_key.SetListIndex(meta.GetMin());
             cursor = 0;
         }
-        ctx.flags.iterate_no_upperbound = 1;
-        Iterator* iter = m_engine->Find(ctx, ele_key);
+        IterateOptions iter_opts;
+        iter_opts.prefix_only = true;
+        CheckStreamIterate(rangelen, iter_opts);
+        bool streaming = BeginStreamReply(ctx, reply, rangelen);
+        Iterator* iter = m_engine->Find(ctx, ele_key, iter_opts);
         while (NULL != iter && iter->Valid())
         {
             KeyObject& field = iter->Key();
@@ -501,6 +657,10 @@ OP_NAMESPACE_BEGIN
             {
                 RedisReply& r = reply.AddMember();
                 r.SetString(iter->Value().GetListElement());
+                if (streaming)
+                {
+                    StreamReplyMembers(ctx, reply);
+                }
             }
             if (cursor == end)
             {
@@ -595,7 +755,10 @@ OP_NAMESPACE_BEGIN
                 }
             }
             DELETE(iter);
-            meta.GetMetaObject().list_sequential = false;
+            if (removed > 0)
+            {
+                meta.GetMetaObject().list_sequential = false;
+            }
             meta.SetObjectLen(meta.GetObjectLen() - removed);
             if (meta.GetObjectLen() == 0)
             {
@@ -613,6 +776,10 @@ OP_NAMESPACE_BEGIN
         else
         {
             reply.SetInteger(removed);
+            if (removed > 0 && meta.GetObjectLen() > 0)
+            {
+                AddListCompactKey(ctx.ns, key.GetKey());
+            }
         }
         return 0;
     }
@@ -666,6 +833,7 @@ OP_NAMESPACE_BEGIN
         }
         else
         {
+            AddListCompactKey(ctx.ns, k.GetKey());
             KeyObject key(ctx.ns, KEY_LIST_ELEMENT, cmd.GetArguments()[0]);
             key.SetListIndex(v.GetMin());
             Iterator* iter = m_engine->Find(ctx, key);
@@ -949,6 +1117,7 @@ OP_NAMESPACE_BEGIN
         RPopLPush(ctx, cmd);
         if (reply.IsNil())
         {
+            reply.type = 0; //wait
             StringArray list_keys(1, cmd.GetArguments()[0]);
             BlockForKeys(ctx, list_keys, cmd.GetArguments()[1], timeout);
         }
@@ -976,20 +1145,34 @@ OP_NAMESPACE_BEGIN
             ctx.client->client->GetService().AsyncIO(ctx.client->client->GetID(), AsyncUnblockKeysCallback, &ctx);
             return 0;
         }
-        LockGuard<SpinMutexLock> guard(m_block_keys_lock, true);
-        if (ctx.bpop != NULL && !m_blocked_ctxs.empty())
+        if (ctx.bpop != NULL)
         {
             BlockingState::BlockKeySet::iterator it = ctx.GetBPop().keys.begin();
             while (it != ctx.GetBPop().keys.end())
             {
                 const KeyPrefix& prefix = *it;
-                m_blocked_ctxs[prefix].erase(&ctx);
-                if (m_blocked_ctxs[prefix].size() == 0)
+                BlockShard& shard = GetBlockShard(prefix);
+                LockGuard<SpinMutexLock> guard(shard.lock);
+                BlockedContextTable::iterator found = shard.waiters.find(prefix);
+                if (found != shard.waiters.end())
                 {
-                    m_blocked_ctxs.erase(prefix);
+                    BlockedContextQueue& queue = found->second;
+                    BlockedContextQueue::iterator qit = std::find(queue.begin(), queue.end(), &ctx);
+                    if (qit != queue.end())
+                    {
+                        queue.erase(qit);
+                    }
+                    if (queue.empty())
+                    {
+                        shard.waiters.erase(found);
+                    }
                 }
                 it++;
             }
+            if (!ctx.GetBPop().keys.empty())
+            {
+                atomic_sub_uint32(&m_blocked_clients, 1);
+            }
             ctx.ClearBPop();
         }
         ctx.client->client->UnblockRead();
@@ -1012,14 +1195,30 @@ OP_NAMESPACE_BEGIN
             ctx.GetBPop().timeout = (uint64) timeout * 1000 * 1000 + get_current_epoch_micros();
         }
         ctx.client->client->BlockRead();
-        LockGuard<SpinMutexLock> guard(m_block_keys_lock);
         for (size_t i = 0; i < keys.size(); i++)
         {
             KeyPrefix prefix;
             prefix.ns = ctx.ns;
             prefix.key.SetString(keys[i], false);
-            ctx.GetBPop().keys.insert(prefix);
-            m_blocked_ctxs[prefix].insert(&ctx);
+            if (!ctx.GetBPop().keys.insert(prefix).second)
+            {
+                continue;
+            }
+            BlockShard& shard = GetBlockShard(prefix);
+            LockGuard<SpinMutexLock> guard(shard.lock);
+            shard.waiters[prefix].push_back(&ctx);
+        }
+        if (!ctx.GetBPop().keys.empty())
+        {
+            atomic_add_uint32(&m_blocked_clients, 1);
+        }
+        /*
+         * an element pushed after the lists were found empty & before the client was queued would never wake it,
+         * check the lists once more after the current command
+         */
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            SignalListAsReady(ctx, keys[i]);
         }
         return 0;
     }
@@ -1030,14 +1229,17 @@ OP_NAMESPACE_BEGIN
         {
             FATAL_LOG("Can not modify block dataset when key locked.");
         }
-        LockGuard<SpinMutexLock> guard(m_block_keys_lock);
-        KeyPrefix prefix;
-        prefix.ns = ctx.ns;
-        prefix.key.SetString(key, false);
-        if (m_blocked_ctxs.find(prefix) == m_blocked_ctxs.end())
+        /*
+         * the waiters are looked up by WakeClientsBlockingOnList, this may be called with a block shard locked
+         */
+        if (0 == m_blocked_clients)
         {
             return -1;
         }
+        KeyPrefix prefix;
+        prefix.ns = ctx.ns;
+        prefix.key.SetString(key, false);
+        LockGuard<SpinMutexLock> guard(m_ready_keys_lock);
         if (NULL == m_ready_keys)
         {
             NEW(m_ready_keys, ReadyKeySet);
@@ -1046,39 +1248,169 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
-    int Ardb::ServeClientBlockedOnList(Context& ctx, const KeyPrefix& key, const std::string& value)
+    /*
+     * Pop the first client waiting on the key which is not served yet & mark it served, the caller holds the shard lock.
+     * With 'plain_pop_only' a BRPOPLPUSH client at the head of the queue is left there & NULL returned.
+     */
+    Context* Ardb::ClaimBlockedClient(BlockShard& shard, const KeyPrefix& key, bool plain_pop_only)
     {
-        if (ctx.GetBPop().target.IsNil())
+        BlockedContextTable::iterator found = shard.waiters.find(key);
+        if (found == shard.waiters.end())
         {
-            RedisReply* r = NULL;
-            NEW(r, RedisReply);
-            RedisReply& r1 = r->AddMember();
-            RedisReply& r2 = r->AddMember();
-            r1.SetString(key.key);
-            r2.SetString(value);
-            WriteReply(ctx, r, true);
+            return NULL;
+        }
+        BlockedContextQueue& queue = found->second;
+        Context* client = NULL;
+        while (!queue.empty())
+        {
+            Context* head = queue.front();
+            if (plain_pop_only && !head->GetBPop().target.IsNil())
+            {
+                break;
+            }
+            queue.pop_front();
+            /*
+             * a client blocked on several keys may be served by another one, or timed out already
+             */
+            if (atomic_cmp_set_uint32(&head->GetBPop().served, 0, 1))
+            {
+                client = head;
+                break;
+            }
+        }
+        if (queue.empty())
+        {
+            shard.waiters.erase(found);
+        }
+        return client;
+    }
+
+    struct BlockedPopResult
+    {
+            Context* client;
+            KeyPrefix key;
+            std::string value;
+            bool lpop;
+    };
+
+    /*
+     * Reads of a blocked client are paused, a peer closed meanwhile is only noticed by peeking the socket.
+     */
+    static bool blocked_peer_closed(Channel* ch)
+    {
+        char c;
+        return ::recv(ch->GetReadFD(), &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0;
+    }
+
+    /*
+     * Runs in the thread of the served client, the client is only touched if its connection is still alive. Otherwise
+     * the element is pushed back where it was popped from.
+     */
+    void Ardb::AsyncBlockedPopCallback(Channel* ch, void * data)
+    {
+        BlockedPopResult* result = (BlockedPopResult*) data;
+        bool alive = NULL != ch && !ch->IsClosed();
+        if (alive && blocked_peer_closed(ch))
+        {
+            ch->Close();
+            alive = false;
+        }
+        if (alive)
+        {
+            RedisReply r;
+            r.AddMember().SetString(result->key.key);
+            r.AddMember().SetString(result->value);
+            ch->Write(r);
+            g_db->UnblockKeys(*(result->client), true);
         }
         else
         {
-            RedisCommandFrame lpush;
-            lpush.SetCommand("lpush");
-            lpush.SetType(REDIS_CMD_LPUSH);
-            lpush.AddArg(ctx.GetBPop().target.key.AsString());
-            lpush.AddArg(value);
+            RedisCommandFrame repush(result->lpop ? "lpush" : "rpush");
+            repush.SetType(result->lpop ? REDIS_CMD_LPUSH : REDIS_CMD_RPUSH);
+            repush.AddArg(result->key.key.AsString());
+            repush.AddArg(result->value);
             Context tmpctx;
-            tmpctx.ns = ctx.GetBPop().target.ns;
-            ListPush(tmpctx, lpush, false);
-            if (tmpctx.GetReply().IsErr())
+            tmpctx.ns = result->key.ns;
+            g_db->ListPush(tmpctx, repush, true);
+            if (!tmpctx.GetReply().IsErr() && g_db->GetConf().master_host.empty())
+            {
+                g_db->FeedReplicationBacklog(tmpctx, tmpctx.ns, repush);
+            }
+            g_db->WakeClientsBlockingOnList(tmpctx);
+        }
+        DELETE(result);
+    }
+
+    void Ardb::PostBlockedPopResult(Context& client, const KeyPrefix& key, const std::string& value, bool lpop)
+    {
+        BlockedPopResult* result = NULL;
+        NEW(result, BlockedPopResult);
+        result->client = &client;
+        result->key.ns.Clone(key.ns);
+        result->key.key.Clone(key.key);
+        result->value = value;
+        result->lpop = lpop;
+        Channel* ch = client.client->client;
+        ch->GetService().AsyncIO(ch->GetID(), AsyncBlockedPopCallback, result);
+    }
+
+    /*
+     * Elements pushed into a new list are handed to the clients blocked on it directly, in FIFO order & each from the end
+     * it pops, without being written to the engine. 'elements' is the list to be, the remaining elements are left in it.
+     * Stop at the first BRPOPLPUSH client, which is served after the command like before.
+     */
+    size_t Ardb::HandoffListElements(Context& ctx, const std::string& key, std::deque<std::string>& elements, std::vector<bool>& lpops)
+    {
+        KeyPrefix prefix;
+        prefix.ns = ctx.ns;
+        prefix.key.SetString(key, false);
+        BlockShard& shard = GetBlockShard(prefix);
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        size_t served = 0;
+        while (!elements.empty())
+        {
+            Context* client = ClaimBlockedClient(shard, prefix, true);
+            if (NULL == client)
+            {
+                break;
+            }
+            bool lpop = client->last_cmdtype == REDIS_CMD_BLPOP;
+            if (lpop)
             {
-                return -1;
+                PostBlockedPopResult(*client, prefix, elements.front(), true);
+                elements.pop_front();
             }
             else
             {
-                RedisReply* r = NULL;
-                NEW(r, RedisReply);
-                r->SetString(value);
-                WriteReply(ctx, r, true);
+                PostBlockedPopResult(*client, prefix, elements.back(), false);
+                elements.pop_back();
             }
+            lpops.push_back(lpop);
+            served++;
+        }
+        return served;
+    }
+
+    int Ardb::ServeClientBlockedOnList(Context& ctx, const KeyPrefix& key, const std::string& value)
+    {
+        RedisCommandFrame lpush;
+        lpush.SetCommand("lpush");
+        lpush.SetType(REDIS_CMD_LPUSH);
+        lpush.AddArg(ctx.GetBPop().target.key.AsString());
+        lpush.AddArg(value);
+        Context tmpctx;
+        tmpctx.ns = ctx.GetBPop().target.ns;
+        ListPush(tmpctx, lpush, false);
+        if (tmpctx.GetReply().IsErr())
+        {
+            return -1;
+        }
+        else
+        {
+            RedisReply* r = NULL;
+            NEW(r, RedisReply);
+            r->SetString(value);
+            WriteReply(ctx, r, true);
         }
         return 0;
     }
@@ -1091,91 +1423,97 @@ OP_NAMESPACE_BEGIN
         }
         ReadyKeySet ready_keys;
         {
-            LockGuard<SpinMutexLock> guard(m_block_keys_lock);
+            LockGuard<SpinMutexLock> guard(m_ready_keys_lock);
             if (NULL == m_ready_keys)
             {
                 return 0;
             }
-            if (m_ready_keys->empty())
-            {
-                return 0;
-            }
-            ready_keys = *m_ready_keys;
+            ready_keys.swap(*m_ready_keys);
             DELETE(m_ready_keys);
         }
 
-        while (!ready_keys.empty())
+        ReadyKeySet::iterator kit = ready_keys.begin();
+        while (kit != ready_keys.end())
         {
-            ReadyKeySet::iterator head = ready_keys.begin();
-            KeyPrefix key = *head;
+            const KeyPrefix& key = *kit;
+            Context tmpctx;
+            tmpctx.ns = key.ns;
+            KeyObject list_key(key.ns, KEY_META, key.key);
+            KeyLockGuard keylocker(tmpctx, list_key);
+            BlockShard& shard = GetBlockShard(key);
+            LockGuard<SpinMutexLock> block_guard(shard.lock);
+            std::deque<Context*> stream_waiting;
+            while (true)
             {
-                LockGuard<SpinMutexLock> block_guard(m_block_keys_lock);
-                BlockedContextTable::iterator fit = m_blocked_ctxs.find(key);
-                if (fit != m_blocked_ctxs.end())
+                Context* unblock_client = ClaimBlockedClient(shard, key, false);
+                if (NULL == unblock_client)
                 {
-                    ContextSet::iterator cit = fit->second.begin();
-                    if (cit == fit->second.end())
-                    {
-                        break;
-                    }
-                    Context* unblock_client = *cit;
-                    RedisCommandFrame list_pop;
-                    if (unblock_client->last_cmdtype == REDIS_CMD_BLPOP)
+                    break;
+                }
+                /*
+                 * XREAD does not consume, every client waiting on the stream is served, those still waiting for
+                 * later ids are queued again at the head in the same order
+                 */
+                if (unblock_client->last_cmdtype == REDIS_CMD_XREAD)
+                {
+                    if (0 != ServeClientBlockedOnStream(*unblock_client, key))
                     {
-                        list_pop.SetCommand("lpop");
-                        list_pop.SetType(REDIS_CMD_LPOP);
+                        unblock_client->GetBPop().served = 0;
+                        stream_waiting.push_back(unblock_client);
                     }
                     else
                     {
-                        list_pop.SetCommand("rpop");
-                        list_pop.SetType(REDIS_CMD_RPOP);
+                        UnblockKeys(*unblock_client, false);
                     }
-                    list_pop.AddArg(key.key.AsString());
-                    Context tmpctx;
-                    tmpctx.ns = key.ns;
-                    {
-                        KeyObject list_key(key.ns, KEY_META, key.key);
-                        KeyLockGuard keylocker(tmpctx, list_key);
-                        ListPop(tmpctx, list_pop, false);
-                        if (tmpctx.GetReply().IsString())
-                        {
-                            if (0 != ServeClientBlockedOnList(*unblock_client, key, tmpctx.GetReply().GetString()))
-                            {
-                                /*
-                                 * repush value into old list
-                                 */
-                                std::string repush = tmpctx.GetReply().GetString();
-                                RedisCommandFrame list_push;
-                                if (unblock_client->last_cmdtype == REDIS_CMD_BLPOP)
-                                {
-                                    list_push.SetCommand("lpush");
-                                    list_push.SetType(REDIS_CMD_LPUSH);
-                                }
-                                else
-                                {
-                                    list_push.SetCommand("rpush");
-                                    list_push.SetType(REDIS_CMD_RPUSH);
-                                }
-                                list_push.AddArg(key.key.AsString());
-                                list_push.AddArg(repush);
-                                ListPush(tmpctx, list_push, false);
-                            }
-                            else
-                            {
-                                /*
-                                 * generate 'lpop/rpop' for replication in master
-                                 */
-                                if (GetConf().master_host.empty())
-                                {
-                                    FeedReplicationBacklog(tmpctx, key.ns, list_pop);
-                                }
-                            }
-                        }
-                    }
-                    UnblockKeys(*unblock_client, false);
+                    continue;
                 }
+                bool lpop = unblock_client->last_cmdtype == REDIS_CMD_BLPOP;
+                RedisCommandFrame list_pop(lpop ? "lpop" : "rpop");
+                list_pop.SetType(lpop ? REDIS_CMD_LPOP : REDIS_CMD_RPOP);
+                list_pop.AddArg(key.key.AsString());
+                tmpctx.GetReply().Clear();
+                ListPop(tmpctx, list_pop, false);
+                if (!tmpctx.GetReply().IsString())
+                {
+                    /*
+                     * nothing left to pop, the client keeps waiting at the head of the queue
+                     */
+                    unblock_client->GetBPop().served = 0;
+                    shard.waiters[key].push_front(unblock_client);
+                    break;
+                }
+                std::string value = tmpctx.GetReply().GetString();
+                /*
+                 * generate 'lpop/rpop' for replication in master
+                 */
+                if (GetConf().master_host.empty())
+                {
+                    FeedReplicationBacklog(tmpctx, key.ns, list_pop);
+                }
+                if (unblock_client->GetBPop().target.IsNil())
+                {
+                    PostBlockedPopResult(*unblock_client, key, value, lpop);
+                    continue;
+                }
+                if (0 != ServeClientBlockedOnList(*unblock_client, key, value))
+                {
+                    /*
+                     * repush value into old list
+                     */
+                    RedisCommandFrame list_push(lpop ? "lpush" : "rpush");
+                    list_push.SetType(lpop ? REDIS_CMD_LPUSH : REDIS_CMD_RPUSH);
+                    list_push.AddArg(key.key.AsString());
+                    list_push.AddArg(value);
+                    ListPush(tmpctx, list_push, false);
+                }
+                UnblockKeys(*unblock_client, false);
+            }
+            while (!stream_waiting.empty())
+            {
+                shard.waiters[key].push_front(stream_waiting.back());
+                stream_waiting.pop_back();
             }
-            ready_keys.erase(head);
+            kit++;
         }
         return 0;
     }
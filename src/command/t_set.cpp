@@ -28,9 +28,231 @@
  */
 #include "db/db.hpp"
 #include <float.h>
+#include <limits.h>
+#include <algorithm>
 
 OP_NAMESPACE_BEGIN
 
+    /*
+     * sets of more members are sampled by random seeks instead of being read as a whole
+     */
+    static const int64 kSetSampleMinLen = 128;
+
+    static uint64 random_uint64()
+    {
+        return ((uint64) random() << 33) ^ ((uint64) random() << 2) ^ (uint64) random();
+    }
+
+    /*
+     * Bytes the random part of a seek target is drawn from: the classes(digits, lower & upper case letters) of the bytes
+     * of 'lo' & 'hi' past their common prefix, plus any other byte found there. Members made of such an alphabet are
+     * sampled close to uniformly, instead of most targets falling in the gaps between the used bytes.
+     */
+    static void member_alphabet(const std::string& lo, const std::string& hi, size_t prefix, std::string& alphabet)
+    {
+        bool used[256] = { false };
+        const std::string* bounds[] = { &lo, &hi };
+        for (int b = 0; b < 2; b++)
+        {
+            for (size_t j = prefix; j < bounds[b]->size(); j++)
+            {
+                uint8 c = (uint8) (*bounds[b])[j];
+                uint8 first = c, last = c;
+                if (c >= '0' && c <= '9')
+                {
+                    first = '0';
+                    last = '9';
+                }
+                else if (c >= 'a' && c <= 'z')
+                {
+                    first = 'a';
+                    last = 'z';
+                }
+                else if (c >= 'A' && c <= 'Z')
+                {
+                    first = 'A';
+                    last = 'Z';
+                }
+                for (uint32 k = first; k <= last; k++)
+                {
+                    used[k] = true;
+                }
+            }
+        }
+        for (uint32 k = 0; k < 256; k++)
+        {
+            if (used[k])
+            {
+                alphabet.push_back((char) k);
+            }
+        }
+        if (alphabet.empty())
+        {
+            for (uint32 k = 0; k < 256; k++)
+            {
+                alphabet.push_back((char) k);
+            }
+        }
+    }
+
+    /*
+     * Random seek target between two members: the common prefix, a byte between the first differing ones & a random
+     * tail, all drawn from the alphabet of the members. Targets past either bound land on the first member or wrap to it.
+     */
+    static void random_member_between(const Data& min, const Data& max, Data& target)
+    {
+        if (min.IsInteger() && max.IsInteger())
+        {
+            int64 lo = min.GetInt64(), hi = max.GetInt64();
+            uint64 range = (uint64) hi - (uint64) lo;
+            target.SetInt64(range == UINT64_MAX ? (int64) random_uint64() : (int64) ((uint64) lo + random_uint64() % (range + 1)));
+            return;
+        }
+        std::string lo, hi;
+        if (!min.IsInteger())
+        {
+            min.ToString(lo);
+        }
+        max.ToString(hi);
+        if (max.IsInteger())
+        {
+            hi.clear();
+        }
+        size_t i = 0;
+        while (i < lo.size() && i < hi.size() && lo[i] == hi[i])
+        {
+            i++;
+        }
+        std::string point = hi.substr(0, i);
+        std::string alphabet;
+        member_alphabet(lo, hi, i, alphabet);
+        uint32 lo_byte = i < lo.size() ? (uint8) lo[i] : 0;
+        uint32 hi_byte = i < hi.size() ? (uint8) hi[i] : 255;
+        if (hi_byte < lo_byte)
+        {
+            hi_byte = lo_byte;
+        }
+        size_t first = 0, last = alphabet.size();
+        while (first < alphabet.size() && (uint8) alphabet[first] < lo_byte)
+        {
+            first++;
+        }
+        while (last > first && (uint8) alphabet[last - 1] > hi_byte)
+        {
+            last--;
+        }
+        if (last > first)
+        {
+            point.push_back(alphabet[first + random() % (last - first)]);
+        }
+        else
+        {
+            point.push_back((char) (lo_byte + random() % (hi_byte - lo_byte + 1)));
+        }
+        for (int j = 0; j < 4; j++)
+        {
+            point.push_back(alphabet[random() % alphabet.size()]);
+        }
+        target.SetString(point, false, true);
+    }
+
+    static bool at_set_member(Iterator* iter, const KeyObject& key)
+    {
+        if (!iter->Valid())
+        {
+            return false;
+        }
+        KeyObject& field = iter->Key(false);
+        return field.GetType() == KEY_SET_MEMBER && field.GetNameSpace() == key.GetNameSpace() && field.GetKey() == key.GetKey();
+    }
+
+    /*
+     * Moves 'iter' to a member of set 'key' found by seeking to a random point between the min & max members kept in
+     * the meta, O(log n) per member. Members following large gaps of the key space are picked more often, sets of well
+     * spread members(ids, hashes, uuids) are sampled close to uniformly.
+     */
+    static bool seek_random_member(Iterator* iter, const KeyObject& key, ValueObject& meta)
+    {
+        KeyObject target(key.GetNameSpace(), KEY_SET_MEMBER, key.GetKey());
+        if (!meta.GetMin().IsNil() && !meta.GetMax().IsNil())
+        {
+            Data point;
+            random_member_between(meta.GetMin(), meta.GetMax(), point);
+            target.SetSetMember(point);
+            iter->Jump(target);
+            if (at_set_member(iter, key))
+            {
+                return true;
+            }
+        }
+        /*
+         * past the last member, wrap to the first one
+         */
+        target.SetSetMember(meta.GetMin());
+        iter->Jump(target);
+        return at_set_member(iter, key);
+    }
+
+    /*
+     * Random member not in 'seen' yet, the iterator reads a snapshot & still sees members deleted through it. Steps
+     * forward from the seek target past seen members, wrapping once.
+     */
+    static bool seek_unseen_member(Iterator* iter, const KeyObject& key, ValueObject& meta, StringTreeSet& seen, std::string& member)
+    {
+        if (!seek_random_member(iter, key, meta))
+        {
+            return false;
+        }
+        bool wrapped = false;
+        while (true)
+        {
+            member.clear();
+            iter->Key(false).GetSetMember().ToString(member);
+            if (seen.count(member) == 0)
+            {
+                return true;
+            }
+            iter->Next();
+            if (!at_set_member(iter, key))
+            {
+                if (wrapped)
+                {
+                    return false;
+                }
+                wrapped = true;
+                KeyObject first(key.GetNameSpace(), KEY_SET_MEMBER, key.GetKey());
+                first.SetSetMember(meta.GetMin());
+                iter->Jump(first);
+                if (!at_set_member(iter, key))
+                {
+                    return false;
+                }
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Reads all members of a small set.
+     */
+    static void load_set_members(Engine* engine, Context& ctx, const KeyObject& key, DataArray& members)
+    {
+        KeyObject start(key.GetNameSpace(), KEY_SET_MEMBER, key.GetKey());
+        Iterator* iter = engine->Find(ctx, start);
+        while (NULL != iter && iter->Valid())
+        {
+            KeyObject& field = iter->Key(true);
+            if (field.GetType() != KEY_SET_MEMBER || field.GetNameSpace() != key.GetNameSpace() || field.GetKey() != key.GetKey())
+            {
+                break;
+            }
+            members.resize(members.size() + 1);
+            members.back().Clone(field.GetSetMember());
+            iter->Next();
+        }
+        DELETE(iter);
+    }
+
     int Ardb::SAdd(Context& ctx, RedisCommandFrame& cmd)
     {
         ctx.flags.create_if_notexist = 1;
@@ -53,6 +275,27 @@ OP_NAMESPACE_BEGIN
             meta.SetType(KEY_SET);
             meta.SetObjectLen(-1);
         }
+        /*
+         * members of an existing set are looked up by one MultiGet before writing
+         */
+        ErrCodeArray exist_errs;
+        if (redis_compatible && 0 != meta.GetType())
+        {
+            KeyObjectArray fields;
+            for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+            {
+                KeyObject field(ctx.ns, KEY_SET_MEMBER, keystr);
+                field.SetSetMember(cmd.GetArguments()[i]);
+                fields.push_back(field);
+            }
+            ValueObjectArray exist_values;
+            int err = m_engine->MultiGet(ctx, fields, exist_values, exist_errs);
+            if (0 != err)
+            {
+                reply.SetErrCode(err);
+                return 0;
+            }
+        }
         {
             bool meta_changed = false;
             WriteBatchGuard batch(ctx, m_engine);
@@ -65,7 +308,8 @@ OP_NAMESPACE_BEGIN
                 field.SetSetMember(data);
                 if (redis_compatible)
                 {
-                    if ((0 == meta.GetType() || !m_engine->Exists(ctx, field)) && added.count(data) == 0)
+                    bool exists = 0 != meta.GetType() && i - 1 < exist_errs.size() && 0 == exist_errs[i - 1];
+                    if (!exists && added.count(data) == 0)
                     {
                         SetKeyValue(ctx, field, empty);
                         if (meta.SetMinMaxData(field.GetSetMember()))
@@ -98,7 +342,19 @@ OP_NAMESPACE_BEGIN
             }
             if (meta_changed)
             {
-                SetKeyValue(ctx, key, meta);
+                if (!redis_compatible && m_engine->GetFeatureSet().support_merge)
+                {
+                    /*
+                     * blind merge keeps the length, ttl & min/max of an existing set instead of overwriting them
+                     */
+                    Data unknown_added;
+                    unknown_added.SetInt64(-1);
+                    MergeKeyValue(ctx, key, REDIS_CMD_SADD, DataArray(1, unknown_added));
+                }
+                else
+                {
+                    SetKeyValue(ctx, key, meta);
+                }
             }
         }
         if (0 != ctx.transc_err)
@@ -119,6 +375,33 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
+    /*
+     * Merge of 'added' new members into the set meta, -1 if the number is unknown, which makes the length unknown.
+     */
+    int Ardb::MergeSAdd(Context& ctx, const KeyObject& key, ValueObject& meta, int64 added)
+    {
+        if (meta.GetType() == 0)
+        {
+            meta.SetType(KEY_SET);
+            meta.SetObjectLen(added);
+            return 0;
+        }
+        if (meta.GetType() != KEY_SET)
+        {
+            return ERR_NOTPERFORMED;
+        }
+        if (meta.GetObjectLen() < 0)
+        {
+            return ERR_NOTPERFORMED;
+        }
+        if (0 == added)
+        {
+            return ERR_NOTPERFORMED;
+        }
+        meta.SetObjectLen(added < 0 ? -1 : meta.GetObjectLen() + added);
+        return 0;
+    }
+
     int Ardb::SCard(Context& ctx, RedisCommandFrame& cmd)
     {
         return ObjectLen(ctx, KEY_SET, cmd.GetArguments()[0]);
@@ -140,52 +423,40 @@ OP_NAMESPACE_BEGIN
         const std::string& keystr = cmd.GetArguments()[0];
         KeyObject key(ctx.ns, KEY_META, keystr);
         KeyLockGuard guard(ctx, key);
-        Iterator* iter = m_engine->Find(ctx, key);
-        bool checked_meta = false;
-        bool need_set_minmax = false;
-        ValueObject new_meta;
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_SET, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            return 0;
+        }
+        bool need_set_minmax = meta.GetMin().IsNil() && meta.GetMax().IsNil();
+        KeyObject member_key(ctx.ns, KEY_SET_MEMBER, keystr);
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(member_key);
+        CheckStreamIterate(meta.GetObjectLen(), iter_opts);
+        bool streaming = !need_set_minmax && BeginStreamReply(ctx, reply, meta.GetObjectLen());
+        Iterator* iter = m_engine->Find(ctx, member_key, iter_opts);
         while (NULL != iter && iter->Valid())
         {
             KeyObject& field = iter->Key();
-            if (!checked_meta)
-            {
-                if (field.GetType() == KEY_META && field.GetKey() == key.GetKey())
-                {
-                    ValueObject& meta = iter->Value();
-                    if (meta.GetType() != KEY_SET)
-                    {
-                        reply.SetErrCode(ERR_WRONG_TYPE);
-                        break;
-                    }
-                    checked_meta = true;
-                    if (meta.GetMin().IsNil() && meta.GetMax().IsNil())
-                    {
-                        need_set_minmax = true;
-                        new_meta = meta;
-                    }
-                    iter->Next();
-                    continue;
-                }
-                else
-                {
-                    break;
-                }
-            }
-            if (field.GetType() != KEY_SET_MEMBER || field.GetNameSpace() != key.GetNameSpace() || field.GetKey() != key.GetKey())
-            {
-                break;
-            }
             RedisReply& r = reply.AddMember();
             r.SetString(field.GetSetMember());
+            if (streaming)
+            {
+                StreamReplyMembers(ctx, reply);
+            }
             iter->Next();
         }
         DELETE(iter);
-        if (need_set_minmax)
+        if (need_set_minmax && !ctx.flags.snapshot_read && reply.MemberSize() > 0)
         {
-            new_meta.SetObjectLen(reply.MemberSize());
-            new_meta.GetMin().SetString(reply.MemberAt(0).str, true);
-            new_meta.GetMax().SetString(reply.MemberAt(reply.MemberSize() - 1).str, true);
-            SetKeyValue(ctx, key, new_meta);
+            meta.SetObjectLen(reply.MemberSize());
+            meta.GetMin().SetString(reply.MemberAt(0).str, true);
+            meta.GetMax().SetString(reply.MemberAt(reply.MemberSize() - 1).str, true);
+            SetKeyValue(ctx, key, meta);
         }
         return 0;
     }
@@ -307,6 +578,47 @@ OP_NAMESPACE_BEGIN
         }
         bool remove_key = false;
         KeyObject key(ctx.ns, KEY_SET_MEMBER, keystr);
+        int64 len = meta.GetObjectLen();
+        if ((len < 0 || (len > kSetSampleMinLen && count < len)) && !meta.GetMin().IsNil() && !meta.GetMax().IsNil())
+        {
+            /*
+             * large set: pop members at random seek points instead of the head of the set
+             */
+            Iterator* iter = m_engine->Find(ctx, key);
+            StringTreeSet popped;
+            std::string member;
+            while (NULL != iter && removed < count && seek_unseen_member(iter, key, meta, popped, member))
+            {
+                if (with_count)
+                {
+                    reply.AddMember().SetString(member);
+                }
+                else
+                {
+                    reply.SetString(member);
+                }
+                popped.insert(member);
+                IteratorDel(ctx, meta_key, iter);
+                removed++;
+                if (meta.GetObjectLen() > 0)
+                {
+                    meta.SetObjectLen(meta.GetObjectLen() - 1);
+                }
+            }
+            DELETE(iter);
+            if (removed < count || 0 == meta.GetObjectLen())
+            {
+                /*
+                 * no member left to pop
+                 */
+                RemoveKey(ctx, meta_key);
+            }
+            else
+            {
+                SetKeyValue(ctx, meta_key, meta);
+            }
+            return 0;
+        }
         key.SetSetMember(meta.GetMin());
         Iterator* iter = m_engine->Find(ctx, key);
         //bool ele_removed = false;
@@ -392,41 +704,67 @@ OP_NAMESPACE_BEGIN
 
         const std::string& keystr = cmd.GetArguments()[0];
         KeyObject key(ctx.ns, KEY_SET_MEMBER, keystr);
-        Iterator* iter = m_engine->Find(ctx, key);
-        while (NULL != iter && iter->Valid() && fetched < std::abs(count))
+        int64 len = meta.GetObjectLen();
+        int64 wanted = with_count ? std::abs(count) : 1;
+        if ((len >= 0 && (len <= kSetSampleMinLen || (count > 0 && count >= len))) || meta.GetMin().IsNil() || meta.GetMax().IsNil())
         {
-            KeyObject& field = iter->Key();
-            if (field.GetType() == KEY_SET_MEMBER && field.GetNameSpace() == key.GetNameSpace() && key.GetKey() == field.GetKey())
+            /*
+             * small set, or all of it asked for: read it whole & reply the head of the set, only the
+             * repeats asked by a negative count beyond the set length are random
+             */
+            DataArray members;
+            load_set_members(m_engine, ctx, key, members);
+            if (members.empty())
             {
+                return 0;
+            }
+            for (int64 i = 0; i < wanted && (count < 0 || i < (int64) members.size()); i++)
+            {
+                const Data& member = i < (int64) members.size() ? members[i] : members[random() % members.size()];
                 if (with_count)
                 {
-                    RedisReply& r = reply.AddMember();
-                    r.SetString(field.GetSetMember());
-                    fetched++;
-                    iter->Next();
+                    reply.AddMember().SetString(member);
                 }
                 else
                 {
-                    reply.SetString(field.GetSetMember());
+                    reply.SetString(member);
+                }
+            }
+            return 0;
+        }
+        Iterator* iter = m_engine->Find(ctx, key);
+        StringTreeSet seen;
+        std::string member;
+        while (NULL != iter && fetched < wanted)
+        {
+            if (count > 0)
+            {
+                if (!seek_unseen_member(iter, key, meta, seen, member))
+                {
                     break;
                 }
+                seen.insert(member);
             }
             else
             {
-                break;
+                if (!seek_random_member(iter, key, meta))
+                {
+                    break;
+                }
+                member.clear();
+                iter->Key(false).GetSetMember().ToString(member);
             }
-        }
-        DELETE(iter);
-        if(count < 0 && fetched < std::abs(count) && fetched > 0)
-        {
-            while(fetched < std::abs(count))
+            if (with_count)
             {
-                RedisReply& r = reply.MemberAt(random_between_int32(0, reply.MemberSize() -1));
-                RedisReply& rr = reply.AddMember();
-                rr.SetString(r.GetString());
-                fetched++;
+                reply.AddMember().SetString(member);
             }
+            else
+            {
+                reply.SetString(member);
+            }
+            fetched++;
         }
+        DELETE(iter);
         return 0;
     }
 
@@ -512,420 +850,462 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
-    int Ardb::SDiff(Context& ctx, RedisCommandFrame& cmd)
+    /*
+     * A set at least 'kSetProbeRatio' times larger than the set driving SINTER/SDIFF is checked by point lookups
+     * instead of being walked, a walking iterator jumps to the wanted member after 'kSetWalkSteps' smaller ones.
+     */
+    static const int64 kSetProbeRatio = 16;
+    static const int kSetWalkSteps = 8;
+
+    static int64 set_size(ValueObject& meta)
     {
-        RedisReply& reply = ctx.GetReply();
-        PointerArray<Iterator*> iters;
-        ValueObjectArray metas;
-        size_t diff_key_cursor = 0;
-        KeyObjectArray keys;
-        for (size_t i = 0; i < cmd.GetArguments().size(); i++)
+        //the length is unknown(-1) for sets written in non redis compatible mode
+        return meta.GetObjectLen() >= 0 ? meta.GetObjectLen() : LLONG_MAX;
+    }
+
+    static void set_member_copy(const Data& member, Data& copy)
+    {
+        if (member.IsCStr())
         {
-            KeyObject set_key(ctx.ns, KEY_META, cmd.GetArguments()[i]);
-            keys.push_back(set_key);
+            copy.SetString(member.CStr(), member.StringLength(), true);
         }
-        metas.resize(keys.size());
-        iters.resize(keys.size());
-        KeysLockGuard guard(ctx, keys);
-        if (cmd.GetType() == REDIS_CMD_SDIFFSTORE)
+        else
         {
-            diff_key_cursor = 1;
-            if (!CheckMeta(ctx, keys[0], KEY_SET, metas[0]))
-            {
-                return 0;
-            }
+            copy = member;
         }
-        for (size_t i = diff_key_cursor; i < keys.size(); i++)
+    }
+
+    bool Ardb::SetOperandSmaller::operator()(SetOperand* a, SetOperand* b) const
+    {
+        return set_size(a->meta) < set_size(b->meta);
+    }
+
+    bool Ardb::SetOperandGreater::operator()(SetOperand* a, SetOperand* b) const
+    {
+        return a->iter->Key(false).GetSetMember().Compare(b->iter->Key(false).GetSetMember()) > 0;
+    }
+
+    void Ardb::SetOpOpen(Context& ctx, SetOperand& op, const Data& from)
+    {
+        KeyObject start(op.key.GetNameSpace(), KEY_SET_MEMBER, op.key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(start);
+        CheckStreamIterate(op.meta.GetObjectLen(), iter_opts);
+        if (!from.IsNil())
+        {
+            start.SetSetMember(from);
+        }
+        op.iter = m_engine->Find(ctx, start, iter_opts);
+    }
+
+    /*
+     * Return true if 'member' is in the operand, a walked operand is left on the first member not less than 'member'.
+     */
+    bool Ardb::SetOpSeek(Context& ctx, SetOperand& op, const Data& member)
+    {
+        if (op.probe)
+        {
+            KeyObject element(op.key.GetNameSpace(), KEY_SET_MEMBER, op.key.GetKey());
+            element.SetSetMember(member);
+            return m_engine->Exists(ctx, element);
+        }
+        int steps = 0;
+        while (NULL != op.iter && op.iter->Valid())
         {
-            if (0 != GetMinMax(ctx, keys[i], KEY_SET, metas[i], iters[i]))
+            int cmp = op.iter->Key(false).GetSetMember().Compare(member);
+            if (cmp >= 0)
             {
-                reply.SetErrCode(ERR_WRONG_TYPE);
-                return 0;
+                return cmp == 0;
+            }
+            if (++steps == kSetWalkSteps)
+            {
+                KeyObject next(op.key.GetNameSpace(), KEY_SET_MEMBER, op.key.GetKey());
+                next.SetSetMember(member);
+                op.iter->Jump(next);
+            }
+            else
+            {
+                op.iter->Next();
             }
         }
-        if (metas[diff_key_cursor].GetType() == 0)
+        return false;
+    }
+
+    void Ardb::SetOpEmit(Context& ctx, SetOpOutput& out, const Data& member)
+    {
+        out.count++;
+        switch (out.type)
         {
-            if (cmd.GetType() == REDIS_CMD_SDIFF)
+            case REDIS_CMD_SINTER:
+            case REDIS_CMD_SUNION:
+            case REDIS_CMD_SDIFF:
             {
-                reply.ReserveMember(0);
+                RedisReply& r = ctx.GetReply().AddMember();
+                r.SetString(member);
+                break;
             }
-            else
+            case REDIS_CMD_SINTERSTORE:
+            case REDIS_CMD_SUNIONSTORE:
+            case REDIS_CMD_SDIFFSTORE:
             {
-                if (cmd.GetType() == REDIS_CMD_SDIFFSTORE)
+                KeyObject element(out.dest.GetNameSpace(), KEY_SET_MEMBER, out.dest.GetKey());
+                element.SetSetMember(member);
+                ValueObject empty;
+                empty.SetType(KEY_SET_MEMBER);
+                SetKeyValue(ctx, element, empty);
+                if (out.count == 1)
                 {
-                    if (metas[0].GetType() > 0)
-                    {
-                        DelKey(ctx, keys[0]);
-                    }
+                    set_member_copy(member, out.min);
                 }
-                reply.SetInteger(0); //REDIS_CMD_SDIFFCOUNT & REDIS_CMD_SDIFFSTORE
+                break;
             }
-            return 0;
-        }
-        DataSet diff_result;
-        while (iters[diff_key_cursor]->Valid())
-        {
-            KeyObject& k = iters[diff_key_cursor]->Key(true);
-            if (k.GetType() != KEY_SET_MEMBER || k.GetKey() != keys[diff_key_cursor].GetKey() || k.GetNameSpace() != keys[diff_key_cursor].GetNameSpace())
+            default:
             {
                 break;
             }
-            diff_result.insert(k.GetSetMember());
-            iters[diff_key_cursor]->Next();
         }
+        set_member_copy(member, out.last);
+    }
 
-        for (size_t i = diff_key_cursor + 1; i < metas.size(); i++)
+    /*
+     * Leapfrog join, the smallest set drives and every other set either confirms its member or moves the driver
+     * forward to the next member it has.
+     */
+    void Ardb::SetOpInter(Context& ctx, PointerArray<SetOperand*>& ops, const Data& max, SetOpOutput& out)
+    {
+        SetOperand& driver = *(ops[0]);
+        while (driver.iter->Valid())
         {
-
-            if (metas[i].GetType() == 0)
-            {
-                continue;
-            }
-            if (metas[i].GetMin() > metas[diff_key_cursor].GetMax() || metas[i].GetMax() < metas[diff_key_cursor].GetMin())
+            const Data& member = driver.iter->Key(false).GetSetMember();
+            if (!max.IsNil() && member > max)
             {
-                continue;
+                break;
             }
-            Data min = metas[diff_key_cursor].GetMin() > metas[i].GetMin() ? metas[diff_key_cursor].GetMin() : metas[i].GetMin();
-            Data max = metas[diff_key_cursor].GetMax() < metas[i].GetMax() ? metas[diff_key_cursor].GetMax() : metas[i].GetMax();
-            KeyObject start(ctx.ns, KEY_SET_MEMBER, keys[i].GetKey());
-            start.SetSetMember(min);
-            iters[i]->Jump(start);
-
-            while (iters[i]->Valid())
+            bool matched = true;
+            bool exhausted = false;
+            Data next;
+            for (size_t i = 1; i < ops.size(); i++)
             {
-                KeyObject& k = iters[i]->Key(false);
-                if (k.GetType() != KEY_SET_MEMBER || k.GetKey() != keys[i].GetKey() || k.GetNameSpace() != keys[i].GetNameSpace() || k.GetSetMember() > max)
+                if (SetOpSeek(ctx, *(ops[i]), member))
                 {
-                    break;
+                    continue;
                 }
-                diff_result.erase(k.GetSetMember());
-                iters[i]->Next();
+                matched = false;
+                if (!ops[i]->probe)
+                {
+                    if (ops[i]->iter->Valid())
+                    {
+                        set_member_copy(ops[i]->iter->Key(false).GetSetMember(), next);
+                    }
+                    else
+                    {
+                        exhausted = true;
+                    }
+                }
+                break;
             }
-        }
-        if (cmd.GetType() == REDIS_CMD_SDIFFSTORE)
-        {
-            if (metas[0].GetType() > 0)
+            if (exhausted)
             {
-                Iterator* iter = NULL;
-                DelKey(ctx, keys[0], iter);
-                DELETE(iter);
+                break;
             }
-            if (!diff_result.empty())
+            if (matched)
             {
-                DataSet::iterator it = diff_result.begin();
-                ValueObject dest_meta;
-                dest_meta.SetType(KEY_SET);
-                dest_meta.SetObjectLen(diff_result.size());
-                while (it != diff_result.end())
-                {
-                    KeyObject element(ctx.ns, KEY_SET_MEMBER, cmd.GetArguments()[0]);
-                    element.SetSetMember(*it);
-                    ValueObject empty;
-                    empty.SetType(KEY_SET_MEMBER);
-                    SetKeyValue(ctx, element, empty);
-                    it++;
-                }
-                dest_meta.SetMinData(*(diff_result.begin()));
-                dest_meta.SetMaxData(*(diff_result.rbegin()));
-                SetKeyValue(ctx, keys[0], dest_meta);
+                SetOpEmit(ctx, out, member);
+                driver.iter->Next();
+            }
+            else if (!next.IsNil())
+            {
+                SetOpSeek(ctx, driver, next);
+            }
+            else
+            {
+                driver.iter->Next();
             }
-            reply.SetInteger(diff_result.size());
         }
-        else if (cmd.GetType() == REDIS_CMD_SDIFF)
+    }
+
+    /*
+     * K-way merge of all sets by a min heap of their iterators.
+     */
+    void Ardb::SetOpUnion(Context& ctx, PointerArray<SetOperand*>& ops, SetOpOutput& out)
+    {
+        std::vector<SetOperand*> heap;
+        for (size_t i = 0; i < ops.size(); i++)
         {
-            DataSet::iterator it = diff_result.begin();
-            while (it != diff_result.end())
+            if (ops[i]->iter->Valid())
             {
-                RedisReply& r = reply.AddMember();
-                r.SetString(*it);
-                it++;
+                heap.push_back(ops[i]);
             }
         }
-        else
+        SetOperandGreater greater;
+        std::make_heap(heap.begin(), heap.end(), greater);
+        while (!heap.empty())
         {
-            reply.SetInteger(diff_result.size()); //REDIS_CMD_SDIFFCOUNT
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            SetOperand* op = heap.back();
+            const Data& member = op->iter->Key(false).GetSetMember();
+            if (out.count == 0 || member.Compare(out.last) != 0)
+            {
+                SetOpEmit(ctx, out, member);
+            }
+            op->iter->Next();
+            if (op->iter->Valid())
+            {
+                std::push_heap(heap.begin(), heap.end(), greater);
+            }
+            else
+            {
+                heap.pop_back();
+            }
         }
-        return 0;
     }
 
-    int Ardb::SDiffStore(Context& ctx, RedisCommandFrame& cmd)
+    void Ardb::SetOpDiff(Context& ctx, PointerArray<SetOperand*>& ops, SetOpOutput& out)
     {
-        return SDiff(ctx, cmd);
-    }
-    int Ardb::SDiffCount(Context& ctx, RedisCommandFrame& cmd)
-    {
-        return SDiff(ctx, cmd);
+        SetOperand& driver = *(ops[0]);
+        while (driver.iter->Valid())
+        {
+            const Data& member = driver.iter->Key(false).GetSetMember();
+            bool found = false;
+            for (size_t i = 1; i < ops.size() && !found; i++)
+            {
+                found = SetOpSeek(ctx, *(ops[i]), member);
+            }
+            if (!found)
+            {
+                SetOpEmit(ctx, out, member);
+            }
+            driver.iter->Next();
+        }
     }
 
-    int Ardb::SInter(Context& ctx, RedisCommandFrame& cmd)
+    /*
+     * SINTER/SUNION/SDIFF and their STORE/COUNT variants, members are produced in order while walking the sets and
+     * are replied, counted or written to the destination directly.
+     */
+    int Ardb::SetOperation(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
-        PointerArray<Iterator*> iters;
-        ValueObjectArray metas;
-        size_t inter_key_cursor = 0;
+        int type = cmd.GetType();
+        bool store = type == REDIS_CMD_SINTERSTORE || type == REDIS_CMD_SUNIONSTORE || type == REDIS_CMD_SDIFFSTORE;
+        bool inter = type == REDIS_CMD_SINTER || type == REDIS_CMD_SINTERSTORE || type == REDIS_CMD_SINTERCOUNT;
+        bool diff = type == REDIS_CMD_SDIFF || type == REDIS_CMD_SDIFFSTORE || type == REDIS_CMD_SDIFFCOUNT;
         KeyObjectArray keys;
         for (size_t i = 0; i < cmd.GetArguments().size(); i++)
         {
             KeyObject set_key(ctx.ns, KEY_META, cmd.GetArguments()[i]);
             keys.push_back(set_key);
         }
-        metas.resize(keys.size());
-        iters.resize(keys.size());
         KeysLockGuard guard(ctx, keys);
-        if (cmd.GetType() == REDIS_CMD_SINTERSTORE)
+        ValueObjectArray metas;
+        ErrCodeArray errs;
+        m_engine->MultiGet(ctx, keys, metas, errs);
+        for (size_t i = 0; i < keys.size(); i++)
         {
-            inter_key_cursor = 1;
-            if (!CheckMeta(ctx, keys[0], KEY_SET, metas[0]))
+            if (errs[i] != 0 && errs[i] != ERR_ENTRY_NOT_EXIST)
+            {
+                reply.SetErrCode(errs[i]);
+                return 0;
+            }
+            if (!CheckMeta(ctx, keys[i], KEY_SET, metas[i], false))
             {
                 return 0;
             }
         }
+        size_t first = store ? 1 : 0;
         bool empty_result = false;
+        bool bounded = inter;
         Data min, max;
-        for (size_t i = inter_key_cursor; i < keys.size(); i++)
+        PointerArray<SetOperand*> ops;
+        for (size_t i = first; i < keys.size() && !empty_result; i++)
         {
-            if (0 != GetMinMax(ctx, keys[i], KEY_SET, metas[i], iters[i]))
-            {
-                reply.SetErrCode(ERR_WRONG_TYPE);
-                return 0;
-            }
             if (metas[i].GetType() == 0)
             {
-                empty_result = true;
-                break;
-            }
-            if (min.IsNil() || metas[i].GetMin() > min)
-            {
-                min = metas[i].GetMin();
+                empty_result = inter || (diff && i == first);
+                continue;
             }
-            if (max.IsNil() || metas[i].GetMax() < max)
+            if (inter)
             {
-                max = metas[i].GetMax();
+                if (metas[i].GetMin().IsNil() || metas[i].GetMax().IsNil())
+                {
+                    bounded = false;
+                }
+                else
+                {
+                    if (min.IsNil() || metas[i].GetMin() > min)
+                    {
+                        min = metas[i].GetMin();
+                    }
+                    if (max.IsNil() || metas[i].GetMax() < max)
+                    {
+                        max = metas[i].GetMax();
+                    }
+                }
             }
+            SetOperand* op = NULL;
+            NEW(op, SetOperand);
+            op->key = keys[i];
+            op->meta = metas[i];
+            ops.push_back(op);
+        }
+        if (!bounded)
+        {
+            min.Clear();
+            max.Clear();
         }
-        if (min > max)
+        else if (min > max)
         {
             empty_result = true;
         }
-
-        if (empty_result)
+        if (ops.empty())
         {
-            if (cmd.GetType() == REDIS_CMD_SINTER)
+            empty_result = true;
+        }
+        if (!empty_result)
+        {
+            if (inter)
             {
-                reply.ReserveMember(0);
+                std::stable_sort(ops.begin(), ops.end(), SetOperandSmaller());
             }
-            else // REDIS_CMD_SINTERSTORE | REDIS_CMD_SINTERCOUNT
+            /*
+             * iterators are all created before the destination is cleared, and a set which is also the destination is
+             * never probed, so sources see their content before this command.
+             */
+            SetOperand* driver = ops[0];
+            for (size_t i = 0; i < ops.size(); i++)
             {
-                if (cmd.GetType() == REDIS_CMD_SINTERSTORE)
+                SetOperand* op = ops[i];
+                if (i > 0 && !(store && op->key.GetKey() == keys[0].GetKey()))
                 {
-                    if (metas[0].GetType() > 0)
+                    if ((inter || diff) && set_size(driver->meta) != LLONG_MAX && set_size(op->meta) != LLONG_MAX
+                            && set_size(op->meta) / kSetProbeRatio >= set_size(driver->meta))
+                    {
+                        op->probe = true;
+                        continue;
+                    }
+                    if (diff && !op->meta.GetMin().IsNil() && !driver->meta.GetMax().IsNil()
+                            && (op->meta.GetMin() > driver->meta.GetMax() || op->meta.GetMax() < driver->meta.GetMin()))
                     {
-                        Iterator* iter = NULL;
-                        DelKey(ctx, keys[0], iter);
-                        DELETE(iter);
+                        continue; //disjoint with the first set, it removes nothing
                     }
                 }
-                reply.SetInteger(0);
+                SetOpOpen(ctx, *op, min);
             }
-            return 0;
         }
-        DataSet inter_result[2];
-        size_t inter_result_cursor = 1;
-        for (size_t i = inter_key_cursor; i < metas.size(); i++)
+        SetOpOutput out;
+        out.type = type;
+        out.dest = keys[0];
+        if (type == REDIS_CMD_SINTER || type == REDIS_CMD_SUNION || type == REDIS_CMD_SDIFF)
+        {
+            reply.ReserveMember(0);
+        }
+        if (!store)
         {
-            KeyObject start(ctx.ns, KEY_SET_MEMBER, keys[i].GetKey());
-            start.SetSetMember(min);
-            iters[i]->Jump(start);
-            inter_result_cursor = 1 - inter_result_cursor;
-            inter_result[inter_result_cursor].clear();
-            while (iters[i]->Valid())
+            if (!empty_result)
             {
-                KeyObject& k = iters[i]->Key(true);
-                if (k.GetType() != KEY_SET_MEMBER || k.GetKey() != keys[i].GetKey() || k.GetNameSpace() != keys[i].GetNameSpace() || k.GetSetMember() > max)
+                if (inter)
                 {
-                    break;
+                    SetOpInter(ctx, ops, max, out);
+                }
+                else if (diff)
+                {
+                    SetOpDiff(ctx, ops, out);
                 }
-                if (i == inter_key_cursor || inter_result[1 - inter_result_cursor].erase(k.GetSetMember()) > 0)
+                else
                 {
-                    inter_result[inter_result_cursor].insert(k.GetSetMember());
+                    SetOpUnion(ctx, ops, out);
                 }
-                iters[i]->Next();
             }
+            if (type == REDIS_CMD_SINTERCOUNT || type == REDIS_CMD_SUNIONCOUNT || type == REDIS_CMD_SDIFFCOUNT)
+            {
+                reply.SetInteger(out.count);
+            }
+            return 0;
         }
-        if (cmd.GetType() == REDIS_CMD_SINTERSTORE)
         {
-            if (!inter_result[inter_result_cursor].empty())
+            WriteBatchGuard batch(ctx, m_engine);
+            if (metas[0].GetType() > 0)
+            {
+                DelKey(ctx, keys[0]);
+            }
+            if (!empty_result)
             {
-                if (metas[0].GetType() > 0)
+                if (inter)
+                {
+                    SetOpInter(ctx, ops, max, out);
+                }
+                else if (diff)
                 {
-                    Iterator* iter = NULL;
-                    DelKey(ctx, keys[0], iter);
-                    DELETE(iter);
+                    SetOpDiff(ctx, ops, out);
                 }
-                DataSet::iterator it = inter_result[inter_result_cursor].begin();
+                else
+                {
+                    SetOpUnion(ctx, ops, out);
+                }
+            }
+            if (out.count > 0)
+            {
                 ValueObject dest_meta;
                 dest_meta.SetType(KEY_SET);
-                dest_meta.SetObjectLen(inter_result[inter_result_cursor].size());
-                while (it != inter_result[inter_result_cursor].end())
-                {
-                    KeyObject element(ctx.ns, KEY_SET_MEMBER, cmd.GetArguments()[0]);
-                    element.SetSetMember(*it);
-                    ValueObject empty;
-                    empty.SetType(KEY_SET_MEMBER);
-                    SetKeyValue(ctx, element, empty);
-                    it++;
-                }
-                dest_meta.SetMinData(*(inter_result[inter_result_cursor].begin()));
-                dest_meta.SetMaxData(*(inter_result[inter_result_cursor].rbegin()));
+                dest_meta.SetObjectLen(out.count);
+                dest_meta.SetMinData(out.min);
+                dest_meta.SetMaxData(out.last);
                 SetKeyValue(ctx, keys[0], dest_meta);
             }
-            reply.SetInteger(inter_result[inter_result_cursor].size());
         }
-        else if (cmd.GetType() == REDIS_CMD_SINTER)
+        if (ctx.transc_err != 0)
         {
-            DataSet::iterator it = inter_result[inter_result_cursor].begin();
-            while (it != inter_result[inter_result_cursor].end())
-            {
-                RedisReply& r = reply.AddMember();
-                r.SetString(*it);
-                it++;
-            }
+            reply.SetErrCode(ctx.transc_err);
         }
         else
         {
-            reply.SetInteger(inter_result[inter_result_cursor].size()); //REDIS_CMD_SINTERCOUNT
+            reply.SetInteger(out.count);
         }
         return 0;
     }
 
+    int Ardb::SDiff(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return SetOperation(ctx, cmd);
+    }
+
+    int Ardb::SDiffStore(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return SetOperation(ctx, cmd);
+    }
+    int Ardb::SDiffCount(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return SetOperation(ctx, cmd);
+    }
+
+    int Ardb::SInter(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return SetOperation(ctx, cmd);
+    }
+
     int Ardb::SInterStore(Context& ctx, RedisCommandFrame& cmd)
     {
-        return SInter(ctx, cmd);
+        return SetOperation(ctx, cmd);
     }
 
     int Ardb::SInterCount(Context& ctx, RedisCommandFrame& cmd)
     {
-        return SInter(ctx, cmd);
+        return SetOperation(ctx, cmd);
     }
 
     int Ardb::SUnion(Context& ctx, RedisCommandFrame& cmd)
     {
-        RedisReply& reply = ctx.GetReply();
-        ValueObjectArray metas;
-        size_t union_key_cursor = 0;
-        KeyObjectArray keys;
-        for (size_t i = 0; i < cmd.GetArguments().size(); i++)
-        {
-            KeyObject set_key(ctx.ns, KEY_META, cmd.GetArguments()[i]);
-            keys.push_back(set_key);
-        }
-        metas.resize(keys.size());
-        KeysLockGuard guard(ctx,keys);
-        ErrCodeArray errs;
-        m_engine->MultiGet(ctx, keys, metas, errs);
-        for (size_t i = 0; i < metas.size(); i++)
-        {
-            if (!CheckMeta(ctx, keys[i], KEY_SET, metas[i], false))
-            {
-                return 0;
-            }
-            if (errs[i] != 0 && errs[i] != ERR_ENTRY_NOT_EXIST)
-            {
-                reply.SetErrCode(errs[i]);
-                return 0;
-            }
-        }
-        if (cmd.GetType() == REDIS_CMD_SUNIONSTORE)
-        {
-            union_key_cursor = 1;
-        }
-        DataSet union_result;
-        Iterator* iter = NULL;
-        ctx.flags.iterate_no_upperbound = 1;
-        for (size_t i = union_key_cursor; i < keys.size(); i++)
-        {
-            if (metas[i].GetType() == 0)
-            {
-                continue;
-            }
-            KeyObject ele(ctx.ns, KEY_SET_MEMBER, keys[i].GetKey());
-            ele.SetSetMember(metas[i].GetMin());
-            if (NULL != iter)
-            {
-                iter->Jump(ele);
-            }
-            else
-            {
-                iter = m_engine->Find(ctx, ele);
-            }
-            while (NULL != iter && iter->Valid())
-            {
-                KeyObject& k = iter->Key(true);
-                if (k.GetType() != KEY_SET_MEMBER || k.GetKey() != keys[i].GetKey() || k.GetNameSpace() != keys[i].GetNameSpace())
-                {
-                    break;
-                }
-                union_result.insert(k.GetSetMember());
-                iter->Next();
-            }
-        }
-        DELETE(iter);
-        if (cmd.GetType() == REDIS_CMD_SUNIONSTORE)
-        {
-            if (metas[0].GetType() > 0)
-            {
-                Iterator* iter = NULL;
-                DelKey(ctx, keys[0], iter);
-                DELETE(iter);
-            }
-
-            if (!union_result.empty())
-            {
-                DataSet::iterator it = union_result.begin();
-                ValueObject dest_meta;
-                dest_meta.SetType(KEY_SET);
-                dest_meta.SetObjectLen(union_result.size());
-                while (it != union_result.end())
-                {
-                    KeyObject element(ctx.ns, KEY_SET_MEMBER, cmd.GetArguments()[0]);
-                    element.SetSetMember(*it);
-                    ValueObject empty;
-                    empty.SetType(KEY_SET_MEMBER);
-                    SetKeyValue(ctx, element, empty);
-                    it++;
-                }
-                dest_meta.SetMinData(*(union_result.begin()));
-                dest_meta.SetMaxData(*(union_result.rbegin()));
-                SetKeyValue(ctx, keys[0], dest_meta);
-                reply.SetInteger(union_result.size());
-            }
-
-        }
-        else if (cmd.GetType() == REDIS_CMD_SUNION)
-        {
-            DataSet::iterator it = union_result.begin();
-            while (it != union_result.end())
-            {
-                RedisReply& r = reply.AddMember();
-                r.SetString(*it);
-                it++;
-            }
-        }
-        else
-        {
-            reply.SetInteger(union_result.size()); //REDIS_CMD_SUNIONCOUNT
-        }
-        return 0;
+        return SetOperation(ctx, cmd);
     }
 
     int Ardb::SUnionStore(Context& ctx, RedisCommandFrame& cmd)
     {
-        return SUnion(ctx, cmd);
+        return SetOperation(ctx, cmd);
     }
 
     int Ardb::SUnionCount(Context& ctx, RedisCommandFrame& cmd)
     {
-        return SUnion(ctx, cmd);
+        return SetOperation(ctx, cmd);
     }
 
     int Ardb::SScan(Context& ctx, RedisCommandFrame& cmd)
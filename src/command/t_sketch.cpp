@@ -0,0 +1,742 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "db/db.hpp"
+#include "util/murmur3.h"
+#include <math.h>
+
+/*
+ * Count-min sketches & top-k (HeavyKeeper) are plain strings of a fixed layout, sized when they are created:
+ *
+ *   count-min: "CM01" width depth reserved(4) count(8) | depth rows of width 32 bits counters
+ *   top-k:     "TK01" k width depth decay(8) | depth rows of width (fingerprint, count) buckets | heap
+ *
+ * The heap of the top-k holds at most k (fingerprint, count, item) entries after the buckets. Updates are merge
+ * operations when the engine supports merge, so CMS.INCRBY & TOPK.ADD are blind writes applied by the merge
+ * operator, the replies then carry no counts like PFADD. HeavyKeeper decays with a probability, which is drawn
+ * from a hash of the bucket instead of a random number so that every replica & compaction gives the same sketch.
+ */
+OP_NAMESPACE_BEGIN
+    static const char* kCMSMagic = "CM01";
+    static const char* kTopKMagic = "TK01";
+    static const size_t kSketchHeaderSize = 24;
+    static const uint64 kSketchMaxCells = 64 * 1024 * 1024;
+    static const size_t kSketchMaxMergeArgs = 254; //item/increment pairs in the one byte argument count of a merge value
+    static const int64 kTopKDefaultWidth = 8;
+    static const int64 kTopKDefaultDepth = 7;
+    static const double kTopKDefaultDecay = 0.9;
+
+    static void sketch_hash(const std::string& item, uint64 hash[2])
+    {
+        MurmurHash3_x64_128(item.data(), item.size(), 0, hash);
+    }
+
+    static uint32 sketch_col(const uint64 hash[2], uint32 row, uint32 width)
+    {
+        return (uint32) ((hash[0] + (uint64) row * hash[1]) % width);
+    }
+
+    static bool sketch_header(const std::string& value, const char* magic, uint32& width, uint32& depth, uint32* k)
+    {
+        if (value.size() < kSketchHeaderSize || memcmp(value.data(), magic, 4) != 0)
+        {
+            return false;
+        }
+        if (NULL != k)
+        {
+            memcpy(k, value.data() + 4, 4);
+            memcpy(&width, value.data() + 8, 4);
+            memcpy(&depth, value.data() + 12, 4);
+        }
+        else
+        {
+            memcpy(&width, value.data() + 4, 4);
+            memcpy(&depth, value.data() + 8, 4);
+        }
+        return width > 0 && depth > 0;
+    }
+
+    /*
+     * Rows of counters, laid out row by row after the header.
+     */
+    struct CountMinSketch
+    {
+            std::string value;
+            uint32 width;
+            uint32 depth;
+            CountMinSketch() :
+                    width(0), depth(0)
+            {
+            }
+            void Create(uint32 w, uint32 d)
+            {
+                width = w;
+                depth = d;
+                value.assign(kSketchHeaderSize + (size_t) w * d * sizeof(uint32), 0);
+                memcpy(&value[0], kCMSMagic, 4);
+                memcpy(&value[4], &width, 4);
+                memcpy(&value[8], &depth, 4);
+            }
+            bool Decode(ValueObject& v)
+            {
+                if (v.GetType() != KEY_STRING || v.IsChunked())
+                {
+                    return false;
+                }
+                v.GetStringValue().ToString(value);
+                return sketch_header(value, kCMSMagic, width, depth, NULL)
+                        && value.size() == kSketchHeaderSize + (size_t) width * depth * sizeof(uint32);
+            }
+            uint32* Counters()
+            {
+                return (uint32*) (&value[kSketchHeaderSize]);
+            }
+            uint64 Count() const
+            {
+                uint64 count;
+                memcpy(&count, value.data() + 16, 8);
+                return count;
+            }
+            void Incr(const uint64 hash[2], uint32 incr)
+            {
+                uint32* counters = Counters();
+                for (uint32 i = 0; i < depth; i++)
+                {
+                    uint32& c = counters[(size_t) i * width + sketch_col(hash, i, width)];
+                    c = c > UINT32_MAX - incr ? UINT32_MAX : c + incr;
+                }
+                uint64 count = Count() + incr;
+                memcpy(&value[16], &count, 8);
+            }
+            /*
+             * The counters of the item are gathered first, the min is then a plain loop over a small array.
+             */
+            uint32 Query(const uint64 hash[2])
+            {
+                uint32* counters = Counters();
+                std::vector<uint32> cells(depth);
+                for (uint32 i = 0; i < depth; i++)
+                {
+                    cells[i] = counters[(size_t) i * width + sketch_col(hash, i, width)];
+                }
+                uint32 min = cells[0];
+                for (uint32 i = 1; i < depth; i++)
+                {
+                    min = cells[i] < min ? cells[i] : min;
+                }
+                return min;
+            }
+    };
+
+    struct TopKEntry
+    {
+            uint32 fp;
+            uint32 count;
+            std::string item;
+    };
+
+    struct TopKSketch
+    {
+            std::string value;
+            uint32 k;
+            uint32 width;
+            uint32 depth;
+            double decay;
+            std::vector<TopKEntry> heap;
+            TopKSketch() :
+                    k(0), width(0), depth(0), decay(0)
+            {
+            }
+            size_t BucketsEnd() const
+            {
+                return kSketchHeaderSize + (size_t) width * depth * 8;
+            }
+            void Create(uint32 topk, uint32 w, uint32 d, double dc)
+            {
+                k = topk;
+                width = w;
+                depth = d;
+                decay = dc;
+                value.assign(BucketsEnd(), 0);
+                memcpy(&value[0], kTopKMagic, 4);
+                memcpy(&value[4], &k, 4);
+                memcpy(&value[8], &width, 4);
+                memcpy(&value[12], &depth, 4);
+                memcpy(&value[16], &decay, 8);
+            }
+            bool Decode(ValueObject& v)
+            {
+                if (v.GetType() != KEY_STRING || v.IsChunked())
+                {
+                    return false;
+                }
+                v.GetStringValue().ToString(value);
+                if (!sketch_header(value, kTopKMagic, width, depth, &k) || value.size() < BucketsEnd())
+                {
+                    return false;
+                }
+                memcpy(&decay, value.data() + 16, 8);
+                heap.clear();
+                Buffer buffer(const_cast<char*>(value.data()), BucketsEnd(), value.size());
+                uint32 n = 0;
+                if (buffer.Readable() && !BufferHelper::ReadVarUInt32(buffer, n))
+                {
+                    return false;
+                }
+                heap.resize(n);
+                for (uint32 i = 0; i < n; i++)
+                {
+                    if (!BufferHelper::ReadVarUInt32(buffer, heap[i].fp) || !BufferHelper::ReadVarUInt32(buffer, heap[i].count)
+                            || !BufferHelper::ReadVarString(buffer, heap[i].item))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            void Encode()
+            {
+                Buffer buffer;
+                BufferHelper::WriteVarUInt32(buffer, heap.size());
+                for (size_t i = 0; i < heap.size(); i++)
+                {
+                    BufferHelper::WriteVarUInt32(buffer, heap[i].fp);
+                    BufferHelper::WriteVarUInt32(buffer, heap[i].count);
+                    BufferHelper::WriteVarString(buffer, heap[i].item);
+                }
+                value.resize(BucketsEnd());
+                value.append(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+            }
+            uint32* Bucket(uint32 row, uint32 col)
+            {
+                return (uint32*) (&value[kSketchHeaderSize + ((size_t) row * width + col) * 8]);
+            }
+            /*
+             * Decay the bucket with probability decay^count.
+             */
+            bool DecayHit(uint32 fp, uint32 count, uint32 n) const
+            {
+                double p = pow(decay, (double) count);
+                uint32 seed[3] = { fp, count, n };
+                uint64 h[2];
+                MurmurHash3_x64_128(seed, sizeof(seed), 0, h);
+                return (double) (uint32) h[0] / 4294967296.0 < p;
+            }
+            int Find(uint32 fp, const std::string& item) const
+            {
+                for (size_t i = 0; i < heap.size(); i++)
+                {
+                    if (heap[i].fp == fp && heap[i].item == item)
+                    {
+                        return (int) i;
+                    }
+                }
+                return -1;
+            }
+            /*
+             * HeavyKeeper update, return true & set 'expelled' if an item left the top k.
+             */
+            bool Add(const std::string& item, uint32 incr, std::string& expelled)
+            {
+                uint64 hash[2];
+                sketch_hash(item, hash);
+                uint32 fp = (uint32) (hash[1] >> 32);
+                uint32 max = 0;
+                for (uint32 i = 0; i < depth; i++)
+                {
+                    uint32* b = Bucket(i, sketch_col(hash, i, width));
+                    if (b[1] == 0)
+                    {
+                        b[0] = fp;
+                        b[1] = incr;
+                    }
+                    else if (b[0] == fp)
+                    {
+                        b[1] = b[1] > UINT32_MAX - incr ? UINT32_MAX : b[1] + incr;
+                    }
+                    else
+                    {
+                        for (uint32 n = 0; n < incr; n++)
+                        {
+                            if (pow(decay, (double) b[1]) < 1e-9)
+                            {
+                                break;
+                            }
+                            if (DecayHit(b[0], b[1], n) && --b[1] == 0)
+                            {
+                                b[0] = fp;
+                                b[1] = incr - n;
+                                break;
+                            }
+                        }
+                    }
+                    if (b[0] == fp && b[1] > max)
+                    {
+                        max = b[1];
+                    }
+                }
+                int pos = Find(fp, item);
+                if (pos >= 0)
+                {
+                    heap[pos].count = max > heap[pos].count ? max : heap[pos].count;
+                    return false;
+                }
+                if (max == 0)
+                {
+                    return false;
+                }
+                TopKEntry entry;
+                entry.fp = fp;
+                entry.count = max;
+                entry.item = item;
+                if (heap.size() < k)
+                {
+                    heap.push_back(entry);
+                    return false;
+                }
+                size_t min = 0;
+                for (size_t i = 1; i < heap.size(); i++)
+                {
+                    if (heap[i].count < heap[min].count)
+                    {
+                        min = i;
+                    }
+                }
+                if (heap.empty() || heap[min].count >= max)
+                {
+                    return false;
+                }
+                expelled = heap[min].item;
+                heap[min] = entry;
+                return true;
+            }
+    };
+
+    static bool topk_entry_greater(const TopKEntry& a, const TopKEntry& b)
+    {
+        return a.count > b.count;
+    }
+
+    /*
+     * args are item/increment pairs.
+     */
+    int Ardb::MergeCMSIncrBy(Context& ctx, const KeyObject& key, ValueObject& val, const DataArray& args)
+    {
+        CountMinSketch cms;
+        if (!cms.Decode(val))
+        {
+            return ERR_INVALID_SKETCH;
+        }
+        for (size_t i = 0; i + 1 < args.size(); i += 2)
+        {
+            std::string item;
+            args[i].ToString(item);
+            uint64 hash[2];
+            sketch_hash(item, hash);
+            cms.Incr(hash, (uint32) args[i + 1].GetInt64());
+        }
+        val.GetStringValue().SetString(cms.value, false);
+        return 0;
+    }
+
+    /*
+     * args are item/increment pairs, the items expelled from the top k are added to 'expelled' if it's not NULL.
+     */
+    int Ardb::MergeTopKAdd(Context& ctx, const KeyObject& key, ValueObject& val, const DataArray& args, RedisReply* expelled)
+    {
+        TopKSketch topk;
+        if (!topk.Decode(val))
+        {
+            return ERR_INVALID_SKETCH;
+        }
+        for (size_t i = 0; i + 1 < args.size(); i += 2)
+        {
+            std::string item, out;
+            args[i].ToString(item);
+            bool out_set = topk.Add(item, (uint32) args[i + 1].GetInt64(), out);
+            if (NULL != expelled)
+            {
+                RedisReply& r = expelled->AddMember();
+                if (out_set)
+                {
+                    r.SetString(out);
+                }
+                else
+                {
+                    r.Clear();
+                }
+            }
+        }
+        topk.Encode();
+        val.GetStringValue().SetString(topk.value, false);
+        return 0;
+    }
+
+    /*
+     * CMS.INCRBY key item incr [item incr ...], TOPK.ADD key item [item ...] & TOPK.INCRBY key item incr [item incr ...].
+     */
+    int Ardb::SketchUpdate(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& cmdargs = cmd.GetArguments();
+        bool with_incr = cmd.GetType() != REDIS_CMD_TOPKADD;
+        uint16 op = cmd.GetType() == REDIS_CMD_CMSINCRBY ? REDIS_CMD_CMSINCRBY : REDIS_CMD_TOPKADD;
+        if (with_incr && cmdargs.size() % 2 != 1)
+        {
+            reply.SetErrCode(ERR_INVALID_ARGS);
+            return 0;
+        }
+        DataArray args;
+        for (size_t i = 1; i < cmdargs.size(); i += (with_incr ? 2 : 1))
+        {
+            int64 incr = 1;
+            if (with_incr && (!string_toint64(cmdargs[i + 1], incr) || incr < 0 || incr > UINT32_MAX))
+            {
+                reply.SetErrorReason("ERR invalid increment value");
+                return 0;
+            }
+            Data item, n;
+            item.SetString(cmdargs[i], false);
+            n.SetInt64(incr);
+            args.push_back(item);
+            args.push_back(n);
+        }
+        KeyObject key(ctx.ns, KEY_META, cmdargs[0]);
+        int err = 0;
+        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        {
+            {
+                WriteBatchGuard batch(ctx, m_engine);
+                for (size_t i = 0; 0 == err && i < args.size(); i += kSketchMaxMergeArgs)
+                {
+                    size_t end = i + kSketchMaxMergeArgs < args.size() ? i + kSketchMaxMergeArgs : args.size();
+                    err = MergeKeyValue(ctx, key, op, DataArray(args.begin() + i, args.begin() + end));
+                }
+                if (0 != err)
+                {
+                    batch.MarkFailed(err);
+                }
+            }
+            if (0 == err)
+            {
+                err = ctx.transc_err;
+            }
+            if (0 != err)
+            {
+                reply.SetErrCode(err);
+            }
+            else
+            {
+                reply.SetStatusCode(STATUS_OK);
+            }
+            return 0;
+        }
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.SetErrorReason("ERR key does not exist");
+            return 0;
+        }
+        RedisReply result;
+        result.ReserveMember(0);
+        err = op == REDIS_CMD_CMSINCRBY ? MergeCMSIncrBy(ctx, key, meta, args) : MergeTopKAdd(ctx, key, meta, args, &result);
+        if (0 == err)
+        {
+            err = SetKeyValue(ctx, key, meta);
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+            return 0;
+        }
+        if (op == REDIS_CMD_TOPKADD)
+        {
+            reply.ReserveMember(0);
+            for (size_t i = 0; i < result.MemberSize(); i++)
+            {
+                RedisReply& r = reply.AddMember();
+                if (result.MemberAt(i).IsString())
+                {
+                    r.SetString(result.MemberAt(i).GetString());
+                }
+                else
+                {
+                    r.Clear();
+                }
+            }
+            return 0;
+        }
+        CountMinSketch cms;
+        cms.Decode(meta);
+        reply.ReserveMember(0);
+        for (size_t i = 0; i < args.size(); i += 2)
+        {
+            std::string item;
+            args[i].ToString(item);
+            uint64 hash[2];
+            sketch_hash(item, hash);
+            reply.AddMember().SetInteger(cms.Query(hash));
+        }
+        return 0;
+    }
+
+    int Ardb::SketchCreate(Context& ctx, RedisCommandFrame& cmd, const std::string& value)
+    {
+        ctx.flags.create_if_notexist = 1;
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_UNKNOWN, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() > 0)
+        {
+            reply.SetErrorReason("ERR key already exists");
+            return 0;
+        }
+        meta.SetType(KEY_STRING);
+        meta.GetStringValue().SetString(value, false);
+        int err = SetKeyValue(ctx, key, meta);
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetStatusCode(STATUS_OK);
+        }
+        return 0;
+    }
+
+    int Ardb::CMSInitByDim(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        int64 width = 0, depth = 0;
+        if (!string_toint64(cmd.GetArguments()[1], width) || !string_toint64(cmd.GetArguments()[2], depth) || width <= 0
+                || depth <= 0 || (uint64) width * depth > kSketchMaxCells)
+        {
+            reply.SetErrorReason("ERR invalid width/depth");
+            return 0;
+        }
+        CountMinSketch cms;
+        cms.Create(width, depth);
+        return SketchCreate(ctx, cmd, cms.value);
+    }
+
+    int Ardb::CMSInitByProb(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        double error = 0, prob = 0;
+        if (!string_todouble(cmd.GetArguments()[1], error) || !string_todouble(cmd.GetArguments()[2], prob) || error <= 0
+                || error >= 1 || prob <= 0 || prob >= 1)
+        {
+            reply.SetErrorReason("ERR invalid error/probability");
+            return 0;
+        }
+        uint64 width = (uint64) ceil(2 / error);
+        uint64 depth = (uint64) ceil(log10(prob) / log10(0.5));
+        if (width * depth > kSketchMaxCells)
+        {
+            reply.SetErrorReason("ERR invalid error/probability");
+            return 0;
+        }
+        CountMinSketch cms;
+        cms.Create(width, depth);
+        return SketchCreate(ctx, cmd, cms.value);
+    }
+
+    int Ardb::CMSIncrBy(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return SketchUpdate(ctx, cmd);
+    }
+
+    int Ardb::CMSQuery(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.SetErrorReason("ERR key does not exist");
+            return 0;
+        }
+        CountMinSketch cms;
+        if (!cms.Decode(meta))
+        {
+            reply.SetErrCode(ERR_INVALID_SKETCH);
+            return 0;
+        }
+        reply.ReserveMember(0);
+        for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+        {
+            uint64 hash[2];
+            sketch_hash(cmd.GetArguments()[i], hash);
+            reply.AddMember().SetInteger(cms.Query(hash));
+        }
+        return 0;
+    }
+
+    int Ardb::CMSInfo(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.SetErrorReason("ERR key does not exist");
+            return 0;
+        }
+        CountMinSketch cms;
+        if (!cms.Decode(meta))
+        {
+            reply.SetErrCode(ERR_INVALID_SKETCH);
+            return 0;
+        }
+        reply.ReserveMember(0);
+        reply.AddMember().SetString("width");
+        reply.AddMember().SetInteger(cms.width);
+        reply.AddMember().SetString("depth");
+        reply.AddMember().SetInteger(cms.depth);
+        reply.AddMember().SetString("count");
+        reply.AddMember().SetInteger(cms.Count());
+        return 0;
+    }
+
+    int Ardb::TopKReserve(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        int64 k = 0, width = kTopKDefaultWidth, depth = kTopKDefaultDepth;
+        double decay = kTopKDefaultDecay;
+        if (args.size() != 2 && args.size() != 5)
+        {
+            reply.SetErrCode(ERR_INVALID_ARGS);
+            return 0;
+        }
+        if (!string_toint64(args[1], k) || k <= 0 || k > UINT32_MAX)
+        {
+            reply.SetErrorReason("ERR invalid k");
+            return 0;
+        }
+        if (args.size() == 5
+                && (!string_toint64(args[2], width) || !string_toint64(args[3], depth) || !string_todouble(args[4], decay) || width <= 0
+                        || depth <= 0 || (uint64) width * depth > kSketchMaxCells || decay <= 0 || decay > 1))
+        {
+            reply.SetErrorReason("ERR invalid width/depth/decay");
+            return 0;
+        }
+        TopKSketch topk;
+        topk.Create(k, width, depth, decay);
+        topk.Encode();
+        return SketchCreate(ctx, cmd, topk.value);
+    }
+
+    int Ardb::TopKAdd(Context& ctx, RedisCommandFrame& cmd)
+    {
+        return SketchUpdate(ctx, cmd);
+    }
+
+    int Ardb::TopKRead(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.SetErrorReason("ERR key does not exist");
+            return 0;
+        }
+        TopKSketch topk;
+        if (!topk.Decode(meta))
+        {
+            reply.SetErrCode(ERR_INVALID_SKETCH);
+            return 0;
+        }
+        reply.ReserveMember(0);
+        switch (cmd.GetType())
+        {
+            case REDIS_CMD_TOPKQUERY:
+            {
+                for (size_t i = 1; i < cmd.GetArguments().size(); i++)
+                {
+                    uint64 hash[2];
+                    sketch_hash(cmd.GetArguments()[i], hash);
+                    reply.AddMember().SetInteger(topk.Find((uint32) (hash[1] >> 32), cmd.GetArguments()[i]) >= 0 ? 1 : 0);
+                }
+                break;
+            }
+            case REDIS_CMD_TOPKLIST:
+            {
+                bool withcount = cmd.GetArguments().size() > 1 && !strcasecmp(cmd.GetArguments()[1].c_str(), "withcount");
+                std::stable_sort(topk.heap.begin(), topk.heap.end(), topk_entry_greater);
+                for (size_t i = 0; i < topk.heap.size(); i++)
+                {
+                    reply.AddMember().SetString(topk.heap[i].item);
+                    if (withcount)
+                    {
+                        reply.AddMember().SetInteger(topk.heap[i].count);
+                    }
+                }
+                break;
+            }
+            default:
+            {
+                reply.AddMember().SetString("k");
+                reply.AddMember().SetInteger(topk.k);
+                reply.AddMember().SetString("width");
+                reply.AddMember().SetInteger(topk.width);
+                reply.AddMember().SetString("depth");
+                reply.AddMember().SetInteger(topk.depth);
+                reply.AddMember().SetString("decay");
+                reply.AddMember().SetDouble(topk.decay);
+                break;
+            }
+        }
+        return 0;
+    }
+OP_NAMESPACE_END
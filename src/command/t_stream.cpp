@@ -0,0 +1,1059 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "db/db.hpp"
+
+/*
+ * Streams are chunked strings like bloom filters & time series: the meta holds the stream header, entries are
+ * stored in blocks of up to 'stream-node-max-entries' entries, one KEY_BITMAP_CHUNK key per block whose index is
+ * the millisecond part of the block's first id. A new block is only started by an entry with a later millisecond
+ * than the last entry, so all entries of a block are before the index of the next one and a range read seeks to
+ * the last block whose index is not after the start id.
+ *
+ * A block is a sequence of entries: the millisecond part of the id relative to the block index, the sequence and
+ * the field/value pairs.
+ */
+OP_NAMESPACE_BEGIN
+    static const char* kStreamMagic = "XS01";
+
+    struct StreamID
+    {
+            uint64 ms;
+            uint64 seq;
+            StreamID(uint64 m = 0, uint64 s = 0) :
+                    ms(m), seq(s)
+            {
+            }
+            bool operator<(const StreamID& other) const
+            {
+                return ms < other.ms || (ms == other.ms && seq < other.seq);
+            }
+            bool operator==(const StreamID& other) const
+            {
+                return ms == other.ms && seq == other.seq;
+            }
+            bool Incr()
+            {
+                if (seq < UINT64_MAX)
+                {
+                    seq++;
+                    return true;
+                }
+                if (ms < UINT64_MAX)
+                {
+                    ms++;
+                    seq = 0;
+                    return true;
+                }
+                return false;
+            }
+            std::string ToString() const
+            {
+                char buf[64];
+                snprintf(buf, sizeof(buf), "%" PRIu64 "-%" PRIu64, ms, seq);
+                return buf;
+            }
+            /*
+             * "ms-seq" or "ms", the sequence of an id without one is 'missing_seq'.
+             */
+            bool Parse(const std::string& str, uint64 missing_seq)
+            {
+                size_t pos = str.find('-');
+                if (pos == std::string::npos)
+                {
+                    seq = missing_seq;
+                    return string_touint64(str, ms);
+                }
+                return string_touint64(str.substr(0, pos), ms) && string_touint64(str.substr(pos + 1), seq);
+            }
+    };
+
+    struct StreamMeta
+    {
+            int64 length;
+            StreamID first;
+            StreamID last; //last id ever added, kept when the entries are trimmed
+            int64 chunks;
+            int64 last_chunk;
+            int64 last_chunk_entries; //0 if the last block was trimmed away
+            StreamMeta() :
+                    length(0), chunks(0), last_chunk(0), last_chunk_entries(0)
+            {
+            }
+            void Encode(std::string& header) const
+            {
+                Buffer buffer;
+                buffer.Write(kStreamMagic, strlen(kStreamMagic));
+                BufferHelper::WriteVarInt64(buffer, length);
+                BufferHelper::WriteVarUInt64(buffer, first.ms);
+                BufferHelper::WriteVarUInt64(buffer, first.seq);
+                BufferHelper::WriteVarUInt64(buffer, last.ms);
+                BufferHelper::WriteVarUInt64(buffer, last.seq);
+                BufferHelper::WriteVarInt64(buffer, chunks);
+                BufferHelper::WriteVarInt64(buffer, last_chunk);
+                BufferHelper::WriteVarInt64(buffer, last_chunk_entries);
+                header.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+            }
+            bool Decode(const std::string& header)
+            {
+                size_t magic_len = strlen(kStreamMagic);
+                if (header.size() < magic_len || header.compare(0, magic_len, kStreamMagic) != 0)
+                {
+                    return false;
+                }
+                Buffer buffer(const_cast<char*>(header.data()), magic_len, header.size());
+                return BufferHelper::ReadVarInt64(buffer, length) && BufferHelper::ReadVarUInt64(buffer, first.ms)
+                        && BufferHelper::ReadVarUInt64(buffer, first.seq) && BufferHelper::ReadVarUInt64(buffer, last.ms)
+                        && BufferHelper::ReadVarUInt64(buffer, last.seq) && BufferHelper::ReadVarInt64(buffer, chunks)
+                        && BufferHelper::ReadVarInt64(buffer, last_chunk) && BufferHelper::ReadVarInt64(buffer, last_chunk_entries);
+            }
+    };
+
+    struct StreamEntry
+    {
+            StreamID id;
+            StringArray fields;
+    };
+    typedef std::vector<StreamEntry> StreamEntryArray;
+
+    static void encode_stream_entry(int64 idx, const StreamEntry& entry, std::string& content)
+    {
+        Buffer buffer;
+        BufferHelper::WriteVarUInt64(buffer, entry.id.ms - (uint64) idx);
+        BufferHelper::WriteVarUInt64(buffer, entry.id.seq);
+        BufferHelper::WriteVarUInt32(buffer, entry.fields.size());
+        for (size_t i = 0; i < entry.fields.size(); i++)
+        {
+            BufferHelper::WriteVarString(buffer, entry.fields[i]);
+        }
+        content.append(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+    }
+
+    static bool decode_stream_chunk(int64 idx, const std::string& content, StreamEntryArray& entries)
+    {
+        entries.clear();
+        Buffer buffer(const_cast<char*>(content.data()), 0, content.size());
+        while (buffer.Readable())
+        {
+            StreamEntry entry;
+            uint32 nfields = 0;
+            if (!BufferHelper::ReadVarUInt64(buffer, entry.id.ms) || !BufferHelper::ReadVarUInt64(buffer, entry.id.seq)
+                    || !BufferHelper::ReadVarUInt32(buffer, nfields))
+            {
+                return false;
+            }
+            entry.id.ms += idx;
+            entry.fields.resize(nfields);
+            for (uint32 i = 0; i < nfields; i++)
+            {
+                if (!BufferHelper::ReadVarString(buffer, entry.fields[i]))
+                {
+                    return false;
+                }
+            }
+            entries.push_back(entry);
+        }
+        return true;
+    }
+
+    static bool decode_stream(ValueObject& meta, StreamMeta& sm)
+    {
+        if (meta.GetType() != KEY_STRING || !meta.IsChunked())
+        {
+            return false;
+        }
+        std::string header;
+        meta.GetChunkedHeader().ToString(header);
+        return sm.Decode(header);
+    }
+
+    static void add_stream_entry(RedisReply& entries, const StreamEntry& entry)
+    {
+        RedisReply& r = entries.AddMember();
+        r.ReserveMember(0);
+        r.AddMember().SetString(entry.id.ToString());
+        RedisReply& fields = r.AddMember();
+        fields.ReserveMember(0);
+        for (size_t i = 0; i < entry.fields.size(); i++)
+        {
+            fields.AddMember().SetString(entry.fields[i]);
+        }
+    }
+
+    /*
+     * MAXLEN [~|=] n, 'i' is at MAXLEN and moved to the count.
+     */
+    static bool parse_stream_maxlen(const ArgumentArray& args, size_t& i, int64& maxlen, bool& approx)
+    {
+        approx = false;
+        if (i + 1 < args.size() && (args[i + 1] == "~" || args[i + 1] == "="))
+        {
+            approx = args[i + 1] == "~";
+            i++;
+        }
+        if (i + 1 >= args.size() || !string_toint64(args[i + 1], maxlen) || maxlen < 0)
+        {
+            return false;
+        }
+        i++;
+        return true;
+    }
+
+    bool Ardb::IsStream(ValueObject& meta)
+    {
+        StreamMeta sm;
+        return decode_stream(meta, sm);
+    }
+
+    /*
+     * Entries between 'start' & 'end'(both included) in id order, or reversed, at most 'count' if it's positive.
+     */
+    int Ardb::StreamRange(Context& ctx, const KeyObject& key, const StreamID& start, const StreamID& end, int64 count, bool reverse,
+            RedisReply& entries)
+    {
+        entries.ReserveMember(0);
+        if (end < start)
+        {
+            return 0;
+        }
+        uint64 target = reverse ? end.ms : start.ms;
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        chunk_key.SetBitmapChunk(target > (uint64) INT64_MAX ? INT64_MAX : (int64) target);
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(chunk_key);
+        iter_opts.total_order = true;
+        Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+        /*
+         * seek to the last block starting before the target, or the first block if all start after it
+         */
+        if (!iter->Valid())
+        {
+            iter->JumpToLast();
+        }
+        else if ((uint64) iter->Key().GetBitmapChunk() > target)
+        {
+            iter->Prev();
+            if (!iter->Valid() && !reverse)
+            {
+                iter->Jump(chunk_key);
+            }
+        }
+        int64 added = 0;
+        int err = 0;
+        StreamEntryArray chunk_entries;
+        while (iter->Valid() && (count <= 0 || added < count))
+        {
+            int64 idx = iter->Key().GetBitmapChunk();
+            if (!reverse && (uint64) idx > end.ms)
+            {
+                break;
+            }
+            std::string content;
+            iter->Value().GetStringValue().ToString(content);
+            if (!decode_stream_chunk(idx, content, chunk_entries))
+            {
+                err = ERR_INVALID_STREAM;
+                break;
+            }
+            bool done = false;
+            for (size_t i = 0; i < chunk_entries.size() && !done && (count <= 0 || added < count); i++)
+            {
+                const StreamEntry& entry = chunk_entries[reverse ? chunk_entries.size() - 1 - i : i];
+                if (entry.id < start)
+                {
+                    done = reverse;
+                    continue;
+                }
+                if (end < entry.id)
+                {
+                    done = !reverse;
+                    continue;
+                }
+                add_stream_entry(entries, entry);
+                added++;
+            }
+            if (done)
+            {
+                break;
+            }
+            if (reverse)
+            {
+                iter->Prev();
+            }
+            else
+            {
+                iter->Next();
+            }
+        }
+        DELETE(iter);
+        return err;
+    }
+
+    /*
+     * Drop the oldest entries until at most 'maxlen' are left. Whole blocks are removed, with 'approx' a block
+     * keeping entries over the limit is left as it is, otherwise it's rewritten without its oldest entries.
+     * 'open' is the content of the last block, which may not be written yet, it's updated in place.
+     */
+    int Ardb::TrimStream(Context& ctx, const KeyObject& key, StreamMeta& sm, int64 maxlen, bool approx, std::string& open)
+    {
+        if (sm.length <= maxlen)
+        {
+            return 0;
+        }
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(chunk_key);
+        Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+        int err = 0;
+        StreamEntryArray entries;
+        while (0 == err)
+        {
+            bool is_open = !iter->Valid() || iter->Key().GetBitmapChunk() == sm.last_chunk;
+            int64 idx = is_open ? sm.last_chunk : iter->Key().GetBitmapChunk();
+            std::string content;
+            if (is_open)
+            {
+                content = open;
+            }
+            else
+            {
+                iter->Value().GetStringValue().ToString(content);
+            }
+            if (!decode_stream_chunk(idx, content, entries))
+            {
+                err = ERR_INVALID_STREAM;
+                break;
+            }
+            if (entries.empty())
+            {
+                break;
+            }
+            int64 n = entries.size();
+            if (sm.length <= maxlen)
+            {
+                sm.first = entries[0].id;
+                break;
+            }
+            KeyObject block_key(chunk_key);
+            block_key.SetBitmapChunk(idx);
+            if (sm.length - n >= maxlen)
+            {
+                err = RemoveKey(ctx, block_key);
+                sm.length -= n;
+                sm.chunks--;
+                if (is_open)
+                {
+                    open.clear();
+                    sm.last_chunk_entries = 0;
+                    break;
+                }
+                iter->Next();
+                continue;
+            }
+            if (approx)
+            {
+                sm.first = entries[0].id;
+                break;
+            }
+            int64 drop = sm.length - maxlen;
+            content.clear();
+            for (int64 i = drop; i < n; i++)
+            {
+                encode_stream_entry(idx, entries[i], content);
+            }
+            sm.length = maxlen;
+            sm.first = entries[drop].id;
+            if (is_open)
+            {
+                open = content;
+                sm.last_chunk_entries -= drop;
+            }
+            else
+            {
+                ValueObject block;
+                block.SetType(KEY_BITMAP_CHUNK);
+                block.GetStringValue().SetString(content, false);
+                err = SetKeyValue(ctx, block_key, block);
+            }
+            break;
+        }
+        DELETE(iter);
+        return err;
+    }
+
+    /*
+     * XADD key [MAXLEN [~|=] n] id|ms-*|* field value [field value ...]
+     */
+    int Ardb::XAdd(Context& ctx, RedisCommandFrame& cmd)
+    {
+        ctx.flags.create_if_notexist = 1;
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        int64 maxlen = -1;
+        bool approx = false;
+        size_t id_pos = 1;
+        if (!strcasecmp(args[id_pos].c_str(), "maxlen"))
+        {
+            if (!parse_stream_maxlen(args, id_pos, maxlen, approx))
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            id_pos++;
+        }
+        size_t nfields = id_pos < args.size() ? args.size() - id_pos - 1 : 0;
+        if (nfields == 0 || nfields % 2 != 0)
+        {
+            reply.SetErrorReason("ERR wrong number of arguments for 'xadd' command");
+            return 0;
+        }
+        const std::string& keystr = args[0];
+        KeyObject key(ctx.ns, KEY_META, keystr);
+        {
+            KeyLockGuard guard(ctx, key);
+            ValueObject meta;
+            if (!CheckMeta(ctx, key, KEY_STRING, meta))
+            {
+                return 0;
+            }
+            StreamMeta sm;
+            bool created = meta.GetType() == 0;
+            if (created)
+            {
+                meta.SetType(KEY_STRING);
+                meta.SetChunked(true);
+                meta.SetChunkSize(GetConf().stream_node_max_entries > 0 ? GetConf().stream_node_max_entries : 100);
+                meta.SetChunkedLength(0);
+            }
+            else if (!decode_stream(meta, sm))
+            {
+                reply.SetErrCode(ERR_INVALID_STREAM);
+                return 0;
+            }
+            StreamEntry entry;
+            const std::string& idstr = args[id_pos];
+            bool auto_seq = idstr.size() > 2 && idstr.compare(idstr.size() - 2, 2, "-*") == 0;
+            if (idstr == "*")
+            {
+                entry.id.ms = get_current_epoch_millis();
+                if (!(sm.last < entry.id))
+                {
+                    entry.id = sm.last;
+                    entry.id.Incr();
+                }
+            }
+            else if (auto_seq)
+            {
+                if (!string_touint64(idstr.substr(0, idstr.size() - 2), entry.id.ms))
+                {
+                    reply.SetErrorReason("ERR Invalid stream ID specified as stream command argument");
+                    return 0;
+                }
+                entry.id.seq = entry.id.ms == sm.last.ms && sm.last.seq < UINT64_MAX ? sm.last.seq + 1 : 0;
+            }
+            else if (!entry.id.Parse(idstr, 0))
+            {
+                reply.SetErrorReason("ERR Invalid stream ID specified as stream command argument");
+                return 0;
+            }
+            if (entry.id == StreamID(0, 0))
+            {
+                reply.SetErrorReason("ERR The ID specified in XADD must be greater than 0-0");
+                return 0;
+            }
+            if (!(sm.last < entry.id) || entry.id.ms > (uint64) INT64_MAX)
+            {
+                reply.SetErrorReason("ERR The ID specified in XADD is equal or smaller than the target stream top item");
+                return 0;
+            }
+            entry.fields.assign(args.begin() + id_pos + 1, args.end());
+
+            bool rollover = sm.last_chunk_entries == 0 || (sm.last_chunk_entries >= meta.GetChunkSize() && sm.last.ms < entry.id.ms);
+            std::string open;
+            int err = 0;
+            if (rollover)
+            {
+                sm.last_chunk = entry.id.ms;
+                sm.last_chunk_entries = 0;
+                sm.chunks++;
+            }
+            else
+            {
+                err = GetBitmapChunk(ctx, key, sm.last_chunk, open);
+                if (0 != err)
+                {
+                    reply.SetErrCode(err);
+                    return 0;
+                }
+            }
+            encode_stream_entry(sm.last_chunk, entry, open);
+            sm.last_chunk_entries++;
+            if (sm.length == 0)
+            {
+                sm.first = entry.id;
+            }
+            sm.length++;
+            sm.last = entry.id;
+            {
+                WriteBatchGuard batch(ctx, m_engine);
+                if (created)
+                {
+                    ClearBitmapChunks(ctx, key);
+                }
+                if (maxlen >= 0)
+                {
+                    err = TrimStream(ctx, key, sm, maxlen, approx, open);
+                }
+                if (0 == err && !open.empty())
+                {
+                    KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+                    chunk_key.SetBitmapChunk(sm.last_chunk);
+                    ValueObject block;
+                    block.SetType(KEY_BITMAP_CHUNK);
+                    block.GetStringValue().SetString(open, false);
+                    err = SetKeyValue(ctx, chunk_key, block);
+                }
+                if (0 == err)
+                {
+                    std::string header;
+                    sm.Encode(header);
+                    meta.GetChunkedHeader().SetString(header, true);
+                    err = SetKeyValue(ctx, key, meta);
+                }
+                if (0 != err)
+                {
+                    batch.MarkFailed(err);
+                }
+            }
+            if (0 == err)
+            {
+                err = ctx.transc_err;
+            }
+            if (0 != err)
+            {
+                reply.SetErrCode(err);
+                return 0;
+            }
+            reply.SetString(entry.id.ToString());
+            if (idstr == "*" || auto_seq)
+            {
+                /*
+                 * replicate the id generated here
+                 */
+                cmd.GetMutableArguments()[id_pos] = entry.id.ToString();
+                cmd.ClearRawProtocolData();
+            }
+        }
+        SignalListAsReady(ctx, keystr);
+        return 0;
+    }
+
+    int Ardb::XLen(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        StreamMeta sm;
+        if (meta.GetType() > 0 && !decode_stream(meta, sm))
+        {
+            reply.SetErrCode(ERR_INVALID_STREAM);
+            return 0;
+        }
+        reply.SetInteger(sm.length);
+        return 0;
+    }
+
+    /*
+     * XRANGE key start end [COUNT n] & XREVRANGE key end start [COUNT n], '-' and '+' are the smallest and the
+     * greatest ids.
+     */
+    int Ardb::XRange(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        bool reverse = cmd.GetType() == REDIS_CMD_XREVRANGE;
+        const std::string& startstr = args[reverse ? 2 : 1];
+        const std::string& endstr = args[reverse ? 1 : 2];
+        StreamID start, end(UINT64_MAX, UINT64_MAX);
+        if ((startstr != "-" && !start.Parse(startstr, 0)) || (endstr != "+" && !end.Parse(endstr, UINT64_MAX)))
+        {
+            reply.SetErrorReason("ERR Invalid stream ID specified as stream command argument");
+            return 0;
+        }
+        int64 count = 0;
+        if (args.size() > 3)
+        {
+            if (args.size() != 5 || strcasecmp(args[3].c_str(), "count") || !string_toint64(args[4], count))
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            if (count <= 0)
+            {
+                reply.ReserveMember(0);
+                return 0;
+            }
+        }
+        KeyObject key(ctx.ns, KEY_META, args[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        reply.ReserveMember(0);
+        if (meta.GetType() == 0)
+        {
+            return 0;
+        }
+        if (!IsStream(meta))
+        {
+            reply.SetErrCode(ERR_INVALID_STREAM);
+            return 0;
+        }
+        int err = StreamRange(ctx, key, start, end, count, reverse, reply);
+        if (0 != err)
+        {
+            reply.Clear();
+            reply.SetErrCode(err);
+        }
+        return 0;
+    }
+
+    /*
+     * Serve a client blocked by XREAD with the entries added after the id it waits for on the stream, called
+     * with the key locked.
+     */
+    int Ardb::ServeClientBlockedOnStream(Context& ctx, const KeyPrefix& key)
+    {
+        BlockingState::StreamIDTable::iterator found = ctx.GetBPop().stream_ids.find(key);
+        StreamID start;
+        if (found == ctx.GetBPop().stream_ids.end() || !start.Parse(found->second, 0) || !start.Incr())
+        {
+            return -1;
+        }
+        Context tmpctx;
+        tmpctx.ns = key.ns;
+        KeyObject meta_key(key.ns, KEY_META, key.key);
+        ValueObject meta;
+        if (!CheckMeta(tmpctx, meta_key, KEY_STRING, meta) || !IsStream(meta))
+        {
+            return -1;
+        }
+        RedisReply* r = NULL;
+        NEW(r, RedisReply);
+        r->ReserveMember(0);
+        RedisReply& stream = r->AddMember();
+        stream.ReserveMember(0);
+        stream.AddMember().SetString(key.key.AsString());
+        RedisReply& entries = stream.AddMember();
+        if (0 != StreamRange(tmpctx, meta_key, start, StreamID(UINT64_MAX, UINT64_MAX), ctx.GetBPop().stream_count, false, entries)
+                || entries.MemberSize() == 0)
+        {
+            DELETE(r);
+            return -1;
+        }
+        WriteReply(ctx, r, true);
+        return 0;
+    }
+
+    /*
+     * XREAD [COUNT n] [BLOCK ms] STREAMS key... id..., '$' is the last id of the stream. A client blocked on
+     * streams waits in the same queues as BLPOP clients and is served after the XADD to one of them.
+     */
+    int Ardb::XRead(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        int64 count = 0, block = -1;
+        size_t i = 0;
+        for (; i < args.size(); i += 2)
+        {
+            if (!strcasecmp(args[i].c_str(), "streams"))
+            {
+                break;
+            }
+            int64 v = 0;
+            if (i + 1 >= args.size() || !string_toint64(args[i + 1], v) || v < 0)
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            if (!strcasecmp(args[i].c_str(), "count"))
+            {
+                count = v;
+            }
+            else if (!strcasecmp(args[i].c_str(), "block"))
+            {
+                block = v;
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        i++;
+        if (i >= args.size() || (args.size() - i) % 2 != 0)
+        {
+            reply.SetErrorReason("ERR Unbalanced XREAD list of streams: for each stream key an ID or '$' must be specified.");
+            return 0;
+        }
+        size_t nkeys = (args.size() - i) / 2;
+        StringArray keys;
+        std::vector<StreamID> ids(nkeys);
+        reply.ReserveMember(0);
+        for (size_t k = 0; k < nkeys; k++)
+        {
+            const std::string& keystr = args[i + k];
+            const std::string& idstr = args[i + nkeys + k];
+            KeyObject key(ctx.ns, KEY_META, keystr);
+            ValueObject meta;
+            if (!CheckMeta(ctx, key, KEY_STRING, meta))
+            {
+                return 0;
+            }
+            StreamMeta sm;
+            if (meta.GetType() > 0 && !decode_stream(meta, sm))
+            {
+                reply.SetErrCode(ERR_INVALID_STREAM);
+                return 0;
+            }
+            if (idstr == "$")
+            {
+                ids[k] = sm.last;
+            }
+            else if (!ids[k].Parse(idstr, 0))
+            {
+                reply.SetErrorReason("ERR Invalid stream ID specified as stream command argument");
+                return 0;
+            }
+            keys.push_back(keystr);
+            StreamID start = ids[k];
+            if (meta.GetType() == 0 || !start.Incr() || !(start < sm.last || start == sm.last))
+            {
+                continue;
+            }
+            RedisReply& stream = reply.AddMember();
+            stream.ReserveMember(0);
+            stream.AddMember().SetString(keystr);
+            int err = StreamRange(ctx, key, start, StreamID(UINT64_MAX, UINT64_MAX), count, false, stream.AddMember());
+            if (0 != err)
+            {
+                reply.Clear();
+                reply.SetErrCode(err);
+                return 0;
+            }
+        }
+        if (reply.MemberSize() > 0)
+        {
+            return 0;
+        }
+        if (block < 0 || ctx.InTransaction() || ctx.flags.lua)
+        {
+            reply.ReserveMember(-1);
+            return 0;
+        }
+        reply.type = 0; //wait
+        for (size_t k = 0; k < nkeys; k++)
+        {
+            KeyPrefix prefix;
+            prefix.ns = ctx.ns;
+            prefix.key.SetString(keys[k], false);
+            ctx.GetBPop().stream_ids[prefix] = ids[k].ToString();
+        }
+        ctx.GetBPop().stream_count = count;
+        if (block > 0)
+        {
+            ctx.GetBPop().timeout = (uint64) block * 1000 + get_current_epoch_micros();
+        }
+        BlockForKeys(ctx, keys, "", 0);
+        return 0;
+    }
+
+    /*
+     * XTRIM key MAXLEN [~|=] n
+     */
+    int Ardb::XTrim(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        size_t i = 1;
+        int64 maxlen = 0;
+        bool approx = false;
+        if (strcasecmp(args[i].c_str(), "maxlen") || !parse_stream_maxlen(args, i, maxlen, approx) || i + 1 != args.size())
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
+        KeyObject key(ctx.ns, KEY_META, args[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        StreamMeta sm;
+        if (meta.GetType() == 0 || !decode_stream(meta, sm))
+        {
+            if (meta.GetType() > 0)
+            {
+                reply.SetErrCode(ERR_INVALID_STREAM);
+            }
+            else
+            {
+                reply.SetInteger(0);
+            }
+            return 0;
+        }
+        int64 length = sm.length;
+        std::string open, old_open;
+        int err = sm.last_chunk_entries > 0 ? GetBitmapChunk(ctx, key, sm.last_chunk, open) : 0;
+        old_open = open;
+        if (0 == err)
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            err = TrimStream(ctx, key, sm, maxlen, approx, open);
+            if (0 == err && !open.empty() && open != old_open)
+            {
+                KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+                chunk_key.SetBitmapChunk(sm.last_chunk);
+                ValueObject block;
+                block.SetType(KEY_BITMAP_CHUNK);
+                block.GetStringValue().SetString(open, false);
+                err = SetKeyValue(ctx, chunk_key, block);
+            }
+            if (0 == err && length != sm.length)
+            {
+                std::string header;
+                sm.Encode(header);
+                meta.GetChunkedHeader().SetString(header, true);
+                err = SetKeyValue(ctx, key, meta);
+            }
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        if (0 == err)
+        {
+            err = ctx.transc_err;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetInteger(length - sm.length);
+        }
+        return 0;
+    }
+
+    /*
+     * XDEL key id [id ...], each block holding some of the ids is rewritten once without them, or removed if no
+     * entry is left in it. Block indexes are kept, so the entries of a block still start at or after its index.
+     */
+    int Ardb::XDel(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        std::vector<StreamID> ids(args.size() - 1);
+        for (size_t i = 1; i < args.size(); i++)
+        {
+            if (!ids[i - 1].Parse(args[i], 0))
+            {
+                reply.SetErrorReason("ERR Invalid stream ID specified as stream command argument");
+                return 0;
+            }
+        }
+        KeyObject key(ctx.ns, KEY_META, args[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        StreamMeta sm;
+        if (meta.GetType() == 0 || !decode_stream(meta, sm))
+        {
+            if (meta.GetType() > 0)
+            {
+                reply.SetErrCode(ERR_INVALID_STREAM);
+            }
+            else
+            {
+                reply.SetInteger(0);
+            }
+            return 0;
+        }
+        /*
+         * the block of an id is the last one whose index is not after it
+         */
+        std::map<int64, std::string> blocks;
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(chunk_key);
+        iter_opts.total_order = true;
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            if (ids[i].ms > (uint64) INT64_MAX)
+            {
+                continue;
+            }
+            chunk_key.SetBitmapChunk((int64) ids[i].ms);
+            Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+            if (!iter->Valid())
+            {
+                iter->JumpToLast();
+            }
+            else if ((uint64) iter->Key().GetBitmapChunk() > ids[i].ms)
+            {
+                iter->Prev();
+            }
+            if (iter->Valid() && blocks.find(iter->Key().GetBitmapChunk()) == blocks.end())
+            {
+                iter->Value().GetStringValue().ToString(blocks[iter->Key().GetBitmapChunk()]);
+            }
+            DELETE(iter);
+        }
+        int64 length = sm.length;
+        bool first_removed = false;
+        StreamEntryArray entries;
+        int err = 0;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            std::map<int64, std::string>::iterator it = blocks.begin();
+            for (; it != blocks.end() && 0 == err; it++)
+            {
+                if (!decode_stream_chunk(it->first, it->second, entries))
+                {
+                    err = ERR_INVALID_STREAM;
+                    break;
+                }
+                std::string content;
+                int64 removed = 0;
+                for (size_t i = 0; i < entries.size(); i++)
+                {
+                    if (std::find(ids.begin(), ids.end(), entries[i].id) != ids.end())
+                    {
+                        first_removed = first_removed || entries[i].id == sm.first;
+                        removed++;
+                        continue;
+                    }
+                    encode_stream_entry(it->first, entries[i], content);
+                }
+                if (removed == 0)
+                {
+                    continue;
+                }
+                KeyObject block_key(chunk_key);
+                block_key.SetBitmapChunk(it->first);
+                if (content.empty())
+                {
+                    err = RemoveKey(ctx, block_key);
+                    sm.chunks--;
+                }
+                else
+                {
+                    ValueObject block;
+                    block.SetType(KEY_BITMAP_CHUNK);
+                    block.GetStringValue().SetString(content, false);
+                    err = SetKeyValue(ctx, block_key, block);
+                }
+                if (it->first == sm.last_chunk)
+                {
+                    sm.last_chunk_entries -= removed;
+                }
+                sm.length -= removed;
+                it->second = content;
+            }
+            /*
+             * the first entry left is in the first block not emptied, reading the rewritten blocks from 'blocks'
+             */
+            if (0 == err && first_removed && sm.length > 0)
+            {
+                chunk_key.SetBitmapChunk(0);
+                Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+                while (iter->Valid())
+                {
+                    std::string content;
+                    int64 idx = iter->Key().GetBitmapChunk();
+                    if (blocks.find(idx) != blocks.end())
+                    {
+                        content = blocks[idx];
+                    }
+                    else
+                    {
+                        iter->Value().GetStringValue().ToString(content);
+                    }
+                    if (!decode_stream_chunk(idx, content, entries))
+                    {
+                        err = ERR_INVALID_STREAM;
+                        break;
+                    }
+                    if (!entries.empty())
+                    {
+                        sm.first = entries[0].id;
+                        break;
+                    }
+                    iter->Next();
+                }
+                DELETE(iter);
+            }
+            if (0 == err && length != sm.length)
+            {
+                std::string header;
+                sm.Encode(header);
+                meta.GetChunkedHeader().SetString(header, true);
+                err = SetKeyValue(ctx, key, meta);
+            }
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        if (0 == err)
+        {
+            err = ctx.transc_err;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetInteger(length - sm.length);
+        }
+        return 0;
+    }
+OP_NAMESPACE_END
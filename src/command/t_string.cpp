@@ -46,6 +46,7 @@ OP_NAMESPACE_BEGIN
         }
         else
         {
+            LoadBitmapChunks(ctx, keyobj, v);
             reply.SetString(v.GetStringValue());
         }
         return 0;
@@ -77,6 +78,7 @@ OP_NAMESPACE_BEGIN
             }
             else
             {
+                LoadBitmapChunks(ctx, ks[i], vs[i]);
                 r.SetString(vs[i].GetStringValue());
             }
         }
@@ -106,9 +108,11 @@ OP_NAMESPACE_BEGIN
         int err = 0;
         RedisReply& reply = ctx.GetReply();
         /*
-         * merge append
+         * merge append, not if strings may be chunked since the merge would land on the meta of a chunked one,
+         * the reply stays the one of the merge then.
          */
-        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        bool merge = !ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge;
+        if (merge && GetConf().bitmap_chunk_size <= 0)
         {
             Data merge_data;
             merge_data.SetString(append, false);
@@ -127,12 +131,17 @@ OP_NAMESPACE_BEGIN
         {
             return 0;
         }
+        bool chunked = LoadBitmapChunks(ctx, key, v) > 0;
         MergeAppend(ctx, key, v, append);
-        err = SetKeyValue(ctx, key, v);
+        err = chunked ? SetUnchunkedValue(ctx, key, v) : SetKeyValue(ctx, key, v);
         if (err < 0)
         {
             reply.SetErrCode(err);
         }
+        else if (merge)
+        {
+            reply.SetStatusCode(STATUS_OK);
+        }
         else
         {
             reply.SetInteger(v.GetStringValue().StringLength());
@@ -198,6 +207,10 @@ OP_NAMESPACE_BEGIN
                         valueobj.SetType(KEY_STRING);
                         valueobj.SetTTL(0);
                         valueobj.GetStringValue().SetString(cmd.GetArguments()[i + 1], true, false);
+                        if (GetConf().bitmap_chunk_size > 0)
+                        {
+                            ClearBitmapChunks(ctx, key);
+                        }
                         SetKeyValue(ctx, key, valueobj);
                     }
                 }
@@ -217,6 +230,10 @@ OP_NAMESPACE_BEGIN
                             break;
                         }
                     }
+                    if (valueobj.IsChunked())
+                    {
+                        ClearBitmapChunks(ctx, key);
+                    }
                     ValueObject value;
                     value.SetType(KEY_STRING);
                     value.GetStringValue().SetString(cmd.GetArguments()[i + 1], true, false);
@@ -268,9 +285,10 @@ OP_NAMESPACE_BEGIN
         int err = 0;
         KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
         /*
-         * merge incr
+         * merge incr, not if strings may be chunked
          */
-        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        bool merge = !ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge;
+        if (merge && GetConf().bitmap_chunk_size <= 0)
         {
             Data merge_data;
             merge_data.SetFloat64(increment);
@@ -289,16 +307,21 @@ OP_NAMESPACE_BEGIN
         err = m_engine->Get(ctx, key, v);
         if (err == ERR_ENTRY_NOT_EXIST || 0 == err)
         {
+            bool chunked = LoadBitmapChunks(ctx, key, v) > 0;
             err = MergeIncrByFloat(ctx, key, v, increment);
             if (0 == err)
             {
-                err = SetKeyValue(ctx, key, v);
+                err = chunked ? SetUnchunkedValue(ctx, key, v) : SetKeyValue(ctx, key, v);
             }
         }
         if (err != 0)
         {
             reply.SetErrCode(err);
         }
+        else if (merge)
+        {
+            reply.SetStatusCode(STATUS_OK);
+        }
         else
         {
             reply.SetDouble(v.GetStringValue().GetFloat64());
@@ -336,9 +359,10 @@ OP_NAMESPACE_BEGIN
         KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
         int err = 0;
         /*
-         * merge incr
+         * merge incr, not if strings may be chunked
          */
-        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        bool merge = !ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge;
+        if (merge && GetConf().bitmap_chunk_size <= 0)
         {
             Data merge_data;
             merge_data.SetInt64(incr);
@@ -360,11 +384,13 @@ OP_NAMESPACE_BEGIN
             switch (cmd.GetType())
             {
                 case REDIS_CMD_DECR:
+                case REDIS_CMD_DECR2:
                 {
                     incr = -1;
                     break;
                 }
                 case REDIS_CMD_DECRBY:
+                case REDIS_CMD_DECRBY2:
                 {
                     incr = 0 - incr;
                     break;
@@ -374,16 +400,21 @@ OP_NAMESPACE_BEGIN
                     break;
                 }
             }
+            bool chunked = LoadBitmapChunks(ctx, key, v) > 0;
             err = MergeIncrBy(ctx, key, v, incr);
             if (0 == err)
             {
-                err = SetKeyValue(ctx, key, v);
+                err = chunked ? SetUnchunkedValue(ctx, key, v) : SetKeyValue(ctx, key, v);
             }
         }
         if (err < 0)
         {
             reply.SetErrCode(err);
         }
+        else if (merge)
+        {
+            reply.SetStatusCode(STATUS_OK);
+        }
         else
         {
             reply.SetInteger(v.GetStringValue().GetInt64());
@@ -429,9 +460,10 @@ OP_NAMESPACE_BEGIN
                 reply.SetErrCode(ERR_WRONG_TYPE);
                 return 0;
             }
+            bool chunked = LoadBitmapChunks(ctx, keyobj, value) > 0;
             reply.SetString(value.GetStringValue());
             value.GetStringValue().SetString(cmd.GetArguments()[1], true);
-            err = SetKeyValue(ctx, keyobj, value);
+            err = chunked ? SetUnchunkedValue(ctx, keyobj, value) : SetKeyValue(ctx, keyobj, value);
             if (0 != err)
             {
                 reply.SetErrCode(err);
@@ -469,6 +501,7 @@ OP_NAMESPACE_BEGIN
                 reply.SetErrCode(ERR_WRONG_TYPE);
                 return 0;
             }
+            LoadBitmapChunks(ctx, keyobj, value);
             std::string str;
             value.GetStringValue().ToString(str);
             size_t strlen = str.size();
@@ -554,7 +587,12 @@ OP_NAMESPACE_BEGIN
         {
             redis_compatible = true;
         }
-        if (redis_compatible)
+        /*
+         * an existing chunked string must be read to drop its chunks, merges & blind writes would only replace its
+         * meta, the reply stays the one of the merge.
+         */
+        bool read_chunks = !redis_compatible && GetConf().bitmap_chunk_size > 0;
+        if (redis_compatible || read_chunks)
         {
             if (!CheckMeta(ctx, key, KEY_STRING, valueobj))
             {
@@ -563,10 +601,11 @@ OP_NAMESPACE_BEGIN
             Data merge;
             merge.SetString(value, true);
             int64 oldttl = valueobj.GetTTL();
+            bool chunked = valueobj.IsChunked();
             err = MergeSet(ctx, keyobj, valueobj, op, merge, ttl);
             if (0 == err)
             {
-                err = SetKeyValue(ctx, keyobj, valueobj);
+                err = chunked ? SetUnchunkedValue(ctx, keyobj, valueobj) : SetKeyValue(ctx, keyobj, valueobj);
                 if (0 == err)
                 {
                     SaveTTL(ctx, keyobj.GetNameSpace(), key, oldttl, ttl);
@@ -601,6 +640,10 @@ OP_NAMESPACE_BEGIN
                 err = MergeKeyValue(ctx, keyobj, op, merge_data);
             }
         }
+        if (read_chunks && ERR_NOTPERFORMED == err)
+        {
+            err = 0;
+        }
         return err;
     }
 
@@ -753,9 +796,10 @@ OP_NAMESPACE_BEGIN
         int err = 0;
 
         /*
-         * merge setrange
+         * merge setrange, not if strings may be chunked
          */
-        if (!ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge)
+        bool merge = !ctx.flags.redis_compatible && m_engine->GetFeatureSet().support_merge;
+        if (merge && GetConf().bitmap_chunk_size <= 0)
         {
             DataArray args(2);
             args[0].SetInt64(offset);
@@ -784,15 +828,20 @@ OP_NAMESPACE_BEGIN
                 reply.SetErrCode(err);
                 return 0;
             }
+            bool chunked = LoadBitmapChunks(ctx, keyobj, valueobj) > 0;
             err = MergeSetRange(ctx, keyobj, valueobj, offset, cmd.GetArguments()[2]);
             if (0 == err)
             {
-                err = SetKeyValue(ctx, keyobj, valueobj);
+                err = chunked ? SetUnchunkedValue(ctx, keyobj, valueobj) : SetKeyValue(ctx, keyobj, valueobj);
             }
             if (0 != err)
             {
                 reply.SetErrCode(err);
             }
+            else if (merge)
+            {
+                reply.SetStatusCode(STATUS_OK);
+            }
             else
             {
                 reply.SetInteger(valueobj.GetStringValue().StringLength());
@@ -809,6 +858,11 @@ OP_NAMESPACE_BEGIN
         {
             return 0;
         }
+        if (value.IsChunked())
+        {
+            reply.SetInteger(value.GetChunkedLength());
+            return 0;
+        }
         reply.SetInteger(value.GetStringValue().StringLength());
         return 0;
     }
@@ -0,0 +1,850 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "db/db.hpp"
+
+/*
+ * Time series are chunked strings like bloom filters: the meta holds the series header, the samples are stored
+ * in KEY_BITMAP_CHUNK keys, one chunk per 'chunk span' milliseconds of timestamps, so a range read is a
+ * sequential scan of the chunks covering it. Samples are compressed as in Facebook's Gorilla: timestamps as
+ * delta of deltas, values as the xor with the previous value. A chunk keeps the encoder state in front of its
+ * bit stream, so an append only decodes the chunk header.
+ *
+ * Samples older than 'retention' milliseconds before the last sample are dropped a chunk at a time when a new
+ * chunk is started, and the key expires 'retention' after the last chunk was started, so an idle series is
+ * removed by the normal ttl machinery.
+ */
+OP_NAMESPACE_BEGIN
+    static const char* kTimeSeriesMagic = "TS01";
+    static const int64 kTimeSeriesDefaultChunkSpan = 2 * 3600 * 1000;
+
+    struct TimeSeries
+    {
+            int64 retention; //0 keeps all samples
+            int64 samples;
+            int64 chunks;
+            int64 first_ts;
+            int64 last_ts;
+            double last_value;
+            TimeSeries() :
+                    retention(0), samples(0), chunks(0), first_ts(0), last_ts(0), last_value(0)
+            {
+            }
+            void Encode(std::string& header) const
+            {
+                Buffer buffer;
+                buffer.Write(kTimeSeriesMagic, strlen(kTimeSeriesMagic));
+                BufferHelper::WriteVarInt64(buffer, retention);
+                BufferHelper::WriteVarInt64(buffer, samples);
+                BufferHelper::WriteVarInt64(buffer, chunks);
+                BufferHelper::WriteVarInt64(buffer, first_ts);
+                BufferHelper::WriteVarInt64(buffer, last_ts);
+                BufferHelper::WriteFixDouble(buffer, last_value);
+                header.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+            }
+            bool Decode(const std::string& header)
+            {
+                size_t magic_len = strlen(kTimeSeriesMagic);
+                if (header.size() < magic_len || header.compare(0, magic_len, kTimeSeriesMagic) != 0)
+                {
+                    return false;
+                }
+                Buffer buffer(const_cast<char*>(header.data()), magic_len, header.size());
+                return BufferHelper::ReadVarInt64(buffer, retention) && BufferHelper::ReadVarInt64(buffer, samples)
+                        && BufferHelper::ReadVarInt64(buffer, chunks) && BufferHelper::ReadVarInt64(buffer, first_ts)
+                        && BufferHelper::ReadVarInt64(buffer, last_ts) && BufferHelper::ReadFixDouble(buffer, last_value);
+            }
+    };
+
+    /*
+     * One chunk of samples: the state of the encoder after the last sample, followed by the bit stream.
+     */
+    struct SeriesChunk
+    {
+            int64 last_ts;
+            int64 last_delta;
+            uint64 last_value;
+            uint8 leading;
+            uint8 meaningful; //0 if there is no previous xor window
+            int64 count;
+            int64 bits;
+            std::string stream;
+            SeriesChunk() :
+                    last_ts(0), last_delta(0), last_value(0), leading(0), meaningful(0), count(0), bits(0)
+            {
+            }
+            void WriteBits(uint64 v, int n)
+            {
+                while (n > 0)
+                {
+                    if ((bits & 0x7) == 0)
+                    {
+                        stream.push_back(0);
+                    }
+                    int free = 8 - (bits & 0x7);
+                    int take = n < free ? n : free;
+                    uint8 part = (uint8) ((v >> (n - take)) & ((1 << take) - 1));
+                    stream[bits >> 3] |= (char) (part << (free - take));
+                    bits += take;
+                    n -= take;
+                }
+            }
+            void Append(int64 ts, double value)
+            {
+                uint64 v;
+                memcpy(&v, &value, sizeof(v));
+                if (count == 0)
+                {
+                    WriteBits((uint64) ts, 64);
+                    WriteBits(v, 64);
+                }
+                else
+                {
+                    int64 delta = ts - last_ts;
+                    int64 dod = delta - last_delta;
+                    if (dod == 0)
+                    {
+                        WriteBits(0, 1);
+                    }
+                    else if (dod >= -63 && dod <= 64)
+                    {
+                        WriteBits(0x2, 2);
+                        WriteBits((uint64) (dod + 63), 7);
+                    }
+                    else if (dod >= -255 && dod <= 256)
+                    {
+                        WriteBits(0x6, 3);
+                        WriteBits((uint64) (dod + 255), 9);
+                    }
+                    else if (dod >= -2047 && dod <= 2048)
+                    {
+                        WriteBits(0xE, 4);
+                        WriteBits((uint64) (dod + 2047), 12);
+                    }
+                    else
+                    {
+                        WriteBits(0xF, 4);
+                        WriteBits((uint64) dod, 64);
+                    }
+                    last_delta = delta;
+                    uint64 x = v ^ last_value;
+                    if (x == 0)
+                    {
+                        WriteBits(0, 1);
+                    }
+                    else
+                    {
+                        int lz = __builtin_clzll(x);
+                        int tz = __builtin_ctzll(x);
+                        if (lz > 31)
+                        {
+                            lz = 31;
+                        }
+                        if (meaningful > 0 && lz >= leading && tz >= 64 - leading - meaningful)
+                        {
+                            WriteBits(0x2, 2);
+                            WriteBits(x >> (64 - leading - meaningful), meaningful);
+                        }
+                        else
+                        {
+                            leading = lz;
+                            meaningful = 64 - lz - tz;
+                            WriteBits(0x3, 2);
+                            WriteBits(leading, 5);
+                            WriteBits(meaningful - 1, 6);
+                            WriteBits(x >> tz, meaningful);
+                        }
+                    }
+                }
+                last_ts = ts;
+                last_value = v;
+                count++;
+            }
+            void Encode(std::string& content) const
+            {
+                Buffer buffer;
+                BufferHelper::WriteVarInt64(buffer, last_ts);
+                BufferHelper::WriteVarInt64(buffer, last_delta);
+                BufferHelper::WriteFixUInt64(buffer, last_value);
+                BufferHelper::WriteFixUInt8(buffer, leading);
+                BufferHelper::WriteFixUInt8(buffer, meaningful);
+                BufferHelper::WriteVarInt64(buffer, count);
+                BufferHelper::WriteVarInt64(buffer, bits);
+                content.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+                content.append(stream);
+            }
+            bool Decode(const std::string& content)
+            {
+                Buffer buffer(const_cast<char*>(content.data()), 0, content.size());
+                if (!BufferHelper::ReadVarInt64(buffer, last_ts) || !BufferHelper::ReadVarInt64(buffer, last_delta)
+                        || !BufferHelper::ReadFixUInt64(buffer, last_value) || !BufferHelper::ReadFixUInt8(buffer, leading)
+                        || !BufferHelper::ReadFixUInt8(buffer, meaningful) || !BufferHelper::ReadVarInt64(buffer, count)
+                        || !BufferHelper::ReadVarInt64(buffer, bits) || count <= 0 || bits < 128
+                        || (int64) buffer.ReadableBytes() != (bits + 7) / 8)
+                {
+                    return false;
+                }
+                stream.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+                return true;
+            }
+    };
+
+    /*
+     * Decodes the samples of a chunk bit stream.
+     */
+    struct SeriesChunkReader
+    {
+            const SeriesChunk& chunk;
+            int64 pos;
+            int64 read;
+            int64 ts;
+            int64 delta;
+            uint64 value;
+            uint8 leading;
+            uint8 meaningful;
+            SeriesChunkReader(const SeriesChunk& c) :
+                    chunk(c), pos(0), read(0), ts(0), delta(0), value(0), leading(0), meaningful(0)
+            {
+            }
+            uint64 ReadBits(int n)
+            {
+                uint64 v = 0;
+                while (n > 0)
+                {
+                    int avail = 8 - (pos & 0x7);
+                    int take = n < avail ? n : avail;
+                    uint8 byte = (uint8) chunk.stream[pos >> 3];
+                    v = (v << take) | ((byte >> (avail - take)) & ((1 << take) - 1));
+                    pos += take;
+                    n -= take;
+                }
+                return v;
+            }
+            bool Next(int64& sample_ts, double& sample_value)
+            {
+                if (read >= chunk.count)
+                {
+                    return false;
+                }
+                if (read == 0)
+                {
+                    ts = (int64) ReadBits(64);
+                    value = ReadBits(64);
+                }
+                else
+                {
+                    int64 dod = 0;
+                    if (ReadBits(1) == 0)
+                    {
+                        dod = 0;
+                    }
+                    else if (ReadBits(1) == 0)
+                    {
+                        dod = (int64) ReadBits(7) - 63;
+                    }
+                    else if (ReadBits(1) == 0)
+                    {
+                        dod = (int64) ReadBits(9) - 255;
+                    }
+                    else if (ReadBits(1) == 0)
+                    {
+                        dod = (int64) ReadBits(12) - 2047;
+                    }
+                    else
+                    {
+                        dod = (int64) ReadBits(64);
+                    }
+                    delta += dod;
+                    ts += delta;
+                    if (ReadBits(1) == 1)
+                    {
+                        if (ReadBits(1) == 1)
+                        {
+                            leading = ReadBits(5);
+                            meaningful = ReadBits(6) + 1;
+                        }
+                        value ^= ReadBits(meaningful) << (64 - leading - meaningful);
+                    }
+                }
+                read++;
+                sample_ts = ts;
+                memcpy(&sample_value, &value, sizeof(sample_value));
+                return true;
+            }
+    };
+
+    static bool decode_time_series(ValueObject& meta, TimeSeries& ts)
+    {
+        if (meta.GetType() != KEY_STRING || !meta.IsChunked())
+        {
+            return false;
+        }
+        std::string header;
+        meta.GetChunkedHeader().ToString(header);
+        return ts.Decode(header);
+    }
+
+    static bool parse_series_options(RedisCommandFrame& cmd, size_t start, TimeSeries& ts, int64& chunk_span, RedisReply& reply)
+    {
+        for (size_t i = start; i < cmd.GetArguments().size(); i += 2)
+        {
+            int64 v = 0;
+            if (i + 1 >= cmd.GetArguments().size() || !string_toint64(cmd.GetArguments()[i + 1], v))
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return false;
+            }
+            if (!strcasecmp(cmd.GetArguments()[i].c_str(), "retention") && v >= 0)
+            {
+                ts.retention = v;
+            }
+            else if (!strcasecmp(cmd.GetArguments()[i].c_str(), "chunk_span") && v > 0)
+            {
+                chunk_span = v;
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Removes the chunks before 'before_idx', 'first_ts' is set to the first sample of the chunk left, or
+     * to INT64_MAX if no chunk is left.
+     */
+    int Ardb::TrimSeriesChunks(Context& ctx, const KeyObject& key, int64 before_idx, int64& chunks, int64& samples, int64& first_ts)
+    {
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(chunk_key);
+        Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+        first_ts = INT64_MAX;
+        int err = 0;
+        while (0 == err && iter->Valid())
+        {
+            std::string content;
+            SeriesChunk chunk;
+            iter->Value().GetStringValue().ToString(content);
+            if (!chunk.Decode(content))
+            {
+                err = ERR_INVALID_TIMESERIES;
+                break;
+            }
+            if (iter->Key().GetBitmapChunk() >= before_idx)
+            {
+                first_ts = (int64) SeriesChunkReader(chunk).ReadBits(64);
+                break;
+            }
+            err = RemoveKey(ctx, iter->Key());
+            chunks--;
+            samples -= chunk.count;
+            iter->Next();
+        }
+        DELETE(iter);
+        return err;
+    }
+
+    int Ardb::TSCreate(Context& ctx, RedisCommandFrame& cmd)
+    {
+        ctx.flags.create_if_notexist = 1;
+        RedisReply& reply = ctx.GetReply();
+        TimeSeries ts;
+        int64 chunk_span = kTimeSeriesDefaultChunkSpan;
+        if (!parse_series_options(cmd, 1, ts, chunk_span, reply))
+        {
+            return 0;
+        }
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_UNKNOWN, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() > 0)
+        {
+            reply.SetErrorReason("ERR key already exists");
+            return 0;
+        }
+        std::string header;
+        ts.Encode(header);
+        int err = 0;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            ClearBitmapChunks(ctx, key);
+            meta.SetType(KEY_STRING);
+            meta.SetChunked(true);
+            meta.SetChunkSize(chunk_span);
+            meta.SetChunkedLength(0);
+            meta.GetChunkedHeader().SetString(header, true);
+            err = SetKeyValue(ctx, key, meta);
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        if (0 == err)
+        {
+            err = ctx.transc_err;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetStatusCode(STATUS_OK);
+        }
+        return 0;
+    }
+
+    /*
+     * Samples are appended in timestamp order, the open chunk is rewritten with the new sample. Starting a new
+     * chunk trims the chunks out of the retention and pushes the key ttl forward.
+     */
+    int Ardb::TSAdd(Context& ctx, RedisCommandFrame& cmd)
+    {
+        ctx.flags.create_if_notexist = 1;
+        RedisReply& reply = ctx.GetReply();
+        int64 sample_ts = 0;
+        double value = 0;
+        if (cmd.GetArguments()[1] == "*")
+        {
+            sample_ts = get_current_epoch_millis();
+        }
+        else if (!string_toint64(cmd.GetArguments()[1], sample_ts) || sample_ts < 0)
+        {
+            reply.SetErrorReason("ERR invalid timestamp");
+            return 0;
+        }
+        if (!string_todouble(cmd.GetArguments()[2], value))
+        {
+            reply.SetErrCode(ERR_INVALID_FLOAT_ARGS);
+            return 0;
+        }
+        TimeSeries ts;
+        int64 chunk_span = kTimeSeriesDefaultChunkSpan;
+        if (!parse_series_options(cmd, 3, ts, chunk_span, reply))
+        {
+            return 0;
+        }
+        const std::string& keystr = cmd.GetArguments()[0];
+        KeyObject key(ctx.ns, KEY_META, keystr);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        bool created = meta.GetType() == 0;
+        if (created)
+        {
+            meta.SetType(KEY_STRING);
+            meta.SetChunked(true);
+            meta.SetChunkSize(chunk_span);
+            meta.SetChunkedLength(0);
+        }
+        else if (!decode_time_series(meta, ts))
+        {
+            reply.SetErrCode(ERR_INVALID_TIMESERIES);
+            return 0;
+        }
+        if (ts.samples > 0 && sample_ts <= ts.last_ts)
+        {
+            reply.SetErrorReason("ERR timestamp must be greater than the last sample timestamp");
+            return 0;
+        }
+        chunk_span = meta.GetChunkSize();
+        int64 idx = sample_ts / chunk_span;
+        bool rollover = ts.samples == 0 || idx != ts.last_ts / chunk_span;
+        SeriesChunk chunk;
+        int err = 0;
+        if (!rollover)
+        {
+            std::string content;
+            err = GetBitmapChunk(ctx, key, idx, content);
+            if (0 == err && !chunk.Decode(content))
+            {
+                err = ERR_INVALID_TIMESERIES;
+            }
+            if (0 != err)
+            {
+                reply.SetErrCode(err);
+                return 0;
+            }
+        }
+        chunk.Append(sample_ts, value);
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            if (created)
+            {
+                ClearBitmapChunks(ctx, key);
+            }
+            if (rollover && ts.retention > 0 && ts.samples > 0)
+            {
+                int64 first_ts = 0;
+                err = TrimSeriesChunks(ctx, key, (sample_ts - ts.retention) / chunk_span, ts.chunks, ts.samples, first_ts);
+                ts.first_ts = first_ts;
+            }
+            if (0 == err)
+            {
+                KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+                chunk_key.SetBitmapChunk(idx);
+                ValueObject chunk_val;
+                std::string content;
+                chunk.Encode(content);
+                chunk_val.SetType(KEY_BITMAP_CHUNK);
+                chunk_val.GetStringValue().SetString(content, false);
+                err = SetKeyValue(ctx, chunk_key, chunk_val);
+            }
+            if (0 == err)
+            {
+                if (rollover)
+                {
+                    ts.chunks++;
+                }
+                if (ts.samples == 0 || ts.first_ts > sample_ts)
+                {
+                    ts.first_ts = sample_ts;
+                }
+                ts.samples++;
+                ts.last_ts = sample_ts;
+                ts.last_value = value;
+                std::string header;
+                ts.Encode(header);
+                meta.GetChunkedHeader().SetString(header, true);
+                if (rollover && ts.retention > 0)
+                {
+                    int64 old_ttl = meta.GetTTL();
+                    int64 ttl = get_current_epoch_millis() + ts.retention + chunk_span;
+                    meta.SetTTL(ttl);
+                    m_key_cache->Expire(keystr, ttl);
+                    if (!m_engine->GetFeatureSet().support_compactfilter)
+                    {
+                        SaveTTL(ctx, ctx.ns, keystr, old_ttl, ttl);
+                    }
+                }
+                err = SetKeyValue(ctx, key, meta);
+            }
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        if (0 == err)
+        {
+            err = ctx.transc_err;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetInteger(sample_ts);
+            if (cmd.GetArguments()[1] == "*")
+            {
+                /*
+                 * replicate the timestamp taken here
+                 */
+                cmd.GetMutableArguments()[1] = stringfromll(sample_ts);
+                cmd.ClearRawProtocolData();
+            }
+        }
+        return 0;
+    }
+
+    int Ardb::TSGet(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        reply.ReserveMember(0);
+        if (meta.GetType() == 0)
+        {
+            return 0;
+        }
+        TimeSeries ts;
+        if (!decode_time_series(meta, ts))
+        {
+            reply.SetErrCode(ERR_INVALID_TIMESERIES);
+            return 0;
+        }
+        if (ts.samples > 0)
+        {
+            reply.AddMember().SetInteger(ts.last_ts);
+            reply.AddMember().SetDouble(ts.last_value);
+        }
+        return 0;
+    }
+
+    enum SeriesAggregation
+    {
+        SERIES_AGG_NONE, SERIES_AGG_AVG, SERIES_AGG_SUM, SERIES_AGG_MIN, SERIES_AGG_MAX, SERIES_AGG_COUNT, SERIES_AGG_FIRST, SERIES_AGG_LAST
+    };
+
+    struct SeriesBucket
+    {
+            int64 start;
+            int64 count;
+            double value;
+            SeriesBucket() :
+                    start(0), count(0), value(0)
+            {
+            }
+            void Add(SeriesAggregation agg, double v)
+            {
+                switch (agg)
+                {
+                    case SERIES_AGG_MIN:
+                    {
+                        value = count == 0 || v < value ? v : value;
+                        break;
+                    }
+                    case SERIES_AGG_MAX:
+                    {
+                        value = count == 0 || v > value ? v : value;
+                        break;
+                    }
+                    case SERIES_AGG_FIRST:
+                    {
+                        value = count == 0 ? v : value;
+                        break;
+                    }
+                    case SERIES_AGG_LAST:
+                    {
+                        value = v;
+                        break;
+                    }
+                    default:
+                    {
+                        value += v;
+                        break;
+                    }
+                }
+                count++;
+            }
+            double Result(SeriesAggregation agg) const
+            {
+                if (agg == SERIES_AGG_AVG)
+                {
+                    return value / count;
+                }
+                if (agg == SERIES_AGG_COUNT)
+                {
+                    return (double) count;
+                }
+                return value;
+            }
+    };
+
+    static void add_series_sample(RedisReply& reply, int64 ts, double v)
+    {
+        RedisReply& r = reply.AddMember();
+        r.ReserveMember(0);
+        r.AddMember().SetInteger(ts);
+        r.AddMember().SetDouble(v);
+    }
+
+    /*
+     * TS.RANGE key from to [AGGREGATION avg|sum|min|max|count|first|last bucket], '-' and '+' stand for the first
+     * and the last sample. Only the chunks covering the range are read, in one sequential scan.
+     */
+    int Ardb::TSRange(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        int64 from = 0, to = INT64_MAX;
+        if ((cmd.GetArguments()[1] != "-" && !string_toint64(cmd.GetArguments()[1], from))
+                || (cmd.GetArguments()[2] != "+" && !string_toint64(cmd.GetArguments()[2], to)))
+        {
+            reply.SetErrorReason("ERR invalid timestamp");
+            return 0;
+        }
+        SeriesAggregation agg = SERIES_AGG_NONE;
+        int64 bucket = 0;
+        if (cmd.GetArguments().size() > 3)
+        {
+            static const char* names[] = { "", "avg", "sum", "min", "max", "count", "first", "last" };
+            if (cmd.GetArguments().size() != 6 || strcasecmp(cmd.GetArguments()[3].c_str(), "aggregation"))
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            for (int i = SERIES_AGG_AVG; i <= SERIES_AGG_LAST; i++)
+            {
+                if (!strcasecmp(cmd.GetArguments()[4].c_str(), names[i]))
+                {
+                    agg = (SeriesAggregation) i;
+                }
+            }
+            if (agg == SERIES_AGG_NONE)
+            {
+                reply.SetErrorReason("ERR unknown aggregation type");
+                return 0;
+            }
+            if (!string_toint64(cmd.GetArguments()[5], bucket) || bucket <= 0)
+            {
+                reply.SetErrorReason("ERR bucket size should be larger than 0");
+                return 0;
+            }
+        }
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        reply.ReserveMember(0);
+        if (meta.GetType() == 0)
+        {
+            return 0;
+        }
+        TimeSeries ts;
+        if (!decode_time_series(meta, ts))
+        {
+            reply.SetErrCode(ERR_INVALID_TIMESERIES);
+            return 0;
+        }
+        if (ts.retention > 0 && from < ts.last_ts - ts.retention)
+        {
+            from = ts.last_ts - ts.retention;
+        }
+        if (ts.samples == 0 || from > to || from > ts.last_ts)
+        {
+            return 0;
+        }
+        int64 chunk_span = meta.GetChunkSize();
+        KeyObject chunk_key(ctx.ns, KEY_BITMAP_CHUNK, cmd.GetArguments()[0]);
+        chunk_key.SetBitmapChunk(from / chunk_span);
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(chunk_key);
+        CheckStreamIterate(ts.samples, iter_opts);
+        Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+        SeriesBucket current;
+        int err = 0;
+        while (iter->Valid())
+        {
+            if (iter->Key().GetBitmapChunk() > to / chunk_span)
+            {
+                break;
+            }
+            std::string content;
+            SeriesChunk chunk;
+            iter->Value().GetStringValue().ToString(content);
+            if (!chunk.Decode(content))
+            {
+                err = ERR_INVALID_TIMESERIES;
+                break;
+            }
+            SeriesChunkReader reader(chunk);
+            int64 sample_ts;
+            double v;
+            while (reader.Next(sample_ts, v))
+            {
+                if (sample_ts < from)
+                {
+                    continue;
+                }
+                if (sample_ts > to)
+                {
+                    break;
+                }
+                if (agg == SERIES_AGG_NONE)
+                {
+                    add_series_sample(reply, sample_ts, v);
+                    continue;
+                }
+                int64 start = sample_ts - sample_ts % bucket;
+                if (current.count > 0 && current.start != start)
+                {
+                    add_series_sample(reply, current.start, current.Result(agg));
+                    current = SeriesBucket();
+                }
+                current.start = start;
+                current.Add(agg, v);
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        if (0 != err)
+        {
+            reply.Clear();
+            reply.SetErrCode(err);
+            return 0;
+        }
+        if (current.count > 0)
+        {
+            add_series_sample(reply, current.start, current.Result(agg));
+        }
+        return 0;
+    }
+
+    int Ardb::TSInfo(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.SetErrorReason("ERR not found");
+            return 0;
+        }
+        TimeSeries ts;
+        if (!decode_time_series(meta, ts))
+        {
+            reply.SetErrCode(ERR_INVALID_TIMESERIES);
+            return 0;
+        }
+        reply.ReserveMember(0);
+        reply.AddMember().SetString("totalSamples");
+        reply.AddMember().SetInteger(ts.samples);
+        reply.AddMember().SetString("firstTimestamp");
+        reply.AddMember().SetInteger(ts.samples > 0 ? ts.first_ts : 0);
+        reply.AddMember().SetString("lastTimestamp");
+        reply.AddMember().SetInteger(ts.samples > 0 ? ts.last_ts : 0);
+        reply.AddMember().SetString("retentionTime");
+        reply.AddMember().SetInteger(ts.retention);
+        reply.AddMember().SetString("chunkCount");
+        reply.AddMember().SetInteger(ts.chunks);
+        reply.AddMember().SetString("chunkSpan");
+        reply.AddMember().SetInteger(meta.GetChunkSize());
+        return 0;
+    }
+OP_NAMESPACE_END
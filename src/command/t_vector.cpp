@@ -0,0 +1,799 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "db/db.hpp"
+#include "util/murmur3.h"
+#include "util/vecops.hpp"
+#include <math.h>
+#include <queue>
+
+/*
+ * Vector sets are chunked strings like bloom filters & time series: the meta holds the set header, every element
+ * is one KEY_BITMAP_CHUNK key whose index is the murmur3 hash of the element name, probing the next index on a
+ * collision. A record holds the element name and its vector, normalized to unit length on insert so the
+ * similarity is a plain dot product, either as float32 or quantized to int8 with a per vector scale.
+ *
+ * VSIM is a flat scan of the element keys in one sequential iteration, scored by the vecops dot product kernels,
+ * keeping the best 'count' elements in a heap.
+ */
+OP_NAMESPACE_BEGIN
+    static const char* kVectorSetMagic = "VS01";
+    static const uint32 kVectorSetMaxDim = 32768;
+    static const int64 kVectorSetMaxProbe = 64;
+
+    enum VectorQuantType
+    {
+        VECTOR_QUANT_NONE = 0, VECTOR_QUANT_Q8 = 1
+    };
+
+    struct VectorSet
+    {
+            uint32 dim;
+            uint8 quant;
+            int64 count;
+            VectorSet() :
+                    dim(0), quant(VECTOR_QUANT_Q8), count(0)
+            {
+            }
+            void Encode(std::string& header) const
+            {
+                Buffer buffer;
+                buffer.Write(kVectorSetMagic, strlen(kVectorSetMagic));
+                BufferHelper::WriteVarUInt32(buffer, dim);
+                BufferHelper::WriteFixUInt8(buffer, quant);
+                BufferHelper::WriteVarInt64(buffer, count);
+                header.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+            }
+            bool Decode(const std::string& header)
+            {
+                size_t magic_len = strlen(kVectorSetMagic);
+                if (header.size() < magic_len || header.compare(0, magic_len, kVectorSetMagic) != 0)
+                {
+                    return false;
+                }
+                Buffer buffer(const_cast<char*>(header.data()), magic_len, header.size());
+                return BufferHelper::ReadVarUInt32(buffer, dim) && BufferHelper::ReadFixUInt8(buffer, quant)
+                        && BufferHelper::ReadVarInt64(buffer, count);
+            }
+            size_t VectorBytes() const
+            {
+                return quant == VECTOR_QUANT_Q8 ? sizeof(float) + dim : dim * sizeof(float);
+            }
+    };
+
+    /*
+     * A normalized vector in the representation of its set: float32 components, or int8 components whose value
+     * is component * scale.
+     */
+    struct VectorValue
+    {
+            std::vector<float> f32;
+            std::vector<int8_t> q8;
+            float scale;
+            VectorValue() :
+                    scale(0)
+            {
+            }
+            void Assign(const VectorSet& vs, std::vector<float>& v)
+            {
+                double norm = 0;
+                for (size_t i = 0; i < v.size(); i++)
+                {
+                    norm += (double) v[i] * v[i];
+                }
+                norm = sqrt(norm);
+                for (size_t i = 0; i < v.size() && norm > 0; i++)
+                {
+                    v[i] = (float) (v[i] / norm);
+                }
+                if (vs.quant != VECTOR_QUANT_Q8)
+                {
+                    f32.swap(v);
+                    return;
+                }
+                float max = 0;
+                for (size_t i = 0; i < v.size(); i++)
+                {
+                    max = fabsf(v[i]) > max ? fabsf(v[i]) : max;
+                }
+                scale = max > 0 ? max / 127 : 0;
+                q8.resize(v.size());
+                for (size_t i = 0; i < v.size(); i++)
+                {
+                    q8[i] = scale > 0 ? (int8_t) lrintf(v[i] / scale) : 0;
+                }
+            }
+            void Encode(const VectorSet& vs, std::string& out) const
+            {
+                if (vs.quant == VECTOR_QUANT_Q8)
+                {
+                    out.append((const char*) &scale, sizeof(scale));
+                    out.append((const char*) &q8[0], q8.size());
+                }
+                else
+                {
+                    out.append((const char*) &f32[0], f32.size() * sizeof(float));
+                }
+            }
+            bool Decode(const VectorSet& vs, const char* p, size_t len)
+            {
+                if (len != vs.VectorBytes())
+                {
+                    return false;
+                }
+                if (vs.quant == VECTOR_QUANT_Q8)
+                {
+                    memcpy(&scale, p, sizeof(scale));
+                    q8.assign((const int8_t*) p + sizeof(scale), (const int8_t*) p + len);
+                }
+                else
+                {
+                    f32.resize(vs.dim);
+                    memcpy(&f32[0], p, len);
+                }
+                return true;
+            }
+            float Component(size_t i) const
+            {
+                return q8.empty() ? f32[i] : q8[i] * scale;
+            }
+            /*
+             * cosine similarity mapped to [0, 1] as VSIM scores
+             */
+            double Similarity(const VectorValue& other) const
+            {
+                double dot = q8.empty() ? vecops_dot_f32(&f32[0], &other.f32[0], f32.size()) :
+                        (double) vecops_dot_i8(&q8[0], &other.q8[0], q8.size()) * scale * other.scale;
+                dot = dot > 1 ? 1 : (dot < -1 ? -1 : dot);
+                return (1 + dot) / 2;
+            }
+    };
+
+    /*
+     * Element record: the name followed by the vector, an empty name marks a removed element still in a probe
+     * sequence.
+     */
+    static void encode_vector_record(const VectorSet& vs, const std::string& name, const VectorValue& v, std::string& record)
+    {
+        Buffer buffer;
+        BufferHelper::WriteVarString(buffer, name);
+        record.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+        v.Encode(vs, record);
+    }
+
+    static bool decode_vector_record(const VectorSet& vs, const std::string& record, std::string& name, VectorValue* v)
+    {
+        Buffer buffer(const_cast<char*>(record.data()), 0, record.size());
+        if (!BufferHelper::ReadVarString(buffer, name))
+        {
+            return false;
+        }
+        if (name.empty() || NULL == v)
+        {
+            return true;
+        }
+        return v->Decode(vs, buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+    }
+
+    static int64 vector_element_slot(const std::string& name)
+    {
+        uint64 hash[2];
+        MurmurHash3_x64_128(name.data(), name.size(), 0, hash);
+        return (int64) (hash[0] & INT64_MAX);
+    }
+
+    static bool decode_vector_set(ValueObject& meta, VectorSet& vs)
+    {
+        if (meta.GetType() != KEY_STRING || !meta.IsChunked())
+        {
+            return false;
+        }
+        std::string header;
+        meta.GetChunkedHeader().ToString(header);
+        return vs.Decode(header);
+    }
+
+    bool Ardb::IsVectorSet(ValueObject& meta)
+    {
+        VectorSet vs;
+        return decode_vector_set(meta, vs);
+    }
+
+    /*
+     * Parse 'VALUES num v1 ... vnum' or 'FP32 blob' at 'pos', 'pos' is moved after the vector.
+     */
+    static bool parse_vector(RedisCommandFrame& cmd, size_t& pos, std::vector<float>& v, RedisReply& reply)
+    {
+        const ArgumentArray& args = cmd.GetArguments();
+        if (pos + 1 >= args.size())
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return false;
+        }
+        if (!strcasecmp(args[pos].c_str(), "fp32"))
+        {
+            const std::string& blob = args[pos + 1];
+            if (blob.empty() || blob.size() % sizeof(float) != 0 || blob.size() / sizeof(float) > kVectorSetMaxDim)
+            {
+                reply.SetErrorReason("ERR invalid FP32 vector blob");
+                return false;
+            }
+            v.resize(blob.size() / sizeof(float));
+            memcpy(&v[0], blob.data(), blob.size());
+            pos += 2;
+        }
+        else if (!strcasecmp(args[pos].c_str(), "values"))
+        {
+            uint32 num = 0;
+            if (!string_touint32(args[pos + 1], num) || num == 0 || num > kVectorSetMaxDim || pos + 2 + num > args.size())
+            {
+                reply.SetErrorReason("ERR invalid vector dimension");
+                return false;
+            }
+            v.resize(num);
+            for (uint32 i = 0; i < num; i++)
+            {
+                double d;
+                if (!string_todouble(args[pos + 2 + i], d))
+                {
+                    reply.SetErrCode(ERR_INVALID_FLOAT_ARGS);
+                    return false;
+                }
+                v[i] = (float) d;
+            }
+            pos += 2 + num;
+        }
+        else
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return false;
+        }
+        for (size_t i = 0; i < v.size(); i++)
+        {
+            if (isnan(v[i]) || isinf(v[i]))
+            {
+                reply.SetErrCode(ERR_INVALID_FLOAT_ARGS);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Find the slot of 'name', 'slot' is set to its slot if found, else to the first free or removed slot of its
+     * probe sequence. Return 1 if found, 0 if not, or an error.
+     */
+    int Ardb::FindVectorElement(Context& ctx, const KeyObject& key, const VectorSet& vs, const std::string& name, int64& slot,
+            VectorValue* v)
+    {
+        int64 home = vector_element_slot(name);
+        int64 free_slot = -1;
+        for (int64 i = 0; i < kVectorSetMaxProbe; i++)
+        {
+            int64 idx = (home + i) & INT64_MAX;
+            std::string record, found;
+            int err = GetBitmapChunk(ctx, key, idx, record);
+            if (0 != err)
+            {
+                return err;
+            }
+            if (record.empty())
+            {
+                slot = free_slot >= 0 ? free_slot : idx;
+                return 0;
+            }
+            if (!decode_vector_record(vs, record, found, NULL))
+            {
+                return ERR_INVALID_VECTOR_SET;
+            }
+            if (found.empty())
+            {
+                free_slot = free_slot >= 0 ? free_slot : idx;
+                continue;
+            }
+            if (found == name)
+            {
+                slot = idx;
+                return NULL == v || decode_vector_record(vs, record, found, v) ? 1 : ERR_INVALID_VECTOR_SET;
+            }
+        }
+        if (free_slot < 0)
+        {
+            return ERR_INVALID_VECTOR_SET;
+        }
+        slot = free_slot;
+        return 0;
+    }
+
+    int Ardb::SetVectorRecord(Context& ctx, const KeyObject& key, int64 slot, const std::string& record)
+    {
+        KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+        chunk_key.SetBitmapChunk(slot);
+        ValueObject chunk_val;
+        chunk_val.SetType(KEY_BITMAP_CHUNK);
+        chunk_val.GetStringValue().SetString(record, false);
+        return SetKeyValue(ctx, chunk_key, chunk_val);
+    }
+
+    /*
+     * VADD key (VALUES num v1 ... vnum | FP32 blob) element [NOQUANT|Q8]
+     * The quantization is chosen when the set is created, Q8 by default.
+     */
+    int Ardb::VAdd(Context& ctx, RedisCommandFrame& cmd)
+    {
+        ctx.flags.create_if_notexist = 1;
+        RedisReply& reply = ctx.GetReply();
+        size_t pos = 1;
+        std::vector<float> input;
+        if (!parse_vector(cmd, pos, input, reply))
+        {
+            return 0;
+        }
+        if (pos >= cmd.GetArguments().size())
+        {
+            reply.SetErrCode(ERR_INVALID_SYNTAX);
+            return 0;
+        }
+        const std::string& name = cmd.GetArguments()[pos];
+        VectorSet vs;
+        for (pos++; pos < cmd.GetArguments().size(); pos++)
+        {
+            if (!strcasecmp(cmd.GetArguments()[pos].c_str(), "noquant"))
+            {
+                vs.quant = VECTOR_QUANT_NONE;
+            }
+            else if (!strcasecmp(cmd.GetArguments()[pos].c_str(), "q8"))
+            {
+                vs.quant = VECTOR_QUANT_Q8;
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        if (name.empty())
+        {
+            reply.SetErrorReason("ERR empty element name");
+            return 0;
+        }
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        bool created = meta.GetType() == 0;
+        if (created)
+        {
+            vs.dim = input.size();
+            meta.SetType(KEY_STRING);
+            meta.SetChunked(true);
+            meta.SetChunkSize(1);
+            meta.SetChunkedLength(0);
+        }
+        else if (!decode_vector_set(meta, vs))
+        {
+            reply.SetErrCode(ERR_INVALID_VECTOR_SET);
+            return 0;
+        }
+        if (vs.dim != input.size())
+        {
+            reply.SetErrorReason("ERR vector dimension mismatch, the set has " + stringfromll(vs.dim));
+            return 0;
+        }
+        int64 slot = 0;
+        int found = 0;
+        if (!created)
+        {
+            found = FindVectorElement(ctx, key, vs, name, slot, NULL);
+            if (found < 0)
+            {
+                reply.SetErrCode(found);
+                return 0;
+            }
+        }
+        else
+        {
+            slot = vector_element_slot(name);
+        }
+        VectorValue v;
+        v.Assign(vs, input);
+        std::string record;
+        encode_vector_record(vs, name, v, record);
+        int err = 0;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            if (created)
+            {
+                ClearBitmapChunks(ctx, key);
+            }
+            err = SetVectorRecord(ctx, key, slot, record);
+            if (0 == err && !found)
+            {
+                vs.count++;
+                std::string header;
+                vs.Encode(header);
+                meta.GetChunkedHeader().SetString(header, true);
+                err = SetKeyValue(ctx, key, meta);
+            }
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        if (0 == err)
+        {
+            err = ctx.transc_err;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetInteger(found ? 0 : 1);
+        }
+        return 0;
+    }
+
+    int Ardb::VRem(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        KeyLockGuard guard(ctx, key);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.SetInteger(0);
+            return 0;
+        }
+        VectorSet vs;
+        if (!decode_vector_set(meta, vs))
+        {
+            reply.SetErrCode(ERR_INVALID_VECTOR_SET);
+            return 0;
+        }
+        int64 slot = 0;
+        int found = FindVectorElement(ctx, key, vs, cmd.GetArguments()[1], slot, NULL);
+        if (found <= 0)
+        {
+            found < 0 ? reply.SetErrCode(found) : reply.SetInteger(0);
+            return 0;
+        }
+        /*
+         * the slot is kept as removed if the next one is used, it may be in the probe sequence of another element
+         */
+        std::string next;
+        int err = GetBitmapChunk(ctx, key, (slot + 1) & INT64_MAX, next);
+        if (0 == err)
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            vs.count--;
+            if (vs.count <= 0)
+            {
+                ClearBitmapChunks(ctx, key);
+                err = RemoveKey(ctx, key);
+            }
+            else
+            {
+                if (next.empty())
+                {
+                    KeyObject chunk_key(key.GetNameSpace(), KEY_BITMAP_CHUNK, key.GetKey());
+                    chunk_key.SetBitmapChunk(slot);
+                    err = RemoveKey(ctx, chunk_key);
+                }
+                else
+                {
+                    err = SetVectorRecord(ctx, key, slot, std::string(1, 0));
+                }
+                std::string header;
+                vs.Encode(header);
+                meta.GetChunkedHeader().SetString(header, true);
+                err = 0 == err ? SetKeyValue(ctx, key, meta) : err;
+            }
+            if (0 != err)
+            {
+                batch.MarkFailed(err);
+            }
+        }
+        if (0 == err)
+        {
+            err = ctx.transc_err;
+        }
+        if (0 != err)
+        {
+            reply.SetErrCode(err);
+        }
+        else
+        {
+            reply.SetInteger(1);
+        }
+        return 0;
+    }
+
+    struct VectorMatch
+    {
+            double score;
+            std::string name;
+            VectorMatch(double s = 0, const std::string& n = "") :
+                    score(s), name(n)
+            {
+            }
+            bool operator<(const VectorMatch& other) const
+            {
+                return score > other.score || (score == other.score && name < other.name);
+            }
+    };
+
+    /*
+     * VSIM key (ELE element | VALUES num v1 ... vnum | FP32 blob) [WITHSCORES] [COUNT count]
+     * Elements most similar to the query first, scores are the cosine similarity mapped to [0, 1].
+     */
+    int Ardb::VSim(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        const ArgumentArray& args = cmd.GetArguments();
+        size_t pos = 1;
+        std::vector<float> input;
+        std::string ele;
+        if (!strcasecmp(args[pos].c_str(), "ele"))
+        {
+            if (pos + 1 >= args.size())
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+            ele = args[pos + 1];
+            pos += 2;
+        }
+        else if (!parse_vector(cmd, pos, input, reply))
+        {
+            return 0;
+        }
+        bool withscores = false;
+        int64 count = 10;
+        for (; pos < args.size(); pos++)
+        {
+            if (!strcasecmp(args[pos].c_str(), "withscores"))
+            {
+                withscores = true;
+            }
+            else if (!strcasecmp(args[pos].c_str(), "count") && pos + 1 < args.size())
+            {
+                if (!string_toint64(args[pos + 1], count) || count <= 0)
+                {
+                    reply.SetErrCode(ERR_INVALID_INTEGER_ARGS);
+                    return 0;
+                }
+                pos++;
+            }
+            else
+            {
+                reply.SetErrCode(ERR_INVALID_SYNTAX);
+                return 0;
+            }
+        }
+        KeyObject key(ctx.ns, KEY_META, args[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        reply.ReserveMember(0);
+        if (meta.GetType() == 0)
+        {
+            return 0;
+        }
+        VectorSet vs;
+        if (!decode_vector_set(meta, vs))
+        {
+            reply.SetErrCode(ERR_INVALID_VECTOR_SET);
+            return 0;
+        }
+        VectorValue query;
+        if (!ele.empty())
+        {
+            int64 slot;
+            int found = FindVectorElement(ctx, key, vs, ele, slot, &query);
+            if (found <= 0)
+            {
+                found < 0 ? reply.SetErrCode(found) : reply.SetErrorReason("ERR element not found in set");
+                return 0;
+            }
+        }
+        else if (vs.dim != input.size())
+        {
+            reply.SetErrorReason("ERR vector dimension mismatch, the set has " + stringfromll(vs.dim));
+            return 0;
+        }
+        else
+        {
+            query.Assign(vs, input);
+        }
+        KeyObject chunk_key(ctx.ns, KEY_BITMAP_CHUNK, args[0]);
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(chunk_key);
+        CheckStreamIterate(vs.count, iter_opts);
+        Iterator* iter = m_engine->Find(ctx, chunk_key, iter_opts);
+        std::priority_queue<VectorMatch> best; //the worst match on top
+        VectorValue v;
+        std::string record, name;
+        int err = 0;
+        while (iter->Valid())
+        {
+            iter->Value().GetStringValue().ToString(record);
+            if (!decode_vector_record(vs, record, name, &v))
+            {
+                err = ERR_INVALID_VECTOR_SET;
+                break;
+            }
+            if (!name.empty())
+            {
+                VectorMatch m(query.Similarity(v), name);
+                if ((int64) best.size() < count)
+                {
+                    best.push(m);
+                }
+                else if (m < best.top())
+                {
+                    best.pop();
+                    best.push(m);
+                }
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        if (0 != err)
+        {
+            reply.Clear();
+            reply.SetErrCode(err);
+            return 0;
+        }
+        std::vector<VectorMatch> matches;
+        while (!best.empty())
+        {
+            matches.push_back(best.top());
+            best.pop();
+        }
+        for (size_t i = matches.size(); i > 0; i--)
+        {
+            reply.AddMember().SetString(matches[i - 1].name);
+            if (withscores)
+            {
+                reply.AddMember().SetDouble(matches[i - 1].score);
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * VCARD/VDIM/VINFO key
+     */
+    int Ardb::VInfo(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        VectorSet vs;
+        if (meta.GetType() > 0 && !decode_vector_set(meta, vs))
+        {
+            reply.SetErrCode(ERR_INVALID_VECTOR_SET);
+            return 0;
+        }
+        switch (cmd.GetType())
+        {
+            case REDIS_CMD_VCARD:
+            {
+                reply.SetInteger(meta.GetType() > 0 ? vs.count : 0);
+                break;
+            }
+            case REDIS_CMD_VDIM:
+            {
+                if (meta.GetType() == 0)
+                {
+                    reply.SetErrorReason("ERR key does not exist");
+                    break;
+                }
+                reply.SetInteger(vs.dim);
+                break;
+            }
+            default:
+            {
+                if (meta.GetType() == 0)
+                {
+                    reply.Clear();
+                    break;
+                }
+                reply.ReserveMember(0);
+                reply.AddMember().SetString("quant-type");
+                reply.AddMember().SetString(vs.quant == VECTOR_QUANT_Q8 ? "int8" : "f32");
+                reply.AddMember().SetString("vector-dim");
+                reply.AddMember().SetInteger(vs.dim);
+                reply.AddMember().SetString("size");
+                reply.AddMember().SetInteger(vs.count);
+                break;
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * VEMB key element, the stored vector, normalized and dequantized.
+     */
+    int Ardb::VEmb(Context& ctx, RedisCommandFrame& cmd)
+    {
+        RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        if (!CheckMeta(ctx, key, KEY_STRING, meta))
+        {
+            return 0;
+        }
+        if (meta.GetType() == 0)
+        {
+            reply.Clear();
+            return 0;
+        }
+        VectorSet vs;
+        if (!decode_vector_set(meta, vs))
+        {
+            reply.SetErrCode(ERR_INVALID_VECTOR_SET);
+            return 0;
+        }
+        VectorValue v;
+        int64 slot;
+        int found = FindVectorElement(ctx, key, vs, cmd.GetArguments()[1], slot, &v);
+        if (found < 0)
+        {
+            reply.SetErrCode(found);
+            return 0;
+        }
+        if (found == 0)
+        {
+            reply.Clear();
+            return 0;
+        }
+        reply.ReserveMember(0);
+        for (uint32 i = 0; i < vs.dim; i++)
+        {
+            reply.AddMember().SetDouble(v.Component(i));
+        }
+        return 0;
+    }
+OP_NAMESPACE_END
@@ -29,6 +29,8 @@
 #include "db/db.hpp"
 #include <float.h>
 #include <cmath>
+#include <limits.h>
+#include <algorithm>
 
 /* This generic command implements both ZADD and ZINCRBY. */
 #define ZADD_NONE 0
@@ -42,6 +44,374 @@
 #define REDIS_AGGR_MAX 3
 
 OP_NAMESPACE_BEGIN
+    /*
+     * 'from' may be an iterator's key, the string parts are cloned so 'to' stays valid after the iterator moves.
+     */
+    static void zset_key_convert(const KeyObject& from, uint8 type, KeyObject& to)
+    {
+        to.SetNameSpace(from.GetNameSpace());
+        to.SetKey(from.GetKey());
+        to.SetType(type);
+        to.SetMember(from.GetElement(0), 0);
+        to.SetMember(from.GetElement(1), 1);
+        to.CloneStringPart();
+    }
+
+    /*
+     * entries of a reverse range read forward, replied backwards once the scan is done.
+     */
+    typedef std::pair<std::string, double> ZSetEntry;
+    typedef std::vector<ZSetEntry> ZSetEntries;
+    static void zset_reply_reversed(RedisReply& reply, const ZSetEntries& entries, bool withscores)
+    {
+        ZSetEntries::const_reverse_iterator it = entries.rbegin();
+        while (it != entries.rend())
+        {
+            RedisReply& r1 = reply.AddMember();
+            r1.SetString(it->first);
+            if (withscores)
+            {
+                RedisReply& r2 = reply.AddMember();
+                r2.SetDouble(it->second);
+            }
+            it++;
+        }
+    }
+
+    static std::string zrank_block_id(const KeyObject& fence)
+    {
+        Buffer buffer;
+        Slice id = fence.Encode(buffer, false);
+        return std::string(id.data(), id.size());
+    }
+
+    /*
+     * The rank index of a zset splits its sorted elements into blocks of 'zset-rank-block-size' to twice of it elements.
+     * Each block is a KEY_ZSET_RANK key whose elements are the score & member of the block's first element(fence), valued with
+     * the count of elements up to the next block, the first block has nil elements so that it is before any element.
+     * A fence is only a lower bound, it's kept after the element is removed. Counts are changed in the command's write batch,
+     * blocks are split/merged after it is committed.
+     */
+    int Ardb::ZRankLocate(Context& ctx, ZRankUpdates& updates, const KeyObject& rank_key, ZRankBlock*& block, bool before)
+    {
+        if (NULL == updates.iter)
+        {
+            IterateOptions iter_opts;
+            iter_opts.BoundToObject(rank_key);
+            iter_opts.total_order = true;
+            updates.iter = m_engine->Find(ctx, rank_key, iter_opts);
+        }
+        else
+        {
+            updates.iter->Jump(rank_key);
+        }
+        Iterator* iter = updates.iter;
+        if (!iter->Valid())
+        {
+            iter->JumpToLast();
+        }
+        else
+        {
+            int cmp = iter->Key().Compare(rank_key);
+            if (cmp > 0 || (before && cmp == 0))
+            {
+                iter->Prev();
+            }
+        }
+        if (!iter->Valid())
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        KeyObject& fence = iter->Key(true);
+        std::string id = zrank_block_id(fence);
+        std::map<std::string, ZRankBlock>::iterator found = updates.blocks.find(id);
+        if (found != updates.blocks.end())
+        {
+            block = &(found->second);
+            return 0;
+        }
+        block = &(updates.blocks[id]);
+        block->fence = fence;
+        block->count = iter->Value().GetZSetRankCount();
+        return 0;
+    }
+
+    void Ardb::ZRankUpdate(Context& ctx, ZRankUpdates& updates, const KeyObject& sort_key, int64 delta)
+    {
+        KeyObject rank_key;
+        zset_key_convert(sort_key, KEY_ZSET_RANK, rank_key);
+        ZRankBlock* block = NULL;
+        if (0 != ZRankLocate(ctx, updates, rank_key, block))
+        {
+            WARN_LOG("No rank index block found for zset:%s", sort_key.GetKey().AsString().c_str());
+            return;
+        }
+        block->delta += delta;
+    }
+
+    void Ardb::ZRankFlush(Context& ctx, ZRankUpdates& updates)
+    {
+        std::map<std::string, ZRankBlock>::iterator it = updates.blocks.begin();
+        while (it != updates.blocks.end())
+        {
+            ZRankBlock& block = it->second;
+            if (block.delta != 0)
+            {
+                block.count += block.delta;
+                block.delta = 0;
+                ValueObject count;
+                count.SetType(KEY_ZSET_RANK);
+                count.SetZSetRankCount(block.count);
+                SetKeyValue(ctx, block.fence, count);
+            }
+            it++;
+        }
+    }
+
+    void Ardb::ZRankSplit(Context& ctx, ZRankBlock& block)
+    {
+        int64 block_size = GetConf().zset_rank_block_size;
+        int64 pieces = block.count / block_size;
+        KeyObject sort_key;
+        zset_key_convert(block.fence, KEY_ZSET_SORT, sort_key);
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(sort_key);
+        Iterator* iter = m_engine->Find(ctx, sort_key, iter_opts);
+        /*
+         * all pieces except the last one have 'block_size' elements, the last one has block_size to 2*block_size elements.
+         */
+        KeyObjectArray fences;
+        int64 pos = 0;
+        while (iter->Valid() && (int64) fences.size() < pieces - 1)
+        {
+            if (pos > 0 && pos % block_size == 0)
+            {
+                KeyObject fence;
+                zset_key_convert(iter->Key(), KEY_ZSET_RANK, fence);
+                fences.push_back(fence);
+            }
+            pos++;
+            iter->Next();
+        }
+        DELETE(iter);
+        if ((int64) fences.size() < pieces - 1)
+        {
+            return;
+        }
+        ValueObject count;
+        count.SetType(KEY_ZSET_RANK);
+        for (size_t i = 0; i < fences.size(); i++)
+        {
+            count.SetZSetRankCount(i == fences.size() - 1 ? block.count - (pieces - 1) * block_size : block_size);
+            SetKeyValue(ctx, fences[i], count);
+        }
+        block.count = block_size;
+        count.SetZSetRankCount(block.count);
+        SetKeyValue(ctx, block.fence, count);
+    }
+
+    void Ardb::ZRankClear(Context& ctx, const KeyObject& meta_key)
+    {
+        KeyObject rank_key(meta_key.GetNameSpace(), KEY_ZSET_RANK, meta_key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(rank_key);
+        Iterator* iter = m_engine->Find(ctx, rank_key, iter_opts);
+        while (iter->Valid())
+        {
+            RemoveKey(ctx, iter->Key());
+            iter->Next();
+        }
+        DELETE(iter);
+    }
+
+    /*
+     * Index all elements of a zset written by previous commands, which only happens once per zset.
+     */
+    void Ardb::ZRankBuild(Context& ctx, const KeyObject& meta_key, ValueObject& meta)
+    {
+        int64 block_size = GetConf().zset_rank_block_size;
+        WriteBatchGuard batch(ctx, m_engine);
+        ZRankClear(ctx, meta_key);
+        KeyObject sort_key(meta_key.GetNameSpace(), KEY_ZSET_SORT, meta_key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(sort_key);
+        CheckStreamIterate(meta.GetObjectLen(), iter_opts);
+        Iterator* iter = m_engine->Find(ctx, sort_key, iter_opts);
+        KeyObject fence(meta_key.GetNameSpace(), KEY_ZSET_RANK, meta_key.GetKey());
+        ValueObject count;
+        count.SetType(KEY_ZSET_RANK);
+        int64 n = 0;
+        while (iter->Valid())
+        {
+            if (n == block_size)
+            {
+                count.SetZSetRankCount(n);
+                SetKeyValue(ctx, fence, count);
+                zset_key_convert(iter->Key(), KEY_ZSET_RANK, fence);
+                n = 0;
+            }
+            n++;
+            iter->Next();
+        }
+        DELETE(iter);
+        count.SetZSetRankCount(n);
+        SetKeyValue(ctx, fence, count);
+        meta.SetRankIndexed(true);
+        SetKeyValue(ctx, meta_key, meta);
+    }
+
+    /*
+     * Called after the command's changes are committed, while the key is still locked.
+     */
+    void Ardb::ZRankRebalance(Context& ctx, const KeyObject& meta_key, ValueObject& meta, ZRankUpdates& updates)
+    {
+        if (0 != ctx.transc_err)
+        {
+            return;
+        }
+        int64 block_size = GetConf().zset_rank_block_size;
+        if (!meta.IsRankIndexed())
+        {
+            if (block_size > 0 && meta.GetType() == KEY_ZSET && meta.GetObjectLen() > 0)
+            {
+                ZRankBuild(ctx, meta_key, meta);
+            }
+            return;
+        }
+        if (meta.GetObjectLen() <= 0)
+        {
+            //the zset is removed
+            WriteBatchGuard batch(ctx, m_engine);
+            ZRankClear(ctx, meta_key);
+            return;
+        }
+        if (block_size <= 0)
+        {
+            //rank index disabled, drop it
+            WriteBatchGuard batch(ctx, m_engine);
+            ZRankClear(ctx, meta_key);
+            meta.SetRankIndexed(false);
+            SetKeyValue(ctx, meta_key, meta);
+            return;
+        }
+        DELETE(updates.iter); //iterator created before the commit may not see the changes
+        WriteBatchGuard batch(ctx, m_engine);
+        std::vector<std::string> ids;
+        std::map<std::string, ZRankBlock>::iterator it = updates.blocks.begin();
+        while (it != updates.blocks.end())
+        {
+            ids.push_back(it->first);
+            it++;
+        }
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            ZRankBlock& block = updates.blocks[ids[i]];
+            if (block.removed || block.fence.GetElement(0).IsNil() || block.count >= block_size / 2)
+            {
+                continue;
+            }
+            /*
+             * merge a small block into the previous one, which is skipped if the previous one is merged in this pass,
+             * the block would be merged next time it's updated.
+             */
+            ZRankBlock* prev = NULL;
+            if (0 != ZRankLocate(ctx, updates, block.fence, prev, true) || prev->removed)
+            {
+                continue;
+            }
+            prev->count += block.count;
+            block.removed = true;
+            RemoveKey(ctx, block.fence);
+            ValueObject count;
+            count.SetType(KEY_ZSET_RANK);
+            count.SetZSetRankCount(prev->count);
+            SetKeyValue(ctx, prev->fence, count);
+        }
+        it = updates.blocks.begin();
+        while (it != updates.blocks.end())
+        {
+            if (!it->second.removed && it->second.count > 2 * block_size)
+            {
+                ZRankSplit(ctx, it->second);
+            }
+            it++;
+        }
+    }
+
+    /*
+     * Return the rank of 'sort_key' in a rank indexed zset, or -1 if not exist. It sums the counts of the blocks before
+     * the element, and counts the elements in its block.
+     */
+    int64 Ardb::ZRankOf(Context& ctx, const KeyObject& sort_key)
+    {
+        KeyObject rank_key;
+        zset_key_convert(sort_key, KEY_ZSET_RANK, rank_key);
+        KeyObject start(sort_key.GetNameSpace(), KEY_ZSET_RANK, sort_key.GetKey());
+        KeyObject fence(sort_key.GetNameSpace(), KEY_ZSET_SORT, sort_key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(start);
+        Iterator* iter = m_engine->Find(ctx, start, iter_opts);
+        int64 rank = 0, count = 0;
+        while (iter->Valid())
+        {
+            KeyObject& k = iter->Key();
+            if (k.Compare(rank_key) > 0)
+            {
+                break;
+            }
+            rank += count;
+            count = iter->Value().GetZSetRankCount();
+            zset_key_convert(k, KEY_ZSET_SORT, fence);
+            iter->Next();
+        }
+        DELETE(iter);
+        IterateOptions sort_opts;
+        sort_opts.BoundToObject(fence);
+        iter = m_engine->Find(ctx, fence, sort_opts);
+        bool found = false;
+        while (iter->Valid())
+        {
+            int cmp = iter->Key().Compare(sort_key);
+            if (cmp >= 0)
+            {
+                found = (cmp == 0);
+                break;
+            }
+            rank++;
+            iter->Next();
+        }
+        DELETE(iter);
+        return found ? rank : -1;
+    }
+
+    /*
+     * Locate the block containing the element at 'rank' of a rank indexed zset, 'sort_key' is set to the
+     * block's fence and 'skip' is the offset of the element from the fence.
+     */
+    bool Ardb::ZRankSeek(Context& ctx, const KeyObject& meta_key, int64 rank, KeyObject& sort_key, int64& skip)
+    {
+        KeyObject start(meta_key.GetNameSpace(), KEY_ZSET_RANK, meta_key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(start);
+        Iterator* iter = m_engine->Find(ctx, start, iter_opts);
+        int64 passed = 0;
+        bool found = false;
+        while (iter->Valid())
+        {
+            int64 count = iter->Value().GetZSetRankCount();
+            if (passed + count > rank)
+            {
+                zset_key_convert(iter->Key(), KEY_ZSET_SORT, sort_key);
+                skip = rank - passed;
+                found = true;
+                break;
+            }
+            passed += count;
+            iter->Next();
+        }
+        DELETE(iter);
+        return found;
+    }
 
     int Ardb::ZAdd(Context& ctx, RedisCommandFrame& cmd)
     {
@@ -116,7 +486,8 @@ OP_NAMESPACE_BEGIN
             return 0;
         }
 
-        if (meta.GetType() == 0)
+        bool new_key = meta.GetType() == 0;
+        if (new_key)
         {
             if (xx)
             {
@@ -128,23 +499,61 @@ OP_NAMESPACE_BEGIN
                 meta.SetObjectLen(0);
             }
         }
+        /*
+         * scores of all given members read by one MultiGet, none to read for a new key
+         */
+        KeyObjectArray ele_keys;
+        for (size_t i = 0; i < elements; i++)
+        {
+            KeyObject ele(ctx.ns, KEY_ZSET_SCORE, cmd.GetArguments()[0]);
+            ele.SetZSetMember(cmd.GetArguments()[scoreidx + i * 2 + 1]);
+            ele_keys.push_back(ele);
+        }
+        ValueObjectArray ele_values;
+        ErrCodeArray ele_errs;
+        if (!new_key)
+        {
+            err = m_engine->MultiGet(ctx, ele_keys, ele_values, ele_errs);
+            if (0 != err)
+            {
+                reply.SetErrCode(err);
+                return 0;
+            }
+        }
+        /*
+         * members given more than once see the score written by their previous occurrence
+         */
+        std::map<std::string, double> written;
         double score = 0;
+        bool ranked = meta.IsRankIndexed();
+        ZRankUpdates rank_updates;
         {
             WriteBatchGuard batch(ctx, m_engine);
             for (size_t i = 0; i < elements; i++)
             {
-                KeyObject ele(ctx.ns, KEY_ZSET_SCORE, cmd.GetArguments()[0]);
-                ele.SetZSetMember(cmd.GetArguments()[scoreidx + i * 2 + 1]);
+                KeyObject& ele = ele_keys[i];
+                const std::string& member = cmd.GetArguments()[scoreidx + i * 2 + 1];
                 score = scores[i];
                 double current_score = 0;
+                bool found = false;
+                std::map<std::string, double>::iterator prev = written.find(member);
+                if (prev != written.end())
+                {
+                    found = true;
+                    current_score = prev->second;
+                }
+                else if (!new_key && i < ele_errs.size() && 0 == ele_errs[i])
+                {
+                    found = true;
+                    current_score = ele_values[i].GetZSetScore();
+                }
                 ValueObject ele_value;
-                if (0 == m_engine->Get(ctx, ele, ele_value))
+                if (found)
                 {
                     if (nx)
                     {
                         continue;
                     }
-                    current_score = ele_value.GetZSetScore();
                     if (incr)
                     {
                         score += current_score;
@@ -161,6 +570,10 @@ OP_NAMESPACE_BEGIN
                         old_sort_key.SetZSetMember(cmd.GetArguments()[scoreidx + i * 2 + 1]);
                         old_sort_key.SetZSetScore(current_score);
                         RemoveKey(ctx, old_sort_key);
+                        if (ranked)
+                        {
+                            ZRankUpdate(ctx, rank_updates, old_sort_key, -1);
+                        }
                         updated++;
                     }
                     else
@@ -183,14 +596,21 @@ OP_NAMESPACE_BEGIN
                 ValueObject empty;
                 empty.SetType(KEY_ZSET_SORT);
                 SetKeyValue(ctx, new_sort_key, empty);
+                if (ranked)
+                {
+                    ZRankUpdate(ctx, rank_updates, new_sort_key, 1);
+                }
                 ele_value.SetType(KEY_ZSET_SCORE);
                 ele_value.SetZSetScore(score);
                 SetKeyValue(ctx, ele, ele_value);
+                written[member] = score;
                 meta.SetMinMaxData(new_sort_key.GetZSetMember());
             }
             meta.SetObjectLen(meta.GetObjectLen() + added);
             SetKeyValue(ctx, key, meta);
+            ZRankFlush(ctx, rank_updates);
         }
+        ZRankRebalance(ctx, key, meta, rank_updates);
 
         if (ctx.transc_err != 0)
         {
@@ -286,53 +706,89 @@ OP_NAMESPACE_BEGIN
         if (end >= meta.GetObjectLen())
             end = meta.GetObjectLen() - 1;
         KeyObject sort_key(ctx.ns, KEY_ZSET_SORT, key.GetKey());
-        if(reverse)
-        {
-            ctx.flags.iterate_total_order = 1;
-        }
-        Iterator* iter = m_engine->Find(ctx, sort_key);
+        /*
+         * with a rank index a reverse range is read forward from its lowest rank & replied backwards, engines step
+         * forward several times faster than backward & read ahead only forward.
+         */
+        bool forward_reverse = reverse && meta.IsRankIndexed();
+        ZSetEntries reversed;
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(sort_key);
+        iter_opts.total_order = reverse && !forward_reverse;
+        /*
+         * 'first' & 'last' are ranks in ascending order, the iterator starts at 'last' if reverse, else 'first'.
+         */
+        int64 first = start, last = end;
         if (reverse)
         {
-            iter->JumpToLast();
+            first = meta.GetObjectLen() - 1 - end;
+            last = meta.GetObjectLen() - 1 - start;
         }
         int64_t rank = 0;
-        if (reverse)
+        int64 skip = 0;
+        Iterator* iter = NULL;
+        if (meta.IsRankIndexed() && ZRankSeek(ctx, key, forward_reverse ? first : (reverse ? last : first), sort_key, skip))
         {
-            rank = meta.GetObjectLen() - 1 - rank;
+            iter = m_engine->Find(ctx, sort_key, iter_opts);
+            rank = (forward_reverse ? first : (reverse ? last : first)) - skip;
+            while (skip > 0 && iter->Valid())
+            {
+                iter->Next();
+                skip--;
+                rank++;
+            }
         }
-
-        while (iter->Valid())
+        else
         {
-            KeyObject& field = iter->Key();
-            if (field.GetType() != KEY_ZSET_SORT || field.GetNameSpace() != key.GetNameSpace() || field.GetKey() != key.GetKey())
+            if (forward_reverse)
             {
-                break;
+                forward_reverse = false;
+                iter_opts.total_order = true;
             }
+            iter = m_engine->Find(ctx, sort_key, iter_opts);
             if (reverse)
             {
-                if (rank < start)
+                iter->JumpToLast();
+                rank = meta.GetObjectLen() - 1;
+            }
+        }
+        ZRankUpdates rank_updates;
+        while (iter->Valid())
+        {
+            KeyObject& field = iter->Key();
+            if (reverse && !forward_reverse)
+            {
+                if (rank < first)
                 {
                     break;
                 }
             }
             else
             {
-                if (rank > end)
+                if (rank > last)
                 {
                     break;
                 }
             }
-            if (rank >= start && rank <= end)
+            if (rank >= first && rank <= last)
             {
                 if (toremove)
                 {
                     KeyObject score_key(ctx.ns, KEY_ZSET_SCORE, key.GetKey());
                     score_key.SetZSetMember(field.GetZSetMember());
+                    if (meta.IsRankIndexed())
+                    {
+                        ZRankUpdate(ctx, rank_updates, field, -1);
+                    }
                     //RemoveKey(ctx, field);
                     RemoveKey(ctx, score_key);
                     iter->Del();
                     removed++;
                 }
+                else if (forward_reverse)
+                {
+                    reversed.push_back(ZSetEntry(field.GetZSetMember().AsString(), field.GetZSetScore()));
+                }
                 else
                 {
                     RedisReply& r1 = reply.AddMember();
@@ -345,7 +801,7 @@ OP_NAMESPACE_BEGIN
                 }
             }
 
-            if (reverse)
+            if (reverse && !forward_reverse)
             {
                 iter->Prev();
                 rank--;
@@ -357,6 +813,7 @@ OP_NAMESPACE_BEGIN
             }
         }
         DELETE(iter);
+        zset_reply_reversed(reply, reversed, withscores);
         if (toremove)
         {
             if (removed > 0)
@@ -368,8 +825,10 @@ OP_NAMESPACE_BEGIN
                 }
                 else
                 {
+                    ZRankFlush(ctx, rank_updates);
                     SetKeyValue(ctx, key, meta);
                 }
+                ZRankRebalance(ctx, key, meta, rank_updates);
             }
             reply.SetInteger(removed);
         }
@@ -450,6 +909,15 @@ OP_NAMESPACE_BEGIN
         {
             return 0;
         }
+        /*
+         * a reverse range without LIMIT is read forward from its min score & replied backwards, as in ZIterateByRank.
+         */
+        bool forward_reverse = reverse && !with_limit;
+        ZSetEntries reversed;
+        if (forward_reverse)
+        {
+            reverse = false;
+        }
         KeyObject sort_key(ctx.ns, KEY_ZSET_SORT, key.GetKey());
         sort_key.SetZSetScore(reverse ? range.max.GetFloat64() : range.min.GetFloat64());
         if(reverse)
@@ -463,6 +931,7 @@ OP_NAMESPACE_BEGIN
         }
         int64_t range_cursor = 0;
         int64_t range_count = 0;
+        ZRankUpdates rank_updates;
         while (iter->Valid())
         {
             KeyObject& field = iter->Key();
@@ -493,11 +962,19 @@ OP_NAMESPACE_BEGIN
                     {
                         KeyObject score_key(ctx.ns, KEY_ZSET_SCORE, key.GetKey());
                         score_key.SetZSetMember(field.GetZSetMember());
+                        if (meta.IsRankIndexed())
+                        {
+                            ZRankUpdate(ctx, rank_updates, field, -1);
+                        }
                         //RemoveKey(ctx, field);
                         RemoveKey(ctx, score_key);
                         iter->Del();
                         removed++;
                     }
+                    else if (forward_reverse)
+                    {
+                        reversed.push_back(ZSetEntry(field.GetZSetMember().AsString(), field.GetZSetScore()));
+                    }
                     else if (!countrange)
                     {
                         RedisReply& r1 = reply.AddMember();
@@ -526,6 +1003,7 @@ OP_NAMESPACE_BEGIN
             }
         }
         DELETE(iter);
+        zset_reply_reversed(reply, reversed, withscores);
         if (toremove)
         {
             if (removed > 0)
@@ -537,8 +1015,10 @@ OP_NAMESPACE_BEGIN
                 }
                 else
                 {
+                    ZRankFlush(ctx, rank_updates);
                     SetKeyValue(ctx, key, meta);
                 }
+                ZRankRebalance(ctx, key, meta, rank_updates);
             }
             reply.SetInteger(removed);
         }
@@ -572,22 +1052,41 @@ OP_NAMESPACE_BEGIN
     int Ardb::ZRank(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
+        KeyObject key(ctx.ns, KEY_META, cmd.GetArguments()[0]);
+        ValueObject meta;
+        KeyLockGuard guard(ctx, key);
         ZScore(ctx, cmd);
-        if (reply.type == REDIS_REPLY_DOUBLE)
+        if (reply.type == REDIS_REPLY_DOUBLE && 0 == m_engine->Get(ctx, key, meta) && meta.IsRankIndexed())
+        {
+            KeyObject sort_key(ctx.ns, KEY_ZSET_SORT, cmd.GetArguments()[0]);
+            sort_key.SetZSetMember(cmd.GetArguments()[1]);
+            sort_key.SetZSetScore(reply.GetDouble());
+            int64 rank = ZRankOf(ctx, sort_key);
+            if (rank < 0)
+            {
+                reply.Clear();
+            }
+            else
+            {
+                reply.SetInteger(cmd.GetType() == REDIS_CMD_ZREVRANK ? meta.GetObjectLen() - 1 - rank : rank);
+            }
+        }
+        else if (reply.type == REDIS_REPLY_DOUBLE)
         {
             double score = reply.GetDouble();
             Data member;
             member.SetString(cmd.GetArguments()[1], false);
             KeyObject sort_key(ctx.ns, KEY_ZSET_SORT, cmd.GetArguments()[0]);
-            if (cmd.GetType() == REDIS_CMD_ZREVRANK)
+            bool revrank = cmd.GetType() == REDIS_CMD_ZREVRANK;
+            if (revrank)
             {
-                ctx.flags.iterate_total_order = 1;
+                /*
+                 * the reverse rank is the count of members after this one, counted forward from its sort key.
+                 */
+                sort_key.SetZSetScore(score);
+                sort_key.SetZSetMember(member);
             }
             Iterator* iter = m_engine->Find(ctx, sort_key);
-            if (cmd.GetType() == REDIS_CMD_ZREVRANK)
-            {
-                iter->JumpToLast();
-            }
             int64_t rank = 0;
             bool found = false;
             while (iter->Valid())
@@ -597,20 +1096,31 @@ OP_NAMESPACE_BEGIN
                 {
                     break;
                 }
-                if (field.GetZSetMember() == member)
+                if (revrank)
                 {
-                    found = true;
-                    break;
+                    if (!found)
+                    {
+                        if (field.GetZSetMember() != member)
+                        {
+                            break;
+                        }
+                        found = true;
+                    }
+                    else
+                    {
+                        rank++;
+                    }
                 }
-                rank++;
-                if (cmd.GetType() == REDIS_CMD_ZREVRANK)
+                else if (field.GetZSetMember() == member)
                 {
-                    iter->Prev();
+                    found = true;
+                    break;
                 }
                 else
                 {
-                    iter->Next();
+                    rank++;
                 }
+                iter->Next();
             }
             DELETE(iter);
             if (!found)
@@ -656,6 +1166,7 @@ OP_NAMESPACE_BEGIN
             return 0;
         }
         int64_t removed = 0;
+        ZRankUpdates rank_updates;
         {
             WriteBatchGuard batch(ctx, m_engine);
             for (size_t i = 1; i < vs.size(); i++)
@@ -667,15 +1178,31 @@ OP_NAMESPACE_BEGIN
                     sort_key.SetZSetScore(vs[i].GetZSetScore());
                     RemoveKey(ctx, sort_key);
                     RemoveKey(ctx, keys[i]);
+                    if (vs[0].IsRankIndexed())
+                    {
+                        ZRankUpdate(ctx, rank_updates, sort_key, -1);
+                    }
                     removed++;
                 }
             }
             if (removed > 0)
             {
                 vs[0].SetObjectLen(vs[0].GetObjectLen() - removed);
-                SetKeyValue(ctx, keys[0], vs[0]);
+                if (vs[0].GetObjectLen() <= 0)
+                {
+                    RemoveKey(ctx, keys[0]);
+                }
+                else
+                {
+                    ZRankFlush(ctx, rank_updates);
+                    SetKeyValue(ctx, keys[0], vs[0]);
+                }
             }
         }
+        if (removed > 0)
+        {
+            ZRankRebalance(ctx, keys[0], vs[0], rank_updates);
+        }
         if (0 != ctx.transc_err)
         {
             reply.SetErrCode(ctx.transc_err);
@@ -772,69 +1299,77 @@ OP_NAMESPACE_BEGIN
         {
             return 0;
         }
-        KeyObject sort_key(ctx.ns, KEY_ZSET_SCORE, key.GetKey());
-        sort_key.SetZSetMember(reverse ? range.max : range.min);
-        if(reverse)
+        /*
+         * Members are also keyed alone by KEY_ZSET_SCORE keys in member order, so the lex range is one bounded
+         * iterator: the lower bound is min(or its successor min+"\0" if excluded), the upper bound is max(or its
+         * successor if included), every key visited is in range and no member is decoded or compared.
+         */
+        KeyObject score_key(ctx.ns, KEY_ZSET_SCORE, key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(score_key);
+        std::string lower_member, upper_member;
+        if (!range.min.empty() || !range.include_min)
+        {
+            lower_member = range.min;
+            if (!range.include_min)
+            {
+                lower_member.push_back(0);
+            }
+            iter_opts.lower_bound.SetZSetMember(lower_member);
+        }
+        if (!range.max.empty() || !range.include_max)
         {
-            ctx.flags.iterate_total_order = 1;
+            upper_member = range.max;
+            if (range.include_max)
+            {
+                upper_member.push_back(0);
+            }
+            iter_opts.upper_bound = score_key;
+            iter_opts.upper_bound.SetZSetMember(upper_member);
         }
-        Iterator* iter = m_engine->Find(ctx, sort_key);
-        if (reverse && !iter->Valid())
+        iter_opts.total_order = reverse;
+        if (!with_limit)
+        {
+            CheckStreamIterate(meta.GetObjectLen(), iter_opts);
+        }
+        Iterator* iter = m_engine->Find(ctx, iter_opts.lower_bound, iter_opts);
+        if (reverse)
         {
             iter->JumpToLast();
         }
         int64_t range_cursor = 0;
         int64_t range_count = 0;
+        ZRankUpdates rank_updates;
         while (iter->Valid())
         {
-            KeyObject& field = iter->Key();
-            if (field.GetType() != KEY_ZSET_SCORE || field.GetNameSpace() != key.GetNameSpace() || field.GetKey() != key.GetKey())
+            if (with_limit && limit_count >= 0 && range_count >= limit_count)
             {
                 break;
             }
-            std::string member_str;
-            field.GetZSetMember().ToString(member_str);
-            int inrange = range.InRange(member_str);
-            if (reverse)
-            {
-                if (inrange < 0)
-                {
-                    break;
-                }
-            }
-            else
+            if (range_cursor >= limit_offset)
             {
-                if (inrange > 0)
-                {
-                    break;
-                }
-            }
-            if (0 == inrange)
-            {
-                if (!with_limit || (range_cursor >= limit_offset))
+                if (toremove)
                 {
-                    if (toremove)
-                    {
-                        KeyObject sort_key(ctx.ns, KEY_ZSET_SORT, key.GetKey());
-                        sort_key.SetZSetMember(field.GetZSetMember());
-                        sort_key.SetZSetScore(iter->Value().GetZSetScore());
-                        RemoveKey(ctx, sort_key);
-                        iter->Del();
-                        removed++;
-                    }
-                    else if (!countrange)
-                    {
-                        RedisReply& r1 = reply.AddMember();
-                        r1.SetString(field.GetZSetMember());
-                    }
-                    range_count++;
-                    if (with_limit && range_count >= limit_count)
+                    KeyObject& field = iter->Key();
+                    KeyObject sort_key(ctx.ns, KEY_ZSET_SORT, key.GetKey());
+                    sort_key.SetZSetMember(field.GetZSetMember());
+                    sort_key.SetZSetScore(iter->Value().GetZSetScore());
+                    RemoveKey(ctx, sort_key);
+                    if (meta.IsRankIndexed())
                     {
-                        break;
+                        ZRankUpdate(ctx, rank_updates, sort_key, -1);
                     }
+                    iter->Del();
+                    removed++;
                 }
-                range_cursor++;
+                else if (!countrange)
+                {
+                    RedisReply& r1 = reply.AddMember();
+                    r1.SetString(iter->Key().GetZSetMember());
+                }
+                range_count++;
             }
+            range_cursor++;
             if (reverse)
             {
                 iter->Prev();
@@ -856,8 +1391,10 @@ OP_NAMESPACE_BEGIN
                 }
                 else
                 {
+                    ZRankFlush(ctx, rank_updates);
                     SetKeyValue(ctx, key, meta);
                 }
+                ZRankRebalance(ctx, key, meta, rank_updates);
             }
             reply.SetInteger(removed);
         }
@@ -908,6 +1445,320 @@ OP_NAMESPACE_BEGIN
             //serverPanic("Unknown ZUNION/INTER aggregate type");
         }
     }
+    /*
+     * Same policy as the set operations, a source at least 'kZSetProbeRatio' times larger than the driving one is
+     * checked by point lookups, a walking iterator jumps to the wanted member after 'kZSetWalkSteps' smaller ones.
+     */
+    static const int64 kZSetProbeRatio = 16;
+    static const int kZSetWalkSteps = 8;
+
+    static int64 zset_operand_size(ValueObject& meta)
+    {
+        return meta.GetObjectLen() >= 0 ? meta.GetObjectLen() : LLONG_MAX;
+    }
+
+    bool Ardb::ZSetOperandSmaller::operator()(ZSetOperand* a, ZSetOperand* b) const
+    {
+        //zsets drive before sets, whose members are ordered differently
+        if (a->meta.GetType() != b->meta.GetType())
+        {
+            return a->meta.GetType() == KEY_ZSET;
+        }
+        return zset_operand_size(a->meta) < zset_operand_size(b->meta);
+    }
+
+    bool Ardb::ZSetOperandGreater::operator()(ZSetOperand* a, ZSetOperand* b) const
+    {
+        return a->iter->Key(false).GetElement(0).Compare(b->iter->Key(false).GetElement(0)) > 0;
+    }
+
+    void Ardb::ZSetOpOpen(Context& ctx, ZSetOperand& op, const Data& from)
+    {
+        KeyObject start(op.key.GetNameSpace(), element_type((KeyType) op.meta.GetType()), op.key.GetKey());
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(start);
+        CheckStreamIterate(op.meta.GetObjectLen(), iter_opts);
+        if (!from.IsNil())
+        {
+            start.SetMember(from, 0);
+        }
+        op.iter = m_engine->Find(ctx, start, iter_opts);
+    }
+
+    /*
+     * Return true & the unweighted score if 'member' is in the operand, a walked operand is left on the first member
+     * not less than 'member'. Probed members may come from a source of the other type, they are looked up by string.
+     */
+    bool Ardb::ZSetOpSeek(Context& ctx, ZSetOperand& op, const Data& member, double& score)
+    {
+        bool zset = op.meta.GetType() == KEY_ZSET;
+        if (op.probe)
+        {
+            KeyObject element(op.key.GetNameSpace(), element_type((KeyType) op.meta.GetType()), op.key.GetKey());
+            score = 1.0;
+            if (!zset)
+            {
+                element.SetSetMember(member.AsString());
+                return m_engine->Exists(ctx, element);
+            }
+            element.SetZSetMember(member.AsString());
+            ValueObject value;
+            if (0 != m_engine->Get(ctx, element, value))
+            {
+                return false;
+            }
+            score = value.GetZSetScore();
+            return true;
+        }
+        int steps = 0;
+        while (NULL != op.iter && op.iter->Valid())
+        {
+            int cmp = op.iter->Key(false).GetElement(0).Compare(member);
+            if (cmp >= 0)
+            {
+                if (cmp > 0)
+                {
+                    return false;
+                }
+                score = zset ? op.iter->Value().GetZSetScore() : 1.0;
+                return true;
+            }
+            if (++steps == kZSetWalkSteps)
+            {
+                KeyObject next(op.key.GetNameSpace(), element_type((KeyType) op.meta.GetType()), op.key.GetKey());
+                next.SetMember(member, 0);
+                op.iter->Jump(next);
+            }
+            else
+            {
+                op.iter->Next();
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Aggregate the scores hit for 'member' in the order of the sources, and write it to the destination.
+     */
+    void Ardb::ZSetOpEmit(Context& ctx, ZSetStoreOutput& out, const Data& member)
+    {
+        double score = 0;
+        bool first = true;
+        for (size_t i = 0; i < out.hits.size(); i++)
+        {
+            if (!out.hits[i])
+            {
+                continue;
+            }
+            if (first)
+            {
+                score = out.scores[i];
+                first = false;
+            }
+            else
+            {
+                zunionInterAggregate(&score, out.scores[i], out.aggregate);
+            }
+        }
+        Data zmember;
+        zmember.SetString(member.AsString(), false);
+        KeyObject element(out.dest.GetNameSpace(), KEY_ZSET_SCORE, out.dest.GetKey());
+        element.SetZSetMember(zmember);
+        ValueObject score_value;
+        score_value.SetType(KEY_ZSET_SCORE);
+        score_value.SetZSetScore(score);
+        SetKeyValue(ctx, element, score_value);
+        KeyObject sort(out.dest.GetNameSpace(), KEY_ZSET_SORT, out.dest.GetKey());
+        sort.SetZSetMember(zmember);
+        sort.SetZSetScore(score);
+        ValueObject sort_value;
+        sort_value.SetType(KEY_ZSET_SORT);
+        SetKeyValue(ctx, sort, sort_value);
+        if (out.min.IsNil() || zmember < out.min)
+        {
+            out.min = zmember;
+        }
+        if (out.max.IsNil() || zmember > out.max)
+        {
+            out.max = zmember;
+        }
+        out.count++;
+        int64 batch_size = GetConf().zset_store_batch_size;
+        if (batch_size > 0 && out.count % batch_size == 0)
+        {
+            DELETE(out.batch);
+            if (0 == ctx.transc_err)
+            {
+                NEW(out.batch, WriteBatchGuard(ctx, m_engine));
+            }
+        }
+    }
+
+    /*
+     * Leapfrog join driven by the smallest source, sources of the driver's type are walked along with it unless they
+     * are much larger, the others are probed.
+     */
+    void Ardb::ZSetOpInter(Context& ctx, PointerArray<ZSetOperand*>& ops, const Data& max, ZSetStoreOutput& out)
+    {
+        ZSetOperand& driver = *(ops[0]);
+        while (driver.iter->Valid() && NULL != out.batch)
+        {
+            const Data& member = driver.iter->Key(false).GetElement(0);
+            if (!max.IsNil() && member > max)
+            {
+                break;
+            }
+            out.hits.assign(out.hits.size(), 0);
+            bool matched = true;
+            bool exhausted = false;
+            const Data* next = NULL;
+            for (size_t i = 0; i < ops.size(); i++)
+            {
+                double score = 0;
+                if (ZSetOpSeek(ctx, *(ops[i]), member, score))
+                {
+                    score = ops[i]->weight * score;
+                    out.scores[ops[i]->idx] = std::isnan(score) ? 0 : score;
+                    out.hits[ops[i]->idx] = 1;
+                    continue;
+                }
+                matched = false;
+                if (!ops[i]->probe)
+                {
+                    if (ops[i]->iter->Valid())
+                    {
+                        next = &(ops[i]->iter->Key(false).GetElement(0));
+                    }
+                    else
+                    {
+                        exhausted = true;
+                    }
+                }
+                break;
+            }
+            if (exhausted)
+            {
+                break;
+            }
+            if (matched)
+            {
+                ZSetOpEmit(ctx, out, member);
+                driver.iter->Next();
+            }
+            else if (NULL != next)
+            {
+                double score;
+                ZSetOpSeek(ctx, driver, *next, score);
+            }
+            else
+            {
+                driver.iter->Next();
+            }
+        }
+    }
+
+    /*
+     * K-way merge of the sources of 'walk_type' by a min heap of their iterators, sources of the other type are
+     * probed for each merged member. Sets are merged after zsets, a set member found in any zset was written already.
+     */
+    void Ardb::ZSetOpMerge(Context& ctx, PointerArray<ZSetOperand*>& ops, KeyType walk_type, ZSetStoreOutput& out)
+    {
+        std::vector<ZSetOperand*> heap, group;
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            ops[i]->probe = ops[i]->meta.GetType() != walk_type;
+            if (!ops[i]->probe && ops[i]->iter->Valid())
+            {
+                heap.push_back(ops[i]);
+            }
+        }
+        ZSetOperandGreater greater;
+        std::make_heap(heap.begin(), heap.end(), greater);
+        while (!heap.empty() && NULL != out.batch)
+        {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            group.push_back(heap.back());
+            heap.pop_back();
+            const Data& member = group[0]->iter->Key(false).GetElement(0);
+            while (!heap.empty() && heap.front()->iter->Key(false).GetElement(0).Compare(member) == 0)
+            {
+                std::pop_heap(heap.begin(), heap.end(), greater);
+                group.push_back(heap.back());
+                heap.pop_back();
+            }
+            out.hits.assign(out.hits.size(), 0);
+            double score = 0;
+            for (size_t i = 0; i < group.size(); i++)
+            {
+                ZSetOpSeek(ctx, *(group[i]), member, score);
+                score = group[i]->weight * score;
+                out.scores[group[i]->idx] = std::isnan(score) ? 0 : score;
+                out.hits[group[i]->idx] = 1;
+            }
+            bool written = false;
+            for (size_t i = 0; i < ops.size() && !written; i++)
+            {
+                if (!ops[i]->probe || !ZSetOpSeek(ctx, *(ops[i]), member, score))
+                {
+                    continue;
+                }
+                written = walk_type == KEY_SET;
+                score = ops[i]->weight * score;
+                out.scores[ops[i]->idx] = std::isnan(score) ? 0 : score;
+                out.hits[ops[i]->idx] = 1;
+            }
+            if (!written)
+            {
+                ZSetOpEmit(ctx, out, member);
+            }
+            for (size_t i = 0; i < group.size(); i++)
+            {
+                group[i]->iter->Next();
+                if (group[i]->iter->Valid())
+                {
+                    heap.push_back(group[i]);
+                    std::push_heap(heap.begin(), heap.end(), greater);
+                }
+            }
+            group.clear();
+        }
+    }
+
+    /*
+     * Move the members staged under 'from' to the zset 'to', in batches like the merge writes them.
+     */
+    void Ardb::ZSetStoreMove(Context& ctx, const KeyObject& from, const KeyObject& to)
+    {
+        IterateOptions iter_opts;
+        iter_opts.BoundToObject(from);
+        Iterator* iter = m_engine->Find(ctx, from, iter_opts);
+        int64 batch_size = GetConf().zset_store_batch_size;
+        int64 moved = 0;
+        WriteBatchGuard* batch = NULL;
+        NEW(batch, WriteBatchGuard(ctx, m_engine));
+        while (iter->Valid())
+        {
+            KeyObject& k = iter->Key();
+            RemoveKey(ctx, k);
+            k.SetNameSpace(to.GetNameSpace());
+            k.SetKey(to.GetKey());
+            SetKeyValue(ctx, k, iter->Value());
+            iter->Next();
+            moved++;
+            if (batch_size > 0 && moved % batch_size == 0)
+            {
+                DELETE(batch);
+                if (0 != ctx.transc_err)
+                {
+                    break;
+                }
+                NEW(batch, WriteBatchGuard(ctx, m_engine));
+            }
+        }
+        DELETE(batch);
+        DELETE(iter);
+    }
+
     int Ardb::ZInterStore(Context& ctx, RedisCommandFrame& cmd)
     {
         RedisReply& reply = ctx.GetReply();
@@ -981,6 +1832,7 @@ OP_NAMESPACE_BEGIN
             }
         }
 
+        ctx.flags.create_if_notexist = 1;
         KeyObjectArray keys;
         ValueObjectArray vs;
         ErrCodeArray errs;
@@ -993,159 +1845,169 @@ OP_NAMESPACE_BEGIN
         keys.push_back(destkey);
         KeysLockGuard guard(ctx, keys);
         m_engine->MultiGet(ctx, keys, vs, errs);
+        bool inter = cmd.GetType() == REDIS_CMD_ZINTERSTORE;
+        bool empty_result = false;
+        bool staged = false;
+        bool bounded = inter;
+        Data min, max;
+        PointerArray<ZSetOperand*> ops;
         for (size_t i = 0; i < setnum; i++)
         {
-            if (!CheckMeta(ctx, keys[i], KEY_ZSET, vs[i], false) && !!CheckMeta(ctx, keys[i], KEY_SET, vs[i], false))
+            if (errs[i] != 0 && errs[i] != ERR_ENTRY_NOT_EXIST)
             {
+                reply.SetErrCode(errs[i]);
                 return 0;
             }
-        }
-        DataScoreMap inter_union_result[2];
-        size_t result_cursor = 1;
-        if (cmd.GetType() == REDIS_CMD_ZINTERSTORE)
-        {
-            bool empty_inter_result = false;
-            PointerArray<Iterator*> iters;
-            iters.resize(setnum);
-            Data min, max;
-            for (size_t i = 0; !empty_inter_result && i < setnum; i++)
+            if (!CheckMeta(ctx, keys[i], (KeyType) 0, vs[i], false))
             {
-                if (vs[i].GetType() == 0)
-                {
-                    empty_inter_result = true;
-                    break;
-                }
-                GetMinMax(ctx, keys[i], vs[i], iters[i]);
-                if (min.IsNil() || vs[i].GetMin() > min)
-                {
-                    min = vs[i].GetMin();
-                }
-                if (max.IsNil() || vs[i].GetMax() < max)
-                {
-                    max = vs[i].GetMax();
-                }
-                if (min > max)
-                {
-                    empty_inter_result = true;
-                    break;
-                }
+                return 0;
+            }
+            if (vs[i].GetType() > 0 && vs[i].GetType() != KEY_ZSET && vs[i].GetType() != KEY_SET)
+            {
+                reply.SetErrCode(ERR_WRONG_TYPE);
+                return 0;
             }
-            for (size_t i = 0; !empty_inter_result && i < setnum; i++)
+            if (vs[i].GetType() == 0)
             {
-                KeyObject start(ctx.ns, (KeyType) element_type((KeyType) vs[i].GetType()), keys[i].GetKey());
-                start.SetSetMember(min);
-                iters[i]->Jump(start);
-                result_cursor = 1 - result_cursor;
-                inter_union_result[result_cursor].clear();
-                while (iters[i]->Valid())
+                empty_result = empty_result || inter;
+                continue;
+            }
+            if (vs[i].GetType() == KEY_ZSET && inter)
+            {
+                if (vs[i].GetMin().IsNil() || vs[i].GetMax().IsNil())
                 {
-                    KeyObject& k = iters[i]->Key(true);
-                    if (k.GetType() != start.GetType() || k.GetKey() != keys[i].GetKey() || k.GetNameSpace() != keys[i].GetNameSpace()
-                            || k.GetSetMember() > max)
-                    {
-                        break;
-                    }
-                    double score = 1.0;
-                    if (k.GetType() == KEY_ZSET_SCORE)
-                    {
-                        score = iters[i]->Value().GetZSetScore();
-                    }
-                    score = weights[i] * score;
-                    if (i == 0)
+                    bounded = false;
+                }
+                else
+                {
+                    if (min.IsNil() || vs[i].GetMin() > min)
                     {
-                        inter_union_result[result_cursor][k.GetElement(0)] = score;
+                        min = vs[i].GetMin();
                     }
-                    else
+                    if (max.IsNil() || vs[i].GetMax() < max)
                     {
-                        DataScoreMap& last_result = inter_union_result[1 - result_cursor];
-                        DataScoreMap::iterator found = last_result.find(k.GetElement(0));
-                        if (found != last_result.end())
-                        {
-                            zunionInterAggregate(&score, found->second, aggregate);
-                            inter_union_result[result_cursor][k.GetElement(0)] = score;
-                            last_result.erase(found);
-                        }
+                        max = vs[i].GetMax();
                     }
-                    iters[i]->Next();
                 }
             }
+            staged = staged || keys[i].GetKey() == destkey.GetKey();
+            ZSetOperand* op = NULL;
+            NEW(op, ZSetOperand);
+            op->key = keys[i];
+            op->meta = vs[i];
+            op->weight = weights[i];
+            op->idx = i;
+            ops.push_back(op);
         }
-        else
+        if (!bounded)
         {
-            Iterator* iter = NULL;
-            ctx.flags.iterate_no_upperbound = 1;
-            for (size_t i = 0; i < setnum; i++)
+            min.Clear();
+            max.Clear();
+        }
+        else if (!min.IsNil() && min > max)
+        {
+            empty_result = true;
+        }
+        if (ops.empty())
+        {
+            empty_result = true;
+        }
+        if (!empty_result)
+        {
+            if (inter)
+            {
+                std::stable_sort(ops.begin(), ops.end(), ZSetOperandSmaller());
+            }
+            ZSetOperand* driver = ops[0];
+            for (size_t i = 0; i < ops.size(); i++)
             {
-                if (vs[i].GetType() == 0)
+                ZSetOperand* op = ops[i];
+                if (inter && i > 0
+                        && (op->meta.GetType() != driver->meta.GetType()
+                                || (zset_operand_size(driver->meta) != LLONG_MAX && zset_operand_size(op->meta) != LLONG_MAX
+                                        && zset_operand_size(op->meta) / kZSetProbeRatio >= zset_operand_size(driver->meta))))
                 {
+                    op->probe = true;
                     continue;
                 }
-                KeyObject ele(ctx.ns, (KeyType) element_type((KeyType) vs[i].GetType()), keys[i].GetKey());
-                if (NULL != iter)
-                {
-                    iter->Jump(ele);
-                }
-                else
-                {
-                    iter = m_engine->Find(ctx, ele);
-                }
-                while (NULL != iter && iter->Valid())
-                {
-                    KeyObject& k = iter->Key(true);
-                    if (k.GetType() != ele.GetType() || k.GetKey() != keys[i].GetKey() || k.GetNameSpace() != keys[i].GetNameSpace())
-                    {
-                        break;
-                    }
-                    double score = 1.0;
-                    if (k.GetType() == KEY_ZSET_SCORE)
-                    {
-                        score = iter->Value().GetZSetScore();
-                    }
-                    //printf("###%f  %f\n", weights[i], score);
-                    score = weights[i] * score;
-                    DataScoreMap& result_map = inter_union_result[result_cursor];
-                    std::pair<DataScoreMap::iterator, bool> ret = result_map.insert(DataScoreMap::value_type(k.GetElement(0), score));
-                    if (!ret.second)
-                    {
-                        zunionInterAggregate(&score, ret.first->second, aggregate);
-                        ret.first->second = score;
-                    }
-                    iter->Next();
-                }
+                ZSetOpOpen(ctx, *op, op->meta.GetType() == KEY_ZSET ? min : Data());
             }
-            DELETE(iter);
         }
-        if (vs[vs.size() - 1].GetType() > 0)
+
+        /*
+         * the result is staged in ZSET_STORE_NAMESPACE while the destination is also a source, so that point lookups
+         * of the sources never see a partially written destination. The staging key is prefixed by the db of the
+         * destination, stores to the same key of two dbs must not share it.
+         */
+        ZSetStoreOutput out;
+        out.aggregate = aggregate;
+        out.scores.resize(setnum);
+        out.hits.resize(setnum);
+        if (staged)
+        {
+            Data staging_ns(ZSET_STORE_NAMESPACE, false);
+            std::string staging_key = destkey.GetNameSpace().AsString();
+            staging_key.push_back(0);
+            staging_key.append(destkey.GetKey().AsString());
+            out.dest = KeyObject(staging_ns, KEY_META, staging_key);
+            DelKey(ctx, out.dest);
+        }
+        else
         {
-            DelKey(ctx, destkey);
+            out.dest = destkey;
+            if (vs[setnum].GetType() > 0)
+            {
+                DelKey(ctx, destkey);
+            }
         }
-
-        if (!inter_union_result[result_cursor].empty())
+        NEW(out.batch, WriteBatchGuard(ctx, m_engine));
+        if (!empty_result)
+        {
+            if (inter)
+            {
+                ZSetOpInter(ctx, ops, max, out);
+            }
+            else
+            {
+                ZSetOpMerge(ctx, ops, (KeyType) KEY_ZSET, out);
+                ZSetOpMerge(ctx, ops, (KeyType) KEY_SET, out);
+            }
+        }
+        DELETE(out.batch);
+        for (size_t i = 0; i < ops.size(); i++)
+        {
+            DELETE(ops[i]->iter); //iterators created before the commit may not see the changes
+        }
+        if (0 == ctx.transc_err && staged)
+        {
+            if (vs[setnum].GetType() > 0)
+            {
+                DelKey(ctx, destkey);
+            }
+            ZSetStoreMove(ctx, out.dest, destkey);
+        }
+        if (0 == ctx.transc_err && out.count > 0)
         {
-            DataScoreMap::iterator it = inter_union_result[result_cursor].begin();
             ValueObject dest_meta;
-            dest_meta.SetType(KEY_ZSET);
-            dest_meta.SetObjectLen(inter_union_result[result_cursor].size());
-            while (it != inter_union_result[result_cursor].end())
-            {
-                KeyObject element(ctx.ns, KEY_ZSET_SCORE, cmd.GetArguments()[0]);
-                element.SetSetMember(it->first);
-                ValueObject score;
-                score.SetType(KEY_ZSET_SCORE);
-                score.SetZSetScore(it->second);
-                KeyObject sort(ctx.ns, KEY_ZSET_SORT, cmd.GetArguments()[0]);
-                sort.SetZSetMember(it->first);
-                sort.SetZSetScore(it->second);
-                ValueObject sort_value;
-                sort_value.SetType(KEY_ZSET_SORT);
-                SetKeyValue(ctx, sort, sort_value);
-                it++;
-            }
-            dest_meta.SetMinData(inter_union_result[result_cursor].begin()->first);
-            dest_meta.SetMaxData(inter_union_result[result_cursor].rbegin()->first);
-            SetKeyValue(ctx, destkey, dest_meta);
-        }
-        reply.SetInteger(inter_union_result[result_cursor].size());
+            {
+                WriteBatchGuard batch(ctx, m_engine);
+                dest_meta.SetType(KEY_ZSET);
+                dest_meta.SetObjectLen(out.count);
+                dest_meta.SetMinData(out.min);
+                dest_meta.SetMaxData(out.max);
+                SetKeyValue(ctx, destkey, dest_meta);
+            }
+            ZRankUpdates rank_updates;
+            ZRankRebalance(ctx, destkey, dest_meta, rank_updates);
+        }
+        if (ctx.transc_err != 0)
+        {
+            reply.SetErrCode(ctx.transc_err);
+        }
+        else
+        {
+            reply.SetInteger(out.count);
+        }
         return 0;
     }
 
@@ -28,7 +28,7 @@
  */
 
 #include "db/db.hpp"
-#include "thread/thread_mutex.hpp"
+#include "util/atomic.hpp"
 
 namespace ardb
 {
@@ -40,7 +40,7 @@ namespace ardb
             reply.SetErrorReason("MULTI calls can not be nested");
             return 0;
         }
-        ctx.GetTransaction();
+        ctx.GetTransaction().multi = true;
         reply.SetStatusCode(STATUS_OK);
         return 0;
     }
@@ -65,7 +65,7 @@ namespace ardb
         {
             reply.SetErrorReason("EXEC without MULTI");
         }
-        else if (ctx.GetTransaction().abort || ctx.GetTransaction().cas)
+        else if (ctx.GetTransaction().abort || WatchedKeysTouched(ctx))
         {
             if (ctx.GetTransaction().abort)
             {
@@ -90,6 +90,10 @@ namespace ardb
                 if (NULL != setting)
                 {
                     transc_ctx.GetReply().Clear();
+                    /*
+                     * consecutive single key writes of the transaction are applied as one engine write batch
+                     */
+                    JoinPipelineBatch(transc_ctx, *it);
                     DoCall(transc_ctx, *setting, *it);
                     r.Clone(transc_ctx.GetReply());
                 }
@@ -99,6 +103,7 @@ namespace ardb
                 }
                 it++;
             }
+            CommitPipelineBatch(transc_ctx);
             ctx.ns = transc_ctx.ns;
             DiscardTransaction(ctx);
         }
@@ -123,96 +128,101 @@ namespace ardb
 
     int Ardb::TouchWatchedKeysOnFlush(Context& ctx, const Data& ns)
     {
-        if (NULL == m_watched_ctxs)
+        FireKeysFlushedEvent(ctx);
+        if (0 == m_watching_clients)
         {
             return 0;
         }
-        LockGuard<SpinMutexLock> guard(m_watched_keys_lock);
-        if (!m_watched_ctxs->empty())
-        {
-            WatchedContextTable::iterator wit = m_watched_ctxs->begin();
-            while (wit != m_watched_ctxs->end())
-            {
-                if (ns.IsNil() || wit->first.ns == ns)
-                {
-                    ContextSet::iterator cit = wit->second.begin();
-                    while (cit != wit->second.end())
-                    {
-                        (*cit)->GetTransaction().cas = true;
-                        cit++;
-                    }
-                }
-                wit++;
-            }
-        }
+        atomic_add_uint32(&m_watch_flush_version, 1);
         return 0;
     }
 
     int Ardb::TouchWatchKey(Context& ctx, const KeyObject& key)
     {
-        if (NULL == m_watched_ctxs)
+        FireKeyChangedEvent(ctx, key);
+        if (0 == m_watching_clients)
         {
             return 0;
         }
-        LockGuard<SpinMutexLock> guard(m_watched_keys_lock);
-        if (!m_watched_ctxs->empty())
+        KeyPrefix prefix;
+        prefix.ns = key.GetNameSpace();
+        prefix.key = key.GetKey();
+        atomic_add_uint32(&m_watch_versions[GetWatchVersionSlot(prefix)], 1);
+        return 0;
+    }
+
+    bool Ardb::WatchedKeysTouched(Context& ctx)
+    {
+        TransactionContext& transc = ctx.GetTransaction();
+        if (transc.watched_keys.empty())
+        {
+            return false;
+        }
+        if (transc.watched_flush_version != m_watch_flush_version)
         {
-            KeyPrefix prefix;
-            prefix.ns = key.GetNameSpace();
-            prefix.key = key.GetKey();
-            WatchedContextTable::iterator found = m_watched_ctxs->find(prefix);
-            if (found != m_watched_ctxs->end())
+            return true;
+        }
+        TransactionContext::WatchKeyTable::iterator it = transc.watched_keys.begin();
+        while (it != transc.watched_keys.end())
+        {
+            if (it->second != m_watch_versions[GetWatchVersionSlot(it->first)])
             {
-                ContextSet::iterator cit = found->second.begin();
-                while (cit != found->second.end())
-                {
-                    (*cit)->GetTransaction().cas = true;
-                    cit++;
-                }
+                return true;
             }
+            it++;
         }
-        return 0;
+        return false;
+    }
+
+    /*
+     * Whether the watched 'key' of the current db was written or flushed since it was watched.
+     */
+    bool Ardb::WatchedKeyTouched(Context& ctx, const Data& key)
+    {
+        TransactionContext& transc = ctx.GetTransaction();
+        if (transc.watched_flush_version != m_watch_flush_version)
+        {
+            return true;
+        }
+        KeyPrefix prefix;
+        prefix.ns = ctx.ns;
+        prefix.key = key;
+        TransactionContext::WatchKeyTable::iterator found = transc.watched_keys.find(prefix);
+        return found == transc.watched_keys.end() || found->second != m_watch_versions[GetWatchVersionSlot(prefix)];
     }
 
     int Ardb::WatchForKey(Context& ctx, const std::string& key)
     {
-        LockGuard<SpinMutexLock> guard(m_watched_keys_lock);
-        if (NULL == m_watched_ctxs)
+        TransactionContext& transc = ctx.GetTransaction();
+        if (transc.watched_keys.empty())
         {
-            NEW(m_watched_ctxs, WatchedContextTable);
+            /*
+             * writes start bumping versions before the versions of the keys are taken, so none of the later writes is missed
+             */
+            atomic_add_uint32(&m_watching_clients, 1);
+            transc.watched_flush_version = m_watch_flush_version;
         }
         KeyPrefix prefix;
         prefix.ns = ctx.ns;
         prefix.key.SetString(key, false);
-        (*m_watched_ctxs)[prefix].insert(&ctx);
-        ctx.GetTransaction().watched_keys.insert(prefix);
+        if (transc.watched_keys.count(prefix) == 0)
+        {
+            transc.watched_keys[prefix] = m_watch_versions[GetWatchVersionSlot(prefix)];
+        }
         return 0;
     }
 
     int Ardb::UnwatchKeys(Context& ctx)
     {
-        if (NULL == m_watched_ctxs)
+        if (NULL == ctx.transc || ctx.transc->watched_keys.empty())
         {
             return 0;
         }
-        LockGuard<SpinMutexLock> guard(m_watched_keys_lock);
-        if (ctx.transc != NULL && m_watched_ctxs->empty())
-        {
-            TransactionContext::WatchKeySet::iterator it = ctx.GetTransaction().watched_keys.begin();
-            while (it != ctx.GetTransaction().watched_keys.end())
-            {
-                const KeyPrefix& prefix = *it;
-                (*m_watched_ctxs)[prefix].erase(&ctx);
-                if ((*m_watched_ctxs)[prefix].size() == 0)
-                {
-                    (*m_watched_ctxs).erase(prefix);
-                }
-                it++;
-            }
-        }
-        if (m_watched_ctxs->empty())
+        ctx.transc->watched_keys.clear();
+        atomic_sub_uint32(&m_watching_clients, 1);
+        if (!ctx.transc->multi)
         {
-            DELETE(m_watched_ctxs);
+            ctx.ClearTransaction();
         }
         return 0;
     }
@@ -37,6 +37,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <string>
+#include "buffer_pool.hpp"
 
 namespace ardb
 {
@@ -60,22 +61,52 @@ namespace ardb
 			size_t m_write_idx;
 			size_t m_read_idx;
 			bool m_in_heap;
+			bool m_use_pool; //allocate the raw buffer from BufferPool
+			size_t m_pooled_size; //block size if the raw buffer is a BufferPool block
+
+			inline char* AllocateSpace(size_t& capacity, size_t& pooled_size)
+			{
+				pooled_size = 0;
+				if (m_use_pool)
+				{
+					char* space = BufferPool::Allocate(capacity);
+					if (NULL != space)
+					{
+						pooled_size = capacity;
+						return space;
+					}
+				}
+				return (char*) malloc(capacity);
+			}
+			inline void FreeSpace()
+			{
+				if (NULL != m_buffer && m_in_heap)
+				{
+					if (m_pooled_size > 0)
+					{
+						BufferPool::Free(m_buffer, m_pooled_size);
+					} else
+					{
+						free(m_buffer);
+					}
+				}
+			}
 		public:
 			static const int BUFFER_MAX_READ = 8192;
 			static const size_t DEFAULT_BUFFER_SIZE = 32;
 			inline Buffer() :
 					m_buffer(0), m_buffer_len(0), m_write_idx(0), m_read_idx(0), m_in_heap(
-							true)
+							true), m_use_pool(false), m_pooled_size(0)
 			{
 			}
 			inline Buffer(char* value, int off, int len) :
 					m_buffer(value), m_buffer_len(len), m_write_idx(len), m_read_idx(
-							off), m_in_heap(false)
+							off), m_in_heap(false), m_use_pool(false), m_pooled_size(0)
 			{
 			}
 			inline Buffer(size_t size) :
 					m_buffer(0), m_buffer_len(0), m_write_idx(0), m_read_idx(0), m_in_heap(
-							true)
+							true), m_use_pool(false), m_pooled_size(0)
 			{
 				EnsureWritableBytes(size);
 			}
@@ -148,9 +179,11 @@ namespace ardb
 				uint32_t readableBytes = ReadableBytes();
 				uint32_t total = Capacity();
 				char* newSpace = NULL;
+				size_t newCapacity = readableBytes;
+				size_t pooled = 0;
 				if (readableBytes > 0)
 				{
-					newSpace = (char*) malloc(readableBytes);
+					newSpace = AllocateSpace(newCapacity, pooled);
 					if (NULL == newSpace)
 					{
 						return 0;
@@ -160,16 +193,14 @@ namespace ardb
 				{
 					return 0;
 				}
-				if (NULL != m_buffer && m_in_heap)
-				{
-					free(m_buffer);
-				}
+				FreeSpace();
 				m_read_idx = 0;
 				m_write_idx = readableBytes;
-				m_buffer_len = readableBytes;
+				m_buffer_len = newCapacity;
 				m_buffer = newSpace;
 				m_in_heap = true;
-				return total - readableBytes;
+				m_pooled_size = pooled;
+				return total > newCapacity ? total - newCapacity : 0;
 			}
 
 			inline bool EnsureWritableBytes(size_t minWritableBytes,
@@ -191,9 +222,10 @@ namespace ardb
 						newCapacity <<= 1;
 					}
 					char* tmp = NULL;
+					size_t pooled = 0;
 
 					//tmp = (char*) realloc(m_buffer, newCapacity);
-					tmp = (char*) malloc(newCapacity);
+					tmp = AllocateSpace(newCapacity, pooled);
 					if (NULL != tmp)
 					{
 						if (growzero)
@@ -204,11 +236,9 @@ namespace ardb
 						{
 							memcpy(tmp, m_buffer, Capacity());
 						}
-						if (m_in_heap && NULL != m_buffer)
-						{
-							free(m_buffer);
-						}
+						FreeSpace();
 						m_in_heap = true;
+						m_pooled_size = pooled;
 						m_buffer = tmp;
 						m_buffer_len = newCapacity;
 						return true;
@@ -379,12 +409,33 @@ namespace ardb
 			{
 				return std::string(m_buffer + m_read_idx, ReadableBytes());
 			}
-			inline ~Buffer()
+			/*
+			 * Route later allocations of the raw buffer through BufferPool.
+			 */
+			inline void SetUsePool(bool on)
 			{
-				if (m_buffer != NULL && m_in_heap)
+				m_use_pool = on;
+			}
+			/*
+			 * Give the raw buffer back, fails if there is readable content.
+			 */
+			inline bool Release()
+			{
+				if (Readable())
 				{
-					free(m_buffer);
+					return false;
 				}
+				FreeSpace();
+				m_buffer = NULL;
+				m_buffer_len = 0;
+				m_write_idx = m_read_idx = 0;
+				m_in_heap = true;
+				m_pooled_size = 0;
+				return true;
+			}
+			inline ~Buffer()
+			{
+				FreeSpace();
 			}
 
 	};
@@ -468,7 +468,7 @@ namespace ardb
         {
              i = swap_int64(i);
         }
-        return sizeof(uint64_t) == buffer.Write(&i, sizeof(int64_t));
+        return sizeof(int64_t) == buffer.Write(&i, sizeof(int64_t));
 	}
 
 	bool BufferHelper::WriteFixUInt32(Buffer& buffer, uint32_t i,
@@ -478,7 +478,7 @@ namespace ardb
         {
              i = swap_uint32(i);
         }
-        return sizeof(uint64_t) == buffer.Write(&i, sizeof(uint32_t));
+        return sizeof(uint32_t) == buffer.Write(&i, sizeof(uint32_t));
 	}
 
 	bool BufferHelper::WriteFixInt32(Buffer& buffer, int32_t i, bool bigendian)
@@ -487,7 +487,7 @@ namespace ardb
         {
              i = swap_int32(i);
         }
-        return sizeof(uint64_t) == buffer.Write(&i, sizeof(int32_t));
+        return sizeof(int32_t) == buffer.Write(&i, sizeof(int32_t));
 	}
 
 	bool BufferHelper::WriteFixFloat(Buffer& buffer, float i, bool bigendian)
@@ -530,7 +530,7 @@ namespace ardb
         {
              i = swap_uint16(i);
         }
-        return sizeof(uint64_t) == buffer.Write(&i, sizeof(uint16_t));
+        return sizeof(uint16_t) == buffer.Write(&i, sizeof(uint16_t));
 	}
 
 	bool BufferHelper::WriteFixInt16(Buffer& buffer, int16_t i, bool bigendian)
@@ -539,7 +539,7 @@ namespace ardb
         {
              i = swap_int16(i);
         }
-        return sizeof(uint64_t) == buffer.Write(&i, sizeof(int16_t));
+        return sizeof(int16_t) == buffer.Write(&i, sizeof(int16_t));
 	}
 
 	bool BufferHelper::WriteFixString(Buffer& buffer, const string& str,
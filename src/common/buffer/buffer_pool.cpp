@@ -0,0 +1,230 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "buffer_pool.hpp"
+#include "thread/thread_local.hpp"
+#include "thread/spin_mutex_lock.hpp"
+#include "thread/lock_guard.hpp"
+#include "util/atomic.hpp"
+#include "util/mem_arena.hpp"
+#include <stdlib.h>
+
+#define BUFFER_POOL_CLASSES 11  /* 1KB ... 1MB */
+
+namespace ardb
+{
+    struct FreeBlock
+    {
+            FreeBlock* next;
+    };
+
+    static size_t g_shared_limit = 64 * 1024 * 1024;
+    static volatile uint64_t g_allocated_bytes = 0;
+    static SpinMutexLock g_shared_lock;
+    static FreeBlock* g_shared_blocks[BUFFER_POOL_CLASSES];
+    static size_t g_shared_bytes = 0;
+
+    static inline int size_class(size_t& size)
+    {
+        int idx = 0;
+        size_t block_size = BufferPool::MIN_BLOCK_SIZE;
+        while (block_size < size)
+        {
+            block_size <<= 1;
+            idx++;
+        }
+        size = block_size;
+        return idx;
+    }
+
+    static bool shared_push(FreeBlock* block, int idx, size_t size)
+    {
+        LockGuard<SpinMutexLock> guard(g_shared_lock);
+        if (g_shared_bytes + size > g_shared_limit)
+        {
+            return false;
+        }
+        block->next = g_shared_blocks[idx];
+        g_shared_blocks[idx] = block;
+        g_shared_bytes += size;
+        return true;
+    }
+
+    static FreeBlock* shared_pop(int idx, size_t size)
+    {
+        LockGuard<SpinMutexLock> guard(g_shared_lock);
+        FreeBlock* block = g_shared_blocks[idx];
+        if (NULL != block)
+        {
+            g_shared_blocks[idx] = block->next;
+            g_shared_bytes -= size;
+        }
+        return block;
+    }
+
+    static void release_block(FreeBlock* block, size_t size)
+    {
+        atomic_sub_uint64(&g_allocated_bytes, size);
+        arena_free(MEM_ARENA_REPLY, block);
+    }
+
+    struct BufferPoolCache
+    {
+            FreeBlock* blocks[BUFFER_POOL_CLASSES];
+            size_t bytes;
+            BufferPoolCache() :
+                    bytes(0)
+            {
+                for (int i = 0; i < BUFFER_POOL_CLASSES; i++)
+                {
+                    blocks[i] = NULL;
+                }
+            }
+            ~BufferPoolCache()
+            {
+                /*
+                 * hand the cached blocks of the exiting thread over to other threads
+                 */
+                for (int i = 0; i < BUFFER_POOL_CLASSES; i++)
+                {
+                    size_t size = BufferPool::MIN_BLOCK_SIZE << i;
+                    while (NULL != blocks[i])
+                    {
+                        FreeBlock* block = blocks[i];
+                        blocks[i] = block->next;
+                        if (!shared_push(block, i, size))
+                        {
+                            release_block(block, size);
+                        }
+                    }
+                }
+            }
+    };
+    static ThreadLocal<BufferPoolCache> g_thread_cache;
+
+    char* BufferPool::Allocate(size_t& size)
+    {
+        if (0 == g_shared_limit || size > MAX_BLOCK_SIZE)
+        {
+            return NULL;
+        }
+        size_t block_size = size;
+        int idx = size_class(block_size);
+        BufferPoolCache& cache = g_thread_cache.GetValue();
+        FreeBlock* block = cache.blocks[idx];
+        if (NULL != block)
+        {
+            cache.blocks[idx] = block->next;
+            cache.bytes -= block_size;
+        }
+        else
+        {
+            block = shared_pop(idx, block_size);
+        }
+        if (NULL == block)
+        {
+            block = (FreeBlock*) arena_malloc(MEM_ARENA_REPLY, block_size);
+            if (NULL == block)
+            {
+                return NULL;
+            }
+            atomic_add_uint64(&g_allocated_bytes, block_size);
+        }
+        size = block_size;
+        return (char*) block;
+    }
+
+    void BufferPool::Free(char* data, size_t size)
+    {
+        if (NULL == data)
+        {
+            return;
+        }
+        int idx = size_class(size);
+        FreeBlock* block = (FreeBlock*) data;
+        BufferPoolCache& cache = g_thread_cache.GetValue();
+        if (cache.bytes + size <= THREAD_CACHE_SIZE)
+        {
+            block->next = cache.blocks[idx];
+            cache.blocks[idx] = block;
+            cache.bytes += size;
+            return;
+        }
+        if (!shared_push(block, idx, size))
+        {
+            release_block(block, size);
+        }
+    }
+
+    /*
+     * Called with the shared lock held.
+     */
+    static void shared_trim(size_t limit)
+    {
+        for (int i = 0; i < BUFFER_POOL_CLASSES && g_shared_bytes > limit; i++)
+        {
+            size_t size = BufferPool::MIN_BLOCK_SIZE << i;
+            while (NULL != g_shared_blocks[i] && g_shared_bytes > limit)
+            {
+                FreeBlock* block = g_shared_blocks[i];
+                g_shared_blocks[i] = block->next;
+                g_shared_bytes -= size;
+                release_block(block, size);
+            }
+        }
+    }
+
+    void BufferPool::SetSharedLimit(size_t limit)
+    {
+        LockGuard<SpinMutexLock> guard(g_shared_lock);
+        g_shared_limit = limit;
+        shared_trim(limit);
+    }
+
+    void BufferPool::ReleaseShared()
+    {
+        LockGuard<SpinMutexLock> guard(g_shared_lock);
+        shared_trim(0);
+    }
+
+    bool BufferPool::IsEnabled()
+    {
+        return g_shared_limit > 0;
+    }
+
+    uint64_t BufferPool::AllocatedBytes()
+    {
+        return g_allocated_bytes;
+    }
+
+    uint64_t BufferPool::SharedCachedBytes()
+    {
+        LockGuard<SpinMutexLock> guard(g_shared_lock);
+        return g_shared_bytes;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BUFFER_POOL_HPP_
+#define BUFFER_POOL_HPP_
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ardb
+{
+    /*
+     * Size classed pool of the raw storage of channel buffers. Blocks are power of two
+     * sized from MIN_BLOCK_SIZE to MAX_BLOCK_SIZE, freed blocks are cached by the freeing
+     * thread first and spill over into a list shared by all threads, so idle connections
+     * do not have to keep their grown buffers.
+     */
+    class BufferPool
+    {
+        public:
+            static const size_t MIN_BLOCK_SIZE = 1024;
+            static const size_t MAX_BLOCK_SIZE = 1024 * 1024;
+            static const size_t THREAD_CACHE_SIZE = 4 * 1024 * 1024;
+            /*
+             * Return NULL if the pool is disabled or 'size' exceeds MAX_BLOCK_SIZE,
+             * otherwise 'size' is rounded up to the size of the returned block.
+             */
+            static char* Allocate(size_t& size);
+            static void Free(char* block, size_t size);
+            /*
+             * Max bytes of the shared free list, 0 disables the pool.
+             */
+            static void SetSharedLimit(size_t limit);
+            /*
+             * Free all blocks of the shared list, thread caches are kept.
+             */
+            static void ReleaseShared();
+            static bool IsEnabled();
+            static uint64_t AllocatedBytes();
+            static uint64_t SharedCachedBytes();
+    };
+}
+
+#endif /* BUFFER_POOL_HPP_ */
@@ -36,7 +36,10 @@
 #ifndef STRUCT_CODEC_MACROS_HPP_
 #define STRUCT_CODEC_MACROS_HPP_
 #include "buffer/buffer_helper.hpp"
-#include "buffer/struct_code_templates.hpp"
+#include "util/math_helper.hpp"
+#include "util/system_helper.hpp"
+#include <string.h>
+#include <type_traits>
 #include <string>
 #include <list>
 #include <map>
@@ -923,6 +926,269 @@ namespace ardb
         return true;
     }
 
+    /*
+     * Multi fields codec, fields are encoded/decoded in order by the single field overloads above.
+     */
+    template<typename A0, typename A1, typename ... Args>
+    inline bool encode_arg(Buffer& buf, A0& a0, A1& a1, Args&... args)
+    {
+        return encode_arg(buf, a0) && encode_arg(buf, a1, args...);
+    }
+    template<typename A0, typename A1, typename ... Args>
+    inline bool decode_arg(Buffer& buf, A0& a0, A1& a1, Args&... args)
+    {
+        return decode_arg(buf, a0) && decode_arg(buf, a1, args...);
+    }
+
+    /*
+     * Fixed width fields of the fix codec, 0 for others.
+     */
+    template<typename T> struct FixPodSize
+    {
+            static const size_t value = 0;
+    };
+#define FIX_POD_SIZE(T) template<> struct FixPodSize<T> { static const size_t value = sizeof(T); };
+    FIX_POD_SIZE(bool)
+    FIX_POD_SIZE(int8_t)
+    FIX_POD_SIZE(uint8_t)
+    FIX_POD_SIZE(int16_t)
+    FIX_POD_SIZE(uint16_t)
+    FIX_POD_SIZE(int32_t)
+    FIX_POD_SIZE(uint32_t)
+    FIX_POD_SIZE(int64_t)
+    FIX_POD_SIZE(uint64_t)
+#undef FIX_POD_SIZE
+
+    /*
+     * Total width of a run of fields if all of them are fixed width, 0 otherwise.
+     */
+    template<typename ... Args> struct FixPodRunSize
+    {
+            static const size_t value = 0;
+    };
+    template<typename A0, typename ... Args> struct FixPodRunSize<A0, Args...>
+    {
+            static const size_t head = FixPodSize<typename std::remove_const<A0>::type>::value;
+            static const size_t tail = FixPodRunSize<Args...>::value;
+            static const size_t value = (0 == head || (sizeof...(Args) > 0 && 0 == tail)) ? 0 : head + tail;
+    };
+
+    inline void fix_pod_put(char*& p, bool v)
+    {
+        *p++ = (char) v;
+    }
+    inline void fix_pod_put(char*& p, int8_t v)
+    {
+        *p++ = (char) v;
+    }
+    inline void fix_pod_put(char*& p, uint8_t v)
+    {
+        *p++ = (char) v;
+    }
+    inline void fix_pod_put(char*& p, uint16_t v)
+    {
+        v = is_bigendian() ? v : swap_uint16(v);
+        memcpy(p, &v, sizeof(v));
+        p += sizeof(v);
+    }
+    inline void fix_pod_put(char*& p, uint32_t v)
+    {
+        v = is_bigendian() ? v : swap_uint32(v);
+        memcpy(p, &v, sizeof(v));
+        p += sizeof(v);
+    }
+    inline void fix_pod_put(char*& p, uint64_t v)
+    {
+        v = is_bigendian() ? v : swap_uint64(v);
+        memcpy(p, &v, sizeof(v));
+        p += sizeof(v);
+    }
+    inline void fix_pod_put(char*& p, int16_t v)
+    {
+        fix_pod_put(p, (uint16_t) v);
+    }
+    inline void fix_pod_put(char*& p, int32_t v)
+    {
+        fix_pod_put(p, (uint32_t) v);
+    }
+    inline void fix_pod_put(char*& p, int64_t v)
+    {
+        fix_pod_put(p, (uint64_t) v);
+    }
+    inline void fix_pod_put_all(char*& p)
+    {
+    }
+    template<typename A0, typename ... Args>
+    inline void fix_pod_put_all(char*& p, const A0& a0, const Args&... args)
+    {
+        fix_pod_put(p, a0);
+        fix_pod_put_all(p, args...);
+    }
+
+    inline void fix_pod_get(const char*& p, bool& v)
+    {
+        v = (bool) *p++;
+    }
+    inline void fix_pod_get(const char*& p, int8_t& v)
+    {
+        v = (int8_t) *p++;
+    }
+    inline void fix_pod_get(const char*& p, uint8_t& v)
+    {
+        v = (uint8_t) *p++;
+    }
+    inline void fix_pod_get(const char*& p, uint16_t& v)
+    {
+        memcpy(&v, p, sizeof(v));
+        v = is_bigendian() ? v : swap_uint16(v);
+        p += sizeof(v);
+    }
+    inline void fix_pod_get(const char*& p, uint32_t& v)
+    {
+        memcpy(&v, p, sizeof(v));
+        v = is_bigendian() ? v : swap_uint32(v);
+        p += sizeof(v);
+    }
+    inline void fix_pod_get(const char*& p, uint64_t& v)
+    {
+        memcpy(&v, p, sizeof(v));
+        v = is_bigendian() ? v : swap_uint64(v);
+        p += sizeof(v);
+    }
+    inline void fix_pod_get(const char*& p, int16_t& v)
+    {
+        fix_pod_get(p, (uint16_t&) v);
+    }
+    inline void fix_pod_get(const char*& p, int32_t& v)
+    {
+        fix_pod_get(p, (uint32_t&) v);
+    }
+    inline void fix_pod_get(const char*& p, int64_t& v)
+    {
+        fix_pod_get(p, (uint64_t&) v);
+    }
+    inline void fix_pod_get_all(const char*& p)
+    {
+    }
+    template<typename A0, typename ... Args>
+    inline void fix_pod_get_all(const char*& p, A0& a0, Args&... args)
+    {
+        fix_pod_get(p, a0);
+        fix_pod_get_all(p, args...);
+    }
+
+    /*
+     * A run of fixed width fields is bounds checked once and copied straight into/out of the buffer,
+     * otherwise the head field goes through its own overload and the rest is tried again as a run.
+     */
+    template<typename ... Args>
+    inline bool fix_encode_run(Buffer& buf, std::true_type, Args&... args)
+    {
+        const size_t size = FixPodRunSize<Args...>::value;
+        if (!buf.EnsureWritableBytes(size))
+        {
+            return false;
+        }
+        char* p = const_cast<char*>(buf.GetRawWriteBuffer());
+        fix_pod_put_all(p, args...);
+        buf.AdvanceWriteIndex(size);
+        return true;
+    }
+    template<typename A0, typename ... Args>
+    inline bool fix_encode_run(Buffer& buf, std::false_type, A0& a0, Args&... args)
+    {
+        return fix_encode_arg(buf, a0) && fix_encode_arg(buf, args...);
+    }
+    template<typename A0, typename A1, typename ... Args>
+    inline bool fix_encode_arg(Buffer& buf, A0& a0, A1& a1, Args&... args)
+    {
+        return fix_encode_run(buf, std::integral_constant<bool, 0 != FixPodRunSize<A0, A1, Args...>::value>(), a0, a1, args...);
+    }
+
+    template<typename ... Args>
+    inline bool fix_decode_run(Buffer& buf, std::true_type, Args&... args)
+    {
+        const size_t size = FixPodRunSize<Args...>::value;
+        if (buf.ReadableBytes() < size)
+        {
+            return false;
+        }
+        const char* p = buf.GetRawReadBuffer();
+        fix_pod_get_all(p, args...);
+        buf.AdvanceReadIndex(size);
+        return true;
+    }
+    template<typename A0, typename ... Args>
+    inline bool fix_decode_run(Buffer& buf, std::false_type, A0& a0, Args&... args)
+    {
+        return fix_decode_arg(buf, a0) && fix_decode_arg(buf, args...);
+    }
+    template<typename A0, typename A1, typename ... Args>
+    inline bool fix_decode_arg(Buffer& buf, A0& a0, A1& a1, Args&... args)
+    {
+        return fix_decode_run(buf, std::integral_constant<bool, 0 != FixPodRunSize<A0, A1, Args...>::value>(), a0, a1, args...);
+    }
+
+    /*
+     * Tagged codec: fix uint32 size of the fields, then each field prefixed by its var uint32 index.
+     * Fields missing in the input are left untouched and unknown trailing fields are skipped, so fields
+     * can be appended to a struct without breaking old data.
+     */
+    template<typename A0>
+    inline void encode_tagged_fields(Buffer& buf, uint32_t tag, A0& a0)
+    {
+        BufferHelper::WriteVarUInt32(buf, tag);
+        encode_arg(buf, a0);
+    }
+    template<typename A0, typename A1, typename ... Args>
+    inline void encode_tagged_fields(Buffer& buf, uint32_t tag, A0& a0, A1& a1, Args&... args)
+    {
+        encode_tagged_fields(buf, tag, a0);
+        encode_tagged_fields(buf, tag + 1, a1, args...);
+    }
+    template<typename ... Args>
+    inline bool encode_arg_with_tag(Buffer& buf, Args&... args)
+    {
+        uint32_t cursor = buf.GetWriteIndex();
+        BufferHelper::WriteFixUInt32(buf, 1);
+        encode_tagged_fields(buf, 0, args...);
+        uint32_t end = buf.GetWriteIndex();
+        buf.SetWriteIndex(cursor);
+        BufferHelper::WriteFixUInt32(buf, end - cursor - 4);
+        buf.SetWriteIndex(end);
+        return true;
+    }
+
+    template<typename A0>
+    inline bool decode_tagged_fields(Buffer& buf, uint32_t tag, A0& a0)
+    {
+        return !BufferHelper::ReadVarUInt32IfEqual(buf, tag) || decode_arg(buf, a0);
+    }
+    template<typename A0, typename A1, typename ... Args>
+    inline bool decode_tagged_fields(Buffer& buf, uint32_t tag, A0& a0, A1& a1, Args&... args)
+    {
+        return decode_tagged_fields(buf, tag, a0) && decode_tagged_fields(buf, tag + 1, a1, args...);
+    }
+    template<typename ... Args>
+    inline bool decode_arg_with_tag(Buffer& buf, Args&... args)
+    {
+        uint32_t size = 0;
+        if (!BufferHelper::ReadFixUInt32(buf, size))
+        {
+            return false;
+        }
+        uint32_t cursor = buf.GetReadIndex();
+        if (!decode_tagged_fields(buf, 0, args...))
+        {
+            return false;
+        }
+        uint32_t consumed = buf.GetReadIndex() - cursor;
+        if (consumed < size)
+        {
+            buf.AdvanceReadIndex(size - consumed);
+        }
+        return true;
+    }
 }
 
 #endif /* STRUCT_CODEC_MACROS_HPP_ */
@@ -3,45 +3,95 @@
 //
 
 #include <common/thread/lock_guard.hpp>
+#include <common/util/murmur3.h>
 #include "ConcurrentKeyCache.h"
-//LockGuard<SpinMutexLock> guard(m_expires_lock);
+#include <algorithm>
+
+ConcurrentKeyCache::Shard& ConcurrentKeyCache::shardOf(const KeyType& key) {
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(key.data(), key.size(), 0, &hash);
+    return shards[hash % kShards];
+}
 
 void ConcurrentKeyCache::Put(const CacheEntry& keyEntry) {
-    ardb::WriteLockGuard<ardb::SpinRWLock> guard(lock);
-    KeyCache::Put(keyEntry);
+    Shard& shard = shardOf(keyEntry.key);
+    ardb::WriteLockGuard<ardb::SpinRWLock> guard(shard.lock);
+    shard.cache.Put(keyEntry);
 }
 
 std::vector<KeyCache::KeyType> ConcurrentKeyCache::Get(const KeyType& pattern) {
-    ardb::ReadLockGuard<ardb::SpinRWLock> guard(lock);
-    return KeyCache::Get(pattern);
+    std::vector<KeyType> ret;
+    for (uint32_t i = 0; i < kShards; i++) {
+        std::vector<KeyType> keys;
+        {
+            ardb::ReadLockGuard<ardb::SpinRWLock> guard(shards[i].lock);
+            keys = shards[i].cache.Get(pattern);
+        }
+        ret.insert(ret.end(), keys.begin(), keys.end());
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
 }
 
 void ConcurrentKeyCache::Delete(const KeyType& key) {
-    ardb::WriteLockGuard<ardb::SpinRWLock> guard(lock);
-    KeyCache::Delete(key);
+    Shard& shard = shardOf(key);
+    ardb::WriteLockGuard<ardb::SpinRWLock> guard(shard.lock);
+    shard.cache.Delete(key);
 }
 
 void ConcurrentKeyCache::Expire(const KeyType &key, TtlType ttl) {
-    ardb::WriteLockGuard<ardb::SpinRWLock> guard(lock);
-    KeyCache::Expire(key, ttl);
+    Shard& shard = shardOf(key);
+    ardb::WriteLockGuard<ardb::SpinRWLock> guard(shard.lock);
+    shard.cache.Expire(key, ttl);
 }
 
 size_t ConcurrentKeyCache::size() {
-    ardb::ReadLockGuard<ardb::SpinRWLock> guard(lock);
-    return KeyCache::size();
-}
-
-void ConcurrentKeyCache::ensureTTL() {
-    ardb::LockGuard<ardb::SpinMutexLock> guard(ensureTtlLock);
-    KeyCache::ensureTTL();
+    size_t ret = 0;
+    for (uint32_t i = 0; i < kShards; i++) {
+        ardb::WriteLockGuard<ardb::SpinRWLock> guard(shards[i].lock);
+        ret += shards[i].cache.size();
+    }
+    return ret;
 }
 
 void ConcurrentKeyCache::DropAll() {
-    ardb::WriteLockGuard<ardb::SpinRWLock> guard(lock);
-    KeyCache::DropAll();
+    for (uint32_t i = 0; i < kShards; i++) {
+        ardb::WriteLockGuard<ardb::SpinRWLock> guard(shards[i].lock);
+        shards[i].cache.DropAll();
+    }
 }
 
 int64_t ConcurrentKeyCache::Memory() {
-    ardb::ReadLockGuard<ardb::SpinRWLock> guard(lock);
-    return KeyCache::Memory();
-}
\ No newline at end of file
+    int64_t ret = sizeof(*this);
+    for (uint32_t i = 0; i < kShards; i++) {
+        ardb::WriteLockGuard<ardb::SpinRWLock> guard(shards[i].lock);
+        ret += shards[i].cache.Memory() - sizeof(KeyCache);
+    }
+    return ret;
+}
+
+/*
+ * Keys are hashed to shards, so a sample of a random non empty shard is a sample of the whole cache.
+ */
+bool ConcurrentKeyCache::RandomKey(KeyType& key) {
+    uint32_t start = random() % kShards;
+    for (uint32_t i = 0; i < kShards; i++) {
+        Shard& shard = shards[(start + i) % kShards];
+        ardb::WriteLockGuard<ardb::SpinRWLock> guard(shard.lock);
+        if (shard.cache.RandomKey(key))
+            return true;
+    }
+    return false;
+}
+
+int64_t ConcurrentKeyCache::writeEntries(FILE* fp) {
+    int64_t count = 0;
+    for (uint32_t i = 0; i < kShards; i++) {
+        ardb::ReadLockGuard<ardb::SpinRWLock> guard(shards[i].lock);
+        int64_t written = shards[i].cache.writeEntries(fp);
+        if (written < 0)
+            return -1;
+        count += written;
+    }
+    return count;
+}
@@ -7,21 +7,30 @@
 
 #include "KeyCache.h"
 #include "thread/spin_rwlock.hpp"
-#include "thread/spin_mutex_lock.hpp"
 
+/*
+ * Keys are spread over hash shards, each one a KeyCache with its own lock & TTL index, so writers of
+ * different shards never wait on each other and KEYS only holds one shard's read lock at a time.
+ */
 class ConcurrentKeyCache: public KeyCache {
-    void Put(const CacheEntry& keyEntry);
+public:
     std::vector<KeyType> Get(const KeyType& pattern);
+    void Put(const CacheEntry& keyEntry);
     void Delete(const KeyType& key);
     void Expire(const KeyType &key, TtlType ttl);
     size_t size();
     void DropAll();
     int64_t Memory();
+    bool RandomKey(KeyType& key);
 protected:
-    virtual void ensureTTL();
-
-    ardb::SpinRWLock lock;
-    ardb::SpinMutexLock ensureTtlLock;
+    static const uint32_t kShards = 64;
+    struct Shard {
+        ardb::SpinRWLock lock;
+        KeyCache cache;
+    };
+    Shard shards[kShards];
+    Shard& shardOf(const KeyType& key);
+    int64_t writeEntries(FILE* fp);
 };
 
 
@@ -4,6 +4,14 @@
 #include "KeyCache.h"
 #include "db/codec.hpp"
 #include <common/util/time_helper.hpp>
+#include "thread/thread.hpp"
+#include "util/file_helper.hpp"
+#include "util/mmap.hpp"
+#include <sys/mman.h>
+#include <errno.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdlib.h>
 
 //Matchers
 KeyCache::Matcher::~Matcher() {}
@@ -13,63 +21,267 @@ KeyCache::SubstringMatcher::SubstringMatcher(const KeyType& substring): substrin
 KeyCache::EqualsMatcher::EqualsMatcher(const KeyType& str): str(str) {}
 KeyCache::PatternMatcher::PatternMatcher(const KeyType &pattern):pattern(pattern) {}
 
-bool KeyCache::PatternMatcher::operator()(const KeyType &t) {
-    return stringmatchlen(pattern.c_str(), pattern.size(), t.c_str(), t.size(), 0) == 1;
+bool KeyCache::PatternMatcher::operator()(const KeyRef &t) {
+    return stringmatchlen(pattern.c_str(), pattern.size(), t.data, t.len, 0) == 1;
 }
 
-bool KeyCache::PrefixMatcher::operator() (const KeyType& t) {
-    return prefix.size() <= t.size() && t.substr(0, prefix.size()) == prefix;
+bool KeyCache::PrefixMatcher::operator() (const KeyRef& t) {
+    return prefix.size() <= t.len && memcmp(t.data, prefix.data(), prefix.size()) == 0;
 }
 
-bool KeyCache::SuffixMatcher::operator()(const KeyType& t)  {
-    return suffix.size() <= t.size() && t.substr(t.size() - suffix.size(), suffix.size()) == suffix;
+bool KeyCache::SuffixMatcher::operator()(const KeyRef& t)  {
+    return suffix.size() <= t.len && memcmp(t.data + t.len - suffix.size(), suffix.data(), suffix.size()) == 0;
 }
 
-bool KeyCache::SubstringMatcher::operator()(const KeyType& t) {
-    return t.find(substring) != -1;
+bool KeyCache::SubstringMatcher::operator()(const KeyRef& t) {
+    return std::search(t.data, t.data + t.len, substring.begin(), substring.end()) != t.data + t.len || substring.empty();
 }
 
-bool KeyCache::EqualsMatcher::operator()(const KeyType& t) {
-    return str == t;
+bool KeyCache::EqualsMatcher::operator()(const KeyRef& t) {
+    return str.size() == t.len && memcmp(t.data, str.data(), t.len) == 0;
 }
 
+//KeyArena
+static const size_t kArenaChunkSize = 64 * 1024;
+
+KeyCache::KeyArena::~KeyArena() {
+    Clear();
+}
+
+KeyCache::KeyRef KeyCache::KeyArena::Intern(const char* data, size_t len) {
+    char* buf = NULL;
+    if (len > kArenaChunkSize / 4) {
+        /*
+         * large keys get their own chunk, the current chunk keeps being filled
+         */
+        buf = (char*) ardb::arena_malloc(ardb::MEM_ARENA_KEYCACHE, len);
+        chunks.push_back(buf);
+        reserved += len;
+    } else {
+        if (len > currentLeft) {
+            current = (char*) ardb::arena_malloc(ardb::MEM_ARENA_KEYCACHE, kArenaChunkSize);
+            currentLeft = kArenaChunkSize;
+            chunks.push_back(current);
+            reserved += kArenaChunkSize;
+        }
+        buf = current;
+        current += len;
+        currentLeft -= len;
+    }
+    memcpy(buf, data, len);
+    live += len;
+    return KeyRef(buf, len);
+}
+
+void KeyCache::KeyArena::Clear() {
+    for (size_t i = 0; i < chunks.size(); i++)
+        ardb::arena_free(ardb::MEM_ARENA_KEYCACHE, chunks[i]);
+    std::vector<char*>().swap(chunks);
+    current = NULL;
+    currentLeft = reserved = live = dead = 0;
+}
+
+void KeyCache::KeyArena::Swap(KeyArena& other) {
+    chunks.swap(other.chunks);
+    std::swap(current, other.current);
+    std::swap(currentLeft, other.currentLeft);
+    std::swap(reserved, other.reserved);
+    std::swap(live, other.live);
+    std::swap(dead, other.dead);
+}
 
 //KeyCache implementation
-KeyCache::KeyCache() {
-    ttlByKey.set_empty_key("");
-    ttlByKey.set_deleted_key("\n");
+KeyCache::KeyCache(): loadAborted(false) {
 }
 
-void KeyCache::LoadFromDisk(ardb::Engine* engine) {
-    INFO_LOG("Loading keys to KeyCache from disk");
+KeyCache::~KeyCache() {
+}
+
+/*
+ * Loads the keys whose first byte is in [lo, hi), or whose slot is in [lo, hi) with KEY_CODEC_V3 which orders
+ * keys by slot first.
+ */
+void KeyCache::loadRange(ardb::Engine* engine, int lo, int hi) {
     Context ctx;
-    ardb::KeyObject startkey(ctx.ns, KEY_META, "");
+    bool by_slot = ardb::get_key_codec_version() == ardb::KEY_CODEC_V3;
+    int units = by_slot ? (int) ardb::kClusterSlots : 256;
+    ardb::KeyObject startkey(ctx.ns, KEY_META, lo == 0 || by_slot ? std::string() : std::string(1, (char) lo));
+    if (by_slot)
+        startkey.SetSlot(lo);
     ctx.flags.iterate_multi_keys = 1;
     ctx.flags.iterate_no_upperbound = 1;
     ctx.flags.iterate_total_order = 1;
     ardb::Iterator* iter = engine->Find(ctx, startkey);
-    while (iter->Valid()) {
+    while (iter->Valid() && !loadAborted) {
         KeyObject& k = iter->Key();
+        std::string keystr = k.GetKey().AsString();
+        if (hi < units) {
+            if (by_slot ? k.GetSlot() >= hi : !keystr.empty() && (unsigned char) keystr[0] >= hi)
+                break;
+        }
         ValueObject& value = iter->Value();
         if (k.GetType() == KEY_META) {
-            std::string keystr = k.GetKey().AsString();
             int64_t  ttl = value.GetTTL();
             if (ttl == 0)
                 ttl = INF;
-            KeyCache::Put(CacheEntry(keystr, ttl));
+            Put(CacheEntry(keystr, ttl));
         }
         if (iter->Value().GetType() != KEY_STRING) {
-            std::string keystr(k.GetKey().AsString());
+            uint16 slot = k.GetSlot();
             keystr.append(1, 0);
             KeyObject next(ctx.ns, KEY_META, keystr);
+            if (by_slot)
+                next.SetSlot(slot);
             iter->Jump(next);
             continue;
         }
         iter->Next();
     }
     DELETE(iter);
-    ensureTTL();
-    INFO_LOG("%d keys loaded from disk to KeyCache", sortedKeys.size());
+}
+
+void KeyCache::LoadFromDisk(ardb::Engine* engine, uint32_t threads) {
+    INFO_LOG("Loading keys to KeyCache from disk");
+    uint64_t start_time = ardb::get_current_epoch_millis();
+    int units = ardb::get_key_codec_version() == ardb::KEY_CODEC_V3 ? (int) ardb::kClusterSlots : 256;
+    if (threads <= 1) {
+        loadRange(engine, 0, units);
+    } else {
+        /*
+         * each worker loads the keys of a range of first bytes, or of slots with KEY_CODEC_V3
+         */
+        struct LoadTask: public ardb::Runnable {
+            KeyCache* cache;
+            ardb::Engine* engine;
+            int lo, hi;
+            void Run() {
+                cache->loadRange(engine, lo, hi);
+            }
+        };
+        if (threads > 256)
+            threads = 256;
+        std::vector<LoadTask> tasks(threads);
+        std::vector<ardb::Thread*> workers(threads, (ardb::Thread*) NULL);
+        for (uint32_t i = 0; i < threads; i++) {
+            tasks[i].cache = this;
+            tasks[i].engine = engine;
+            tasks[i].lo = i * units / threads;
+            tasks[i].hi = (i + 1) * units / threads;
+            NEW(workers[i], ardb::Thread(&tasks[i]));
+            workers[i]->Start();
+        }
+        for (uint32_t i = 0; i < threads; i++) {
+            workers[i]->Join();
+            DELETE(workers[i]);
+        }
+    }
+    INFO_LOG("%llu keys loaded from disk to KeyCache in %llums with %u threads%s", (unsigned long long) size(),
+             (unsigned long long) (ardb::get_current_epoch_millis() - start_time), threads, loadAborted ? ", aborted" : "");
+}
+
+/*
+ * Snapshot layout: magic, engine sequence, entry count, then per entry ttl(int64), key length(uint32) & key bytes.
+ */
+static const char kSnapshotMagic[8] = { 'A', 'R', 'D', 'B', 'K', 'C', '0', '1' };
+
+int64_t KeyCache::writeEntries(FILE* fp) {
+    TtlType currentTime = ardb::get_current_epoch_millis();
+    TTLMap::const_iterator ttl_it = ttlByKey.begin();
+    KeyRefLess less;
+    int64_t count = 0;
+    for (KeySet::const_iterator it = keys.begin(); it != keys.end(); it++) {
+        while (ttl_it != ttlByKey.end() && less(ttl_it->first, *it))
+            ttl_it++;
+        TtlType ttl = INF;
+        if (ttl_it != ttlByKey.end() && !less(*it, ttl_it->first)) {
+            ttl = ttl_it->second;
+            if (ttl <= currentTime)
+                continue;
+        }
+        if (fwrite(&ttl, sizeof(ttl), 1, fp) != 1 || fwrite(&it->len, sizeof(it->len), 1, fp) != 1
+                || fwrite(it->data, 1, it->len, fp) != it->len)
+            return -1;
+        count++;
+    }
+    return count;
+}
+
+int KeyCache::SaveSnapshot(const std::string& file, int64_t seq) {
+    uint64_t start_time = ardb::get_current_epoch_millis();
+    std::string tmpfile = file + ".tmp";
+    FILE* fp = fopen(tmpfile.c_str(), "wb");
+    if (NULL == fp) {
+        ERROR_LOG("Failed to open KeyCache snapshot file:%s for reason:%s", tmpfile.c_str(), strerror(errno));
+        return -1;
+    }
+    int64_t count = 0;
+    bool ok = fwrite(kSnapshotMagic, sizeof(kSnapshotMagic), 1, fp) == 1 && fwrite(&seq, sizeof(seq), 1, fp) == 1
+            && fwrite(&count, sizeof(count), 1, fp) == 1;
+    if (ok) {
+        count = writeEntries(fp);
+        ok = count >= 0 && fseek(fp, sizeof(kSnapshotMagic) + sizeof(seq), SEEK_SET) == 0
+                && fwrite(&count, sizeof(count), 1, fp) == 1;
+    }
+    ok = fflush(fp) == 0 && ok;
+    ok = fsync(fileno(fp)) == 0 && ok;
+    fclose(fp);
+    if (!ok || rename(tmpfile.c_str(), file.c_str()) != 0) {
+        ERROR_LOG("Failed to save KeyCache snapshot file:%s for reason:%s", file.c_str(), strerror(errno));
+        unlink(tmpfile.c_str());
+        return -1;
+    }
+    INFO_LOG("%lld keys saved to KeyCache snapshot:%s in %llums", (long long) count, file.c_str(),
+             (unsigned long long) (ardb::get_current_epoch_millis() - start_time));
+    return 0;
+}
+
+int KeyCache::LoadSnapshot(const std::string& file, int64_t seq) {
+    if (!ardb::is_file_exist(file))
+        return -1;
+    uint64_t start_time = ardb::get_current_epoch_millis();
+    int64 size = ardb::file_size(file);
+    size_t header_size = sizeof(kSnapshotMagic) + sizeof(int64_t) * 2;
+    if (size < (int64) header_size) {
+        WARN_LOG("Invalid KeyCache snapshot:%s with size:%lld", file.c_str(), (long long) size);
+        return -1;
+    }
+    ardb::MMapBuf mbuf;
+    if (0 != mbuf.Init(file, size, MADV_SEQUENTIAL))
+        return -1;
+    const char* p = mbuf.m_buf;
+    const char* end = mbuf.m_buf + size;
+    int64_t snapshot_seq, count;
+    memcpy(&snapshot_seq, p + sizeof(kSnapshotMagic), sizeof(snapshot_seq));
+    memcpy(&count, p + sizeof(kSnapshotMagic) + sizeof(snapshot_seq), sizeof(count));
+    if (memcmp(p, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 || snapshot_seq != seq) {
+        INFO_LOG("KeyCache snapshot:%s taken at sequence:%lld is stale at sequence:%lld", file.c_str(),
+                 (long long) snapshot_seq, (long long) seq);
+        return -1;
+    }
+    p += header_size;
+    int64_t loaded = 0;
+    while (p < end) {
+        TtlType ttl;
+        uint32_t len;
+        if (end - p < (ptrdiff_t) (sizeof(ttl) + sizeof(len)))
+            break;
+        memcpy(&ttl, p, sizeof(ttl));
+        memcpy(&len, p + sizeof(ttl), sizeof(len));
+        p += sizeof(ttl) + sizeof(len);
+        if ((size_t) (end - p) < len)
+            break;
+        Put(CacheEntry(KeyType(p, len), ttl));
+        p += len;
+        loaded++;
+    }
+    if (p != end || loaded != count) {
+        WARN_LOG("Corrupted KeyCache snapshot:%s, %lld of %lld keys read", file.c_str(), (long long) loaded,
+                 (long long) count);
+        return -1;
+    }
+    INFO_LOG("%lld keys loaded from KeyCache snapshot:%s in %llums", (long long) loaded, file.c_str(),
+             (unsigned long long) (ardb::get_current_epoch_millis() - start_time));
+    return 0;
 }
 
 void KeyCache::Put(const KeyType& kt) {
@@ -79,25 +291,45 @@ void KeyCache::Put(const KeyType& kt) {
 
 void KeyCache::Put(const CacheEntry& keyEntry) {
     ensureTTL();
-    if (sortedKeys.find(keyEntry.key) == sortedKeys.end()) {//!sortedKeys.contains(keyEntry.key)
-        sortedKeys.insert(keyEntry);
-        ttlByKey[keyEntry.key] = keyEntry.ttl;
+    if (keys.find(toRef(keyEntry.key)) == keys.end()) {
+        KeyRef ref = arena.Intern(keyEntry.key.data(), keyEntry.key.size());
+        keys.insert(ref);
+        sampleKey(ref);
+        if (keyEntry.ttl != INF) {
+            ttlByKey[ref] = keyEntry.ttl;
+            pushExpire(ref, keyEntry.ttl);
+        }
+    }
+}
+
+void KeyCache::removeKey(KeySet::iterator it) {
+    KeyRef ref = *it;
+    ttlByKey.erase(ref);//the heap entry is skipped when popped
+    keys.erase(it);
+    for (size_t i = 0; i < samples.size(); i++) {
+        if (samples[i].data == ref.data) {
+            samples[i] = samples.back();
+            samples.pop_back();
+            break;
+        }
     }
+    arena.Release(ref);
 }
 
 void KeyCache::Delete(const KeyType& key) {
     ensureTTL();
-    typename HashMap::iterator it = ttlByKey.find(key);
-    if (it != ttlByKey.end()) {//ttlByKey.contains(key)
-        TtlType ttl = it->second;
-        ttlByKey.erase(it);//erase ttl from ttl map
-
-        sortedKeys.erase(CacheEntry(key, ttl));//erase KeyEntry from set
+    KeySet::iterator it = keys.find(toRef(key));
+    if (it != keys.end()) {
+        removeKey(it);
+        compactArena();
     }
 }
 
+/*
+ * Expired keys not purged yet are filtered here, so Get never modifies the cache.
+ */
 std::vector<KeyCache::KeyType> KeyCache::Get(const KeyType& pattern) {
-    ensureTTL();
+    TtlType currentTime = ardb::get_current_epoch_millis();
     Matcher* matcher;
     if (isOptimizedPattern(pattern)) {
         if (pattern.size() != 1 && pattern[0] == '*' && pattern.back() == '*')
@@ -111,50 +343,170 @@ std::vector<KeyCache::KeyType> KeyCache::Get(const KeyType& pattern) {
     } else
         matcher = new PatternMatcher(pattern);
 
+    /*
+     * only keys starting with the literal prefix of the pattern can match
+     */
+    KeyType prefix = literalPrefix(pattern);
     std::vector<KeyType> ret;
-    for (HashMap::const_iterator it = ttlByKey.begin(); it != ttlByKey.end(); it++)
-        if ((*matcher)(it->first))
-            ret.push_back(it->first);
+    KeySet::const_iterator it = prefix.empty() ? keys.begin() : keys.lower_bound(toRef(prefix));
+    for (; it != keys.end(); it++) {
+        if (it->len < prefix.size() || memcmp(it->data, prefix.data(), prefix.size()) != 0)
+            break;
+        if (!(*matcher)(*it))
+            continue;
+        if (!ttlByKey.empty()) {
+            TTLMap::const_iterator found = ttlByKey.find(*it);
+            if (found != ttlByKey.end() && found->second <= currentTime)
+                continue;
+        }
+        ret.push_back(KeyType(it->data, it->len));
+    }
     delete matcher;
     return ret;
 }
 
 void KeyCache::Expire(const KeyType &key, TtlType ttl) {
     ensureTTL();
-    typename HashMap::iterator it = ttlByKey.find(key);
-    if (it != ttlByKey.end()) {//ttlByKey.contains(key)
-        TtlType prevTtl = it->second;
-        sortedKeys.erase(CacheEntry(key, prevTtl));
-
-        ttlByKey[key] = ttl;
-        sortedKeys.insert(CacheEntry(key, ttl));
+    KeySet::iterator it = keys.find(toRef(key));
+    if (it != keys.end()) {
+        if (ttl < 0 || ttl == INF) {
+            ttlByKey.erase(*it);
+        } else {
+            ttlByKey[*it] = ttl;
+            pushExpire(*it, ttl);
+        }
     }
 }
 
 size_t KeyCache::size() {
     ensureTTL();
-    return sortedKeys.size();
+    return keys.size();
+}
+
+void KeyCache::pushExpire(const KeyRef& key, TtlType ttl) {
+    expireHeap.push_back(ExpireEntry(ttl, key));
+    std::push_heap(expireHeap.begin(), expireHeap.end(), ExpiresLater());
+    /*
+     * drop entries left by Delete/Expire once they outnumber the live ones
+     */
+    if (expireHeap.size() > 2 * (size_t) ttlByKey.size() + 1024)
+        rebuildExpireHeap();
 }
 
+void KeyCache::rebuildExpireHeap() {
+    ExpireHeap live;
+    live.reserve(ttlByKey.size());
+    for (TTLMap::const_iterator it = ttlByKey.begin(); it != ttlByKey.end(); it++)
+        live.push_back(ExpireEntry(it->second, it->first));
+    std::make_heap(live.begin(), live.end(), ExpiresLater());
+    expireHeap.swap(live);
+}
+
+/*
+ * Re-intern the live keys once the bytes of deleted keys outnumber them, heap entries may point
+ * to released bytes, so the heap is rebuilt from the ttl index as well.
+ */
+void KeyCache::compactArena() {
+    if (arena.Dead() < 4 * kArenaChunkSize || arena.Dead() < arena.Live())
+        return;
+    KeyArena fresh;
+    KeySet freshKeys;
+    TTLMap freshTTL;
+    KeyRefLess less;
+    TTLMap::const_iterator ttl_it = ttlByKey.begin();
+    for (KeySet::const_iterator it = keys.begin(); it != keys.end(); it++) {
+        KeyRef ref = fresh.Intern(it->data, it->len);
+        freshKeys.insert(freshKeys.end(), ref);
+        while (ttl_it != ttlByKey.end() && less(ttl_it->first, *it))
+            ttl_it++;
+        if (ttl_it != ttlByKey.end() && !less(*it, ttl_it->first))
+            freshTTL.insert(freshTTL.end(), TTLMap::value_type(ref, ttl_it->second));
+    }
+    keys.swap(freshKeys);
+    ttlByKey.swap(freshTTL);
+    arena.Swap(fresh);
+    rebuildExpireHeap();
+    for (size_t i = 0; i < samples.size(); i++)
+        samples[i] = *keys.find(samples[i]);
+}
 
 void KeyCache::ensureTTL() {
+    if (expireHeap.empty())
+        return;
     TtlType currentTime = ardb::get_current_epoch_millis();
-    while (!sortedKeys.empty()) {
-        CacheEntry entry = *sortedKeys.begin();
+    bool removed = false;
+    while (!expireHeap.empty()) {
+        ExpireEntry entry = expireHeap.front();
         if (entry.ttl > currentTime)
-            return;
-        sortedKeys.erase(sortedKeys.begin());
-        ttlByKey.erase(entry.key);
+            break;
+        std::pop_heap(expireHeap.begin(), expireHeap.end(), ExpiresLater());
+        expireHeap.pop_back();
+        TTLMap::iterator found = ttlByKey.find(entry.key);
+        if (found != ttlByKey.end() && found->second == entry.ttl) {
+            KeySet::iterator it = keys.find(found->first);
+            if (it != keys.end()) {
+                removeKey(it);
+                removed = true;
+            }
+        }
     }
+    if (removed)
+        compactArena();
 }
 
 void KeyCache::DropAll() {
-    sortedKeys.clear();
+    keys.clear();
     ttlByKey.clear();
+    ExpireHeap().swap(expireHeap);
+    samples.clear();
+    arena.Clear();
+}
+
+void KeyCache::sampleKey(const KeyRef& key) {
+    if (samples.size() < kSamples) {
+        samples.push_back(key);
+        return;
+    }
+    size_t idx = random() % keys.size();
+    if (idx < kSamples)
+        samples[idx] = key;
+}
+
+void KeyCache::refillSamples() {
+    if (samples.size() >= kSamples / 2 || (size_t) keys.size() <= samples.size())
+        return;
+    for (size_t i = 0; i < kSamples && samples.size() < kSamples && samples.size() < (size_t) keys.size(); i++) {
+        uint32_t probe = random();
+        KeySet::const_iterator it = keys.lower_bound(KeyRef((const char*) &probe, sizeof(probe)));
+        if (it == keys.end())
+            it = keys.begin();
+        bool sampled = false;
+        for (size_t j = 0; j < samples.size() && !sampled; j++)
+            sampled = samples[j].data == it->data;
+        if (!sampled)
+            samples.push_back(*it);
+    }
+}
+
+bool KeyCache::RandomKey(KeyType& key) {
+    ensureTTL();
+    refillSamples();
+    if (samples.empty())
+        return false;
+    const KeyRef& ref = samples[random() % samples.size()];
+    key.assign(ref.data, ref.len);
+    return true;
+}
+
+KeyCache::KeyType KeyCache::literalPrefix(const KeyType &pattern) {
+    size_t i = 0;
+    while (i < pattern.size() && pattern[i] != '*' && pattern[i] != '?' && pattern[i] != '[' && pattern[i] != '\\')
+        i++;
+    return pattern.substr(0, i);
 }
 
 bool KeyCache::isOptimizedPattern(const KeyType &pattern) {
-    for (int i = 1; i + 1 < pattern.size(); ++i)
+    for (size_t i = 1; i + 1 < pattern.size(); ++i)
         if (pattern[i] == '*' || pattern[i] == '?' || pattern[i] == '[' || pattern[i] == '\\')
             return false;
     if (pattern[0] == '?' || pattern[0] == '[' || pattern[0] == '\\')
@@ -164,19 +516,16 @@ bool KeyCache::isOptimizedPattern(const KeyType &pattern) {
     return true;
 }
 
+/*
+ * Bytes held by the arena chunks, the btree nodes & the heap.
+ */
 int64_t KeyCache::Memory() {
     ensureTTL();
-
-    int64_t ret = 0;
-    for (HashMap::const_iterator it = ttlByKey.begin(); it != ttlByKey.end(); it++) {
-        ret += it->first.capacity();
-        ret += sizeof (it->second);
-    }
-
-    for (Set::const_iterator it = sortedKeys.begin(); it != sortedKeys.end(); it++) {
-        ret += it->key.capacity();
-        ret += sizeof (it->ttl);
-    }
+    int64_t ret = arena.Reserved();
+    ret += keys.bytes_used();
+    ret += ttlByKey.bytes_used();
+    ret += expireHeap.capacity() * sizeof(ExpireEntry);
+    ret += samples.capacity() * sizeof(KeyRef);
     ret += sizeof(*this);
     return ret;
-}
\ No newline at end of file
+}
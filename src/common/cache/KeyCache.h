@@ -9,15 +9,11 @@
 #include <cstring>
 #include <numeric>
 #include <limits>
-#include "sparsehash/dense_hash_map"
 #include "db/engine.hpp"
 
-#include <cstring>
-#include <numeric>
-#include <limits>
 #include "common.hpp"
+#include "util/mem_arena.hpp"
 #include <vector>
-#include <set>
 
 
 class KeyCache {
@@ -41,7 +37,22 @@ public:
     };
 
     KeyCache();
-    void LoadFromDisk(ardb::Engine* engine);
+    /*
+     * 'threads' > 1 loads key ranges in parallel, only for caches whose Put is thread safe.
+     */
+    void LoadFromDisk(ardb::Engine* engine, uint32_t threads = 1);
+    /*
+     * A running LoadFromDisk stops early while 'abort' is set, the keys loaded so far are kept.
+     */
+    void AbortLoad(bool abort) {
+        loadAborted = abort;
+    }
+    /*
+     * The snapshot file is tagged with the engine sequence it was taken at, loading it fails
+     * unless 'seq' is the same, i.e. nothing was written to the engine since.
+     */
+    int SaveSnapshot(const std::string& file, int64_t seq);
+    int LoadSnapshot(const std::string& file, int64_t seq);
     virtual std::vector<KeyType> Get(const KeyType& pattern);
     void Put(const KeyType& kt);
     virtual void Put(const CacheEntry& keyEntry);
@@ -50,50 +61,140 @@ public:
     virtual size_t size();
     virtual void DropAll();
     virtual int64_t Memory();
+    /*
+     * A key drawn from a small reservoir of sampled keys, false if the cache is empty.
+     */
+    virtual bool RandomKey(KeyType& key);
+
+    virtual ~KeyCache();
 
-    virtual ~KeyCache() {}
+    friend class ConcurrentKeyCache;
 
 protected:
-    typedef google::dense_hash_map<KeyType, TtlType> HashMap;
-    typedef std::set<CacheEntry> Set;
-    Set sortedKeys;
-    HashMap ttlByKey;
+    /*
+     * Key bytes are interned once in an arena, the ordered key set & the ttl index hold 16 bytes
+     * references into it. Bytes of deleted keys are reclaimed by compacting the arena once they
+     * outnumber the live ones.
+     */
+    struct KeyRef {
+        const char* data;
+        uint32_t len;
+        KeyRef(): data(NULL), len(0) {}
+        KeyRef(const char* d, uint32_t l): data(d), len(l) {}
+    };
+    struct KeyRefLess {
+        bool operator() (const KeyRef& a, const KeyRef& b) const {
+            int ret = memcmp(a.data, b.data, a.len < b.len ? a.len : b.len);
+            return ret < 0 || (ret == 0 && a.len < b.len);
+        }
+    };
+    class KeyArena {
+    public:
+        KeyArena(): current(NULL), currentLeft(0), reserved(0), live(0), dead(0) {}
+        ~KeyArena();
+        KeyRef Intern(const char* data, size_t len);
+        void Release(const KeyRef& key) {
+            live -= key.len;
+            dead += key.len;
+        }
+        void Clear();
+        void Swap(KeyArena& other);
+        size_t Reserved() const {
+            return reserved;
+        }
+        size_t Live() const {
+            return live;
+        }
+        size_t Dead() const {
+            return dead;
+        }
+    private:
+        std::vector<char*> chunks;
+        char* current;
+        size_t currentLeft;
+        size_t reserved;
+        size_t live;
+        size_t dead;
+    };
+    /*
+     * keys with ttl are also queued in a min heap of expire time, entries left by Delete/Expire are
+     * skipped when popped.
+     */
+    struct ExpireEntry {
+        TtlType ttl;
+        KeyRef key;
+        ExpireEntry(TtlType t, const KeyRef& k): ttl(t), key(k) {}
+    };
+    struct ExpiresLater {
+        bool operator() (const ExpireEntry& a, const ExpireEntry& b) const {
+            return a.ttl > b.ttl;
+        }
+    };
+    /*
+     * all memory of the cache is allocated from the keycache arena
+     */
+    typedef btree::btree_set<KeyRef, KeyRefLess, ardb::ArenaAllocator<KeyRef, ardb::MEM_ARENA_KEYCACHE> > KeySet;
+    typedef btree::btree_map<KeyRef, TtlType, KeyRefLess, ardb::ArenaAllocator<std::pair<const KeyRef, TtlType>, ardb::MEM_ARENA_KEYCACHE> > TTLMap;
+    typedef std::vector<ExpireEntry, ardb::ArenaAllocator<ExpireEntry, ardb::MEM_ARENA_KEYCACHE> > ExpireHeap;
+    KeyArena arena;
+    KeySet keys;
+    TTLMap ttlByKey;
+    ExpireHeap expireHeap;
+    /*
+     * Reservoir of keys for RandomKey, a new key replaces a sample with probability kSamples / size(),
+     * deleted keys are dropped from it & it is topped up by probing the key set once half empty.
+     */
+    static const size_t kSamples = 16;
+    std::vector<KeyRef, ardb::ArenaAllocator<KeyRef, ardb::MEM_ARENA_KEYCACHE> > samples;
+    void sampleKey(const KeyRef& key);
+    void refillSamples();
     virtual void ensureTTL();
+    void pushExpire(const KeyRef& key, TtlType ttl);
+    void rebuildExpireHeap();
+    void removeKey(KeySet::iterator it);
+    void compactArena();
+    void loadRange(ardb::Engine* engine, int lo, int hi);
+    volatile bool loadAborted;
+    virtual int64_t writeEntries(FILE* fp);
     bool isOptimizedPattern(const KeyType &pattern);
+    static KeyType literalPrefix(const KeyType &pattern);
+    static KeyRef toRef(const KeyType& key) {
+        return KeyRef(key.data(), key.size());
+    }
 
     struct Matcher {
-        virtual bool operator() (const KeyType& s) = 0;
+        virtual bool operator() (const KeyRef& s) = 0;
         virtual ~Matcher();
     };
 
     struct PrefixMatcher : public Matcher {
         KeyType prefix;
         PrefixMatcher(const KeyType& prefix);
-        bool operator() (const KeyType& t);
+        bool operator() (const KeyRef& t);
     };
 
     struct SuffixMatcher : public Matcher {
         KeyType suffix;
         SuffixMatcher(const KeyType& suffix);
-        bool operator()(const KeyType& t);
+        bool operator()(const KeyRef& t);
     };
 
     struct SubstringMatcher : public Matcher {
         KeyType substring;
         SubstringMatcher(const KeyType& substring);
-        bool operator()(const KeyType& t);
+        bool operator()(const KeyRef& t);
     };
 
     struct EqualsMatcher : public Matcher {
         KeyType str;
         EqualsMatcher(const KeyType& str);
-        bool operator()(const KeyType& t);
+        bool operator()(const KeyRef& t);
     };
 
     struct PatternMatcher: public Matcher {
         KeyType pattern;
         PatternMatcher(const KeyType& pattern);
-        bool operator()(const KeyType& t);
+        bool operator()(const KeyRef& t);
     };
 };
 
@@ -33,6 +33,7 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <sys/stat.h>
+#include <poll.h>
 #if defined(linux) || defined(__linux__)
 #include <sys/sendfile.h>
 #endif
@@ -63,9 +64,10 @@ void Channel::IOEventCallback(struct aeEventLoop *eventLoop, int fd, void *clien
 }
 
 Channel::Channel(Channel* parent, ChannelService& service) :
-        m_user_configed(false), m_has_removed(false), m_parent_id(0), m_service(&service), m_id(0), m_fd(-1), m_flush_timertask_id(-1), m_pipeline_initializor(
+        m_user_configed(false), m_has_removed(false), m_parent_id(0), m_service(&service), m_id(0), m_fd(-1), m_output_chunk_bytes(0), m_output_consumed(0), m_flush_timertask_id(-1), m_corked(false), m_pipeline_initializor(
         NULL), m_pipeline_initailizor_user_data(NULL), m_pipeline_finallizer(
-        NULL), m_pipeline_finallizer_user_data(NULL), m_detached(false), m_close_after_write(false), m_block_read(false), m_file_sending(
+        NULL), m_pipeline_finallizer_user_data(NULL), m_detached(false), m_close_after_write(false), m_block_read(false), m_output_read_paused(false), m_output_soft_limit(
+        0), m_output_hard_limit(0), m_file_sending(
         NULL), m_attach(NULL), m_attach_destructor(NULL)
 {
 
@@ -82,6 +84,8 @@ Channel::Channel(Channel* parent, ChannelService& service) :
     {
         m_parent_id = parent->GetID();
     }
+    m_inputBuffer.SetUsePool(true);
+    m_outputBuffer.SetUsePool(true);
 }
 
 int Channel::GetWriteFD()
@@ -98,7 +102,10 @@ bool Channel::BlockRead()
 {
     if (GetReadFD() > 0 && !m_block_read)
     {
-        aeDeleteFileEvent(GetService().GetRawEventLoop(), GetReadFD(), AE_READABLE);
+        if (!m_output_read_paused)
+        {
+            aeDeleteFileEvent(GetService().GetRawEventLoop(), GetReadFD(), AE_READABLE);
+        }
         m_block_read = true;
     }
     return true;
@@ -110,6 +117,13 @@ bool Channel::UnblockRead()
         return true;
     }
     int fd = GetReadFD();
+    if (m_output_read_paused)
+    {
+        /*
+         * the readable event is registered again once the output drains
+         */
+        fd = -1;
+    }
     if (fd != -1 && aeCreateFileEvent(GetService().GetRawEventLoop(), fd, AE_READABLE, Channel::IOEventCallback, this) == AE_ERR)
     {
         ::close(GetReadFD());
@@ -120,13 +134,14 @@ bool Channel::UnblockRead()
     if(m_inputBuffer.ReadableBytes() > 0)
     {
         fire_message_received<Buffer>(this, &m_inputBuffer, NULL);
+        fire_channel_read_complete(this);
     }
     return true;
 }
 
 bool Channel::AttachFD()
 {
-    int fd = GetReadFD();
+    int fd = m_output_read_paused ? -1 : GetReadFD();
     if (fd != -1 && aeCreateFileEvent(GetService().GetRawEventLoop(), fd, AE_READABLE, Channel::IOEventCallback, this) == AE_ERR)
     {
         ::close(GetReadFD());
@@ -329,12 +344,16 @@ int32 Channel::WriteNow(Buffer* buffer)
         return 0;
     }
     uint32 buf_len = NULL != buffer ? buffer->ReadableBytes() : 0;
+    if (m_options.cork_output_bytes > 0 && 0 == m_options.user_write_buffer_water_mark && !m_options.async_write)
+    {
+        return CorkOutput(buffer, buf_len);
+    }
 
-    if (m_outputBuffer.Readable())
+    if (HasPendingOutput())
     {
         if (m_options.max_write_buffer_size > 0) //write buffer size limit enable
         {
-            uint32 write_buffer_size = m_outputBuffer.ReadableBytes();
+            uint32 write_buffer_size = WritableBytes();
             if (write_buffer_size > (uint32) m_options.max_write_buffer_size || (write_buffer_size + buf_len) > (uint32) m_options.max_write_buffer_size)
             {
                 //overflow
@@ -416,6 +435,58 @@ int32 Channel::WriteNow(Buffer* buffer)
     }
 }
 
+/*
+ * Buffers the write until ChannelService flushes the corked channels at the end of the loop iteration,
+ * or writes all pending output at once when it reaches 'cork_output_bytes'.
+ */
+int32 Channel::CorkOutput(Buffer* buffer, uint32 buf_len)
+{
+    if (m_options.max_write_buffer_size > 0 && WritableBytes() + buf_len > (uint32) m_options.max_write_buffer_size)
+    {
+        WARN_LOG("Channel:%u write buffer exceed limit:%d", m_id, m_options.max_write_buffer_size);
+        return 0;
+    }
+    m_outputBuffer.Write(buffer, buf_len);
+    if (IsEnableWriting())
+    {
+        /*
+         * the socket is full, OnWrite sends it once writable
+         */
+        return buf_len;
+    }
+    if (WritableBytes() >= m_options.cork_output_bytes)
+    {
+        if (!UncorkOutput())
+        {
+            return -1;
+        }
+    }
+    else if (!m_corked)
+    {
+        m_corked = true;
+        GetService().CorkChannel(this);
+    }
+    return buf_len;
+}
+
+bool Channel::UncorkOutput()
+{
+    m_corked = false;
+    if (!HasPendingOutput() || IsEnableWriting())
+    {
+        return true;
+    }
+    if (!DoFlush())
+    {
+        return false;
+    }
+    if (HasPendingOutput())
+    {
+        EnableWriting();
+    }
+    return true;
+}
+
 bool Channel::DoConfigure(const ChannelOptions& options)
 {
     if (options.user_write_buffer_water_mark > 0)
@@ -449,14 +520,142 @@ bool Channel::DoClose()
     return true;
 }
 
+void Channel::WriteChunk(std::string& data)
+{
+    m_output_chunks.push_back(OutputChunk());
+    OutputChunk& chunk = m_output_chunks.back();
+    chunk.data.swap(data);
+    chunk.buffer_pos = m_output_consumed + m_outputBuffer.ReadableBytes();
+    m_output_chunk_bytes += chunk.data.size();
+}
+
+int Channel::DrainOutput(uint32 limit, uint32 timeout_ms)
+{
+    uint64 start = get_current_epoch_millis();
+    while (WritableBytes() > limit)
+    {
+        int err = 0;
+        int ret = 0;
+        if (m_output_chunks.empty())
+        {
+            ret = m_outputBuffer.WriteFD(GetWriteFD(), err);
+            if (ret > 0)
+            {
+                m_output_consumed += ret;
+            }
+        }
+        else
+        {
+            ret = FlushChunks(err);
+        }
+        if (ret > 0)
+        {
+            m_outputBuffer.DiscardReadedBytes();
+            continue;
+        }
+        if (ret == 0 || !IO_ERR_RW_RETRIABLE(err))
+        {
+            return -1;
+        }
+        uint64 waited = get_current_epoch_millis() - start;
+        if (waited >= timeout_ms)
+        {
+            return 0;
+        }
+        struct pollfd pfd;
+        pfd.fd = GetWriteFD();
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        ::poll(&pfd, 1, timeout_ms - waited);
+    }
+    return 1;
+}
+
+/*
+ * Sends the output buffer with the chunks queued between its bytes by one writev.
+ */
+int Channel::FlushChunks(int& err)
+{
+    static const int kMaxIOVs = 64;
+    struct iovec iovs[kMaxIOVs];
+    int iovcnt = 0;
+    const char* base = m_outputBuffer.GetRawReadBuffer();
+    uint64 pos = m_output_consumed;
+    uint64 buffer_end = m_output_consumed + m_outputBuffer.ReadableBytes();
+    for (size_t i = 0; i < m_output_chunks.size() && iovcnt < kMaxIOVs - 1; i++)
+    {
+        OutputChunk& chunk = m_output_chunks[i];
+        if (chunk.buffer_pos > pos)
+        {
+            iovs[iovcnt].iov_base = (void*) (base + (pos - m_output_consumed));
+            iovs[iovcnt].iov_len = chunk.buffer_pos - pos;
+            iovcnt++;
+            pos = chunk.buffer_pos;
+        }
+        iovs[iovcnt].iov_base = (void*) (chunk.data.data() + chunk.offset);
+        iovs[iovcnt].iov_len = chunk.data.size() - chunk.offset;
+        iovcnt++;
+    }
+    if (iovcnt < kMaxIOVs && buffer_end > pos)
+    {
+        iovs[iovcnt].iov_base = (void*) (base + (pos - m_output_consumed));
+        iovs[iovcnt].iov_len = buffer_end - pos;
+        iovcnt++;
+    }
+    int ret = ::writev(GetWriteFD(), iovs, iovcnt);
+    if (ret < 0)
+    {
+        err = errno;
+        return ret;
+    }
+    size_t left = ret;
+    while (left > 0)
+    {
+        if (!m_output_chunks.empty() && m_output_chunks.front().buffer_pos == m_output_consumed)
+        {
+            OutputChunk& chunk = m_output_chunks.front();
+            size_t n = chunk.data.size() - chunk.offset;
+            n = n > left ? left : n;
+            chunk.offset += n;
+            left -= n;
+            if (chunk.offset == chunk.data.size())
+            {
+                m_output_chunk_bytes -= chunk.data.size();
+                m_output_chunks.pop_front();
+            }
+        }
+        else
+        {
+            size_t n = m_output_chunks.empty() ? m_outputBuffer.ReadableBytes() : m_output_chunks.front().buffer_pos - m_output_consumed;
+            n = n > left ? left : n;
+            m_outputBuffer.AdvanceReadIndex(n);
+            m_output_consumed += n;
+            left -= n;
+        }
+    }
+    return ret;
+}
+
 bool Channel::DoFlush()
 {
     //TRACE_LOG("Flush %u bytes for channel.", m_outputBuffer.ReadableBytes());
-    if (m_outputBuffer.Readable())
+    if (HasPendingOutput())
     {
-        uint32 send_buf_len = m_outputBuffer.ReadableBytes();
+        uint32 send_buf_len = WritableBytes();
         int err;
-        int ret = m_outputBuffer.WriteFD(GetWriteFD(), err);
+        int ret = 0;
+        if (m_output_chunks.empty())
+        {
+            ret = m_outputBuffer.WriteFD(GetWriteFD(), err);
+            if (ret > 0)
+            {
+                m_output_consumed += ret;
+            }
+        }
+        else
+        {
+            ret = FlushChunks(err);
+        }
         if (ret < 0)
         {
             if (IO_ERR_RW_RETRIABLE(err))
@@ -474,8 +673,18 @@ bool Channel::DoFlush()
         {
             return HandleExceptionEvent(CHANNEL_EVENT_EOF);
         }
-        m_outputBuffer.DiscardReadedBytes();
-        m_outputBuffer.Compact(m_options.user_write_buffer_water_mark > 0 ? m_options.user_write_buffer_water_mark * 2 : 8192);
+        if (!HasPendingOutput())
+        {
+            /*
+             * drained output goes back to the buffer pool
+             */
+            m_outputBuffer.Release();
+        }
+        else
+        {
+            m_outputBuffer.DiscardReadedBytes();
+            m_outputBuffer.Compact(m_options.user_write_buffer_water_mark > 0 ? m_options.user_write_buffer_water_mark * 2 : 8192);
+        }
         if ((uint32) ret < send_buf_len)
         {
             //EnableWriting();
@@ -488,7 +697,7 @@ bool Channel::DoFlush()
     }
     else
     {
-        m_outputBuffer.Compact(m_options.user_write_buffer_water_mark > 0 ? m_options.user_write_buffer_water_mark : 8192);
+        m_outputBuffer.Release();
         return true;
     }
 
@@ -548,6 +757,14 @@ void Channel::OnRead()
         //TRACE_LOG(
         //        "DataReceived with %d bytes in channel %u.", m_inputBuffer.ReadableBytes(), GetID());
         fire_message_received<Buffer>(this, &m_inputBuffer, NULL);
+        fire_channel_read_complete(this);
+        /*
+         * consumed input goes back to the buffer pool, so idle connections hold no input buffer
+         */
+        if (!m_inputBuffer.Readable())
+        {
+            m_inputBuffer.Release();
+        }
     }
     else
     {
@@ -556,6 +773,62 @@ void Channel::OnRead()
     }
 }
 
+void Channel::SetOutputLimits(uint32 soft_limit, uint32 hard_limit)
+{
+    m_output_soft_limit = soft_limit;
+    m_output_hard_limit = hard_limit;
+    if (m_output_read_paused && (0 == soft_limit || WritableBytes() < soft_limit))
+    {
+        ResumeOutputPausedRead();
+    }
+}
+
+void Channel::CheckOutputLimits()
+{
+    uint32 pending = WritableBytes();
+    if (m_output_hard_limit > 0 && pending > m_output_hard_limit)
+    {
+        WARN_LOG("Close channel:%u since its pending output:%u exceed hard limit:%u", m_id, pending, m_output_hard_limit);
+        m_outputBuffer.Clear();
+        m_output_chunks.clear();
+        m_output_chunk_bytes = 0;
+        m_output_consumed = 0;
+        Close();
+        return;
+    }
+    if (m_output_soft_limit > 0 && pending > m_output_soft_limit && !m_output_read_paused && GetReadFD() > 0)
+    {
+        DEBUG_LOG("Pause reading channel:%u since its pending output:%u exceed soft limit:%u", m_id, pending, m_output_soft_limit);
+        if (!m_block_read)
+        {
+            aeDeleteFileEvent(GetService().GetRawEventLoop(), GetReadFD(), AE_READABLE);
+        }
+        m_output_read_paused = true;
+    }
+}
+
+void Channel::ResumeOutputPausedRead()
+{
+    m_output_read_paused = false;
+    int fd = GetReadFD();
+    if (m_block_read || m_detached || fd == -1)
+    {
+        return;
+    }
+    if (aeCreateFileEvent(GetService().GetRawEventLoop(), fd, AE_READABLE, Channel::IOEventCallback, this) == AE_ERR)
+    {
+        ERROR_LOG("Failed to register event for fd:%d.", fd);
+        DoClose(false);
+        return;
+    }
+    /*
+     * fired even if the input buffer is empty, since the frame decoder may hold
+     * undecoded input in its own cumulation buffer.
+     */
+    fire_message_received<Buffer>(this, &m_inputBuffer, NULL);
+    fire_channel_read_complete(this);
+}
+
 void Channel::OnWrite()
 {
     if (!DoFlush())
@@ -571,7 +844,11 @@ void Channel::OnWrite()
             return;
         }
     }
-    if (m_outputBuffer.Readable())
+    if (m_output_read_paused && WritableBytes() < m_output_soft_limit)
+    {
+        ResumeOutputPausedRead();
+    }
+    if (HasPendingOutput())
     {
         return;
     }
@@ -622,7 +899,7 @@ void Channel::OnWrite()
         }
     }
     fire_channel_writable(this);
-    if (!m_outputBuffer.Readable() && m_options.auto_disable_writing)
+    if (!HasPendingOutput() && m_options.auto_disable_writing)
     {
         DisableWriting();
     }
@@ -733,7 +1010,7 @@ bool Channel::DoClose(bool inDestructor)
 
 bool Channel::Close()
 {
-    if (m_outputBuffer.Readable() && GetWriteFD() > 0)
+    if (HasPendingOutput() && GetWriteFD() > 0)
     {
         EnableWriting();
         m_close_after_write = true;
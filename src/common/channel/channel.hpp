@@ -35,6 +35,8 @@
 #include "channel/channel_pipeline.hpp"
 #include "util/helpers.hpp"
 #include <map>
+#include <deque>
+#include <string>
 
 /* delayed ack (quick_ack) */
 #ifndef HAVE_TCP_QUICKACK
@@ -98,11 +100,16 @@ namespace ardb
             int32 max_write_buffer_size;  //-1: means unlimit 0: disable
             bool auto_disable_writing;
             bool async_write;
+            /*
+             * writes are buffered until the event loop iteration ends or this many bytes are pending, so the replies
+             * of one read go out by one write/writev, 0 writes at once
+             */
+            uint32 cork_output_bytes;
 
             ChannelOptions() :
                     receive_buffer_size(0), send_buffer_size(0), tcp_nodelay(true), keep_alive(0), reuse_address(true), user_write_buffer_water_mark(
                             0), user_write_buffer_flush_timeout_mills(0), max_write_buffer_size(-1), auto_disable_writing(
-                            true),async_write(false)
+                            true),async_write(false), cork_output_bytes(0)
             {
             }
     };
@@ -170,7 +177,25 @@ namespace ardb
             int m_fd;
             Buffer m_inputBuffer;
             Buffer m_outputBuffer;
+            /*
+             * Large payloads queued by WriteChunk, a chunk is sent right after the output buffer bytes written before it,
+             * 'buffer_pos' is its position in all bytes ever written to the output buffer.
+             */
+            struct OutputChunk
+            {
+                    std::string data;
+                    size_t offset;
+                    uint64 buffer_pos;
+                    OutputChunk() :
+                            offset(0), buffer_pos(0)
+                    {
+                    }
+            };
+            std::deque<OutputChunk> m_output_chunks;
+            uint64 m_output_chunk_bytes;
+            uint64 m_output_consumed; //bytes of the output buffer already sent
             int32 m_flush_timertask_id;
+            bool m_corked; //queued in the service for the flush at the end of the loop iteration
             ChannelPipelineInitializer* m_pipeline_initializor;
             void* m_pipeline_initailizor_user_data;
             ChannelPipelineFinalizer* m_pipeline_finallizer;
@@ -178,6 +203,9 @@ namespace ardb
             bool m_detached;
             bool m_close_after_write;
             bool m_block_read;
+            bool m_output_read_paused; //read blocked by the soft output limit
+            uint32 m_output_soft_limit;
+            uint32 m_output_hard_limit;
 
             SendFileSetting* m_file_sending;
             void* m_attach;
@@ -200,7 +228,16 @@ namespace ardb
             virtual bool DoConnect(Address* remote);
             virtual bool DoClose();
             virtual bool DoFlush();
+            int FlushChunks(int& err);
+            void CheckOutputLimits();
+            void ResumeOutputPausedRead();
+            inline bool HasPendingOutput()
+            {
+                return m_outputBuffer.Readable() || !m_output_chunks.empty();
+            }
             virtual int32 WriteNow(Buffer* buffer);
+            int32 CorkOutput(Buffer* buffer, uint32 buf_len);
+            bool UncorkOutput();
             virtual int32 ReadNow(Buffer* buffer);
             virtual int32 HandleExceptionEvent(int32 event);
             int HandleIOError(int err);
@@ -231,13 +268,23 @@ namespace ardb
 
             inline uint32 WritableBytes()
             {
-                return m_outputBuffer.ReadableBytes();
+                return m_outputBuffer.ReadableBytes() + m_output_chunk_bytes;
             }
 
             inline Buffer& GetOutputBuffer()
             {
                 return m_outputBuffer;
             }
+            /*
+             * Queues 'data' after the bytes already in the output buffer without copying it, the string is swapped out.
+             */
+            void WriteChunk(std::string& data);
+            /*
+             * Sends pending output without returning to the event loop until at most 'limit' bytes are left,
+             * waits at most 'timeout_ms' for the socket to be writable.
+             * Returns 1 once drained to the limit, 0 on timeout, -1 on io error, the error is handled by the event loop later.
+             */
+            int DrainOutput(uint32 limit, uint32 timeout_ms);
 
             inline uint32 ReadableBytes()
             {
@@ -307,8 +354,14 @@ namespace ardb
             bool UnblockRead();
             bool IsReadBlocked()
             {
-                return m_block_read;
+                return m_block_read || m_output_read_paused;
             }
+            /*
+             * Pending output limits, 0 means unlimited. Above the soft limit the channel
+             * stops reading and decoding input until the output drains, above the hard
+             * limit it is closed.
+             */
+            void SetOutputLimits(uint32 soft_limit, uint32 hard_limit);
 
             inline void SetChannelPipelineInitializor(ChannelPipelineInitializer* initializor, void* data = NULL)
             {
@@ -347,10 +400,19 @@ namespace ardb
             template<typename T>
             bool Write(T& msg)
             {
-                return write_channel<T>(this, &msg, NULL);
+                bool ret = write_channel<T>(this, &msg, NULL);
+                if (m_output_soft_limit > 0 || m_output_hard_limit > 0)
+                {
+                    CheckOutputLimits();
+                }
+                return ret;
             }
 
             int SendFile(const SendFileSetting& setting);
+            bool IsSendingFile()
+            {
+                return NULL != m_file_sending;
+            }
 
             bool Flush();
             virtual const Address* GetLocalAddress()
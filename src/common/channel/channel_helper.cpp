@@ -67,6 +67,12 @@ namespace ardb
 		return channel->GetPipeline().SendUpstream(event);
 	}
 
+	bool fire_channel_read_complete(Channel* channel)
+	{
+		ChannelStateEvent event(channel, READ_COMPLETE, NULL, true);
+		return channel->GetPipeline().SendUpstream(event);
+	}
+
 	bool GetSocketRemoteAddress(Channel* channel, SocketHostAddress& address)
 	{
 		const Address* remote_address = channel->GetRemoteAddress();
@@ -62,6 +62,11 @@ namespace ardb
 
 	bool fire_channel_writable(Channel* channel);
 
+	/*
+	 * fired after the frames decoded from one read of the channel have been handled.
+	 */
+	bool fire_channel_read_complete(Channel* channel);
+
 	//bool openChannel(Channel* channel);
 	//bool bindChannel(Channel* channel, Address* localAddress);
 	//ChannelEvent* unbindChannel(Channel* channel);
@@ -29,6 +29,7 @@
 
 #include "channel/all_includes.hpp"
 #include "util/helpers.hpp"
+#include "util/atomic.hpp"
 #include "util/datagram_packet.hpp"
 #include "buffer/buffer_helper.hpp"
 #include <list>
@@ -37,9 +38,11 @@ using namespace ardb;
 
 ChannelService::ChannelService(uint32 setsize) :
         m_setsize(setsize), m_eventLoop(NULL), m_timer(NULL), m_signal_channel(
-        NULL), m_self_soft_signal_channel(NULL), m_running(false), m_thread_pool_size(1), m_tid(0), m_lifecycle_callback(NULL), m_pool_index(0), m_parent(NULL)
+        NULL), m_self_soft_signal_channel(NULL), m_async_io_signaled(0), m_running(false), m_thread_pool_size(1), m_tid(0), m_lifecycle_callback(NULL), m_pool_index(0), m_parent(NULL)
 {
     m_eventLoop = aeCreateEventLoop(m_setsize);
+    m_eventLoop->privdata = this;
+    aeSetBeforeSleepProc(m_eventLoop, ChannelService::BeforeSleep);
     m_self_soft_signal_channel = NewSoftSignalChannel();
     if (NULL != m_self_soft_signal_channel)
     {
@@ -166,6 +169,10 @@ void ChannelService::OnSoftSignal(uint32 soft_signo, uint32 appendinfo)
         }
         case CHANNEL_ASNC_IO:
         {
+            /*
+             * requests pushed after the reset fire a new signal, the ones before are drained below
+             */
+            atomic_cmp_set_uint32(&m_async_io_signaled, 1, 0);
             ChannelAsyncIOContext ctx;
             while (m_async_io_queue.Pop(ctx))
             {
@@ -352,6 +359,30 @@ void ChannelService::Start()
 void ChannelService::Continue()
 {
     aeProcessEvents(m_eventLoop, AE_FILE_EVENTS | AE_DONT_WAIT | AE_TIME_EVENTS);
+    FlushCorkedChannels();
+}
+
+void ChannelService::FlushCorkedChannels()
+{
+    if (m_corked_channels.empty())
+    {
+        return;
+    }
+    std::vector<uint32> corked;
+    corked.swap(m_corked_channels);
+    for (size_t i = 0; i < corked.size(); i++)
+    {
+        Channel* ch = GetChannel(corked[i]);
+        if (NULL != ch && ch->m_corked)
+        {
+            ch->UncorkOutput();
+        }
+    }
+}
+
+void ChannelService::BeforeSleep(aeEventLoop* loop)
+{
+    ((ChannelService*) loop->privdata)->FlushCorkedChannels();
 }
 
 void ChannelService::OnStopCB(Channel*, void* data)
@@ -561,9 +592,12 @@ void ChannelService::Run()
 void ChannelService::AsyncIO(const ChannelAsyncIOContext& ctx)
 {
     m_async_io_queue.Push(ctx);
-    if (NULL != m_self_soft_signal_channel)
+    if (NULL != m_self_soft_signal_channel && atomic_cmp_set_uint32(&m_async_io_signaled, 0, 1))
     {
-        m_self_soft_signal_channel->FireSoftSignal(CHANNEL_ASNC_IO, 1);
+        if (m_self_soft_signal_channel->FireSoftSignal(CHANNEL_ASNC_IO, 1) < 0)
+        {
+            m_async_io_signaled = 0;
+        }
     }
 }
 
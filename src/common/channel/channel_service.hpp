@@ -87,7 +87,7 @@ namespace ardb
             typedef std::vector<ChannelService*> ChannelServicePool;
             typedef std::vector<Thread*> ThreadVector;
 
-            typedef MPSCQueue<ChannelAsyncIOContext> AsyncIOQueue;
+            typedef MPSCRingQueue<ChannelAsyncIOContext> AsyncIOQueue;
             ChannelTable m_channel_table;
             uint32 m_setsize;
             aeEventLoop* m_eventLoop;
@@ -96,6 +96,14 @@ namespace ardb
             SoftSignalChannel* m_self_soft_signal_channel;
             RemoveChannelQueue m_remove_queue;
             AsyncIOQueue m_async_io_queue;
+            /*
+             * set by the producer firing CHANNEL_ASNC_IO, one soft signal wakes the loop for a batch of requests
+             */
+            volatile uint32_t m_async_io_signaled;
+            /*
+             * ids of the channels holding corked output, flushed before the loop waits for events again
+             */
+            std::vector<uint32> m_corked_channels;
 
             bool m_running;
 
@@ -154,6 +162,12 @@ namespace ardb
             void AttachAcceptedChannel(SocketChannel *ch);
             void AsyncIO(const ChannelAsyncIOContext& ctx);
             void Routine();
+            void CorkChannel(Channel* ch)
+            {
+                m_corked_channels.push_back(ch->GetID());
+            }
+            void FlushCorkedChannels();
+            static void BeforeSleep(aeEventLoop* loop);
             void SetParent(ChannelService* parent)
             {
                 m_parent = parent;
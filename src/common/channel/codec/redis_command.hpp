@@ -83,6 +83,13 @@ namespace ardb
             REDIS_CMD_PUBSUB = 39,
             REDIS_CMD_MONITOR = 40,
             REDIS_CMD_DEBUG = 41,
+            REDIS_CMD_WAIT = 42,
+            REDIS_CMD_MEMORY = 43,
+            REDIS_CMD_LATENCY = 44,
+            REDIS_CMD_HOTKEYS = 45,
+            REDIS_CMD_BGJOBS = 46,
+            REDIS_CMD_BACKUP = 47,
+            REDIS_CMD_CDC = 48,
 
             //'keys' commands
             REDIS_CMD_DEL = 50,
@@ -109,6 +116,8 @@ namespace ardb
             REDIS_CMD_MIGRATEDB = 71,
             REDIS_CMD_RESTOREDB = 72,
             REDIS_CMD_RESTORECHUNK = 73,
+            REDIS_CMD_REBALANCE = 74,
+            REDIS_CMD_UNLINK = 75,
 
             //'string' commands
             REDIS_CMD_APPEND = 100,
@@ -138,6 +147,7 @@ namespace ardb
             REDIS_CMD_PFCOUNT = 124,
             REDIS_CMD_PFMERGE = 125,
             REDIS_CMD_SETXX = 126,
+            REDIS_CMD_BITPOS = 127,
 
             //'hash' commands
             REDIS_CMD_HDEL = 150,
@@ -154,6 +164,13 @@ namespace ardb
             REDIS_CMD_HSETNX = 161,
             REDIS_CMD_HMSET = 162,
             REDIS_CMD_HSCAN = 163,
+            REDIS_CMD_HEXPIRE = 164,
+            REDIS_CMD_HPEXPIRE = 165,
+            REDIS_CMD_HEXPIREAT = 166,
+            REDIS_CMD_HPEXPIREAT = 167,
+            REDIS_CMD_HTTL = 168,
+            REDIS_CMD_HPTTL = 169,
+            REDIS_CMD_HPERSIST = 170,
 
             //'set' commands
             REDIS_CMD_SCARD = 200,
@@ -226,8 +243,63 @@ namespace ardb
             REDIS_CMD_LSET = 317,
             REDIS_CMD_CACHEMEMORY = 318,
 
+            //'bloom' commands
+            REDIS_CMD_BFRESERVE = 350,
+            REDIS_CMD_BFADD = 351,
+            REDIS_CMD_BFMADD = 352,
+            REDIS_CMD_BFEXISTS = 353,
+            REDIS_CMD_BFMEXISTS = 354,
+            REDIS_CMD_BFINFO = 355,
+
+            //'timeseries' commands
+            REDIS_CMD_TSCREATE = 360,
+            REDIS_CMD_TSADD = 361,
+            REDIS_CMD_TSGET = 362,
+            REDIS_CMD_TSRANGE = 363,
+            REDIS_CMD_TSINFO = 364,
+
+            //'stream' commands
+            REDIS_CMD_XADD = 370,
+            REDIS_CMD_XLEN = 371,
+            REDIS_CMD_XRANGE = 372,
+            REDIS_CMD_XREVRANGE = 373,
+            REDIS_CMD_XREAD = 374,
+            REDIS_CMD_XTRIM = 375,
+            REDIS_CMD_XDEL = 376,
+
+            //'sketch' commands
+            REDIS_CMD_CMSINITBYDIM = 380,
+            REDIS_CMD_CMSINITBYPROB = 381,
+            REDIS_CMD_CMSINCRBY = 382,
+            REDIS_CMD_CMSQUERY = 383,
+            REDIS_CMD_CMSINFO = 384,
+            REDIS_CMD_TOPKRESERVE = 385,
+            REDIS_CMD_TOPKADD = 386,
+            REDIS_CMD_TOPKINCRBY = 387,
+            REDIS_CMD_TOPKQUERY = 388,
+            REDIS_CMD_TOPKLIST = 389,
+            REDIS_CMD_TOPKINFO = 390,
+
+            //'index' commands
+            REDIS_CMD_IDXCREATE = 395,
+            REDIS_CMD_IDXDROP = 396,
+            REDIS_CMD_IDXLIST = 397,
+            REDIS_CMD_IDXRANGE = 398,
+
+            //'vector set' commands
+            REDIS_CMD_VADD = 400,
+            REDIS_CMD_VREM = 401,
+            REDIS_CMD_VSIM = 402,
+            REDIS_CMD_VCARD = 403,
+            REDIS_CMD_VDIM = 404,
+            REDIS_CMD_VINFO = 405,
+            REDIS_CMD_VEMB = 406,
+
             //cluster commands
             REDIS_CMD_CLUSTER = 500,  //used in cluster mode
+            REDIS_CMD_ASKING = 501,
+            REDIS_CMD_READONLY = 502,
+            REDIS_CMD_READWRITE = 503,
 
             REDIS_CMD_EXTEND_BEGIN = 1000,
             REDIS_CMD_APPEND2 = 1001,
@@ -263,6 +335,14 @@ namespace ardb
 
         class RedisCommandDecoder;
         typedef std::deque<std::string> ArgumentArray;
+
+        /*
+         * If set, decoders resolve the command type as soon as the command name is read,
+         * so that the frame arrives at the handler with its type already set.
+         */
+        typedef RedisCommandType RedisCommandTypeResolver(const char* cmd, size_t len);
+        extern RedisCommandTypeResolver* g_redis_command_type_resolver;
+
         class RedisCommandFrame
         {
             private:
@@ -275,18 +355,28 @@ namespace ardb
                  * Used to save temp protocol data
                  */
                 Buffer m_raw_msg;
+                /*
+                 * Argument strings are taken from and given back to a per thread pool, so that decoding a command
+                 * reuses the buffers of previous commands instead of allocating one string per argument.
+                 */
+                static std::string& NewArgument(ArgumentArray& args);
+                static void ReleaseArguments(ArgumentArray& args);
                 inline void FillNextArgument(Buffer& buf, size_t len)
                 {
                     const char* str = buf.GetRawReadBuffer();
                     buf.AdvanceReadIndex(len);
                     if (m_cmd_seted)
                     {
-                        m_args.push_back(std::string(str, len));
+                        NewArgument(m_args).assign(str, len);
                     }
                     else
                     {
                         m_cmd.append(str, len);
                         m_cmd_seted = true;
+                        if (NULL != g_redis_command_type_resolver)
+                        {
+                            type = g_redis_command_type_resolver(m_cmd.data(), m_cmd.size());
+                        }
                     }
                 }
                 friend class RedisCommandDecoder;
@@ -352,6 +442,13 @@ namespace ardb
                 {
                     return m_raw_msg;
                 }
+                /*
+                 * A handler rewriting its arguments for replication drops the raw bytes, the frame is encoded again.
+                 */
+                inline void ClearRawProtocolData()
+                {
+                    m_raw_msg.Clear();
+                }
                 inline void SetType(RedisCommandType type)
                 {
                     this->type = type;
@@ -387,6 +484,7 @@ namespace ardb
                 void SetCommand(const std::string& cmd)
                 {
                     m_cmd = cmd;
+                    type = REDIS_CMD_INVALID;
                 }
                 const std::string* GetArgument(uint32 index) const
                 {
@@ -420,6 +518,10 @@ namespace ardb
                 }
                 void ReserveArgs(size_t size)
                 {
+                    while (m_args.size() < size)
+                    {
+                        NewArgument(m_args);
+                    }
                     m_args.resize(size);
                 }
                 void Adapt()
@@ -432,13 +534,14 @@ namespace ardb
                 }
                 void Clear()
                 {
+                    type = REDIS_CMD_INVALID;
                     m_cmd_seted = false;
                     m_cmd.clear();
-                    m_args.clear();
+                    ReleaseArguments(m_args);
                 }
                 ~RedisCommandFrame()
                 {
-
+                    ReleaseArguments(m_args);
                 }
         };
 
@@ -31,13 +31,59 @@
 #include "channel/all_includes.hpp"
 #include "redis_command_codec.hpp"
 #include "util/exception/api_exception.hpp"
+#include "thread/thread_local.hpp"
 #include <string.h>
 #include <limits.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using ardb::BufferHelper;
 using namespace ardb::codec;
 using namespace ardb;
 
+RedisCommandTypeResolver* ardb::codec::g_redis_command_type_resolver = NULL;
+
+/*
+ * Only strings with a heap buffer up to kMaxPooledArgumentSize are pooled & the pool is bounded,
+ * a big argument is freed as before.
+ */
+static const size_t kMaxPooledArguments = 1024;
+static const size_t kMaxPooledArgumentSize = 1024;
+static const size_t kInlineArgumentSize = std::string().capacity();
+typedef std::vector<std::string> ArgumentPool;
+static ThreadLocal<ArgumentPool> g_argument_pool;
+
+std::string& RedisCommandFrame::NewArgument(ArgumentArray& args)
+{
+    args.push_back(std::string());
+    ArgumentPool& pool = g_argument_pool.GetValue();
+    if (!pool.empty())
+    {
+        args.back().swap(pool.back());
+        pool.pop_back();
+    }
+    return args.back();
+}
+
+void RedisCommandFrame::ReleaseArguments(ArgumentArray& args)
+{
+    if (!args.empty())
+    {
+        ArgumentPool& pool = g_argument_pool.GetValue();
+        for (size_t i = 0; i < args.size() && pool.size() < kMaxPooledArguments; i++)
+        {
+            if (args[i].capacity() > kInlineArgumentSize && args[i].capacity() <= kMaxPooledArgumentSize)
+            {
+                args[i].clear();
+                pool.push_back(std::string());
+                pool.back().swap(args[i]);
+            }
+        }
+        args.clear();
+    }
+}
+
 #define REDIS_INLINE_MAX_SIZE   (1024*64) /* Max size of inline reads */
 #define REDIS_MBULK_BIG_ARG     (1024*32)
 
@@ -46,19 +92,139 @@ static const uint32 REDIS_REQ_INLINE = 1;
 static const uint32 REDIS_REQ_MULTIBULK = 2;
 static const char* kCRLF = "\r\n";
 
+/*
+ * Finds the '\r' of RESP lines, the positions of all '\r' in a 64 bytes block are computed at once(by SSE2 if supported)
+ * into a bitmask, so the lines of pipelined small commands within the block cost one ctz each instead of a byte scan.
+ */
+class CRScanner
+{
+    private:
+        const char* m_end;
+        const char* m_block;
+        uint64_t m_mask;
+        void Load(const char* p)
+        {
+            m_block = p;
+            m_mask = 0;
+            size_t len = m_end - p;
+            if (len >= 64)
+            {
+#if defined(__SSE2__)
+                const __m128i cr = _mm_set1_epi8('\r');
+                for (int i = 0; i < 4; i++)
+                {
+                    __m128i v = _mm_loadu_si128((const __m128i*) (p + i * 16));
+                    m_mask |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v, cr)) << (i * 16);
+                }
+                return;
+#else
+                len = 64;
+#endif
+            }
+            for (size_t i = 0; i < len; i++)
+            {
+                m_mask |= (uint64_t) (p[i] == '\r') << i;
+            }
+        }
+    public:
+        CRScanner(const char* begin, const char* end) :
+                m_end(end), m_block(end), m_mask(0)
+        {
+        }
+        /*
+         * Returns the first '\r' at or after 'p', NULL if there is none before the end.
+         */
+        const char* Find(const char* p)
+        {
+            while (p < m_end)
+            {
+                if (p < m_block || p >= m_block + 64)
+                {
+                    Load(p);
+                }
+                uint64_t mask = m_mask & (~0ULL << (p - m_block));
+                if (0 != mask)
+                {
+                    return m_block + __builtin_ctzll(mask);
+                }
+                p = m_block + 64;
+            }
+            return NULL;
+        }
+};
+
+/*
+ * Parses the length of a '*' or '$' line, the digits are at most 18 so there is no overflow check per digit.
+ */
+static inline bool parse_line_length(const char* p, const char* end, int64_t& v)
+{
+    bool negative = false;
+    if (p < end && *p == '-')
+    {
+        negative = true;
+        p++;
+    }
+    if (p == end || end - p > 18)
+    {
+        return false;
+    }
+    int64_t n = 0;
+    for (; p < end; p++)
+    {
+        unsigned int digit = (unsigned char) (*p) - '0';
+        if (digit > 9)
+        {
+            return false;
+        }
+        n = n * 10 + digit;
+    }
+    v = negative ? -n : n;
+    return true;
+}
+
+/*
+ * Reads a "<length>\r\n" line at 'p', returns 1 with 'next' after the line, 0 if more data is required, -1 if malformed.
+ */
+static inline int read_line_length(CRScanner& scanner, const char* p, const char* end, int64_t& v, const char*& next)
+{
+    const char* cr = scanner.Find(p);
+    if (NULL == cr || cr + 1 >= end)
+    {
+        /*
+         * incomplete line, it's malformed already if the part read is not a number
+         */
+        for (const char* c = p; c < (NULL == cr ? end : cr); c++)
+        {
+            if (!((*c >= '0' && *c <= '9') || (*c == '-' && c == p)))
+            {
+                return -1;
+            }
+        }
+        return 0;
+    }
+    if (cr[1] != '\n' || !parse_line_length(p, cr, v))
+    {
+        return -1;
+    }
+    next = cr + 2;
+    return 1;
+}
+
 int FastRedisCommandDecoder::ProcessMultibulkBuffer(Buffer& buffer, std::string& err)
 {
-    const char *newline = NULL;
+    const char* begin = buffer.GetRawReadBuffer();
+    const char* end = begin + buffer.ReadableBytes();
+    const char* next = NULL;
+    CRScanner scanner(begin, end);
     int pos = 0, ok;
     int64_t ll;
-    //const char* querybuf = buffer.GetRawReadBuffer();
     if (m_multibulklen == 0)
     {
         m_cmd.Clear();
         m_argc = 0;
         /* Multi bulk length cannot be read without a \r\n */
-        newline = strchr(buffer.GetRawReadBuffer(), '\r');
-        if (newline == NULL)
+        ok = read_line_length(scanner, begin + 1, end, ll, next);
+        if (ok == 0)
         {
             if (buffer.ReadableBytes() > REDIS_INLINE_MAX_SIZE)
             {
@@ -67,21 +233,13 @@ int FastRedisCommandDecoder::ProcessMultibulkBuffer(Buffer& buffer, std::string&
             }
             return 0;
         }
-        /* Buffer should also contain \n */
-        if (newline - buffer.GetRawReadBuffer() > (buffer.ReadableBytes() - 2))
-            return 0;
-
-        /* We know for sure there is a whole line since newline != NULL,
-         * so go ahead and find out the multi bulk length. */
-
-        ok = string2ll(buffer.GetRawReadBuffer() + 1, newline - (buffer.GetRawReadBuffer() + 1), &ll);
-        if (!ok || ll > 1024 * 1024)
+        if (ok < 0 || ll > 1024 * 1024)
         {
             err = "Protocol error: invalid multibulk length";
             return -1;
         }
 
-        pos = (newline - buffer.GetRawReadBuffer()) + 2;
+        pos = next - begin;
         if (ll <= 0)
         {
             buffer.AdvanceReadIndex(pos);
@@ -96,36 +254,33 @@ int FastRedisCommandDecoder::ProcessMultibulkBuffer(Buffer& buffer, std::string&
         /* Read bulk length if unknown */
         if (m_bulklen == -1)
         {
-            newline = strchr(buffer.GetRawReadBuffer() + pos, '\r');
-            if (newline == NULL)
+            if (begin + pos >= end)
             {
-                if (buffer.ReadableBytes() > REDIS_INLINE_MAX_SIZE)
-                {
-                    err = "Protocol error: too big bulk count string";
-                    return -1;
-                }
                 break;
             }
-
-            /* Buffer should also contain \n */
-            if (newline - buffer.GetRawReadBuffer() > (buffer.ReadableBytes() - 2))
-                break;
-
-            if (buffer.GetRawReadBuffer()[pos] != '$')
+            if (begin[pos] != '$')
             {
                 err = "Protocol error: expected '$', got '%c'";
                 //err = "Protocol error: expected '$', got '%c'", c->querybuf[pos];
                 return -1;
             }
-
-            ok = string2ll(buffer.GetRawReadBuffer() + pos + 1, newline - (buffer.GetRawReadBuffer() + pos + 1), &ll);
-            if (!ok || ll < 0 || ll > 512 * 1024 * 1024)
+            ok = read_line_length(scanner, begin + pos + 1, end, ll, next);
+            if (ok == 0)
+            {
+                if (buffer.ReadableBytes() > REDIS_INLINE_MAX_SIZE)
+                {
+                    err = "Protocol error: too big bulk count string";
+                    return -1;
+                }
+                break;
+            }
+            if (ok < 0 || ll < 0 || ll > 512 * 1024 * 1024)
             {
                 err = "Protocol error: invalid bulk length";
                 return -1;
             }
 
-            pos += newline - (buffer.GetRawReadBuffer() + pos) + 2;
+            pos = next - begin;
             m_bulklen = ll;
         }
 
@@ -274,24 +429,6 @@ int RedisCommandDecoder::ProcessInlineBuffer(Buffer& buffer, RedisCommandFrame&
     return 1;
 }
 
-static inline int readBulkLen(Buffer& buffer, int& len)
-{
-    char *eptr = NULL;
-    const char* raw = buffer.GetRawReadBuffer();
-    int tmp = strtol(raw, &eptr, 10);
-    if ((eptr - raw) > (buffer.ReadableBytes() - 2))
-    {
-        return 0;
-    }
-    if (*eptr != '\r' || *(eptr + 1) != '\n')
-    {
-        return -1;
-    }
-    len = tmp;
-    buffer.AdvanceReadIndex(eptr - raw + 2);
-    return 1;
-}
-
 #define THROW_DECODE_EX(str)  do{\
         if (NULL != channel)\
         {\
@@ -307,8 +444,12 @@ int RedisCommandDecoder::ProcessMultibulkBuffer(Channel* channel, Buffer& buffer
     {
         return 0;
     }
-    int multibulklen = 0;
-    int read_len_ret = readBulkLen(buffer, multibulklen);
+    const char* begin = buffer.GetRawReadBuffer();
+    const char* end = begin + buffer.ReadableBytes();
+    CRScanner scanner(begin, end);
+    const char* p = begin;
+    int64_t multibulklen = 0;
+    int read_len_ret = read_line_length(scanner, p, end, multibulklen, p);
     if (read_len_ret == 0)
     {
         return 0;
@@ -323,27 +464,25 @@ int RedisCommandDecoder::ProcessMultibulkBuffer(Channel* channel, Buffer& buffer
         THROW_DECODE_EX("Protocol error: invalid multibulk length");
         return -1;
     }
-    int parsed_args = 0;
+    int64_t parsed_args = 0;
     while (parsed_args < multibulklen)
     {
-        if (buffer.ReadableBytes() < 4)  //at least '$0\r\n'
+        if (end - p < 4)  //at least '$0\r\n'
         {
             return 0;
         }
-        char expected = 0;
-        buffer.ReadByte(expected);
-        if (expected != '$')
+        if (*p != '$')
         {
             if (NULL != channel)
             {
                 char temp[100];
-                sprintf(temp, "Protocol error: expected '$', , got '%c'", buffer.GetRawReadBuffer()[0]);
+                sprintf(temp, "Protocol error: expected '$', , got '%c'", *p);
                 THROW_DECODE_EX(temp);
             }
             return -1;
         }
-        int arglen = 0;
-        read_len_ret = readBulkLen(buffer, arglen);
+        int64_t arglen = 0;
+        read_len_ret = read_line_length(scanner, p + 1, end, arglen, p);
         if (read_len_ret == 0)
         {
             return 0;
@@ -353,24 +492,27 @@ int RedisCommandDecoder::ProcessMultibulkBuffer(Channel* channel, Buffer& buffer
             THROW_DECODE_EX("Protocol error: expected CRLF at bulk length end");
             return -1;
         }
-        if (arglen > 512 * 1024 * 1024)
+        if (arglen < 0 || arglen > 512 * 1024 * 1024)
         {
             THROW_DECODE_EX("Protocol error: invalid bulk length");
             return -1;
         }
-        if (buffer.ReadableBytes() < (arglen + 2))
+        if (end - p < (arglen + 2))
         {
             return 0;
         }
-        if (buffer.GetRawReadBuffer()[arglen] != '\r' || buffer.GetRawReadBuffer()[arglen + 1] != '\n')
+        if (p[arglen] != '\r' || p[arglen + 1] != '\n')
         {
             THROW_DECODE_EX("Protocol error: expected CRLF at bulk end.");
             return -1;
         }
+        buffer.AdvanceReadIndex(p - buffer.GetRawReadBuffer());
         frame.FillNextArgument(buffer, arglen);
         buffer.AdvanceReadIndex(2);
+        p += arglen + 2;
         parsed_args++;
     }
+    buffer.AdvanceReadIndex(p - buffer.GetRawReadBuffer());
     return 1;
 }
 
@@ -30,6 +30,12 @@
 #include "redis_reply.hpp"
 #include "db/engine.hpp"
 
+/*
+ * Pooled replies keep string bodies and member arrays up to these sizes when they are recycled.
+ */
+#define REDIS_REPLY_MAX_RECYCLE_STR_SIZE 1024
+#define REDIS_REPLY_MAX_RECYCLE_MEMBERS 4096
+
 namespace ardb
 {
     namespace codec
@@ -55,27 +61,53 @@ namespace ardb
         {
             if (m_cursor >= elements.size())
             {
-                while (m_cursor - elements.size() >= pending.size())
+                if (m_cursor - elements.size() >= pending.size())
                 {
-                    RedisReply r;
-                    r.SetPool(this);
-                    pending.push_back(r);
+                    pending.push_back(RedisReply());
+                    pending.back().SetPool(this);
                 }
                 RedisReply& rr = pending[m_cursor - elements.size()];
                 m_cursor++;
                 return rr;
             }
-            RedisReply& r = elements[m_cursor++];
-            r.Clear();
-            return r;
+            return elements[m_cursor++];
+        }
+        void RedisReplyPool::Release(uint32 count)
+        {
+            while (count > 0 && m_cursor > 0)
+            {
+                m_cursor--;
+                if (m_cursor < elements.size())
+                {
+                    elements[m_cursor].Recycle();
+                }
+                else
+                {
+                    pending[m_cursor - elements.size()].Recycle();
+                }
+                count--;
+            }
         }
         void RedisReplyPool::Clear()
         {
-            m_cursor = 0;
-            if (!pending.empty())
+            uint32 fixed = m_cursor < elements.size() ? m_cursor : elements.size();
+            for (uint32 i = 0; i < fixed; i++)
             {
-                pending.clear();
+                elements[i].Recycle();
             }
+            if (m_cursor > elements.size())
+            {
+                uint32 used = m_cursor - elements.size();
+                if (pending.size() > m_max_size)
+                {
+                    pending.resize(m_max_size);
+                }
+                for (uint32 i = 0; i < used && i < pending.size(); i++)
+                {
+                    pending[i].Recycle();
+                }
+            }
+            m_cursor = 0;
         }
 
         void RedisReply::SetPool(RedisReplyPool* p)
@@ -105,7 +137,7 @@ namespace ardb
             type = REDIS_REPLY_ARRAY;
             if (NULL == elements)
             {
-                elements = new std::deque<RedisReply*>;
+                elements = new std::vector<RedisReply*>;
             }
             RedisReply* reply = NULL;
             if (NULL == pool)
@@ -122,7 +154,7 @@ namespace ardb
             }
             else
             {
-                elements->push_front(reply);
+                elements->insert(elements->begin(), reply);
             }
             return *reply;
         }
@@ -131,6 +163,14 @@ namespace ardb
             Clear();
             type = REDIS_REPLY_ARRAY;
             integer = num;
+            if (num > 0)
+            {
+                if (NULL == elements)
+                {
+                    elements = new std::vector<RedisReply*>;
+                }
+                elements->reserve(num);
+            }
             for (size_t i = 0; num > 0 && i < num; i++)
             {
                 AddMember();
@@ -148,20 +188,63 @@ namespace ardb
         {
             return *(elements->at(i));
         }
-        void RedisReply::Clear()
+        void RedisReply::ReleaseMembers()
         {
-            if (NULL == pool && NULL != elements)
+            if (NULL == elements)
             {
-                for (int i = 0; i < elements->size(); i++)
+                return;
+            }
+            if (NULL == pool)
+            {
+                for (size_t i = 0; i < elements->size(); i++)
                 {
                     DELETE(elements->at(i));
                 }
             }
-            DELETE(elements);
+            else
+            {
+                pool->Release(elements->size());
+            }
+            elements->clear();
+        }
+        void RedisReply::Clear()
+        {
+            if (NULL != elements)
+            {
+                if (NULL == pool)
+                {
+                    for (size_t i = 0; i < elements->size(); i++)
+                    {
+                        DELETE(elements->at(i));
+                    }
+                    DELETE(elements);
+                }
+                else
+                {
+                    //members are owned by the pool, keep the array for reuse
+                    elements->clear();
+                }
+            }
             type = REDIS_REPLY_NIL;
             integer = 0;
+            chunk_flag = 0;
+            streamed = 0;
             str.clear();
         }
+        void RedisReply::Recycle()
+        {
+            if (NULL != elements && elements->capacity() > REDIS_REPLY_MAX_RECYCLE_MEMBERS)
+            {
+                DELETE(elements);
+            }
+            if (str.capacity() > REDIS_REPLY_MAX_RECYCLE_STR_SIZE)
+            {
+                std::string empty;
+                str.swap(empty);
+            }
+            Clear();
+            disposable = false;
+        }
         const std::string& RedisReply::Error()
         {
             if (str.empty())
@@ -181,6 +264,7 @@ namespace ardb
         RedisReply::~RedisReply()
         {
             Clear();
+            DELETE(elements);
         }
 
         void clone_redis_reply(RedisReply& src, RedisReply& dst)
@@ -362,6 +446,31 @@ namespace ardb
                     str.assign("WRONGTYPE Key is not a valid HyperLogLog string value.");
                     break;
                 }
+                case ERR_INVALID_BLOOM_FILTER:
+                {
+                    str.assign("WRONGTYPE Key is not a valid bloom filter.");
+                    break;
+                }
+                case ERR_INVALID_TIMESERIES:
+                {
+                    str.assign("WRONGTYPE Key is not a valid time series.");
+                    break;
+                }
+                case ERR_INVALID_STREAM:
+                {
+                    str.assign("WRONGTYPE Key is not a valid stream.");
+                    break;
+                }
+                case ERR_INVALID_SKETCH:
+                {
+                    str.assign("WRONGTYPE Key is not a valid sketch.");
+                    break;
+                }
+                case ERR_INVALID_VECTOR_SET:
+                {
+                    str.assign("WRONGTYPE Key is not a valid vector set.");
+                    break;
+                }
                 default:
                 {
                     str = g_engine->GetErrorReason(code);
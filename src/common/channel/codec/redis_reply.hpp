@@ -46,6 +46,9 @@
 
 #define FIRST_CHUNK_FLAG  0x01
 #define LAST_CHUNK_FLAG  0x02
+#define STREAM_CHUNK_FLAG  0x04   //array reply sent to client in chunks while its members are generated
+#define DISCARD_CHUNK_FLAG  0x08  //members of a streamed reply are dropped since the client is gone
+#define NOWAIT_CHUNK_FLAG  0x10   //a streamed reply no longer waits for the client to read
 
 #define STORAGE_ENGINE_ERR_OFFSET -100000
 
@@ -81,6 +84,11 @@ namespace ardb
             ERR_KEY_EXIST = -1021,
             ERR_WRONG_TYPE = -1022,
             ERR_OUTOFRANGE = -1023,
+            ERR_INVALID_BLOOM_FILTER = -1024,
+            ERR_INVALID_TIMESERIES = -1025,
+            ERR_INVALID_STREAM = -1026,
+            ERR_INVALID_SKETCH = -1027,
+            ERR_INVALID_VECTOR_SET = -1028,
         };
 
         enum StatusCode
@@ -114,6 +122,11 @@ namespace ardb
 
             public:
                 int type;
+                /*
+                 * Set if the reply is dropped once it's written, then the encoder may move its large strings
+                 * to the channel output instead of copying them, it's reset after the reply is encoded.
+                 */
+                bool disposable;
                 std::string str;
 
                 /*
@@ -121,23 +134,29 @@ namespace ardb
                  * the integer value also used to identify chunk state.
                  */
                 int64_t integer;
-                std::deque<RedisReply*>* elements;
+                /*
+                 * Chunk state of a streamed array reply, 'integer' is the member count of the whole array then,
+                 * and 'streamed' is the count of members already sent in previous chunks.
+                 */
+                uint32 chunk_flag;
+                int64_t streamed;
+                std::vector<RedisReply*>* elements;
 
                 RedisReplyPool* pool;  //use object pool if reply is array with hundreds of elements
                 RedisReply() :
-                        type(REDIS_REPLY_NIL), integer(0), elements(NULL), pool(NULL)
+                        type(REDIS_REPLY_NIL), disposable(false), integer(0), chunk_flag(0), streamed(0), elements(NULL), pool(NULL)
                 {
                 }
                 RedisReply(uint64 v) :
-                        type(REDIS_REPLY_INTEGER), integer(v), elements(NULL), pool(NULL)
+                        type(REDIS_REPLY_INTEGER), disposable(false), integer(v), chunk_flag(0), streamed(0), elements(NULL), pool(NULL)
                 {
                 }
                 RedisReply(double v) :
-                        type(REDIS_REPLY_DOUBLE), integer(0), elements(NULL), pool(NULL)
+                        type(REDIS_REPLY_DOUBLE), disposable(false), integer(0), chunk_flag(0), streamed(0), elements(NULL), pool(NULL)
                 {
                 }
                 RedisReply(const std::string& v) :
-                        type(REDIS_REPLY_STRING), str(v), integer(0), elements(NULL), pool(NULL)
+                        type(REDIS_REPLY_STRING), disposable(false), str(v), integer(0), chunk_flag(0), streamed(0), elements(NULL), pool(NULL)
                 {
                 }
                 bool IsErr() const
@@ -226,7 +245,15 @@ namespace ardb
                 void ReserveMember(int64_t num);
                 size_t MemberSize();
                 RedisReply& MemberAt(uint32 i);
+                /*
+                 * Drop all members, the members of a pooled reply must be the last nodes allocated from the pool.
+                 */
+                void ReleaseMembers();
                 void Clear();
+                /*
+                 * Clear a pooled reply for reuse, keeps its string body and member array unless they are large.
+                 */
+                void Recycle();
                 void Clone(const RedisReply& r)
                 {
                     Clear();
@@ -246,6 +273,11 @@ namespace ardb
         };
 
 
+        /*
+         * Arena of the reply nodes of one command, every reply and member allocated for the command
+         * is taken from it and they are all recycled at once by Clear after the reply is encoded.
+         * Nodes beyond 'max_size' are kept for later commands too, up to another 'max_size' nodes.
+         */
         class RedisReplyPool
         {
             private:
@@ -257,6 +289,10 @@ namespace ardb
                 RedisReplyPool(uint32 size = 5);
                 void SetMaxSize(uint32 size);
                 RedisReply& Allocate();
+                /*
+                 * Recycle the last 'count' allocated nodes.
+                 */
+                void Release(uint32 count);
                 void Clear();
         };
 
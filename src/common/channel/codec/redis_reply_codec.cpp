@@ -37,7 +37,49 @@ using ardb::BufferHelper;
 using namespace ardb::codec;
 using namespace ardb;
 
-bool RedisReplyEncoder::Encode(Buffer& buf, RedisReply& reply)
+/*
+ * Bulk strings at least this large are moved to the channel as separate output chunks & sent by writev,
+ * instead of being copied into the output buffer.
+ */
+#define REDIS_REPLY_CHUNK_MIN_SIZE  (64*1024)
+
+static bool encode_reply(Buffer& buf, RedisReply& reply, Channel* chunk_channel);
+
+/*
+ * Encode the members of a streamed array reply added since the previous chunk, the header carrying the count
+ * of the whole array goes with the first chunk. The last chunk pads the array with nils if less members than
+ * declared are generated, members beyond the declared count are dropped.
+ */
+static bool encode_stream_chunk(Buffer& buf, RedisReply& reply, Channel* chunk_channel, bool last)
+{
+    if (reply.chunk_flag & FIRST_CHUNK_FLAG)
+    {
+        buf.Printf("*%lld\r\n", reply.integer);
+        reply.chunk_flag &= ~FIRST_CHUNK_FLAG;
+    }
+    size_t members = reply.MemberSize();
+    int64 generated = reply.streamed + (int64) members;
+    for (size_t i = 0; i < members && reply.streamed < reply.integer; i++)
+    {
+        if (!encode_reply(buf, reply.MemberAt(i), chunk_channel))
+        {
+            return false;
+        }
+        reply.streamed++;
+    }
+    if (last && generated != reply.integer)
+    {
+        WARN_LOG("Streamed array reply generated %lld members while %lld are declared.", generated, reply.integer);
+        while (reply.streamed < reply.integer)
+        {
+            buf.Printf("$-1\r\n");
+            reply.streamed++;
+        }
+    }
+    return true;
+}
+
+static bool encode_reply(Buffer& buf, RedisReply& reply, Channel* chunk_channel)
 {
     switch (reply.type)
     {
@@ -49,7 +91,12 @@ bool RedisReplyEncoder::Encode(Buffer& buf, RedisReply& reply)
         case REDIS_REPLY_STRING:
         {
             buf.Printf("$%d\r\n", reply.str.size());
-            if (reply.str.size() > 0)
+            if (NULL != chunk_channel && reply.str.size() >= REDIS_REPLY_CHUNK_MIN_SIZE)
+            {
+                chunk_channel->WriteChunk(reply.str);
+                buf.Printf("\r\n");
+            }
+            else if (reply.str.size() > 0)
             {
                 //buf.Printf("%s\r\n", reply.str.c_str());
                 buf.Write(reply.str.data(), reply.str.size());
@@ -89,6 +136,10 @@ bool RedisReplyEncoder::Encode(Buffer& buf, RedisReply& reply)
         }
         case REDIS_REPLY_ARRAY:
         {
+            if (reply.chunk_flag & STREAM_CHUNK_FLAG)
+            {
+                return encode_stream_chunk(buf, reply, chunk_channel, true);
+            }
             if(reply.integer < 0)
             {
                 buf.Printf("*-1\r\n");
@@ -100,10 +151,10 @@ bool RedisReplyEncoder::Encode(Buffer& buf, RedisReply& reply)
                 break;
             }
             buf.Printf("*%d\r\n", reply.elements->size());
-            std::deque<RedisReply*>::iterator it = reply.elements->begin();
+            std::vector<RedisReply*>::iterator it = reply.elements->begin();
             while (it != reply.elements->end())
             {
-                if (!RedisReplyEncoder::Encode(buf, *(*it)))
+                if (!encode_reply(buf, *(*it), chunk_channel))
                 {
                     return false;
                 }
@@ -125,10 +176,28 @@ bool RedisReplyEncoder::Encode(Buffer& buf, RedisReply& reply)
     return true;
 }
 
+bool RedisReplyEncoder::Encode(Buffer& buf, RedisReply& reply)
+{
+    return encode_reply(buf, reply, NULL);
+}
+
+bool RedisReplyEncoder::WriteStreamChunk(Channel* ch, RedisReply& reply)
+{
+    if (!encode_stream_chunk(ch->GetOutputBuffer(), reply, ch, false))
+    {
+        return false;
+    }
+    reply.ReleaseMembers();
+    ch->EnableWriting();
+    return true;
+}
+
 bool RedisReplyEncoder::WriteRequested(ChannelHandlerContext& ctx, MessageEvent<RedisReply>& e)
 {
     RedisReply* msg = e.GetMessage();
-    if (Encode(ctx.GetChannel()->GetOutputBuffer(), *msg))
+    Channel* chunk_channel = msg->disposable ? ctx.GetChannel() : NULL;
+    msg->disposable = false;
+    if (encode_reply(ctx.GetChannel()->GetOutputBuffer(), *msg, chunk_channel))
     {
         ctx.GetChannel()->EnableWriting();
         return true;
@@ -251,8 +320,36 @@ bool RedisReplyDecoder::Decode(ChannelHandlerContext& ctx, Channel* channel, Buf
     return ret > 0;
 }
 
+bool RedisDumpFileChunkDecoder::DecodeEOFChunk(Buffer& buffer, RedisDumpFileChunk& msg)
+{
+    msg.len = -1;
+    int mark_index = buffer.IndexOf(m_eof_mark.data(), m_eof_mark.size());
+    if (mark_index >= 0)
+    {
+        msg.chunk.assign(buffer.GetRawReadBuffer(), mark_index - buffer.GetReadIndex());
+        buffer.SetReadIndex(mark_index + m_eof_mark.size());
+        msg.flag = msg.flag | LAST_CHUNK_FLAG;
+        m_eof_mark.clear();
+        return true;
+    }
+    /*
+     * keep the tail which may be the beginning of the mark
+     */
+    if (buffer.ReadableBytes() >= m_eof_mark.size())
+    {
+        size_t chunklen = buffer.ReadableBytes() - m_eof_mark.size() + 1;
+        msg.chunk.assign(buffer.GetRawReadBuffer(), chunklen);
+        buffer.SkipBytes(chunklen);
+    }
+    return msg.IsFirstChunk() || !msg.chunk.empty();
+}
+
 bool RedisDumpFileChunkDecoder::Decode(ChannelHandlerContext& ctx, Channel* channel, Buffer& buffer, RedisDumpFileChunk& msg)
 {
+    if (!m_eof_mark.empty())
+    {
+        return DecodeEOFChunk(buffer, msg);
+    }
     if (m_waiting_chunk_len == 0)
     {
         while (buffer.GetRawReadBuffer()[0] == '\n')
@@ -271,6 +368,13 @@ bool RedisDumpFileChunkDecoder::Decode(ChannelHandlerContext& ctx, Channel* chan
         {
             ERROR_LOG("Unexpected char '%c' for receiving redis dump file.", type);
         }
+        if (crlf_index - buffer.GetReadIndex() > 4 && !strncmp(buffer.GetRawReadBuffer(), "EOF:", 4))
+        {
+            m_eof_mark.assign(buffer.GetRawReadBuffer() + 4, crlf_index - buffer.GetReadIndex() - 4);
+            buffer.SetReadIndex(crlf_index + 2);
+            msg.flag = msg.flag | FIRST_CHUNK_FLAG;
+            return DecodeEOFChunk(buffer, msg);
+        }
         if (!raw_toint64(buffer.GetRawReadBuffer(), crlf_index - buffer.GetReadIndex(), msg.len))
         {
             return -1;
@@ -53,7 +53,12 @@ namespace ardb
 			protected:
 				int64 m_waiting_chunk_len;
 				int64 m_all_chunk_len;
+				/*
+				 * a dump streamed without known length starts with '$EOF:<mark>\r\n' and ends with the mark
+				 */
+				std::string m_eof_mark;
 				bool Decode(ChannelHandlerContext& ctx, Channel* channel, Buffer& buffer, RedisDumpFileChunk& msg);
+				bool DecodeEOFChunk(Buffer& buffer, RedisDumpFileChunk& msg);
 				friend class RedisMessageDecoder;
 				RedisDumpFileChunkDecoder() :m_waiting_chunk_len(0),m_all_chunk_len(0)
 				{
@@ -67,6 +72,11 @@ namespace ardb
 				bool WriteRequested(ChannelHandlerContext& ctx, MessageEvent<RedisReply>& e);
 			public:
 				static bool Encode(Buffer& buf, RedisReply& reply);
+				/*
+				 * Write the members generated so far of a streamed array reply to the channel & drop them,
+				 * the rest members are written with the reply itself.
+				 */
+				static bool WriteStreamChunk(Channel* ch, RedisReply& reply);
 		};
 
 		class NullRedisReplyEncoder: public ChannelDownstreamHandler<RedisReply>
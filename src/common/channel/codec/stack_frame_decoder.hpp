@@ -137,6 +137,7 @@ namespace ardb
 			public:
 				StackFrameDecoder()
 				{
+					m_cumulation.SetUsePool(true);
 				}
 				void Clear()
 				{
@@ -152,6 +153,10 @@ namespace ardb
 						m_cumulation.DiscardReadedBytes();
 						m_cumulation.Write(input, input->ReadableBytes());
 						CallDecode(ctx, e.GetChannel(), m_cumulation);
+						if (!m_cumulation.Readable())
+						{
+							m_cumulation.Release();
+						}
 					} else
 					{
 						CallDecode(ctx, e.GetChannel(), *input);
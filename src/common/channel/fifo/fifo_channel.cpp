@@ -88,6 +88,19 @@ bool PipeChannel::DoClose()
 	//fireChannelClosed(this);
 	return true;
 }
+/*
+ * the write end closed by the peer
+ */
+int32 PipeChannel::HandleExceptionEvent(int32 event)
+{
+	if (event & CHANNEL_EVENT_EOF)
+	{
+		Close();
+		return -1;
+	}
+	return 0;
+}
+
 int PipeChannel::GetWriteFD()
 {
 	return m_write_fd;
@@ -45,6 +45,7 @@ namespace ardb
 			bool DoClose();
 			int GetWriteFD();
 			int GetReadFD();
+			int32 HandleExceptionEvent(int32 event);
 		public:
 			PipeChannel(ChannelService& factory, int readFd = -1, int writeFd = -1);
 			virtual ~PipeChannel();
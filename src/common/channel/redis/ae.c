@@ -35,6 +35,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "ae.h"
@@ -43,7 +44,11 @@
 /* Include the best multiplexing layer supported by this system.
  * The following should be ordered by performances, descending. */
 #ifdef HAVE_EPOLL
+#ifdef HAVE_IO_URING
+#include "ae_io_uring.cc" /* io_uring, with epoll as fallback */
+#else
 #include "ae_epoll.cc"
+#endif
 #else
 #ifdef HAVE_KQUEUE
 #include "ae_kqueue.cc"
@@ -81,6 +86,8 @@ aeEventLoop *aeCreateEventLoop(int setsize)
 	eventLoop->stop = 0;
 	eventLoop->maxfd = -1;
 	eventLoop->beforesleep = NULL;
+	eventLoop->privdata = NULL;
+	eventLoop->api = 0;
     if (aeApiCreate(eventLoop) == -1) goto err;
 
 	/* Events with mask == AE_NONE are not set. So let's initialize the
@@ -491,6 +498,15 @@ char *aeGetApiName(void)
 	return aeApiName();
 }
 
+int aeSetApi(const char *name)
+{
+#ifdef HAVE_IO_URING
+	return aeApiSelect(name) == 0 ? AE_OK : AE_ERR;
+#else
+	return strcmp(name, aeApiName()) == 0 ? AE_OK : AE_ERR;
+#endif
+}
+
 void aeSetBeforeSleepProc(aeEventLoop *eventLoop,
         aeBeforeSleepProc *beforesleep)
 {
@@ -38,6 +38,11 @@ extern "C" {
 
 #ifdef __linux__
 #define HAVE_EPOLL 1
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAVE_IO_URING 1
+#endif
+#endif
 #endif
 
 #if (defined(__APPLE__) && defined(MAC_OS_X_VERSION_10_6)) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined (__NetBSD__)
@@ -106,7 +111,9 @@ typedef struct aeEventLoop {
     aeTimeEvent *timeEventHead;
     int stop;
     void *apidata; /* This is used for polling API specific data */
+    int api; /* polling API serving this loop when several are compiled in */
     aeBeforeSleepProc *beforesleep;
+    void *privdata; /* owner of the loop, for beforesleep */
 } aeEventLoop;
 
 /* Prototypes */
@@ -129,6 +136,8 @@ int aeProcessEvents(aeEventLoop *eventLoop, int flags);
 int aeWait(int fd, int mask, long long milliseconds);
 void aeMain(aeEventLoop *eventLoop);
 char *aeGetApiName(void);
+/* Select the polling API ("epoll" or "io_uring") of the event loops created afterwards */
+int aeSetApi(const char *name);
 void aeSetBeforeSleepProc(aeEventLoop *eventLoop, aeBeforeSleepProc *beforesleep);
 
 #ifdef __cplusplus
@@ -0,0 +1,419 @@
+/* Released under the BSD license. See the COPYING file for more info. */
+
+/*
+ * io_uring polling layer.
+ * File events are armed as one-shot IORING_OP_POLL_ADD requests. Arming, re-arming
+ * after a fire and mask changes are only queued in the submission ring, and all of
+ * them are submitted by the same io_uring_enter call that waits for completions, so
+ * an iteration of the event loop costs one syscall instead of one epoll_ctl per
+ * mask change plus epoll_wait.
+ * The epoll layer is compiled in too, it serves the loops when io_uring is not
+ * selected or the ring can not be set up.
+ */
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+
+#define aeApiState aeEpollState
+#define aeApiCreate aeEpollCreate
+#define aeApiFree aeEpollFree
+#define aeApiAddEvent aeEpollAddEvent
+#define aeApiDelEvent aeEpollDelEvent
+#define aeApiPoll aeEpollPoll
+#define aeApiName aeEpollName
+#include "ae_epoll.cc"
+#undef aeApiState
+#undef aeApiCreate
+#undef aeApiFree
+#undef aeApiAddEvent
+#undef aeApiDelEvent
+#undef aeApiPoll
+#undef aeApiName
+
+#define AE_API_EPOLL 0
+#define AE_API_IO_URING 1
+
+#define AE_URING_ENTRIES 4096
+#define AE_URING_REMOVE_DATA 0xFFFFFFFFFFFFFFFFULL /* user data of poll remove requests */
+
+static int aePreferredApi = AE_API_EPOLL;
+static int aeUringFallbacks = 0; /* event loops served by epoll since their ring could not be set up */
+
+typedef struct aeUringState {
+    int ringfd;
+    unsigned *sqhead;
+    unsigned *sqtail;
+    unsigned sqmask;
+    unsigned sqentries;
+    unsigned sqlocaltail; /* tail of the queued entries, published on submit */
+    struct io_uring_sqe *sqes;
+    unsigned *cqhead;
+    unsigned *cqtail;
+    unsigned cqmask;
+    struct io_uring_cqe *cqes;
+    void *sqring;
+    size_t sqringsize;
+    void *cqring;
+    size_t cqringsize;
+    size_t sqessize;
+    unsigned *gen;          /* per fd, generation of the poll request in flight */
+    unsigned char *armed;   /* per fd, mask of the poll request in flight */
+    unsigned char *dirty;   /* per fd, set when queued for synchronization */
+    int *dirtyfds;
+    int ndirty;
+} aeUringState;
+
+static int aeUringSetup(unsigned entries, struct io_uring_params *p)
+{
+    memset(p, 0, sizeof(*p));
+    return (int) syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int aeUringEnter(int ringfd, unsigned tosubmit, unsigned mincomplete, unsigned flags, void *arg, size_t argsize)
+{
+    return (int) syscall(__NR_io_uring_enter, ringfd, tosubmit, mincomplete, flags, arg, argsize);
+}
+
+static void aeUringUnmap(aeUringState *state)
+{
+    if (state->sqes != NULL && state->sqes != MAP_FAILED)
+        munmap(state->sqes, state->sqessize);
+    if (state->cqring != NULL && state->cqring != MAP_FAILED && state->cqring != state->sqring)
+        munmap(state->cqring, state->cqringsize);
+    if (state->sqring != NULL && state->sqring != MAP_FAILED)
+        munmap(state->sqring, state->sqringsize);
+}
+
+static void aeUringFreeState(aeUringState *state)
+{
+    aeUringUnmap(state);
+    if (state->ringfd >= 0)
+        close(state->ringfd);
+    zfree(state->gen);
+    zfree(state->armed);
+    zfree(state->dirty);
+    zfree(state->dirtyfds);
+    zfree(state);
+}
+
+static int aeUringCreate(aeEventLoop *eventLoop)
+{
+    struct io_uring_params p;
+    aeUringState *state = zmalloc(sizeof(aeUringState));
+    unsigned i, *sqarray;
+
+    if (!state) return -1;
+    memset(state, 0, sizeof(*state));
+    state->ringfd = aeUringSetup(AE_URING_ENTRIES, &p);
+    if (state->ringfd < 0) goto err;
+    /* timed waits need IORING_ENTER_EXT_ARG, and completions must not be dropped
+     * since every fired poll has to be re-armed */
+    if (!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP)) goto err;
+
+    state->sqringsize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    state->cqringsize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (state->cqringsize > state->sqringsize)
+            state->sqringsize = state->cqringsize;
+        state->cqringsize = state->sqringsize;
+    }
+    state->sqring = mmap(NULL, state->sqringsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            state->ringfd, IORING_OFF_SQ_RING);
+    if (state->sqring == MAP_FAILED) goto err;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        state->cqring = state->sqring;
+    } else {
+        state->cqring = mmap(NULL, state->cqringsize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                state->ringfd, IORING_OFF_CQ_RING);
+        if (state->cqring == MAP_FAILED) goto err;
+    }
+    state->sqessize = p.sq_entries * sizeof(struct io_uring_sqe);
+    state->sqes = mmap(NULL, state->sqessize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            state->ringfd, IORING_OFF_SQES);
+    if (state->sqes == MAP_FAILED) goto err;
+
+    state->sqhead = (unsigned *) ((char *) state->sqring + p.sq_off.head);
+    state->sqtail = (unsigned *) ((char *) state->sqring + p.sq_off.tail);
+    state->sqmask = *(unsigned *) ((char *) state->sqring + p.sq_off.ring_mask);
+    state->sqentries = p.sq_entries;
+    state->sqlocaltail = *state->sqtail;
+    sqarray = (unsigned *) ((char *) state->sqring + p.sq_off.array);
+    for (i = 0; i < p.sq_entries; i++)
+        sqarray[i] = i;
+    state->cqhead = (unsigned *) ((char *) state->cqring + p.cq_off.head);
+    state->cqtail = (unsigned *) ((char *) state->cqring + p.cq_off.tail);
+    state->cqmask = *(unsigned *) ((char *) state->cqring + p.cq_off.ring_mask);
+    state->cqes = (struct io_uring_cqe *) ((char *) state->cqring + p.cq_off.cqes);
+
+    state->gen = zmalloc(sizeof(unsigned) * eventLoop->setsize);
+    state->armed = zmalloc(eventLoop->setsize);
+    state->dirty = zmalloc(eventLoop->setsize);
+    state->dirtyfds = zmalloc(sizeof(int) * eventLoop->setsize);
+    if (!state->gen || !state->armed || !state->dirty || !state->dirtyfds) goto err;
+    memset(state->gen, 0, sizeof(unsigned) * eventLoop->setsize);
+    memset(state->armed, 0, eventLoop->setsize);
+    memset(state->dirty, 0, eventLoop->setsize);
+    eventLoop->apidata = state;
+    return 0;
+
+err:
+    aeUringFreeState(state);
+    return -1;
+}
+
+static unsigned aeUringQueued(aeUringState *state)
+{
+    return state->sqlocaltail - __atomic_load_n(state->sqhead, __ATOMIC_ACQUIRE);
+}
+
+static void aeUringPublish(aeUringState *state)
+{
+    __atomic_store_n(state->sqtail, state->sqlocaltail, __ATOMIC_RELEASE);
+}
+
+static struct io_uring_sqe *aeUringGetSqe(aeUringState *state)
+{
+    struct io_uring_sqe *sqe;
+
+    if (aeUringQueued(state) >= state->sqentries) {
+        /* the ring is full of pending requests, hand them to the kernel now */
+        aeUringPublish(state);
+        aeUringEnter(state->ringfd, aeUringQueued(state), 0, 0, NULL, 0);
+        if (aeUringQueued(state) >= state->sqentries)
+            return NULL;
+    }
+    sqe = &state->sqes[state->sqlocaltail & state->sqmask];
+    memset(sqe, 0, sizeof(*sqe));
+    state->sqlocaltail++;
+    return sqe;
+}
+
+static void aeUringMarkDirty(aeUringState *state, int fd)
+{
+    if (!state->dirty[fd]) {
+        state->dirty[fd] = 1;
+        state->dirtyfds[state->ndirty++] = fd;
+    }
+}
+
+/* Queue the removal of the poll request in flight for fd, its completions are stale from now on.
+ * Returns -1 if the ring is full. */
+static int aeUringQueueRemove(aeUringState *state, int fd)
+{
+    struct io_uring_sqe *sqe;
+
+    if ((sqe = aeUringGetSqe(state)) == NULL)
+        return -1;
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = ((uint64_t) state->gen[fd] << 32) | (unsigned) fd;
+    sqe->user_data = AE_URING_REMOVE_DATA;
+    state->gen[fd]++;
+    state->armed[fd] = AE_NONE;
+    return 0;
+}
+
+/* Queue the poll requests making the kernel side match the registered masks. */
+static void aeUringSync(aeEventLoop *eventLoop, aeUringState *state)
+{
+    int i, kept = 0;
+
+    for (i = 0; i < state->ndirty; i++) {
+        int fd = state->dirtyfds[i];
+        int mask = eventLoop->events[fd].mask;
+        struct io_uring_sqe *sqe;
+        unsigned events = 0;
+
+        if (state->armed[fd] == mask) {
+            state->dirty[fd] = 0;
+            continue;
+        }
+        if (state->armed[fd] != AE_NONE && aeUringQueueRemove(state, fd) < 0) {
+            state->dirtyfds[kept++] = fd;
+            continue;
+        }
+        if (mask != AE_NONE) {
+            if ((sqe = aeUringGetSqe(state)) == NULL) {
+                state->dirtyfds[kept++] = fd;
+                continue;
+            }
+            if (mask & AE_READABLE)
+                events |= POLLIN;
+            if (mask & AE_WRITABLE)
+                events |= POLLOUT;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            events = (events << 16) | (events >> 16);
+#endif
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = fd;
+            sqe->poll32_events = events;
+            sqe->user_data = ((uint64_t) state->gen[fd] << 32) | (unsigned) fd;
+            state->armed[fd] = mask;
+        }
+        state->dirty[fd] = 0;
+    }
+    state->ndirty = kept;
+}
+
+static void aeUringFree(aeEventLoop *eventLoop)
+{
+    aeUringFreeState(eventLoop->apidata);
+}
+
+static int aeUringAddEvent(aeEventLoop *eventLoop, int fd, int mask)
+{
+    aeUringState *state = eventLoop->apidata;
+
+    if ((eventLoop->events[fd].mask | mask) != eventLoop->events[fd].mask)
+        aeUringMarkDirty(state, fd);
+    return 0;
+}
+
+/* Called once the mask of fd is updated. A fd left without events is usually closed next, and its
+ * number may be reused by a new file before the next poll, so the request polling the old file is
+ * removed at once instead of on the next synchronization, which would find the reused fd armed. */
+static void aeUringDelEvent(aeEventLoop *eventLoop, int fd, int delmask)
+{
+    aeUringState *state = eventLoop->apidata;
+
+    AE_NOTUSED(delmask);
+    if (eventLoop->events[fd].mask == AE_NONE && state->armed[fd] != AE_NONE
+            && aeUringQueueRemove(state, fd) == 0)
+        return;
+    aeUringMarkDirty(state, fd);
+}
+
+static int aeUringPoll(aeEventLoop *eventLoop, struct timeval *tvp)
+{
+    aeUringState *state = eventLoop->apidata;
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    unsigned head, tail, mincomplete = 1;
+    int numevents = 0;
+
+    aeUringSync(eventLoop, state);
+    aeUringPublish(state);
+    memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    if (tvp != NULL) {
+        ts.tv_sec = tvp->tv_sec;
+        ts.tv_nsec = tvp->tv_usec * 1000;
+        arg.ts = (uint64_t) (uintptr_t) &ts;
+        if (tvp->tv_sec == 0 && tvp->tv_usec == 0)
+            mincomplete = 0;
+    }
+    /* ETIME and EINTR just mean nothing completed, completions are reaped below anyway */
+    aeUringEnter(state->ringfd, aeUringQueued(state), mincomplete, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+            &arg, sizeof(arg));
+
+    head = *state->cqhead;
+    tail = __atomic_load_n(state->cqtail, __ATOMIC_ACQUIRE);
+    while (head != tail && numevents < eventLoop->setsize) {
+        struct io_uring_cqe *cqe = &state->cqes[head & state->cqmask];
+        uint64_t data = cqe->user_data;
+        int res = cqe->res;
+        int fd, mask = 0;
+
+        head++;
+        if (data == AE_URING_REMOVE_DATA)
+            continue;
+        fd = (int) (data & 0xFFFFFFFF);
+        if (fd >= eventLoop->setsize || state->armed[fd] == AE_NONE || state->gen[fd] != (unsigned) (data >> 32))
+            continue;
+        if (res < 0 || (res & (POLLERR | POLLHUP | POLLNVAL))) {
+            mask = AE_READABLE | AE_WRITABLE;
+        } else {
+            if (res & POLLIN)
+                mask |= AE_READABLE;
+            if (res & POLLOUT)
+                mask |= AE_WRITABLE;
+        }
+        /* one-shot poll, arm it again on the next iteration if still registered */
+        state->armed[fd] = AE_NONE;
+        state->gen[fd]++;
+        aeUringMarkDirty(state, fd);
+        eventLoop->fired[numevents].fd = fd;
+        eventLoop->fired[numevents].mask = mask;
+        numevents++;
+    }
+    __atomic_store_n(state->cqhead, head, __ATOMIC_RELEASE);
+    return numevents;
+}
+
+/* Polling api dispatch, every event loop keeps the api it has been created with. */
+static int aeApiCreate(aeEventLoop *eventLoop)
+{
+    if (aePreferredApi == AE_API_IO_URING && aeUringCreate(eventLoop) == 0) {
+        eventLoop->api = AE_API_IO_URING;
+        return 0;
+    }
+    if (aePreferredApi == AE_API_IO_URING)
+        __atomic_add_fetch(&aeUringFallbacks, 1, __ATOMIC_RELAXED);
+    eventLoop->api = AE_API_EPOLL;
+    return aeEpollCreate(eventLoop);
+}
+
+static void aeApiFree(aeEventLoop *eventLoop)
+{
+    if (eventLoop->api == AE_API_IO_URING)
+        aeUringFree(eventLoop);
+    else
+        aeEpollFree(eventLoop);
+}
+
+static int aeApiAddEvent(aeEventLoop *eventLoop, int fd, int mask)
+{
+    if (eventLoop->api == AE_API_IO_URING)
+        return aeUringAddEvent(eventLoop, fd, mask);
+    return aeEpollAddEvent(eventLoop, fd, mask);
+}
+
+static void aeApiDelEvent(aeEventLoop *eventLoop, int fd, int delmask)
+{
+    if (eventLoop->api == AE_API_IO_URING)
+        aeUringDelEvent(eventLoop, fd, delmask);
+    else
+        aeEpollDelEvent(eventLoop, fd, delmask);
+}
+
+static int aeApiPoll(aeEventLoop *eventLoop, struct timeval *tvp)
+{
+    if (eventLoop->api == AE_API_IO_URING)
+        return aeUringPoll(eventLoop, tvp);
+    return aeEpollPoll(eventLoop, tvp);
+}
+
+/* io_uring is only reported while no event loop fell back to epoll. */
+static char *aeApiName(void)
+{
+    if (aePreferredApi == AE_API_IO_URING && __atomic_load_n(&aeUringFallbacks, __ATOMIC_RELAXED) == 0)
+        return "io_uring";
+    return aeEpollName();
+}
+
+static int aeApiSelect(const char *name)
+{
+    struct io_uring_params p;
+    int fd;
+
+    if (!strcmp(name, "epoll")) {
+        aePreferredApi = AE_API_EPOLL;
+        return 0;
+    }
+    if (strcmp(name, "io_uring"))
+        return -1;
+    fd = aeUringSetup(2, &p);
+    if (fd < 0)
+        return -1;
+    close(fd);
+    if (!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP))
+        return -1;
+    aePreferredApi = AE_API_IO_URING;
+    return 0;
+}
@@ -38,7 +38,7 @@
 using namespace ardb;
 
 ServerSocketChannel::ServerSocketChannel(ChannelService& factory) :
-        SocketChannel(factory), m_connected_socks(0), m_pool_min(0), m_pool_max(0)
+        SocketChannel(factory), m_connected_socks(0), m_pool_min(0), m_pool_max(0), m_reuse_port(false)
 {
 }
 
@@ -129,6 +129,20 @@ bool ServerSocketChannel::DoBind(Address* local)
             WARN_LOG("Failed to set SO_REUSEADDR for socket.");
         }
     }
+    if (m_reuse_port && !addr.IsUnix())
+    {
+#ifdef SO_REUSEPORT
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &flag, sizeof(flag)) != 0)
+        {
+            int e = errno;
+            ERROR_LOG("Failed to set SO_REUSEPORT for socket:%s", strerror(e));
+            ::close(fd);
+            return false;
+        }
+#else
+        WARN_LOG("SO_REUSEPORT is not supported on this platform.");
+#endif
+    }
     //setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, (void*) &on, sizeof(on));
     if (::bind(fd, (struct sockaddr*) &(addr.GetRawSockAddr()), addr.GetRawSockAddrSize()) == -1)
     {
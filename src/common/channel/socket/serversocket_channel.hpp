@@ -43,6 +43,7 @@ namespace ardb
 			uint32 m_pool_min;
 			uint32 m_pool_max;
 			std::string m_adress_str;
+			bool m_reuse_port;
 			bool DoBind(Address* local);
 			bool DoConnect(Address* remote);
 			bool DoConfigure(const ChannelOptions& options);
@@ -53,6 +54,13 @@ namespace ardb
 			ServerSocketChannel(ChannelService& factory);
 			uint32 ConnectedSockets();
 			void BindThreadPool(uint32 min, uint32 max);
+			/*
+			 * Must be set before Bind, lets several listeners share one tcp address.
+			 */
+			void SetReusePort(bool on)
+			{
+			    m_reuse_port = on;
+			}
 			const std::string& GetStringAddress()
 			{
 			    return m_adress_str;
@@ -39,20 +39,12 @@ Timer::Timer()
 
 }
 
-TimerTask* Timer::GetNearestTimerTask()
-{
-	return m_task_queue.GetMin();
-}
-
+/*
+ * A lower bound of the nearest trigger time, the wheel only knows the slot of the nearest tasks
+ */
 int64 Timer::GetNearestTaskTriggerTime()
-
 {
-	TimerTask* task = GetNearestTimerTask();
-	if (NULL != task)
-	{
-		return task->m_nextTriggerTime;
-	}
-	return -1;
+	return m_wheel.GetNextAdvanceTime();
 }
 
 uint32 Timer::GenerateTimerTaskID()
@@ -80,7 +72,7 @@ void Timer::DoFinalSchedule(TimerTask* task)
 {
 	BeforeScheduled(task);
 	OnScheduled(task);
-	m_task_queue.Add(task);
+	m_wheel.Add(task);
 	AfterScheduled(task);
 }
 
@@ -138,7 +130,19 @@ bool Timer::Cancel(uint32 taskID)
 	TimerTaskMap::iterator found = m_task_table.find(taskID);
 	if (found != m_task_table.end())
 	{
-		found->second->Cancel();
+		TimerTask* task = found->second;
+		/*
+		 * a task out of the wheel is being executed by Routine, which terminates it afterwards
+		 */
+		if (NULL != task->m_slot)
+		{
+			m_wheel.Remove(task);
+			DoTerminated(task);
+		}
+		else
+		{
+			task->Cancel();
+		}
 		return true;
 	}
 	return false;
@@ -146,7 +150,7 @@ bool Timer::Cancel(uint32 taskID)
 
 uint32 Timer::GetAlivedTaskNumber()
 {
-	return m_task_queue.GetSize();
+	return m_wheel.GetSize();
 }
 
 int64 Timer::GetNextTriggerMillsTime(uint32 taskID)
@@ -176,8 +180,16 @@ bool Timer::AdjustNextTriggerTime(uint32 taskID, int64 value, TimeUnit unit)
 		{
 			newTime -= adjustvalue;
 		}
-		bool ret = m_task_queue.RescheduleTask(task, newTime);
-		ASSERT(ret);
+		if (NULL != task->m_slot)
+		{
+			m_wheel.Remove(task);
+			task->m_nextTriggerTime = newTime;
+			m_wheel.Add(task);
+		}
+		else
+		{
+			task->m_nextTriggerTime = newTime;
+		}
 		return true;
 	}
 	return false;
@@ -185,58 +197,47 @@ bool Timer::AdjustNextTriggerTime(uint32 taskID, int64 value, TimeUnit unit)
 
 int64 Timer::Routine()
 {
-	uint32 scheduled = 0;
-	int64 ret = -1;
-
-	while (!m_task_queue.IsEmpty())
+	TimerTask* task = m_wheel.Advance(get_current_epoch_millis());
+	while (NULL != task)
 	{
-		ret = -1;
-		TimerTask* task = m_task_queue.GetMin();
-		uint64 now = get_current_epoch_millis();
-		if (task->m_nextTriggerTime > now)
+		TimerTask* next = task->m_next;
+		task->m_next = NULL;
+		if (NULL != task->m_runner && SCHEDULED == task->GetState())
 		{
-			ret = task->m_nextTriggerTime - now;
-			break;
-		} else
-		{
-			if (NULL != task->m_runner)
+			Runnable* runner = task->m_runner;
+			if (task->m_period > 0)
 			{
+				uint64 next_trigger_time = get_current_epoch_millis()
+						+ millistime(task->m_period, task->m_unit);
+				runner->Run();
 				if (SCHEDULED == task->GetState())
 				{
-					Runnable* runner = task->m_runner;
-					scheduled++;
-					if (task->m_period > 0)
-					{
-						//task->m_delay = task->m_period;
-						//DoSchedule(task, task->m_delay, task->m_period,
-						//        task->m_unit);
-						m_task_queue.RescheduleMin(
-								get_current_epoch_millis()
-										+ millistime(task->m_period,
-												task->m_unit));
-						runner->Run();
-						continue;
-					} else
-					{
-						m_task_queue.RemoveMin();
-						task->m_state = EXECUTED;
-						runner->Run();
-						DoTerminated(task);
-					}
-				} else
+					task->m_nextTriggerTime = next_trigger_time;
+					m_wheel.Add(task);
+				}
+				else
 				{
-					m_task_queue.RemoveMin();
 					DoTerminated(task);
 				}
-			} else //runner is NULL
+			} else
 			{
-				m_task_queue.RemoveMin();
+				task->m_state = EXECUTED;
+				runner->Run();
+				DoTerminated(task);
 			}
+		} else
+		{
+			DoTerminated(task);
 		}
-
+		task = next;
 	}
-
-	return ret;
+	int64 next_time = m_wheel.GetNextAdvanceTime();
+	if (next_time < 0)
+	{
+		return -1;
+	}
+	uint64 now = get_current_epoch_millis();
+	return (uint64) next_time > now ? next_time - now : 1;
 }
 
 Timer::~Timer()
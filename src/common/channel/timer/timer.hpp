@@ -32,7 +32,7 @@
 #include "common.hpp"
 #include "util/time_unit.hpp"
 #include "timer_task.hpp"
-#include "timer_task_queue.hpp"
+#include "timer_wheel.hpp"
 #include <map>
 
 using ardb::TimeUnit;
@@ -42,7 +42,7 @@ namespace ardb
 	{
 		protected:
 			typedef TreeMap<uint32, TimerTask*>::Type TimerTaskMap;
-			TimerTaskQueue m_task_queue;
+			TimerWheel m_wheel;
 			TimerTaskMap m_task_table;
 			virtual void BeforeScheduled(TimerTask* task)
 			{
@@ -62,7 +62,6 @@ namespace ardb
 					TimeUnit unit);
 			void DoTerminated(TimerTask* task, bool eraseFromTable = true);
 
-			TimerTask* GetNearestTimerTask();
 			int64 GetNearestTaskTriggerTime();
 			int32 DoSchedule(Runnable* task, int64_t delay, int64_t period,
 					TimeUnit unit, RunnableDestructor* destructor);
@@ -37,48 +37,36 @@ int TimerChannel::TimeoutCB(struct aeEventLoop *eventLoop, long long id,
 {
     TimerChannel* channel = (TimerChannel*) clientData;
     int64 nextTime = channel->Routine();
-    //int64 nextTime = channel->GetNearestTaskTriggerTime();
     if (nextTime > 0)
     {
-        //uint64 now = getCurrentTimeMillis();
-        //return nextTime - now;
+        channel->m_timer_trigger_time = get_current_epoch_millis() + nextTime;
         return nextTime;
     }
-    //ASSERT(nextTime > 0);
     channel->m_timer_id = -1;
     return AE_NOMORE;
 }
 
+/*
+ * The ae timer is armed for the time Routine asked for, it only moves earlier for a task due before it.
+ */
 void TimerChannel::OnScheduled(TimerTask* task)
 {
-    //TimerTask* nearestTask = getNearestTimerTask();
-    int64 nextTime = GetNearestTaskTriggerTime();
-    if (nextTime < 0
-            || static_cast<uint64>(nextTime) > task->GetNextTriggerTime())
+    uint64 now = get_current_epoch_millis();
+    uint64 trigger_time = task->GetNextTriggerTime();
+    int64 delay = trigger_time > now ? trigger_time - now : 0;
+    if (-1 != m_timer_id)
     {
-        if (-1 != m_timer_id)
-        {
-            if (nextTime > 0)
-            {
-                aeModifyTimeEvent(GetService().GetRawEventLoop(), m_timer_id,
-                        task->GetDelay());
-            }
-            else
-            {
-                //just ignore, let timer handle it later
-            }
-        }
-        else
+        if (trigger_time < m_timer_trigger_time)
         {
-            if (-1 != m_timer_id)
-            {
-                aeDeleteTimeEvent(GetService().GetRawEventLoop(), m_timer_id);
-                m_timer_id = -1;
-            }
-            m_timer_id = aeCreateTimeEvent(GetService().GetRawEventLoop(),
-                    task->GetDelay(), TimeoutCB, this, NULL);
+            aeModifyTimeEvent(GetService().GetRawEventLoop(), m_timer_id, delay);
+            m_timer_trigger_time = trigger_time;
         }
     }
+    else
+    {
+        m_timer_id = aeCreateTimeEvent(GetService().GetRawEventLoop(), delay, TimeoutCB, this, NULL);
+        m_timer_trigger_time = trigger_time;
+    }
 }
 
 TimerChannel::~TimerChannel()
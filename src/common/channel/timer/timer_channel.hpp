@@ -41,9 +41,10 @@ namespace ardb
 					void *clientData);
 			void OnScheduled(TimerTask* task);
 			long long m_timer_id;
+			uint64 m_timer_trigger_time;
 		public:
 			TimerChannel(ChannelService& service) :
-					Channel(NULL, service), m_timer_id(-1)
+					Channel(NULL, service), m_timer_id(-1), m_timer_trigger_time(0)
 			{
 			}
 			~TimerChannel();
@@ -39,7 +39,7 @@ namespace ardb
 		VIRGIN, SCHEDULED, EXECUTED, CANCELLED
 	};
 	class Timer;
-	class TimerTaskQueue;
+	class TimerWheel;
 	class TimerTask
 	{
 		protected:
@@ -51,20 +51,26 @@ namespace ardb
 			uint64 m_nextTriggerTime;
 			Runnable* m_runner;
 			RunnableDestructor* m_runner_destructor;
-			uint32 m_queue_index;
+			/*
+			 * links of the timer wheel slot holding the task, m_slot is NULL while the task is
+			 * not in the wheel(e.g. being executed)
+			 */
+			TimerTask* m_prev;
+			TimerTask* m_next;
+			TimerTask** m_slot;
 			inline uint32 GetID()
 			{
 				return m_id;
 			}
 			friend class Timer;
-			friend class TimerTaskQueue;
+			friend class TimerWheel;
 		public:
 			TimerTask(uint32 id, Runnable* runner,
 					RunnableDestructor* destructor) :
 					m_id(id), m_state(VIRGIN), m_delay(0), m_period(0), m_unit(
 							ardb::MILLIS), m_nextTriggerTime(0), m_runner(
-							runner), m_runner_destructor(destructor), m_queue_index(
-							0)
+							runner), m_runner_destructor(destructor), m_prev(NULL), m_next(
+							NULL), m_slot(NULL)
 			{
 			}
 			inline int64 GetDelay()
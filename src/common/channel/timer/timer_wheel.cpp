@@ -0,0 +1,221 @@
+ /*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "timer_wheel.hpp"
+#include "util/time_helper.hpp"
+#include <string.h>
+
+using namespace ardb;
+
+TimerWheel::TimerWheel() :
+		m_current(0), m_size(0), m_root_size(0)
+{
+	memset(m_root, 0, sizeof(m_root));
+	memset(m_levels, 0, sizeof(m_levels));
+}
+
+void TimerWheel::Link(TimerTask** slot, TimerTask* task)
+{
+	task->m_slot = slot;
+	task->m_prev = NULL;
+	task->m_next = *slot;
+	if (NULL != *slot)
+	{
+		(*slot)->m_prev = task;
+	}
+	*slot = task;
+}
+
+void TimerWheel::Unlink(TimerTask* task)
+{
+	if (NULL != task->m_prev)
+	{
+		task->m_prev->m_next = task->m_next;
+	}
+	else
+	{
+		*(task->m_slot) = task->m_next;
+	}
+	if (NULL != task->m_next)
+	{
+		task->m_next->m_prev = task->m_prev;
+	}
+	if (task->m_slot >= m_root && task->m_slot < m_root + kRootSize)
+	{
+		m_root_size--;
+	}
+	task->m_slot = NULL;
+	task->m_prev = task->m_next = NULL;
+	m_size--;
+}
+
+void TimerWheel::Add(TimerTask* task)
+{
+	if (0 == m_size)
+	{
+		m_current = get_current_epoch_millis();
+	}
+	Place(task);
+}
+
+void TimerWheel::Place(TimerTask* task)
+{
+	uint64 expires = task->GetNextTriggerTime();
+	if (expires < m_current)
+	{
+		expires = m_current;
+	}
+	uint64 delta = expires - m_current;
+	m_size++;
+	if (delta < kRootSize)
+	{
+		Link(&m_root[expires & (kRootSize - 1)], task);
+		m_root_size++;
+		return;
+	}
+	uint32 level = 0;
+	while (level < kUpperLevels - 1 && delta >= ((uint64) 1 << (kRootBits + (level + 1) * kLevelBits)))
+	{
+		level++;
+	}
+	uint64 max_delta = ((uint64) 1 << (kRootBits + kUpperLevels * kLevelBits)) - 1;
+	if (delta > max_delta)
+	{
+		expires = m_current + max_delta;
+	}
+	uint32 index = (expires >> (kRootBits + level * kLevelBits)) & (kLevelSize - 1);
+	Link(&m_levels[level][index], task);
+}
+
+void TimerWheel::Remove(TimerTask* task)
+{
+	if (NULL != task->m_slot)
+	{
+		Unlink(task);
+	}
+}
+
+void TimerWheel::Cascade()
+{
+	for (uint32 level = 0; level < kUpperLevels; level++)
+	{
+		uint32 index = (m_current >> (kRootBits + level * kLevelBits)) & (kLevelSize - 1);
+		TimerTask* task = m_levels[level][index];
+		m_levels[level][index] = NULL;
+		while (NULL != task)
+		{
+			TimerTask* next = task->m_next;
+			task->m_slot = NULL;
+			task->m_prev = task->m_next = NULL;
+			m_size--;
+			Place(task);
+			task = next;
+		}
+		if (0 != index)
+		{
+			break;
+		}
+	}
+}
+
+TimerTask* TimerWheel::Advance(uint64 now)
+{
+	TimerTask* expired = NULL;
+	TimerTask* expired_tail = NULL;
+	while (m_size > 0 && m_current <= now)
+	{
+		uint32 index = m_current & (kRootSize - 1);
+		if (0 == index)
+		{
+			Cascade();
+		}
+		if (0 == m_root_size)
+		{
+			/*
+			 * nothing due before the next cascade
+			 */
+			uint64 cascade_time = (m_current | (kRootSize - 1)) + 1;
+			m_current = cascade_time <= now ? cascade_time : now + 1;
+			continue;
+		}
+		TimerTask* task = m_root[index];
+		while (NULL != task)
+		{
+			TimerTask* next = task->m_next;
+			Unlink(task);
+			if (NULL == expired_tail)
+			{
+				expired = task;
+			}
+			else
+			{
+				expired_tail->m_next = task;
+			}
+			expired_tail = task;
+			task = next;
+		}
+		m_current++;
+	}
+	return expired;
+}
+
+int64 TimerWheel::GetNextAdvanceTime()
+{
+	if (0 == m_size)
+	{
+		return -1;
+	}
+	/*
+	 * the cascade at m_current is still pending
+	 */
+	if (0 == (m_current & (kRootSize - 1)))
+	{
+		return m_current;
+	}
+	uint64 cascade_time = (m_current | (kRootSize - 1)) + 1;
+	if (m_root_size > 0)
+	{
+		for (uint64 t = m_current; t < cascade_time; t++)
+		{
+			if (NULL != m_root[t & (kRootSize - 1)])
+			{
+				return t;
+			}
+		}
+	}
+	return cascade_time;
+}
+
+void TimerWheel::Clear()
+{
+	memset(m_root, 0, sizeof(m_root));
+	memset(m_levels, 0, sizeof(m_levels));
+	m_size = 0;
+	m_root_size = 0;
+}
@@ -0,0 +1,84 @@
+ /*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TIMER_WHEEL_HPP_
+#define TIMER_WHEEL_HPP_
+#include "common.hpp"
+#include "timer_task.hpp"
+namespace ardb
+{
+	/*
+	 * Hierarchical timing wheel with millisecond ticks, 256 slots at the first level and 64 at the
+	 * three upper ones (~18 hours), later tasks wait in the last slot & are placed again when it
+	 * cascades. Add/Remove are O(1), tasks of an upper level slot move down once every 256 ticks.
+	 */
+	class TimerWheel
+	{
+		private:
+			static const uint32 kRootBits = 8;
+			static const uint32 kLevelBits = 6;
+			static const uint32 kRootSize = 1 << kRootBits;
+			static const uint32 kLevelSize = 1 << kLevelBits;
+			static const uint32 kUpperLevels = 3;
+
+			TimerTask* m_root[kRootSize];
+			TimerTask* m_levels[kUpperLevels][kLevelSize];
+			uint64 m_current;
+			uint32 m_size;
+			uint32 m_root_size;
+			void Link(TimerTask** slot, TimerTask* task);
+			void Unlink(TimerTask* task);
+			void Place(TimerTask* task);
+			void Cascade();
+		public:
+			TimerWheel();
+			inline uint32 GetSize()
+			{
+				return m_size;
+			}
+			inline bool IsEmpty()
+			{
+				return m_size == 0;
+			}
+			void Add(TimerTask* task);
+			void Remove(TimerTask* task);
+			/*
+			 * Moves all tasks due at or before 'now' to the list linked by m_next, and returns its head.
+			 */
+			TimerTask* Advance(uint64 now);
+			/*
+			 * Earliest time the wheel needs to be advanced again, a slot with due tasks or the next
+			 * cascade. -1 if empty.
+			 */
+			int64 GetNextAdvanceTime();
+			void Clear();
+	};
+}
+
+#endif /* TIMER_WHEEL_HPP_ */
@@ -128,6 +128,15 @@ OP_NAMESPACE_BEGIN
     {
         WakeupCoro();
     }
+    /*
+     * Yield the current coroutine for 'millis', nothing should be pending on the channel meanwhile.
+     */
+    void CoroChannel::SyncSleep(int millis)
+    {
+        CreateTimeoutTask(millis);
+        WaitCoro();
+        CancelTimeoutTask();
+    }
     bool CoroChannel::SyncConnect(Address* addr, int timeout)
     {
         if (NULL == m_ch)
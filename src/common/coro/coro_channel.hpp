@@ -73,6 +73,7 @@ OP_NAMESPACE_BEGIN
             bool SyncConnect(Address* addr, int timeout);
             int SyncRead(Buffer& buffer, int timeout);
             int SyncWrite(Buffer& buffer, int timeout);
+            void SyncSleep(int millis);
             ~CoroChannel();
     };
     class RedisCoroChannelHandler;
@@ -29,18 +29,32 @@
 
 #include "scheduler.hpp"
 #include "thread/thread_local.hpp"
+#include "util/atomic.hpp"
+#include <sys/mman.h>
 
 OP_NAMESPACE_BEGIN
 
     static ThreadLocal<Scheduler> g_local_scheduler;
     static uint64 g_coro_id_seed = 0;
+
+    static const uint32 kStackSampleRate = 64;
+    static const size_t kMaxPooledStacks = 64; //per size class & thread
+    static const uint8 kStackPaint = 0xA5;
+    static volatile uint64_t g_stacks_allocated = 0;
+    static volatile uint64_t g_stacks_pooled = 0;
+    static volatile uint64_t g_stacks_reused = 0;
+    static volatile uint64_t g_stacks_sampled = 0;
+    static volatile uint64_t g_stack_max_used = 0;
+
     Coroutine::Coroutine(CoroutineFunc* f, void* data, uint32 stack_size) :
-            id(0), func(f)
+            id(0), func(f), stack_sampled(false)
     {
         id = g_coro_id_seed++;
+        stack.sptr = NULL;
+        stack.ssze = 0;
         if (NULL != func)
         {
-            coro_stack_alloc(&stack, stack_size);
+            Scheduler::CurrentScheduler().AllocStack(stack, stack_size, stack_sampled);
             coro_create(&ctx, func, data, stack.sptr, stack.ssze);
         }
         else
@@ -51,14 +65,107 @@ OP_NAMESPACE_BEGIN
 
     Coroutine::~Coroutine()
     {
-        coro_stack_free(&stack);
+        Scheduler::CurrentScheduler().FreeStack(stack, stack_sampled);
         coro_destroy(&ctx);
     }
 
     Scheduler::Scheduler() :
-            m_current_coro(NULL)
+            m_current_coro(NULL), m_stack_allocs(0)
+    {
+
+    }
+
+    bool Scheduler::AllocStack(coro_stack& stack, uint32 size, bool& sampled)
+    {
+        size_t size_class = 4096;
+        size = 0 == size ? 256 * 1024 : size;
+        while (size_class < size)
+        {
+            size_class <<= 1;
+        }
+        std::vector<coro_stack>& pooled = m_stack_pool[size_class];
+        if (!pooled.empty())
+        {
+            stack = pooled.back();
+            pooled.pop_back();
+            atomic_sub_uint64(&g_stacks_pooled, 1);
+            atomic_add_uint64(&g_stacks_reused, 1);
+        }
+        else
+        {
+            if (!coro_stack_alloc(&stack, size_class))
+            {
+                stack.sptr = NULL;
+                return false;
+            }
+            atomic_add_uint64(&g_stacks_allocated, 1);
+        }
+        sampled = (++m_stack_allocs % kStackSampleRate) == 0;
+        if (sampled)
+        {
+            memset(stack.sptr, kStackPaint, stack.ssze);
+        }
+        return true;
+    }
+
+    void Scheduler::FreeStack(coro_stack& stack, bool sampled)
     {
+        if (NULL == stack.sptr)
+        {
+            return;
+        }
+        if (sampled)
+        {
+            /*
+             * stacks grow down, the painted bytes left at the low end were never used
+             */
+            const uint8* low = (const uint8*) stack.sptr;
+            size_t unused = 0;
+            while (unused < stack.ssze && low[unused] == kStackPaint)
+            {
+                unused++;
+            }
+            uint64 used = stack.ssze - unused;
+            atomic_add_uint64(&g_stacks_sampled, 1);
+            while (true)
+            {
+                uint64 current = g_stack_max_used;
+                if (used <= current || atomic_cmp_set_uint64(&g_stack_max_used, current, used))
+                {
+                    break;
+                }
+            }
+            /*
+             * painting touched the whole stack, give the never used pages back
+             */
+            size_t page = sysconf(_SC_PAGESIZE);
+            if (unused >= page)
+            {
+                madvise(stack.sptr, unused / page * page, MADV_DONTNEED);
+            }
+        }
+        size_t units = stack.ssze / sizeof(void*);
+        std::vector<coro_stack>& pooled = m_stack_pool[units];
+        if (pooled.size() < kMaxPooledStacks)
+        {
+            pooled.push_back(stack);
+            atomic_add_uint64(&g_stacks_pooled, 1);
+        }
+        else
+        {
+            coro_stack_free(&stack);
+            atomic_sub_uint64(&g_stacks_allocated, 1);
+        }
+        stack.sptr = NULL;
+    }
 
+    void Scheduler::GetStackStats(CoroStackStats& stats)
+    {
+        stats.allocated = g_stacks_allocated;
+        stats.pooled = g_stacks_pooled;
+        stats.reused = g_stacks_reused;
+        stats.sampled = g_stacks_sampled;
+        stats.max_used = g_stack_max_used;
     }
 
     void Scheduler::Clean()
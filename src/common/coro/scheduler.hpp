@@ -33,6 +33,7 @@
 #include "common.hpp"
 #include "coro.h"
 #include <stack>
+#include <vector>
 
 OP_NAMESPACE_BEGIN
 
@@ -46,9 +47,23 @@ OP_NAMESPACE_BEGIN
             CoroutineFunc* func;  //coro func
             coro_context ctx;
             coro_stack stack;
+            bool stack_sampled; //stack painted to measure its usage when it is released
             Coroutine(CoroutineFunc* func = NULL, void* data = NULL, uint32 stack_size = 0);
             ~Coroutine();
     };
+
+    struct CoroStackStats
+    {
+            uint64 allocated; //stacks mapped by all threads
+            uint64 pooled; //stacks parked in the thread pools
+            uint64 reused; //coroutines started on a pooled stack
+            uint64 sampled; //coroutines whose stack usage was measured
+            uint64 max_used; //most stack bytes used by a measured coroutine
+            CoroStackStats() :
+                    allocated(0), pooled(0), reused(0), sampled(0), max_used(0)
+            {
+            }
+    };
     /*
      * A simple coroutine scheduler
      */
@@ -62,6 +77,12 @@ OP_NAMESPACE_BEGIN
             CoroutineTable m_join_table;
             CoroutineTable m_exec_table;
             Coroutine* m_current_coro;
+            /*
+             * released stacks by size class(power of 2 sizes), they keep their guard pages & touched memory
+             */
+            typedef TreeMap<size_t, std::vector<coro_stack> >::Type StackPool;
+            StackPool m_stack_pool;
+            uint32 m_stack_allocs;
             void Clean();
 
             void SetCurrentCoroutine(Coroutine* coro)
@@ -97,7 +118,15 @@ OP_NAMESPACE_BEGIN
                 return m_current_coro;
             }
 
+            /*
+             * Stacks of 'size' units(see coro_stack_alloc) from the pool of the current thread, one of every
+             * kStackSampleRate stacks is painted & measured when released, see GetStackStats.
+             */
+            bool AllocStack(coro_stack& stack, uint32 size, bool& sampled);
+            void FreeStack(coro_stack& stack, bool sampled);
+
             static Scheduler& CurrentScheduler();
+            static void GetStackStats(CoroStackStats& stats);
 
     };
 
@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <set>
 #include <complex>
+#include <deque>
 
 #define D_R (M_PI / 180.0)
 #define R_D (180.0 / M_PI)
@@ -454,6 +455,131 @@ namespace ardb
         return 0;
     }
 
+    /*
+     * Exact great circle distance from a point to a lat/lon cell, 0 if the point is inside.
+     * Outside the cell's longitude span the nearest point lies on the nearer meridian edge,
+     * at the foot of the perpendicular if that falls on the edge, else at one of its corners.
+     */
+    static double distance_to_area(double longitude, double latitude, const GeoHashArea& area)
+    {
+        if (longitude >= area.longitude.min && longitude <= area.longitude.max)
+        {
+            if (latitude >= area.latitude.min && latitude <= area.latitude.max)
+            {
+                return 0;
+            }
+            double edge = latitude < area.latitude.min ? area.latitude.min : area.latitude.max;
+            return GeoHashHelper::GetWGS84Distance(longitude, latitude, longitude, edge);
+        }
+        double to_min = fabs(fmod(area.longitude.min - longitude + 540.0, 360.0) - 180.0);
+        double to_max = fabs(fmod(area.longitude.max - longitude + 540.0, 360.0) - 180.0);
+        double edge = to_min < to_max ? area.longitude.min : area.longitude.max;
+        double dlon = deg_rad(to_min < to_max ? to_min : to_max);
+        if (dlon >= M_PI_2)
+        {
+            return 0;
+        }
+        double latr = deg_rad(latitude);
+        double foot = rad_deg(atan(tan(latr) / cos(dlon)));
+        if (foot >= area.latitude.min && foot <= area.latitude.max)
+        {
+            return EARTH_RADIUS_IN_METERS * asin(sin(dlon) * cos(latr));
+        }
+        double to_bottom = GeoHashHelper::GetWGS84Distance(longitude, latitude, edge, area.latitude.min);
+        double to_top = GeoHashHelper::GetWGS84Distance(longitude, latitude, edge, area.latitude.max);
+        return to_bottom < to_top ? to_bottom : to_top;
+    }
+
+    static bool area_inside_radius(double longitude, double latitude, const GeoHashArea& area, double radius_meters)
+    {
+        return GeoHashHelper::GetWGS84Distance(longitude, latitude, area.longitude.min, area.latitude.min) < radius_meters
+                && GeoHashHelper::GetWGS84Distance(longitude, latitude, area.longitude.min, area.latitude.max) < radius_meters
+                && GeoHashHelper::GetWGS84Distance(longitude, latitude, area.longitude.max, area.latitude.min) < radius_meters
+                && GeoHashHelper::GetWGS84Distance(longitude, latitude, area.longitude.max, area.latitude.max) < radius_meters;
+    }
+
+    /*
+     * Refine the 9-box areas of 'GetAreasByRadius' into at most 'max_cells' cells of mixed steps:
+     * coarsest cells are split first, cells not touching the circle are dropped, cells fully inside
+     * it or at 'max_step' are kept. Every cell still needs per point distance filtering.
+     */
+    int GeoHashHelper::GetCoveringCells(uint8 coord_type, double latitude, double longitude, double radius_meters, uint8 max_step, uint32 max_cells,
+            GeoHashCoverCellArray& cells)
+    {
+        cells.clear();
+        GeoHashBitsSet areas;
+        GetAreasByRadius(coord_type, latitude, longitude, radius_meters, areas);
+        GeoHashBitsSet::iterator ait = areas.begin();
+        if (coord_type != GEO_WGS84_TYPE)
+        {
+            while (ait != areas.end())
+            {
+                GeoHashCoverCell cell;
+                cell.hash = *ait;
+                cell.min_distance = 0;
+                cells.push_back(cell);
+                ait++;
+            }
+            return 0;
+        }
+        GeoHashRange lat_range, lon_range;
+        GeoHashHelper::GetCoordRange(coord_type, lat_range, lon_range);
+        /*
+         * tolerate rounding errors, dropping a cell must never lose a point within the radius
+         */
+        double prune_distance = radius_meters * (1 + 1e-9) + 1e-6;
+        std::deque<GeoHashCoverCell> pending;
+        while (ait != areas.end())
+        {
+            GeoHashArea area;
+            geohash_fast_decode(lat_range, lon_range, *ait, &area);
+            GeoHashCoverCell cell;
+            cell.hash = *ait;
+            cell.min_distance = distance_to_area(longitude, latitude, area);
+            if (cell.min_distance <= prune_distance)
+            {
+                pending.push_back(cell);
+            }
+            ait++;
+        }
+        while (!pending.empty())
+        {
+            GeoHashCoverCell cell = pending.front();
+            pending.pop_front();
+            GeoHashArea area;
+            geohash_fast_decode(lat_range, lon_range, cell.hash, &area);
+            if (cell.hash.step >= max_step || area_inside_radius(longitude, latitude, area, radius_meters))
+            {
+                cells.push_back(cell);
+                continue;
+            }
+            GeoHashCoverCell children[4];
+            uint32 child_count = 0;
+            for (uint64_t i = 0; i < 4; i++)
+            {
+                GeoHashCoverCell& child = children[child_count];
+                child.hash.bits = (cell.hash.bits << 2) | i;
+                child.hash.step = cell.hash.step + 1;
+                geohash_fast_decode(lat_range, lon_range, child.hash, &area);
+                child.min_distance = distance_to_area(longitude, latitude, area);
+                if (child.min_distance <= prune_distance)
+                {
+                    child_count++;
+                }
+            }
+            if (cells.size() + pending.size() + child_count > max_cells)
+            {
+                cells.push_back(cell);
+                continue;
+            }
+            for (uint32 i = 0; i < child_count; i++)
+            {
+                pending.push_back(children[i]);
+            }
+        }
+        return 0;
+    }
+
     uint64 GeoHashHelper::AllignHashBits(uint8 step, const GeoHashBits& hash)
     {
         uint64_t bits = hash.bits;
@@ -485,6 +611,22 @@ namespace ardb
         return 2.0 * EARTH_RADIUS_IN_METERS * asin(sqrt(u * u + cos(lat1r) * cos(lat2r) * v * v));
     }
 
+    /*
+     * Half sizes in degrees of the smallest box holding every point within 'radius_meters' of the center, the longitude
+     * one is 360 if the circle reaches a pole. Both are widened a little against rounding, the box is only a prefilter.
+     */
+    void GeoHashHelper::GetWGS84BoundingBox(double longitude, double latitude, double radius_meters, double& lon_delta, double& lat_delta)
+    {
+        double angle = radius_meters / EARTH_RADIUS_IN_METERS;
+        lat_delta = rad_deg(angle) * (1 + 1e-9) + 1e-12;
+        if (angle >= M_PI_2 || fabs(latitude) + lat_delta >= 90.0)
+        {
+            lon_delta = 360.0;
+            return;
+        }
+        lon_delta = rad_deg(asin(sin(angle) / cos(deg_rad(latitude)))) * (1 + 1e-9) + 1e-12;
+    }
+
     bool GeoHashHelper::GetDistanceSquareIfInRadius(uint8 coord_type, double x1, double y1, double x2, double y2, double radius, double& distance,
             double accurace)
     {
@@ -60,12 +60,21 @@ namespace ardb
 
     typedef TreeSet<GeoHashBits, GeoHashBitsComparator>::Type GeoHashBitsSet;
 
+    struct GeoHashCoverCell
+    {
+            GeoHashBits hash;
+            double min_distance;  //lower bound of the distance from the search center to any point in the cell
+    };
+    typedef std::vector<GeoHashCoverCell> GeoHashCoverCellArray;
+
 
     class GeoHashHelper
     {
         public:
             static int GetCoordRange(uint8 coord_type, GeoHashRange& lat_range, GeoHashRange& lon_range);
             static int GetAreasByRadius(uint8 coord_type,double latitude, double longitude, double radius_meters, GeoHashBitsSet& results);
+            static int GetCoveringCells(uint8 coord_type, double latitude, double longitude, double radius_meters, uint8 max_step, uint32 max_cells,
+                    GeoHashCoverCellArray& cells);
             static int GetAreasByRadiusV2(uint8 coord_type,double latitude, double longitude, double radius_meters, GeoHashBitsSet& results);
             static uint64 AllignHashBits(uint8 step, const GeoHashBits& hash);
             static double GetMercatorX(double longtitude);
@@ -78,6 +87,7 @@ namespace ardb
             static bool GetMercatorXYByHash(GeoHashFix60Bits hash, double& x, double& y);
             static bool GetXYByHash(uint8 coord_type, uint8 step, uint64_t hash, double& x, double& y);
             static double GetWGS84Distance(double lon1d, double lat1d, double lon2d, double lat2d);
+            static void GetWGS84BoundingBox(double longitude, double latitude, double radius_meters, double& lon_delta, double& lat_delta);
     };
 }
 
@@ -0,0 +1,126 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BIG_READER_LOCK_HPP_
+#define BIG_READER_LOCK_HPP_
+#include "lock_mode.hpp"
+#include "util/atomic.hpp"
+#include <sched.h>
+#include <string.h>
+namespace ardb
+{
+    /*
+     * Reader slot of the calling thread, threads get slots round robin.
+     */
+    uint32_t big_reader_slot();
+
+    /*
+     * Read-mostly lock like the linux 'brlock': each reader only bumps the counter of its own thread's cache line, so
+     * readers on different cores never share a written line. A writer announces itself then waits for all reader slots
+     * to drain, which costs a scan of kSlots lines, use it only where writes are rare(subscriptions, monitors).
+     * Same interface & semantics as SpinRWLock(recursive reads, readers wait for a pending writer).
+     */
+    class BigReaderLock
+    {
+        public:
+            static const uint32_t kSlots = 64;
+        private:
+            struct ReaderSlot
+            {
+                    volatile uint32_t readers;
+                    char padding[64 - sizeof(uint32_t)];
+            };
+            ReaderSlot m_slots[kSlots];
+            volatile uint32_t m_writer;
+        public:
+            BigReaderLock() :
+                    m_writer(0)
+            {
+                memset((void*) m_slots, 0, sizeof(m_slots));
+            }
+            bool Lock(LockMode mode)
+            {
+                switch (mode)
+                {
+                    case READ_LOCK:
+                    {
+                        volatile uint32_t* readers = &(m_slots[big_reader_slot() % kSlots].readers);
+                        for (;;)
+                        {
+                            while (m_writer)
+                                sched_yield();
+                            // the full barrier of the increment orders it before the writer check below
+                            atomic_add_uint32(readers, 1);
+                            if (!m_writer)
+                                return true;
+                            atomic_sub_uint32(readers, 1);
+                        }
+                        return true;
+                    }
+                    case WRITE_LOCK:
+                    {
+                        while (!atomic_cmp_set_uint32(&m_writer, 0, 1))
+                            sched_yield();
+                        for (uint32_t i = 0; i < kSlots; i++)
+                        {
+                            while (m_slots[i].readers)
+                                sched_yield();
+                        }
+                        return true;
+                    }
+                    default:
+                    {
+                        return false;
+                    }
+                }
+            }
+            bool Unlock(LockMode mode)
+            {
+                switch (mode)
+                {
+                    case READ_LOCK:
+                    {
+                        atomic_sub_uint32(&(m_slots[big_reader_slot() % kSlots].readers), 1);
+                        return true;
+                    }
+                    case WRITE_LOCK:
+                    {
+                        atomic_sub_uint32(&m_writer, 1);
+                        return true;
+                    }
+                    default:
+                    {
+                        return false;
+                    }
+                }
+            }
+    };
+}
+
+#endif /* BIG_READER_LOCK_HPP_ */
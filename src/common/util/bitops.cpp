@@ -0,0 +1,415 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "util/bitops.hpp"
+#include <string.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BITOPS_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define BITOPS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace ardb
+{
+    //copy from redis
+    static long popcount_scalar(const unsigned char* p, size_t count)
+    {
+        long bits = 0;
+        static const unsigned char bitsinbyte[256] =
+        { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3,
+                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3,
+                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3,
+                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 2, 3,
+                3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 4, 5,
+                5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8 };
+
+        /* Count bits 16 bytes at a time */
+        while (count >= 16)
+        {
+            uint32_t aux1, aux2, aux3, aux4;
+
+            memcpy(&aux1, p, 4);
+            memcpy(&aux2, p + 4, 4);
+            memcpy(&aux3, p + 8, 4);
+            memcpy(&aux4, p + 12, 4);
+            p += 16;
+            count -= 16;
+
+            aux1 = aux1 - ((aux1 >> 1) & 0x55555555);
+            aux1 = (aux1 & 0x33333333) + ((aux1 >> 2) & 0x33333333);
+            aux2 = aux2 - ((aux2 >> 1) & 0x55555555);
+            aux2 = (aux2 & 0x33333333) + ((aux2 >> 2) & 0x33333333);
+            aux3 = aux3 - ((aux3 >> 1) & 0x55555555);
+            aux3 = (aux3 & 0x33333333) + ((aux3 >> 2) & 0x33333333);
+            aux4 = aux4 - ((aux4 >> 1) & 0x55555555);
+            aux4 = (aux4 & 0x33333333) + ((aux4 >> 2) & 0x33333333);
+            bits += ((((aux1 + (aux1 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24) + ((((aux2 + (aux2 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24)
+                    + ((((aux3 + (aux3 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24) + ((((aux4 + (aux4 >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+        }
+        /* Count the remaining bytes */
+        while (count--)
+            bits += bitsinbyte[*p++];
+        return bits;
+    }
+
+    /*
+     * Return the count of leading bytes equal to 'skipval'.
+     */
+    static size_t skip_scalar(const unsigned char* p, size_t count, unsigned char skipval)
+    {
+        uint64 skipword = skipval ? ~(uint64) 0 : 0;
+        size_t i = 0;
+        for (; i + sizeof(uint64) <= count; i += sizeof(uint64))
+        {
+            uint64 word;
+            memcpy(&word, p + i, sizeof(word));
+            if (word != skipword)
+            {
+                break;
+            }
+        }
+        while (i < count && p[i] == skipval)
+        {
+            i++;
+        }
+        return i;
+    }
+
+    static void and_scalar(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+            dst[i] &= src[i];
+    }
+    static void or_scalar(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+            dst[i] |= src[i];
+    }
+    static void xor_scalar(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+            dst[i] ^= src[i];
+    }
+    static void not_scalar(unsigned char* dst, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+            dst[i] = ~dst[i];
+    }
+    static void max_scalar(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+            if (src[i] > dst[i])
+                dst[i] = src[i];
+    }
+
+#if defined(BITOPS_X86)
+    __attribute__((target("popcnt")))
+    static long popcount_popcnt(const unsigned char* p, size_t count)
+    {
+        long bits = 0;
+        size_t i = 0;
+        for (; i + sizeof(uint64) <= count; i += sizeof(uint64))
+        {
+            uint64 word;
+            memcpy(&word, p + i, sizeof(word));
+            bits += __builtin_popcountll(word);
+        }
+        return bits + popcount_scalar(p + i, count - i);
+    }
+
+    /*
+     * Count the bits of both nibbles of every byte with a shuffle lookup, the byte counters are summed
+     * into 64bit lanes before they could overflow.
+     */
+    __attribute__((target("avx2")))
+    static long popcount_avx2(const unsigned char* p, size_t count)
+    {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_mask = _mm256_set1_epi8(0x0f);
+        __m256i total = _mm256_setzero_si256();
+        size_t i = 0;
+        while (i + 32 <= count)
+        {
+            __m256i local = _mm256_setzero_si256();
+            for (int n = 0; n < 31 && i + 32 <= count; n++, i += 32)
+            {
+                __m256i v = _mm256_loadu_si256((const __m256i*) (p + i));
+                __m256i lo = _mm256_and_si256(v, low_mask);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+                local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, lo));
+                local = _mm256_add_epi8(local, _mm256_shuffle_epi8(lookup, hi));
+            }
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(local, _mm256_setzero_si256()));
+        }
+        uint64 lanes[4];
+        _mm256_storeu_si256((__m256i*) lanes, total);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + popcount_popcnt(p + i, count - i);
+    }
+
+    static size_t skip_sse2(const unsigned char* p, size_t count, unsigned char skipval)
+    {
+        const __m128i skip = _mm_set1_epi8(skipval);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*) (p + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, skip)) != 0xffff)
+            {
+                break;
+            }
+        }
+        return i + skip_scalar(p + i, count - i, skipval);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t skip_avx2(const unsigned char* p, size_t count, unsigned char skipval)
+    {
+        const __m256i skip = _mm256_set1_epi8(skipval);
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (p + i));
+            if ((uint32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, skip)) != 0xffffffff)
+            {
+                break;
+            }
+        }
+        return i + skip_sse2(p + i, count - i, skipval);
+    }
+
+#define BITOPS_SSE2_KERNEL(name, op)                                                      \
+    static void name##_sse2(unsigned char* dst, const unsigned char* src, size_t len)     \
+    {                                                                                     \
+        size_t i = 0;                                                                     \
+        for (; i + 16 <= len; i += 16)                                                    \
+        {                                                                                 \
+            __m128i a = _mm_loadu_si128((const __m128i*) (dst + i));                      \
+            __m128i b = _mm_loadu_si128((const __m128i*) (src + i));                      \
+            _mm_storeu_si128((__m128i*) (dst + i), op(a, b));                             \
+        }                                                                                 \
+        name##_scalar(dst + i, src + i, len - i);                                         \
+    }
+#define BITOPS_AVX2_KERNEL(name, op)                                                      \
+    __attribute__((target("avx2")))                                                       \
+    static void name##_avx2(unsigned char* dst, const unsigned char* src, size_t len)     \
+    {                                                                                     \
+        size_t i = 0;                                                                     \
+        for (; i + 32 <= len; i += 32)                                                    \
+        {                                                                                 \
+            __m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));                   \
+            __m256i b = _mm256_loadu_si256((const __m256i*) (src + i));                   \
+            _mm256_storeu_si256((__m256i*) (dst + i), op(a, b));                          \
+        }                                                                                 \
+        name##_scalar(dst + i, src + i, len - i);                                         \
+    }
+    BITOPS_SSE2_KERNEL(and, _mm_and_si128)
+    BITOPS_SSE2_KERNEL(or, _mm_or_si128)
+    BITOPS_SSE2_KERNEL(xor, _mm_xor_si128)
+    BITOPS_AVX2_KERNEL(and, _mm256_and_si256)
+    BITOPS_AVX2_KERNEL(or, _mm256_or_si256)
+    BITOPS_AVX2_KERNEL(xor, _mm256_xor_si256)
+    BITOPS_SSE2_KERNEL(max, _mm_max_epu8)
+    BITOPS_AVX2_KERNEL(max, _mm256_max_epu8)
+
+    static void not_sse2(unsigned char* dst, size_t len)
+    {
+        const __m128i ones = _mm_set1_epi8((char) 0xff);
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*) (dst + i));
+            _mm_storeu_si128((__m128i*) (dst + i), _mm_xor_si128(a, ones));
+        }
+        not_scalar(dst + i, len - i);
+    }
+
+    __attribute__((target("avx2")))
+    static void not_avx2(unsigned char* dst, size_t len)
+    {
+        const __m256i ones = _mm256_set1_epi8((char) 0xff);
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));
+            _mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(a, ones));
+        }
+        not_scalar(dst + i, len - i);
+    }
+#endif
+
+#if defined(BITOPS_NEON)
+    static long popcount_neon(const unsigned char* p, size_t count)
+    {
+        long bits = 0;
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            bits += vaddvq_u8(vcntq_u8(vld1q_u8(p + i)));
+        }
+        return bits + popcount_scalar(p + i, count - i);
+    }
+
+    static size_t skip_neon(const unsigned char* p, size_t count, unsigned char skipval)
+    {
+        const uint8x16_t skip = vdupq_n_u8(skipval);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            if (vminvq_u8(vceqq_u8(vld1q_u8(p + i), skip)) != 0xff)
+            {
+                break;
+            }
+        }
+        return i + skip_scalar(p + i, count - i, skipval);
+    }
+
+#define BITOPS_NEON_KERNEL(name, op)                                                      \
+    static void name##_neon(unsigned char* dst, const unsigned char* src, size_t len)     \
+    {                                                                                     \
+        size_t i = 0;                                                                     \
+        for (; i + 16 <= len; i += 16)                                                    \
+        {                                                                                 \
+            vst1q_u8(dst + i, op(vld1q_u8(dst + i), vld1q_u8(src + i)));                  \
+        }                                                                                 \
+        name##_scalar(dst + i, src + i, len - i);                                         \
+    }
+    BITOPS_NEON_KERNEL(and, vandq_u8)
+    BITOPS_NEON_KERNEL(or, vorrq_u8)
+    BITOPS_NEON_KERNEL(xor, veorq_u8)
+    BITOPS_NEON_KERNEL(max, vmaxq_u8)
+
+    static void not_neon(unsigned char* dst, size_t len)
+    {
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            vst1q_u8(dst + i, vmvnq_u8(vld1q_u8(dst + i)));
+        }
+        not_scalar(dst + i, len - i);
+    }
+#endif
+
+    struct BitopsKernels
+    {
+            long (*popcount)(const unsigned char* p, size_t count);
+            size_t (*skip)(const unsigned char* p, size_t count, unsigned char skipval);
+            void (*bit_and)(unsigned char* dst, const unsigned char* src, size_t len);
+            void (*bit_or)(unsigned char* dst, const unsigned char* src, size_t len);
+            void (*bit_xor)(unsigned char* dst, const unsigned char* src, size_t len);
+            void (*bit_not)(unsigned char* dst, size_t len);
+            void (*byte_max)(unsigned char* dst, const unsigned char* src, size_t len);
+            BitopsKernels() :
+                    popcount(popcount_scalar), skip(skip_scalar), bit_and(and_scalar), bit_or(or_scalar), bit_xor(xor_scalar), bit_not(not_scalar), byte_max(max_scalar)
+            {
+#if defined(BITOPS_X86)
+                __builtin_cpu_init();
+                skip = skip_sse2;
+                bit_and = and_sse2;
+                bit_or = or_sse2;
+                bit_xor = xor_sse2;
+                bit_not = not_sse2;
+                byte_max = max_sse2;
+                if (__builtin_cpu_supports("popcnt"))
+                {
+                    popcount = popcount_popcnt;
+                    if (__builtin_cpu_supports("avx2"))
+                    {
+                        popcount = popcount_avx2;
+                    }
+                }
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    skip = skip_avx2;
+                    bit_and = and_avx2;
+                    bit_or = or_avx2;
+                    bit_xor = xor_avx2;
+                    bit_not = not_avx2;
+                    byte_max = max_avx2;
+                }
+#elif defined(BITOPS_NEON)
+                popcount = popcount_neon;
+                skip = skip_neon;
+                bit_and = and_neon;
+                bit_or = or_neon;
+                bit_xor = xor_neon;
+                bit_not = not_neon;
+                byte_max = max_neon;
+#endif
+            }
+    };
+    static BitopsKernels g_bitops_kernels;
+
+    long bitops_popcount(const void* s, size_t count)
+    {
+        return g_bitops_kernels.popcount((const unsigned char*) s, count);
+    }
+
+    long bitops_bitpos(const void* s, size_t count, int bit)
+    {
+        const unsigned char* p = (const unsigned char*) s;
+        size_t skipped = g_bitops_kernels.skip(p, count, bit ? 0 : 0xff);
+        if (skipped == count)
+        {
+            return bit ? -1 : (long) count * 8;
+        }
+        unsigned char c = bit ? p[skipped] : ~p[skipped];
+        long pos = skipped * 8;
+        while (!(c & 0x80))
+        {
+            c <<= 1;
+            pos++;
+        }
+        return pos;
+    }
+
+    void bitops_and(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        g_bitops_kernels.bit_and(dst, src, len);
+    }
+    void bitops_or(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        g_bitops_kernels.bit_or(dst, src, len);
+    }
+    void bitops_xor(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        g_bitops_kernels.bit_xor(dst, src, len);
+    }
+    void bitops_not(unsigned char* dst, size_t len)
+    {
+        g_bitops_kernels.bit_not(dst, len);
+    }
+    void bitops_max(unsigned char* dst, const unsigned char* src, size_t len)
+    {
+        g_bitops_kernels.byte_max(dst, src, len);
+    }
+}
+
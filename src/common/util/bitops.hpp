@@ -0,0 +1,56 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BITOPS_HPP_
+#define BITOPS_HPP_
+#include "common.hpp"
+
+namespace ardb
+{
+    /*
+     * Bitmap kernels used by BITCOUNT/BITPOS/BITOP, the implementation is picked once at startup
+     * by the cpu features (AVX2, SSE2/POPCNT on x86, NEON on aarch64) with a portable fallback.
+     */
+    long bitops_popcount(const void* s, size_t count);
+    /*
+     * Return the position of the first bit set to 'bit' in 's', if no such bit is found -1 is returned
+     * for bit 1 and count * 8 for bit 0, just like the string is zero padded on the right.
+     */
+    long bitops_bitpos(const void* s, size_t count, int bit);
+    void bitops_and(unsigned char* dst, const unsigned char* src, size_t len);
+    void bitops_or(unsigned char* dst, const unsigned char* src, size_t len);
+    void bitops_xor(unsigned char* dst, const unsigned char* src, size_t len);
+    void bitops_not(unsigned char* dst, size_t len);
+    /*
+     * dst[i] = MAX(dst[i], src[i]) as unsigned bytes, used to merge unpacked HyperLogLog registers.
+     */
+    void bitops_max(unsigned char* dst, const unsigned char* src, size_t len);
+}
+
+#endif /* BITOPS_HPP_ */
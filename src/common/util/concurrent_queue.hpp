@@ -290,6 +290,128 @@ namespace ardb
             }
     };
 
+    /*
+     * Bounded multi-producer/single-consumer ring (Dmitry Vyukov's bounded queue), the producer & consumer
+     * positions live on separate cache lines. Pushing never fails, once the ring is full values go to an
+     * unbounded MPSCQueue until it is drained again. A producer keeps using the overflow queue while
+     * its own overflowed values are pending, and the consumer only reads the overflow queue when the ring
+     * is empty, so the values of one producer are always popped in push order.
+     */
+    template<typename T>
+    class MPSCRingQueue
+    {
+        private:
+            static const uint32 CACHE_LINE_SIZE = 64;
+            struct Cell
+            {
+                    volatile uint64_t sequence;
+                    T value;
+            };
+            Cell* m_cells;
+            uint64_t m_mask;
+            char m_pad0[CACHE_LINE_SIZE];
+            volatile uint64_t m_enqueue_pos;
+            char m_pad1[CACHE_LINE_SIZE];
+            uint64_t m_dequeue_pos;
+            char m_pad2[CACHE_LINE_SIZE];
+            volatile uint64_t m_overflow_count;
+            MPSCQueue<T> m_overflow;
+
+            bool TryPush(const T& value)
+            {
+                uint64_t pos = m_enqueue_pos;
+                while (true)
+                {
+                    Cell* cell = &m_cells[pos & m_mask];
+                    int64_t diff = (int64_t) load_sequence(cell) - (int64_t) pos;
+                    if (0 == diff)
+                    {
+                        if (__sync_bool_compare_and_swap(&m_enqueue_pos, pos, pos + 1))
+                        {
+                            cell->value = value;
+                            __sync_synchronize();
+                            cell->sequence = pos + 1;
+                            return true;
+                        }
+                        pos = m_enqueue_pos;
+                    }
+                    else if (diff < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        pos = m_enqueue_pos;
+                    }
+                }
+            }
+            static uint64_t load_sequence(Cell* cell)
+            {
+                uint64_t seq = cell->sequence;
+                __sync_synchronize();
+                return seq;
+            }
+            MPSCRingQueue(MPSCRingQueue const&);
+            MPSCRingQueue& operator =(MPSCRingQueue const&);
+        public:
+            /*
+             * capacity is rounded up to a power of 2
+             */
+            MPSCRingQueue(uint32 capacity = 4096) :
+                    m_cells(NULL), m_mask(0), m_enqueue_pos(0), m_dequeue_pos(0), m_overflow_count(0)
+            {
+                uint64_t size = 2;
+                while (size < capacity)
+                {
+                    size <<= 1;
+                }
+                m_cells = new Cell[size];
+                for (uint64_t i = 0; i < size; i++)
+                {
+                    m_cells[i].sequence = i;
+                }
+                m_mask = size - 1;
+            }
+            void Push(const T& value)
+            {
+                if (0 == m_overflow_count && TryPush(value))
+                {
+                    return;
+                }
+                __sync_add_and_fetch(&m_overflow_count, 1);
+                m_overflow.Push(value);
+            }
+            bool Pop(T& value)
+            {
+                Cell* cell = &m_cells[m_dequeue_pos & m_mask];
+                if (load_sequence(cell) == m_dequeue_pos + 1)
+                {
+                    value = cell->value;
+                    __sync_synchronize();
+                    cell->sequence = m_dequeue_pos + m_mask + 1;
+                    m_dequeue_pos++;
+                    return true;
+                }
+                /*
+                 * a producer claimed the cell but has not published it yet, it signals the consumer afterwards
+                 */
+                if (m_enqueue_pos != m_dequeue_pos)
+                {
+                    return false;
+                }
+                if (m_overflow.Pop(value))
+                {
+                    __sync_sub_and_fetch(&m_overflow_count, 1);
+                    return true;
+                }
+                return false;
+            }
+            ~MPSCRingQueue()
+            {
+                delete[] m_cells;
+            }
+    };
+
 // load with 'consume' (data-dependent) memory ordering
     template<typename T>
     static T load_consume(T const* addr)
@@ -0,0 +1,21 @@
+/*
+ * CRC16 as used by redis cluster to hash keys to slots(XMODEM: polynomial 0x1021, init 0, no reflection).
+ */
+
+#ifndef _CRC16_H_
+#define _CRC16_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint16_t crc16(const char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _CRC16_H_
@@ -0,0 +1,396 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "mem_arena.hpp"
+#include "util/atomic.hpp"
+#include <stdlib.h>
+#include <stdio.h>
+#include <strings.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#ifdef USE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace ardb
+{
+    static const char* kArenaNames[MEM_ARENA_MAX] = { "keycache", "reply", "lua", "repl" };
+
+    const char* arena_name(MemArenaKind kind)
+    {
+        return kind < MEM_ARENA_MAX ? kArenaNames[kind] : "unknown";
+    }
+
+    MemArenaKind arena_kind(const std::string& name)
+    {
+        for (int i = 0; i < MEM_ARENA_MAX; i++)
+        {
+            if (!strcasecmp(name.c_str(), kArenaNames[i]))
+            {
+                return (MemArenaKind) i;
+            }
+        }
+        return MEM_ARENA_MAX;
+    }
+
+#ifdef MADV_HUGEPAGE
+    static const uintptr_t kHugePageSize = 2 * 1024 * 1024;
+
+    /*
+     * Only the huge page aligned part of the range can be backed by huge pages.
+     */
+    static void advise_hugepage(void* ptr, size_t size)
+    {
+        uintptr_t start = ((uintptr_t) ptr + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        uintptr_t end = ((uintptr_t) ptr + size) & ~(kHugePageSize - 1);
+        if (end > start)
+        {
+            madvise((void*) start, end - start, MADV_HUGEPAGE);
+        }
+    }
+#endif
+
+#ifdef USE_JEMALLOC
+    static unsigned g_arena_index[MEM_ARENA_MAX];
+    static int g_arena_flags[MEM_ARENA_MAX];
+    static pthread_once_t g_arena_once = PTHREAD_ONCE_INIT;
+
+    /*
+     * Arenas are created on first use, an arena failed to be created falls back to the default ones.
+     */
+    static void create_arenas()
+    {
+        for (int i = 0; i < MEM_ARENA_MAX; i++)
+        {
+            unsigned idx = 0;
+            size_t sz = sizeof(idx);
+            if (0 == mallctl("arenas.extend", &idx, &sz, NULL, 0))
+            {
+                g_arena_index[i] = idx;
+                g_arena_flags[i] = MALLOCX_ARENA(idx) | MALLOCX_TCACHE_NONE;
+            }
+            else
+            {
+                g_arena_index[i] = (unsigned) -1;
+                g_arena_flags[i] = 0;
+            }
+        }
+    }
+
+    static inline int arena_flags(MemArenaKind kind)
+    {
+        pthread_once(&g_arena_once, create_arenas);
+        return g_arena_flags[kind];
+    }
+
+    void* arena_malloc(MemArenaKind kind, size_t size)
+    {
+        return mallocx(size > 0 ? size : 1, arena_flags(kind));
+    }
+
+    void* arena_realloc(MemArenaKind kind, void* ptr, size_t size)
+    {
+        if (NULL == ptr)
+        {
+            return arena_malloc(kind, size);
+        }
+        return rallocx(ptr, size > 0 ? size : 1, arena_flags(kind));
+    }
+
+    void arena_free(MemArenaKind kind, void* ptr)
+    {
+        if (NULL != ptr)
+        {
+            dallocx(ptr, arena_flags(kind) & MALLOCX_TCACHE_NONE);
+        }
+    }
+
+    static void refresh_stats()
+    {
+        uint64_t epoch = 1;
+        size_t sz = sizeof(epoch);
+        mallctl("epoch", &epoch, &sz, &epoch, sz);
+    }
+
+    template<typename T>
+    static T arena_ctl(unsigned idx, const char* name)
+    {
+        char path[128];
+        snprintf(path, sizeof(path), "stats.arenas.%u.%s", idx, name);
+        T v = 0;
+        size_t sz = sizeof(v);
+        mallctl(path, &v, &sz, NULL, 0);
+        return v;
+    }
+
+    void arena_stats(MemArenaKind kind, MemArenaStats& stats)
+    {
+        arena_flags(kind);
+        unsigned idx = g_arena_index[kind];
+        if (idx == (unsigned) -1)
+        {
+            return;
+        }
+        refresh_stats();
+        size_t page = 4096;
+        size_t sz = sizeof(page);
+        mallctl("arenas.page", &page, &sz, NULL, 0);
+        stats.allocated = arena_ctl<size_t>(idx, "small.allocated") + arena_ctl<size_t>(idx, "large.allocated") + arena_ctl<size_t>(idx, "huge.allocated");
+        stats.active = arena_ctl<size_t>(idx, "pactive") * page;
+        stats.dirty = arena_ctl<size_t>(idx, "pdirty") * page;
+        stats.allocs = arena_ctl<uint64_t>(idx, "small.nmalloc") + arena_ctl<uint64_t>(idx, "large.nmalloc") + arena_ctl<uint64_t>(idx, "huge.nmalloc");
+    }
+
+    int arena_purge(MemArenaKind kind)
+    {
+        arena_flags(kind);
+        unsigned idx = g_arena_index[kind];
+        if (idx == (unsigned) -1)
+        {
+            return -1;
+        }
+        char path[64];
+        snprintf(path, sizeof(path), "arena.%u.purge", idx);
+        return mallctl(path, NULL, NULL, NULL, 0);
+    }
+
+#ifdef MADV_HUGEPAGE
+    static chunk_hooks_t g_default_chunk_hooks;
+
+    static void* hugepage_chunk_alloc(void* new_addr, size_t size, size_t alignment, bool* zero, bool* commit, unsigned arena_ind)
+    {
+        void* chunk = g_default_chunk_hooks.alloc(new_addr, size, alignment, zero, commit, arena_ind);
+        if (NULL != chunk)
+        {
+            advise_hugepage(chunk, size);
+        }
+        return chunk;
+    }
+#endif
+
+    int arena_use_hugepage(MemArenaKind kind)
+    {
+#ifdef MADV_HUGEPAGE
+        arena_flags(kind);
+        unsigned idx = g_arena_index[kind];
+        if (idx == (unsigned) -1)
+        {
+            return -1;
+        }
+        char path[64];
+        snprintf(path, sizeof(path), "arena.%u.chunk_hooks", idx);
+        chunk_hooks_t hooks;
+        size_t sz = sizeof(hooks);
+        if (0 != mallctl(path, &hooks, &sz, NULL, 0))
+        {
+            return -1;
+        }
+        if (hooks.alloc == hugepage_chunk_alloc)
+        {
+            return 0;
+        }
+        g_default_chunk_hooks = hooks;
+        hooks.alloc = hugepage_chunk_alloc;
+        return mallctl(path, NULL, NULL, &hooks, sizeof(hooks));
+#else
+        return -1;
+#endif
+    }
+
+    void malloc_stats(std::string& str)
+    {
+        refresh_stats();
+        const char* names[] = { "allocated", "active", "resident", "mapped" };
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+        {
+            char path[64], line[128];
+            snprintf(path, sizeof(path), "stats.%s", names[i]);
+            size_t v = 0;
+            size_t sz = sizeof(v);
+            mallctl(path, &v, &sz, NULL, 0);
+            snprintf(line, sizeof(line), "allocator_%s:%zu\r\n", names[i], v);
+            str.append(line);
+        }
+        str.append("mem_allocator:jemalloc-").append(JEMALLOC_VERSION).append("\r\n");
+    }
+
+    /*
+     * The stats of arena 'arenas.narenas' are the ones merged from all arenas.
+     */
+    bool malloc_frag_stats(MallocFragStats& stats)
+    {
+        refresh_stats();
+        unsigned narenas = 0;
+        size_t sz = sizeof(narenas);
+        if (0 != mallctl("arenas.narenas", &narenas, &sz, NULL, 0))
+        {
+            return false;
+        }
+        size_t page = 4096, v = 0;
+        sz = sizeof(page);
+        mallctl("arenas.page", &page, &sz, NULL, 0);
+        sz = sizeof(v);
+        mallctl("stats.allocated", &v, &sz, NULL, 0);
+        stats.allocated = v;
+        mallctl("stats.active", &v, &sz, NULL, 0);
+        stats.active = v;
+        mallctl("stats.resident", &v, &sz, NULL, 0);
+        stats.resident = v;
+        stats.dirty = arena_ctl<size_t>(narenas, "pdirty") * page;
+        return true;
+    }
+
+    int malloc_purge_all()
+    {
+        unsigned narenas = 0;
+        size_t sz = sizeof(narenas);
+        if (0 != mallctl("arenas.narenas", &narenas, &sz, NULL, 0))
+        {
+            return -1;
+        }
+        char path[64];
+        snprintf(path, sizeof(path), "arena.%u.purge", narenas);
+        return mallctl(path, NULL, NULL, NULL, 0);
+    }
+#else
+    static volatile uint64_t g_arena_allocated[MEM_ARENA_MAX];
+    static volatile uint64_t g_arena_allocs[MEM_ARENA_MAX];
+    static bool g_arena_hugepage[MEM_ARENA_MAX];
+
+    static inline size_t usable_size(void* ptr)
+    {
+#if defined(__APPLE__)
+        return malloc_size(ptr);
+#else
+        return malloc_usable_size(ptr);
+#endif
+    }
+
+    void* arena_malloc(MemArenaKind kind, size_t size)
+    {
+        void* ptr = malloc(size);
+        if (NULL != ptr)
+        {
+            atomic_add_uint64(&g_arena_allocated[kind], usable_size(ptr));
+            atomic_add_uint64(&g_arena_allocs[kind], 1);
+#ifdef MADV_HUGEPAGE
+            if (g_arena_hugepage[kind] && size >= kHugePageSize)
+            {
+                advise_hugepage(ptr, size);
+            }
+#endif
+        }
+        return ptr;
+    }
+
+    void* arena_realloc(MemArenaKind kind, void* ptr, size_t size)
+    {
+        if (NULL == ptr)
+        {
+            return arena_malloc(kind, size);
+        }
+        size_t old_size = usable_size(ptr);
+        void* newptr = realloc(ptr, size);
+        if (NULL != newptr)
+        {
+            atomic_sub_uint64(&g_arena_allocated[kind], old_size);
+            atomic_add_uint64(&g_arena_allocated[kind], usable_size(newptr));
+#ifdef MADV_HUGEPAGE
+            if (g_arena_hugepage[kind] && size >= kHugePageSize)
+            {
+                advise_hugepage(newptr, size);
+            }
+#endif
+        }
+        return newptr;
+    }
+
+    void arena_free(MemArenaKind kind, void* ptr)
+    {
+        if (NULL != ptr)
+        {
+            atomic_sub_uint64(&g_arena_allocated[kind], usable_size(ptr));
+            free(ptr);
+        }
+    }
+
+    void arena_stats(MemArenaKind kind, MemArenaStats& stats)
+    {
+        stats.allocated = g_arena_allocated[kind];
+        stats.allocs = g_arena_allocs[kind];
+    }
+
+    int arena_purge(MemArenaKind kind)
+    {
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+        return 0;
+    }
+
+    bool malloc_frag_stats(MallocFragStats& stats)
+    {
+        return false;
+    }
+
+    int malloc_purge_all()
+    {
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+        return 0;
+    }
+
+    int arena_use_hugepage(MemArenaKind kind)
+    {
+#ifdef MADV_HUGEPAGE
+        g_arena_hugepage[kind] = true;
+        return 0;
+#else
+        return -1;
+#endif
+    }
+
+    void malloc_stats(std::string& str)
+    {
+#if defined(__GLIBC__)
+        struct mallinfo mi = mallinfo();
+        char line[128];
+        snprintf(line, sizeof(line), "allocator_allocated:%u\r\n", (unsigned) mi.uordblks);
+        str.append(line);
+        snprintf(line, sizeof(line), "allocator_mapped:%u\r\n", (unsigned) (mi.arena + mi.hblkhd));
+        str.append(line);
+#endif
+        str.append("mem_allocator:libc\r\n");
+    }
+#endif
+}
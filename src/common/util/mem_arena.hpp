@@ -0,0 +1,176 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MEM_ARENA_HPP_
+#define MEM_ARENA_HPP_
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <string>
+
+namespace ardb
+{
+    /*
+     * Subsystems whose heap memory is accounted apart. With jemalloc(USE_JEMALLOC) each one allocates
+     * from a dedicated arena bypassing the thread caches, so its pages can be purged on their own,
+     * otherwise allocations go to malloc & are only counted.
+     */
+    enum MemArenaKind
+    {
+        MEM_ARENA_KEYCACHE = 0, MEM_ARENA_REPLY = 1, MEM_ARENA_LUA = 2, MEM_ARENA_REPL = 3, MEM_ARENA_MAX = 4,
+    };
+
+    struct MemArenaStats
+    {
+            uint64_t allocated; //bytes in use
+            uint64_t active;    //bytes of the pages holding them, 0 without jemalloc
+            uint64_t dirty;     //bytes of unused pages not returned to the OS yet, 0 without jemalloc
+            uint64_t allocs;
+            MemArenaStats() :
+                    allocated(0), active(0), dirty(0), allocs(0)
+            {
+            }
+    };
+
+    void* arena_malloc(MemArenaKind kind, size_t size);
+    void* arena_realloc(MemArenaKind kind, void* ptr, size_t size);
+    void arena_free(MemArenaKind kind, void* ptr);
+
+    const char* arena_name(MemArenaKind kind);
+    /*
+     * 'kind' is matched case insensitively against arena_name, MEM_ARENA_MAX if unknown.
+     */
+    MemArenaKind arena_kind(const std::string& name);
+    void arena_stats(MemArenaKind kind, MemArenaStats& stats);
+    /*
+     * Return the unused pages of the arena to the OS, the whole heap without jemalloc.
+     */
+    int arena_purge(MemArenaKind kind);
+    /*
+     * Back the arena with transparent huge pages(madvise MADV_HUGEPAGE): every new chunk of the arena with
+     * jemalloc, allocations of at least one huge page otherwise. Call it before the arena is used,
+     * -1 if not supported.
+     */
+    int arena_use_hugepage(MemArenaKind kind);
+    /*
+     * Allocator stats of the whole process, "key:value\r\n" lines.
+     */
+    void malloc_stats(std::string& str);
+
+    struct MallocFragStats
+    {
+            uint64_t allocated; //bytes in use
+            uint64_t active;    //bytes of the pages holding them
+            uint64_t resident;  //bytes of the pages mapped by the allocator & backed by memory
+            uint64_t dirty;     //bytes of unused pages of all arenas not returned to the OS yet
+            MallocFragStats() :
+                    allocated(0), active(0), resident(0), dirty(0)
+            {
+            }
+    };
+    /*
+     * Allocator stats of the whole process, false without jemalloc.
+     */
+    bool malloc_frag_stats(MallocFragStats& stats);
+    /*
+     * Return the unused pages of all arenas to the OS, the whole heap without jemalloc.
+     */
+    int malloc_purge_all();
+
+    /*
+     * STL allocator over an arena.
+     */
+    template<typename T, MemArenaKind K>
+    class ArenaAllocator
+    {
+        public:
+            typedef T value_type;
+            typedef T* pointer;
+            typedef const T* const_pointer;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            template<typename U>
+            struct rebind
+            {
+                    typedef ArenaAllocator<U, K> other;
+            };
+            ArenaAllocator()
+            {
+            }
+            template<typename U>
+            ArenaAllocator(const ArenaAllocator<U, K>&)
+            {
+            }
+            pointer address(reference x) const
+            {
+                return &x;
+            }
+            const_pointer address(const_reference x) const
+            {
+                return &x;
+            }
+            pointer allocate(size_type n, const void* = 0)
+            {
+                void* p = arena_malloc(K, n * sizeof(T));
+                if (NULL == p)
+                {
+                    throw std::bad_alloc();
+                }
+                return (pointer) p;
+            }
+            void deallocate(pointer p, size_type)
+            {
+                arena_free(K, p);
+            }
+            size_type max_size() const
+            {
+                return size_t(-1) / sizeof(T);
+            }
+            void construct(pointer p, const T& v)
+            {
+                new ((void*) p) T(v);
+            }
+            void destroy(pointer p)
+            {
+                p->~T();
+            }
+            bool operator==(const ArenaAllocator&) const
+            {
+                return true;
+            }
+            bool operator!=(const ArenaAllocator&) const
+            {
+                return false;
+            }
+    };
+}
+
+#endif /* MEM_ARENA_HPP_ */
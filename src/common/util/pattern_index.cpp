@@ -0,0 +1,140 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "pattern_index.hpp"
+#include "string_helper.hpp"
+
+namespace ardb
+{
+    static size_t literal_prefix_length(const std::string& pattern)
+    {
+        size_t i = 0;
+        while (i < pattern.size() && pattern[i] != '*' && pattern[i] != '?' && pattern[i] != '[' && pattern[i] != '\\')
+        {
+            i++;
+        }
+        return i;
+    }
+
+    GlobPatternIndex::Node::~Node()
+    {
+        ChildTable::iterator it = children.begin();
+        while (it != children.end())
+        {
+            delete it->second;
+            it++;
+        }
+    }
+
+    bool GlobPatternIndex::Add(const std::string& pattern)
+    {
+        size_t prefix_len = literal_prefix_length(pattern);
+        Node* node = &m_root;
+        for (size_t i = 0; i < prefix_len; i++)
+        {
+            Node*& child = node->children[pattern[i]];
+            if (NULL == child)
+            {
+                child = new Node;
+            }
+            node = child;
+        }
+        std::set<std::string>& patterns = prefix_len == pattern.size() ? node->literals : node->globs;
+        if (!patterns.insert(pattern).second)
+        {
+            return false;
+        }
+        m_size++;
+        return true;
+    }
+
+    bool GlobPatternIndex::Remove(Node* node, const std::string& pattern, size_t depth, size_t prefix_len)
+    {
+        if (depth == prefix_len)
+        {
+            std::set<std::string>& patterns = prefix_len == pattern.size() ? node->literals : node->globs;
+            return patterns.erase(pattern) > 0;
+        }
+        Node::ChildTable::iterator it = node->children.find(pattern[depth]);
+        if (it == node->children.end())
+        {
+            return false;
+        }
+        bool removed = Remove(it->second, pattern, depth + 1, prefix_len);
+        if (it->second->Empty())
+        {
+            delete it->second;
+            node->children.erase(it);
+        }
+        return removed;
+    }
+
+    bool GlobPatternIndex::Remove(const std::string& pattern)
+    {
+        if (!Remove(&m_root, pattern, 0, literal_prefix_length(pattern)))
+        {
+            return false;
+        }
+        m_size--;
+        return true;
+    }
+
+    void GlobPatternIndex::Match(const std::string& str, std::vector<const std::string*>& matched) const
+    {
+        const Node* node = &m_root;
+        size_t depth = 0;
+        while (NULL != node)
+        {
+            /*
+             * the literal prefix of the patterns here equals str[0, depth), only the rest is left to match
+             */
+            std::set<std::string>::const_iterator it = node->globs.begin();
+            while (it != node->globs.end())
+            {
+                if (stringmatchlen(it->data() + depth, it->size() - depth, str.data() + depth, str.size() - depth, 0))
+                {
+                    matched.push_back(&(*it));
+                }
+                it++;
+            }
+            if (depth == str.size())
+            {
+                it = node->literals.begin();
+                while (it != node->literals.end())
+                {
+                    matched.push_back(&(*it));
+                    it++;
+                }
+                break;
+            }
+            Node::ChildTable::const_iterator cit = node->children.find(str[depth]);
+            node = cit != node->children.end() ? cit->second : NULL;
+            depth++;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef PATTERN_INDEX_HPP_
+#define PATTERN_INDEX_HPP_
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace ardb
+{
+    /*
+     * Glob patterns(stringmatchlen syntax, case sensitive) kept in a trie by their literal prefix, the part
+     * before the first '*', '?', '[' or '\'. Matching a string walks the trie along the string & only tests
+     * the patterns whose literal prefix is a prefix of it, instead of every pattern.
+     */
+    class GlobPatternIndex
+    {
+        private:
+            struct Node
+            {
+                    typedef std::map<char, Node*> ChildTable;
+                    ChildTable children;
+                    std::set<std::string> literals; //patterns without any wildcard
+                    std::set<std::string> globs;
+                    bool Empty() const
+                    {
+                        return children.empty() && literals.empty() && globs.empty();
+                    }
+                    ~Node();
+            };
+            Node m_root;
+            size_t m_size;
+            bool Remove(Node* node, const std::string& pattern, size_t depth, size_t prefix_len);
+        public:
+            GlobPatternIndex() :
+                    m_size(0)
+            {
+            }
+            /*
+             * return false if the pattern exists already.
+             */
+            bool Add(const std::string& pattern);
+            bool Remove(const std::string& pattern);
+            /*
+             * Append the patterns matching 'str', the pointers are valid until the pattern is removed.
+             */
+            void Match(const std::string& str, std::vector<const std::string*>& matched) const;
+            size_t Size() const
+            {
+                return m_size;
+            }
+    };
+}
+
+#endif /* PATTERN_INDEX_HPP_ */
@@ -0,0 +1,128 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "perfect_hash.hpp"
+#include <algorithm>
+
+namespace ardb
+{
+    typedef std::vector<size_t> BucketKeys;
+    static bool compare_bucket_size(const BucketKeys* a, const BucketKeys* b)
+    {
+        return a->size() > b->size();
+    }
+
+    bool CaseInsensitivePerfectHash::Build(const EntryArray& entries)
+    {
+        m_displacements.clear();
+        m_slots.clear();
+        size_t n = entries.size();
+        if (0 == n)
+        {
+            return true;
+        }
+        std::vector<BucketKeys> buckets(n);
+        std::vector<BucketKeys*> sorted_buckets(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            buckets[Hash(0, entries[i].first.data(), entries[i].first.size()) % n].push_back(i);
+            sorted_buckets[i] = &buckets[i];
+        }
+        std::stable_sort(sorted_buckets.begin(), sorted_buckets.end(), compare_bucket_size);
+
+        std::vector<int32_t> displacements(n, 0);
+        std::vector<int> slot_used(n, -1);
+        size_t i = 0;
+        /*
+         * place buckets with collisions first, search a seed for each one
+         */
+        for (; i < n && sorted_buckets[i]->size() > 1; i++)
+        {
+            BucketKeys& bucket = *sorted_buckets[i];
+            uint32_t d = 1;
+            std::vector<size_t> slots;
+            while (true)
+            {
+                slots.clear();
+                bool fit = true;
+                for (size_t k = 0; k < bucket.size() && fit; k++)
+                {
+                    const std::string& key = entries[bucket[k]].first;
+                    size_t slot = Hash(d, key.data(), key.size()) % n;
+                    if (slot_used[slot] >= 0 || std::find(slots.begin(), slots.end(), slot) != slots.end())
+                    {
+                        fit = false;
+                    }
+                    slots.push_back(slot);
+                }
+                if (fit)
+                {
+                    break;
+                }
+                d++;
+                if (d > 1000000)
+                {
+                    /*
+                     * duplicate keys never fit
+                     */
+                    return false;
+                }
+            }
+            const std::string& key = entries[bucket[0]].first;
+            displacements[Hash(0, key.data(), key.size()) % n] = (int32_t) d;
+            for (size_t k = 0; k < bucket.size(); k++)
+            {
+                slot_used[slots[k]] = (int) bucket[k];
+            }
+        }
+        /*
+         * buckets with single key are put into free slots directly, the slot is encoded as negative displacement
+         */
+        size_t free_slot = 0;
+        for (; i < n && sorted_buckets[i]->size() == 1; i++)
+        {
+            while (slot_used[free_slot] >= 0)
+            {
+                free_slot++;
+            }
+            size_t idx = sorted_buckets[i]->at(0);
+            const std::string& key = entries[idx].first;
+            displacements[Hash(0, key.data(), key.size()) % n] = -(int32_t) free_slot - 1;
+            slot_used[free_slot] = (int) idx;
+        }
+        m_slots.resize(n);
+        for (size_t k = 0; k < n; k++)
+        {
+            m_slots[k] = entries[slot_used[k]];
+        }
+        m_displacements.swap(displacements);
+        return true;
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef PERFECT_HASH_HPP_
+#define PERFECT_HASH_HPP_
+#include "common.hpp"
+#include <string.h>
+#include <strings.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace ardb
+{
+    /*
+     * Minimal perfect hash over a fixed set of case insensitive strings, built by 'hash and displace':
+     * keys are hashed into buckets first, then every bucket searches a displacement seed which moves
+     * all its keys into free slots. A lookup costs two hash computations and one string compare.
+     */
+    class CaseInsensitivePerfectHash
+    {
+        public:
+            typedef std::pair<std::string, int> Entry;
+            typedef std::vector<Entry> EntryArray;
+        private:
+            std::vector<int32_t> m_displacements;
+            EntryArray m_slots;
+            static uint32_t Hash(uint32_t seed, const char* str, size_t len)
+            {
+                uint32_t h = seed == 0 ? 0x811c9dc5 : seed;
+                for (size_t i = 0; i < len; i++)
+                {
+                    unsigned char c = str[i];
+                    if (c >= 'A' && c <= 'Z')
+                    {
+                        c += 'a' - 'A';
+                    }
+                    h = (h ^ c) * 0x01000193;
+                }
+                return h;
+            }
+        public:
+            /*
+             * keys must be distinct(case insensitive), return false if failed to build.
+             */
+            bool Build(const EntryArray& entries);
+            int Get(const char* key, size_t len, int default_value) const
+            {
+                if (m_slots.empty())
+                {
+                    return default_value;
+                }
+                size_t n = m_slots.size();
+                int32_t d = m_displacements[Hash(0, key, len) % n];
+                const Entry& slot = m_slots[d < 0 ? (-d - 1) : Hash(d, key, len) % n];
+                if (slot.first.size() != len || strncasecmp(slot.first.data(), key, len) != 0)
+                {
+                    return default_value;
+                }
+                return slot.second;
+            }
+            size_t Size() const
+            {
+                return m_slots.size();
+            }
+    };
+}
+
+#endif /* PERFECT_HASH_HPP_ */
@@ -0,0 +1,65 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PROBES_HPP_
+#define PROBES_HPP_
+
+/*
+ * Static tracepoints for bpftrace/bcc/perf, built in with 'make USDT=1' which needs <sys/sdt.h>(systemtap-sdt-dev).
+ * A probe is a nop in the code until a tracer attaches to it, the provider is 'ardb':
+ *
+ *   command__start(type, ns, ns_len, key_len)         command__done(type, ns, ns_len, key_len, micros)
+ *   lock__wait(key_len)                                lock__acquired(key_len, wait_micros)
+ *   engine__get__start(ns, ns_len, key_len)            engine__get__done(err)
+ *   engine__put__start(ns, ns_len, key_len)            engine__put__done(err)
+ *   engine__commit__start()                            engine__commit__done()
+ *   engine__seek__start(key_len)                       engine__seek__done(valid)
+ *   wal__append(bytes)                                 wal__sync__start()      wal__sync__done()
+ *   snapshot__state(state, type)
+ *
+ * e.g. bpftrace -e 'usdt:./ardb-server:ardb:command__done { @us[arg0] = hist(arg4); }'
+ */
+#ifdef USE_USDT
+#include <sys/sdt.h>
+#define ARDB_PROBE(name) DTRACE_PROBE(ardb, name)
+#define ARDB_PROBE1(name, a1) DTRACE_PROBE1(ardb, name, a1)
+#define ARDB_PROBE2(name, a1, a2) DTRACE_PROBE2(ardb, name, a1, a2)
+#define ARDB_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(ardb, name, a1, a2, a3)
+#define ARDB_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(ardb, name, a1, a2, a3, a4)
+#define ARDB_PROBE5(name, a1, a2, a3, a4, a5) DTRACE_PROBE5(ardb, name, a1, a2, a3, a4, a5)
+#else
+#define ARDB_PROBE(name) do {} while (0)
+#define ARDB_PROBE1(name, a1) do {} while (0)
+#define ARDB_PROBE2(name, a1, a2) do {} while (0)
+#define ARDB_PROBE3(name, a1, a2, a3) do {} while (0)
+#define ARDB_PROBE4(name, a1, a2, a3, a4) do {} while (0)
+#define ARDB_PROBE5(name, a1, a2, a3, a4, a5) do {} while (0)
+#endif
+
+#endif /* PROBES_HPP_ */
@@ -852,6 +852,65 @@ namespace ardb
         return ret;
     }
 
+    static const char kBase64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    void base64_encode(const char* data, size_t len, std::string& out)
+    {
+        out.clear();
+        out.reserve((len * 4 + 2) / 3);
+        const unsigned char* s = (const unsigned char*) data;
+        size_t i = 0;
+        for (; i + 2 < len; i += 3)
+        {
+            uint32 v = (s[i] << 16) | (s[i + 1] << 8) | s[i + 2];
+            out.push_back(kBase64Chars[(v >> 18) & 0x3f]);
+            out.push_back(kBase64Chars[(v >> 12) & 0x3f]);
+            out.push_back(kBase64Chars[(v >> 6) & 0x3f]);
+            out.push_back(kBase64Chars[v & 0x3f]);
+        }
+        if (i + 1 == len)
+        {
+            uint32 v = s[i] << 16;
+            out.push_back(kBase64Chars[(v >> 18) & 0x3f]);
+            out.push_back(kBase64Chars[(v >> 12) & 0x3f]);
+        }
+        else if (i + 2 == len)
+        {
+            uint32 v = (s[i] << 16) | (s[i + 1] << 8);
+            out.push_back(kBase64Chars[(v >> 18) & 0x3f]);
+            out.push_back(kBase64Chars[(v >> 12) & 0x3f]);
+            out.push_back(kBase64Chars[(v >> 6) & 0x3f]);
+        }
+    }
+
+    bool base64_decode(const std::string& str, std::string& out)
+    {
+        out.clear();
+        if (str.size() % 4 == 1)
+        {
+            return false;
+        }
+        out.reserve(str.size() * 3 / 4);
+        uint32 v = 0;
+        int bits = 0;
+        for (size_t i = 0; i < str.size(); i++)
+        {
+            const char* p = strchr(kBase64Chars, str[i]);
+            if (NULL == p || 0 == str[i])
+            {
+                return false;
+            }
+            v = (v << 6) | (uint32) (p - kBase64Chars);
+            bits += 6;
+            if (bits >= 8)
+            {
+                bits -= 8;
+                out.push_back((char) ((v >> bits) & 0xff));
+            }
+        }
+        return true;
+    }
+
     std::string stringfromll(int64 value)
     {
         size_t l;
@@ -138,6 +138,11 @@ namespace ardb
 
     std::string stringfromll(int64 v);
     std::string base16_stringfromllu(uint64 v);
+    /*
+     * URL safe base64 without padding, decode returns false on invalid input.
+     */
+    void base64_encode(const char* data, size_t len, std::string& out);
+    bool base64_decode(const std::string& str, std::string& out);
 
     template<typename T>
     std::string string_join_container(const T& container, const std::string& sep)
@@ -28,7 +28,11 @@
  */
 
 #include "system_helper.hpp"
+#include "string_helper.hpp"
 #include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
 #if  __APPLE__
 #include <sys/param.h>
 #include <sys/sysctl.h>
@@ -72,6 +76,57 @@ namespace ardb
 		return ret;
 	}
 
+	bool parse_cpu_list(const std::string& str, std::vector<int>& cpus)
+	{
+		cpus.clear();
+		std::vector<std::string> ranges = split_string(str, ",");
+		for (size_t i = 0; i < ranges.size(); i++)
+		{
+			std::string range = trim_string(ranges[i]);
+			if (range.empty())
+			{
+				continue;
+			}
+			uint32 lo, hi;
+			size_t pos = range.find('-');
+			if (pos == std::string::npos)
+			{
+				if (!string_touint32(range, lo))
+				{
+					return false;
+				}
+				hi = lo;
+			}
+			else if (!string_touint32(trim_string(range.substr(0, pos)), lo) || !string_touint32(trim_string(range.substr(pos + 1)), hi) || hi < lo)
+			{
+				return false;
+			}
+			for (uint32 cpu = lo; cpu <= hi; cpu++)
+			{
+				cpus.push_back((int) cpu);
+			}
+		}
+		return true;
+	}
+
+	int bind_current_thread(const std::vector<int>& cpus)
+	{
+#ifdef __linux__
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (size_t i = 0; i < cpus.size(); i++)
+		{
+			if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE)
+			{
+				CPU_SET(cpus[i], &set);
+			}
+		}
+		return 0 == sched_setaffinity(0, sizeof(set), &set) ? 0 : -1;
+#else
+		return -1;
+#endif
+	}
+
 #if defined(HAVE_PROC_STAT)
 #include <unistd.h>
 #include <sys/types.h>
@@ -35,12 +35,21 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <string>
+#include <vector>
 #include "common.hpp"
 
 namespace ardb
 {
     uint32 available_processors();
     size_t mem_rss_size();
+    /*
+     * Parse a cpu list like "0-3,8,10-11", false if it is malformed.
+     */
+    bool parse_cpu_list(const std::string& str, std::vector<int>& cpus);
+    /*
+     * Restrict the calling thread to 'cpus', -1 if failed or not supported(linux only).
+     */
+    int bind_current_thread(const std::vector<int>& cpus);
     inline bool is_bigendian()
     {
         static int bigendian = -1;
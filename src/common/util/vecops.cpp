@@ -0,0 +1,303 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "util/vecops.hpp"
+#include <math.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define VECOPS_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define VECOPS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace ardb
+{
+    static float dot_f32_scalar(const float* a, const float* b, size_t n)
+    {
+        float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < n; i++)
+        {
+            s0 += a[i] * b[i];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    static int32_t dot_i8_scalar(const int8_t* a, const int8_t* b, size_t n)
+    {
+        int32_t s = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            s += (int32_t) a[i] * b[i];
+        }
+        return s;
+    }
+
+    static size_t geo_box_filter_scalar(const double* lons, const double* lats, size_t n, double lon, double lat, double lon_delta, double lat_delta,
+            uint8_t* keeps)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            double dx = fabs(lons[i] - lon);
+            dx = dx < 360.0 - dx ? dx : 360.0 - dx;
+            keeps[i] = dx <= lon_delta && fabs(lats[i] - lat) <= lat_delta;
+            kept += keeps[i];
+        }
+        return kept;
+    }
+
+#if defined(VECOPS_X86)
+    static float dot_f32_sse2(const float* a, const float* b, size_t n)
+    {
+        __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(s0, s1));
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dot_f32_scalar(a + i, b + i, n - i);
+    }
+
+    /*
+     * Bytes are sign extended to 16bit lanes, _mm_madd_epi16 sums the products of adjacent lanes into 32bit.
+     */
+    static int32_t dot_i8_sse2(const int8_t* a, const int8_t* b, size_t n)
+    {
+        __m128i sum = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i va = _mm_loadu_si128((const __m128i*) (a + i));
+            __m128i vb = _mm_loadu_si128((const __m128i*) (b + i));
+            __m128i sa = _mm_cmpgt_epi8(_mm_setzero_si128(), va);
+            __m128i sb = _mm_cmpgt_epi8(_mm_setzero_si128(), vb);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(va, sa), _mm_unpacklo_epi8(vb, sb)));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpackhi_epi8(va, sa), _mm_unpackhi_epi8(vb, sb)));
+        }
+        int32_t lanes[4];
+        _mm_storeu_si128((__m128i*) lanes, sum);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dot_i8_scalar(a + i, b + i, n - i);
+    }
+
+    static size_t geo_box_filter_sse2(const double* lons, const double* lats, size_t n, double lon, double lat, double lon_delta, double lat_delta,
+            uint8_t* keeps)
+    {
+        const __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+        __m128d vlon = _mm_set1_pd(lon), vlat = _mm_set1_pd(lat), vlon_delta = _mm_set1_pd(lon_delta), vlat_delta = _mm_set1_pd(lat_delta);
+        __m128d round = _mm_set1_pd(360.0);
+        size_t kept = 0, i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d dx = _mm_and_pd(_mm_sub_pd(_mm_loadu_pd(lons + i), vlon), abs_mask);
+            dx = _mm_min_pd(dx, _mm_sub_pd(round, dx));
+            __m128d dy = _mm_and_pd(_mm_sub_pd(_mm_loadu_pd(lats + i), vlat), abs_mask);
+            int mask = _mm_movemask_pd(_mm_and_pd(_mm_cmple_pd(dx, vlon_delta), _mm_cmple_pd(dy, vlat_delta)));
+            keeps[i] = mask & 1;
+            keeps[i + 1] = (mask >> 1) & 1;
+            kept += keeps[i] + keeps[i + 1];
+        }
+        return kept + geo_box_filter_scalar(lons + i, lats + i, n - i, lon, lat, lon_delta, lat_delta, keeps + i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static float dot_f32_avx2(const float* a, const float* b, size_t n)
+    {
+        __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+            s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), s1);
+        }
+        float lanes[8];
+        _mm256_storeu_ps(lanes, _mm256_add_ps(s0, s1));
+        float s = 0;
+        for (int j = 0; j < 8; j++)
+        {
+            s += lanes[j];
+        }
+        return s + dot_f32_scalar(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    static int32_t dot_i8_avx2(const int8_t* a, const int8_t* b, size_t n)
+    {
+        __m256i sum = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a + i)));
+            __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (b + i)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(va, vb));
+        }
+        int32_t lanes[8];
+        _mm256_storeu_si256((__m256i*) lanes, sum);
+        int32_t s = 0;
+        for (int j = 0; j < 8; j++)
+        {
+            s += lanes[j];
+        }
+        return s + dot_i8_scalar(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx")))
+    static size_t geo_box_filter_avx(const double* lons, const double* lats, size_t n, double lon, double lat, double lon_delta, double lat_delta,
+            uint8_t* keeps)
+    {
+        const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+        __m256d vlon = _mm256_set1_pd(lon), vlat = _mm256_set1_pd(lat), vlon_delta = _mm256_set1_pd(lon_delta), vlat_delta = _mm256_set1_pd(lat_delta);
+        __m256d round = _mm256_set1_pd(360.0);
+        size_t kept = 0, i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d dx = _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(lons + i), vlon), abs_mask);
+            dx = _mm256_min_pd(dx, _mm256_sub_pd(round, dx));
+            __m256d dy = _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(lats + i), vlat), abs_mask);
+            int mask = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(dx, vlon_delta, _CMP_LE_OQ), _mm256_cmp_pd(dy, vlat_delta, _CMP_LE_OQ)));
+            for (int j = 0; j < 4; j++)
+            {
+                keeps[i + j] = (mask >> j) & 1;
+                kept += keeps[i + j];
+            }
+        }
+        return kept + geo_box_filter_scalar(lons + i, lats + i, n - i, lon, lat, lon_delta, lat_delta, keeps + i);
+    }
+#endif
+
+#if defined(VECOPS_NEON)
+    static float dot_f32_neon(const float* a, const float* b, size_t n)
+    {
+        float32x4_t s0 = vdupq_n_f32(0), s1 = vdupq_n_f32(0);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = vfmaq_f32(s0, vld1q_f32(a + i), vld1q_f32(b + i));
+            s1 = vfmaq_f32(s1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        }
+        return vaddvq_f32(vaddq_f32(s0, s1)) + dot_f32_scalar(a + i, b + i, n - i);
+    }
+
+    static int32_t dot_i8_neon(const int8_t* a, const int8_t* b, size_t n)
+    {
+        int32x4_t sum = vdupq_n_s32(0);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            int8x16_t va = vld1q_s8(a + i);
+            int8x16_t vb = vld1q_s8(b + i);
+            sum = vpadalq_s16(sum, vmull_s8(vget_low_s8(va), vget_low_s8(vb)));
+            sum = vpadalq_s16(sum, vmull_s8(vget_high_s8(va), vget_high_s8(vb)));
+        }
+        return vaddvq_s32(sum) + dot_i8_scalar(a + i, b + i, n - i);
+    }
+
+    static size_t geo_box_filter_neon(const double* lons, const double* lats, size_t n, double lon, double lat, double lon_delta, double lat_delta,
+            uint8_t* keeps)
+    {
+        float64x2_t vlon = vdupq_n_f64(lon), vlat = vdupq_n_f64(lat), vlon_delta = vdupq_n_f64(lon_delta), vlat_delta = vdupq_n_f64(lat_delta);
+        float64x2_t round = vdupq_n_f64(360.0);
+        size_t kept = 0, i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            float64x2_t dx = vabdq_f64(vld1q_f64(lons + i), vlon);
+            dx = vminq_f64(dx, vsubq_f64(round, dx));
+            float64x2_t dy = vabdq_f64(vld1q_f64(lats + i), vlat);
+            uint64x2_t in = vandq_u64(vcleq_f64(dx, vlon_delta), vcleq_f64(dy, vlat_delta));
+            keeps[i] = vgetq_lane_u64(in, 0) != 0;
+            keeps[i + 1] = vgetq_lane_u64(in, 1) != 0;
+            kept += keeps[i] + keeps[i + 1];
+        }
+        return kept + geo_box_filter_scalar(lons + i, lats + i, n - i, lon, lat, lon_delta, lat_delta, keeps + i);
+    }
+#endif
+
+    struct VecopsKernels
+    {
+            float (*dot_f32)(const float* a, const float* b, size_t n);
+            int32_t (*dot_i8)(const int8_t* a, const int8_t* b, size_t n);
+            size_t (*geo_box_filter)(const double* lons, const double* lats, size_t n, double lon, double lat, double lon_delta, double lat_delta,
+                    uint8_t* keeps);
+            VecopsKernels() :
+                    dot_f32(dot_f32_scalar), dot_i8(dot_i8_scalar), geo_box_filter(geo_box_filter_scalar)
+            {
+#if defined(VECOPS_X86)
+                __builtin_cpu_init();
+                dot_f32 = dot_f32_sse2;
+                dot_i8 = dot_i8_sse2;
+                geo_box_filter = geo_box_filter_sse2;
+                if (__builtin_cpu_supports("avx"))
+                {
+                    geo_box_filter = geo_box_filter_avx;
+                }
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    dot_i8 = dot_i8_avx2;
+                    if (__builtin_cpu_supports("fma"))
+                    {
+                        dot_f32 = dot_f32_avx2;
+                    }
+                }
+#elif defined(VECOPS_NEON)
+                dot_f32 = dot_f32_neon;
+                dot_i8 = dot_i8_neon;
+                geo_box_filter = geo_box_filter_neon;
+#endif
+            }
+    };
+    static VecopsKernels g_vecops_kernels;
+
+    float vecops_dot_f32(const float* a, const float* b, size_t n)
+    {
+        return g_vecops_kernels.dot_f32(a, b, n);
+    }
+
+    int32_t vecops_dot_i8(const int8_t* a, const int8_t* b, size_t n)
+    {
+        return g_vecops_kernels.dot_i8(a, b, n);
+    }
+
+    size_t vecops_geo_box_filter(const double* lons, const double* lats, size_t n, double lon, double lat, double lon_delta, double lat_delta,
+            uint8_t* keeps)
+    {
+        return g_vecops_kernels.geo_box_filter(lons, lats, n, lon, lat, lon_delta, lat_delta, keeps);
+    }
+}
@@ -1,4 +1,4 @@
- /*
+/*
  *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
  *All rights reserved.
  * 
@@ -27,43 +27,24 @@
  *THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef TIMER_TASK_QUEUE_HPP_
-#define TIMER_TASK_QUEUE_HPP_
+#ifndef VECOPS_HPP_
+#define VECOPS_HPP_
 #include "common.hpp"
-#include "timer_task.hpp"
+
 namespace ardb
 {
-
-	class TimerTaskQueue
-	{
-		private:
-			TimerTask** m_queue;
-			uint32 m_queue_capacity;
-			uint32 m_size;
-			void FixUp(uint32 k);
-			void FixDown(uint32 k);
-		public:
-			TimerTaskQueue();
-			inline uint32 GetSize()
-			{
-				return m_size;
-			}
-			inline bool IsEmpty()
-			{
-				return m_size == 0;
-			}
-			void Add(TimerTask* task);
-			TimerTask* Get(uint32 i);
-			TimerTask* GetMin();
-			void RemoveMin();
-			void QuickRemove(uint32 i);
-			void Heapify();
-			void Clear();
-			int32 FindTaskIndex(TimerTask* task);
-			void RescheduleMin(uint64 newTime);
-			bool RescheduleTask(TimerTask* task, uint64 newTime);
-			~TimerTaskQueue();
-	};
+    /*
+     * Dot products used by the vector set similarity scan, the implementation is picked once at startup
+     * by the cpu features (AVX2/FMA, SSE2 on x86, NEON on aarch64) with a portable fallback.
+     */
+    float vecops_dot_f32(const float* a, const float* b, size_t n);
+    int32_t vecops_dot_i8(const int8_t* a, const int8_t* b, size_t n);
+    /*
+     * Geo radius prefilter, keeps[i] is set to 1 if the point (lons[i], lats[i]) is within 'lon_delta'/'lat_delta' degrees
+     * of (lon, lat) with the longitude distance wrapped at 180, 0 otherwise. Returns the number of points kept.
+     */
+    size_t vecops_geo_box_filter(const double* lons, const double* lats, size_t n, double lon, double lat, double lon_delta, double lat_delta,
+            uint8_t* keeps);
 }
 
-#endif /* TIMER_TASK_QUEUE_HPP_ */
+#endif /* VECOPS_HPP_ */
@@ -31,6 +31,7 @@
 #include "util/file_helper.hpp"
 #include "util/string_helper.hpp"
 #include "util/system_helper.hpp"
+#include "util/mem_arena.hpp"
 #include <errno.h>
 
 #define ARDB_AUTHPASS_MAX_LEN 512
@@ -39,6 +40,8 @@
 #define CONFIG_MIN_HZ            1
 #define CONFIG_MAX_HZ            500
 #define DEFAULT_STAT_LOG_PERIOD_SECS   600
+/* A packed hash is stored as field/value pairs in the meta value, which holds at most 255 values */
+#define MAX_HASH_PACKED_ENTRIES   126
 
 OP_NAMESPACE_BEGIN
 
@@ -49,6 +52,11 @@ OP_NAMESPACE_BEGIN
             ERROR_LOG("[Config]Invalid value for 'slaveof' since 'repl-backlog-size' is not set correctly.");
             return false;
         }
+        if (!cfg.master_host.empty() && !cfg.rocksdb_read_replica_of.empty())
+        {
+            ERROR_LOG("[Config]'slaveof' could not be set with 'rocksdb-read-replica-of'.");
+            return false;
+        }
         if (cfg.requirepass.size() > ARDB_AUTHPASS_MAX_LEN)
         {
             ERROR_LOG("[Config]Password is longer than %u", ARDB_AUTHPASS_MAX_LEN);
@@ -89,12 +97,69 @@ OP_NAMESPACE_BEGIN
         {
             thread_pool_size = available_processors();
         }
+        conf_get_int64(props, "io-read-threads", io_read_threads);
+        conf_get_int64(props, "io-write-threads", io_write_threads);
+        conf_get_bool(props, "coro-requests", coro_requests);
+        if (io_read_threads < 0)
+        {
+            io_read_threads = 0;
+        }
+        if (io_write_threads < 0)
+        {
+            io_write_threads = 0;
+        }
+        conf_get_int64(props, "slow-command-threads", slow_command_threads);
+        conf_get_int64(props, "slow-command-budget", slow_command_budget);
+        if (slow_command_threads < 0)
+        {
+            slow_command_threads = 0;
+        }
+        conf_get_int64(props, "connection-rebalance-period", connection_rebalance_period);
+        conf_get_int64(props, "connection-rebalance-cpu-diff", connection_rebalance_cpu_diff);
+        conf_get_bool(props, "thread-per-core", thread_per_core);
+        std::string cpus;
+        if (conf_get_string(props, "worker-cpus", cpus) && !parse_cpu_list(cpus, worker_cpus))
+        {
+            ERROR_LOG("Invalid worker-cpus:%s", cpus.c_str());
+            return false;
+        }
+        cpus.clear();
+        if (conf_get_string(props, "cron-cpus", cpus) && !parse_cpu_list(cpus, cron_cpus))
+        {
+            ERROR_LOG("Invalid cron-cpus:%s", cpus.c_str());
+            return false;
+        }
+        std::string arenas;
+        conf_get_string(props, "hugepage-arenas", arenas);
+        hugepage_arenas.clear();
+        std::vector<std::string> names = split_string(arenas, ",");
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            std::string name = trim_string(names[i]);
+            if (name.empty())
+            {
+                continue;
+            }
+            if (arena_kind(name) == MEM_ARENA_MAX)
+            {
+                ERROR_LOG("Invalid hugepage-arenas:%s", arenas.c_str());
+                return false;
+            }
+            hugepage_arenas.push_back(name);
+        }
         conf_get_int64(props, "hz", hz);
         if (hz < CONFIG_MIN_HZ)
             hz = CONFIG_MIN_HZ;
         if (hz > CONFIG_MAX_HZ)
             hz = CONFIG_MAX_HZ;
         conf_get_int64(props, "tcp-keepalive", tcp_keepalive);
+        conf_get_bool(props, "tcp-reuseport", tcp_reuseport);
+        conf_get_int64(props, "reply-cork-bytes", reply_cork_bytes);
+        if (reply_cork_bytes < 0)
+        {
+            reply_cork_bytes = 0;
+        }
+        conf_get_string(props, "multiplexing-api", multiplexing_api);
         conf_get_int64(props, "timeout", timeout);
         //conf_get_int64(props, "unixsocketperm", unixsocketperm);
         conf_get_int64(props, "slowlog-log-slower-than", slowlog_log_slower_than);
@@ -161,19 +226,115 @@ OP_NAMESPACE_BEGIN
         {
             backup_redis_format = true;
         }
+        conf_get_int64(props, "backup-incremental-period", backup_incremental_period);
+        conf_get_int64(props, "backup-incremental-keep", backup_incremental_keep);
 
         conf_get_string(props, "zookeeper-servers", zookeeper_servers);
         conf_get_string(props, "zk-clientid-file", zk_clientid_file);
+        conf_get_bool(props, "cluster-enabled", cluster_enabled);
+        conf_get_string(props, "cluster-announce-addr", cluster_announce_addr);
+        Properties::const_iterator slots_it = props.find("cluster-slots");
+        if (slots_it != props.end())
+        {
+            cluster_slots.clear();
+            const ConfItemsArray& cs = slots_it->second;
+            for (size_t i = 0; i < cs.size(); i++)
+            {
+                ClusterSlotRange range;
+                std::vector<std::string> ss = cs[i].size() >= 2 ? split_string(cs[i][0], "-") : std::vector<std::string>();
+                uint32 start = 0, end = 0;
+                if (ss.empty() || ss.size() > 2 || !string_touint32(ss[0], start) || !string_touint32(ss[ss.size() - 1], end) || start > end
+                        || end >= 16384)
+                {
+                    ERROR_LOG("Invalid 'cluster-slots' config at line %u.", (uint32) i + 1);
+                    return false;
+                }
+                range.start = start;
+                range.end = end;
+                if (strcasecmp(cs[i][1].c_str(), "myself"))
+                {
+                    range.addr = cs[i][1];
+                }
+                range.replicas.assign(cs[i].begin() + 2, cs[i].end());
+                cluster_slots.push_back(range);
+            }
+        }
+        conf_get_bool(props, "migrate-raw-transfer", migrate_raw_transfer);
+        conf_get_int64(props, "migrate-pipeline-chunks", migrate_pipeline_chunks);
+        conf_get_int64(props, "migrate-parallel-tasks", migrate_parallel_tasks);
+        if (migrate_pipeline_chunks <= 0)
+        {
+            migrate_pipeline_chunks = 1;
+        }
+        if (migrate_parallel_tasks <= 0)
+        {
+            migrate_parallel_tasks = 1;
+        }
+        conf_get_int64(props, "rebalance-max-mb-per-sec", rebalance_max_mb_per_sec);
+        conf_get_int64(props, "rebalance-max-ops-per-sec", rebalance_max_ops_per_sec);
+        conf_get_bool(props, "engine-profiling", engine_profiling);
+        conf_get_int64(props, "row-cache-size", row_cache_size);
+        conf_get_int64(props, "row-cache-max-value", row_cache_max_value);
+        conf_get_bool(props, "row-cache-elements", row_cache_elements);
+        conf_get_int64(props, "row-cache-admit-reads", row_cache_admit_reads);
+        conf_get_int64(props, "counter-coalesce-interval", counter_coalesce_interval);
+        std::string counter_prefixes;
+        conf_get_string(props, "counter-coalesce-prefixes", counter_prefixes);
+        counter_coalesce_prefixes.clear();
+        std::vector<std::string> prefixes = split_string(counter_prefixes, ",");
+        for (size_t i = 0; i < prefixes.size(); i++)
+        {
+            std::string prefix = trim_string(prefixes[i]);
+            if (!prefix.empty())
+            {
+                counter_coalesce_prefixes.push_back(prefix);
+            }
+        }
+        if (row_cache_admit_reads < 1 || row_cache_admit_reads > 15)
+        {
+            row_cache_admit_reads = row_cache_admit_reads < 1 ? 1 : 15;
+        }
+        conf_get_int64(props, "latency-monitor-threshold", latency_monitor_threshold);
+        conf_get_int64(props, "monitor-output-limit", monitor_output_limit);
+        if (latency_monitor_threshold < 0)
+        {
+            latency_monitor_threshold = 0;
+        }
+        conf_get_string(props, "metrics-host", metrics_host);
+        conf_get_int64(props, "metrics-port", metrics_port);
+        conf_get_int64(props, "hotkeys-sample-rate", hotkeys_sample_rate);
+        conf_get_int64(props, "bigkeys-min-length", bigkeys_min_length);
+        conf_get_int64(props, "bgjobs-cpu-share", bgjobs_cpu_share);
+        conf_get_int64(props, "bgjobs-max-mb-per-sec", bgjobs_max_mb_per_sec);
+        conf_get_int64(props, "bgjobs-latency-target", bgjobs_latency_target);
+        conf_get_string(props, "qos-namespace-limits", qos_namespace_limits);
+        conf_get_string(props, "command-cost-limits", command_cost_limits);
+        conf_get_int64(props, "qos-client-ops-limit", qos_client_ops_limit);
+        conf_get_int64(props, "qos-client-bytes-limit", qos_client_bytes_limit);
+        conf_get_int64(props, "write-stall-pending-limit", write_stall_pending_limit);
+        conf_get_int64(props, "tracking-table-max-keys", tracking_table_max_keys);
+        conf_get_int64(props, "stream-node-max-entries", stream_node_max_entries);
 
         conf_get_string(props, "loglevel", loglevel);
         conf_get_string(props, "logfile", logfile);
+        conf_get_int64(props, "log-buffer-size", log_buffer_size);
         conf_get_bool(props, "daemonize", daemonize);
 
         conf_get_int64(props, "repl-backlog-size", repl_backlog_size);
         conf_get_int64(props, "repl-backlog-cache-size", repl_backlog_cache_size);
+        conf_get_bool(props, "repl-wal-sendfile", repl_wal_sendfile);
         conf_get_int64(props, "repl-ping-slave-period", repl_ping_slave_period);
         conf_get_int64(props, "repl-timeout", repl_timeout);
         conf_get_int64(props, "repl-backlog-sync-period", repl_backlog_sync_period);
+        conf_get_bool(props, "repl-backlog-async-write", repl_backlog_async_write);
+        conf_get_string(props, "repl-backlog-fsync", repl_backlog_fsync);
+        lower_string(repl_backlog_fsync);
+        if (repl_backlog_fsync != "no" && repl_backlog_fsync != "period" && repl_backlog_fsync != "batch")
+        {
+            WARN_LOG("[Config]Invalid 'repl-backlog-fsync' config:%s, use 'period' instead.", repl_backlog_fsync.c_str());
+            repl_backlog_fsync = "period";
+        }
+        conf_get_int64(props, "repl-backlog-fsync-period", repl_backlog_fsync_period);
         conf_get_int64(props, "repl-backlog-ttl", repl_backlog_time_limit);
         conf_get_int64(props, "min-slaves-to-write", repl_min_slaves_to_write);
         conf_get_int64(props, "min-slaves-max-lag", repl_min_slaves_max_lag);
@@ -195,8 +356,17 @@ OP_NAMESPACE_BEGIN
         conf_get_int64(props, "slave-priority", slave_priority);
         conf_get_bool(props, "slave-ignore-expire", slave_ignore_expire);
         conf_get_bool(props, "slave-ignore-del", slave_ignore_del);
+        conf_get_bool(props, "scan-cursor-stateless", scan_cursor_stateless);
+        conf_get_int64(props, "slave-apply-threads", slave_apply_threads);
+        conf_get_string(props, "slave-filter-namespaces", slave_filter_namespaces);
+        conf_get_string(props, "slave-filter-key-prefixes", slave_filter_key_prefixes);
 
         conf_get_bool(props, "slave-cleardb-before-fullresync", slave_cleardb_before_fullresync);
+        conf_get_bool(props, "slave-shadow-fullresync", slave_shadow_fullresync);
+        conf_get_bool(props, "repl-engine-sync", repl_engine_sync);
+        conf_get_bool(props, "repl-compress-stream", repl_compress_stream);
+        conf_get_bool(props, "repl-diskless-sync", repl_diskless_sync);
+        conf_get_int64(props, "repl-diskless-sync-delay", repl_diskless_sync_delay);
 
         conf_get_int64(props, "statistics-log-period", statistics_log_period);
         if (statistics_log_period <= 0)
@@ -260,14 +430,128 @@ OP_NAMESPACE_BEGIN
         }
 
         conf_get_int64(props, "reply-pool-size", reply_pool_size);
+        conf_get_int64(props, "mem-purge-fragmentation-percent", mem_purge_fragmentation_percent);
+        conf_get_int64(props, "mem-purge-min-dirty", mem_purge_min_dirty);
 
         conf_get_int64(props, "slave-client-output-buffer-limit", slave_client_output_buffer_limit);
         conf_get_int64(props, "pubsub-client-output-buffer-limit", pubsub_client_output_buffer_limit);
+        conf_get_int64(props, "normal-client-output-buffer-soft-limit", normal_client_output_buffer_soft_limit);
+        conf_get_int64(props, "normal-client-output-buffer-hard-limit", normal_client_output_buffer_hard_limit);
+        conf_get_int64(props, "channel-buffer-pool-size", channel_buffer_pool_size);
+        if (channel_buffer_pool_size < 0)
+        {
+            channel_buffer_pool_size = 0;
+        }
 
         conf_get_string(props, "redis-compatible-version", redis_compatible_version);
 
         conf_get_bool(props, "redis-compatible-mode", redis_compatible);
         conf_get_bool(props, "compact-after-snapshot-load", compact_after_snapshot_load);
+        conf_get_int64(props, "compact-min-deleted-percent", compact_min_deleted_percent);
+        if (compact_min_deleted_percent < 0 || compact_min_deleted_percent > 100)
+        {
+            compact_min_deleted_percent = 20;
+        }
+        conf_get_int64(props, "compact-after-deleted-entries", compact_after_deleted_entries);
+        conf_get_bool(props, "rocksdb-group-commit", rocksdb_group_commit);
+        conf_get_bool(props, "rocksdb-sync-wal", rocksdb_sync_wal);
+        conf_get_int64(props, "key-lock-shards", key_lock_shards);
+        if (key_lock_shards <= 0)
+        {
+            key_lock_shards = 1;
+        }
+        conf_get_int64(props, "stream-iterate-threshold", stream_iterate_threshold);
+        conf_get_int64(props, "stream-reply-threshold", stream_reply_threshold);
+        conf_get_int64(props, "hash-max-packed-entries", hash_max_packed_entries);
+        conf_get_int64(props, "hash-max-packed-value", hash_max_packed_value);
+        if (hash_max_packed_entries > MAX_HASH_PACKED_ENTRIES)
+        {
+            hash_max_packed_entries = MAX_HASH_PACKED_ENTRIES;
+        }
+        conf_get_int64(props, "zset-rank-block-size", zset_rank_block_size);
+        conf_get_int64(props, "bitmap-chunk-size", bitmap_chunk_size);
+        conf_get_int64(props, "zset-store-batch-size", zset_store_batch_size);
+        conf_get_int64(props, "pipeline-write-batch-size", pipeline_write_batch_size);
+        conf_get_int64(props, "expire-scan-max-keys", expire_scan_max_keys);
+        conf_get_int64(props, "expire-scan-threads", expire_scan_threads);
+        conf_get_int64(props, "expire-delete-batch-size", expire_delete_batch_size);
+        conf_get_int64(props, "lazyfree-threshold", lazyfree_threshold);
+        conf_get_int64(props, "lazyfree-batch-size", lazyfree_batch_size);
+        conf_get_int64(props, "keycache-load-threads", keycache_load_threads);
+        conf_get_bool(props, "keycache-load-async", keycache_load_async);
+        conf_get_int64(props, "snapshot-threads", snapshot_threads);
+        conf_get_int64(props, "snapshot-write-fence-timeout", snapshot_write_fence_timeout);
+        conf_get_bool(props, "import-serve-reads", import_serve_reads);
+        conf_get_bool(props, "rocksdb-ingest-sst", rocksdb_ingest_sst);
+        conf_get_int64(props, "rocksdb-ingest-buffer-size", rocksdb_ingest_buffer_size);
+        if (rocksdb_ingest_buffer_size < 1024 * 1024)
+        {
+            rocksdb_ingest_buffer_size = 1024 * 1024;
+        }
+        conf_get_bool(props, "rocksdb-cf-per-type", rocksdb_cf_per_type);
+        conf_get_int64(props, "rocksdb-shards", rocksdb_shards);
+        if (rocksdb_shards < 1)
+        {
+            rocksdb_shards = 1;
+        }
+        conf_get_int64(props, "rocksdb-meta-block-cache-size", rocksdb_meta_block_cache_size);
+        conf_get_int64(props, "rocksdb-bloom-bits-per-key", rocksdb_bloom_bits_per_key);
+        conf_get_bool(props, "rocksdb-statistics", rocksdb_statistics);
+        conf_get_int64(props, "rocksdb-compressed-block-cache-size", rocksdb_compressed_block_cache_size);
+        conf_get_int64(props, "rocksdb-memtable-total-size", rocksdb_memtable_total_size);
+        conf_get_int64(props, "rocksdb-memtable-hard-limit", rocksdb_memtable_hard_limit);
+        conf_get_int64(props, "rocksdb-delete-mb-per-sec", rocksdb_delete_mb_per_sec);
+        conf_get_int64(props, "rocksdb-tombstone-compact-threshold", rocksdb_tombstone_compact_threshold);
+        conf_get_int64(props, "rocksdb-blob-min-size", rocksdb_blob_min_size);
+        conf_get_bool(props, "rocksdb-blob-universal-compaction", rocksdb_blob_universal_compaction);
+        std::string blob_namespaces;
+        conf_get_string(props, "rocksdb-blob-namespaces", blob_namespaces);
+        rocksdb_blob_namespaces.clear();
+        std::vector<std::string> blob_nss = split_string(blob_namespaces, ",");
+        for (size_t i = 0; i < blob_nss.size(); i++)
+        {
+            std::string ns = trim_string(blob_nss[i]);
+            if (!ns.empty())
+            {
+                rocksdb_blob_namespaces.insert(ns);
+            }
+        }
+        std::string ttl_namespaces;
+        conf_get_string(props, "rocksdb-ttl-namespaces", ttl_namespaces);
+        rocksdb_ttl_namespaces.clear();
+        std::vector<std::string> ttl_nss = split_string(ttl_namespaces, ",");
+        for (size_t i = 0; i < ttl_nss.size(); i++)
+        {
+            std::string ns = trim_string(ttl_nss[i]);
+            if (!ns.empty())
+            {
+                rocksdb_ttl_namespaces.insert(ns);
+            }
+        }
+        conf_get_string(props, "rocksdb-ttl-compaction-style", rocksdb_ttl_compaction_style);
+        rocksdb_ttl_compaction_style = string_tolower(rocksdb_ttl_compaction_style);
+        if (rocksdb_ttl_compaction_style != "fifo" && rocksdb_ttl_compaction_style != "universal" && rocksdb_ttl_compaction_style != "level")
+        {
+            rocksdb_ttl_compaction_style = "fifo";
+        }
+        conf_get_int64(props, "rocksdb-ttl-fifo-max-size", rocksdb_ttl_fifo_max_size);
+        conf_get_string(props, "rocksdb-read-replica-of", rocksdb_read_replica_of);
+        conf_get_int64(props, "rocksdb-read-replica-refresh", rocksdb_read_replica_refresh);
+        if (rocksdb_read_replica_refresh < 100)
+        {
+            rocksdb_read_replica_refresh = 100;
+        }
+        conf_get_int64(props, "key-codec-version", key_codec_version);
+        if (key_codec_version < 1 || key_codec_version > 3)
+        {
+            key_codec_version = 1;
+        }
+        conf_get_int64(props, "value-compress-threshold", value_compress_threshold);
+        if (value_compress_threshold < 0 || value_compress_threshold > 0xFFFFFFFFLL)
+        {
+            value_compress_threshold = 0;
+        }
+        conf_get_bool(props, "hash-object-id", hash_object_id);
 
         //trusted_ip.clear();
         Properties::const_iterator ip_it = props.find("trusted-ip");
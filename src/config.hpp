@@ -59,6 +59,22 @@ OP_NAMESPACE_BEGIN
             }
     };
     typedef std::vector<ListenPoint> ListenPointArray;
+    /*
+     * 'cluster-slots' line, an empty address stands for this server. Replicas of the owner serve reads of READONLY
+     * connections.
+     */
+    struct ClusterSlotRange
+    {
+            uint16 start;
+            uint16 end;
+            std::string addr;
+            StringArray replicas;
+            ClusterSlotRange() :
+                    start(0), end(0)
+            {
+            }
+    };
+    typedef std::vector<ClusterSlotRange> ClusterSlotRangeArray;
     struct ArdbConfig
     {
             SpinRWLock lock;
@@ -66,11 +82,25 @@ OP_NAMESPACE_BEGIN
 
             ListenPointArray servers;
             int64 thread_pool_size;
+            int64 io_read_threads;
+            bool coro_requests;
+            int64 io_write_threads;
+            int64 slow_command_threads;
+            int64 slow_command_budget;
+            int64 connection_rebalance_period;
+            int64 connection_rebalance_cpu_diff;
+            bool thread_per_core;
+            std::vector<int> worker_cpus;
+            std::vector<int> cron_cpus;
+            std::vector<std::string> hugepage_arenas;
 
             int64 hz;
             //int64 unixsocketperm;
             int64 max_open_files;
             int64 tcp_keepalive;
+            bool tcp_reuseport;
+            int64 reply_cork_bytes;
+            std::string multiplexing_api;
             int64 timeout;
             std::string engine;
             std::string home;
@@ -81,6 +111,8 @@ OP_NAMESPACE_BEGIN
             std::string repl_data_dir;
             std::string backup_dir;
             bool backup_redis_format;
+            int64 backup_incremental_period;
+            int64 backup_incremental_keep;
 
             int64 repl_ping_slave_period;
             int64 repl_timeout;
@@ -92,6 +124,8 @@ OP_NAMESPACE_BEGIN
             int64 repl_min_slaves_max_lag;
             bool repl_serve_stale_data;
             bool slave_cleardb_before_fullresync;
+            bool slave_shadow_fullresync;
+            bool repl_engine_sync;
             bool slave_readonly;
             bool slave_serve_stale_data;
             int64 slave_priority;
@@ -107,6 +141,7 @@ OP_NAMESPACE_BEGIN
 
             std::string loglevel;
             std::string logfile;
+            int64 log_buffer_size;
 
             std::string pidfile;
 
@@ -120,8 +155,14 @@ OP_NAMESPACE_BEGIN
 
             int64 reply_pool_size;
 
+            int64 mem_purge_fragmentation_percent;
+            int64 mem_purge_min_dirty;
+
             int64 slave_client_output_buffer_limit;
             int64 pubsub_client_output_buffer_limit;
+            int64 normal_client_output_buffer_soft_limit;
+            int64 normal_client_output_buffer_hard_limit;
+            int64 channel_buffer_pool_size;
 
             bool slave_ignore_expire;
             bool slave_ignore_del;
@@ -129,6 +170,7 @@ OP_NAMESPACE_BEGIN
 
             bool scan_redis_compatible;
             int64 scan_cursor_expire_after;
+            bool scan_cursor_stateless;
 
             int64 snapshot_max_lag_offset;
 
@@ -141,17 +183,115 @@ OP_NAMESPACE_BEGIN
             int64 statistics_log_period;
 
             bool compact_after_snapshot_load;
+            int64 compact_min_deleted_percent;
+            int64 compact_after_deleted_entries;
+
+            bool rocksdb_group_commit;
+            bool rocksdb_sync_wal;
+
+            int64 key_lock_shards;
+
+            int64 stream_iterate_threshold;
+            int64 stream_reply_threshold;
+
+            int64 hash_max_packed_entries;
+            int64 hash_max_packed_value;
+
+            int64 zset_rank_block_size;
+
+            int64 bitmap_chunk_size;
+            int64 zset_store_batch_size;
+
+            int64 pipeline_write_batch_size;
+
+            int64 expire_scan_max_keys;
+            int64 expire_scan_threads;
+            int64 expire_delete_batch_size;
+
+            int64 lazyfree_threshold;
+            int64 lazyfree_batch_size;
+            int64 keycache_load_threads;
+            bool keycache_load_async;
+            int64 snapshot_threads;
+            int64 snapshot_write_fence_timeout;
+            bool import_serve_reads;
+            bool rocksdb_ingest_sst;
+            int64 rocksdb_ingest_buffer_size;
+            bool repl_compress_stream;
+            int64 slave_apply_threads;
+            std::string slave_filter_namespaces;
+            std::string slave_filter_key_prefixes;
+            bool repl_wal_sendfile;
+            bool repl_backlog_async_write;
+            std::string repl_backlog_fsync;
+            int64 repl_backlog_fsync_period;
+            bool repl_diskless_sync;
+            int64 repl_diskless_sync_delay;
+            bool rocksdb_cf_per_type;
+            int64 rocksdb_shards;
+            int64 rocksdb_meta_block_cache_size;
+            int64 rocksdb_bloom_bits_per_key;
+            bool rocksdb_statistics;
+            int64 rocksdb_compressed_block_cache_size;
+            int64 rocksdb_memtable_total_size;
+            int64 rocksdb_memtable_hard_limit;
+            int64 rocksdb_delete_mb_per_sec;
+            int64 rocksdb_tombstone_compact_threshold;
+            int64 rocksdb_blob_min_size;
+            StringTreeSet rocksdb_blob_namespaces;
+            bool rocksdb_blob_universal_compaction;
+            StringTreeSet rocksdb_ttl_namespaces;
+            std::string rocksdb_ttl_compaction_style;
+            int64 rocksdb_ttl_fifo_max_size;
+            std::string rocksdb_read_replica_of;
+            int64 rocksdb_read_replica_refresh;
+            int64 key_codec_version;
+            int64 value_compress_threshold;
+            bool hash_object_id;
+
+            bool cluster_enabled;
+            std::string cluster_announce_addr;
+            ClusterSlotRangeArray cluster_slots;
+
+            bool migrate_raw_transfer;
+            int64 migrate_pipeline_chunks;
+            int64 migrate_parallel_tasks;
+            int64 rebalance_max_mb_per_sec;
+            int64 rebalance_max_ops_per_sec;
+            bool engine_profiling;
+            int64 row_cache_size;
+            int64 row_cache_max_value;
+            bool row_cache_elements;
+            int64 row_cache_admit_reads;
+            int64 counter_coalesce_interval;
+            StringArray counter_coalesce_prefixes;
+            int64 latency_monitor_threshold;
+            int64 monitor_output_limit;
+            std::string metrics_host;
+            int64 metrics_port;
+            int64 hotkeys_sample_rate;
+            int64 bigkeys_min_length;
+            int64 bgjobs_cpu_share;
+            int64 bgjobs_max_mb_per_sec;
+            int64 bgjobs_latency_target;
+            std::string qos_namespace_limits;
+            std::string command_cost_limits;
+            int64 qos_client_ops_limit;
+            int64 qos_client_bytes_limit;
+            int64 write_stall_pending_limit;
+            int64 tracking_table_max_keys;
+            int64 stream_node_max_entries;
 
             std::string _conf_file;
             std::string _executable;
             Properties conf_props;
 
             ArdbConfig() :
-                    daemonize(false), thread_pool_size(0),hz(10), max_open_files(100000), tcp_keepalive(0), timeout(0), engine("rocksdb"), slowlog_log_slower_than(10000), slowlog_max_len(128), repl_data_dir("./repl"), backup_dir("./backup"), backup_redis_format(false), repl_ping_slave_period(
+                    daemonize(false), thread_pool_size(0), io_read_threads(0), coro_requests(false), io_write_threads(0), slow_command_threads(0), slow_command_budget(10000), connection_rebalance_period(0), connection_rebalance_cpu_diff(30), thread_per_core(false), hz(10), max_open_files(100000), tcp_keepalive(0), tcp_reuseport(false), reply_cork_bytes(64 * 1024), multiplexing_api("epoll"), timeout(0), engine("rocksdb"), slowlog_log_slower_than(10000), slowlog_max_len(128), repl_data_dir("./repl"), backup_dir("./backup"), backup_redis_format(false), backup_incremental_period(0), backup_incremental_keep(0), repl_ping_slave_period(
                             10), repl_timeout(60), repl_backlog_size(100 * 1024 * 1024), repl_backlog_cache_size(100 * 1024 * 1024), repl_backlog_sync_period(1), repl_backlog_time_limit(3600), repl_min_slaves_to_write(0), repl_min_slaves_max_lag(10), repl_serve_stale_data(
-                            false), slave_cleardb_before_fullresync(true), slave_readonly(true), slave_serve_stale_data(true), slave_priority(100), lua_time_limit(0), master_port(0), loglevel("INFO"), hll_sparse_max_bytes(3000), reply_pool_size(
-                            10000), slave_client_output_buffer_limit(256 * 1024 * 1024), pubsub_client_output_buffer_limit(32 * 1024 * 1024), slave_ignore_expire(false), slave_ignore_del(false), repl_disable_tcp_nodelay(true), scan_redis_compatible(
-                            true), scan_cursor_expire_after(60), snapshot_max_lag_offset(500 * 1024 * 1024), redis_compatible(false), redis_compatible_version("2.8.0"), statistics_log_period(300),compact_after_snapshot_load(false)
+                            false), slave_cleardb_before_fullresync(true), slave_shadow_fullresync(false), repl_engine_sync(true), slave_readonly(true), slave_serve_stale_data(true), slave_priority(100), lua_time_limit(0), master_port(0), loglevel("INFO"), log_buffer_size(0), hll_sparse_max_bytes(3000), reply_pool_size(
+                            10000), mem_purge_fragmentation_percent(150), mem_purge_min_dirty(64 * 1024 * 1024), slave_client_output_buffer_limit(256 * 1024 * 1024), pubsub_client_output_buffer_limit(32 * 1024 * 1024), normal_client_output_buffer_soft_limit(0), normal_client_output_buffer_hard_limit(0), channel_buffer_pool_size(64 * 1024 * 1024), slave_ignore_expire(false), slave_ignore_del(false), repl_disable_tcp_nodelay(true), scan_redis_compatible(
+                            true), scan_cursor_expire_after(60), scan_cursor_stateless(false), snapshot_max_lag_offset(500 * 1024 * 1024), redis_compatible(false), redis_compatible_version("2.8.0"), statistics_log_period(300),compact_after_snapshot_load(false), compact_min_deleted_percent(20), compact_after_deleted_entries(0), rocksdb_group_commit(false), rocksdb_sync_wal(false), key_lock_shards(64), stream_iterate_threshold(10000), stream_reply_threshold(100000), hash_max_packed_entries(0), hash_max_packed_value(64), zset_rank_block_size(0), bitmap_chunk_size(0), zset_store_batch_size(1024), pipeline_write_batch_size(128), expire_scan_max_keys(100000), expire_scan_threads(4), expire_delete_batch_size(256), lazyfree_threshold(10000), lazyfree_batch_size(1024), keycache_load_threads(8), keycache_load_async(false), snapshot_threads(4), snapshot_write_fence_timeout(1000), import_serve_reads(false), rocksdb_ingest_sst(true), rocksdb_ingest_buffer_size(64 * 1024 * 1024), repl_compress_stream(true), slave_apply_threads(0), repl_wal_sendfile(true), repl_backlog_async_write(true), repl_backlog_fsync("period"), repl_backlog_fsync_period(1000), repl_diskless_sync(false), repl_diskless_sync_delay(5), rocksdb_cf_per_type(false), rocksdb_shards(1), rocksdb_meta_block_cache_size(128 * 1024 * 1024), rocksdb_bloom_bits_per_key(10), rocksdb_statistics(false), rocksdb_compressed_block_cache_size(0), rocksdb_memtable_total_size(0), rocksdb_memtable_hard_limit(0), rocksdb_delete_mb_per_sec(0), rocksdb_tombstone_compact_threshold(10000), rocksdb_blob_min_size(0), rocksdb_blob_universal_compaction(true), rocksdb_ttl_compaction_style("fifo"), rocksdb_ttl_fifo_max_size(0), rocksdb_read_replica_refresh(5000), key_codec_version(1), value_compress_threshold(0), hash_object_id(false), cluster_enabled(false), migrate_raw_transfer(false), migrate_pipeline_chunks(4), migrate_parallel_tasks(4), rebalance_max_mb_per_sec(64), rebalance_max_ops_per_sec(0), engine_profiling(false), row_cache_size(0), row_cache_max_value(4096), row_cache_elements(false), row_cache_admit_reads(1), counter_coalesce_interval(0), latency_monitor_threshold(0), monitor_output_limit(1024 * 1024), metrics_host("0.0.0.0"), metrics_port(0), hotkeys_sample_rate(0), bigkeys_min_length(10000), bgjobs_cpu_share(100), bgjobs_max_mb_per_sec(0), bgjobs_latency_target(0), qos_client_ops_limit(0), qos_client_bytes_limit(0), write_stall_pending_limit(0), tracking_table_max_keys(1000000), stream_node_max_entries(100)
             {
             }
             bool Parse(const Properties& props);
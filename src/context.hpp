@@ -52,9 +52,14 @@ OP_NAMESPACE_BEGIN
             unsigned lua :1;
             unsigned pubsub :1;
             unsigned bulk_loading:1;
+            unsigned snapshot_read:1; //current command reads under engine snapshot without key locks
+            unsigned hotkey_sampled:1; //current command is sampled by the hot/big key tracker
+            unsigned request_coro:1; //current command runs in a request coroutine & may yield on engine cache misses
+            unsigned slow_command:1; //current command runs in the slow command pool
+            unsigned stream_reply:1; //current command streams its reply whatever its size, set by 'command-cost-limits'
             CallFlags() :
                     no_wal(0), no_fill_reply(0), create_if_notexist(0), fuzzy_check(0), redis_compatible(0), iterate_multi_keys(0), iterate_no_upperbound(0), iterate_total_order(
-                            0), slave(0), lua(0), pubsub(0),bulk_loading(0)
+                            0), slave(0), lua(0), pubsub(0),bulk_loading(0), snapshot_read(0), hotkey_sampled(0), request_coro(0), slow_command(0), stream_reply(0)
             {
             }
     };
@@ -88,26 +93,48 @@ OP_NAMESPACE_BEGIN
     };
 
     class Context;
-    struct ClientId
+    /*
+     * Token bucket refilled at 'rate' per second with one second of burst, a 0 rate is unlimited. A charge may take
+     * it below zero, requests are refused until it refills.
+     */
+    struct QoSBucket
     {
-            uint32 id;
-            Context* ctx;
-            ClientId() :
-                    id(0), ctx(NULL)
+            int64 rate;
+            double tokens;
+            uint64 refill_ustime;
+            QoSBucket() :
+                    rate(0), tokens(0), refill_ustime(0)
             {
             }
-            bool operator<(const ClientId& other) const
+            void SetRate(int64 r)
             {
-                int64 cmp = (int64) id - (int64) other.id;
-                if (cmp < 0)
+                rate = r > 0 ? r : 0;
+                tokens = (double) rate;
+                refill_ustime = 0;
+            }
+            bool Allow(uint64 now)
+            {
+                if (rate <= 0)
                 {
                     return true;
                 }
-                if (cmp > 0)
+                if (now > refill_ustime)
                 {
-                    return false;
+                    tokens += (double) (now - refill_ustime) * rate / 1000000;
+                    if (tokens > rate)
+                    {
+                        tokens = (double) rate;
+                    }
+                    refill_ustime = now;
+                }
+                return tokens > 0;
+            }
+            void Charge(int64 n)
+            {
+                if (rate > 0)
+                {
+                    tokens -= n;
                 }
-                return ctx < other.ctx;
             }
     };
 
@@ -116,25 +143,97 @@ OP_NAMESPACE_BEGIN
             bool processing;
             std::string name;
             Channel* client;
-            ClientId clientid;
+            Context* ctx;
             int64 uptime;
             int64 last_interaction_ustime;
-            int64 resume_ustime;
+            /*
+             * links in the list of connected clients
+             */
+            ClientContext* prev;
+            ClientContext* next;
+            bool listed;
+            /*
+             * limits of this connection, the qos-client-* defaults unless CLIENT QOS set them
+             */
+            QoSBucket qos_ops;
+            QoSBucket qos_bytes;
+            bool qos_custom;
             ClientContext() :
-                    processing(false), client(NULL), uptime(0), last_interaction_ustime(0), resume_ustime(-1)
+                    processing(false), client(NULL), ctx(NULL), uptime(0), last_interaction_ustime(0), prev(NULL), next(NULL), listed(false), qos_custom(false)
+            {
+            }
+    };
+
+    /*
+     * Intrusive list of the connected clients in connection order
+     */
+    struct ClientList
+    {
+            ClientContext* head;
+            ClientContext* tail;
+            uint32 size;
+            ClientList() :
+                    head(NULL), tail(NULL), size(0)
+            {
+            }
+            void Add(ClientContext* c)
+            {
+                if (c->listed)
+                {
+                    return;
+                }
+                c->prev = tail;
+                c->next = NULL;
+                if (NULL != tail)
+                {
+                    tail->next = c;
+                }
+                else
+                {
+                    head = c;
+                }
+                tail = c;
+                c->listed = true;
+                size++;
+            }
+            void Remove(ClientContext* c)
             {
+                if (!c->listed)
+                {
+                    return;
+                }
+                if (NULL != c->prev)
+                {
+                    c->prev->next = c->next;
+                }
+                else
+                {
+                    head = c->next;
+                }
+                if (NULL != c->next)
+                {
+                    c->next->prev = c->prev;
+                }
+                else
+                {
+                    tail = c->prev;
+                }
+                c->prev = c->next = NULL;
+                c->listed = false;
+                size--;
             }
     };
 
     struct TransactionContext
     {
+            bool multi;
             bool abort;
-            bool cas;
             RedisCommandFrameArray cached_cmds;
-            typedef TreeSet<KeyPrefix>::Type WatchKeySet;
-            WatchKeySet watched_keys;
+            typedef TreeMap<KeyPrefix, uint32>::Type WatchKeyTable;
+            WatchKeyTable watched_keys; //watched key -> version of its slot when watched
+            uint32 watched_flush_version;
             TransactionContext() :
-                    abort(false), cas(false)
+                    multi(false), abort(false), watched_flush_version(0)
             {
             }
     };
@@ -144,15 +243,80 @@ OP_NAMESPACE_BEGIN
             StringTreeSet pubsub_patterns;
     };
 
+    /*
+     * CLIENT TRACKING state, invalidations are sent to the 'redirect' connection. BCAST clients are notified of
+     * every key under their 'prefixes' instead of the keys they read.
+     */
+    struct TrackingContext
+    {
+            uint32 redirect;
+            bool bcast;
+            bool noloop;
+            StringTreeSet prefixes;
+            TrackingContext() :
+                    redirect(0), bcast(false), noloop(false)
+            {
+            }
+    };
+
     struct BlockingState
     {
             typedef TreeSet<KeyPrefix>::Type BlockKeySet;
             BlockKeySet keys;
             KeyPrefix target;
+            typedef TreeMap<KeyPrefix, std::string>::Type StreamIDTable;
+            StreamIDTable stream_ids; //XREAD: entries after these ids are waited for
+            int64 stream_count;
             uint64 timeout;
+            volatile uint32_t served; //set once by whoever serves the client: a pushed element or the timeout
             BlockingState() :
-                    timeout(0)
+                    stream_count(0), timeout(0), served(0)
+            {
+            }
+    };
+
+    /*
+     * Consecutive pipelined write commands of one connection share one engine write batch,
+     * their keys stay locked until the batch is committed. The batch is open while 'keys' is not empty.
+     */
+    struct PipelineBatch
+    {
+            typedef TreeSet<KeyPrefix>::Type KeySet;
+            KeySet keys;
+    };
+
+    /*
+     * Nanoseconds & value bytes a command spent in engine calls, iterators, key locks & value codecs, only recorded
+     * with engine-profiling.
+     */
+    struct EngineProfile
+    {
+            uint64 engine_nanos;
+            uint64 engine_ops;
+            uint64 iterate_nanos;
+            uint64 iterate_ops;
+            uint64 lock_wait_nanos;
+            uint64 codec_nanos;
+            uint64 read_bytes;
+            uint64 written_bytes;
+            EngineProfile()
+            {
+                Clear();
+            }
+            void Clear()
+            {
+                engine_nanos = engine_ops = iterate_nanos = iterate_ops = lock_wait_nanos = codec_nanos = read_bytes = written_bytes = 0;
+            }
+            void Add(const EngineProfile& other)
             {
+                engine_nanos += other.engine_nanos;
+                engine_ops += other.engine_ops;
+                iterate_nanos += other.iterate_nanos;
+                iterate_ops += other.iterate_ops;
+                lock_wait_nanos += other.lock_wait_nanos;
+                codec_nanos += other.codec_nanos;
+                read_bytes += other.read_bytes;
+                written_bytes += other.written_bytes;
             }
     };
 
@@ -165,7 +329,9 @@ OP_NAMESPACE_BEGIN
             ClientContext* client;
             TransactionContext* transc;
             PubSubContext* pubsub;
+            TrackingContext* tracking;
             BlockingState* bpop;
+            PipelineBatch* pipeline;
             RedisCommandFrame* current_cmd;
 
             int dirty;
@@ -174,10 +340,14 @@ OP_NAMESPACE_BEGIN
             CallFlags flags;
             bool authenticated;
             bool keyslocked;
+            bool asking; //ASKING was sent, the next command may access an importing cluster slot
+            bool readonly; //READONLY was sent, reads of slots this server replicates are served here
+            int64 cost_estimate; //elements the current command was estimated to return by 'command-cost-limits', 0 if not
+            EngineProfile profile;
 
             Context() :
                     reply(NULL), client(NULL), transc(NULL), pubsub(
-                    NULL), bpop(NULL), current_cmd(NULL), dirty(0), last_cmdtype(REDIS_CMD_INVALID), transc_err(0), authenticated(true), keyslocked(false)
+                    NULL), tracking(NULL), bpop(NULL), pipeline(NULL), current_cmd(NULL), dirty(0), last_cmdtype(REDIS_CMD_INVALID), transc_err(0), authenticated(true), keyslocked(false), asking(false), readonly(false), cost_estimate(0)
             {
                 ns.SetString("0", false);
             }
@@ -223,22 +393,42 @@ OP_NAMESPACE_BEGIN
             {
                 DELETE(pubsub);
             }
+            void ClearTracking()
+            {
+                DELETE(tracking);
+            }
             void ClearBPop()
             {
                 DELETE(bpop);
             }
+            void ClearPipelineBatch()
+            {
+                DELETE(pipeline);
+            }
             bool InTransaction()
             {
-                return transc != NULL;
+                return transc != NULL && transc->multi;
             }
             bool IsSubscribed()
             {
                 return pubsub != NULL;
             }
+            bool InPipelineBatch()
+            {
+                return NULL != pipeline && !pipeline->keys.empty();
+            }
             bool IsBlocking()
             {
                 return NULL != bpop && !bpop->keys.empty();
             }
+            TrackingContext& GetTracking()
+            {
+                if (NULL == tracking)
+                {
+                    NEW(tracking, TrackingContext);
+                }
+                return *tracking;
+            }
             BlockingState& GetBPop()
             {
                 if (NULL == bpop)
@@ -247,6 +437,14 @@ OP_NAMESPACE_BEGIN
                 }
                 return *bpop;
             }
+            PipelineBatch& GetPipelineBatch()
+            {
+                if (NULL == pipeline)
+                {
+                    NEW(pipeline, PipelineBatch);
+                }
+                return *pipeline;
+            }
             TransactionContext& GetTransaction()
             {
                 if (NULL == transc)
@@ -283,10 +481,10 @@ OP_NAMESPACE_BEGIN
             ~Context()
             {
                 SetReply(NULL);
+                ClearPipelineBatch();
             }
     };
     typedef TreeSet<Context*>::Type ContextSet;
-    typedef TreeSet<ClientId>::Type ClientIdSet;
 
 OP_NAMESPACE_END
 
@@ -28,7 +28,10 @@
  */
 #include "network.hpp"
 #include "statistics.hpp"
+#include "bgjobs.hpp"
 #include "db/db.hpp"
+#include "repl/backup.hpp"
+#include "util/system_helper.hpp"
 
 OP_NAMESPACE_BEGIN
 
@@ -70,13 +73,22 @@ OP_NAMESPACE_BEGIN
             void Run()
             {
                 Statistics::GetSingleton().TrackQPSPerSecond();
+                BackgroundJobs::GetSingleton().TuneRate();
                 period_dump_statistics();
+                g_backup_manager->Routine();
             }
     };
 
     struct CronThread: public Thread
     {
             ChannelService serv;
+            void BindCpus()
+            {
+                if (!g_db->GetConf().cron_cpus.empty() && 0 != bind_current_thread(g_db->GetConf().cron_cpus))
+                {
+                    WARN_LOG("Failed to bind cron thread to cron-cpus.");
+                }
+            }
             virtual ~CronThread()
             {
             }
@@ -86,6 +98,7 @@ OP_NAMESPACE_BEGIN
     {
             void Run()
             {
+                BindCpus();
                 serv.GetTimer().ScheduleHeapTask(new FastCronTask, 1, 1, SECONDS);
                 serv.Start();
             }
@@ -95,7 +108,31 @@ OP_NAMESPACE_BEGIN
     {
             void Run()
             {
-                g_db->ScanExpiredKeys();
+                {
+                    BackgroundJobScope job(BGJOB_EXPIRE);
+                    if (job.started)
+                    {
+                        g_db->ScanExpiredKeys();
+                        g_db->DropExpiredTables();
+                    }
+                }
+                {
+                    BackgroundJobScope job(BGJOB_LIST_COMPACT);
+                    if (job.started)
+                    {
+                        g_db->CompactLists();
+                    }
+                }
+                {
+                    BackgroundJobScope job(BGJOB_COMPACTION);
+                    if (job.started)
+                    {
+                        g_db->CompactQueuedRanges();
+                    }
+                }
+                g_db->ReserveObjectIds();
+                g_db->CompactOnDeletes();
+                g_db->PurgeFragmentedMemory();
             }
     };
 
@@ -106,11 +143,82 @@ OP_NAMESPACE_BEGIN
     {
             void Run()
             {
+                BindCpus();
                 serv.GetTimer().ScheduleHeapTask(new SlowCronTask, 1, 1, SECONDS);
                 serv.Start();
             }
     };
 
+    struct LazyFreeCronTask: public Runnable
+    {
+            void Run()
+            {
+                BackgroundJobScope job(BGJOB_LAZYFREE);
+                if (job.started)
+                {
+                    g_db->ReclaimLazyFreeKeys();
+                    g_db->ReclaimFlushedData();
+                }
+            }
+    };
+
+    /*
+     * reclaims elements of large objects removed by DEL/expiry & data of flushed namespaces
+     */
+    struct LazyFreeCronThread: public CronThread
+    {
+            void Run()
+            {
+                BindCpus();
+                serv.GetTimer().ScheduleHeapTask(new LazyFreeCronTask, 100, 100, MILLIS);
+                serv.Start();
+            }
+    };
+
+    struct CounterFlushCronTask: public Runnable
+    {
+            void Run()
+            {
+                g_db->FlushPendingWrites();
+            }
+    };
+
+    /*
+     * writes the increments coalesced by counter-coalesce-interval to the engine
+     */
+    struct CounterFlushCronThread: public CronThread
+    {
+            void Run()
+            {
+                BindCpus();
+                int64 interval = g_db->GetConf().counter_coalesce_interval;
+                serv.GetTimer().ScheduleHeapTask(new CounterFlushCronTask, interval, interval, MILLIS);
+                serv.Start();
+            }
+    };
+
+    struct ReadReplicaCronTask: public Runnable
+    {
+            void Run()
+            {
+                g_db->RefreshReadReplica();
+            }
+    };
+
+    /*
+     * reopens the engine of a read replica on the files of the owning instance
+     */
+    struct ReadReplicaCronThread: public CronThread
+    {
+            void Run()
+            {
+                BindCpus();
+                int64 interval = g_db->GetConf().rocksdb_read_replica_refresh;
+                serv.GetTimer().ScheduleHeapTask(new ReadReplicaCronTask, interval, interval, MILLIS);
+                serv.Start();
+            }
+    };
+
     void Server::StartCrons()
     {
         if (m_cron_threads.empty())
@@ -119,9 +227,28 @@ OP_NAMESPACE_BEGIN
             NEW(cron, FastCronThread);
             cron->Start();
             m_cron_threads.push_back(cron);
+            /*
+             * the jobs of the other crons write, a read replica only refreshes
+             */
+            if (g_db->IsReadReplica())
+            {
+                NEW(cron, ReadReplicaCronThread);
+                cron->Start();
+                m_cron_threads.push_back(cron);
+                return;
+            }
             NEW(cron, SlowCronThread);
             cron->Start();
             m_cron_threads.push_back(cron);
+            NEW(cron, LazyFreeCronThread);
+            cron->Start();
+            m_cron_threads.push_back(cron);
+            if (g_db->GetConf().counter_coalesce_interval > 0 && !g_db->GetConf().counter_coalesce_prefixes.empty())
+            {
+                NEW(cron, CounterFlushCronThread);
+                cron->Start();
+                m_cron_threads.push_back(cron);
+            }
         }
     }
 
@@ -28,16 +28,269 @@
  */
 
 #include "codec.hpp"
+#include "engine_profiler.hpp"
 #include "buffer/buffer_helper.hpp"
 #include "util/murmur3.h"
+#include "util/crc16.h"
 #include "channel/all_includes.hpp"
+#include <snappy.h>
 #include <cmath>
 #include <float.h>
 
 static const uint8 kCurrentMetaFormat = 0;
+static const uint8 kPackedMetaFormat = 1;
+static const uint8 kRankIndexedMetaFormat = 2;
+static const uint8 kChunkedMetaFormat = 3;
+static const uint8 kObjectIdMetaFormat = 4;
 
 OP_NAMESPACE_BEGIN
 
+    static uint8 g_key_codec_version = KEY_CODEC_V1;
+
+    uint8 get_key_codec_version()
+    {
+        return g_key_codec_version;
+    }
+    void set_key_codec_version(uint8 version)
+    {
+        g_key_codec_version = version;
+    }
+
+    static uint32 g_value_compress_threshold = 0;
+    /*
+     * Header of a compressed value element: the string encoding of Data with the 0x80 flag bit,
+     * followed by the fix uint32 compressed length and the snappy block.
+     */
+    static const char kCompressedElementHeader = (char) 0x84;
+
+    void set_value_compress_threshold(uint32 threshold)
+    {
+        g_value_compress_threshold = threshold;
+    }
+
+    static inline uint8 key_codec(uint8 codec)
+    {
+        return codec > 0 ? codec : g_key_codec_version;
+    }
+
+    uint16 key_hash_slot(const char* key, size_t len)
+    {
+        const char* start = (const char*) memchr(key, '{', len);
+        if (NULL != start)
+        {
+            const char* end = (const char*) memchr(start + 1, '}', key + len - start - 1);
+            if (NULL != end && end > start + 1)
+            {
+                return crc16(start + 1, end - start - 1) & (kClusterSlots - 1);
+            }
+        }
+        return crc16(key, len) & (kClusterSlots - 1);
+    }
+
+    /*
+     * Tags of the KEY_CODEC_V2 data encoding, in the order of Data::Compare(non alpha): nil < number < string.
+     */
+    static const char kOrderedNil = 1;
+    static const char kOrderedNumber = 2;
+    static const char kOrderedString = 3;
+    static const double kTwoPow63 = 9223372036854775808.0;
+    /*
+     * The key part of an element key with an object id: 0x00 0x02 and the big endian id, never produced by
+     * encode_ordered_string, so the ids of one namespace sort after the empty key & before all others.
+     */
+    static const char kObjectIdKeyTag = 2;
+    static const size_t kObjectIdKeySize = 10;
+
+    /*
+     * 0x00 bytes are escaped as 0x00 0xFF and the string ends with 0x00 0x01, a prefix sorts before longer strings.
+     */
+    static void encode_ordered_string(Buffer& buffer, const char* str, size_t len)
+    {
+        const char* end = str + len;
+        while (str < end)
+        {
+            const char* zero = (const char*) memchr(str, 0, end - str);
+            if (NULL == zero)
+            {
+                buffer.Write(str, end - str);
+                break;
+            }
+            buffer.Write(str, zero - str);
+            buffer.WriteByte(0);
+            buffer.WriteByte((char) 0xFF);
+            str = zero + 1;
+        }
+        buffer.WriteByte(0);
+        buffer.WriteByte(1);
+    }
+
+    static bool decode_ordered_string(Buffer& buffer, Data& data, bool clone_str)
+    {
+        const char* start = buffer.GetRawReadBuffer();
+        const char* end = start + buffer.ReadableBytes();
+        const char* cursor = start;
+        bool escaped = false;
+        while (true)
+        {
+            const char* zero = (const char*) memchr(cursor, 0, end - cursor);
+            if (NULL == zero || zero + 1 >= end)
+            {
+                return false;
+            }
+            if (zero[1] == 1)
+            {
+                cursor = zero;
+                break;
+            }
+            if ((uint8) zero[1] != 0xFF)
+            {
+                return false;
+            }
+            escaped = true;
+            cursor = zero + 2;
+        }
+        if (escaped)
+        {
+            std::string str;
+            str.reserve(cursor - start);
+            for (const char* c = start; c < cursor; c++)
+            {
+                str.push_back(*c);
+                if (0 == *c)
+                {
+                    c++;
+                }
+            }
+            data.SetString(str.data(), str.size(), true);
+        }
+        else
+        {
+            data.SetString(start, cursor - start, clone_str);
+        }
+        buffer.AdvanceReadIndex(cursor + 2 - start);
+        return true;
+    }
+
+    /*
+     * A number is the sign flipped big endian double of its value, followed by 2 bytes holding the difference of an
+     * int64 to that double(non zero only for ints beyond 2^53). Equal values give equal bytes whether stored as int or float,
+     * as both compare equal in Data::Compare.
+     */
+    static void encode_ordered_number(Buffer& buffer, const Data& data)
+    {
+        double d = data.GetFloat64();
+        int64 residual = 0;
+        if (data.IsInteger())
+        {
+            uint64 base = d >= kTwoPow63 ? (1ULL << 63) : (uint64) (int64) d;
+            residual = (int64) ((uint64) data.GetInt64() - base);
+        }
+        if (d == 0)
+        {
+            d = 0; //-0.0
+        }
+        uint64 bits;
+        memcpy(&bits, &d, sizeof(bits));
+        bits = (bits & (1ULL << 63)) ? ~bits : (bits | (1ULL << 63));
+        uint16 diff = (uint16) ((int16) residual) ^ 0x8000;
+        char tmp[11];
+        tmp[0] = kOrderedNumber;
+        for (int i = 0; i < 8; i++)
+        {
+            tmp[1 + i] = (char) (bits >> (56 - 8 * i));
+        }
+        tmp[9] = (char) (diff >> 8);
+        tmp[10] = (char) diff;
+        buffer.Write(tmp, sizeof(tmp));
+    }
+
+    /*
+     * Integral values in the int64 range are decoded as ints, floats otherwise.
+     */
+    static bool decode_ordered_number(Buffer& buffer, Data& data)
+    {
+        if (buffer.ReadableBytes() < 10)
+        {
+            return false;
+        }
+        const uint8* p = (const uint8*) buffer.GetRawReadBuffer();
+        uint64 bits = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            bits = (bits << 8) | p[i];
+        }
+        bits = (bits & (1ULL << 63)) ? (bits & ~(1ULL << 63)) : ~bits;
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        int16 residual = (int16) ((((uint16) p[8] << 8) | p[9]) ^ 0x8000);
+        buffer.AdvanceReadIndex(10);
+        if (0 != residual || (d >= -kTwoPow63 && d < kTwoPow63 && d == floor(d)))
+        {
+            uint64 base = d >= kTwoPow63 ? (1ULL << 63) : (uint64) (int64) d;
+            data.SetInt64((int64) (base + (uint64) (int64) residual));
+        }
+        else
+        {
+            data.SetFloat64(d);
+        }
+        return true;
+    }
+
+    static void encode_key_data(Buffer& buffer, const Data& data, uint8 codec)
+    {
+        if (!is_ordered_key_codec(codec))
+        {
+            data.Encode(buffer);
+            return;
+        }
+        if (data.IsNumber())
+        {
+            encode_ordered_number(buffer, data);
+        }
+        else if (data.IsString())
+        {
+            buffer.WriteByte(kOrderedString);
+            encode_ordered_string(buffer, data.CStr(), data.StringLength());
+        }
+        else
+        {
+            buffer.WriteByte(kOrderedNil);
+        }
+    }
+
+    static bool decode_key_data(Buffer& buffer, Data& data, bool clone_str, uint8 codec)
+    {
+        if (!is_ordered_key_codec(codec))
+        {
+            return data.Decode(buffer, clone_str);
+        }
+        char tag;
+        if (!buffer.ReadByte(tag))
+        {
+            return false;
+        }
+        switch (tag)
+        {
+            case kOrderedNil:
+            {
+                data.Clear();
+                return true;
+            }
+            case kOrderedNumber:
+            {
+                return decode_ordered_number(buffer, data);
+            }
+            case kOrderedString:
+            {
+                return decode_ordered_string(buffer, data, clone_str);
+            }
+            default:
+            {
+                return false;
+            }
+        }
+    }
+
     void KeyObject::SetType(uint8 t)
     {
         type = t;
@@ -47,11 +300,13 @@ OP_NAMESPACE_BEGIN
             case KEY_LIST_ELEMENT:
             case KEY_ZSET_SCORE:
             case KEY_HASH_FIELD:
+            case KEY_BITMAP_CHUNK:
             {
                 elements.resize(1);
                 break;
             }
             case KEY_ZSET_SORT:
+            case KEY_ZSET_RANK:
             {
                 elements.resize(2);
                 break;
@@ -59,7 +314,7 @@ OP_NAMESPACE_BEGIN
             case KEY_TTL_SORT:
             {
                 /*
-                 * 0: ttl 1:namespace 2:ttl key
+                 * 0: ttl 1:namespace 2:ttl key [3:hash field]
                  */
                 elements.resize(3);
                 break;
@@ -71,9 +326,31 @@ OP_NAMESPACE_BEGIN
         }
     }
 
-    bool KeyObject::DecodeNS(Buffer& buffer, bool clone_str)
+    bool KeyObject::DecodeNS(Buffer& buffer, bool clone_str, uint8 codec)
     {
-        return ns.Decode(buffer, clone_str);
+        return decode_key_data(buffer, ns, clone_str, key_codec(codec));
+    }
+
+    bool KeyObject::IsSameObject(const KeyObject& other) const
+    {
+        if (ns.Compare(other.ns, false) != 0)
+        {
+            return false;
+        }
+        if (object_id > 0 || other.object_id > 0)
+        {
+            return object_id == other.object_id;
+        }
+        return key.Compare(other.key, false) == 0;
+    }
+
+    uint16 KeyObject::GetSlot() const
+    {
+        if (slot >= 0)
+        {
+            return (uint16) slot;
+        }
+        return key.IsString() ? key_hash_slot(key.CStr(), key.StringLength()) : 0;
     }
 
     int KeyObject::Compare(const KeyObject& other) const
@@ -83,7 +360,35 @@ OP_NAMESPACE_BEGIN
         {
             return ret;
         }
-        ret = key.Compare(other.key, false);
+        if (g_key_codec_version == KEY_CODEC_V3)
+        {
+            ret = (int) GetSlot() - (int) other.GetSlot();
+            if (ret != 0)
+            {
+                return ret;
+            }
+        }
+        /*
+         * same order as the KEY_CODEC_V2 encoding, the key of an element key with an object id is ignored
+         */
+        uint64 id = type != KEY_META ? object_id : 0;
+        uint64 other_id = other.type != KEY_META ? other.object_id : 0;
+        if (id > 0 && other_id > 0)
+        {
+            ret = id == other_id ? 0 : (id < other_id ? -1 : 1);
+        }
+        else if (id > 0)
+        {
+            ret = other.key.StringLength() == 0 ? 1 : -1;
+        }
+        else if (other_id > 0)
+        {
+            ret = key.StringLength() == 0 ? -1 : 1;
+        }
+        else
+        {
+            ret = key.Compare(other.key, false);
+        }
         if (ret != 0)
         {
             return ret;
@@ -124,8 +429,31 @@ OP_NAMESPACE_BEGIN
 //        return key.Decode(buffer, clone_str);
 //    }
 
-    bool KeyObject::DecodeKey(Buffer& buffer, bool clone_str)
+    bool KeyObject::DecodeKey(Buffer& buffer, bool clone_str, uint8 codec)
     {
+        codec = key_codec(codec);
+        slot = -1;
+        if (codec == KEY_CODEC_V3)
+        {
+            uint16 s;
+            if (!BufferHelper::ReadFixUInt16(buffer, s))
+            {
+                return false;
+            }
+            slot = s;
+        }
+        if (is_ordered_key_codec(codec))
+        {
+            object_id = 0;
+            const char* p = buffer.GetRawReadBuffer();
+            if (buffer.ReadableBytes() >= kObjectIdKeySize && 0 == p[0] && kObjectIdKeyTag == p[1])
+            {
+                buffer.AdvanceReadIndex(2);
+                key.Clear();
+                return BufferHelper::ReadFixUInt64(buffer, object_id);
+            }
+            return decode_ordered_string(buffer, key, clone_str);
+        }
         uint32 keylen;
         if (!BufferHelper::ReadVarUInt32(buffer, keylen))
         {
@@ -151,9 +479,9 @@ OP_NAMESPACE_BEGIN
         return true;
     }
 
-    bool KeyObject::DecodePrefix(Buffer& buffer, bool clone_str)
+    bool KeyObject::DecodePrefix(Buffer& buffer, bool clone_str, uint8 codec)
     {
-        if (!DecodeKey(buffer, clone_str))
+        if (!DecodeKey(buffer, clone_str, codec))
         {
             return false;
         }
@@ -177,25 +505,26 @@ OP_NAMESPACE_BEGIN
         }
         return (int) len;
     }
-    bool KeyObject::DecodeElement(Buffer& buffer, bool clone_str, int idx)
+    bool KeyObject::DecodeElement(Buffer& buffer, bool clone_str, int idx, uint8 codec)
     {
         if (elements.size() <= idx)
         {
             elements.resize(idx + 1);
         }
-        return elements[idx].Decode(buffer, clone_str);
+        return decode_key_data(buffer, elements[idx], clone_str, key_codec(codec));
     }
-    bool KeyObject::Decode(Buffer& buffer, bool clone_str, bool with_ns)
+    bool KeyObject::Decode(Buffer& buffer, bool clone_str, bool with_ns, uint8 codec)
     {
         Clear();
+        codec = key_codec(codec);
         if (with_ns)
         {
-            if (!ns.Decode(buffer, clone_str))
+            if (!decode_key_data(buffer, ns, clone_str, codec))
             {
                 return false;
             }
         }
-        if (!DecodePrefix(buffer, clone_str))
+        if (!DecodePrefix(buffer, clone_str, codec))
         {
             return false;
         }
@@ -208,7 +537,7 @@ OP_NAMESPACE_BEGIN
         {
             for (int i = 0; i < elen1; i++)
             {
-                if (!DecodeElement(buffer, clone_str, i))
+                if (!DecodeElement(buffer, clone_str, i, codec))
                 {
                     return false;
                 }
@@ -217,28 +546,54 @@ OP_NAMESPACE_BEGIN
         return true;
     }
 
-    void KeyObject::EncodePrefix(Buffer& buffer) const
+    void KeyObject::EncodePrefix(Buffer& buffer, uint8 codec) const
     {
-        BufferHelper::WriteVarUInt32(buffer, key.StringLength());
-        buffer.Write(key.CStr(), key.StringLength());
+        codec = key_codec(codec);
+        if (codec == KEY_CODEC_V3)
+        {
+            BufferHelper::WriteFixUInt16(buffer, GetSlot());
+        }
+        if (is_ordered_key_codec(codec))
+        {
+            if (object_id > 0 && type != KEY_META)
+            {
+                buffer.WriteByte(0);
+                buffer.WriteByte(kObjectIdKeyTag);
+                BufferHelper::WriteFixUInt64(buffer, object_id);
+            }
+            else
+            {
+                encode_ordered_string(buffer, key.CStr(), key.StringLength());
+            }
+        }
+        else
+        {
+            BufferHelper::WriteVarUInt32(buffer, key.StringLength());
+            buffer.Write(key.CStr(), key.StringLength());
+        }
         buffer.WriteByte((char) type);
     }
-    Slice KeyObject::Encode(Buffer& buffer, bool verify, bool with_ns) const
+    Slice KeyObject::Encode(Buffer& buffer, bool verify, bool with_ns, uint8 codec) const
     {
         if (verify && !IsValid())
         {
             return Slice();
         }
+        codec = key_codec(codec);
         size_t mark = buffer.GetWriteIndex();
         if (with_ns)
         {
-            ns.Encode(buffer);
+            encode_key_data(buffer, ns, codec);
         }
-        EncodePrefix(buffer);
-        buffer.WriteByte((char) elements.size());
-        for (size_t i = 0; i < elements.size(); i++)
+        EncodePrefix(buffer, codec);
+        /*
+         * compare_keys ignores elements of meta keys, bytewise comparison would not
+         */
+        size_t element_count = (is_ordered_key_codec(codec) && type == KEY_META) ? 0 : elements.size();
+        buffer.WriteByte((char) element_count);
+        for (size_t i = 0; i < element_count; i++)
         {
-            elements[i].Encode(buffer);
+            encode_key_data(buffer, elements[i], codec);
         }
         return Slice(buffer.GetRawBuffer() + mark, buffer.GetWriteIndex() - mark);
     }
@@ -275,6 +630,9 @@ OP_NAMESPACE_BEGIN
             case KEY_SET_MEMBER:
             case KEY_ZSET_SORT:
             case KEY_ZSET_SCORE:
+            case KEY_ZSET_RANK:
+            case KEY_BITMAP_CHUNK:
+            case KEY_TTL_SORT:
             {
                 return true;
             }
@@ -285,7 +643,7 @@ OP_NAMESPACE_BEGIN
         }
     }
     MetaObject::MetaObject() :
-            format(kCurrentMetaFormat), ttl(0), size(-1), list_sequential(true)
+            format(kCurrentMetaFormat), ttl(0), size(-1), list_sequential(true), object_id(0)
     {
 
     }
@@ -295,6 +653,7 @@ OP_NAMESPACE_BEGIN
         ttl = 0;
         size = -1;
         list_sequential = true;
+        object_id = 0;
     }
     void MetaObject::Encode(Buffer& buffer, uint8 type) const
     {
@@ -317,6 +676,10 @@ OP_NAMESPACE_BEGIN
                 {
                     buffer.WriteByte(list_sequential ? 1 : 0);
                 }
+                if (format == kObjectIdMetaFormat)
+                {
+                    BufferHelper::WriteVarUInt64(buffer, object_id);
+                }
                 break;
             }
             default:
@@ -361,6 +724,10 @@ OP_NAMESPACE_BEGIN
                     }
                     list_sequential = (bool) tmp;
                 }
+                if (format == kObjectIdMetaFormat && !BufferHelper::ReadVarUInt64(buffer, object_id))
+                {
+                    return false;
+                }
                 break;
             }
             default:
@@ -448,6 +815,62 @@ OP_NAMESPACE_BEGIN
         return replaced;
     }
 
+    static void encode_value_element(Buffer& buf, const Data& v, bool compress)
+    {
+        size_t raw_len = v.StringLength();
+        if (!compress || 0 == g_value_compress_threshold || !v.IsString() || raw_len < g_value_compress_threshold)
+        {
+            v.Encode(buf);
+            return;
+        }
+        size_t start = buf.GetWriteIndex();
+        buf.WriteByte(kCompressedElementHeader);
+        size_t len_idx = buf.GetWriteIndex();
+        BufferHelper::WriteFixUInt32(buf, 0);
+        buf.EnsureWritableBytes(snappy::MaxCompressedLength(raw_len));
+        size_t compressed_len = 0;
+        snappy::RawCompress(v.CStr(), raw_len, const_cast<char*>(buf.GetRawWriteBuffer()), &compressed_len);
+        if (compressed_len + raw_len / 8 > raw_len)
+        {
+            //not worth the decompression
+            buf.SetWriteIndex(start);
+            v.Encode(buf);
+            return;
+        }
+        size_t end = buf.GetWriteIndex() + compressed_len;
+        buf.SetWriteIndex(len_idx);
+        BufferHelper::WriteFixUInt32(buf, compressed_len);
+        buf.SetWriteIndex(end);
+    }
+
+    static bool decode_value_element(Buffer& buf, Data& v, bool clone_str)
+    {
+        if (!buf.Readable() || *buf.GetRawReadBuffer() != kCompressedElementHeader)
+        {
+            return v.Decode(buf, clone_str);
+        }
+        buf.AdvanceReadIndex(1);
+        uint32 compressed_len = 0;
+        if (!BufferHelper::ReadFixUInt32(buf, compressed_len) || buf.ReadableBytes() < compressed_len)
+        {
+            return false;
+        }
+        const char* compressed = buf.GetRawReadBuffer();
+        size_t raw_len = 0;
+        if (!snappy::GetUncompressedLength(compressed, compressed_len, &raw_len))
+        {
+            return false;
+        }
+        v.Clear();
+        char* raw = (char*) v.ReserveStringSpace(raw_len);
+        if (raw_len > 0 && !snappy::RawUncompress(compressed, compressed_len, raw))
+        {
+            return false;
+        }
+        buf.AdvanceReadIndex(compressed_len);
+        return true;
+    }
+
     static void encode_value_object(Buffer& encode_buffer, uint8 type, uint16 merge_op, const DataArray& args, const MetaObject* meta)
     {
         encode_buffer.WriteByte((char) type);
@@ -475,7 +898,7 @@ OP_NAMESPACE_BEGIN
         encode_buffer.WriteByte((char) args.size());
         for (size_t i = 0; i < args.size(); i++)
         {
-            args[i].Encode(encode_buffer);
+            encode_value_element(encode_buffer, args[i], type != KEY_MERGE);
         }
     }
 
@@ -484,13 +907,135 @@ OP_NAMESPACE_BEGIN
         type = t;
     }
 
+    bool ValueObject::IsPacked() const
+    {
+        return meta.format == kPackedMetaFormat;
+    }
+    void ValueObject::SetPacked(bool packed)
+    {
+        if (packed)
+        {
+            meta.format = kPackedMetaFormat;
+            if (vals.size() < 2)
+            {
+                vals.resize(2);
+            }
+            meta.size = PackedCount();
+        }
+        else
+        {
+            meta.format = kCurrentMetaFormat;
+            if (vals.size() > 2)
+            {
+                vals.resize(2);
+            }
+        }
+    }
+    size_t ValueObject::packedLowerBound(const Data& field, bool& found)
+    {
+        size_t low = 0, high = PackedCount();
+        while (low < high)
+        {
+            size_t mid = low + (high - low) / 2;
+            if (PackedField(mid) < field)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        found = low < PackedCount() && PackedField(low) == field;
+        return low;
+    }
+    Data* ValueObject::GetPackedValue(const Data& field)
+    {
+        bool found = false;
+        size_t idx = packedLowerBound(field, found);
+        return found ? &PackedValue(idx) : NULL;
+    }
+    bool ValueObject::SetPackedValue(const Data& field, const Data& value)
+    {
+        bool found = false;
+        size_t idx = packedLowerBound(field, found);
+        if (found)
+        {
+            PackedValue(idx).Clone(value);
+            return false;
+        }
+        vals.insert(vals.begin() + 2 + idx * 2, 2, Data());
+        PackedField(idx).Clone(field);
+        PackedValue(idx).Clone(value);
+        meta.size = PackedCount();
+        return true;
+    }
+    bool ValueObject::DelPackedValue(const Data& field)
+    {
+        bool found = false;
+        size_t idx = packedLowerBound(field, found);
+        if (!found)
+        {
+            return false;
+        }
+        vals.erase(vals.begin() + 2 + idx * 2, vals.begin() + 4 + idx * 2);
+        meta.size = PackedCount();
+        return true;
+    }
+
+    bool ValueObject::IsRankIndexed() const
+    {
+        return meta.format == kRankIndexedMetaFormat;
+    }
+    void ValueObject::SetRankIndexed(bool indexed)
+    {
+        meta.format = indexed ? kRankIndexedMetaFormat : kCurrentMetaFormat;
+    }
+
+    uint64 ValueObject::GetObjectId() const
+    {
+        return meta.format == kObjectIdMetaFormat ? meta.object_id : 0;
+    }
+    void ValueObject::SetObjectId(uint64 id)
+    {
+        meta.format = id > 0 ? kObjectIdMetaFormat : kCurrentMetaFormat;
+        meta.object_id = id;
+    }
+
+    bool ValueObject::IsChunked() const
+    {
+        return meta.format == kChunkedMetaFormat;
+    }
+    void ValueObject::SetChunked(bool chunked)
+    {
+        if (chunked)
+        {
+            meta.format = kChunkedMetaFormat;
+            vals.resize(3);
+            vals[0].SetString("", false);
+        }
+        else
+        {
+            meta.format = kCurrentMetaFormat;
+            if (vals.size() > 1)
+            {
+                vals.resize(1);
+            }
+        }
+    }
+
     Slice ValueObject::Encode(Buffer& encode_buffer) const
     {
         if (0 == type)
         {
             return Slice();
         }
+        EngineProfileScope scope(g_engine_profiling ? CurrentEngineProfile() : NULL, &EngineProfile::codec_nanos);
         encode_value_object(encode_buffer, type, merge_op, vals, &meta);
+        if (NULL != scope.profile)
+        {
+            scope.profile->written_bytes += encode_buffer.ReadableBytes();
+        }
         return Slice(encode_buffer.GetRawReadBuffer(), encode_buffer.ReadableBytes());
     }
 
@@ -539,6 +1084,11 @@ OP_NAMESPACE_BEGIN
 
     bool ValueObject::Decode(Buffer& buffer, bool clone_str)
     {
+        EngineProfileScope scope(g_engine_profiling ? CurrentEngineProfile() : NULL, &EngineProfile::codec_nanos);
+        if (NULL != scope.profile)
+        {
+            scope.profile->read_bytes += buffer.ReadableBytes();
+        }
         if (!DecodeMeta(buffer))
         {
             return false;
@@ -554,7 +1104,7 @@ OP_NAMESPACE_BEGIN
             vals.resize(len);
             for (uint8 i = 0; i < len; i++)
             {
-                if (!vals[i].Decode(buffer, clone_str))
+                if (!decode_value_element(buffer, vals[i], clone_str))
                 {
                     return false;
                 }
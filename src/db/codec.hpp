@@ -37,6 +37,7 @@
 #include "types.hpp"
 #include <assert.h>
 #include <deque>
+#include <stdexcept>
 
 OP_NAMESPACE_BEGIN
 
@@ -54,23 +55,112 @@ OP_NAMESPACE_BEGIN
 
         KEY_SET = 7, KEY_SET_MEMBER = 8,
 
-        KEY_ZSET = 9, KEY_ZSET_SORT = 10, KEY_ZSET_SCORE = 11,
+        KEY_ZSET = 9, KEY_ZSET_SORT = 10, KEY_ZSET_SCORE = 11, KEY_ZSET_RANK = 12,
+
+        KEY_BITMAP_CHUNK = 13,
 
         /*
-         * Reserver 20 types
+         * Reserver 15 types
          */
         KEY_TTL_SORT = 29,
         KEY_MERGE = 30,
         KEY_END = 31, /* max value for 1byte */
     };
 
+    /*
+     * Encoding of keys in the engine, fixed when a data dir is created.
+     * KEY_CODEC_V1 keys are length prefixed & need compare_keys to decode them for ordering,
+     * KEY_CODEC_V2 keys are order preserving(escaped strings, big endian sign flipped numbers),
+     * so plain bytewise comparison gives the same order & engines can use their native comparator.
+     * KEY_CODEC_V3 is KEY_CODEC_V2 with the big endian cluster hash slot of the key ahead of the key bytes,
+     * all keys of one slot are contiguous in a namespace(no object ids).
+     */
+    enum KeyCodecVersion
+    {
+        KEY_CODEC_V1 = 1, KEY_CODEC_V2 = 2, KEY_CODEC_V3 = 3,
+    };
+    uint8 get_key_codec_version();
+    void set_key_codec_version(uint8 version);
+    /*
+     * KEY_CODEC_V2 & later sort bytewise.
+     */
+    inline bool is_ordered_key_codec(uint8 version)
+    {
+        return version >= KEY_CODEC_V2;
+    }
+
+    /*
+     * Redis cluster hash slot of a key, CRC16 of the '{tag}' part if any else of the whole key.
+     */
+    static const uint32 kClusterSlots = 16384;
+    uint16 key_hash_slot(const char* key, size_t len);
+
+    /*
+     * String elements of values(except merge operands) at least this long are snappy compressed by
+     * ValueObject::Encode when that saves 1/8 of their size, 0 to disable. Decoding always handles them.
+     */
+    void set_value_compress_threshold(uint32 threshold);
+
+    /*
+     * Element array with the first N elements stored inline, more elements(only from corrupted or future keys)
+     * spill into a vector. Slots beyond size() are always cleared.
+     */
+    template<uint32 N>
+    class SmallDataArray
+    {
+        private:
+            Data m_inline[N];
+            DataArray m_spill;
+            uint32 m_size;
+        public:
+            SmallDataArray() :
+                    m_size(0)
+            {
+            }
+            size_t size() const
+            {
+                return m_size;
+            }
+            Data& operator[](size_t idx)
+            {
+                return idx < N ? m_inline[idx] : m_spill[idx - N];
+            }
+            const Data& operator[](size_t idx) const
+            {
+                return idx < N ? m_inline[idx] : m_spill[idx - N];
+            }
+            const Data& at(size_t idx) const
+            {
+                if (idx >= m_size)
+                {
+                    throw std::out_of_range("SmallDataArray::at");
+                }
+                return (*this)[idx];
+            }
+            void resize(size_t n)
+            {
+                for (size_t i = n; i < m_size && i < N; i++)
+                {
+                    m_inline[i].Clear();
+                }
+                m_spill.resize(n > N ? n - N : 0);
+                m_size = n;
+            }
+            void clear()
+            {
+                resize(0);
+            }
+    };
+
     struct KeyObject
     {
         private:
             Data ns; //namespace
             uint8 type;
             Data key;
-            DataArray elements;
+            uint64 object_id; //replaces the key bytes in element keys if not 0, see ValueObject::GetObjectId
+            int32 slot; //hash slot for KEY_CODEC_V3 if >= 0, computed from the key otherwise
+            SmallDataArray<4> elements; //no key type has more than 3 elements
 
             Data& getElement(uint32_t idx)
             {
@@ -86,18 +176,18 @@ OP_NAMESPACE_BEGIN
             }
         public:
             KeyObject(uint8 t = 0) :
-                    type(t)
+                    type(t), object_id(0), slot(-1)
             {
                 SetType(t);
             }
             KeyObject(const Data& nns, uint8 t, const std::string& data) :
-                    ns(nns), type(0)
+                    ns(nns), type(0), object_id(0), slot(-1)
             {
                 key.SetString(data, false);
                 SetType(t);
             }
             KeyObject(const Data& nns, uint8 t, const Data& key_data) :
-                    ns(nns), type(0), key(key_data)
+                    ns(nns), type(0), key(key_data), object_id(0), slot(-1)
             {
                 SetType(t);
             }
@@ -106,6 +196,8 @@ OP_NAMESPACE_BEGIN
                 type = 0;
                 ns.Clear();
                 key.Clear();
+                object_id = 0;
+                slot = -1;
                 elements.clear();
             }
             const Data& GetNameSpace() const
@@ -132,11 +224,33 @@ OP_NAMESPACE_BEGIN
             void SetKey(const Data& d)
             {
                 key = d;
+                slot = -1;
             }
             void SetKey(const std::string& v)
             {
                 key.SetString(v, false);
+                slot = -1;
+            }
+            /*
+             * Pins the slot of the key, e.g. to seek to the first key of a slot with an empty key.
+             */
+            void SetSlot(uint16 s)
+            {
+                slot = s;
+            }
+            uint16 GetSlot() const;
+            uint64 GetObjectId() const
+            {
+                return object_id;
             }
+            void SetObjectId(uint64 id)
+            {
+                object_id = id;
+            }
+            /*
+             * Element keys decoded from the engine carry only the object id of their object, not its key.
+             */
+            bool IsSameObject(const KeyObject& other) const;
             void SetHashField(const std::string& v)
             {
                 getElement(0).SetString(v, true);
@@ -218,6 +332,14 @@ OP_NAMESPACE_BEGIN
             {
                 return getElement(0).GetFloat64();
             }
+            void SetBitmapChunk(int64 idx)
+            {
+                getElement(0).SetInt64(idx);
+            }
+            int64 GetBitmapChunk() const
+            {
+                return GetElement(0).GetInt64();
+            }
             void SetTTLKeyNamespace(const Data& ns)
             {
                 setElement(ns, 1);
@@ -226,6 +348,17 @@ OP_NAMESPACE_BEGIN
             {
                 getElement(2).SetString(key, false);
             }
+            void SetTTLField(const std::string& field)
+            {
+                getElement(3).SetString(field, false);
+            }
+            /*
+             * entries of hash fields with a ttl(HEXPIRE) have the field as 4th element
+             */
+            bool IsFieldTTL() const
+            {
+                return type == KEY_TTL_SORT && elements.size() > 3;
+            }
             const Data& GetTTLKey() const
             {
                 return GetElement(0);
@@ -245,15 +378,18 @@ OP_NAMESPACE_BEGIN
 
             bool IsValid() const;
             int Compare(const KeyObject& other) const;
-            Slice Encode(Buffer& buffer, bool verify = true, bool with_ns = false) const;
-            void EncodePrefix(Buffer& buffer) const;
-            bool DecodeNS(Buffer& buffer, bool clone_str);
-            bool DecodeKey(Buffer& buffer, bool clone_str);
+            /*
+             * 'codec' 0 means the key codec version of the running instance.
+             */
+            Slice Encode(Buffer& buffer, bool verify = true, bool with_ns = false, uint8 codec = 0) const;
+            void EncodePrefix(Buffer& buffer, uint8 codec = 0) const;
+            bool DecodeNS(Buffer& buffer, bool clone_str, uint8 codec = 0);
+            bool DecodeKey(Buffer& buffer, bool clone_str, uint8 codec = 0);
             bool DecodeType(Buffer& buffer);
-            bool DecodePrefix(Buffer& buffer, bool clone_str);
+            bool DecodePrefix(Buffer& buffer, bool clone_str, uint8 codec = 0);
             int DecodeElementLength(Buffer& buffer);
-            bool DecodeElement(Buffer& buffer, bool clone_str, int idx);
-            bool Decode(Buffer& buffer, bool clone_str, bool with_ns = false);
+            bool DecodeElement(Buffer& buffer, bool clone_str, int idx, uint8 codec = 0);
+            bool Decode(Buffer& buffer, bool clone_str, bool with_ns = false, uint8 codec = 0);
 
             void CloneStringPart();
 
@@ -278,6 +414,7 @@ OP_NAMESPACE_BEGIN
             int64_t ttl;
             int64_t size;
             bool list_sequential;  //indicate that list is sequential ot not
+            uint64 object_id;
             MetaObject();
             void Encode(Buffer& buffer, uint8 type) const;
             bool Decode(Buffer& buffer, uint8 type);
@@ -301,6 +438,7 @@ OP_NAMESPACE_BEGIN
                 }
                 return vals[idx];
             }
+            size_t packedLowerBound(const Data& field, bool& found);
         public:
             ValueObject() :
                     type(0), merge_op(0)
@@ -397,6 +535,29 @@ OP_NAMESPACE_BEGIN
             {
                 return getElement(0);
             }
+            /*
+             * Field level expire time(HPEXPIREAT) in the second value of a hash field, 0 if the field does not expire.
+             */
+            int64 GetHashFieldTTL() const
+            {
+                return vals.size() > 1 ? vals[1].GetInt64() : 0;
+            }
+            void SetHashFieldTTL(int64 ttl)
+            {
+                if (ttl > 0)
+                {
+                    getElement(1).SetInt64(ttl);
+                }
+                else if (vals.size() > 1)
+                {
+                    vals.resize(1);
+                }
+            }
+            bool IsHashFieldExpired(int64 now) const
+            {
+                int64 ttl = GetHashFieldTTL();
+                return ttl > 0 && ttl <= now;
+            }
             Data& GetListElement()
             {
                 return getElement(0);
@@ -411,6 +572,14 @@ OP_NAMESPACE_BEGIN
             {
                 getElement(0).SetFloat64(s);
             }
+            int64 GetZSetRankCount()
+            {
+                return getElement(0).GetInt64();
+            }
+            void SetZSetRankCount(int64 v)
+            {
+                getElement(0).SetInt64(v);
+            }
             void SetMergeArgs(const DataArray& args)
             {
                 vals = args;
@@ -419,6 +588,68 @@ OP_NAMESPACE_BEGIN
             {
                 return vals;
             }
+            /*
+             * A packed object keeps all its elements inside the meta value as field/value pairs sorted by field,
+             * which are stored after the min/max slots.
+             */
+            bool IsPacked() const;
+            void SetPacked(bool packed);
+            size_t PackedCount() const
+            {
+                return vals.size() > 2 ? (vals.size() - 2) / 2 : 0;
+            }
+            Data& PackedField(size_t idx)
+            {
+                return vals[2 + idx * 2];
+            }
+            Data& PackedValue(size_t idx)
+            {
+                return vals[3 + idx * 2];
+            }
+            Data* GetPackedValue(const Data& field);
+            bool SetPackedValue(const Data& field, const Data& value); //return true if the field is new
+            bool DelPackedValue(const Data& field);
+            /*
+             * A rank indexed zset keeps KEY_ZSET_RANK block keys besides its elements, see Ardb::ZRankOf.
+             */
+            bool IsRankIndexed() const;
+            void SetRankIndexed(bool indexed);
+            /*
+             * A chunked string keeps its bytes in KEY_BITMAP_CHUNK keys, the meta only holds the string length
+             * and the chunk size it was written with.
+             */
+            bool IsChunked() const;
+            void SetChunked(bool chunked);
+            int64 GetChunkedLength()
+            {
+                return getElement(1).GetInt64();
+            }
+            void SetChunkedLength(int64 len)
+            {
+                getElement(1).SetInt64(len);
+            }
+            int64 GetChunkSize()
+            {
+                return getElement(2).GetInt64();
+            }
+            void SetChunkSize(int64 size)
+            {
+                getElement(2).SetInt64(size);
+            }
+            /*
+             * Bloom filters and time series are chunked strings described by a header after the chunk size,
+             * see t_bloom.cpp and t_timeseries.cpp.
+             */
+            Data& GetChunkedHeader()
+            {
+                return getElement(3);
+            }
+            /*
+             * Element keys of an object with an object id(only non packed hashes, KEY_CODEC_V2) are encoded
+             * as the id instead of the key bytes, they stay where they are when the object is renamed.
+             */
+            uint64 GetObjectId() const;
+            void SetObjectId(uint64 id);
             Slice Encode(Buffer& buffer) const;
             bool DecodeMeta(Buffer& buffer);
             bool Decode(Buffer& buffer, bool clone_str);
@@ -0,0 +1,423 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "counter_buffer.hpp"
+#include "thread/lock_guard.hpp"
+#include "util/atomic.hpp"
+#include "util/murmur3.h"
+#include <limits.h>
+
+OP_NAMESPACE_BEGIN
+
+    CounterEngine::CounterEngine(Engine* engine, const StringArray& prefixes) :
+            m_engine(engine), m_prefixes(prefixes), m_pending_keys(0), m_absorbed(0), m_flushed(0)
+    {
+    }
+    CounterEngine::Shard& CounterEngine::GetShard(const std::string& pk)
+    {
+        uint32 hash = 0;
+        MurmurHash3_x86_32(pk.data(), pk.size(), 0, &hash);
+        return m_shards[hash % kShards];
+    }
+    void CounterEngine::PendingKey(const KeyObject& key, std::string& pk)
+    {
+        Buffer buffer;
+        key.Encode(buffer, false, true);
+        pk.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+    }
+    bool CounterEngine::Absorbable(Context& ctx, const KeyObject& key, uint16_t op)
+    {
+        switch (op)
+        {
+            case REDIS_CMD_INCR:
+            case REDIS_CMD_INCR2:
+            case REDIS_CMD_INCRBY:
+            case REDIS_CMD_INCRBY2:
+            case REDIS_CMD_DECR:
+            case REDIS_CMD_DECR2:
+            case REDIS_CMD_DECRBY:
+            case REDIS_CMD_DECRBY2:
+            {
+                break;
+            }
+            default:
+            {
+                return false;
+            }
+        }
+        if (key.GetType() != KEY_META || ctx.InTransaction())
+        {
+            return false;
+        }
+        const Data& k = key.GetKey();
+        for (size_t i = 0; i < m_prefixes.size(); i++)
+        {
+            if (k.StringLength() >= m_prefixes[i].size() && !strncmp(k.CStr(), m_prefixes[i].data(), m_prefixes[i].size()))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    int CounterEngine::WriteDelta(Context& ctx, const KeyObject& key, int64 delta)
+    {
+        DataArray args(1);
+        args[0].SetInt64(delta);
+        int err = m_engine->Merge(ctx, key, REDIS_CMD_INCRBY, args);
+        if (0 != err)
+        {
+            ERROR_LOG("Failed to flush pending delta:%lld of key:%s for reason:%s", (long long) delta, key.GetKey().AsString().c_str(),
+                    m_engine->GetErrorReason(err).c_str());
+        }
+        atomic_add_uint64(&m_flushed, 1);
+        return err;
+    }
+    void CounterEngine::FlushKey(Context& ctx, const KeyObject& key)
+    {
+        if (0 == m_pending_keys || key.GetType() != KEY_META)
+        {
+            return;
+        }
+        std::string pk;
+        PendingKey(key, pk);
+        Shard& shard = GetShard(pk);
+        /*
+         * the delta is merged with the shard locked, a concurrent read of the key waits for it instead of missing it
+         */
+        LockGuard<ThreadMutex> guard(shard.lock);
+        PendingTable::iterator found = shard.pending.find(pk);
+        if (found == shard.pending.end())
+        {
+            return;
+        }
+        WriteDelta(ctx, found->second.key, found->second.delta);
+        shard.pending.erase(found);
+        atomic_sub_uint64(&m_pending_keys, 1);
+    }
+    void CounterEngine::FlushPending(const Data* ns)
+    {
+        if (0 == m_pending_keys)
+        {
+            return;
+        }
+        for (uint32 i = 0; i < kShards; i++)
+        {
+            Shard& shard = m_shards[i];
+            LockGuard<ThreadMutex> guard(shard.lock);
+            if (shard.pending.empty())
+            {
+                continue;
+            }
+            Context ctx;
+            WriteBatchGuard batch(ctx, m_engine);
+            StringArray flushed;
+            PendingTable::iterator it = shard.pending.begin();
+            while (it != shard.pending.end())
+            {
+                if (NULL == ns || it->second.key.GetNameSpace() == *ns)
+                {
+                    WriteDelta(ctx, it->second.key, it->second.delta);
+                    flushed.push_back(it->first);
+                }
+                it++;
+            }
+            for (size_t j = 0; j < flushed.size(); j++)
+            {
+                shard.pending.erase(flushed[j]);
+            }
+            atomic_sub_uint64(&m_pending_keys, flushed.size());
+        }
+    }
+    int CounterEngine::Init(const std::string& dir, const std::string& options)
+    {
+        return m_engine->Init(dir, options);
+    }
+    int CounterEngine::Repair(const std::string& dir)
+    {
+        return m_engine->Repair(dir);
+    }
+    int CounterEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
+    {
+        FlushPending(&ns);
+        return m_engine->PutRaw(ctx, ns, key, value);
+    }
+    int CounterEngine::Put(Context& ctx, const KeyObject& key, const ValueObject& value)
+    {
+        FlushKey(ctx, key);
+        return m_engine->Put(ctx, key, value);
+    }
+    int CounterEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
+    {
+        FlushKey(ctx, key);
+        return m_engine->Get(ctx, key, value);
+    }
+    int CounterEngine::Del(Context& ctx, const KeyObject& key)
+    {
+        FlushKey(ctx, key);
+        return m_engine->Del(ctx, key);
+    }
+    int CounterEngine::MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs)
+    {
+        for (size_t i = 0; i < keys.size() && m_pending_keys > 0; i++)
+        {
+            FlushKey(ctx, keys[i]);
+        }
+        return m_engine->MultiGet(ctx, keys, values, errs);
+    }
+    int CounterEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values)
+    {
+        if (values.size() != 1 || !Absorbable(ctx, key, op))
+        {
+            FlushKey(ctx, key);
+            return m_engine->Merge(ctx, key, op, values);
+        }
+        int64 delta = values[0].GetInt64();
+        if (op == REDIS_CMD_DECR || op == REDIS_CMD_DECR2)
+        {
+            delta = -1;
+        }
+        else if (op == REDIS_CMD_DECRBY || op == REDIS_CMD_DECRBY2)
+        {
+            delta = 0 - delta;
+        }
+        std::string pk;
+        PendingKey(key, pk);
+        Shard& shard = GetShard(pk);
+        LockGuard<ThreadMutex> guard(shard.lock);
+        PendingTable::iterator found = shard.pending.find(pk);
+        if (found == shard.pending.end())
+        {
+            PendingCounter& counter = shard.pending[pk];
+            counter.key = key;
+            counter.key.CloneStringPart();
+            counter.delta = delta;
+            atomic_add_uint64(&m_pending_keys, 1);
+        }
+        else
+        {
+            int64& pending = found->second.delta;
+            if ((delta > 0 && pending > LLONG_MAX - delta) || (delta < 0 && pending < LLONG_MIN - delta))
+            {
+                /*
+                 * the sum would overflow, write out what is pending & start over
+                 */
+                WriteDelta(ctx, found->second.key, pending);
+                pending = 0;
+            }
+            pending += delta;
+        }
+        atomic_add_uint64(&m_absorbed, 1);
+        return 0;
+    }
+    bool CounterEngine::Exists(Context& ctx, const KeyObject& key)
+    {
+        FlushKey(ctx, key);
+        return m_engine->Exists(ctx, key);
+    }
+    int CounterEngine::DelRange(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        FlushPending(&start.GetNameSpace());
+        return m_engine->DelRange(ctx, start, end);
+    }
+    Iterator* CounterEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
+    {
+        FlushPending(&key.GetNameSpace());
+        return m_engine->Find(ctx, key, options);
+    }
+    int CounterEngine::Compact(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        return m_engine->Compact(ctx, start, end);
+    }
+    int CounterEngine::CompactAll(Context& ctx)
+    {
+        return m_engine->CompactAll(ctx);
+    }
+    int CounterEngine::CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress)
+    {
+        return m_engine->CompactDeleted(ctx, ns, min_deleted_percent, progress);
+    }
+    int CounterEngine::CompactQueuedRanges(Context& ctx)
+    {
+        return m_engine->CompactQueuedRanges(ctx);
+    }
+    int CounterEngine::DropExpiredTables(Context& ctx)
+    {
+        return m_engine->DropExpiredTables(ctx);
+    }
+    uint64_t CounterEngine::GetThreadSkippedDeletes()
+    {
+        return m_engine->GetThreadSkippedDeletes();
+    }
+    int CounterEngine::FlushPendingWrites(Context& ctx)
+    {
+        uint64 pending = m_pending_keys;
+        FlushPending(NULL);
+        return (int) pending;
+    }
+    int CounterEngine::BeginWriteBatch(Context& ctx)
+    {
+        return m_engine->BeginWriteBatch(ctx);
+    }
+    int CounterEngine::CommitWriteBatch(Context& ctx)
+    {
+        return m_engine->CommitWriteBatch(ctx);
+    }
+    int CounterEngine::DiscardWriteBatch(Context& ctx)
+    {
+        return m_engine->DiscardWriteBatch(ctx);
+    }
+    int CounterEngine::ListNameSpaces(Context& ctx, DataArray& nss)
+    {
+        FlushPending(NULL);
+        return m_engine->ListNameSpaces(ctx, nss);
+    }
+    int CounterEngine::DropNameSpace(Context& ctx, const Data& ns)
+    {
+        FlushPending(&ns);
+        return m_engine->DropNameSpace(ctx, ns);
+    }
+    int CounterEngine::DetachNameSpace(Context& ctx, const Data& ns)
+    {
+        FlushPending(&ns);
+        return m_engine->DetachNameSpace(ctx, ns);
+    }
+    int CounterEngine::SwapNameSpace(Context& ctx, const Data& ns, const Data& from)
+    {
+        FlushPending(&ns);
+        FlushPending(&from);
+        return m_engine->SwapNameSpace(ctx, ns, from);
+    }
+    int CounterEngine::Refresh(Context& ctx)
+    {
+        return m_engine->Refresh(ctx);
+    }
+    int CounterEngine::ReclaimDetachedNameSpaces(Context& ctx)
+    {
+        return m_engine->ReclaimDetachedNameSpaces(ctx);
+    }
+    int CounterEngine::Flush(Context& ctx, const Data& ns)
+    {
+        FlushPending(&ns);
+        return m_engine->Flush(ctx, ns);
+    }
+    int CounterEngine::FlushAll(Context& ctx)
+    {
+        FlushPending(NULL);
+        return m_engine->FlushAll(ctx);
+    }
+    int CounterEngine::BeginBulkLoad(Context& ctx)
+    {
+        FlushPending(NULL);
+        return m_engine->BeginBulkLoad(ctx);
+    }
+    int CounterEngine::BeginSnapshotRead(Context& ctx)
+    {
+        FlushPending(NULL);
+        return m_engine->BeginSnapshotRead(ctx);
+    }
+    int CounterEngine::EndSnapshotRead(Context& ctx)
+    {
+        return m_engine->EndSnapshotRead(ctx);
+    }
+    const void* CounterEngine::CreateSharedSnapshot(Context& ctx)
+    {
+        /*
+         * taken under the write fence of a save, the snapshot has to hold every increment up to the WAL offset
+         */
+        FlushPending(NULL);
+        return m_engine->CreateSharedSnapshot(ctx);
+    }
+    int CounterEngine::BeginSharedSnapshotRead(Context& ctx, const void* snapshot)
+    {
+        return m_engine->BeginSharedSnapshotRead(ctx, snapshot);
+    }
+    void CounterEngine::ReleaseSharedSnapshot(Context& ctx, const void* snapshot)
+    {
+        m_engine->ReleaseSharedSnapshot(ctx, snapshot);
+    }
+    int CounterEngine::EndBulkLoad(Context& ctx)
+    {
+        return m_engine->EndBulkLoad(ctx);
+    }
+    int64_t CounterEngine::EstimateKeysNum(Context& ctx, const Data& ns)
+    {
+        return m_engine->EstimateKeysNum(ctx, ns);
+    }
+    int64_t CounterEngine::GetLatestSequence()
+    {
+        return m_engine->GetLatestSequence();
+    }
+    int CounterEngine::Checkpoint(Context& ctx, const std::string& dir)
+    {
+        FlushPending(NULL);
+        return m_engine->Checkpoint(ctx, dir);
+    }
+    int CounterEngine::SetOption(Context& ctx, const std::string& name, const std::string& value)
+    {
+        return m_engine->SetOption(ctx, name, value);
+    }
+    bool CounterEngine::IsWriteStalled()
+    {
+        return m_engine->IsWriteStalled();
+    }
+    int CounterEngine::Restore(Context& ctx, const std::string& dir)
+    {
+        FlushPending(NULL);
+        return m_engine->Restore(ctx, dir);
+    }
+    int CounterEngine::BeginBulkIngest(Context& ctx, const Data& ns)
+    {
+        FlushPending(&ns);
+        return m_engine->BeginBulkIngest(ctx, ns);
+    }
+    int CounterEngine::EndBulkIngest(Context& ctx, const Data& ns, bool abort)
+    {
+        return m_engine->EndBulkIngest(ctx, ns, abort);
+    }
+    void CounterEngine::Stats(Context& ctx, std::string& str)
+    {
+        str.append("counter_coalesce_pending_keys:").append(stringfromll(m_pending_keys)).append("\r\n");
+        str.append("counter_coalesce_absorbed:").append(stringfromll(m_absorbed)).append("\r\n");
+        str.append("counter_coalesce_flushed:").append(stringfromll(m_flushed)).append("\r\n");
+        m_engine->Stats(ctx, str);
+    }
+    const std::string CounterEngine::GetErrorReason(int err)
+    {
+        return m_engine->GetErrorReason(err);
+    }
+    const FeatureSet CounterEngine::GetFeatureSet()
+    {
+        return m_engine->GetFeatureSet();
+    }
+    CounterEngine::~CounterEngine()
+    {
+        FlushPending(NULL);
+        DELETE(m_engine);
+    }
+
+OP_NAMESPACE_END
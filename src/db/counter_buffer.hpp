@@ -0,0 +1,137 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_DB_COUNTER_BUFFER_HPP_
+#define SRC_DB_COUNTER_BUFFER_HPP_
+
+#include "engine.hpp"
+#include "thread/thread_mutex.hpp"
+#include <sparsehash/dense_hash_map>
+
+OP_NAMESPACE_BEGIN
+
+    /*
+     * counter-coalesce-interval: the engine is wrapped by CounterEngine at start, INCR/INCRBY/DECR/DECRBY merges of
+     * string keys starting with one of the 'counter-coalesce-prefixes' are summed in memory & written to the engine
+     * as one INCRBY merge per key every interval. The commands are still written to the WAL one by one, only the
+     * engine writes are coalesced, a crash loses at most one interval of increments not yet flushed to the engine.
+     * Any other access to a key with a pending delta(reads, other writes, iterators of its namespace) flushes the
+     * delta first, so reads always see the stored value plus the pending delta. Writes inside MULTI are not absorbed.
+     */
+    class CounterEngine: public Engine
+    {
+        private:
+            struct PendingCounter
+            {
+                    KeyObject key;
+                    int64 delta;
+                    PendingCounter() :
+                            delta(0)
+                    {
+                    }
+            };
+            typedef google::dense_hash_map<std::string, PendingCounter> PendingTable;
+            struct Shard
+            {
+                    ThreadMutex lock;
+                    PendingTable pending;
+                    Shard()
+                    {
+                        pending.set_empty_key("");
+                        pending.set_deleted_key(std::string(1, '\0'));
+                    }
+            };
+            static const uint32 kShards = 16;
+            Engine* m_engine;
+            Shard m_shards[kShards];
+            StringArray m_prefixes;
+            volatile uint64 m_pending_keys;
+            volatile uint64 m_absorbed;
+            volatile uint64 m_flushed;
+            Shard& GetShard(const std::string& pk);
+            void PendingKey(const KeyObject& key, std::string& pk);
+            bool Absorbable(Context& ctx, const KeyObject& key, uint16_t op);
+            int WriteDelta(Context& ctx, const KeyObject& key, int64 delta);
+            void FlushKey(Context& ctx, const KeyObject& key);
+            void FlushPending(const Data* ns);
+        public:
+            CounterEngine(Engine* engine, const StringArray& prefixes);
+            int Init(const std::string& dir, const std::string& options);
+            int Repair(const std::string& dir);
+            int PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value);
+            int Put(Context& ctx, const KeyObject& key, const ValueObject& value);
+            int Get(Context& ctx, const KeyObject& key, ValueObject& value);
+            int Del(Context& ctx, const KeyObject& key);
+            int MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs);
+            int Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values);
+            bool Exists(Context& ctx, const KeyObject& key);
+            int DelRange(Context& ctx, const KeyObject& start, const KeyObject& end);
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
+            int Compact(Context& ctx, const KeyObject& start, const KeyObject& end);
+            int CompactAll(Context& ctx);
+            int CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress);
+            int CompactQueuedRanges(Context& ctx);
+            int DropExpiredTables(Context& ctx);
+            uint64_t GetThreadSkippedDeletes();
+            int FlushPendingWrites(Context& ctx);
+            int BeginWriteBatch(Context& ctx);
+            int CommitWriteBatch(Context& ctx);
+            int DiscardWriteBatch(Context& ctx);
+            int ListNameSpaces(Context& ctx, DataArray& nss);
+            int DropNameSpace(Context& ctx, const Data& ns);
+            int DetachNameSpace(Context& ctx, const Data& ns);
+            int SwapNameSpace(Context& ctx, const Data& ns, const Data& from);
+            int Refresh(Context& ctx);
+            int ReclaimDetachedNameSpaces(Context& ctx);
+            int Flush(Context& ctx, const Data& ns);
+            int FlushAll(Context& ctx);
+            int BeginBulkLoad(Context& ctx);
+            int BeginSnapshotRead(Context& ctx);
+            int EndSnapshotRead(Context& ctx);
+            const void* CreateSharedSnapshot(Context& ctx);
+            int BeginSharedSnapshotRead(Context& ctx, const void* snapshot);
+            void ReleaseSharedSnapshot(Context& ctx, const void* snapshot);
+            int EndBulkLoad(Context& ctx);
+            int64_t EstimateKeysNum(Context& ctx, const Data& ns);
+            int64_t GetLatestSequence();
+            int Checkpoint(Context& ctx, const std::string& dir);
+            int SetOption(Context& ctx, const std::string& name, const std::string& value);
+            bool IsWriteStalled();
+            int Restore(Context& ctx, const std::string& dir);
+            int BeginBulkIngest(Context& ctx, const Data& ns);
+            int EndBulkIngest(Context& ctx, const Data& ns, bool abort);
+            void Stats(Context& ctx, std::string& str);
+            const std::string GetErrorReason(int err);
+            const FeatureSet GetFeatureSet();
+            ~CounterEngine();
+    };
+
+OP_NAMESPACE_END
+
+#endif /* SRC_DB_COUNTER_BUFFER_HPP_ */
@@ -36,6 +36,16 @@
 #include "db.hpp"
 #include "repl/repl.hpp"
 #include "statistics.hpp"
+#include "util/probes.hpp"
+#include "bgjobs.hpp"
+#include "row_cache.hpp"
+#include "counter_buffer.hpp"
+#include "sharded_engine.hpp"
+#include "util/murmur3.h"
+#include "util/perfect_hash.hpp"
+#include "util/mem_arena.hpp"
+#include "util/atomic.hpp"
+#include <snappy.h>
 #if defined __USE_LMDB__
 #include "lmdb/lmdb_engine.hpp"
 const char* ardb::g_engine_name = "lmdb";
@@ -54,6 +64,9 @@ const char* ardb::g_engine_name ="wiredtiger";
 #elif defined __USE_PERCONAFT__
 #include "perconaft/perconaft_engine.hpp"
 const char* ardb::g_engine_name ="perconaft";
+#elif defined __USE_MEMORY__
+#include "memory/memory_engine.hpp"
+const char* ardb::g_engine_name ="memory";
 #else
 const char* ardb::g_engine_name = "unknown";
 #endif
@@ -74,6 +87,9 @@ const char* ardb::g_engine_name = "unknown";
 #define ARDB_CMD_SKIP_MONITOR 2048         /* "M" flag */
 #define ARDB_CMD_ASKING 4096               /* "k" flag */
 #define ARDB_CMD_FAST 8192                 /* "F" flag */
+#define ARDB_CMD_LOCKFREE_READ 16384       /* "L" flag */
+#define ARDB_CMD_PIPELINE_BATCH 32768      /* "B" flag */
+#define ARDB_CMD_SLOW 65536                /* "H" flag */
 
 OP_NAMESPACE_BEGIN
     Ardb* g_db = NULL;
@@ -87,6 +103,13 @@ OP_NAMESPACE_BEGIN
     {
         return (flags & ARDB_CMD_WRITE) > 0;
     }
+    /*
+     * Writes only touching the key of the first argument, same as the commands allowed in pipeline write batches.
+     */
+    bool Ardb::RedisCommandHandlerSetting::IsSingleKeyWrite() const
+    {
+        return (flags & ARDB_CMD_PIPELINE_BATCH) > 0;
+    }
 
     size_t Ardb::RedisCommandHash::operator ()(const std::string& t) const
     {
@@ -103,11 +126,12 @@ OP_NAMESPACE_BEGIN
     }
 
     Ardb::KeyLockGuard::KeyLockGuard(Context& cctx, const KeyObject& key, bool _lock) :
-            ctx(cctx), k(key), lock(_lock)
+            ctx(cctx), k(key), lock(_lock && !cctx.flags.snapshot_read && !g_db->IsPipelineBatchKey(cctx, key))
     {
         if (lock)
         {
             ctx.keyslocked = true;
+            EngineProfileScope scope(g_engine_profiling ? &ctx.profile : NULL, &EngineProfile::lock_wait_nanos);
             g_db->LockKey(k);
         }
 
@@ -126,6 +150,7 @@ OP_NAMESPACE_BEGIN
             ctx(cctx), ks(keys)
     {
         ctx.keyslocked = true;
+        EngineProfileScope scope(g_engine_profiling ? &ctx.profile : NULL, &EngineProfile::lock_wait_nanos);
         g_db->LockKeys(ks);
     }
     Ardb::KeysLockGuard::KeysLockGuard(Context& cctx, const KeyObject& key1, const KeyObject& key2) :
@@ -133,6 +158,7 @@ OP_NAMESPACE_BEGIN
     {
         ks.push_back(key1);
         ks.push_back(key2);
+        EngineProfileScope scope(g_engine_profiling ? &ctx.profile : NULL, &EngineProfile::lock_wait_nanos);
         g_db->LockKeys(ks);
     }
     Ardb::KeysLockGuard::~KeysLockGuard()
@@ -142,208 +168,277 @@ OP_NAMESPACE_BEGIN
     }
 
     static CostTrack g_cmd_cost_tracks[REDIS_CMD_MAX];
+    static EngineProfileStat g_cmd_engine_profiles[REDIS_CMD_MAX];
+    static CountTrack g_key_lock_contentions;
+    static CountTrack g_key_lock_waiters;
+    static CostTrack g_key_lock_wait_cost;
 
     Ardb::Ardb() :
-            m_engine(NULL), m_starttime(0), m_loading_data(false), m_compacting_data(false),m_redis_cursor_seed(0), m_watched_ctxs(NULL), m_ready_keys(NULL), m_monitors(NULL), m_restoring_nss(
-            NULL), m_min_ttl(-1)
+            m_engine(NULL), m_starttime(0), m_loading_data(false), m_loading_serve_reads(false), m_compacting_data(false), m_conf_snapshot(&m_conf), m_lazyfree_key_count(0), m_ttl_purge_ttl(0), m_ttl_purge_version(0), m_flushed_ns_count(0), m_next_object_id(1), m_object_id_limit(1), m_object_id_enabled(false), m_mem_purges(0), m_mem_purged_bytes(0), m_read_replica(false), m_replica_refreshes(0), m_replica_refresh_skips(0), m_replica_refresh_time(0), m_hash_index_count(0), m_key_lock_shards(NULL), m_key_lock_shard_num(0), m_redis_cursor_seed(0), m_tracking_clients(0), m_watch_flush_version(0), m_watching_clients(0), m_blocked_clients(0), m_ready_keys(NULL), m_cluster_epoch(0), m_monitors(NULL), m_monitor_seq(0), m_monitor_dropped(0), m_stall_pending_writes(0), m_shed_writes(0), m_cost_rejected(0), m_cost_streamed(0), m_cost_rerouted(0), m_restoring_nss(
+            NULL), m_rebalance(NULL), m_rebalancing(false), m_rebalance_frozen(false), m_rebalance_writes(0), m_write_fence(false), m_fenced_writes(0), m_min_ttl(-1), m_key_cache(
+            NULL), m_keycache_loader(NULL), m_keycache_loading(false), m_compaction_thread(NULL), m_deleted_entries(0), m_compaction_last_time(0), m_compaction_last_status("ok")
     {
         g_db = this;
+        memset(m_settings_by_type, 0, sizeof(m_settings_by_type));
+        memset(m_command_names_by_type, 0, sizeof(m_command_names_by_type));
+        memset((void*) m_watch_versions, 0, sizeof(m_watch_versions));
         m_settings.set_empty_key("");
         m_settings.set_deleted_key("\n");
 
         struct RedisCommandHandlerSetting settingTable[] =
         {
-        { "ping", REDIS_CMD_PING, &Ardb::Ping, 0, 0, "rtF", 0, 0, 0 },
-        { "multi", REDIS_CMD_MULTI, &Ardb::Multi, 0, 0, "rsF", 0, 0, 0 },
-        { "discard", REDIS_CMD_DISCARD, &Ardb::Discard, 0, 0, "rsF", 0, 0, 0 },
-        { "exec", REDIS_CMD_EXEC, &Ardb::Exec, 0, 0, "sM", 0, 0, 0 },
-        { "watch", REDIS_CMD_WATCH, &Ardb::Watch, 0, -1, "rsF", 0, 0, 0 },
-        { "unwatch", REDIS_CMD_UNWATCH, &Ardb::UnWatch, 0, 0, "rsF", 0, 0, 0 },
-        { "subscribe", REDIS_CMD_SUBSCRIBE, &Ardb::Subscribe, 1, -1, "rpslt", 0, 0, 0 },
-        { "psubscribe", REDIS_CMD_PSUBSCRIBE, &Ardb::PSubscribe, 1, -1, "rpslt", 0, 0, 0 },
-        { "unsubscribe", REDIS_CMD_UNSUBSCRIBE, &Ardb::UnSubscribe, 0, -1, "rpslt", 0, 0, 0 },
-        { "punsubscribe", REDIS_CMD_PUNSUBSCRIBE, &Ardb::PUnSubscribe, 0, -1, "rpslt", 0, 0, 0 },
-        { "publish", REDIS_CMD_PUBLISH, &Ardb::Publish, 2, 2, "pltrF", 0, 0, 0 },
-        { "pubsub", REDIS_CMD_PUBSUB, &Ardb::Pubsub, 1, -1, "pltrF", 0, 0, 0 },
-        { "info", REDIS_CMD_INFO, &Ardb::Info, 0, 1, "rlt", 0, 0, 0 },
-        { "save", REDIS_CMD_SAVE, &Ardb::Save, 0, 0, "ars", 0, 0, 0 },
-        { "save2", REDIS_CMD_SAVE2, &Ardb::Save, 0, 0, "ars", 0, 0, 0 },
-        { "bgsave", REDIS_CMD_BGSAVE, &Ardb::BGSave, 0, 0, "ar", 0, 0, 0 },
-        { "bgsave2", REDIS_CMD_BGSAVE2, &Ardb::BGSave, 0, 0, "ar", 0, 0, 0 },
-        { "import", REDIS_CMD_IMPORT, &Ardb::Import, 1, 1, "aws", 0, 0, 0 },
-        { "lastsave", REDIS_CMD_LASTSAVE, &Ardb::LastSave, 0, 0, "r", 0, 0, 0 },
-        { "slowlog", REDIS_CMD_SLOWLOG, &Ardb::SlowLog, 1, 2, "r", 0, 0, 0 },
-        { "dbsize", REDIS_CMD_DBSIZE, &Ardb::DBSize, 0, 0, "r", 0, 0, 0 },
-        { "config", REDIS_CMD_CONFIG, &Ardb::Config, 1, 3, "ar", 0, 0, 0 },
-        { "client", REDIS_CMD_CLIENT, &Ardb::Client, 1, 3, "ar", 0, 0, 0 },
-        { "flushdb", REDIS_CMD_FLUSHDB, &Ardb::FlushDB, 0, 0, "w", 0, 0, 0 },
-        { "flushall", REDIS_CMD_FLUSHALL, &Ardb::FlushAll, 0, 0, "w", 0, 0, 0 },
-        { "compactdb", REDIS_CMD_COMPACTDB, &Ardb::CompactDB, 0, 0, "ar", 0, 0, 0 },
-        { "compactall", REDIS_CMD_COMPACTALL, &Ardb::CompactAll, 0, 0, "ar", 0, 0, 0 },
-        { "time", REDIS_CMD_TIME, &Ardb::Time, 0, 0, "ar", 0, 0, 0 },
-        { "echo", REDIS_CMD_ECHO, &Ardb::Echo, 1, 1, "r", 0, 0, 0 },
-        { "quit", REDIS_CMD_QUIT, &Ardb::Quit, 0, 0, "rs", 0, 0, 0 },
-        { "shutdown", REDIS_CMD_SHUTDOWN, &Ardb::Shutdown, 0, 1, "arlt", 0, 0, 0 },
-        { "slaveof", REDIS_CMD_SLAVEOF, &Ardb::Slaveof, 2, -1, "ast", 0, 0, 0 },
-        { "replconf", REDIS_CMD_REPLCONF, &Ardb::ReplConf, 0, -1, "arslt", 0, 0, 0 },
-        { "sync", REDIS_CMD_SYNC, &Ardb::Sync, 0, 2, "ars", 0, 0, 0 },
-        { "psync", REDIS_CMD_PSYNC, &Ardb::PSync, 2, 4, "ars", 0, 0, 0 },
-        { "select", REDIS_CMD_SELECT, &Ardb::Select, 1, 1, "r", 0, 0, 0 },
-        { "append", REDIS_CMD_APPEND, &Ardb::Append, 2, 2, "w", 0, 0, 0 },
-        { "append2", REDIS_CMD_APPEND2, &Ardb::Append, 2, 2, "w", 0, 0, 0 },
-        { "get", REDIS_CMD_GET, &Ardb::Get, 1, 1, "rF", 0, 0, 0 },
-        { "set", REDIS_CMD_SET, &Ardb::Set, 2, 7, "w", 0, 0, 0 },
-        { "set2", REDIS_CMD_SET2, &Ardb::Set, 2, 7, "w", 0, 0, 0 },
-        { "del", REDIS_CMD_DEL, &Ardb::Del, 1, -1, "w", 0, 0, 0 },
-        { "exists", REDIS_CMD_EXISTS, &Ardb::Exists, 1, 1, "r", 0, 0, 0 },
-        { "expire", REDIS_CMD_EXPIRE, &Ardb::Expire, 2, 2, "w", 0, 0, 0 },
-        { "pexpire", REDIS_CMD_PEXPIRE, &Ardb::PExpire, 2, 2, "w", 0, 0, 0 },
-        { "expireat", REDIS_CMD_EXPIREAT, &Ardb::Expireat, 2, 2, "w", 0, 0, 0 },
-        { "pexpireat", REDIS_CMD_PEXPIREAT, &Ardb::PExpireat, 2, 2, "w", 0, 0, 0 },
-        { "persist", REDIS_CMD_PERSIST, &Ardb::Persist, 1, 1, "w", 1, 0, 0 },
-        { "ttl", REDIS_CMD_TTL, &Ardb::TTL, 1, 1, "r", 0, 0, 0 },
-        { "pttl", REDIS_CMD_PTTL, &Ardb::PTTL, 1, 1, "r", 0, 0, 0 },
-        { "type", REDIS_CMD_TYPE, &Ardb::Type, 1, 1, "r", 0, 0, 0 },
-        { "bitcount", REDIS_CMD_BITCOUNT, &Ardb::Bitcount, 1, 3, "r", 0, 0, 0 },
-        { "bitop", REDIS_CMD_BITOP, &Ardb::Bitop, 3, -1, "w", 1, 0, 0 },
-        { "bitopcount", REDIS_CMD_BITOPCUNT, &Ardb::BitopCount, 2, -1, "r", 0, 0, 0 },
-        { "decr", REDIS_CMD_DECR, &Ardb::Decr, 1, 1, "w", 1, 0, 0 },
-        { "decr2", REDIS_CMD_DECR2, &Ardb::Decr, 1, 1, "w", 1, 0, 0 },
-        { "decrby", REDIS_CMD_DECRBY, &Ardb::Decrby, 2, 2, "w", 1, 0, 0 },
-        { "decrby2", REDIS_CMD_DECRBY2, &Ardb::Decrby, 2, 2, "w", 1, 0, 0 },
-        { "getbit", REDIS_CMD_GETBIT, &Ardb::GetBit, 2, 2, "r", 0, 0, 0 },
-        { "getrange", REDIS_CMD_GETRANGE, &Ardb::GetRange, 3, 3, "r", 0, 0, 0 },
-        { "getset", REDIS_CMD_GETSET, &Ardb::GetSet, 2, 2, "w", 1, 0, 0 },
-        { "incr", REDIS_CMD_INCR, &Ardb::Incr, 1, 1, "w", 1, 0, 0 },
-        { "incr2", REDIS_CMD_INCR2, &Ardb::Incr, 1, 1, "w", 1, 0, 0 },
-        { "incrby", REDIS_CMD_INCRBY, &Ardb::Incrby, 2, 2, "w", 1, 0, 0 },
-        { "incrby2", REDIS_CMD_INCRBY2, &Ardb::Incrby, 2, 2, "w", 1, 0, 0 },
-        { "incrbyfloat", REDIS_CMD_INCRBYFLOAT, &Ardb::IncrbyFloat, 2, 2, "w", 0, 0, 0 },
-        { "incrbyfloat2", REDIS_CMD_INCRBYFLOAT2, &Ardb::IncrbyFloat, 2, 2, "w", 0, 0, 0 },
-        { "mget", REDIS_CMD_MGET, &Ardb::MGet, 1, -1, "r", 0, 0, 0 },
-        { "mset", REDIS_CMD_MSET, &Ardb::MSet, 2, -1, "w", 0, 0, 0 },
-        { "mset2", REDIS_CMD_MSET2, &Ardb::MSet, 2, -1, "w", 0, 0, 0 },
-        { "msetnx", REDIS_CMD_MSETNX, &Ardb::MSetNX, 2, -1, "w", 0, 0, 0 },
-        { "msetnx2", REDIS_CMD_MSETNX2, &Ardb::MSetNX, 2, -1, "w", 0, 0, 0 },
-        { "psetex", REDIS_CMD_PSETEX, &Ardb::PSetEX, 3, 3, "w", 0, 0, 0 },
-        { "setbit", REDIS_CMD_SETBIT, &Ardb::SetBit, 3, 3, "w", 0, 0, 0 },
-        { "setbit2", REDIS_CMD_SETBIT2, &Ardb::SetBit, 3, 3, "w", 0, 0, 0 },
-        { "setex", REDIS_CMD_SETEX, &Ardb::SetEX, 3, 3, "w", 0, 0, 0 },
-        { "setnx", REDIS_CMD_SETNX, &Ardb::SetNX, 2, 2, "w", 0, 0, 0 },
-        { "setnx2", REDIS_CMD_SETNX2, &Ardb::SetNX, 2, 2, "w", 0, 0, 0 },
-        { "setrange", REDIS_CMD_SETRANGE, &Ardb::SetRange, 3, 3, "w", 0, 0, 0 },
-        { "setrange2", REDIS_CMD_SETRANGE2, &Ardb::SetRange, 3, 3, "w", 0, 0, 0 },
-        { "strlen", REDIS_CMD_STRLEN, &Ardb::Strlen, 1, 1, "r", 0, 0, 0 },
-        { "hdel", REDIS_CMD_HDEL, &Ardb::HDel, 2, -1, "w", 0, 0, 0 },
-        { "hdel2", REDIS_CMD_HDEL2, &Ardb::HDel, 2, -1, "w", 0, 0, 0 },
-        { "hexists", REDIS_CMD_HEXISTS, &Ardb::HExists, 2, 2, "r", 0, 0, 0 },
-        { "hget", REDIS_CMD_HGET, &Ardb::HGet, 2, 2, "r", 0, 0, 0 },
-        { "hgetall", REDIS_CMD_HGETALL, &Ardb::HGetAll, 1, 1, "r", 0, 0, 0 },
-        { "hincrby", REDIS_CMD_HINCR, &Ardb::HIncrby, 3, 3, "w", 0, 0, 0 },
-        { "hincrby2", REDIS_CMD_HINCR2, &Ardb::HIncrby, 3, 3, "w", 0, 0, 0 },
-        { "hincrbyfloat", REDIS_CMD_HINCRBYFLOAT, &Ardb::HIncrbyFloat, 3, 3, "w", 0, 0, 0 },
-        { "hincrbyfloat2", REDIS_CMD_HINCRBYFLOAT2, &Ardb::HIncrbyFloat, 3, 3, "w", 0, 0, 0 },
-        { "hkeys", REDIS_CMD_HKEYS, &Ardb::HKeys, 1, 1, "r", 0, 0, 0 },
-        { "hlen", REDIS_CMD_HLEN, &Ardb::HLen, 1, 1, "r", 0, 0, 0 },
-        { "hvals", REDIS_CMD_HVALS, &Ardb::HVals, 1, 1, "r", 0, 0, 0 },
-        { "hmget", REDIS_CMD_HMGET, &Ardb::HMGet, 2, -1, "r", 0, 0, 0 },
-        { "hset", REDIS_CMD_HSET, &Ardb::HSet, 3, 3, "w", 0, 0, 0 },
-        { "hset2", REDIS_CMD_HSET2, &Ardb::HSet, 3, 3, "w", 0, 0, 0 },
-        { "hsetnx", REDIS_CMD_HSETNX, &Ardb::HSetNX, 3, 3, "w", 0, 0, 0 },
-        { "hsetnx2", REDIS_CMD_HSETNX2, &Ardb::HSetNX, 3, 3, "w", 0, 0, 0 },
-        { "hmset", REDIS_CMD_HMSET, &Ardb::HMSet, 3, -1, "w", 0, 0, 0 },
-        { "hmset2", REDIS_CMD_HMSET2, &Ardb::HMSet, 3, -1, "w", 0, 0, 0 },
-        { "hscan", REDIS_CMD_HSCAN, &Ardb::HScan, 2, 6, "r", 0, 0, 0 },
-        { "scard", REDIS_CMD_SCARD, &Ardb::SCard, 1, 1, "r", 0, 0, 0 },
-        { "sadd", REDIS_CMD_SADD, &Ardb::SAdd, 2, -1, "w", 0, 0, 0 },
-        { "sadd2", REDIS_CMD_SADD2, &Ardb::SAdd, 2, -1, "w", 0, 0, 0 },
-        { "sdiff", REDIS_CMD_SDIFF, &Ardb::SDiff, 2, -1, "r", 0, 0, 0 },
-        { "sdiffcount", REDIS_CMD_SDIFFCOUNT, &Ardb::SDiffCount, 2, -1, "r", 0, 0, 0 },
-        { "sdiffstore", REDIS_CMD_SDIFFSTORE, &Ardb::SDiffStore, 3, -1, "w", 0, 0, 0 },
-        { "sinter", REDIS_CMD_SINTER, &Ardb::SInter, 2, -1, "r", 0, 0, 0 },
-        { "sintercount", REDIS_CMD_SINTERCOUNT, &Ardb::SInterCount, 2, -1, "r", 0, 0, 0 },
-        { "sinterstore", REDIS_CMD_SINTERSTORE, &Ardb::SInterStore, 3, -1, "w", 0, 0, 0 },
-        { "sismember", REDIS_CMD_SISMEMBER, &Ardb::SIsMember, 2, 2, "r", 0, 0, 0 },
-        { "smembers", REDIS_CMD_SMEMBERS, &Ardb::SMembers, 1, 1, "r", 0, 0, 0 },
-        { "smove", REDIS_CMD_SMOVE, &Ardb::SMove, 3, 3, "w", 0, 0, 0 },
-        { "spop", REDIS_CMD_SPOP, &Ardb::SPop, 1, 2, "wR", 0, 0, 0 },
-        { "srandmember", REDIS_CMD_SRANMEMEBER, &Ardb::SRandMember, 1, 2, "rR", 0, 0, 0 },
-        { "srem", REDIS_CMD_SREM, &Ardb::SRem, 2, -1, "w", 1, 0, 0 },
-        { "srem2", REDIS_CMD_SREM2, &Ardb::SRem, 2, -1, "w", 1, 0, 0 },
-        { "sunion", REDIS_CMD_SUNION, &Ardb::SUnion, 2, -1, "r", 0, 0, 0 },
-        { "sunionstore", REDIS_CMD_SUNIONSTORE, &Ardb::SUnionStore, 3, -1, "w", 0, 0, 0 },
-        { "sunioncount", REDIS_CMD_SUNIONCOUNT, &Ardb::SUnionCount, 2, -1, "r", 0, 0, 0 },
-        { "sscan", REDIS_CMD_SSCAN, &Ardb::SScan, 2, 6, "r", 0, 0, 0 },
-        { "zadd", REDIS_CMD_ZADD, &Ardb::ZAdd, 3, -1, "w", 0, 0, 0 },
-        { "zcard", REDIS_CMD_ZCARD, &Ardb::ZCard, 1, 1, "r", 0, 0, 0 },
-        { "zcount", REDIS_CMD_ZCOUNT, &Ardb::ZCount, 3, 3, "r", 0, 0, 0 },
-        { "zincrby", REDIS_CMD_ZINCRBY, &Ardb::ZIncrby, 3, 3, "w", 0, 0, 0 },
-        { "zrange", REDIS_CMD_ZRANGE, &Ardb::ZRange, 3, 4, "r", 0, 0, 0 },
-        { "zrangebyscore", REDIS_CMD_ZRANGEBYSCORE, &Ardb::ZRangeByScore, 3, 7, "r", 0, 0, 0 },
-        { "zrank", REDIS_CMD_ZRANK, &Ardb::ZRank, 2, 2, "r", 0, 0, 0 },
-        { "zrem", REDIS_CMD_ZREM, &Ardb::ZRem, 2, -1, "w", 0, 0, 0 },
-        { "zremrangebyrank", REDIS_CMD_ZREMRANGEBYRANK, &Ardb::ZRemRangeByRank, 3, 3, "w", 0, 0, 0 },
-        { "zremrangebyscore", REDIS_CMD_ZREMRANGEBYSCORE, &Ardb::ZRemRangeByScore, 3, 3, "w", 0, 0, 0 },
-        { "zrevrange", REDIS_CMD_ZREVRANGE, &Ardb::ZRevRange, 3, 4, "r", 0, 0, 0 },
-        { "zrevrangebyscore", REDIS_CMD_ZREVRANGEBYSCORE, &Ardb::ZRevRangeByScore, 3, 7, "r", 0, 0, 0 },
-        { "zinterstore", REDIS_CMD_ZINTERSTORE, &Ardb::ZInterStore, 3, -1, "w", 0, 0, 0 },
-        { "zunionstore", REDIS_CMD_ZUNIONSTORE, &Ardb::ZUnionStore, 3, -1, "w", 0, 0, 0 },
-        { "zrevrank", REDIS_CMD_ZREVRANK, &Ardb::ZRevRank, 2, 2, "r", 0, 0, 0 },
-        { "zscore", REDIS_CMD_ZSCORE, &Ardb::ZScore, 2, 2, "r", 0, 0, 0 },
-        { "zscan", REDIS_CMD_ZSCORE, &Ardb::ZScan, 2, 6, "r", 0, 0, 0 },
-        { "zlexcount", REDIS_CMD_ZLEXCOUNT, &Ardb::ZLexCount, 3, 3, "r", 0, 0, 0 },
-        { "zrangebylex", REDIS_CMD_ZRANGEBYLEX, &Ardb::ZRangeByLex, 3, 6, "r", 0, 0, 0 },
-        { "zrevrangebylex", REDIS_CMD_ZREVRANGEBYLEX, &Ardb::ZRangeByLex, 3, 6, "r", 0, 0, 0 },
-        { "zremrangebylex", REDIS_CMD_ZREMRANGEBYLEX, &Ardb::ZRemRangeByLex, 3, 3, "w", 0, 0, 0 },
-        { "lindex", REDIS_CMD_LINDEX, &Ardb::LIndex, 2, 2, "r", 0, 0, 0 },
-        { "linsert", REDIS_CMD_LINSERT, &Ardb::LInsert, 4, 4, "w", 0, 0, 0 },
-        { "llen", REDIS_CMD_LLEN, &Ardb::LLen, 1, 1, "r", 0, 0, 0 },
-        { "lpop", REDIS_CMD_LPOP, &Ardb::LPop, 1, 1, "w", 0, 0, 0 },
-        { "lpush", REDIS_CMD_LPUSH, &Ardb::LPush, 2, -1, "w", 0, 0, 0 },
-        { "lpushx", REDIS_CMD_LPUSHX, &Ardb::LPushx, 2, 2, "w", 0, 0, 0 },
-        { "lrange", REDIS_CMD_LRANGE, &Ardb::LRange, 3, 3, "r", 0, 0, 0 },
-        { "lrem", REDIS_CMD_LREM, &Ardb::LRem, 3, 3, "w", 0, 0, 0 },
-        { "lset", REDIS_CMD_LSET, &Ardb::LSet, 3, 3, "w", 0, 0, 0 },
-        { "ltrim", REDIS_CMD_LTRIM, &Ardb::LTrim, 3, 3, "w", 0, 0, 0 },
-        { "rpop", REDIS_CMD_RPOP, &Ardb::RPop, 1, 1, "w", 0, 0, 0 },
-        { "rpush", REDIS_CMD_RPUSH, &Ardb::RPush, 2, -1, "w", 0, 0, 0 },
-        { "rpushx", REDIS_CMD_RPUSHX, &Ardb::RPushx, 2, 2, "w", 0, 0, 0 },
-        { "rpoplpush", REDIS_CMD_RPOPLPUSH, &Ardb::RPopLPush, 2, 2, "w", 0, 0, 0 },
-        { "blpop", REDIS_CMD_BLPOP, &Ardb::BLPop, 2, -1, "ws", 0, 0, 0 },
-        { "brpop", REDIS_CMD_BRPOP, &Ardb::BRPop, 2, -1, "ws", 0, 0, 0 },
-        { "brpoplpush", REDIS_CMD_BRPOPLPUSH, &Ardb::BRPopLPush, 3, 3, "ws", 0, 0, 0 },
-        { "rpoplpush", REDIS_CMD_RPOPLPUSH, &Ardb::RPopLPush, 2, 2, "w", 0, 0, 0 },
-        { "move", REDIS_CMD_MOVE, &Ardb::Move, 2, 2, "w", 0, 0, 0 },
-        { "rename", REDIS_CMD_RENAME, &Ardb::Rename, 2, 2, "w", 0, 0, 0 },
-        { "renamenx", REDIS_CMD_RENAMENX, &Ardb::RenameNX, 2, 2, "w", 0, 0, 0 },
-        { "sort", REDIS_CMD_SORT, &Ardb::Sort, 1, -1, "w", 0, 0, 0 },
-        { "keys", REDIS_CMD_KEYS, &Ardb::Keys, 1, 6, "r", 0, 0, 0 },
-        { "keyscount", REDIS_CMD_KEYSCOUNT, &Ardb::KeysCount, 1, 6, "r", 0, 0, 0 },
-        { "eval", REDIS_CMD_EVAL, &Ardb::Eval, 2, -1, "s", 0, 0, 0 },
-        { "evalsha", REDIS_CMD_EVALSHA, &Ardb::EvalSHA, 2, -1, "s", 0, 0, 0 },
-        { "script", REDIS_CMD_SCRIPT, &Ardb::Script, 1, -1, "rs", 0, 0, 0 },
-        { "randomkey", REDIS_CMD_RANDOMKEY, &Ardb::Randomkey, 0, 0, "r", 0, 0, 0 },
-        { "scan", REDIS_CMD_SCAN, &Ardb::Scan, 1, 5, "r", 0, 0, 0 },
-        { "geoadd", REDIS_CMD_GEO_ADD, &Ardb::GeoAdd, 4, -1, "w", 0, 0, 0 },
-        { "georadius", REDIS_CMD_GEO_RADIUS, &Ardb::GeoRadius, 5, -1, "w", 0, 0, 0 },
-        { "georadiusbymember", REDIS_CMD_GEO_RADIUSBYMEMBER, &Ardb::GeoRadiusByMember, 4, 10, "w", 0, 0, 0 },
-        { "geohash", REDIS_CMD_GEO_HASH, &Ardb::GeoHash, 2, -1, "r", 0, 0, 0 },
-        { "geodist", REDIS_CMD_GEO_DIST, &Ardb::GeoDist, 3, 4, "r", 0, 0, 0 },
-        { "geopos", REDIS_CMD_GEO_POS, &Ardb::GeoPos, 2, -1, "r", 0, 0, 0 },
-        { "auth", REDIS_CMD_AUTH, &Ardb::Auth, 1, 1, "rsltF", 0, 0, 0 },
-        { "pfadd", REDIS_CMD_PFADD, &Ardb::PFAdd, 2, -1, "w", 0, 0, 0 },
-        { "pfadd2", REDIS_CMD_PFADD2, &Ardb::PFAdd, 2, -1, "w", 0, 0, 0 },
-        { "pfcount", REDIS_CMD_PFCOUNT, &Ardb::PFCount, 1, -1, "r", 0, 0, 0 },
-        { "pfmerge", REDIS_CMD_PFMERGE, &Ardb::PFMerge, 2, -1, "w", 0, 0, 0 },
-        { "dump", REDIS_CMD_DUMP, &Ardb::Dump, 1, 1, "r", 0, 0, 0 },
-        { "restore", REDIS_CMD_RESTORE, &Ardb::Restore, 3, 4, "w", 0, 0, 0 },
-        { "migrate", REDIS_CMD_MIGRATE, &Ardb::Migrate, 5, -1, "w", 0, 0, 0 },
-        { "migratedb", REDIS_CMD_MIGRATEDB, &Ardb::MigrateDB, 4, 4, "w", 0, 0, 0 },
-        { "restorechunk", REDIS_CMD_RESTORECHUNK, &Ardb::RestoreChunk, 1, 1, "wl", 0, 0, 0 },
-        { "restoredb", REDIS_CMD_RESTOREDB, &Ardb::RestoreDB, 1, 1, "wl", 0, 0, 0 },
-        { "monitor", REDIS_CMD_MONITOR, &Ardb::Monitor, 0, 0, "ars", 0, 0, 0 },
-        { "debug", REDIS_CMD_DEBUG, &Ardb::Debug, 1, 1, "ars", 0, 0, 0 },
-        { "cachememory", REDIS_CMD_CACHEMEMORY, &Ardb::CacheMemory, 0, 0, "r", 0, 0, 0}};
+        { "ping", REDIS_CMD_PING, &Ardb::Ping, 0, 0, "rtF", 0, 0 },
+        { "multi", REDIS_CMD_MULTI, &Ardb::Multi, 0, 0, "rsF", 0, 0 },
+        { "discard", REDIS_CMD_DISCARD, &Ardb::Discard, 0, 0, "rsF", 0, 0 },
+        { "exec", REDIS_CMD_EXEC, &Ardb::Exec, 0, 0, "sM", 0, 0 },
+        { "watch", REDIS_CMD_WATCH, &Ardb::Watch, 0, -1, "rsF", 0, 0 },
+        { "unwatch", REDIS_CMD_UNWATCH, &Ardb::UnWatch, 0, 0, "rsF", 0, 0 },
+        { "subscribe", REDIS_CMD_SUBSCRIBE, &Ardb::Subscribe, 1, -1, "rpslt", 0, 0 },
+        { "psubscribe", REDIS_CMD_PSUBSCRIBE, &Ardb::PSubscribe, 1, -1, "rpslt", 0, 0 },
+        { "unsubscribe", REDIS_CMD_UNSUBSCRIBE, &Ardb::UnSubscribe, 0, -1, "rpslt", 0, 0 },
+        { "punsubscribe", REDIS_CMD_PUNSUBSCRIBE, &Ardb::PUnSubscribe, 0, -1, "rpslt", 0, 0 },
+        { "publish", REDIS_CMD_PUBLISH, &Ardb::Publish, 2, 2, "pltrF", 0, 0 },
+        { "pubsub", REDIS_CMD_PUBSUB, &Ardb::Pubsub, 1, -1, "pltrF", 0, 0 },
+        { "info", REDIS_CMD_INFO, &Ardb::Info, 0, 1, "rlt", 0, 0 },
+        { "save", REDIS_CMD_SAVE, &Ardb::Save, 0, 0, "ars", 0, 0 },
+        { "save2", REDIS_CMD_SAVE2, &Ardb::Save, 0, 0, "ars", 0, 0 },
+        { "bgsave", REDIS_CMD_BGSAVE, &Ardb::BGSave, 0, 0, "ar", 0, 0 },
+        { "bgsave2", REDIS_CMD_BGSAVE2, &Ardb::BGSave, 0, 0, "ar", 0, 0 },
+        { "import", REDIS_CMD_IMPORT, &Ardb::Import, 1, 1, "aws", 0, 0 },
+        { "backup", REDIS_CMD_BACKUP, &Ardb::Backup, 1, 3, "as", 0, 0 },
+        { "lastsave", REDIS_CMD_LASTSAVE, &Ardb::LastSave, 0, 0, "r", 0, 0 },
+        { "slowlog", REDIS_CMD_SLOWLOG, &Ardb::SlowLog, 1, 2, "r", 0, 0 },
+        { "latency", REDIS_CMD_LATENCY, &Ardb::Latency, 1, -1, "ar", 0, 0 },
+        { "hotkeys", REDIS_CMD_HOTKEYS, &Ardb::HotKeys, 1, 2, "ar", 0, 0 },
+        { "bgjobs", REDIS_CMD_BGJOBS, &Ardb::BGJobs, 0, 2, "ar", 0, 0 },
+        { "memory", REDIS_CMD_MEMORY, &Ardb::Memory, 1, 2, "ar", 0, 0 },
+        { "dbsize", REDIS_CMD_DBSIZE, &Ardb::DBSize, 0, 0, "r", 0, 0 },
+        { "config", REDIS_CMD_CONFIG, &Ardb::Config, 1, 3, "ar", 0, 0 },
+        { "client", REDIS_CMD_CLIENT, &Ardb::Client, 1, -1, "ar", 0, 0 },
+        { "flushdb", REDIS_CMD_FLUSHDB, &Ardb::FlushDB, 0, 1, "wH", 0, 0 },
+        { "flushall", REDIS_CMD_FLUSHALL, &Ardb::FlushAll, 0, 1, "wH", 0, 0 },
+        { "compactdb", REDIS_CMD_COMPACTDB, &Ardb::CompactDB, 0, 1, "ar", 0, 0 },
+        { "compactall", REDIS_CMD_COMPACTALL, &Ardb::CompactAll, 0, 1, "ar", 0, 0 },
+        { "time", REDIS_CMD_TIME, &Ardb::Time, 0, 0, "ar", 0, 0 },
+        { "echo", REDIS_CMD_ECHO, &Ardb::Echo, 1, 1, "r", 0, 0 },
+        { "quit", REDIS_CMD_QUIT, &Ardb::Quit, 0, 0, "rs", 0, 0 },
+        { "shutdown", REDIS_CMD_SHUTDOWN, &Ardb::Shutdown, 0, 1, "arlt", 0, 0 },
+        { "slaveof", REDIS_CMD_SLAVEOF, &Ardb::Slaveof, 2, -1, "ast", 0, 0 },
+        { "replconf", REDIS_CMD_REPLCONF, &Ardb::ReplConf, 0, -1, "arslt", 0, 0 },
+        { "sync", REDIS_CMD_SYNC, &Ardb::Sync, 0, 2, "ars", 0, 0 },
+        { "psync", REDIS_CMD_PSYNC, &Ardb::PSync, 2, 4, "ars", 0, 0 },
+        { "wait", REDIS_CMD_WAIT, &Ardb::Wait, 2, 2, "r", 0, 0 },
+        { "cdc", REDIS_CMD_CDC, &Ardb::CDC, 1, 6, "rst", 0, 0 },
+        { "select", REDIS_CMD_SELECT, &Ardb::Select, 1, 1, "r", 0, 0 },
+        { "append", REDIS_CMD_APPEND, &Ardb::Append, 2, 2, "wB", 0, 0 },
+        { "append2", REDIS_CMD_APPEND2, &Ardb::Append, 2, 2, "w", 0, 0 },
+        { "get", REDIS_CMD_GET, &Ardb::Get, 1, 1, "rF", 0, 0 },
+        { "set", REDIS_CMD_SET, &Ardb::Set, 2, 7, "wB", 0, 0 },
+        { "set2", REDIS_CMD_SET2, &Ardb::Set, 2, 7, "wB", 0, 0 },
+        { "del", REDIS_CMD_DEL, &Ardb::Del, 1, -1, "w", 0, 0 },
+        { "unlink", REDIS_CMD_UNLINK, &Ardb::Del, 1, -1, "w", 0, 0 },
+        { "exists", REDIS_CMD_EXISTS, &Ardb::Exists, 1, -1, "r", 0, 0 },
+        { "expire", REDIS_CMD_EXPIRE, &Ardb::Expire, 2, 2, "w", 0, 0 },
+        { "pexpire", REDIS_CMD_PEXPIRE, &Ardb::PExpire, 2, 2, "w", 0, 0 },
+        { "expireat", REDIS_CMD_EXPIREAT, &Ardb::Expireat, 2, 2, "w", 0, 0 },
+        { "pexpireat", REDIS_CMD_PEXPIREAT, &Ardb::PExpireat, 2, 2, "w", 0, 0 },
+        { "persist", REDIS_CMD_PERSIST, &Ardb::Persist, 1, 1, "w", 1, 0 },
+        { "ttl", REDIS_CMD_TTL, &Ardb::TTL, 1, 1, "r", 0, 0 },
+        { "pttl", REDIS_CMD_PTTL, &Ardb::PTTL, 1, 1, "r", 0, 0 },
+        { "type", REDIS_CMD_TYPE, &Ardb::Type, 1, 1, "rL", 0, 0 },
+        { "bitcount", REDIS_CMD_BITCOUNT, &Ardb::Bitcount, 1, 3, "r", 0, 0 },
+        { "bitop", REDIS_CMD_BITOP, &Ardb::Bitop, 3, -1, "wH", 1, 0 },
+        { "bitopcount", REDIS_CMD_BITOPCUNT, &Ardb::BitopCount, 2, -1, "r", 0, 0 },
+        { "bitpos", REDIS_CMD_BITPOS, &Ardb::Bitpos, 2, 4, "r", 0, 0 },
+        { "decr", REDIS_CMD_DECR, &Ardb::Decr, 1, 1, "wB", 1, 0 },
+        { "decr2", REDIS_CMD_DECR2, &Ardb::Decr, 1, 1, "wB", 1, 0 },
+        { "decrby", REDIS_CMD_DECRBY, &Ardb::Decrby, 2, 2, "wB", 1, 0 },
+        { "decrby2", REDIS_CMD_DECRBY2, &Ardb::Decrby, 2, 2, "wB", 1, 0 },
+        { "getbit", REDIS_CMD_GETBIT, &Ardb::GetBit, 2, 2, "r", 0, 0 },
+        { "getrange", REDIS_CMD_GETRANGE, &Ardb::GetRange, 3, 3, "r", 0, 0 },
+        { "getset", REDIS_CMD_GETSET, &Ardb::GetSet, 2, 2, "w", 1, 0 },
+        { "incr", REDIS_CMD_INCR, &Ardb::Incr, 1, 1, "wB", 1, 0 },
+        { "incr2", REDIS_CMD_INCR2, &Ardb::Incr, 1, 1, "wB", 1, 0 },
+        { "incrby", REDIS_CMD_INCRBY, &Ardb::Incrby, 2, 2, "wB", 1, 0 },
+        { "incrby2", REDIS_CMD_INCRBY2, &Ardb::Incrby, 2, 2, "wB", 1, 0 },
+        { "incrbyfloat", REDIS_CMD_INCRBYFLOAT, &Ardb::IncrbyFloat, 2, 2, "w", 0, 0 },
+        { "incrbyfloat2", REDIS_CMD_INCRBYFLOAT2, &Ardb::IncrbyFloat, 2, 2, "w", 0, 0 },
+        { "mget", REDIS_CMD_MGET, &Ardb::MGet, 1, -1, "r", 0, 0 },
+        { "mset", REDIS_CMD_MSET, &Ardb::MSet, 2, -1, "w", 0, 0 },
+        { "mset2", REDIS_CMD_MSET2, &Ardb::MSet, 2, -1, "w", 0, 0 },
+        { "msetnx", REDIS_CMD_MSETNX, &Ardb::MSetNX, 2, -1, "w", 0, 0 },
+        { "msetnx2", REDIS_CMD_MSETNX2, &Ardb::MSetNX, 2, -1, "w", 0, 0 },
+        { "psetex", REDIS_CMD_PSETEX, &Ardb::PSetEX, 3, 3, "wB", 0, 0 },
+        { "setbit", REDIS_CMD_SETBIT, &Ardb::SetBit, 3, 3, "w", 0, 0 },
+        { "setbit2", REDIS_CMD_SETBIT2, &Ardb::SetBit, 3, 3, "w", 0, 0 },
+        { "setex", REDIS_CMD_SETEX, &Ardb::SetEX, 3, 3, "wB", 0, 0 },
+        { "setnx", REDIS_CMD_SETNX, &Ardb::SetNX, 2, 2, "wB", 0, 0 },
+        { "setnx2", REDIS_CMD_SETNX2, &Ardb::SetNX, 2, 2, "wB", 0, 0 },
+        { "setrange", REDIS_CMD_SETRANGE, &Ardb::SetRange, 3, 3, "w", 0, 0 },
+        { "setrange2", REDIS_CMD_SETRANGE2, &Ardb::SetRange, 3, 3, "w", 0, 0 },
+        { "strlen", REDIS_CMD_STRLEN, &Ardb::Strlen, 1, 1, "r", 0, 0 },
+        { "hdel", REDIS_CMD_HDEL, &Ardb::HDel, 2, -1, "wB", 0, 0 },
+        { "hdel2", REDIS_CMD_HDEL2, &Ardb::HDel, 2, -1, "wB", 0, 0 },
+        { "hexists", REDIS_CMD_HEXISTS, &Ardb::HExists, 2, 2, "r", 0, 0 },
+        { "hget", REDIS_CMD_HGET, &Ardb::HGet, 2, 2, "rL", 0, 0 },
+        { "hgetall", REDIS_CMD_HGETALL, &Ardb::HGetAll, 1, 1, "rL", 0, 0 },
+        { "hincrby", REDIS_CMD_HINCR, &Ardb::HIncrby, 3, 3, "wB", 0, 0 },
+        { "hincrby2", REDIS_CMD_HINCR2, &Ardb::HIncrby, 3, 3, "wB", 0, 0 },
+        { "hincrbyfloat", REDIS_CMD_HINCRBYFLOAT, &Ardb::HIncrbyFloat, 3, 3, "w", 0, 0 },
+        { "hincrbyfloat2", REDIS_CMD_HINCRBYFLOAT2, &Ardb::HIncrbyFloat, 3, 3, "w", 0, 0 },
+        { "hkeys", REDIS_CMD_HKEYS, &Ardb::HKeys, 1, 1, "r", 0, 0 },
+        { "hlen", REDIS_CMD_HLEN, &Ardb::HLen, 1, 1, "r", 0, 0 },
+        { "hvals", REDIS_CMD_HVALS, &Ardb::HVals, 1, 1, "r", 0, 0 },
+        { "hmget", REDIS_CMD_HMGET, &Ardb::HMGet, 2, -1, "r", 0, 0 },
+        { "hset", REDIS_CMD_HSET, &Ardb::HSet, 3, 3, "wB", 0, 0 },
+        { "hset2", REDIS_CMD_HSET2, &Ardb::HSet, 3, 3, "wB", 0, 0 },
+        { "hsetnx", REDIS_CMD_HSETNX, &Ardb::HSetNX, 3, 3, "wB", 0, 0 },
+        { "hsetnx2", REDIS_CMD_HSETNX2, &Ardb::HSetNX, 3, 3, "wB", 0, 0 },
+        { "hmset", REDIS_CMD_HMSET, &Ardb::HMSet, 3, -1, "wB", 0, 0 },
+        { "hmset2", REDIS_CMD_HMSET2, &Ardb::HMSet, 3, -1, "wB", 0, 0 },
+        { "hscan", REDIS_CMD_HSCAN, &Ardb::HScan, 2, -1, "r", 0, 0 },
+        { "hexpire", REDIS_CMD_HEXPIRE, &Ardb::HExpire, 5, -1, "w", 0, 0 },
+        { "hpexpire", REDIS_CMD_HPEXPIRE, &Ardb::HExpire, 5, -1, "w", 0, 0 },
+        { "hexpireat", REDIS_CMD_HEXPIREAT, &Ardb::HExpire, 5, -1, "w", 0, 0 },
+        { "hpexpireat", REDIS_CMD_HPEXPIREAT, &Ardb::HExpire, 5, -1, "w", 0, 0 },
+        { "httl", REDIS_CMD_HTTL, &Ardb::HTTL, 4, -1, "r", 0, 0 },
+        { "hpttl", REDIS_CMD_HPTTL, &Ardb::HTTL, 4, -1, "r", 0, 0 },
+        { "hpersist", REDIS_CMD_HPERSIST, &Ardb::HTTL, 4, -1, "w", 0, 0 },
+        { "scard", REDIS_CMD_SCARD, &Ardb::SCard, 1, 1, "r", 0, 0 },
+        { "sadd", REDIS_CMD_SADD, &Ardb::SAdd, 2, -1, "wB", 0, 0 },
+        { "sadd2", REDIS_CMD_SADD2, &Ardb::SAdd, 2, -1, "wB", 0, 0 },
+        { "sdiff", REDIS_CMD_SDIFF, &Ardb::SDiff, 2, -1, "r", 0, 0 },
+        { "sdiffcount", REDIS_CMD_SDIFFCOUNT, &Ardb::SDiffCount, 2, -1, "r", 0, 0 },
+        { "sdiffstore", REDIS_CMD_SDIFFSTORE, &Ardb::SDiffStore, 3, -1, "wH", 0, 0 },
+        { "sinter", REDIS_CMD_SINTER, &Ardb::SInter, 2, -1, "r", 0, 0 },
+        { "sintercount", REDIS_CMD_SINTERCOUNT, &Ardb::SInterCount, 2, -1, "r", 0, 0 },
+        { "sinterstore", REDIS_CMD_SINTERSTORE, &Ardb::SInterStore, 3, -1, "wH", 0, 0 },
+        { "sismember", REDIS_CMD_SISMEMBER, &Ardb::SIsMember, 2, 2, "r", 0, 0 },
+        { "smembers", REDIS_CMD_SMEMBERS, &Ardb::SMembers, 1, 1, "rL", 0, 0 },
+        { "smove", REDIS_CMD_SMOVE, &Ardb::SMove, 3, 3, "w", 0, 0 },
+        { "spop", REDIS_CMD_SPOP, &Ardb::SPop, 1, 2, "wR", 0, 0 },
+        { "srandmember", REDIS_CMD_SRANMEMEBER, &Ardb::SRandMember, 1, 2, "rR", 0, 0 },
+        { "srem", REDIS_CMD_SREM, &Ardb::SRem, 2, -1, "wB", 1, 0 },
+        { "srem2", REDIS_CMD_SREM2, &Ardb::SRem, 2, -1, "wB", 1, 0 },
+        { "sunion", REDIS_CMD_SUNION, &Ardb::SUnion, 2, -1, "r", 0, 0 },
+        { "sunionstore", REDIS_CMD_SUNIONSTORE, &Ardb::SUnionStore, 3, -1, "wH", 0, 0 },
+        { "sunioncount", REDIS_CMD_SUNIONCOUNT, &Ardb::SUnionCount, 2, -1, "r", 0, 0 },
+        { "sscan", REDIS_CMD_SSCAN, &Ardb::SScan, 2, -1, "r", 0, 0 },
+        { "zadd", REDIS_CMD_ZADD, &Ardb::ZAdd, 3, -1, "wB", 0, 0 },
+        { "zcard", REDIS_CMD_ZCARD, &Ardb::ZCard, 1, 1, "r", 0, 0 },
+        { "zcount", REDIS_CMD_ZCOUNT, &Ardb::ZCount, 3, 3, "rL", 0, 0 },
+        { "zincrby", REDIS_CMD_ZINCRBY, &Ardb::ZIncrby, 3, 3, "wB", 0, 0 },
+        { "zrange", REDIS_CMD_ZRANGE, &Ardb::ZRange, 3, 4, "rL", 0, 0 },
+        { "zrangebyscore", REDIS_CMD_ZRANGEBYSCORE, &Ardb::ZRangeByScore, 3, 7, "rL", 0, 0 },
+        { "zrank", REDIS_CMD_ZRANK, &Ardb::ZRank, 2, 2, "r", 0, 0 },
+        { "zrem", REDIS_CMD_ZREM, &Ardb::ZRem, 2, -1, "wB", 0, 0 },
+        { "zremrangebyrank", REDIS_CMD_ZREMRANGEBYRANK, &Ardb::ZRemRangeByRank, 3, 3, "w", 0, 0 },
+        { "zremrangebyscore", REDIS_CMD_ZREMRANGEBYSCORE, &Ardb::ZRemRangeByScore, 3, 3, "w", 0, 0 },
+        { "zrevrange", REDIS_CMD_ZREVRANGE, &Ardb::ZRevRange, 3, 4, "rL", 0, 0 },
+        { "zrevrangebyscore", REDIS_CMD_ZREVRANGEBYSCORE, &Ardb::ZRevRangeByScore, 3, 7, "rL", 0, 0 },
+        { "zinterstore", REDIS_CMD_ZINTERSTORE, &Ardb::ZInterStore, 3, -1, "wH", 0, 0 },
+        { "zunionstore", REDIS_CMD_ZUNIONSTORE, &Ardb::ZUnionStore, 3, -1, "wH", 0, 0 },
+        { "zrevrank", REDIS_CMD_ZREVRANK, &Ardb::ZRevRank, 2, 2, "r", 0, 0 },
+        { "zscore", REDIS_CMD_ZSCORE, &Ardb::ZScore, 2, 2, "r", 0, 0 },
+        { "zscan", REDIS_CMD_ZSCAN, &Ardb::ZScan, 2, -1, "r", 0, 0 },
+        { "zlexcount", REDIS_CMD_ZLEXCOUNT, &Ardb::ZLexCount, 3, 3, "rL", 0, 0 },
+        { "zrangebylex", REDIS_CMD_ZRANGEBYLEX, &Ardb::ZRangeByLex, 3, 6, "rL", 0, 0 },
+        { "zrevrangebylex", REDIS_CMD_ZREVRANGEBYLEX, &Ardb::ZRangeByLex, 3, 6, "rL", 0, 0 },
+        { "zremrangebylex", REDIS_CMD_ZREMRANGEBYLEX, &Ardb::ZRemRangeByLex, 3, 3, "w", 0, 0 },
+        { "lindex", REDIS_CMD_LINDEX, &Ardb::LIndex, 2, 2, "rL", 0, 0 },
+        { "linsert", REDIS_CMD_LINSERT, &Ardb::LInsert, 4, 4, "w", 0, 0 },
+        { "llen", REDIS_CMD_LLEN, &Ardb::LLen, 1, 1, "r", 0, 0 },
+        { "lpop", REDIS_CMD_LPOP, &Ardb::LPop, 1, 1, "w", 0, 0 },
+        { "lpush", REDIS_CMD_LPUSH, &Ardb::LPush, 2, -1, "w", 0, 0 },
+        { "lpushx", REDIS_CMD_LPUSHX, &Ardb::LPushx, 2, 2, "w", 0, 0 },
+        { "lrange", REDIS_CMD_LRANGE, &Ardb::LRange, 3, 3, "rL", 0, 0 },
+        { "lrem", REDIS_CMD_LREM, &Ardb::LRem, 3, 3, "w", 0, 0 },
+        { "lset", REDIS_CMD_LSET, &Ardb::LSet, 3, 3, "w", 0, 0 },
+        { "ltrim", REDIS_CMD_LTRIM, &Ardb::LTrim, 3, 3, "w", 0, 0 },
+        { "rpop", REDIS_CMD_RPOP, &Ardb::RPop, 1, 1, "w", 0, 0 },
+        { "rpush", REDIS_CMD_RPUSH, &Ardb::RPush, 2, -1, "w", 0, 0 },
+        { "rpushx", REDIS_CMD_RPUSHX, &Ardb::RPushx, 2, 2, "w", 0, 0 },
+        { "rpoplpush", REDIS_CMD_RPOPLPUSH, &Ardb::RPopLPush, 2, 2, "w", 0, 0 },
+        { "blpop", REDIS_CMD_BLPOP, &Ardb::BLPop, 2, -1, "ws", 0, 0 },
+        { "brpop", REDIS_CMD_BRPOP, &Ardb::BRPop, 2, -1, "ws", 0, 0 },
+        { "brpoplpush", REDIS_CMD_BRPOPLPUSH, &Ardb::BRPopLPush, 3, 3, "ws", 0, 0 },
+        { "rpoplpush", REDIS_CMD_RPOPLPUSH, &Ardb::RPopLPush, 2, 2, "w", 0, 0 },
+        { "move", REDIS_CMD_MOVE, &Ardb::Move, 2, 2, "w", 0, 0 },
+        { "rename", REDIS_CMD_RENAME, &Ardb::Rename, 2, 2, "w", 0, 0 },
+        { "renamenx", REDIS_CMD_RENAMENX, &Ardb::RenameNX, 2, 2, "w", 0, 0 },
+        { "sort", REDIS_CMD_SORT, &Ardb::Sort, 1, -1, "wH", 0, 0 },
+        { "keys", REDIS_CMD_KEYS, &Ardb::Keys, 1, 6, "rH", 0, 0 },
+        { "keyscount", REDIS_CMD_KEYSCOUNT, &Ardb::KeysCount, 1, 6, "rH", 0, 0 },
+        { "eval", REDIS_CMD_EVAL, &Ardb::Eval, 2, -1, "s", 0, 0 },
+        { "evalsha", REDIS_CMD_EVALSHA, &Ardb::EvalSHA, 2, -1, "s", 0, 0 },
+        { "script", REDIS_CMD_SCRIPT, &Ardb::Script, 1, -1, "rs", 0, 0 },
+        { "randomkey", REDIS_CMD_RANDOMKEY, &Ardb::Randomkey, 0, 0, "r", 0, 0 },
+        { "scan", REDIS_CMD_SCAN, &Ardb::Scan, 1, -1, "rH", 0, 0 },
+        { "geoadd", REDIS_CMD_GEO_ADD, &Ardb::GeoAdd, 4, -1, "w", 0, 0 },
+        { "georadius", REDIS_CMD_GEO_RADIUS, &Ardb::GeoRadius, 5, -1, "wH", 0, 0 },
+        { "georadiusbymember", REDIS_CMD_GEO_RADIUSBYMEMBER, &Ardb::GeoRadiusByMember, 4, 10, "w", 0, 0 },
+        { "geohash", REDIS_CMD_GEO_HASH, &Ardb::GeoHash, 2, -1, "r", 0, 0 },
+        { "geodist", REDIS_CMD_GEO_DIST, &Ardb::GeoDist, 3, 4, "r", 0, 0 },
+        { "geopos", REDIS_CMD_GEO_POS, &Ardb::GeoPos, 2, -1, "r", 0, 0 },
+        { "auth", REDIS_CMD_AUTH, &Ardb::Auth, 1, 1, "rsltF", 0, 0 },
+        { "pfadd", REDIS_CMD_PFADD, &Ardb::PFAdd, 2, -1, "w", 0, 0 },
+        { "pfadd2", REDIS_CMD_PFADD2, &Ardb::PFAdd, 2, -1, "w", 0, 0 },
+        { "pfcount", REDIS_CMD_PFCOUNT, &Ardb::PFCount, 1, -1, "r", 0, 0 },
+        { "pfmerge", REDIS_CMD_PFMERGE, &Ardb::PFMerge, 2, -1, "w", 0, 0 },
+        { "bf.reserve", REDIS_CMD_BFRESERVE, &Ardb::BFReserve, 3, 6, "w", 0, 0 },
+        { "bf.add", REDIS_CMD_BFADD, &Ardb::BFAdd, 2, 2, "w", 0, 0 },
+        { "bf.madd", REDIS_CMD_BFMADD, &Ardb::BFMAdd, 2, -1, "w", 0, 0 },
+        { "bf.exists", REDIS_CMD_BFEXISTS, &Ardb::BFExists, 2, 2, "r", 0, 0 },
+        { "bf.mexists", REDIS_CMD_BFMEXISTS, &Ardb::BFMExists, 2, -1, "r", 0, 0 },
+        { "bf.info", REDIS_CMD_BFINFO, &Ardb::BFInfo, 1, 1, "r", 0, 0 },
+        { "ts.create", REDIS_CMD_TSCREATE, &Ardb::TSCreate, 1, 5, "w", 0, 0 },
+        { "ts.add", REDIS_CMD_TSADD, &Ardb::TSAdd, 3, 5, "w", 0, 0 },
+        { "ts.get", REDIS_CMD_TSGET, &Ardb::TSGet, 1, 1, "r", 0, 0 },
+        { "ts.range", REDIS_CMD_TSRANGE, &Ardb::TSRange, 3, 6, "r", 0, 0 },
+        { "ts.info", REDIS_CMD_TSINFO, &Ardb::TSInfo, 1, 1, "r", 0, 0 },
+        { "xadd", REDIS_CMD_XADD, &Ardb::XAdd, 4, -1, "w", 0, 0 },
+        { "xlen", REDIS_CMD_XLEN, &Ardb::XLen, 1, 1, "r", 0, 0 },
+        { "xrange", REDIS_CMD_XRANGE, &Ardb::XRange, 3, 5, "r", 0, 0 },
+        { "xrevrange", REDIS_CMD_XREVRANGE, &Ardb::XRange, 3, 5, "r", 0, 0 },
+        { "xread", REDIS_CMD_XREAD, &Ardb::XRead, 3, -1, "r", 0, 0 },
+        { "xtrim", REDIS_CMD_XTRIM, &Ardb::XTrim, 3, 4, "w", 0, 0 },
+        { "xdel", REDIS_CMD_XDEL, &Ardb::XDel, 2, -1, "w", 0, 0 },
+        { "cms.initbydim", REDIS_CMD_CMSINITBYDIM, &Ardb::CMSInitByDim, 3, 3, "w", 0, 0 },
+        { "cms.initbyprob", REDIS_CMD_CMSINITBYPROB, &Ardb::CMSInitByProb, 3, 3, "w", 0, 0 },
+        { "cms.incrby", REDIS_CMD_CMSINCRBY, &Ardb::CMSIncrBy, 3, -1, "w", 0, 0 },
+        { "cms.query", REDIS_CMD_CMSQUERY, &Ardb::CMSQuery, 2, -1, "r", 0, 0 },
+        { "cms.info", REDIS_CMD_CMSINFO, &Ardb::CMSInfo, 1, 1, "r", 0, 0 },
+        { "topk.reserve", REDIS_CMD_TOPKRESERVE, &Ardb::TopKReserve, 2, 5, "w", 0, 0 },
+        { "topk.add", REDIS_CMD_TOPKADD, &Ardb::TopKAdd, 2, -1, "w", 0, 0 },
+        { "topk.incrby", REDIS_CMD_TOPKINCRBY, &Ardb::TopKAdd, 3, -1, "w", 0, 0 },
+        { "topk.query", REDIS_CMD_TOPKQUERY, &Ardb::TopKRead, 2, -1, "r", 0, 0 },
+        { "topk.list", REDIS_CMD_TOPKLIST, &Ardb::TopKRead, 1, 2, "r", 0, 0 },
+        { "topk.info", REDIS_CMD_TOPKINFO, &Ardb::TopKRead, 1, 1, "r", 0, 0 },
+        { "idx.create", REDIS_CMD_IDXCREATE, &Ardb::IndexCreate, 6, -1, "wH", 0, 0 },
+        { "idx.drop", REDIS_CMD_IDXDROP, &Ardb::IndexDrop, 1, 1, "wH", 0, 0 },
+        { "idx.list", REDIS_CMD_IDXLIST, &Ardb::IndexList, 0, 0, "r", 0, 0 },
+        { "idx.range", REDIS_CMD_IDXRANGE, &Ardb::IndexRange, 4, -1, "r", 0, 0 },
+        { "vadd", REDIS_CMD_VADD, &Ardb::VAdd, 4, -1, "w", 0, 0 },
+        { "vrem", REDIS_CMD_VREM, &Ardb::VRem, 2, 2, "w", 0, 0 },
+        { "vsim", REDIS_CMD_VSIM, &Ardb::VSim, 3, -1, "rH", 0, 0 },
+        { "vcard", REDIS_CMD_VCARD, &Ardb::VInfo, 1, 1, "r", 0, 0 },
+        { "vdim", REDIS_CMD_VDIM, &Ardb::VInfo, 1, 1, "r", 0, 0 },
+        { "vinfo", REDIS_CMD_VINFO, &Ardb::VInfo, 1, 1, "r", 0, 0 },
+        { "vemb", REDIS_CMD_VEMB, &Ardb::VEmb, 2, 2, "r", 0, 0 },
+        { "dump", REDIS_CMD_DUMP, &Ardb::Dump, 1, 5, "rL", 0, 0 },
+        { "restore", REDIS_CMD_RESTORE, &Ardb::Restore, 3, 5, "wk", 0, 0 },
+        { "migrate", REDIS_CMD_MIGRATE, &Ardb::Migrate, 5, -1, "w", 0, 0 },
+        { "migratedb", REDIS_CMD_MIGRATEDB, &Ardb::MigrateDB, 4, 4, "w", 0, 0 },
+        { "restorechunk", REDIS_CMD_RESTORECHUNK, &Ardb::RestoreChunk, 1, 1, "wl", 0, 0 },
+        { "rebalance", REDIS_CMD_REBALANCE, &Ardb::Rebalance, 1, -1, "as", 0, 0 },
+        { "restoredb", REDIS_CMD_RESTOREDB, &Ardb::RestoreDB, 1, 1, "wl", 0, 0 },
+        { "monitor", REDIS_CMD_MONITOR, &Ardb::Monitor, 0, 2, "ars", 0, 0 },
+        { "debug", REDIS_CMD_DEBUG, &Ardb::Debug, 1, 1, "ars", 0, 0 },
+        { "cachememory", REDIS_CMD_CACHEMEMORY, &Ardb::CacheMemory, 0, 0, "r", 0, 0},
+        { "cluster", REDIS_CMD_CLUSTER, &Ardb::Cluster, 1, 4, "ar", 0, 0 },
+        { "asking", REDIS_CMD_ASKING, &Ardb::Asking, 0, 0, "rF", 0, 0 },
+        { "readonly", REDIS_CMD_READONLY, &Ardb::ReadOnly, 0, 0, "rF", 0, 0 },
+        { "readwrite", REDIS_CMD_READWRITE, &Ardb::ReadWrite, 0, 0, "rF", 0, 0 }};
 
         CostRanges cmdstat_ranges;
         cmdstat_ranges.push_back(CostRange(0, 1000));
@@ -356,6 +451,14 @@ OP_NAMESPACE_BEGIN
         cmdstat_ranges.push_back(CostRange(200000, 500000));
         cmdstat_ranges.push_back(CostRange(500000, 1000000));
         cmdstat_ranges.push_back(CostRange(1000000, UINT64_MAX));
+        g_key_lock_contentions.name = "key_lock_contentions";
+        Statistics::GetSingleton().AddTrack(&g_key_lock_contentions);
+        g_key_lock_waiters.name = "key_lock_waiters";
+        Statistics::GetSingleton().AddTrack(&g_key_lock_waiters);
+        g_key_lock_wait_cost.dump_flags = STAT_DUMP_INFO_CMD | STAT_DUMP_PERIOD | STAT_DUMP_PERIOD_CLEAR;
+        g_key_lock_wait_cost.name = "key_lock_wait";
+        g_key_lock_wait_cost.SetCostRanges(cmdstat_ranges);
+        Statistics::GetSingleton().AddTrack(&g_key_lock_wait_cost);
         uint32 arraylen = arraysize(settingTable);
         for (uint32 i = 0; i < arraylen; i++)
         {
@@ -368,6 +471,8 @@ OP_NAMESPACE_BEGIN
 
             cost_track.SetCostRanges(cmdstat_ranges);
             Statistics::GetSingleton().AddTrack(&cost_track);
+            settingTable[i].cost_track = &cost_track;
+            settingTable[i].engine_profile = &g_cmd_engine_profiles[settingTable[i].type];
 
             while (*f != '\0')
             {
@@ -409,6 +514,15 @@ OP_NAMESPACE_BEGIN
                     case 'F':
                         settingTable[i].flags |= ARDB_CMD_FAST;
                         break;
+                    case 'L':
+                        settingTable[i].flags |= ARDB_CMD_LOCKFREE_READ;
+                        break;
+                    case 'B':
+                        settingTable[i].flags |= ARDB_CMD_PIPELINE_BATCH;
+                        break;
+                    case 'H':
+                        settingTable[i].flags |= ARDB_CMD_SLOW;
+                        break;
                     default:
                         break;
                 }
@@ -420,12 +534,37 @@ OP_NAMESPACE_BEGIN
 
     Ardb::~Ardb()
     {
+        StopKeyCacheLoader();
+        StopCompaction();
         DELETE(m_engine);
+        DELETE_A(m_key_lock_shards);
         DELETE(m_ready_keys);
-        DELETE(m_watched_ctxs);
+        DELETE(m_rebalance);
+        for (size_t i = 0; i < m_retired_confs.size(); i++)
+        {
+            DELETE(m_retired_confs[i]);
+        }
+        if (m_conf_snapshot != &m_conf)
+        {
+            DELETE(m_conf_snapshot);
+        }
         ArdbLogger::DestroyDefaultLogger();
     }
 
+    void Ardb::PublishConf()
+    {
+        ArdbConfig* conf = NULL;
+        NEW(conf, ArdbConfig(m_conf));
+        conf->lock.m_lock = 0; //copied while m_conf.lock is held
+        ArdbConfig* old = m_conf_snapshot;
+        __sync_synchronize();
+        m_conf_snapshot = conf;
+        if (old != &m_conf)
+        {
+            m_retired_confs.push_back(old);
+        }
+    }
+
     static void daemonize(void)
     {
         int fd;
@@ -469,6 +608,8 @@ OP_NAMESPACE_BEGIN
         NEW(engine, WiredTigerEngine);
 #elif defined __USE_PERCONAFT__
         NEW(engine, PerconaFTEngine);
+#elif defined __USE_MEMORY__
+        NEW(engine, MemoryEngine);
 #else
         ERROR_LOG("Unsupported storage engine specified at compile time.");
         return NULL;
@@ -476,6 +617,75 @@ OP_NAMESPACE_BEGIN
         return engine;
     }
 
+    /*
+     * rocksdb-shards: several instances of the engine behind one ShardedEngine
+     */
+    static Engine* create_sharded_engine(int64 shards)
+    {
+        Engine* engine = create_engine();
+        if (NULL == engine || shards <= 1)
+        {
+            return engine;
+        }
+        if (strcmp(g_engine_name, "rocksdb") != 0)
+        {
+            WARN_LOG("'rocksdb-shards' is ignored by engine:%s.", g_engine_name);
+            return engine;
+        }
+        std::vector<Engine*> engines(1, engine);
+        while (engines.size() < (size_t) shards)
+        {
+            engines.push_back(create_engine());
+        }
+        NEW(engine, ShardedEngine(engines));
+        return engine;
+    }
+
+    /*
+     * The key codec version of a data dir is kept in '<dbdir>.keycodec', data dirs without it use KEY_CODEC_V1.
+     * 'key-codec-version' only applies to data dirs created empty, 0 just reads the version of the data dir.
+     */
+    static int init_key_codec_version(std::string dbdir, int64 conf_version)
+    {
+        while (dbdir.size() > 1 && dbdir[dbdir.size() - 1] == '/')
+        {
+            dbdir.resize(dbdir.size() - 1);
+        }
+        std::string path = dbdir + ".keycodec";
+        uint32 version = KEY_CODEC_V1;
+        if (is_file_exist(path))
+        {
+            std::string content;
+            if (0 != file_read_full(path, content) || !string_touint32(trim_string(content), version)
+                    || version < KEY_CODEC_V1 || version > KEY_CODEC_V3)
+            {
+                ERROR_LOG("Invalid key codec version in file:%s", path.c_str());
+                return -1;
+            }
+        }
+        else
+        {
+            std::deque<std::string> files, dirs;
+            list_subfiles(dbdir, files);
+            list_subdirs(dbdir, dirs);
+            if (files.empty() && dirs.empty() && conf_version > KEY_CODEC_V1)
+            {
+                version = conf_version;
+                if (0 != file_write_content(path, stringfromll(version)))
+                {
+                    ERROR_LOG("Failed to save key codec version into file:%s", path.c_str());
+                    return -1;
+                }
+            }
+        }
+        if (conf_version > 0 && version != conf_version)
+        {
+            WARN_LOG("Data dir:%s keeps the key codec version %u it was created with.", dbdir.c_str(), version);
+        }
+        set_key_codec_version(version);
+        return 0;
+    }
+
     int Ardb::Init(const std::string& conf_file)
     {
         Properties props;
@@ -493,6 +703,7 @@ OP_NAMESPACE_BEGIN
             printf("Failed to parse config file:%s\n", conf_file.c_str());
             return -1;
         }
+        PublishConf();
         if (m_conf.daemonize && !m_conf.servers.empty())
         {
             daemonize();
@@ -500,6 +711,10 @@ OP_NAMESPACE_BEGIN
         signal_setting();
 
         RenameCommand();
+        BuildCommandTypeIndex();
+        ApplyCommandCostLimits();
+        m_key_lock_shard_num = m_conf.key_lock_shards;
+        NEW(m_key_lock_shards, KeyLockShard[m_key_lock_shard_num]);
 
         /*
          * save pid into file
@@ -511,16 +726,86 @@ OP_NAMESPACE_BEGIN
             std::string content = tmp;
             file_write_content(m_conf.pidfile, content);
         }
-        ArdbLogger::InitDefaultLogger(m_conf.loglevel, m_conf.logfile);
+        ArdbLogger::InitDefaultLogger(m_conf.loglevel, m_conf.logfile, m_conf.log_buffer_size > 0 ? m_conf.log_buffer_size : 0);
 
         std::string dbdir = GetConf().data_base_path + "/" + g_engine_name;
-        make_dir(dbdir);
+        m_read_replica = !GetConf().rocksdb_read_replica_of.empty();
+        if (m_read_replica)
+        {
+            /*
+             * nothing may be written into the data dir of the owning instance, its layout files must all be there
+             */
+            dbdir = GetConf().rocksdb_read_replica_of + "/" + g_engine_name;
+            if (strcmp(g_engine_name, "rocksdb") != 0)
+            {
+                ERROR_LOG("'rocksdb-read-replica-of' is not supported by engine:%s.", g_engine_name);
+                return -1;
+            }
+            if (!is_dir_exist(dbdir) || (GetConf().rocksdb_shards > 1 && !is_file_exist(dbdir + "/shards")))
+            {
+                ERROR_LOG("Data dir:%s of 'rocksdb-read-replica-of' does not exist or holds no engine shards.", dbdir.c_str());
+                return -1;
+            }
+        }
+        else
+        {
+            make_dir(dbdir);
+        }
+        if (0 != init_key_codec_version(dbdir, m_read_replica ? 0 : GetConf().key_codec_version))
+        {
+            return -1;
+        }
+        set_value_compress_threshold(GetConf().value_compress_threshold);
+        LatencyMonitor::GetSingleton().SetThreshold(GetConf().latency_monitor_threshold);
+        HotKeyTracker::GetSingleton().SetSampleRate(GetConf().hotkeys_sample_rate);
+        HotKeyTracker::GetSingleton().SetBigKeyMinLength(GetConf().bigkeys_min_length);
+        BackgroundJobs::GetSingleton().SetCpuShare(GetConf().bgjobs_cpu_share);
+        BackgroundJobs::GetSingleton().SetLatencyTarget(GetConf().bgjobs_latency_target);
+        BackgroundJobs::GetSingleton().SetMaxMBPerSec(GetConf().bgjobs_max_mb_per_sec);
+        if (!TenantLimiter::GetSingleton().SetLimits(GetConf().qos_namespace_limits))
+        {
+            WARN_LOG("Invalid qos-namespace-limits:%s", GetConf().qos_namespace_limits.c_str());
+        }
+        for (size_t i = 0; i < GetConf().hugepage_arenas.size(); i++)
+        {
+            const std::string& name = GetConf().hugepage_arenas[i];
+            if (0 != arena_use_hugepage(arena_kind(name)))
+            {
+                WARN_LOG("Failed to back arena:%s with huge pages.", name.c_str());
+            }
+        }
+        if (GetConf().rocksdb_shards <= 1 && is_file_exist(dbdir + "/shards"))
+        {
+            ERROR_LOG("Data dir:%s holds engine shards, set 'rocksdb-shards' to the count in its 'shards' file.", dbdir.c_str());
+            return -1;
+        }
         int err = 0;
-        m_engine = create_engine();
+        m_engine = create_sharded_engine(GetConf().rocksdb_shards);
         if (NULL == m_engine)
         {
             return -1;
         }
+        if (GetConf().engine_profiling)
+        {
+            Engine* engine = m_engine;
+            NEW(m_engine, ProfiledEngine(engine));
+            g_engine_profiling = true;
+        }
+        if (GetConf().row_cache_size > 0)
+        {
+            Engine* engine = m_engine;
+            NEW(m_engine,
+                    CachedEngine(engine, GetConf().row_cache_size * 1024 * 1024, GetConf().row_cache_max_value, GetConf().row_cache_elements,
+                            (uint32) GetConf().row_cache_admit_reads));
+            INFO_LOG("Row cache of %lldMB in front of the engine.", (long long) GetConf().row_cache_size);
+        }
+        if (GetConf().counter_coalesce_interval > 0 && !GetConf().counter_coalesce_prefixes.empty())
+        {
+            Engine* engine = m_engine;
+            NEW(m_engine, CounterEngine(engine, GetConf().counter_coalesce_prefixes));
+            INFO_LOG("Increments of %u counter key prefixes coalesced every %lldms.", (uint32) GetConf().counter_coalesce_prefixes.size(),
+                    (long long) GetConf().counter_coalesce_interval);
+        }
         std::string options_key = g_engine_name;
         options_key.append(".options");
         std::string options_value;
@@ -535,15 +820,129 @@ OP_NAMESPACE_BEGIN
         m_starttime = time(NULL);
         g_engine = m_engine;
         INFO_LOG("Ardb init engine:%s success.", g_engine_name);
+        if (m_read_replica)
+        {
+            m_replica_refresh_time = get_current_epoch_millis();
+            INFO_LOG("Serving reads of data dir:%s, refreshed every %lldms.", dbdir.c_str(), (long long) GetConf().rocksdb_read_replica_refresh);
+        }
 
         NEW(m_key_cache, ConcurrentKeyCache());
-        m_key_cache->LoadFromDisk(m_engine);
+        if (GetConf().keycache_load_async)
+        {
+            StartKeyCacheLoader();
+        }
+        else
+        {
+            LoadKeyCache();
+        }
+        LoadLazyFreeKeys();
+        LoadObjectIds();
+        LoadHashIndexes();
+        InitClusterSlots();
         return 0;
     }
 
+    std::string Ardb::KeyCacheSnapshotPath()
+    {
+        return GetConf().data_base_path + "/" + g_engine_name + ".keycache";
+    }
+
+    /*
+     * The snapshot saved at shutdown is only used if the engine sequence did not move since, it is removed once
+     * read so that a later crash never brings back a stale one.
+     */
+    void Ardb::LoadKeyCache()
+    {
+        std::string snapshot = KeyCacheSnapshotPath();
+        int64_t seq = m_engine->GetLatestSequence();
+        if (seq < 0 || 0 != m_key_cache->LoadSnapshot(snapshot, seq))
+        {
+            m_key_cache->DropAll();
+            m_key_cache->LoadFromDisk(m_engine, GetConf().keycache_load_threads > 1 ? GetConf().keycache_load_threads : 1);
+        }
+        unlink(snapshot.c_str());
+    }
+
+    void Ardb::KeyCacheLoadTask::Run()
+    {
+        g_db->LoadKeyCache();
+        g_db->m_keycache_loading = false;
+        INFO_LOG("Key cache loaded, db 0 is ready.");
+    }
+
+    void Ardb::StartKeyCacheLoader()
+    {
+        m_keycache_loading = true;
+        NEW(m_keycache_loader, Thread(&m_keycache_load_task));
+        m_keycache_loader->Start();
+    }
+
+    /*
+     * Abort a running async load, the caller drops or reloads the cache afterwards.
+     */
+    void Ardb::StopKeyCacheLoader()
+    {
+        if (NULL == m_keycache_loader)
+        {
+            return;
+        }
+        m_key_cache->AbortLoad(true);
+        m_keycache_loader->Join();
+        DELETE(m_keycache_loader);
+        m_key_cache->AbortLoad(false);
+    }
+
+    bool Ardb::IsKeyCacheLoading(Context& ctx, RedisCommandType type)
+    {
+        if (!m_keycache_loading)
+        {
+            return false;
+        }
+        switch (type)
+        {
+            case REDIS_CMD_KEYS:
+            case REDIS_CMD_KEYSCOUNT:
+            case REDIS_CMD_FLUSHALL:
+            {
+                return true;
+            }
+            default:
+            {
+                return IsKeyCacheNameSpace(ctx.ns);
+            }
+        }
+    }
+
+    /*
+     * The key cache only indexes the keys of db 0.
+     */
+    bool Ardb::IsKeyCacheNameSpace(const Data& ns)
+    {
+        return ns.StringLength() == 1 && ns.CStr()[0] == '0';
+    }
+
+    void Ardb::SaveKeyCache()
+    {
+        if (m_keycache_loading)
+        {
+            WARN_LOG("Skip saving the key cache which is still loading.");
+            return;
+        }
+        int64_t seq = m_engine->GetLatestSequence();
+        if (seq < 0)
+        {
+            return;
+        }
+        m_key_cache->SaveSnapshot(KeyCacheSnapshotPath(), seq);
+    }
+
     int Ardb::Repair(const std::string& dir)
     {
-        m_engine = create_engine();
+        if (0 != init_key_codec_version(dir, 0))
+        {
+            return -1;
+        }
+        m_engine = create_sharded_engine(GetConf().rocksdb_shards);
         if (NULL == m_engine)
         {
             return -1;
@@ -568,6 +967,37 @@ OP_NAMESPACE_BEGIN
         }
     }
 
+    static CaseInsensitivePerfectHash g_command_type_hash;
+    static RedisCommandType resolve_command_type(const char* cmd, size_t len)
+    {
+        return (RedisCommandType) g_command_type_hash.Get(cmd, len, REDIS_CMD_INVALID);
+    }
+
+    void Ardb::BuildCommandTypeIndex()
+    {
+        CaseInsensitivePerfectHash::EntryArray entries;
+        RedisCommandHandlerSettingTable::iterator it = m_settings.begin();
+        while (it != m_settings.end())
+        {
+            RedisCommandType type = it->second.type;
+            entries.push_back(CaseInsensitivePerfectHash::Entry(it->first, type));
+            if (NULL == m_settings_by_type[type])
+            {
+                m_settings_by_type[type] = &(it->second);
+                m_command_names_by_type[type] = &(it->first);
+            }
+            it++;
+        }
+        if (g_command_type_hash.Build(entries))
+        {
+            g_redis_command_type_resolver = resolve_command_type;
+        }
+        else
+        {
+            WARN_LOG("Failed to build command type index, resolve command by name.");
+        }
+    }
+
     int Ardb::SetKeyValue(Context& ctx, const KeyObject& key, const ValueObject& val)
     {
         int ret = 0;
@@ -594,6 +1024,7 @@ OP_NAMESPACE_BEGIN
         int ret = m_engine->Del(ctx, key);
         if (0 == ret)
         {
+            NoteDeletedEntries(1);
             TouchWatchKey(ctx, key);
             ctx.dirty++;
         }
@@ -618,13 +1049,45 @@ OP_NAMESPACE_BEGIN
             WARN_LOG("Can NOT launch compact task since server is compacting db.");
             return -1;
         }
+        BackgroundJobScope job(BGJOB_COMPACTION);
+        if (!job.started)
+        {
+            WARN_LOG("Can NOT launch compact task since compaction jobs are paused or throttled.");
+            return -1;
+        }
         KeyObject start, end;
-        start.SetNameSpace(ctx.ns);
+        start.SetNameSpace(ns);
         m_compacting_data = true;
+        LatencyMonitorScope latency("compaction");
         m_engine->Compact(ctx, start, end);
         m_compacting_data = false;
         return 0;
     }
+    /*
+     * Replace the engine data with a checkpoint received from the master, then rebuild the in memory state
+     * derived from it.
+     */
+    int Ardb::RestoreEngine(const std::string& dir)
+    {
+        Context ctx;
+        StopCompaction();
+        int err = m_engine->Restore(ctx, dir);
+        if (0 != err)
+        {
+            ERROR_LOG("Failed to restore engine from:%s with err:%d", dir.c_str(), err);
+            return err;
+        }
+        StopKeyCacheLoader();
+        m_key_cache->DropAll();
+        m_key_cache->LoadFromDisk(m_engine, GetConf().keycache_load_threads > 1 ? GetConf().keycache_load_threads : 1);
+        m_keycache_loading = false;
+        LoadLazyFreeKeys();
+        LoadObjectIds();
+        LoadHashIndexes();
+        InitClusterSlots();
+        return 0;
+    }
+
     int Ardb::CompactAll(Context& ctx)
     {
         if(m_compacting_data)
@@ -632,178 +1095,445 @@ OP_NAMESPACE_BEGIN
             WARN_LOG("Can NOT launch compact task since server is compacting db.");
             return -1;
         }
+        BackgroundJobScope job(BGJOB_COMPACTION);
+        if (!job.started)
+        {
+            WARN_LOG("Can NOT launch compact task since compaction jobs are paused or throttled.");
+            return -1;
+        }
         m_compacting_data = true;
+        LatencyMonitorScope latency("compaction");
         m_engine->CompactAll(ctx);
         m_compacting_data = false;
         return 0;
     }
 
-    int Ardb::FlushDB(Context& ctx, const Data& ns)
+    int Ardb::CompactQueuedRanges()
     {
-        m_engine->DropNameSpace(ctx, ns);
-        ctx.dirty += 1000; //makesure all
-        TouchWatchedKeysOnFlush(ctx, ns);
-        m_key_cache->DropAll();
-        return 0;
+        Context ctx;
+        return m_engine->CompactQueuedRanges(ctx);
     }
-    int Ardb::FlushAll(Context& ctx)
+
+    int Ardb::DropExpiredTables()
     {
-        DataArray nss;
-        m_engine->ListNameSpaces(ctx, nss);
-        for (size_t i = 0; i < nss.size(); i++)
+        Context ctx;
+        return m_engine->DropExpiredTables(ctx);
+    }
+
+    int Ardb::FlushPendingWrites()
+    {
+        Context ctx;
+        return m_engine->FlushPendingWrites(ctx);
+    }
+
+    int Ardb::StartCompaction(const Data& ns, bool full)
+    {
+        LockGuard<ThreadMutexLock> guard(m_compaction_lock);
+        if (m_compacting_data)
         {
-            m_engine->DropNameSpace(ctx, nss[i]);
+            return -1;
         }
-        ctx.dirty += 1000;
-        Data empty_ns; //indicate all namespaces
-        TouchWatchedKeysOnFlush(ctx, empty_ns);
-        m_key_cache->DropAll();
+        if (NULL != m_compaction_thread)
+        {
+            m_compaction_thread->Join();
+            DELETE(m_compaction_thread);
+        }
+        m_compaction_task.ns = ns;
+        m_compaction_task.ns.ToMutableStr();
+        m_compaction_task.full = full;
+        m_compaction_task.progress = CompactProgress();
+        m_compacting_data = true;
+        m_deleted_entries = 0;
+        NEW(m_compaction_thread, Thread(&m_compaction_task));
+        m_compaction_thread->Start();
         return 0;
     }
 
-    void Ardb::LockKey(const KeyObject& key)
+    bool Ardb::CancelCompaction()
     {
-        KeyPrefix lk;
-        lk.ns = key.GetNameSpace();
-        lk.key = key.GetKey();
-        while (true)
+        if (!m_compacting_data || NULL == m_compaction_thread)
         {
-            ThreadMutexLock* lock = NULL;
-            {
-                LockGuard<SpinMutexLock> guard(m_locking_keys_lock);
-                std::pair<LockTable::iterator, bool> ret = m_locking_keys.insert(LockTable::value_type(lk, NULL));
-                if (!ret.second && NULL != ret.first->second)
-                {
-                    /*
-                     * already locked by other thread, wait until unlocked
-                     */
-                    lock = ret.first->second;
-                }
-                else
-                {
-                    /*
-                     * no other thread lock on the key
-                     */
-                    if (!m_lock_pool.empty())
-                    {
-                        lock = m_lock_pool.top();
-                        m_lock_pool.pop();
-                    }
-                    else
-                    {
-                        NEW(lock, ThreadMutexLock);
-                    }
-                    ret.first->second = lock;
-                    return;
-                }
-            }
-
-            if (NULL != lock)
-            {
-                LockGuard<ThreadMutexLock> guard(*lock);
-                lock->Wait(1, MILLIS);
-            }
+            return false;
         }
+        m_compaction_task.progress.cancel = true;
+        return true;
     }
-    void Ardb::UnlockKey(const KeyObject& key)
+
+    /*
+     * A range being compacted is finished first, the engine can not be interrupted within one.
+     */
+    void Ardb::StopCompaction()
     {
-        KeyPrefix lk;
-        lk.ns = key.GetNameSpace();
-        lk.key = key.GetKey();
+        LockGuard<ThreadMutexLock> guard(m_compaction_lock);
+        if (NULL == m_compaction_thread)
         {
-            LockGuard<SpinMutexLock> guard(m_locking_keys_lock);
-            LockTable::iterator ret = m_locking_keys.find(lk);
-            if (ret != m_locking_keys.end() && ret->second != NULL)
-            {
-                ThreadMutexLock* lock = ret->second;
-                m_locking_keys.erase(ret);
-                m_lock_pool.push(lock);
-                LockGuard<ThreadMutexLock> guard(*lock);
-                lock->Notify();
-            }
+            return;
         }
+        m_compaction_task.progress.cancel = true;
+        m_compaction_thread->Join();
+        DELETE(m_compaction_thread);
     }
 
-    void Ardb::LockKeys(const KeyObjectArray& ks)
+    void Ardb::CompactionTask::Run()
     {
-        typedef std::vector<std::pair<LockTable::iterator, bool> > IterRetArray;
-        while (true)
+        g_db->RunCompaction(*this);
+    }
+
+    void Ardb::RunCompaction(CompactionTask& task)
+    {
+        Context ctx;
+        const char* status = "ok";
         {
-            ThreadMutexLock* lock = NULL;
+            BackgroundJobScope job(BGJOB_COMPACTION, true);
+            if (!job.started)
+            {
+                WARN_LOG("Background compaction skipped since compaction jobs are paused.");
+                status = "paused";
+            }
+            else
             {
-                LockGuard<SpinMutexLock> guard(m_locking_keys_lock);
-                IterRetArray rets(ks.size());
-                for (size_t i = 0; i < ks.size(); i++)
+                LatencyMonitorScope latency("compaction");
+                DataArray nss;
+                if (task.ns.IsNil())
                 {
-                    KeyPrefix lk;
-                    lk.ns = ks[i].GetNameSpace();
-                    lk.key = ks[i].GetKey();
-                    std::pair<LockTable::iterator, bool> ret = m_locking_keys.insert(LockTable::value_type(lk, NULL));
-                    if (!ret.second && NULL != ret.first->second)
-                    {
-                        /*
-                         * already locked by other thread, wait until unlocked
-                         */
-                        lock = ret.first->second;
-                        break;
-                    }
-                    rets[i] = ret;
+                    m_engine->ListNameSpaces(ctx, nss);
                 }
-                /*
-                 * already locked by other thread, wait until unlocked
-                 */
-                if (NULL != lock)
+                else
                 {
-                    break;
+                    nss.push_back(task.ns);
                 }
-                /*
-                 * no other thread lock on the key
-                 */
-                if (!m_lock_pool.empty())
+                if (task.full)
                 {
-                    lock = m_lock_pool.top();
-                    m_lock_pool.pop();
+                    task.progress.total = nss.size();
                 }
-                else
+                for (size_t i = 0; i < nss.size() && !task.progress.cancel; i++)
                 {
-                    NEW(lock, ThreadMutexLock);
+                    int err = ERR_NOTSUPPORTED;
+                    if (!task.full)
+                    {
+                        err = m_engine->CompactDeleted(ctx, nss[i], (int) GetConf().compact_min_deleted_percent, task.progress);
+                    }
+                    if (ERR_NOTSUPPORTED == err)
+                    {
+                        if (!task.full)
+                        {
+                            task.progress.total++;
+                        }
+                        KeyObject start, end;
+                        start.SetNameSpace(nss[i]);
+                        err = m_engine->Compact(ctx, start, end);
+                        task.progress.done++;
+                    }
+                    if (0 != err && ERR_ENTRY_NOT_EXIST != err)
+                    {
+                        ERROR_LOG("Failed to compact db:%s with err:%d", nss[i].AsString().c_str(), err);
+                        status = "error";
+                    }
                 }
-                for (size_t i = 0; i < ks.size(); i++)
+                if (task.progress.cancel)
                 {
-                    rets[i].first->second = lock;
+                    status = "cancelled";
                 }
-                return;
-            }
-
-            if (NULL != lock)
-            {
-                LockGuard<ThreadMutexLock> guard(*lock);
-                lock->Wait(1, MILLIS);
             }
         }
+        INFO_LOG("Background %s compaction finished with status:%s, %u/%u ranges compacted.", task.full ? "full" : "deleted ranges",
+                status, task.progress.done, task.progress.total);
+        m_compaction_last_status = status;
+        m_compaction_last_time = time(NULL);
+        m_compacting_data = false;
     }
-    void Ardb::UnlockKeys(const KeyObjectArray& ks)
+
+    void Ardb::CompactionInfo(std::string& info)
     {
-        LockGuard<SpinMutexLock> guard(m_locking_keys_lock);
-        ThreadMutexLock* lock = NULL;
-        for (size_t i = 0; i < ks.size(); i++)
-        {
-            KeyPrefix lk;
-            lk.ns = ks[i].GetNameSpace();
-            lk.key = ks[i].GetKey();
-            LockTable::iterator ret = m_locking_keys.find(lk);
-            if (ret != m_locking_keys.end() && ret->second != NULL)
-            {
-                lock = ret->second;
-                m_locking_keys.erase(ret);
-                m_lock_pool.push(lock);
-            }
-        }
-        if (NULL != lock)
-        {
-            LockGuard<ThreadMutexLock> guard(*lock);
-            lock->Notify();
-        }
+        info.append("compaction_in_progress:").append(m_compacting_data ? "1" : "0").append("\r\n");
+        info.append("compaction_ranges_done:").append(stringfromll(m_compaction_task.progress.done)).append("\r\n");
+        info.append("compaction_ranges_total:").append(stringfromll(m_compaction_task.progress.total)).append("\r\n");
+        info.append("compaction_last_time:").append(stringfromll(m_compaction_last_time)).append("\r\n");
+        info.append("compaction_last_status:").append(m_compaction_last_status).append("\r\n");
+        info.append("compaction_deleted_entries:").append(stringfromll(m_deleted_entries)).append("\r\n");
+    }
+
+    /*
+     * Called by the slow cron, a wave of DEL/expiry leaves tombstones which slow down every scan over them
+     * until compacted away.
+     */
+    void Ardb::CompactOnDeletes()
+    {
+        int64 threshold = GetConf().compact_after_deleted_entries;
+        if (threshold <= 0 || (int64) m_deleted_entries < threshold || m_compacting_data || IsLoadingData())
+        {
+            return;
+        }
+        INFO_LOG("%llu entries deleted since the last compaction, compact the ranges with deleted entries.", (unsigned long long) m_deleted_entries);
+        Data all;
+        StartCompaction(all, false);
+    }
+
+    int Ardb::FlushDB(Context& ctx, const Data& ns, bool async)
+    {
+        if (!async || 0 != m_engine->DetachNameSpace(ctx, ns))
+        {
+            m_engine->DropNameSpace(ctx, ns);
+        }
+        AddFlushedNameSpace(ns);
+        FlushHashIndexes(ctx, ns);
+        ctx.dirty += 1000; //makesure all
+        TouchWatchedKeysOnFlush(ctx, ns);
+        m_key_cache->DropAll();
+        return 0;
+    }
+    /*
+     * Replaces the data of 'ns' by the one of namespace 'from' at once, the old data is reclaimed as by FLUSHDB ASYNC.
+     */
+    int Ardb::SwapNameSpace(Context& ctx, const Data& ns, const Data& from)
+    {
+        int err = m_engine->SwapNameSpace(ctx, ns, from);
+        if (0 != err)
+        {
+            return err;
+        }
+        AddFlushedNameSpace(ns);
+        FlushHashIndexes(ctx, ns);
+        ctx.dirty += 1000;
+        TouchWatchedKeysOnFlush(ctx, ns);
+        m_key_cache->DropAll();
+        return 0;
+    }
+    int Ardb::FlushAll(Context& ctx, bool async)
+    {
+        DataArray nss;
+        m_engine->ListNameSpaces(ctx, nss);
+        for (size_t i = 0; i < nss.size(); i++)
+        {
+            if (!async || 0 != m_engine->DetachNameSpace(ctx, nss[i]))
+            {
+                m_engine->DropNameSpace(ctx, nss[i]);
+            }
+        }
+        {
+            //the ttl db is gone along with all other namespaces
+            LockGuard<SpinMutexLock> guard(m_flushed_lock);
+            m_flushed_nss.clear();
+            m_flushed_ns_count = 0;
+            m_ttl_purge_version++;
+        }
+        ClearHashIndexes();
+        ctx.dirty += 1000;
+        Data empty_ns; //indicate all namespaces
+        TouchWatchedKeysOnFlush(ctx, empty_ns);
+        m_key_cache->DropAll();
+        return 0;
+    }
+
+    static uint32 key_lock_hash(const Data& data, uint32 seed)
+    {
+        uint32 hash = 0;
+        if (data.IsString())
+        {
+            MurmurHash3_x86_32(data.CStr(), data.StringLength(), seed, &hash);
+        }
+        else
+        {
+            std::string str;
+            data.ToString(str);
+            MurmurHash3_x86_32(str.data(), str.size(), seed, &hash);
+        }
+        return hash;
+    }
+
+    uint32 Ardb::GetKeyLockShardIndex(const KeyPrefix& key)
+    {
+        if (m_key_lock_shard_num <= 1)
+        {
+            return 0;
+        }
+        uint32 hash = key_lock_hash(key.ns, 0);
+        hash = key_lock_hash(key.key, hash);
+        return hash % m_key_lock_shard_num;
+    }
+
+    uint32 Ardb::GetWatchVersionSlot(const KeyPrefix& key)
+    {
+        uint32 hash = key_lock_hash(key.ns, 0);
+        hash = key_lock_hash(key.key, hash);
+        return hash % kWatchVersionSlots;
+    }
+
+    Ardb::BlockShard& Ardb::GetBlockShard(const KeyPrefix& key)
+    {
+        uint32 hash = key_lock_hash(key.ns, 0);
+        hash = key_lock_hash(key.key, hash);
+        return m_block_shards[hash % kBlockShards];
+    }
+
+    void Ardb::LockKey(const KeyPrefix& lk)
+    {
+        KeyLockShard& shard = m_key_lock_shards[GetKeyLockShardIndex(lk)];
+        KeyLockWaiter waiter;
+        {
+            LockGuard<SpinMutexLock> guard(shard.lock);
+            std::pair<LockTable::iterator, bool> ret = shard.keys.insert(LockTable::value_type(lk, NULL));
+            if (ret.second)
+            {
+                /*
+                 * no other thread lock on the key
+                 */
+                KeyLockWaitQueue* queue = NULL;
+                if (!shard.pool.empty())
+                {
+                    queue = shard.pool.top();
+                    shard.pool.pop();
+                }
+                else
+                {
+                    NEW(queue, KeyLockWaitQueue);
+                }
+                ret.first->second = queue;
+                return;
+            }
+            /*
+             * already locked by other thread, queue up and wait for the ownership handed over by UnlockKey
+             */
+            ret.first->second->push_back(&waiter);
+        }
+        g_key_lock_contentions.Add(1);
+        g_key_lock_waiters.Add(1);
+        uint64 start_time = get_current_epoch_micros();
+        ARDB_PROBE1(lock__wait, lk.key.StringLength());
+        {
+            LockGuard<ThreadMutexLock> guard(waiter.cond);
+            while (!waiter.granted)
+            {
+                waiter.cond.Wait();
+            }
+        }
+        g_key_lock_waiters.Sub(1);
+        g_key_lock_wait_cost.AddCost(get_current_epoch_micros() - start_time);
+        ARDB_PROBE2(lock__acquired, lk.key.StringLength(), get_current_epoch_micros() - start_time);
+        LatencyMonitor::GetSingleton().AddSampleIfNeeded("key-lock-wait", (get_current_epoch_micros() - start_time) / 1000);
+    }
+
+    /*
+     * Lock the key only if no other thread holds it.
+     */
+    bool Ardb::TryLockKey(const KeyPrefix& lk)
+    {
+        KeyLockShard& shard = m_key_lock_shards[GetKeyLockShardIndex(lk)];
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        std::pair<LockTable::iterator, bool> ret = shard.keys.insert(LockTable::value_type(lk, NULL));
+        if (!ret.second)
+        {
+            return false;
+        }
+        KeyLockWaitQueue* queue = NULL;
+        if (!shard.pool.empty())
+        {
+            queue = shard.pool.top();
+            shard.pool.pop();
+        }
+        else
+        {
+            NEW(queue, KeyLockWaitQueue);
+        }
+        ret.first->second = queue;
+        return true;
+    }
+
+    void Ardb::UnlockKey(const KeyPrefix& lk)
+    {
+        KeyLockShard& shard = m_key_lock_shards[GetKeyLockShardIndex(lk)];
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        LockTable::iterator ret = shard.keys.find(lk);
+        if (ret == shard.keys.end())
+        {
+            return;
+        }
+        KeyLockWaitQueue* queue = ret->second;
+        if (queue->empty())
+        {
+            shard.keys.erase(ret);
+            shard.pool.push(queue);
+            return;
+        }
+        /*
+         * the key stays locked, ownership goes to the first waiter
+         */
+        KeyLockWaiter* waiter = queue->front();
+        queue->pop_front();
+        LockGuard<ThreadMutexLock> cond_guard(waiter->cond);
+        waiter->granted = true;
+        waiter->cond.Notify();
+    }
+
+    /*
+     * Keys of the connection's pipeline batch are locked by the batch already.
+     */
+    bool Ardb::IsPipelineBatchKey(Context& ctx, const KeyObject& key)
+    {
+        if (!ctx.InPipelineBatch())
+        {
+            return false;
+        }
+        KeyPrefix lk;
+        lk.ns = key.GetNameSpace();
+        lk.key = key.GetKey();
+        return ctx.pipeline->keys.count(lk) > 0;
+    }
+
+    void Ardb::LockKey(const KeyObject& key)
+    {
+        KeyPrefix lk;
+        lk.ns = key.GetNameSpace();
+        lk.key = key.GetKey();
+        LockKey(lk);
+        FinishLazyFree(lk);
+    }
+    void Ardb::UnlockKey(const KeyObject& key)
+    {
+        KeyPrefix lk;
+        lk.ns = key.GetNameSpace();
+        lk.key = key.GetKey();
+        UnlockKey(lk);
+    }
+
+    /*
+     * Multiple keys are locked one by one in ascending key order, so that threads locking overlapping
+     * key sets never wait on each other in a cycle.
+     */
+    void Ardb::LockKeys(const KeyObjectArray& ks)
+    {
+        TreeSet<KeyPrefix>::Type lks;
+        for (size_t i = 0; i < ks.size(); i++)
+        {
+            KeyPrefix lk;
+            lk.ns = ks[i].GetNameSpace();
+            lk.key = ks[i].GetKey();
+            lks.insert(lk);
+        }
+        TreeSet<KeyPrefix>::Type::iterator it = lks.begin();
+        while (it != lks.end())
+        {
+            LockKey(*it);
+            FinishLazyFree(*it);
+            it++;
+        }
+    }
+    void Ardb::UnlockKeys(const KeyObjectArray& ks)
+    {
+        TreeSet<KeyPrefix>::Type lks;
+        for (size_t i = 0; i < ks.size(); i++)
+        {
+            KeyPrefix lk;
+            lk.ns = ks[i].GetNameSpace();
+            lk.key = ks[i].GetKey();
+            lks.insert(lk);
+        }
+        TreeSet<KeyPrefix>::Type::iterator it = lks.begin();
+        while (it != lks.end())
+        {
+            UnlockKey(*it);
+            it++;
+        }
     }
 
     void Ardb::FeedReplicationDelOperation(Context& ctx, const Data& ns, const std::string& key)
@@ -849,7 +1579,10 @@ OP_NAMESPACE_BEGIN
         g_repl->GetReplLog().WriteWAL(ns, cmd);
     }
 
-    void Ardb::SaveTTL(Context& ctx, const Data& ns, const std::string& key, int64 old_ttl, int64_t new_ttl)
+    /*
+     * TTL entry of a key, or of a field of a hash if 'field' is not NULL.
+     */
+    void Ardb::SaveTTL(Context& ctx, const Data& ns, const std::string& key, int64 old_ttl, int64_t new_ttl, const std::string* field)
     {
         /*
          * only works with engine that has no compactfilter support
@@ -860,15 +1593,27 @@ OP_NAMESPACE_BEGIN
         }
         if (new_ttl > 0)
         {
-            if (m_min_ttl <= 0 || m_min_ttl > new_ttl)
+            while (true)
             {
-                m_min_ttl = new_ttl;
+                int64 current = m_min_ttl;
+                if (current > 0 && current <= new_ttl)
+                {
+                    break;
+                }
+                if (atomic_cmp_set_uint64((volatile uint64_t*) &m_min_ttl, (uint64_t) current, (uint64_t) new_ttl))
+                {
+                    break;
+                }
             }
             Data tll_ns(TTL_DB_NSMAESPACE, false);
             KeyObject new_ttl_key(tll_ns, KEY_TTL_SORT, "");
             new_ttl_key.SetTTL(new_ttl);
             new_ttl_key.SetTTLKeyNamespace(ns);
             new_ttl_key.SetTTLKey(key);
+            if (NULL != field)
+            {
+                new_ttl_key.SetTTLField(*field);
+            }
             ValueObject v;
             v.SetType(KEY_TTL_SORT);
             ctx.flags.create_if_notexist = 1;
@@ -881,10 +1626,102 @@ OP_NAMESPACE_BEGIN
             old_ttl_key.SetTTL(old_ttl);
             old_ttl_key.SetTTLKeyNamespace(ns);
             old_ttl_key.SetTTLKey(key);
+            if (NULL != field)
+            {
+                old_ttl_key.SetTTLField(*field);
+            }
             m_engine->Del(ctx, old_ttl_key);
         }
     }
 
+    void Ardb::TTLScanTask::Run()
+    {
+        g_db->ScanTTLRange(*this);
+    }
+
+    /*
+     * Delete the expired keys of the TTL entries together with the entries in one write batch,
+     * the keys stay locked until the batch is committed.
+     */
+    uint32 Ardb::DeleteExpiredTTLKeys(Context& ctx, KeyObjectArray& ttl_keys)
+    {
+        KeyObjectArray meta_keys;
+        for (size_t i = 0; i < ttl_keys.size(); i++)
+        {
+            meta_keys.push_back(KeyObject(ttl_keys[i].GetElement(1), KEY_META, ttl_keys[i].GetElement(2)));
+        }
+        uint32 expired_keys = 0;
+        KeysLockGuard guard(ctx, meta_keys);
+        WriteBatchGuard batch(ctx, m_engine);
+        for (size_t i = 0; i < meta_keys.size(); i++)
+        {
+            const KeyObject& meta_key = meta_keys[i];
+            ValueObject meta;
+            if (ttl_keys[i].IsFieldTTL())
+            {
+                ExpireHashField(ctx, meta_key, ttl_keys[i].GetElement(3).AsString(), ttl_keys[i].GetTTL());
+            }
+            else if (0 == m_engine->Get(ctx, meta_key, meta) && meta.GetTTL() == ttl_keys[i].GetTTL())
+            {
+                //delete whole key
+                if (meta.GetType() == KEY_STRING && !meta.IsChunked())
+                {
+                    m_engine->Del(ctx, meta_key);
+                }
+                else
+                {
+                    Iterator* iter = NULL;
+                    DelKey(ctx, meta_key, iter, true);
+                    DELETE(iter);
+                }
+                expired_keys++;
+                FeedReplicationDelOperation(ctx, meta_key.GetNameSpace(), meta_key.GetKey().AsString());
+            }
+            m_engine->Del(ctx, ttl_keys[i]);
+        }
+        return expired_keys;
+    }
+
+    void Ardb::ScanTTLRange(TTLScanTask& task)
+    {
+        Context scan_ctx;
+        Data tll_ns(TTL_DB_NSMAESPACE, false);
+        KeyObject scan_key(tll_ns, KEY_TTL_SORT, "");
+        scan_key.SetTTL(task.start);
+        size_t batch_size = GetConf().expire_delete_batch_size > 0 ? (size_t) GetConf().expire_delete_batch_size : 1;
+        int64 now = get_current_epoch_millis();
+        uint32 scaned_keys = 0;
+        KeyObjectArray ttl_keys;
+        task.next = -1;
+        Iterator* iter = m_engine->Find(scan_ctx, scan_key);
+        while (iter->Valid())
+        {
+            KeyObject& k = iter->Key(true);
+            if (k.GetTTL() >= task.end)
+            {
+                break;
+            }
+            if (k.GetTTL() > now || scaned_keys >= task.limit)
+            {
+                task.next = k.GetTTL();
+                break;
+            }
+            scaned_keys++;
+            ttl_keys.push_back(k);
+            if (ttl_keys.size() >= batch_size)
+            {
+                task.expired += DeleteExpiredTTLKeys(scan_ctx, ttl_keys);
+                ttl_keys.clear();
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        if (!ttl_keys.empty())
+        {
+            task.expired += DeleteExpiredTTLKeys(scan_ctx, ttl_keys);
+        }
+    }
+
     void Ardb::ScanTTLDB()
     {
         /*
@@ -898,60 +1735,80 @@ OP_NAMESPACE_BEGIN
         {
             return;
         }
-        uint32 max_scan_keys_one_iter = 1000;
-        uint32 scaned_keys = 0;
-        uint32 total_expired_keys = 0;
-        Context scan_ctx;
-        Data tll_ns(TTL_DB_NSMAESPACE, false);
-        KeyObject scan_key(tll_ns, KEY_TTL_SORT, "");
-        scan_key.SetTTL(m_min_ttl);
-        Iterator* iter = m_engine->Find(scan_ctx, scan_key);
-        if (!iter->Valid())
-        {
-            m_min_ttl = 0; //no expire key
-        }
+        const uint32 min_scan_keys_one_iter = 1000;
+        int64 min_ttl = m_min_ttl;
         uint64 start_time = get_current_epoch_millis();
-        while (iter->Valid() && scaned_keys < max_scan_keys_one_iter)
+        /*
+         * the scan budget grows by 'min_scan_keys_one_iter' for every second the oldest TTL entry is behind,
+         * a lagging scan is split into time buckets of the TTL entries expired by parallel workers.
+         */
+        int64 max_scan_keys_one_iter = min_scan_keys_one_iter;
+        uint32 workers = 1;
+        if (min_ttl > 0 && (int64) start_time > min_ttl)
         {
-            KeyObject& k = iter->Key(false);
-            m_min_ttl = k.GetTTL();
-            if (k.GetTTL() > get_current_epoch_millis())
+            int64 lag_secs = ((int64) start_time - min_ttl) / 1000;
+            max_scan_keys_one_iter = min_scan_keys_one_iter * (1 + lag_secs);
+            if (max_scan_keys_one_iter > GetConf().expire_scan_max_keys)
             {
-                break;
+                max_scan_keys_one_iter = GetConf().expire_scan_max_keys > min_scan_keys_one_iter ? GetConf().expire_scan_max_keys : min_scan_keys_one_iter;
             }
-            scaned_keys++;
-            ValueObject meta;
-            KeyObject meta_key(k.GetElement(1), KEY_META, k.GetElement(2));
-            KeyLockGuard guard(scan_ctx, meta_key);
-            if (0 == m_engine->Get(scan_ctx, meta_key, meta))
+            workers = max_scan_keys_one_iter / min_scan_keys_one_iter;
+            if (workers > GetConf().expire_scan_threads)
             {
-                if (meta.GetTTL() == k.GetTTL())
-                {
-                    //delete whole key
-                    if (meta.GetType() == KEY_STRING)
-                    {
-                        m_engine->Del(scan_ctx, meta_key);
-                    }
-                    else
-                    {
-                        DelKey(scan_ctx, meta_key);
-                    }
-                    total_expired_keys++;
-                    FeedReplicationDelOperation(scan_ctx, meta_key.GetNameSpace(), meta_key.GetKey().AsString());
-                }
+                workers = GetConf().expire_scan_threads > 1 ? GetConf().expire_scan_threads : 1;
             }
-            else
+        }
+        std::vector<TTLScanTask> tasks(workers);
+        int64 bucket = workers > 1 ? ((int64) start_time - min_ttl) / workers : 0;
+        for (uint32 i = 0; i < workers; i++)
+        {
+            tasks[i].start = min_ttl + i * bucket;
+            tasks[i].end = i == workers - 1 ? LLONG_MAX : min_ttl + (i + 1) * bucket;
+            tasks[i].limit = max_scan_keys_one_iter / workers;
+        }
+        std::vector<Thread*> threads;
+        for (uint32 i = 1; i < workers; i++)
+        {
+            Thread* thread = NULL;
+            NEW(thread, Thread(&tasks[i]));
+            thread->Start();
+            threads.push_back(thread);
+        }
+        tasks[0].Run();
+        uint32 total_expired_keys = tasks[0].expired;
+        for (size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i]->Join();
+            DELETE(threads[i]);
+            total_expired_keys += tasks[i + 1].expired;
+        }
+        /*
+         * the first entry left in the earliest range is the next TTL to expire, 0 if there is no expire key
+         */
+        int64 next_ttl = 0;
+        for (uint32 i = 0; i < workers; i++)
+        {
+            if (tasks[i].next >= 0)
             {
-
+                next_ttl = tasks[i].next;
+                break;
+            }
+        }
+        while (!atomic_cmp_set_uint64((volatile uint64_t*) &m_min_ttl, (uint64_t) min_ttl, (uint64_t) next_ttl))
+        {
+            /*
+             * lowered by SaveTTL while scanning
+             */
+            min_ttl = m_min_ttl;
+            if (min_ttl > 0 && (0 == next_ttl || min_ttl < next_ttl))
+            {
+                break;
             }
-            iter->Del();
-            iter->Next();
         }
-        DELETE(iter);
         uint64 end_time = get_current_epoch_millis();
         if (total_expired_keys > 0)
         {
-            INFO_LOG("Cost %llums to delete %u keys.", (end_time - start_time), total_expired_keys);
+            INFO_LOG("Cost %llums to delete %u keys with %u workers.", (end_time - start_time), total_expired_keys, workers);
         }
     }
 
@@ -962,6 +1819,7 @@ OP_NAMESPACE_BEGIN
 
     int64 Ardb::ScanExpiredKeys()
     {
+        LatencyMonitorScope latency("expire-cycle");
         /*
          * do not do scan expire on slaves
          */
@@ -974,27 +1832,30 @@ OP_NAMESPACE_BEGIN
             ScanTTLDB();
             return 0;
         }
-        KeyPrefix scan_key;
         Context scan_ctx;
         int64 total_expired_keys = 0;
         uint64 start_time = get_current_epoch_millis();
-        while (true)
+        ExpireKeySet expires;
+        for (uint32 i = 0; i < kExpireKeyShards; i++)
         {
+            LockGuard<SpinMutexLock> guard(m_expires[i].lock);
+            if (expires.empty())
             {
-                LockGuard<SpinMutexLock> guard(m_expires_lock);
-                if (!m_expires.empty())
-                {
-                    scan_key = *(m_expires.begin());
-                    m_expires.erase(m_expires.begin());
-                }
-                else
-                {
-                    break;
-                }
+                expires.swap(m_expires[i].keys);
+            }
+            else
+            {
+                expires.insert(m_expires[i].keys.begin(), m_expires[i].keys.end());
+                m_expires[i].keys.clear();
             }
+        }
+        ExpireKeySet::iterator eit = expires.begin();
+        for (; eit != expires.end(); eit++)
+        {
+            const KeyPrefix& scan_key = *eit;
             if (scan_key.IsNil())
             {
-                break;
+                continue;
             }
             KeyObject key(scan_key.ns, KEY_META, scan_key.key);
             KeyLockGuard keylocker(scan_ctx, key);
@@ -1030,13 +1891,15 @@ OP_NAMESPACE_BEGIN
                  */
                 FeedReplicationDelOperation(scan_ctx, key.GetNameSpace(), key.GetKey().AsString());
             }
-            if (KEY_STRING == meta.GetType())
+            if (KEY_STRING == meta.GetType() && !meta.IsChunked())
             {
                 RemoveKey(scan_ctx, key);
             }
             else if (meta.GetType() > 0)
             {
-                DelKey(scan_ctx, key);
+                Iterator* iter = NULL;
+                DelKey(scan_ctx, key, iter, true);
+                DELETE(iter);
             }
         }
         uint64 end_time = get_current_epoch_millis();
@@ -1054,14 +1917,611 @@ OP_NAMESPACE_BEGIN
         k.ns = ns;
         k.key.ToMutableStr();
         k.ns.ToMutableStr();
-        LockGuard<SpinMutexLock> guard(m_expires_lock);
-        m_expires.insert(k);
+        ExpireKeyShard& shard = m_expires[key_lock_hash(key, 0) % kExpireKeyShards];
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        shard.keys.insert(k);
+    }
+
+    void Ardb::AddListCompactKey(const Data& ns, const Data& key)
+    {
+        KeyPrefix k;
+        k.key = key;
+        k.ns = ns;
+        k.key.ToMutableStr();
+        k.ns.ToMutableStr();
+        LockGuard<SpinMutexLock> guard(m_list_compact_lock);
+        m_list_compact_keys.insert(k);
+    }
+
+    /*
+     * Renumber the queued lists until 'max_elements' elements are moved or 50ms passed, the rest are left to the next
+     * cron. A list is always renumbered as a whole, so one larger than the budget is still done in a single call.
+     */
+    int64 Ardb::CompactLists(int64 max_elements)
+    {
+        int64 total_compacted = 0;
+        int64 total_moved = 0;
+        uint64 start_time = get_current_epoch_millis();
+        while (total_moved < max_elements && get_current_epoch_millis() - start_time < 50)
+        {
+            KeyPrefix compact_key;
+            {
+                LockGuard<SpinMutexLock> guard(m_list_compact_lock);
+                if (m_list_compact_keys.empty())
+                {
+                    break;
+                }
+                compact_key = *(m_list_compact_keys.begin());
+                m_list_compact_keys.erase(m_list_compact_keys.begin());
+            }
+            Context compact_ctx;
+            KeyObject key(compact_key.ns, KEY_META, compact_key.key);
+            int moved = ListCompact(compact_ctx, key);
+            if (moved > 0)
+            {
+                total_compacted++;
+                total_moved += moved;
+            }
+        }
+        uint64 end_time = get_current_epoch_millis();
+        if (total_compacted > 0)
+        {
+            INFO_LOG("Cost %llums to compact %lld lists.", (end_time - start_time), total_compacted);
+        }
+        return total_compacted;
+    }
+
+    /*
+     * Remove the meta of a large object now and leave its elements to the reclaimer, the object is queued
+     * in the lazyfree db so that the reclaim survives restarts. Must be called with the key locked.
+     */
+    int Ardb::LazyFreeKey(Context& ctx, const KeyObject& meta_key)
+    {
+        KeyPrefix lk;
+        lk.ns = meta_key.GetNameSpace();
+        lk.key = meta_key.GetKey();
+        lk.ns.ToMutableStr();
+        lk.key.ToMutableStr();
+        int64 now = get_current_epoch_millis();
+        Data lazyfree_ns(LAZYFREE_DB_NAMESPACE, false);
+        KeyObject lazyfree_key(lazyfree_ns, KEY_TTL_SORT, "");
+        lazyfree_key.SetTTL(now);
+        lazyfree_key.SetTTLKeyNamespace(meta_key.GetNameSpace());
+        lazyfree_key.SetTTLKey(meta_key.GetKey().AsString());
+        ValueObject v;
+        v.SetType(KEY_TTL_SORT);
+        int err = 0;
+        {
+            WriteBatchGuard batch(ctx, m_engine);
+            ctx.flags.create_if_notexist = 1;
+            err = m_engine->Put(ctx, lazyfree_key, v);
+            if (0 == err)
+            {
+                err = m_engine->Del(ctx, meta_key);
+            }
+            batch.MarkFailed(err);
+        }
+        if (0 != err)
+        {
+            return err;
+        }
+        LockGuard<SpinMutexLock> guard(m_lazyfree_lock);
+        m_lazyfree_keys[lk] = now;
+        m_lazyfree_key_count = m_lazyfree_keys.size();
+        return 0;
+    }
+
+    /*
+     * Delete at most 'limit'(0 for no limit) elements of a queued object, the object is dequeued once all
+     * its elements are gone. Must be called with the key locked.
+     */
+    int64 Ardb::ReclaimLazyFreeKey(const KeyPrefix& lk, int64 limit)
+    {
+        int64 queued_time = 0;
+        {
+            LockGuard<SpinMutexLock> guard(m_lazyfree_lock);
+            LazyFreeKeyTable::iterator found = m_lazyfree_keys.find(lk);
+            if (found == m_lazyfree_keys.end())
+            {
+                return 0;
+            }
+            queued_time = found->second;
+        }
+        Context reclaim_ctx;
+        KeyObject meta_key(lk.ns, KEY_META, lk.key);
+        int64 removed = 0;
+        bool drained = true;
+        {
+            WriteBatchGuard batch(reclaim_ctx, m_engine);
+            Iterator* iter = m_engine->Find(reclaim_ctx, meta_key);
+            while (NULL != iter && iter->Valid())
+            {
+                KeyObject& k = iter->Key();
+                const Data& kdata = k.GetKey();
+                if (k.GetNameSpace().Compare(meta_key.GetNameSpace()) != 0 || kdata.StringLength() != meta_key.GetKey().StringLength()
+                        || strncmp(meta_key.GetKey().CStr(), kdata.CStr(), kdata.StringLength()) != 0)
+                {
+                    break;
+                }
+                if (limit > 0 && removed >= limit)
+                {
+                    drained = false;
+                    break;
+                }
+                iter->Del();
+                removed++;
+                iter->Next();
+            }
+            DELETE(iter);
+            if (drained)
+            {
+                Data lazyfree_ns(LAZYFREE_DB_NAMESPACE, false);
+                KeyObject lazyfree_key(lazyfree_ns, KEY_TTL_SORT, "");
+                lazyfree_key.SetTTL(queued_time);
+                lazyfree_key.SetTTLKeyNamespace(lk.ns);
+                lazyfree_key.SetTTLKey(lk.key.AsString());
+                m_engine->Del(reclaim_ctx, lazyfree_key);
+            }
+        }
+        if (drained)
+        {
+            LockGuard<SpinMutexLock> guard(m_lazyfree_lock);
+            m_lazyfree_keys.erase(lk);
+            m_lazyfree_key_count = m_lazyfree_keys.size();
+        }
+        return removed;
+    }
+
+    /*
+     * Called right after a key is locked, the elements of a queued object must be gone before the key
+     * is accessed again, or they would show up in a new object with the same name.
+     */
+    void Ardb::FinishLazyFree(const KeyPrefix& lk)
+    {
+        if (0 == m_lazyfree_key_count)
+        {
+            return;
+        }
+        ReclaimLazyFreeKey(lk, 0);
+    }
+
+    /*
+     * Commands reading elements without locking the key(SISMEMBER, SSCAN...) would still see the elements of
+     * a queued object, so the keys of every command are reclaimed under their lock before it runs.
+     */
+    void Ardb::FinishCommandLazyFree(Context& ctx, RedisCommandFrame& args)
+    {
+        if (0 == m_lazyfree_key_count || ctx.keyslocked)
+        {
+            return;
+        }
+        StringArray keys;
+        GetCommandKeys(args, keys);
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            KeyObject key(ctx.ns, KEY_META, keys[i]);
+            KeyPrefix lk;
+            lk.ns = key.GetNameSpace();
+            lk.key = key.GetKey();
+            {
+                LockGuard<SpinMutexLock> guard(m_lazyfree_lock);
+                if (m_lazyfree_keys.count(lk) == 0)
+                {
+                    continue;
+                }
+            }
+            if (IsPipelineBatchKey(ctx, key))
+            {
+                continue;
+            }
+            LockKey(key);
+            UnlockKey(key);
+        }
+    }
+
+    void Ardb::LoadLazyFreeKeys()
+    {
+        Context load_ctx;
+        Data lazyfree_ns(LAZYFREE_DB_NAMESPACE, false);
+        KeyObject start(lazyfree_ns, KEY_TTL_SORT, "");
+        start.SetTTL(0);
+        Iterator* iter = m_engine->Find(load_ctx, start);
+        LockGuard<SpinMutexLock> guard(m_lazyfree_lock);
+        m_lazyfree_keys.clear();
+        while (NULL != iter && iter->Valid())
+        {
+            KeyObject& k = iter->Key(true);
+            if (k.GetType() != KEY_TTL_SORT)
+            {
+                break;
+            }
+            KeyPrefix lk;
+            lk.ns = k.GetElement(1);
+            lk.key = k.GetElement(2);
+            lk.ns.ToMutableStr();
+            lk.key.ToMutableStr();
+            m_lazyfree_keys[lk] = k.GetTTL();
+            iter->Next();
+        }
+        DELETE(iter);
+        m_lazyfree_key_count = m_lazyfree_keys.size();
+        if (m_lazyfree_key_count > 0)
+        {
+            INFO_LOG("%u large objects left to reclaim.", m_lazyfree_key_count);
+        }
+    }
+
+    static const uint64 kObjectIdBlock = 1024 * 1024;
+
+    /*
+     * The limit of reserved object ids is kept as the meta of the empty key in the ttl db, which every data
+     * copy of the engine(checkpoints, backups) carries along.
+     */
+    static KeyObject object_id_limit_key()
+    {
+        Data ttl_ns(TTL_DB_NSMAESPACE, false);
+        return KeyObject(ttl_ns, KEY_META, "");
+    }
+
+    void Ardb::LoadObjectIds()
+    {
+        Context ctx;
+        ValueObject limit;
+        uint64 saved_limit = 0;
+        if (0 == m_engine->Get(ctx, object_id_limit_key(), limit) && limit.GetType() == KEY_STRING
+                && limit.GetStringValue().IsInteger())
+        {
+            saved_limit = (uint64) limit.GetStringValue().GetInt64();
+        }
+        bool enabled = GetConf().hash_object_id || saved_limit > 0;
+        if (enabled && get_key_codec_version() != KEY_CODEC_V2)
+        {
+            WARN_LOG("'hash-object-id' needs key codec version 2, hashes are created without object ids.");
+            enabled = false;
+        }
+        else if (saved_limit > 0 && !GetConf().hash_object_id)
+        {
+            INFO_LOG("Hashes keyed by object ids exist, new hashes also get object ids.");
+        }
+        {
+            LockGuard<SpinMutexLock> guard(m_object_id_lock);
+            if (saved_limit > m_next_object_id)
+            {
+                m_next_object_id = saved_limit;
+            }
+            m_object_id_limit = m_next_object_id;
+        }
+        m_object_id_enabled = enabled;
+        ReserveObjectIds();
+    }
+
+    /*
+     * Save a new limit once less than half a block of ids is left, run by the slow cron and called by no
+     * command, a write here would otherwise join the write batch of the command.
+     */
+    /*
+     * Run by the slow cron. After a peak(large replies, snapshot loads) the freed pages stay in the RSS, once the
+     * resident pages exceed the bytes in use by 'mem-purge-fragmentation-percent' with at least 'mem-purge-min-dirty'
+     * of unused ones, the unused pages of all arenas & the shared blocks of the buffer pool go back to the OS.
+     */
+    void Ardb::PurgeFragmentedMemory()
+    {
+        if (GetConf().mem_purge_fragmentation_percent <= 0)
+        {
+            return;
+        }
+        MallocFragStats stats;
+        if (!malloc_frag_stats(stats) || 0 == stats.allocated)
+        {
+            return;
+        }
+        if (stats.resident * 100 < stats.allocated * (uint64) GetConf().mem_purge_fragmentation_percent
+                || stats.dirty < (uint64) GetConf().mem_purge_min_dirty)
+        {
+            return;
+        }
+        BufferPool::ReleaseShared();
+        malloc_purge_all();
+        MallocFragStats purged;
+        malloc_frag_stats(purged);
+        uint64 reclaimed = stats.resident > purged.resident ? stats.resident - purged.resident : 0;
+        atomic_add_uint64(&m_mem_purges, 1);
+        atomic_add_uint64(&m_mem_purged_bytes, reclaimed);
+        INFO_LOG("Purged %llu bytes of unused pages, resident:%llu allocated:%llu", (unsigned long long) reclaimed,
+                (unsigned long long) purged.resident, (unsigned long long) purged.allocated);
+    }
+
+    /*
+     * Run by the refresh cron of a read replica. Commands are fenced while the engine reopens the files of the owning
+     * instance, the refresh is retried at the next period if they do not drain in time. The key cache of db 0 is
+     * rebuilt in the background once the data moved.
+     */
+#define READ_REPLICA_FENCE_TIMEOUT 1000
+    void Ardb::RefreshReadReplica()
+    {
+        if (!m_read_replica || m_keycache_loading)
+        {
+            return;
+        }
+        int64_t seq = m_engine->GetLatestSequence();
+        if (!RaiseWriteFence(READ_REPLICA_FENCE_TIMEOUT))
+        {
+            atomic_add_uint64(&m_replica_refresh_skips, 1);
+            return;
+        }
+        Context ctx;
+        int err = m_engine->Refresh(ctx);
+        LowerWriteFence();
+        if (0 != err)
+        {
+            atomic_add_uint64(&m_replica_refresh_skips, 1);
+            if (ERR_NOTPERFORMED != err)
+            {
+                WARN_LOG("Failed to refresh read replica engine with error:%d", err);
+            }
+            return;
+        }
+        atomic_add_uint64(&m_replica_refreshes, 1);
+        m_replica_refresh_time = get_current_epoch_millis();
+        if (seq != m_engine->GetLatestSequence())
+        {
+            StopKeyCacheLoader();
+            m_key_cache->DropAll();
+            StartKeyCacheLoader();
+        }
+    }
+
+    void Ardb::ReserveObjectIds()
+    {
+        if (!m_object_id_enabled)
+        {
+            return;
+        }
+        uint64 new_limit = 0;
+        {
+            LockGuard<SpinMutexLock> guard(m_object_id_lock);
+            if (m_object_id_limit - m_next_object_id >= kObjectIdBlock / 2)
+            {
+                return;
+            }
+            new_limit = m_next_object_id + kObjectIdBlock;
+        }
+        Context ctx;
+        ctx.flags.create_if_notexist = 1;
+        ValueObject limit;
+        limit.SetType(KEY_STRING);
+        limit.GetStringValue().SetInt64((int64) new_limit);
+        int err = m_engine->Put(ctx, object_id_limit_key(), limit);
+        if (0 != err)
+        {
+            ERROR_LOG("Failed to save object id limit:%llu with err:%d", new_limit, err);
+            return;
+        }
+        LockGuard<SpinMutexLock> guard(m_object_id_lock);
+        if (new_limit > m_object_id_limit)
+        {
+            m_object_id_limit = new_limit;
+        }
+    }
+
+    /*
+     * 0 if no id is left until the cron reserves more, the object is then created without id.
+     */
+    uint64 Ardb::AllocObjectId()
+    {
+        LockGuard<SpinMutexLock> guard(m_object_id_lock);
+        if (m_next_object_id >= m_object_id_limit)
+        {
+            return 0;
+        }
+        return m_next_object_id++;
+    }
+
+    /*
+     * Ids written into the engine by data loads must never be handed out again.
+     */
+    void Ardb::ObserveObjectId(uint64 id)
+    {
+        LockGuard<SpinMutexLock> guard(m_object_id_lock);
+        if (id >= m_next_object_id)
+        {
+            m_next_object_id = id + 1;
+            if (m_next_object_id > m_object_id_limit)
+            {
+                m_object_id_limit = m_next_object_id;
+            }
+        }
+        m_object_id_enabled = true;
+    }
+
+    /*
+     * Run by the lazyfree cron every 100ms, spends at most half of the period deleting elements in
+     * batches of 'lazyfree-batch-size', the key is unlocked between batches.
+     */
+    /*
+     * Rough engine bytes(tombstone & WAL record) written per reclaimed element, charged to the background io budget.
+     */
+    static const int64 kLazyFreeDeleteBytes = 64;
+
+    int64 Ardb::ReclaimLazyFreeKeys()
+    {
+        if (0 == m_lazyfree_key_count)
+        {
+            return 0;
+        }
+        int64 batch_size = GetConf().lazyfree_batch_size > 0 ? GetConf().lazyfree_batch_size : 1;
+        int64 total_removed = 0;
+        uint64 start_time = get_current_epoch_millis();
+        while (get_current_epoch_millis() - start_time < 50)
+        {
+            KeyPrefix lk;
+            {
+                LockGuard<SpinMutexLock> guard(m_lazyfree_lock);
+                if (m_lazyfree_keys.empty())
+                {
+                    break;
+                }
+                lk = m_lazyfree_keys.begin()->first;
+            }
+            LockKey(lk);
+            int64 removed = ReclaimLazyFreeKey(lk, batch_size);
+            UnlockKey(lk);
+            total_removed += removed;
+            BackgroundJobs::GetSingleton().Request(removed * kLazyFreeDeleteBytes);
+        }
+        return total_removed;
+    }
+
+    /*
+     * Entries of a flushed namespace in the ttl db would otherwise stay until they expire, the purge starts over
+     * from the first entry.
+     */
+    void Ardb::AddFlushedNameSpace(const Data& ns)
+    {
+        if (ns.AsString() == TTL_DB_NSMAESPACE)
+        {
+            return;
+        }
+        Data flushed_ns = ns;
+        flushed_ns.ToMutableStr();
+        LockGuard<SpinMutexLock> guard(m_flushed_lock);
+        m_flushed_nss.insert(flushed_ns);
+        m_flushed_ns_count = m_flushed_nss.size();
+        m_ttl_purge_ttl = 0;
+        m_ttl_purge_ns.Clear();
+        m_ttl_purge_key.clear();
+        m_ttl_purge_version++;
+    }
+
+    static const uint32 kTTLPurgeScanKeys = 10000;
+
+    /*
+     * Destroys the data of one namespace detached by FLUSHDB/FLUSHALL ASYNC, then removes the ttl entries of the
+     * flushed namespaces whose keys are gone, at most 'kTTLPurgeScanKeys' entries are visited per call.
+     */
+    int64 Ardb::ReclaimFlushedData()
+    {
+        Context purge_ctx;
+        m_engine->ReclaimDetachedNameSpaces(purge_ctx);
+        if (0 == m_flushed_ns_count)
+        {
+            return 0;
+        }
+        DataSet nss;
+        uint64 version = 0;
+        Data ttl_ns(TTL_DB_NSMAESPACE, false);
+        KeyObject start(ttl_ns, KEY_TTL_SORT, "");
+        {
+            LockGuard<SpinMutexLock> guard(m_flushed_lock);
+            nss = m_flushed_nss;
+            version = m_ttl_purge_version;
+            start.SetTTL(m_ttl_purge_ttl);
+            if (!m_ttl_purge_ns.IsNil())
+            {
+                start.SetTTLKeyNamespace(m_ttl_purge_ns);
+                start.SetTTLKey(m_ttl_purge_key);
+            }
+        }
+        KeyObjectArray orphans;
+        uint32 visited = 0;
+        bool exhausted = true;
+        int64 next_ttl = 0;
+        Data next_ns;
+        std::string next_key;
+        Iterator* iter = m_engine->Find(purge_ctx, start);
+        while (NULL != iter && iter->Valid())
+        {
+            KeyObject& k = iter->Key(true);
+            if (k.GetType() != KEY_TTL_SORT)
+            {
+                break;
+            }
+            if (visited >= kTTLPurgeScanKeys)
+            {
+                exhausted = false;
+                next_ttl = k.GetTTL();
+                next_ns = k.GetElement(1);
+                next_ns.ToMutableStr();
+                next_key = k.GetElement(2).AsString();
+                break;
+            }
+            visited++;
+            if (nss.count(k.GetElement(1)) > 0)
+            {
+                orphans.push_back(k);
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        int64 removed = 0;
+        for (size_t i = 0; i < orphans.size(); i++)
+        {
+            KeyObject& ttl_key = orphans[i];
+            KeyPrefix lk;
+            lk.ns = ttl_key.GetElement(1);
+            lk.key = ttl_key.GetElement(2);
+            LockKey(lk);
+            KeyObject meta_key(lk.ns, KEY_META, lk.key);
+            ValueObject meta;
+            int err = m_engine->Get(purge_ctx, meta_key, meta);
+            /*
+             * a key written into the namespace after the flush keeps its entry, field ttls are left to the
+             * expiry of their hash.
+             */
+            if (ERR_ENTRY_NOT_EXIST == err || (0 == err && !ttl_key.IsFieldTTL() && meta.GetTTL() != ttl_key.GetTTL()))
+            {
+                m_engine->Del(purge_ctx, ttl_key);
+                removed++;
+            }
+            UnlockKey(lk);
+        }
+        BackgroundJobs::GetSingleton().Request(removed * kLazyFreeDeleteBytes);
+        LockGuard<SpinMutexLock> guard(m_flushed_lock);
+        if (version == m_ttl_purge_version)
+        {
+            if (exhausted)
+            {
+                INFO_LOG("Purged ttl entries of %u flushed namespaces.", m_flushed_nss.size());
+                m_flushed_nss.clear();
+                m_flushed_ns_count = 0;
+                m_ttl_purge_ttl = 0;
+                m_ttl_purge_ns.Clear();
+                m_ttl_purge_key.clear();
+            }
+            else
+            {
+                m_ttl_purge_ttl = next_ttl;
+                m_ttl_purge_ns = next_ns;
+                m_ttl_purge_key = next_key;
+            }
+        }
+        return removed;
     }
 
+    /*
+     * With 'scan-cursor-stateless' the cursor is the next element itself, snappy compressed & base64 encoded behind
+     * a 's' so it never parses as a number. Any thread, restarted server or replica could resume from it.
+     */
+    static const char kStatelessCursorPrefix = 's';
+
     int Ardb::FindElementByRedisCursor(const std::string& cursor, std::string& element)
     {
         uint64 cursor_int = 0;
         element.clear();
+        if (GetConf().scan_cursor_stateless && cursor.size() > 1 && cursor[0] == kStatelessCursorPrefix)
+        {
+            std::string compressed;
+            size_t raw_len = 0;
+            if (base64_decode(cursor.substr(1), compressed) && snappy::GetUncompressedLength(compressed.data(), compressed.size(), &raw_len))
+            {
+                element.resize(raw_len);
+                if (snappy::RawUncompress(compressed.data(), compressed.size(), &element[0]))
+                {
+                    return 0;
+                }
+            }
+            element.clear();
+        }
         if (!string_touint64(cursor, cursor_int))
         {
             element = cursor;
@@ -1074,13 +2534,23 @@ OP_NAMESPACE_BEGIN
         LockGuard<SpinMutexLock> guard(m_redis_cursor_lock);
         return m_redis_cursor_cache.Get(cursor_int, element) ? 0 : -1;
     }
-    uint64 Ardb::GetNewRedisCursor(const std::string& element)
+    std::string Ardb::GetNewRedisCursor(const std::string& element)
     {
+        if (GetConf().scan_cursor_stateless)
+        {
+            std::string compressed, cursor;
+            size_t compressed_len = 0;
+            compressed.resize(snappy::MaxCompressedLength(element.size()));
+            snappy::RawCompress(element.data(), element.size(), &compressed[0], &compressed_len);
+            base64_encode(compressed.data(), compressed_len, cursor);
+            cursor.insert(0, 1, kStatelessCursorPrefix);
+            return cursor;
+        }
         LockGuard<SpinMutexLock> guard(m_redis_cursor_lock);
         m_redis_cursor_seed++;
         RedisCursorCache::CacheEntry entry;
         m_redis_cursor_cache.Insert(m_redis_cursor_seed, element, entry);
-        return m_redis_cursor_seed;
+        return stringfromll(m_redis_cursor_seed);
     }
 
     bool Ardb::GetLongFromProtocol(Context& ctx, const std::string& str, int64_t& v)
@@ -1099,21 +2569,94 @@ OP_NAMESPACE_BEGIN
         return true;
     }
 
-    bool Ardb::CheckMeta(Context& ctx, const std::string& key, KeyType expected)
+    /*
+     * Reading a whole large object is a one pass scan, which should not evict hot data from the engine's block cache.
+     */
+    void Ardb::CheckStreamIterate(int64 elements, IterateOptions& options)
     {
-        ValueObject meta_value;
-        return CheckMeta(ctx, key, expected, meta_value);
+        int64 threshold = GetConf().stream_iterate_threshold;
+        options.streaming = threshold > 0 && elements >= threshold;
     }
 
-    bool Ardb::CheckMeta(Context& ctx, const std::string& key, KeyType expected, ValueObject& meta_value)
-    {
-        KeyObject meta_key(ctx.ns, KEY_META, key);
-        return CheckMeta(ctx, meta_key, expected, meta_value);
-    }
+    /*
+     * Members per chunk of a streamed array reply, and the output bytes a streaming command leaves unsent
+     * before it waits for the client to read.
+     */
+#define STREAM_REPLY_CHUNK_MEMBERS  1024
+#define STREAM_REPLY_BUFFER_LIMIT   (4 * 1024 * 1024)
+#define STREAM_REPLY_WAIT_MILLIS    1000
 
-    bool Ardb::CheckMeta(Context& ctx, const KeyObject& key, KeyType expected, ValueObject& meta, bool fetch)
+    bool Ardb::BeginStreamReply(Context& ctx, RedisReply& reply, int64 count)
     {
-        RedisReply& reply = ctx.GetReply();
+        int64 threshold = GetConf().stream_reply_threshold;
+        if ((threshold <= 0 || count < threshold) && !ctx.flags.stream_reply)
+        {
+            return false;
+        }
+        if (count <= 0 || !reply.IsPooled() || ctx.flags.lua)
+        {
+            return false;
+        }
+        if (NULL == ctx.client || NULL == ctx.client->client || !ctx.client->client->GetService().IsInLoopThread())
+        {
+            return false;
+        }
+        reply.ReserveMember(0);
+        reply.integer = count;
+        reply.streamed = 0;
+        reply.chunk_flag = STREAM_CHUNK_FLAG | FIRST_CHUNK_FLAG;
+        return true;
+    }
+
+    void Ardb::StreamReplyMembers(Context& ctx, RedisReply& reply)
+    {
+        if (!(reply.chunk_flag & STREAM_CHUNK_FLAG) || reply.MemberSize() < STREAM_REPLY_CHUNK_MEMBERS)
+        {
+            return;
+        }
+        if (reply.chunk_flag & DISCARD_CHUNK_FLAG)
+        {
+            reply.streamed += reply.MemberSize();
+            reply.ReleaseMembers();
+            return;
+        }
+        Channel* ch = ctx.client->client;
+        if (!RedisReplyEncoder::WriteStreamChunk(ch, reply))
+        {
+            reply.chunk_flag |= DISCARD_CHUNK_FLAG;
+            return;
+        }
+        if (reply.chunk_flag & NOWAIT_CHUNK_FLAG)
+        {
+            return;
+        }
+        int ret = ch->DrainOutput(STREAM_REPLY_BUFFER_LIMIT, STREAM_REPLY_WAIT_MILLIS);
+        if (ret < 0)
+        {
+            reply.chunk_flag |= DISCARD_CHUNK_FLAG;
+        }
+        else if (ret == 0)
+        {
+            //the client is too slow, buffer the rest members instead of blocking the event loop any longer
+            reply.chunk_flag |= NOWAIT_CHUNK_FLAG;
+        }
+    }
+
+    bool Ardb::CheckMeta(Context& ctx, const std::string& key, KeyType expected)
+    {
+        ValueObject meta_value;
+        return CheckMeta(ctx, key, expected, meta_value);
+    }
+
+    bool Ardb::CheckMeta(Context& ctx, const std::string& key, KeyType expected, ValueObject& meta_value)
+    {
+        KeyObject meta_key(ctx.ns, KEY_META, key);
+        return CheckMeta(ctx, meta_key, expected, meta_value);
+    }
+
+    bool Ardb::CheckMeta(Context& ctx, const KeyObject& key, KeyType expected, ValueObject& meta, bool fetch)
+    {
+        RedisReply& reply = ctx.GetReply();
         int err = 0;
         if (fetch)
         {
@@ -1133,11 +2676,14 @@ OP_NAMESPACE_BEGIN
             }
             if (meta.GetTTL() > 0 && meta.GetTTL() < get_current_epoch_millis())
             {
-                if (GetConf().master_host.empty() || !GetConf().slave_readonly)
+                /*
+                 * snapshot reads never write, expired keys would be removed by the expire scanner later
+                 */
+                if (!ctx.flags.snapshot_read && (GetConf().master_host.empty() || !GetConf().slave_readonly))
                 {
                     KeyLockGuard keylocker(ctx, key, ctx.keyslocked ? false : true);
                     int old_dirty = ctx.dirty;
-                    if (meta.GetType() == KEY_STRING)
+                    if (meta.GetType() == KEY_STRING && !meta.IsChunked())
                     {
                         RemoveKey(ctx, key);
                     }
@@ -1157,6 +2703,10 @@ OP_NAMESPACE_BEGIN
                 meta.Clear();
                 return true;
             }
+            if (ctx.flags.hotkey_sampled && meta.GetType() != KEY_STRING && HotKeyTracker::GetSingleton().IsBigKey(meta.GetObjectLen()))
+            {
+                HotKeyTracker::GetSingleton().AddBigKey(key.GetNameSpace().AsString(), key.GetKey().AsString(), meta.GetType(), meta.GetObjectLen());
+            }
         }
         return true;
     }
@@ -1168,229 +2718,808 @@ OP_NAMESPACE_BEGIN
         {
             if (!ch->Write(*r))
             {
-                ch->Close();
+                ch->Close();
+            }
+        }
+        DELETE(r);
+    }
+
+    int Ardb::WriteReply(Context& ctx, RedisReply* r, bool async)
+    {
+        if (NULL == ctx.client || NULL == ctx.client->client || NULL == r)
+        {
+            if (async)
+            {
+                DELETE(r);
+            }
+            return -1;
+        }
+        Channel* ch = ctx.client->client;
+        if (!async)
+        {
+            ch->Write(*r);
+        }
+        else
+        {
+            ch->GetService().AsyncIO(ch->GetID(), async_write_reply_callback, r);
+        }
+        return 0;
+    }
+
+    void Ardb::FreeClient(Context& ctx)
+    {
+        UnwatchKeys(ctx);
+        UnsubscribeAll(ctx, true, false);
+        UnsubscribeAll(ctx, false, false);
+        DisableTracking(ctx);
+        if (NULL != ctx.client)
+        {
+            LockGuard<SpinMutexLock> guard(m_clients_lock);
+            m_all_clients.Remove(ctx.client);
+        }
+        UnblockKeys(ctx, true);
+        if (NULL != g_repl)
+        {
+            g_repl->GetMaster().CancelAckWait(ctx);
+        }
+        if (MarkRestoring(ctx, false))
+        {
+            m_engine->EndBulkIngest(ctx, ctx.ns, false);
+        }
+        {
+            WriteLockGuard<BigReaderLock> guard(m_monitors_lock);
+            if (NULL != m_monitors)
+            {
+                MonitorTable::iterator found = m_monitors->find(&ctx);
+                if (found != m_monitors->end())
+                {
+                    ReleaseMonitorFeed(found->second);
+                    m_monitors->erase(found);
+                }
+                if (m_monitors->empty())
+                {
+                    DELETE(m_monitors);
+                }
+            }
+        }
+    }
+
+    /*
+     * Enforces the idle(tcp-keepalive) & blocking timeouts of one client, executed by its connection's timer
+     * in the client's event loop thread. Returns the next time(micros) the client needs to be checked, 0 if
+     * none, -1 if the client is closed.
+     */
+    int64 Ardb::ClientCron(Context& ctx)
+    {
+        bool blocking = ctx.IsBlocking();
+        if (NULL == ctx.client || (!blocking && GetConf().tcp_keepalive <= 0))
+        {
+            return 0;
+        }
+        int64 now = get_current_epoch_micros();
+        int64 next = 0;
+        if (blocking && ctx.GetBPop().timeout > 0)
+        {
+            /*
+             * a client already served by a pushed element gets its reply posted instead
+             */
+            if (now >= (int64) ctx.GetBPop().timeout)
+            {
+                if (atomic_cmp_set_uint32(&ctx.GetBPop().served, 0, 1))
+                {
+                    RedisReply empty_bulk;
+                    empty_bulk.ReserveMember(-1);
+                    ctx.client->client->Write(empty_bulk);
+                    UnblockKeys(ctx, true);
+                }
+            }
+            else
+            {
+                next = ctx.GetBPop().timeout;
+            }
+        }
+        if (GetConf().tcp_keepalive > 0 && !blocking && !ctx.IsSubscribed())
+        {
+            int64 deadline = ctx.client->last_interaction_ustime + GetConf().tcp_keepalive * 1000 * 1000;
+            if (now >= deadline)
+            {
+                ctx.client->client->Close();
+                return -1;
+            }
+            if (0 == next || deadline < next)
+            {
+                next = deadline;
+            }
+        }
+        else if (0 == next && blocking && GetConf().tcp_keepalive > 0)
+        {
+            /*
+             * served by a pushed element without a new command, check the idle time again later
+             */
+            next = now + GetConf().tcp_keepalive * 1000 * 1000;
+        }
+        return next;
+    }
+
+    void Ardb::AddClient(Context& ctx)
+    {
+        if (NULL != ctx.client)
+        {
+            LockGuard<SpinMutexLock> guard(m_clients_lock);
+            m_all_clients.Add(ctx.client);
+        }
+    }
+
+    /*
+     * Returns false for clients bound to the state of their event loop thread (transaction, pubsub,
+     * blocking, monitor, replication), their connections are never moved to another thread.
+     */
+    bool Ardb::CanMigrateClient(Context& ctx)
+    {
+        if (NULL == ctx.client || NULL != ctx.transc || ctx.IsSubscribed() || ctx.IsBlocking() || ctx.flags.slave)
+        {
+            return false;
+        }
+        {
+            ReadLockGuard<BigReaderLock> guard(m_monitors_lock);
+            if (NULL != m_monitors && m_monitors->count(&ctx) > 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Ardb::IsLoadingData()
+    {
+        return g_repl->GetSlave().IsLoading() || m_loading_data;
+    }
+
+    int Ardb::DoCall(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& args)
+    {
+        uint64 start_time = get_current_epoch_micros();
+        uint64 start_skipped_deletes = m_engine->GetThreadSkippedDeletes();
+        /*
+         * 1. commands recv from slave replication connection always in incompatible mode
+         * 2. command type > REDIS_CMD_EXTEND_BEGIN
+         * 3. configuration 'redis_compatible = no'
+         */
+        if ((args.GetType() < REDIS_CMD_EXTEND_BEGIN && GetConf().redis_compatible) || ctx.flags.slave)
+        {
+            ctx.flags.redis_compatible = 1;
+        }
+        else
+        {
+            ctx.flags.redis_compatible = 0;
+        }
+        if (NULL != ctx.client)
+        {
+            ctx.client->last_interaction_ustime = start_time;
+        }
+        ctx.last_cmdtype = setting.type;
+        ARDB_PROBE4(command__start, setting.type, ctx.ns.CStr(), ctx.ns.StringLength(),
+                args.GetArguments().empty() ? 0 : args.GetArguments()[0].size());
+
+        if (NULL != m_monitors && !IsLoadingData() && !(setting.flags & (ARDB_CMD_SKIP_MONITOR | ARDB_CMD_ADMIN)))
+        {
+            /*
+             * feed monitors
+             */
+            FeedMonitors(ctx, ctx.ns, args);
+        }
+
+        FinishCommandLazyFree(ctx, args);
+        /*
+         * lock free read commands run under engine snapshot instead of key locks if engine supports
+         */
+        bool snapshot_read = false;
+        if ((setting.flags & ARDB_CMD_LOCKFREE_READ) && !ctx.flags.snapshot_read && !ctx.keyslocked && m_engine->GetFeatureSet().support_snapshot_read)
+        {
+            snapshot_read = (0 == m_engine->BeginSnapshotRead(ctx));
+            ctx.flags.snapshot_read = snapshot_read ? 1 : 0;
+        }
+        /*
+         * commands called by this one(EXEC, scripts on this context) are profiled on their own & added to this one
+         */
+        EngineProfile outer_profile, call_profile;
+        EngineProfile* outer_current = NULL;
+        if (g_engine_profiling)
+        {
+            outer_profile = ctx.profile;
+            ctx.profile.Clear();
+            outer_current = CurrentEngineProfile();
+            CurrentEngineProfile() = &ctx.profile;
+        }
+        /*
+         * sampled commands feed their keys to the hot key tracker & let CheckMeta record the big keys they read
+         */
+        unsigned outer_hotkey_sampled = ctx.flags.hotkey_sampled;
+        ctx.flags.hotkey_sampled = 0;
+        if (!(setting.flags & ARDB_CMD_ADMIN) && HotKeyTracker::GetSingleton().Sample())
+        {
+            ctx.flags.hotkey_sampled = 1;
+            StringArray keys;
+            GetCommandKeys(args, keys);
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                HotKeyTracker::GetSingleton().AddHit(ctx.ns.AsString(), keys[i]);
+            }
+        }
+        int ret = (this->*(setting.handler))(ctx, args);
+        ctx.flags.hotkey_sampled = outer_hotkey_sampled;
+        if (snapshot_read)
+        {
+            ctx.flags.snapshot_read = 0;
+            m_engine->EndSnapshotRead(ctx);
+        }
+        if (g_engine_profiling)
+        {
+            CurrentEngineProfile() = outer_current;
+            setting.engine_profile->Add(ctx.profile);
+            call_profile = ctx.profile;
+            outer_profile.Add(ctx.profile);
+            ctx.profile = outer_profile;
+        }
+        if (!ctx.flags.lua)
+        {
+            uint64 stop_time = get_current_epoch_micros();
+            ARDB_PROBE5(command__done, setting.type, ctx.ns.CStr(), ctx.ns.StringLength(),
+                    args.GetArguments().empty() ? 0 : args.GetArguments()[0].size(), stop_time - start_time);
+            setting.cost_track->AddCost((stop_time - start_time));
+            int64 slow_budget = GetConf().slow_command_budget;
+            if (slow_budget > 0)
+            {
+                /*
+                 * hysteresis: only a cheap call in the slow command pool moves the command back
+                 */
+                if (ctx.flags.slow_command)
+                {
+                    if (setting.slow && stop_time - start_time < (uint64) slow_budget / 4)
+                    {
+                        setting.slow = false;
+                    }
+                }
+                else if (!setting.slow && stop_time - start_time > (uint64) slow_budget)
+                {
+                    setting.slow = true;
+                }
+            }
+            if (!(setting.flags & ARDB_CMD_ADMIN))
+            {
+                BackgroundJobs::GetSingleton().AddForegroundLatency(stop_time - start_time);
+            }
+            int64 actual_cost = 0;
+            if (ctx.cost_estimate > 0)
+            {
+                RedisReply& creply = ctx.GetReply();
+                if (creply.chunk_flag & STREAM_CHUNK_FLAG)
+                {
+                    actual_cost = creply.integer;
+                }
+                else if (creply.type == REDIS_REPLY_ARRAY)
+                {
+                    actual_cost = creply.MemberSize();
+                }
+                else
+                {
+                    actual_cost = creply.type == REDIS_REPLY_INTEGER ? creply.integer : 1;
+                }
+            }
+            TryPushSlowCommand(args, stop_time - start_time, m_engine->GetThreadSkippedDeletes() - start_skipped_deletes,
+                    g_engine_profiling ? &call_profile : NULL, ctx.cost_estimate, actual_cost);
+            DEBUG_LOG("Process recved cmd cost %lluus", stop_time - start_time);
+        }
+
+        /*
+         * Sometimes read only command may modify the key/value pair, do NOT propagate it to replication log
+         */
+        if (!ctx.flags.no_wal && ctx.dirty > 0 && setting.IsWriteCommand())
+        {
+            FeedReplicationBacklog(ctx, ctx.ns, args);
+        }
+
+        return ret;
+    }
+
+    Ardb::RedisCommandHandlerSetting* Ardb::FindRedisCommandHandlerSetting(RedisCommandFrame& args)
+    {
+        std::string& cmd = args.GetMutableCommand();
+        RedisCommandType type = args.GetType();
+        if (type > REDIS_CMD_INVALID && type < REDIS_CMD_MAX && NULL != m_settings_by_type[type])
+        {
+            /*
+             * type resolved while decoding, verify the name since some internal frames carry a type of another command
+             */
+            const std::string& name = *(m_command_names_by_type[type]);
+            if (name.size() == cmd.size() && strncasecmp(name.data(), cmd.data(), cmd.size()) == 0)
+            {
+                lower_string(cmd);
+                return m_settings_by_type[type];
+            }
+        }
+        lower_string(cmd);
+        RedisCommandHandlerSettingTable::iterator found = m_settings.find(cmd);
+        if (found == m_settings.end())
+        {
+            return NULL;
+        }
+        args.SetType(found->second.type);
+        return &(found->second);
+    }
+
+    struct ResumeOverloadConnection: public Runnable
+    {
+            ChannelService& chs;
+            uint32 channle_id;
+            ResumeOverloadConnection(ChannelService& serv, uint32 id) :
+                    chs(serv), channle_id(id)
+            {
+            }
+            void Run()
+            {
+                Channel* ch = chs.GetChannel(channle_id);
+                if (NULL != ch)
+                {
+                    ch->AttachFD();
+                }
+            }
+    };
+
+    /*
+     * Commands which only touch the storage engine could be executed outside the event loop thread,
+     * connection state changing commands(admin/pubsub/blocking/transaction/script) are always executed inline.
+     */
+    bool Ardb::IsEngineIOCommand(Context& ctx, RedisCommandFrame& args, bool& is_write)
+    {
+        if (!ctx.authenticated || ctx.InTransaction() || ctx.IsSubscribed())
+        {
+            return false;
+        }
+        RedisCommandHandlerSetting* found = FindRedisCommandHandlerSetting(args);
+        if (NULL == found)
+        {
+            return false;
+        }
+        if ((found->flags & (ARDB_CMD_WRITE | ARDB_CMD_READONLY)) == 0 || (found->flags & (ARDB_CMD_ADMIN | ARDB_CMD_PUBSUB | ARDB_CMD_NOSCRIPT)) > 0)
+        {
+            return false;
+        }
+        is_write = found->IsWriteCommand();
+        return true;
+    }
+
+    /*
+     * Actions of 'command-cost-limits' on a command of a client estimated over the limit of its command.
+     */
+#define COMMAND_COST_REJECT  1
+#define COMMAND_COST_STREAM  2
+#define COMMAND_COST_SLOW    3
+
+    /*
+     * Commands flagged 'H', the ones marked by Call for exceeding 'slow-command-budget' & the ones estimated over their
+     * 'slow' limit of 'command-cost-limits' run in the slow command pool.
+     */
+    bool Ardb::IsSlowCommand(Context& ctx, RedisCommandFrame& args)
+    {
+        bool is_write = false;
+        if (!IsEngineIOCommand(ctx, args, is_write))
+        {
+            return false;
+        }
+        RedisCommandHandlerSetting* found = FindRedisCommandHandlerSetting(args);
+        if (NULL == found)
+        {
+            return false;
+        }
+        if ((found->flags & ARDB_CMD_SLOW) > 0 || found->slow)
+        {
+            return true;
+        }
+        if (found->cost_action == COMMAND_COST_SLOW && !ctx.InTransaction() && EstimateCommandCost(ctx, *found, args) > found->cost_limit)
+        {
+            atomic_add_uint64(&m_cost_rerouted, 1);
+            return true;
+        }
+        return false;
+    }
+
+    /*
+     * 'command-cost-limits' are set on the command settings once at start, by the original command names.
+     */
+    void Ardb::ApplyCommandCostLimits()
+    {
+        std::vector<std::string> limits = split_string(GetConf().command_cost_limits, ",");
+        for (size_t i = 0; i < limits.size(); i++)
+        {
+            std::string limit = trim_string(limits[i]);
+            if (limit.empty())
+            {
+                continue;
+            }
+            std::vector<std::string> parts = split_string(limit, ":");
+            int64 elements = 0;
+            int action = COMMAND_COST_REJECT;
+            if ((parts.size() != 2 && parts.size() != 3) || !string_toint64(trim_string(parts[1]), elements) || elements <= 0)
+            {
+                WARN_LOG("Invalid command-cost-limits entry:%s", limit.c_str());
+                continue;
+            }
+            if (parts.size() == 3)
+            {
+                std::string name = string_tolower(trim_string(parts[2]));
+                if (name == "stream")
+                {
+                    action = COMMAND_COST_STREAM;
+                }
+                else if (name == "slow")
+                {
+                    action = COMMAND_COST_SLOW;
+                }
+                else if (name != "reject")
+                {
+                    WARN_LOG("Invalid action:%s of command-cost-limits entry:%s", name.c_str(), limit.c_str());
+                    continue;
+                }
+            }
+            std::string cmd = trim_string(parts[0]);
+            bool found = false;
+            RedisCommandHandlerSettingTable::iterator it = m_settings.begin();
+            while (it != m_settings.end())
+            {
+                if (!strcasecmp(it->second.name, cmd.c_str()))
+                {
+                    it->second.cost_limit = elements;
+                    it->second.cost_action = action;
+                    found = true;
+                }
+                it++;
+            }
+            if (!found)
+            {
+                WARN_LOG("Unknown command:%s in command-cost-limits.", cmd.c_str());
             }
         }
-        DELETE(r);
     }
 
-    int Ardb::WriteReply(Context& ctx, RedisReply* r, bool async)
+    /*
+     * Elements a command is expected to return: the length in the meta of every key(1 for a string), bounded by the
+     * range of an index range read, or the key cache size for KEYS. Expired keys are counted as the meta is not
+     * checked, it is only an upper bound used before running the command.
+     */
+    int64 Ardb::EstimateCommandCost(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& args)
     {
-        if (NULL == ctx.client || NULL == ctx.client->client || NULL == r)
+        if (setting.type == REDIS_CMD_KEYS || setting.type == REDIS_CMD_KEYSCOUNT)
         {
-            if (async)
+            return NULL != m_key_cache ? m_key_cache->size() : 0;
+        }
+        StringArray keys;
+        GetCommandKeys(args, keys);
+        int64 cost = 0;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            KeyObject key(ctx.ns, KEY_META, keys[i]);
+            ValueObject meta;
+            if (0 != m_engine->Get(ctx, key, meta) || 0 == meta.GetType())
             {
-                DELETE(r);
+                continue;
             }
-            return -1;
+            cost += meta.GetType() == KEY_STRING ? 1 : meta.GetObjectLen();
         }
-        Channel* ch = ctx.client->client;
-        if (!async)
+        int64 start = 0, stop = 0;
+        if ((setting.type == REDIS_CMD_LRANGE || setting.type == REDIS_CMD_ZRANGE || setting.type == REDIS_CMD_ZREVRANGE) && args.GetArguments().size() >= 3
+                && string_toint64(args.GetArguments()[1], start) && string_toint64(args.GetArguments()[2], stop))
         {
-            ch->Write(*r);
+            start = start < 0 ? start + cost : start;
+            stop = stop < 0 ? stop + cost : stop;
+            start = start < 0 ? 0 : start;
+            stop = stop >= cost ? cost - 1 : stop;
+            cost = stop >= start ? stop - start + 1 : 0;
         }
-        else
+        return cost;
+    }
+
+    /*
+     * Lock free reads run under an engine snapshot without key locks, so they can yield in a request coroutine.
+     */
+    bool Ardb::IsRequestCoroCommand(Context& ctx, RedisCommandFrame& args)
+    {
+        bool is_write = false;
+        if (!m_engine->GetFeatureSet().support_snapshot_read || !IsEngineIOCommand(ctx, args, is_write) || is_write)
         {
-            ch->GetService().AsyncIO(ch->GetID(), async_write_reply_callback, r);
+            return false;
         }
-        return 0;
+        RedisCommandHandlerSetting* found = FindRedisCommandHandlerSetting(args);
+        return NULL != found && (found->flags & ARDB_CMD_LOCKFREE_READ) > 0;
     }
 
-    void Ardb::FreeClient(Context& ctx)
+    /*
+     * In thread-per-core mode every event loop thread owns the keys whose hash slot modulo 'partitions' is its
+     * partition, return the partition owning all keys of the command, or -1 if it has no key or its keys are
+     * spread over several partitions.
+     */
+    int32 Ardb::GetCommandPartition(Context& ctx, RedisCommandFrame& args, uint32 partitions)
     {
-        UnwatchKeys(ctx);
-        UnsubscribeAll(ctx, true, false);
-        UnsubscribeAll(ctx, false, false);
-        if (NULL != ctx.client)
+        bool is_write = false;
+        if (partitions <= 1 || !IsEngineIOCommand(ctx, args, is_write))
         {
-            m_clients.GetValue().erase(ctx.client->clientid);
-            LockGuard<SpinMutexLock> guard(m_clients_lock);
-            m_all_clients.erase(&ctx);
+            return -1;
         }
-        UnblockKeys(ctx, true);
-        MarkRestoring(ctx, false);
+        StringArray keys;
+        GetCommandKeys(args, keys);
+        int32 partition = -1;
+        for (size_t i = 0; i < keys.size(); i++)
         {
-            WriteLockGuard<SpinRWLock> guard(m_monitors_lock);
-            if (NULL != m_monitors)
+            int32 owner = key_hash_slot(keys[i].data(), keys[i].size()) % partitions;
+            if (partition >= 0 && owner != partition)
             {
-                m_monitors->erase(&ctx);
-                if (m_monitors->empty())
-                {
-                    DELETE(m_monitors);
-                }
+                return -1;
             }
+            partition = owner;
         }
+        return partition;
     }
 
-#define CLIENTS_CRON_MIN_ITERATIONS 5
-    void Ardb::ScanClients()
+    /*
+     * Consecutive pipelined single key writes(commands flagged 'B') of one connection are executed inside one engine
+     * write batch, committed by CommitPipelineBatch once the pipelined input has been handled. The keys of the batch stay
+     * locked until then, so that other connections never read or overwrite uncommitted writes. A command on a key already
+     * in the batch starts a new batch since it would not see the uncommitted writes.
+     * Return false if the command can not join, the current batch is committed then.
+     */
+    bool Ardb::JoinPipelineBatch(Context& ctx, RedisCommandFrame& args)
     {
-        std::vector<Context*> to_close;
-        uint64 now = get_current_epoch_micros();
-        ClientIdSet& local_clients = m_clients.GetValue();
-        if (local_clients.empty())
+        int64 limit = GetConf().pipeline_write_batch_size;
+        if (limit <= 0 && !ctx.InPipelineBatch())
         {
-            return;
+            return false;
         }
-        int64 numclients = local_clients.size();
-        int64 iterations = numclients / GetConf().hz;
-
-        /* Process at least a few clients while we are at it, even if we need
-         * to process less than CLIENTS_CRON_MIN_ITERATIONS to meet our contract
-         * of processing each client once per second. */
-        if (iterations < CLIENTS_CRON_MIN_ITERATIONS)
-            iterations = (numclients < CLIENTS_CRON_MIN_ITERATIONS) ? numclients : CLIENTS_CRON_MIN_ITERATIONS;
-        ClientId& last_scan_clientid = m_last_scan_clientid.GetValue();
-        ClientIdSet::iterator it = local_clients.lower_bound(last_scan_clientid);
-        while (it != local_clients.end() && iterations--)
+        RedisCommandHandlerSetting* found = NULL;
+        if (limit > 0 && ctx.authenticated && !ctx.InTransaction() && !ctx.IsSubscribed() && !args.GetArguments().empty() && GetConf().master_host.empty()
+                && !IsLoadingData() && m_engine->GetFeatureSet().support_nested_write_batch)
+        {
+            found = FindRedisCommandHandlerSetting(args);
+        }
+        if (NULL == found || !(found->flags & ARDB_CMD_PIPELINE_BATCH))
+        {
+            CommitPipelineBatch(ctx);
+            return false;
+        }
+        KeyObject meta(ctx.ns, KEY_META, args.GetArguments()[0]);
+        KeyPrefix lk;
+        lk.ns = meta.GetNameSpace();
+        lk.key = meta.GetKey();
+        PipelineBatch& batch = ctx.GetPipelineBatch();
+        bool locked = false;
+        if (!batch.keys.empty())
         {
-            ClientId& clientid = *it;
-            Context* client = clientid.ctx;
-            if (GetConf().tcp_keepalive > 0)
+            /*
+             * never wait for a key while holding the batch keys, the holder may wait for them
+             */
+            if ((int64) batch.keys.size() < limit && batch.keys.count(lk) == 0)
             {
-                if (!client->IsBlocking() && !client->IsSubscribed())
-                {
-                    if (now - client->client->last_interaction_ustime >= GetConf().tcp_keepalive * 1000 * 1000)
-                    {
-                        //timeout;
-                        to_close.push_back(client);
-                        client = NULL;
-                    }
-                }
+                locked = TryLockKey(lk);
             }
-            if (NULL != client && client->IsBlocking())
+            if (!locked)
             {
-                if (client->GetBPop().timeout > 0 && now >= client->GetBPop().timeout)
-                {
-                    //timeout;
-                    RedisReply empty_bulk;
-                    empty_bulk.ReserveMember(-1);
-                    client->client->client->Write(empty_bulk);
-                    to_close.push_back(client);
-                }
+                CommitPipelineBatch(ctx);
             }
-            if (NULL != client->client && NULL != client->client->client)
+        }
+        if (!locked)
+        {
+            /*
+             * an open batch counts as a write in flight until it is committed
+             */
+            EnterWriteFence();
+            LockKey(lk);
+            if (0 != m_engine->BeginWriteBatch(ctx))
             {
-                if (client->client->resume_ustime > 0 && now <= client->client->resume_ustime)
-                {
-                    client->client->client->AttachFD();
-                    client->client->resume_ustime = -1;
-                }
+                UnlockKey(lk);
+                atomic_sub_uint32(&m_fenced_writes, 1);
+                return false;
             }
-            it++;
         }
-        for (size_t i = 0; i < to_close.size(); i++)
+        FinishLazyFree(lk);
+        batch.keys.insert(lk);
+        return true;
+    }
+
+    void Ardb::CommitPipelineBatch(Context& ctx)
+    {
+        if (!ctx.InPipelineBatch())
         {
-            to_close[i]->client->client->Close();
+            return;
         }
-        if (it == local_clients.end())
+        PipelineBatch::KeySet& keys = ctx.pipeline->keys;
+        int err = m_engine->CommitWriteBatch(ctx);
+        if (0 != err)
         {
-            last_scan_clientid.id = 0;
-            last_scan_clientid.ctx = NULL;
+            ERROR_LOG("Failed to commit pipeline write batch of %u keys for reason:%d", (uint32) keys.size(), err);
         }
-        else
+        PipelineBatch::KeySet::iterator it = keys.begin();
+        while (it != keys.end())
         {
-            last_scan_clientid = (*it);
+            UnlockKey(*it);
+            it++;
         }
+        keys.clear();
+        atomic_sub_uint32(&m_fenced_writes, 1);
     }
 
-    void Ardb::AddClient(Context& ctx)
+    /*
+     * The writer is counted before checking the fence, so a raiser seeing no writes in flight after raising it
+     * can not miss one which passed the check.
+     */
+    void Ardb::EnterWriteFence()
     {
-        if (NULL != ctx.client)
+        while (true)
         {
-            m_clients.GetValue().insert(ctx.client->clientid);
-            LockGuard<SpinMutexLock> guard(m_clients_lock);
-            m_all_clients.insert(&ctx);
+            atomic_add_uint32(&m_fenced_writes, 1);
+            if (!m_write_fence)
+            {
+                return;
+            }
+            atomic_sub_uint32(&m_fenced_writes, 1);
+            while (m_write_fence)
+            {
+                usleep(100);
+            }
         }
     }
 
-    bool Ardb::IsLoadingData()
+    /*
+     * Returns false if the writes in flight are not drained in 'timeout_ms', the fence is lowered then.
+     */
+    bool Ardb::RaiseWriteFence(int64 timeout_ms)
     {
-        return g_repl->GetSlave().IsLoading() || m_loading_data;
+        m_write_fence = true;
+        uint64 start = get_current_epoch_millis();
+        while (m_fenced_writes > 0)
+        {
+            if (get_current_epoch_millis() - start >= (uint64) timeout_ms)
+            {
+                m_write_fence = false;
+                return false;
+            }
+            usleep(100);
+        }
+        return true;
     }
 
-    int Ardb::DoCall(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& args)
+    void Ardb::LowerWriteFence()
     {
-        uint64 start_time = get_current_epoch_micros();
-        /*
-         * 1. commands recv from slave replication connection always in incompatible mode
-         * 2. command type > REDIS_CMD_EXTEND_BEGIN
-         * 3. configuration 'redis_compatible = no'
-         */
-        if ((args.GetType() < REDIS_CMD_EXTEND_BEGIN && GetConf().redis_compatible) || ctx.flags.slave)
-        {
-            ctx.flags.redis_compatible = 1;
-        }
-        else
+        m_write_fence = false;
+    }
+
+    /*
+     * Reply -TRYAGAIN & return true for a command which may write on the range of a frozen REBALANCE, a db moved by a
+     * finished rebalance refuses writes until it is flushed.
+     */
+    bool Ardb::RebalanceBlocked(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& cmd)
+    {
+        if (setting.flags & (ARDB_CMD_READONLY | ARDB_CMD_ADMIN | ARDB_CMD_PUBSUB))
         {
-            ctx.flags.redis_compatible = 0;
+            return false;
         }
-        if (NULL != ctx.client)
+        LockGuard<SpinMutexLock> guard(m_rebalance_lock);
+        if (!m_rebalance_frozen || NULL == m_rebalance)
         {
-            ctx.client->last_interaction_ustime = start_time;
+            return false;
         }
-        ctx.last_cmdtype = setting.type;
-
-        if (NULL != m_monitors && !IsLoadingData() && !(setting.flags & (ARDB_CMD_SKIP_MONITOR | ARDB_CMD_ADMIN)))
+        RebalanceState& state = *m_rebalance;
+        bool flush = setting.type == REDIS_CMD_FLUSHALL || (setting.type == REDIS_CMD_FLUSHDB && ctx.ns == state.ns);
+        if (!flush && ctx.ns != state.ns)
         {
-            /*
-             * feed monitors
-             */
-            FeedMonitors(ctx, ctx.ns, args);
+            return false;
         }
-
-        int ret = (this->*(setting.handler))(ctx, args);
-        if (!ctx.flags.lua)
+        RedisReply& reply = ctx.GetReply();
+        if (!m_rebalancing)
         {
-            uint64 stop_time = get_current_epoch_micros();
-            atomic_add_uint64(&(setting.calls), 1);
-            atomic_add_uint64(&(setting.microseconds), stop_time - start_time);
-            g_cmd_cost_tracks[setting.type].AddCost((stop_time - start_time));
-            TryPushSlowCommand(args, stop_time - start_time);
-            DEBUG_LOG("Process recved cmd cost %lluus", stop_time - start_time);
+            if (flush)
+            {
+                m_rebalance_frozen = false;
+                return false;
+            }
+            reply.SetErrorReason("-READONLY DB moved to " + state.host + ":" + stringfromll(state.port));
+            return true;
         }
-
-        /*
-         * Sometimes read only command may modify the key/value pair, do NOT propagate it to replication log
-         */
-        if (!ctx.flags.no_wal && ctx.dirty > 0 && setting.IsWriteCommand())
+        if (state.start_slot >= 0 && !flush)
         {
-            FeedReplicationBacklog(ctx, ctx.ns, args);
+            StringArray keys;
+            if (setting.type == REDIS_CMD_EXEC && ctx.InTransaction())
+            {
+                RedisCommandFrameArray& cmds = ctx.GetTransaction().cached_cmds;
+                for (size_t i = 0; i < cmds.size(); i++)
+                {
+                    GetCommandKeys(cmds[i], keys);
+                }
+            }
+            else
+            {
+                GetCommandKeys(cmd, keys);
+            }
+            bool in_range = false;
+            for (size_t i = 0; i < keys.size() && !in_range; i++)
+            {
+                int32 slot = key_hash_slot(keys[i].data(), keys[i].size());
+                in_range = slot >= state.start_slot && slot <= state.end_slot;
+            }
+            if (!in_range)
+            {
+                return false;
+            }
         }
-
-        return ret;
+        reply.SetErrorReason(state.start_slot >= 0 ? "-TRYAGAIN Slots are being rebalanced" : "-TRYAGAIN DB is being rebalanced");
+        return true;
     }
 
-    Ardb::RedisCommandHandlerSetting* Ardb::FindRedisCommandHandlerSetting(RedisCommandFrame& args)
+    /*
+     * Reply -QOS & return true for a command of a client over its own limits or over the quota of its db,
+     * 'slow_ns' is set to the db of an admitted slow command which holds a slot until TenantLimiter::SlowCommandDone.
+     */
+    bool Ardb::QoSBlocked(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& cmd, std::string& slow_ns)
     {
-        std::string& cmd = args.GetMutableCommand();
-        lower_string(cmd);
-        RedisCommandHandlerSettingTable::iterator found = m_settings.find(cmd);
-        if (found == m_settings.end())
+        if (setting.flags & ARDB_CMD_ADMIN)
         {
-            return NULL;
+            return false;
         }
-        args.SetType(found->second.type);
-        return &(found->second);
-    }
-
-    struct ResumeOverloadConnection: public Runnable
-    {
-            ChannelService& chs;
-            uint32 channle_id;
-            ResumeOverloadConnection(ChannelService& serv, uint32 id) :
-                    chs(serv), channle_id(id)
-            {
-            }
-            void Run()
+        TenantLimiter& limiter = TenantLimiter::GetSingleton();
+        ClientContext& client = *ctx.client;
+        if (!client.qos_custom && (client.qos_ops.rate != GetConf().qos_client_ops_limit || client.qos_bytes.rate != GetConf().qos_client_bytes_limit))
+        {
+            client.qos_ops.SetRate(GetConf().qos_client_ops_limit);
+            client.qos_bytes.SetRate(GetConf().qos_client_bytes_limit);
+        }
+        if (!limiter.Enabled() && client.qos_ops.rate == 0 && client.qos_bytes.rate == 0)
+        {
+            return false;
+        }
+        uint64 bytes = cmd.GetCommand().size();
+        for (size_t i = 0; i < cmd.GetArguments().size(); i++)
+        {
+            bytes += cmd.GetArguments()[i].size();
+        }
+        RedisReply& reply = ctx.GetReply();
+        uint64 now = get_current_epoch_micros();
+        if (!client.qos_ops.Allow(now) || !client.qos_bytes.Allow(now))
+        {
+            limiter.AddClientRejected();
+            reply.SetErrorReason("-QOS client over its limit, try again later");
+            return true;
+        }
+        if (limiter.Enabled())
+        {
+            bool slow = (setting.flags & ARDB_CMD_SLOW) || setting.slow;
+            switch (limiter.Admit(ctx.ns.AsString(), bytes, slow))
             {
-                Channel* ch = chs.GetChannel(channle_id);
-                if (NULL != ch)
+                case QOS_OPS_EXCEEDED:
                 {
-                    ch->AttachFD();
+                    reply.SetErrorReason("-QOS db " + ctx.ns.AsString() + " over its ops/s quota, try again later");
+                    return true;
+                }
+                case QOS_BYTES_EXCEEDED:
+                {
+                    reply.SetErrorReason("-QOS db " + ctx.ns.AsString() + " over its bytes/s quota, try again later");
+                    return true;
+                }
+                case QOS_SLOW_EXCEEDED:
+                {
+                    reply.SetErrorReason("-QOS db " + ctx.ns.AsString() + " runs too many slow commands, try again later");
+                    return true;
+                }
+                default:
+                {
+                    break;
                 }
             }
-    };
+            if (slow)
+            {
+                slow_ns = ctx.ns.AsString();
+            }
+        }
+        client.qos_ops.Charge(1);
+        client.qos_bytes.Charge(bytes);
+        return false;
+    }
 
     int Ardb::Call(Context& ctx, RedisCommandFrame& args)
     {
@@ -1476,7 +3605,13 @@ OP_NAMESPACE_BEGIN
             }
         }
 
-        if (GetConf().slave_ignore_del && ctx.flags.slave && setting.type == REDIS_CMD_DEL)
+        if (m_read_replica && (setting.flags & ARDB_CMD_WRITE) > 0)
+        {
+            reply.SetErrorReason("-READONLY You can't write against a read replica.");
+            return 0;
+        }
+
+        if (GetConf().slave_ignore_del && ctx.flags.slave && (setting.type == REDIS_CMD_DEL || setting.type == REDIS_CMD_UNLINK))
         {
             return 0;
         }
@@ -1492,11 +3627,36 @@ OP_NAMESPACE_BEGIN
 
         /* Loading DB? Return an error if the command has not the
          * CMD_LOADING flag. */
-        if ((IsLoadingData() || IsRestoring(ctx, ctx.ns)) && !(setting.flags & ARDB_CMD_LOADING))
+        if ((IsLoadingData() || IsRestoring(ctx, ctx.ns) || IsKeyCacheLoading(ctx, setting.type)) && !(setting.flags & ARDB_CMD_LOADING)
+                && !(m_loading_serve_reads && !setting.IsWriteCommand() && !g_repl->GetSlave().IsLoading()))
         {
             reply.SetErrCode(ERR_LOADING);
             return 0;
         }
+
+        /*
+         * Commands of clients(not the master or scripts) on keys of other cluster nodes are redirected.
+         * ASKING only holds for the next command, READONLY until READWRITE.
+         */
+        if (GetConf().cluster_enabled && NULL != ctx.client && !ctx.flags.slave && !ctx.flags.lua && setting.type != REDIS_CMD_ASKING)
+        {
+            bool asking = ctx.asking || (setting.flags & ARDB_CMD_ASKING);
+            ctx.asking = false;
+            if (!(setting.flags & (ARDB_CMD_ADMIN | ARDB_CMD_PUBSUB)) && RedirectClusterCommand(ctx, args, asking,
+                    ctx.readonly && (setting.flags & ARDB_CMD_READONLY)))
+            {
+                ctx.AbortTransaction();
+                return 0;
+            }
+        }
+        /*
+         * Writes of clients on the range of a REBALANCE are refused while its ownership is flipped.
+         */
+        if (m_rebalance_frozen && NULL != ctx.client && !ctx.flags.slave && !ctx.flags.lua && RebalanceBlocked(ctx, setting, args))
+        {
+            ctx.AbortTransaction();
+            return 0;
+        }
         if (ctx.InTransaction())
         {
             if (setting.type != REDIS_CMD_MULTI && setting.type != REDIS_CMD_EXEC && setting.type != REDIS_CMD_DISCARD && setting.type != REDIS_CMD_QUIT)
@@ -1514,7 +3674,98 @@ OP_NAMESPACE_BEGIN
                 return 0;
             }
         }
+        /*
+         * client commands expected to return more elements than their 'command-cost-limits' are refused or stream their
+         * reply, the ones of a 'slow' limit were moved to the slow command pool by IsSlowCommand
+         */
+        ctx.cost_estimate = 0;
+        ctx.flags.stream_reply = 0;
+        if (setting.cost_limit > 0 && NULL != ctx.client && !ctx.flags.slave && !ctx.flags.lua)
+        {
+            ctx.cost_estimate = EstimateCommandCost(ctx, setting, args);
+            if (ctx.cost_estimate > setting.cost_limit)
+            {
+                if (setting.cost_action == COMMAND_COST_REJECT)
+                {
+                    atomic_add_uint64(&m_cost_rejected, 1);
+                    ctx.AbortTransaction();
+                    reply.SetErrorReason("estimated " + stringfromll(ctx.cost_estimate) + " elements over the limit " + stringfromll(setting.cost_limit)
+                            + " of '" + setting.name + "', read it by SCAN/SSCAN/HSCAN/ZSCAN or smaller ranges");
+                    ctx.cost_estimate = 0;
+                    return 0;
+                }
+                if (setting.cost_action == COMMAND_COST_STREAM)
+                {
+                    atomic_add_uint64(&m_cost_streamed, 1);
+                    ctx.flags.stream_reply = 1;
+                }
+            }
+        }
+        std::string qos_slow_ns;
+        if (NULL != ctx.client && !ctx.flags.slave && !ctx.flags.lua && QoSBlocked(ctx, setting, args, qos_slow_ns))
+        {
+            ctx.AbortTransaction();
+            return 0;
+        }
+        /*
+         * while the engine stalls writes only a bounded number of client writes wait in it, so the other worker
+         * threads keep serving reads, later writes fail fast with a retryable -BUSY.
+         */
+        bool stall_pending_write = false;
+        if (GetConf().write_stall_pending_limit > 0 && NULL != ctx.client && !ctx.flags.slave && !ctx.flags.lua && setting.IsWriteCommand()
+                && m_engine->IsWriteStalled())
+        {
+            if (atomic_add_uint32(&m_stall_pending_writes, 1) > (uint32) GetConf().write_stall_pending_limit)
+            {
+                atomic_sub_uint32(&m_stall_pending_writes, 1);
+                atomic_add_uint64(&m_shed_writes, 1);
+                if (!qos_slow_ns.empty())
+                {
+                    TenantLimiter::GetSingleton().SlowCommandDone(qos_slow_ns);
+                }
+                ctx.AbortTransaction();
+                reply.SetErrorReason("-BUSY Engine is stalling writes, try again later");
+                return 0;
+            }
+            stall_pending_write = true;
+        }
+        bool rebalance_write = m_rebalancing && !(setting.flags & (ARDB_CMD_READONLY | ARDB_CMD_ADMIN));
+        if (rebalance_write)
+        {
+            atomic_add_uint32(&m_rebalance_writes, 1);
+        }
+        if (NULL != ctx.tracking && (setting.flags & ARDB_CMD_READONLY))
+        {
+            TrackKeysRead(ctx, args);
+        }
+        /*
+         * a read replica fences all commands, as a refresh reopens the engine under them. A command of a pipeline batch
+         * is covered by the fence held by the batch.
+         */
+        bool fenced_write = (m_read_replica || !(setting.flags & (ARDB_CMD_READONLY | ARDB_CMD_ADMIN))) && !ctx.InPipelineBatch();
+        if (fenced_write)
+        {
+            EnterWriteFence();
+        }
         ret = DoCall(ctx, setting, args);
+        ctx.flags.stream_reply = 0;
+        ctx.cost_estimate = 0;
+        if (fenced_write)
+        {
+            atomic_sub_uint32(&m_fenced_writes, 1);
+        }
+        if (rebalance_write)
+        {
+            atomic_sub_uint32(&m_rebalance_writes, 1);
+        }
+        if (!qos_slow_ns.empty())
+        {
+            TenantLimiter::GetSingleton().SlowCommandDone(qos_slow_ns);
+        }
+        if (stall_pending_write)
+        {
+            atomic_sub_uint32(&m_stall_pending_writes, 1);
+        }
         WakeClientsBlockingOnList(ctx);
         return ret;
     }
@@ -32,21 +32,29 @@
 #include "common/common.hpp"
 #include "thread/thread_local.hpp"
 #include "thread/spin_rwlock.hpp"
+#include "thread/big_reader_lock.hpp"
 #include "thread/spin_mutex_lock.hpp"
 #include "thread/thread_mutex_lock.hpp"
 #include "channel/all_includes.hpp"
 #include "util/lru.hpp"
+#include "util/pattern_index.hpp"
 #include "command/lua_scripting.hpp"
 #include "db/engine.hpp"
+#include "db/engine_profiler.hpp"
 #include "statistics.hpp"
 #include "context.hpp"
 #include "config.hpp"
 #include "logger.hpp"
 #include <stack>
+#include <deque>
 #include <sparsehash/dense_hash_map>
 #include <common/cache/ConcurrentKeyCache.h>
 
 #define TTL_DB_NSMAESPACE "__TTL_DB__"
+#define ZSET_STORE_NAMESPACE "__ZSTORE_DB__"
+#define LAZYFREE_DB_NAMESPACE "__LAZYFREE_DB__"
+#define INDEX_DB_NAMESPACE "__INDEX_DB__"
+#define SHADOW_NAMESPACE_PREFIX "__SHADOW__." //namespaces of a full resync loaded aside the live ones
 
 using namespace ardb::codec;
 
@@ -55,6 +63,10 @@ OP_NAMESPACE_BEGIN
     class ObjectIO;
     class ObjectBuffer;
     class Snapshot;
+    struct StreamID;
+    struct StreamMeta;
+    struct VectorSet;
+    struct VectorValue;
     class Ardb
     {
         public:
@@ -68,11 +80,14 @@ OP_NAMESPACE_BEGIN
                     int max_arity;
                     const char* sflags;
                     int flags;
-                    volatile uint64 microseconds;
-                    volatile uint64 calls;
-                    //CostTrack
+                    CostTrack* cost_track;
+                    EngineProfileStat* engine_profile;
+                    volatile bool slow; //took longer than 'slow-command-budget' in its last call outside the slow command pool
+                    int64 cost_limit; //estimated elements over which 'command-cost-limits' applies cost_action, 0 for no limit
+                    int cost_action;
                     bool IsAllowedInScript() const;
                     bool IsWriteCommand() const;
+                    bool IsSingleKeyWrite() const;
             };
             struct RedisCommandHash
             {
@@ -101,77 +116,444 @@ OP_NAMESPACE_BEGIN
                     ~KeysLockGuard();
             };
 
+            /*
+             * A REBALANCE copying a db or the keys of a slot range to another server
+             */
+            struct RebalanceState
+            {
+                    ChannelService* io_serv;
+                    Data ns;
+                    int32 start_slot; //-1 for the whole db
+                    int32 end_slot;
+                    std::string host;
+                    uint16 port;
+                    uint32 timeout;
+                    int64 max_bytes_per_sec;
+                    int64 max_ops_per_sec;
+                    const char* phase;
+                    std::string error;
+                    volatile bool abort;
+                    uint64 start_time;
+                    uint64 end_time;
+                    int64 estimated_keys;
+                    int64 copied_keys;
+                    int64 copied_entries;
+                    int64 copied_bytes;
+                    int64 charged_bytes; //copied bytes charged to the background io budget
+                    int64 catchup_keys;
+                    uint64 wal_offset; //the WAL is scanned for written keys from here
+                    RebalanceState() :
+                            io_serv(NULL), start_slot(-1), end_slot(-1), port(0), timeout(0), max_bytes_per_sec(0), max_ops_per_sec(0), phase("copying"), abort(
+                                    false), start_time(0), end_time(0), estimated_keys(0), copied_keys(0), copied_entries(0), copied_bytes(0), charged_bytes(0), catchup_keys(0), wal_offset(0)
+                    {
+                    }
+            };
+
+            /*
+             * IDX.CREATE definition, 'fields' of the hashes of db 'ns' whose keys start with 'prefix' are indexed.
+             */
+            struct HashIndex
+            {
+                    std::string ns;
+                    std::string name;
+                    std::string prefix;
+                    StringArray fields;
+                    std::vector<uint8> types;
+            };
+            typedef std::vector<HashIndex> HashIndexArray;
+            typedef TreeMap<std::string, std::string>::Type HashIndexValues; //field -> value
+
         private:
 
             Engine* m_engine;
             time_t m_starttime;
             bool m_loading_data;
+            bool m_loading_serve_reads; //read commands are served while IMPORT runs('import-serve-reads')
             bool m_compacting_data;
+            /*
+             * CONFIG SET/RELOAD & SLAVEOF change m_conf under m_conf.lock, then publish an immutable copy. GetConf()
+             * reads the published copy without locks, replaced copies are kept until exit since readers may still
+             * hold references to them.
+             */
             ArdbConfig m_conf;
+            ArdbConfig* volatile m_conf_snapshot;
+            std::vector<ArdbConfig*> m_retired_confs;
             ThreadLocal<LUAInterpreter> m_lua;
 
+            /*
+             * keys found expired by engine compactions, sharded by key hash so that compaction threads
+             * rarely contend on one lock.
+             */
             typedef TreeSet<KeyPrefix>::Type ExpireKeySet;
-            SpinMutexLock m_expires_lock;
-            ExpireKeySet m_expires;
+            struct ExpireKeyShard
+            {
+                    SpinMutexLock lock;
+                    ExpireKeySet keys;
+            };
+            static const uint32 kExpireKeyShards = 16;
+            ExpireKeyShard m_expires[kExpireKeyShards];
+
+            /*
+             * lists left non-sequential by LINSERT/LREM, renumbered by the slow cron at most
+             * 'kListCompactCronElements' elements per run.
+             */
+            static const int64 kListCompactCronElements = 100000;
+            typedef TreeSet<KeyPrefix>::Type ListCompactKeySet;
+            SpinMutexLock m_list_compact_lock;
+            ListCompactKeySet m_list_compact_keys;
+
+            /*
+             * large objects removed by DEL/expiry whose elements are still being deleted by the reclaimer,
+             * mapped to the time they were queued.
+             */
+            typedef TreeMap<KeyPrefix, int64>::Type LazyFreeKeyTable;
+            SpinMutexLock m_lazyfree_lock;
+            LazyFreeKeyTable m_lazyfree_keys;
+            volatile uint32 m_lazyfree_key_count;
+
+            /*
+             * namespaces flushed since whose entries in the ttl db are still being purged, the purge resumes after
+             * the last visited entry & starts over whenever a namespace is flushed again.
+             */
+            SpinMutexLock m_flushed_lock;
+            DataSet m_flushed_nss;
+            int64 m_ttl_purge_ttl;
+            Data m_ttl_purge_ns;
+            std::string m_ttl_purge_key;
+            uint64 m_ttl_purge_version;
+            volatile uint32 m_flushed_ns_count;
+
+            /*
+             * object ids of hashes(hash-object-id) are taken from [m_next_object_id, m_object_id_limit), the limit
+             * is saved in the engine by the slow cron ahead of use, so that no command waits for it.
+             */
+            SpinMutexLock m_object_id_lock;
+            uint64 m_next_object_id;
+            uint64 m_object_id_limit;
+            volatile bool m_object_id_enabled;
+
+            volatile uint64 m_mem_purges; //runs of PurgeFragmentedMemory which returned memory
+            volatile uint64 m_mem_purged_bytes;
+
+            bool m_read_replica; //engine opened read only on the data dir of another instance('rocksdb-read-replica-of')
+            volatile uint64 m_replica_refreshes;
+            volatile uint64 m_replica_refresh_skips; //commands in flight not drained in time, or a snapshot held
+            volatile uint64 m_replica_refresh_time; //epoch millis of the last refresh
+
+            /*
+             * Secondary indexes of all dbs(IDX.CREATE), saved in the index db & published by SaveHashIndexes.
+             */
+            SpinMutexLock m_hash_indexes_lock;
+            HashIndexArray m_hash_indexes;
+            volatile uint32 m_hash_index_count;
 
             typedef google::dense_hash_map<std::string, RedisCommandHandlerSetting, RedisCommandHash, RedisCommandEqual> RedisCommandHandlerSettingTable;
             RedisCommandHandlerSettingTable m_settings;
-            typedef TreeMap<KeyPrefix, ThreadMutexLock*>::Type LockTable;
-            typedef std::stack<ThreadMutexLock*> LockPool;
-            SpinMutexLock m_locking_keys_lock;
-            LockTable m_locking_keys;
-            LockPool m_lock_pool;
+            /*
+             * settings & (possibly renamed) command names indexed by command type, for frames whose type
+             * was already resolved by the decoder.
+             */
+            RedisCommandHandlerSetting* m_settings_by_type[REDIS_CMD_MAX];
+            const std::string* m_command_names_by_type[REDIS_CMD_MAX];
+            /*
+             * threads waiting on a locked key are queued in FIFO order, UnlockKey hands the ownership
+             * to the head waiter directly instead of releasing the key.
+             */
+            struct KeyLockWaiter
+            {
+                    ThreadMutexLock cond;
+                    bool granted;
+                    KeyLockWaiter() :
+                            granted(false)
+                    {
+                    }
+            };
+            typedef std::deque<KeyLockWaiter*> KeyLockWaitQueue;
+            typedef TreeMap<KeyPrefix, KeyLockWaitQueue*>::Type LockTable;
+            typedef std::stack<KeyLockWaitQueue*> LockPool;
+            /*
+             * locking keys are hash partitioned into shards, each shard has its own spin lock & lock pool,
+             * so that threads locking unrelated keys do not contend on one global lock.
+             */
+            struct KeyLockShard
+            {
+                    SpinMutexLock lock;
+                    LockTable keys;
+                    LockPool pool;
+            };
+            KeyLockShard* m_key_lock_shards;
+            uint32 m_key_lock_shard_num;
 
             SpinMutexLock m_redis_cursor_lock;
             typedef LRUCache<uint64, std::string> RedisCursorCache;
             uint64 m_redis_cursor_seed;
             RedisCursorCache m_redis_cursor_cache;
 
+            struct PFCountCacheEntry
+            {
+                    uint64 digest;
+                    uint64 card;
+                    PFCountCacheEntry() :
+                            digest(0), card(0)
+                    {
+                    }
+            };
+            typedef LRUCache<std::string, PFCountCacheEntry> PFCountCache;
+            SpinMutexLock m_pfcount_cache_lock;
+            PFCountCache m_pfcount_cache;
+
             typedef TreeMap<std::string, ContextSet>::Type PubSubChannelTable;
-            SpinRWLock m_pubsub_lock;
-            PubSubChannelTable m_pubsub_channels;
+            /*
+             * Channels are hashed over shards with their own locks, subscription churn on some channels
+             * only blocks publishers of the channels in the same shard.
+             */
+            struct PubSubShard
+            {
+                    BigReaderLock lock;
+                    PubSubChannelTable channels;
+            };
+            static const uint32 kPubSubShards = 32;
+            PubSubShard m_pubsub_shards[kPubSubShards];
+            BigReaderLock m_pubsub_pattern_lock;
             PubSubChannelTable m_pubsub_patterns;
-
-            SpinMutexLock m_watched_keys_lock;
-            typedef TreeMap<KeyPrefix, ContextSet>::Type WatchedContextTable;
-            WatchedContextTable* m_watched_ctxs;
-
-            SpinMutexLock m_block_keys_lock;
-            typedef TreeMap<KeyPrefix, ContextSet>::Type BlockedContextTable;
+            GlobPatternIndex m_pubsub_pattern_index; //keys of m_pubsub_patterns
+
+            /*
+             * Client side caching(CLIENT TRACKING): keys read by tracking clients map to the ids of their connections,
+             * BCAST clients register key prefixes. A key is dropped from the table once it is invalidated, the table is
+             * bounded by 'tracking-table-max-keys' by invalidating the keys after the eviction cursor early.
+             */
+            typedef TreeSet<uint32>::Type TrackingClientSet;
+            typedef TreeMap<std::string, TrackingClientSet>::Type TrackingKeyTable;
+            typedef TreeMap<uint32, Context*>::Type TrackingContextTable;
+            SpinMutexLock m_tracking_lock;
+            TrackingKeyTable m_tracking_keys;
+            TrackingKeyTable m_tracking_prefixes; //prefix -> ids of the BCAST clients
+            TrackingContextTable m_tracking_contexts; //connection id -> tracking client
+            std::string m_tracking_evict_cursor;
+            volatile uint32_t m_tracking_clients;
+
+            /*
+             * WATCH is validated optimistically at EXEC: while any client watches keys, every write bumps the version slot
+             * of its key & flushes bump the flush version. EXEC fails if one of them moved since WATCH, a slot shared with
+             * another written key only costs a spurious abort.
+             */
+            static const uint32 kWatchVersionSlots = 4096;
+            volatile uint32_t m_watch_versions[kWatchVersionSlots];
+            volatile uint32_t m_watch_flush_version;
+            volatile uint32_t m_watching_clients;
+
+            /*
+             * Clients blocked on lists wait in a FIFO per key, the tables are sharded by key. Lock order is key lock,
+             * block shard lock, then the ready keys lock.
+             */
+            typedef std::deque<Context*> BlockedContextQueue;
+            typedef TreeMap<KeyPrefix, BlockedContextQueue>::Type BlockedContextTable;
+            struct BlockShard
+            {
+                    SpinMutexLock lock;
+                    BlockedContextTable waiters;
+            };
+            static const uint32 kBlockShards = 32;
+            BlockShard m_block_shards[kBlockShards];
+            volatile uint32_t m_blocked_clients;
+            SpinMutexLock m_ready_keys_lock;
             typedef TreeSet<KeyPrefix>::Type ReadyKeySet;
-            BlockedContextTable m_blocked_ctxs;
             ReadyKeySet* m_ready_keys;
 
-            SpinRWLock m_monitors_lock;
-            ContextSet* m_monitors;
+            /*
+             * Cluster slot owners(cluster-enabled) index m_cluster_nodes, node 0 is this server. Slots migrating
+             * from/importing into this server map to the node on the other side. m_cluster_replicas holds the replica
+             * addresses of each node, m_cluster_epoch counts the topology changes.
+             */
+            typedef TreeMap<uint16, uint16>::Type ClusterSlotNodeTable;
+            static const uint16 kClusterNoNode = 0xFFFF;
+            BigReaderLock m_cluster_lock;
+            StringArray m_cluster_nodes;
+            std::vector<StringArray> m_cluster_replicas;
+            uint64 m_cluster_epoch;
+            uint16 m_cluster_slots[kClusterSlots];
+            ClusterSlotNodeTable m_cluster_migrating;
+            ClusterSlotNodeTable m_cluster_importing;
+
+            /*
+             * A MONITOR client fed one of every 'sample' commands. 'pending' is the bytes queued to its IO thread but not
+             * yet in its output buffer, events are dropped & counted in 'dropped' while it is over 'monitor-output-limit'.
+             * Queued events hold a reference, the feed is freed by the last of them once the client left.
+             */
+            struct MonitorFeed
+            {
+                    uint32 sample;
+                    volatile uint32 refs;
+                    volatile uint64_t pending;
+                    volatile uint64_t dropped;
+                    uint64_t reported; //drops already noted in the feed, only touched in the client's IO thread
+                    MonitorFeed() :
+                            sample(1), refs(1), pending(0), dropped(0), reported(0)
+                    {
+                    }
+            };
+            /*
+             * One formatted command line shared by the events queued to all monitors fed with it.
+             */
+            struct MonitorLine
+            {
+                    std::string line;
+                    volatile uint32 refs;
+                    MonitorLine() :
+                            refs(0)
+                    {
+                    }
+            };
+            struct MonitorEvent
+            {
+                    MonitorLine* line;
+                    MonitorFeed* feed;
+            };
+            typedef std::map<Context*, MonitorFeed*> MonitorTable;
+            BigReaderLock m_monitors_lock;
+            MonitorTable* m_monitors;
+            volatile uint64_t m_monitor_seq;
+            volatile uint64_t m_monitor_dropped;
+            /*
+             * client writes waiting in the engine while it stalls writes, at most 'write-stall-pending-limit'
+             */
+            volatile uint32_t m_stall_pending_writes;
+            volatile uint64_t m_shed_writes;
+            /*
+             * client commands over their 'command-cost-limits' refused, forced to a streamed reply & moved to the
+             * slow command pool
+             */
+            volatile uint64_t m_cost_rejected;
+            volatile uint64_t m_cost_streamed;
+            volatile uint64_t m_cost_rerouted;
+            void ApplyCommandCostLimits();
+            int64 EstimateCommandCost(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& args);
 
-            ThreadLocal<ClientIdSet> m_clients;
-            ThreadLocal<ClientId> m_last_scan_clientid;
             SpinMutexLock m_clients_lock;
-            ContextSet m_all_clients;
+            ClientList m_all_clients;
 
             SpinMutexLock m_restoring_lock;
             DataSet* m_restoring_nss;
 
-            int64_t m_min_ttl;
+            /*
+             * The running or last REBALANCE. Writes on its range are refused while it is frozen, commands which may
+             * write are counted while it runs, so that they are drained before its ownership flip.
+             */
+            SpinMutexLock m_rebalance_lock;
+            RebalanceState* m_rebalance;
+            volatile bool m_rebalancing;
+            volatile bool m_rebalance_frozen;
+            volatile uint32_t m_rebalance_writes;
+
+            /*
+             * Raised by a snapshot save to pair its engine snapshot with the wal offset, commands which may write wait
+             * before entering while it is up, the raiser drains the ones counted in flight.
+             */
+            volatile bool m_write_fence;
+            volatile uint32_t m_fenced_writes;
+            void EnterWriteFence();
+            bool RaiseWriteFence(int64 timeout_ms);
+            void LowerWriteFence();
+
+            volatile int64_t m_min_ttl; //only lowered by SaveTTL, reset by ScanTTLDB with CAS
 
             KeyCache* m_key_cache;
+            /*
+             * With 'keycache-load-async' the key cache is loaded by this thread after the server started, db 0(the
+             * namespace it is loaded from) & the commands answered by the cache get -LOADING meanwhile.
+             */
+            struct KeyCacheLoadTask: public Runnable
+            {
+                    void Run();
+            };
+            KeyCacheLoadTask m_keycache_load_task;
+            Thread* m_keycache_loader;
+            volatile bool m_keycache_loading;
+            bool IsKeyCacheLoading(Context& ctx, RedisCommandType type);
+            void StopKeyCacheLoader();
+
+            /*
+             * COMPACTDB/COMPACTALL & the compaction started after many deletes run in this thread, one at a time.
+             */
+            struct CompactionTask: public Runnable
+            {
+                    Data ns; //nil for all namespaces
+                    bool full;
+                    CompactProgress progress;
+                    CompactionTask() :
+                            full(false)
+                    {
+                    }
+                    void Run();
+            };
+            CompactionTask m_compaction_task;
+            Thread* m_compaction_thread;
+            ThreadMutexLock m_compaction_lock;
+            volatile uint64 m_deleted_entries; //keys & elements deleted since the last compaction
+            time_t m_compaction_last_time;
+            const char* m_compaction_last_status;
+            void RunCompaction(CompactionTask& task);
+            void StopCompaction();
+            void NoteDeletedEntries(uint64 count)
+            {
+                atomic_add_uint64(&m_deleted_entries, count);
+            }
 
             static void MigrateCoroTask(void* data);
             static void MigrateDBCoroTask(void* data);
-
-            bool IsLoadingData();
+            static void MigrateRawCoroTask(void* data);
+            static void RebalanceCoroTask(void* data);
+            bool RebalanceBlocked(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& cmd);
+            bool QoSBlocked(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& cmd, std::string& slow_ns);
+            bool RebalanceWrittenKeys(RebalanceState& state, Buffer& wal, std::string& wal_ns, StringTreeSet& keys, std::string& err);
+            void RebalanceInfo(std::string& info);
 
             bool MarkRestoring(Context& ctx, bool enable);
             bool IsRestoring(Context& ctx, const Data& ns);
 
-            void SaveTTL(Context& ctx, const Data& ns, const std::string& key, int64 old_ttl, int64_t new_ttl);
+            void SaveTTL(Context& ctx, const Data& ns, const std::string& key, int64 old_ttl, int64_t new_ttl, const std::string* field = NULL);
+            /*
+             * TTL entries within [start, end) expired by one worker of ScanTTLDB
+             */
+            struct TTLScanTask: public Runnable
+            {
+                    int64 start;
+                    int64 end;
+                    uint32 limit;
+                    int64 next; //ttl of the first entry left in the range, -1 if the range is drained
+                    uint32 expired;
+                    TTLScanTask() :
+                            start(0), end(0), limit(0), next(-1), expired(0)
+                    {
+                    }
+                    void Run();
+            };
             void ScanTTLDB();
+            void ScanTTLRange(TTLScanTask& task);
+            uint32 DeleteExpiredTTLKeys(Context& ctx, KeyObjectArray& ttl_keys);
             void FeedReplicationBacklog(Context& ctx,const Data& ns, RedisCommandFrame& cmd);
             void FeedMonitors(Context& ctx,const Data& ns, RedisCommandFrame& cmd);
+            static void ReleaseMonitorFeed(MonitorFeed* feed);
+            static void MonitorWriteCallback(Channel* ch, void* data);
 
             int WriteReply(Context& ctx, RedisReply* r, bool async);
 
+            int LazyFreeKey(Context& ctx, const KeyObject& meta_key);
+            int64 ReclaimLazyFreeKey(const KeyPrefix& key, int64 limit);
+            void FinishLazyFree(const KeyPrefix& key);
+            void FinishCommandLazyFree(Context& ctx, RedisCommandFrame& args);
+            void LoadLazyFreeKeys();
+            void LoadKeyCache();
+            void StartKeyCacheLoader();
+            std::string KeyCacheSnapshotPath();
+            bool IsKeyCacheNameSpace(const Data& ns);
+
+            uint32 GetKeyLockShardIndex(const KeyPrefix& key);
+            void LockKey(const KeyPrefix& key);
+            bool TryLockKey(const KeyPrefix& key);
+            void UnlockKey(const KeyPrefix& key);
+            bool IsPipelineBatchKey(Context& ctx, const KeyObject& key);
             void LockKey(const KeyObject& key);
             void UnlockKey(const KeyObject& key);
             void LockKeys(const KeyObjectArray& key);
@@ -185,19 +567,27 @@ OP_NAMESPACE_BEGIN
             int MergeKeyValue(Context& ctx, const KeyObject& key, uint16 op, const DataArray& args);
             int RemoveKey(Context& ctx, const KeyObject& key);
             int IteratorDel(Context& ctx, const KeyObject& key, Iterator* iter);
-            int FlushDB(Context& ctx, const Data& ns);
-            int FlushAll(Context& ctx);
+            /*
+             * With 'async' the namespaces are swapped for empty ones at once if the engine supports it, their old
+             * data is destroyed by the lazyfree cron.
+             */
+            int FlushDB(Context& ctx, const Data& ns, bool async = false);
+            int SwapNameSpace(Context& ctx, const Data& ns, const Data& from);
+            int FlushAll(Context& ctx, bool async = false);
+            void AddFlushedNameSpace(const Data& ns);
             int CompactDB(Context& ctx, const Data& ns);
             int CompactAll(Context& ctx);
 
             bool GetLongFromProtocol(Context& ctx, const std::string& str, int64_t& v);
 
             int FindElementByRedisCursor(const std::string& cursor, std::string& element);
-            uint64 GetNewRedisCursor(const std::string& element);
+            std::string GetNewRedisCursor(const std::string& element);
 
             int GetValueByPattern(Context& ctx, const Slice& pattern, Data& subst, Data& value);
+            void GetValuesByPattern(Context& ctx, const char* pattern, const DataArray& substs, DataArray& values);
 
-            void TryPushSlowCommand(const RedisCommandFrame& cmd, uint64 micros);
+            void TryPushSlowCommand(const RedisCommandFrame& cmd, uint64 micros, uint64 skipped_deletes, const EngineProfile* profile,
+                    int64 estimated_cost, int64 actual_cost);
             void GetSlowlog(Context& ctx, uint32 len);
             int ObjectLen(Context& ctx, KeyType type, const std::string& key);
 
@@ -206,12 +596,20 @@ OP_NAMESPACE_BEGIN
             int SubscribeChannel(Context& ctx, const std::string& channel, bool is_pattern);
             int UnsubscribeChannel(Context& ctx, const std::string& channel, bool is_pattern, bool notify);
             int UnsubscribeAll(Context& ctx, bool is_pattern, bool notify);
+            PubSubShard& GetPubSubShard(const std::string& channel);
             int PublishMessage(Context& ctx, const std::string& channel, const std::string& message);
+            int EnableTracking(Context& ctx, RedisCommandFrame& cmd);
+            int DisableTracking(Context& ctx);
+            void TrackKeysRead(Context& ctx, RedisCommandFrame& cmd);
+            void CollectTrackingTargets(uint32 writer, const TrackingClientSet& clients, TrackingClientSet& targets);
+            int SendInvalidation(const std::string* key, const TrackingClientSet& targets);
+            int FireKeysFlushedEvent(Context& ctx);
 
             int SetString(Context& ctx, const std::string& key, const std::string& value, bool redis_compatible, int64_t px = -1, int8_t nx_xx = -1);
 
             int ListPop(Context& ctx, RedisCommandFrame& cmd, bool lock_key = true);
             int ListPush(Context& ctx, RedisCommandFrame& cmd, bool lock_key = true);
+            int ListCompact(Context& ctx, const KeyObject& key);
 
             bool AdjustMergeOp(uint16& op, DataArray& args);
             int MergeAppend(Context& ctx, const KeyObject& key, ValueObject& val, const std::string& append);
@@ -221,18 +619,232 @@ OP_NAMESPACE_BEGIN
             int MergeSetRange(Context& ctx, const KeyObject& key, ValueObject& val, int64_t offset, const std::string& range);
             int MergeHSet(Context& ctx, const KeyObject& key, ValueObject& value, uint16_t op, const Data& v);
             int MergeHIncrby(Context& ctx, const KeyObject& key, ValueObject& value, uint16_t op, const Data& v);
+            int MergeSAdd(Context& ctx, const KeyObject& key, ValueObject& meta, int64 added);
             int MergeExpire(Context& ctx, const KeyObject& key, ValueObject& meta, int64 ms);
             int MergeSetBit(Context& ctx, const KeyObject& key, ValueObject& meta, int64 offset, uint8 bit, uint8* oldbit);
             int MergePFAdd(Context& ctx, const KeyObject& key, ValueObject& value, const DataArray& ms, int* updated = NULL);
+            int MergeBloomBits(Context& ctx, const KeyObject& key, ValueObject& chunk, const DataArray& bits);
+            int MergeCMSIncrBy(Context& ctx, const KeyObject& key, ValueObject& val, const DataArray& args);
+            int MergeTopKAdd(Context& ctx, const KeyObject& key, ValueObject& val, const DataArray& args, RedisReply* expelled);
 
             bool CheckMeta(Context& ctx, const std::string& key, KeyType expected);
             bool CheckMeta(Context& ctx, const std::string& key, KeyType expected, ValueObject& meta);
             bool CheckMeta(Context& ctx, const KeyObject& key, KeyType expected, ValueObject& meta, bool fetch = true);
+            void CheckStreamIterate(int64 elements, IterateOptions& options);
+            /*
+             * Start streaming the array reply of 'count' members if it's large enough & the reply goes to a network
+             * client from its event loop thread, StreamReplyMembers then sends the members added so far in chunks.
+             */
+            bool BeginStreamReply(Context& ctx, RedisReply& reply, int64 count);
+            void StreamReplyMembers(Context& ctx, RedisReply& reply);
+
+            bool HashPackEnabled();
+            bool PrepareHashPacked(ValueObject& meta);
+            bool HashFitsPacked(ValueObject& meta);
+            void SavePackedHash(Context& ctx, const KeyObject& meta_key, ValueObject& meta, bool unpack = false);
+            int64 RemoveHashFields(Context& ctx, const KeyObject& meta_key, ValueObject& meta, const StringArray& fields);
+            bool ExpireHashField(Context& ctx, const KeyObject& meta_key, const std::string& field, int64 ttl);
+            bool ObjectIdEnabled()
+            {
+                return m_object_id_enabled;
+            }
+            uint64 AllocObjectId();
+            void LoadObjectIds();
+            uint64 HashObjectId(ValueObject& meta);
+            void DelObjectFields(Context& ctx, const Data& ns, uint64 object_id);
+            void HashMultiGet(Context& ctx, KeyObjectArray& keys, ValueObjectArray& vals, ErrCodeArray& errs, bool create);
+            void LoadHashIndexes();
+            int SaveHashIndexes(Context& ctx, const HashIndexArray& idxs);
+            void ClearHashIndexes();
+            size_t GetHashIndexes(Context& ctx, const std::string& key, HashIndexArray& idxs);
+            bool IsHashIndexField(const HashIndexArray& idxs, const std::string& field);
+            bool GetHashIndexValue(Context& ctx, const KeyObject& meta_key, ValueObject& meta, const std::string& field, std::string& value);
+            void GetHashIndexValues(Context& ctx, const KeyObject& meta_key, ValueObject& meta, const HashIndexArray& idxs, HashIndexValues& values);
+            void UpdateHashIndexEntry(Context& ctx, const HashIndex& idx, size_t pos, const std::string& key, const std::string* old_value,
+                    const std::string* new_value);
+            void UpdateHashIndexes(Context& ctx, const HashIndexArray& idxs, const std::string& key, const std::string& field,
+                    const std::string* old_value, const std::string* new_value);
+            void UpdateHashIndexes(Context& ctx, const HashIndexArray& idxs, const std::string& key, const HashIndexValues& old_values,
+                    const HashIndexValues& new_values);
+            void RemoveHashIndexes(Context& ctx, const KeyObject& meta_key, ValueObject& meta);
+            void ClearHashIndexEntries(Context& ctx, const HashIndex& idx);
+            void FlushHashIndexes(Context& ctx, const Data& ns);
+            int64 BackfillHashIndex(Context& ctx, const HashIndex& idx);
+
+            /*
+             * Block of a zset rank index, 'fence' is the KEY_ZSET_RANK key of the block, 'count' is the stored count
+             * and 'delta' the pending change made by the current command.
+             */
+            struct ZRankBlock
+            {
+                    KeyObject fence;
+                    int64 count;
+                    int64 delta;
+                    bool removed;
+                    ZRankBlock() :
+                            count(0), delta(0), removed(false)
+                    {
+                    }
+            };
+            struct ZRankUpdates
+            {
+                    Iterator* iter;
+                    std::map<std::string, ZRankBlock> blocks; //blocks are referenced by pointer, which a btree map does not keep valid
+                    ZRankUpdates() :
+                            iter(NULL)
+                    {
+                    }
+                    ~ZRankUpdates()
+                    {
+                        DELETE(iter);
+                    }
+            };
+            int ZRankLocate(Context& ctx, ZRankUpdates& updates, const KeyObject& rank_key, ZRankBlock*& block, bool before = false);
+            void ZRankUpdate(Context& ctx, ZRankUpdates& updates, const KeyObject& sort_key, int64 delta);
+            void ZRankFlush(Context& ctx, ZRankUpdates& updates);
+            void ZRankSplit(Context& ctx, ZRankBlock& block);
+            void ZRankClear(Context& ctx, const KeyObject& meta_key);
+            void ZRankBuild(Context& ctx, const KeyObject& meta_key, ValueObject& meta);
+            void ZRankRebalance(Context& ctx, const KeyObject& meta_key, ValueObject& meta, ZRankUpdates& updates);
+            int64 ZRankOf(Context& ctx, const KeyObject& sort_key);
+            bool ZRankSeek(Context& ctx, const KeyObject& meta_key, int64 rank, KeyObject& sort_key, int64& skip);
+
+            /*
+             * Input set of SINTER/SUNION/SDIFF, its members are walked in order by 'iter', or looked up one by one
+             * when 'probe' is set.
+             */
+            struct SetOperand
+            {
+                    KeyObject key;
+                    ValueObject meta;
+                    Iterator* iter;
+                    bool probe;
+                    SetOperand() :
+                            iter(NULL), probe(false)
+                    {
+                    }
+                    ~SetOperand()
+                    {
+                        DELETE(iter);
+                    }
+            };
+            struct SetOperandSmaller
+            {
+                    bool operator()(SetOperand* a, SetOperand* b) const;
+            };
+            struct SetOperandGreater
+            {
+                    bool operator()(SetOperand* a, SetOperand* b) const;
+            };
+            /*
+             * Destination of a set operation, members are counted, replied or written to 'dest' as they are produced.
+             */
+            struct SetOpOutput
+            {
+                    int type;
+                    KeyObject dest;
+                    Data min, last;
+                    int64 count;
+                    SetOpOutput() :
+                            type(0), count(0)
+                    {
+                    }
+            };
+            void SetOpOpen(Context& ctx, SetOperand& op, const Data& from);
+            bool SetOpSeek(Context& ctx, SetOperand& op, const Data& member);
+            void SetOpEmit(Context& ctx, SetOpOutput& out, const Data& member);
+            void SetOpInter(Context& ctx, PointerArray<SetOperand*>& ops, const Data& max, SetOpOutput& out);
+            void SetOpUnion(Context& ctx, PointerArray<SetOperand*>& ops, SetOpOutput& out);
+            void SetOpDiff(Context& ctx, PointerArray<SetOperand*>& ops, SetOpOutput& out);
+            int SetOperation(Context& ctx, RedisCommandFrame& cmd);
+
+            /*
+             * Input of ZUNIONSTORE/ZINTERSTORE, a zset walked by its KEY_ZSET_SCORE keys or a set with score 1,
+             * 'idx' is the position in the command which orders the aggregation.
+             */
+            struct ZSetOperand
+            {
+                    KeyObject key;
+                    ValueObject meta;
+                    Iterator* iter;
+                    double weight;
+                    size_t idx;
+                    bool probe;
+                    ZSetOperand() :
+                            iter(NULL), weight(1.0), idx(0), probe(false)
+                    {
+                    }
+                    ~ZSetOperand()
+                    {
+                        DELETE(iter);
+                    }
+            };
+            struct ZSetOperandSmaller
+            {
+                    bool operator()(ZSetOperand* a, ZSetOperand* b) const;
+            };
+            struct ZSetOperandGreater
+            {
+                    bool operator()(ZSetOperand* a, ZSetOperand* b) const;
+            };
+            /*
+             * Members are written under 'dest' as they are merged, committed every 'zset-store-batch-size' members.
+             */
+            struct ZSetStoreOutput
+            {
+                    KeyObject dest;
+                    WriteBatchGuard* batch;
+                    int aggregate;
+                    std::vector<double> scores;
+                    std::vector<char> hits;
+                    Data min, max;
+                    int64 count;
+                    ZSetStoreOutput() :
+                            batch(NULL), aggregate(0), count(0)
+                    {
+                    }
+                    ~ZSetStoreOutput()
+                    {
+                        DELETE(batch);
+                    }
+            };
+            void ZSetOpOpen(Context& ctx, ZSetOperand& op, const Data& from);
+            bool ZSetOpSeek(Context& ctx, ZSetOperand& op, const Data& member, double& score);
+            void ZSetOpEmit(Context& ctx, ZSetStoreOutput& out, const Data& member);
+            void ZSetOpInter(Context& ctx, PointerArray<ZSetOperand*>& ops, const Data& max, ZSetStoreOutput& out);
+            void ZSetOpMerge(Context& ctx, PointerArray<ZSetOperand*>& ops, KeyType walk_type, ZSetStoreOutput& out);
+            void ZSetStoreMove(Context& ctx, const KeyObject& from, const KeyObject& to);
+
+            int SetBitmapChunk(Context& ctx, const KeyObject& key, int64 idx, const std::string& chunk);
+            int ChunkedSetBit(Context& ctx, const KeyObject& key, ValueObject& meta, const std::string& plain, int64 offset, uint8 on, uint8* oldbit);
+            int GetBitmapChunk(Context& ctx, const KeyObject& key, int64 idx, std::string& chunk);
+            void GetBitmapRange(Context& ctx, const KeyObject& key, ValueObject& meta, int64 offset, int64 len, std::string& bytes);
+            void ClearBitmapChunks(Context& ctx, const KeyObject& key);
+            int LoadBitmapChunks(Context& ctx, const KeyObject& key, ValueObject& meta);
+            int SetUnchunkedValue(Context& ctx, const KeyObject& key, ValueObject& meta);
+            int GetBloomChunks(Context& ctx, const KeyObject& key, int64 chunk_size, std::map<int64, std::string>& chunks);
+            int BloomAdd(Context& ctx, RedisCommandFrame& cmd, bool multi);
+            int BloomExists(Context& ctx, RedisCommandFrame& cmd, bool multi);
+            bool IsStream(ValueObject& meta);
+            bool IsVectorSet(ValueObject& meta);
+            int FindVectorElement(Context& ctx, const KeyObject& key, const VectorSet& vs, const std::string& name, int64& slot,
+                    VectorValue* v);
+            int SetVectorRecord(Context& ctx, const KeyObject& key, int64 slot, const std::string& record);
+            const char* KeyTypeName(ValueObject& meta);
+            bool EvalScanPredicate(Context& ctx, const std::string& sha1, const std::string& key, const std::string& element,
+                    const std::string& value, std::string& err);
+            int StreamRange(Context& ctx, const KeyObject& key, const StreamID& start, const StreamID& end, int64 count, bool reverse, RedisReply& entries);
+            int TrimStream(Context& ctx, const KeyObject& key, StreamMeta& sm, int64 maxlen, bool approx, std::string& open);
+            int ServeClientBlockedOnStream(Context& ctx, const KeyPrefix& key);
+            int SketchCreate(Context& ctx, RedisCommandFrame& cmd, const std::string& value);
+            int SketchUpdate(Context& ctx, RedisCommandFrame& cmd);
+            int TrimSeriesChunks(Context& ctx, const KeyObject& key, int64 before_idx, int64& chunks, int64& samples, int64& first_ts);
 
             int GetMinMax(Context& ctx, const KeyObject& key, ValueObject& meta, Iterator*& iter);
             int GetMinMax(Context& ctx, const KeyObject& key, KeyType ele_type, ValueObject& meta, Iterator*& iter);
 
-            int DelKey(Context& ctx, const KeyObject& meta_key, Iterator*& iter);
+            int DelKey(Context& ctx, const KeyObject& meta_key, Iterator*& iter, bool lazy = false);
+            int DelKey(Context& ctx, const KeyObject& meta_key, ValueObject* meta, Iterator*& iter, bool lazy);
             int DelKey(Context& ctx, const std::string& key);
             int DelKey(Context& ctx, const KeyObject& key);
             int MoveKey(Context& ctx, RedisCommandFrame& cmd);
@@ -244,6 +856,9 @@ OP_NAMESPACE_BEGIN
 
             int WatchForKey(Context& ctx, const std::string& key);
             int UnwatchKeys(Context& ctx);
+            uint32 GetWatchVersionSlot(const KeyPrefix& key);
+            bool WatchedKeysTouched(Context& ctx);
+            bool WatchedKeyTouched(Context& ctx, const Data& key);
             int TouchWatchedKeysOnFlush(Context& ctx, const Data& ns);
             int DiscardTransaction(Context& ctx);
 
@@ -253,6 +868,21 @@ OP_NAMESPACE_BEGIN
             int WakeClientsBlockingOnList(Context& ctx);
             int SignalListAsReady(Context& ctx, const std::string& key);
             int ServeClientBlockedOnList(Context& ctx, const KeyPrefix& key, const std::string& value);
+            BlockShard& GetBlockShard(const KeyPrefix& key);
+            Context* ClaimBlockedClient(BlockShard& shard, const KeyPrefix& key, bool plain_pop_only);
+            void PostBlockedPopResult(Context& client, const KeyPrefix& key, const std::string& value, bool lpop);
+            static void AsyncBlockedPopCallback(Channel* ch, void * data);
+            size_t HandoffListElements(Context& ctx, const std::string& key, std::deque<std::string>& elements, std::vector<bool>& lpops);
+
+            static void GetCommandKeys(RedisCommandFrame& cmd, StringArray& keys);
+            void InitClusterSlots();
+            uint16 GetClusterNode(const std::string& addr);
+            bool IsClusterReplicaOf(uint16 node);
+            bool RedirectClusterCommand(Context& ctx, RedisCommandFrame& cmd, bool asking, bool readonly);
+            void ClusterSlotsReply(RedisReply& reply);
+            std::string ClusterNodesInfo();
+            void ClusterTopologyChanged(Context& ctx);
+            int ClusterKeysInSlot(Context& ctx, uint16 slot, int64 limit, RedisReply* keys);
 
             int IncrDecrCommand(Context& ctx, RedisCommandFrame& cmd);
 
@@ -265,15 +895,25 @@ OP_NAMESPACE_BEGIN
             int LastSave(Context& ctx, RedisCommandFrame& cmd);
             int BGSave(Context& ctx, RedisCommandFrame& cmd);
             int Import(Context& ctx, RedisCommandFrame& cmd);
+            int Backup(Context& ctx, RedisCommandFrame& cmd);
             int Info(Context& ctx, RedisCommandFrame& cmd);
             int DBSize(Context& ctx, RedisCommandFrame& cmd);
             int Config(Context& ctx, RedisCommandFrame& cmd);
+            int ConfigSetEngineOption(Context& ctx, const std::string& option, const std::string& value);
             int SlowLog(Context& ctx, RedisCommandFrame& cmd);
+            int Latency(Context& ctx, RedisCommandFrame& cmd);
+            int HotKeys(Context& ctx, RedisCommandFrame& cmd);
+            int BGJobs(Context& ctx, RedisCommandFrame& cmd);
+            int Memory(Context& ctx, RedisCommandFrame& cmd);
             int Client(Context& ctx, RedisCommandFrame& cmd);
             int Keys(Context& ctx, RedisCommandFrame& cmd);
             int KeysCount(Context& ctx, RedisCommandFrame& cmd);
             int Randomkey(Context& ctx, RedisCommandFrame& cmd);
             int Scan(Context& ctx, RedisCommandFrame& cmd);
+            int Cluster(Context& ctx, RedisCommandFrame& cmd);
+            int Asking(Context& ctx, RedisCommandFrame& cmd);
+            int ReadOnly(Context& ctx, RedisCommandFrame& cmd);
+            int ReadWrite(Context& ctx, RedisCommandFrame& cmd);
 
             int Multi(Context& ctx, RedisCommandFrame& cmd);
             int Discard(Context& ctx, RedisCommandFrame& cmd);
@@ -292,6 +932,8 @@ OP_NAMESPACE_BEGIN
             int Sync(Context& ctx, RedisCommandFrame& cmd);
             int PSync(Context& ctx, RedisCommandFrame& cmd);
             int ReplConf(Context& ctx, RedisCommandFrame& cmd);
+            int Wait(Context& ctx, RedisCommandFrame& cmd);
+            int CDC(Context& ctx, RedisCommandFrame& cmd);
 
             int Ping(Context& ctx, RedisCommandFrame& cmd);
             int Echo(Context& ctx, RedisCommandFrame& cmd);
@@ -358,6 +1000,8 @@ OP_NAMESPACE_BEGIN
             int HSetNX(Context& ctx, RedisCommandFrame& cmd);
             int HVals(Context& ctx, RedisCommandFrame& cmd);
             int HScan(Context& ctx, RedisCommandFrame& cmd);
+            int HExpire(Context& ctx, RedisCommandFrame& cmd);
+            int HTTL(Context& ctx, RedisCommandFrame& cmd);
 
             int SAdd(Context& ctx, RedisCommandFrame& cmd);
             int SCard(Context& ctx, RedisCommandFrame& cmd);
@@ -434,13 +1078,56 @@ OP_NAMESPACE_BEGIN
             int PFCount(Context& ctx, RedisCommandFrame& cmd);
             int PFMerge(Context& ctx, RedisCommandFrame& cmd);
 
+            int BFReserve(Context& ctx, RedisCommandFrame& cmd);
+            int BFAdd(Context& ctx, RedisCommandFrame& cmd);
+            int BFMAdd(Context& ctx, RedisCommandFrame& cmd);
+            int BFExists(Context& ctx, RedisCommandFrame& cmd);
+            int BFMExists(Context& ctx, RedisCommandFrame& cmd);
+            int BFInfo(Context& ctx, RedisCommandFrame& cmd);
+
+            int TSCreate(Context& ctx, RedisCommandFrame& cmd);
+            int TSAdd(Context& ctx, RedisCommandFrame& cmd);
+            int TSGet(Context& ctx, RedisCommandFrame& cmd);
+            int TSRange(Context& ctx, RedisCommandFrame& cmd);
+            int TSInfo(Context& ctx, RedisCommandFrame& cmd);
+
+            int XAdd(Context& ctx, RedisCommandFrame& cmd);
+            int XLen(Context& ctx, RedisCommandFrame& cmd);
+            int XRange(Context& ctx, RedisCommandFrame& cmd);
+            int XRead(Context& ctx, RedisCommandFrame& cmd);
+            int XTrim(Context& ctx, RedisCommandFrame& cmd);
+            int XDel(Context& ctx, RedisCommandFrame& cmd);
+
+            int IndexCreate(Context& ctx, RedisCommandFrame& cmd);
+            int IndexDrop(Context& ctx, RedisCommandFrame& cmd);
+            int IndexList(Context& ctx, RedisCommandFrame& cmd);
+            int IndexRange(Context& ctx, RedisCommandFrame& cmd);
+
+            int CMSInitByDim(Context& ctx, RedisCommandFrame& cmd);
+            int CMSInitByProb(Context& ctx, RedisCommandFrame& cmd);
+            int CMSIncrBy(Context& ctx, RedisCommandFrame& cmd);
+            int CMSQuery(Context& ctx, RedisCommandFrame& cmd);
+            int CMSInfo(Context& ctx, RedisCommandFrame& cmd);
+            int TopKReserve(Context& ctx, RedisCommandFrame& cmd);
+            int TopKAdd(Context& ctx, RedisCommandFrame& cmd);
+            int TopKRead(Context& ctx, RedisCommandFrame& cmd);
+
+            int VAdd(Context& ctx, RedisCommandFrame& cmd);
+            int VRem(Context& ctx, RedisCommandFrame& cmd);
+            int VSim(Context& ctx, RedisCommandFrame& cmd);
+            int VInfo(Context& ctx, RedisCommandFrame& cmd);
+            int VEmb(Context& ctx, RedisCommandFrame& cmd);
+
             int Monitor(Context& ctx, RedisCommandFrame& cmd);
             int Dump(Context& ctx, RedisCommandFrame& cmd);
+            int DumpChunk(Context& ctx, RedisCommandFrame& cmd);
             int Restore(Context& ctx, RedisCommandFrame& cmd);
+            int RestoreAppend(Context& ctx, RedisCommandFrame& cmd, bool replace, int64 ttl);
             int Migrate(Context& ctx, RedisCommandFrame& cmd);
             int MigrateDB(Context& ctx, RedisCommandFrame& cmd);
             int RestoreDB(Context& ctx, RedisCommandFrame& cmd);
             int RestoreChunk(Context& ctx, RedisCommandFrame& cmd);
+            int Rebalance(Context& ctx, RedisCommandFrame& cmd);
             int Debug(Context& ctx, RedisCommandFrame& cmd);
             int CacheMemory(Context& ctx, RedisCommandFrame& cmd);
 
@@ -448,6 +1135,7 @@ OP_NAMESPACE_BEGIN
             int DoCall(Context& ctx, RedisCommandHandlerSetting& setting, RedisCommandFrame& cmd);
             RedisCommandHandlerSetting* FindRedisCommandHandlerSetting(RedisCommandFrame& cmd);
             void RenameCommand();
+            void BuildCommandTypeIndex();
 
             friend class LUAInterpreter;
             friend class ObjectIO;
@@ -455,11 +1143,19 @@ OP_NAMESPACE_BEGIN
             friend class Snapshot;
             friend class Master;
             friend class Slave;
+            friend class MetricsHandler;
         public:
             Ardb();
             int Init(const std::string& conf_file);
             int Repair(const std::string& dir);
+            bool IsLoadingData();
             int Call(Context& ctx, RedisCommandFrame& cmd);
+            bool IsEngineIOCommand(Context& ctx, RedisCommandFrame& cmd, bool& is_write);
+            bool IsRequestCoroCommand(Context& ctx, RedisCommandFrame& cmd);
+            bool IsSlowCommand(Context& ctx, RedisCommandFrame& cmd);
+            int32 GetCommandPartition(Context& ctx, RedisCommandFrame& cmd, uint32 partitions);
+            bool JoinPipelineBatch(Context& ctx, RedisCommandFrame& cmd);
+            void CommitPipelineBatch(Context& ctx);
             int MergeOperation(const KeyObject& key, ValueObject& val, uint16_t op, DataArray& args);
             int MergeOperands(uint16_t left, const DataArray& left_args, uint16_t& right, DataArray& right_args);
             void AddExpiredKey(const Data& ns, const Data& key);
@@ -467,14 +1163,44 @@ OP_NAMESPACE_BEGIN
             int TouchWatchKey(Context& ctx, const KeyObject& key);
             void FreeClient(Context& ctx);
             void AddClient(Context& ctx);
-            void ScanClients();
+            bool CanMigrateClient(Context& ctx);
+            int64 ClientCron(Context& ctx);
             int64 ScanExpiredKeys();
+            void AddListCompactKey(const Data& ns, const Data& key);
+            int64 CompactLists(int64 max_elements = kListCompactCronElements);
+            int64 ReclaimLazyFreeKeys();
+            int64 ReclaimFlushedData();
+            /*
+             * Compact namespace 'ns'(all for nil) in the background, only the ranges with many deleted entries
+             * unless 'full'. -1 if a compaction is running.
+             */
+            int StartCompaction(const Data& ns, bool full);
+            bool CancelCompaction();
+            void CompactionInfo(std::string& info);
+            void CompactOnDeletes();
+            int CompactQueuedRanges();
+            int DropExpiredTables();
+            int FlushPendingWrites();
+            int RestoreEngine(const std::string& dir);
             void DeleteKeyFromKeyCache(const string& key);
+            void SaveKeyCache();
+            void ReserveObjectIds();
+            void ObserveObjectId(uint64 id);
+            void PurgeFragmentedMemory();
+            bool IsReadReplica() const
+            {
+                return m_read_replica;
+            }
+            void RefreshReadReplica();
 
             const ArdbConfig& GetConf() const
             {
-                return m_conf;
+                return *m_conf_snapshot;
             }
+            /*
+             * Called with m_conf.lock held after m_conf is changed.
+             */
+            void PublishConf();
             ArdbConfig& GetMutableConf()
             {
                 return m_conf;
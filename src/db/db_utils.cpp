@@ -32,8 +32,11 @@
 #include "util/file_helper.hpp"
 #include "thread/event_condition.hpp"
 #include "db.hpp"
+#include "util/murmur3.h"
 
 #define DEFAULT_LOCAL_ENCODE_BUFFER_SIZE 8192
+#define DB_LOCAL_ENCODE_BUFFER_MAX_SIZE (1024 * 1024)
+#define DB_LOCAL_ENCODE_STATS_BATCH 1024
 
 #define ARDB_PUT_OP     1
 #define ARDB_PUT_RAW_OP 2
@@ -58,36 +61,91 @@ OP_NAMESPACE_BEGIN
         ss[1] = Slice(encode_buffer.GetRawBuffer() + key_len, value_len);
     }
 
+    static volatile uint64_t g_encode_buffer_reuses = 0;
+    static volatile uint64_t g_encode_buffer_grows = 0;
+
     Buffer& DBLocalContext::GetEncodeBufferCache()
     {
+        /*
+         * the previous encode allocated if the arena had to grow for it, counters are published in batches
+         * to keep the shared cache line off the hot path
+         */
+        if (0 == encode_buffer_capacity || encode_buffer_cache.Capacity() != encode_buffer_capacity)
+        {
+            encode_buffer_grows++;
+        }
+        else
+        {
+            encode_buffer_reuses++;
+        }
+        if (encode_buffer_reuses + encode_buffer_grows >= DB_LOCAL_ENCODE_STATS_BATCH)
+        {
+            atomic_add_uint64(&g_encode_buffer_reuses, encode_buffer_reuses);
+            atomic_add_uint64(&g_encode_buffer_grows, encode_buffer_grows);
+            encode_buffer_reuses = encode_buffer_grows = 0;
+        }
         encode_buffer_cache.Clear();
-        encode_buffer_cache.Compact(DEFAULT_LOCAL_ENCODE_BUFFER_SIZE);
+        if (encode_buffer_cache.Capacity() > DB_LOCAL_ENCODE_BUFFER_MAX_SIZE)
+        {
+            encode_buffer_cache.Release();
+        }
+        if (encode_buffer_cache.Capacity() == 0)
+        {
+            encode_buffer_cache.Reserve(DEFAULT_LOCAL_ENCODE_BUFFER_SIZE);
+        }
+        encode_buffer_capacity = encode_buffer_cache.Capacity();
         return encode_buffer_cache;
     }
 
+    void encode_buffer_stats(std::string& str)
+    {
+        str.append("encode_buffer_reuses:").append(stringfromll(g_encode_buffer_reuses)).append("\r\n");
+        str.append("encode_buffer_grows:").append(stringfromll(g_encode_buffer_grows)).append("\r\n");
+    }
+
     struct DBWriteOperation
     {
             RedisCommandFrame cmd;
             uint8 type;
+            KeyObject key;
+            ValueObject value;
+            Data ns;
+            std::string raw_key;
+            std::string raw_value;
     };
+    /*
+     * Puts popped in one round are written in one write batch of at most kWriterBatchSize entries.
+     */
+    static const int kWriterBatchSize = 1024;
     struct DBWriterWorker: public Thread
     {
             Context worker_ctx;
             SPSCQueue<DBWriteOperation*> write_queue;
             EventCondition event_cond;
             volatile uint32 queue_size;
+            volatile uint64 written;
+            volatile int err;
             bool running;
-            DBWriterWorker() :queue_size(0), running(true)
+            DBWriterWorker() :queue_size(0), written(0), err(0), running(true)
             {
                 worker_ctx.flags.create_if_notexist = 1;
                 worker_ctx.flags.bulk_loading = 1;
             }
+            void CheckErr(int ret)
+            {
+                if (0 != ret && 0 == err)
+                {
+                    err = ret;
+                    ERROR_LOG("Failed to write loaded data with err:%d", ret);
+                }
+            }
             void Run()
             {
                 while (running)
                 {
                     DBWriteOperation* op = NULL;
                     int count = 0;
+                    int batched = 0;
                     while (write_queue.Pop(op))
                     {
                         count++;
@@ -98,9 +156,36 @@ OP_NAMESPACE_BEGIN
                                 g_db->Call(worker_ctx, op->cmd);
                                 break;
                             }
+                            case ARDB_PUT_OP:
+                            case ARDB_PUT_RAW_OP:
+                            {
+                                if (0 == batched)
+                                {
+                                    g_engine->BeginWriteBatch(worker_ctx);
+                                }
+                                if (op->type == ARDB_PUT_OP)
+                                {
+                                    CheckErr(g_engine->Put(worker_ctx, op->key, op->value));
+                                }
+                                else
+                                {
+                                    CheckErr(g_engine->PutRaw(worker_ctx, op->ns, op->raw_key, op->raw_value));
+                                }
+                                written++;
+                                if (++batched >= kWriterBatchSize)
+                                {
+                                    CheckErr(g_engine->CommitWriteBatch(worker_ctx));
+                                    batched = 0;
+                                }
+                                break;
+                            }
                             case ARDB_CKP_OP:
                             {
-                                //g_engine->CommitWriteBatch(worker_ctx);
+                                if (batched > 0)
+                                {
+                                    CheckErr(g_engine->CommitWriteBatch(worker_ctx));
+                                    batched = 0;
+                                }
                                 event_cond.Notify();
                                 break;
                             }
@@ -113,6 +198,10 @@ OP_NAMESPACE_BEGIN
                         DELETE(op);
                         atomic_sub_uint32(&queue_size, 1);
                     }
+                    if (batched > 0)
+                    {
+                        CheckErr(g_engine->CommitWriteBatch(worker_ctx));
+                    }
                     if (count == 0)
                     {
                         Thread::Sleep(1, MILLIS);
@@ -156,7 +245,7 @@ OP_NAMESPACE_BEGIN
     };
 
     DBWriter::DBWriter(int workers) :
-            m_cursor(0)
+            m_cursor(0), m_start_time(get_current_epoch_millis()), m_written(0)
     {
         if (workers > 1)
         {
@@ -181,19 +270,73 @@ OP_NAMESPACE_BEGIN
         return worker;
     }
 
+    DBWriterWorker* DBWriter::GetWorker(const void* key, size_t len)
+    {
+        uint32_t hash = 0;
+        MurmurHash3_x86_32(key, len, 0, &hash);
+        return m_workers[hash % m_workers.size()];
+    }
+
     int DBWriter::Put(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
     {
-        /*
-         * multi thread only work faster for commands
-         */
-        return g_engine->PutRaw(ctx, ns, key, value);
+        if (m_workers.empty())
+        {
+            m_written++;
+            return g_engine->PutRaw(ctx, ns, key, value);
+        }
+        DBWriteOperation* op = NULL;
+        NEW(op, DBWriteOperation);
+        op->type = ARDB_PUT_RAW_OP;
+        op->ns.Clone(ns);
+        op->raw_key.assign(key.data(), key.size());
+        op->raw_value.assign(value.data(), value.size());
+        GetWorker(key.data(), key.size())->Offer(op);
+        return 0;
     }
     int DBWriter::Put(Context& ctx, const KeyObject& k, const ValueObject& value)
     {
-        /*
-         * multi thread only work faster for commands
-         */
-        return g_engine->Put(ctx, k, value);
+        if (m_workers.empty())
+        {
+            m_written++;
+            return g_engine->Put(ctx, k, value);
+        }
+        DBWriteOperation* op = NULL;
+        NEW(op, DBWriteOperation);
+        op->type = ARDB_PUT_OP;
+        op->key = k;
+        op->key.CloneStringPart();
+        op->value = value;
+        op->value.CloneStringPart();
+        const Data& name = k.GetKey();
+        GetWorker(name.CStr(), name.StringLength())->Offer(op);
+        return 0;
+    }
+    int DBWriter::Flush()
+    {
+        int err = 0;
+        for (size_t i = 0; i < m_workers.size(); i++)
+        {
+            m_workers[i]->WaitBatchWrite();
+            if (0 == err)
+            {
+                err = m_workers[i]->err;
+            }
+        }
+        return err;
+    }
+    uint64 DBWriter::WrittenCount()
+    {
+        uint64 count = m_written;
+        for (size_t i = 0; i < m_workers.size(); i++)
+        {
+            count += m_workers[i]->written;
+        }
+        return count;
+    }
+    uint64 DBWriter::WrittenPerSecond()
+    {
+        uint64 elapsed = get_current_epoch_millis() - m_start_time;
+        return elapsed > 0 ? WrittenCount() * 1000 / elapsed : 0;
     }
     void DBWriter::Stop()
     {
@@ -216,7 +359,7 @@ OP_NAMESPACE_BEGIN
 
     //KeyCacheWriter
     //@author Ilya Peresadin <peresadin@loayltyplant.com>
-    KeyCacheWriter::KeyCacheWriter(KeyCache* keyCache):keyCache(keyCache) {}
+    KeyCacheWriter::KeyCacheWriter(KeyCache* keyCache, int workers):DBWriter(workers), keyCache(keyCache) {}
     int KeyCacheWriter::Put(Context &ctx, const Data &ns, const Slice &key, const Slice &value) {
         Buffer buffer(const_cast<char*>(key.data()), 0, key.size());
         KeyObject k;
@@ -45,10 +45,21 @@
 
 OP_NAMESPACE_BEGIN
 
+    /*
+     * Per thread state shared by all engines. The encode buffer is an arena reset by every GetEncodeBufferCache,
+     * it keeps its space between operations unless one huge key/value grew it over DB_LOCAL_ENCODE_BUFFER_MAX_SIZE.
+     */
     struct DBLocalContext
     {
             Buffer encode_buffer_cache;
             std::string string_cache;
+            size_t encode_buffer_capacity;
+            uint32 encode_buffer_reuses;
+            uint32 encode_buffer_grows;
+            DBLocalContext() :
+                    encode_buffer_capacity(0), encode_buffer_reuses(0), encode_buffer_grows(0)
+            {
+            }
             Buffer& GetEncodeBufferCache();
             Slice GetSlice(const KeyObject& key);
             void GetSlices(const KeyObject& key, const ValueObject& val, Slice ss[2]);
@@ -62,10 +73,17 @@ OP_NAMESPACE_BEGIN
             }
     };
 
+    /*
+     * Encodes served from an already allocated arena & encodes that had to grow it, summed over all threads.
+     */
+    void encode_buffer_stats(std::string& str);
+
     /*
      *  A multi thread db writer, which could do db write operations by several threads to increase
      *  write performance.
      *  It's used in loading snapshot.
+     *  With more than one worker, puts are copied & queued to the worker chosen by the hash of the key name, so all
+     *  writes of one object keep their order while workers encode & write them in batches.
      */
     class DBWriterWorker;
     class DBWriter
@@ -73,20 +91,29 @@ OP_NAMESPACE_BEGIN
         private:
             std::vector<DBWriterWorker*> m_workers;
             uint32 m_cursor;
+            uint64 m_start_time;
+            volatile uint64 m_written;
             DBWriterWorker* GetWorker();
+            DBWriterWorker* GetWorker(const void* key, size_t len);
         public:
             DBWriter(int workers = 1);
             virtual int Put(Context& ctx, const Data& ns, const Slice& key, const Slice& value);
             virtual int Put(Context& ctx, const KeyObject& k, const ValueObject& value);
+            /*
+             * Waits until all queued puts are written, returns the first write error of workers.
+             */
+            int Flush();
+            uint64 WrittenCount();
+            uint64 WrittenPerSecond();
             void Stop();
-            ~DBWriter();
+            virtual ~DBWriter();
     };
 
     class KeyCacheWriter: public DBWriter {
     private:
         KeyCache *keyCache;
     public:
-        KeyCacheWriter(KeyCache* keyCache);
+        KeyCacheWriter(KeyCache* keyCache, int workers = 1);
         int Put(Context& ctx, const Data& ns, const Slice& key, const Slice& value);
         int Put(Context& ctx, const KeyObject& k, const ValueObject& value);
     };
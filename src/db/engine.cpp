@@ -28,9 +28,16 @@
  */
 #include "engine.hpp"
 #include <assert.h>
+#include <algorithm>
 
 OP_NAMESPACE_BEGIN
 
+    static void run_engine_blocking_call(Context& ctx, Runnable* task)
+    {
+        task->Run();
+    }
+    EngineBlockingCall* g_engine_blocking_call = run_engine_blocking_call;
+
     int compare_keyslices(const Slice& k1, const Slice& k2, bool has_ns)
     {
         return compare_keys(k1.data(), k1.size(), k2.data(), k2.size(), has_ns);
@@ -43,6 +50,15 @@ OP_NAMESPACE_BEGIN
         {
             return ret;
         }
+        if (is_ordered_key_codec(get_key_codec_version()))
+        {
+            ret = memcmp(k1, k2, k1_len < k2_len ? k1_len : k2_len);
+            if (0 != ret)
+            {
+                return ret;
+            }
+            return k1_len < k2_len ? -1 : (k1_len > k2_len ? 1 : 0);
+        }
 
         Buffer kbuf1(const_cast<char*>(k1), 0, k1_len);
         Buffer kbuf2(const_cast<char*>(k2), 0, k2_len);
@@ -140,6 +156,51 @@ OP_NAMESPACE_BEGIN
         return ret;
     }
 
+    void IterateOptions::SetObjectUpperBound(const KeyObject& key)
+    {
+        upper_bound.SetNameSpace(key.GetNameSpace());
+        if (key.GetType() == KEY_META)
+        {
+            upper_bound.SetType(KEY_END);
+        }
+        else
+        {
+            upper_bound.SetType(key.GetType() + 1);
+        }
+        upper_bound.SetKey(key.GetKey());
+        upper_bound.SetObjectId(key.GetObjectId());
+        upper_bound.CloneStringPart();
+    }
+
+    void IterateOptions::BoundToObject(const KeyObject& key)
+    {
+        /*
+         * elements of the lower bound key are nil, which are less than any element value
+         */
+        lower_bound.SetNameSpace(key.GetNameSpace());
+        lower_bound.SetType(key.GetType());
+        lower_bound.SetKey(key.GetKey());
+        lower_bound.SetObjectId(key.GetObjectId());
+        lower_bound.CloneStringPart();
+        SetObjectUpperBound(key);
+        prefix_only = true;
+    }
+
+    Iterator* Engine::Find(Context& ctx, const KeyObject& key)
+    {
+        IterateOptions options;
+        if (key.GetType() > 0 && !ctx.flags.iterate_multi_keys)
+        {
+            options.prefix_only = true;
+            if (!ctx.flags.iterate_no_upperbound)
+            {
+                options.SetObjectUpperBound(key);
+            }
+        }
+        options.total_order = ctx.flags.iterate_total_order;
+        return Find(ctx, key, options);
+    }
+
     int Engine::FlushAll(Context& ctx)
     {
         DataArray nss;
@@ -164,5 +225,27 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
+    struct KeyIndexLess
+    {
+            const KeyObjectArray& keys;
+            KeyIndexLess(const KeyObjectArray& ks) :
+                    keys(ks)
+            {
+            }
+            bool operator()(size_t i, size_t j) const
+            {
+                return keys[i].Compare(keys[j]) < 0;
+            }
+    };
+    void sort_keys_index(const KeyObjectArray& keys, std::vector<size_t>& idxs)
+    {
+        idxs.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            idxs[i] = i;
+        }
+        std::sort(idxs.begin(), idxs.end(), KeyIndexLess(keys));
+    }
+
 OP_NAMESPACE_END
 
@@ -63,13 +63,58 @@ OP_NAMESPACE_BEGIN
             }
     };
 
+    /*
+     * Iterate range hints for Engine::Find, keys out of [lower_bound, upper_bound) are invisible to the iterator,
+     * a bound with type KEY_UNKNOWN means unbounded.
+     */
+    struct IterateOptions
+    {
+            KeyObject lower_bound;
+            KeyObject upper_bound;
+            bool prefix_only; //only keys with the same namespace & key as the seek key would be visited
+            bool total_order; //the iterator may be moved backward by Prev/JumpToLast
+            bool streaming; //one pass over a large range, do not fill the block cache & read ahead if supported
+            IterateOptions() :
+                    prefix_only(false), total_order(false), streaming(false)
+            {
+            }
+            /*
+             * Upper bound after the last key of the object, which is all keys of the object for a meta key, or keys with same type.
+             */
+            void SetObjectUpperBound(const KeyObject& key);
+            /*
+             * Restrict the iterator to the keys of the object with same type as 'key'(all keys for a meta key).
+             */
+            void BoundToObject(const KeyObject& key);
+    };
+
     struct FeatureSet
     {
             unsigned support_namespace :1;
             unsigned support_compactfilter :1;
             unsigned support_merge :1;
+            unsigned support_snapshot_read :1; //reads between BeginSnapshotRead/EndSnapshotRead see one consistent snapshot
+            unsigned support_nested_write_batch :1; //DiscardWriteBatch of a nested batch only rolls back the writes since its BeginWriteBatch
+            unsigned support_delete_range :1; //DelRange drops a key range in one operation instead of one delete per key
+            unsigned support_checkpoint :1; //Checkpoint/Restore copy & replace the engine files as they are
+            unsigned support_swap_namespace :1; //SwapNameSpace moves a namespace in place of another without copying its keys
             FeatureSet() :
-                    support_namespace(0), support_compactfilter(0),support_merge(0)
+                    support_namespace(0), support_compactfilter(0),support_merge(0), support_snapshot_read(0), support_nested_write_batch(0), support_delete_range(0), support_checkpoint(
+                            0), support_swap_namespace(0)
+            {
+            }
+    };
+
+    /*
+     * Progress of a compaction run in the background, 'cancel' stops it before its next range.
+     */
+    struct CompactProgress
+    {
+            volatile uint32 total; //ranges found so far
+            volatile uint32 done;
+            volatile bool cancel;
+            CompactProgress() :
+                    total(0), done(0), cancel(false)
             {
             }
     };
@@ -91,11 +136,59 @@ OP_NAMESPACE_BEGIN
                 return Merge(ctx, key, op, DataArray(1, value));
             }
             virtual bool Exists(Context& ctx, const KeyObject& key) = 0;
+            /*
+             * Delete all keys in [start, end) of the namespace of 'start'.
+             */
+            virtual int DelRange(Context& ctx, const KeyObject& start, const KeyObject& end)
+            {
+                return ERR_NOTSUPPORTED;
+            }
 
-            virtual Iterator* Find(Context& ctx, const KeyObject& key) = 0;
+            virtual Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options) = 0;
+            /*
+             * Find with iterate options derived from ctx.flags(iterate_multi_keys/iterate_no_upperbound/iterate_total_order)
+             */
+            Iterator* Find(Context& ctx, const KeyObject& key);
 
             virtual int Compact(Context& ctx, const KeyObject& start, const KeyObject& end) = 0;
             virtual int CompactAll(Context& ctx);
+            /*
+             * Compact only the ranges of namespace 'ns' where deleted entries make at least 'min_deleted_percent' of
+             * all entries, one range after the other. ERR_NOTSUPPORTED if the engine keeps no count of deleted entries.
+             */
+            virtual int CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            /*
+             * Compact the key ranges the engine queued by itself, such as long runs of deleted entries skipped by
+             * iterators. Returns the number of ranges compacted.
+             */
+            virtual int CompactQueuedRanges(Context& ctx)
+            {
+                return 0;
+            }
+            /*
+             * Drop whole tables of keys which all expired without compacting them. Returns the number of tables dropped.
+             */
+            virtual int DropExpiredTables(Context& ctx)
+            {
+                return 0;
+            }
+            /*
+             * Deleted entries skipped by reads of the calling thread since it started, 0 if not counted.
+             */
+            virtual uint64_t GetThreadSkippedDeletes()
+            {
+                return 0;
+            }
+            /*
+             * Write out the writes the engine holds back in memory, returns the number of keys written.
+             */
+            virtual int FlushPendingWrites(Context& ctx)
+            {
+                return 0;
+            }
 
             virtual int BeginWriteBatch(Context& ctx) = 0;
             virtual int CommitWriteBatch(Context& ctx) = 0;
@@ -103,6 +196,37 @@ OP_NAMESPACE_BEGIN
 
             virtual int ListNameSpaces(Context& ctx, DataArray& nss) = 0;
             virtual int DropNameSpace(Context& ctx, const Data& ns) = 0;
+            /*
+             * Swap namespace 'ns' for an empty one at once, the old data is only destroyed by ReclaimDetachedNameSpaces.
+             * ERR_NOTSUPPORTED if the engine can not drop a namespace without visiting its keys.
+             */
+            virtual int DetachNameSpace(Context& ctx, const Data& ns)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            /*
+             * Destroy the data of one detached namespace, returns the number of detached namespaces left.
+             */
+            virtual int ReclaimDetachedNameSpaces(Context& ctx)
+            {
+                return 0;
+            }
+            /*
+             * Move the data of namespace 'from' in place of namespace 'ns' at once, 'from' is gone afterwards and the old
+             * data of 'ns' is detached as by DetachNameSpace.
+             */
+            virtual int SwapNameSpace(Context& ctx, const Data& ns, const Data& from)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            /*
+             * Catch up with the writes of the instance owning the data dir, only for an engine opened read only by
+             * 'rocksdb-read-replica-of'. Callers make sure no reads run meanwhile.
+             */
+            virtual int Refresh(Context& ctx)
+            {
+                return ERR_NOTSUPPORTED;
+            }
 
             virtual int Flush(Context& ctx, const Data& ns)
             {
@@ -115,12 +239,90 @@ OP_NAMESPACE_BEGIN
                 return ERR_NOTSUPPORTED;
             }
 
+            /*
+             * All reads issued by current thread between BeginSnapshotRead & EndSnapshotRead
+             * see one consistent snapshot, calls can be nested.
+             */
+            virtual int BeginSnapshotRead(Context& ctx)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            virtual int EndSnapshotRead(Context& ctx)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            /*
+             * A snapshot not bound to any thread, several threads read it by BeginSharedSnapshotRead/EndSnapshotRead,
+             * it is released by ReleaseSharedSnapshot after all readers ended.
+             */
+            virtual const void* CreateSharedSnapshot(Context& ctx)
+            {
+                return NULL;
+            }
+            virtual int BeginSharedSnapshotRead(Context& ctx, const void* snapshot)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            virtual void ReleaseSharedSnapshot(Context& ctx, const void* snapshot)
+            {
+            }
+
             virtual int EndBulkLoad(Context& ctx)
             {
                 return ERR_NOTSUPPORTED;
             }
 
             virtual int64_t EstimateKeysNum(Context& ctx, const Data& ns) = 0;
+            /*
+             * Sequence of the last write, persisted across restarts. -1 if the engine has none.
+             */
+            virtual int64_t GetLatestSequence()
+            {
+                return -1;
+            }
+            /*
+             * Consistent copy of all engine files into the new directory 'dir', hard linked when possible.
+             */
+            virtual int Checkpoint(Context& ctx, const std::string& dir)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            /*
+             * Replace all data with the checkpoint in 'dir', the directory is moved into place.
+             */
+            virtual int Restore(Context& ctx, const std::string& dir)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            /*
+             * Applies one option of '<engine>.options' to the running engine, ERR_NOTSUPPORTED for options
+             * that are only read when the engine opens.
+             */
+            virtual int SetOption(Context& ctx, const std::string& name, const std::string& value)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            /*
+             * true while writes would be slowed down or stopped by the engine(e.g. too many level 0 files), callers
+             * may shed writes instead of blocking in them.
+             */
+            virtual bool IsWriteStalled()
+            {
+                return false;
+            }
+            /*
+             * Puts into namespace 'ns' between BeginBulkIngest & EndBulkIngest are sorted into engine files
+             * and added to the engine at the end instead of being written one by one, 'abort' drops them.
+             * Only for namespaces nobody else reads or writes meanwhile.
+             */
+            virtual int BeginBulkIngest(Context& ctx, const Data& ns)
+            {
+                return ERR_NOTSUPPORTED;
+            }
+            virtual int EndBulkIngest(Context& ctx, const Data& ns, bool abort)
+            {
+                return ERR_NOTSUPPORTED;
+            }
             virtual void Stats(Context& ctx, std::string& str) = 0;
 
             virtual const std::string GetErrorReason(int err) = 0;
@@ -168,8 +370,20 @@ OP_NAMESPACE_BEGIN
     };
 
     int compare_keys(const char* k1, size_t k1_len, const char* k2, size_t k2_len, bool has_ns);
+    /*
+     * Fill the indexes of keys sorted in storage order, MultiGet visits keys in this order for better locality.
+     */
+    void sort_keys_index(const KeyObjectArray& keys, std::vector<size_t>& idxs);
     int compare_keyslices(const Slice& k1, const Slice& k2, bool has_ns);
 
+    /*
+     * Runs 'task' which may block on disk & returns once it has run. Engines call it for reads of request coroutines
+     * (ctx.flags.request_coro) missing their caches, the server then hands the task to the engine io threads & yields
+     * the coroutine to its event loop meanwhile. Runs the task inline by default.
+     */
+    typedef void EngineBlockingCall(Context& ctx, Runnable* task);
+    extern EngineBlockingCall* g_engine_blocking_call;
+
     extern Engine* g_engine;
 OP_NAMESPACE_END
 
@@ -0,0 +1,371 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "engine_profiler.hpp"
+#include "thread/thread_local.hpp"
+#include "util/atomic.hpp"
+
+OP_NAMESPACE_BEGIN
+
+    bool g_engine_profiling = false;
+    static ThreadLocal<EngineProfile*> g_current_profile(false);
+
+    EngineProfile*& CurrentEngineProfile()
+    {
+        return g_current_profile.GetValue();
+    }
+
+    void EngineProfileStat::Add(const EngineProfile& profile)
+    {
+        atomic_add_uint64(&calls, 1);
+        atomic_add_uint64(&engine_nanos, profile.engine_nanos);
+        atomic_add_uint64(&engine_ops, profile.engine_ops);
+        atomic_add_uint64(&iterate_nanos, profile.iterate_nanos);
+        atomic_add_uint64(&iterate_ops, profile.iterate_ops);
+        atomic_add_uint64(&lock_wait_nanos, profile.lock_wait_nanos);
+        atomic_add_uint64(&codec_nanos, profile.codec_nanos);
+        atomic_add_uint64(&read_bytes, profile.read_bytes);
+        atomic_add_uint64(&written_bytes, profile.written_bytes);
+    }
+
+    void EngineProfileStat::Clear()
+    {
+        calls = engine_nanos = engine_ops = iterate_nanos = iterate_ops = lock_wait_nanos = codec_nanos = read_bytes = written_bytes = 0;
+    }
+
+    void EngineProfileStat::Dump(const std::string& name, std::string& info)
+    {
+        if (0 == calls)
+        {
+            return;
+        }
+        info.append("engineprofile_").append(name).append(":calls=").append(stringfromll(calls));
+        info.append(",engine_usec=").append(stringfromll(engine_nanos / 1000)).append(",engine_ops=").append(stringfromll(engine_ops));
+        info.append(",iterate_usec=").append(stringfromll(iterate_nanos / 1000)).append(",iterate_ops=").append(stringfromll(iterate_ops));
+        info.append(",lock_wait_usec=").append(stringfromll(lock_wait_nanos / 1000)).append(",codec_usec=").append(stringfromll(codec_nanos / 1000));
+        info.append(",read_bytes=").append(stringfromll(read_bytes)).append(",written_bytes=").append(stringfromll(written_bytes)).append("\r\n");
+    }
+
+#define PROFILE_ENGINE_OP(ctx) \
+        ctx.profile.engine_ops++; \
+        EngineProfileScope profile_scope(&ctx.profile, &EngineProfile::engine_nanos)
+
+    /*
+     * Iterator moves are accounted to the profile of the command running on the calling thread.
+     */
+    class ProfiledIterator: public Iterator
+    {
+        private:
+            Iterator* m_iter;
+            EngineProfile* Moved()
+            {
+                EngineProfile* profile = CurrentEngineProfile();
+                if (NULL != profile)
+                {
+                    profile->iterate_ops++;
+                }
+                return profile;
+            }
+        public:
+            ProfiledIterator(Iterator* iter) :
+                    m_iter(iter)
+            {
+            }
+            bool Valid()
+            {
+                return m_iter->Valid();
+            }
+            void Next()
+            {
+                EngineProfileScope scope(Moved(), &EngineProfile::iterate_nanos);
+                m_iter->Next();
+            }
+            void Prev()
+            {
+                EngineProfileScope scope(Moved(), &EngineProfile::iterate_nanos);
+                m_iter->Prev();
+            }
+            void Jump(const KeyObject& next)
+            {
+                EngineProfileScope scope(Moved(), &EngineProfile::iterate_nanos);
+                m_iter->Jump(next);
+            }
+            void JumpToFirst()
+            {
+                EngineProfileScope scope(Moved(), &EngineProfile::iterate_nanos);
+                m_iter->JumpToFirst();
+            }
+            void JumpToLast()
+            {
+                EngineProfileScope scope(Moved(), &EngineProfile::iterate_nanos);
+                m_iter->JumpToLast();
+            }
+            KeyObject& Key(bool clone_str)
+            {
+                return m_iter->Key(clone_str);
+            }
+            Slice RawKey()
+            {
+                return m_iter->RawKey();
+            }
+            Slice RawValue()
+            {
+                return m_iter->RawValue();
+            }
+            ValueObject& Value(bool clone_str)
+            {
+                return m_iter->Value(clone_str);
+            }
+            void Del()
+            {
+                EngineProfileScope scope(Moved(), &EngineProfile::iterate_nanos);
+                m_iter->Del();
+            }
+            ~ProfiledIterator()
+            {
+                DELETE(m_iter);
+            }
+    };
+
+    ProfiledEngine::ProfiledEngine(Engine* engine) :
+            m_engine(engine)
+    {
+    }
+    int ProfiledEngine::Init(const std::string& dir, const std::string& options)
+    {
+        return m_engine->Init(dir, options);
+    }
+    int ProfiledEngine::Repair(const std::string& dir)
+    {
+        return m_engine->Repair(dir);
+    }
+    int ProfiledEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        ctx.profile.written_bytes += value.size();
+        return m_engine->PutRaw(ctx, ns, key, value);
+    }
+    int ProfiledEngine::Put(Context& ctx, const KeyObject& key, const ValueObject& value)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->Put(ctx, key, value);
+    }
+    int ProfiledEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->Get(ctx, key, value);
+    }
+    int ProfiledEngine::Del(Context& ctx, const KeyObject& key)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->Del(ctx, key);
+    }
+    int ProfiledEngine::MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->MultiGet(ctx, keys, values, errs);
+    }
+    int ProfiledEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->Merge(ctx, key, op, values);
+    }
+    bool ProfiledEngine::Exists(Context& ctx, const KeyObject& key)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->Exists(ctx, key);
+    }
+    int ProfiledEngine::DelRange(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->DelRange(ctx, start, end);
+    }
+    Iterator* ProfiledEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
+    {
+        ctx.profile.iterate_ops++;
+        EngineProfileScope scope(&ctx.profile, &EngineProfile::iterate_nanos);
+        Iterator* iter = m_engine->Find(ctx, key, options);
+        if (NULL == iter)
+        {
+            return NULL;
+        }
+        Iterator* profiled = NULL;
+        NEW(profiled, ProfiledIterator(iter));
+        return profiled;
+    }
+    int ProfiledEngine::Compact(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        return m_engine->Compact(ctx, start, end);
+    }
+    int ProfiledEngine::CompactAll(Context& ctx)
+    {
+        return m_engine->CompactAll(ctx);
+    }
+    int ProfiledEngine::CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress)
+    {
+        return m_engine->CompactDeleted(ctx, ns, min_deleted_percent, progress);
+    }
+    int ProfiledEngine::CompactQueuedRanges(Context& ctx)
+    {
+        return m_engine->CompactQueuedRanges(ctx);
+    }
+    int ProfiledEngine::DropExpiredTables(Context& ctx)
+    {
+        return m_engine->DropExpiredTables(ctx);
+    }
+    uint64_t ProfiledEngine::GetThreadSkippedDeletes()
+    {
+        return m_engine->GetThreadSkippedDeletes();
+    }
+    int ProfiledEngine::FlushPendingWrites(Context& ctx)
+    {
+        return m_engine->FlushPendingWrites(ctx);
+    }
+    int ProfiledEngine::BeginWriteBatch(Context& ctx)
+    {
+        return m_engine->BeginWriteBatch(ctx);
+    }
+    int ProfiledEngine::CommitWriteBatch(Context& ctx)
+    {
+        PROFILE_ENGINE_OP(ctx);
+        return m_engine->CommitWriteBatch(ctx);
+    }
+    int ProfiledEngine::DiscardWriteBatch(Context& ctx)
+    {
+        return m_engine->DiscardWriteBatch(ctx);
+    }
+    int ProfiledEngine::ListNameSpaces(Context& ctx, DataArray& nss)
+    {
+        return m_engine->ListNameSpaces(ctx, nss);
+    }
+    int ProfiledEngine::DropNameSpace(Context& ctx, const Data& ns)
+    {
+        return m_engine->DropNameSpace(ctx, ns);
+    }
+    int ProfiledEngine::DetachNameSpace(Context& ctx, const Data& ns)
+    {
+        return m_engine->DetachNameSpace(ctx, ns);
+    }
+    int ProfiledEngine::SwapNameSpace(Context& ctx, const Data& ns, const Data& from)
+    {
+        return m_engine->SwapNameSpace(ctx, ns, from);
+    }
+    int ProfiledEngine::Refresh(Context& ctx)
+    {
+        return m_engine->Refresh(ctx);
+    }
+    int ProfiledEngine::ReclaimDetachedNameSpaces(Context& ctx)
+    {
+        return m_engine->ReclaimDetachedNameSpaces(ctx);
+    }
+    int ProfiledEngine::Flush(Context& ctx, const Data& ns)
+    {
+        return m_engine->Flush(ctx, ns);
+    }
+    int ProfiledEngine::FlushAll(Context& ctx)
+    {
+        return m_engine->FlushAll(ctx);
+    }
+    int ProfiledEngine::BeginBulkLoad(Context& ctx)
+    {
+        return m_engine->BeginBulkLoad(ctx);
+    }
+    int ProfiledEngine::BeginSnapshotRead(Context& ctx)
+    {
+        return m_engine->BeginSnapshotRead(ctx);
+    }
+    int ProfiledEngine::EndSnapshotRead(Context& ctx)
+    {
+        return m_engine->EndSnapshotRead(ctx);
+    }
+    const void* ProfiledEngine::CreateSharedSnapshot(Context& ctx)
+    {
+        return m_engine->CreateSharedSnapshot(ctx);
+    }
+    int ProfiledEngine::BeginSharedSnapshotRead(Context& ctx, const void* snapshot)
+    {
+        return m_engine->BeginSharedSnapshotRead(ctx, snapshot);
+    }
+    void ProfiledEngine::ReleaseSharedSnapshot(Context& ctx, const void* snapshot)
+    {
+        m_engine->ReleaseSharedSnapshot(ctx, snapshot);
+    }
+    int ProfiledEngine::EndBulkLoad(Context& ctx)
+    {
+        return m_engine->EndBulkLoad(ctx);
+    }
+    int64_t ProfiledEngine::EstimateKeysNum(Context& ctx, const Data& ns)
+    {
+        return m_engine->EstimateKeysNum(ctx, ns);
+    }
+    int64_t ProfiledEngine::GetLatestSequence()
+    {
+        return m_engine->GetLatestSequence();
+    }
+    int ProfiledEngine::Checkpoint(Context& ctx, const std::string& dir)
+    {
+        return m_engine->Checkpoint(ctx, dir);
+    }
+    int ProfiledEngine::SetOption(Context& ctx, const std::string& name, const std::string& value)
+    {
+        return m_engine->SetOption(ctx, name, value);
+    }
+    bool ProfiledEngine::IsWriteStalled()
+    {
+        return m_engine->IsWriteStalled();
+    }
+    int ProfiledEngine::Restore(Context& ctx, const std::string& dir)
+    {
+        return m_engine->Restore(ctx, dir);
+    }
+    int ProfiledEngine::BeginBulkIngest(Context& ctx, const Data& ns)
+    {
+        return m_engine->BeginBulkIngest(ctx, ns);
+    }
+    int ProfiledEngine::EndBulkIngest(Context& ctx, const Data& ns, bool abort)
+    {
+        return m_engine->EndBulkIngest(ctx, ns, abort);
+    }
+    void ProfiledEngine::Stats(Context& ctx, std::string& str)
+    {
+        m_engine->Stats(ctx, str);
+    }
+    const std::string ProfiledEngine::GetErrorReason(int err)
+    {
+        return m_engine->GetErrorReason(err);
+    }
+    const FeatureSet ProfiledEngine::GetFeatureSet()
+    {
+        return m_engine->GetFeatureSet();
+    }
+    ProfiledEngine::~ProfiledEngine()
+    {
+        DELETE(m_engine);
+    }
+
+OP_NAMESPACE_END
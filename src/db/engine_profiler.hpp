@@ -0,0 +1,158 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_DB_ENGINE_PROFILER_HPP_
+#define SRC_DB_ENGINE_PROFILER_HPP_
+
+#include "engine.hpp"
+#include <time.h>
+
+OP_NAMESPACE_BEGIN
+
+    /*
+     * engine-profiling: the engine is wrapped by ProfiledEngine at start, a server started without it runs the engine
+     * as is & only tests g_engine_profiling in DoCall, key locks & value codecs.
+     */
+    extern bool g_engine_profiling;
+
+    inline uint64 profile_nanos()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    /*
+     * Profile of the command running on this thread, set by DoCall. Iterators & value codecs have no Context at hand.
+     */
+    EngineProfile*& CurrentEngineProfile();
+
+    /*
+     * Adds the time from construction to destruction to one counter of the current profile.
+     */
+    struct EngineProfileScope
+    {
+            EngineProfile* profile;
+            uint64 EngineProfile::* field;
+            uint64 start;
+            EngineProfileScope(EngineProfile* p, uint64 EngineProfile::* f) :
+                    profile(p), field(f), start(NULL != p ? profile_nanos() : 0)
+            {
+            }
+            ~EngineProfileScope()
+            {
+                if (NULL != profile)
+                {
+                    profile->*field += profile_nanos() - start;
+                }
+            }
+    };
+
+    /*
+     * Profiles of all calls of one command, summed by DoCall with atomic adds.
+     */
+    struct EngineProfileStat
+    {
+            volatile uint64_t calls;
+            volatile uint64_t engine_nanos;
+            volatile uint64_t engine_ops;
+            volatile uint64_t iterate_nanos;
+            volatile uint64_t iterate_ops;
+            volatile uint64_t lock_wait_nanos;
+            volatile uint64_t codec_nanos;
+            volatile uint64_t read_bytes;
+            volatile uint64_t written_bytes;
+            EngineProfileStat()
+            {
+                Clear();
+            }
+            void Add(const EngineProfile& profile);
+            void Clear();
+            void Dump(const std::string& name, std::string& info);
+    };
+
+    class ProfiledEngine: public Engine
+    {
+        private:
+            Engine* m_engine;
+        public:
+            ProfiledEngine(Engine* engine);
+            int Init(const std::string& dir, const std::string& options);
+            int Repair(const std::string& dir);
+            int PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value);
+            int Put(Context& ctx, const KeyObject& key, const ValueObject& value);
+            int Get(Context& ctx, const KeyObject& key, ValueObject& value);
+            int Del(Context& ctx, const KeyObject& key);
+            int MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs);
+            int Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values);
+            bool Exists(Context& ctx, const KeyObject& key);
+            int DelRange(Context& ctx, const KeyObject& start, const KeyObject& end);
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
+            int Compact(Context& ctx, const KeyObject& start, const KeyObject& end);
+            int CompactAll(Context& ctx);
+            int CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress);
+            int CompactQueuedRanges(Context& ctx);
+            int DropExpiredTables(Context& ctx);
+            uint64_t GetThreadSkippedDeletes();
+            int FlushPendingWrites(Context& ctx);
+            int BeginWriteBatch(Context& ctx);
+            int CommitWriteBatch(Context& ctx);
+            int DiscardWriteBatch(Context& ctx);
+            int ListNameSpaces(Context& ctx, DataArray& nss);
+            int DropNameSpace(Context& ctx, const Data& ns);
+            int DetachNameSpace(Context& ctx, const Data& ns);
+            int SwapNameSpace(Context& ctx, const Data& ns, const Data& from);
+            int Refresh(Context& ctx);
+            int ReclaimDetachedNameSpaces(Context& ctx);
+            int Flush(Context& ctx, const Data& ns);
+            int FlushAll(Context& ctx);
+            int BeginBulkLoad(Context& ctx);
+            int BeginSnapshotRead(Context& ctx);
+            int EndSnapshotRead(Context& ctx);
+            const void* CreateSharedSnapshot(Context& ctx);
+            int BeginSharedSnapshotRead(Context& ctx, const void* snapshot);
+            void ReleaseSharedSnapshot(Context& ctx, const void* snapshot);
+            int EndBulkLoad(Context& ctx);
+            int64_t EstimateKeysNum(Context& ctx, const Data& ns);
+            int64_t GetLatestSequence();
+            int Checkpoint(Context& ctx, const std::string& dir);
+            int SetOption(Context& ctx, const std::string& name, const std::string& value);
+            bool IsWriteStalled();
+            int Restore(Context& ctx, const std::string& dir);
+            int BeginBulkIngest(Context& ctx, const Data& ns);
+            int EndBulkIngest(Context& ctx, const Data& ns, bool abort);
+            void Stats(Context& ctx, std::string& str);
+            const std::string GetErrorReason(int err);
+            const FeatureSet GetFeatureSet();
+            ~ProfiledEngine();
+    };
+
+OP_NAMESPACE_END
+
+#endif /* SRC_DB_ENGINE_PROFILER_HPP_ */
@@ -32,6 +32,8 @@
 #include "db/db_utils.hpp"
 #include "util/helpers.hpp"
 #include "thread/lock_guard.hpp"
+#include "thread/thread.hpp"
+#include "util/atomic.hpp"
 #include <string.h>
 #include <unistd.h>
 #include "forestdb_engine.hpp"
@@ -57,6 +59,13 @@ namespace ardb
     {
         return compare_keys((const char*) a, len_a, (const char*) b, len_b, false);
     }
+    /*
+     * KEY_CODEC_V2 & V3 keys sort bytewise, which is the default order of forestdb.
+     */
+    static fdb_custom_cmp_variable fdb_key_cmp()
+    {
+        return is_ordered_key_codec(get_key_codec_version()) ? NULL : fdb_cmp_callback;
+    }
 
     static fdb_compact_decision ardb_fdb_compaction_callback(fdb_file_handle *fhandle, fdb_compaction_status status, const char *kv_store_name, fdb_doc *doc,
             uint64_t last_oldfile_offset, uint64_t last_newfile_offset, void *ctx)
@@ -91,7 +100,7 @@ namespace ardb
             }
             if (meta.GetTTL() > 0 && meta.GetTTL() <= get_current_epoch_millis())
             {
-                if (meta.GetType() != KEY_STRING)
+                if (meta.GetType() != KEY_STRING || meta.IsChunked())
                 {
                     Data ns;
                     ns.SetString(kv_store_name, false);
@@ -111,8 +120,47 @@ namespace ardb
     static std::string g_fdb_dir;
     static fdb_config g_fdb_config;
 
+    /*
+     * Writes outside a transaction are made durable by one commit for every 'commit_ops' writes,
+     * or by the commit thread every 'commit_interval' ms, a commit writes the pending writes of all handles.
+     * Both 0 means commit after every write.
+     */
+    struct FDBCommitConfig
+    {
+            int64 commit_interval;
+            int64 commit_ops;
+            fdb_commit_opt_t commit_opt;
+            FDBCommitConfig() :
+                    commit_interval(0), commit_ops(0), commit_opt(FDB_COMMIT_NORMAL)
+            {
+            }
+    };
+    static FDBCommitConfig g_fdb_commit_config;
+    static volatile uint64_t g_fdb_pending_writes = 0;
+    static volatile uint64_t g_fdb_commits = 0;
+    static volatile uint64_t g_fdb_committed_writes = 0;
+
+    /*
+     * commit if at least 'min_pending' writes are not committed yet
+     */
+    static void commit_pending_writes(fdb_file_handle* fdb, uint64_t min_pending)
+    {
+        uint64_t pending = 0;
+        do
+        {
+            pending = g_fdb_pending_writes;
+            if (0 == pending || pending < min_pending)
+            {
+                return;
+            }
+        } while (!atomic_cmp_set_uint64(&g_fdb_pending_writes, pending, 0));
+        CHECK_EXPR(fdb_commit(fdb, g_fdb_commit_config.commit_opt));
+        atomic_add_uint64(&g_fdb_commits, 1);
+        atomic_add_uint64(&g_fdb_committed_writes, pending);
+    }
+
 
-    struct ForestDBLocalContext
+    struct ForestDBLocalContext: public DBLocalContext
     {
             fdb_file_handle* fdb;
             fdb_file_handle* metadb;
@@ -122,7 +170,7 @@ namespace ardb
             KVStoreTable kv_stores;
             uint32 txn_ref;
             LocalIteratorSet iters;bool txn_abort;
-            Buffer encode_buffer_cache;bool inited;
+            bool inited;
             ForestDBLocalContext() :
                     fdb(NULL), metadb(NULL), metakv(NULL), txn_ref(0), txn_abort(false), inited(false)
             {
@@ -140,7 +188,7 @@ namespace ardb
                 }
                 fdb_kvs_config config = fdb_get_default_kvs_config();
                 config.create_if_missing = create_if_missing;
-                config.custom_cmp = fdb_cmp_callback;
+                config.custom_cmp = fdb_key_cmp();
                 fdb_kvs_handle* kvs;
                 fdb_status fs = fdb_kvs_open(fdb, &kvs, ns.AsString().c_str(), &config);
                 if (0 != fs)
@@ -238,7 +286,7 @@ namespace ardb
                     for (size_t i = 0; i < nss.size(); i++)
                     {
                         names[i] = nss[i].CStr();
-                        cmps[i] = fdb_cmp_callback;
+                        cmps[i] = fdb_key_cmp();
                     }
                     fs = fdb_open_custom_cmp(&fdb, data_file.c_str(), &config, nss.size(), (char **) names, cmps);
                     if (0 == fs)
@@ -310,10 +358,25 @@ namespace ardb
                 }
                 return rc;
             }
-            Buffer& GetEncodeBuferCache()
+            void CommitWrite()
             {
-                encode_buffer_cache.Clear();
-                return encode_buffer_cache;
+                if (txn_ref > 0)
+                {
+                    /*
+                     * committed by the end of the transaction
+                     */
+                    return;
+                }
+                if (g_fdb_commit_config.commit_interval <= 0 && g_fdb_commit_config.commit_ops <= 1)
+                {
+                    CHECK_EXPR(fdb_commit(fdb, g_fdb_commit_config.commit_opt));
+                    return;
+                }
+                atomic_add_uint64(&g_fdb_pending_writes, 1);
+                if (g_fdb_commit_config.commit_ops > 0)
+                {
+                    commit_pending_writes(fdb, g_fdb_commit_config.commit_ops);
+                }
             }
             ~ForestDBLocalContext()
             {
@@ -336,6 +399,41 @@ namespace ardb
         return local_ctx;
     }
 
+    class ForestDBCommitThread: public Thread
+    {
+        private:
+            ThreadMutexLock m_lock;
+            bool m_running;
+            void Run()
+            {
+                ForestDBLocalContext& local_ctx = GetDBLocalContext();
+                m_lock.Lock();
+                while (m_running)
+                {
+                    m_lock.Wait(g_fdb_commit_config.commit_interval);
+                    m_lock.Unlock();
+                    commit_pending_writes(local_ctx.fdb, 1);
+                    m_lock.Lock();
+                }
+                m_lock.Unlock();
+                commit_pending_writes(local_ctx.fdb, 1);
+            }
+        public:
+            ForestDBCommitThread() :
+                    m_running(true)
+            {
+            }
+            void Stop()
+            {
+                m_lock.Lock();
+                m_running = false;
+                m_lock.NotifyAll();
+                m_lock.Unlock();
+                Join();
+            }
+    };
+    static ForestDBCommitThread* g_fdb_commit_thread = NULL;
+
     ForestDBEngine::ForestDBEngine()
     //:m_meta_db(NULL), m_meta_kv(NULL)
     {
@@ -345,6 +443,11 @@ namespace ardb
     ForestDBEngine::~ForestDBEngine()
     {
         //Close();
+        if (NULL != g_fdb_commit_thread)
+        {
+            g_fdb_commit_thread->Stop();
+            DELETE(g_fdb_commit_thread);
+        }
     }
 
     void ForestDBEngine::AddNamespace(const Data& ns)
@@ -396,8 +499,26 @@ namespace ardb
         conf_get_size(props, "num_compactor_threads", g_fdb_config.num_compactor_threads);
         conf_get_size(props, "num_bgflusher_threads", g_fdb_config.num_bgflusher_threads);
         conf_get_uint8(props, "compaction_threshold", g_fdb_config.compaction_threshold);
+        conf_get_int64(props, "commit_interval", g_fdb_commit_config.commit_interval);
+        conf_get_int64(props, "commit_ops", g_fdb_commit_config.commit_ops);
+        std::string commit_mode;
+        if (conf_get_string(props, "commit_mode", commit_mode) && !strcasecmp(commit_mode.c_str(), "wal_flush"))
+        {
+            g_fdb_commit_config.commit_opt = FDB_COMMIT_MANUAL_WAL_FLUSH;
+        }
         ForestDBLocalContext& local_ctx = g_ctx_local.GetValue();
-        return local_ctx.Init() ? 0 : -1;
+        if (!local_ctx.Init())
+        {
+            return -1;
+        }
+        if (g_fdb_commit_config.commit_interval > 0)
+        {
+            NEW(g_fdb_commit_thread, ForestDBCommitThread);
+            g_fdb_commit_thread->Start();
+        }
+        INFO_LOG("ForestDB commits every %lldms or %lld writes with %u compactor threads.", g_fdb_commit_config.commit_interval,
+                g_fdb_commit_config.commit_ops, (uint32) g_fdb_config.num_compactor_threads);
+        return 0;
     }
 
     int ForestDBEngine::Repair(const std::string& dir)
@@ -414,14 +535,17 @@ namespace ardb
             return ERR_ENTRY_NOT_EXIST;
         }
         ForestDBLocalContext& local_ctx = GetDBLocalContext();
-        Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         value.Encode(encode_buffer);
         size_t value_len = encode_buffer.ReadableBytes() - key_len;
         fdb_status fs = fdb_set_kv(kv, (const void*) encode_buffer.GetRawBuffer(), key_len, (const void*) (encode_buffer.GetRawBuffer() + key_len), value_len);
         CHECK_EXPR(fs);
-        fdb_commit(local_ctx.fdb, FDB_COMMIT_NORMAL);
+        if (0 == fs)
+        {
+            local_ctx.CommitWrite();
+        }
         return ENGINE_ERR(fs);
     }
     int ForestDBEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
@@ -433,7 +557,10 @@ namespace ardb
         }
         ForestDBLocalContext& local_ctx = GetDBLocalContext();
         fdb_status fs = fdb_set_kv(kv, (const void*) key.data(), key.size(), (const void*) value.data(), value.size());
-        fdb_commit(local_ctx.fdb, FDB_COMMIT_NORMAL);
+        if (0 == fs)
+        {
+            local_ctx.CommitWrite();
+        }
         return ENGINE_ERR(fs);
     }
 
@@ -445,7 +572,7 @@ namespace ardb
             return ERR_ENTRY_NOT_EXIST;
         }
         ForestDBLocalContext& local_ctx = GetDBLocalContext();
-        Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         void* val = NULL;
@@ -464,10 +591,14 @@ namespace ardb
     {
         values.resize(keys.size());
         errs.resize(keys.size());
-        for (size_t i = 0; i < keys.size(); i++)
+        /*
+         * visit keys in storage order
+         */
+        std::vector<size_t> idxs;
+        sort_keys_index(keys, idxs);
+        for (size_t i = 0; i < idxs.size(); i++)
         {
-            int err = Get(ctx, keys[i], values[i]);
-            errs[i] = err;
+            errs[idxs[i]] = Get(ctx, keys[idxs[i]], values[idxs[i]]);
         }
         return 0;
     }
@@ -479,7 +610,7 @@ namespace ardb
             return ERR_ENTRY_NOT_EXIST;
         }
         ForestDBLocalContext& local_ctx = GetDBLocalContext();
-        Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         if(!local_ctx.iters.empty())
@@ -493,7 +624,10 @@ namespace ardb
         }
         fdb_status fs = FDB_RESULT_SUCCESS;
         CHECK_EXPR(fs = fdb_del_kv(kv, (const void* ) encode_buffer.GetRawBuffer(), key_len));
-        CHECK_EXPR(fs = fdb_commit(local_ctx.fdb, FDB_COMMIT_NORMAL));
+        if (0 == fs)
+        {
+            local_ctx.CommitWrite();
+        }
         return ENGINE_NERR(fs);
     }
 
@@ -578,7 +712,7 @@ namespace ardb
         return fdb_error_msg((fdb_status)err);
     }
 
-    Iterator* ForestDBEngine::Find(Context& ctx, const KeyObject& key)
+    Iterator* ForestDBEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
     {
         ForestDBIterator* iter = NULL;
         fdb_kvs_handle* kv = GetKVStore(ctx, key.GetNameSpace(), false);
@@ -597,29 +731,22 @@ namespace ardb
         fdb_iterator_opt_t opt = FDB_ITR_NO_DELETES;
         if (key.GetType() > 0)
         {
-            Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
-            key.Encode(encode_buffer);
+            Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
+            if (options.lower_bound.GetType() > 0)
+            {
+                options.lower_bound.Encode(encode_buffer);
+            }
+            else
+            {
+                key.Encode(encode_buffer);
+            }
             start_keylen = encode_buffer.ReadableBytes();
-            if (!ctx.flags.iterate_multi_keys)
+            if (options.upper_bound.GetType() > 0)
             {
-                if (!ctx.flags.iterate_no_upperbound)
-                {
-                    KeyObject upperbound_key;
-                    upperbound_key.SetNameSpace(key.GetNameSpace());
-                    if (key.GetType() == KEY_META)
-                    {
-                        upperbound_key.SetType(KEY_END);
-                    }
-                    else
-                    {
-                        upperbound_key.SetType(key.GetType() + 1);
-                    }
-                    upperbound_key.SetKey(key.GetKey());
-                    upperbound_key.Encode(encode_buffer, false);
-                    end_keylen = encode_buffer.ReadableBytes() - start_keylen;
-                    end_key = (const void *) (encode_buffer.GetRawBuffer() + start_keylen);
-//                    opt |= FDB_ITR_SKIP_MAX_KEY;
-                }
+                options.upper_bound.Encode(encode_buffer, false);
+                end_keylen = encode_buffer.ReadableBytes() - start_keylen;
+                end_key = (const void *) (encode_buffer.GetRawBuffer() + start_keylen);
+//                opt |= FDB_ITR_SKIP_MAX_KEY;
             }
             start_key = (const void *) encode_buffer.GetRawBuffer();
         }
@@ -658,6 +785,9 @@ namespace ardb
         {
             stat_info.append("forestdb_file_version:").append(fdb_get_file_version(local_ctx.fdb)).append("\r\n");
         }
+        stat_info.append("forestdb_pending_writes:").append(stringfromll(g_fdb_pending_writes)).append("\r\n");
+        stat_info.append("forestdb_batched_commits:").append(stringfromll(g_fdb_commits)).append("\r\n");
+        stat_info.append("forestdb_batched_committed_writes:").append(stringfromll(g_fdb_committed_writes)).append("\r\n");
     }
 
     void ForestDBIterator::ClearState()
@@ -712,7 +842,7 @@ namespace ardb
             return;
         }
         ForestDBLocalContext& local_ctx = GetDBLocalContext();
-        Slice key_slice = next.Encode(local_ctx.GetEncodeBuferCache(), false);
+        Slice key_slice = next.Encode(local_ctx.GetEncodeBufferCache(), false);
         int rc = fdb_iterator_seek(m_iter, (const void *) key_slice.data(), key_slice.size(), FDB_ITR_SEEK_HIGHER);
         m_valid = rc == 0;
     }
@@ -845,9 +975,11 @@ namespace ardb
         }
         if (NULL != m_raw)
         {
-            fdb_del(m_kv, m_raw);
-            ForestDBLocalContext& local_ctx = GetDBLocalContext();
-            fdb_commit(local_ctx.fdb, FDB_COMMIT_NORMAL);
+            if (0 == fdb_del(m_kv, m_raw))
+            {
+                ForestDBLocalContext& local_ctx = GetDBLocalContext();
+                local_ctx.CommitWrite();
+            }
         }
         //status = fdb_del(m_iter->handle, &m_raw);
     }
@@ -860,7 +992,7 @@ namespace ardb
 //        if (NULL != m_raw)
 //        {
 //            ForestDBLocalContext& local_ctx = GetDBLocalContext();
-//            Slice kslice = key.Encode(local_ctx.GetEncodeBuferCache());
+//            Slice kslice = key.Encode(local_ctx.GetEncodeBufferCache());
 //            int rc = fdb_iterator_seek(m_iter, (const void *) kslice.data(), kslice.size(), FDB_ITR_SEEK_LOWER);
 //            rc = fdb_iterator_next(m_iter);
 //            if (0 == rc)
@@ -134,7 +134,8 @@ namespace ardb
             int DropNameSpace(Context& ctx, const Data& ns);
             void Stats(Context& ctx, std::string& str);
             int64_t EstimateKeysNum(Context& ctx, const Data& ns);
-            Iterator* Find(Context& ctx, const KeyObject& key);
+            using Engine::Find;
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
             const std::string GetErrorReason(int err);
             const FeatureSet GetFeatureSet()
             {
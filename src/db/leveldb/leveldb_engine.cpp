@@ -254,7 +254,7 @@ namespace ardb
 
         static LevelDBComparator comparator;
         m_options.create_if_missing = true;
-        m_options.comparator = &comparator;
+        m_options.comparator = is_ordered_key_codec(get_key_codec_version()) ? leveldb::BytewiseComparator() : &comparator;
         if (m_cfg.block_cache_size > 0)
         {
             leveldb::Cache* cache = leveldb::NewLRUCache(m_cfg.block_cache_size);
@@ -353,7 +353,7 @@ namespace ardb
     {
         static LevelDBComparator comparator;
         static LevelDBLogger logger;
-        m_options.comparator = &comparator;
+        m_options.comparator = is_ordered_key_codec(get_key_codec_version()) ? leveldb::BytewiseComparator() : &comparator;
         m_options.info_log = &logger;
         leveldb::Status status = leveldb::RepairDB(dir, m_options);
         return status.ok() ? 0 : -1;
@@ -425,11 +425,18 @@ namespace ardb
     {
         values.resize(keys.size());
         errs.resize(keys.size());
-        for (size_t i = 0; i < keys.size(); i++)
+        /*
+         * all keys are read from one snapshot in storage order
+         */
+        LevelDBLocalContext& local_ctx = g_local_ctx.GetValue();
+        local_ctx.snapshot.Get();
+        std::vector<size_t> idxs;
+        sort_keys_index(keys, idxs);
+        for (size_t i = 0; i < idxs.size(); i++)
         {
-            int err = Get(ctx, keys[i], values[i]);
-            errs[i] = err;
+            errs[idxs[i]] = Get(ctx, keys[idxs[i]], values[idxs[i]]);
         }
+        local_ctx.snapshot.Release();
         return 0;
     }
     int LevelDBEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
@@ -514,7 +521,18 @@ namespace ardb
         return "";
     }
 
-    Iterator* LevelDBEngine::Find(Context& ctx, const KeyObject& key)
+    int LevelDBEngine::BeginSnapshotRead(Context& ctx)
+    {
+        g_local_ctx.GetValue().snapshot.Get();
+        return 0;
+    }
+    int LevelDBEngine::EndSnapshotRead(Context& ctx)
+    {
+        g_local_ctx.GetValue().snapshot.Release();
+        return 0;
+    }
+
+    Iterator* LevelDBEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
     {
         LevelDBIterator* iter = NULL;
         NEW(iter, LevelDBIterator(this,key.GetNameSpace()));
@@ -526,27 +544,8 @@ namespace ardb
         LevelDBLocalContext& local_ctx = g_local_ctx.GetValue();
         leveldb::ReadOptions opt;
         opt.snapshot = local_ctx.snapshot.Get();
-        if (key.GetType() > 0)
-        {
-            if (!ctx.flags.iterate_multi_keys)
-            {
-                if (!ctx.flags.iterate_no_upperbound)
-                {
-                    KeyObject& upperbound_key = iter->IterateUpperBoundKey();
-                    upperbound_key.SetNameSpace(key.GetNameSpace());
-                    if (key.GetType() == KEY_META)
-                    {
-                        upperbound_key.SetType(KEY_END);
-                    }
-                    else
-                    {
-                        upperbound_key.SetType(key.GetType() + 1);
-                    }
-                    upperbound_key.SetKey(key.GetKey());
-                    upperbound_key.CloneStringPart();
-                }
-            }
-        }
+        opt.fill_cache = !options.streaming;
+        iter->SetIterateBounds(options);
         leveldb::Iterator* rocksiter = m_db->NewIterator(opt);
         iter->SetIterator(rocksiter);
         if (key.GetType() > 0)
@@ -676,11 +675,13 @@ namespace ardb
     }
     void LevelDBIterator::CheckBound()
     {
-        if (NULL != m_iter && m_iterate_upper_bound_key.GetType() > 0)
+        if (NULL != m_iter && (m_iterate_upper_bound_key.GetType() > 0 || m_iterate_lower_bound_key.GetType() > 0))
         {
             if (m_iter->Valid())
             {
-                if (Key(false).Compare(m_iterate_upper_bound_key) >= 0)
+                KeyObject& current = Key(false);
+                if ((m_iterate_upper_bound_key.GetType() > 0 && current.Compare(m_iterate_upper_bound_key) >= 0)
+                        || (m_iterate_lower_bound_key.GetType() > 0 && current.Compare(m_iterate_lower_bound_key) < 0))
                 {
                     m_valid = false;
                 }
@@ -705,6 +706,7 @@ namespace ardb
             return;
         }
         m_iter->Prev();
+        CheckBound();
     }
     void LevelDBIterator::Jump(const KeyObject& next)
     {
@@ -740,6 +742,7 @@ namespace ardb
             if (!m_iter->Valid())
             {
                 m_iter->SeekToLast();
+                CheckBound();
             }
             if (m_iter->Valid())
             {
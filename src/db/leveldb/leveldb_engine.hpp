@@ -51,6 +51,7 @@ namespace ardb
             ValueObject m_value;
             LevelDBEngine* m_engine;
             leveldb::Iterator* m_iter;
+            KeyObject m_iterate_lower_bound_key;
             KeyObject m_iterate_upper_bound_key;
             bool m_valid;
             void ClearState();
@@ -70,9 +71,12 @@ namespace ardb
             {
                 m_iter = iter;
             }
-            KeyObject& IterateUpperBoundKey()
+            void SetIterateBounds(const IterateOptions& options)
             {
-                return m_iterate_upper_bound_key;
+                m_iterate_lower_bound_key = options.lower_bound;
+                m_iterate_lower_bound_key.CloneStringPart();
+                m_iterate_upper_bound_key = options.upper_bound;
+                m_iterate_upper_bound_key.CloneStringPart();
             }
             bool Valid();
             void Next();
@@ -130,18 +134,22 @@ namespace ardb
             int BeginWriteBatch(Context& ctx);
             int CommitWriteBatch(Context& ctx);
             int DiscardWriteBatch(Context& ctx);
+            int BeginSnapshotRead(Context& ctx);
+            int EndSnapshotRead(Context& ctx);
             int Compact(Context& ctx, const KeyObject& start, const KeyObject& end);
             int ListNameSpaces(Context& ctx, DataArray& nss);
             int DropNameSpace(Context& ctx, const Data& ns);
             void Stats(Context& ctx, std::string& str);
             int64_t EstimateKeysNum(Context& ctx, const Data& ns);
             const std::string GetErrorReason(int err);
-            Iterator* Find(Context& ctx, const KeyObject& key);
+            using Engine::Find;
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
             const FeatureSet GetFeatureSet()
             {
                 FeatureSet features;
                 features.support_compactfilter = 0;
                 features.support_namespace = 0;
+                features.support_snapshot_read = 1;
                 features.support_merge = 0;
                 return features;
             }
@@ -56,7 +56,6 @@
 #define DEFAULT_LMDB_LOCAL_MULTI_CACHE_SIZE 10
 #define LMDB_PUT_OP 1
 #define LMDB_DEL_OP 2
-#define LMDB_CKP_OP 3
 
 #define LMDB_META_NAMESPACE "__LMDB_META__"
 
@@ -69,6 +68,31 @@ namespace ardb
     }
 
     static MDB_env *g_mdb_env = NULL;
+    static LMDBConfig* g_mdb_cfg = NULL;
+    static volatile uint64_t g_read_txn_renews = 0;
+    static volatile uint64_t g_read_txn_repins = 0;
+    static volatile uint64_t g_stale_readers = 0;
+    static volatile uint64_t g_reader_check_time = 0;
+
+    /*
+     * Reader slots of threads/processes gone without ending their transactions pin pages forever, they are
+     * cleared by one of the readers every 'reader_check_period' secs.
+     */
+    static void check_stale_readers(uint64 now)
+    {
+        uint64 last = g_reader_check_time;
+        if (NULL == g_mdb_cfg || g_mdb_cfg->reader_check_period <= 0 || now < last + g_mdb_cfg->reader_check_period * 1000
+                || !atomic_cmp_set_uint64(&g_reader_check_time, last, now))
+        {
+            return;
+        }
+        int dead = 0;
+        if (0 == mdb_reader_check(g_mdb_env, &dead) && dead > 0)
+        {
+            atomic_add_uint64(&g_stale_readers, dead);
+            WARN_LOG("Cleared %d stale lmdb reader slots.", dead);
+        }
+    }
 
     struct WriteOperation
     {
@@ -76,164 +100,337 @@ namespace ardb
             std::string value;
             MDB_dbi dbi;
             uint8 type;
+            WriteOperation() :
+                    dbi(0), type(0)
+            {
+            }
+            /*
+             * buffers of the strings are reused by later operations
+             */
+            void Set(MDB_dbi d, uint8 t, const MDB_val& k, const MDB_val* v)
+            {
+                dbi = d;
+                type = t;
+                key.assign((const char*) k.mv_data, k.mv_size);
+                if (NULL != v)
+                {
+                    value.assign((const char*) v->mv_data, v->mv_size);
+                }
+                else
+                {
+                    value.clear();
+                }
+            }
     };
 
-    class BGWriteThread: public Thread
+#define LMDB_MAX_FAILED_BATCHES 1024
+    /*
+     * Writes outside of a thread local transaction are appended to a preallocated ring, the commit thread
+     * drains all appended writes into one transaction. Writers waiting for their writes are woken after the
+     * commit, so a write is visible to every reader once it returns.
+     */
+    class LMDBWriteRing: public Thread
     {
         private:
-            bool running;
-            MPSCQueue<WriteOperation*> write_queue;
-            ThreadMutexLock queue_cond;
-            EventCondition event_cond;
-            void Run()
+            struct FailedBatch
+            {
+                    uint64 start;
+                    uint64 end;
+                    int err;
+            };
+            MDB_env* m_env;
+            std::vector<WriteOperation> m_slots;
+            uint64 m_head; //sequence of the first write not committed
+            uint64 m_tail; //sequence of the next appended write
+            ThreadMutexLock m_lock;
+            std::deque<FailedBatch> m_failed;
+            bool m_running;
+
+            uint64 m_commits;
+            uint64 m_committed_ops;
+            uint64 m_max_batch;
+            uint64 m_commit_micros;
+            uint64 m_max_commit_micros;
+            uint64 m_full_waits;
+
+            int Commit(uint64 start, uint64 end)
             {
-                running = true;
                 MDB_txn* txn = NULL;
-                while (running)
+                int rc = mdb_txn_begin(m_env, NULL, 0, &txn);
+                for (uint64 seq = start; 0 == rc && seq < end; seq++)
                 {
-                    if (NULL == txn)
+                    WriteOperation& op = m_slots[seq % m_slots.size()];
+                    MDB_val k, v;
+                    k.mv_data = const_cast<char*>(op.key.data());
+                    k.mv_size = op.key.size();
+                    if (LMDB_PUT_OP == op.type)
                     {
-                        if (NULL == g_mdb_env || 0 != mdb_txn_begin(g_mdb_env, NULL, 0, &txn))
-                        {
-                            Thread::Sleep(10, MILLIS);
-                            continue;
-                        }
+                        v.mv_data = const_cast<char*>(op.value.data());
+                        v.mv_size = op.value.size();
+                        rc = mdb_put(txn, op.dbi, &k, &v, 0);
                     }
-                    WriteOperation* op = NULL;
-                    int count = 0;
-                    while (write_queue.Pop(op))
+                    else
                     {
-                        count++;
-                        switch (op->type)
-                        {
-                            case LMDB_PUT_OP:
-                            {
-                                MDB_val k, v;
-                                k.mv_data = const_cast<char*>(op->key.data());
-                                k.mv_size = op->key.size();
-                                v.mv_data = const_cast<char*>(op->value.data());
-                                v.mv_size = op->value.size();
-                                CHECK_EXPR(mdb_put(txn, op->dbi, &k, &v, 0));
-                                DELETE(op);
-                                break;
-                            }
-                            case LMDB_DEL_OP:
-                            {
-                                MDB_val k;
-                                k.mv_data = const_cast<char*>(op->key.data());
-                                k.mv_size = op->key.size();
-                                mdb_del(txn, op->dbi, &k, NULL);
-                                //CHECK_EXPR(mdb_del(txn, op->dbi, &k, NULL));
-                                DELETE(op);
-                                break;
-                            }
-                            case LMDB_CKP_OP:
-                            {
-                                CHECK_EXPR(mdb_txn_commit(txn));
-                                txn = NULL;
-                                event_cond.Notify();
-                                DELETE(op);
-                                break;
-                            }
-                            default:
-                            {
-                                break;
-                            }
-                        }
-                        if (NULL == txn)
+                        rc = mdb_del(txn, op.dbi, &k, NULL);
+                        if (MDB_NOTFOUND == rc)
                         {
-                            break;
+                            rc = 0;
                         }
                     }
-
-                    if (count == 0)
+                }
+                if (0 == rc)
+                {
+                    rc = mdb_txn_commit(txn);
+                }
+                else if (NULL != txn)
+                {
+                    mdb_txn_abort(txn);
+                }
+                if (0 != rc)
+                {
+                    ERROR_LOG("Failed to commit %llu writes for reason:%s", end - start, mdb_strerror(rc));
+                }
+                return rc;
+            }
+            void Run()
+            {
+                while (true)
+                {
+                    m_lock.Lock();
+                    while (m_running && m_head == m_tail)
+                    {
+                        m_lock.Wait(5);
+                    }
+                    if (m_head == m_tail)
                     {
-                        if (NULL != txn)
+                        m_lock.Unlock();
+                        break;
+                    }
+                    /*
+                     * slots in [start, end) are not touched by writers until m_head moves past them
+                     */
+                    uint64 start = m_head, end = m_tail;
+                    m_lock.Unlock();
+                    uint64 begin_time = get_current_epoch_micros();
+                    int err = Commit(start, end);
+                    uint64 cost = get_current_epoch_micros() - begin_time;
+                    LockGuard<ThreadMutexLock> guard(m_lock);
+                    m_head = end;
+                    if (0 != err)
+                    {
+                        FailedBatch failed;
+                        failed.start = start;
+                        failed.end = end;
+                        failed.err = err;
+                        m_failed.push_back(failed);
+                        if (m_failed.size() > LMDB_MAX_FAILED_BATCHES)
                         {
-                            CHECK_EXPR(mdb_txn_commit(txn));
-                            txn = NULL;
+                            m_failed.pop_front();
                         }
-                        queue_cond.Lock();
-                        queue_cond.Wait(5);
-                        queue_cond.Unlock();
                     }
+                    m_commits++;
+                    m_committed_ops += end - start;
+                    m_commit_micros += cost;
+                    if (end - start > m_max_batch)
+                    {
+                        m_max_batch = end - start;
+                    }
+                    if (cost > m_max_commit_micros)
+                    {
+                        m_max_commit_micros = cost;
+                    }
+                    m_lock.NotifyAll();
                 }
             }
-            void PushWriteOp(WriteOperation* op)
-            {
-                write_queue.Push(op);
-                queue_cond.Lock();
-                queue_cond.Notify();
-                queue_cond.Unlock();
-            }
         public:
-            BGWriteThread() :
-                    running(false)
+            LMDBWriteRing(MDB_env* env, size_t size) :
+                    m_env(env), m_slots(size > 0 ? size : 1), m_head(0), m_tail(0), m_running(true), m_commits(0), m_committed_ops(0), m_max_batch(0), m_commit_micros(
+                            0), m_max_commit_micros(0), m_full_waits(0)
             {
             }
-            bool IsRunning()
+            /*
+             * Returns the sequence of the write, MUST NOT be called while the thread holds a write transaction,
+             * which blocks the commit thread.
+             */
+            uint64 Append(MDB_dbi dbi, uint8 type, const MDB_val& k, const MDB_val* v)
             {
-                return running;
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                while (m_tail - m_head >= m_slots.size())
+                {
+                    m_full_waits++;
+                    m_lock.Wait();
+                }
+                m_slots[m_tail % m_slots.size()].Set(dbi, type, k, v);
+                uint64 seq = m_tail++;
+                m_lock.NotifyAll();
+                return seq;
             }
-            void AdviceStop()
+            /*
+             * Wait until the write with sequence 'seq' committed, returns the error of its transaction
+             */
+            int WaitCommitted(uint64 seq)
             {
-                running = false;
-            }
-            void Put(MDB_dbi dbi, MDB_val k, MDB_val v)
-            {
-                WriteOperation* op = new WriteOperation;
-                op->dbi = dbi;
-                op->type = LMDB_PUT_OP;
-                op->key.assign((const char*) k.mv_data, k.mv_size);
-                op->value.assign((const char*) v.mv_data, v.mv_size);
-                PushWriteOp(op);
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                while (m_head <= seq)
+                {
+                    m_lock.Wait();
+                }
+                for (size_t i = 0; i < m_failed.size(); i++)
+                {
+                    if (seq >= m_failed[i].start && seq < m_failed[i].end)
+                    {
+                        return m_failed[i].err;
+                    }
+                }
+                return 0;
             }
-            void Del(MDB_dbi dbi, MDB_val k)
+            void Stop()
             {
-                WriteOperation* op = new WriteOperation;
-                op->dbi = dbi;
-                op->key.assign((const char*) k.mv_data, k.mv_size);
-                op->type = LMDB_DEL_OP;
-                PushWriteOp(op);
+                m_lock.Lock();
+                m_running = false;
+                m_lock.NotifyAll();
+                m_lock.Unlock();
+                Join();
             }
-            void WaitWriteComplete()
+            void Stats(std::string& str)
             {
-                WriteOperation* op = new WriteOperation;
-                op->type = LMDB_CKP_OP;
-                PushWriteOp(op);
-                event_cond.Wait();
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                str.append("lmdb_write_ring_size:").append(stringfromll(m_slots.size())).append("\r\n");
+                str.append("lmdb_write_ring_pending:").append(stringfromll(m_tail - m_head)).append("\r\n");
+                str.append("lmdb_write_ring_full_waits:").append(stringfromll(m_full_waits)).append("\r\n");
+                str.append("lmdb_group_commits:").append(stringfromll(m_commits)).append("\r\n");
+                str.append("lmdb_group_committed_writes:").append(stringfromll(m_committed_ops)).append("\r\n");
+                str.append("lmdb_group_commit_avg_batch:").append(stringfromll(m_commits > 0 ? m_committed_ops / m_commits : 0)).append("\r\n");
+                str.append("lmdb_group_commit_max_batch:").append(stringfromll(m_max_batch)).append("\r\n");
+                str.append("lmdb_group_commit_avg_latency_us:").append(stringfromll(m_commits > 0 ? m_commit_micros / m_commits : 0)).append("\r\n");
+                str.append("lmdb_group_commit_max_latency_us:").append(stringfromll(m_max_commit_micros)).append("\r\n");
+                str.append("lmdb_group_failed_commits:").append(stringfromll(m_failed.size())).append("\r\n");
             }
     };
+    static LMDBWriteRing* g_write_ring = NULL;
 
-    struct LMDBLocalContext
+    struct LMDBLocalContext: public DBLocalContext
     {
             MDB_txn *txn;
             uint32 txn_ref;
             uint32 iter_ref;
             bool txn_abort;
-            bool write_dispatched;
             EventCondition cond;
-            Buffer encode_buffer_cache;
-            BGWriteThread bgwriter;
+            /*
+             * writes while an iterator is open in the thread local transaction, appended to the write ring
+             * after the transaction ended.
+             */
+            std::vector<WriteOperation> dispatched;
+            size_t dispatched_count;
+            /*
+             * read only transaction of the thread, reset after every read and renewed by the next one instead of
+             * begun & aborted each time, so its reader slot is kept while it pins no pages between reads.
+             */
+            MDB_txn *read_txn;
+            uint32 read_txn_ref;
+            uint64 read_txn_renew_time;
             LMDBLocalContext() :
-                    txn(NULL), txn_ref(0), iter_ref(0), txn_abort(false), write_dispatched(false)
+                    txn(NULL), txn_ref(0), iter_ref(0), txn_abort(false), dispatched_count(0), read_txn(NULL), read_txn_ref(0), read_txn_renew_time(0)
             //, iter_txn(NULL),iter_txn_ref(0)
             {
             }
-            BGWriteThread& GetBGWriter()
+            ~LMDBLocalContext()
             {
-                if (!bgwriter.IsRunning())
+                if (NULL != read_txn)
                 {
-                    bgwriter.Start();
-                    /*
-                     * wait until it started
-                     */
-                    while (!bgwriter.IsRunning())
+                    mdb_txn_abort(read_txn);
+                }
+            }
+            int AcquireReadTransaction(MDB_txn*& rtxn)
+            {
+                int rc = 0;
+                if (0 == read_txn_ref)
+                {
+                    uint64 now = get_current_epoch_millis();
+                    check_stale_readers(now);
+                    if (NULL == read_txn)
                     {
-                        usleep(10);
+                        rc = mdb_txn_begin(g_mdb_env, NULL, MDB_RDONLY, &read_txn);
                     }
+                    else
+                    {
+                        rc = mdb_txn_renew(read_txn);
+                        if (0 != rc)
+                        {
+                            mdb_txn_abort(read_txn);
+                            read_txn = NULL;
+                            rc = mdb_txn_begin(g_mdb_env, NULL, MDB_RDONLY, &read_txn);
+                        }
+                        atomic_add_uint64(&g_read_txn_renews, 1);
+                    }
+                    if (0 != rc)
+                    {
+                        read_txn = NULL;
+                        return rc;
+                    }
+                    read_txn_renew_time = now;
+                }
+                read_txn_ref++;
+                rtxn = read_txn;
+                return 0;
+            }
+            void ReleaseReadTransaction()
+            {
+                if (read_txn_ref > 0 && 0 == --read_txn_ref)
+                {
+                    mdb_txn_reset(read_txn);
+                }
+            }
+            /*
+             * Moves a read transaction pinning pages for more than 'reader_max_pin' millis to the latest snapshot,
+             * only between reads whose values have been copied out.
+             */
+            void RepinReadTransaction()
+            {
+                if (1 != read_txn_ref || NULL == g_mdb_cfg || g_mdb_cfg->reader_max_pin <= 0)
+                {
+                    return;
+                }
+                uint64 now = get_current_epoch_millis();
+                if (now < read_txn_renew_time + g_mdb_cfg->reader_max_pin)
+                {
+                    return;
+                }
+                mdb_txn_reset(read_txn);
+                if (0 != mdb_txn_renew(read_txn))
+                {
+                    FATAL_LOG("Can NOT renew lmdb read transaction.");
+                }
+                read_txn_renew_time = now;
+                atomic_add_uint64(&g_read_txn_repins, 1);
+            }
+            void Dispatch(MDB_dbi dbi, uint8 type, const MDB_val& k, const MDB_val* v)
+            {
+                if (dispatched_count == dispatched.size())
+                {
+                    dispatched.resize(dispatched_count + 1);
+                }
+                dispatched[dispatched_count++].Set(dbi, type, k, v);
+            }
+            int CommitDispatched()
+            {
+                if (0 == dispatched_count)
+                {
+                    return 0;
+                }
+                uint64 seq = 0;
+                for (size_t i = 0; i < dispatched_count; i++)
+                {
+                    WriteOperation& op = dispatched[i];
+                    MDB_val k, v;
+                    k.mv_data = const_cast<char*>(op.key.data());
+                    k.mv_size = op.key.size();
+                    v.mv_data = const_cast<char*>(op.value.data());
+                    v.mv_size = op.value.size();
+                    seq = g_write_ring->Append(op.dbi, op.type, k, LMDB_PUT_OP == op.type ? &v : NULL);
                 }
-                return bgwriter;
+                dispatched_count = 0;
+                return g_write_ring->WaitCommitted(seq);
             }
             int AcquireTransanction(bool from_iterator = false)
             {
@@ -244,7 +441,6 @@ namespace ardb
                     txn_abort = false;
                     txn_ref = 0;
                     iter_ref = 0;
-                    write_dispatched = false;
                 }
                 if (0 == rc)
                 {
@@ -262,7 +458,6 @@ namespace ardb
                 if (NULL != txn)
                 {
                     txn_ref--;
-                    //printf("#### %d %d %d \n", txn_ref, txn_abort, write_dispatched);
                     if (!txn_abort)
                     {
                         txn_abort = !success;
@@ -278,12 +473,7 @@ namespace ardb
                             rc = mdb_txn_commit(txn);
                         }
                         txn = NULL;
-
-                        if (write_dispatched)
-                        {
-                            GetBGWriter().WaitWriteComplete();
-                        }
-                        write_dispatched = false;
+                        CommitDispatched();
                     }
                 }
                 if (from_iterator && iter_ref > 0)
@@ -292,16 +482,6 @@ namespace ardb
                 }
                 return rc;
             }
-            Buffer& GetEncodeBuferCache()
-            {
-                encode_buffer_cache.Clear();
-                return encode_buffer_cache;
-            }
-            ~LMDBLocalContext()
-            {
-                bgwriter.AdviceStop();
-                bgwriter.Join();
-            }
     };
     static ThreadLocal<LMDBLocalContext> g_ctx_local;
 
@@ -313,6 +493,11 @@ namespace ardb
     LMDBEngine::~LMDBEngine()
     {
         //Close();
+        if (NULL != g_write_ring)
+        {
+            g_write_ring->Stop();
+            DELETE(g_write_ring);
+        }
     }
 
     bool LMDBEngine::GetDBI(Context& ctx, const Data& ns, bool create_if_noexist, MDB_dbi& dbi)
@@ -340,7 +525,10 @@ namespace ardb
             recreate_local_txn = true;
         }
         CHECK_RET(mdb_open(txn, ns.AsString().c_str(), create_if_noexist?MDB_CREATE:0, &dbi), false);
-        mdb_set_compare(txn, dbi, LMDBCompareFunc);
+        if (!is_ordered_key_codec(get_key_codec_version()))
+        {
+            mdb_set_compare(txn, dbi, LMDBCompareFunc);
+        }
 
         std::string ns_key = "ns:" + ns.AsString();
         std::string ns_val = ns.AsString();
@@ -381,6 +569,9 @@ namespace ardb
         conf_get_int64(props, "database_maxdbs", m_cfg.max_dbs);
         conf_get_int64(props, "batch_commit_watermark", m_cfg.batch_commit_watermark);
         conf_get_bool(props, "readahead", m_cfg.readahead);
+        conf_get_int64(props, "reader_check_period", m_cfg.reader_check_period);
+        conf_get_int64(props, "reader_max_pin", m_cfg.reader_max_pin);
+        g_mdb_cfg = &m_cfg;
 
         mdb_env_create(&m_env);
         mdb_env_set_maxdbs(m_env, m_cfg.max_dbs);
@@ -438,6 +629,8 @@ namespace ardb
         } while (rc == 0);
         mdb_txn_commit(local_ctx.txn);
         local_ctx.txn = NULL;
+        NEW(g_write_ring, LMDBWriteRing(m_env, m_cfg.batch_commit_watermark));
+        g_write_ring->Start();
         INFO_LOG("Success to open lmdb at %s", dir.c_str());
         return 0;
     }
@@ -456,7 +649,7 @@ namespace ardb
             return ERR_ENTRY_NOT_EXIST;
         }
         LMDBLocalContext& local_ctx = g_ctx_local.GetValue();
-        Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         value.Encode(encode_buffer);
@@ -468,15 +661,19 @@ namespace ardb
         v.mv_size = value_len;
 
         /*
-         * write operation MUST dispatch to background write thread if there is exiting iterators,
+         * write operation MUST be dispatched to the write ring if there is exiting iterators,
          * because write operation would invalid current iterator in the same thread.
          */
         if (local_ctx.iter_ref > 0)
         {
-            local_ctx.write_dispatched = true;
-            local_ctx.GetBGWriter().Put(dbi, k, v);
+            local_ctx.Dispatch(dbi, LMDB_PUT_OP, k, &v);
             return 0;
         }
+        if (NULL == local_ctx.txn)
+        {
+            int err = g_write_ring->WaitCommitted(g_write_ring->Append(dbi, LMDB_PUT_OP, k, &v));
+            return ENGINE_ERR(err);
+        }
         int err = local_ctx.AcquireTransanction(false);
         if (0 == err)
         {
@@ -501,10 +698,14 @@ namespace ardb
         v.mv_size = value.size();
         if (local_ctx.iter_ref > 0)
         {
-            local_ctx.write_dispatched = true;
-            local_ctx.GetBGWriter().Put(dbi, k, v);
+            local_ctx.Dispatch(dbi, LMDB_PUT_OP, k, &v);
             return 0;
         }
+        if (NULL == local_ctx.txn)
+        {
+            int err = g_write_ring->WaitCommitted(g_write_ring->Append(dbi, LMDB_PUT_OP, k, &v));
+            return ENGINE_ERR(err);
+        }
         int err = local_ctx.AcquireTransanction(false);
         if (0 == err)
         {
@@ -522,7 +723,7 @@ namespace ardb
             return ERR_ENTRY_NOT_EXIST;
         }
         LMDBLocalContext& local_ctx = g_ctx_local.GetValue();
-        Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         MDB_val k, v;
@@ -532,7 +733,7 @@ namespace ardb
         int rc = 0;
         if (NULL == txn)
         {
-            rc = mdb_txn_begin(m_env, NULL, MDB_RDONLY, &txn);
+            rc = local_ctx.AcquireReadTransaction(txn);
         }
         if (0 == rc)
         {
@@ -544,7 +745,7 @@ namespace ardb
             }
             if (NULL == local_ctx.txn)
             {
-                mdb_txn_commit(txn);
+                local_ctx.ReleaseReadTransaction();
             }
         }
         return ENGINE_ERR(rc);
@@ -560,7 +761,7 @@ namespace ardb
             return 0;
         }
         LMDBLocalContext& local_ctx = g_ctx_local.GetValue();
-        Buffer& key_encode_buffers = local_ctx.GetEncodeBuferCache();
+        Buffer& key_encode_buffers = local_ctx.GetEncodeBufferCache();
         std::vector<size_t> positions;
         std::vector<MDB_val> ks;
         ks.resize(keys.size());
@@ -582,13 +783,17 @@ namespace ardb
         int rc = 0;
         if (NULL == txn)
         {
-            rc = mdb_txn_begin(m_env, NULL, MDB_RDONLY, &txn);
+            rc = local_ctx.AcquireReadTransaction(txn);
         }
         if (0 == rc)
         {
             for (size_t i = 0; i < keys.size(); i++)
             {
                 MDB_val v;
+                if (NULL == local_ctx.txn && i > 0 && 0 == (i & 63))
+                {
+                    local_ctx.RepinReadTransaction();
+                }
                 rc = mdb_get(txn, dbi, &ks[i], &v);
                 if (0 == rc)
                 {
@@ -602,7 +807,7 @@ namespace ardb
             }
             if (NULL == local_ctx.txn)
             {
-                mdb_txn_commit(txn);
+                local_ctx.ReleaseReadTransaction();
             }
         }
         return ENGINE_NERR(rc);
@@ -615,7 +820,7 @@ namespace ardb
             return ERR_ENTRY_NOT_EXIST;
         }
         LMDBLocalContext& local_ctx = g_ctx_local.GetValue();
-        Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         MDB_val k;
@@ -624,10 +829,14 @@ namespace ardb
         int rc = 0;
         if (local_ctx.iter_ref > 0)
         {
-            local_ctx.write_dispatched = true;
-            local_ctx.GetBGWriter().Del(dbi, k);
+            local_ctx.Dispatch(dbi, LMDB_DEL_OP, k, NULL);
             return 0;
         }
+        if (NULL == local_ctx.txn)
+        {
+            int err = g_write_ring->WaitCommitted(g_write_ring->Append(dbi, LMDB_DEL_OP, k, NULL));
+            return ENGINE_ERR(err);
+        }
         rc = local_ctx.AcquireTransanction(false);
         if (0 == rc)
         {
@@ -735,7 +944,7 @@ namespace ardb
         return stat.ms_entries;
     }
 
-    Iterator* LMDBEngine::Find(Context& ctx, const KeyObject& key)
+    Iterator* LMDBEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
     {
         LMDBIterator* iter = NULL;
         NEW(iter, LMDBIterator(this,key.GetNameSpace()));
@@ -762,26 +971,9 @@ namespace ardb
             return iter;
         }
         iter->SetCursor(cursor);
+        iter->SetIterateBounds(options);
         if (key.GetType() > 0)
         {
-            if (!ctx.flags.iterate_multi_keys)
-            {
-                if (!ctx.flags.iterate_no_upperbound)
-                {
-                    KeyObject& upperbound_key = iter->IterateUpperBoundKey();
-                    upperbound_key.SetNameSpace(key.GetNameSpace());
-                    if (key.GetType() == KEY_META)
-                    {
-                        upperbound_key.SetType(KEY_END);
-                    }
-                    else
-                    {
-                        upperbound_key.SetType(key.GetType() + 1);
-                    }
-                    upperbound_key.SetKey(key.GetKey());
-                    upperbound_key.CloneStringPart();
-                }
-            }
             iter->Jump(key);
         }
         else
@@ -799,6 +991,13 @@ namespace ardb
         stat_info.append("lmdb_mapsize:").append(stringfromll(envinfo.me_mapsize)).append("\r\n");
         stat_info.append("lmdb_maxreaders:").append(stringfromll(envinfo.me_maxreaders)).append("\r\n");
         stat_info.append("lmdb_numreaders:").append(stringfromll(envinfo.me_numreaders)).append("\r\n");
+        stat_info.append("lmdb_read_txn_renews:").append(stringfromll(g_read_txn_renews)).append("\r\n");
+        stat_info.append("lmdb_read_txn_repins:").append(stringfromll(g_read_txn_repins)).append("\r\n");
+        stat_info.append("lmdb_stale_readers_cleared:").append(stringfromll(g_stale_readers)).append("\r\n");
+        if (NULL != g_write_ring)
+        {
+            g_write_ring->Stats(stat_info);
+        }
 
         DataArray nss;
         ListNameSpaces(ctx, nss);
@@ -831,11 +1030,13 @@ namespace ardb
     }
     void LMDBIterator::CheckBound()
     {
-        if (m_valid && NULL != m_cursor && m_iterate_upper_bound_key.GetType() > 0)
+        if (m_valid && NULL != m_cursor && (m_iterate_upper_bound_key.GetType() > 0 || m_iterate_lower_bound_key.GetType() > 0))
         {
             if (m_valid)
             {
-                if (Key(false).Compare(m_iterate_upper_bound_key) >= 0)
+                KeyObject& current = Key(false);
+                if ((m_iterate_upper_bound_key.GetType() > 0 && current.Compare(m_iterate_upper_bound_key) >= 0)
+                        || (m_iterate_lower_bound_key.GetType() > 0 && current.Compare(m_iterate_lower_bound_key) < 0))
                 {
                     m_valid = false;
                 }
@@ -868,6 +1069,7 @@ namespace ardb
         int rc;
         rc = mdb_cursor_get(m_cursor, &m_raw_key, &m_raw_val, MDB_PREV);
         m_valid = rc == 0;
+        CheckBound();
     }
     void LMDBIterator::DoJump(const KeyObject& next)
     {
@@ -877,7 +1079,7 @@ namespace ardb
             return;
         }
         LMDBLocalContext& local_ctx = g_ctx_local.GetValue();
-        Slice key_slice = next.Encode(local_ctx.GetEncodeBuferCache(), false);
+        Slice key_slice = next.Encode(local_ctx.GetEncodeBufferCache(), false);
         m_raw_key.mv_data = (void *) key_slice.data();
         m_raw_key.mv_size = key_slice.size();
         int rc = mdb_cursor_get(m_cursor, &m_raw_key, &m_raw_val, MDB_SET_RANGE);
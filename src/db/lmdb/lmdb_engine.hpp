@@ -53,6 +53,7 @@ namespace ardb
             ValueObject m_value;
             MDB_val m_raw_key;
             MDB_val m_raw_val;
+            KeyObject m_iterate_lower_bound_key;
             KeyObject m_iterate_upper_bound_key;
             bool m_valid;
 
@@ -81,9 +82,12 @@ namespace ardb
                     m_engine(e), m_cursor(NULL),m_ns(ns), m_valid(true)
             {
             }
-            KeyObject& IterateUpperBoundKey()
+            void SetIterateBounds(const IterateOptions& options)
             {
-                return m_iterate_upper_bound_key;
+                m_iterate_lower_bound_key = options.lower_bound;
+                m_iterate_lower_bound_key.CloneStringPart();
+                m_iterate_upper_bound_key = options.upper_bound;
+                m_iterate_upper_bound_key.CloneStringPart();
             }
             void MarkValid(bool valid)
             {
@@ -99,8 +103,11 @@ namespace ardb
             int64 max_dbs;
             int64 batch_commit_watermark;
             bool readahead;
+            int64 reader_check_period; //secs between sweeps of stale reader slots
+            int64 reader_max_pin; //millis a thread's read transaction may pin pages before renewed
             LMDBConfig() :
-                    max_dbsize(10 * 1024 * 1024 * 1024LL), max_dbs(4096), batch_commit_watermark(1024), readahead(false)
+                    max_dbsize(10 * 1024 * 1024 * 1024LL), max_dbs(4096), batch_commit_watermark(1024), readahead(false), reader_check_period(
+                            10), reader_max_pin(100)
             {
             }
     };
@@ -137,7 +144,8 @@ namespace ardb
             int DropNameSpace(Context& ctx, const Data& ns);
             void Stats(Context& ctx, std::string& str);
             int64_t EstimateKeysNum(Context& ctx, const Data& ns);
-            Iterator* Find(Context& ctx, const KeyObject& key);
+            using Engine::Find;
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
             const std::string GetErrorReason(int err);
             const FeatureSet GetFeatureSet()
             {
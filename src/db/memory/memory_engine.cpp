@@ -0,0 +1,882 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "memory_engine.hpp"
+#include "util/file_helper.hpp"
+#include "db/db_utils.hpp"
+#include "db/db.hpp"
+#include "thread/lock_guard.hpp"
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+
+#define MEMORY_DATA_FILE "memory.data"
+#define MEMORY_DATA_MAGIC "MEMKV001"
+
+namespace ardb
+{
+    void MemoryTable::Put(const Slice& key, const Slice& value)
+    {
+        std::string k(key.data(), key.size());
+        KVMap::iterator found = kvs.find(k);
+        if (found != kvs.end())
+        {
+            bytes -= found->second.size();
+            found->second.assign(value.data(), value.size());
+            bytes += value.size();
+            return;
+        }
+        kvs.insert(KVMap::value_type(k, std::string(value.data(), value.size())));
+        bytes += key.size() + value.size();
+        version++;
+    }
+    bool MemoryTable::Del(const Slice& key)
+    {
+        KVMap::iterator found = kvs.find(std::string(key.data(), key.size()));
+        if (found == kvs.end())
+        {
+            return false;
+        }
+        bytes -= found->first.size() + found->second.size();
+        kvs.erase(found);
+        version++;
+        return true;
+    }
+    void MemoryTable::DelRange(const std::string& start, const std::string& end, bool has_end)
+    {
+        KVMap::iterator it = kvs.lower_bound(start);
+        KVMap::iterator stop = has_end ? kvs.lower_bound(end) : kvs.end();
+        if (it == stop)
+        {
+            return;
+        }
+        for (KVMap::iterator cit = it; cit != stop; cit++)
+        {
+            bytes -= cit->first.size() + cit->second.size();
+        }
+        kvs.erase(it, stop);
+        version++;
+    }
+    void MemoryTable::Clear()
+    {
+        kvs.clear();
+        bytes = 0;
+        version++;
+    }
+
+    struct MemoryWriteOp
+    {
+            enum
+            {
+                PUT = 1, DEL = 2, DEL_RANGE = 3
+            };
+            uint8 type;
+            bool has_end;
+            MemoryTable* table;
+            std::string key;
+            std::string value; //the end key of DEL_RANGE
+            MemoryWriteOp(uint8 t, MemoryTable* tb) :
+                    type(t), has_end(false), table(tb)
+            {
+            }
+    };
+
+    struct MemoryLocalContext: public DBLocalContext
+    {
+            std::vector<MemoryWriteOp> batch;
+            uint32 batch_ref;
+            MemoryLocalContext() :
+                    batch_ref(0)
+            {
+            }
+            void Append(const MemoryWriteOp& op)
+            {
+                batch.push_back(op);
+            }
+    };
+    static ThreadLocal<MemoryLocalContext> g_local_ctx;
+
+    static void apply_write_op(const MemoryWriteOp& op)
+    {
+        switch (op.type)
+        {
+            case MemoryWriteOp::PUT:
+            {
+                op.table->Put(op.key, op.value);
+                break;
+            }
+            case MemoryWriteOp::DEL:
+            {
+                op.table->Del(op.key);
+                break;
+            }
+            case MemoryWriteOp::DEL_RANGE:
+            {
+                op.table->DelRange(op.key, op.value, op.has_end);
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    MemoryEngine::MemoryEngine()
+    {
+    }
+    MemoryEngine::~MemoryEngine()
+    {
+        if (m_cfg.save_on_shutdown && !m_dir.empty())
+        {
+            SaveData(m_dir + "/" + MEMORY_DATA_FILE);
+        }
+        TableMap::iterator it = m_tables.begin();
+        while (it != m_tables.end())
+        {
+            DELETE(it->second);
+            it++;
+        }
+        for (size_t i = 0; i < m_detached.size(); i++)
+        {
+            DELETE(m_detached[i]);
+        }
+    }
+
+    int MemoryEngine::Init(const std::string& dir, const std::string& options)
+    {
+        Properties props;
+        parse_conf_content(options, props);
+        conf_get_bool(props, "save_on_shutdown", m_cfg.save_on_shutdown);
+        m_dir = dir;
+        make_dir(m_dir);
+        std::string file = m_dir + "/" + MEMORY_DATA_FILE;
+        if (is_file_exist(file))
+        {
+            if (0 != LoadData(file))
+            {
+                ERROR_LOG("Failed to load memory engine data from:%s", file.c_str());
+                return -1;
+            }
+            INFO_LOG("Memory engine loaded %u namespaces from:%s", (uint32) m_nss.size(), file.c_str());
+        }
+        return 0;
+    }
+
+    int MemoryEngine::Repair(const std::string& dir)
+    {
+        return 0;
+    }
+
+    MemoryTable* MemoryEngine::GetTable(const Data& ns, bool create_if_missing)
+    {
+        {
+            RWLockGuard<SpinRWLock> guard(m_lock, true);
+            if (m_nss.count(ns) > 0)
+            {
+                return m_tables[ns];
+            }
+        }
+        if (!create_if_missing)
+        {
+            return NULL;
+        }
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        MemoryTable*& table = m_tables[ns];
+        if (NULL == table)
+        {
+            NEW(table, MemoryTable);
+        }
+        m_nss.insert(ns);
+        return table;
+    }
+
+    /*
+     * Tables are kept after their namespace is dropped since iterators & write batches may still refer to them,
+     * a dropped namespace comes back with the same(empty) table.
+     */
+    void MemoryEngine::ClearData()
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        TableMap::iterator it = m_tables.begin();
+        while (it != m_tables.end())
+        {
+            RWLockGuard<SpinRWLock> table_guard(it->second->lock, false);
+            it->second->Clear();
+            it++;
+        }
+        m_nss.clear();
+    }
+
+    static bool write_field(FILE* fp, const char* data, uint32 len)
+    {
+        return fwrite(&len, sizeof(len), 1, fp) == 1 && (0 == len || fwrite(data, len, 1, fp) == 1);
+    }
+    static bool read_field(FILE* fp, std::string& str)
+    {
+        uint32 len = 0;
+        if (fread(&len, sizeof(len), 1, fp) != 1)
+        {
+            return false;
+        }
+        str.resize(len);
+        return 0 == len || fread(&str[0], len, 1, fp) == 1;
+    }
+
+    /*
+     * Layout: magic, then for each namespace [ns][count] followed by 'count' [key][value],
+     * every field is length prefixed. Each namespace is dumped under its read lock, so writers of
+     * the namespace are blocked meanwhile.
+     */
+    int MemoryEngine::SaveData(const std::string& file)
+    {
+        std::string tmp = file + ".tmp";
+        FILE* fp = fopen(tmp.c_str(), "wb");
+        if (NULL == fp)
+        {
+            ERROR_LOG("Failed to open file:%s for reason:%s", tmp.c_str(), strerror(errno));
+            return -1;
+        }
+        bool success = fwrite(MEMORY_DATA_MAGIC, strlen(MEMORY_DATA_MAGIC), 1, fp) == 1;
+        DataArray nss;
+        Context ctx;
+        ListNameSpaces(ctx, nss);
+        for (size_t i = 0; success && i < nss.size(); i++)
+        {
+            MemoryTable* table = GetTable(nss[i], false);
+            if (NULL == table)
+            {
+                continue;
+            }
+            Buffer ns_buffer;
+            nss[i].Encode(ns_buffer);
+            RWLockGuard<SpinRWLock> guard(table->lock, true);
+            uint64 count = table->kvs.size();
+            success = write_field(fp, ns_buffer.GetRawReadBuffer(), ns_buffer.ReadableBytes()) && fwrite(&count, sizeof(count), 1, fp) == 1;
+            MemoryTable::KVMap::iterator it = table->kvs.begin();
+            while (success && it != table->kvs.end())
+            {
+                success = write_field(fp, it->first.data(), it->first.size()) && write_field(fp, it->second.data(), it->second.size());
+                it++;
+            }
+        }
+        success = success && fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+        fclose(fp);
+        if (!success || 0 != rename(tmp.c_str(), file.c_str()))
+        {
+            ERROR_LOG("Failed to save memory engine data to:%s for reason:%s", file.c_str(), strerror(errno));
+            unlink(tmp.c_str());
+            return -1;
+        }
+        return 0;
+    }
+
+    int MemoryEngine::LoadData(const std::string& file)
+    {
+        FILE* fp = fopen(file.c_str(), "rb");
+        if (NULL == fp)
+        {
+            ERROR_LOG("Failed to open file:%s for reason:%s", file.c_str(), strerror(errno));
+            return -1;
+        }
+        char magic[8];
+        bool success = fread(magic, sizeof(magic), 1, fp) == 1 && !strncmp(magic, MEMORY_DATA_MAGIC, sizeof(magic));
+        std::string ns_str, key, value;
+        while (success)
+        {
+            uint64 count = 0;
+            if (!read_field(fp, ns_str))
+            {
+                success = feof(fp) != 0;
+                break;
+            }
+            if (fread(&count, sizeof(count), 1, fp) != 1)
+            {
+                success = false;
+                break;
+            }
+            Data ns;
+            Buffer ns_buffer(const_cast<char*>(ns_str.data()), 0, ns_str.size());
+            if (!ns.Decode(ns_buffer, true))
+            {
+                success = false;
+                break;
+            }
+            MemoryTable* table = GetTable(ns, true);
+            RWLockGuard<SpinRWLock> guard(table->lock, false);
+            for (uint64 i = 0; success && i < count; i++)
+            {
+                success = read_field(fp, key) && read_field(fp, value);
+                if (success)
+                {
+                    table->Put(key, value);
+                }
+            }
+        }
+        fclose(fp);
+        return success ? 0 : -1;
+    }
+
+    int MemoryEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
+    {
+        MemoryTable* table = GetTable(ns, ctx.flags.create_if_notexist);
+        if (NULL == table)
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        MemoryLocalContext& local_ctx = g_local_ctx.GetValue();
+        if (local_ctx.batch_ref > 0)
+        {
+            MemoryWriteOp op(MemoryWriteOp::PUT, table);
+            op.key.assign(key.data(), key.size());
+            op.value.assign(value.data(), value.size());
+            local_ctx.Append(op);
+            return 0;
+        }
+        RWLockGuard<SpinRWLock> guard(table->lock, false);
+        table->Put(key, value);
+        return 0;
+    }
+
+    int MemoryEngine::Put(Context& ctx, const KeyObject& key, const ValueObject& value)
+    {
+        MemoryLocalContext& local_ctx = g_local_ctx.GetValue();
+        Slice ss[2];
+        local_ctx.GetSlices(key, value, ss);
+        return PutRaw(ctx, key.GetNameSpace(), ss[0], ss[1]);
+    }
+
+    int MemoryEngine::MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs)
+    {
+        values.resize(keys.size());
+        errs.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            errs[i] = Get(ctx, keys[i], values[i]);
+        }
+        return 0;
+    }
+
+    int MemoryEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
+    {
+        MemoryTable* table = GetTable(key.GetNameSpace(), false);
+        if (NULL == table)
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        MemoryLocalContext& local_ctx = g_local_ctx.GetValue();
+        Slice ks = local_ctx.GetSlice(key);
+        std::string& valstr = local_ctx.GetStringCache();
+        {
+            RWLockGuard<SpinRWLock> guard(table->lock, true);
+            MemoryTable::KVMap::iterator found = table->kvs.find(std::string(ks.data(), ks.size()));
+            if (found == table->kvs.end())
+            {
+                return ERR_ENTRY_NOT_EXIST;
+            }
+            valstr = found->second;
+        }
+        Buffer valBuffer(const_cast<char*>(valstr.data()), 0, valstr.size());
+        value.Decode(valBuffer, true);
+        return 0;
+    }
+
+    int MemoryEngine::Del(Context& ctx, const KeyObject& key)
+    {
+        MemoryTable* table = GetTable(key.GetNameSpace(), false);
+        if (NULL == table)
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        MemoryLocalContext& local_ctx = g_local_ctx.GetValue();
+        Slice ks = local_ctx.GetSlice(key);
+        if (local_ctx.batch_ref > 0)
+        {
+            MemoryWriteOp op(MemoryWriteOp::DEL, table);
+            op.key.assign(ks.data(), ks.size());
+            local_ctx.Append(op);
+            return 0;
+        }
+        RWLockGuard<SpinRWLock> guard(table->lock, false);
+        table->Del(ks);
+        return 0;
+    }
+
+    int MemoryEngine::DelRange(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        MemoryTable* table = GetTable(start.GetNameSpace(), false);
+        if (NULL == table)
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        MemoryWriteOp op(MemoryWriteOp::DEL_RANGE, table);
+        Buffer start_buffer, end_buffer;
+        Slice start_key = start.Encode(start_buffer, false);
+        op.key.assign(start_key.data(), start_key.size());
+        if (end.GetType() > 0)
+        {
+            Slice end_key = end.Encode(end_buffer, false);
+            op.value.assign(end_key.data(), end_key.size());
+            op.has_end = true;
+        }
+        MemoryLocalContext& local_ctx = g_local_ctx.GetValue();
+        if (local_ctx.batch_ref > 0)
+        {
+            local_ctx.Append(op);
+            return 0;
+        }
+        RWLockGuard<SpinRWLock> guard(table->lock, false);
+        apply_write_op(op);
+        return 0;
+    }
+
+    int MemoryEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& args)
+    {
+        ValueObject current;
+        int err = Get(ctx, key, current);
+        if (0 == err || ERR_ENTRY_NOT_EXIST == err)
+        {
+            err = g_db->MergeOperation(key, current, op, const_cast<DataArray&>(args));
+            if (0 == err)
+            {
+                return Put(ctx, key, current);
+            }
+            if (err == ERR_NOTPERFORMED)
+            {
+                err = 0;
+            }
+        }
+        return err;
+    }
+
+    bool MemoryEngine::Exists(Context& ctx, const KeyObject& key)
+    {
+        MemoryTable* table = GetTable(key.GetNameSpace(), false);
+        if (NULL == table)
+        {
+            return false;
+        }
+        Slice ks = g_local_ctx.GetValue().GetSlice(key);
+        RWLockGuard<SpinRWLock> guard(table->lock, true);
+        return table->kvs.count(std::string(ks.data(), ks.size())) > 0;
+    }
+
+    const std::string MemoryEngine::GetErrorReason(int err)
+    {
+        return "";
+    }
+
+    Iterator* MemoryEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
+    {
+        MemoryTable* table = GetTable(key.GetNameSpace(), false);
+        MemoryIterator* iter = NULL;
+        NEW(iter, MemoryIterator(this, table, key.GetNameSpace()));
+        if (NULL == table)
+        {
+            iter->MarkValid(false);
+            return iter;
+        }
+        iter->SetIterateBounds(options);
+        if (key.GetType() > 0)
+        {
+            iter->Jump(key);
+        }
+        else
+        {
+            iter->JumpToFirst();
+        }
+        return iter;
+    }
+
+    int MemoryEngine::BeginWriteBatch(Context& ctx)
+    {
+        g_local_ctx.GetValue().batch_ref++;
+        return 0;
+    }
+
+    /*
+     * All tables touched by the batch are write locked in address order, so the batch is applied atomically
+     * without deadlock against other batches.
+     */
+    int MemoryEngine::CommitWriteBatch(Context& ctx)
+    {
+        MemoryLocalContext& local_ctx = g_local_ctx.GetValue();
+        if (local_ctx.batch_ref == 0 || --local_ctx.batch_ref > 0)
+        {
+            return 0;
+        }
+        std::vector<MemoryTable*> tables;
+        for (size_t i = 0; i < local_ctx.batch.size(); i++)
+        {
+            tables.push_back(local_ctx.batch[i].table);
+        }
+        std::sort(tables.begin(), tables.end());
+        tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+        for (size_t i = 0; i < tables.size(); i++)
+        {
+            tables[i]->lock.Lock(WRITE_LOCK);
+        }
+        for (size_t i = 0; i < local_ctx.batch.size(); i++)
+        {
+            apply_write_op(local_ctx.batch[i]);
+        }
+        for (size_t i = 0; i < tables.size(); i++)
+        {
+            tables[i]->lock.Unlock(WRITE_LOCK);
+        }
+        local_ctx.batch.clear();
+        return 0;
+    }
+    int MemoryEngine::DiscardWriteBatch(Context& ctx)
+    {
+        MemoryLocalContext& local_ctx = g_local_ctx.GetValue();
+        if (local_ctx.batch_ref == 0 || --local_ctx.batch_ref > 0)
+        {
+            return 0;
+        }
+        local_ctx.batch.clear();
+        return 0;
+    }
+
+    int MemoryEngine::Compact(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        return 0;
+    }
+
+    int MemoryEngine::ListNameSpaces(Context& ctx, DataArray& nss)
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, true);
+        DataSet::iterator it = m_nss.begin();
+        while (it != m_nss.end())
+        {
+            nss.push_back(*it);
+            it++;
+        }
+        return 0;
+    }
+
+    int MemoryEngine::DropNameSpace(Context& ctx, const Data& ns)
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        if (m_nss.erase(ns) == 0)
+        {
+            return 0;
+        }
+        MemoryTable* table = m_tables[ns];
+        RWLockGuard<SpinRWLock> table_guard(table->lock, false);
+        table->Clear();
+        return 0;
+    }
+
+    /*
+     * The table itself stays since iterators may still point to it, only its content is swapped out.
+     */
+    int MemoryEngine::DetachNameSpace(Context& ctx, const Data& ns)
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        if (m_nss.erase(ns) == 0)
+        {
+            return 0;
+        }
+        MemoryTable* table = m_tables[ns];
+        MemoryTable::KVMap* detached = NULL;
+        NEW(detached, MemoryTable::KVMap);
+        {
+            RWLockGuard<SpinRWLock> table_guard(table->lock, false);
+            detached->swap(table->kvs);
+            table->bytes = 0;
+            table->version++;
+        }
+        LockGuard<SpinMutexLock> detached_guard(m_detached_lock);
+        m_detached.push_back(detached);
+        return 0;
+    }
+
+    int MemoryEngine::ReclaimDetachedNameSpaces(Context& ctx)
+    {
+        MemoryTable::KVMap* detached = NULL;
+        {
+            LockGuard<SpinMutexLock> guard(m_detached_lock);
+            if (m_detached.empty())
+            {
+                return 0;
+            }
+            detached = m_detached.back();
+            m_detached.pop_back();
+        }
+        DELETE(detached);
+        LockGuard<SpinMutexLock> guard(m_detached_lock);
+        return (int) m_detached.size();
+    }
+
+    int MemoryEngine::Checkpoint(Context& ctx, const std::string& dir)
+    {
+        make_dir(dir);
+        return SaveData(dir + "/" + MEMORY_DATA_FILE);
+    }
+
+    /*
+     * The checkpoint replaces the content of the existing tables, and becomes the data file of the engine.
+     */
+    int MemoryEngine::Restore(Context& ctx, const std::string& dir)
+    {
+        std::string file = dir + "/" + MEMORY_DATA_FILE;
+        std::string data_file = m_dir + "/" + MEMORY_DATA_FILE;
+        if (!is_file_exist(file))
+        {
+            ERROR_LOG("No memory engine data in checkpoint:%s", dir.c_str());
+            return -1;
+        }
+        ClearData();
+        if (0 != LoadData(file))
+        {
+            ERROR_LOG("Failed to load memory engine data from checkpoint:%s", dir.c_str());
+            ClearData();
+            return -1;
+        }
+        rename(file.c_str(), data_file.c_str());
+        rmdir(dir.c_str());
+        INFO_LOG("Memory engine restored from checkpoint:%s", dir.c_str());
+        return 0;
+    }
+
+    int64_t MemoryEngine::EstimateKeysNum(Context& ctx, const Data& ns)
+    {
+        MemoryTable* table = GetTable(ns, false);
+        if (NULL == table)
+        {
+            return 0;
+        }
+        RWLockGuard<SpinRWLock> guard(table->lock, true);
+        return table->kvs.size();
+    }
+
+    void MemoryEngine::Stats(Context& ctx, std::string& str)
+    {
+        DataArray nss;
+        ListNameSpaces(ctx, nss);
+        uint64 total_keys = 0, total_bytes = 0;
+        for (size_t i = 0; i < nss.size(); i++)
+        {
+            MemoryTable* table = GetTable(nss[i], false);
+            if (NULL == table)
+            {
+                continue;
+            }
+            RWLockGuard<SpinRWLock> guard(table->lock, true);
+            str.append("memory_ns_").append(nss[i].AsString()).append(":keys=").append(stringfromll(table->kvs.size())).append(",bytes=").append(
+                    stringfromll(table->bytes)).append("\r\n");
+            total_keys += table->kvs.size();
+            total_bytes += table->bytes;
+        }
+        str.append("memory_keys:").append(stringfromll(total_keys)).append("\r\n");
+        str.append("memory_bytes:").append(stringfromll(total_bytes)).append("\r\n");
+    }
+
+    void MemoryIterator::ClearState()
+    {
+        m_key.Clear();
+        m_value.Clear();
+        m_valid = true;
+    }
+    /*
+     * Copy the entry at m_iter, the caller holds the read lock of the table.
+     */
+    void MemoryIterator::Load()
+    {
+        if (m_iter == m_table->kvs.end())
+        {
+            m_valid = false;
+            return;
+        }
+        m_raw_key = m_iter->first;
+        m_raw_value = m_iter->second;
+        m_version = m_table->version;
+    }
+    void MemoryIterator::CheckBound()
+    {
+        if (m_valid && (m_iterate_upper_bound_key.GetType() > 0 || m_iterate_lower_bound_key.GetType() > 0))
+        {
+            KeyObject& current = Key(false);
+            if ((m_iterate_upper_bound_key.GetType() > 0 && current.Compare(m_iterate_upper_bound_key) >= 0)
+                    || (m_iterate_lower_bound_key.GetType() > 0 && current.Compare(m_iterate_lower_bound_key) < 0))
+            {
+                m_valid = false;
+            }
+        }
+    }
+    bool MemoryIterator::Valid()
+    {
+        return m_valid && NULL != m_table;
+    }
+    void MemoryIterator::Next()
+    {
+        if (!Valid())
+        {
+            return;
+        }
+        ClearState();
+        {
+            RWLockGuard<SpinRWLock> guard(m_table->lock, true);
+            if (m_version != m_table->version)
+            {
+                m_iter = m_table->kvs.upper_bound(m_raw_key);
+            }
+            else
+            {
+                m_iter++;
+            }
+            Load();
+        }
+        CheckBound();
+    }
+    void MemoryIterator::Prev()
+    {
+        if (!Valid())
+        {
+            return;
+        }
+        ClearState();
+        {
+            RWLockGuard<SpinRWLock> guard(m_table->lock, true);
+            if (m_version != m_table->version)
+            {
+                m_iter = m_table->kvs.lower_bound(m_raw_key);
+            }
+            if (m_iter == m_table->kvs.begin())
+            {
+                m_valid = false;
+                return;
+            }
+            m_iter--;
+            Load();
+        }
+        CheckBound();
+    }
+    void MemoryIterator::DoJump(const KeyObject& next)
+    {
+        ClearState();
+        if (NULL == m_table)
+        {
+            return;
+        }
+        Slice key_slice = next.Encode(g_local_ctx.GetValue().GetEncodeBufferCache(), false);
+        RWLockGuard<SpinRWLock> guard(m_table->lock, true);
+        m_iter = m_table->kvs.lower_bound(std::string(key_slice.data(), key_slice.size()));
+        Load();
+    }
+    void MemoryIterator::Jump(const KeyObject& next)
+    {
+        DoJump(next);
+        CheckBound();
+    }
+    void MemoryIterator::JumpToFirst()
+    {
+        ClearState();
+        if (NULL == m_table)
+        {
+            return;
+        }
+        RWLockGuard<SpinRWLock> guard(m_table->lock, true);
+        m_iter = m_table->kvs.begin();
+        Load();
+    }
+    void MemoryIterator::JumpToLast()
+    {
+        ClearState();
+        if (NULL == m_table)
+        {
+            return;
+        }
+        {
+            RWLockGuard<SpinRWLock> guard(m_table->lock, true);
+            if (m_iterate_upper_bound_key.GetType() > 0)
+            {
+                Slice key_slice = m_iterate_upper_bound_key.Encode(g_local_ctx.GetValue().GetEncodeBufferCache(), false);
+                m_iter = m_table->kvs.lower_bound(std::string(key_slice.data(), key_slice.size()));
+            }
+            else
+            {
+                m_iter = m_table->kvs.end();
+            }
+            if (m_iter == m_table->kvs.begin())
+            {
+                m_valid = false;
+                return;
+            }
+            m_iter--;
+            Load();
+        }
+        CheckBound();
+    }
+
+    KeyObject& MemoryIterator::Key(bool clone_str)
+    {
+        if (m_key.GetType() > 0)
+        {
+            if (clone_str && m_key.GetKey().IsCStr())
+            {
+                m_key.CloneStringPart();
+            }
+            return m_key;
+        }
+        Buffer kbuf(const_cast<char*>(m_raw_key.data()), 0, m_raw_key.size());
+        m_key.Decode(kbuf, clone_str);
+        m_key.SetNameSpace(m_ns);
+        return m_key;
+    }
+    ValueObject& MemoryIterator::Value(bool clone_str)
+    {
+        if (m_value.GetType() > 0)
+        {
+            return m_value;
+        }
+        Buffer vbuf(const_cast<char*>(m_raw_value.data()), 0, m_raw_value.size());
+        m_value.Decode(vbuf, clone_str);
+        return m_value;
+    }
+    Slice MemoryIterator::RawKey()
+    {
+        return Slice(m_raw_key.data(), m_raw_key.size());
+    }
+    Slice MemoryIterator::RawValue()
+    {
+        return Slice(m_raw_value.data(), m_raw_value.size());
+    }
+
+    void MemoryIterator::Del()
+    {
+        if (Valid())
+        {
+            RWLockGuard<SpinRWLock> guard(m_table->lock, false);
+            m_table->Del(m_raw_key);
+        }
+    }
+}
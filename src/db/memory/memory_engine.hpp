@@ -0,0 +1,188 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ * 
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ * 
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ * 
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS 
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MEMORY_ENGINE_HPP_
+#define MEMORY_ENGINE_HPP_
+
+#include "db/engine.hpp"
+#include "util/config_helper.hpp"
+#include "thread/thread_local.hpp"
+#include "thread/spin_rwlock.hpp"
+#include "thread/spin_mutex_lock.hpp"
+
+namespace ardb
+{
+    struct MemoryKeyCompare
+    {
+            bool operator()(const std::string& a, const std::string& b) const
+            {
+                return compare_keys(a.data(), a.size(), b.data(), b.size(), false) < 0;
+            }
+    };
+
+    /*
+     * Ordered key/values of one namespace, 'version' is changed by every insert/erase which invalidates
+     * the iterators of the map.
+     */
+    struct MemoryTable
+    {
+            typedef TreeMap<std::string, std::string, MemoryKeyCompare>::Type KVMap;
+            KVMap kvs;
+            SpinRWLock lock;
+            uint64 version;
+            uint64 bytes;
+            MemoryTable() :
+                    version(0), bytes(0)
+            {
+            }
+            void Put(const Slice& key, const Slice& value);
+            bool Del(const Slice& key);
+            void DelRange(const std::string& start, const std::string& end, bool has_end);
+            void Clear();
+    };
+
+    class MemoryEngine;
+    /*
+     * The current key/value is copied out of the table, the iterator re-seeks from the copied key
+     * if the table changed since the last move.
+     */
+    class MemoryIterator: public Iterator
+    {
+        private:
+            MemoryEngine* m_engine;
+            MemoryTable* m_table;
+            Data m_ns;
+            MemoryTable::KVMap::iterator m_iter;
+            uint64 m_version;
+            std::string m_raw_key;
+            std::string m_raw_value;
+            KeyObject m_key;
+            ValueObject m_value;
+            KeyObject m_iterate_lower_bound_key;
+            KeyObject m_iterate_upper_bound_key;
+            bool m_valid;
+            void ClearState();
+            void CheckBound();
+            void Load();
+            void DoJump(const KeyObject& next);
+            void SetIterateBounds(const IterateOptions& options)
+            {
+                m_iterate_lower_bound_key = options.lower_bound;
+                m_iterate_lower_bound_key.CloneStringPart();
+                m_iterate_upper_bound_key = options.upper_bound;
+                m_iterate_upper_bound_key.CloneStringPart();
+            }
+            friend class MemoryEngine;
+        public:
+            MemoryIterator(MemoryEngine* engine, MemoryTable* table, const Data& ns) :
+                    m_engine(engine), m_table(table), m_ns(ns), m_version(0), m_valid(true)
+            {
+            }
+            void MarkValid(bool valid)
+            {
+                m_valid = valid;
+            }
+            bool Valid();
+            void Next();
+            void Prev();
+            void Jump(const KeyObject& next);
+            void JumpToFirst();
+            void JumpToLast();
+            KeyObject& Key(bool clone_str);
+            ValueObject& Value(bool clone_str);
+            Slice RawKey();
+            Slice RawValue();
+            void Del();
+    };
+
+    struct MemoryConfig
+    {
+            bool save_on_shutdown;
+            MemoryConfig() :
+                    save_on_shutdown(true)
+            {
+            }
+    };
+
+    class MemoryEngine: public Engine
+    {
+        private:
+            typedef TreeMap<Data, MemoryTable*>::Type TableMap;
+            TableMap m_tables;
+            DataSet m_nss;
+            SpinRWLock m_lock;
+            std::vector<MemoryTable::KVMap*> m_detached; //content of detached namespaces, freed by ReclaimDetachedNameSpaces
+            SpinMutexLock m_detached_lock;
+            MemoryConfig m_cfg;
+            std::string m_dir;
+            friend class MemoryIterator;
+            MemoryTable* GetTable(const Data& ns, bool create_if_missing);
+            int SaveData(const std::string& file);
+            int LoadData(const std::string& file);
+            void ClearData();
+        public:
+            MemoryEngine();
+            ~MemoryEngine();
+            int Init(const std::string& dir, const std::string& options);
+            int Repair(const std::string& dir);
+            int Put(Context& ctx, const KeyObject& key, const ValueObject& value);
+            int PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value);
+            int Get(Context& ctx, const KeyObject& key, ValueObject& value);
+            int MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs);
+            int Del(Context& ctx, const KeyObject& key);
+            int DelRange(Context& ctx, const KeyObject& start, const KeyObject& end);
+            int Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& args);
+            bool Exists(Context& ctx, const KeyObject& key);
+            int BeginWriteBatch(Context& ctx);
+            int CommitWriteBatch(Context& ctx);
+            int DiscardWriteBatch(Context& ctx);
+            int Compact(Context& ctx, const KeyObject& start, const KeyObject& end);
+            int ListNameSpaces(Context& ctx, DataArray& nss);
+            int DropNameSpace(Context& ctx, const Data& ns);
+            int DetachNameSpace(Context& ctx, const Data& ns);
+            int ReclaimDetachedNameSpaces(Context& ctx);
+            int Checkpoint(Context& ctx, const std::string& dir);
+            int Restore(Context& ctx, const std::string& dir);
+            void Stats(Context& ctx, std::string& str);
+            int64_t EstimateKeysNum(Context& ctx, const Data& ns);
+            const std::string GetErrorReason(int err);
+            using Engine::Find;
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
+            const FeatureSet GetFeatureSet()
+            {
+                FeatureSet features;
+                features.support_compactfilter = 0;
+                features.support_namespace = 1;
+                features.support_merge = 0;
+                features.support_delete_range = 1;
+                features.support_checkpoint = 1;
+                return features;
+            }
+    };
+}
+#endif
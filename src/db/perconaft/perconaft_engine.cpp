@@ -32,6 +32,7 @@
 #include "db/db.hpp"
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <sys/stat.h>
 #include "db/db_utils.hpp"
 #include "perconaft_engine.hpp"
@@ -153,6 +154,51 @@ namespace ardb
         ERROR_LOG("%s %s", prefix, content);
     }
 
+    /*
+     * Applies the merge operation in 'extra' injected by db->update to the value of the key, called when the
+     * update message reaches a leaf or a query, maybe in a background thread. A merge that is not performed(e.g.
+     * SETNX on an existing key) leaves the value unchanged.
+     */
+    static int ardb_perconaft_update(DB* db, const DBT* key, const DBT* old_val, const DBT* extra, void (*set_val)(const DBT* new_val, void* set_extra),
+            void* set_extra)
+    {
+        KeyObject key_obj;
+        Buffer key_buffer((char*) key->data, 0, key->size);
+        if (!key_obj.Decode(key_buffer, false))
+        {
+            WARN_LOG("Invalid key to merge with size:%u", key->size);
+            return EINVAL;
+        }
+        ValueObject val_obj;
+        if (NULL != old_val)
+        {
+            Buffer val_buffer((char*) old_val->data, 0, old_val->size);
+            if (!val_obj.Decode(val_buffer, false))
+            {
+                WARN_LOG("Invalid existing value to merge with size:%u", old_val->size);
+                return EINVAL;
+            }
+        }
+        ValueObject merge_op;
+        Buffer merge_buffer((char*) extra->data, 0, extra->size);
+        if (!merge_op.Decode(merge_buffer, false))
+        {
+            WARN_LOG("Invalid merge op with size:%u", extra->size);
+            return EINVAL;
+        }
+        if (0 == g_db->MergeOperation(key_obj, val_obj, merge_op.GetMergeOp(), merge_op.GetMergeArgs()))
+        {
+            Buffer encode_buffer;
+            Slice encode_slice = val_obj.Encode(encode_buffer);
+            DBT new_val;
+            memset(&new_val, 0, sizeof(new_val));
+            new_val.data = (void*) encode_slice.data();
+            new_val.size = encode_slice.size();
+            set_val(&new_val, set_extra);
+        }
+        return 0;
+    }
+
     int PerconaFTEngine::Init(const std::string& dir, const std::string& options)
     {
         Properties props;
@@ -189,6 +235,7 @@ namespace ardb
         db_env_create(&m_env, 0);
         m_env->set_default_bt_compare(m_env, ardb_perconaft_compare);
         m_env->set_errcall(m_env, _err_callback);
+        m_env->set_update(m_env, ardb_perconaft_update);
 
         /*
          * set env config
@@ -351,11 +398,18 @@ namespace ardb
     {
         values.resize(keys.size());
         errs.resize(keys.size());
-        for (size_t i = 0; i < keys.size(); i++)
+        /*
+         * all keys are read in one transaction in storage order
+         */
+        PerconaFTLocalContext& local_ctx = g_local_ctx.GetValue();
+        local_ctx.transc.Get();
+        std::vector<size_t> idxs;
+        sort_keys_index(keys, idxs);
+        for (size_t i = 0; i < idxs.size(); i++)
         {
-            int err = Get(ctx, keys[i], values[i]);
-            errs[i] = err;
+            errs[idxs[i]] = Get(ctx, keys[idxs[i]], values[idxs[i]]);
         }
+        local_ctx.transc.Release(true);
         return 0;
     }
     int PerconaFTEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
@@ -401,23 +455,29 @@ namespace ardb
         return ENGINE_NERR(r);
     }
 
+    /*
+     * The merge is injected as an update message without reading the leaf, ardb_perconaft_update applies it later.
+     */
     int PerconaFTEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& args)
     {
-        ValueObject current;
-        int err = Get(ctx, key, current);
-        if (0 == err || ERR_ENTRY_NOT_EXIST == err)
+        DB* db = GetFTDB(ctx, key.GetNameSpace(), ctx.flags.create_if_notexist);
+        if (NULL == db)
         {
-            err = g_db->MergeOperation(key, current, op, const_cast<DataArray&>(args));
-            if (0 == err)
-            {
-                return Put(ctx, key, current);
-            }
-            if (err == ERR_NOTPERFORMED)
-            {
-                err = 0;
-            }
+            return ERR_ENTRY_NOT_EXIST;
         }
-        return err;
+        PerconaFTLocalContext& local_ctx = g_local_ctx.GetValue();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
+        key.Encode(encode_buffer);
+        size_t key_len = encode_buffer.ReadableBytes();
+        encode_merge_operation(encode_buffer, op, args);
+        size_t merge_len = encode_buffer.ReadableBytes() - key_len;
+        DBT key_slice = to_dbt(Slice(encode_buffer.GetRawBuffer(), key_len));
+        DBT merge_slice = to_dbt(Slice(encode_buffer.GetRawBuffer() + key_len, merge_len));
+        DB_TXN* txn = local_ctx.transc.Get();
+        int r = 0;
+        CHECK_EXPR(r = db->update(db, txn, &key_slice, &merge_slice, 0));
+        local_ctx.transc.Release(0 == r);
+        return ENGINE_ERR(r);
     }
 
     bool PerconaFTEngine::Exists(Context& ctx, const KeyObject& key)
@@ -530,7 +590,7 @@ namespace ardb
         return db_strerror(err);
     }
 
-    Iterator* PerconaFTEngine::Find(Context& ctx, const KeyObject& key)
+    Iterator* PerconaFTEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
     {
         PerconaFTIterator* iter = NULL;
         NEW(iter, PerconaFTIterator(this,key.GetNameSpace()));
@@ -552,26 +612,9 @@ namespace ardb
             return iter;
         }
         iter->SetCursor(db, txn, c);
+        iter->SetIterateBounds(options);
         if (key.GetType() > 0)
         {
-            if (!ctx.flags.iterate_multi_keys)
-            {
-                if (!ctx.flags.iterate_no_upperbound)
-                {
-                    KeyObject& upperbound_key = iter->IterateUpperBoundKey();
-                    upperbound_key.SetNameSpace(key.GetNameSpace());
-                    if (key.GetType() == KEY_META)
-                    {
-                        upperbound_key.SetType(KEY_END);
-                    }
-                    else
-                    {
-                        upperbound_key.SetType(key.GetType() + 1);
-                    }
-                    upperbound_key.SetKey(key.GetKey());
-                    upperbound_key.CloneStringPart();
-                }
-            }
             iter->Jump(key);
 
         }
@@ -605,6 +648,7 @@ namespace ardb
             m_valid = false;
             return;
         }
+        CheckBound();
     }
     void PerconaFTIterator::DoJump(const KeyObject& next)
     {
@@ -739,11 +783,13 @@ namespace ardb
     }
     void PerconaFTIterator::CheckBound()
     {
-        if (NULL != m_cursor && m_iterate_upper_bound_key.GetType() > 0)
+        if (NULL != m_cursor && (m_iterate_upper_bound_key.GetType() > 0 || m_iterate_lower_bound_key.GetType() > 0))
         {
             if (m_valid)
             {
-                if (Key(false).Compare(m_iterate_upper_bound_key) >= 0)
+                KeyObject& current = Key(false);
+                if ((m_iterate_upper_bound_key.GetType() > 0 && current.Compare(m_iterate_upper_bound_key) >= 0)
+                        || (m_iterate_lower_bound_key.GetType() > 0 && current.Compare(m_iterate_lower_bound_key) < 0))
                 {
                     m_valid = false;
                 }
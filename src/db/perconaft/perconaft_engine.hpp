@@ -53,6 +53,7 @@ namespace ardb
             ValueObject m_value;
             DBT m_raw_key;
             DBT m_raw_val;
+            KeyObject m_iterate_lower_bound_key;
             KeyObject m_iterate_upper_bound_key;
             bool m_valid;
 
@@ -78,9 +79,12 @@ namespace ardb
                 m_txn = txn;
                 m_cursor = c;
             }
-            KeyObject& IterateUpperBoundKey()
+            void SetIterateBounds(const IterateOptions& options)
             {
-                return m_iterate_upper_bound_key;
+                m_iterate_lower_bound_key = options.lower_bound;
+                m_iterate_lower_bound_key.CloneStringPart();
+                m_iterate_upper_bound_key = options.upper_bound;
+                m_iterate_upper_bound_key.CloneStringPart();
             }
             friend class PerconaFTEngine;
         public:
@@ -127,14 +131,15 @@ namespace ardb
             int DropNameSpace(Context& ctx, const Data& ns);
             void Stats(Context& ctx, std::string& str);
             int64_t EstimateKeysNum(Context& ctx, const Data& ns);
-            Iterator* Find(Context& ctx, const KeyObject& key);
+            using Engine::Find;
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
             const std::string GetErrorReason(int err);
             const FeatureSet GetFeatureSet()
             {
                 FeatureSet features;
                 features.support_compactfilter = 0;
                 features.support_namespace = 1;
-                features.support_merge = 0;
+                features.support_merge = 1;
                 return features;
             }
     };
@@ -31,9 +31,28 @@
 #include "rocksdb/compaction_filter.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/utilities/memory_util.h"
+#include "rocksdb/utilities/checkpoint.h"
 #include "rocksdb/table.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/perf_level.h"
+#include "rocksdb/listener.h"
+#include "rocksdb/rate_limiter.h"
+#include "rocksdb/delete_scheduler.h"
 #include "thread/lock_guard.hpp"
+#include "thread/thread_mutex_lock.hpp"
+#include "thread/thread.hpp"
+#include "util/file_helper.hpp"
+#include "util/atomic.hpp"
+#include <deque>
+#include <queue>
+#include <algorithm>
+#include <errno.h>
+#include <unistd.h>
 #include "db/db.hpp"
+#include "db/db_utils.hpp"
+#include "bgjobs.hpp"
+#include "util/probes.hpp"
 
 OP_NAMESPACE_BEGIN
 
@@ -94,35 +113,730 @@ OP_NAMESPACE_BEGIN
     {
             const rocksdb::Snapshot* snapshot;
             uint32_t ref;
+            bool shared; //owned by CreateSharedSnapshot, not released with the last ref
             RocksSnapshot() :
-                    snapshot(NULL), ref(0)
+                    snapshot(NULL), ref(0), shared(false)
             {
             }
     };
 
+    /*
+     * Leader/follower group commit, the first queued writer merges the batches of writers queued behind it
+     * and commits them by one rocksdb write(one WAL append/sync), followers just wait the result.
+     */
+#define ROCKS_WRITE_BATCH_HEADER_SIZE 12
+#define ROCKS_GROUP_COMMIT_MAX_BYTES (1024 * 1024)
+    class RocksGroupCommit
+    {
+        private:
+            struct Writer
+            {
+                    rocksdb::WriteBatch* batch;
+                    bool disable_wal;
+                    bool done;
+                    rocksdb::Status status;
+                    Writer(rocksdb::WriteBatch* b, bool dw) :
+                            batch(b), disable_wal(dw), done(false)
+                    {
+                    }
+            };
+            ThreadMutexLock m_lock;
+            std::deque<Writer*> m_writers;
+        public:
+            rocksdb::Status Write(rocksdb::DB* db, const rocksdb::WriteOptions& opt, rocksdb::WriteBatch* batch)
+            {
+                Writer w(batch, opt.disableWAL);
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                m_writers.push_back(&w);
+                while (!w.done && &w != m_writers.front())
+                {
+                    m_lock.Wait();
+                }
+                if (w.done)
+                {
+                    return w.status;
+                }
+                size_t group_size = 1;
+                size_t group_bytes = batch->GetDataSize();
+                while (group_size < m_writers.size())
+                {
+                    Writer* next = m_writers[group_size];
+                    if (next->disable_wal != w.disable_wal || group_bytes + next->batch->GetDataSize() > ROCKS_GROUP_COMMIT_MAX_BYTES)
+                    {
+                        break;
+                    }
+                    group_bytes += next->batch->GetDataSize();
+                    group_size++;
+                }
+                std::string merged_rep;
+                if (group_size > 1)
+                {
+                    /*
+                     * batch data is a 12 bytes header(8 bytes sequence + 4 bytes fixed32 count) followed by records
+                     */
+                    merged_rep.reserve(group_bytes);
+                    merged_rep.assign(ROCKS_WRITE_BATCH_HEADER_SIZE, 0);
+                    uint32 count = 0;
+                    for (size_t i = 0; i < group_size; i++)
+                    {
+                        const std::string& data = m_writers[i]->batch->Data();
+                        merged_rep.append(data.data() + ROCKS_WRITE_BATCH_HEADER_SIZE, data.size() - ROCKS_WRITE_BATCH_HEADER_SIZE);
+                        count += m_writers[i]->batch->Count();
+                    }
+                    for (int i = 0; i < 4; i++)
+                    {
+                        merged_rep[8 + i] = (char) ((count >> (8 * i)) & 0xff);
+                    }
+                }
+                m_lock.Unlock();
+                rocksdb::Status s;
+                if (group_size > 1)
+                {
+                    rocksdb::WriteBatch merged(merged_rep);
+                    s = db->Write(opt, &merged);
+                }
+                else
+                {
+                    s = db->Write(opt, batch);
+                }
+                m_lock.Lock();
+                for (size_t i = 0; i < group_size; i++)
+                {
+                    Writer* done = m_writers.front();
+                    m_writers.pop_front();
+                    done->status = s;
+                    done->done = true;
+                }
+                m_lock.NotifyAll();
+                return s;
+            }
+    };
+
+    static void remove_db_dir(const std::string& dir)
+    {
+        std::deque<std::string> files;
+        list_subfiles(dir, files);
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            unlink((dir + "/" + files[i]).c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
+    /*
+     * Bulk ingestion: puts are appended to a buffer per column family, every full buffer is sorted & spilled
+     * into a run file by a background thread. At the end the runs of every column family are merged(the latest
+     * put of a key wins) by one thread per column family into sst files added by DB::AddFile, which skips
+     * memtables & WAL. Once rocksdb refuses a file(overlapping keys, held snapshots), the rest of the merge is
+     * written by plain puts instead.
+     * Only puts are captured, loaders never delete or merge while loading.
+     */
+#define ROCKS_INGEST_REFUSED -2
+#define ROCKS_INGEST_MAX_SPILLS 2
+#define ROCKS_INGEST_MIN_SST_SIZE (256 * 1024 * 1024)
+#define ROCKS_INGEST_WRITE_BATCH_SIZE (1024 * 1024)
+    class RocksBulkIngest
+    {
+        public:
+            typedef std::shared_ptr<rocksdb::ColumnFamilyHandle> ColumnFamilyHandlePtr;
+        private:
+            struct Entry
+            {
+                    size_t offset;
+                    uint32 key_len;
+                    uint32 value_len;
+            };
+            struct EntryLess
+            {
+                    const rocksdb::Comparator* cmp;
+                    const std::string* arena;
+                    EntryLess(const rocksdb::Comparator* c, const std::string* a) :
+                            cmp(c), arena(a)
+                    {
+                    }
+                    bool operator()(const Entry& a, const Entry& b) const
+                    {
+                        return cmp->Compare(rocksdb::Slice(arena->data() + a.offset, a.key_len),
+                                rocksdb::Slice(arena->data() + b.offset, b.key_len)) < 0;
+                    }
+            };
+            struct Table
+            {
+                    std::string name;
+                    ColumnFamilyHandlePtr cf;
+                    bool whole_load; //created by BeginBulkLoad, not by BeginBulkIngest
+                    std::string arena;
+                    std::vector<Entry> entries;
+                    std::vector<std::string> runs;
+                    Table() :
+                            whole_load(false)
+                    {
+                    }
+            };
+            struct SpillTask: public Runnable
+            {
+                    const rocksdb::Comparator* cmp;
+                    std::string path;
+                    std::string arena;
+                    std::vector<Entry> entries;
+                    bool ok;
+                    SpillTask() :
+                            cmp(NULL), ok(false)
+                    {
+                    }
+                    void Run()
+                    {
+                        /*
+                         * stable sort keeps puts of the same key in arrival order, only the last one is written
+                         */
+                        std::stable_sort(entries.begin(), entries.end(), EntryLess(cmp, &arena));
+                        FILE* fp = fopen(path.c_str(), "wb");
+                        if (NULL == fp)
+                        {
+                            ERROR_LOG("Failed to open ingest run:%s for reason:%s", path.c_str(), strerror(errno));
+                            return;
+                        }
+                        ok = true;
+                        for (size_t i = 0; i < entries.size() && ok; i++)
+                        {
+                            const Entry& e = entries[i];
+                            if (i + 1 < entries.size())
+                            {
+                                const Entry& next = entries[i + 1];
+                                if (0 == cmp->Compare(rocksdb::Slice(arena.data() + e.offset, e.key_len),
+                                        rocksdb::Slice(arena.data() + next.offset, next.key_len)))
+                                {
+                                    continue;
+                                }
+                            }
+                            ok = fwrite(&e.key_len, sizeof(uint32), 1, fp) == 1 && fwrite(&e.value_len, sizeof(uint32), 1, fp) == 1
+                                    && fwrite(arena.data() + e.offset, e.key_len + e.value_len, 1, fp) == 1;
+                        }
+                        if (0 != fclose(fp))
+                        {
+                            ok = false;
+                        }
+                        if (!ok)
+                        {
+                            ERROR_LOG("Failed to write ingest run:%s for reason:%s", path.c_str(), strerror(errno));
+                        }
+                        std::string().swap(arena);
+                        std::vector<Entry>().swap(entries);
+                    }
+            };
+            struct RunReader
+            {
+                    FILE* fp;
+                    std::string key;
+                    std::string value;
+                    RunReader() :
+                            fp(NULL)
+                    {
+                    }
+                    bool Next()
+                    {
+                        uint32 lens[2];
+                        if (fread(lens, sizeof(uint32), 2, fp) != 2)
+                        {
+                            return false;
+                        }
+                        key.resize(lens[0]);
+                        value.resize(lens[1]);
+                        return (0 == lens[0] || fread(&key[0], lens[0], 1, fp) == 1) && (0 == lens[1] || fread(&value[0], lens[1], 1, fp) == 1);
+                    }
+                    ~RunReader()
+                    {
+                        if (NULL != fp)
+                        {
+                            fclose(fp);
+                        }
+                    }
+            };
+            /*
+             * max heap order of priority_queue, top is the smallest key, the newest run on same keys
+             */
+            struct RunGreater
+            {
+                    const rocksdb::Comparator* cmp;
+                    const std::vector<RunReader*>* readers;
+                    RunGreater(const rocksdb::Comparator* c, const std::vector<RunReader*>* r) :
+                            cmp(c), readers(r)
+                    {
+                    }
+                    bool operator()(size_t a, size_t b) const
+                    {
+                        int c = cmp->Compare((*readers)[a]->key, (*readers)[b]->key);
+                        if (0 != c)
+                        {
+                            return c > 0;
+                        }
+                        return a < b;
+                    }
+            };
+            struct MergeTask: public Runnable
+            {
+                    RocksBulkIngest* ingest;
+                    rocksdb::DB* db;
+                    Table* table;
+                    int err;
+                    MergeTask(RocksBulkIngest* i, rocksdb::DB* d, Table* t) :
+                            ingest(i), db(d), table(t), err(0)
+                    {
+                    }
+                    void Run()
+                    {
+                        err = ingest->MergeTable(db, table);
+                    }
+            };
+            typedef TreeMap<std::string, Table*>::Type TableMap;
+            typedef std::deque<std::pair<SpillTask*, Thread*> > SpillQueue;
+            const rocksdb::Options& m_options;
+            std::string m_dir;
+            ThreadMutexLock m_lock;
+            TableMap m_tables;
+            SpillQueue m_spills;
+            volatile uint32 m_run_seq;
+            bool m_whole_load;
+            volatile bool m_active;
+            bool m_spill_failed;
+            uint32 m_merging;
+
+            /*
+             * REQUIRES: m_lock held
+             */
+            void Spill(Table* t, bool wait)
+            {
+                SpillTask* task = NULL;
+                NEW(task, SpillTask);
+                task->cmp = m_options.comparator;
+                char name[64];
+                sprintf(name, "/%u.run", m_run_seq++);
+                task->path = m_dir + name;
+                task->arena.swap(t->arena);
+                task->entries.swap(t->entries);
+                t->runs.push_back(task->path);
+                if (wait)
+                {
+                    task->Run();
+                    m_spill_failed = m_spill_failed || !task->ok;
+                    DELETE(task);
+                    return;
+                }
+                while (m_spills.size() >= ROCKS_INGEST_MAX_SPILLS)
+                {
+                    JoinSpill();
+                }
+                Thread* thread = NULL;
+                NEW(thread, Thread(task));
+                thread->Start();
+                m_spills.push_back(SpillQueue::value_type(task, thread));
+            }
+            void JoinSpill()
+            {
+                SpillTask* task = m_spills.front().first;
+                Thread* thread = m_spills.front().second;
+                m_spills.pop_front();
+                thread->Join();
+                m_spill_failed = m_spill_failed || !task->ok;
+                DELETE(thread);
+                DELETE(task);
+            }
+            void RemoveRuns(Table* t)
+            {
+                for (size_t i = 0; i < t->runs.size(); i++)
+                {
+                    unlink(t->runs[i].c_str());
+                }
+                t->runs.clear();
+            }
+            int MergeRuns(rocksdb::DB* db, Table* t, bool use_sst, const std::string* skip_until, std::string& added, bool& has_added)
+            {
+                const rocksdb::Comparator* cmp = m_options.comparator;
+                std::vector<RunReader*> readers;
+                RunGreater greater(cmp, &readers);
+                std::priority_queue<size_t, std::vector<size_t>, RunGreater> heap(greater);
+                for (size_t i = 0; i < t->runs.size(); i++)
+                {
+                    RunReader* reader = NULL;
+                    NEW(reader, RunReader);
+                    readers.push_back(reader);
+                    reader->fp = fopen(t->runs[i].c_str(), "rb");
+                    if (NULL != reader->fp && reader->Next())
+                    {
+                        heap.push(i);
+                    }
+                }
+                rocksdb::ImmutableCFOptions ioptions(m_options);
+                rocksdb::SstFileWriter* writer = NULL;
+                std::string sst_path, sst_largest, last_key;
+                uint64 sst_size = 0, sst_limit = m_options.target_file_size_base;
+                if (sst_limit < ROCKS_INGEST_MIN_SST_SIZE)
+                {
+                    sst_limit = ROCKS_INGEST_MIN_SST_SIZE;
+                }
+                rocksdb::WriteBatch batch;
+                rocksdb::WriteOptions opt;
+                opt.disableWAL = true;
+                rocksdb::Status s;
+                bool has_last = false;
+                int err = 0;
+                while (!heap.empty() && s.ok())
+                {
+                    size_t idx = heap.top();
+                    heap.pop();
+                    RunReader* reader = readers[idx];
+                    bool emit = !has_last || cmp->Compare(reader->key, last_key) != 0;
+                    if (emit)
+                    {
+                        last_key = reader->key;
+                        has_last = true;
+                    }
+                    if (emit && (NULL == skip_until || cmp->Compare(reader->key, *skip_until) > 0))
+                    {
+                        if (!use_sst)
+                        {
+                            batch.Put(t->cf.get(), reader->key, reader->value);
+                            if (batch.GetDataSize() >= ROCKS_INGEST_WRITE_BATCH_SIZE)
+                            {
+                                s = db->Write(opt, &batch);
+                                batch.Clear();
+                            }
+                        }
+                        else
+                        {
+                            if (NULL == writer)
+                            {
+                                char name[64];
+                                sprintf(name, "/%u.sst", atomic_add_uint32(&m_run_seq, 1));
+                                sst_path = m_dir + name;
+                                writer = new rocksdb::SstFileWriter(rocksdb::EnvOptions(), ioptions, cmp);
+                                s = writer->Open(sst_path);
+                                sst_size = 0;
+                            }
+                            if (s.ok())
+                            {
+                                s = writer->Add(reader->key, reader->value);
+                                sst_size += reader->key.size() + reader->value.size();
+                                BackgroundJobs::GetSingleton().Request(reader->key.size() + reader->value.size());
+                                sst_largest = reader->key;
+                            }
+                        }
+                    }
+                    if (reader->Next())
+                    {
+                        heap.push(idx);
+                    }
+                    if (NULL != writer && s.ok() && (sst_size >= sst_limit || heap.empty()))
+                    {
+                        s = writer->Finish();
+                        delete writer;
+                        writer = NULL;
+                        if (s.ok())
+                        {
+                            s = db->AddFile(t->cf.get(), sst_path, true);
+                            if (!s.ok())
+                            {
+                                WARN_LOG("RocksDB refused to add sst file:%s for reason:%s", sst_path.c_str(), s.ToString().c_str());
+                                err = ROCKS_INGEST_REFUSED;
+                            }
+                            else
+                            {
+                                added = sst_largest;
+                                has_added = true;
+                            }
+                        }
+                        if (!s.ok())
+                        {
+                            unlink(sst_path.c_str());
+                        }
+                    }
+                }
+                if (NULL != writer)
+                {
+                    delete writer;
+                    unlink(sst_path.c_str());
+                }
+                if (s.ok() && !use_sst)
+                {
+                    s = db->Write(opt, &batch);
+                    if (s.ok())
+                    {
+                        s = db->Flush(rocksdb::FlushOptions(), t->cf.get());
+                    }
+                }
+                for (size_t i = 0; i < readers.size(); i++)
+                {
+                    DELETE(readers[i]);
+                }
+                if (!s.ok() && 0 == err)
+                {
+                    ERROR_LOG("Failed to ingest column family:%s for reason:%s", t->name.c_str(), s.ToString().c_str());
+                    err = -1;
+                }
+                return err;
+            }
+            int MergeTable(rocksdb::DB* db, Table* t)
+            {
+                int err = 0;
+                if (NULL != t->cf.get() && !t->runs.empty())
+                {
+                    uint64 start = get_current_epoch_millis();
+                    std::string added;
+                    bool has_added = false;
+                    err = MergeRuns(db, t, true, NULL, added, has_added);
+                    if (ROCKS_INGEST_REFUSED == err)
+                    {
+                        WARN_LOG("Write the rest of column family:%s by puts.", t->name.c_str());
+                        err = MergeRuns(db, t, false, has_added ? &added : NULL, added, has_added);
+                    }
+                    INFO_LOG("Ingest %u runs into column family:%s cost %llums.", (uint32) t->runs.size(), t->name.c_str(),
+                            get_current_epoch_millis() - start);
+                }
+                RemoveRuns(t);
+                return err;
+            }
+        public:
+            RocksBulkIngest(const rocksdb::Options& options, const std::string& dir) :
+                    m_options(options), m_dir(dir), m_run_seq(0), m_whole_load(false), m_active(false), m_spill_failed(false), m_merging(0)
+            {
+                remove_db_dir(m_dir);
+            }
+            int Begin(const Data& ns)
+            {
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                std::string name = ns.AsString();
+                if (!is_dir_exist(m_dir) && !make_dir(m_dir))
+                {
+                    ERROR_LOG("Failed to create ingest dir:%s", m_dir.c_str());
+                    return -1;
+                }
+                if (!m_active)
+                {
+                    m_spill_failed = false;
+                }
+                if (ns.IsNil())
+                {
+                    m_whole_load = true;
+                }
+                else
+                {
+                    Table*& t = m_tables[name];
+                    if (NULL != t)
+                    {
+                        return -1;
+                    }
+                    NEW(t, Table);
+                    t->name = name;
+                }
+                m_active = true;
+                return 0;
+            }
+            /*
+             * Returns false if the put is not captured by any ingestion
+             */
+            bool Add(Context& ctx, const Data& ns, const ColumnFamilyHandlePtr& cf, const rocksdb::Slice& key, const rocksdb::Slice& value)
+            {
+                if (!m_active)
+                {
+                    return false;
+                }
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                std::string name = ns.AsString();
+                TableMap::iterator found = m_tables.find(name);
+                Table* t = NULL;
+                if (found != m_tables.end())
+                {
+                    t = found->second;
+                }
+                else if (m_whole_load && ctx.flags.bulk_loading)
+                {
+                    NEW(t, Table);
+                    t->name = name;
+                    t->whole_load = true;
+                    m_tables[name] = t;
+                }
+                else
+                {
+                    return false;
+                }
+                if (NULL == t->cf.get())
+                {
+                    t->cf = cf;
+                }
+                Entry e;
+                e.offset = t->arena.size();
+                e.key_len = key.size();
+                e.value_len = value.size();
+                t->arena.append(key.data(), key.size());
+                t->arena.append(value.data(), value.size());
+                t->entries.push_back(e);
+                if (t->arena.size() >= (size_t) g_db->GetConf().rocksdb_ingest_buffer_size)
+                {
+                    Spill(t, false);
+                }
+                return true;
+            }
+            /*
+             * Ends the ingestion of 'ns', or of all namespaces captured since Begin with a nil 'ns'
+             */
+            int End(rocksdb::DB* db, const Data& ns, bool abort)
+            {
+                std::vector<Table*> tables;
+                int err = 0;
+                {
+                    LockGuard<ThreadMutexLock> guard(m_lock);
+                    TableMap::iterator it = m_tables.begin();
+                    while (it != m_tables.end())
+                    {
+                        if (ns.IsNil() ? it->second->whole_load : it->first == ns.AsString())
+                        {
+                            tables.push_back(it->second);
+                            it = m_tables.erase(it);
+                        }
+                        else
+                        {
+                            it++;
+                        }
+                    }
+                    if (ns.IsNil())
+                    {
+                        m_whole_load = false;
+                    }
+                    m_active = m_whole_load || !m_tables.empty();
+                    while (!m_spills.empty())
+                    {
+                        JoinSpill();
+                    }
+                    for (size_t i = 0; i < tables.size(); i++)
+                    {
+                        if (!abort && !tables[i]->entries.empty())
+                        {
+                            Spill(tables[i], true);
+                        }
+                    }
+                    err = m_spill_failed ? -1 : 0;
+                    m_merging++;
+                }
+                std::vector<MergeTask*> tasks;
+                std::vector<Thread*> threads;
+                for (size_t i = 0; i < tables.size(); i++)
+                {
+                    if (abort || 0 != err)
+                    {
+                        RemoveRuns(tables[i]);
+                        continue;
+                    }
+                    MergeTask* task = NULL;
+                    NEW(task, MergeTask(this, db, tables[i]));
+                    Thread* thread = NULL;
+                    NEW(thread, Thread(task));
+                    thread->Start();
+                    tasks.push_back(task);
+                    threads.push_back(thread);
+                }
+                for (size_t i = 0; i < threads.size(); i++)
+                {
+                    threads[i]->Join();
+                    if (0 != tasks[i]->err)
+                    {
+                        err = tasks[i]->err;
+                    }
+                    DELETE(threads[i]);
+                    DELETE(tasks[i]);
+                }
+                for (size_t i = 0; i < tables.size(); i++)
+                {
+                    DELETE(tables[i]);
+                }
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                m_merging--;
+                if (!m_active && 0 == m_merging)
+                {
+                    remove_db_dir(m_dir);
+                }
+                return err;
+            }
+            ~RocksBulkIngest()
+            {
+                while (!m_spills.empty())
+                {
+                    JoinSpill();
+                }
+                TableMap::iterator it = m_tables.begin();
+                while (it != m_tables.end())
+                {
+                    RemoveRuns(it->second);
+                    DELETE(it->second);
+                    it++;
+                }
+                remove_db_dir(m_dir);
+            }
+    };
+
 #define DEFAULT_ROCKS_LOCAL_MULTI_CACHE_SIZE 10
-    struct RocksDBLocalContext
+#define ROCKS_ITER_POOL_SIZE 16
+#define ROCKS_READ_PREFIX_SAME_AS_START 1
+#define ROCKS_READ_TOTAL_ORDER_SEEK 2
+#define ROCKS_READ_NO_FILL_CACHE 4
+    /*
+     * An iterator released while its snapshot is still held by the thread(snapshot reads, nested iterators),
+     * it sees exactly what a new one on the same snapshot would, rocksdb 4.x has no Iterator::Refresh for
+     * reuse across snapshots.
+     */
+    struct RocksPooledIterator
+    {
+            uint32_t cf_id;
+            const rocksdb::Snapshot* snapshot;
+            uint8 read_flags;
+            rocksdb::Iterator* iter;
+    };
+
+    struct RocksDBLocalContext: public DBLocalContext
     {
             RocksWriteBatch transc;
             RocksSnapshot snapshot;
-            Buffer encode_buffer_cache;
-            std::string string_cache;
+            std::vector<RocksPooledIterator> iter_pool;
             std::vector<std::string> multi_string_cache;
-            typedef TreeMap<int, rocksdb::Status>::Type ErrMap;
-            ErrMap err_map;
-            const rocksdb::Snapshot* PeekSnapshot() const
+            rocksdb::Iterator* TakeIterator(uint32_t cf_id, const rocksdb::Snapshot* snap, uint8 read_flags)
             {
-                return snapshot.snapshot;
+                for (size_t i = 0; i < iter_pool.size(); i++)
+                {
+                    RocksPooledIterator& pooled = iter_pool[i];
+                    if (pooled.cf_id == cf_id && pooled.snapshot == snap && pooled.read_flags == read_flags)
+                    {
+                        rocksdb::Iterator* iter = pooled.iter;
+                        iter_pool[i] = iter_pool.back();
+                        iter_pool.pop_back();
+                        return iter;
+                    }
+                }
+                return NULL;
+            }
+            bool ReturnIterator(uint32_t cf_id, const rocksdb::Snapshot* snap, uint8 read_flags, rocksdb::Iterator* iter)
+            {
+                if (iter_pool.size() >= ROCKS_ITER_POOL_SIZE || !iter->status().ok())
+                {
+                    return false;
+                }
+                RocksPooledIterator pooled;
+                pooled.cf_id = cf_id;
+                pooled.snapshot = snap;
+                pooled.read_flags = read_flags;
+                pooled.iter = iter;
+                iter_pool.push_back(pooled);
+                return true;
             }
-            Buffer& GetEncodeBuferCache()
+            void ClearIterators()
             {
-                encode_buffer_cache.Clear();
-                return encode_buffer_cache;
+                for (size_t i = 0; i < iter_pool.size(); i++)
+                {
+                    delete iter_pool[i].iter;
+                }
+                iter_pool.clear();
             }
-            std::string& GetStringCache()
+            const rocksdb::Snapshot* PeekSnapshot() const
             {
-                string_cache.clear();
-                return string_cache;
+                return snapshot.snapshot;
             }
             std::vector<string>& GetMultiStringCache(size_t num)
             {
@@ -138,7 +852,11 @@ OP_NAMESPACE_BEGIN
             }
     };
 
-    static ThreadLocal<RocksDBLocalContext> g_rocks_context;
+    /*
+     * rocksdb statuses of the error codes returned to the thread, shared by all engine instances
+     */
+    typedef TreeMap<int, rocksdb::Status>::Type RocksErrMap;
+    static ThreadLocal<RocksErrMap> g_rocks_errs;
 
     static inline int rocksdb_err(const rocksdb::Status& s)
     {
@@ -151,7 +869,7 @@ OP_NAMESPACE_BEGIN
             return ERR_ENTRY_NOT_EXIST;
         }
         int err = (int)(s.code()) << 8 + s.subcode();
-        g_rocks_context.GetValue().err_map[err] = s;
+        g_rocks_errs.GetValue()[err] = s;
         return err + STORAGE_ENGINE_ERR_OFFSET;
     }
 
@@ -332,15 +1050,67 @@ OP_NAMESPACE_BEGIN
             }
     };
 
+    /*
+     * A meta value moved to the blob column family leaves this one byte reference in its place, encoded values
+     * start with their type which is never above KEY_END.
+     */
+#define ROCKS_BLOB_REF_TYPE 0xFE
+    static bool is_blob_ref(const rocksdb::Slice& value)
+    {
+        return value.size() == 1 && (uint8) value[0] == ROCKS_BLOB_REF_TYPE;
+    }
+
     class RocksDBCompactionFilter: public rocksdb::CompactionFilter
     {
         private:
+            RocksDBEngine* engine;
             Data ns;
             int num_levels;
+            bool check_orphans;
+            /*
+             * keys arrive in order, elements of one object are checked against its meta once
+             */
+            mutable std::string last_object;
+            mutable bool last_object_alive;
+            bool IsObjectAlive(const KeyObject& k) const
+            {
+                /*
+                 * no meta can be found by an object id, elements keyed by one are deleted along with their object
+                 */
+                if (k.GetObjectId() > 0)
+                {
+                    return true;
+                }
+                const Data& key = k.GetKey();
+                if (!last_object.empty() && last_object.size() == key.StringLength() && !memcmp(last_object.data(), key.CStr(), key.StringLength()))
+                {
+                    return last_object_alive;
+                }
+                last_object.assign(key.CStr(), key.StringLength());
+                ardb::Context ctx;
+                KeyObject meta_key(ns, KEY_META, last_object);
+                ValueObject meta;
+                int err = engine->Get(ctx, meta_key, meta);
+                if (ERR_ENTRY_NOT_EXIST == err)
+                {
+                    last_object_alive = false;
+                }
+                else
+                {
+                    last_object_alive = (0 != err || meta.GetTTL() == 0 || meta.GetTTL() > (int64) get_current_epoch_millis());
+                }
+                return last_object_alive;
+            }
         public:
-            RocksDBCompactionFilter(RocksDBEngine* engine, const rocksdb::CompactionFilter::Context& context, int num_levels):num_levels(num_levels)
+            RocksDBCompactionFilter(RocksDBEngine* e, const rocksdb::CompactionFilter::Context& context, int num_levels):engine(e), num_levels(num_levels), check_orphans(false), last_object_alive(true)
             {
                 ns = engine->GetNamespaceByColumnFamilyId(context.column_family_id);
+                if (!ns.IsNil())
+                {
+                    std::string ns_str = ns.AsString();
+                    check_orphans = ns_str != TTL_DB_NSMAESPACE && ns_str != ZSET_STORE_NAMESPACE && ns_str != LAZYFREE_DB_NAMESPACE
+                            && ns_str != INDEX_DB_NAMESPACE;
+                }
             }
             const char* Name() const
             {
@@ -380,6 +1150,10 @@ OP_NAMESPACE_BEGIN
 
                 if (k.GetType() == KEY_META)
                 {
+                    if (is_blob_ref(existing_value))
+                    {
+                        return false;
+                    }
                     ValueObject meta;
                     Buffer val_buffer(const_cast<char*>(existing_value.data()), 0, existing_value.size());
                     if (!meta.DecodeMeta(val_buffer))
@@ -404,6 +1178,28 @@ OP_NAMESPACE_BEGIN
                         return true;
                       
                 }
+                else if (k.GetType() == KEY_HASH_FIELD && check_orphans)
+                {
+                    /*
+                     * hash fields with a passed ttl(HEXPIRE) are dropped here, the size of their hash is not tracked
+                     */
+                    ValueObject field_value;
+                    Buffer val_buffer(const_cast<char*>(existing_value.data()), 0, existing_value.size());
+                    if (field_value.Decode(val_buffer, false) && field_value.IsHashFieldExpired(get_current_epoch_millis()))
+                    {
+                        return true;
+                    }
+                    return !g_db->IsLoadingData() && !IsObjectAlive(k);
+                }
+                /*
+                 * elements whose meta is deleted or expired belong to no object any more(expired by this filter,
+                 * or deleted lazily), drop them here instead of deleting them one by one.
+                 * objects may be written element by element before their meta while loading data.
+                 */
+                else if (check_orphans && k.GetType() != KEY_STRING && !g_db->IsLoadingData() && !IsObjectAlive(k))
+                {
+                    return true;
+                }
                 return false;
             }
     };
@@ -424,22 +1220,72 @@ OP_NAMESPACE_BEGIN
             }
     };
 
-    class MergeOperator: public rocksdb::MergeOperator
+    /*
+     * Background compactions are spikes of the latency monitor's 'compaction' event like manual ones.
+     */
+    struct RocksDBLatencyListener: public rocksdb::EventListener
+    {
+            void OnCompactionCompleted(rocksdb::DB* db, const rocksdb::CompactionJobInfo& ci)
+            {
+                LatencyMonitor::GetSingleton().AddSampleIfNeeded("compaction", ci.stats.elapsed_micros / 1000);
+            }
+    };
+
+    /*
+     * Flushes & compactions charge the background io budget shared with snapshots, ingestion, lazyfree & migration,
+     * flushes never wait so writes are not stalled behind a full memtable.
+     */
+    class RocksDBRateLimiter: public rocksdb::RateLimiter
     {
         private:
-            RocksDBEngine* m_engine;
+            volatile int64_t m_bytes[rocksdb::Env::IO_TOTAL];
+            volatile int64_t m_requests[rocksdb::Env::IO_TOTAL];
         public:
-            MergeOperator(RocksDBEngine* engine) :
-                    m_engine(engine)
+            RocksDBRateLimiter()
             {
+                memset((void*) m_bytes, 0, sizeof(m_bytes));
+                memset((void*) m_requests, 0, sizeof(m_requests));
             }
-            // Gives the client a way to express the read -> modify -> write semantics
-            // key:      (IN)    The key that's associated with this merge operation.
-            //                   Client could multiplex the merge operator based on it
-            //                   if the key space is partitioned and different subspaces
-            //                   refer to different types of data which have different
-            //                   merge operation semantics
-            // existing: (IN)    null indicates that the key does not exist before this op
+            void SetBytesPerSecond(int64_t bytes_per_second)
+            {
+                BackgroundJobs::GetSingleton().SetMaxBytesPerSec(bytes_per_second);
+            }
+            void Request(const int64_t bytes, const rocksdb::Env::IOPriority pri)
+            {
+                atomic_add_uint64((volatile uint64_t*) &m_bytes[pri], bytes);
+                atomic_add_uint64((volatile uint64_t*) &m_requests[pri], 1);
+                BackgroundJobs::GetSingleton().Request(bytes, pri == rocksdb::Env::IO_HIGH);
+            }
+            int64_t GetSingleBurstBytes() const
+            {
+                return 1024 * 1024;
+            }
+            int64_t GetTotalBytesThrough(const rocksdb::Env::IOPriority pri) const
+            {
+                return pri == rocksdb::Env::IO_TOTAL ? m_bytes[rocksdb::Env::IO_LOW] + m_bytes[rocksdb::Env::IO_HIGH] : m_bytes[pri];
+            }
+            int64_t GetTotalRequests(const rocksdb::Env::IOPriority pri) const
+            {
+                return pri == rocksdb::Env::IO_TOTAL ? m_requests[rocksdb::Env::IO_LOW] + m_requests[rocksdb::Env::IO_HIGH] : m_requests[pri];
+            }
+    };
+
+    class MergeOperator: public rocksdb::MergeOperator
+    {
+        private:
+            RocksDBEngine* m_engine;
+        public:
+            MergeOperator(RocksDBEngine* engine) :
+                    m_engine(engine)
+            {
+            }
+            // Gives the client a way to express the read -> modify -> write semantics
+            // key:      (IN)    The key that's associated with this merge operation.
+            //                   Client could multiplex the merge operator based on it
+            //                   if the key space is partitioned and different subspaces
+            //                   refer to different types of data which have different
+            //                   merge operation semantics
+            // existing: (IN)    null indicates that the key does not exist before this op
             // operand_list:(IN) the sequence of merge operations to apply, front() first.
             // new_value:(OUT)   Client is responsible for filling the merge result here.
             // The string that new_value is pointing to will be empty.
@@ -460,6 +1306,14 @@ OP_NAMESPACE_BEGIN
 
                 //INFO_LOG("Do merge for key:%s in thread %d", key_obj.GetKey().AsString().c_str(), pthread_self());
 
+                /*
+                 * merges reaching a value moved to its blob are the SETNX like ones, which keep an existing value
+                 */
+                if (NULL != existing_value && is_blob_ref(*existing_value))
+                {
+                    new_value->assign(existing_value->data(), existing_value->size());
+                    return true;
+                }
                 ValueObject val_obj;
                 if (NULL != existing_value)
                 {
@@ -623,214 +1477,1149 @@ OP_NAMESPACE_BEGIN
             }
     };
 
-    RocksDBEngine::RocksDBEngine() :
-            m_db(NULL)
+    /*
+     * Column families of one namespace in the per type layout, the meta one is named as the namespace.
+     * CF_BLOB is not one of them, it holds the large values of a namespace in either layout and is created
+     * by the first one written(rocksdb-blob-min-size).
+     */
+    enum ColumnFamilyKind
+    {
+        CF_META = 0, CF_HASH_FIELD = 1, CF_ZSET_SORT = 2, CF_ELEMENT = 3, CF_KIND_MAX = 4, CF_BLOB = CF_KIND_MAX
+    };
+
+    /*
+     * Suffixes of the column family names for the kinds in the per type layout & the blob one, indexed by ColumnFamilyKind.
+     */
+    static const char* g_cf_kind_suffixes[] = { "", "@hash_field", "@zset_sort", "@element", "@blob" };
+
+    static const char* kColumnFamilyAliasesFile = "cf_aliases";
+
+    /*
+     * Writes a meta value into 'batch', a large one goes to the blob column family with a reference left in its
+     * place, a small one replaces the blob written before if any. Returns true if the value went to the blob.
+     */
+    static bool put_meta_value(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* cf, rocksdb::ColumnFamilyHandle* blob_cf,
+            const rocksdb::Slice& key, const rocksdb::Slice& value, int64 blob_min_size)
     {
+        if ((int64) value.size() >= blob_min_size)
+        {
+            char ref = (char) ROCKS_BLOB_REF_TYPE;
+            batch.Put(blob_cf, key, value);
+            batch.Put(cf, key, rocksdb::Slice(&ref, 1));
+            return true;
+        }
+        batch.Put(cf, key, value);
+        batch.Delete(blob_cf, key);
+        return false;
     }
 
-    RocksDBEngine::~RocksDBEngine()
+    /*
+     * The blob column family's garbage collection, a blob whose reference was deleted, replaced by a small value
+     * or dropped by the meta column family's own filter is dropped when compacted.
+     */
+    class RocksDBBlobCompactionFilter: public rocksdb::CompactionFilter
     {
-        Close();
+        private:
+            RocksDBEngine* engine;
+            Data ns;
+        public:
+            RocksDBBlobCompactionFilter(RocksDBEngine* e, const rocksdb::CompactionFilter::Context& context) :
+                    engine(e)
+            {
+                ns = engine->GetNamespaceByColumnFamilyId(context.column_family_id);
+            }
+            const char* Name() const
+            {
+                return "ardb.blob_filter";
+            }
+            bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value, bool* value_changed) const
+            {
+                if (ns.IsNil())
+                {
+                    return false;
+                }
+                ardb::Context ctx;
+                RocksDBEngine::ColumnFamilyHandlePtr cfp = engine->GetColumnFamilyHandle(ctx, ns, CF_META, false);
+                if (NULL == cfp.get())
+                {
+                    return false;
+                }
+                std::string ref;
+                rocksdb::Status s = engine->m_db->Get(rocksdb::ReadOptions(), cfp.get(), key, &ref);
+                if (s.IsNotFound() || (s.ok() && !is_blob_ref(ref)))
+                {
+                    atomic_add_uint64(&engine->m_blob_gc_drops, 1);
+                    return true;
+                }
+                return false;
+            }
+    };
+
+    struct RocksDBBlobFilterFactory: public rocksdb::CompactionFilterFactory
+    {
+            RocksDBEngine* engine;
+            RocksDBBlobFilterFactory(RocksDBEngine* e) :
+                    engine(e)
+            {
+            }
+            std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(const rocksdb::CompactionFilter::Context& context)
+            {
+                return std::unique_ptr < rocksdb::CompactionFilter > (new RocksDBBlobCompactionFilter(engine, context));
+            }
+            const char* Name() const
+            {
+                return "ardb.blob_filter_factory";
+            }
+    };
+
+    static const Data& column_family_name(const Data& ns, int kind, Data& name)
+    {
+        std::string str;
+        ns.ToString(str);
+        str.append(g_cf_kind_suffixes[kind]);
+        name.SetString(str, false);
+        return name;
     }
 
-    RocksDBEngine::ColumnFamilyHandlePtr RocksDBEngine::GetColumnFamilyHandle(Context& ctx, const Data& ns, bool create_if_noexist)
+    /*
+     * Kind of the column family by its name, the namespace part is stored into 'ns' if not NULL
+     */
+    static int column_family_kind(const std::string& name, std::string* ns)
     {
-        RWLockGuard<SpinRWLock> guard(m_lock, !ctx.flags.create_if_notexist);
-        ColumnFamilyHandleTable::iterator found = m_handlers.find(ns);
-        if (found != m_handlers.end())
+        for (int kind = CF_BLOB; kind > 0; kind--)
         {
-            return found->second;
+            size_t suffix_len = strlen(g_cf_kind_suffixes[kind]);
+            if (name.size() > suffix_len && !name.compare(name.size() - suffix_len, suffix_len, g_cf_kind_suffixes[kind]))
+            {
+                if (NULL != ns)
+                {
+                    ns->assign(name.data(), name.size() - suffix_len);
+                }
+                return kind;
+            }
         }
-        if (!create_if_noexist)
+        if (NULL != ns)
         {
-            return NULL;
+            *ns = name;
         }
-        rocksdb::ColumnFamilyOptions cf_options(m_options);
-        std::string name;
-        ns.ToString(name);
-        rocksdb::ColumnFamilyHandle* cfh = NULL;
-        rocksdb::Status s = m_db->CreateColumnFamily(cf_options, name, &cfh);
-        if (s.ok())
+        return 0;
+    }
+
+    static uint8 decode_key_type(const rocksdb::Slice& key)
+    {
+        Buffer buffer(const_cast<char*>(key.data()), 0, key.size());
+        KeyObject k;
+        if (!k.DecodePrefix(buffer, false))
         {
-            m_handlers[ns].reset(cfh);
-            INFO_LOG("Create ColumnFamilyHandle with name:%s success.", name.c_str());
-            return m_handlers[ns];
+            return KEY_UNKNOWN;
         }
-        ERROR_LOG("Failed to create column family:%s for reason:%s", name.c_str(), s.ToString().c_str());
-        return NULL;
+        return k.GetType();
     }
 
-    void RocksDBEngine::Close()
+#define ROCKS_PROP_MAX_EXPIRE "ardb.max_expire"
+#define ROCKS_PROP_ALL_EXPIRE "ardb.all_expire"
+    /*
+     * Records the latest expiry of the keys of a table of a ttl namespace, and whether all of them expire. Deletes
+     * do not count, DropExpiredTables only deletes the oldest tables where they shadow nothing.
+     */
+    class RocksDBExpireCollector: public rocksdb::TablePropertiesCollector
     {
-        RWLockGuard<SpinRWLock> guard(m_lock, true);
-        m_handlers.clear(); //handlers MUST be deleted before m_db
-        DELETE(m_db);
-    }
+        private:
+            uint64 max_expire;
+            bool all_expire;
+        public:
+            RocksDBExpireCollector() :
+                    max_expire(0), all_expire(true)
+            {
+            }
+            rocksdb::Status AddUserKey(const rocksdb::Slice& key, const rocksdb::Slice& value, rocksdb::EntryType type, rocksdb::SequenceNumber seq,
+                    uint64_t file_size)
+            {
+                if (!all_expire || type == rocksdb::kEntryDelete || type == rocksdb::kEntrySingleDelete)
+                {
+                    return rocksdb::Status::OK();
+                }
+                if (type != rocksdb::kEntryPut || decode_key_type(key) != KEY_META || is_blob_ref(value))
+                {
+                    all_expire = false;
+                    return rocksdb::Status::OK();
+                }
+                ValueObject meta;
+                Buffer buffer(const_cast<char*>(value.data()), 0, value.size());
+                if (!meta.DecodeMeta(buffer) || meta.GetMergeOp() != 0 || meta.GetTTL() <= 0)
+                {
+                    all_expire = false;
+                    return rocksdb::Status::OK();
+                }
+                if ((uint64) meta.GetTTL() > max_expire)
+                {
+                    max_expire = (uint64) meta.GetTTL();
+                }
+                return rocksdb::Status::OK();
+            }
+            rocksdb::Status Finish(rocksdb::UserCollectedProperties* properties)
+            {
+                *properties = GetReadableProperties();
+                return rocksdb::Status::OK();
+            }
+            rocksdb::UserCollectedProperties GetReadableProperties() const
+            {
+                rocksdb::UserCollectedProperties properties;
+                properties[ROCKS_PROP_MAX_EXPIRE] = stringfromll(max_expire);
+                properties[ROCKS_PROP_ALL_EXPIRE] = all_expire ? "1" : "0";
+                return properties;
+            }
+            const char* Name() const
+            {
+                return "ardb.expire_collector";
+            }
+    };
 
-    int RocksDBEngine::ReOpen(rocksdb::Options& options)
+    struct RocksDBExpireCollectorFactory: public rocksdb::TablePropertiesCollectorFactory
     {
-        Close();
-        RWLockGuard<SpinRWLock> guard(m_lock, true);
-        std::vector<std::string> column_families;
-        rocksdb::Status s = rocksdb::DB::ListColumnFamilies(options, m_dbdir, &column_families);
-        if (column_families.empty())
-        {
-            s = rocksdb::DB::Open(options, m_dbdir, &m_db);
-        }
-        else
-        {
-            std::vector<rocksdb::ColumnFamilyDescriptor> column_families_descs(column_families.size());
-            for (size_t i = 0; i < column_families.size(); i++)
+            rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(rocksdb::TablePropertiesCollectorFactory::Context context)
             {
-                column_families_descs[i] = rocksdb::ColumnFamilyDescriptor(column_families[i], rocksdb::ColumnFamilyOptions(m_options));
+                return new RocksDBExpireCollector;
             }
-            std::vector<rocksdb::ColumnFamilyHandle*> handlers;
-            s = rocksdb::DB::Open(options, m_dbdir, column_families_descs, &handlers, &m_db);
-            if (s.ok())
+            const char* Name() const
             {
-                for (size_t i = 0; i < handlers.size(); i++)
+                return "ardb.expire_collector_factory";
+            }
+    };
+
+    /*
+     * Block cache hits & block reads of the reads in the scope are added to the namespace, taken from
+     * the thread local perf context. Only with rocksdb-statistics.
+     */
+    struct RocksDBCacheStatsScope
+    {
+            RocksDBEngine* engine;
+            const Data& ns;
+            bool enable;
+            uint64_t hits;
+            uint64_t reads;
+            RocksDBCacheStatsScope(RocksDBEngine* e, const Data& n) :
+                    engine(e), ns(n), enable(NULL != e->m_options.statistics.get()), hits(0), reads(0)
+            {
+                if (enable)
                 {
-                    rocksdb::ColumnFamilyHandle* handler = handlers[i];
-                    Data ns;
-                    ns.SetString(column_families_descs[i].name, false);
-                    m_handlers[ns].reset(handler);
-                    INFO_LOG("RocksDB open column family:%s success.", column_families_descs[i].name.c_str());
+                    if (rocksdb::GetPerfLevel() == rocksdb::kDisable)
+                    {
+                        rocksdb::SetPerfLevel(rocksdb::kEnableCount);
+                    }
+                    hits = rocksdb::perf_context.block_cache_hit_count;
+                    reads = rocksdb::perf_context.block_read_count;
                 }
             }
-        }
+            ~RocksDBCacheStatsScope()
+            {
+                if (enable)
+                {
+                    uint64_t new_hits = rocksdb::perf_context.block_cache_hit_count - hits;
+                    uint64_t new_reads = rocksdb::perf_context.block_read_count - reads;
+                    if (new_hits > 0 || new_reads > 0)
+                    {
+                        engine->AddCacheStats(ns, new_hits, new_reads);
+                    }
+                }
+            }
+    };
 
-        if (s != rocksdb::Status::OK())
+    RocksDBEngine::RocksDBEngine() :
+            m_db(NULL), m_tombstone_runs(0), m_tombstone_compactions(0), m_memtable_usage(0), m_memtable_check_time(0), m_write_stalls(0), m_write_stall_millis(0), m_stall_check_time(0), m_stall_start_time(
+                    0), m_stall_conditions(0), m_stall_condition_millis(0), m_group_commit(NULL), m_ingest(
+                    NULL), m_ingest_load(false), m_sync_wal(false), m_read_only(false), m_shared_snapshots(0), m_cf_per_type(false), m_blob_min_size(0), m_blob_writes(
+                    0), m_blob_reads(0), m_blob_gc_drops(0), m_expired_table_drops(0), m_expired_table_bytes(0)
+    {
+    }
+
+    RocksDBEngine::~RocksDBEngine()
+    {
+        DELETE(m_ingest);
+        Close();
+        DELETE(m_group_commit);
+        CacheStatsTable::iterator it = m_cache_stats.begin();
+        while (it != m_cache_stats.end())
         {
-            ERROR_LOG("Failed to open db:%s by reason:%s", m_dbdir.c_str(), s.ToString().c_str());
-            return -1;
+            DELETE(it->second);
+            it++;
         }
-        return 0;
     }
 
-    int RocksDBEngine::Init(const std::string& dir, const std::string& conf)
+    /*
+     * Writers wait while all memtables(unflushed immutable ones included) take more than 'rocksdb-memtable-hard-limit',
+     * the usage is sampled at most once per 10ms out of a stall.
+     */
+    void RocksDBEngine::WaitMemtableLimit()
     {
-        static RocksDBComparator comparator;
-        rocksdb::Status s = rocksdb::GetOptionsFromString(m_options, conf, &m_options);
-
-        m_options.comparator = &comparator;
-        m_options.merge_operator.reset(new MergeOperator(this));
-        m_options.prefix_extractor.reset(new RocksDBPrefixExtractor);
-        m_options.compaction_filter_factory.reset(new RocksDBCompactionFilterFactory(this, m_options.num_levels));
-        m_options.info_log.reset(new RocksDBLogger);
-
-        m_options.create_if_missing = true;
-        if (DEBUG_ENABLED())
+        int64 limit = g_db->GetConf().rocksdb_memtable_hard_limit;
+        if (limit <= 0 || NULL == m_db)
         {
-            m_options.info_log_level = rocksdb::DEBUG_LEVEL;
+            return;
         }
-        else
+        uint64 now = get_current_epoch_millis();
+        if (now >= m_memtable_check_time + 10)
         {
-            m_options.info_log_level = rocksdb::INFO_LEVEL;
+            m_memtable_check_time = now;
+            uint64_t usage = 0;
+            m_db->GetAggregatedIntProperty(rocksdb::DB::Properties::kSizeAllMemTables, &usage);
+            m_memtable_usage = usage;
         }
-
-        if (!s.ok())
+        if (m_memtable_usage <= (uint64) limit)
         {
-            ERROR_LOG("Invalid rocksdb's options:%s with error reason:%s", conf.c_str(), s.ToString().c_str());
-            return -1;
+            return;
         }
-        //Commented by Ilya Peresadin
-        //m_options.OptimizeLevelStyleCompaction();
-        m_options.IncreaseParallelism();
-        m_options.stats_dump_period_sec = (unsigned int) g_db->GetConf().statistics_log_period;
-        m_dbdir = dir;
-        return ReOpen(m_options);
-    }
-
-    int RocksDBEngine::Repair(const std::string& dir)
-    {
-        static RocksDBComparator comparator;
-        m_options.comparator = &comparator;
-        m_options.merge_operator.reset(new MergeOperator(this));
-        m_options.prefix_extractor.reset(new RocksDBPrefixExtractor);
-        m_options.compaction_filter_factory.reset(new RocksDBCompactionFilterFactory(this, m_options.num_levels));
-        m_options.info_log.reset(new RocksDBLogger);
-        m_options.info_log_level = rocksdb::INFO_LEVEL;
-        return rocksdb_err(rocksdb::RepairDB(dir, m_options));
+        bool flushed = false;
+        while (true)
+        {
+            uint64_t usage = 0;
+            m_db->GetAggregatedIntProperty(rocksdb::DB::Properties::kSizeAllMemTables, &usage);
+            m_memtable_usage = usage;
+            if (usage <= (uint64) limit)
+            {
+                break;
+            }
+            if (!flushed)
+            {
+                FlushLargestMemtable();
+                flushed = true;
+            }
+            usleep(1000);
+        }
+        atomic_add_uint64(&m_write_stalls, 1);
+        atomic_add_uint64(&m_write_stall_millis, get_current_epoch_millis() - now);
+        LatencyMonitor::GetSingleton().AddSampleIfNeeded("rocksdb-write-stall", get_current_epoch_millis() - now);
     }
 
-    Data RocksDBEngine::GetNamespaceByColumnFamilyId(uint32 id)
+    /*
+     * The listener api of this rocksdb has no stall notifications, so the conditions rocksdb delays or stops writes
+     * on are checked instead: level 0 files over the slowdown trigger, pending compaction bytes over the hard limit,
+     * all write buffers but one waiting for flush, and the memtable hard limit of WaitMemtableLimit.
+     */
+    bool RocksDBEngine::CheckStallConditions()
     {
-        Data ns;
+        int64 limit = g_db->GetConf().rocksdb_memtable_hard_limit;
+        if (limit > 0 && m_memtable_usage > (uint64) limit)
+        {
+            return true;
+        }
+        std::string level0 = rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0";
         RWLockGuard<SpinRWLock> guard(m_lock, true);
         ColumnFamilyHandleTable::iterator it = m_handlers.begin();
         while (it != m_handlers.end())
         {
-            if (it->second->GetID() == id)
+            rocksdb::ColumnFamilyHandle* cf = it->second.get();
+            std::string files;
+            uint64_t value = 0;
+            if (m_options.level0_slowdown_writes_trigger > 0 && m_db->GetProperty(cf, level0, &files)
+                    && strtoll(files.c_str(), NULL, 10) >= m_options.level0_slowdown_writes_trigger)
             {
-                ns.SetString(it->second->GetName(), false);
-                return ns;
+                return true;
+            }
+            if (m_options.hard_pending_compaction_bytes_limit > 0 && m_db->GetIntProperty(cf, rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &value)
+                    && value >= m_options.hard_pending_compaction_bytes_limit)
+            {
+                return true;
+            }
+            if (m_options.max_write_buffer_number > 1 && m_db->GetIntProperty(cf, rocksdb::DB::Properties::kNumImmutableMemTable, &value)
+                    && value >= (uint64_t) m_options.max_write_buffer_number - 1)
+            {
+                return true;
             }
             it++;
         }
-        return ns;
+        return false;
     }
 
-    int RocksDBEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
+    bool RocksDBEngine::IsWriteStalled()
     {
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, ns, ctx.flags.create_if_notexist);
-        rocksdb::ColumnFamilyHandle* cf = cfp.get();
-        if (NULL == cf)
+        uint64 now = get_current_epoch_millis();
+        uint64 last_check = m_stall_check_time;
+        if (NULL == m_db || now < last_check + 10 || !atomic_cmp_set_uint64(&m_stall_check_time, last_check, now))
         {
-            return ERR_ENTRY_NOT_EXIST;
+            return m_stall_start_time > 0;
         }
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
-        rocksdb::WriteOptions opt;
-        if (ctx.flags.bulk_loading)
+        bool stalled = CheckStallConditions();
+        if (stalled && 0 == m_stall_start_time)
         {
-            opt.disableWAL = true;
+            m_stall_start_time = now;
+            atomic_add_uint64(&m_stall_conditions, 1);
+            INFO_LOG("RocksDB write stall conditions begin.");
         }
-        rocksdb::Slice key_slice = to_rocksdb_slice(key);
-        rocksdb::Slice value_slice = to_rocksdb_slice(value);
-        rocksdb::Status s;
-        rocksdb::WriteBatch* batch = rocks_ctx.transc.Ref();
-        if (NULL != batch)
+        else if (!stalled && m_stall_start_time > 0)
         {
-            batch->Put(cf, key_slice, value_slice);
+            uint64 millis = now - m_stall_start_time;
+            atomic_add_uint64(&m_stall_condition_millis, millis);
+            m_stall_start_time = 0;
+            INFO_LOG("RocksDB write stall conditions end after %llums.", millis);
+            LatencyMonitor::GetSingleton().AddSampleIfNeeded("rocksdb-stall-condition", millis);
         }
-        else
+        return stalled;
+    }
+
+    void RocksDBEngine::FlushLargestMemtable()
+    {
+        ColumnFamilyHandlePtr largest;
+        uint64_t largest_size = 0;
         {
-            s = m_db->Put(opt, cf, key_slice, value_slice);
+            RWLockGuard<SpinRWLock> guard(m_lock, false);
+            ColumnFamilyHandleTable::iterator it = m_handlers.begin();
+            while (it != m_handlers.end())
+            {
+                uint64_t size = 0;
+                m_db->GetIntProperty(it->second.get(), rocksdb::DB::Properties::kCurSizeAllMemTables, &size);
+                if (size > largest_size)
+                {
+                    largest_size = size;
+                    largest = it->second;
+                }
+                it++;
+            }
+        }
+        if (NULL != largest.get())
+        {
+            rocksdb::FlushOptions opt;
+            opt.wait = false;
+            m_db->Flush(opt, largest.get());
+            INFO_LOG("Flush memtable of column family:%s with size:%llu for memtable hard limit.", largest->GetName().c_str(), (unsigned long long) largest_size);
         }
-        return rocksdb_err(s);
     }
 
-    int RocksDBEngine::Put(Context& ctx, const KeyObject& key, const ValueObject& value)
+    void RocksDBEngine::AddCacheStats(const Data& ns, uint64_t hits, uint64_t reads)
     {
+        CacheStats* stats = NULL;
+        {
+            RWLockGuard<SpinRWLock> guard(m_cache_stats_lock, false);
+            CacheStatsTable::iterator found = m_cache_stats.find(ns);
+            if (found != m_cache_stats.end())
+            {
+                stats = found->second;
+            }
+        }
+        if (NULL == stats)
+        {
+            RWLockGuard<SpinRWLock> guard(m_cache_stats_lock, true);
+            CacheStats*& created = m_cache_stats[ns];
+            if (NULL == created)
+            {
+                NEW(created, CacheStats);
+            }
+            stats = created;
+        }
+        atomic_add_uint64(&stats->hits, hits);
+        atomic_add_uint64(&stats->reads, reads);
+    }
+
+    RocksDBEngine::ColumnFamilyHandlePtr RocksDBEngine::GetColumnFamilyHandle(Context& ctx, const Data& ns, bool create_if_noexist)
+    {
+        return GetColumnFamilyHandle(ctx, ns, CF_META, create_if_noexist);
+    }
+
+    RocksDBEngine::ColumnFamilyHandlePtr RocksDBEngine::GetColumnFamilyHandle(Context& ctx, const Data& ns, int kind, bool create_if_noexist)
+    {
+        Data kind_name;
+        const Data& cf_name = CF_META == kind ? ns : column_family_name(ns, kind, kind_name);
+        RWLockGuard<SpinRWLock> guard(m_lock, !ctx.flags.create_if_notexist);
+        ColumnFamilyHandleTable::iterator found = m_handlers.find(cf_name);
+        if (found != m_handlers.end())
+        {
+            return found->second;
+        }
+        if (!create_if_noexist)
+        {
+            return NULL;
+        }
+        /*
+         * all column families of a namespace are created together, ReOpen tells the layout of the data dir by them
+         */
+        int kinds = m_cf_per_type ? CF_KIND_MAX : 1;
+        for (int i = 0; i < kinds; i++)
+        {
+            Data create_name;
+            column_family_name(ns, i, create_name);
+            if (m_handlers.count(create_name) > 0)
+            {
+                continue;
+            }
+            std::string name;
+            create_name.ToString(name);
+            rocksdb::ColumnFamilyHandle* cfh = NULL;
+            rocksdb::Status s = m_db->CreateColumnFamily(GetColumnFamilyOptions(name, true), name, &cfh);
+            if (!s.ok())
+            {
+                ERROR_LOG("Failed to create column family:%s for reason:%s", name.c_str(), s.ToString().c_str());
+                return NULL;
+            }
+            m_handlers[create_name].reset(cfh);
+            INFO_LOG("Create ColumnFamilyHandle with name:%s success.", name.c_str());
+        }
+        return m_handlers[cf_name];
+    }
+
+    void RocksDBEngine::GetColumnFamilyHandles(Context& ctx, const Data& ns, std::vector<ColumnFamilyHandlePtr>& cfs)
+    {
+        int kinds = m_cf_per_type ? CF_KIND_MAX : 1;
+        for (int kind = 0; kind < kinds; kind++)
+        {
+            ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, ns, kind, false);
+            if (NULL != cfp.get())
+            {
+                cfs.push_back(cfp);
+            }
+        }
+    }
+
+    bool RocksDBEngine::IsBlobNameSpace(const Data& ns)
+    {
+        if (m_blob_min_size <= 0)
+        {
+            return false;
+        }
+        std::string name = ns.AsString();
+        if (!m_blob_namespaces.empty())
+        {
+            return m_blob_namespaces.count(name) > 0;
+        }
+        return name != TTL_DB_NSMAESPACE && name != ZSET_STORE_NAMESPACE && name != LAZYFREE_DB_NAMESPACE && name != INDEX_DB_NAMESPACE;
+    }
+
+    RocksDBEngine::ColumnFamilyHandlePtr RocksDBEngine::GetBlobColumnFamily(Context& ctx, const Data& ns, bool create_if_noexist)
+    {
+        Data cf_name;
+        column_family_name(ns, CF_BLOB, cf_name);
+        {
+            RWLockGuard<SpinRWLock> guard(m_lock, true);
+            ColumnFamilyHandleTable::iterator found = m_handlers.find(cf_name);
+            if (found != m_handlers.end())
+            {
+                return found->second;
+            }
+        }
+        if (!create_if_noexist)
+        {
+            return NULL;
+        }
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        ColumnFamilyHandleTable::iterator found = m_handlers.find(cf_name);
+        if (found != m_handlers.end())
+        {
+            return found->second;
+        }
+        std::string name;
+        cf_name.ToString(name);
+        rocksdb::ColumnFamilyHandle* cfh = NULL;
+        rocksdb::Status s = m_db->CreateColumnFamily(GetColumnFamilyOptions(name, true), name, &cfh);
+        if (!s.ok())
+        {
+            ERROR_LOG("Failed to create column family:%s for reason:%s", name.c_str(), s.ToString().c_str());
+            return NULL;
+        }
+        m_handlers[cf_name].reset(cfh);
+        INFO_LOG("Create ColumnFamilyHandle with name:%s success.", name.c_str());
+        return m_handlers[cf_name];
+    }
+
+    int RocksDBEngine::GetColumnFamilyKind(uint8 key_type)
+    {
+        if (!m_cf_per_type)
+        {
+            return CF_META;
+        }
+        switch (key_type)
+        {
+            case KEY_META:
+            case KEY_STRING:
+            {
+                return CF_META;
+            }
+            case KEY_HASH_FIELD:
+            {
+                return CF_HASH_FIELD;
+            }
+            case KEY_ZSET_SORT:
+            {
+                return CF_ZSET_SORT;
+            }
+            default:
+            {
+                return CF_ELEMENT;
+            }
+        }
+    }
+
+    /*
+     * Options of column family 'cf_name', the meta one of a ttl namespace gets the compaction style of
+     * rocksdb-ttl-compaction-style if 'ttl_style'.
+     */
+    rocksdb::ColumnFamilyOptions RocksDBEngine::GetColumnFamilyOptions(const std::string& cf_name, bool ttl_style)
+    {
+        std::string ns;
+        int kind = column_family_kind(cf_name, &ns);
+        rocksdb::ColumnFamilyOptions cf_options(m_options);
+        if (CF_META == kind && m_ttl_namespaces.count(ns) > 0)
+        {
+            cf_options.table_properties_collector_factories.push_back(std::make_shared<RocksDBExpireCollectorFactory>());
+            if (ttl_style && g_db->GetConf().rocksdb_ttl_compaction_style == "fifo")
+            {
+                /*
+                 * tables are never merged, the oldest ones go when all their keys expired(or by size if limited)
+                 */
+                cf_options.compaction_style = rocksdb::kCompactionStyleFIFO;
+                cf_options.compaction_options_fifo.max_table_files_size =
+                        g_db->GetConf().rocksdb_ttl_fifo_max_size > 0 ? (uint64_t) g_db->GetConf().rocksdb_ttl_fifo_max_size : UINT64_MAX;
+            }
+            else if (ttl_style && g_db->GetConf().rocksdb_ttl_compaction_style == "universal")
+            {
+                cf_options.compaction_style = rocksdb::kCompactionStyleUniversal;
+            }
+        }
+        if (CF_BLOB == kind)
+        {
+            /*
+             * a blob is kept by compactions while its reference lives, it is rewritten far less often in the universal
+             * style than in the leveled one, and only read by whole key after its reference was found.
+             */
+            cf_options.compaction_filter_factory.reset(new RocksDBBlobFilterFactory(this));
+            if (g_db->GetConf().rocksdb_blob_universal_compaction)
+            {
+                cf_options.compaction_style = rocksdb::kCompactionStyleUniversal;
+            }
+            cf_options.memtable_prefix_bloom_bits = 0;
+        }
+        if (NULL == m_options.table_factory.get() || strcmp(m_options.table_factory->Name(), "BlockBasedTable") || NULL == m_options.table_factory->GetOptions())
+        {
+            return cf_options;
+        }
+        rocksdb::BlockBasedTableOptions table_options = *((rocksdb::BlockBasedTableOptions*) m_options.table_factory->GetOptions());
+        if (CF_BLOB == kind)
+        {
+            if (g_db->GetConf().rocksdb_bloom_bits_per_key > 0)
+            {
+                table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy((int) g_db->GetConf().rocksdb_bloom_bits_per_key, false));
+                table_options.whole_key_filtering = true;
+            }
+            cf_options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+            return cf_options;
+        }
+        /*
+         * a full filter holds the whole keys and their prefixes(key part by RocksDBPrefixExtractor),
+         * meta lookups & member checks(HEXISTS/SISMEMBER) test the whole key, seeks into an object test the prefix.
+         * A filter set by rocksdb.options is kept in the per namespace layout.
+         */
+        int64 bloom_bits = g_db->GetConf().rocksdb_bloom_bits_per_key;
+        if (bloom_bits > 0 && (m_cf_per_type || NULL == table_options.filter_policy.get()))
+        {
+            table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy((int) bloom_bits, false));
+            table_options.whole_key_filtering = true;
+        }
+        switch (m_cf_per_type ? kind : CF_ELEMENT)
+        {
+            case CF_META:
+            {
+                /*
+                 * every command looks up meta by whole key, a scan over elements should not evict them from cache
+                 */
+                if (NULL != m_meta_cache.get())
+                {
+                    table_options.block_cache = m_meta_cache;
+                }
+                break;
+            }
+            case CF_ZSET_SORT:
+            {
+                /*
+                 * only range scanned by score, blooms would never be checked
+                 */
+                table_options.filter_policy.reset();
+                table_options.whole_key_filtering = false;
+                cf_options.memtable_prefix_bloom_bits = 0;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+        cf_options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+        return cf_options;
+    }
+
+    void RocksDBEngine::Close()
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, true);
+        m_handlers.clear(); //handlers MUST be deleted before m_db
+        {
+            LockGuard<SpinMutexLock> detached_guard(m_detached_lock);
+            m_detached_handlers.clear();
+        }
+        DELETE(m_db);
+    }
+
+    int RocksDBEngine::ReOpen(rocksdb::Options& options)
+    {
+        Close();
+        RWLockGuard<SpinRWLock> guard(m_lock, true);
+        std::vector<std::string> column_families;
+        rocksdb::Status s = rocksdb::DB::ListColumnFamilies(options, m_dbdir, &column_families);
+        /*
+         * a column family swapped in place of a namespace is opened by the name it serves
+         */
+        LoadColumnFamilyAliases();
+        std::vector<std::string> names(column_families.size());
+        StringTreeSet alias_names;
+        for (size_t i = 0; i < column_families.size(); i++)
+        {
+            StringStringMap::iterator found = m_cf_aliases.find(column_families[i]);
+            names[i] = found != m_cf_aliases.end() ? found->second : column_families[i];
+            if (found != m_cf_aliases.end())
+            {
+                alias_names.insert(found->second);
+            }
+        }
+        /*
+         * the layout is fixed when the data dir is created, existing column families tell which one it has
+         */
+        bool has_kind_cf = false, has_ns_cf = false;
+        for (size_t i = 0; i < column_families.size(); i++)
+        {
+            if (column_families[i] == rocksdb::kDefaultColumnFamilyName)
+            {
+                continue;
+            }
+            int kind = column_family_kind(names[i], NULL);
+            if (kind == CF_META)
+            {
+                has_ns_cf = true;
+            }
+            else if (kind != CF_BLOB)
+            {
+                has_kind_cf = true;
+            }
+        }
+        bool cf_per_type = has_kind_cf || (!has_ns_cf && g_db->GetConf().rocksdb_cf_per_type);
+        if (cf_per_type != g_db->GetConf().rocksdb_cf_per_type)
+        {
+            WARN_LOG("RocksDB data dir:%s keeps the %s column family layout it was created with.", m_dbdir.c_str(), cf_per_type ? "per type" : "per namespace");
+        }
+        m_cf_per_type = cf_per_type;
+        if (column_families.empty())
+        {
+            if (m_read_only)
+            {
+                s = rocksdb::DB::OpenForReadOnly(options, m_dbdir, &m_db);
+            }
+            else
+            {
+                s = rocksdb::DB::Open(options, m_dbdir, &m_db);
+            }
+            m_cf_aliases.clear();
+        }
+        else
+        {
+            std::vector<rocksdb::ColumnFamilyDescriptor> column_families_descs(column_families.size());
+            for (size_t i = 0; i < column_families.size(); i++)
+            {
+                column_families_descs[i] = rocksdb::ColumnFamilyDescriptor(column_families[i], GetColumnFamilyOptions(names[i], true));
+            }
+            std::vector<rocksdb::ColumnFamilyHandle*> handlers;
+            if (m_read_only)
+            {
+                /*
+                 * the files & WAL of the owning instance are read as they are at this point, Refresh reopens them
+                 */
+                s = rocksdb::DB::OpenForReadOnly(options, m_dbdir, column_families_descs, &handlers, &m_db);
+            }
+            else
+            {
+                s = rocksdb::DB::Open(options, m_dbdir, column_families_descs, &handlers, &m_db);
+            }
+            if (!s.ok() && !m_read_only && !m_ttl_namespaces.empty())
+            {
+                /*
+                 * the files of a ttl namespace created before its compaction style was set may not fit it(fifo keeps one level)
+                 */
+                WARN_LOG("Failed to open db:%s with the ttl compaction style for reason:%s, open it with the default style.", m_dbdir.c_str(),
+                        s.ToString().c_str());
+                for (size_t i = 0; i < column_families.size(); i++)
+                {
+                    column_families_descs[i] = rocksdb::ColumnFamilyDescriptor(column_families[i], GetColumnFamilyOptions(names[i], false));
+                }
+                s = rocksdb::DB::Open(options, m_dbdir, column_families_descs, &handlers, &m_db);
+            }
+            if (s.ok())
+            {
+                StringStringMap aliases;
+                for (size_t i = 0; i < handlers.size(); i++)
+                {
+                    rocksdb::ColumnFamilyHandle* handler = handlers[i];
+                    if (names[i] == column_families[i] && alias_names.count(names[i]) > 0)
+                    {
+                        /*
+                         * the column family replaced by a swap interrupted before it was dropped
+                         */
+                        if (!m_read_only)
+                        {
+                            WARN_LOG("RocksDB drop column family:%s replaced by a swapped one.", names[i].c_str());
+                            m_db->DropColumnFamily(handler);
+                        }
+                        delete handler;
+                        continue;
+                    }
+                    if (names[i] != column_families[i])
+                    {
+                        aliases[column_families[i]] = names[i];
+                    }
+                    Data ns;
+                    ns.SetString(names[i], false);
+                    m_handlers[ns].reset(handler);
+                    INFO_LOG("RocksDB open column family:%s success.", names[i].c_str());
+                }
+                if (aliases.size() != m_cf_aliases.size() && !m_read_only)
+                {
+                    SaveColumnFamilyAliases(m_dbdir, aliases);
+                }
+                m_cf_aliases = aliases;
+            }
+        }
+
+        if (s != rocksdb::Status::OK())
+        {
+            ERROR_LOG("Failed to open db:%s by reason:%s", m_dbdir.c_str(), s.ToString().c_str());
+            return -1;
+        }
+        return 0;
+    }
+
+    int RocksDBEngine::Init(const std::string& dir, const std::string& conf)
+    {
+        static RocksDBComparator comparator;
+        rocksdb::Status s = rocksdb::GetOptionsFromString(m_options, conf, &m_options);
+
+        m_options.comparator = is_ordered_key_codec(get_key_codec_version()) ? rocksdb::BytewiseComparator() : &comparator;
+        m_options.merge_operator.reset(new MergeOperator(this));
+        m_options.prefix_extractor.reset(new RocksDBPrefixExtractor);
+        m_options.compaction_filter_factory.reset(new RocksDBCompactionFilterFactory(this, m_options.num_levels));
+        m_options.info_log.reset(new RocksDBLogger);
+        /*
+         * column families get table factories of their own by GetColumnFamilyOptions, all of them share the caches set here,
+         * instead of a default cache per table factory
+         */
+        if (NULL != m_options.table_factory.get() && !strcmp(m_options.table_factory->Name(), "BlockBasedTable") && NULL != m_options.table_factory->GetOptions())
+        {
+            rocksdb::BlockBasedTableOptions* table_options = (rocksdb::BlockBasedTableOptions*) m_options.table_factory->GetOptions();
+            if (!table_options->no_block_cache && NULL == table_options->block_cache.get())
+            {
+                table_options->block_cache = rocksdb::NewLRUCache(8 * 1024 * 1024);
+            }
+            if (g_db->GetConf().rocksdb_compressed_block_cache_size > 0 && NULL == table_options->block_cache_compressed.get())
+            {
+                table_options->block_cache_compressed = rocksdb::NewLRUCache((size_t) g_db->GetConf().rocksdb_compressed_block_cache_size);
+            }
+            m_block_cache = table_options->block_cache;
+            m_compressed_cache = table_options->block_cache_compressed;
+        }
+
+        if (g_db->GetConf().rocksdb_memtable_total_size > 0)
+        {
+            m_options.db_write_buffer_size = (size_t) g_db->GetConf().rocksdb_memtable_total_size;
+        }
+
+        m_options.create_if_missing = true;
+        if (DEBUG_ENABLED())
+        {
+            m_options.info_log_level = rocksdb::DEBUG_LEVEL;
+        }
+        else
+        {
+            m_options.info_log_level = rocksdb::INFO_LEVEL;
+        }
+
+        if (!s.ok())
+        {
+            ERROR_LOG("Invalid rocksdb's options:%s with error reason:%s", conf.c_str(), s.ToString().c_str());
+            return -1;
+        }
+        //Commented by Ilya Peresadin
+        //m_options.OptimizeLevelStyleCompaction();
+        m_options.IncreaseParallelism();
+        m_options.stats_dump_period_sec = (unsigned int) g_db->GetConf().statistics_log_period;
+        if (m_options.listeners.empty())
+        {
+            m_options.listeners.push_back(std::make_shared<RocksDBLatencyListener>());
+        }
+        if (NULL == m_options.rate_limiter.get())
+        {
+            m_options.rate_limiter.reset(new RocksDBRateLimiter);
+        }
+        m_sync_wal = g_db->GetConf().rocksdb_sync_wal;
+        m_blob_min_size = g_db->GetConf().rocksdb_blob_min_size;
+        m_blob_namespaces = g_db->GetConf().rocksdb_blob_namespaces;
+        m_ttl_namespaces = g_db->GetConf().rocksdb_ttl_namespaces;
+        if (g_db->GetConf().rocksdb_statistics && NULL == m_options.statistics.get())
+        {
+            m_options.statistics = rocksdb::CreateDBStatistics();
+        }
+        if (g_db->GetConf().rocksdb_cf_per_type && g_db->GetConf().rocksdb_meta_block_cache_size > 0 && NULL == m_meta_cache.get())
+        {
+            m_meta_cache = rocksdb::NewLRUCache((size_t) g_db->GetConf().rocksdb_meta_block_cache_size);
+        }
+        if (g_db->GetConf().rocksdb_group_commit && NULL == m_group_commit)
+        {
+            NEW(m_group_commit, RocksGroupCommit);
+        }
+        m_dbdir = dir;
+        m_read_only = !g_db->GetConf().rocksdb_read_replica_of.empty();
+        if (m_read_only)
+        {
+            return ReOpen(m_options);
+        }
+        if (g_db->GetConf().rocksdb_delete_mb_per_sec > 0 && NULL == m_options.delete_scheduler.get())
+        {
+            rocksdb::Status ds;
+            m_options.delete_scheduler.reset(
+                    rocksdb::NewDeleteScheduler(m_options.env, m_dbdir + ".trash", g_db->GetConf().rocksdb_delete_mb_per_sec * 1024 * 1024,
+                            nullptr, true, &ds));
+            if (!ds.ok())
+            {
+                WARN_LOG("Failed to create rocksdb delete scheduler for reason:%s", ds.ToString().c_str());
+            }
+        }
+        if (NULL == m_ingest)
+        {
+            NEW(m_ingest, RocksBulkIngest(m_options, m_dbdir + ".ingest"));
+        }
+        return ReOpen(m_options);
+    }
+
+    int RocksDBEngine::Repair(const std::string& dir)
+    {
+        static RocksDBComparator comparator;
+        m_options.comparator = is_ordered_key_codec(get_key_codec_version()) ? rocksdb::BytewiseComparator() : &comparator;
+        m_options.merge_operator.reset(new MergeOperator(this));
+        m_options.prefix_extractor.reset(new RocksDBPrefixExtractor);
+        m_options.compaction_filter_factory.reset(new RocksDBCompactionFilterFactory(this, m_options.num_levels));
+        m_options.info_log.reset(new RocksDBLogger);
+        m_options.info_log_level = rocksdb::INFO_LEVEL;
+        return rocksdb_err(rocksdb::RepairDB(dir, m_options));
+    }
+
+    Data RocksDBEngine::GetNamespaceByColumnFamilyId(uint32 id)
+    {
+        Data ns;
+        RWLockGuard<SpinRWLock> guard(m_lock, true);
+        ColumnFamilyHandleTable::iterator it = m_handlers.begin();
+        while (it != m_handlers.end())
+        {
+            if (it->second->GetID() == id)
+            {
+                std::string name;
+                column_family_kind(it->first.AsString(), &name);
+                ns.SetString(name, false);
+                return ns;
+            }
+            it++;
+        }
+        return ns;
+    }
+
+    std::string RocksDBEngine::ColumnFamilyName(rocksdb::ColumnFamilyHandle* cf)
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, true);
+        StringStringMap::iterator found = m_cf_aliases.find(cf->GetName());
+        return found != m_cf_aliases.end() ? found->second : cf->GetName();
+    }
+
+    /*
+     * One '<column family>\t<name it serves>' line per alias
+     */
+    void RocksDBEngine::LoadColumnFamilyAliases()
+    {
+        m_cf_aliases.clear();
+        std::string content;
+        if (0 != file_read_full(m_dbdir + "/" + kColumnFamilyAliasesFile, content))
+        {
+            return;
+        }
+        std::vector<std::string> lines = split_string(content, "\n");
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            size_t sep = lines[i].find('\t');
+            if (sep != std::string::npos)
+            {
+                m_cf_aliases[lines[i].substr(0, sep)] = lines[i].substr(sep + 1);
+            }
+        }
+    }
+
+    int RocksDBEngine::SaveColumnFamilyAliases(const std::string& dir, const StringStringMap& aliases)
+    {
+        std::string path = dir + "/" + kColumnFamilyAliasesFile;
+        if (aliases.empty())
+        {
+            unlink(path.c_str());
+            return 0;
+        }
+        std::string content;
+        StringStringMap::const_iterator it = aliases.begin();
+        while (it != aliases.end())
+        {
+            content.append(it->first).append("\t").append(it->second).append("\n");
+            it++;
+        }
+        std::string tmp = path + ".tmp";
+        int err = file_write_content(tmp, content);
+        if (0 == err)
+        {
+            err = rename(tmp.c_str(), path.c_str());
+        }
+        if (0 != err)
+        {
+            ERROR_LOG("Failed to save column family aliases:%s for reason:%s", path.c_str(), strerror(errno));
+            return -1;
+        }
+        return 0;
+    }
+
+    /*
+     * Called with m_lock held for write on a column family leaving m_handlers, true if it had an alias
+     */
+    bool RocksDBEngine::ForgetColumnFamilyAlias(rocksdb::ColumnFamilyHandle* cf)
+    {
+        return m_cf_aliases.erase(cf->GetName()) > 0;
+    }
+
+    /*
+     * A meta value of a blob namespace is written with its blob(or the removal of its former blob) in one batch,
+     * added to the batch of current transaction if any.
+     */
+    rocksdb::Status RocksDBEngine::WriteMetaValue(const rocksdb::WriteOptions& opt, rocksdb::WriteBatch* batch, rocksdb::ColumnFamilyHandle* cf,
+            rocksdb::ColumnFamilyHandle* blob_cf, const rocksdb::Slice& key, const rocksdb::Slice& value)
+    {
+        rocksdb::WriteBatch single;
+        if (put_meta_value(NULL != batch ? *batch : single, cf, blob_cf, key, value, m_blob_min_size))
+        {
+            atomic_add_uint64(&m_blob_writes, 1);
+        }
+        if (NULL != batch)
+        {
+            return rocksdb::Status::OK();
+        }
+        return NULL != m_group_commit ? m_group_commit->Write(m_db, opt, &single) : m_db->Write(opt, &single);
+    }
+
+    int RocksDBEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
+    {
+        rocksdb::Slice key_slice = to_rocksdb_slice(key);
+        rocksdb::Slice value_slice = to_rocksdb_slice(value);
+        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, ns, m_cf_per_type ? GetColumnFamilyKind(decode_key_type(key_slice)) : CF_META, ctx.flags.create_if_notexist);
+        rocksdb::ColumnFamilyHandle* cf = cfp.get();
+        if (NULL == cf)
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
+        rocksdb::WriteOptions opt;
+        if (ctx.flags.bulk_loading)
+        {
+            opt.disableWAL = true;
+        }
+        opt.sync = m_sync_wal && !opt.disableWAL;
+        if (NULL != m_ingest && m_ingest->Add(ctx, ns, cfp, key_slice, value_slice))
+        {
+            return 0;
+        }
+        ColumnFamilyHandlePtr blob_cfp;
+        if (IsBlobNameSpace(ns) && decode_key_type(key_slice) == KEY_META)
+        {
+            blob_cfp = GetBlobColumnFamily(ctx, ns, (int64) value_slice.size() >= m_blob_min_size);
+        }
         rocksdb::Status s;
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), ctx.flags.create_if_notexist);
+        rocksdb::WriteBatch* batch = rocks_ctx.transc.Ref();
+        if (NULL == batch)
+        {
+            WaitMemtableLimit();
+        }
+        if (NULL != blob_cfp.get())
+        {
+            s = WriteMetaValue(opt, batch, cf, blob_cfp.get(), key_slice, value_slice);
+        }
+        else if (NULL != batch)
+        {
+            batch->Put(cf, key_slice, value_slice);
+        }
+        else if (NULL != m_group_commit)
+        {
+            rocksdb::WriteBatch single;
+            single.Put(cf, key_slice, value_slice);
+            s = m_group_commit->Write(m_db, opt, &single);
+        }
+        else
+        {
+            s = m_db->Put(opt, cf, key_slice, value_slice);
+        }
+        return rocksdb_err(s);
+    }
+
+    int RocksDBEngine::Put(Context& ctx, const KeyObject& key, const ValueObject& value)
+    {
+        rocksdb::Status s;
+        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), GetColumnFamilyKind(key.GetType()), ctx.flags.create_if_notexist);
         rocksdb::ColumnFamilyHandle* cf = cfp.get();
         if (NULL == cf)
         {
             return ERR_ENTRY_NOT_EXIST;
         }
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         rocksdb::WriteOptions opt;
         if (ctx.flags.bulk_loading)
         {
             opt.disableWAL = true;
         }
-        Buffer& encode_buffer = rocks_ctx.GetEncodeBuferCache();
+        opt.sync = m_sync_wal && !opt.disableWAL;
+        ARDB_PROBE3(engine__put__start, key.GetNameSpace().CStr(), key.GetNameSpace().StringLength(), key.GetKey().StringLength());
+        Buffer& encode_buffer = rocks_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         value.Encode(encode_buffer);
         size_t value_len = encode_buffer.ReadableBytes() - key_len;
         rocksdb::Slice key_slice(encode_buffer.GetRawBuffer(), key_len);
         rocksdb::Slice value_slice(encode_buffer.GetRawBuffer() + key_len, value_len);
+        if (NULL != m_ingest && m_ingest->Add(ctx, key.GetNameSpace(), cfp, key_slice, value_slice))
+        {
+            ARDB_PROBE1(engine__put__done, 0);
+            return 0;
+        }
+        ColumnFamilyHandlePtr blob_cfp;
+        if (key.GetType() == KEY_META && IsBlobNameSpace(key.GetNameSpace()))
+        {
+            blob_cfp = GetBlobColumnFamily(ctx, key.GetNameSpace(), (int64) value_len >= m_blob_min_size);
+        }
         rocksdb::WriteBatch* batch = rocks_ctx.transc.Ref();
-        if (NULL != batch)
+        if (NULL == batch)
+        {
+            WaitMemtableLimit();
+        }
+        if (NULL != blob_cfp.get())
+        {
+            s = WriteMetaValue(opt, batch, cf, blob_cfp.get(), key_slice, value_slice);
+        }
+        else if (NULL != batch)
         {
             batch->Put(cf, key_slice, value_slice);
         }
+        else if (NULL != m_group_commit)
+        {
+            rocksdb::WriteBatch single;
+            single.Put(cf, key_slice, value_slice);
+            s = m_group_commit->Write(m_db, opt, &single);
+        }
         else
         {
             s = m_db->Put(opt, cf, key_slice, value_slice);
         }
-        return rocksdb_err(s);
+        int err = rocksdb_err(s);
+        ARDB_PROBE1(engine__put__done, err);
+        return err;
     }
     int RocksDBEngine::MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs)
     {
@@ -843,11 +2632,19 @@ OP_NAMESPACE_BEGIN
             return ERR_ENTRY_NOT_EXIST;
         }
         errs.resize(keys.size());
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        ColumnFamilyHandlePtr kind_cfps[CF_KIND_MAX];
+        if (m_cf_per_type)
+        {
+            for (int kind = 1; kind < CF_KIND_MAX; kind++)
+            {
+                kind_cfps[kind] = GetColumnFamilyHandle(ctx, ctx.ns, kind, false);
+            }
+        }
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         std::vector<rocksdb::ColumnFamilyHandle*> cfs;
         std::vector<rocksdb::Slice> ks;
         std::vector<size_t> positions;
-        Buffer& key_encode_buffers = rocks_ctx.GetEncodeBuferCache();
+        Buffer& key_encode_buffers = rocks_ctx.GetEncodeBufferCache();
         ks.resize(keys.size());
         std::vector<std::string>& vs = rocks_ctx.GetMultiStringCache(keys.size());
         for (size_t i = 0; i < keys.size(); i++)
@@ -859,46 +2656,130 @@ OP_NAMESPACE_BEGIN
         }
         for (size_t i = 0; i < keys.size(); i++)
         {
-            cfs.push_back(cf);
+            rocksdb::ColumnFamilyHandle* kind_cf = kind_cfps[GetColumnFamilyKind(keys[i].GetType())].get();
+            cfs.push_back(NULL != kind_cf ? kind_cf : cf);
             ks[i] = rocksdb::Slice(key_encode_buffers.GetRawReadBuffer(), positions[i]);
             key_encode_buffers.AdvanceReadIndex(positions[i]);
         }
 
         rocksdb::ReadOptions opt;
         opt.snapshot = rocks_ctx.PeekSnapshot();
+        RocksDBCacheStatsScope cache_stats(this, ctx.ns);
         std::vector<rocksdb::Status> ss = m_db->MultiGet(opt, cfs, ks, &vs);
 
         for (size_t i = 0; i < ss.size(); i++)
         {
-            if (ss[i].ok())
+            errs[i] = rocksdb_err(ss[i]);
+            if (0 == errs[i] && is_blob_ref(vs[i]))
+            {
+                errs[i] = ReadBlob(ctx, ctx.ns, opt, ks[i], vs[i]);
+            }
+            if (0 == errs[i])
             {
                 Buffer valBuffer(const_cast<char*>(vs[i].data()), 0, vs[i].size());
                 values[i].Decode(valBuffer, true);
             }
-            errs[i] = rocksdb_err(ss[i]);
         }
         return 0;
     }
+    /*
+     * A read of a request coroutine which missed the memtables & block cache, run by g_engine_blocking_call while the
+     * coroutine yields. Other requests of the thread reuse its local caches meanwhile, so the key & value live here
+     * and the thread's read snapshot is stashed until the coroutine resumes.
+     */
+    struct RocksBlockingGet: public Runnable
+    {
+            rocksdb::DB* db;
+            rocksdb::ReadOptions opt;
+            rocksdb::ColumnFamilyHandle* cf;
+            std::string key;
+            std::string value;
+            rocksdb::Status s;
+            void Run()
+            {
+                s = db->Get(opt, cf, key, &value);
+            }
+    };
+    static rocksdb::Status rocksdb_blocking_get(Context& ctx, RocksDBLocalContext& rocks_ctx, rocksdb::DB* db, const rocksdb::ReadOptions& opt,
+            rocksdb::ColumnFamilyHandle* cf, const rocksdb::Slice& key, std::string& value)
+    {
+        RocksBlockingGet get;
+        get.db = db;
+        get.opt = opt;
+        get.opt.read_tier = rocksdb::kReadAllTier;
+        get.cf = cf;
+        get.key.assign(key.data(), key.size());
+        RocksSnapshot snapshot = rocks_ctx.snapshot;
+        rocks_ctx.snapshot = RocksSnapshot();
+        g_engine_blocking_call(ctx, &get);
+        rocks_ctx.snapshot = snapshot;
+        value.swap(get.value);
+        return get.s;
+    }
+
+    int RocksDBEngine::ReadBlob(Context& ctx, const Data& ns, const rocksdb::ReadOptions& opt, const rocksdb::Slice& key, std::string& value)
+    {
+        ColumnFamilyHandlePtr blob_cfp = GetBlobColumnFamily(ctx, ns, false);
+        rocksdb::ColumnFamilyHandle* blob_cf = blob_cfp.get();
+        if (NULL == blob_cf)
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        atomic_add_uint64(&m_blob_reads, 1);
+        rocksdb::Status s = m_db->Get(opt, blob_cf, key, &value);
+        if (ctx.flags.request_coro && s.IsIncomplete())
+        {
+            s = rocksdb_blocking_get(ctx, m_local_ctx.GetValue(), m_db, opt, blob_cf, key, value);
+        }
+        return rocksdb_err(s);
+    }
+
     int RocksDBEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
     {
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), false);
+        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), GetColumnFamilyKind(key.GetType()), false);
         rocksdb::ColumnFamilyHandle* cf = cfp.get();
         if (NULL == cf)
         {
             return ERR_ENTRY_NOT_EXIST;
         }
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         rocksdb::ReadOptions opt;
         opt.snapshot = rocks_ctx.PeekSnapshot();
         std::string& valstr = rocks_ctx.GetStringCache();
-        Buffer& key_encode_buffer = rocks_ctx.GetEncodeBuferCache();
+        ARDB_PROBE3(engine__get__start, key.GetNameSpace().CStr(), key.GetNameSpace().StringLength(), key.GetKey().StringLength());
+        Buffer& key_encode_buffer = rocks_ctx.GetEncodeBufferCache();
         rocksdb::Slice key_slice = to_rocksdb_slice(key.Encode(key_encode_buffer));
-        rocksdb::Status s = m_db->Get(opt, cf, key_slice, &valstr);
+        rocksdb::Status s;
+        {
+            RocksDBCacheStatsScope cache_stats(this, key.GetNameSpace());
+            if (ctx.flags.request_coro)
+            {
+                opt.read_tier = rocksdb::kBlockCacheTier;
+            }
+            s = m_db->Get(opt, cf, key_slice, &valstr);
+        }
+        if (ctx.flags.request_coro && s.IsIncomplete())
+        {
+            s = rocksdb_blocking_get(ctx, rocks_ctx, m_db, opt, cf, key_slice, valstr);
+        }
         int err = rocksdb_err(s);
+        ARDB_PROBE1(engine__get__done, err);
         if (0 != err)
         {
             return err;
         }
+        if (is_blob_ref(valstr))
+        {
+            /*
+             * the encode buffer may be reused by other requests while a blocking read yields, the key is encoded again
+             */
+            Buffer& blob_key_buffer = rocks_ctx.GetEncodeBufferCache();
+            err = ReadBlob(ctx, key.GetNameSpace(), opt, to_rocksdb_slice(key.Encode(blob_key_buffer)), valstr);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
         Buffer valBuffer(const_cast<char*>(valstr.data()), 0, valstr.size());
         value.Decode(valBuffer, true);
 
@@ -906,22 +2787,49 @@ OP_NAMESPACE_BEGIN
     }
     int RocksDBEngine::Del(Context& ctx, const KeyObject& key)
     {
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), false);
+        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), GetColumnFamilyKind(key.GetType()), false);
         rocksdb::ColumnFamilyHandle* cf = cfp.get();
         if (NULL == cf)
         {
             return ERR_ENTRY_NOT_EXIST;
         }
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         rocksdb::WriteOptions opt;
-        Buffer& key_encode_buffer = rocks_ctx.GetEncodeBuferCache();
+        opt.sync = m_sync_wal;
+        Buffer& key_encode_buffer = rocks_ctx.GetEncodeBufferCache();
         rocksdb::Slice key_slice = to_rocksdb_slice(key.Encode(key_encode_buffer));
+        ColumnFamilyHandlePtr blob_cfp;
+        if (key.GetType() == KEY_META && IsBlobNameSpace(key.GetNameSpace()))
+        {
+            blob_cfp = GetBlobColumnFamily(ctx, key.GetNameSpace(), false);
+        }
         rocksdb::Status s;
         rocksdb::WriteBatch* batch = rocks_ctx.transc.Ref();
-        if (NULL != batch)
+        if (NULL == batch)
+        {
+            WaitMemtableLimit();
+        }
+        if (NULL != blob_cfp.get())
+        {
+            rocksdb::WriteBatch single;
+            rocksdb::WriteBatch& target = NULL != batch ? *batch : single;
+            target.Delete(cf, key_slice);
+            target.Delete(blob_cfp.get(), key_slice);
+            if (NULL == batch)
+            {
+                s = NULL != m_group_commit ? m_group_commit->Write(m_db, opt, &single) : m_db->Write(opt, &single);
+            }
+        }
+        else if (NULL != batch)
         {
             batch->Delete(cf, key_slice);
         }
+        else if (NULL != m_group_commit)
+        {
+            rocksdb::WriteBatch single;
+            single.Delete(cf, key_slice);
+            s = m_group_commit->Write(m_db, opt, &single);
+        }
         else
         {
             s = m_db->Delete(opt, cf, key_slice);
@@ -931,15 +2839,16 @@ OP_NAMESPACE_BEGIN
 
     int RocksDBEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& args)
     {
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), ctx.flags.create_if_notexist);
+        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), GetColumnFamilyKind(key.GetType()), ctx.flags.create_if_notexist);
         rocksdb::ColumnFamilyHandle* cf = cfp.get();
         if (NULL == cf)
         {
             return ERR_ENTRY_NOT_EXIST;
         }
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         rocksdb::WriteOptions opt;
-        Buffer& encode_buffer = rocks_ctx.GetEncodeBuferCache();
+        opt.sync = m_sync_wal;
+        Buffer& encode_buffer = rocks_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         encode_merge_operation(encode_buffer, op, args);
@@ -948,10 +2857,20 @@ OP_NAMESPACE_BEGIN
         rocksdb::Slice merge_slice(encode_buffer.GetRawBuffer() + key_len, merge_len);
         rocksdb::Status s;
         rocksdb::WriteBatch* batch = rocks_ctx.transc.Ref();
+        if (NULL == batch)
+        {
+            WaitMemtableLimit();
+        }
         if (NULL != batch)
         {
             batch->Merge(cf, key_slice, merge_slice);
         }
+        else if (NULL != m_group_commit)
+        {
+            rocksdb::WriteBatch single;
+            single.Merge(cf, key_slice, merge_slice);
+            s = m_group_commit->Write(m_db, opt, &single);
+        }
         else
         {
             s = m_db->Merge(opt, cf, key_slice, merge_slice);
@@ -961,16 +2880,17 @@ OP_NAMESPACE_BEGIN
 
     bool RocksDBEngine::Exists(Context& ctx, const KeyObject& key)
     {
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), false);
+        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), GetColumnFamilyKind(key.GetType()), false);
         rocksdb::ColumnFamilyHandle* cf = cfp.get();
         if (NULL == cf)
         {
             return false;
         }
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
+        RocksDBCacheStatsScope cache_stats(this, key.GetNameSpace());
         rocksdb::ReadOptions opt;
         opt.snapshot = rocks_ctx.PeekSnapshot();
-        Buffer& key_encode_buffer = rocks_ctx.GetEncodeBuferCache();
+        Buffer& key_encode_buffer = rocks_ctx.GetEncodeBufferCache();
         std::string& tmp = rocks_ctx.GetStringCache();
         rocksdb::Slice k = to_rocksdb_slice(key.Encode(key_encode_buffer));
         bool exist = m_db->KeyMayExist(opt, cf, k, &tmp, NULL);
@@ -987,7 +2907,7 @@ OP_NAMESPACE_BEGIN
 
     const rocksdb::Snapshot* RocksDBEngine::GetSnpashot()
     {
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         RocksSnapshot& snapshot = rocks_ctx.snapshot;
         snapshot.ref++;
         if (snapshot.snapshot == NULL)
@@ -998,7 +2918,7 @@ OP_NAMESPACE_BEGIN
     }
     void RocksDBEngine::ReleaseSnpashot()
     {
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         RocksSnapshot& snapshot = rocks_ctx.snapshot;
         if (snapshot.snapshot == NULL)
         {
@@ -1007,19 +2927,60 @@ OP_NAMESPACE_BEGIN
         snapshot.ref--;
         if (snapshot.ref <= 0)
         {
-            m_db->ReleaseSnapshot(snapshot.snapshot);
+            rocks_ctx.ClearIterators();
+            if (!snapshot.shared)
+            {
+                m_db->ReleaseSnapshot(snapshot.snapshot);
+            }
             snapshot.snapshot = NULL;
             snapshot.ref = 0;
+            snapshot.shared = false;
+        }
+    }
+
+    int RocksDBEngine::BeginSnapshotRead(Context& ctx)
+    {
+        GetSnpashot();
+        return 0;
+    }
+    int RocksDBEngine::EndSnapshotRead(Context& ctx)
+    {
+        ReleaseSnpashot();
+        return 0;
+    }
+    const void* RocksDBEngine::CreateSharedSnapshot(Context& ctx)
+    {
+        atomic_add_uint32(&m_shared_snapshots, 1);
+        return m_db->GetSnapshot();
+    }
+    int RocksDBEngine::BeginSharedSnapshotRead(Context& ctx, const void* snapshot)
+    {
+        RocksSnapshot& current = m_local_ctx.GetValue().snapshot;
+        if (NULL == snapshot || (NULL != current.snapshot && current.snapshot != snapshot))
+        {
+            return ERR_INVALID_ARGS;
+        }
+        current.snapshot = (const rocksdb::Snapshot*) snapshot;
+        current.shared = true;
+        current.ref++;
+        return 0;
+    }
+    void RocksDBEngine::ReleaseSharedSnapshot(Context& ctx, const void* snapshot)
+    {
+        if (NULL != snapshot)
+        {
+            m_db->ReleaseSnapshot((const rocksdb::Snapshot*) snapshot);
+            atomic_sub_uint32(&m_shared_snapshots, 1);
         }
     }
 
-    Iterator* RocksDBEngine::Find(Context& ctx, const KeyObject& key)
+    Iterator* RocksDBEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
     {
         RocksDBIterator* iter = NULL;
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), false);
-        rocksdb::ColumnFamilyHandle* cf = cfp.get();
-        NEW(iter, RocksDBIterator(this,cf, key.GetNameSpace()));
-        if (NULL == cf)
+        std::vector<ColumnFamilyHandlePtr> cfs;
+        GetIterateColumnFamilies(ctx, key, options, cfs);
+        NEW(iter, RocksDBIterator(this, key.GetNameSpace()));
+        if (cfs.empty())
         {
             iter->MarkValid(false);
             return iter;
@@ -1027,94 +2988,434 @@ OP_NAMESPACE_BEGIN
 
         rocksdb::ReadOptions opt;
         opt.snapshot = GetSnpashot();
-        if (key.GetType() > 0)
+        /*
+         * rocksdb compares 'iterate_upper_bound' bytewise instead of using the custom comparator,
+         * so the bounds are checked by the iterator itself.
+         */
+        iter->SetIterateBounds(options);
+        uint8 read_flags = 0;
+        if (key.GetType() > 0 && options.prefix_only)
         {
-            if (!ctx.flags.iterate_multi_keys)
-            {
-                opt.prefix_same_as_start = true;
-                if (!ctx.flags.iterate_no_upperbound)
-                {
-                    KeyObject& upperbound_key = iter->IterateUpperBoundKey();
-                    upperbound_key.SetNameSpace(key.GetNameSpace());
-                    if (key.GetType() == KEY_META)
-                    {
-                        upperbound_key.SetType(KEY_END);
-                    }
-                    else
-                    {
-                        upperbound_key.SetType(key.GetType() + 1);
-                    }
-                    upperbound_key.SetKey(key.GetKey());
-                    upperbound_key.CloneStringPart();
-                }
-            }
-            else
-            {
-                //opt.total_order_seek = true;
-            }
+            opt.prefix_same_as_start = true;
+            read_flags |= ROCKS_READ_PREFIX_SAME_AS_START;
         }
-        if (ctx.flags.iterate_total_order)
+        if (options.total_order)
         {
             opt.total_order_seek = true;
+            read_flags |= ROCKS_READ_TOTAL_ORDER_SEEK;
+        }
+        if (options.streaming)
+        {
+            opt.fill_cache = false;
+            read_flags |= ROCKS_READ_NO_FILL_CACHE;
+        }
+        iter->SetReadOptions(opt.snapshot, read_flags);
+        if (g_db->GetConf().rocksdb_tombstone_compact_threshold > 0 && rocksdb::GetPerfLevel() == rocksdb::kDisable)
+        {
+            rocksdb::SetPerfLevel(rocksdb::kEnableCount);
+        }
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
+        for (size_t i = 0; i < cfs.size(); i++)
+        {
+            rocksdb::Iterator* rocks_iter = rocks_ctx.TakeIterator(cfs[i]->GetID(), opt.snapshot, read_flags);
+            if (NULL == rocks_iter)
+            {
+                rocks_iter = m_db->NewIterator(opt, cfs[i].get());
+            }
+            iter->AddIterator(cfs[i].get(), rocks_iter);
         }
-        rocksdb::Iterator* rocksiter = m_db->NewIterator(opt, cf);
-        iter->SetIterator(rocksiter);
         if (key.GetType() > 0)
         {
             iter->Jump(key);
         }
         else
         {
-            rocksiter->SeekToFirst();
+            iter->JumpToFirst();
         }
         return iter;
     }
 
+    /*
+     * The column family with the type of 'key' is enough if the iterate range is within keys of its kind,
+     * otherwise all column families of the namespace are merged.
+     */
+    void RocksDBEngine::GetIterateColumnFamilies(Context& ctx, const KeyObject& key, const IterateOptions& options, std::vector<ColumnFamilyHandlePtr>& cfs)
+    {
+        if (!m_cf_per_type)
+        {
+            GetColumnFamilyHandles(ctx, key.GetNameSpace(), cfs);
+            return;
+        }
+        int kind = GetColumnFamilyKind(key.GetType());
+        const KeyObject& upper = options.upper_bound;
+        if (key.GetType() > 0 && CF_META != kind && upper.GetType() > key.GetType() && upper.GetKey().Compare(key.GetKey()) == 0)
+        {
+            bool one_kind = true;
+            for (int type = key.GetType() + 1; type < upper.GetType(); type++)
+            {
+                if (GetColumnFamilyKind(type) != kind)
+                {
+                    one_kind = false;
+                    break;
+                }
+            }
+            if (one_kind)
+            {
+                ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, key.GetNameSpace(), kind, false);
+                if (NULL != cfp.get())
+                {
+                    cfs.push_back(cfp);
+                }
+                return;
+            }
+        }
+        GetColumnFamilyHandles(ctx, key.GetNameSpace(), cfs);
+    }
+
     int RocksDBEngine::BeginWriteBatch(Context& ctx)
     {
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         rocks_ctx.transc.AddRef();
         return 0;
     }
     int RocksDBEngine::CommitWriteBatch(Context& ctx)
     {
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         if (rocks_ctx.transc.ReleaseRef(false) == 0)
         {
+            WaitMemtableLimit();
             rocksdb::WriteOptions opt;
             if (ctx.flags.bulk_loading)
             {
                 opt.disableWAL = true;
             }
-            m_db->Write(opt, &rocks_ctx.transc.GetBatch());
+            opt.sync = m_sync_wal && !opt.disableWAL;
+            ARDB_PROBE(engine__commit__start);
+            if (NULL != m_group_commit)
+            {
+                m_group_commit->Write(m_db, opt, &rocks_ctx.transc.GetBatch());
+            }
+            else
+            {
+                m_db->Write(opt, &rocks_ctx.transc.GetBatch());
+            }
+            ARDB_PROBE(engine__commit__done);
             rocks_ctx.transc.Clear();
         }
         return 0;
     }
     int RocksDBEngine::DiscardWriteBatch(Context& ctx)
     {
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
+        RocksDBLocalContext& rocks_ctx = m_local_ctx.GetValue();
         if (rocks_ctx.transc.ReleaseRef(true) == 0)
         {
             rocks_ctx.transc.Clear();
         }
-        return 0;
+        return 0;
+    }
+
+    int RocksDBEngine::Compact(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        std::vector<ColumnFamilyHandlePtr> cfs;
+        GetColumnFamilyHandles(ctx, start.GetNameSpace(), cfs);
+        if (cfs.empty())
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        Buffer start_buffer, end_buffer;
+        rocksdb::Slice start_key = to_rocksdb_slice(start.Encode(start_buffer));
+        rocksdb::Slice end_key = to_rocksdb_slice(end.Encode(end_buffer));
+        rocksdb::CompactRangeOptions opt;
+        rocksdb::Status s;
+        for (size_t i = 0; i < cfs.size() && s.ok(); i++)
+        {
+            s = m_db->CompactRange(opt, cfs[i].get(), start.IsValid() ? &start_key : NULL, end.IsValid() ? &end_key : NULL);
+        }
+        return rocksdb_err(s);
+    }
+
+    static std::string sst_file_basename(const std::string& path)
+    {
+        size_t pos = path.rfind('/');
+        return pos == std::string::npos ? path : path.substr(pos + 1);
+    }
+
+    struct DeletedKeyRange
+    {
+            std::string start;
+            std::string end;
+    };
+    struct DeletedKeyRangeLess
+    {
+            const rocksdb::Comparator* cmp;
+            DeletedKeyRangeLess(const rocksdb::Comparator* c) :
+                    cmp(c)
+            {
+            }
+            bool operator()(const DeletedKeyRange& a, const DeletedKeyRange& b) const
+            {
+                return cmp->Compare(a.start, b.start) < 0;
+            }
+    };
+
+    /*
+     * The deleted entries(tombstones) of every sst file are counted in its table properties, the files with
+     * many of them are compacted by their key range, overlapping ranges merged.
+     */
+    int RocksDBEngine::CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress)
+    {
+        std::vector<ColumnFamilyHandlePtr> cfs;
+        GetColumnFamilyHandles(ctx, ns, cfs);
+        if (cfs.empty())
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        const rocksdb::Comparator* cmp = m_options.comparator;
+        rocksdb::Status s;
+        for (size_t i = 0; i < cfs.size() && s.ok() && !progress.cancel; i++)
+        {
+            rocksdb::TablePropertiesCollection props;
+            s = m_db->GetPropertiesOfAllTables(cfs[i].get(), &props);
+            if (!s.ok())
+            {
+                break;
+            }
+            StringTreeSet dense_files;
+            rocksdb::TablePropertiesCollection::iterator pit = props.begin();
+            while (pit != props.end())
+            {
+                uint64_t entries = pit->second->num_entries;
+                uint64_t deleted = rocksdb::GetDeletedKeys(pit->second->user_collected_properties);
+                if (entries > 0 && deleted * 100 >= entries * (uint64_t) min_deleted_percent)
+                {
+                    dense_files.insert(sst_file_basename(pit->first));
+                }
+                pit++;
+            }
+            if (dense_files.empty())
+            {
+                continue;
+            }
+            rocksdb::ColumnFamilyMetaData meta;
+            m_db->GetColumnFamilyMetaData(cfs[i].get(), &meta);
+            std::vector<DeletedKeyRange> ranges;
+            for (size_t level = 0; level < meta.levels.size(); level++)
+            {
+                const std::vector<rocksdb::SstFileMetaData>& files = meta.levels[level].files;
+                for (size_t j = 0; j < files.size(); j++)
+                {
+                    if (!files[j].being_compacted && dense_files.count(sst_file_basename(files[j].name)) > 0)
+                    {
+                        DeletedKeyRange range;
+                        range.start = files[j].smallestkey;
+                        range.end = files[j].largestkey;
+                        ranges.push_back(range);
+                    }
+                }
+            }
+            std::sort(ranges.begin(), ranges.end(), DeletedKeyRangeLess(cmp));
+            std::vector<DeletedKeyRange> merged;
+            for (size_t j = 0; j < ranges.size(); j++)
+            {
+                if (!merged.empty() && cmp->Compare(ranges[j].start, merged.back().end) <= 0)
+                {
+                    if (cmp->Compare(ranges[j].end, merged.back().end) > 0)
+                    {
+                        merged.back().end = ranges[j].end;
+                    }
+                    continue;
+                }
+                merged.push_back(ranges[j]);
+            }
+            progress.total += merged.size();
+            rocksdb::CompactRangeOptions opt;
+            for (size_t j = 0; j < merged.size() && s.ok() && !progress.cancel; j++)
+            {
+                rocksdb::Slice start_key(merged[j].start), end_key(merged[j].end);
+                s = m_db->CompactRange(opt, cfs[i].get(), &start_key, &end_key);
+                progress.done++;
+            }
+        }
+        return rocksdb_err(s);
+    }
+
+    static const size_t kMaxQueuedTombstoneRanges = 64;
+
+    void RocksDBEngine::QueueTombstoneRange(const std::vector<rocksdb::ColumnFamilyHandle*>& cfs, const std::string& lower,
+            const std::string& upper, uint64_t skipped)
+    {
+        atomic_add_uint64(&m_tombstone_runs, 1);
+        LockGuard<SpinMutexLock> guard(m_tombstone_lock);
+        for (size_t i = 0; i < cfs.size() && m_tombstone_ranges.size() < kMaxQueuedTombstoneRanges; i++)
+        {
+            TombstoneRange range;
+            range.cf = ColumnFamilyName(cfs[i]);
+            range.lower = lower;
+            range.upper = upper;
+            bool queued = false;
+            for (size_t j = 0; j < m_tombstone_ranges.size() && !queued; j++)
+            {
+                const TombstoneRange& r = m_tombstone_ranges[j];
+                queued = r.cf == range.cf && r.lower == range.lower && r.upper == range.upper;
+            }
+            if (!queued)
+            {
+                INFO_LOG("An iterator skipped %llu deleted entries in column family:%s, the range is queued for compaction.",
+                        (unsigned long long) skipped, range.cf.c_str());
+                m_tombstone_ranges.push_back(range);
+            }
+        }
+    }
+
+    /*
+     * One range per call, the caller runs it again for the rest.
+     */
+    int RocksDBEngine::CompactQueuedRanges(Context& ctx)
+    {
+        TombstoneRange range;
+        {
+            LockGuard<SpinMutexLock> guard(m_tombstone_lock);
+            if (m_tombstone_ranges.empty())
+            {
+                return 0;
+            }
+            range = m_tombstone_ranges.front();
+            m_tombstone_ranges.pop_front();
+        }
+        ColumnFamilyHandlePtr cf = GetColumnFamilyHandle(ctx, Data(range.cf, false), false);
+        if (NULL == cf.get())
+        {
+            return 0;
+        }
+        rocksdb::Slice lower(range.lower), upper(range.upper);
+        rocksdb::CompactRangeOptions opt;
+        rocksdb::Status s = m_db->CompactRange(opt, cf.get(), range.lower.empty() ? NULL : &lower, range.upper.empty() ? NULL : &upper);
+        if (!s.ok())
+        {
+            WARN_LOG("Failed to compact deleted entries in column family:%s for reason:%s", range.cf.c_str(), s.ToString().c_str());
+            return 0;
+        }
+        atomic_add_uint64(&m_tombstone_compactions, 1);
+        return 1;
+    }
+
+    /*
+     * Deletes whole tables of the ttl namespaces whose keys all expired. DeleteFile only accepts the oldest level 0 files
+     * or files of the last non empty level, so nothing newer could be shadowed by the dropped keys.
+     */
+    int RocksDBEngine::DropExpiredTables(Context& ctx)
+    {
+        if (m_ttl_namespaces.empty() || !g_db->GetConf().master_host.empty())
+        {
+            return 0;
+        }
+        std::vector<ColumnFamilyHandlePtr> cfs;
+        {
+            RWLockGuard<SpinRWLock> guard(m_lock, true);
+            ColumnFamilyHandleTable::iterator it = m_handlers.begin();
+            while (it != m_handlers.end())
+            {
+                std::string ns;
+                if (column_family_kind(it->first.AsString(), &ns) == CF_META && m_ttl_namespaces.count(ns) > 0)
+                {
+                    cfs.push_back(it->second);
+                }
+                it++;
+            }
+        }
+        uint64 now = get_current_epoch_millis();
+        int dropped = 0;
+        for (size_t i = 0; i < cfs.size(); i++)
+        {
+            rocksdb::TablePropertiesCollection props;
+            rocksdb::Status s = m_db->GetPropertiesOfAllTables(cfs[i].get(), &props);
+            if (!s.ok())
+            {
+                continue;
+            }
+            StringTreeSet expired_files;
+            rocksdb::TablePropertiesCollection::iterator pit = props.begin();
+            while (pit != props.end())
+            {
+                const rocksdb::UserCollectedProperties& user_props = pit->second->user_collected_properties;
+                rocksdb::UserCollectedProperties::const_iterator all = user_props.find(ROCKS_PROP_ALL_EXPIRE);
+                rocksdb::UserCollectedProperties::const_iterator max = user_props.find(ROCKS_PROP_MAX_EXPIRE);
+                int64 max_expire = 0;
+                if (all != user_props.end() && all->second == "1" && max != user_props.end() && string_toint64(max->second, max_expire)
+                        && max_expire > 0 && (uint64) max_expire < now)
+                {
+                    expired_files.insert(sst_file_basename(pit->first));
+                }
+                pit++;
+            }
+            if (expired_files.empty())
+            {
+                continue;
+            }
+            rocksdb::ColumnFamilyMetaData meta;
+            m_db->GetColumnFamilyMetaData(cfs[i].get(), &meta);
+            int last_level = -1;
+            for (size_t j = 0; j < meta.levels.size(); j++)
+            {
+                if (!meta.levels[j].files.empty())
+                {
+                    last_level = (int) j;
+                }
+            }
+            if (last_level < 0)
+            {
+                continue;
+            }
+            std::vector<rocksdb::SstFileMetaData> candidates;
+            const std::vector<rocksdb::SstFileMetaData>& files = meta.levels[last_level].files;
+            if (0 == last_level)
+            {
+                /*
+                 * level 0 files are listed newest first, only a run of the oldest ones could be dropped
+                 */
+                for (size_t j = files.size(); j > 0; j--)
+                {
+                    if (files[j - 1].being_compacted || expired_files.count(sst_file_basename(files[j - 1].name)) == 0)
+                    {
+                        break;
+                    }
+                    candidates.push_back(files[j - 1]);
+                }
+            }
+            else
+            {
+                for (size_t j = 0; j < files.size(); j++)
+                {
+                    if (!files[j].being_compacted && expired_files.count(sst_file_basename(files[j].name)) > 0)
+                    {
+                        candidates.push_back(files[j]);
+                    }
+                }
+            }
+            for (size_t j = 0; j < candidates.size(); j++)
+            {
+                s = m_db->DeleteFile(candidates[j].name);
+                if (!s.ok())
+                {
+                    WARN_LOG("Failed to delete expired table:%s in column family:%s for reason:%s", candidates[j].name.c_str(), meta.name.c_str(),
+                            s.ToString().c_str());
+                    break;
+                }
+                atomic_add_uint64(&m_expired_table_drops, 1);
+                atomic_add_uint64(&m_expired_table_bytes, candidates[j].size);
+                dropped++;
+            }
+        }
+        return dropped;
     }
 
-    int RocksDBEngine::Compact(Context& ctx, const KeyObject& start, const KeyObject& end)
+    uint64_t RocksDBEngine::GetThreadSkippedDeletes()
     {
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, start.GetNameSpace(), false);
-        rocksdb::ColumnFamilyHandle* cf = cfp.get();
-        if (NULL == cf)
+        if (rocksdb::GetPerfLevel() == rocksdb::kDisable)
         {
-            return ERR_ENTRY_NOT_EXIST;
+            return 0;
         }
-        Buffer start_buffer, end_buffer;
-        rocksdb::Slice start_key = to_rocksdb_slice(start.Encode(start_buffer));
-        rocksdb::Slice end_key = to_rocksdb_slice(end.Encode(end_buffer));
-        rocksdb::CompactRangeOptions opt;
-        rocksdb::Status s = m_db->CompactRange(opt, cf, start.IsValid() ? &start_key : NULL, end.IsValid() ? &end_key : NULL);
-        return rocksdb_err(s);
+        return rocksdb::perf_context.internal_delete_skipped_count;
     }
 
     int RocksDBEngine::ListNameSpaces(Context& ctx, DataArray& nss)
@@ -1123,7 +3424,7 @@ OP_NAMESPACE_BEGIN
         ColumnFamilyHandleTable::iterator it = m_handlers.begin();
         while (it != m_handlers.end())
         {
-            if (it->first.AsString() != m_db->DefaultColumnFamily()->GetName())
+            if (it->first.AsString() != m_db->DefaultColumnFamily()->GetName() && column_family_kind(it->first.AsString(), NULL) == CF_META)
             {
                 nss.push_back(it->first);
             }
@@ -1134,32 +3435,66 @@ OP_NAMESPACE_BEGIN
 
     int RocksDBEngine::Flush(Context& ctx, const Data& ns)
     {
-        ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, ns, false);
-        rocksdb::ColumnFamilyHandle* cf = cfp.get();
-        if (NULL == cf)
+        std::vector<ColumnFamilyHandlePtr> cfs;
+        GetColumnFamilyHandles(ctx, ns, cfs);
+        if (cfs.empty())
         {
             return ERR_ENTRY_NOT_EXIST;
         }
         rocksdb::FlushOptions opt;
-        rocksdb::Status s = m_db->Flush(opt, cf);
+        rocksdb::Status s;
+        for (size_t i = 0; i < cfs.size() && s.ok(); i++)
+        {
+            s = m_db->Flush(opt, cfs[i].get());
+        }
         return rocksdb_err(s);
     }
 
     int RocksDBEngine::BeginBulkLoad(Context& ctx)
     {
+        if (0 == BeginBulkIngest(ctx, Data()))
+        {
+            m_ingest_load = true;
+            return 0;
+        }
         rocksdb::Options load_options = m_options;
         load_options.PrepareForBulkLoad();
         return ReOpen(load_options);
     }
     int RocksDBEngine::EndBulkLoad(Context& ctx)
     {
+        if (m_ingest_load)
+        {
+            m_ingest_load = false;
+            return EndBulkIngest(ctx, Data(), false);
+        }
         return ReOpen(m_options);
     }
 
+    int RocksDBEngine::BeginBulkIngest(Context& ctx, const Data& ns)
+    {
+        /*
+         * ingested tables are kept per namespace, which does not fit several column families of one namespace
+         */
+        if (NULL == m_ingest || !g_db->GetConf().rocksdb_ingest_sst || m_cf_per_type)
+        {
+            return ERR_NOTSUPPORTED;
+        }
+        return m_ingest->Begin(ns);
+    }
+    int RocksDBEngine::EndBulkIngest(Context& ctx, const Data& ns, bool abort)
+    {
+        if (NULL == m_ingest)
+        {
+            return ERR_NOTSUPPORTED;
+        }
+        return m_ingest->End(m_db, ns, abort);
+    }
+
     const std::string RocksDBEngine::GetErrorReason(int err)
     {
         err = err - STORAGE_ENGINE_ERR_OFFSET;
-        RocksDBLocalContext::ErrMap& err_map = g_rocks_context.GetValue().err_map;
+        RocksErrMap& err_map = g_rocks_errs.GetValue();
         if(err_map.count(err) > 0)
         {
             return err_map[err].ToString();
@@ -1170,16 +3505,176 @@ OP_NAMESPACE_BEGIN
     int RocksDBEngine::DropNameSpace(Context& ctx, const Data& ns)
     {
         RWLockGuard<SpinRWLock> guard(m_lock, false);
-        ColumnFamilyHandleTable::iterator found = m_handlers.find(ns);
-        if (found != m_handlers.end())
+        int err = ERR_ENTRY_NOT_EXIST;
+        bool aliases_changed = false;
+        int kinds = m_cf_per_type ? CF_KIND_MAX : 1;
+        for (int kind = 0; kind <= CF_BLOB; kind++)
         {
-            INFO_LOG("RocksDB drop column family:%s.", found->second->GetName().c_str());
-            m_db->DropColumnFamily(found->second.get());
-            //m_droped_handlers.push_back(found->second);
-            m_handlers.erase(found);
-            return 0;
+            if (kind >= kinds && kind != CF_BLOB)
+            {
+                continue;
+            }
+            Data kind_name;
+            const Data& cf_name = CF_META == kind ? ns : column_family_name(ns, kind, kind_name);
+            ColumnFamilyHandleTable::iterator found = m_handlers.find(cf_name);
+            if (found != m_handlers.end())
+            {
+                INFO_LOG("RocksDB drop column family:%s.", found->second->GetName().c_str());
+                m_db->DropColumnFamily(found->second.get());
+                //m_droped_handlers.push_back(found->second);
+                aliases_changed = ForgetColumnFamilyAlias(found->second.get()) || aliases_changed;
+                m_handlers.erase(found);
+                err = 0;
+            }
+        }
+        if (aliases_changed)
+        {
+            SaveColumnFamilyAliases(m_dbdir, m_cf_aliases);
+        }
+        return err;
+    }
+
+    /*
+     * Dropping a column family only marks it dropped, its files are deleted by whoever releases the last handle
+     * of it, which is the reclaimer instead of the caller here.
+     */
+    int RocksDBEngine::DetachNameSpace(Context& ctx, const Data& ns)
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        int err = ERR_ENTRY_NOT_EXIST;
+        bool aliases_changed = false;
+        int kinds = m_cf_per_type ? CF_KIND_MAX : 1;
+        for (int kind = 0; kind <= CF_BLOB; kind++)
+        {
+            if (kind >= kinds && kind != CF_BLOB)
+            {
+                continue;
+            }
+            Data kind_name;
+            const Data& cf_name = CF_META == kind ? ns : column_family_name(ns, kind, kind_name);
+            ColumnFamilyHandleTable::iterator found = m_handlers.find(cf_name);
+            if (found != m_handlers.end())
+            {
+                INFO_LOG("RocksDB detach column family:%s.", found->second->GetName().c_str());
+                m_db->DropColumnFamily(found->second.get());
+                {
+                    LockGuard<SpinMutexLock> detached_guard(m_detached_lock);
+                    m_detached_handlers.push_back(found->second);
+                }
+                aliases_changed = ForgetColumnFamilyAlias(found->second.get()) || aliases_changed;
+                m_handlers.erase(found);
+                err = 0;
+            }
+        }
+        if (aliases_changed)
+        {
+            SaveColumnFamilyAliases(m_dbdir, m_cf_aliases);
+        }
+        return err;
+    }
+
+    /*
+     * The column families of 'from' take the names of the ones of 'ns' in m_handlers & the alias file, the replaced ones
+     * are detached. The aliases are saved before the old column families are dropped, a swap interrupted in between
+     * is completed by ReOpen.
+     */
+    int RocksDBEngine::SwapNameSpace(Context& ctx, const Data& ns, const Data& from)
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        if (m_handlers.find(from) == m_handlers.end())
+        {
+            return ERR_ENTRY_NOT_EXIST;
         }
-        return ERR_ENTRY_NOT_EXIST;
+        StringStringMap aliases = m_cf_aliases;
+        for (int kind = 0; kind <= CF_BLOB; kind++)
+        {
+            Data to_kind_name, from_kind_name;
+            const Data& to_name = CF_META == kind ? ns : column_family_name(ns, kind, to_kind_name);
+            const Data& from_name = CF_META == kind ? from : column_family_name(from, kind, from_kind_name);
+            ColumnFamilyHandleTable::iterator found = m_handlers.find(to_name);
+            if (found != m_handlers.end())
+            {
+                aliases.erase(found->second->GetName());
+            }
+            found = m_handlers.find(from_name);
+            if (found != m_handlers.end())
+            {
+                aliases[found->second->GetName()] = to_name.AsString();
+                if (found->second->GetName() == to_name.AsString())
+                {
+                    aliases.erase(found->second->GetName());
+                }
+            }
+        }
+        if (0 != SaveColumnFamilyAliases(m_dbdir, aliases))
+        {
+            return ERR_NOTPERFORMED;
+        }
+        m_cf_aliases = aliases;
+        for (int kind = 0; kind <= CF_BLOB; kind++)
+        {
+            Data to_kind_name, from_kind_name;
+            const Data& to_name = CF_META == kind ? ns : column_family_name(ns, kind, to_kind_name);
+            const Data& from_name = CF_META == kind ? from : column_family_name(from, kind, from_kind_name);
+            ColumnFamilyHandlePtr replaced;
+            ColumnFamilyHandleTable::iterator found = m_handlers.find(to_name);
+            if (found != m_handlers.end())
+            {
+                replaced = found->second;
+                m_handlers.erase(found);
+            }
+            found = m_handlers.find(from_name);
+            if (found != m_handlers.end())
+            {
+                ColumnFamilyHandlePtr moved = found->second;
+                m_handlers.erase(found);
+                m_handlers[to_name] = moved;
+                INFO_LOG("RocksDB swap column family:%s in place of %s.", moved->GetName().c_str(), to_name.AsString().c_str());
+            }
+            if (NULL != replaced.get())
+            {
+                m_db->DropColumnFamily(replaced.get());
+                LockGuard<SpinMutexLock> detached_guard(m_detached_lock);
+                m_detached_handlers.push_back(replaced);
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * rocksdb 4.x has no secondary instance to tail the owner's MANIFEST & WAL, the read only db is reopened instead,
+     * which replays the WAL the owner has not flushed yet.
+     */
+    int RocksDBEngine::Refresh(Context& ctx)
+    {
+        if (!m_read_only)
+        {
+            return ERR_NOTSUPPORTED;
+        }
+        if (m_shared_snapshots > 0)
+        {
+            return ERR_NOTPERFORMED;
+        }
+        return ReOpen(m_options);
+    }
+
+    int RocksDBEngine::ReclaimDetachedNameSpaces(Context& ctx)
+    {
+        ColumnFamilyHandlePtr cf;
+        {
+            LockGuard<SpinMutexLock> guard(m_detached_lock);
+            if (m_detached_handlers.empty())
+            {
+                return 0;
+            }
+            cf = m_detached_handlers.back();
+            m_detached_handlers.pop_back();
+        }
+        std::string name = cf->GetName();
+        cf.reset();
+        INFO_LOG("RocksDB released detached column family:%s.", name.c_str());
+        LockGuard<SpinMutexLock> guard(m_detached_lock);
+        return (int) m_detached_handlers.size();
     }
 
     int64_t RocksDBEngine::EstimateKeysNum(Context& ctx, const Data& ns)
@@ -1194,6 +3689,119 @@ OP_NAMESPACE_BEGIN
         return (int64) value;
     }
 
+    int64_t RocksDBEngine::GetLatestSequence()
+    {
+        return (int64_t) m_db->GetLatestSequenceNumber();
+    }
+
+    int RocksDBEngine::Checkpoint(Context& ctx, const std::string& dir)
+    {
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        rocksdb::Checkpoint* checkpoint = NULL;
+        rocksdb::Status s = rocksdb::Checkpoint::Create(m_db, &checkpoint);
+        if (s.ok())
+        {
+            s = checkpoint->CreateCheckpoint(dir);
+            delete checkpoint;
+        }
+        if (!s.ok())
+        {
+            ERROR_LOG("Failed to create checkpoint:%s for reason:%s", dir.c_str(), s.ToString().c_str());
+            return rocksdb_err(s);
+        }
+        return SaveColumnFamilyAliases(dir, m_cf_aliases);
+    }
+
+    /*
+     * Mutable column family options go to every open column family and to m_options for the ones created later,
+     * rocksdb 4.x has no SetDBOptions so among the db options only the rate limit can change, besides the capacity
+     * of the shared block cache.
+     */
+    int RocksDBEngine::SetOption(Context& ctx, const std::string& name, const std::string& value)
+    {
+        if (name == "block_cache" || name == "rate_limiter_bytes_per_sec")
+        {
+            Properties props;
+            int64 size = 0;
+            conf_set(props, name, value);
+            if (!conf_get_int64(props, name, size) || size <= 0)
+            {
+                return ERR_INVALID_ARGS;
+            }
+            if (name == "block_cache")
+            {
+                if (NULL == m_block_cache.get())
+                {
+                    return ERR_NOTSUPPORTED;
+                }
+                m_block_cache->SetCapacity((size_t) size);
+            }
+            else
+            {
+                m_options.rate_limiter->SetBytesPerSecond(size);
+            }
+            INFO_LOG("RocksDB option %s set to %s", name.c_str(), value.c_str());
+            return 0;
+        }
+        std::unordered_map<std::string, std::string> opts;
+        opts[name] = value;
+        rocksdb::ColumnFamilyOptions cf_options;
+        rocksdb::Status s = rocksdb::GetColumnFamilyOptionsFromMap(m_options, opts, &cf_options);
+        if (!s.ok())
+        {
+            rocksdb::DBOptions db_options;
+            /*
+             * a valid db option is read only at runtime
+             */
+            return rocksdb::GetDBOptionsFromMap(m_options, opts, &db_options).ok() ? ERR_NOTSUPPORTED : ERR_INVALID_ARGS;
+        }
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        ColumnFamilyHandleTable::iterator it = m_handlers.begin();
+        while (it != m_handlers.end())
+        {
+            s = m_db->SetOptions(it->second.get(), opts);
+            if (!s.ok())
+            {
+                WARN_LOG("Failed to set rocksdb option %s to %s for reason:%s", name.c_str(), value.c_str(), s.ToString().c_str());
+                return s.IsInvalidArgument() ? ERR_NOTSUPPORTED : rocksdb_err(s);
+            }
+            it++;
+        }
+        (rocksdb::ColumnFamilyOptions&) m_options = cf_options;
+        INFO_LOG("RocksDB option %s set to %s", name.c_str(), value.c_str());
+        return 0;
+    }
+
+    /*
+     * The current db dir is moved aside until the checkpoint opens, and restored if it does not.
+     */
+    int RocksDBEngine::Restore(Context& ctx, const std::string& dir)
+    {
+        std::string old_dir = m_dbdir + ".old";
+        remove_db_dir(old_dir);
+        Close();
+        if (0 != rename(m_dbdir.c_str(), old_dir.c_str()) || 0 != rename(dir.c_str(), m_dbdir.c_str()))
+        {
+            ERROR_LOG("Failed to move checkpoint:%s to %s for reason:%s", dir.c_str(), m_dbdir.c_str(), strerror(errno));
+            if (!is_dir_exist(m_dbdir))
+            {
+                rename(old_dir.c_str(), m_dbdir.c_str());
+            }
+            ReOpen(m_options);
+            return -1;
+        }
+        if (0 != ReOpen(m_options))
+        {
+            rename(m_dbdir.c_str(), dir.c_str());
+            rename(old_dir.c_str(), m_dbdir.c_str());
+            ReOpen(m_options);
+            return -1;
+        }
+        remove_db_dir(old_dir);
+        INFO_LOG("RocksDB restored from checkpoint:%s", dir.c_str());
+        return 0;
+    }
+
     void RocksDBEngine::Stats(Context& ctx, std::string& all)
     {
         std::string str, version_info;
@@ -1201,6 +3809,18 @@ OP_NAMESPACE_BEGIN
         all.append(version_info);
         std::map<rocksdb::MemoryUtil::UsageType, uint64_t> usage_by_type;
         std::unordered_set<const rocksdb::Cache*> cache_set;
+        if (NULL != m_block_cache.get())
+        {
+            cache_set.insert(m_block_cache.get());
+        }
+        if (NULL != m_compressed_cache.get())
+        {
+            cache_set.insert(m_compressed_cache.get());
+        }
+        if (NULL != m_meta_cache.get())
+        {
+            cache_set.insert(m_meta_cache.get());
+        }
         std::vector<rocksdb::DB*> dbs(1, m_db);
         rocksdb::MemoryUtil::GetApproximateMemoryUsageByType(dbs, cache_set, &usage_by_type);
         for (size_t i = 0; i < rocksdb::MemoryUtil::kNumUsageTypes; ++i)
@@ -1238,17 +3858,77 @@ OP_NAMESPACE_BEGIN
                 all.append(name).append(":").append(stringfromll(usage_by_type[(rocksdb::MemoryUtil::UsageType) i])).append("\r\n");
             }
         }
+        if (NULL != m_options.statistics.get())
+        {
+            /*
+             * point lookups skipped by the whole key filter, and seeks checked/skipped by the prefix filter
+             */
+            rocksdb::Statistics* stats = m_options.statistics.get();
+            uint64 prefix_checked = stats->getTickerCount(rocksdb::BLOOM_FILTER_PREFIX_CHECKED);
+            uint64 prefix_useful = stats->getTickerCount(rocksdb::BLOOM_FILTER_PREFIX_USEFUL);
+            all.append("rocksdb_bloom_filter_useful:").append(stringfromll(stats->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL))).append("\r\n");
+            all.append("rocksdb_bloom_filter_prefix_checked:").append(stringfromll(prefix_checked)).append("\r\n");
+            all.append("rocksdb_bloom_filter_prefix_useful:").append(stringfromll(prefix_useful)).append("\r\n");
+            all.append("rocksdb_bloom_filter_prefix_miss:").append(stringfromll(prefix_checked - prefix_useful)).append("\r\n");
+            all.append("rocksdb_block_cache_filter_hit:").append(stringfromll(stats->getTickerCount(rocksdb::BLOCK_CACHE_FILTER_HIT))).append("\r\n");
+            all.append("rocksdb_block_cache_filter_miss:").append(stringfromll(stats->getTickerCount(rocksdb::BLOCK_CACHE_FILTER_MISS))).append("\r\n");
+            all.append("rocksdb_memtable_hit:").append(stringfromll(stats->getTickerCount(rocksdb::MEMTABLE_HIT))).append("\r\n");
+            RWLockGuard<SpinRWLock> guard(m_cache_stats_lock, false);
+            CacheStatsTable::iterator it = m_cache_stats.begin();
+            while (it != m_cache_stats.end())
+            {
+                uint64_t hits = it->second->hits;
+                uint64_t reads = it->second->reads;
+                char rate[64];
+                snprintf(rate, sizeof(rate), "%.2f", hits + reads > 0 ? hits * 100.0 / (hits + reads) : 0.0);
+                all.append("rocksdb_block_cache_db").append(it->first.AsString()).append(":hits=").append(stringfromll(hits)).append(",reads=").append(
+                        stringfromll(reads)).append(",hit_rate=").append(rate).append("%\r\n");
+                it++;
+            }
+        }
+        all.append("rocksdb_memtable_write_stalls:").append(stringfromll(m_write_stalls)).append("\r\n");
+        all.append("rocksdb_memtable_write_stall_millis:").append(stringfromll(m_write_stall_millis)).append("\r\n");
+        uint64 stall_start = m_stall_start_time;
+        all.append("rocksdb_write_stalled:").append(stall_start > 0 ? "1" : "0").append("\r\n");
+        all.append("rocksdb_write_stall_conditions:").append(stringfromll(m_stall_conditions)).append("\r\n");
+        all.append("rocksdb_write_stall_condition_millis:").append(
+                stringfromll(m_stall_condition_millis + (stall_start > 0 ? get_current_epoch_millis() - stall_start : 0))).append("\r\n");
+        all.append("rocksdb_blob_writes:").append(stringfromll(m_blob_writes)).append("\r\n");
+        all.append("rocksdb_blob_reads:").append(stringfromll(m_blob_reads)).append("\r\n");
+        all.append("rocksdb_blob_gc_drops:").append(stringfromll(m_blob_gc_drops)).append("\r\n");
+        all.append("rocksdb_expired_table_drops:").append(stringfromll(m_expired_table_drops)).append("\r\n");
+        all.append("rocksdb_expired_table_bytes:").append(stringfromll(m_expired_table_bytes)).append("\r\n");
+        all.append("rocksdb_tombstone_runs:").append(stringfromll(m_tombstone_runs)).append("\r\n");
+        all.append("rocksdb_tombstone_compactions:").append(stringfromll(m_tombstone_compactions)).append("\r\n");
+        {
+            LockGuard<SpinMutexLock> guard(m_tombstone_lock);
+            all.append("rocksdb_tombstone_queued_ranges:").append(stringfromll(m_tombstone_ranges.size())).append("\r\n");
+        }
         DataArray nss;
         ListNameSpaces(ctx, nss);
         for (size_t i = 0; i < nss.size(); i++)
         {
-            std::string cf_stat;
-            ColumnFamilyHandlePtr cfp = GetColumnFamilyHandle(ctx, nss[i], false);
-            rocksdb::ColumnFamilyHandle* cf = cfp.get();
-            if (NULL == cf)
-                continue;
-            m_db->GetProperty(cf, "rocksdb.stats", &cf_stat);
-            all.append(cf_stat).append("\r\n");
+            std::vector<ColumnFamilyHandlePtr> cfs;
+            GetColumnFamilyHandles(ctx, nss[i], cfs);
+            uint64_t memtable_size = 0;
+            for (size_t j = 0; j < cfs.size(); j++)
+            {
+                uint64_t size = 0;
+                m_db->GetIntProperty(cfs[j].get(), rocksdb::DB::Properties::kSizeAllMemTables, &size);
+                memtable_size += size;
+            }
+            all.append("rocksdb_memtable_db").append(nss[i].AsString()).append(":").append(stringfromll(memtable_size)).append("\r\n");
+        }
+        for (size_t i = 0; i < nss.size(); i++)
+        {
+            std::vector<ColumnFamilyHandlePtr> cfs;
+            GetColumnFamilyHandles(ctx, nss[i], cfs);
+            for (size_t j = 0; j < cfs.size(); j++)
+            {
+                std::string cf_stat;
+                m_db->GetProperty(cfs[j].get(), "rocksdb.stats", &cf_stat);
+                all.append(cf_stat).append("\r\n");
+            }
         }
     }
 
@@ -1260,21 +3940,123 @@ OP_NAMESPACE_BEGIN
     {
         m_key.Clear();
         m_value.Clear();
+        m_blob_loaded = false;
         m_valid = true;
     }
     void RocksDBIterator::CheckBound()
     {
-        if (NULL != m_iter && m_iterate_upper_bound_key.GetType() > 0)
+        if (NULL != m_iter && (m_iterate_upper_bound_key.GetType() > 0 || m_iterate_lower_bound_key.GetType() > 0))
         {
             if (m_iter->Valid())
             {
-                if (Key(false).Compare(m_iterate_upper_bound_key) >= 0)
+                KeyObject& current = Key(false);
+                if ((m_iterate_upper_bound_key.GetType() > 0 && current.Compare(m_iterate_upper_bound_key) >= 0)
+                        || (m_iterate_lower_bound_key.GetType() > 0 && current.Compare(m_iterate_lower_bound_key) < 0))
                 {
                     m_valid = false;
                 }
             }
         }
     }
+    /*
+     * Point m_iter to the valid child with the smallest(or largest) key, keys never repeat across column families.
+     */
+    void RocksDBIterator::SelectCurrent(bool smallest)
+    {
+        if (m_iters.size() < 2)
+        {
+            return;
+        }
+        const rocksdb::Comparator* cmp = m_engine->m_options.comparator;
+        size_t current = m_iters.size();
+        for (size_t i = 0; i < m_iters.size(); i++)
+        {
+            if (!m_iters[i]->Valid())
+            {
+                continue;
+            }
+            if (current == m_iters.size())
+            {
+                current = i;
+                continue;
+            }
+            int ret = cmp->Compare(m_iters[i]->key(), m_iters[current]->key());
+            if (smallest ? ret < 0 : ret > 0)
+            {
+                current = i;
+            }
+        }
+        if (current == m_iters.size())
+        {
+            current = 0;
+        }
+        m_iter = m_iters[current];
+        m_cf = m_cfs[current];
+        m_forward = smallest;
+    }
+    void RocksDBIterator::StartTombstoneRun(const rocksdb::Slice& start)
+    {
+        m_run_start.assign(start.data(), start.size());
+        m_run_skipped = 0;
+    }
+
+    /*
+     * The deleted entries skipped by the move are counted by the perf context of the thread.
+     */
+    void RocksDBIterator::CheckTombstoneRun(uint64_t skipped_before)
+    {
+        uint64_t skipped = rocksdb::perf_context.internal_delete_skipped_count - skipped_before;
+        if (0 == skipped)
+        {
+            return;
+        }
+        m_run_skipped += skipped;
+        int64 threshold = g_db->GetConf().rocksdb_tombstone_compact_threshold;
+        if (threshold <= 0 || m_run_skipped < (uint64_t) threshold)
+        {
+            return;
+        }
+        std::string current;
+        if (NULL != m_iter && m_iter->Valid())
+        {
+            current.assign(m_iter->key().data(), m_iter->key().size());
+        }
+        if (m_forward)
+        {
+            m_engine->QueueTombstoneRange(m_cfs, m_run_start, current, m_run_skipped);
+        }
+        else
+        {
+            m_engine->QueueTombstoneRange(m_cfs, current, m_run_start, m_run_skipped);
+        }
+        m_run_start = current;
+        m_run_skipped = 0;
+    }
+
+    void RocksDBIterator::SeekAll(const rocksdb::Slice& key)
+    {
+        for (size_t i = 0; i < m_iters.size(); i++)
+        {
+            m_iters[i]->Seek(key);
+        }
+        SelectCurrent(true);
+    }
+    void RocksDBIterator::SeekToFirstAll()
+    {
+        for (size_t i = 0; i < m_iters.size(); i++)
+        {
+            m_iters[i]->SeekToFirst();
+        }
+        SelectCurrent(true);
+    }
+    void RocksDBIterator::SeekToLastAll()
+    {
+        for (size_t i = 0; i < m_iters.size(); i++)
+        {
+            m_iters[i]->SeekToLast();
+        }
+        SelectCurrent(false);
+    }
     void RocksDBIterator::Next()
     {
         ClearState();
@@ -1282,8 +4064,25 @@ OP_NAMESPACE_BEGIN
         {
             return;
         }
+        RocksDBCacheStatsScope cache_stats(m_engine, m_ns);
+        if (!m_forward && m_iter->Valid())
+        {
+            /*
+             * other children are before the current key after moving backward, put them after it
+             */
+            for (size_t i = 0; i < m_iters.size(); i++)
+            {
+                if (m_iters[i] != m_iter)
+                {
+                    m_iters[i]->Seek(m_iter->key());
+                }
+            }
+        }
+        uint64_t skipped = rocksdb::perf_context.internal_delete_skipped_count;
         m_iter->Next();
+        SelectCurrent(true);
         CheckBound();
+        CheckTombstoneRun(skipped);
     }
     void RocksDBIterator::Prev()
     {
@@ -1292,7 +4091,33 @@ OP_NAMESPACE_BEGIN
         {
             return;
         }
+        RocksDBCacheStatsScope cache_stats(m_engine, m_ns);
+        if (m_forward && m_iters.size() > 1 && m_iter->Valid())
+        {
+            /*
+             * other children are after the current key while moving forward, put them before it
+             */
+            for (size_t i = 0; i < m_iters.size(); i++)
+            {
+                if (m_iters[i] != m_iter)
+                {
+                    m_iters[i]->Seek(m_iter->key());
+                    if (m_iters[i]->Valid())
+                    {
+                        m_iters[i]->Prev();
+                    }
+                    else
+                    {
+                        m_iters[i]->SeekToLast();
+                    }
+                }
+            }
+        }
+        uint64_t skipped = rocksdb::perf_context.internal_delete_skipped_count;
         m_iter->Prev();
+        SelectCurrent(false);
+        CheckBound();
+        CheckTombstoneRun(skipped);
     }
     void RocksDBIterator::Jump(const KeyObject& next)
     {
@@ -1301,10 +4126,16 @@ OP_NAMESPACE_BEGIN
         {
             return;
         }
-        RocksDBLocalContext& rocks_ctx = g_rocks_context.GetValue();
-        Slice key_slice = next.Encode(rocks_ctx.GetEncodeBuferCache(), false);
-        m_iter->Seek(to_rocksdb_slice(key_slice));
+        RocksDBLocalContext& rocks_ctx = m_engine->m_local_ctx.GetValue();
+        RocksDBCacheStatsScope cache_stats(m_engine, m_ns);
+        Slice key_slice = next.Encode(rocks_ctx.GetEncodeBufferCache(), false);
+        uint64_t skipped = rocksdb::perf_context.internal_delete_skipped_count;
+        ARDB_PROBE1(engine__seek__start, key_slice.size());
+        StartTombstoneRun(to_rocksdb_slice(key_slice));
+        SeekAll(to_rocksdb_slice(key_slice));
         CheckBound();
+        CheckTombstoneRun(skipped);
+        ARDB_PROBE1(engine__seek__done, Valid() ? 1 : 0);
     }
     void RocksDBIterator::JumpToFirst()
     {
@@ -1313,7 +4144,11 @@ OP_NAMESPACE_BEGIN
         {
             return;
         }
-        m_iter->SeekToFirst();
+        RocksDBCacheStatsScope cache_stats(m_engine, m_ns);
+        uint64_t skipped = rocksdb::perf_context.internal_delete_skipped_count;
+        StartTombstoneRun(rocksdb::Slice());
+        SeekToFirstAll();
+        CheckTombstoneRun(skipped);
     }
     void RocksDBIterator::JumpToLast()
     {
@@ -1327,7 +4162,8 @@ OP_NAMESPACE_BEGIN
             Jump(m_iterate_upper_bound_key);
             if (!m_iter->Valid())
             {
-                m_iter->SeekToLast();
+                SeekToLastAll();
+                CheckBound();
             }
             if (m_iter->Valid())
             {
@@ -1339,7 +4175,7 @@ OP_NAMESPACE_BEGIN
         }
         else
         {
-            m_iter->SeekToLast();
+            SeekToLastAll();
         }
     }
 
@@ -1365,32 +4201,84 @@ OP_NAMESPACE_BEGIN
         {
             return m_value;
         }
-        rocksdb::Slice key = m_iter->value();
+        rocksdb::Slice key = CurrentValue();
         Buffer kbuf(const_cast<char*>(key.data()), 0, key.size());
         m_value.Decode(kbuf, clone_str);
         return m_value;
     }
+    /*
+     * The blob is read by the snapshot of the iterator, a missing one(dropped after the reference was read) gives
+     * an empty value.
+     */
+    rocksdb::Slice RocksDBIterator::CurrentValue()
+    {
+        rocksdb::Slice value = m_iter->value();
+        if (!is_blob_ref(value))
+        {
+            return value;
+        }
+        if (!m_blob_loaded)
+        {
+            Context ctx;
+            rocksdb::ReadOptions opt;
+            opt.snapshot = m_snapshot;
+            if (0 != m_engine->ReadBlob(ctx, m_ns, opt, m_iter->key(), m_blob_value))
+            {
+                m_blob_value.clear();
+            }
+            m_blob_loaded = true;
+        }
+        return m_blob_value;
+    }
     Slice RocksDBIterator::RawKey()
     {
         return to_ardb_slice(m_iter->key());
     }
     Slice RocksDBIterator::RawValue()
     {
-        return to_ardb_slice(m_iter->value());
+        return to_ardb_slice(CurrentValue());
     }
     void RocksDBIterator::Del()
     {
         if (NULL != m_iter)
         {
             rocksdb::WriteOptions opt;
-            m_engine->m_db->Delete(opt, m_cf, m_iter->key());
+            Context ctx;
+            RocksDBEngine::ColumnFamilyHandlePtr blob_cfp;
+            if (is_blob_ref(m_iter->value()))
+            {
+                blob_cfp = m_engine->GetBlobColumnFamily(ctx, m_ns, false);
+            }
+            if (NULL != blob_cfp.get())
+            {
+                rocksdb::WriteBatch batch;
+                batch.Delete(m_cf, m_iter->key());
+                batch.Delete(blob_cfp.get(), m_iter->key());
+                m_engine->m_db->Write(opt, &batch);
+            }
+            else
+            {
+                m_engine->m_db->Delete(opt, m_cf, m_iter->key());
+            }
         }
 
     }
     RocksDBIterator::~RocksDBIterator()
     {
+        /*
+         * the snapshot outlives this iterator if the thread holds more refs of it, the next Find on it
+         * reuses the rocksdb iterators instead of creating new ones
+         */
+        RocksDBLocalContext& rocks_ctx = m_engine->m_local_ctx.GetValue();
+        bool reusable = NULL != m_snapshot && rocks_ctx.snapshot.snapshot == m_snapshot && rocks_ctx.snapshot.ref > 1;
+        for (size_t i = 0; i < m_iters.size(); i++)
+        {
+            if (!reusable || !rocks_ctx.ReturnIterator(m_cf_ids[i], m_snapshot, m_read_flags, m_iters[i]))
+            {
+                DELETE(m_iters[i]);
+            }
+        }
         m_engine->ReleaseSnpashot();
-        DELETE(m_iter);
     }
 OP_NAMESPACE_END
 
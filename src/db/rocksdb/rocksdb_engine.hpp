@@ -32,6 +32,7 @@
 
 #include "common/common.hpp"
 #include "thread/spin_rwlock.hpp"
+#include "thread/spin_mutex_lock.hpp"
 #include "thread/thread_local.hpp"
 #include "rocksdb/db.h"
 #include "rocksdb/write_batch.h"
@@ -42,12 +43,15 @@
 #include "rocksdb/merge_operator.h"
 #include "db/engine.hpp"
 #include <vector>
+#include <deque>
 #include <sparsehash/dense_hash_map>
 #include <memory>
 
 OP_NAMESPACE_BEGIN
 
     class RocksDBEngine;
+    class RocksGroupCommit;
+    class RocksBulkIngest;
     class RocksDBIterator: public Iterator
     {
         private:
@@ -55,28 +59,75 @@ OP_NAMESPACE_BEGIN
             KeyObject m_key;
             ValueObject m_value;
             RocksDBEngine* m_engine;
+            /*
+             * Iterators over several column families(per type layout) are merged in key order,
+             * m_cf & m_iter point to the one at the current position.
+             */
+            std::vector<rocksdb::ColumnFamilyHandle*> m_cfs;
+            std::vector<uint32_t> m_cf_ids;
+            std::vector<rocksdb::Iterator*> m_iters;
             rocksdb::ColumnFamilyHandle* m_cf;
             rocksdb::Iterator* m_iter;
+            KeyObject m_iterate_lower_bound_key;
             KeyObject m_iterate_upper_bound_key;
+            const rocksdb::Snapshot* m_snapshot;
+            uint8 m_read_flags;
             bool m_valid;
+            bool m_forward;
+            /*
+             * deleted entries skipped since the last seek(or the last queued run), a long run between
+             * 'm_run_start'(empty for the first/last key) and the current key is queued for compaction.
+             */
+            std::string m_run_start;
+            uint64_t m_run_skipped;
+            /*
+             * value of the current key read from the blob column family if it was moved there
+             */
+            std::string m_blob_value;
+            bool m_blob_loaded;
+            rocksdb::Slice CurrentValue();
+            void StartTombstoneRun(const rocksdb::Slice& start);
+            void CheckTombstoneRun(uint64_t skipped_before);
             void ClearState();
             void CheckBound();
+            void SelectCurrent(bool smallest);
+            void SeekAll(const rocksdb::Slice& key);
+            void SeekToFirstAll();
+            void SeekToLastAll();
         public:
-            RocksDBIterator(RocksDBEngine* engine, rocksdb::ColumnFamilyHandle* cf, const Data& ns) :
-                    m_ns(ns), m_engine(engine),m_cf(cf), m_iter(NULL), m_valid(true)
+            RocksDBIterator(RocksDBEngine* engine, const Data& ns) :
+                    m_ns(ns), m_engine(engine), m_cf(NULL), m_iter(NULL), m_snapshot(NULL), m_read_flags(0), m_valid(true), m_forward(true), m_run_skipped(0), m_blob_loaded(false)
             {
             }
+            /*
+             * The iterators are parked for reuse on destruction if 'snapshot' is still held by the thread.
+             */
+            void SetReadOptions(const rocksdb::Snapshot* snapshot, uint8 read_flags)
+            {
+                m_snapshot = snapshot;
+                m_read_flags = read_flags;
+            }
             void MarkValid(bool valid)
             {
                 m_valid = valid;
             }
-            void SetIterator(rocksdb::Iterator* iter)
+            void AddIterator(rocksdb::ColumnFamilyHandle* cf, rocksdb::Iterator* iter)
             {
-                m_iter = iter;
+                m_cfs.push_back(cf);
+                m_cf_ids.push_back(cf->GetID());
+                m_iters.push_back(iter);
+                if (NULL == m_iter)
+                {
+                    m_cf = cf;
+                    m_iter = iter;
+                }
             }
-            KeyObject& IterateUpperBoundKey()
+            void SetIterateBounds(const IterateOptions& options)
             {
-                return m_iterate_upper_bound_key;
+                m_iterate_lower_bound_key = options.lower_bound;
+                m_iterate_lower_bound_key.CloneStringPart();
+                m_iterate_upper_bound_key = options.upper_bound;
+                m_iterate_upper_bound_key.CloneStringPart();
             }
             bool Valid();
             void Next();
@@ -93,19 +144,112 @@ OP_NAMESPACE_BEGIN
     };
 
     class RocksDBCompactionFilter;
+    class RocksDBBlobCompactionFilter;
+    struct RocksDBCacheStatsScope;
+    struct RocksDBLocalContext;
     class RocksDBEngine: public Engine
     {
         private:
             typedef std::shared_ptr<rocksdb::ColumnFamilyHandle> ColumnFamilyHandlePtr;
             typedef TreeMap<Data, ColumnFamilyHandlePtr>::Type ColumnFamilyHandleTable;
             typedef TreeMap<uint32_t, Data>::Type ColumnFamilyHandleIDTable;
+            struct CacheStats
+            {
+                    volatile uint64_t hits;
+                    volatile uint64_t reads;
+                    CacheStats() :
+                            hits(0), reads(0)
+                    {
+                    }
+            };
+            typedef TreeMap<Data, CacheStats*>::Type CacheStatsTable;
             rocksdb::DB* m_db;
             rocksdb::Options m_options;
+            /*
+             * write batch, snapshot & parked iterators of the calling thread, per instance as several engines
+             * could be open in one process(engine-shards)
+             */
+            ThreadLocal<RocksDBLocalContext> m_local_ctx;
             std::string m_dbdir;
-            ColumnFamilyHandleTable m_handlers;
+            ColumnFamilyHandleTable m_handlers; //keyed by column family name
+            std::vector<ColumnFamilyHandlePtr> m_detached_handlers; //dropped column families, their files go once released
+            SpinMutexLock m_detached_lock;
+            /*
+             * column families moved in place of another namespace by SwapNameSpace, keyed by their own name and valued by
+             * the name they serve, rocksdb can not rename a column family so the map is kept in the data dir(cf_aliases)
+             */
+            StringStringMap m_cf_aliases;
+            std::string ColumnFamilyName(rocksdb::ColumnFamilyHandle* cf);
+            void LoadColumnFamilyAliases();
+            int SaveColumnFamilyAliases(const std::string& dir, const StringStringMap& aliases);
+            bool ForgetColumnFamilyAlias(rocksdb::ColumnFamilyHandle* cf);
+            struct TombstoneRange
+            {
+                    std::string cf;
+                    std::string lower; //empty for unbounded
+                    std::string upper;
+            };
+            std::deque<TombstoneRange> m_tombstone_ranges; //queued by iterators, compacted by CompactQueuedRanges
+            SpinMutexLock m_tombstone_lock;
+            volatile uint64_t m_tombstone_runs;
+            volatile uint64_t m_tombstone_compactions;
+            void QueueTombstoneRange(const std::vector<rocksdb::ColumnFamilyHandle*>& cfs, const std::string& lower, const std::string& upper, uint64_t skipped);
+            std::shared_ptr<rocksdb::Cache> m_meta_cache;
+            std::shared_ptr<rocksdb::Cache> m_block_cache;
+            std::shared_ptr<rocksdb::Cache> m_compressed_cache;
+            CacheStatsTable m_cache_stats; //block cache hits & reads per namespace
+            SpinRWLock m_cache_stats_lock;
+            volatile uint64_t m_memtable_usage;
+            volatile uint64_t m_memtable_check_time;
+            volatile uint64_t m_write_stalls;
+            volatile uint64_t m_write_stall_millis;
+            /*
+             * stall conditions of rocksdb sampled at most once per 10ms by IsWriteStalled
+             */
+            volatile uint64_t m_stall_check_time;
+            volatile uint64_t m_stall_start_time; //0 out of a stall
+            volatile uint64_t m_stall_conditions;
+            volatile uint64_t m_stall_condition_millis;
+            bool CheckStallConditions();
             SpinRWLock m_lock;
+            RocksGroupCommit* m_group_commit;
+            RocksBulkIngest* m_ingest;
+            bool m_ingest_load;
+            bool m_sync_wal;
+            bool m_read_only; //opened on the data dir of another instance by 'rocksdb-read-replica-of'
+            volatile uint32_t m_shared_snapshots; //a refresh reopens the db, not possible while any is held
+            bool m_cf_per_type;
+            /*
+             * meta values of at least this size in the blob namespaces(all user dbs if none configured) are kept in
+             * the namespace's blob column family, 0 to disable.
+             */
+            int64 m_blob_min_size;
+            StringTreeSet m_blob_namespaces;
+            volatile uint64_t m_blob_writes;
+            volatile uint64_t m_blob_reads;
+            volatile uint64_t m_blob_gc_drops;
+            /*
+             * namespaces whose meta column families use the ttl compaction style, their tables record key expiry
+             * so that fully expired tables could be deleted without compaction.
+             */
+            StringTreeSet m_ttl_namespaces;
+            volatile uint64_t m_expired_table_drops;
+            volatile uint64_t m_expired_table_bytes;
 
             ColumnFamilyHandlePtr GetColumnFamilyHandle(Context& ctx, const Data& name, bool create_if_noexist);
+            ColumnFamilyHandlePtr GetColumnFamilyHandle(Context& ctx, const Data& ns, int kind, bool create_if_noexist);
+            void GetColumnFamilyHandles(Context& ctx, const Data& ns, std::vector<ColumnFamilyHandlePtr>& cfs);
+            void GetIterateColumnFamilies(Context& ctx, const KeyObject& key, const IterateOptions& options, std::vector<ColumnFamilyHandlePtr>& cfs);
+            rocksdb::ColumnFamilyOptions GetColumnFamilyOptions(const std::string& cf_name, bool ttl_style);
+            int GetColumnFamilyKind(uint8 key_type);
+            bool IsBlobNameSpace(const Data& ns);
+            ColumnFamilyHandlePtr GetBlobColumnFamily(Context& ctx, const Data& ns, bool create_if_noexist);
+            rocksdb::Status WriteMetaValue(const rocksdb::WriteOptions& opt, rocksdb::WriteBatch* batch, rocksdb::ColumnFamilyHandle* cf,
+                    rocksdb::ColumnFamilyHandle* blob_cf, const rocksdb::Slice& key, const rocksdb::Slice& value);
+            int ReadBlob(Context& ctx, const Data& ns, const rocksdb::ReadOptions& opt, const rocksdb::Slice& key, std::string& value);
+            void AddCacheStats(const Data& ns, uint64_t hits, uint64_t reads);
+            void WaitMemtableLimit();
+            void FlushLargestMemtable();
             const rocksdb::Snapshot* GetSnpashot();
 
             void ReleaseSnpashot();
@@ -114,6 +258,8 @@ OP_NAMESPACE_BEGIN
             void Close();
             friend class RocksDBIterator;
             friend class RocksDBCompactionFilter;
+            friend class RocksDBBlobCompactionFilter;
+            friend struct RocksDBCacheStatsScope;
         public:
             RocksDBEngine();
             ~RocksDBEngine();
@@ -129,22 +275,47 @@ OP_NAMESPACE_BEGIN
             int BeginWriteBatch(Context& ctx);
             int CommitWriteBatch(Context& ctx);
             int DiscardWriteBatch(Context& ctx);
+            int BeginSnapshotRead(Context& ctx);
+            int EndSnapshotRead(Context& ctx);
+            const void* CreateSharedSnapshot(Context& ctx);
+            int BeginSharedSnapshotRead(Context& ctx, const void* snapshot);
+            void ReleaseSharedSnapshot(Context& ctx, const void* snapshot);
             int Compact(Context& ctx, const KeyObject& start, const KeyObject& end);
+            int CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress);
+            int CompactQueuedRanges(Context& ctx);
+            int DropExpiredTables(Context& ctx);
+            uint64_t GetThreadSkippedDeletes();
             int ListNameSpaces(Context& ctx, DataArray& nss);
             int DropNameSpace(Context& ctx, const Data& ns);
+            int DetachNameSpace(Context& ctx, const Data& ns);
+            int SwapNameSpace(Context& ctx, const Data& ns, const Data& from);
+            int Refresh(Context& ctx);
+            int ReclaimDetachedNameSpaces(Context& ctx);
             void Stats(Context& ctx, std::string& str);
             int64_t EstimateKeysNum(Context& ctx, const Data& ns);
-            Iterator* Find(Context& ctx, const KeyObject& key);
+            int64_t GetLatestSequence();
+            int Checkpoint(Context& ctx, const std::string& dir);
+            int SetOption(Context& ctx, const std::string& name, const std::string& value);
+            bool IsWriteStalled();
+            int Restore(Context& ctx, const std::string& dir);
+            using Engine::Find;
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
             int Flush(Context& ctx, const Data& ns);
             int BeginBulkLoad(Context& ctx);
             int EndBulkLoad(Context& ctx);
+            int BeginBulkIngest(Context& ctx, const Data& ns);
+            int EndBulkIngest(Context& ctx, const Data& ns, bool abort);
             const std::string GetErrorReason(int err);
             const FeatureSet GetFeatureSet()
             {
                 FeatureSet features;
                 features.support_compactfilter = 1;
                 features.support_namespace = 1;
-                features.support_merge = 1;
+                features.support_snapshot_read = 1;
+                features.support_merge = m_blob_min_size > 0 ? 0 : 1; //a merge could not see a value moved to its blob
+                features.support_nested_write_batch = 1;
+                features.support_checkpoint = 1;
+                features.support_swap_namespace = 1;
                 return features;
             }
     };
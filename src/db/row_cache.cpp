@@ -0,0 +1,754 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "row_cache.hpp"
+#include "thread/lock_guard.hpp"
+#include "util/atomic.hpp"
+#include "util/murmur3.h"
+#include <algorithm>
+
+OP_NAMESPACE_BEGIN
+
+    /*
+     * map node & bookkeeping bytes accounted per entry besides its key & value
+     */
+    static const uint64 kRowCacheEntryOverhead = 96;
+
+    RowCache::RowCache() :
+            m_shard_capacity(0), m_admit_reads(1)
+    {
+    }
+
+    void RowCache::SetCapacity(uint64 bytes)
+    {
+        m_shard_capacity = bytes / kShards;
+    }
+
+    RowCache::Shard& RowCache::GetShard(const std::string& owner)
+    {
+        uint32 hash = 0;
+        MurmurHash3_x86_32(owner.data(), owner.size(), 0, &hash);
+        return m_shards[hash % kShards];
+    }
+
+    void RowCache::Erase(Shard& shard, uint32 slot)
+    {
+        Entry& entry = shard.entries[slot];
+        shard.index.erase(entry.key);
+        if (!entry.owner.empty())
+        {
+            OwnerIndex::iterator found = shard.owners.find(entry.owner);
+            if (found != shard.owners.end())
+            {
+                std::vector<uint32>& slots = found->second;
+                slots.erase(std::remove(slots.begin(), slots.end(), slot), slots.end());
+                if (slots.empty())
+                {
+                    shard.owners.erase(found);
+                }
+            }
+        }
+        shard.bytes -= entry.key.size() + entry.owner.size() + entry.value.size() + kRowCacheEntryOverhead;
+        entry.key.clear();
+        entry.owner.clear();
+        entry.value.clear();
+        entry.referenced = false;
+        entry.used = false;
+        shard.free_slots.push_back(slot);
+    }
+
+    bool RowCache::Get(const std::string& owner, const std::string& key, std::string& value)
+    {
+        Shard& shard = GetShard(owner);
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        EntryIndex::iterator found = shard.index.find(key);
+        if (found == shard.index.end())
+        {
+            return false;
+        }
+        Entry& entry = shard.entries[found->second];
+        entry.referenced = true;
+        value = entry.value;
+        return true;
+    }
+
+    uint64 RowCache::GetVersion(const std::string& owner)
+    {
+        Shard& shard = GetShard(owner);
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        return shard.version;
+    }
+
+    bool RowCache::Admit(const std::string& owner, const std::string& key)
+    {
+        uint32 admit_reads = m_admit_reads;
+        if (admit_reads <= 1)
+        {
+            return true;
+        }
+        uint32 h1 = 0, h2 = 0;
+        MurmurHash3_x86_32(key.data(), key.size(), 0x9747b28c, &h1);
+        MurmurHash3_x86_32(key.data(), key.size(), 0x5bd1e995, &h2);
+        Shard& shard = GetShard(owner);
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        if (shard.freq.empty())
+        {
+            shard.freq.resize(kFreqCounters);
+        }
+        uint8& c1 = shard.freq[h1 % kFreqCounters];
+        uint8& c2 = shard.freq[h2 % kFreqCounters];
+        if (c1 < 15)
+        {
+            c1++;
+        }
+        if (c2 < 15)
+        {
+            c2++;
+        }
+        uint32 count = c1 < c2 ? c1 : c2;
+        /*
+         * aging: halve all counters once the sketch saw 8 misses per counter, old hot keys fade out
+         */
+        if (++shard.freq_adds >= kFreqCounters * 8)
+        {
+            for (uint32 i = 0; i < kFreqCounters; i++)
+            {
+                shard.freq[i] >>= 1;
+            }
+            shard.freq_adds = 0;
+        }
+        return count >= admit_reads;
+    }
+
+    void RowCache::Put(const std::string& owner, const std::string& key, const std::string& value, uint64 version)
+    {
+        bool owned = owner != key;
+        uint64 size = key.size() + (owned ? owner.size() : 0) + value.size() + kRowCacheEntryOverhead;
+        uint64 capacity = m_shard_capacity;
+        if (size > capacity)
+        {
+            return;
+        }
+        Shard& shard = GetShard(owner);
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        if (shard.version != version || shard.index.find(key) != shard.index.end())
+        {
+            return;
+        }
+        /*
+         * CLOCK: sweep from the hand, a referenced entry gets a second chance
+         */
+        while (shard.bytes + size > capacity && shard.bytes > 0)
+        {
+            if (shard.hand >= shard.entries.size())
+            {
+                shard.hand = 0;
+            }
+            Entry& entry = shard.entries[shard.hand];
+            if (entry.used)
+            {
+                if (entry.referenced)
+                {
+                    entry.referenced = false;
+                }
+                else
+                {
+                    Erase(shard, shard.hand);
+                }
+            }
+            shard.hand++;
+        }
+        uint32 slot = 0;
+        if (!shard.free_slots.empty())
+        {
+            slot = shard.free_slots.back();
+            shard.free_slots.pop_back();
+        }
+        else
+        {
+            slot = shard.entries.size();
+            shard.entries.resize(slot + 1);
+        }
+        Entry& entry = shard.entries[slot];
+        entry.key = key;
+        if (owned)
+        {
+            entry.owner = owner;
+            shard.owners[owner].push_back(slot);
+        }
+        entry.value = value;
+        entry.used = true;
+        entry.referenced = false;
+        shard.index[key] = slot;
+        shard.bytes += size;
+    }
+
+    void RowCache::Invalidate(const std::string& owner, const std::string& key)
+    {
+        Shard& shard = GetShard(owner);
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        shard.version++;
+        EntryIndex::iterator found = shard.index.find(key);
+        if (found != shard.index.end())
+        {
+            Erase(shard, found->second);
+        }
+    }
+
+    void RowCache::InvalidateOwner(const std::string& owner)
+    {
+        Shard& shard = GetShard(owner);
+        LockGuard<SpinMutexLock> guard(shard.lock);
+        shard.version++;
+        EntryIndex::iterator found = shard.index.find(owner);
+        if (found != shard.index.end())
+        {
+            Erase(shard, found->second);
+        }
+        OwnerIndex::iterator owned = shard.owners.find(owner);
+        if (owned != shard.owners.end())
+        {
+            std::vector<uint32> slots = owned->second;
+            for (size_t i = 0; i < slots.size(); i++)
+            {
+                Erase(shard, slots[i]);
+            }
+        }
+    }
+
+    void RowCache::Clear()
+    {
+        for (uint32 i = 0; i < kShards; i++)
+        {
+            Shard& shard = m_shards[i];
+            LockGuard<SpinMutexLock> guard(shard.lock);
+            shard.version++;
+            shard.index.clear();
+            shard.owners.clear();
+            shard.entries.clear();
+            shard.free_slots.clear();
+            shard.hand = 0;
+            shard.bytes = 0;
+        }
+    }
+
+    uint64 RowCache::Memory()
+    {
+        uint64 bytes = 0;
+        for (uint32 i = 0; i < kShards; i++)
+        {
+            LockGuard<SpinMutexLock> guard(m_shards[i].lock);
+            bytes += m_shards[i].bytes;
+        }
+        return bytes;
+    }
+
+    /*
+     * Deletes at the iterator position invalidate the deleted key.
+     */
+    class CachedIterator: public Iterator
+    {
+        private:
+            CachedEngine* m_engine;
+            Iterator* m_iter;
+        public:
+            CachedIterator(CachedEngine* engine, Iterator* iter) :
+                    m_engine(engine), m_iter(iter)
+            {
+            }
+            bool Valid()
+            {
+                return m_iter->Valid();
+            }
+            void Next()
+            {
+                m_iter->Next();
+            }
+            void Prev()
+            {
+                m_iter->Prev();
+            }
+            void Jump(const KeyObject& next)
+            {
+                m_iter->Jump(next);
+            }
+            void JumpToFirst()
+            {
+                m_iter->JumpToFirst();
+            }
+            void JumpToLast()
+            {
+                m_iter->JumpToLast();
+            }
+            KeyObject& Key(bool clone_str)
+            {
+                return m_iter->Key(clone_str);
+            }
+            Slice RawKey()
+            {
+                return m_iter->RawKey();
+            }
+            Slice RawValue()
+            {
+                return m_iter->RawValue();
+            }
+            ValueObject& Value(bool clone_str)
+            {
+                return m_iter->Value(clone_str);
+            }
+            void Del()
+            {
+                KeyObject& key = m_iter->Key(false);
+                m_engine->Invalidate(key);
+                m_iter->Del();
+                m_engine->Invalidate(key);
+            }
+            ~CachedIterator()
+            {
+                DELETE(m_iter);
+            }
+    };
+
+    CachedEngine::CachedEngine(Engine* engine, uint64 capacity, uint64 max_value_size, bool cache_elements, uint32 admit_reads) :
+            m_engine(engine), m_max_value_size(max_value_size), m_cache_elements(cache_elements), m_open_batches(0), m_hits(0), m_misses(
+                    0), m_element_hits(0), m_rejects(0)
+    {
+        m_cache.SetCapacity(capacity);
+        m_cache.SetAdmitReads(admit_reads);
+    }
+    bool CachedEngine::Cacheable(Context& ctx, const KeyObject& key)
+    {
+        /*
+         * reads under a snapshot may see older values than the cached ones
+         */
+        return (key.GetType() == KEY_META || m_cache_elements) && !ctx.flags.snapshot_read;
+    }
+    void CachedEngine::CacheKey(const KeyObject& key, std::string& ck, std::string& owner)
+    {
+        Buffer buffer;
+        key.Encode(buffer, false, true);
+        ck.assign(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+        if (key.GetType() == KEY_META || key.GetObjectId() > 0)
+        {
+            owner = ck;
+            return;
+        }
+        KeyObject meta(key.GetNameSpace(), KEY_META, key.GetKey());
+        Buffer meta_buffer;
+        meta.Encode(meta_buffer, false, true);
+        owner.assign(meta_buffer.GetRawReadBuffer(), meta_buffer.ReadableBytes());
+    }
+    void CachedEngine::Fill(const std::string& owner, const std::string& ck, const ValueObject& value, uint64 version)
+    {
+        if (m_open_batches > 0)
+        {
+            return;
+        }
+        Buffer buffer;
+        value.Encode(buffer);
+        if (buffer.ReadableBytes() > m_max_value_size)
+        {
+            return;
+        }
+        m_cache.Put(owner, ck, std::string(buffer.GetRawReadBuffer(), buffer.ReadableBytes()), version);
+    }
+    void CachedEngine::Invalidate(const KeyObject& key)
+    {
+        if (key.GetType() != KEY_META && !m_cache_elements)
+        {
+            return;
+        }
+        std::string ck, owner;
+        CacheKey(key, ck, owner);
+        if (key.GetType() == KEY_META)
+        {
+            m_cache.InvalidateOwner(owner);
+        }
+        else
+        {
+            m_cache.Invalidate(owner, ck);
+        }
+    }
+    int CachedEngine::Init(const std::string& dir, const std::string& options)
+    {
+        return m_engine->Init(dir, options);
+    }
+    int CachedEngine::Repair(const std::string& dir)
+    {
+        return m_engine->Repair(dir);
+    }
+    int CachedEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
+    {
+        int err = m_engine->PutRaw(ctx, ns, key, value);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::Put(Context& ctx, const KeyObject& key, const ValueObject& value)
+    {
+        int err = m_engine->Put(ctx, key, value);
+        Invalidate(key);
+        return err;
+    }
+    int CachedEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
+    {
+        if (!Cacheable(ctx, key))
+        {
+            return m_engine->Get(ctx, key, value);
+        }
+        std::string ck, owner, cv;
+        CacheKey(key, ck, owner);
+        if (m_cache.Get(owner, ck, cv))
+        {
+            Buffer buffer(const_cast<char*>(cv.data()), 0, cv.size());
+            if (value.Decode(buffer, true))
+            {
+                atomic_add_uint64(&m_hits, 1);
+                if (key.GetType() != KEY_META)
+                {
+                    atomic_add_uint64(&m_element_hits, 1);
+                }
+                return 0;
+            }
+        }
+        atomic_add_uint64(&m_misses, 1);
+        uint64 version = m_cache.GetVersion(owner);
+        bool fill = 0 == m_open_batches && m_cache.Admit(owner, ck);
+        if (!fill)
+        {
+            atomic_add_uint64(&m_rejects, 1);
+        }
+        int err = m_engine->Get(ctx, key, value);
+        if (0 == err && fill)
+        {
+            Fill(owner, ck, value, version);
+        }
+        return err;
+    }
+    int CachedEngine::Del(Context& ctx, const KeyObject& key)
+    {
+        int err = m_engine->Del(ctx, key);
+        Invalidate(key);
+        return err;
+    }
+    int CachedEngine::MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs)
+    {
+        values.resize(keys.size());
+        errs.assign(keys.size(), 0);
+        KeyObjectArray miss_keys;
+        std::vector<size_t> miss_idxs;
+        StringArray cks(keys.size()), owners(keys.size());
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            std::string cv;
+            if (Cacheable(ctx, keys[i]))
+            {
+                CacheKey(keys[i], cks[i], owners[i]);
+                if (m_cache.Get(owners[i], cks[i], cv))
+                {
+                    Buffer buffer(const_cast<char*>(cv.data()), 0, cv.size());
+                    if (values[i].Decode(buffer, true))
+                    {
+                        atomic_add_uint64(&m_hits, 1);
+                        if (keys[i].GetType() != KEY_META)
+                        {
+                            atomic_add_uint64(&m_element_hits, 1);
+                        }
+                        continue;
+                    }
+                }
+                atomic_add_uint64(&m_misses, 1);
+                if (!m_cache.Admit(owners[i], cks[i]))
+                {
+                    /*
+                     * not read often enough yet, looked up but not filled
+                     */
+                    atomic_add_uint64(&m_rejects, 1);
+                    cks[i].clear();
+                }
+            }
+            miss_keys.push_back(keys[i]);
+            miss_idxs.push_back(i);
+        }
+        if (miss_keys.empty())
+        {
+            return 0;
+        }
+        std::vector<uint64> versions(miss_keys.size(), 0);
+        for (size_t i = 0; i < miss_keys.size(); i++)
+        {
+            if (!cks[miss_idxs[i]].empty())
+            {
+                versions[i] = m_cache.GetVersion(owners[miss_idxs[i]]);
+            }
+        }
+        bool fill = 0 == m_open_batches;
+        ValueObjectArray miss_values;
+        ErrCodeArray miss_errs;
+        int err = m_engine->MultiGet(ctx, miss_keys, miss_values, miss_errs);
+        if (0 != err)
+        {
+            return err;
+        }
+        for (size_t i = 0; i < miss_keys.size(); i++)
+        {
+            size_t idx = miss_idxs[i];
+            values[idx] = miss_values[i];
+            errs[idx] = i < miss_errs.size() ? miss_errs[i] : 0;
+            if (fill && 0 == errs[idx] && !cks[idx].empty())
+            {
+                Fill(owners[idx], cks[idx], values[idx], versions[i]);
+            }
+        }
+        return 0;
+    }
+    int CachedEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values)
+    {
+        int err = m_engine->Merge(ctx, key, op, values);
+        Invalidate(key);
+        return err;
+    }
+    bool CachedEngine::Exists(Context& ctx, const KeyObject& key)
+    {
+        if (Cacheable(ctx, key))
+        {
+            std::string ck, owner, cv;
+            CacheKey(key, ck, owner);
+            if (m_cache.Get(owner, ck, cv))
+            {
+                atomic_add_uint64(&m_hits, 1);
+                return true;
+            }
+        }
+        return m_engine->Exists(ctx, key);
+    }
+    int CachedEngine::DelRange(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        int err = m_engine->DelRange(ctx, start, end);
+        m_cache.Clear();
+        return err;
+    }
+    Iterator* CachedEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
+    {
+        Iterator* iter = m_engine->Find(ctx, key, options);
+        if (NULL == iter)
+        {
+            return NULL;
+        }
+        Iterator* cached = NULL;
+        NEW(cached, CachedIterator(this, iter));
+        return cached;
+    }
+    int CachedEngine::Compact(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        return m_engine->Compact(ctx, start, end);
+    }
+    int CachedEngine::CompactAll(Context& ctx)
+    {
+        return m_engine->CompactAll(ctx);
+    }
+    int CachedEngine::CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress)
+    {
+        return m_engine->CompactDeleted(ctx, ns, min_deleted_percent, progress);
+    }
+    int CachedEngine::CompactQueuedRanges(Context& ctx)
+    {
+        return m_engine->CompactQueuedRanges(ctx);
+    }
+    int CachedEngine::DropExpiredTables(Context& ctx)
+    {
+        return m_engine->DropExpiredTables(ctx);
+    }
+    uint64_t CachedEngine::GetThreadSkippedDeletes()
+    {
+        return m_engine->GetThreadSkippedDeletes();
+    }
+    int CachedEngine::FlushPendingWrites(Context& ctx)
+    {
+        return m_engine->FlushPendingWrites(ctx);
+    }
+    int CachedEngine::BeginWriteBatch(Context& ctx)
+    {
+        atomic_add_uint32(&m_open_batches, 1);
+        int err = m_engine->BeginWriteBatch(ctx);
+        if (0 != err)
+        {
+            atomic_sub_uint32(&m_open_batches, 1);
+        }
+        return err;
+    }
+    int CachedEngine::CommitWriteBatch(Context& ctx)
+    {
+        int err = m_engine->CommitWriteBatch(ctx);
+        atomic_sub_uint32(&m_open_batches, 1);
+        return err;
+    }
+    int CachedEngine::DiscardWriteBatch(Context& ctx)
+    {
+        int err = m_engine->DiscardWriteBatch(ctx);
+        atomic_sub_uint32(&m_open_batches, 1);
+        return err;
+    }
+    int CachedEngine::ListNameSpaces(Context& ctx, DataArray& nss)
+    {
+        return m_engine->ListNameSpaces(ctx, nss);
+    }
+    int CachedEngine::DropNameSpace(Context& ctx, const Data& ns)
+    {
+        int err = m_engine->DropNameSpace(ctx, ns);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::DetachNameSpace(Context& ctx, const Data& ns)
+    {
+        int err = m_engine->DetachNameSpace(ctx, ns);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::SwapNameSpace(Context& ctx, const Data& ns, const Data& from)
+    {
+        int err = m_engine->SwapNameSpace(ctx, ns, from);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::Refresh(Context& ctx)
+    {
+        int err = m_engine->Refresh(ctx);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::ReclaimDetachedNameSpaces(Context& ctx)
+    {
+        return m_engine->ReclaimDetachedNameSpaces(ctx);
+    }
+    int CachedEngine::Flush(Context& ctx, const Data& ns)
+    {
+        int err = m_engine->Flush(ctx, ns);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::FlushAll(Context& ctx)
+    {
+        int err = m_engine->FlushAll(ctx);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::BeginBulkLoad(Context& ctx)
+    {
+        m_cache.Clear();
+        return m_engine->BeginBulkLoad(ctx);
+    }
+    int CachedEngine::BeginSnapshotRead(Context& ctx)
+    {
+        return m_engine->BeginSnapshotRead(ctx);
+    }
+    int CachedEngine::EndSnapshotRead(Context& ctx)
+    {
+        return m_engine->EndSnapshotRead(ctx);
+    }
+    const void* CachedEngine::CreateSharedSnapshot(Context& ctx)
+    {
+        return m_engine->CreateSharedSnapshot(ctx);
+    }
+    int CachedEngine::BeginSharedSnapshotRead(Context& ctx, const void* snapshot)
+    {
+        return m_engine->BeginSharedSnapshotRead(ctx, snapshot);
+    }
+    void CachedEngine::ReleaseSharedSnapshot(Context& ctx, const void* snapshot)
+    {
+        m_engine->ReleaseSharedSnapshot(ctx, snapshot);
+    }
+    int CachedEngine::EndBulkLoad(Context& ctx)
+    {
+        int err = m_engine->EndBulkLoad(ctx);
+        m_cache.Clear();
+        return err;
+    }
+    int64_t CachedEngine::EstimateKeysNum(Context& ctx, const Data& ns)
+    {
+        return m_engine->EstimateKeysNum(ctx, ns);
+    }
+    int64_t CachedEngine::GetLatestSequence()
+    {
+        return m_engine->GetLatestSequence();
+    }
+    int CachedEngine::Checkpoint(Context& ctx, const std::string& dir)
+    {
+        return m_engine->Checkpoint(ctx, dir);
+    }
+    int CachedEngine::SetOption(Context& ctx, const std::string& name, const std::string& value)
+    {
+        return m_engine->SetOption(ctx, name, value);
+    }
+    bool CachedEngine::IsWriteStalled()
+    {
+        return m_engine->IsWriteStalled();
+    }
+    int CachedEngine::Restore(Context& ctx, const std::string& dir)
+    {
+        int err = m_engine->Restore(ctx, dir);
+        m_cache.Clear();
+        return err;
+    }
+    int CachedEngine::BeginBulkIngest(Context& ctx, const Data& ns)
+    {
+        return m_engine->BeginBulkIngest(ctx, ns);
+    }
+    int CachedEngine::EndBulkIngest(Context& ctx, const Data& ns, bool abort)
+    {
+        int err = m_engine->EndBulkIngest(ctx, ns, abort);
+        m_cache.Clear();
+        return err;
+    }
+    void CachedEngine::Stats(Context& ctx, std::string& str)
+    {
+        uint64 hits = m_hits, misses = m_misses;
+        str.append("row_cache_size:").append(stringfromll(m_cache.GetCapacity())).append("\r\n");
+        str.append("row_cache_used_memory:").append(stringfromll(m_cache.Memory())).append("\r\n");
+        str.append("row_cache_hits:").append(stringfromll(hits)).append("\r\n");
+        str.append("row_cache_misses:").append(stringfromll(misses)).append("\r\n");
+        str.append("row_cache_element_hits:").append(stringfromll(m_element_hits)).append("\r\n");
+        str.append("row_cache_admission_rejects:").append(stringfromll(m_rejects)).append("\r\n");
+        char ratio[32];
+        snprintf(ratio, sizeof(ratio), "%.4f", hits + misses > 0 ? (double) hits / (hits + misses) : 0.0);
+        str.append("row_cache_hit_ratio:").append(ratio).append("\r\n");
+        m_engine->Stats(ctx, str);
+    }
+    const std::string CachedEngine::GetErrorReason(int err)
+    {
+        return m_engine->GetErrorReason(err);
+    }
+    const FeatureSet CachedEngine::GetFeatureSet()
+    {
+        return m_engine->GetFeatureSet();
+    }
+    CachedEngine::~CachedEngine()
+    {
+        DELETE(m_engine);
+    }
+
+OP_NAMESPACE_END
@@ -0,0 +1,200 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_DB_ROW_CACHE_HPP_
+#define SRC_DB_ROW_CACHE_HPP_
+
+#include "engine.hpp"
+#include "thread/spin_mutex_lock.hpp"
+#include <sparsehash/dense_hash_map>
+
+OP_NAMESPACE_BEGIN
+
+    /*
+     * Sharded map of encoded keys to encoded values, evicted by CLOCK: a hit sets the referenced bit of its entry, the
+     * hand clears set bits & evicts the first entry found without one.
+     * Entries live in the shard of their owner, the meta key of the object an element key belongs to(the key itself for
+     * meta keys), so that all cached elements of an object are dropped with its meta by InvalidateOwner.
+     * Every invalidation bumps the version of the owner's shard, a value read from the engine is only inserted if the
+     * version did not move since the read started, so a fill racing with a write never brings back the old value.
+     * Misses are counted by a small frequency sketch per shard which halves its counters as it fills up, a key is only
+     * admitted once it missed 'admit_reads' times recently, so that scans of cold keys do not flush the hot ones.
+     */
+    class RowCache
+    {
+        private:
+            struct Entry
+            {
+                    std::string key;
+                    std::string owner;
+                    std::string value;
+                    bool referenced;
+                    bool used;
+                    Entry() :
+                            referenced(false), used(false)
+                    {
+                    }
+            };
+            typedef google::dense_hash_map<std::string, uint32> EntryIndex;
+            typedef google::dense_hash_map<std::string, std::vector<uint32> > OwnerIndex;
+            struct Shard
+            {
+                    SpinMutexLock lock;
+                    EntryIndex index;
+                    OwnerIndex owners;
+                    std::vector<Entry> entries;
+                    std::vector<uint32> free_slots;
+                    std::vector<uint8> freq;
+                    uint32 freq_adds;
+                    uint32 hand;
+                    uint64 bytes;
+                    uint64 version;
+                    Shard() :
+                            freq_adds(0), hand(0), bytes(0), version(0)
+                    {
+                        index.set_empty_key("");
+                        index.set_deleted_key(std::string(1, '\0'));
+                        owners.set_empty_key("");
+                        owners.set_deleted_key(std::string(1, '\0'));
+                    }
+            };
+            static const uint32 kShards = 64;
+            static const uint32 kFreqCounters = 4096;
+            Shard m_shards[kShards];
+            volatile uint64 m_shard_capacity;
+            uint32 m_admit_reads;
+            Shard& GetShard(const std::string& owner);
+            void Erase(Shard& shard, uint32 slot);
+        public:
+            RowCache();
+            void SetCapacity(uint64 bytes);
+            void SetAdmitReads(uint32 reads)
+            {
+                m_admit_reads = reads;
+            }
+            uint64 GetCapacity() const
+            {
+                return m_shard_capacity * kShards;
+            }
+            bool Get(const std::string& owner, const std::string& key, std::string& value);
+            uint64 GetVersion(const std::string& owner);
+            /*
+             * Counts a miss of the key, returns true if it is read often enough to be cached.
+             */
+            bool Admit(const std::string& owner, const std::string& key);
+            void Put(const std::string& owner, const std::string& key, const std::string& value, uint64 version);
+            void Invalidate(const std::string& owner, const std::string& key);
+            void InvalidateOwner(const std::string& owner);
+            void Clear();
+            uint64 Memory();
+    };
+
+    /*
+     * row-cache-size: the engine is wrapped by CachedEngine at start, meta keys read by Get/MultiGet are served from
+     * the RowCache. Every write through the engine invalidates the written key, writes the cache can not map to
+     * keys(raw puts, range deletes, namespace drops, restores & bulk loads) drop the whole cache.
+     * Values are only cached while no write batch is open: keys written in a batch are invalidated when they are
+     * written but only change when the batch commits.
+     * With row-cache-elements the element keys(hash fields, set members, zset scores, list elements) read by point
+     * lookups are cached too, any write of a meta key drops the cached elements of its object. Element keys of
+     * objects keyed by object id are owned by themselves, a recreated object never reuses an id.
+     * The engine stays the only store of every key, so iterators read it directly & never see a tier boundary.
+     */
+    class CachedEngine: public Engine
+    {
+        private:
+            Engine* m_engine;
+            RowCache m_cache;
+            uint64 m_max_value_size;
+            bool m_cache_elements;
+            volatile uint32 m_open_batches;
+            volatile uint64 m_hits;
+            volatile uint64 m_misses;
+            volatile uint64 m_element_hits;
+            volatile uint64 m_rejects;
+            bool Cacheable(Context& ctx, const KeyObject& key);
+            void CacheKey(const KeyObject& key, std::string& ck, std::string& owner);
+            void Fill(const std::string& owner, const std::string& ck, const ValueObject& value, uint64 version);
+            void Invalidate(const KeyObject& key);
+            friend class CachedIterator;
+        public:
+            CachedEngine(Engine* engine, uint64 capacity, uint64 max_value_size, bool cache_elements, uint32 admit_reads);
+            int Init(const std::string& dir, const std::string& options);
+            int Repair(const std::string& dir);
+            int PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value);
+            int Put(Context& ctx, const KeyObject& key, const ValueObject& value);
+            int Get(Context& ctx, const KeyObject& key, ValueObject& value);
+            int Del(Context& ctx, const KeyObject& key);
+            int MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs);
+            int Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values);
+            bool Exists(Context& ctx, const KeyObject& key);
+            int DelRange(Context& ctx, const KeyObject& start, const KeyObject& end);
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
+            int Compact(Context& ctx, const KeyObject& start, const KeyObject& end);
+            int CompactAll(Context& ctx);
+            int CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress);
+            int CompactQueuedRanges(Context& ctx);
+            int DropExpiredTables(Context& ctx);
+            uint64_t GetThreadSkippedDeletes();
+            int FlushPendingWrites(Context& ctx);
+            int BeginWriteBatch(Context& ctx);
+            int CommitWriteBatch(Context& ctx);
+            int DiscardWriteBatch(Context& ctx);
+            int ListNameSpaces(Context& ctx, DataArray& nss);
+            int DropNameSpace(Context& ctx, const Data& ns);
+            int DetachNameSpace(Context& ctx, const Data& ns);
+            int SwapNameSpace(Context& ctx, const Data& ns, const Data& from);
+            int Refresh(Context& ctx);
+            int ReclaimDetachedNameSpaces(Context& ctx);
+            int Flush(Context& ctx, const Data& ns);
+            int FlushAll(Context& ctx);
+            int BeginBulkLoad(Context& ctx);
+            int BeginSnapshotRead(Context& ctx);
+            int EndSnapshotRead(Context& ctx);
+            const void* CreateSharedSnapshot(Context& ctx);
+            int BeginSharedSnapshotRead(Context& ctx, const void* snapshot);
+            void ReleaseSharedSnapshot(Context& ctx, const void* snapshot);
+            int EndBulkLoad(Context& ctx);
+            int64_t EstimateKeysNum(Context& ctx, const Data& ns);
+            int64_t GetLatestSequence();
+            int Checkpoint(Context& ctx, const std::string& dir);
+            int SetOption(Context& ctx, const std::string& name, const std::string& value);
+            bool IsWriteStalled();
+            int Restore(Context& ctx, const std::string& dir);
+            int BeginBulkIngest(Context& ctx, const Data& ns);
+            int EndBulkIngest(Context& ctx, const Data& ns, bool abort);
+            void Stats(Context& ctx, std::string& str);
+            const std::string GetErrorReason(int err);
+            const FeatureSet GetFeatureSet();
+            ~CachedEngine();
+    };
+
+OP_NAMESPACE_END
+
+#endif /* SRC_DB_ROW_CACHE_HPP_ */
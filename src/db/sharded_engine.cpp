@@ -0,0 +1,789 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "sharded_engine.hpp"
+#include "util/file_helper.hpp"
+#include "util/string_helper.hpp"
+#include "util/murmur3.h"
+
+OP_NAMESPACE_BEGIN
+
+    /*
+     * Iterators of all shards merged in key order, a key lives in exactly one shard so no duplicates are skipped.
+     * Changing direction re-seeks the other shards around the current key.
+     */
+    class ShardedIterator: public Iterator
+    {
+        private:
+            std::vector<Iterator*> m_iters;
+            int m_current;
+            bool m_forward;
+            bool m_has_ns;
+            void SelectCurrent()
+            {
+                m_current = -1;
+                for (size_t i = 0; i < m_iters.size(); i++)
+                {
+                    if (!m_iters[i]->Valid())
+                    {
+                        continue;
+                    }
+                    if (m_current < 0)
+                    {
+                        m_current = i;
+                        continue;
+                    }
+                    int cmp = compare_keyslices(m_iters[i]->RawKey(), m_iters[m_current]->RawKey(), m_has_ns);
+                    if (m_forward ? cmp < 0 : cmp > 0)
+                    {
+                        m_current = i;
+                    }
+                }
+            }
+        public:
+            ShardedIterator(bool has_ns) :
+                    m_current(-1), m_forward(true), m_has_ns(has_ns)
+            {
+            }
+            void AddIterator(Iterator* iter)
+            {
+                m_iters.push_back(iter);
+            }
+            void Init()
+            {
+                SelectCurrent();
+            }
+            bool Valid()
+            {
+                return m_current >= 0 && m_iters[m_current]->Valid();
+            }
+            void Next()
+            {
+                if (!Valid())
+                {
+                    return;
+                }
+                if (!m_forward)
+                {
+                    KeyObject current = m_iters[m_current]->Key(true);
+                    for (size_t i = 0; i < m_iters.size(); i++)
+                    {
+                        if ((int) i != m_current)
+                        {
+                            m_iters[i]->Jump(current);
+                        }
+                    }
+                    m_forward = true;
+                }
+                m_iters[m_current]->Next();
+                SelectCurrent();
+            }
+            void Prev()
+            {
+                if (!Valid())
+                {
+                    return;
+                }
+                if (m_forward)
+                {
+                    KeyObject current = m_iters[m_current]->Key(true);
+                    for (size_t i = 0; i < m_iters.size(); i++)
+                    {
+                        if ((int) i == m_current)
+                        {
+                            continue;
+                        }
+                        m_iters[i]->Jump(current);
+                        if (m_iters[i]->Valid())
+                        {
+                            m_iters[i]->Prev();
+                        }
+                        else
+                        {
+                            m_iters[i]->JumpToLast();
+                        }
+                    }
+                    m_forward = false;
+                }
+                m_iters[m_current]->Prev();
+                SelectCurrent();
+            }
+            void Jump(const KeyObject& next)
+            {
+                for (size_t i = 0; i < m_iters.size(); i++)
+                {
+                    m_iters[i]->Jump(next);
+                }
+                m_forward = true;
+                SelectCurrent();
+            }
+            void JumpToFirst()
+            {
+                for (size_t i = 0; i < m_iters.size(); i++)
+                {
+                    m_iters[i]->JumpToFirst();
+                }
+                m_forward = true;
+                SelectCurrent();
+            }
+            void JumpToLast()
+            {
+                for (size_t i = 0; i < m_iters.size(); i++)
+                {
+                    m_iters[i]->JumpToLast();
+                }
+                m_forward = false;
+                SelectCurrent();
+            }
+            KeyObject& Key(bool clone_str)
+            {
+                return m_iters[m_current]->Key(clone_str);
+            }
+            ValueObject& Value(bool clone_str)
+            {
+                return m_iters[m_current]->Value(clone_str);
+            }
+            Slice RawKey()
+            {
+                return m_iters[m_current]->RawKey();
+            }
+            Slice RawValue()
+            {
+                return m_iters[m_current]->RawValue();
+            }
+            void Del()
+            {
+                m_iters[m_current]->Del();
+            }
+            ~ShardedIterator()
+            {
+                for (size_t i = 0; i < m_iters.size(); i++)
+                {
+                    DELETE(m_iters[i]);
+                }
+            }
+    };
+
+    typedef std::vector<const void*> ShardedSnapshot;
+
+    ShardedEngine::ShardedEngine(const std::vector<Engine*>& shards) :
+            m_shards(shards)
+    {
+    }
+    uint32 ShardedEngine::ShardIndex(const Data& key)
+    {
+        std::string str;
+        key.ToString(str);
+        uint32 hash = 0;
+        MurmurHash3_x86_32(str.data(), str.size(), 0, &hash);
+        return hash % m_shards.size();
+    }
+    std::string ShardedEngine::ShardDir(const std::string& dir, size_t idx)
+    {
+        return dir + "/shard-" + stringfromll(idx);
+    }
+    int ShardedEngine::Init(const std::string& dir, const std::string& options)
+    {
+        std::string count_file = dir + "/shards";
+        std::string content;
+        uint32 count = 0;
+        if (is_file_exist(count_file))
+        {
+            if (0 != file_read_full(count_file, content) || !string_touint32(trim_string(content), count) || count != m_shards.size())
+            {
+                ERROR_LOG("Data dir:%s was created with %s engine shards instead of %u.", dir.c_str(), trim_string(content).c_str(),
+                        (uint32) m_shards.size());
+                return -1;
+            }
+        }
+        else if (is_file_exist(dir + "/CURRENT"))
+        {
+            ERROR_LOG("Data dir:%s holds a single engine instance, it could not be opened with %u shards.", dir.c_str(), (uint32) m_shards.size());
+            return -1;
+        }
+        else if (0 != file_write_content(count_file, stringfromll(m_shards.size())))
+        {
+            ERROR_LOG("Failed to save engine shards count into file:%s", count_file.c_str());
+            return -1;
+        }
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            std::string shard_dir = ShardDir(dir, i);
+            make_dir(shard_dir);
+            int err = m_shards[i]->Init(shard_dir, options);
+            if (0 != err)
+            {
+                ERROR_LOG("Failed to init engine shard:%s", shard_dir.c_str());
+                return err;
+            }
+        }
+        INFO_LOG("Engine opened with %u shards.", (uint32) m_shards.size());
+        return 0;
+    }
+    int ShardedEngine::Repair(const std::string& dir)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->Repair(ShardDir(dir, i));
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value)
+    {
+        KeyObject k;
+        Buffer kbuf(const_cast<char*>(key.data()), 0, key.size());
+        if (!GetFeatureSet().support_namespace && !k.DecodeNS(kbuf, false))
+        {
+            return ERR_INVALID_ARGS;
+        }
+        if (!k.DecodeKey(kbuf, false))
+        {
+            return ERR_INVALID_ARGS;
+        }
+        return GetShard(k)->PutRaw(ctx, ns, key, value);
+    }
+    int ShardedEngine::Put(Context& ctx, const KeyObject& key, const ValueObject& value)
+    {
+        return GetShard(key)->Put(ctx, key, value);
+    }
+    int ShardedEngine::Get(Context& ctx, const KeyObject& key, ValueObject& value)
+    {
+        return GetShard(key)->Get(ctx, key, value);
+    }
+    int ShardedEngine::Del(Context& ctx, const KeyObject& key)
+    {
+        return GetShard(key)->Del(ctx, key);
+    }
+    int ShardedEngine::MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs)
+    {
+        values.resize(keys.size());
+        errs.assign(keys.size(), ERR_ENTRY_NOT_EXIST);
+        std::vector<std::vector<size_t> > idxs(m_shards.size());
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            idxs[ShardIndex(keys[i].GetKey())].push_back(i);
+        }
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            if (idxs[i].empty())
+            {
+                continue;
+            }
+            KeyObjectArray shard_keys;
+            ValueObjectArray shard_values;
+            ErrCodeArray shard_errs;
+            for (size_t j = 0; j < idxs[i].size(); j++)
+            {
+                shard_keys.push_back(keys[idxs[i][j]]);
+            }
+            m_shards[i]->MultiGet(ctx, shard_keys, shard_values, shard_errs);
+            for (size_t j = 0; j < idxs[i].size() && j < shard_errs.size(); j++)
+            {
+                errs[idxs[i][j]] = shard_errs[j];
+                if (j < shard_values.size())
+                {
+                    values[idxs[i][j]] = shard_values[j];
+                }
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values)
+    {
+        return GetShard(key)->Merge(ctx, key, op, values);
+    }
+    bool ShardedEngine::Exists(Context& ctx, const KeyObject& key)
+    {
+        return GetShard(key)->Exists(ctx, key);
+    }
+    int ShardedEngine::DelRange(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->DelRange(ctx, start, end);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    Iterator* ShardedEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
+    {
+        /*
+         * an iterator bound to one object only visits the shard of its key
+         */
+        if (options.prefix_only)
+        {
+            return GetShard(key)->Find(ctx, key, options);
+        }
+        ShardedIterator* iter = NULL;
+        NEW(iter, ShardedIterator(!GetFeatureSet().support_namespace));
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            iter->AddIterator(m_shards[i]->Find(ctx, key, options));
+        }
+        iter->Init();
+        return iter;
+    }
+    int ShardedEngine::Compact(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            m_shards[i]->Compact(ctx, start, end);
+        }
+        return 0;
+    }
+    int ShardedEngine::CompactAll(Context& ctx)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            m_shards[i]->CompactAll(ctx);
+        }
+        return 0;
+    }
+    int ShardedEngine::CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress)
+    {
+        for (size_t i = 0; i < m_shards.size() && !progress.cancel; i++)
+        {
+            int err = m_shards[i]->CompactDeleted(ctx, ns, min_deleted_percent, progress);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::CompactQueuedRanges(Context& ctx)
+    {
+        int compacted = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            compacted += m_shards[i]->CompactQueuedRanges(ctx);
+        }
+        return compacted;
+    }
+    int ShardedEngine::DropExpiredTables(Context& ctx)
+    {
+        int dropped = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            dropped += m_shards[i]->DropExpiredTables(ctx);
+        }
+        return dropped;
+    }
+    uint64_t ShardedEngine::GetThreadSkippedDeletes()
+    {
+        uint64_t skipped = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            skipped += m_shards[i]->GetThreadSkippedDeletes();
+        }
+        return skipped;
+    }
+    int ShardedEngine::FlushPendingWrites(Context& ctx)
+    {
+        int written = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            written += m_shards[i]->FlushPendingWrites(ctx);
+        }
+        return written;
+    }
+    int ShardedEngine::BeginWriteBatch(Context& ctx)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->BeginWriteBatch(ctx);
+            if (0 != err)
+            {
+                while (i > 0)
+                {
+                    m_shards[--i]->DiscardWriteBatch(ctx);
+                }
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::CommitWriteBatch(Context& ctx)
+    {
+        int ret = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->CommitWriteBatch(ctx);
+            if (0 != err && 0 == ret)
+            {
+                ret = err;
+            }
+        }
+        return ret;
+    }
+    int ShardedEngine::DiscardWriteBatch(Context& ctx)
+    {
+        int ret = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->DiscardWriteBatch(ctx);
+            if (0 != err && 0 == ret)
+            {
+                ret = err;
+            }
+        }
+        return ret;
+    }
+    int ShardedEngine::ListNameSpaces(Context& ctx, DataArray& nss)
+    {
+        DataSet all;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            DataArray shard_nss;
+            m_shards[i]->ListNameSpaces(ctx, shard_nss);
+            for (size_t j = 0; j < shard_nss.size(); j++)
+            {
+                if (all.insert(shard_nss[j]).second)
+                {
+                    nss.push_back(shard_nss[j]);
+                }
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::DropNameSpace(Context& ctx, const Data& ns)
+    {
+        int ret = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->DropNameSpace(ctx, ns);
+            if (0 != err && 0 == ret)
+            {
+                ret = err;
+            }
+        }
+        return ret;
+    }
+    int ShardedEngine::DetachNameSpace(Context& ctx, const Data& ns)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->DetachNameSpace(ctx, ns);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::SwapNameSpace(Context& ctx, const Data& ns, const Data& from)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->SwapNameSpace(ctx, ns, from);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::Refresh(Context& ctx)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->Refresh(ctx);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::ReclaimDetachedNameSpaces(Context& ctx)
+    {
+        int left = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            left += m_shards[i]->ReclaimDetachedNameSpaces(ctx);
+        }
+        return left;
+    }
+    int ShardedEngine::Flush(Context& ctx, const Data& ns)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->Flush(ctx, ns);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::FlushAll(Context& ctx)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            m_shards[i]->FlushAll(ctx);
+        }
+        return 0;
+    }
+    int ShardedEngine::BeginBulkLoad(Context& ctx)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->BeginBulkLoad(ctx);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::EndBulkLoad(Context& ctx)
+    {
+        int ret = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->EndBulkLoad(ctx);
+            if (0 != err && 0 == ret)
+            {
+                ret = err;
+            }
+        }
+        return ret;
+    }
+    int ShardedEngine::BeginSnapshotRead(Context& ctx)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->BeginSnapshotRead(ctx);
+            if (0 != err)
+            {
+                while (i > 0)
+                {
+                    m_shards[--i]->EndSnapshotRead(ctx);
+                }
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::EndSnapshotRead(Context& ctx)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            m_shards[i]->EndSnapshotRead(ctx);
+        }
+        return 0;
+    }
+    const void* ShardedEngine::CreateSharedSnapshot(Context& ctx)
+    {
+        ShardedSnapshot* snapshot = NULL;
+        NEW(snapshot, ShardedSnapshot);
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            const void* shard_snapshot = m_shards[i]->CreateSharedSnapshot(ctx);
+            if (NULL == shard_snapshot)
+            {
+                ReleaseSharedSnapshot(ctx, snapshot);
+                return NULL;
+            }
+            snapshot->push_back(shard_snapshot);
+        }
+        return snapshot;
+    }
+    int ShardedEngine::BeginSharedSnapshotRead(Context& ctx, const void* snapshot)
+    {
+        const ShardedSnapshot* shard_snapshots = (const ShardedSnapshot*) snapshot;
+        for (size_t i = 0; i < m_shards.size() && i < shard_snapshots->size(); i++)
+        {
+            int err = m_shards[i]->BeginSharedSnapshotRead(ctx, shard_snapshots->at(i));
+            if (0 != err)
+            {
+                while (i > 0)
+                {
+                    m_shards[--i]->EndSnapshotRead(ctx);
+                }
+                return err;
+            }
+        }
+        return 0;
+    }
+    void ShardedEngine::ReleaseSharedSnapshot(Context& ctx, const void* snapshot)
+    {
+        ShardedSnapshot* shard_snapshots = (ShardedSnapshot*) snapshot;
+        for (size_t i = 0; i < shard_snapshots->size(); i++)
+        {
+            m_shards[i]->ReleaseSharedSnapshot(ctx, shard_snapshots->at(i));
+        }
+        DELETE(shard_snapshots);
+    }
+    int64_t ShardedEngine::EstimateKeysNum(Context& ctx, const Data& ns)
+    {
+        int64_t num = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            num += m_shards[i]->EstimateKeysNum(ctx, ns);
+        }
+        return num;
+    }
+    /*
+     * sum of the shards' sequences, it only grows with the writes of any shard
+     */
+    int64_t ShardedEngine::GetLatestSequence()
+    {
+        int64_t seq = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int64_t shard_seq = m_shards[i]->GetLatestSequence();
+            if (shard_seq < 0)
+            {
+                return -1;
+            }
+            seq += shard_seq;
+        }
+        return seq;
+    }
+    int ShardedEngine::Checkpoint(Context& ctx, const std::string& dir)
+    {
+        if (!make_dir(dir) || 0 != file_write_content(dir + "/shards", stringfromll(m_shards.size())))
+        {
+            return ERR_INVALID_ARGS;
+        }
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->Checkpoint(ctx, ShardDir(dir, i));
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::Restore(Context& ctx, const std::string& dir)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            if (!is_dir_exist(ShardDir(dir, i)))
+            {
+                ERROR_LOG("No engine shard:%u in checkpoint:%s", (uint32) i, dir.c_str());
+                return ERR_INVALID_ARGS;
+            }
+        }
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->Restore(ctx, ShardDir(dir, i));
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::SetOption(Context& ctx, const std::string& name, const std::string& value)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->SetOption(ctx, name, value);
+            if (0 != err)
+            {
+                return err;
+            }
+        }
+        return 0;
+    }
+    bool ShardedEngine::IsWriteStalled()
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            if (m_shards[i]->IsWriteStalled())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    int ShardedEngine::BeginBulkIngest(Context& ctx, const Data& ns)
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->BeginBulkIngest(ctx, ns);
+            if (0 != err)
+            {
+                while (i > 0)
+                {
+                    m_shards[--i]->EndBulkIngest(ctx, ns, true);
+                }
+                return err;
+            }
+        }
+        return 0;
+    }
+    int ShardedEngine::EndBulkIngest(Context& ctx, const Data& ns, bool abort)
+    {
+        int ret = 0;
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            int err = m_shards[i]->EndBulkIngest(ctx, ns, abort);
+            if (0 != err && 0 == ret)
+            {
+                ret = err;
+            }
+        }
+        return ret;
+    }
+    void ShardedEngine::Stats(Context& ctx, std::string& str)
+    {
+        str.append("engine_shards:").append(stringfromll(m_shards.size())).append("\r\n");
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            str.append("# Engine shard ").append(stringfromll(i)).append("\r\n");
+            m_shards[i]->Stats(ctx, str);
+        }
+    }
+    const std::string ShardedEngine::GetErrorReason(int err)
+    {
+        return m_shards[0]->GetErrorReason(err);
+    }
+    const FeatureSet ShardedEngine::GetFeatureSet()
+    {
+        return m_shards[0]->GetFeatureSet();
+    }
+    ShardedEngine::~ShardedEngine()
+    {
+        for (size_t i = 0; i < m_shards.size(); i++)
+        {
+            DELETE(m_shards[i]);
+        }
+    }
+
+OP_NAMESPACE_END
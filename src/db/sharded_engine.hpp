@@ -0,0 +1,109 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_DB_SHARDED_ENGINE_HPP_
+#define SRC_DB_SHARDED_ENGINE_HPP_
+
+#include "engine.hpp"
+
+OP_NAMESPACE_BEGIN
+
+    /*
+     * engine-shards: the engine is opened 'engine-shards' times in '<dir>/shard-<n>' and wrapped by ShardedEngine
+     * at start, each instance with its own WAL, memtables & compaction threads. A key goes to the shard selected by
+     * the hash of its user key, so the meta & elements of an object always live in one shard. Iterators over more
+     * than one object merge the iterators of all shards in key order. Write batches & snapshots are opened on every
+     * shard, they are atomic & consistent per shard only. The shard count is kept in '<dir>/shards', a data dir is
+     * always reopened with the count it was created with.
+     */
+    class ShardedEngine: public Engine
+    {
+        private:
+            std::vector<Engine*> m_shards;
+            uint32 ShardIndex(const Data& key);
+            Engine* GetShard(const KeyObject& key)
+            {
+                return m_shards[ShardIndex(key.GetKey())];
+            }
+            static std::string ShardDir(const std::string& dir, size_t idx);
+        public:
+            ShardedEngine(const std::vector<Engine*>& shards);
+            int Init(const std::string& dir, const std::string& options);
+            int Repair(const std::string& dir);
+            int PutRaw(Context& ctx, const Data& ns, const Slice& key, const Slice& value);
+            int Put(Context& ctx, const KeyObject& key, const ValueObject& value);
+            int Get(Context& ctx, const KeyObject& key, ValueObject& value);
+            int Del(Context& ctx, const KeyObject& key);
+            int MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs);
+            int Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& values);
+            bool Exists(Context& ctx, const KeyObject& key);
+            int DelRange(Context& ctx, const KeyObject& start, const KeyObject& end);
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
+            int Compact(Context& ctx, const KeyObject& start, const KeyObject& end);
+            int CompactAll(Context& ctx);
+            int CompactDeleted(Context& ctx, const Data& ns, int min_deleted_percent, CompactProgress& progress);
+            int CompactQueuedRanges(Context& ctx);
+            int DropExpiredTables(Context& ctx);
+            uint64_t GetThreadSkippedDeletes();
+            int FlushPendingWrites(Context& ctx);
+            int BeginWriteBatch(Context& ctx);
+            int CommitWriteBatch(Context& ctx);
+            int DiscardWriteBatch(Context& ctx);
+            int ListNameSpaces(Context& ctx, DataArray& nss);
+            int DropNameSpace(Context& ctx, const Data& ns);
+            int DetachNameSpace(Context& ctx, const Data& ns);
+            int SwapNameSpace(Context& ctx, const Data& ns, const Data& from);
+            int Refresh(Context& ctx);
+            int ReclaimDetachedNameSpaces(Context& ctx);
+            int Flush(Context& ctx, const Data& ns);
+            int FlushAll(Context& ctx);
+            int BeginBulkLoad(Context& ctx);
+            int BeginSnapshotRead(Context& ctx);
+            int EndSnapshotRead(Context& ctx);
+            const void* CreateSharedSnapshot(Context& ctx);
+            int BeginSharedSnapshotRead(Context& ctx, const void* snapshot);
+            void ReleaseSharedSnapshot(Context& ctx, const void* snapshot);
+            int EndBulkLoad(Context& ctx);
+            int64_t EstimateKeysNum(Context& ctx, const Data& ns);
+            int64_t GetLatestSequence();
+            int Checkpoint(Context& ctx, const std::string& dir);
+            int SetOption(Context& ctx, const std::string& name, const std::string& value);
+            bool IsWriteStalled();
+            int Restore(Context& ctx, const std::string& dir);
+            int BeginBulkIngest(Context& ctx, const Data& ns);
+            int EndBulkIngest(Context& ctx, const Data& ns, bool abort);
+            void Stats(Context& ctx, std::string& str);
+            const std::string GetErrorReason(int err);
+            const FeatureSet GetFeatureSet();
+            ~ShardedEngine();
+    };
+
+OP_NAMESPACE_END
+
+#endif /* SRC_DB_SHARDED_ENGINE_HPP_ */
@@ -30,9 +30,12 @@
 #include "wiredtiger_engine.hpp"
 #include "thread/lock_guard.hpp"
 #include "util/file_helper.hpp"
+#include "util/atomic.hpp"
 #include "db/db.hpp"
+#include "db/db_utils.hpp"
 #include <string.h>
 #include <stdlib.h>
+#include <set>
 
 #define CHECK_WT_RETURN(ret)         do{\
                                        int rc = (ret);\
@@ -64,11 +67,21 @@ namespace ardb
             int64 cache_size;
             int64 bloom_bits;
             int64 session_max;
+            int64 cursor_cache_size;
+            int64 cursor_cache_per_table;
             bool mmap;
             std::string compressor;
+            /*
+             * namespaces created as btree tables instead of lsm ones, for read mostly point lookups which pay no
+             * chunk merging & bloom checks
+             */
+            std::set<std::string> btree_namespaces;
+            int64 btree_page_size;
+            int64 btree_memory_page_max;
+            bool btree_cache_resident;
             WTConfig() :
-                    block_size(4096), chunk_size(128 * 1024 * 1024), cache_size(512 * 1024 * 1024), bloom_bits(10), session_max(8192), mmap(false), compressor(
-                            "snappy")
+                    block_size(4096), chunk_size(128 * 1024 * 1024), cache_size(512 * 1024 * 1024), bloom_bits(10), session_max(8192), cursor_cache_size(64), cursor_cache_per_table(
+                            4), mmap(false), compressor("snappy"), btree_page_size(32 * 1024), btree_memory_page_max(5 * 1024 * 1024), btree_cache_resident(false)
             {
             }
     };
@@ -91,51 +104,120 @@ namespace ardb
             }
     };
 
-    struct WiredTigerLocalContext
+    static volatile uint64_t g_cursor_cache_hits = 0;
+    static volatile uint64_t g_cursor_cache_misses = 0;
+    static volatile uint64_t g_cursor_cache_evicts = 0;
+
+    struct WiredTigerLocalContext: public DBLocalContext
     {
             WT_SESSION* wsession;
-            typedef TreeMap<Data, WT_CURSOR*>::Type KVTable;
+            /*
+             * idle cursors of each table, cursors are reset before cached so they do not pin any page,
+             * 'cursor_count' is the number of idle cursors of all tables.
+             */
+            struct CursorCache
+            {
+                    std::vector<WT_CURSOR*> cursors;
+                    uint64 last_use;
+                    CursorCache() :
+                            last_use(0)
+                    {
+                    }
+            };
+            typedef TreeMap<Data, CursorCache>::Type KVTable;
             KVTable kv_stores;
+            size_t cursor_count;
+            uint64 use_tick;
             uint32 batch_ref;
             bool batch_abort;
-            Buffer encode_buffer_cache;
             std::deque<WriteOperation> batch;
             bool inited;
             WiredTigerLocalContext() :
-                    wsession(NULL), batch_ref(0), batch_abort(false), inited(false)
+                    wsession(NULL), cursor_count(0), use_tick(0), batch_ref(0), batch_abort(false), inited(false)
             {
             }
-            void RecycleCursor(const Data& ns, WT_CURSOR* cursor)
+            /*
+             * close the idle cursors of the least recently used table except 'ns'
+             */
+            bool EvictCursors(const Data& ns)
             {
-                KVTable::iterator found = kv_stores.find(ns);
-                if (found != kv_stores.end())
+                KVTable::iterator victim = kv_stores.end();
+                KVTable::iterator it = kv_stores.begin();
+                while (it != kv_stores.end())
                 {
-                    if (NULL == found->second)
+                    if (!it->second.cursors.empty() && it->first != ns && (victim == kv_stores.end() || it->second.last_use < victim->second.last_use))
                     {
-                        found->second = cursor;
-                        return;
-                    }
-                    if (found->second == cursor)
-                    {
-                        return;
+                        victim = it;
                     }
+                    it++;
+                }
+                if (victim == kv_stores.end())
+                {
+                    return false;
+                }
+                std::vector<WT_CURSOR*>& cursors = victim->second.cursors;
+                for (size_t i = 0; i < cursors.size(); i++)
+                {
+                    cursors[i]->close(cursors[i]);
                 }
-                cursor->close(cursor);
+                cursor_count -= cursors.size();
+                atomic_add_uint64(&g_cursor_cache_evicts, cursors.size());
+                cursors.clear();
+                return true;
             }
-            WT_CURSOR* GetKVStore(const Data& ns, bool create_if_missing, bool acquire = false)
+            void CloseCursors(const Data& ns)
+            {
+                KVTable::iterator found = kv_stores.find(ns);
+                if (found == kv_stores.end())
+                {
+                    return;
+                }
+                std::vector<WT_CURSOR*>& cursors = found->second.cursors;
+                for (size_t i = 0; i < cursors.size(); i++)
+                {
+                    cursors[i]->close(cursors[i]);
+                }
+                cursor_count -= cursors.size();
+                kv_stores.erase(found);
+            }
+            void RecycleCursor(const Data& ns, WT_CURSOR* cursor)
             {
-                WT_CURSOR* c = NULL;
                 KVTable::iterator found = kv_stores.find(ns);
-                if (found != kv_stores.end() && NULL != found->second)
+                if (found == kv_stores.end() || found->second.cursors.size() >= (size_t) g_wt_conig.cursor_cache_per_table
+                        || 0 != cursor->reset(cursor))
                 {
-                    c = found->second;
-                    if (acquire)
+                    cursor->close(cursor);
+                    atomic_add_uint64(&g_cursor_cache_evicts, 1);
+                    return;
+                }
+                if (cursor_count >= (size_t) g_wt_conig.cursor_cache_size && !EvictCursors(ns))
+                {
+                    cursor->close(cursor);
+                    atomic_add_uint64(&g_cursor_cache_evicts, 1);
+                    return;
+                }
+                found->second.cursors.push_back(cursor);
+                cursor_count++;
+            }
+            /*
+             * Take a cursor of the table out of the cache, opened if none is idle, it should be given back by RecycleCursor.
+             */
+            WT_CURSOR* GetKVStore(const Data& ns, bool create_if_missing)
+            {
+                KVTable::iterator found = kv_stores.find(ns);
+                if (found != kv_stores.end())
+                {
+                    found->second.last_use = ++use_tick;
+                    if (!found->second.cursors.empty())
                     {
-                        found->second = NULL;
+                        WT_CURSOR* c = found->second.cursors.back();
+                        found->second.cursors.pop_back();
+                        cursor_count--;
+                        atomic_add_uint64(&g_cursor_cache_hits, 1);
+                        return c;
                     }
-                    return c;
                 }
-                if (found == kv_stores.end())
+                else
                 {
                     /*
                      * other thread may create table
@@ -145,16 +227,17 @@ namespace ardb
                         return NULL;
                     }
                 }
+                WT_CURSOR* c = NULL;
                 int ret;
                 if ((ret = wsession->open_cursor(wsession, table_url(ns).c_str(), NULL, NULL, &c)) != 0)
                 {
                     ERROR_LOG("Failed to open cursor on %s: %s\n", ns.AsString().c_str(), wiredtiger_strerror(ret));
                     return NULL;
                 }
-                kv_stores[ns] = c;
-                if (acquire)
+                atomic_add_uint64(&g_cursor_cache_misses, 1);
+                if (found == kv_stores.end())
                 {
-                    kv_stores[ns] = NULL;
+                    kv_stores[ns].last_use = ++use_tick;
                 }
                 return c;
             }
@@ -215,11 +298,6 @@ namespace ardb
                 }
                 return rc;
             }
-            Buffer& GetEncodeBuferCache()
-            {
-                encode_buffer_cache.Clear();
-                return encode_buffer_cache;
-            }
             ~WiredTigerLocalContext()
             {
             }
@@ -253,22 +331,41 @@ namespace ardb
             return false;
         }
         std::stringstream s_table;
-        s_table << "collator=ardb_comparator,";
-        s_table << "type=lsm,split_pct=100,leaf_item_max=1KB,";
-        s_table << "lsm=(chunk_size=100MB,bloom_config=(leaf_page_max=8MB)),";
-        s_table << "internal_page_max=" << g_wt_conig.block_size << ",";
-        s_table << "leaf_page_max=" << g_wt_conig.block_size << ",";
-        s_table << "leaf_item_max=" << g_wt_conig.block_size / 4 << ",";
+        if (!is_ordered_key_codec(get_key_codec_version()))
+        {
+            s_table << "collator=ardb_comparator,";
+        }
+        bool btree = g_wt_conig.btree_namespaces.count(ns.AsString()) > 0;
+        if (btree)
+        {
+            s_table << "type=file,";
+            s_table << "internal_page_max=" << g_wt_conig.btree_page_size << ",";
+            s_table << "leaf_page_max=" << g_wt_conig.btree_page_size << ",";
+            s_table << "leaf_item_max=" << g_wt_conig.btree_page_size / 4 << ",";
+            s_table << "memory_page_max=" << g_wt_conig.btree_memory_page_max << ",";
+            if (g_wt_conig.btree_cache_resident)
+            {
+                s_table << "cache_resident=true,";
+            }
+        }
+        else
+        {
+            s_table << "type=lsm,split_pct=100,";
+            s_table << "internal_page_max=" << g_wt_conig.block_size << ",";
+            s_table << "leaf_page_max=" << g_wt_conig.block_size << ",";
+            s_table << "leaf_item_max=" << g_wt_conig.block_size / 4 << ",";
+            s_table << "lsm=(";
+            s_table << "chunk_size=" << g_wt_conig.chunk_size << ",";
+            s_table << "bloom_bit_count=" << g_wt_conig.bloom_bits << ",";
+            // Approximate the optimal number of hashes
+            s_table << "bloom_hash_count=" << (int) (0.6 * g_wt_conig.bloom_bits) << ",";
+            s_table << "bloom_config=(leaf_page_max=8MB)";
+            s_table << "),";
+        }
         if (g_wt_conig.compressor != "none")
         {
             s_table << "block_compressor=" << g_wt_conig.compressor << ",";
         }
-        s_table << "lsm=(";
-        s_table << "chunk_size=" << g_wt_conig.chunk_size << ",";
-        s_table << "bloom_bit_count=" << g_wt_conig.bloom_bits << ",";
-        // Approximate the optimal number of hashes
-        s_table << "bloom_hash_count=" << (int) (0.6 * g_wt_conig.bloom_bits) << ",";
-        s_table << "),";
         int ret;
         std: string table_name = table_url(ns);
 
@@ -290,7 +387,11 @@ namespace ardb
             return false;
         }
         m_nss.insert(ns);
-        INFO_LOG("Success to open db:%s", ns.AsString().c_str());
+        if (btree)
+        {
+            m_btree_nss.insert(ns);
+        }
+        INFO_LOG("Success to open db:%s as %s table", ns.AsString().c_str(), btree ? "btree" : "lsm");
         return true;
     }
 
@@ -303,8 +404,24 @@ namespace ardb
         conf_get_int64(props, "cache_size", g_wt_conig.cache_size);
         conf_get_int64(props, "bloom_bits", g_wt_conig.bloom_bits);
         conf_get_int64(props, "session_max", g_wt_conig.session_max);
+        conf_get_int64(props, "cursor_cache_size", g_wt_conig.cursor_cache_size);
+        conf_get_int64(props, "cursor_cache_per_table", g_wt_conig.cursor_cache_per_table);
         conf_get_bool(props, "mmap", g_wt_conig.mmap);
         conf_get_string(props, "compressor", g_wt_conig.compressor);
+        conf_get_int64(props, "btree_page_size", g_wt_conig.btree_page_size);
+        conf_get_int64(props, "btree_memory_page_max", g_wt_conig.btree_memory_page_max);
+        conf_get_bool(props, "btree_cache_resident", g_wt_conig.btree_cache_resident);
+        std::string btree_namespaces;
+        conf_get_string(props, "btree_namespaces", btree_namespaces);
+        std::vector<std::string> btree_nss = split_string(btree_namespaces, "|");
+        for (size_t i = 0; i < btree_nss.size(); i++)
+        {
+            std::string ns = trim_string(btree_nss[i]);
+            if (!ns.empty())
+            {
+                g_wt_conig.btree_namespaces.insert(ns);
+            }
+        }
 
         std::stringstream s_conn;
         s_conn << "log=(enabled),checkpoint=(wait=180),checkpoint_sync=false,";
@@ -355,6 +472,19 @@ namespace ardb
                 m_nss.insert(ns);
             }
         }
+        /*
+         * the type of an existing table is the one it was created with, lsm tables have an "lsm:" source
+         */
+        DataSet::iterator nit = m_nss.begin();
+        for (; nit != m_nss.end(); nit++)
+        {
+            std::string lsm_uri = "lsm:" + nit->AsString();
+            c->set_key(c, lsm_uri.c_str());
+            if (0 != c->search(c))
+            {
+                m_btree_nss.insert(*nit);
+            }
+        }
         c->close(c);
         session->close(session, NULL);
         g_wdb = this;
@@ -376,7 +506,7 @@ namespace ardb
         {
             return ERR_ENTRY_NOT_EXIST;
         }
-        Buffer& encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(encode_buffer);
         size_t key_len = encode_buffer.ReadableBytes();
         value.Encode(encode_buffer);
@@ -422,7 +552,7 @@ namespace ardb
         {
             return ERR_ENTRY_NOT_EXIST;
         }
-        Buffer& key_encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& key_encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(key_encode_buffer);
         WT_ITEM item;
         item.data = (const void *) (key_encode_buffer.GetRawReadBuffer());
@@ -433,7 +563,6 @@ namespace ardb
         {
             Buffer valBuffer((char*) item.data, 0, item.size);
             value.Decode(valBuffer, true);
-            ret = cursor->reset(cursor);
         }
         local_ctx.RecycleCursor(key.GetNameSpace(), cursor);
         return WT_ERR(ret);
@@ -443,10 +572,21 @@ namespace ardb
     {
         values.resize(keys.size());
         errs.resize(keys.size());
-        for (size_t i = 0; i < keys.size(); i++)
+        /*
+         * all keys are read in one snapshot transaction in storage order
+         */
+        WiredTigerLocalContext& local_ctx = GetDBLocalContext();
+        WT_SESSION* session = local_ctx.wsession;
+        bool in_txn = (NULL != session && 0 == session->begin_transaction(session, "isolation=snapshot"));
+        std::vector<size_t> idxs;
+        sort_keys_index(keys, idxs);
+        for (size_t i = 0; i < idxs.size(); i++)
         {
-            int err = Get(ctx, keys[i], values[i]);
-            errs[i] = err;
+            errs[idxs[i]] = Get(ctx, keys[idxs[i]], values[idxs[i]]);
+        }
+        if (in_txn)
+        {
+            session->commit_transaction(session, NULL);
         }
         return 0;
     }
@@ -458,7 +598,7 @@ namespace ardb
         {
             return ERR_ENTRY_NOT_EXIST;
         }
-        Buffer& key_encode_buffer = local_ctx.GetEncodeBuferCache();
+        Buffer& key_encode_buffer = local_ctx.GetEncodeBufferCache();
         key.Encode(key_encode_buffer);
         WT_ITEM item;
         item.data = (const void *) (key_encode_buffer.GetRawReadBuffer());
@@ -466,13 +606,55 @@ namespace ardb
         cursor->set_key(cursor, &item);
         int ret;
         ret = cursor->remove(cursor);
-        // Reset the WiredTiger cursor so it doesn't keep any pages pinned.
-        // Track failures in debug builds since we don't expect failure, but
-        // don't pass failures on - it's not necessary for correct operation.
-        cursor->reset(cursor);
         local_ctx.RecycleCursor(key.GetNameSpace(), cursor);
         return WT_NERR(ret);
     }
+    int WiredTigerEngine::DelRange(Context& ctx, const KeyObject& start, const KeyObject& end)
+    {
+        WiredTigerLocalContext& local_ctx = GetDBLocalContext();
+        const Data& ns = start.GetNameSpace();
+        WT_SESSION* session = local_ctx.wsession;
+        WT_CURSOR* start_cursor = local_ctx.GetKVStore(ns, false);
+        if (NULL == start_cursor)
+        {
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        WT_CURSOR* stop_cursor = local_ctx.GetKVStore(ns, false);
+        if (NULL == stop_cursor)
+        {
+            local_ctx.RecycleCursor(ns, start_cursor);
+            return ERR_ENTRY_NOT_EXIST;
+        }
+        int ret;
+        Buffer start_buffer, end_buffer;
+        start.Encode(start_buffer, false);
+        end.Encode(end_buffer, false);
+        WT_ITEM start_item, end_item;
+        start_item.data = (const void *) start_buffer.GetRawReadBuffer();
+        start_item.size = start_buffer.ReadableBytes();
+        end_item.data = (const void *) end_buffer.GetRawReadBuffer();
+        end_item.size = end_buffer.ReadableBytes();
+        start_cursor->set_key(start_cursor, &start_item);
+        /*
+         * the stop cursor of truncate is inclusive, move it to the last key before 'end'
+         */
+        stop_cursor->set_key(stop_cursor, &end_item);
+        int cmp = 0;
+        if ((ret = stop_cursor->search_near(stop_cursor, &cmp)) == 0 && cmp >= 0)
+        {
+            ret = stop_cursor->prev(stop_cursor);
+        }
+        if (0 == ret)
+        {
+            /*
+             * truncate positions the start cursor itself & does nothing if the range is empty
+             */
+            ret = session->truncate(session, NULL, start_cursor, stop_cursor, NULL);
+        }
+        local_ctx.RecycleCursor(ns, start_cursor);
+        local_ctx.RecycleCursor(ns, stop_cursor);
+        return WT_NERR(ret);
+    }
     int WiredTigerEngine::Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& args)
     {
         ValueObject current;
@@ -535,17 +717,21 @@ namespace ardb
     int WiredTigerEngine::DropNameSpace(Context& ctx, const Data& ns)
     {
         WiredTigerLocalContext& local_ctx = GetDBLocalContext();
-        WT_CURSOR *cursor = local_ctx.GetKVStore(ns, false);
-        if (NULL == cursor)
+        if (!GetTable(ns, false))
         {
             return ERR_ENTRY_NOT_EXIST;
         }
+        /*
+         * cached cursors keep the table open, drop fails with EBUSY while any is still open
+         */
+        local_ctx.CloseCursors(ns);
         WT_SESSION *session = local_ctx.wsession;
         int ret = session->drop(session, table_url(ns).c_str(), NULL);
         if (0 == ret)
         {
             RWLockGuard<SpinRWLock> guard(m_lock, false);
             m_nss.erase(ns);
+            m_btree_nss.erase(ns);
         }
         return WT_ERR(ret);
     }
@@ -553,43 +739,53 @@ namespace ardb
     {
         return 0;
     }
+    /*
+     * Only the cache size is reconfigurable, the others are set once by wiredtiger_open.
+     */
+    int WiredTigerEngine::SetOption(Context& ctx, const std::string& name, const std::string& value)
+    {
+        if (name != "cache_size")
+        {
+            return ERR_NOTSUPPORTED;
+        }
+        Properties props;
+        int64 cache_size = 0;
+        conf_set(props, name, value);
+        if (!conf_get_int64(props, name, cache_size) || cache_size <= 0)
+        {
+            return ERR_INVALID_ARGS;
+        }
+        std::stringstream s_conn;
+        s_conn << "cache_size=" << cache_size;
+        int ret = m_db->reconfigure(m_db, s_conn.str().c_str());
+        if (0 != ret)
+        {
+            WARN_LOG("Failed to reconfigure wiredtiger with %s for reason:%s", s_conn.str().c_str(), wiredtiger_strerror(ret));
+            return WT_ERR(ret);
+        }
+        g_wt_conig.cache_size = cache_size;
+        return 0;
+    }
     const std::string WiredTigerEngine::GetErrorReason(int err)
     {
         err = err - STORAGE_ENGINE_ERR_OFFSET;
         return wiredtiger_strerror(err);
     }
-    Iterator* WiredTigerEngine::Find(Context& ctx, const KeyObject& key)
+    Iterator* WiredTigerEngine::Find(Context& ctx, const KeyObject& key, const IterateOptions& options)
     {
         WiredTigerIterator* iter = NULL;
         NEW(iter, WiredTigerIterator(this,key.GetNameSpace()));
         WiredTigerLocalContext& local_ctx = GetDBLocalContext();
-        WT_CURSOR *cursor = local_ctx.GetKVStore(key.GetNameSpace(), false, true);
+        WT_CURSOR *cursor = local_ctx.GetKVStore(key.GetNameSpace(), false);
         if (NULL == cursor)
         {
             iter->MarkValid(false);
             return iter;
         }
         iter->SetCursor(cursor);
+        iter->SetIterateBounds(options);
         if (key.GetType() > 0)
         {
-            if (!ctx.flags.iterate_multi_keys)
-            {
-                if (!ctx.flags.iterate_no_upperbound)
-                {
-                    KeyObject& upperbound_key = iter->IterateUpperBoundKey();
-                    upperbound_key.SetNameSpace(key.GetNameSpace());
-                    if (key.GetType() == KEY_META)
-                    {
-                        upperbound_key.SetType(KEY_END);
-                    }
-                    else
-                    {
-                        upperbound_key.SetType(key.GetType() + 1);
-                    }
-                    upperbound_key.SetKey(key.GetKey());
-                    upperbound_key.CloneStringPart();
-                }
-            }
             iter->Jump(key);
         }
         else
@@ -621,6 +817,15 @@ namespace ardb
         (void) wiredtiger_version(&major_v, &minor_v, &patch);
         str.append("wiredtiger_version:").append(stringfromll(major_v)).append(".").append(stringfromll(minor_v)).append(".").append(stringfromll(patch)).append(
                 "\r\n");
+        str.append("wiredtiger_cursor_cache_hits:").append(stringfromll(g_cursor_cache_hits)).append("\r\n");
+        str.append("wiredtiger_cursor_cache_misses:").append(stringfromll(g_cursor_cache_misses)).append("\r\n");
+        str.append("wiredtiger_cursor_cache_evicts:").append(stringfromll(g_cursor_cache_evicts)).append("\r\n");
+        RWLockGuard<SpinRWLock> guard(m_lock, true);
+        DataSet::iterator it = m_nss.begin();
+        for (; it != m_nss.end(); it++)
+        {
+            str.append("wiredtiger_table_db").append(it->AsString()).append(":type=").append(m_btree_nss.count(*it) > 0 ? "btree" : "lsm").append("\r\n");
+        }
     }
 
     bool WiredTigerIterator::Valid()
@@ -647,6 +852,7 @@ namespace ardb
             m_valid = false;
             return;
         }
+        CheckBound();
     }
     void WiredTigerIterator::DoJump(const KeyObject& next)
     {
@@ -656,7 +862,7 @@ namespace ardb
             return;
         }
         WiredTigerLocalContext& local_ctx = GetDBLocalContext();
-        Slice key_slice = next.Encode(local_ctx.GetEncodeBuferCache());
+        Slice key_slice = next.Encode(local_ctx.GetEncodeBufferCache());
         WT_ITEM item;
         item.data = (const void*) key_slice.data();
         item.size = key_slice.size();
@@ -792,11 +998,13 @@ namespace ardb
     }
     void WiredTigerIterator::CheckBound()
     {
-        if (NULL != m_cursor && m_iterate_upper_bound_key.GetType() > 0)
+        if (NULL != m_cursor && (m_iterate_upper_bound_key.GetType() > 0 || m_iterate_lower_bound_key.GetType() > 0))
         {
             if (m_valid)
             {
-                if (Key(false).Compare(m_iterate_upper_bound_key) >= 0)
+                KeyObject& current = Key(false);
+                if ((m_iterate_upper_bound_key.GetType() > 0 && current.Compare(m_iterate_upper_bound_key) >= 0)
+                        || (m_iterate_lower_bound_key.GetType() > 0 && current.Compare(m_iterate_lower_bound_key) < 0))
                 {
                     m_valid = false;
                 }
@@ -49,6 +49,7 @@ namespace ardb
             Data m_ns;
             KeyObject m_key;
             ValueObject m_value;
+            KeyObject m_iterate_lower_bound_key;
             KeyObject m_iterate_upper_bound_key;
 
             void DoJump(const KeyObject& next);
@@ -72,9 +73,12 @@ namespace ardb
             {
                 m_cursor = c;
             }
-            KeyObject& IterateUpperBoundKey()
+            void SetIterateBounds(const IterateOptions& options)
             {
-                return m_iterate_upper_bound_key;
+                m_iterate_lower_bound_key = options.lower_bound;
+                m_iterate_lower_bound_key.CloneStringPart();
+                m_iterate_upper_bound_key = options.upper_bound;
+                m_iterate_upper_bound_key.CloneStringPart();
             }
             friend class WiredTigerEngine;
         public:
@@ -95,6 +99,7 @@ namespace ardb
         private:
             WT_CONNECTION* m_db;
             DataSet m_nss;
+            DataSet m_btree_nss; //namespaces in btree tables, the others are lsm tables
             SpinRWLock m_lock;
             friend class WiredTigerIterator;
             friend class WiredTigerLocalContext;
@@ -115,6 +120,7 @@ namespace ardb
             int Get(Context& ctx, const KeyObject& key, ValueObject& value);
             int MultiGet(Context& ctx, const KeyObjectArray& keys, ValueObjectArray& values, ErrCodeArray& errs);
             int Del(Context& ctx, const KeyObject& key);
+            int DelRange(Context& ctx, const KeyObject& start, const KeyObject& end);
             int Merge(Context& ctx, const KeyObject& key, uint16_t op, const DataArray& args);
             bool Exists(Context& ctx, const KeyObject& key);
             int BeginWriteBatch(Context& ctx);
@@ -125,7 +131,9 @@ namespace ardb
             int DropNameSpace(Context& ctx, const Data& ns);
             void Stats(Context& ctx, std::string& str);
             int64_t EstimateKeysNum(Context& ctx, const Data& ns);
-            Iterator* Find(Context& ctx, const KeyObject& key);
+            int SetOption(Context& ctx, const std::string& name, const std::string& value);
+            using Engine::Find;
+            Iterator* Find(Context& ctx, const KeyObject& key, const IterateOptions& options);
             const std::string GetErrorReason(int err);
             const FeatureSet GetFeatureSet()
             {
@@ -133,6 +141,7 @@ namespace ardb
                 features.support_compactfilter = 0;
                 features.support_namespace = 1;
                 features.support_merge = 0;
+                features.support_delete_range = 1;
                 return features;
             }
     };
@@ -30,7 +30,9 @@
 #include "logger.hpp"
 #include "util/helpers.hpp"
 #include "thread/thread_mutex.hpp"
+#include "thread/spin_mutex_lock.hpp"
 #include "thread/lock_guard.hpp"
+#include "thread/thread.hpp"
 #include <stdarg.h>
 #include <stdio.h>
 #include <sstream>
@@ -51,6 +53,33 @@ namespace ardb
 
     static ThreadMutex kLogMutex;
 
+    /*
+     * With a log buffer, records are appended to 'kLogPending' and the log writer thread writes them to the file in
+     * batches, a worker only holds the spin lock to copy its line. Records are dropped & counted while the buffer is
+     * full. A record identical to the previous one is only counted, the count is logged once another record comes or
+     * at the next flush, so a repeating record costs at most two lines per flush period.
+     */
+    static const uint32 k_log_flush_period = 100; //ms
+    static SpinMutexLock kLogBufferLock;
+    static std::string kLogPending;
+    static size_t kLogBufferLimit = 0;
+    static std::string kLogLastRecord;
+    static uint32 kLogRepeated = 0;
+    static uint64 kLogDroppedUnreported = 0;
+    static volatile uint64 kLogDropped = 0;
+
+    class LogWriterThread: public Thread
+    {
+        public:
+            volatile bool running;
+            LogWriterThread() :
+                    running(true)
+            {
+            }
+            void Run();
+    };
+    static LogWriterThread* kLogWriter = NULL;
+
     static void reopen_default_logfile()
     {
         if (!kLogFilePath.empty())
@@ -97,11 +126,106 @@ namespace ardb
         rename(kLogFilePath.c_str(), path.c_str());
     }
 
+    static void format_log_line(const char* levelstr, const std::string& record, std::string& line)
+    {
+        uint64_t timestamp = get_current_epoch_millis();
+        uint32 mills = timestamp % 1000;
+        char timetag[256];
+        struct tm& tm = get_current_tm();
+        sprintf(timetag, "[%u] %02u-%02u %02u:%02u:%02u,%03u %s ", getpid(), tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min,
+                tm.tm_sec, mills, levelstr);
+        line.append(timetag).append(record).append("\n");
+    }
+
+    static void write_log_lines(const char* lines, size_t len)
+    {
+        LockGuard<ThreadMutex> guard(kLogMutex);
+        fwrite(lines, 1, len, kLogFile);
+        fflush(kLogFile);
+        if (!kLogFilePath.empty() && kLogFile != stdout)
+        {
+            long file_size = ftell(kLogFile);
+            if (file_size < 0)
+            {
+                reopen_default_logfile();
+            }
+            else if ((uint32) file_size >= k_max_file_size)
+            {
+                rollover_default_logfile();
+                reopen_default_logfile();
+            }
+        }
+    }
+
+    /*
+     * Called with 'kLogBufferLock' held.
+     */
+    static void append_repeated_record()
+    {
+        if (kLogRepeated > 0)
+        {
+            format_log_line("INFO", "Last log record repeated " + stringfromll(kLogRepeated) + " times.", kLogPending);
+            kLogRepeated = 0;
+        }
+    }
+
+    static void flush_log_buffer()
+    {
+        std::string batch;
+        uint64 dropped = 0;
+        {
+            LockGuard<SpinMutexLock> guard(kLogBufferLock);
+            append_repeated_record();
+            kLogLastRecord.clear();
+            batch.swap(kLogPending);
+            dropped = kLogDroppedUnreported;
+            kLogDroppedUnreported = 0;
+        }
+        if (dropped > 0)
+        {
+            format_log_line("WARN", stringfromll(dropped) + " log records dropped since the log buffer is full.", batch);
+        }
+        if (!batch.empty())
+        {
+            write_log_lines(batch.data(), batch.size());
+        }
+    }
+
+    void LogWriterThread::Run()
+    {
+        while (running)
+        {
+            Thread::Sleep(k_log_flush_period);
+            flush_log_buffer();
+        }
+        flush_log_buffer();
+    }
+
+    static void buffer_log_record(const char* levelstr, const std::string& record)
+    {
+        std::string line;
+        format_log_line(levelstr, record, line);
+        LockGuard<SpinMutexLock> guard(kLogBufferLock);
+        if (kLogLastRecord.size() == record.size() + 1 && kLogLastRecord[0] == levelstr[0] && !kLogLastRecord.compare(1, record.size(), record))
+        {
+            kLogRepeated++;
+            return;
+        }
+        if (kLogPending.size() + line.size() > kLogBufferLimit)
+        {
+            kLogDroppedUnreported++;
+            kLogDropped++;
+            return;
+        }
+        append_repeated_record();
+        kLogLastRecord.assign(1, levelstr[0]).append(record);
+        kLogPending.append(line);
+    }
+
     static void default_loghandler(LogLevel level, const char* filename, const char* function, int line,
                     const char* format, ...)
     {
         const char* levelstr = 0;
-        uint64_t timestamp = get_current_epoch_millis();
         if (level > 0 && level < ALL_LOG_LEVEL)
         {
             levelstr = kLogLevelNames[level - 1];
@@ -140,26 +264,21 @@ namespace ardb
             DELETE_A(content);
         }
 
-        uint32 mills = timestamp % 1000;
-        char timetag[256];
-        struct tm& tm = get_current_tm();
-        sprintf(timetag, "%02u-%02u %02u:%02u:%02u", tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
-        LockGuard<ThreadMutex> guard(kLogMutex);
-        fprintf(kLogFile, "[%u] %s,%03u %s %s\n", getpid(), timetag, mills, levelstr, record.c_str());
-        fflush(kLogFile);
-        if (!kLogFilePath.empty() && kLogFile != stdout)
+        if (NULL != kLogWriter)
         {
-            long file_size = ftell(kLogFile);
-            if (file_size < 0)
-            {
-                reopen_default_logfile();
-            }
-            else if ((uint32) file_size >= k_max_file_size)
+            /*
+             * the process aborts after a fatal record, which is written at once after the buffered ones
+             */
+            if (level > FATAL_LOG_LEVEL)
             {
-                rollover_default_logfile();
-                reopen_default_logfile();
+                buffer_log_record(levelstr, record);
+                return;
             }
+            flush_log_buffer();
         }
+        std::string log_line;
+        format_log_line(levelstr, record, log_line);
+        write_log_lines(log_line.data(), log_line.size());
     }
 
     static bool default_logchcker(LogLevel level)
@@ -202,7 +321,7 @@ namespace ardb
         }
     }
 
-    void ArdbLogger::InitDefaultLogger(const std::string& level, const std::string& logfile)
+    void ArdbLogger::InitDefaultLogger(const std::string& level, const std::string& logfile, size_t buffer_size)
     {
         if (!logfile.empty() && (logfile != "stdout" && logfile != "stderr"))
         {
@@ -210,10 +329,28 @@ namespace ardb
             reopen_default_logfile();
         }
         SetLogLevel(level);
+        if (buffer_size > 0 && NULL == kLogWriter)
+        {
+            kLogBufferLimit = buffer_size;
+            kLogWriter = new LogWriterThread;
+            kLogWriter->Start();
+        }
+    }
+
+    uint64_t ArdbLogger::DroppedRecords()
+    {
+        return kLogDropped;
     }
 
     void ArdbLogger::DestroyDefaultLogger()
     {
+        if (NULL != kLogWriter)
+        {
+            kLogWriter->running = false;
+            kLogWriter->Join();
+            delete kLogWriter;
+            kLogWriter = NULL;
+        }
         if (kLogFile != stdout)
         {
             fclose(kLogFile);
@@ -31,6 +31,7 @@
 #define LOGGER_MACROS_HPP_
 
 #include <string>
+#include <stdint.h>
 
 namespace ardb
 {
@@ -68,10 +69,14 @@ namespace ardb
             static ArdbLogHandler* GetLogHandler();
             static IsLogEnable* GetLogChecker();
             static void InstallLogHandler(LoggerSetting& setting);
+            /*
+             * With a non zero 'buffer_size' records are buffered up to that many bytes & written by a log writer thread.
+             */
             static void InitDefaultLogger(const std::string& level,
-                            const std::string& logfile);
+                            const std::string& logfile, size_t buffer_size = 0);
             static void SetLogLevel(const std::string& level);
             static void DestroyDefaultLogger();
+            static uint64_t DroppedRecords();
             static FILE* GetLogStream();
     };
 }
@@ -0,0 +1,255 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "metrics.hpp"
+#include "db/db.hpp"
+#include <map>
+
+OP_NAMESPACE_BEGIN
+
+    static const size_t kMaxMetricsRequestSize = 8192;
+
+    static std::string metric_name(const std::string& s)
+    {
+        std::string name = s;
+        for (size_t i = 0; i < name.size(); i++)
+        {
+            char c = name[i];
+            if (!isalnum(c) && c != '_')
+            {
+                name[i] = '_';
+            }
+        }
+        return name;
+    }
+
+    static std::string metric_label_value(const std::string& s)
+    {
+        std::string value;
+        for (size_t i = 0; i < s.size(); i++)
+        {
+            if (s[i] == '\\' || s[i] == '"')
+            {
+                value.push_back('\\');
+            }
+            value.push_back(s[i]);
+        }
+        return value;
+    }
+
+    /*
+     * numbers with an optional '%' suffix are the number itself
+     */
+    static bool metric_value(const std::string& s, std::string& value)
+    {
+        if (s.empty())
+        {
+            return false;
+        }
+        char* end = NULL;
+        double v = strtod(s.c_str(), &end);
+        if (end == s.c_str() || (*end != 0 && strcmp(end, "%") != 0))
+        {
+            return false;
+        }
+        char tmp[64];
+        snprintf(tmp, sizeof(tmp), "%.17g", v);
+        value = tmp;
+        return true;
+    }
+
+    typedef std::map<std::string, std::vector<std::string> > MetricFamilies;
+
+    void MetricsService::RenderInfo(const std::string& info, std::string& metrics)
+    {
+        MetricFamilies families;
+        std::vector<std::string> lines = split_string(info, "\r\n");
+        std::string section;
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            const std::string& line = lines[i];
+            if (line.empty())
+            {
+                continue;
+            }
+            if (line[0] == '#')
+            {
+                section = metric_name(string_tolower(trim_string(line.substr(1))));
+                continue;
+            }
+            size_t pos = line.find(':');
+            if (pos == std::string::npos || pos == 0)
+            {
+                continue;
+            }
+            std::string key = line.substr(0, pos);
+            std::string val = line.substr(pos + 1);
+            std::string number;
+            if (metric_value(val, number))
+            {
+                std::string name = "ardb_" + metric_name(key);
+                families[name].push_back(name + " " + number);
+            }
+            else if (val.find('=') != std::string::npos)
+            {
+                std::vector<std::string> fields = split_string(val, ",");
+                for (size_t j = 0; j < fields.size(); j++)
+                {
+                    size_t eq = fields[j].find('=');
+                    if (eq == std::string::npos || !metric_value(fields[j].substr(eq + 1), number))
+                    {
+                        continue;
+                    }
+                    std::string name = "ardb_" + section + "_" + metric_name(fields[j].substr(0, eq));
+                    families[name].push_back(name + "{key=\"" + metric_label_value(key) + "\"} " + number);
+                }
+            }
+            else if (val.find(' ') == std::string::npos && val.size() <= 256)
+            {
+                std::string name = "ardb_" + metric_name(key);
+                families[name].push_back(name + "{value=\"" + metric_label_value(val) + "\"} 1");
+            }
+        }
+        MetricFamilies::iterator it = families.begin();
+        for (; it != families.end(); it++)
+        {
+            metrics.append("# TYPE ").append(it->first).append(" gauge\n");
+            for (size_t i = 0; i < it->second.size(); i++)
+            {
+                metrics.append(it->second[i]).append("\n");
+            }
+        }
+        metrics.append("# EOF\n");
+    }
+
+    class MetricsHandler: public ChannelUpstreamHandler<Buffer>
+    {
+        private:
+            void Reply(Channel* ch, const char* status, const char* content_type, const std::string& body)
+            {
+                std::string response = "HTTP/1.1 ";
+                response.append(status).append("\r\nContent-Type: ").append(content_type).append("\r\nContent-Length: ").append(
+                        stringfromll(body.size())).append("\r\nConnection: close\r\n\r\n").append(body);
+                Buffer content(const_cast<char*>(response.data()), 0, response.size());
+                ch->Write(content);
+                ch->Close();
+            }
+        public:
+            void MessageReceived(ChannelHandlerContext& ctx, MessageEvent<Buffer>& e)
+            {
+                Buffer& buffer = *(e.GetMessage());
+                std::string request(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
+                size_t end = request.find("\r\n\r\n");
+                if (end == std::string::npos)
+                {
+                    if (request.size() > kMaxMetricsRequestSize)
+                    {
+                        ctx.GetChannel()->Close();
+                    }
+                    return;
+                }
+                buffer.Clear();
+                std::vector<std::string> request_line = split_string(request.substr(0, request.find("\r\n")), " ");
+                if (request_line.size() != 3 || request_line[0] != "GET")
+                {
+                    Reply(ctx.GetChannel(), "405 Method Not Allowed", "text/plain", "GET only\n");
+                    return;
+                }
+                const std::string& path = request_line[1];
+                if (path != "/metrics" && path.compare(0, 9, "/metrics?") != 0)
+                {
+                    Reply(ctx.GetChannel(), "404 Not Found", "text/plain", "Try /metrics\n");
+                    return;
+                }
+                Context info_ctx;
+                std::string info, metrics;
+                g_db->FillInfoResponse(info_ctx, "all", info);
+                MetricsService::RenderInfo(info, metrics);
+                Reply(ctx.GetChannel(), "200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8", metrics);
+            }
+    };
+
+    static void metrics_pipeline_init(ChannelPipeline* pipeline, void* data)
+    {
+        MetricsHandler* handler = NULL;
+        NEW(handler, MetricsHandler);
+        pipeline->AddLast("handler", handler);
+    }
+
+    static void metrics_pipeline_destroy(ChannelPipeline* pipeline, void* data)
+    {
+        ChannelHandler* handler = pipeline->Get("handler");
+        DELETE(handler);
+    }
+
+    MetricsService::MetricsService() :
+            m_serv(1024), m_started(false)
+    {
+    }
+
+    int MetricsService::Start()
+    {
+        if (g_db->GetConf().metrics_port <= 0)
+        {
+            return 0;
+        }
+        SocketHostAddress address(g_db->GetConf().metrics_host, g_db->GetConf().metrics_port);
+        ServerSocketChannel* server = m_serv.NewServerSocketChannel();
+        if (!server->Bind(&address))
+        {
+            ERROR_LOG("Failed to bind metrics listener on %s:%lld", g_db->GetConf().metrics_host.c_str(), g_db->GetConf().metrics_port);
+            return -1;
+        }
+        ChannelOptions ops;
+        ops.reuse_address = true;
+        server->Configure(ops);
+        server->SetChannelPipelineInitializor(metrics_pipeline_init, NULL);
+        server->SetChannelPipelineFinalizer(metrics_pipeline_destroy, NULL);
+        Thread::Start();
+        m_started = true;
+        INFO_LOG("Ardb serves metrics on http://%s:%lld/metrics", g_db->GetConf().metrics_host.c_str(), g_db->GetConf().metrics_port);
+        return 0;
+    }
+
+    void MetricsService::Run()
+    {
+        m_serv.Start();
+    }
+
+    void MetricsService::Stop()
+    {
+        if (!m_started)
+        {
+            return;
+        }
+        m_serv.Stop();
+        Join();
+        m_started = false;
+    }
+
+OP_NAMESPACE_END
@@ -0,0 +1,59 @@
+/*
+ *Copyright (c) 2013-2014, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef METRICS_HPP_
+#define METRICS_HPP_
+#include "common/common.hpp"
+#include "channel/all_includes.hpp"
+#include "thread/thread.hpp"
+
+OP_NAMESPACE_BEGIN
+
+    /*
+     * HTTP listener('metrics-port') answering 'GET /metrics' with the INFO fields in the OpenMetrics text format.
+     * It runs its own event loop thread, scrapes never queue behind commands on the worker threads.
+     */
+    class MetricsService: public Thread
+    {
+        private:
+            ChannelService m_serv;
+            volatile bool m_started;
+            void Run();
+        public:
+            MetricsService();
+            int Start();
+            void Stop();
+            /*
+             * INFO 'key:value' fields are 'ardb_<key>' gauges, fields of 'key:k1=v1,k2=v2' lines are
+             * 'ardb_<section>_<k>{key="<key>"}' gauges, non numeric values are the 'value' label of a gauge of 1.
+             */
+            static void RenderInfo(const std::string& info, std::string& metrics);
+    };
+
+OP_NAMESPACE_END
+#endif /* METRICS_HPP_ */
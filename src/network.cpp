@@ -27,28 +27,121 @@
  *THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "thread/thread_local.hpp"
+#include "thread/thread_mutex_lock.hpp"
+#include "thread/lock_guard.hpp"
 #include "db/db.hpp"
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include "network.hpp"
+#include "metrics.hpp"
+#include "coro/scheduler.hpp"
 #include "repl/repl.hpp"
+#include "util/system_helper.hpp"
 
 OP_NAMESPACE_BEGIN
     static ThreadLocal<RedisReplyPool> g_reply_pool;
     static QPSTrack g_total_qps;
     static CountTrack g_total_connections_received;
     static CountTrack g_rejected_connections;
+    static QPSTrack g_connection_rate;
+    static CountTrack g_rebalanced_connections;
+    static CountTrack g_routed_commands;
+
+    class RedisRequestHandler;
+    /*
+     * Per event loop thread load, sampled every connection-rebalance-period.
+     */
+    struct LoopLoad
+    {
+            ChannelService* service;
+            uint64 last_check_ustime;
+            uint64 last_cpu_ustime;
+            std::set<RedisRequestHandler*> handlers;
+            LoopLoad() :
+                    service(NULL), last_check_ustime(0), last_cpu_ustime(0)
+            {
+            }
+    };
+    static ThreadLocal<LoopLoad> g_loop_load;
+    /*
+     * indexed by pool index, every thread only writes its own slot
+     */
+    static std::vector<ChannelService*> g_loop_services;
+    static std::vector<uint32> g_loop_cpu_percent;
+    /*
+     * number of keyspace partitions in thread-per-core mode, partition i is owned by the sub pool thread i+1
+     */
+    static uint32 g_thread_partitions = 0;
+    static void rebalance_connections();
+
+    static void pipelineInit(ChannelPipeline* pipeline, void* data);
+    static void pipelineDestroy(ChannelPipeline* pipeline, void* data);
 
     class ServerLifecycleHandler: public ChannelServiceLifeCycle, public Runnable
     {
+        private:
+            const ChannelOptions* m_options;
+            std::vector<QPSTrack*> m_server_tracks;
             void Run()
             {
-                g_db->ScanClients();
+                rebalance_connections();
+            }
+            /*
+             * Every sub pool thread listens on the tcp addresses with its own SO_REUSEPORT socket,
+             * so the kernel spreads new connections over the threads and they are accepted locally.
+             */
+            void StartReusePortListeners(ChannelService* serv)
+            {
+#ifdef SO_REUSEPORT
+                for (uint32 i = 0; i < g_db->GetConf().servers.size(); i++)
+                {
+                    const ListenPoint& lp = g_db->GetConf().servers[i];
+                    if (lp.port == 0)
+                    {
+                        continue;
+                    }
+                    SocketHostAddress socket_address(lp.host, lp.port);
+                    ServerSocketChannel* server = serv->NewServerSocketChannel();
+                    server->SetReusePort(true);
+                    if (!server->Bind(&socket_address))
+                    {
+                        ERROR_LOG("Failed to bind reuseport listener on %s:%u", lp.host.c_str(), lp.port);
+                        server->Close();
+                        continue;
+                    }
+                    server->Configure(*m_options);
+                    server->SetChannelPipelineInitializor(pipelineInit, m_server_tracks[i]);
+                    server->SetChannelPipelineFinalizer(pipelineDestroy, NULL);
+                }
+#endif
             }
             void OnStart(ChannelService* serv, uint32 idx)
             {
                 serv->GetTimer().Schedule(this, 1, 1000 / g_db->GetConf().hz, MILLIS);
+                if (idx < g_loop_services.size())
+                {
+                    g_loop_services[idx] = serv;
+                    g_loop_load.GetValue().service = serv;
+                }
                 g_reply_pool.GetValue().SetMaxSize(g_db->GetConf().reply_pool_size);
+                /*
+                 * One cpu per event loop thread, its connection buffers & reply pools are first touched on the
+                 * node of that cpu.
+                 */
+                const std::vector<int>& cpus = g_db->GetConf().worker_cpus;
+                if (!cpus.empty())
+                {
+                    std::vector<int> cpu(1, cpus[idx % cpus.size()]);
+                    if (0 != bind_current_thread(cpu))
+                    {
+                        WARN_LOG("Failed to bind event loop thread:%u to cpu:%d", idx, cpu[0]);
+                    }
+                }
+                if (idx > 0 && g_db->GetConf().tcp_reuseport)
+                {
+                    StartReusePortListeners(serv);
+                }
             }
             void OnStop(ChannelService* serv, uint32 idx)
             {
@@ -58,9 +151,224 @@ OP_NAMESPACE_BEGIN
             {
 
             }
+        public:
+            ServerLifecycleHandler() :
+                    m_options(NULL)
+            {
+            }
+            void SetListenOptions(const ChannelOptions* options, const std::vector<QPSTrack*>& tracks)
+            {
+                m_options = options;
+                m_server_tracks = tracks;
+            }
+    };
+
+    /*
+     * One shot timer task checking the idle & blocking timeouts of a connection, it looks the connection up
+     * by id, so it does nothing once the connection is closed or moved to another event loop thread.
+     */
+    struct ClientTimerTask: public Runnable
+    {
+            ChannelService* service;
+            uint32 channel_id;
+            ClientTimerTask(ChannelService* s, uint32 id) :
+                    service(s), channel_id(id)
+            {
+            }
+            void Run();
+    };
+
+    /*
+     * Worker threads executing storage engine calls outside the event loop threads.
+     */
+    class EngineIOPool
+    {
+        private:
+            struct Worker: public Thread
+            {
+                    EngineIOPool* pool;
+                    Worker(EngineIOPool* p) :
+                            pool(p)
+                    {
+                    }
+                    void Run()
+                    {
+                        if (!g_db->GetConf().cron_cpus.empty() && 0 != bind_current_thread(g_db->GetConf().cron_cpus))
+                        {
+                            WARN_LOG("Failed to bind engine io thread to cron-cpus.");
+                        }
+                        pool->Work();
+                    }
+            };
+            ThreadMutexLock m_lock;
+            std::deque<Runnable*> m_tasks;
+            std::vector<Thread*> m_workers;
+            bool m_running;
+            void Work()
+            {
+                while (true)
+                {
+                    Runnable* task = NULL;
+                    {
+                        LockGuard<ThreadMutexLock> guard(m_lock);
+                        while (m_running && m_tasks.empty())
+                        {
+                            m_lock.Wait();
+                        }
+                        if (m_tasks.empty())
+                        {
+                            return;
+                        }
+                        task = m_tasks.front();
+                        m_tasks.pop_front();
+                    }
+                    task->Run();
+                }
+            }
+        public:
+            EngineIOPool() :
+                    m_running(false)
+            {
+            }
+            void Start(uint32 size)
+            {
+                m_running = true;
+                for (uint32 i = 0; i < size; i++)
+                {
+                    Thread* worker = NULL;
+                    NEW(worker, Worker(this));
+                    worker->Start();
+                    m_workers.push_back(worker);
+                }
+            }
+            bool IsEnabled() const
+            {
+                return !m_workers.empty();
+            }
+            void Submit(Runnable* task)
+            {
+                LockGuard<ThreadMutexLock> guard(m_lock);
+                m_tasks.push_back(task);
+                m_lock.Notify();
+            }
+            void Stop()
+            {
+                {
+                    LockGuard<ThreadMutexLock> guard(m_lock);
+                    m_running = false;
+                    m_lock.NotifyAll();
+                }
+                for (size_t i = 0; i < m_workers.size(); i++)
+                {
+                    m_workers[i]->Join();
+                    DELETE(m_workers[i]);
+                }
+                m_workers.clear();
+            }
+    };
+    static EngineIOPool g_read_io_pool;
+    static EngineIOPool g_write_io_pool;
+    /*
+     * heavy commands run here instead of the event loop/engine io threads
+     */
+    static EngineIOPool g_slow_cmd_pool;
+
+    /*
+     * Coroutines of an event loop thread running lock free reads('coro-requests'), a finished one is parked for the
+     * next request instead of freeing its stack.
+     */
+    class RequestCoroPool
+    {
+        private:
+            struct RequestCoro
+            {
+                    RequestCoroPool* pool;
+                    Coroutine* coro;
+                    CoroutineFunc* func;
+                    void* data;
+                    RequestCoro(RequestCoroPool* p) :
+                            pool(p), coro(NULL), func(NULL), data(NULL)
+                    {
+                    }
+            };
+            std::vector<RequestCoro*> m_idle;
+            static void CoroMain(void* data)
+            {
+                RequestCoro* rc = (RequestCoro*) data;
+                Scheduler& scheduler = Scheduler::CurrentScheduler();
+                rc->coro = scheduler.GetCurrentCoroutine();
+                while (true)
+                {
+                    rc->func(rc->data);
+                    rc->func = NULL;
+                    rc->data = NULL;
+                    rc->pool->m_idle.push_back(rc);
+                    scheduler.Wait(rc->coro);
+                }
+            }
+        public:
+            /*
+             * Returns when 'func' finished or yielded.
+             */
+            void Execute(CoroutineFunc* func, void* data)
+            {
+                if (m_idle.empty())
+                {
+                    RequestCoro* rc = NULL;
+                    NEW(rc, RequestCoro(this));
+                    rc->func = func;
+                    rc->data = data;
+                    Scheduler::CurrentScheduler().StartCoro(0, CoroMain, rc);
+                    return;
+                }
+                RequestCoro* rc = m_idle.back();
+                m_idle.pop_back();
+                rc->func = func;
+                rc->data = data;
+                Scheduler::CurrentScheduler().Wakeup(rc->coro);
+            }
     };
+    static ThreadLocal<RequestCoroPool> g_request_coros;
 
-    class RedisRequestHandler: public ChannelUpstreamHandler<RedisCommandFrame>
+    /*
+     * Engine reads of request coroutines missing the engine caches run in the engine io read threads, the coroutine
+     * yields to the event loop until the read is done.
+     */
+    struct EngineBlockingTask: public Runnable
+    {
+            Runnable* task;
+            Coroutine* coro;
+            ChannelService* service;
+            void Run()
+            {
+                task->Run();
+                service->AsyncIO(0, Resume, this);
+            }
+            static void Resume(Channel* ch, void* data)
+            {
+                EngineBlockingTask* blocking = (EngineBlockingTask*) data;
+                Scheduler::CurrentScheduler().Wakeup(blocking->coro);
+            }
+    };
+    static void coro_engine_blocking_call(Context& ctx, Runnable* task)
+    {
+        Scheduler& scheduler = Scheduler::CurrentScheduler();
+        if (!ctx.flags.request_coro || scheduler.IsInMainCoro() || NULL == ctx.client || NULL == ctx.client->client)
+        {
+            task->Run();
+            return;
+        }
+        EngineBlockingTask blocking;
+        blocking.task = task;
+        blocking.coro = scheduler.GetCurrentCoroutine();
+        blocking.service = &(ctx.client->client->GetService());
+        EngineProfile* profile = CurrentEngineProfile();
+        g_read_io_pool.Submit(&blocking);
+        scheduler.Wait(blocking.coro);
+        CurrentEngineProfile() = profile;
+    }
+
+    class RedisRequestHandler: public ChannelUpstreamHandler<RedisCommandFrame>, public Runnable
     {
         private:
             QPSTrack* qpsTrack;
@@ -69,22 +377,192 @@ OP_NAMESPACE_BEGIN
             bool m_delete_after_processing;
             RedisReplyPool* pool;
 
+            /*
+             * state of the command running in engine io pool, commands received meanwhile are queued
+             * to keep the replies in order.
+             */
+            bool m_async_processing;
+            bool m_free_after_processing;
+            bool m_async_slow;
+            int m_async_ret;
+            ChannelService* m_async_service;
+            uint32 m_async_channel_id;
+            RedisCommandFrame m_async_cmd;
+            RedisReplyPool m_async_reply_pool;
+            std::deque<RedisCommandFrame> m_pending_cmds;
+            /*
+             * the async command runs in a request coroutine, it is finished by AsyncCommandDone only if it yielded
+             */
+            bool m_coro_running;
+            bool m_coro_yielded;
+            /*
+             * micros spent in commands executed in the event loop thread since the last rebalance check
+             */
+            uint64 m_busy_micros;
+            /*
+             * the armed ClientTimerTask, it is not moved later on activity, it re-arms itself when it fires
+             */
+            ChannelService* m_timer_service;
+            int32 m_timer_task_id;
+            int64 m_timer_deadline;
+
             void MessageReceived(ChannelHandlerContext& ctx, MessageEvent<RedisCommandFrame>& e)
+            {
+                if (m_async_processing)
+                {
+                    m_pending_cmds.push_back(*(e.GetMessage()));
+                    return;
+                }
+                if (!m_pending_cmds.empty())
+                {
+                    m_pending_cmds.push_back(*(e.GetMessage()));
+                    ProcessPendingCommands(ctx.GetChannel());
+                    return;
+                }
+                ProcessCommand(ctx.GetChannel(), *(e.GetMessage()));
+            }
+            /*
+             * Stops when a command is submitted to engine io pool again or the channel stops reading
+             * input (e.g. its output exceeds the soft limit), the rest are resumed by later events.
+             */
+            bool ProcessPendingCommands(Channel* ch)
+            {
+                while (!m_pending_cmds.empty() && !ch->IsReadBlocked())
+                {
+                    RedisCommandFrame cmd = m_pending_cmds.front();
+                    m_pending_cmds.pop_front();
+                    if (!ProcessCommand(ch, cmd))
+                    {
+                        return false;
+                    }
+                }
+                g_db->CommitPipelineBatch(m_ctx);
+                return true;
+            }
+            void ChannelWritable(ChannelHandlerContext& ctx, ChannelStateEvent& e)
+            {
+                if (!m_async_processing && !m_client_ctx.processing && !m_pending_cmds.empty())
+                {
+                    ProcessPendingCommands(ctx.GetChannel());
+                }
+            }
+            /*
+             * Return false if the command is submitted to engine io pool, or the handler is deleted/the connection is closing.
+             */
+            bool ProcessCommand(Channel* ch, RedisCommandFrame& cmd)
             {
                 m_client_ctx.last_interaction_ustime = get_current_epoch_micros();
-                m_client_ctx.client = ctx.GetChannel();
-                RedisCommandFrame* cmd = e.GetMessage();
-                ChannelService& serv = m_client_ctx.client->GetService();
-                uint32 channel_id = ctx.GetChannel()->GetID();
+                m_client_ctx.client = ch;
                 m_client_ctx.processing = true;
+                bool is_write = false;
+                if (g_thread_partitions > 1)
+                {
+                    int32 partition = g_db->GetCommandPartition(m_ctx, cmd, g_thread_partitions);
+                    ChannelService* owner = partition >= 0 ? g_loop_services[partition + 1] : NULL;
+                    if (NULL != owner && owner != &(ch->GetService()))
+                    {
+                        g_db->CommitPipelineBatch(m_ctx);
+                        PrepareAsyncCommand(ch, cmd);
+                        g_routed_commands.Add(1);
+                        owner->AsyncIO(0, RunOnOwner, this);
+                        return false;
+                    }
+                }
+                if (g_slow_cmd_pool.IsEnabled() && g_db->IsSlowCommand(m_ctx, cmd))
+                {
+                    g_db->CommitPipelineBatch(m_ctx);
+                    PrepareAsyncCommand(ch, cmd);
+                    m_async_slow = true;
+                    g_slow_cmd_pool.Submit(this);
+                    return false;
+                }
+                if (g_db->GetConf().coro_requests && g_read_io_pool.IsEnabled() && g_db->IsRequestCoroCommand(m_ctx, cmd))
+                {
+                    g_db->CommitPipelineBatch(m_ctx);
+                    PrepareAsyncCommand(ch, cmd);
+                    m_coro_running = true;
+                    m_coro_yielded = false;
+                    g_request_coros.GetValue().Execute(RunInCoro, this);
+                    if (m_coro_running)
+                    {
+                        m_coro_yielded = true;
+                        return false;
+                    }
+                    m_async_processing = false;
+                    return CommandDone(m_async_ret);
+                }
+                if ((g_read_io_pool.IsEnabled() || g_write_io_pool.IsEnabled()) && g_db->IsEngineIOCommand(m_ctx, cmd, is_write))
+                {
+                    EngineIOPool& io_pool = is_write ? g_write_io_pool : g_read_io_pool;
+                    if (io_pool.IsEnabled())
+                    {
+                        g_db->CommitPipelineBatch(m_ctx);
+                        PrepareAsyncCommand(ch, cmd);
+                        io_pool.Submit(this);
+                        return false;
+                    }
+                }
                 if (NULL == pool)
                 {
                     pool = &(g_reply_pool.GetValue());
                 }
-                pool->Clear();
-                m_ctx.SetReply(&(pool->Allocate()));
+                RedisReplyPool* reply_pool = pool;
+                reply_pool->Clear();
+                m_ctx.SetReply(&(reply_pool->Allocate()));
+                /*
+                 * pipelined writes share one engine write batch until the decoded input is handled(ChannelReadComplete)
+                 */
+                g_db->JoinPipelineBatch(m_ctx, cmd);
+                int ret = g_db->Call(m_ctx, cmd);
+                m_busy_micros += get_current_epoch_micros() - m_client_ctx.last_interaction_ustime;
+                bool done = CommandDone(ret);
+                /*
+                 * the reply has been encoded into the channel, recycle all its nodes at once,
+                 * 'this' may be deleted already.
+                 */
+                reply_pool->Clear();
+                return done;
+            }
+            void PrepareAsyncCommand(Channel* ch, RedisCommandFrame& cmd)
+            {
+                m_async_cmd = cmd;
+                m_async_service = &(ch->GetService());
+                m_async_channel_id = ch->GetID();
+                m_async_reply_pool.Clear();
+                m_ctx.SetReply(&(m_async_reply_pool.Allocate()));
+                m_async_processing = true;
+            }
+            /*
+             * Executed in a request coroutine of the event loop thread
+             */
+            static void RunInCoro(void* data)
+            {
+                RedisRequestHandler* handler = (RedisRequestHandler*) data;
+                handler->m_ctx.flags.request_coro = 1;
+                handler->m_async_ret = g_db->Call(handler->m_ctx, handler->m_async_cmd);
+                handler->m_ctx.flags.request_coro = 0;
+                handler->m_coro_running = false;
+                if (handler->m_coro_yielded)
+                {
+                    handler->m_async_service->AsyncIO(handler->m_async_channel_id, AsyncCommandDone, handler);
+                }
+            }
+            /*
+             * Executed in the event loop thread owning the keys of the command, the reply is written back by
+             * the connection's thread in AsyncCommandDone.
+             */
+            static void RunOnOwner(Channel*, void* data)
+            {
+                RedisRequestHandler* handler = (RedisRequestHandler*) data;
+                handler->m_async_ret = g_db->Call(handler->m_ctx, handler->m_async_cmd);
+                handler->m_async_service->AsyncIO(handler->m_async_channel_id, AsyncCommandDone, handler);
+            }
+            /*
+             * Return false if the handler is deleted or the connection is closing.
+             */
+            bool CommandDone(int ret)
+            {
                 RedisReply& reply = m_ctx.GetReply();
-                int ret = g_db->Call(m_ctx, *cmd);
                 if(NULL != qpsTrack)
                 {
                     qpsTrack->IncMsgCount(1);
@@ -92,11 +570,13 @@ OP_NAMESPACE_BEGIN
                 g_total_qps.IncMsgCount(1);
                 if (m_delete_after_processing)
                 {
+                    g_db->CommitPipelineBatch(m_ctx);
                     delete this;
-                    return;
+                    return false;
                 }
                 if (reply.type != 0)
                 {
+                    reply.disposable = true;
                     m_client_ctx.client->Write(reply);
                 }
                 if (ret < -1)
@@ -107,29 +587,92 @@ OP_NAMESPACE_BEGIN
                         root = root->GetParent();
                     }
                     root->Stop();
-                    return;
+                    return false;
                 }
                 else if (-1 == ret)
                 {
                     m_client_ctx.client->Close();
+                    m_client_ctx.processing = false;
+                    m_ctx.ClearState();
+                    return false;
                 }
                 m_client_ctx.processing = false;
                 m_client_ctx.last_interaction_ustime = get_current_epoch_micros();
                 m_ctx.ClearState();
                 //reply.Clear();
+                if (0 == m_timer_task_id || m_ctx.IsBlocking())
+                {
+                    ScheduleClientTimer();
+                }
+                return true;
+            }
+            /*
+             * Executed in engine io pool or slow command pool thread
+             */
+            void Run()
+            {
+                m_ctx.flags.slow_command = m_async_slow ? 1 : 0;
+                m_async_ret = g_db->Call(m_ctx, m_async_cmd);
+                m_ctx.flags.slow_command = 0;
+                m_async_slow = false;
+                m_async_service->AsyncIO(m_async_channel_id, AsyncCommandDone, this);
+            }
+            static void AsyncCommandDone(Channel* ch, void* data)
+            {
+                RedisRequestHandler* handler = (RedisRequestHandler*) data;
+                handler->OnAsyncCommandDone(ch);
+            }
+            void OnAsyncCommandDone(Channel* ch)
+            {
+                m_async_processing = false;
+                if (m_free_after_processing)
+                {
+                    g_db->FreeClient(m_ctx);
+                }
+                if (NULL == ch || m_free_after_processing)
+                {
+                    m_pending_cmds.clear();
+                    m_client_ctx.processing = false;
+                    if (m_delete_after_processing)
+                    {
+                        delete this;
+                    }
+                    return;
+                }
+                m_client_ctx.client = ch;
+                if (!CommandDone(m_async_ret))
+                {
+                    return;
+                }
+                ProcessPendingCommands(ch);
+            }
+            void ChannelReadComplete(ChannelHandlerContext& ctx, ChannelStateEvent& e)
+            {
+                g_db->CommitPipelineBatch(m_ctx);
             }
             void ChannelClosed(ChannelHandlerContext& ctx, ChannelStateEvent& e)
             {
+                g_loop_load.GetValue().handlers.erase(this);
+                CancelClientTimer();
+                if (m_async_processing)
+                {
+                    m_free_after_processing = true;
+                    return;
+                }
+                g_db->CommitPipelineBatch(m_ctx);
                 g_db->FreeClient(m_ctx);
             }
             void ChannelConnected(ChannelHandlerContext& ctx, ChannelStateEvent& e)
             {
                 g_total_connections_received.Add(1);
+                g_connection_rate.IncMsgCount(1);
                 m_client_ctx.uptime = get_current_epoch_micros();
                 m_client_ctx.last_interaction_ustime = get_current_epoch_micros();
                 m_client_ctx.client = ctx.GetChannel();
-                m_client_ctx.clientid.id = ctx.GetChannel()->GetID();
-                m_client_ctx.clientid.ctx = &m_ctx;
+                m_client_ctx.ctx = &m_ctx;
+                m_client_ctx.client->SetOutputLimits((uint32) g_db->GetConf().normal_client_output_buffer_soft_limit,
+                        (uint32) g_db->GetConf().normal_client_output_buffer_hard_limit);
+                g_loop_load.GetValue().handlers.insert(this);
                 //m_client_ctx.client->Attach(&m_ctx, NULL);
                 if (!g_db->GetConf().requirepass.empty())
                 {
@@ -165,25 +708,183 @@ OP_NAMESPACE_BEGIN
                 {
                     g_db->AddClient(m_ctx);
                 }
+                ScheduleClientTimer();
+            }
+            /*
+             * Arms the client timer for the next idle/blocking deadline unless an armed one fires earlier.
+             */
+            void ScheduleClientTimer()
+            {
+                int64 deadline = g_db->ClientCron(m_ctx);
+                if (deadline <= 0 || (0 != m_timer_task_id && m_timer_deadline <= deadline))
+                {
+                    return;
+                }
+                CancelClientTimer();
+                Channel* ch = m_client_ctx.client;
+                int64 delay = (deadline - (int64) get_current_epoch_micros() + 999) / 1000;
+                m_timer_service = &(ch->GetService());
+                m_timer_task_id = m_timer_service->GetTimer().ScheduleHeapTask(new ClientTimerTask(m_timer_service, ch->GetID()),
+                        delay > 0 ? delay : 1, -1, MILLIS);
+                m_timer_deadline = deadline;
+            }
+            void CancelClientTimer()
+            {
+                if (0 != m_timer_task_id)
+                {
+                    m_timer_service->GetTimer().Cancel(m_timer_task_id);
+                    m_timer_task_id = 0;
+                }
             }
         public:
             RedisRequestHandler(QPSTrack* track) :
-                qpsTrack(track), m_delete_after_processing(false), pool(NULL)
+                qpsTrack(track), m_delete_after_processing(false), pool(NULL), m_async_processing(false), m_free_after_processing(false), m_async_slow(false), m_async_ret(0), m_async_service(
+                        NULL), m_async_channel_id(0), m_coro_running(false), m_coro_yielded(false), m_busy_micros(0), m_timer_service(NULL), m_timer_task_id(0), m_timer_deadline(0)
             {
                 m_ctx.client = &m_client_ctx;
                 //root_reply.SetPool(&pool);
                 //m_ctx.SetReply(&root_reply);
                 //pool.SetMaxSize(g_db->GetConf().reply_pool_size);
             }
+            void OnClientTimer()
+            {
+                m_timer_task_id = 0;
+                ScheduleClientTimer();
+            }
             bool IsProcessing()
             {
-                return m_client_ctx.processing;
+                return m_client_ctx.processing || m_async_processing;
             }
             void EnableSelfDeleteAfterProcessing()
             {
                 m_delete_after_processing = true;
             }
+            uint64 TakeBusyMicros()
+            {
+                uint64 busy = m_busy_micros;
+                m_busy_micros = 0;
+                return busy;
+            }
+            /*
+             * Only a connection without any in flight command, queued input or pending output is moved,
+             * the destination thread attaches its fd & client in its own loop.
+             */
+            bool MigrateTo(ChannelService& dst)
+            {
+                Channel* ch = m_client_ctx.client;
+                if (NULL == ch || IsProcessing() || m_coro_running || !m_pending_cmds.empty() || ch->WritableBytes() > 0 || ch->IsReadBlocked()
+                        || ch->IsDetached())
+                {
+                    return false;
+                }
+                if (!g_db->CanMigrateClient(m_ctx))
+                {
+                    return false;
+                }
+                g_loop_load.GetValue().handlers.erase(this);
+                CancelClientTimer();
+                ch->GetService().DetachChannel(ch, true);
+                dst.AsyncIO(0, MigrateDone, this);
+                return true;
+            }
+            static void MigrateDone(Channel*, void* data)
+            {
+                RedisRequestHandler* handler = (RedisRequestHandler*) data;
+                LoopLoad& load = g_loop_load.GetValue();
+                /*
+                 * reply pools are per thread
+                 */
+                handler->pool = NULL;
+                load.service->AttachChannel(handler->m_client_ctx.client, true);
+                load.handlers.insert(handler);
+                handler->ScheduleClientTimer();
+                g_rebalanced_connections.Add(1);
+            }
     };
+
+    void ClientTimerTask::Run()
+    {
+        Channel* ch = service->GetChannel(channel_id);
+        if (NULL != ch)
+        {
+            RedisRequestHandler* handler = (RedisRequestHandler*) ch->GetPipeline().Get("handler");
+            if (NULL != handler)
+            {
+                handler->OnClientTimer();
+            }
+        }
+    }
+
+    static void rebalance_connections()
+    {
+        LoopLoad& load = g_loop_load.GetValue();
+        int64 period = g_db->GetConf().connection_rebalance_period;
+        uint32 idx = NULL == load.service ? 0 : load.service->GetPoolIndex();
+        /*
+         * connections live in the sub pool threads [1-n] only
+         */
+        if (period <= 0 || idx == 0 || g_loop_services.size() <= 2)
+        {
+            return;
+        }
+        uint64 now = get_current_epoch_micros();
+        if (now - load.last_check_ustime < (uint64) period * 1000000)
+        {
+            return;
+        }
+#ifdef RUSAGE_THREAD
+        struct rusage ru;
+        if (0 != getrusage(RUSAGE_THREAD, &ru))
+        {
+            return;
+        }
+        uint64 cpu_ustime = (uint64) (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+        bool first_check = load.last_check_ustime == 0;
+        if (!first_check)
+        {
+            g_loop_cpu_percent[idx] = (uint32) ((cpu_ustime - load.last_cpu_ustime) * 100 / (now - load.last_check_ustime));
+        }
+        load.last_check_ustime = now;
+        load.last_cpu_ustime = cpu_ustime;
+        RedisRequestHandler* hottest = NULL;
+        uint64 hottest_busy = 0;
+        std::set<RedisRequestHandler*>::iterator it = load.handlers.begin();
+        while (it != load.handlers.end())
+        {
+            uint64 busy = (*it)->TakeBusyMicros();
+            if (busy > hottest_busy)
+            {
+                hottest_busy = busy;
+                hottest = *it;
+            }
+            it++;
+        }
+        if (first_check || NULL == hottest)
+        {
+            return;
+        }
+        uint32 target = 0;
+        for (uint32 i = 1; i < g_loop_services.size(); i++)
+        {
+            if (i != idx && NULL != g_loop_services[i] && (0 == target || g_loop_cpu_percent[i] < g_loop_cpu_percent[target]))
+            {
+                target = i;
+            }
+        }
+        if (0 == target || g_loop_cpu_percent[idx] < g_loop_cpu_percent[target] + (uint32) g_db->GetConf().connection_rebalance_cpu_diff)
+        {
+            return;
+        }
+        /*
+         * at most one connection per period, the loads are measured again before the next one moves
+         */
+        if (hottest->MigrateTo(*g_loop_services[target]))
+        {
+            DEBUG_LOG("Moved a connection from event loop thread:%u(%u%% cpu) to thread:%u(%u%% cpu)", idx, g_loop_cpu_percent[idx], target,
+                    g_loop_cpu_percent[target]);
+        }
+#endif
+    }
     static void pipelineInit(ChannelPipeline* pipeline, void* data)
     {
         QPSTrack* init_data = (QPSTrack*) data;
@@ -198,6 +899,7 @@ OP_NAMESPACE_BEGIN
         handler = pipeline->Get("encoder");
         DELETE(handler);
         RedisRequestHandler* rhandler = (RedisRequestHandler*) pipeline->Get("handler");
+        g_loop_load.GetValue().handlers.erase(rhandler);
         if (NULL != rhandler && rhandler->IsProcessing())
         {
             rhandler->EnableSelfDeleteAfterProcessing();
@@ -217,6 +919,19 @@ OP_NAMESPACE_BEGIN
         Statistics::GetSingleton().AddTrack(&g_total_connections_received);
         g_rejected_connections.name = "rejected_connections";
         Statistics::GetSingleton().AddTrack(&g_rejected_connections);
+        g_connection_rate.name = "connections_accepted";
+        g_connection_rate.qpsName = "instantaneous_connections_per_sec";
+        g_connection_rate.dump_flags = 0; //reported in the clients section of INFO
+        Statistics::GetSingleton().AddTrack(&g_connection_rate);
+        g_rebalanced_connections.name = "rebalanced_connections";
+        Statistics::GetSingleton().AddTrack(&g_rebalanced_connections);
+        g_routed_commands.name = "thread_routed_commands";
+        Statistics::GetSingleton().AddTrack(&g_routed_commands);
+    }
+
+    uint64 Server::ConnectionsPerSecond()
+    {
+        return g_connection_rate.QPS();
     }
 
     Server::Server() :
@@ -231,11 +946,39 @@ OP_NAMESPACE_BEGIN
             ERROR_LOG("Failed to init replication service.");
             return -1;
         }
+        if (aeSetApi(g_db->GetConf().multiplexing_api.c_str()) != AE_OK)
+        {
+            WARN_LOG("Multiplexing api '%s' is not available, use %s instead.", g_db->GetConf().multiplexing_api.c_str(), aeGetApiName());
+        }
+        BufferPool::SetSharedLimit((size_t) g_db->GetConf().channel_buffer_pool_size);
         m_service = new ChannelService(g_db->GetConf().max_open_files);
         m_service->SetThreadPoolSize(g_db->GetConf().thread_pool_size);
-        INFO_LOG("Thread pool size %d", g_db->GetConf().thread_pool_size);
+        INFO_LOG("Thread pool size %d, multiplexing api %s", g_db->GetConf().thread_pool_size, aeGetApiName());
+        g_read_io_pool.Start(g_db->GetConf().io_read_threads);
+        g_write_io_pool.Start(g_db->GetConf().io_write_threads);
+        g_slow_cmd_pool.Start(g_db->GetConf().slow_command_threads);
+        if (g_read_io_pool.IsEnabled() || g_write_io_pool.IsEnabled())
+        {
+            INFO_LOG("Engine io pool size read:%d write:%d", g_db->GetConf().io_read_threads, g_db->GetConf().io_write_threads);
+        }
+        if (g_slow_cmd_pool.IsEnabled())
+        {
+            INFO_LOG("Slow command pool size:%d", g_db->GetConf().slow_command_threads);
+        }
+        if (g_db->GetConf().coro_requests && g_read_io_pool.IsEnabled())
+        {
+            g_engine_blocking_call = coro_engine_blocking_call;
+            INFO_LOG("Lock free reads run in request coroutines, cache misses yield to the event loop.");
+        }
         ServerLifecycleHandler lifecycle;
         m_service->RegisterLifecycleCallback(&lifecycle);
+        g_loop_services.assign(g_db->GetConf().thread_pool_size + 1, (ChannelService*) NULL);
+        g_loop_cpu_percent.assign(g_db->GetConf().thread_pool_size + 1, 0);
+        if (g_db->GetConf().thread_per_core && g_db->GetConf().thread_pool_size > 1)
+        {
+            g_thread_partitions = (uint32) g_db->GetConf().thread_pool_size;
+            INFO_LOG("Thread per core mode with %u keyspace partitions", g_thread_partitions);
+        }
 
         ChannelOptions ops;
         ops.tcp_nodelay = true;
@@ -244,11 +987,14 @@ OP_NAMESPACE_BEGIN
         {
             ops.keep_alive = g_db->GetConf().tcp_keepalive;
         }
+        ops.cork_output_bytes = (uint32) g_db->GetConf().reply_cork_bytes;
 
         init_statistics_setting();
 
         std::vector<QPSTrack> serverQpsTracks;
         serverQpsTracks.resize(g_db->GetConf().servers.size());
+        std::vector<QPSTrack*> serverQpsTrackRefs(g_db->GetConf().servers.size(), (QPSTrack*) NULL);
+        bool reuse_port = g_db->GetConf().tcp_reuseport && g_db->GetConf().thread_pool_size > 1;
         for (uint32 i = 0; i < g_db->GetConf().servers.size(); i++)
         {
             ServerSocketChannel* server = NULL;
@@ -269,6 +1015,7 @@ OP_NAMESPACE_BEGIN
             {
                 SocketHostAddress socket_address(host, g_db->GetConf().servers[i].port);
                 server = m_service->NewServerSocketChannel();
+                server->SetReusePort(reuse_port);
                 if (!server->Bind(&socket_address))
                 {
                     ERROR_LOG("Failed to bind on %s:%u", host.c_str(), g_db->GetConf().servers[i].port);
@@ -285,19 +1032,35 @@ OP_NAMESPACE_BEGIN
                 serverQPSTrack->qpsName = address + "_instantaneous_ops_per_sec";
                 Statistics::GetSingleton().AddTrack(serverQPSTrack);
             }
+            serverQpsTrackRefs[i] = serverQPSTrack;
             server->SetChannelPipelineInitializor(pipelineInit, serverQPSTrack);
             server->SetChannelPipelineFinalizer(pipelineDestroy, NULL);
             server->BindThreadPool(0, g_db->GetConf().thread_pool_size);
             INFO_LOG("Ardb will accept connections on %s", address.c_str());
         }
 
+        if (reuse_port)
+        {
+            lifecycle.SetListenOptions(&ops, serverQpsTrackRefs);
+            INFO_LOG("Every thread of the pool accepts tcp connections with SO_REUSEPORT");
+        }
         StartCrons();
-
-        INFO_LOG("Ardb started with version %s", ARDB_VERSION);
-        m_service->Start();
+        {
+            MetricsService metrics;
+            if (0 == metrics.Start())
+            {
+                INFO_LOG("Ardb started with version %s", ARDB_VERSION);
+                m_service->Start();
+                metrics.Stop();
+            }
+        }
         StopCrons();
         g_repl->StopService();
         sexit:
+        g_read_io_pool.Stop();
+        g_write_io_pool.Stop();
+        g_slow_cmd_pool.Stop();
+        g_db->SaveKeyCache();
         DELETE(m_service);
         return 0;
     }
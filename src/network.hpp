@@ -47,6 +47,7 @@ OP_NAMESPACE_BEGIN
         public:
             Server();
             int Start();
+            static uint64 ConnectionsPerSecond();
             ~Server();
     };
 OP_NAMESPACE_END
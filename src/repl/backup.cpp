@@ -0,0 +1,711 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "backup.hpp"
+#include "repl.hpp"
+#include "db/db.hpp"
+#include "bgjobs.hpp"
+#include "thread/lock_guard.hpp"
+#include "util/file_helper.hpp"
+#include "util/string_helper.hpp"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <set>
+
+#define BACKUP_META_FILE "BACKUP_META"
+#define BACKUP_WAL_FILE "REPL_WAL"
+
+namespace ardb
+{
+    static const size_t kbackup_copy_buffer_size = 1024 * 1024;
+    static const int64_t kbackup_wal_chunk_size = 4 * 1024 * 1024;
+
+    static BackupManager g_backup_manager_instance;
+    BackupManager* g_backup_manager = &g_backup_manager_instance;
+
+    static void remove_backup_dir(const std::string& dir)
+    {
+        std::deque<std::string> files;
+        list_subfiles(dir, files);
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            unlink((dir + "/" + files[i]).c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
+    /*
+     * Copy into 'dest'.tmp & rename, a half copied file never takes the final name.
+     */
+    static int copy_backup_file(const std::string& src, const std::string& dest, uint64& copied)
+    {
+        std::string tmp = dest + ".tmp";
+        FILE* in = fopen(src.c_str(), "r");
+        if (NULL == in)
+        {
+            ERROR_LOG("Failed to open file:%s for reason:%s", src.c_str(), strerror(errno));
+            return -1;
+        }
+        FILE* out = fopen(tmp.c_str(), "w");
+        if (NULL == out)
+        {
+            ERROR_LOG("Failed to create file:%s for reason:%s", tmp.c_str(), strerror(errno));
+            fclose(in);
+            return -1;
+        }
+        std::string buf;
+        buf.resize(kbackup_copy_buffer_size);
+        int ret = 0;
+        size_t len;
+        while ((len = fread(&buf[0], 1, buf.size(), in)) > 0)
+        {
+            BackgroundJobs::GetSingleton().Request(len);
+            if (fwrite(&buf[0], len, 1, out) != 1)
+            {
+                ret = -1;
+                break;
+            }
+            copied += len;
+        }
+        if (0 == ret && ferror(in))
+        {
+            ret = -1;
+        }
+        fflush(out);
+        fsync(fileno(out));
+        fclose(out);
+        fclose(in);
+        if (0 == ret && 0 != rename(tmp.c_str(), dest.c_str()))
+        {
+            ret = -1;
+        }
+        if (0 != ret)
+        {
+            ERROR_LOG("Failed to copy file:%s to %s", src.c_str(), dest.c_str());
+            unlink(tmp.c_str());
+        }
+        return ret;
+    }
+
+    uint64 BackupInfo::TotalSize() const
+    {
+        uint64 total = wal_size;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            total += files[i].size;
+        }
+        return total;
+    }
+
+    BackupManager::BackupManager() :
+            m_running(false), m_last_backup_time(0), m_last_err(0)
+    {
+    }
+
+    std::string BackupManager::Root()
+    {
+        return g_db->GetConf().backup_dir + "/engine-backup";
+    }
+    std::string BackupManager::SharedDir()
+    {
+        return Root() + "/shared";
+    }
+    std::string BackupManager::BackupDir(uint32 id)
+    {
+        return Root() + "/" + stringfromll(id);
+    }
+
+    int BackupManager::ListIds(std::vector<uint32>& ids)
+    {
+        std::deque<std::string> dirs;
+        list_subdirs(Root(), dirs);
+        for (size_t i = 0; i < dirs.size(); i++)
+        {
+            uint32 id = 0;
+            if (string_touint32(dirs[i], id) && id > 0 && is_file_exist(BackupDir(id) + "/" + BACKUP_META_FILE))
+            {
+                ids.push_back(id);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        return 0;
+    }
+
+    /*
+     * BACKUP_META is a text file, one 'name value' line per field & one 'file <shared|private> <name> <stored> <size>'
+     * line per checkpoint file.
+     */
+    int BackupManager::LoadInfo(uint32 id, BackupInfo& info)
+    {
+        std::string content;
+        if (0 != file_read_full(BackupDir(id) + "/" + BACKUP_META_FILE, content))
+        {
+            return -1;
+        }
+        info.id = id;
+        std::vector<std::string> lines = split_string(content, "\n");
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            std::vector<std::string> cols = split_string(lines[i], " ");
+            if (cols.size() == 5 && cols[0] == "file")
+            {
+                BackupFile file;
+                file.shared = cols[1] == "shared";
+                file.name = cols[2];
+                file.stored = cols[3];
+                string_touint64(cols[4], file.size);
+                info.files.push_back(file);
+                continue;
+            }
+            if (cols.size() < 2)
+            {
+                if (cols.size() == 1 && cols[0] == "repl_ns")
+                {
+                    info.repl_ns.clear();
+                }
+                continue;
+            }
+            uint64 v = 0;
+            string_touint64(cols[1], v);
+            if (cols[0] == "engine")
+                info.engine = cols[1];
+            else if (cols[0] == "create_time")
+                info.create_time = (time_t) v;
+            else if (cols[0] == "repl_offset")
+                info.repl_offset = v;
+            else if (cols[0] == "repl_ns")
+                info.repl_ns = cols[1];
+            else if (cols[0] == "wal_start")
+                info.wal_start = v;
+            else if (cols[0] == "wal_size")
+                info.wal_size = v;
+            else if (cols[0] == "copied_bytes")
+                info.copied_bytes = v;
+        }
+        return info.engine.empty() ? -1 : 0;
+    }
+
+    static int save_backup_meta(const std::string& dir, const BackupInfo& info)
+    {
+        std::string content;
+        content.append("engine ").append(info.engine).append("\n");
+        content.append("create_time ").append(stringfromll(info.create_time)).append("\n");
+        content.append("repl_offset ").append(stringfromll(info.repl_offset)).append("\n");
+        content.append("repl_ns ").append(info.repl_ns).append("\n");
+        content.append("wal_start ").append(stringfromll(info.wal_start)).append("\n");
+        content.append("wal_size ").append(stringfromll(info.wal_size)).append("\n");
+        content.append("copied_bytes ").append(stringfromll(info.copied_bytes)).append("\n");
+        for (size_t i = 0; i < info.files.size(); i++)
+        {
+            const BackupFile& file = info.files[i];
+            content.append("file ").append(file.shared ? "shared " : "private ").append(file.name).append(" ").append(file.stored).append(" ").append(
+                    stringfromll(file.size)).append("\n");
+        }
+        return file_write_content(dir + "/" + BACKUP_META_FILE, content);
+    }
+
+    int BackupManager::List(std::vector<BackupInfo>& infos)
+    {
+        std::vector<uint32> ids;
+        ListIds(ids);
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            BackupInfo info;
+            if (0 == LoadInfo(ids[i], info))
+            {
+                infos.push_back(info);
+            }
+        }
+        return 0;
+    }
+
+    time_t BackupManager::LastBackupTime()
+    {
+        LockGuard<ThreadMutexLock> guard(m_lock);
+        if (0 == m_last_backup_time)
+        {
+            std::vector<uint32> ids;
+            ListIds(ids);
+            BackupInfo info;
+            if (!ids.empty() && 0 == LoadInfo(ids.back(), info))
+            {
+                m_last_backup_time = info.create_time;
+            }
+        }
+        return m_last_backup_time;
+    }
+
+    struct BackupWALWriter
+    {
+            FILE* fp;
+            uint64 written;
+            bool err;
+            static int Append(const void* log, size_t loglen, void* data)
+            {
+                BackupWALWriter* writer = (BackupWALWriter*) data;
+                if (!writer->err && fwrite(log, loglen, 1, writer->fp) != 1)
+                {
+                    writer->err = true;
+                }
+                writer->written += loglen;
+                return 0;
+            }
+    };
+
+    /*
+     * The replication log between the previous backup & this one, the part already overwritten in the backlog is
+     * lost & such a backup can NOT be the target of a point in time restore from the previous backup.
+     */
+    int BackupManager::CopyWAL(BackupInfo& info, const BackupInfo* prev)
+    {
+        info.wal_start = info.wal_size = 0;
+        if (NULL == prev || !g_repl->IsInited())
+        {
+            return 0;
+        }
+        ReplicationBacklog& backlog = g_repl->GetReplLog();
+        uint64 start = prev->repl_offset;
+        if (start < backlog.WALStartOffset())
+        {
+            WARN_LOG("Replication log since backup:%u at offset:%llu is overwritten, backup:%u can NOT replay writes after backup:%u.", prev->id,
+                    prev->repl_offset, info.id, prev->id);
+            start = backlog.WALStartOffset();
+        }
+        if (start >= info.repl_offset)
+        {
+            info.wal_start = info.repl_offset;
+            return 0;
+        }
+        std::string path = Root() + "/tmp." + stringfromll(info.id) + "/" + BACKUP_WAL_FILE;
+        BackupWALWriter writer;
+        writer.fp = fopen(path.c_str(), "w");
+        writer.written = 0;
+        writer.err = NULL == writer.fp;
+        if (writer.err)
+        {
+            ERROR_LOG("Failed to create file:%s", path.c_str());
+            return -1;
+        }
+        uint64 offset = start;
+        while (offset < info.repl_offset && !writer.err)
+        {
+            int64_t len = info.repl_offset - offset;
+            if (len > kbackup_wal_chunk_size)
+            {
+                len = kbackup_wal_chunk_size;
+            }
+            uint64 before = writer.written;
+            backlog.Replay(offset, len, BackupWALWriter::Append, &writer);
+            if (writer.written == before)
+            {
+                /*
+                 * overwritten while copying
+                 */
+                writer.err = true;
+                break;
+            }
+            BackgroundJobs::GetSingleton().Request(writer.written - before);
+            offset += writer.written - before;
+        }
+        fflush(writer.fp);
+        fsync(fileno(writer.fp));
+        fclose(writer.fp);
+        if (writer.err)
+        {
+            ERROR_LOG("Failed to copy replication log within [%llu, %llu) into backup:%u", start, info.repl_offset, info.id);
+            return -1;
+        }
+        info.wal_start = start;
+        info.wal_size = writer.written;
+        info.copied_bytes += writer.written;
+        return 0;
+    }
+
+    int BackupManager::DoCreate(BackupInfo& info)
+    {
+        if (!g_engine->GetFeatureSet().support_checkpoint)
+        {
+            ERROR_LOG("Engine %s can NOT create incremental backups.", g_engine_name);
+            return -1;
+        }
+        make_dir(Root());
+        make_dir(SharedDir());
+        std::vector<uint32> ids;
+        ListIds(ids);
+        BackupInfo prev;
+        bool has_prev = !ids.empty() && 0 == LoadInfo(ids.back(), prev) && prev.engine == g_engine_name;
+        info.id = ids.empty() ? 1 : ids.back() + 1;
+        info.create_time = time(NULL);
+        info.engine = g_engine_name;
+        if (g_repl->IsInited())
+        {
+            /*
+             * the offset is taken before the checkpoint, replaying from it may apply again the last writes already in
+             * the checkpoint, same as the full resync snapshots.
+             */
+            g_repl->GetReplLog().WaitWALWritten();
+            info.repl_offset = g_repl->GetReplLog().WALEndOffset();
+            info.repl_ns = g_repl->GetReplLog().CurrentNamespace();
+        }
+        char checkpoint[1024];
+        snprintf(checkpoint, sizeof(checkpoint) - 1, "%s/%s-backup.%u.%u", g_db->GetConf().data_base_path.c_str(), g_engine_name, getpid(),
+                (uint32) info.create_time);
+        std::string tmpdir = Root() + "/tmp." + stringfromll(info.id);
+        remove_backup_dir(tmpdir);
+        make_dir(tmpdir);
+        Context ctx;
+        int ret = g_engine->Checkpoint(ctx, checkpoint);
+        if (0 != ret)
+        {
+            ERROR_LOG("Failed to create engine checkpoint:%s", checkpoint);
+            remove_backup_dir(tmpdir);
+            return ret;
+        }
+        std::deque<std::string> files;
+        list_subfiles(checkpoint, files);
+        for (size_t i = 0; 0 == ret && i < files.size(); i++)
+        {
+            std::string path = std::string(checkpoint) + "/" + files[i];
+            struct stat st;
+            if (0 != stat(path.c_str(), &st))
+            {
+                ret = -1;
+                break;
+            }
+            BackupFile file;
+            file.name = files[i];
+            file.size = st.st_size;
+            /*
+             * table files are never modified once written, the same name, size & mtime is the same file
+             */
+            file.shared = has_suffix(files[i], ".sst");
+            if (file.shared)
+            {
+                file.stored = files[i] + "_" + stringfromll(st.st_size) + "_" + stringfromll(st.st_mtime);
+                std::string dest = SharedDir() + "/" + file.stored;
+                if (!is_file_exist(dest))
+                {
+                    ret = copy_backup_file(path, dest, info.copied_bytes);
+                }
+            }
+            else
+            {
+                file.stored = files[i];
+                ret = copy_backup_file(path, tmpdir + "/" + file.stored, info.copied_bytes);
+            }
+            info.files.push_back(file);
+        }
+        remove_backup_dir(checkpoint);
+        if (0 == ret)
+        {
+            ret = CopyWAL(info, has_prev ? &prev : NULL);
+        }
+        if (0 == ret)
+        {
+            ret = save_backup_meta(tmpdir, info);
+        }
+        if (0 == ret && 0 != rename(tmpdir.c_str(), BackupDir(info.id).c_str()))
+        {
+            ERROR_LOG("Failed to rename backup dir:%s for reason:%s", tmpdir.c_str(), strerror(errno));
+            ret = -1;
+        }
+        if (0 != ret)
+        {
+            remove_backup_dir(tmpdir);
+        }
+        return ret;
+    }
+
+    int BackupManager::Create(BackupInfo& info)
+    {
+        {
+            LockGuard<ThreadMutexLock> guard(m_lock);
+            if (m_running)
+            {
+                ERROR_LOG("There is already a backup running.");
+                return -1;
+            }
+            m_running = true;
+        }
+        uint64 start = get_current_epoch_millis();
+        int ret = -1;
+        {
+            BackgroundJobScope job(BGJOB_SNAPSHOT, true);
+            if (job.started)
+            {
+                ret = DoCreate(info);
+            }
+            else
+            {
+                ERROR_LOG("Snapshot jobs are paused, skip creating backup.");
+            }
+        }
+        if (0 == ret)
+        {
+            INFO_LOG("Created backup:%u with %llu bytes copied of %llu bytes in %llums.", info.id, info.copied_bytes, info.TotalSize(),
+                    get_current_epoch_millis() - start);
+            if (g_db->GetConf().backup_incremental_keep > 0)
+            {
+                Purge(g_db->GetConf().backup_incremental_keep);
+            }
+        }
+        LockGuard<ThreadMutexLock> guard(m_lock);
+        m_last_err = ret;
+        m_last_backup_time = time(NULL);
+        m_running = false;
+        return ret;
+    }
+
+    int BackupManager::BGCreate()
+    {
+        if (m_running)
+        {
+            ERROR_LOG("There is already a backup running.");
+            return -1;
+        }
+        struct BGTask: public Thread
+        {
+                BackupManager* manager;
+                BGTask(BackupManager* m) :
+                        manager(m)
+                {
+                }
+                void Run()
+                {
+                    BackupInfo info;
+                    manager->Create(info);
+                    delete this;
+                }
+        };
+        BGTask* task = new BGTask(this);
+        task->Start();
+        return 0;
+    }
+
+    int BackupManager::ReplayWAL(const BackupInfo& next, uint64 start_offset, const std::string& start_ns, uint64 until_offset)
+    {
+        std::string path = BackupDir(next.id) + "/" + BACKUP_WAL_FILE;
+        FILE* fp = fopen(path.c_str(), "r");
+        if (NULL == fp)
+        {
+            ERROR_LOG("Failed to open replication log:%s", path.c_str());
+            return -1;
+        }
+        Context ctx;
+        ctx.flags.no_wal = 1;
+        ctx.ns.SetString(start_ns.empty() ? "0" : start_ns, false);
+        Buffer buffer;
+        std::string chunk;
+        chunk.resize(kbackup_copy_buffer_size);
+        uint64 offset = start_offset;
+        uint64 replayed = 0;
+        int ret = 0;
+        size_t len;
+        while (0 == ret && offset < until_offset && (len = fread(&chunk[0], 1, chunk.size(), fp)) > 0)
+        {
+            buffer.Write(chunk.data(), len);
+            while (buffer.Readable() && offset < until_offset)
+            {
+                while (buffer.Readable() && (buffer.GetRawReadBuffer()[0] == '\r' || buffer.GetRawReadBuffer()[0] == '\n'))
+                {
+                    buffer.AdvanceReadIndex(1);
+                    offset++;
+                }
+                if (!buffer.Readable())
+                {
+                    break;
+                }
+                size_t mark = buffer.GetReadIndex();
+                RedisCommandFrame cmd;
+                if (!RedisCommandDecoder::Decode(NULL, buffer, cmd))
+                {
+                    if (buffer.GetReadIndex() != mark)
+                    {
+                        ERROR_LOG("Corrupted replication log:%s at offset:%llu", path.c_str(), offset);
+                        ret = -1;
+                    }
+                    break;
+                }
+                uint64 cmd_end = offset + buffer.GetReadIndex() - mark;
+                if (cmd_end > until_offset)
+                {
+                    offset = until_offset;
+                    break;
+                }
+                offset = cmd_end;
+                if (!cmd.GetCommand().empty())
+                {
+                    g_db->Call(ctx, cmd);
+                    replayed++;
+                }
+            }
+            buffer.DiscardReadedBytes();
+        }
+        fclose(fp);
+        INFO_LOG("Replayed %llu commands of backup:%u until offset:%llu", replayed, next.id, offset);
+        return ret;
+    }
+
+    int BackupManager::Restore(uint32 id, uint64 until_offset)
+    {
+        BackupInfo info;
+        if (0 != LoadInfo(id, info))
+        {
+            ERROR_LOG("No backup:%u", id);
+            return -1;
+        }
+        if (info.engine != g_engine_name)
+        {
+            ERROR_LOG("Can't restore backup of %s into %s", info.engine.c_str(), g_engine_name);
+            return -1;
+        }
+        BackupInfo next;
+        if (until_offset > 0 && until_offset != info.repl_offset)
+        {
+            std::vector<uint32> ids;
+            ListIds(ids);
+            std::vector<uint32>::iterator it = std::upper_bound(ids.begin(), ids.end(), id);
+            if (it == ids.end() || 0 != LoadInfo(*it, next) || next.wal_start != info.repl_offset || next.wal_size == 0 || until_offset < info.repl_offset
+                    || until_offset > next.repl_offset)
+            {
+                ERROR_LOG("No replication log from backup:%u at offset:%llu until offset:%llu", id, info.repl_offset, until_offset);
+                return -1;
+            }
+        }
+        char dir[1024];
+        snprintf(dir, sizeof(dir) - 1, "%s/%s-restore.%u.%u", g_db->GetConf().data_base_path.c_str(), g_engine_name, getpid(), (uint32) time(NULL));
+        remove_backup_dir(dir);
+        make_dir(dir);
+        int ret = 0;
+        for (size_t i = 0; 0 == ret && i < info.files.size(); i++)
+        {
+            const BackupFile& file = info.files[i];
+            std::string dest = std::string(dir) + "/" + file.name;
+            if (file.shared)
+            {
+                /*
+                 * the engine never modifies table files, they may be linked instead of copied
+                 */
+                std::string src = SharedDir() + "/" + file.stored;
+                uint64 copied = 0;
+                if (0 != link(src.c_str(), dest.c_str()))
+                {
+                    ret = copy_backup_file(src, dest, copied);
+                }
+            }
+            else
+            {
+                uint64 copied = 0;
+                ret = copy_backup_file(BackupDir(id) + "/" + file.stored, dest, copied);
+            }
+        }
+        if (0 == ret)
+        {
+            ret = g_db->RestoreEngine(dir);
+        }
+        if (0 != ret)
+        {
+            remove_backup_dir(dir);
+            return ret;
+        }
+        INFO_LOG("Engine restored from backup:%u", id);
+        if (next.id > 0)
+        {
+            ret = ReplayWAL(next, info.repl_offset, info.repl_ns, until_offset);
+        }
+        return ret;
+    }
+
+    int BackupManager::RemoveUnreferencedSharedFiles()
+    {
+        std::vector<BackupInfo> infos;
+        List(infos);
+        std::set<std::string> referenced;
+        for (size_t i = 0; i < infos.size(); i++)
+        {
+            for (size_t j = 0; j < infos[i].files.size(); j++)
+            {
+                if (infos[i].files[j].shared)
+                {
+                    referenced.insert(infos[i].files[j].stored);
+                }
+            }
+        }
+        std::deque<std::string> files;
+        list_subfiles(SharedDir(), files);
+        int removed = 0;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            if (referenced.count(files[i]) == 0)
+            {
+                unlink((SharedDir() + "/" + files[i]).c_str());
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    int BackupManager::Purge(uint32 keep)
+    {
+        std::vector<uint32> ids;
+        ListIds(ids);
+        int removed = 0;
+        for (size_t i = 0; i + keep < ids.size(); i++)
+        {
+            /*
+             * the meta goes first, a partly removed backup is no more listed
+             */
+            unlink((BackupDir(ids[i]) + "/" + BACKUP_META_FILE).c_str());
+            remove_backup_dir(BackupDir(ids[i]));
+            removed++;
+        }
+        if (removed > 0)
+        {
+            int files = RemoveUnreferencedSharedFiles();
+            INFO_LOG("Removed %d backups & %d shared files.", removed, files);
+        }
+        return removed;
+    }
+
+    void BackupManager::Routine()
+    {
+        int64 period = g_db->GetConf().backup_incremental_period;
+        if (period <= 0 || m_running || g_db->IsLoadingData())
+        {
+            return;
+        }
+        if (time(NULL) - LastBackupTime() >= period)
+        {
+            BGCreate();
+        }
+    }
+}
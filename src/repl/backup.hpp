@@ -0,0 +1,131 @@
+/*
+ *Copyright (c) 2013-2013, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BACKUP_HPP_
+#define BACKUP_HPP_
+#include <string>
+#include <vector>
+#include "common.hpp"
+#include "thread/thread_mutex_lock.hpp"
+
+namespace ardb
+{
+    struct BackupFile
+    {
+            std::string name; //file name in the engine checkpoint
+            std::string stored; //file name under 'shared' or the backup dir
+            uint64 size;
+            bool shared;
+            BackupFile() :
+                    size(0), shared(false)
+            {
+            }
+    };
+
+    struct BackupInfo
+    {
+            uint32 id;
+            time_t create_time;
+            std::string engine;
+            uint64 repl_offset; //replication log end offset before the checkpoint
+            std::string repl_ns; //namespace selected at 'repl_offset'
+            uint64 wal_start; //'REPL_WAL' holds the replication log within [wal_start, repl_offset)
+            uint64 wal_size;
+            uint64 copied_bytes; //bytes copied by this backup, shared files already backed up are not copied again
+            std::vector<BackupFile> files;
+            BackupInfo() :
+                    id(0), create_time(0), repl_offset(0), wal_start(0), wal_size(0), copied_bytes(0)
+            {
+            }
+            uint64 TotalSize() const;
+    };
+
+    /*
+     * Incremental engine backups under <backup-dir>/engine-backup:
+     *   shared/<name>_<size>_<mtime>   immutable table files(*.sst) of the checkpoints, copied by the first backup
+     *                                  referencing them & kept while any backup still references them
+     *   <id>/                          the other checkpoint files(MANIFEST, CURRENT, OPTIONS, engine logs)
+     *   <id>/BACKUP_META               engine, replication offset & the file list
+     *   <id>/REPL_WAL                  the replication log since the previous backup
+     * A backup restores by linking/copying its files into a new engine dir, the 'REPL_WAL' of the next backup then
+     * replays the writes between two backups up to a given replication offset.
+     */
+    class BackupManager
+    {
+        private:
+            ThreadMutexLock m_lock;
+            volatile bool m_running;
+            time_t m_last_backup_time;
+            int m_last_err;
+            std::string Root();
+            std::string SharedDir();
+            std::string BackupDir(uint32 id);
+            int LoadInfo(uint32 id, BackupInfo& info);
+            int SaveInfo(const BackupInfo& info);
+            int CopyWAL(BackupInfo& info, const BackupInfo* prev);
+            int ReplayWAL(const BackupInfo& next, uint64 start_offset, const std::string& start_ns, uint64 until_offset);
+            int RemoveUnreferencedSharedFiles();
+            int DoCreate(BackupInfo& info);
+        public:
+            BackupManager();
+            /*
+             * Backup ids in ascending order
+             */
+            int ListIds(std::vector<uint32>& ids);
+            int List(std::vector<BackupInfo>& infos);
+            int Create(BackupInfo& info);
+            int BGCreate();
+            /*
+             * Restore the engine from the backup, then replay the writes logged until 'until_offset'(a replication
+             * offset after the backup's one & before the next backup's one) if it is not 0.
+             */
+            int Restore(uint32 id, uint64 until_offset);
+            /*
+             * Remove the oldest backups until 'keep' are left, returns the number of removed backups
+             */
+            int Purge(uint32 keep);
+            bool IsRunning() const
+            {
+                return m_running;
+            }
+            int LastErr() const
+            {
+                return m_last_err;
+            }
+            time_t LastBackupTime();
+            /*
+             * Called every second, starts a background backup every 'backup-incremental-period' seconds
+             */
+            void Routine();
+    };
+
+    extern BackupManager* g_backup_manager;
+}
+
+#endif /* BACKUP_HPP_ */
@@ -30,8 +30,21 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include "db/db.hpp"
+#include "statistics.hpp"
+#include <algorithm>
 
 #define MAX_SEND_CACHE_SIZE 8192
+/*
+ * larger frames give snappy more repeated command patterns to compress
+ */
+#define MAX_FRAMED_SEND_CACHE_SIZE (64 * 1024)
+#define MAX_SENDFILE_WAL_SIZE (1024 * 1024)
+#define SNAPSHOT_FRAME_SIZE (256 * 1024)
+#define MAX_WAL_OFFSET_MARKS 8192
+/*
+ * stop reading the diskless dump while any slave has more pending output
+ */
+#define MAX_DISKLESS_SYNC_PENDING (SNAPSHOT_FRAME_SIZE * 4)
 
 OP_NAMESPACE_BEGIN
     enum SyncState
@@ -53,11 +66,43 @@ OP_NAMESPACE_BEGIN
             uint32 port;
             int repldbfd;
             bool isRedisSlave;
+            bool engine_sync; //slave runs the same engine & accepts engine dumps
+            bool compress_stream; //everything sent after the replconf reply is framed by repl_write_frame
+            bool eof_capa; //slave accepts a dump without length ended by an eof mark
+            time_t diskless_since; //waiting for a diskless full resync since
+            int64 repldb_rest;
             uint8 state;
+            uint64 sent_bytes; //replication data sent to the slave, before compression
+            uint64 sent_bytes_sample;
+            uint64 sample_time;
+            uint64 send_rate; //bytes per second in the last routine period
+            uint64 lag_ms; //age of the oldest data not acked by the slave, at the last ack
+            uint32 o_buffer_peak;
+            uint64 sync_wal_cost; //micros spent in SyncWAL for the slave
+            ReplFilter filter; //namespaces & keys replicated to a filtered slave
+            std::string filter_ns; //namespace selected at sync_offset of the wal
+            Buffer filter_pending; //partial command at the end of the wal replayed for a filtered slave
+            int64 filter_skipped; //wal bytes dropped by the filter & not reported to the slave yet
             SlaveSyncContext() :
-                    snapshot(NULL), conn(NULL), sync_offset(0), ack_offset(0), sync_cksm(0), acktime(0), port(0), repldbfd(-1), isRedisSlave(false), state(SYNC_STATE_INVALID)
+                    snapshot(NULL), conn(NULL), sync_offset(0), ack_offset(0), sync_cksm(0), acktime(0), port(0), repldbfd(-1), isRedisSlave(false), engine_sync(false), compress_stream(
+                            false), eof_capa(false), diskless_since(0), repldb_rest(0), state(SYNC_STATE_INVALID), sent_bytes(0), sent_bytes_sample(0), sample_time(0), send_rate(0), lag_ms(
+                            0), o_buffer_peak(0), sync_wal_cost(0), filter_skipped(0)
             {
             }
+            void Write(Buffer& msg)
+            {
+                sent_bytes += msg.ReadableBytes();
+                if (compress_stream)
+                {
+                    Buffer frame;
+                    repl_write_frame(frame, msg.GetRawReadBuffer(), msg.ReadableBytes());
+                    conn->Write(frame);
+                }
+                else
+                {
+                    conn->Write(msg);
+                }
+            }
             std::string GetAddress()
             {
                 std::string address;
@@ -74,19 +119,177 @@ OP_NAMESPACE_BEGIN
             }
             ~SlaveSyncContext()
             {
+                if (repldb_rest > 0 && -1 != repldbfd)
+                {
+                    close(repldbfd);
+                }
+            }
+    };
+
+    static int diskless_dump_routine(SnapshotState state, Snapshot* snapshot, void* data);
+
+    /*
+     * A diskless full resync, the dump thread saves the snapshot into a pipe, the repl thread reads the pipe & forwards
+     * the dump to all slaves attached when it started. Slaves arriving later wait for the next one.
+     */
+    struct DisklessSync: public ChannelUpstreamHandler<Buffer>, public Runnable
+    {
+            Snapshot snapshot;
+            SnapshotType type;
+            int pipefd[2];
+            PipeChannel* pipe;
+            Thread* dumper;
+            std::string eof_mark;
+            SlaveSyncContextSet slaves;
+            volatile bool dump_started;
+            bool dump_success;
+            bool dump_done;
+            bool pipe_closed;
+            bool pipe_error;
+            DisklessSync(SnapshotType t) :
+                    type(t), pipe(NULL), dumper(NULL), dump_started(false), dump_success(false), dump_done(false), pipe_closed(false), pipe_error(false)
+            {
+                pipefd[0] = pipefd[1] = -1;
+            }
+            void Run();
+            void MessageReceived(ChannelHandlerContext& ctx, MessageEvent<Buffer>& e)
+            {
+                g_repl->GetMaster().DisklessSyncData(*(e.GetMessage()));
+                e.GetMessage()->Clear();
+            }
+            void ExceptionCaught(ChannelHandlerContext& ctx, ExceptionEvent& e)
+            {
+                pipe_error = true;
+            }
+            void ChannelClosed(ChannelHandlerContext& ctx, ChannelStateEvent& e)
+            {
+                pipe = NULL;
+                pipe_closed = true;
+                g_repl->GetMaster().FinishDisklessSync();
             }
     };
 
+    static void diskless_dump_started(Channel*, void* data)
+    {
+        g_repl->GetMaster().DisklessSyncStarted();
+    }
+    static void diskless_dump_done(Channel*, void* data)
+    {
+        g_repl->GetMaster().DisklessSyncDumpDone();
+    }
+    static void destroy_diskless_sync(Channel*, void* data)
+    {
+        DisklessSync* sync = (DisklessSync*) data;
+        DELETE(sync);
+    }
+
+    static int diskless_dump_routine(SnapshotState state, Snapshot* snapshot, void* data)
+    {
+        DisklessSync* sync = (DisklessSync*) data;
+        if (state == DUMP_START)
+        {
+            sync->dump_started = true;
+            g_repl->GetIOService().AsyncIO(0, diskless_dump_started, sync);
+        }
+        else if (state == DUMP_SUCCESS || state == DUMP_FAIL)
+        {
+            sync->dump_success = state == DUMP_SUCCESS;
+            g_repl->GetIOService().AsyncIO(0, diskless_dump_done, sync);
+        }
+        return 0;
+    }
+
+    void DisklessSync::Run()
+    {
+        snapshot.Save(type, "", diskless_dump_routine, this);
+        if (!dump_started)
+        {
+            //failed before dumping, no routine callback
+            dump_success = false;
+            g_repl->GetIOService().AsyncIO(0, diskless_dump_done, this);
+        }
+    }
+
+    static CostTrack g_sync_wal_cost;
+    static uint64_t slaves_send_rate(void* data)
+    {
+        return g_repl->GetMaster().SlavesSendRate();
+    }
+    static uint64_t slaves_max_lag_ms(void* data)
+    {
+        return g_repl->GetMaster().SlavesMaxLagMillis();
+    }
+    static uint64_t slaves_output_bytes(void* data)
+    {
+        return g_repl->GetMaster().SlavesOutputBytes();
+    }
+    static CountRefTrack g_slaves_send_rate(slaves_send_rate, NULL);
+    static CountRefTrack g_slaves_max_lag_ms(slaves_max_lag_ms, NULL);
+    static CountRefTrack g_slaves_output_bytes(slaves_output_bytes, NULL);
+
     Master::Master() :
-            m_repl_noslaves_since(0), m_repl_nolag_since(0), m_repl_good_slaves_count(0), m_slaves_count(0), m_sync_full_count(0), m_sync_partial_ok_count(0), m_sync_partial_err_count(0)
+            m_diskless(NULL), m_repl_noslaves_since(0), m_repl_nolag_since(0), m_repl_good_slaves_count(0), m_slaves_count(0), m_sync_full_count(0), m_sync_partial_ok_count(0), m_sync_partial_err_count(
+                    0), m_slaves_send_rate(0), m_slaves_max_lag_ms(0), m_slaves_output_bytes(0), m_getack_offset(-1)
     {
     }
 
     int Master::Init()
     {
+        CostRanges ranges;
+        ranges.push_back(CostRange(0, 100));
+        ranges.push_back(CostRange(100, 1000));
+        ranges.push_back(CostRange(1000, 10000));
+        ranges.push_back(CostRange(10000, UINT64_MAX));
+        g_sync_wal_cost.dump_flags = STAT_DUMP_INFO_CMD | STAT_DUMP_PERIOD | STAT_DUMP_PERIOD_CLEAR;
+        g_sync_wal_cost.name = "repl_sync_wal";
+        g_sync_wal_cost.SetCostRanges(ranges);
+        Statistics::GetSingleton().AddTrack(&g_sync_wal_cost);
+        g_slaves_send_rate.name = "repl_slaves_send_bytes_per_sec";
+        Statistics::GetSingleton().AddTrack(&g_slaves_send_rate);
+        g_slaves_max_lag_ms.name = "repl_slaves_max_lag_ms";
+        Statistics::GetSingleton().AddTrack(&g_slaves_max_lag_ms);
+        g_slaves_output_bytes.name = "repl_slaves_output_buffer_bytes";
+        Statistics::GetSingleton().AddTrack(&g_slaves_output_bytes);
         return 0;
     }
 
+    /*
+     * Offsets of the wal with the time they were written, an acked offset is mapped to the age of the oldest data
+     * the slave has not applied yet.
+     */
+    void Master::MarkWALOffset()
+    {
+        uint64 offset = g_repl->GetReplLog().WALEndOffset();
+        uint64 now = get_current_epoch_millis();
+        if (!m_offset_marks.empty() && (m_offset_marks.back().first == offset || now - m_offset_marks.back().second < 10))
+        {
+            return;
+        }
+        m_offset_marks.push_back(std::make_pair(offset, now));
+        if (m_offset_marks.size() > MAX_WAL_OFFSET_MARKS)
+        {
+            m_offset_marks.pop_front();
+        }
+    }
+
+    uint64 Master::OffsetLagMillis(int64 offset)
+    {
+        if (offset < 0 || (uint64) offset >= g_repl->GetReplLog().WALEndOffset())
+        {
+            return 0;
+        }
+        /*
+         * the first mark after the offset is when data after the offset was written at latest
+         */
+        OffsetMarkQueue::iterator it = std::upper_bound(m_offset_marks.begin(), m_offset_marks.end(), std::make_pair((uint64) offset, UINT64_MAX));
+        if (it == m_offset_marks.end())
+        {
+            return 0;
+        }
+        uint64 now = get_current_epoch_millis();
+        return now > it->second ? now - it->second : 0;
+    }
+
     static void slave_pipeline_init(ChannelPipeline* pipeline, void* data)
     {
         pipeline->AddLast("decoder", new RedisCommandDecoder(false));
@@ -135,8 +338,12 @@ OP_NAMESPACE_BEGIN
     int Master::Routine()
     {
         m_repl_good_slaves_count = 0;
+        MarkWALOffset();
         if (m_slaves.empty())
         {
+            m_slaves_send_rate = 0;
+            m_slaves_max_lag_ms = 0;
+            m_slaves_output_bytes = 0;
             if (0 == m_repl_noslaves_since)
             {
                 m_repl_noslaves_since = time(NULL);
@@ -144,18 +351,37 @@ OP_NAMESPACE_BEGIN
             return 0;
         }
         m_repl_noslaves_since = 0;
+        CheckDisklessSync();
         std::vector<SlaveSyncContext*> to_close;
         SlaveSyncContextSet::iterator fit = m_slaves.begin();
         bool wal_ping_saved = false;
         time_t now = time(NULL);
+        uint64 now_ms = get_current_epoch_millis();
+        uint64 send_rate = 0, max_lag_ms = 0, output_bytes = 0;
         while (fit != m_slaves.end())
         {
             SlaveSyncContext* slave = *fit;
+            if (slave->sample_time > 0 && now_ms > slave->sample_time)
+            {
+                slave->send_rate = (slave->sent_bytes - slave->sent_bytes_sample) * 1000 / (now_ms - slave->sample_time);
+            }
+            slave->sent_bytes_sample = slave->sent_bytes;
+            slave->sample_time = now_ms;
+            send_rate += slave->send_rate;
+            if (slave->state == SYNC_STATE_SYNCED && slave->lag_ms > max_lag_ms)
+            {
+                max_lag_ms = slave->lag_ms;
+            }
+            output_bytes += slave->conn->WritableBytes();
+            if (slave->conn->WritableBytes() > slave->o_buffer_peak)
+            {
+                slave->o_buffer_peak = slave->conn->WritableBytes();
+            }
             if (slave->state == SYNC_STATE_WAITING_SNAPSHOT)
             {
                 Buffer newline;
                 newline.Write("\n", 1);
-                slave->conn->Write(newline);
+                slave->Write(newline);
             }
             if (slave->state == SYNC_STATE_SYNCED)
             {
@@ -186,6 +412,9 @@ OP_NAMESPACE_BEGIN
             fit++;
         }
 
+        m_slaves_send_rate = send_rate;
+        m_slaves_max_lag_ms = max_lag_ms;
+        m_slaves_output_bytes = output_bytes;
         for (size_t i = 0; i < to_close.size(); i++)
         {
             CloseSlave(to_close[i]);
@@ -226,6 +455,376 @@ OP_NAMESPACE_BEGIN
         return true;
     }
 
+    void Master::SendFullResync(SlaveSyncContext* slave, Snapshot* snapshot)
+    {
+        Buffer msg;
+        slave->sync_offset = snapshot->CachedReplOffset();
+        slave->sync_cksm = snapshot->CachedReplCksm();
+        if (slave->isRedisSlave)
+        {
+            msg.Printf("+FULLRESYNC %s %lld\r\n", g_repl->GetReplLog().GetReplKey().c_str(), slave->sync_offset);
+        }
+        else
+        {
+            msg.Printf("+FULLRESYNC %s %lld %llu\r\n", g_repl->GetReplLog().GetReplKey().c_str(), slave->sync_offset, slave->sync_cksm);
+        }
+        slave->Write(msg);
+    }
+
+    /*
+     * Start a diskless sync for the slaves waiting for it once the first one waited 'repl-diskless-sync-delay' secs,
+     * redis & ardb slaves take different dumps, the ones not matching the first slave wait for the next sync.
+     */
+    void Master::CheckDisklessSync()
+    {
+        if (NULL != m_diskless)
+        {
+            return;
+        }
+        time_t oldest = 0;
+        SnapshotType type = ARDB_DUMP;
+        SlaveSyncContextSet::iterator it = m_slaves.begin();
+        while (it != m_slaves.end())
+        {
+            SlaveSyncContext* slave = *it;
+            if (slave->state == SYNC_STATE_WAITING_SNAPSHOT && slave->diskless_since > 0 && (0 == oldest || slave->diskless_since < oldest))
+            {
+                oldest = slave->diskless_since;
+                type = slave->isRedisSlave ? REDIS_DUMP : ARDB_DUMP;
+            }
+            it++;
+        }
+        if (0 == oldest || time(NULL) - oldest < g_db->GetConf().repl_diskless_sync_delay)
+        {
+            return;
+        }
+        DisklessSync* sync = NULL;
+        NEW(sync, DisklessSync(type));
+        if (0 != pipe(sync->pipefd))
+        {
+            int err = errno;
+            ERROR_LOG("Failed to create pipe for diskless sync for reason:%s", strerror(err));
+            DELETE(sync);
+            return;
+        }
+        if (0 != sync->snapshot.OpenWriteFD(sync->pipefd[1], "diskless-sync"))
+        {
+            close(sync->pipefd[0]);
+            close(sync->pipefd[1]);
+            DELETE(sync);
+            return;
+        }
+        it = m_slaves.begin();
+        while (it != m_slaves.end())
+        {
+            SlaveSyncContext* slave = *it;
+            if (slave->state == SYNC_STATE_WAITING_SNAPSHOT && slave->diskless_since > 0 && type == (slave->isRedisSlave ? REDIS_DUMP : ARDB_DUMP))
+            {
+                slave->diskless_since = 0;
+                sync->slaves.insert(slave);
+            }
+            it++;
+        }
+        sync->eof_mark = random_hex_string(40);
+        m_diskless = sync;
+        INFO_LOG("[Master]Start diskless sync with type:%s for %u slaves.", type == REDIS_DUMP ? "redis" : "ardb", sync->slaves.size());
+        NEW(sync->dumper, Thread(sync));
+        sync->dumper->Start();
+    }
+
+    /*
+     * The offset of the dump is cached before it starts, the data written into the pipe is read after slaves
+     * received the FULLRESYNC & the eof mark.
+     */
+    void Master::DisklessSyncStarted()
+    {
+        DisklessSync* sync = m_diskless;
+        g_repl->GetReplLog().ClearCurrentNamespace();
+        SlaveSyncContextSet::iterator it = sync->slaves.begin();
+        while (it != sync->slaves.end())
+        {
+            SlaveSyncContext* slave = *it;
+            SendFullResync(slave, &sync->snapshot);
+            Buffer header;
+            header.Printf("$EOF:%s\r\n", sync->eof_mark.c_str());
+            slave->Write(header);
+            slave->state = SYNC_STATE_SYNCING_SNAPSHOT;
+            it++;
+        }
+        sync->pipe = g_repl->GetIOService().NewPipeChannel(sync->pipefd[0], -1);
+        sync->pipe->GetPipeline().AddLast("handler", sync);
+        sync->pipe->Open();
+        if (sync->slaves.empty())
+        {
+            sync->pipe->Close();
+        }
+    }
+
+    void Master::DisklessSyncData(Buffer& data)
+    {
+        SlaveSyncContextSet::iterator it = m_diskless->slaves.begin();
+        while (it != m_diskless->slaves.end())
+        {
+            SlaveSyncContext* slave = *it;
+            Buffer chunk((char*) data.GetRawReadBuffer(), 0, data.ReadableBytes());
+            slave->Write(chunk);
+            it++;
+        }
+        CheckDisklessSyncOutput();
+    }
+
+    /*
+     * The dump goes as fast as the slowest slave, the pipe is not read while any slave has too much pending output,
+     * then the dump thread blocks on the full pipe.
+     */
+    void Master::CheckDisklessSyncOutput()
+    {
+        if (NULL == m_diskless || NULL == m_diskless->pipe)
+        {
+            return;
+        }
+        bool busy = false;
+        SlaveSyncContextSet::iterator it = m_diskless->slaves.begin();
+        while (it != m_diskless->slaves.end())
+        {
+            SlaveSyncContext* slave = *it;
+            if (slave->conn->WritableBytes() >= MAX_DISKLESS_SYNC_PENDING)
+            {
+                busy = true;
+                break;
+            }
+            it++;
+        }
+        if (busy)
+        {
+            m_diskless->pipe->BlockRead();
+        }
+        else
+        {
+            m_diskless->pipe->UnblockRead();
+        }
+    }
+
+    void Master::DisklessSyncDumpDone()
+    {
+        DisklessSync* sync = m_diskless;
+        sync->dump_done = true;
+        if (!sync->dump_success && !sync->pipe_closed)
+        {
+            if (NULL != sync->pipe)
+            {
+                //finished in ChannelClosed of the pipe
+                sync->pipe->Close();
+                return;
+            }
+            close(sync->pipefd[0]);
+            sync->pipe_closed = true;
+        }
+        FinishDisklessSync();
+    }
+
+    /*
+     * Finished when the dump thread is done & all the data in the pipe forwarded.
+     */
+    void Master::FinishDisklessSync()
+    {
+        DisklessSync* sync = m_diskless;
+        if (NULL == sync || !sync->dump_done || !sync->pipe_closed)
+        {
+            return;
+        }
+        m_diskless = NULL;
+        sync->dumper->Join();
+        DELETE(sync->dumper);
+        bool success = sync->dump_success && !sync->pipe_error;
+        SlaveSyncContextSet::iterator it = sync->slaves.begin();
+        while (it != sync->slaves.end())
+        {
+            SlaveSyncContext* slave = *it;
+            if (success)
+            {
+                Buffer mark;
+                mark.Write(sync->eof_mark.data(), sync->eof_mark.size());
+                slave->Write(mark);
+                slave->state = SYNC_STATE_SYNCED;
+                INFO_LOG("Send diskless snapshot to slave:%s success.", slave->GetAddress().c_str());
+                SyncWAL(slave);
+            }
+            else
+            {
+                WARN_LOG("Send diskless snapshot to slave:%s failed.", slave->GetAddress().c_str());
+                CloseSlave(slave);
+            }
+            it++;
+        }
+        /*
+         * still in the callback of the pipe channel
+         */
+        g_repl->GetIOService().AsyncIO(0, destroy_diskless_sync, sync);
+    }
+
+    struct AckWaiter
+    {
+            Context* ctx;
+            ChannelService* serv;
+            uint32 channel_id;
+            int64 offset;
+            int64 numreplicas;
+            uint64 deadline; //millis, 0 for ever
+            int64 acked;
+    };
+
+    static void reply_ack_waiter(Channel* ch, void* data)
+    {
+        AckWaiter* waiter = (AckWaiter*) data;
+        if (NULL != ch && !ch->IsClosed())
+        {
+            RedisReply r;
+            r.SetInteger(waiter->acked);
+            ch->Write(r);
+            ch->UnblockRead();
+        }
+        DELETE(waiter);
+    }
+
+    void Master::UpdateSlaveAck(SlaveSyncContext* slave, int64 offset, bool remove)
+    {
+        LockGuard<SpinMutexLock> guard(m_ack_lock);
+        if (remove)
+        {
+            m_slave_acks.erase(slave);
+        }
+        else
+        {
+            m_slave_acks[slave] = offset;
+        }
+    }
+
+    int64 Master::CountAckedSlaves(int64 offset)
+    {
+        int64 count = 0;
+        SlaveAckTable::iterator it = m_slave_acks.begin();
+        while (it != m_slave_acks.end())
+        {
+            if (it->second >= offset)
+            {
+                count++;
+            }
+            it++;
+        }
+        return count;
+    }
+
+    /*
+     * Park the client until enough slaves acked the offset, return false with the acked slaves count if there are
+     * already enough or there is no client to park(EXEC & scripts). The reading of the client is blocked until it's
+     * woken by WakeAckWaiters.
+     */
+    bool Master::WaitForAcks(Context& ctx, int64 offset, int64 numreplicas, int64 timeout, int64& acked)
+    {
+        {
+            LockGuard<SpinMutexLock> guard(m_ack_lock);
+            acked = CountAckedSlaves(offset);
+            if (acked >= numreplicas || NULL == ctx.client || NULL == ctx.client->client)
+            {
+                return false;
+            }
+            AckWaiter* waiter = NULL;
+            NEW(waiter, AckWaiter);
+            waiter->ctx = &ctx;
+            waiter->serv = &(ctx.client->client->GetService());
+            waiter->channel_id = ctx.client->client->GetID();
+            waiter->offset = offset;
+            waiter->numreplicas = numreplicas;
+            waiter->deadline = timeout > 0 ? get_current_epoch_millis() + timeout : 0;
+            waiter->acked = acked;
+            m_ack_waiters.insert(AckWaiterTable::value_type(offset, waiter));
+        }
+        ctx.client->client->BlockRead();
+        /*
+         * ask slaves to ack at once instead of waiting for the next period ack
+         */
+        if (m_getack_offset < offset)
+        {
+            m_getack_offset = offset;
+            Buffer getack;
+            getack.Printf("*3\r\n$8\r\nREPLCONF\r\n$6\r\nGETACK\r\n$1\r\n*\r\n");
+            g_repl->GetReplLog().WriteWAL(getack, true);
+        }
+        return true;
+    }
+
+    void Master::CancelAckWait(Context& ctx)
+    {
+        LockGuard<SpinMutexLock> guard(m_ack_lock);
+        AckWaiterTable::iterator it = m_ack_waiters.begin();
+        while (it != m_ack_waiters.end())
+        {
+            if (it->second->ctx == &ctx)
+            {
+                DELETE(it->second);
+                m_ack_waiters.erase(it++);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    /*
+     * Wake all waiters satisfied by the current acks(or timeout) in one pass, the replies are written by the
+     * threads of the clients.
+     */
+    void Master::WakeAckWaiters(bool check_timeout)
+    {
+        LockGuard<SpinMutexLock> guard(m_ack_lock);
+        if (m_ack_waiters.empty())
+        {
+            return;
+        }
+        int64 max_acked = -1;
+        SlaveAckTable::iterator sit = m_slave_acks.begin();
+        while (sit != m_slave_acks.end())
+        {
+            if (sit->second > max_acked)
+            {
+                max_acked = sit->second;
+            }
+            sit++;
+        }
+        uint64 now = check_timeout ? get_current_epoch_millis() : 0;
+        AckWaiterTable::iterator it = m_ack_waiters.begin();
+        while (it != m_ack_waiters.end())
+        {
+            AckWaiter* waiter = it->second;
+            bool wake = false;
+            if (it->first <= max_acked)
+            {
+                waiter->acked = CountAckedSlaves(it->first);
+                wake = waiter->acked >= waiter->numreplicas;
+            }
+            else if (!check_timeout)
+            {
+                //no slave acked the offsets after
+                break;
+            }
+            if (!wake && check_timeout && waiter->deadline > 0 && now >= waiter->deadline)
+            {
+                wake = true;
+            }
+            if (wake)
+            {
+                waiter->serv->AsyncIO(waiter->channel_id, reply_ack_waiter, waiter);
+                m_ack_waiters.erase(it++);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
     void Master::CloseSlaveBySnapshot(Snapshot* snapshot)
     {
         std::vector<SlaveSyncContext*> to_close;
@@ -306,9 +905,17 @@ OP_NAMESPACE_BEGIN
         fstat(setting.fd, &st);
         Buffer header;
         header.Printf("$%llu\r\n", st.st_size);
-        slave->conn->Write(header);
+        slave->Write(header);
+        if (slave->compress_stream)
+        {
+            slave->repldbfd = setting.fd;
+            slave->repldb_rest = st.st_size;
+            SendSnapshotFrames(slave);
+            return;
+        }
 
         setting.file_rest_len = st.st_size;
+        slave->sent_bytes += st.st_size;
         setting.on_complete = OnSnapshotFileSendComplete;
         setting.on_failure = OnSnapshotFileSendFailure;
         setting.data = slave;
@@ -316,11 +923,45 @@ OP_NAMESPACE_BEGIN
         slave->conn->SendFile(setting);
     }
 
+    /*
+     * Framed slaves can not take the snapshot by sendfile, the file is read & framed whenever the output drained.
+     */
+    void Master::SendSnapshotFrames(SlaveSyncContext* slave)
+    {
+        static char buf[SNAPSHOT_FRAME_SIZE];
+        while (slave->repldb_rest > 0 && slave->conn->WritableBytes() < SNAPSHOT_FRAME_SIZE * 4)
+        {
+            ssize_t n = read(slave->repldbfd, buf, slave->repldb_rest < SNAPSHOT_FRAME_SIZE ? slave->repldb_rest : SNAPSHOT_FRAME_SIZE);
+            if (n <= 0)
+            {
+                OnSnapshotFileSendFailure(slave);
+                slave->conn->Close();
+                return;
+            }
+            repl_write_frame(slave->conn->GetOutputBuffer(), buf, n);
+            slave->repldb_rest -= n;
+            slave->sent_bytes += n;
+        }
+        slave->conn->EnableWriting();
+        if (0 == slave->repldb_rest)
+        {
+            OnSnapshotFileSendComplete(slave);
+        }
+    }
+
     static int send_wal_toslave(const void* log, size_t loglen, void* data)
     {
         SlaveSyncContext* slave = (SlaveSyncContext*) data;
-        slave->conn->GetOutputBuffer().Write(log, loglen);
+        if (slave->compress_stream)
+        {
+            repl_write_frame(slave->conn->GetOutputBuffer(), (const char*) log, loglen);
+        }
+        else
+        {
+            slave->conn->GetOutputBuffer().Write(log, loglen);
+        }
         slave->sync_offset += loglen;
+        slave->sent_bytes += loglen;
         if (slave->sync_offset == g_repl->GetReplLog().WALEndOffset(false))
         {
             slave->conn->GetWritableOptions().auto_disable_writing = true;
@@ -333,7 +974,156 @@ OP_NAMESPACE_BEGIN
         return 0;
     }
 
+    static void write_wal_skip(Buffer& out, int64 skipped)
+    {
+        std::string len = stringfromll(skipped);
+        out.Printf("*3\r\n$8\r\nREPLCONF\r\n$4\r\nSKIP\r\n$%u\r\n%s\r\n", len.size(), len.c_str());
+    }
+
+    /*
+     * SELECTs & stream controls(ping, replconf getack) always pass, so that the namespace selected on a filtered
+     * slave is the one at its offset of the wal. A command with several keys passes if any key matches.
+     */
+    bool Master::MatchSlaveFilter(SlaveSyncContext* slave, RedisCommandFrame& cmd)
+    {
+        const std::string& name = cmd.GetCommand();
+        if (!strcasecmp(name.c_str(), "select"))
+        {
+            slave->filter_ns = cmd.GetArguments().empty() ? "" : cmd.GetArguments()[0];
+            return true;
+        }
+        if (!strcasecmp(name.c_str(), "ping") || !strcasecmp(name.c_str(), "replconf"))
+        {
+            return true;
+        }
+        if (!slave->filter.MatchNameSpace(slave->filter_ns))
+        {
+            return false;
+        }
+        if (slave->filter.prefixes.empty())
+        {
+            return true;
+        }
+        g_db->FindRedisCommandHandlerSetting(cmd);
+        StringArray keys;
+        Ardb::GetCommandKeys(cmd, keys);
+        if (keys.empty())
+        {
+            return true;
+        }
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (slave->filter.MatchKey(keys[i]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Only commands matched by the slave's filter are sent, dropped bytes are reported by 'REPLCONF SKIP <bytes>' so
+     * that the slave's wal stays in the offset space of the master & partial resyncs keep working.
+     */
+    void Master::SendFilteredWAL(SlaveSyncContext* slave, const void* log, size_t loglen)
+    {
+        Buffer& pending = slave->filter_pending;
+        pending.Write(log, loglen);
+        Buffer out;
+        while (pending.Readable())
+        {
+            size_t mark = pending.GetReadIndex();
+            RedisCommandFrame cmd;
+            if (!RedisCommandDecoder::Decode(NULL, pending, cmd))
+            {
+                pending.SetReadIndex(mark);
+                break;
+            }
+            size_t len = pending.GetReadIndex() - mark;
+            if (MatchSlaveFilter(slave, cmd))
+            {
+                if (slave->filter_skipped > 0)
+                {
+                    write_wal_skip(out, slave->filter_skipped);
+                    slave->filter_skipped = 0;
+                }
+                out.Write(pending.GetRawBuffer() + mark, len);
+            }
+            else
+            {
+                slave->filter_skipped += len;
+            }
+        }
+        pending.DiscardReadedBytes();
+        if (slave->filter_skipped > 0)
+        {
+            write_wal_skip(out, slave->filter_skipped);
+            slave->filter_skipped = 0;
+        }
+        if (!out.Readable())
+        {
+            return;
+        }
+        if (slave->compress_stream)
+        {
+            repl_write_frame(slave->conn->GetOutputBuffer(), out.GetRawReadBuffer(), out.ReadableBytes());
+        }
+        else
+        {
+            slave->conn->GetOutputBuffer().Write(out.GetRawReadBuffer(), out.ReadableBytes());
+        }
+        slave->sent_bytes += out.ReadableBytes();
+    }
+
+    static int send_filtered_wal_toslave(const void* log, size_t loglen, void* data)
+    {
+        SlaveSyncContext* slave = (SlaveSyncContext*) data;
+        g_repl->GetMaster().SendFilteredWAL(slave, log, loglen);
+        slave->sync_offset += loglen;
+        slave->conn->GetWritableOptions().auto_disable_writing = slave->sync_offset == g_repl->GetReplLog().WALEndOffset(false);
+        slave->conn->EnableWriting();
+        return 0;
+    }
+
+    static void OnWALFileSendComplete(void* data)
+    {
+    }
+
+    /*
+     * Send the wal to the slave from the wal log file by sendfile, the logs are read from page cache & never copied
+     * into the output buffer of each slave. The channel flushes its output buffer before the file, and the next logs are
+     * sent when the channel is writable again after the file sent.
+     */
+    void Master::SyncWALByFile(SlaveSyncContext* slave)
+    {
+        int fd = -1;
+        size_t file_pos = 0, len = 0;
+        if (0 != g_repl->GetReplLog().Locate(slave->sync_offset, MAX_SENDFILE_WAL_SIZE, fd, file_pos, len) || 0 == len)
+        {
+            return;
+        }
+        SendFileSetting setting;
+        setting.fd = fd;
+        setting.file_offset = file_pos;
+        setting.file_rest_len = len;
+        setting.on_complete = OnWALFileSendComplete;
+        setting.data = slave;
+        slave->sync_offset += len;
+        slave->sent_bytes += len;
+        slave->conn->GetWritableOptions().auto_disable_writing = slave->sync_offset == g_repl->GetReplLog().WALEndOffset(false);
+        slave->conn->SendFile(setting);
+    }
+
     void Master::SyncWAL(SlaveSyncContext* slave)
+    {
+        uint64 start = get_current_epoch_micros();
+        DoSyncWAL(slave);
+        uint64 cost = get_current_epoch_micros() - start;
+        slave->sync_wal_cost += cost;
+        g_sync_wal_cost.AddCost(cost);
+    }
+
+    void Master::DoSyncWAL(SlaveSyncContext* slave)
     {
         if (slave->sync_offset < g_repl->GetReplLog().WALStartOffset() || slave->sync_offset > g_repl->GetReplLog().WALEndOffset())
         {
@@ -348,14 +1138,26 @@ OP_NAMESPACE_BEGIN
         {
             return;
         }
+        if (slave->conn->IsSendingFile())
+        {
+            //wait the wal sending by sendfile complete
+            return;
+        }
+        if (slave->sync_offset < g_repl->GetReplLog().WALEndOffset() && !slave->compress_stream && slave->filter.Empty() && g_db->GetConf().repl_wal_sendfile)
+        {
+            SyncWALByFile(slave);
+            return;
+        }
         if (slave->sync_offset < g_repl->GetReplLog().WALEndOffset())
         {
-            g_repl->GetReplLog().Replay(slave->sync_offset, MAX_SEND_CACHE_SIZE, send_wal_toslave, slave);
+            g_repl->GetReplLog().Replay(slave->sync_offset, slave->compress_stream ? MAX_FRAMED_SEND_CACHE_SIZE : MAX_SEND_CACHE_SIZE,
+                    slave->filter.Empty() ? send_wal_toslave : send_filtered_wal_toslave, slave);
         }
     }
 
     void Master::SyncWAL()
     {
+        MarkWALOffset();
         std::vector<SlaveSyncContext*> sync_slaves;
         SlaveSyncContextSet::iterator it = m_slaves.begin();
         while (it != m_slaves.end())
@@ -417,7 +1219,7 @@ OP_NAMESPACE_BEGIN
             if (!fullsync)
             {
                 msg.Printf("+CONTINUE\r\n");
-                slave->conn->Write(msg);
+                slave->Write(msg);
                 slave->state = SYNC_STATE_SYNCED;
                 INFO_LOG("[Master]Send +CONTINUE to slave %s.", slave->GetAddress().c_str());
                 SyncWAL(slave);
@@ -432,26 +1234,35 @@ OP_NAMESPACE_BEGIN
                 WARN_LOG("Create snapshot for full resync for slave replid:%s offset:%llu cksm:%llu, while current WAL runid:%s offset:%llu cksm:%llu", slave->repl_key.c_str(), slave->sync_offset, slave->sync_cksm,
                         g_repl->GetReplLog().GetReplKey().c_str(), g_repl->GetReplLog().WALEndOffset(), g_repl->GetReplLog().WALCksm());
                 slave->state = SYNC_STATE_WAITING_SNAPSHOT;
-                slave->snapshot = g_snapshot_manager->GetSyncSnapshot(slave->isRedisSlave ? REDIS_DUMP : ARDB_DUMP, snapshot_dump_routine, this);
+                SnapshotType snapshot_type = slave->isRedisSlave ? REDIS_DUMP : ARDB_DUMP;
+                /*
+                 * a filtered slave takes a dedicated ardb dump of the filtered namespaces & keys
+                 */
+                bool filtered = !slave->filter.Empty();
+                if (!slave->isRedisSlave && !filtered && slave->engine_sync && g_db->GetConf().repl_engine_sync && g_db->GetEngine()->GetFeatureSet().support_checkpoint)
+                {
+                    snapshot_type = ENGINE_DUMP;
+                }
+                else if (!filtered && slave->eof_capa && g_db->GetConf().repl_diskless_sync)
+                {
+                    /*
+                     * the dump is streamed to the slave by the next diskless sync started in Routine
+                     */
+                    slave->diskless_since = time(NULL);
+                    m_sync_full_count++;
+                    INFO_LOG("[Master]Slave %s waits for a diskless full resync.", slave->GetAddress().c_str());
+                    return;
+                }
+                slave->snapshot = g_snapshot_manager->GetSyncSnapshot(snapshot_type, snapshot_dump_routine, this, &slave->filter);
                 if (NULL != slave->snapshot)
                 {
+                    slave->filter_ns = g_repl->GetReplLog().CurrentNamespace();
                     //FULLRESYNC
                     /* We are going to accumulate the incremental changes for this
                      * slave as well.Clear current namespace in order to force to re-emit
                      * a SLEECT statement in the replication stream. */
                     g_repl->GetReplLog().ClearCurrentNamespace();
-                    Buffer msg;
-                    slave->sync_offset = slave->snapshot->CachedReplOffset();
-                    slave->sync_cksm = slave->snapshot->CachedReplCksm();
-                    if (slave->isRedisSlave)
-                    {
-                        msg.Printf("+FULLRESYNC %s %lld\r\n", g_repl->GetReplLog().GetReplKey().c_str(), slave->sync_offset);
-                    }
-                    else
-                    {
-                        msg.Printf("+FULLRESYNC %s %lld %llu\r\n", g_repl->GetReplLog().GetReplKey().c_str(), slave->sync_offset, slave->sync_cksm);
-                    }
-                    slave->conn->Write(msg);
+                    SendFullResync(slave, slave->snapshot);
                     m_sync_full_count++;
                     if (slave->snapshot->IsReady())
                     {
@@ -475,6 +1286,20 @@ OP_NAMESPACE_BEGIN
             WARN_LOG("Slave %s closed.", slave->GetAddress().c_str());
             m_slaves.erase(slave);
             m_slaves_count = m_slaves.size();
+            UpdateSlaveAck(slave, 0, true);
+            if (NULL != m_diskless && m_diskless->slaves.erase(slave) > 0)
+            {
+                if (m_diskless->slaves.empty() && NULL != m_diskless->pipe)
+                {
+                    //nobody needs the dump, abort the dump thread by closing the read end of the pipe
+                    WARN_LOG("[Master]Abort diskless sync since all slaves closed.");
+                    m_diskless->pipe->Close();
+                }
+                else
+                {
+                    CheckDisklessSyncOutput();
+                }
+            }
         }
     }
     void Master::ChannelWritable(ChannelHandlerContext& ctx, ChannelStateEvent& e)
@@ -488,6 +1313,14 @@ OP_NAMESPACE_BEGIN
                 DEBUG_LOG("[Master]Slave sync from %lld to %llu at state:%u", slave->sync_offset, g_repl->GetReplLog().WALEndOffset(), slave->state);
                 SyncWAL(slave);
             }
+            else if (slave->state == SYNC_STATE_SYNCING_SNAPSHOT && slave->repldb_rest > 0)
+            {
+                SendSnapshotFrames(slave);
+            }
+            else if (slave->state == SYNC_STATE_SYNCING_SNAPSHOT && NULL == slave->snapshot)
+            {
+                CheckDisklessSyncOutput();
+            }
         }
         else
         {
@@ -521,6 +1354,9 @@ OP_NAMESPACE_BEGIN
                     {
                         slave->acktime = time(NULL);
                         slave->ack_offset = offset;
+                        slave->lag_ms = OffsetLagMillis(offset);
+                        UpdateSlaveAck(slave, offset);
+                        WakeAckWaiters(false);
                     }
                 }
             }
@@ -574,6 +1410,18 @@ OP_NAMESPACE_BEGIN
     {
         INFO_LOG("[Master]Recv sync command:%s", cmd.ToString().c_str());
         slave->Flush();
+        /*
+         * slave output is bounded by slave-client-output-buffer-limit instead
+         */
+        slave->SetOutputLimits(0, 0);
+        if (!g_db->GetConf().master_host.empty()
+                && (!g_db->GetConf().slave_filter_namespaces.empty() || !g_db->GetConf().slave_filter_key_prefixes.empty()))
+        {
+            //the wal of a filtered slave misses logs of its master
+            ERROR_LOG("Filtered slave can not serve slaves.");
+            slave->Close();
+            return;
+        }
         SlaveSyncContext& ctx = getSlaveContext(slave);
         if (cmd.GetType() == REDIS_CMD_SYNC)
         {
@@ -689,8 +1537,10 @@ OP_NAMESPACE_BEGIN
 
             uint32 lag = time(NULL) - slave->acktime;
             sprintf(buffer, "slave%u:%s,state=%s,"
-                    "offset=%" PRId64 ",ack_offset=%" PRId64",lag=%u,o_buffer_size=%u,o_buffer_capacity=%u\r\n", i, slave->GetAddress().c_str(), state, slave->sync_offset, slave->ack_offset, lag, slave->conn->WritableBytes(),
-                    slave->conn->GetOutputBuffer().Capacity());
+                    "offset=%" PRId64 ",ack_offset=%" PRId64",lag=%u,o_buffer_size=%u,o_buffer_capacity=%u,o_buffer_peak=%u,"
+                    "sent_bytes=%" PRIu64 ",send_bytes_per_sec=%" PRIu64 ",lag_offset=%" PRId64 ",lag_ms=%" PRIu64 ",sync_wal_usec=%" PRIu64 "\r\n", i, slave->GetAddress().c_str(), state, slave->sync_offset,
+                    slave->ack_offset, lag, slave->conn->WritableBytes(), slave->conn->GetOutputBuffer().Capacity(), slave->o_buffer_peak, slave->sent_bytes, slave->send_rate,
+                    slave->ack_offset > 0 && slave->sync_offset > slave->ack_offset ? slave->sync_offset - slave->ack_offset : 0, slave->lag_ms, slave->sync_wal_cost);
             it++;
             i++;
             str.append(buffer);
@@ -702,6 +1552,43 @@ OP_NAMESPACE_BEGIN
         getSlaveContext(slave).port = port;
     }
 
+    void Master::SetSlaveEngineSync(Channel* slave)
+    {
+        getSlaveContext(slave).engine_sync = true;
+    }
+
+    void Master::SetSlaveCompressStream(Channel* slave)
+    {
+        getSlaveContext(slave).compress_stream = true;
+    }
+
+    void Master::SetSlaveEOFCapa(Channel* slave)
+    {
+        getSlaveContext(slave).eof_capa = true;
+    }
+
+    void Master::SetSlaveFilter(Channel* slave, const std::string& opt, const std::string& value)
+    {
+        SlaveSyncContext& ctx = getSlaveContext(slave);
+        if (!strcasecmp(opt.c_str(), "filter-ns"))
+        {
+            ctx.filter.AddNameSpaces(value);
+        }
+        else if (!strcasecmp(opt.c_str(), "filter-prefix"))
+        {
+            ctx.filter.AddKeyPrefixes(value);
+        }
+        else if (!strcasecmp(opt.c_str(), "filter-select"))
+        {
+            //namespace selected at the offset the slave continues from
+            ctx.filter_ns = value;
+        }
+        else
+        {
+            WARN_LOG("Unknown replconf filter:%s", opt.c_str());
+        }
+    }
+
     Master::~Master()
     {
     }
@@ -48,6 +48,8 @@ extern "C"
 #include "db/db.hpp"
 #include "repl.hpp"
 #include "thread/lock_guard.hpp"
+#include "bgjobs.hpp"
+#include "util/probes.hpp"
 
 #define RETURN_NEGATIVE_EXPR(x)  do\
     {                    \
@@ -58,8 +60,10 @@ extern "C"
     }while(0)
 
 #define REDIS_RDB_VERSION 7
+/* Newest redis dump version the loader understands(redis 7.x), dumps are still written as REDIS_RDB_VERSION. */
+#define REDIS_RDB_LOAD_MAX_VERSION 11
 
-#define ARDB_RDB_VERSION 1
+#define ARDB_RDB_VERSION 2
 
 /* Defines related to the dump file format. To store 32 bits lengths for short
  * keys requires a lot of space, so we check the most significant 2 bits of
@@ -78,6 +82,8 @@ extern "C"
 #define REDIS_RDB_14BITLEN 1
 #define REDIS_RDB_32BITLEN 2
 #define REDIS_RDB_ENCVAL 3
+#define REDIS_RDB_32BITLEN_BYTE 0x80
+#define REDIS_RDB_64BITLEN_BYTE 0x81
 #define REDIS_RDB_LENERR UINT_MAX
 
 /* When a length of a string object stored on disk has the first two bits
@@ -89,6 +95,12 @@ extern "C"
 #define REDIS_RDB_ENC_LZF 3         /* string compressed with FASTLZ */
 
 /* Special RDB opcodes (saved/loaded with rdbSaveType/rdbLoadType). */
+#define REDIS_RDB_OPCODE_SLOT_INFO 244
+#define REDIS_RDB_OPCODE_FUNCTION2 245
+#define REDIS_RDB_OPCODE_FUNCTION_PRE_GA 246
+#define REDIS_RDB_OPCODE_MODULE_AUX 247
+#define REDIS_RDB_OPCODE_IDLE 248
+#define REDIS_RDB_OPCODE_FREQ 249
 #define RDB_OPCODE_AUX        250
 #define RDB_OPCODE_RESIZEDB   251
 #define REDIS_RDB_OPCODE_EXPIRETIME_MS 252
@@ -103,6 +115,9 @@ extern "C"
 #define REDIS_RDB_TYPE_SET    2
 #define REDIS_RDB_TYPE_ZSET   3
 #define REDIS_RDB_TYPE_HASH   4
+#define REDIS_RDB_TYPE_ZSET_2 5 /* ZSET version 2 with doubles stored in binary. */
+#define REDIS_RDB_TYPE_MODULE 6
+#define REDIS_RDB_TYPE_MODULE_2 7
 
 /* Object types for encoded objects. */
 #define REDIS_RDB_TYPE_HASH_ZIPMAP    9
@@ -111,6 +126,17 @@ extern "C"
 #define REDIS_RDB_TYPE_ZSET_ZIPLIST  12
 #define REDIS_RDB_TYPE_HASH_ZIPLIST  13
 #define REDIS_RDB_TYPE_LIST_QUICKLIST      14
+#define REDIS_RDB_TYPE_STREAM_LISTPACKS    15
+#define REDIS_RDB_TYPE_HASH_LISTPACK       16
+#define REDIS_RDB_TYPE_ZSET_LISTPACK       17
+#define REDIS_RDB_TYPE_LIST_QUICKLIST_2    18
+#define REDIS_RDB_TYPE_STREAM_LISTPACKS_2  19
+#define REDIS_RDB_TYPE_SET_LISTPACK        20
+#define REDIS_RDB_TYPE_STREAM_LISTPACKS_3  21
+
+/* Quicklist(version 2) node containers. */
+#define REDIS_QUICKLIST_NODE_CONTAINER_PLAIN 1
+#define REDIS_QUICKLIST_NODE_CONTAINER_PACKED 2
 
 #define ARDB_RDB_TYPE_CHUNK 1
 #define ARDB_RDB_TYPE_SNAPPY_CHUNK 2
@@ -118,9 +144,25 @@ extern "C"
 #define ARDB_OPCODE_AUX        250
 #define ARDB_RDB_TYPE_EOF 255
 
+#define ENGINE_DUMP_MAGIC "ARDBCKPT"
+#define ENGINE_DUMP_OPCODE_FILE 1
+
 namespace ardb
 {
 
+    static const char* snapshot_type_name(SnapshotType type)
+    {
+        switch (type)
+        {
+            case REDIS_DUMP:
+                return "redis";
+            case ENGINE_DUMP:
+                return "engine";
+            default:
+                return "ardb";
+        }
+    }
+
     static time_t g_lastsave = 0;
     static int g_saver_num = 0;
     static int g_lastsave_err = 0;
@@ -245,42 +287,51 @@ namespace ardb
                 return REDIS_RDB_LENERR;
             return ((buf[0] & 0x3F) << 8) | buf[1];
         }
-        else
+        else if (buf[0] == REDIS_RDB_32BITLEN_BYTE)
         {
             /* Read a 32 bit len. */
             if (Read(&len, 4) == 0)
                 return REDIS_RDB_LENERR;
             return ntohl(len);
         }
+        else if (buf[0] == REDIS_RDB_64BITLEN_BYTE)
+        {
+            /* Read a 64 bit big endian len, lengths beyond 32 bits can not be loaded. */
+            unsigned char len64[8];
+            if (Read(len64, 8) == 0)
+                return REDIS_RDB_LENERR;
+            uint64 v = 0;
+            for (int i = 0; i < 8; i++)
+            {
+                v = (v << 8) | len64[i];
+            }
+            return v >= REDIS_RDB_LENERR ? REDIS_RDB_LENERR : (uint32_t) v;
+        }
+        return REDIS_RDB_LENERR;
     }
 
     bool ObjectIO::ReadLzfStringObject(std::string& str)
     {
         unsigned int len, clen;
-        unsigned char *c = NULL;
 
         if ((clen = ReadLen(NULL)) == REDIS_RDB_LENERR)
             return false;
         if ((len = ReadLen(NULL)) == REDIS_RDB_LENERR)
             return false;
-        str.resize(len);
-        NEW(c, unsigned char[clen]);
-        if (NULL == c)
-            return false;
-
-        if (!Read(c, clen))
+        /*
+         * the compressed bytes go into a scratch buffer reused across strings, only the decompressed
+         * result is written into the caller's string.
+         */
+        m_lzf_buffer.resize(clen);
+        if (clen && !Read(&m_lzf_buffer[0], clen))
         {
-            DELETE_A(c);
             return false;
         }
         str.resize(len);
-        char* val = &str[0];
-        if (lzf_decompress(c, clen, val, len) == 0)
+        if (len && lzf_decompress(m_lzf_buffer.data(), clen, &str[0], len) == 0)
         {
-            DELETE_A(c);
             return false;
         }
-        DELETE_A(c);
         return true;
     }
 
@@ -383,8 +434,7 @@ namespace ardb
                 default:
                 {
                     ERROR_LOG("Unknown RDB encoding type:%d", len);
-                    abort();
-                    break;
+                    return false;
                 }
             }
         }
@@ -407,6 +457,34 @@ namespace ardb
     }
 
     /* Like rdbSaveStringObjectRaw() but handle encoded objects */
+    /*
+     * Fields of a hash keyed by object id are out of the key range of its meta, they are written
+     * in an iteration of their own.
+     */
+    int ObjectIO::WriteObjectIdHashFields(Context& ctx, const Data& ns, uint64 object_id, int64& objectlen)
+    {
+        KeyObject start(ns, KEY_HASH_FIELD, "");
+        start.SetObjectId(object_id);
+        Iterator* iter = g_db->GetEngine()->Find(ctx, start);
+        int err = 0;
+        while (objectlen > 0 && iter->Valid())
+        {
+            KeyObject& k = iter->Key();
+            if (k.GetType() != KEY_HASH_FIELD || !k.IsSameObject(start))
+            {
+                break;
+            }
+            if ((err = WriteStringObject(k.GetHashField())) < 0 || (err = WriteStringObject(iter->Value().GetHashValue())) < 0)
+            {
+                break;
+            }
+            objectlen--;
+            iter->Next();
+        }
+        DELETE(iter);
+        return err;
+    }
+
     int ObjectIO::WriteStringObject(const Data& o)
     {
         /* Avoid to decode the object, then encode it again, if the
@@ -672,167 +750,316 @@ namespace ardb
         Write(magic, 9);
     }
 
-    void ObjectIO::RedisLoadListZipList(Context& ctx, unsigned char* data, const std::string& key, ValueObject& listmeta)
+    /*
+     * Ziplist & listpack blobs are walked in place: string entries are borrowed from the blob & integer entries
+     * stay integers, so elements reach the engine encoder without an intermediate std::string.
+     */
+    class PackedBlobReader
     {
-        unsigned char* iter = ziplistIndex(data, 0);
-        listmeta.SetType(KEY_LIST);
-        //BatchWriteGuard guard(g_db->GetKeyValueEngine());
-        int64 idx = 0;
-        while (iter != NULL)
-        {
-            unsigned char *vstr;
-            unsigned int vlen;
-            long long vlong;
-            if (ziplistGet(iter, &vstr, &vlen, &vlong))
+        private:
+            bool m_listpack;
+            unsigned char* m_blob;
+            const unsigned char* m_end;
+            unsigned char* m_pos;
+            static uint32 BacklenSize(uint64 len)
+            {
+                if (len <= 127)
+                    return 1;
+                if (len < 16383)
+                    return 2;
+                if (len < 2097151)
+                    return 3;
+                if (len < 268435455)
+                    return 4;
+                return 5;
+            }
+            static uint64 LittleEndian(const unsigned char* p, int bytes)
+            {
+                uint64 v = 0;
+                for (int i = bytes - 1; i >= 0; i--)
+                {
+                    v = (v << 8) | p[i];
+                }
+                return v;
+            }
+            int NextListpackEntry(const unsigned char*& str, uint32& len, int64& ival)
+            {
+                const unsigned char* p = m_pos;
+                size_t avail = m_end - p;
+                if (avail < 1)
+                {
+                    return -1;
+                }
+                uint8 b = p[0];
+                if (b == 0xFF)
+                {
+                    return 0;
+                }
+                uint64 entry_len = 0;
+                str = NULL;
+                if ((b & 0x80) == 0)
+                {
+                    ival = b & 0x7F;
+                    entry_len = 1;
+                }
+                else if ((b & 0xC0) == 0x80)
+                {
+                    len = b & 0x3F;
+                    str = p + 1;
+                    entry_len = 1 + len;
+                }
+                else if ((b & 0xE0) == 0xC0)
+                {
+                    if (avail < 2)
+                    {
+                        return -1;
+                    }
+                    uint32 u = ((b & 0x1F) << 8) | p[1];
+                    ival = u >= (1 << 12) ? (int64) u - (1 << 13) : u;
+                    entry_len = 2;
+                }
+                else if ((b & 0xF0) == 0xE0)
+                {
+                    if (avail < 2)
+                    {
+                        return -1;
+                    }
+                    len = ((b & 0x0F) << 8) | p[1];
+                    str = p + 2;
+                    entry_len = 2 + len;
+                }
+                else if (b == 0xF0)
+                {
+                    if (avail < 5)
+                    {
+                        return -1;
+                    }
+                    len = (uint32) LittleEndian(p + 1, 4);
+                    str = p + 5;
+                    entry_len = 5 + (uint64) len;
+                }
+                else if (b >= 0xF1 && b <= 0xF4)
+                {
+                    static const int kIntBytes[] = { 2, 3, 4, 8 };
+                    int bytes = kIntBytes[b - 0xF1];
+                    if (avail < (size_t) bytes + 1)
+                    {
+                        return -1;
+                    }
+                    uint64 u = LittleEndian(p + 1, bytes);
+                    int bits = bytes * 8;
+                    ival = (bits < 64 && (u >> (bits - 1))) ? (int64) (u - (1ULL << bits)) : (int64) u;
+                    entry_len = 1 + bytes;
+                }
+                else
+                {
+                    return -1;
+                }
+                uint64 total = entry_len + BacklenSize(entry_len);
+                if (avail < total)
+                {
+                    return -1;
+                }
+                m_pos += total;
+                return 1;
+            }
+        public:
+            PackedBlobReader(bool listpack, unsigned char* blob, size_t size) :
+                    m_listpack(listpack), m_blob(blob), m_end(blob + size), m_pos(NULL)
+            {
+                if (!m_listpack)
+                {
+                    m_pos = size > 10 ? ziplistIndex(m_blob, 0) : NULL;
+                }
+                else if (size >= 7)
+                {
+                    m_pos = m_blob + 6;
+                }
+            }
+            /*
+             * 1 with the next entry(a string if 'str' is not NULL, or the integer 'ival'), 0 at the end, -1 if corrupted.
+             */
+            int Next(const unsigned char*& str, uint32& len, int64& ival)
+            {
+                if (m_listpack)
+                {
+                    return NULL == m_pos ? -1 : NextListpackEntry(str, len, ival);
+                }
+                if (NULL == m_pos)
+                {
+                    return 0;
+                }
+                unsigned char* vstr = NULL;
+                unsigned int vlen = 0;
+                long long vlong = 0;
+                if (!ziplistGet(m_pos, &vstr, &vlen, &vlong))
+                {
+                    return 0;
+                }
+                str = vstr;
+                len = vlen;
+                ival = vlong;
+                m_pos = ziplistNext(m_blob, m_pos);
+                return 1;
+            }
+            /*
+             * The next entry as a borrowed Data, integer like strings are integers if 'int_encoding' like
+             * Data::SetString(str, true) does, otherwise integers are formatted into 'numbuf'.
+             */
+            int Next(Data& d, bool int_encoding, char* numbuf, size_t numbuf_size)
             {
-                std::string value;
-                if (vstr)
+                const unsigned char* str = NULL;
+                uint32 len = 0;
+                int64 ival = 0;
+                int ret = Next(str, len, ival);
+                if (ret <= 0)
+                {
+                    return ret;
+                }
+                int64_t v = 0;
+                if (NULL != str && int_encoding && len <= 21 && string2ll((const char*) str, len, &v))
+                {
+                    d.SetInt64(v);
+                }
+                else if (NULL != str)
+                {
+                    d.SetString((const char*) str, len, false);
+                }
+                else if (int_encoding)
                 {
-                    value.assign((char*) vstr, vlen);
+                    d.SetInt64(ival);
                 }
                 else
                 {
-                    value = stringfromll(vlong);
+                    d.SetString(numbuf, ll2string(numbuf, numbuf_size, ival), false);
+                }
+                return 1;
+            }
+            int NextScore(double& score)
+            {
+                const unsigned char* str = NULL;
+                uint32 len = 0;
+                int64 ival = 0;
+                int ret = Next(str, len, ival);
+                if (ret <= 0)
+                {
+                    return ret;
+                }
+                if (NULL == str)
+                {
+                    score = ival;
+                    return 1;
+                }
+                char buf[128];
+                if (len >= sizeof(buf))
+                {
+                    return -1;
                 }
-                KeyObject lk(ctx.ns, KEY_LIST_ELEMENT, key);
-                lk.SetListIndex(idx);
-                ValueObject lv;
-                lv.SetType(KEY_LIST_ELEMENT);
-                lv.SetListElement(value);
-                idx++;
-                //g_db->SetKeyValue(ctx, lk, lv);
-                GetDBWriter().Put(ctx, lk, lv);
+                memcpy(buf, str, len);
+                buf[len] = '\0';
+                score = strtod(buf, NULL);
+                return 1;
             }
-            iter = ziplistNext(data, iter);
+    };
+
+    bool ObjectIO::RedisLoadPackedList(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& listmeta, int64& idx)
+    {
+        listmeta.SetType(KEY_LIST);
+        KeyObject lk(ctx.ns, KEY_LIST_ELEMENT, key);
+        ValueObject lv;
+        lv.SetType(KEY_LIST_ELEMENT);
+        char numbuf[32];
+        Data element;
+        int ret;
+        while ((ret = reader.Next(element, true, numbuf, sizeof(numbuf))) > 0)
+        {
+            lk.SetListIndex(idx);
+            lv.SetListElement(element);
+            idx++;
+            GetDBWriter().Put(ctx, lk, lv);
         }
         listmeta.SetObjectLen(idx);
         listmeta.SetListMinIdx(0);
         listmeta.SetListMaxIdx(idx - 1);
         listmeta.GetMetaObject().list_sequential = true;
+        return ret == 0;
     }
 
-    static double zzlGetScore(unsigned char *sptr)
-    {
-        unsigned char *vstr;
-        unsigned int vlen;
-        long long vlong;
-        char buf[128];
-        double score;
-
-        ASSERT(sptr != NULL);
-        ASSERT(ziplistGet(sptr, &vstr, &vlen, &vlong));
-        if (vstr)
-        {
-            memcpy(buf, vstr, vlen);
-            buf[vlen] = '\0';
-            score = strtod(buf, NULL);
-        }
-        else
-        {
-            score = vlong;
-        }
-        return score;
-    }
-    void ObjectIO::RedisLoadZSetZipList(Context& ctx, unsigned char* data, const std::string& key, ValueObject& meta_value)
+    bool ObjectIO::RedisLoadPackedZSet(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& meta_value)
     {
         meta_value.SetType(KEY_ZSET);
-        meta_value.SetObjectLen(ziplistLen(data) / 2);
-        unsigned char* iter = ziplistIndex(data, 0);
-        while (iter != NULL)
-        {
-            unsigned char *vstr;
-            unsigned int vlen;
-            long long vlong;
-            std::string value;
-            if (ziplistGet(iter, &vstr, &vlen, &vlong))
+        KeyObject zsort(ctx.ns, KEY_ZSET_SORT, key);
+        ValueObject zsort_value;
+        zsort_value.SetType(KEY_ZSET_SORT);
+        KeyObject zscore(ctx.ns, KEY_ZSET_SCORE, key);
+        ValueObject zscore_value;
+        zscore_value.SetType(KEY_ZSET_SCORE);
+        char numbuf[32];
+        Data member;
+        int64 len = 0;
+        int ret;
+        while ((ret = reader.Next(member, false, numbuf, sizeof(numbuf))) > 0)
+        {
+            double score = 0;
+            if (reader.NextScore(score) <= 0)
             {
-                if (vstr)
-                {
-                    value.assign((char*) vstr, vlen);
-                }
-                else
-                {
-                    value = stringfromll(vlong);
-                }
-            }
-            iter = ziplistNext(data, iter);
-            if (NULL == iter)
-            {
-                break;
+                return false;
             }
-            double score = zzlGetScore(iter);
-            KeyObject zsort(ctx.ns, KEY_ZSET_SORT, key);
-            zsort.SetZSetMember(value);
+            zsort.SetZSetMember(member);
             zsort.SetZSetScore(score);
-            ValueObject zsort_value;
-            zsort_value.SetType(KEY_ZSET_SORT);
-            KeyObject zscore(ctx.ns, KEY_ZSET_SCORE, key);
-            zscore.SetZSetMember(value);
-            ValueObject zscore_value;
-            zscore_value.SetType(KEY_ZSET_SCORE);
+            zscore.SetZSetMember(member);
             zscore_value.SetZSetScore(score);
-            //g_db->SetKeyValue(ctx, zsort, zscore_value);
-            //g_db->SetKeyValue(ctx, zscore, zscore_value);
             GetDBWriter().Put(ctx, zsort, zsort_value);
             GetDBWriter().Put(ctx, zscore, zscore_value);
-            iter = ziplistNext(data, iter);
+            len++;
         }
+        meta_value.SetObjectLen(len);
+        return ret == 0;
     }
 
-    void ObjectIO::RedisLoadHashZipList(Context& ctx, unsigned char* data, const std::string& key, ValueObject& meta_value)
+    bool ObjectIO::RedisLoadPackedHash(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& meta_value)
     {
         meta_value.SetType(KEY_HASH);
-        meta_value.SetObjectLen(ziplistLen(data)/2);
-        //BatchWriteGuard guard(g_db->GetKeyValueEngine());
-        unsigned char* iter = ziplistIndex(data, 0);
-        while (iter != NULL)
-        {
-            unsigned char *vstr, *fstr;
-            unsigned int vlen, flen;
-            long long vlong, flong;
-            std::string field, value;
-            if (ziplistGet(iter, &fstr, &flen, &flong))
-            {
-                if (fstr)
-                {
-                    field.assign((char*) fstr, flen);
-                }
-                else
-                {
-                    field = stringfromll(flong);
-                }
-            }
-            else
-            {
-                break;
-            }
-            iter = ziplistNext(data, iter);
-            if (NULL == iter)
-            {
-                break;
-            }
-            if (ziplistGet(iter, &vstr, &vlen, &vlong))
+        KeyObject fkey(ctx.ns, KEY_HASH_FIELD, key);
+        ValueObject fvalue;
+        fvalue.SetType(KEY_HASH_FIELD);
+        char fnumbuf[32], vnumbuf[32];
+        Data field, value;
+        int64 len = 0;
+        int ret;
+        while ((ret = reader.Next(field, true, fnumbuf, sizeof(fnumbuf))) > 0)
+        {
+            if (reader.Next(value, true, vnumbuf, sizeof(vnumbuf)) <= 0)
             {
-                if (vstr)
-                {
-                    value.assign((char*) vstr, vlen);
-                }
-                else
-                {
-                    value = stringfromll(vlong);
-                }
-                KeyObject fkey(ctx.ns, KEY_HASH_FIELD, key);
-                fkey.SetHashField(field);
-                ValueObject fvalue;
-                fvalue.SetType(KEY_HASH_FIELD);
-                fvalue.SetHashValue(value);
-                GetDBWriter().Put(ctx, fkey, fvalue);
-                //g_db->SetKeyValue(ctx, fkey, fvalue);
+                return false;
             }
-            iter = ziplistNext(data, iter);
+            fkey.SetHashField(field);
+            fvalue.SetHashValue(value);
+            GetDBWriter().Put(ctx, fkey, fvalue);
+            len++;
+        }
+        meta_value.SetObjectLen(len);
+        return ret == 0;
+    }
+
+    bool ObjectIO::RedisLoadPackedSet(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& meta_value)
+    {
+        meta_value.SetType(KEY_SET);
+        KeyObject member(ctx.ns, KEY_SET_MEMBER, key);
+        ValueObject member_value;
+        member_value.SetType(KEY_SET_MEMBER);
+        char numbuf[32];
+        Data element;
+        int64 len = 0;
+        int ret;
+        while ((ret = reader.Next(element, true, numbuf, sizeof(numbuf))) > 0)
+        {
+            member.SetSetMember(element);
+            GetDBWriter().Put(ctx, member, member_value);
+            len++;
         }
-        //        KeyObject hkey(ctx.ns, KEY_META, key);
-        //        g_db->SetKeyValue(ctx, hkey, hmeta);
+        meta_value.SetObjectLen(len);
+        return ret == 0;
     }
 
     void ObjectIO::RedisLoadSetIntSet(Context& ctx, unsigned char* data, const std::string& key, ValueObject& meta_value)
@@ -841,17 +1068,14 @@ namespace ardb
         int64_t llele = 0;
         meta_value.SetType(KEY_SET);
         meta_value.SetObjectLen(intsetLen((intset*) data));
-        while (!intsetGet((intset*) data, ii++, &llele))
+        KeyObject member(ctx.ns, KEY_SET_MEMBER, key);
+        ValueObject member_value;
+        member_value.SetType(KEY_SET_MEMBER);
+        while (intsetGet((intset*) data, ii++, &llele))
         {
-            KeyObject member(ctx.ns, KEY_SET_MEMBER, key);
-            member.SetSetMember(stringfromll(llele));
-            ValueObject member_value;
-            member_value.SetType(KEY_SET_MEMBER);
-            //g_db->SetKeyValue(ctx, member, member_value);
+            member.SetSetMember(Data((int64_t) llele));
             GetDBWriter().Put(ctx, member, member_value);
         }
-        //        KeyObject skey(ctx.ns, KEY_META, key);
-        //        g_db->SetKeyValue(ctx, skey, smeta);
     }
 
     bool ObjectIO::RedisLoadObject(Context& ctx, int rdbtype, const std::string& key, int64 expiretime)
@@ -895,33 +1119,27 @@ namespace ardb
                     meta_value.SetObjectLen(len);
                     meta_value.GetMetaObject().list_sequential = true;
                 }
+                KeyObject member(ctx.ns, REDIS_RDB_TYPE_SET == rdbtype ? KEY_SET_MEMBER : KEY_LIST_ELEMENT, key);
+                ValueObject member_val;
+                member_val.SetType(REDIS_RDB_TYPE_SET == rdbtype ? KEY_SET_MEMBER : KEY_LIST_ELEMENT);
+                std::string str;
                 int64 idx = 0;
                 while (len--)
                 {
-                    std::string str;
                     if (ReadString(str))
                     {
                         //push to list/set
                         if (REDIS_RDB_TYPE_SET == rdbtype)
                         {
-                            KeyObject member(ctx.ns, KEY_SET_MEMBER, key);
                             member.SetSetMember(str);
-                            ValueObject member_val;
-                            member_val.SetType(KEY_SET_MEMBER);
-                            //g_db->SetKeyValue(ctx, member, member_val);
-                            GetDBWriter().Put(ctx, member, member_val);
                         }
                         else
                         {
-                            KeyObject lk(ctx.ns, KEY_LIST_ELEMENT, key);
-                            lk.SetListIndex(idx);
-                            ValueObject lv;
-                            lv.SetType(KEY_LIST_ELEMENT);
-                            lv.SetListElement(str);
-                            //g_db->SetKeyValue(ctx, lk, lv);
-                            GetDBWriter().Put(ctx, lk, lv);
+                            member.SetListIndex(idx);
+                            member_val.SetListElement(str);
                             idx++;
                         }
+                        GetDBWriter().Put(ctx, member, member_val);
                     }
                     else
                     {
@@ -934,100 +1152,86 @@ namespace ardb
                     meta_value.SetListMinIdx(0);
                     meta_value.SetListMaxIdx(idx - 1);
                 }
-                //g_db->SetKeyValue(ctx, meta_key, zmeta);
                 break;
             }
             case REDIS_RDB_TYPE_LIST_QUICKLIST:
+            case REDIS_RDB_TYPE_LIST_QUICKLIST_2:
             {
-                uint32 ziplen;
-                if ((ziplen = ReadLen(NULL)) == REDIS_RDB_LENERR)
+                uint32 nodes;
+                if ((nodes = ReadLen(NULL)) == REDIS_RDB_LENERR)
                     return false;
                 meta_value.SetType(KEY_LIST);
                 meta_value.GetMetaObject().list_sequential = true;
                 int64 idx = 0;
-                while (ziplen--)
+                std::string node;
+                while (nodes--)
                 {
-                    std::string zipstr;
-                    if (ReadString(zipstr))
+                    uint32 container = REDIS_QUICKLIST_NODE_CONTAINER_PACKED;
+                    if (REDIS_RDB_TYPE_LIST_QUICKLIST_2 == rdbtype && (container = ReadLen(NULL)) == REDIS_RDB_LENERR)
                     {
-                        unsigned char* data = (unsigned char*) (&(zipstr[0]));
-                        unsigned char* iter = ziplistIndex(data, 0);
-                        while (iter != NULL)
-                        {
-                            unsigned char *vstr;
-                            unsigned int vlen;
-                            long long vlong;
-                            if (ziplistGet(iter, &vstr, &vlen, &vlong))
-                            {
-                                std::string value;
-                                if (vstr)
-                                {
-                                    value.assign((char*) vstr, vlen);
-                                }
-                                else
-                                {
-                                    value = stringfromll(vlong);
-                                }
-                                KeyObject lk(ctx.ns, KEY_LIST_ELEMENT, key);
-                                lk.SetListIndex(idx);
-                                ValueObject lv;
-                                lv.SetType(KEY_LIST_ELEMENT);
-                                lv.SetListElement(value);
-                                //g_db->Set
-                                idx++;
-                                //g_db->SetKeyValue(ctx, lk, lv);
-                                GetDBWriter().Put(ctx, lk, lv);
-                            }
-                            iter = ziplistNext(data, iter);
-                        }
+                        return false;
                     }
-                    else
+                    if (!ReadString(node))
+                    {
+                        return false;
+                    }
+                    if (REDIS_QUICKLIST_NODE_CONTAINER_PLAIN == container)
+                    {
+                        KeyObject lk(ctx.ns, KEY_LIST_ELEMENT, key);
+                        lk.SetListIndex(idx);
+                        ValueObject lv;
+                        lv.SetType(KEY_LIST_ELEMENT);
+                        lv.SetListElement(node);
+                        GetDBWriter().Put(ctx, lk, lv);
+                        idx++;
+                        continue;
+                    }
+                    PackedBlobReader reader(REDIS_RDB_TYPE_LIST_QUICKLIST_2 == rdbtype, (unsigned char*) &node[0], node.size());
+                    if (!RedisLoadPackedList(ctx, reader, key, meta_value, idx))
                     {
+                        ERROR_LOG("Corrupted quicklist node of list:%s", key.c_str());
                         return false;
                     }
                 }
-                meta_value.GetMetaObject().list_sequential = true;
                 meta_value.SetListMinIdx(0);
                 meta_value.SetListMaxIdx(idx - 1);
                 meta_value.SetObjectLen(idx);
                 break;
             }
             case REDIS_RDB_TYPE_ZSET:
+            case REDIS_RDB_TYPE_ZSET_2:
             {
                 uint32 len;
                 if ((len = ReadLen(NULL)) == REDIS_RDB_LENERR)
                     return false;
                 meta_value.SetType(KEY_ZSET);
                 meta_value.SetObjectLen(len);
+                KeyObject zsort(ctx.ns, KEY_ZSET_SORT, key);
+                ValueObject zsort_value;
+                zsort_value.SetType(KEY_ZSET_SORT);
+                KeyObject zscore(ctx.ns, KEY_ZSET_SCORE, key);
+                ValueObject zscore_value;
+                zscore_value.SetType(KEY_ZSET_SCORE);
+                std::string str;
                 while (len--)
                 {
-                    std::string str;
                     double score;
-                    if (ReadString(str) && 0 == ReadDoubleValue(score))
+                    if (!ReadString(str))
                     {
-                        //save value score
-                        //g_db->ZAdd(m_current_db, key, score, str);
-                        KeyObject zsort(ctx.ns, KEY_ZSET_SORT, key);
-                        zsort.SetZSetMember(str);
-                        zsort.SetZSetScore(score);
-                        ValueObject zsort_value;
-                        zsort_value.SetType(KEY_ZSET_SORT);
-                        KeyObject zscore(ctx.ns, KEY_ZSET_SCORE, key);
-                        zscore.SetZSetMember(str);
-                        ValueObject zscore_value;
-                        zscore_value.SetType(KEY_ZSET_SCORE);
-                        zscore_value.SetZSetScore(score);
-                        //g_db->SetKeyValue(ctx, zsort, zscore_value);
-                        //g_db->SetKeyValue(ctx, zscore, zscore_value);
-                        GetDBWriter().Put(ctx, zsort, zsort_value);
-                        GetDBWriter().Put(ctx, zscore, zscore_value);
+                        return false;
                     }
-                    else
+                    /* ZSET_2 stores the score as a binary little endian double. */
+                    if (REDIS_RDB_TYPE_ZSET_2 == rdbtype ? !Read(&score, 8) : 0 != ReadDoubleValue(score))
                     {
                         return false;
                     }
+                    zsort.SetZSetMember(str);
+                    zsort.SetZSetScore(score);
+                    zscore.SetZSetMember(str);
+                    zscore_value.SetZSetScore(score);
+                    GetDBWriter().Put(ctx, zsort, zsort_value);
+                    GetDBWriter().Put(ctx, zscore, zscore_value);
                 }
-                //g_db->SetKeyValue(ctx, meta_key, zmeta);
                 break;
             }
             case REDIS_RDB_TYPE_HASH:
@@ -1037,18 +1241,16 @@ namespace ardb
                     return false;
                 meta_value.SetType(KEY_HASH);
                 meta_value.SetObjectLen(len);
+                KeyObject fkey(ctx.ns, KEY_HASH_FIELD, key);
+                ValueObject fvalue;
+                fvalue.SetType(KEY_HASH_FIELD);
+                std::string field, str;
                 while (len--)
                 {
-                    std::string field, str;
                     if (ReadString(field) && ReadString(str))
                     {
-                        //save hash value
-                        KeyObject fkey(ctx.ns, KEY_HASH_FIELD, key);
                         fkey.SetHashField(field);
-                        ValueObject fvalue;
-                        fvalue.SetType(KEY_HASH_FIELD);
                         fvalue.SetHashValue(str);
-                        //g_db->SetKeyValue(ctx, fkey, fvalue);
                         GetDBWriter().Put(ctx, fkey, fvalue);
                     }
                     else
@@ -1056,7 +1258,6 @@ namespace ardb
                         return false;
                     }
                 }
-                //g_db->SetKeyValue(ctx, meta_key, hmeta);
                 break;
             }
             case REDIS_RDB_TYPE_HASH_ZIPMAP:
@@ -1064,6 +1265,9 @@ namespace ardb
             case REDIS_RDB_TYPE_SET_INTSET:
             case REDIS_RDB_TYPE_ZSET_ZIPLIST:
             case REDIS_RDB_TYPE_HASH_ZIPLIST:
+            case REDIS_RDB_TYPE_HASH_LISTPACK:
+            case REDIS_RDB_TYPE_ZSET_LISTPACK:
+            case REDIS_RDB_TYPE_SET_LISTPACK:
             {
                 std::string aux;
                 if (!ReadString(aux))
@@ -1071,6 +1275,10 @@ namespace ardb
                     return false;
                 }
                 unsigned char* data = (unsigned char*) (&(aux[0]));
+                bool listpack = rdbtype == REDIS_RDB_TYPE_HASH_LISTPACK || rdbtype == REDIS_RDB_TYPE_ZSET_LISTPACK
+                        || rdbtype == REDIS_RDB_TYPE_SET_LISTPACK;
+                PackedBlobReader reader(listpack, data, aux.size());
+                bool loaded = true;
                 switch (rdbtype)
                 {
                     case REDIS_RDB_TYPE_HASH_ZIPMAP:
@@ -1078,16 +1286,10 @@ namespace ardb
                         unsigned char *zi = zipmapRewind(data);
                         unsigned char *fstr, *vstr;
                         unsigned int flen, vlen;
-                        //                        unsigned int maxlen = 0;
-                        //                      ValueObject hmeta;
                         meta_value.SetType(KEY_HASH);
                         int64 hlen = 0;
                         while ((zi = zipmapNext(zi, &fstr, &flen, &vstr, &vlen)) != NULL)
                         {
-                            //                            if (flen > maxlen)
-                            //                                maxlen = flen;
-                            //                            if (vlen > maxlen)
-                            //                                maxlen = vlen;
                             std::string fstring, fvstring;
                             fstring.assign((char*) fstr, flen);
                             fvstring.assign((char*) vstr, vlen);
@@ -1096,17 +1298,16 @@ namespace ardb
                             ValueObject fvalue;
                             fvalue.SetType(KEY_HASH_FIELD);
                             fvalue.SetHashValue(fvstring);
-                            //g_db->SetKeyValue(ctx, fkey, fvalue);
                             GetDBWriter().Put(ctx, fkey, fvalue);
                             hlen++;
                         }
                         meta_value.SetObjectLen(hlen);
-                        //g_db->SetKeyValue(ctx, meta_key, hmeta);
                         break;
                     }
                     case REDIS_RDB_TYPE_LIST_ZIPLIST:
                     {
-                        RedisLoadListZipList(ctx, data, key, meta_value);
+                        int64 idx = 0;
+                        loaded = RedisLoadPackedList(ctx, reader, key, meta_value, idx);
                         break;
                     }
                     case REDIS_RDB_TYPE_SET_INTSET:
@@ -1114,28 +1315,43 @@ namespace ardb
                         RedisLoadSetIntSet(ctx, data, key, meta_value);
                         break;
                     }
-                    case REDIS_RDB_TYPE_ZSET_ZIPLIST:
+                    case REDIS_RDB_TYPE_SET_LISTPACK:
                     {
-                        RedisLoadZSetZipList(ctx, data, key, meta_value);
+                        loaded = RedisLoadPackedSet(ctx, reader, key, meta_value);
                         break;
                     }
-                    case REDIS_RDB_TYPE_HASH_ZIPLIST:
+                    case REDIS_RDB_TYPE_ZSET_ZIPLIST:
+                    case REDIS_RDB_TYPE_ZSET_LISTPACK:
                     {
-                        RedisLoadHashZipList(ctx, data, key, meta_value);
+                        loaded = RedisLoadPackedZSet(ctx, reader, key, meta_value);
                         break;
                     }
                     default:
                     {
-                        ERROR_LOG("Unknown encoding");
-                        abort();
+                        loaded = RedisLoadPackedHash(ctx, reader, key, meta_value);
+                        break;
                     }
                 }
+                if (!loaded)
+                {
+                    ERROR_LOG("Corrupted encoded object:%s with type:%d", key.c_str(), rdbtype);
+                    return false;
+                }
                 break;
             }
+            case REDIS_RDB_TYPE_MODULE:
+            case REDIS_RDB_TYPE_MODULE_2:
+            case REDIS_RDB_TYPE_STREAM_LISTPACKS:
+            case REDIS_RDB_TYPE_STREAM_LISTPACKS_2:
+            case REDIS_RDB_TYPE_STREAM_LISTPACKS_3:
+            {
+                ERROR_LOG("Can NOT load module/stream object:%s with type:%d from redis dump.", key.c_str(), rdbtype);
+                return false;
+            }
             default:
             {
                 ERROR_LOG("Unknown object type:%d", rdbtype);
-                abort();
+                return false;
             }
         }
         if (expiretime > 0)
@@ -1154,12 +1370,17 @@ namespace ardb
     int ObjectIO::ArdbWriteMagicHeader()
     {
         char magic[10];
-        snprintf(magic, sizeof(magic), "ARDB%04d", ARDB_RDB_VERSION);
+        /*
+         * version 2 only tells that raw keys may be in another key codec than KEY_CODEC_V1, older versions
+         * can still load the dumps of KEY_CODEC_V1 instances.
+         */
+        snprintf(magic, sizeof(magic), "ARDB%04d", get_key_codec_version() == KEY_CODEC_V1 ? 1 : ARDB_RDB_VERSION);
         return Write(magic, 8);
     }
 
     int ObjectIO::ArdbLoadBuffer(Context& ctx, Buffer& buffer)
     {
+        Buffer transcoded;
         while (buffer.Readable())
         {
             int64 ttl = 0;
@@ -1179,6 +1400,45 @@ namespace ardb
                 ERROR_LOG("Failed to read value in kv pair.");
                 return -1;
             }
+            if (m_key_codec != get_key_codec_version())
+            {
+                Buffer keybuf((char*) key.data(), 0, key.size());
+                KeyObject kk;
+                if (!kk.Decode(keybuf, false, false, m_key_codec))
+                {
+                    ERROR_LOG("Failed to decode key object of key codec version:%u.", m_key_codec);
+                    return -1;
+                }
+                if (kk.GetObjectId() > 0)
+                {
+                    ERROR_LOG("Failed to transcode key keyed by object id:%llu.", kk.GetObjectId());
+                    return -1;
+                }
+                transcoded.Clear();
+                key = kk.Encode(transcoded, false, false);
+            }
+            if (NULL != m_load_key)
+            {
+                Buffer keybuf((char*) key.data(), 0, key.size());
+                KeyObject kk;
+                if (!kk.Decode(keybuf, false, false) || kk.GetObjectId() > 0 || kk.GetKey().AsString() != *m_load_key)
+                {
+                    ERROR_LOG("Raw key in chunk does not belong to key:%s.", m_load_key->c_str());
+                    return -1;
+                }
+            }
+            /*
+             * besides keys by object id only the empty key & keys starting with a zero byte start with one in KEY_CODEC_V2
+             */
+            if (get_key_codec_version() == KEY_CODEC_V2 && key.size() > 0 && key.data()[0] == 0)
+            {
+                Buffer keybuf((char*) key.data(), 0, key.size());
+                KeyObject kk;
+                if (kk.Decode(keybuf, false, false) && kk.GetObjectId() > 0)
+                {
+                    g_db->ObserveObjectId(kk.GetObjectId());
+                }
+            }
             //g_db->GetEngine()->PutRaw(ctx, ctx.ns, key, value);
             GetDBWriter().Put(ctx, ctx.ns, key, value);
             if (ttl > 0 && !g_db->GetEngine()->GetFeatureSet().support_compactfilter)
@@ -1196,6 +1456,36 @@ namespace ardb
         return 0;
     }
 
+    bool ObjectIO::ArdbLoadAux(const std::string& aux_key, const std::string& aux_val)
+    {
+        if (aux_key == "key_codec")
+        {
+            uint32 codec;
+            if (!string_touint32(aux_val, codec) || codec < KEY_CODEC_V1 || codec > KEY_CODEC_V3)
+            {
+                ERROR_LOG("Invalid key codec version:%s", aux_val.c_str());
+                return false;
+            }
+            m_key_codec = codec;
+        }
+        return true;
+    }
+
+    /*
+     * Raw keys written after it are in the key codec of this instance, nothing is written for KEY_CODEC_V1
+     * which is assumed when it is missing.
+     */
+    int ObjectIO::ArdbWriteKeyCodec()
+    {
+        if (get_key_codec_version() == KEY_CODEC_V1)
+        {
+            return 0;
+        }
+        RETURN_NEGATIVE_EXPR(WriteType(ARDB_OPCODE_AUX));
+        RETURN_NEGATIVE_EXPR(WriteRawString("key_codec"));
+        return WriteRawString(stringfromll(get_key_codec_version()));
+    }
+
     int ObjectIO::ArdbSaveRawKeyValue(const Slice& key, const Slice& value, Buffer& buffer, int64 ttl)
     {
         BufferHelper::WriteVarInt64(buffer, ttl);
@@ -1204,32 +1494,50 @@ namespace ardb
         return 0;
     }
 
-    int ObjectIO::ArdbFlushWriteBuffer(Buffer& buffer)
+    /*
+     * 'write_lock' serializes chunks flushed by concurrent dump threads, compression runs outside of it.
+     */
+    int ObjectIO::ArdbFlushWriteBuffer(Buffer& buffer, ThreadMutexLock* write_lock)
     {
-        if (buffer.Readable())
+        if (!buffer.Readable())
+        {
+            return 0;
+        }
+        std::string compressed;
+        snappy::Compress(buffer.GetRawReadBuffer(), buffer.ReadableBytes(), &compressed);
+        int ret = 0;
+        if (NULL != write_lock)
+        {
+            write_lock->Lock();
+        }
+        if (compressed.size() > (buffer.ReadableBytes() + 4))
         {
-            std::string compressed;
-            snappy::Compress(buffer.GetRawReadBuffer(), buffer.ReadableBytes(), &compressed);
-            if (compressed.size() > (buffer.ReadableBytes() + 4))
+            uint32 len = buffer.ReadableBytes();
+            if ((ret = WriteType(ARDB_RDB_TYPE_CHUNK)) >= 0 && (ret = WriteLen(len)) >= 0)
             {
-                RETURN_NEGATIVE_EXPR(WriteType(ARDB_RDB_TYPE_CHUNK));
-                uint32 len = buffer.ReadableBytes();
-                RETURN_NEGATIVE_EXPR(WriteLen(len));
-                RETURN_NEGATIVE_EXPR(Write(buffer.GetRawReadBuffer(), buffer.ReadableBytes()));
+                ret = Write(buffer.GetRawReadBuffer(), buffer.ReadableBytes());
             }
-            else
+        }
+        else
+        {
+            uint32 rawlen = buffer.ReadableBytes();
+            if ((ret = WriteType(ARDB_RDB_TYPE_SNAPPY_CHUNK)) >= 0 && (ret = WriteLen(rawlen)) >= 0 && (ret = WriteLen(compressed.size())) >= 0)
             {
-                RETURN_NEGATIVE_EXPR(WriteType(ARDB_RDB_TYPE_SNAPPY_CHUNK));
-                uint32 rawlen = buffer.ReadableBytes();
-                RETURN_NEGATIVE_EXPR(WriteLen(rawlen));
-                RETURN_NEGATIVE_EXPR(WriteLen(compressed.size()));
-                RETURN_NEGATIVE_EXPR(Write(compressed.data(), compressed.size()));
+                ret = Write(compressed.data(), compressed.size());
             }
-            buffer.Clear();
         }
-        return 0;
-    }
-
+        if (NULL != write_lock)
+        {
+            write_lock->Unlock();
+        }
+        if (ret < 0)
+        {
+            return ret;
+        }
+        buffer.Clear();
+        return 0;
+    }
+
     int ObjectIO::ArdbLoadChunk(Context& ctx, int type)
     {
         if (type == ARDB_RDB_TYPE_CHUNK)
@@ -1311,7 +1619,7 @@ namespace ardb
 
         /* Verify RDB version */
         rdbver = (footer[1] << 8) | footer[0];
-        if (rdbver > REDIS_RDB_VERSION)
+        if (rdbver > REDIS_RDB_LOAD_MAX_VERSION)
             return false;
 
         /* Verify CRC64 */
@@ -1339,6 +1647,16 @@ namespace ardb
         int type = 0;
         if ((type = ReadType()) == -1)
             return false;
+        while (type == ARDB_OPCODE_AUX)
+        {
+            std::string aux_key, aux_val;
+            if (!ReadString(aux_key) || !ReadString(aux_val) || !ArdbLoadAux(aux_key, aux_val))
+            {
+                return false;
+            }
+            if ((type = ReadType()) == -1)
+                return false;
+        }
         if (type == ARDB_RDB_TYPE_CHUNK || type == ARDB_RDB_TYPE_SNAPPY_CHUNK)
         {
             return ArdbLoadChunk(ctx, type) == 0;
@@ -1395,6 +1713,7 @@ namespace ardb
                     {
                         case KEY_STRING:
                         {
+                            g_db->LoadBitmapChunks(ctx, k, v);
                             WriteStringObject(v.GetStringValue());
                             iter_continue = false;
                             break;
@@ -1407,6 +1726,21 @@ namespace ardb
                             g_db->ObjectLen(ctx, current_keytype, k.GetKey().AsString());
                             objectlen = ctx.GetReply().GetInteger();
                             WriteLen(objectlen);
+                            if (current_keytype == KEY_HASH && v.IsPacked())
+                            {
+                                for (size_t i = 0; i < v.PackedCount(); i++)
+                                {
+                                    WriteStringObject(v.PackedField(i));
+                                    WriteStringObject(v.PackedValue(i));
+                                }
+                                objectlen = 0;
+                                iter_continue = false;
+                            }
+                            else if (current_keytype == KEY_HASH && v.GetObjectId() > 0)
+                            {
+                                WriteObjectIdHashFields(ctx, k.GetNameSpace(), v.GetObjectId(), objectlen);
+                                iter_continue = false;
+                            }
                             //DUMP_CHECK_WRITE(WriteStringObject(v.GetStringValue()));
                             break;
                         }
@@ -1502,7 +1836,7 @@ namespace ardb
             m_read_fp(NULL), m_write_fp(NULL), m_cksm(0), m_routine_cb(
             NULL), m_routine_cbdata(
             NULL), m_processed_bytes(0), m_file_size(0), m_state(SNAPSHOT_INVALID), m_routinetime(0), m_read_buf(
-            NULL), m_expected_data_size(0), m_writed_data_size(0), m_cached_repl_offset(0), m_cached_repl_cksm(0), m_save_time(0), m_type((SnapshotType) 0)
+            NULL), m_expected_data_size(0), m_writed_data_size(0), m_cached_repl_offset(0), m_cached_repl_cksm(0), m_engine_snapshot(NULL), m_save_time(0), m_type((SnapshotType) 0)
     {
 
     }
@@ -1588,6 +1922,18 @@ namespace ardb
         return 0;
     }
 
+    int Snapshot::OpenWriteFD(int fd, const std::string& name)
+    {
+        this->m_file_path = name;
+        if ((m_write_fp = fdopen(fd, "w")) == NULL)
+        {
+            ERROR_LOG("Failed to open fd:%d for ardb dump:%s to write", fd, m_file_path.c_str());
+            return -1;
+        }
+        m_writed_data_size = 0;
+        return 0;
+    }
+
     int Snapshot::OpenReadFile(const std::string& file)
     {
         if (m_file_path != file)
@@ -1626,12 +1972,15 @@ namespace ardb
         int ret = 0;
         m_routine_cb = cb;
         m_routine_cbdata = data;
+        m_loaded_nss.clear();
+        ARDB_PROBE2(snapshot__state, LOAD_START, m_type);
         if (NULL != m_routine_cb)
         {
             m_routine_cb(LOAD_START, this, m_routine_cbdata);
         }
         uint64_t start_time = get_current_epoch_millis();
         bool is_redis_snapshot = IsRedisDumpFile(file);
+        bool is_engine_snapshot = !is_redis_snapshot && IsEngineDumpFile(file) == 1;
         ret = OpenReadFile(file);
         if (0 != ret)
         {
@@ -1642,6 +1991,11 @@ namespace ardb
             m_type = REDIS_DUMP;
             ret = RedisLoad();
         }
+        else if (is_engine_snapshot)
+        {
+            m_type = ENGINE_DUMP;
+            ret = EngineLoad();
+        }
         else
         {
             m_type = ARDB_DUMP;
@@ -1650,9 +2004,10 @@ namespace ardb
         if (ret == 0)
         {
             uint64_t cost = get_current_epoch_millis() - start_time;
-            INFO_LOG("Cost %.2fs to load snapshot file with type:%s.", cost / 1000.0, is_redis_snapshot ? "redis" : "ardb");
+            INFO_LOG("Cost %.2fs to load snapshot file with type:%s.", cost / 1000.0, snapshot_type_name(m_type));
         }
         m_state = ret == 0 ? LOAD_SUCCESS : LOAD_FAIL;
+        ARDB_PROBE2(snapshot__state, m_state, m_type);
         if (NULL != m_routine_cb)
         {
             m_routine_cb(m_state, this, m_routine_cbdata);
@@ -1703,6 +2058,7 @@ namespace ardb
             }
 
             m_writed_data_size += bytes_to_write;
+            BackgroundJobs::GetSingleton().Request(bytes_to_write);
             //check sum here
             m_cksm = crc64(m_cksm, (unsigned char *) data, bytes_to_write);
             data += bytes_to_write;
@@ -1758,41 +2114,115 @@ namespace ardb
 
     int Snapshot::PrepareSave(SnapshotType type, const std::string& file, SnapshotRoutine* cb, void *data)
     {
-        int ret = OpenWriteFile(file);
+        /*
+         * already opened by OpenWriteFD
+         */
+        int ret = NULL != m_write_fp ? 0 : OpenWriteFile(file);
         if (0 != ret)
         {
             return ret;
         }
         m_save_time = time(NULL);
         m_state = DUMPING;
+        ARDB_PROBE2(snapshot__state, m_state, type);
         this->m_routine_cb = cb;
         this->m_routine_cbdata = data;
         m_type = type;
+        /*
+         * commands executed before the snapshot should be in the wal before the cached offset, the writes are
+         * fenced while the offset is read & the engine snapshot taken, so that all dbs are dumped exactly at it.
+         */
+        bool fenced = false;
+        int64 fence_timeout = g_db->GetConf().snapshot_write_fence_timeout;
+        if (m_type != ENGINE_DUMP && fence_timeout > 0 && !g_db->IsReadReplica())
+        {
+            fenced = g_db->RaiseWriteFence(fence_timeout);
+            if (!fenced)
+            {
+                WARN_LOG("Writes in flight not drained in %lldms, snapshot taken without fencing writes.", (long long) fence_timeout);
+            }
+        }
+        g_repl->GetReplLog().WaitWALWritten();
         m_cached_repl_offset = g_repl->GetReplLog().WALEndOffset();
         m_cached_repl_cksm = g_repl->GetReplLog().WALCksm();
+        if (m_type != ENGINE_DUMP)
+        {
+            Context ctx;
+            m_engine_snapshot = g_db->GetEngine()->CreateSharedSnapshot(ctx);
+        }
+        if (fenced)
+        {
+            g_db->LowerWriteFence();
+        }
         return 0;
     }
 
+    /*
+     * Reads of current thread see the shared engine snapshot of the save if the engine supports it.
+     */
+    bool Snapshot::BeginEngineSnapshotRead(Context& ctx)
+    {
+        return NULL != m_engine_snapshot && 0 == g_db->GetEngine()->BeginSharedSnapshotRead(ctx, m_engine_snapshot);
+    }
+
+    void Snapshot::ReleaseEngineSnapshot()
+    {
+        if (NULL != m_engine_snapshot)
+        {
+            Context ctx;
+            g_db->GetEngine()->ReleaseSharedSnapshot(ctx, m_engine_snapshot);
+            m_engine_snapshot = NULL;
+        }
+    }
+
     int Snapshot::DoSave()
     {
         int ret = 0;
+        ARDB_PROBE2(snapshot__state, DUMP_START, m_type);
         if (NULL != m_routine_cb)
         {
             m_routine_cb(DUMP_START, this, m_routine_cbdata);
         }
+        BackgroundJobScope job(BGJOB_SNAPSHOT, true);
+        if (!job.started)
+        {
+            ERROR_LOG("Snapshot jobs are paused, skip saving snapshot file:%s", m_file_path.c_str());
+            ReleaseEngineSnapshot();
+            Close();
+            m_state = DUMP_FAIL;
+            ARDB_PROBE2(snapshot__state, m_state, m_type);
+            if (NULL != m_routine_cb)
+            {
+                m_routine_cb(m_state, this, m_routine_cbdata);
+            }
+            return -1;
+        }
         time_t start = time(NULL);
         g_lastsave_start = start;
         g_saver_num++;
+        LatencyMonitorScope latency("snapshot-save");
+        Context snapshot_ctx;
+        bool snapshot_read = BeginEngineSnapshotRead(snapshot_ctx);
         if (m_type == REDIS_DUMP)
         {
             ret = RedisSave();
         }
+        else if (m_type == ENGINE_DUMP)
+        {
+            ret = EngineSave();
+        }
         else
         {
             ret = ArdbSave();
         }
+        if (snapshot_read)
+        {
+            g_db->GetEngine()->EndSnapshotRead(snapshot_ctx);
+        }
+        ReleaseEngineSnapshot();
         Close();
         m_state = ret == 0 ? DUMP_SUCCESS : DUMP_FAIL;
+        ARDB_PROBE2(snapshot__state, m_state, m_type);
         if (NULL != m_routine_cb)
         {
             m_routine_cb(m_state, this, m_routine_cbdata);
@@ -1803,11 +2233,11 @@ namespace ardb
             g_lastsave = time(NULL);
             time_t end = g_lastsave;
             g_lastsave_cost = end - start;
-            INFO_LOG("Cost %us to save snapshot file with type:%s.", g_lastsave_cost, (m_type == REDIS_DUMP) ? "redis" : "ardb");
+            INFO_LOG("Cost %us to save snapshot file with type:%s.", g_lastsave_cost, snapshot_type_name(m_type));
         }
         else
         {
-            WARN_LOG("Failed to save snapshot file with type:%s", (m_type == REDIS_DUMP) ? "redis" : "ardb");
+            WARN_LOG("Failed to save snapshot file with type:%s", snapshot_type_name(m_type));
         }
         g_saver_num--;
         if (g_saver_num < 0)
@@ -1839,7 +2269,7 @@ namespace ardb
         {
             return ret;
         }
-        INFO_LOG("Start to save snapshot file:%s with type:%s.", file.c_str(), (m_type == REDIS_DUMP) ? "redis" : "ardb");
+        INFO_LOG("Start to save snapshot file:%s with type:%s.", file.c_str(), snapshot_type_name(m_type));
         return DoSave();
     }
     int Snapshot::BGSave(SnapshotType type, const std::string& file, SnapshotRoutine* cb, void *data)
@@ -1896,11 +2326,27 @@ namespace ardb
         return 1;
     }
 
+    int Snapshot::IsEngineDumpFile(const std::string& file)
+    {
+        FILE* fp = NULL;
+        if ((fp = fopen(file.c_str(), "r")) == NULL)
+        {
+            return -1;
+        }
+        char buf[8];
+        if (fread(buf, 8, 1, fp) != 1)
+        {
+            fclose(fp);
+            return -1;
+        }
+        fclose(fp);
+        return memcmp(buf, ENGINE_DUMP_MAGIC, 8) == 0 ? 1 : 0;
+    }
+
     int Snapshot::RedisLoad()
     {
-        DataArray nss;
         char buf[1024];
-        int rdbver, type;
+        int rdbver, type, err;
         int64 expiretime = -1;
         std::string key;
 
@@ -1920,7 +2366,7 @@ namespace ardb
             return -1;
         }
         rdbver = atoi(buf + 5);
-        if (rdbver < 1 || rdbver > REDIS_RDB_VERSION)
+        if (rdbver < 1 || rdbver > REDIS_RDB_LOAD_MAX_VERSION)
         {
             WARN_LOG("Can't handle RDB format version %d", rdbver);
             return -1;
@@ -1953,6 +2399,15 @@ namespace ardb
                 if ((type = ReadType()) == -1)
                     goto eoferr;
             }
+            /* LRU idle time & LFU frequency(RDB version 9) may follow the expire time, they are meaningless here. */
+            while (type == REDIS_RDB_OPCODE_IDLE || type == REDIS_RDB_OPCODE_FREQ)
+            {
+                unsigned char freq;
+                if (type == REDIS_RDB_OPCODE_IDLE ? ReadLen(NULL) == REDIS_RDB_LENERR : !Read(&freq, 1, true))
+                    goto eoferr;
+                if ((type = ReadType()) == -1)
+                    goto eoferr;
+            }
 
             if (type == REDIS_RDB_OPCODE_EOF)
                 break;
@@ -1966,8 +2421,8 @@ namespace ardb
                     ERROR_LOG("Failed to read current DBID.");
                     goto eoferr;
                 }
-                loadctx.ns.SetString(stringfromll(dbid), false);
-                nss.push_back(loadctx.ns);
+                loadctx.ns.SetString(m_load_ns_prefix + stringfromll(dbid), false);
+                m_loaded_nss.push_back(stringfromll(dbid));
                 continue;
             }
             else if (type == RDB_OPCODE_RESIZEDB)
@@ -1980,6 +2435,26 @@ namespace ardb
                 //donothing or readed data
                 continue;
             }
+            else if (type == REDIS_RDB_OPCODE_SLOT_INFO)
+            {
+                /* slot id, slot size & expires slot size of a cluster node's dump. */
+                if (ReadLen(NULL) == REDIS_RDB_LENERR || ReadLen(NULL) == REDIS_RDB_LENERR || ReadLen(NULL) == REDIS_RDB_LENERR)
+                    goto eoferr;
+                continue;
+            }
+            else if (type == REDIS_RDB_OPCODE_FUNCTION2)
+            {
+                std::string code;
+                if (!ReadString(code))
+                    goto eoferr;
+                WARN_LOG("Skip redis function library with %u bytes code, functions are not imported.", (uint32) code.size());
+                continue;
+            }
+            else if (type == REDIS_RDB_OPCODE_MODULE_AUX || type == REDIS_RDB_OPCODE_FUNCTION_PRE_GA)
+            {
+                ERROR_LOG("Can NOT load redis dump with module aux data or pre-GA functions(opcode:%d).", type);
+                goto eoferr;
+            }
             else if (type == RDB_OPCODE_AUX)
             {
                 std::string auxkey, auxval;
@@ -2037,8 +2512,23 @@ namespace ardb
             }
         }
         Close();
+        /*
+         * records may still be queued in the workers of the db writer, they must be written before the bulk load ends
+         */
+        err = GetDBWriter().Flush();
+        if (0 != err)
+        {
+            g_engine->EndBulkLoad(loadctx);
+            ERROR_LOG("Failed to write redis snapshot data with err:%d", err);
+            return -1;
+        }
         g_engine->FlushAll(loadctx);
-        g_engine->EndBulkLoad(loadctx);
+        err = g_engine->EndBulkLoad(loadctx);
+        if (0 != err && ERR_NOTSUPPORTED != err)
+        {
+            ERROR_LOG("Failed to end bulk load of redis snapshot file with err:%d", err);
+            return -1;
+        }
         INFO_LOG("All data load successfully from redis snapshot file.");
         if(g_db->GetConf().compact_after_snapshot_load)
         {
@@ -2047,6 +2537,7 @@ namespace ardb
         INFO_LOG("Redis snapshot file load finished.");
         return 0;
         eoferr: Close();
+        GetDBWriter().Flush();
         g_engine->EndBulkLoad(loadctx);
         WARN_LOG("Short read or OOM loading DB. Unrecoverable error, aborting now.");
         return -1;
@@ -2064,9 +2555,12 @@ namespace ardb
         for (size_t i = 0; i < nss.size(); i++)
         {
             /*
-             * do not iterate ttl db
+             * do not iterate ttl db & staged zset results
              */
-            if (nss[i].AsString() == TTL_DB_NSMAESPACE)
+            if (nss[i].AsString() == TTL_DB_NSMAESPACE || nss[i].AsString() == ZSET_STORE_NAMESPACE
+                    || nss[i].AsString() == LAZYFREE_DB_NAMESPACE
+                    || nss[i].AsString() == INDEX_DB_NAMESPACE || has_prefix(nss[i].AsString(), SHADOW_NAMESPACE_PREFIX)
+                    || !m_filter.MatchNameSpace(nss[i].AsString()))
             {
                 continue;
             }
@@ -2117,6 +2611,7 @@ namespace ardb
                         {
                             case KEY_STRING:
                             {
+                                g_db->LoadBitmapChunks(dumpctx, k, v);
                                 DUMP_CHECK_WRITE(WriteStringObject(v.GetStringValue()));
                                 break;
                             }
@@ -2129,6 +2624,19 @@ namespace ardb
                                 objectlen = dumpctx.GetReply().GetInteger();
                                 object_totallen = objectlen;
                                 DUMP_CHECK_WRITE(WriteLen(objectlen));
+                                if (current_keytype == KEY_HASH && v.IsPacked())
+                                {
+                                    for (size_t i = 0; i < v.PackedCount(); i++)
+                                    {
+                                        DUMP_CHECK_WRITE(WriteStringObject(v.PackedField(i)));
+                                        DUMP_CHECK_WRITE(WriteStringObject(v.PackedValue(i)));
+                                    }
+                                    objectlen = 0;
+                                }
+                                else if (current_keytype == KEY_HASH && v.GetObjectId() > 0)
+                                {
+                                    DUMP_CHECK_WRITE(WriteObjectIdHashFields(dumpctx, k.GetNameSpace(), v.GetObjectId(), objectlen));
+                                }
                                 //DUMP_CHECK_WRITE(WriteStringObject(v.GetStringValue()));
                                 break;
                             }
@@ -2168,7 +2676,7 @@ namespace ardb
                     }
                     case KEY_HASH_FIELD:
                     {
-                        if (current_key != k.GetKey() || current_keytype != KEY_HASH || objectlen <= 0)
+                        if (k.GetObjectId() > 0 || current_key != k.GetKey() || current_keytype != KEY_HASH || objectlen <= 0)
                         {
                             break;
                         }
@@ -2256,6 +2764,110 @@ namespace ardb
 //        return 0;
 //    }
 
+    static int dump_key_first_byte(const Data& key)
+    {
+        if (key.IsString())
+        {
+            return key.StringLength() > 0 ? (unsigned char) key.CStr()[0] : -1;
+        }
+        std::string str = key.AsString();
+        return str.empty() ? -1 : (unsigned char) str[0];
+    }
+
+    /*
+     * Ranges of the keys of a namespace dumped in parallel, first bytes or slots with KEY_CODEC_V3 which orders
+     * keys by slot first.
+     */
+    static int dump_range_units()
+    {
+        return get_key_codec_version() == KEY_CODEC_V3 ? (int) kClusterSlots : 256;
+    }
+
+    /*
+     * Dump the keys of 'ns' whose first byte(or slot) is in [lo, hi), every object's elements follow its meta key
+     * so they fall in the same range, elements keyed by object id have no key & fall in the first range.
+     */
+    int Snapshot::ArdbSaveRange(const Data& ns, int lo, int hi, ThreadMutexLock* write_lock)
+    {
+        Context dumpctx;
+        dumpctx.flags.iterate_multi_keys = 1;
+        dumpctx.flags.iterate_total_order = 1;
+        dumpctx.ns = ns;
+        bool by_slot = get_key_codec_version() == KEY_CODEC_V3;
+        int units = dump_range_units();
+        KeyObject start;
+        start.SetNameSpace(ns);
+        if (by_slot)
+        {
+            start = KeyObject(ns, KEY_META, "");
+            start.SetSlot(lo);
+        }
+        else if (lo > 0)
+        {
+            start = KeyObject(ns, KEY_META, std::string(1, (char) lo));
+        }
+        Buffer buffer;
+        int ret = 0;
+        Iterator* iter = g_db->GetEngine()->Find(dumpctx, start);
+        while (iter->Valid())
+        {
+            int64 ttl = 0;
+            KeyObject& k = iter->Key();
+            if (hi < units && (by_slot ? k.GetSlot() >= hi : dump_key_first_byte(k.GetKey()) >= hi))
+            {
+                break;
+            }
+            if (!m_filter.prefixes.empty() && k.GetKey().IsString() && !m_filter.MatchKey(k.GetKey().AsString()))
+            {
+                iter->Next();
+                continue;
+            }
+            if (k.GetType() == KEY_META)
+            {
+                ttl = iter->Value().GetTTL();
+            }
+            ret = ArdbSaveRawKeyValue(iter->RawKey(), iter->RawValue(), buffer, ttl);
+            if (0 == ret && buffer.ReadableBytes() >= 1024 * 1024)
+            {
+                ret = ArdbFlushWriteBuffer(buffer, write_lock);
+            }
+            if (0 != ret)
+            {
+                break;
+            }
+            iter->Next();
+        }
+        DELETE(iter);
+        if (0 == ret)
+        {
+            ret = ArdbFlushWriteBuffer(buffer, write_lock);
+        }
+        return ret;
+    }
+
+    struct Snapshot::ArdbDumpTask: public Runnable
+    {
+            Snapshot* snapshot;
+            Data ns;
+            int lo, hi;
+            ThreadMutexLock* write_lock;
+            int err;
+            ArdbDumpTask() :
+                    snapshot(NULL), lo(0), hi(256), write_lock(NULL), err(0)
+            {
+            }
+            void Run()
+            {
+                Context ctx;
+                bool snapshot_read = snapshot->BeginEngineSnapshotRead(ctx);
+                err = snapshot->ArdbSaveRange(ns, lo, hi, write_lock);
+                if (snapshot_read)
+                {
+                    g_db->GetEngine()->EndSnapshotRead(ctx);
+                }
+            }
+    };
+
     int Snapshot::ArdbSave()
     {
         RETURN_NEGATIVE_EXPR(ArdbWriteMagicHeader());
@@ -2280,47 +2892,66 @@ namespace ardb
         RETURN_NEGATIVE_EXPR(WriteType(ARDB_OPCODE_AUX));
         RETURN_NEGATIVE_EXPR(WriteRawString("create_time"));
         RETURN_NEGATIVE_EXPR(WriteRawString(stringfromll(time(NULL))));
+        RETURN_NEGATIVE_EXPR(ArdbWriteKeyCodec());
 
+        /*
+         * each namespace is split into ranges of key first byte(or slot) dumped by 'snapshot-threads' threads,
+         * their chunks are independent so they can be interleaved in the file.
+         */
+        int64 threads = g_db->GetConf().snapshot_threads;
+        threads = threads < 1 ? 1 : (threads > 256 ? 256 : threads);
+        ThreadMutexLock write_lock;
         DataArray nss;
         g_db->GetEngine()->ListNameSpaces(dumpctx, nss);
         for (size_t i = 0; i < nss.size(); i++)
         {
             /*
-             * do not iterate ttl db
+             * do not iterate ttl db & staged zset results
              */
-            if (nss[i].AsString() == TTL_DB_NSMAESPACE)
+            if (nss[i].AsString() == TTL_DB_NSMAESPACE || nss[i].AsString() == ZSET_STORE_NAMESPACE
+                    || nss[i].AsString() == LAZYFREE_DB_NAMESPACE
+                    || nss[i].AsString() == INDEX_DB_NAMESPACE || has_prefix(nss[i].AsString(), SHADOW_NAMESPACE_PREFIX)
+                    || !m_filter.MatchNameSpace(nss[i].AsString()))
             {
                 continue;
             }
-            dumpctx.ns = nss[i];
             RETURN_NEGATIVE_EXPR(WriteType(ARDB_RDB_OPCODE_SELECTDB));
             RETURN_NEGATIVE_EXPR(WriteStringObject(nss[i]));
-
-            KeyObject empty;
-            empty.SetNameSpace(nss[i]);
-            Iterator* iter = g_db->GetEngine()->Find(dumpctx, empty);
-            while (iter->Valid())
+            int err = 0;
+            int units = dump_range_units();
+            if (threads == 1)
             {
-                int64 ttl = 0;
-                if (iter->Key().GetType() == KEY_META)
-                {
-                    ttl = iter->Value().GetTTL();
-                }
-                int ret = ArdbSaveRawKeyValue(iter->RawKey(), iter->RawValue(), m_write_buffer, ttl);
-                if (0 != ret)
+                err = ArdbSaveRange(nss[i], 0, units, NULL);
+            }
+            else
+            {
+                std::vector<ArdbDumpTask> tasks(threads);
+                std::vector<Thread*> workers(threads, (Thread*) NULL);
+                for (int64 j = 0; j < threads; j++)
                 {
-                    DELETE(iter);
-                    Close();
-                    return ret;
+                    tasks[j].snapshot = this;
+                    tasks[j].ns = nss[i];
+                    tasks[j].lo = j * units / threads;
+                    tasks[j].hi = (j + 1) * units / threads;
+                    tasks[j].write_lock = &write_lock;
+                    NEW(workers[j], Thread(&tasks[j]));
+                    workers[j]->Start();
                 }
-                if (m_write_buffer.ReadableBytes() >= 1024 * 1024)
+                for (int64 j = 0; j < threads; j++)
                 {
-                    ArdbFlushWriteBuffer(m_write_buffer);
+                    workers[j]->Join();
+                    DELETE(workers[j]);
+                    if (0 == err)
+                    {
+                        err = tasks[j].err;
+                    }
                 }
-                iter->Next();
             }
-            ArdbFlushWriteBuffer(m_write_buffer);
-            DELETE(iter);
+            if (0 != err)
+            {
+                Close();
+                return err;
+            }
         }
         WriteType(REDIS_RDB_OPCODE_EOF);
         uint64 cksm = m_cksm;
@@ -2329,12 +2960,141 @@ namespace ardb
         return 0;
     }
 
+    /*
+     * Chunks read by the loading thread are decompressed & written by 'snapshot-threads' workers.
+     */
+    struct Snapshot::ArdbLoadWorkers: public Runnable
+    {
+            struct Chunk
+            {
+                    Data ns;
+                    int type;
+                    std::string data;
+            };
+            Snapshot* snapshot;
+            ThreadMutexLock lock;
+            std::deque<Chunk*> chunks;
+            std::vector<Thread*> threads;
+            bool stopped;
+            int err;
+            ArdbLoadWorkers(Snapshot* s) :
+                    snapshot(s), stopped(false), err(0)
+            {
+            }
+            void Start(int64 count)
+            {
+                for (int64 i = 0; i < count; i++)
+                {
+                    Thread* thread = NULL;
+                    NEW(thread, Thread(this));
+                    thread->Start();
+                    threads.push_back(thread);
+                }
+            }
+            bool Enabled() const
+            {
+                return !threads.empty();
+            }
+            int Offer(const Data& ns, int type, std::string& data)
+            {
+                Chunk* chunk = NULL;
+                NEW(chunk, Chunk);
+                chunk->ns = ns;
+                chunk->type = type;
+                chunk->data.swap(data);
+                LockGuard<ThreadMutexLock> guard(lock);
+                while (chunks.size() >= threads.size() * 2 && 0 == err)
+                {
+                    lock.Wait();
+                }
+                chunks.push_back(chunk);
+                lock.NotifyAll();
+                return err;
+            }
+            void Run()
+            {
+                Context loadctx;
+                loadctx.flags.no_fill_reply = 1;
+                loadctx.flags.no_wal = 1;
+                loadctx.flags.create_if_notexist = 1;
+                loadctx.flags.bulk_loading = 1;
+                while (true)
+                {
+                    Chunk* chunk = NULL;
+                    {
+                        LockGuard<ThreadMutexLock> guard(lock);
+                        while (chunks.empty() && !stopped)
+                        {
+                            lock.Wait();
+                        }
+                        if (chunks.empty())
+                        {
+                            break;
+                        }
+                        chunk = chunks.front();
+                        chunks.pop_front();
+                        lock.NotifyAll();
+                    }
+                    loadctx.ns = chunk->ns;
+                    int ret = snapshot->ArdbLoadChunkData(loadctx, chunk->type, chunk->data);
+                    DELETE(chunk);
+                    if (0 != ret)
+                    {
+                        LockGuard<ThreadMutexLock> guard(lock);
+                        err = ret;
+                        lock.NotifyAll();
+                    }
+                }
+            }
+            int Join()
+            {
+                {
+                    LockGuard<ThreadMutexLock> guard(lock);
+                    stopped = true;
+                    lock.NotifyAll();
+                }
+                for (size_t i = 0; i < threads.size(); i++)
+                {
+                    threads[i]->Join();
+                    DELETE(threads[i]);
+                }
+                threads.clear();
+                return err;
+            }
+            ~ArdbLoadWorkers()
+            {
+                Join();
+                for (size_t i = 0; i < chunks.size(); i++)
+                {
+                    DELETE(chunks[i]);
+                }
+            }
+    };
+
+    int Snapshot::ArdbLoadChunkData(Context& ctx, int type, std::string& data)
+    {
+        if (type == ARDB_RDB_TYPE_SNAPPY_CHUNK)
+        {
+            std::string origin;
+            if (!snappy::Uncompress(data.data(), data.size(), &origin))
+            {
+                ERROR_LOG("Failed to decompress snappy chunk.");
+                return -1;
+            }
+            data.swap(origin);
+        }
+        Buffer readbuf(const_cast<char*>(data.data()), 0, data.size());
+        RETURN_NEGATIVE_EXPR(ArdbLoadBuffer(ctx, readbuf));
+        return 0;
+    }
+
     int Snapshot::ArdbLoad()
     {
-        DataArray nss;
         char buf[1024];
-        int rdbver, type;
-        std::string verstr;
+        int rdbver, type, err;
+        std::string verstr, chunk;
+        int64 threads = g_db->GetConf().snapshot_threads;
+        ArdbLoadWorkers workers(this);
         Context loadctx;
         loadctx.flags.no_fill_reply = 1;
         loadctx.flags.no_wal = 1;
@@ -2356,7 +3116,12 @@ namespace ardb
             WARN_LOG("Can't handle ARDB format version %d", rdbver);
             return -1;
         }
+        m_key_codec = KEY_CODEC_V1;
         g_engine->BeginBulkLoad(loadctx);
+        if (threads > 1)
+        {
+            workers.Start(threads > 256 ? 256 : threads);
+        }
         while (true)
         {
             /* Read type. */
@@ -2375,8 +3140,8 @@ namespace ardb
                     ERROR_LOG("Failed to read selected namespace.");
                     goto eoferr;
                 }
-                loadctx.ns.SetString(ns, false);
-                nss.push_back(loadctx.ns);
+                loadctx.ns.SetString(m_load_ns_prefix + ns, false);
+                m_loaded_nss.push_back(ns);
             }
             else if (type == ARDB_OPCODE_AUX)
             {
@@ -2387,10 +3152,35 @@ namespace ardb
                     goto eoferr;
                 }
                 INFO_LOG("Snapshot aux info: %s=%s", aux_key.c_str(), aux_val.c_str());
+                if (!ArdbLoadAux(aux_key, aux_val))
+                {
+                    goto eoferr;
+                }
             }
             else if (type == ARDB_RDB_TYPE_CHUNK || type == ARDB_RDB_TYPE_SNAPPY_CHUNK)
             {
-                if (0 != ArdbLoadChunk(loadctx, type))
+                if (workers.Enabled())
+                {
+                    /*
+                     * a snappy chunk is prefixed by its raw & compressed length, only the latter is needed
+                     */
+                    uint32 len = ReadLen(NULL);
+                    if (type == ARDB_RDB_TYPE_SNAPPY_CHUNK && len != REDIS_RDB_LENERR)
+                    {
+                        len = ReadLen(NULL);
+                    }
+                    if (len == REDIS_RDB_LENERR)
+                    {
+                        goto eoferr;
+                    }
+                    chunk.resize(len);
+                    if (!Read(&chunk[0], len, true) || 0 != workers.Offer(loadctx.ns, type, chunk))
+                    {
+                        ERROR_LOG("Failed to load chunk type:%d.", type);
+                        goto eoferr;
+                    }
+                }
+                else if (0 != ArdbLoadChunk(loadctx, type))
                 {
                     ERROR_LOG("Failed to load chunk type:%d.", type);
                     goto eoferr;
@@ -2403,6 +3193,11 @@ namespace ardb
             }
         }
 
+        if (0 != workers.Join())
+        {
+            ERROR_LOG("Failed to load chunks.");
+            goto eoferr;
+        }
         if (true)
         {
             /* Verify the checksum if RDB version is >= 5 */
@@ -2424,7 +3219,12 @@ namespace ardb
 
         Close();
         g_engine->FlushAll(loadctx);
-        g_engine->EndBulkLoad(loadctx);
+        err = g_engine->EndBulkLoad(loadctx);
+        if (0 != err && ERR_NOTSUPPORTED != err)
+        {
+            ERROR_LOG("Failed to end bulk load of ardb snapshot file with err:%d", err);
+            return -1;
+        }
         INFO_LOG("All data load successfully from ardb snapshot file.");
         if(g_db->GetConf().compact_after_snapshot_load)
         {
@@ -2433,11 +3233,174 @@ namespace ardb
         INFO_LOG("Ardb dump file load finished.");
         return 0;
         eoferr: Close();
+        workers.Join();
         g_engine->EndBulkLoad(loadctx);
         WARN_LOG("Short read or OOM loading DB. Unrecoverable error, aborting now.");
         return -1;
     }
 
+    static void remove_checkpoint_dir(const std::string& dir)
+    {
+        std::deque<std::string> files;
+        list_subfiles(dir, files);
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            unlink((dir + "/" + files[i]).c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
+    /*
+     * Engine dump: magic, engine name, then every checkpoint file as its name, 64bit size & raw content.
+     * The files are streamed as they are, no key is decoded or re-encoded on either side.
+     */
+    int Snapshot::EngineSaveFiles(const std::string& dir)
+    {
+        RETURN_NEGATIVE_EXPR(Write(ENGINE_DUMP_MAGIC, 8));
+        RETURN_NEGATIVE_EXPR(WriteRawString(g_engine_name));
+        std::deque<std::string> files;
+        list_subfiles(dir, files);
+        std::string buf;
+        buf.resize(1024 * 1024);
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            std::string path = dir + "/" + files[i];
+            uint64 size = file_size(path);
+            FILE* fp = fopen(path.c_str(), "r");
+            if (NULL == fp)
+            {
+                ERROR_LOG("Failed to open checkpoint file:%s", path.c_str());
+                return -1;
+            }
+            uint64 encoded_size = size;
+            memrev64ifbe(&encoded_size);
+            int ret = 0;
+            if (WriteType(ENGINE_DUMP_OPCODE_FILE) != 0 || WriteRawString(files[i]) < 0 || Write(&encoded_size, sizeof(encoded_size)) != 0)
+            {
+                ret = -1;
+            }
+            while (0 == ret && size > 0)
+            {
+                size_t len = size < buf.size() ? size : buf.size();
+                if (fread(&buf[0], len, 1, fp) != 1)
+                {
+                    ERROR_LOG("Failed to read checkpoint file:%s", path.c_str());
+                    ret = -1;
+                    break;
+                }
+                ret = Write(&buf[0], len);
+                size -= len;
+            }
+            fclose(fp);
+            if (0 != ret)
+            {
+                return -1;
+            }
+        }
+        RETURN_NEGATIVE_EXPR(WriteType(ARDB_RDB_TYPE_EOF));
+        uint64 cksm = m_cksm;
+        memrev64ifbe(&cksm);
+        return Write(&cksm, sizeof(cksm));
+    }
+
+    int Snapshot::EngineSave()
+    {
+        char dir[1024];
+        snprintf(dir, sizeof(dir) - 1, "%s/%s-checkpoint.%u.%u", g_db->GetConf().data_base_path.c_str(), g_engine_name, getpid(), (uint32) time(NULL));
+        Context ctx;
+        int ret = g_engine->Checkpoint(ctx, dir);
+        if (0 == ret)
+        {
+            ret = EngineSaveFiles(dir);
+        }
+        else
+        {
+            ERROR_LOG("Failed to create engine checkpoint:%s", dir);
+        }
+        remove_checkpoint_dir(dir);
+        return ret;
+    }
+
+    int Snapshot::EngineLoad()
+    {
+        char buf[8];
+        char dir[1024];
+        std::string engine, name, content;
+        uint64 size = 0;
+        uint64_t cksum = 0, expected = 0;
+        FILE* fp = NULL;
+        int type, ret;
+        snprintf(dir, sizeof(dir) - 1, "%s/%s-restore.%u.%u", g_db->GetConf().data_base_path.c_str(), g_engine_name, getpid(), (uint32) time(NULL));
+        if (!Read(buf, 8, true) || memcmp(buf, ENGINE_DUMP_MAGIC, 8) != 0 || !ReadString(engine))
+        {
+            goto eoferr;
+        }
+        if (engine != g_engine_name)
+        {
+            Close();
+            WARN_LOG("Can't load engine dump of %s into %s", engine.c_str(), g_engine_name);
+            return -1;
+        }
+        remove_checkpoint_dir(dir);
+        make_dir(dir);
+        content.resize(1024 * 1024);
+        while (true)
+        {
+            if ((type = ReadType()) == -1)
+                goto eoferr;
+            if (type == ARDB_RDB_TYPE_EOF)
+                break;
+            if (type != ENGINE_DUMP_OPCODE_FILE || !ReadString(name) || name.find('/') != std::string::npos || !Read(&size, sizeof(size), true))
+            {
+                ERROR_LOG("Invalid engine dump file entry with type:%d.", type);
+                goto eoferr;
+            }
+            memrev64ifbe(&size);
+            if ((fp = fopen((std::string(dir) + "/" + name).c_str(), "w")) == NULL)
+            {
+                ERROR_LOG("Failed to create engine file:%s/%s", dir, name.c_str());
+                goto eoferr;
+            }
+            while (size > 0)
+            {
+                size_t len = size < content.size() ? size : content.size();
+                if (!Read(&content[0], len, true) || fwrite(&content[0], len, 1, fp) != 1)
+                {
+                    fclose(fp);
+                    goto eoferr;
+                }
+                size -= len;
+            }
+            fflush(fp);
+            fsync(fileno(fp));
+            fclose(fp);
+        }
+        expected = m_cksm;
+        if (!Read(&cksum, 8, true))
+        {
+            goto eoferr;
+        }
+        memrev64ifbe(&cksum);
+        if (cksum != expected)
+        {
+            ERROR_LOG("Wrong engine dump checksum.(%llu-%llu)", cksum, expected);
+            goto eoferr;
+        }
+        Close();
+        ret = g_db->RestoreEngine(dir);
+        if (0 != ret)
+        {
+            remove_checkpoint_dir(dir);
+            return ret;
+        }
+        INFO_LOG("Engine restored from engine dump file.");
+        return 0;
+        eoferr: Close();
+        remove_checkpoint_dir(dir);
+        WARN_LOG("Short read or corrupted engine dump file:%s.", m_file_path.c_str());
+        return -1;
+    }
+
     static SnapshotManager g_snapshot_manager_instance;
     SnapshotManager* g_snapshot_manager = &g_snapshot_manager_instance;
 
@@ -2477,7 +3440,7 @@ namespace ardb
         Snapshot* snapshot = NULL;
         NEW(snapshot, Snapshot);
         char path[1024];
-        snprintf(path, sizeof(path) - 1, "%s/%s-snapshot.%u", g_db->GetConf().backup_dir.c_str(), type == REDIS_DUMP ? "redis" : "ardb", now);
+        snprintf(path, sizeof(path) - 1, "%s/%s-snapshot.%u", g_db->GetConf().backup_dir.c_str(), snapshot_type_name(type), now);
         if (bgsave)
         {
             if (0 == snapshot->BGSave(type, path, cb, data))
@@ -2500,16 +3463,80 @@ namespace ardb
         return NULL;
     }
 
-    Snapshot* SnapshotManager::GetSyncSnapshot(SnapshotType type, SnapshotRoutine* cb, void *data)
+    void ReplFilter::AddNameSpaces(const std::string& nss)
+    {
+        std::vector<std::string> ss = split_string(nss, ",");
+        for (size_t i = 0; i < ss.size(); i++)
+        {
+            std::string ns = trim_string(ss[i]);
+            if (!ns.empty())
+            {
+                namespaces.insert(ns);
+            }
+        }
+    }
+
+    void ReplFilter::AddKeyPrefixes(const std::string& keys)
+    {
+        std::vector<std::string> ss = split_string(keys, ",");
+        for (size_t i = 0; i < ss.size(); i++)
+        {
+            std::string prefix = trim_string(ss[i]);
+            if (!prefix.empty())
+            {
+                prefixes.push_back(prefix);
+            }
+        }
+    }
+
+    bool ReplFilter::MatchKey(const std::string& key) const
+    {
+        if (prefixes.empty())
+        {
+            return true;
+        }
+        for (size_t i = 0; i < prefixes.size(); i++)
+        {
+            if (key.size() >= prefixes[i].size() && !memcmp(key.data(), prefixes[i].data(), prefixes[i].size()))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string ReplFilter::ToString() const
     {
+        std::string str;
+        StringTreeSet::const_iterator it = namespaces.begin();
+        while (it != namespaces.end())
+        {
+            str.append(str.empty() ? "" : ",").append(*it);
+            it++;
+        }
+        str.append("|");
+        for (size_t i = 0; i < prefixes.size(); i++)
+        {
+            str.append(i == 0 ? "" : ",").append(prefixes[i]);
+        }
+        return str;
+    }
+
+    /*
+     * A cached snapshot is only shared by slaves of the same filter, a filtered dump misses data the others need.
+     */
+    Snapshot* SnapshotManager::GetSyncSnapshot(SnapshotType type, SnapshotRoutine* cb, void *data, const ReplFilter* filter)
+    {
+        static uint32 filtered_seq = 0;
         time_t now = time(NULL);
+        std::string filter_str = NULL != filter ? filter->ToString() : ReplFilter().ToString();
         LockGuard<ThreadMutexLock> guard(m_snapshots_lock);
         SnapshotArray::reverse_iterator it = m_snapshots.rbegin();
         while (it != m_snapshots.rend())
         {
             Snapshot* s = *it;
             int64 offset_lag = g_repl->GetReplLog().WALEndOffset() - s->CachedReplOffset();
-            if (s->GetType() == type && offset_lag < g_db->GetConf().snapshot_max_lag_offset)
+            if (s->GetType() == type && offset_lag < g_db->GetConf().snapshot_max_lag_offset && s->GetFilter().ToString() == filter_str)
             {
                 if (s->IsSaving() || s->IsReady())
                 {
@@ -2522,6 +3549,11 @@ namespace ardb
         NEW(snapshot, Snapshot);
         char path[1024];
         snprintf(path, sizeof(path) - 1, "%s/master-snapshot.%u", g_db->GetConf().backup_dir.c_str(), now);
+        if (NULL != filter && !filter->Empty())
+        {
+            snprintf(path, sizeof(path) - 1, "%s/master-snapshot.%u.filtered%u", g_db->GetConf().backup_dir.c_str(), now, filtered_seq++);
+            snapshot->SetFilter(*filter);
+        }
         if (0 == snapshot->BGSave(type, path, cb, data))
         {
             m_snapshots.push_back(snapshot);
@@ -42,20 +42,46 @@ namespace ardb
 {
     enum SnapshotType
     {
-        REDIS_DUMP = 1, ARDB_DUMP
+        REDIS_DUMP = 1, ARDB_DUMP, ENGINE_DUMP //ENGINE_DUMP packs the files of an engine checkpoint as they are
     };
 
     enum SnapshotState
     {
         SNAPSHOT_INVALID = 0, DUMP_START = 1, DUMPING, DUMP_SUCCESS, DUMP_FAIL, LOAD_START = 10, LODING, LOAD_SUCCESS, LOAD_FAIL
     };
+    /*
+     * Namespaces & key prefixes a filtered slave replicates, registered by 'replconf filter-ns/filter-prefix' as comma
+     * separated lists. An empty list matches everything.
+     */
+    struct ReplFilter
+    {
+            StringTreeSet namespaces;
+            StringArray prefixes;
+            void AddNameSpaces(const std::string& nss);
+            void AddKeyPrefixes(const std::string& keys);
+            bool Empty() const
+            {
+                return namespaces.empty() && prefixes.empty();
+            }
+            bool MatchNameSpace(const std::string& ns) const
+            {
+                return namespaces.empty() || namespaces.count(ns) > 0;
+            }
+            bool MatchKey(const std::string& key) const;
+            std::string ToString() const;
+    };
+
     class Snapshot;
     typedef int SnapshotRoutine(SnapshotState state, Snapshot* snapshot, void* cb);
 
+    class PackedBlobReader;
     class ObjectIO
     {
         protected:
             DBWriter* m_dbwriter;
+            std::string m_lzf_buffer; //compressed bytes of the last lzf string read, reused across strings
+            uint8 m_key_codec; //key codec version of the raw keys loaded, they are converted if it is not ours
+            const std::string* m_load_key; //raw keys loaded have to belong to this key if not NULL
             virtual bool Read(void* buf, size_t buflen, bool cksm = true) = 0;
             virtual int Write(const void* buf, size_t buflen) = 0;
             int WriteType(uint8 type);
@@ -69,6 +95,7 @@ namespace ardb
             int WriteLzfStringObject(const char *s, size_t len);
             int WriteTime(time_t t);
             int WriteStringObject(const Data& o);
+            int WriteObjectIdHashFields(Context& ctx, const Data& ns, uint64 object_id, int64& objectlen);
 
             int ReadType();
             time_t ReadTime();
@@ -80,28 +107,35 @@ namespace ardb
             int ReadDoubleValue(double&val);
 
             bool RedisLoadObject(Context& ctx, int type, const std::string& key, int64 expiretime);
-            void RedisLoadListZipList(Context& ctx, unsigned char* data, const std::string& key, ValueObject& meta_value);
-            void RedisLoadHashZipList(Context& ctx, unsigned char* data, const std::string& key, ValueObject& meta_value);
-            void RedisLoadZSetZipList(Context& ctx, unsigned char* data, const std::string& key, ValueObject& meta_value);
+            bool RedisLoadPackedList(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& listmeta, int64& idx);
+            bool RedisLoadPackedHash(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& meta_value);
+            bool RedisLoadPackedZSet(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& meta_value);
+            bool RedisLoadPackedSet(Context& ctx, PackedBlobReader& reader, const std::string& key, ValueObject& meta_value);
             void RedisLoadSetIntSet(Context& ctx, unsigned char* data, const std::string& key, ValueObject& meta_value);
             void RedisWriteMagicHeader();
 
             int ArdbWriteMagicHeader();
             int ArdbLoadChunk(Context& ctx, int type);
             int ArdbLoadBuffer(Context& ctx, Buffer& buffer);
+            bool ArdbLoadAux(const std::string& aux_key, const std::string& aux_val);
 
             DBWriter& GetDBWriter();
         public:
             ObjectIO() :
-                    m_dbwriter(NULL)
+                    m_dbwriter(NULL), m_key_codec(KEY_CODEC_V1), m_load_key(NULL)
             {
             }
             void SetDBWriter(DBWriter* writer)
             {
                 m_dbwriter = writer;
             }
+            int ArdbWriteKeyCodec();
             int ArdbSaveRawKeyValue(const Slice& key, const Slice& value, Buffer& buffer, int64 ttl);
-            int ArdbFlushWriteBuffer(Buffer& buffer);
+            int ArdbFlushWriteBuffer(Buffer& buffer, ThreadMutexLock* write_lock = NULL);
+            void RestrictLoadKey(const std::string* key)
+            {
+                m_load_key = key;
+            }
             virtual ~ObjectIO()
             {
             }
@@ -153,8 +187,12 @@ namespace ardb
             Buffer m_write_buffer;
             uint64 m_cached_repl_offset;
             uint64 m_cached_repl_cksm;
+            const void* m_engine_snapshot; //shared engine snapshot paired with the cached repl offset
             time_t m_save_time;
             SnapshotType m_type;
+            ReplFilter m_filter;
+            std::string m_load_ns_prefix;
+            StringArray m_loaded_nss;
             bool Read(void* buf, size_t buflen, bool cksm);
 
 //            int WriteType(uint8 type);
@@ -192,9 +230,18 @@ namespace ardb
 //            int ArdbFlushWriteBuffer();
 //            int ArdbLoadBuffer(Context& ctx, Buffer& buffer);
             int ArdbSave();
+            int ArdbSaveRange(const Data& ns, int lo, int hi, ThreadMutexLock* write_lock);
             int ArdbLoad();
+            int ArdbLoadChunkData(Context& ctx, int type, std::string& data);
+            struct ArdbDumpTask;
+            struct ArdbLoadWorkers;
+            int EngineSave();
+            int EngineSaveFiles(const std::string& dir);
+            int EngineLoad();
 
             int DoSave();
+            bool BeginEngineSnapshotRead(Context& ctx);
+            void ReleaseEngineSnapshot();
             int PrepareSave(SnapshotType type, const std::string& file, SnapshotRoutine* cb, void *data);
         public:
             Snapshot();
@@ -214,10 +261,41 @@ namespace ardb
             {
                 return m_file_path;
             }
+            /*
+             * Only dump namespaces & keys matched by the filter, set before saving an ARDB_DUMP for a filtered slave.
+             */
+            void SetFilter(const ReplFilter& filter)
+            {
+                m_filter = filter;
+            }
+            const ReplFilter& GetFilter() const
+            {
+                return m_filter;
+            }
+            /*
+             * Namespaces selected by an ARDB/REDIS dump are loaded under this prefix, a slave loads a full resync aside
+             * its live data by it. The namespaces named by the dump are listed by LoadedNameSpaces either way.
+             */
+            void SetLoadNameSpacePrefix(const std::string& prefix)
+            {
+                m_load_ns_prefix = prefix;
+            }
+            const StringArray& LoadedNameSpaces() const
+            {
+                return m_loaded_nss;
+            }
             time_t SaveTime()
             {
                 return m_save_time;
             }
+            uint64 ProcessedBytes() const
+            {
+                return m_processed_bytes;
+            }
+            uint64 FileSize() const
+            {
+                return m_file_size;
+            }
             bool IsSaving() const;
             bool IsReady() const;
             void SetExpectedDataSize(int64 size);
@@ -225,6 +303,10 @@ namespace ardb
             int64 ProcessLeftDataSize();
             int Write(const void* buf, size_t buflen);
             int OpenWriteFile(const std::string& file);
+            /*
+             * Save into an opened fd(a pipe to stream the dump) instead of a file, the fd is closed with the snapshot.
+             */
+            int OpenWriteFD(int fd, const std::string& name);
             int OpenReadFile(const std::string& file);
             int Load(const std::string& file, SnapshotRoutine* cb, void *data);
             int Reload(SnapshotRoutine* cb, void *data);
@@ -239,6 +321,7 @@ namespace ardb
             ~Snapshot();
 
             static int IsRedisDumpFile(const std::string& file);
+            static int IsEngineDumpFile(const std::string& file);
     };
 
     class SnapshotManager
@@ -250,7 +333,7 @@ namespace ardb
         public:
             SnapshotManager();
             void RemoveExpiredSnapshots();
-            Snapshot* GetSyncSnapshot(SnapshotType type, SnapshotRoutine* cb, void *data);
+            Snapshot* GetSyncSnapshot(SnapshotType type, SnapshotRoutine* cb, void *data, const ReplFilter* filter = NULL);
             Snapshot* NewSnapshot(SnapshotType type, bool bgsave, SnapshotRoutine* cb, void *data);
             time_t LastSave();
             int CurrentSaverNum();
@@ -29,8 +29,12 @@
 #include "repl.hpp"
 #include "redis/crc64.h"
 #include "db/db.hpp"
+#include "util/mem_arena.hpp"
+#include "util/probes.hpp"
+#include <snappy.h>
 
 #define SERVER_KEY_SIZE 40
+#define MAX_WAL_WRITE_BATCH 1024
 #define RUN_PERIOD(name, ms) static uint64_t name##_exec_ms = 0;  \
     if(ms > 0 && (now - name##_exec_ms >= ms) && (name##_exec_ms = now))
 OP_NAMESPACE_BEGIN
@@ -50,8 +54,37 @@ OP_NAMESPACE_BEGIN
 
     };
 
+    struct WALWriteOperation
+    {
+            Data ns;
+            Buffer cmd;
+            bool wait_sync; //the writer waits until the command fsynced
+            bool done;
+            WALWriteOperation() :
+                    wait_sync(false), done(false)
+            {
+            }
+    };
+
+    static void sync_wal(swal_t* wal)
+    {
+        LatencyMonitorScope latency("wal-fsync");
+        ARDB_PROBE(wal__sync__start);
+        swal_sync(wal);
+        ARDB_PROBE(wal__sync__done);
+    }
+
+    static void* repl_cache_malloc(size_t size)
+    {
+        return arena_malloc(MEM_ARENA_REPL, size);
+    }
+    static void repl_cache_free(void* ptr)
+    {
+        arena_free(MEM_ARENA_REPL, ptr);
+    }
+
     ReplicationBacklog::ReplicationBacklog() :
-            m_wal(NULL)
+            m_wal(NULL), m_write_queue_size(0), m_writer_running(false), m_writer(NULL)
     {
     }
     void ReplicationBacklog::Routine()
@@ -76,6 +109,8 @@ OP_NAMESPACE_BEGIN
         options->ring_cache_size = g_db->GetConf().repl_backlog_cache_size;
         options->cksm_func = crc64;
         options->log_prefix = "ardb";
+        options->malloc_func = repl_cache_malloc;
+        options->free_func = repl_cache_free;
         int err = swal_open(g_db->GetConf().repl_data_dir.c_str(), options, &m_wal);
         swal_options_destroy(options);
         if (0 != err)
@@ -92,14 +127,122 @@ OP_NAMESPACE_BEGIN
             memset(meta->select_ns, 0, ARDB_MAX_NAMESPACE_SIZE);
             meta->replkey_self_gen = true;
         }
+        if (g_db->GetConf().repl_backlog_async_write)
+        {
+            m_writer_running = true;
+            NEW(m_writer, Thread(this));
+            m_writer->Start();
+        }
         return 0;
     }
+    bool ReplicationBacklog::FsyncEveryWrite()
+    {
+        return g_db->GetConf().repl_backlog_fsync == "batch";
+    }
     void ReplicationBacklog::FlushSyncWAL()
     {
         WriteLockGuard<SpinRWLock> guard(m_repl_lock);
-        swal_sync(m_wal);
+        /*
+         * the wal writer thread fsyncs the wal itself
+         */
+        if (NULL == m_writer && g_db->GetConf().repl_backlog_fsync != "no")
+        {
+            sync_wal(m_wal);
+        }
         swal_sync_meta(m_wal);
     }
+
+    void ReplicationBacklog::Run()
+    {
+        std::vector<WALWriteOperation*> batch;
+        uint64_t last_fsync_ms = get_current_epoch_millis();
+        bool fsync_pending = false;
+        while (m_writer_running || m_write_queue_size > 0)
+        {
+            WALWriteOperation* op = NULL;
+            while (batch.size() < MAX_WAL_WRITE_BATCH && m_write_queue.Pop(op))
+            {
+                batch.push_back(op);
+            }
+            uint64_t now = get_current_epoch_millis();
+            if (batch.empty())
+            {
+                if (fsync_pending && g_db->GetConf().repl_backlog_fsync == "period"
+                        && now - last_fsync_ms >= (uint64_t) g_db->GetConf().repl_backlog_fsync_period)
+                {
+                    sync_wal(m_wal);
+                    last_fsync_ms = now;
+                    fsync_pending = false;
+                }
+                Thread::Sleep(1, MILLIS);
+                continue;
+            }
+            {
+                WriteLockGuard<SpinRWLock> guard(m_repl_lock);
+                for (size_t i = 0; i < batch.size(); i++)
+                {
+                    WriteWAL(batch[i]->ns, batch[i]->cmd, false);
+                }
+            }
+            atomic_sub_uint32(&m_write_queue_size, batch.size());
+            fsync_pending = true;
+            /*
+             * fsync outside the wal lock, writers keep queuing the next batch meanwhile
+             */
+            if (FsyncEveryWrite()
+                    || (g_db->GetConf().repl_backlog_fsync == "period" && now - last_fsync_ms >= (uint64_t) g_db->GetConf().repl_backlog_fsync_period))
+            {
+                sync_wal(m_wal);
+                last_fsync_ms = now;
+                fsync_pending = false;
+            }
+            g_repl->GetIOService().AsyncIO(0, WriteWALCallback, NULL);
+            bool notify = false;
+            {
+                LockGuard<ThreadMutexLock> guard(m_write_ack_lock);
+                for (size_t i = 0; i < batch.size(); i++)
+                {
+                    if (batch[i]->wait_sync)
+                    {
+                        batch[i]->done = true;
+                        notify = true;
+                    }
+                    else
+                    {
+                        DELETE(batch[i]);
+                    }
+                }
+                if (notify)
+                {
+                    m_write_ack_lock.NotifyAll();
+                }
+            }
+            batch.clear();
+        }
+    }
+
+    /*
+     * Wait until all queued commands appended to the wal.
+     */
+    void ReplicationBacklog::WaitWALWritten()
+    {
+        while (NULL != m_writer && m_write_queue_size > 0)
+        {
+            Thread::Sleep(1, MILLIS);
+        }
+    }
+
+    void ReplicationBacklog::StopWriter()
+    {
+        if (NULL == m_writer)
+        {
+            return;
+        }
+        m_writer_running = false;
+        m_writer->Join();
+        DELETE(m_writer);
+        FlushSyncWAL();
+    }
     std::string ReplicationBacklog::GetReplKey()
     {
         if (NULL == m_wal)
@@ -140,12 +283,13 @@ OP_NAMESPACE_BEGIN
     int ReplicationBacklog::WriteWAL(const Buffer& cmd, bool lock)
     {
         WriteLockGuard<SpinRWLock> guard(m_repl_lock, lock);
+        ARDB_PROBE1(wal__append, cmd.ReadableBytes());
         swal_append(m_wal, cmd.GetRawReadBuffer(), cmd.ReadableBytes());
         return cmd.ReadableBytes();
     }
-    int ReplicationBacklog::WriteWAL(const Data& ns, const Buffer& cmd)
+    int ReplicationBacklog::WriteWAL(const Data& ns, const Buffer& cmd, bool lock)
     {
-        WriteLockGuard<SpinRWLock> guard(m_repl_lock, true);
+        WriteLockGuard<SpinRWLock> guard(m_repl_lock, lock);
         ReplMeta* meta = (ReplMeta*) swal_user_meta(m_wal);
         int len = 0;
         if (meta->select_ns_size != ns.StringLength() || strncmp(ns.CStr(), meta->select_ns, ns.StringLength()))
@@ -186,6 +330,37 @@ OP_NAMESPACE_BEGIN
         swal_replay(m_wal, offset, limit_len, func, data);
     }
 
+    static int copy_wal_log(const void* log, size_t loglen, void* data)
+    {
+        Buffer* buf = (Buffer*) data;
+        buf->Write(log, loglen);
+        return 0;
+    }
+
+    /*
+     * Copy the wal from 'offset' for readers out of the repl thread, exclusively since swal maps the wal file lazily
+     * when replaying it.
+     */
+    int ReplicationBacklog::ReadWAL(size_t offset, int64_t limit_len, Buffer& buf)
+    {
+        if (!g_repl->IsInited())
+        {
+            return -1;
+        }
+        WriteLockGuard<SpinRWLock> guard(m_repl_lock);
+        return swal_replay(m_wal, offset, limit_len, copy_wal_log, &buf);
+    }
+
+    int ReplicationBacklog::Locate(size_t offset, int64_t limit_len, int& fd, size_t& file_pos, size_t& len)
+    {
+        if (!g_repl->IsInited())
+        {
+            return -1;
+        }
+        ReadLockGuard<SpinRWLock> guard(m_repl_lock);
+        return swal_locate(m_wal, offset, limit_len, &fd, &file_pos, &len);
+    }
+
     int ReplicationBacklog::WriteWAL(const Data& ns, RedisCommandFrame& cmd)
     {
         if (!g_repl->IsInited())
@@ -193,6 +368,40 @@ OP_NAMESPACE_BEGIN
             return -1;
         }
         const Buffer& raw_protocol = cmd.GetRawProtocolData();
+        if (NULL != m_writer)
+        {
+            WALWriteOperation* op = NULL;
+            NEW(op, WALWriteOperation);
+            op->ns = ns;
+            if (ns.IsString())
+            {
+                op->ns.SetString(ns.CStr(), ns.StringLength(), true);
+            }
+            if (raw_protocol.Readable() && !cmd.IsInLine())
+            {
+                op->cmd.Write(raw_protocol.GetRawReadBuffer(), raw_protocol.ReadableBytes());
+            }
+            else
+            {
+                RedisCommandEncoder::Encode(op->cmd, cmd);
+            }
+            op->wait_sync = FsyncEveryWrite();
+            atomic_add_uint32(&m_write_queue_size, 1);
+            m_write_queue.Push(op);
+            if (op->wait_sync)
+            {
+                /*
+                 * group commit, all writers queued in one batch are acked by one fsync
+                 */
+                LockGuard<ThreadMutexLock> guard(m_write_ack_lock);
+                while (!op->done)
+                {
+                    m_write_ack_lock.Wait(1, MILLIS);
+                }
+                DELETE(op);
+            }
+            return 0;
+        }
         if (raw_protocol.Readable() && !cmd.IsInLine())
         {
             WriteWAL(ns, raw_protocol);
@@ -203,6 +412,10 @@ OP_NAMESPACE_BEGIN
             RedisCommandEncoder::Encode(cmdbuf, cmd);
             WriteWAL(ns, cmdbuf);
         }
+        if (FsyncEveryWrite())
+        {
+            sync_wal(m_wal);
+        }
         g_repl->GetIOService().AsyncIO(0, WriteWALCallback, NULL);
         return 0;
     }
@@ -278,6 +491,172 @@ OP_NAMESPACE_BEGIN
     {
     }
 
+    static inline void put_fixed32(char* p, uint32 v)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            p[i] = (char) ((v >> (8 * i)) & 0xff);
+        }
+    }
+    static inline uint32 get_fixed32(const char* p)
+    {
+        uint32 v = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            v |= ((uint32) (uint8) p[i]) << (8 * i);
+        }
+        return v;
+    }
+
+    void repl_write_frame(Buffer& out, const char* data, size_t len)
+    {
+        /*
+         * only called from the replication thread
+         */
+        static std::string compressed;
+        char header[REPL_FRAME_HEADER_SIZE];
+        header[0] = REPL_FRAME_RAW;
+        const char* payload = data;
+        size_t payload_len = len;
+        if (len >= 64)
+        {
+            snappy::Compress(data, len, &compressed);
+            if (compressed.size() < len)
+            {
+                header[0] = REPL_FRAME_SNAPPY;
+                payload = compressed.data();
+                payload_len = compressed.size();
+            }
+        }
+        put_fixed32(header + 1, payload_len);
+        put_fixed32(header + 5, len);
+        out.Write(header, REPL_FRAME_HEADER_SIZE);
+        out.Write(payload, payload_len);
+    }
+
+    void ReplStreamInflater::MessageReceived(ChannelHandlerContext& ctx, MessageEvent<Buffer>& e)
+    {
+        Buffer* input = e.GetMessage();
+        if (!m_enabled)
+        {
+            fire_message_received<Buffer>(ctx, input, NULL);
+            return;
+        }
+        m_pending.Write(input, input->ReadableBytes());
+        Buffer raw;
+        while (m_pending.ReadableBytes() >= REPL_FRAME_HEADER_SIZE)
+        {
+            const char* header = m_pending.GetRawReadBuffer();
+            uint32 payload_len = get_fixed32(header + 1);
+            uint32 raw_len = get_fixed32(header + 5);
+            if (m_pending.ReadableBytes() < REPL_FRAME_HEADER_SIZE + payload_len)
+            {
+                break;
+            }
+            const char* payload = header + REPL_FRAME_HEADER_SIZE;
+            if (header[0] == REPL_FRAME_RAW && raw_len == payload_len)
+            {
+                raw.Write(payload, payload_len);
+            }
+            else if (header[0] == REPL_FRAME_SNAPPY && snappy::Uncompress(payload, payload_len, &m_raw) && m_raw.size() == raw_len)
+            {
+                raw.Write(m_raw.data(), m_raw.size());
+            }
+            else
+            {
+                ERROR_LOG("Invalid replication frame with type:%d, length:%u/%u", header[0], payload_len, raw_len);
+                m_pending.Clear();
+                ctx.GetChannel()->Close();
+                return;
+            }
+            m_pending.AdvanceReadIndex(REPL_FRAME_HEADER_SIZE + payload_len);
+        }
+        m_pending.DiscardReadedBytes();
+        /*
+         * pending frames are consumed before passing on, since the handlers may read the channel again(Continue)
+         */
+        if (raw.Readable())
+        {
+            fire_message_received<Buffer>(ctx, &raw, NULL);
+        }
+    }
+
+    std::string CDCConsumers::Path()
+    {
+        return g_db->GetConf().repl_data_dir + "/cdc.offsets";
+    }
+
+    /*
+     * one 'consumer offset namespace' line per consumer
+     */
+    void CDCConsumers::Load()
+    {
+        if (m_loaded)
+        {
+            return;
+        }
+        m_loaded = true;
+        std::string content;
+        if (0 != file_read_full(Path(), content))
+        {
+            return;
+        }
+        std::vector<std::string> lines = split_string(content, "\n");
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            std::vector<std::string> ss = split_string(lines[i], " ");
+            CDCPosition pos;
+            if (ss.size() < 2 || !string_toint64(ss[1], pos.offset))
+            {
+                continue;
+            }
+            if (ss.size() > 2)
+            {
+                pos.ns = ss[2];
+            }
+            m_positions[ss[0]] = pos;
+        }
+    }
+
+    int CDCConsumers::Save()
+    {
+        std::string content;
+        PositionTable::iterator it = m_positions.begin();
+        while (it != m_positions.end())
+        {
+            content.append(it->first).append(" ").append(stringfromll(it->second.offset)).append(" ").append(it->second.ns).append("\n");
+            it++;
+        }
+        std::string tmp = Path() + ".tmp";
+        int err = file_write_content(tmp, content);
+        if (0 == err)
+        {
+            err = rename(tmp.c_str(), Path().c_str());
+        }
+        return err;
+    }
+
+    int CDCConsumers::Commit(const std::string& consumer, const CDCPosition& pos)
+    {
+        LockGuard<ThreadMutexLock> guard(m_lock);
+        Load();
+        m_positions[consumer] = pos;
+        return Save();
+    }
+
+    bool CDCConsumers::Get(const std::string& consumer, CDCPosition& pos)
+    {
+        LockGuard<ThreadMutexLock> guard(m_lock);
+        Load();
+        PositionTable::iterator found = m_positions.find(consumer);
+        if (found == m_positions.end())
+        {
+            return false;
+        }
+        pos = found->second;
+        return true;
+    }
+
     ReplicationService::ReplicationService() :
             m_inited(false)
     {
@@ -349,6 +728,14 @@ OP_NAMESPACE_BEGIN
                 }
         };
         m_io_serv.GetTimer().Schedule(new RoutineTask, 1, 1, SECONDS);
+        struct AckWaitersTask: public Runnable
+        {
+                void Run()
+                {
+                    g_repl->GetMaster().WakeAckWaiters(true);
+                }
+        };
+        m_io_serv.GetTimer().Schedule(new AckWaitersTask, 100, 100, MILLIS);
         m_inited = true;
         m_io_serv.Start();
     }
@@ -394,6 +781,7 @@ OP_NAMESPACE_BEGIN
         {
             return;
         }
+        m_repl_backlog.StopWriter();
         m_io_serv.Stop();
         Join();
     }
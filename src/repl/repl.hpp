@@ -34,13 +34,16 @@
 #include "channel/all_includes.hpp"
 #include "thread/thread.hpp"
 #include "thread/thread_mutex.hpp"
+#include "thread/thread_mutex_lock.hpp"
 #include "thread/lock_guard.hpp"
 #include "util/concurrent_queue.hpp"
 #include "thread/spin_rwlock.hpp"
+#include "thread/spin_mutex_lock.hpp"
 #include "swal.h"
 #include "context.hpp"
 #include "rdb.hpp"
 #include <map>
+#include <deque>
 
 using namespace ardb::codec;
 
@@ -48,14 +51,28 @@ OP_NAMESPACE_BEGIN
     class Master;
     class Slave;
     class ReplicationService;
-    class ReplicationBacklog
+    struct WALWriteOperation;
+    struct DisklessSync;
+    struct AckWaiter;
+    /*
+     * With 'repl-backlog-async-write', writers only queue the encoded commands, a dedicated thread appends them
+     * to the wal in batches & fsyncs the wal by the 'repl-backlog-fsync' policy.
+     */
+    class ReplicationBacklog: public Runnable
     {
         private:
             swal_t* m_wal;
             SpinRWLock m_repl_lock;
+            MPSCQueue<WALWriteOperation*> m_write_queue;
+            volatile uint32 m_write_queue_size;
+            volatile bool m_writer_running;
+            Thread* m_writer;
+            ThreadMutexLock m_write_ack_lock;
             void ReCreateWAL();
             static void WriteWALCallback(Channel*, void* data);
-            int WriteWAL(const Data& ns, const Buffer& cmd);
+            void Run();
+            bool FsyncEveryWrite();
+            int WriteWAL(const Data& ns, const Buffer& cmd, bool lock = true);
             int WriteWAL(const Buffer& cmd, bool lock);
             int DirectWriteWAL(RedisCommandFrame& cmd);
             void FlushSyncWAL();
@@ -71,6 +88,8 @@ OP_NAMESPACE_BEGIN
             void SetReplKey(const std::string& str);
             int WriteWAL(const Data& ns, RedisCommandFrame& cmd);
             void Replay(size_t offset, int64_t limit_len, swal_replay_logfunc func, void* data);
+            int ReadWAL(size_t offset, int64_t limit_len, Buffer& buf);
+            int Locate(size_t offset, int64_t limit_len, int& fd, size_t& file_pos, size_t& len);
             bool IsValidOffsetCksm(int64_t offset, uint64_t cksm);
             uint64_t WALStartOffset(bool lock = true);
             uint64_t WALEndOffset(bool lock = true);
@@ -79,6 +98,8 @@ OP_NAMESPACE_BEGIN
             void ClearCurrentNamespace();
             void SetCurrentNamespace(const std::string& ns);
             void ResetWALOffsetCksm(uint64_t offset, uint64_t cksm);
+            void WaitWALWritten();
+            void StopWriter();
             ~ReplicationBacklog();
     };
 
@@ -98,6 +119,9 @@ OP_NAMESPACE_BEGIN
             time_t master_last_interaction_time;
             Buffer replay_cumulate_buffer;
             Snapshot snapshot;
+            int64 filter_skip_drift; //local wal bytes ahead of the master's offsets, by skips kept in the wal while replaying
+            std::string shadow_ns_prefix; //a full resync is loaded into namespaces with this prefix if not empty
+            volatile bool shadow_loading; //the live data stays readable while the full resync is loaded aside
             void UpdateSyncOffsetCksm(const Buffer& buffer);
             void Clear()
             {
@@ -112,22 +136,63 @@ OP_NAMESPACE_BEGIN
                 snapshot.Close();
                 snapshot.SetRoutineCallback(NULL, NULL);
                 replay_cumulate_buffer.Clear();
+                filter_skip_drift = 0;
+                shadow_ns_prefix.clear();
+                shadow_loading = false;
             }
             SlaveContext() :
                     server_is_redis(false), server_support_psync(false), state(0), cached_master_repl_offset(0), cached_master_repl_cksm(0), sync_repl_offset(
-                            0), sync_repl_cksm(0), cmd_recved_time(0), master_link_down_time(0), master_last_interaction_time(0)
+                            0), sync_repl_cksm(0), cmd_recved_time(0), master_link_down_time(0), master_last_interaction_time(0), filter_skip_drift(0), shadow_loading(
+                            false)
             {
             }
     };
 
+    /*
+     * Replication stream framing negotiated by 'replconf capa snappy-stream', everything the master sends after
+     * the replconf reply is cut into frames of 1 byte type, 4 bytes payload length & 4 bytes raw length(little endian)
+     * followed by the payload.
+     */
+#define REPL_STREAM_CAPA "snappy-stream"
+#define REPL_FRAME_RAW 0
+#define REPL_FRAME_SNAPPY 1
+#define REPL_FRAME_HEADER_SIZE 9
+    void repl_write_frame(Buffer& out, const char* data, size_t len);
+
+    class ReplStreamInflater: public ChannelUpstreamHandler<Buffer>
+    {
+        private:
+            Buffer m_pending;
+            std::string m_raw;
+            bool m_enabled;
+            void MessageReceived(ChannelHandlerContext& ctx, MessageEvent<Buffer>& e);
+        public:
+            ReplStreamInflater() :
+                    m_enabled(false)
+            {
+            }
+            void Enable()
+            {
+                m_enabled = true;
+            }
+            void Clear()
+            {
+                m_pending.Clear();
+                m_enabled = false;
+            }
+    };
+
+    struct SlaveApplyWorker;
     class Slave: public ChannelUpstreamHandler<RedisMessage>
     {
         private:
             Channel* m_client;
             uint32 m_clientid;
+            ReplStreamInflater m_inflater;
             RedisMessageDecoder m_decoder;
             NullRedisReplyEncoder m_encoder;
             SlaveContext m_ctx;
+            std::vector<SlaveApplyWorker*> m_apply_workers;
 
             void HandleRedisCommand(Channel* ch, RedisCommandFrame& cmd);
             void HandleRedisReply(Channel* ch, RedisReply& reply);
@@ -142,7 +207,15 @@ OP_NAMESPACE_BEGIN
             int ConnectMaster();
             void ReplayWAL();
             void DoClose();
+            bool DispatchApply(RedisCommandFrame& cmd);
+            void WaitApplied();
+            int64 AppliedOffset();
+            void StopApplyWorkers();
             static void AsyncACKCallback(Channel* ch, void*);
+            bool IsFiltered();
+            void SkipFilteredWAL(RedisCommandFrame& cmd);
+            void DropShadowNameSpaces();
+            void SwapShadowNameSpaces();
         public:
             Slave();
             int Init();
@@ -171,6 +244,7 @@ OP_NAMESPACE_BEGIN
         private:
             SlaveSyncContextSet m_slaves;
             DataDumpFileSet m_cached_snapshots;
+            DisklessSync* m_diskless;
             time_t m_repl_noslaves_since;
             time_t m_repl_nolag_since;
             uint32 m_repl_good_slaves_count;
@@ -178,6 +252,23 @@ OP_NAMESPACE_BEGIN
             int64 m_sync_full_count;
             int64 m_sync_partial_ok_count;
             int64 m_sync_partial_err_count;
+            typedef std::deque<std::pair<uint64, uint64> > OffsetMarkQueue;
+            OffsetMarkQueue m_offset_marks; //(wal end offset, millis)
+            volatile uint64 m_slaves_send_rate;
+            volatile uint64 m_slaves_max_lag_ms;
+            volatile uint64 m_slaves_output_bytes;
+            /*
+             * clients parked by WAIT ordered by the offset to be acked & the acked offsets of slaves,
+             * accessed by the repl thread & clients' threads
+             */
+            typedef std::multimap<int64, AckWaiter*> AckWaiterTable;
+            typedef std::map<SlaveSyncContext*, int64> SlaveAckTable;
+            SpinMutexLock m_ack_lock;
+            AckWaiterTable m_ack_waiters;
+            SlaveAckTable m_slave_acks;
+            volatile int64 m_getack_offset;
+            int64 CountAckedSlaves(int64 offset);
+            void UpdateSlaveAck(SlaveSyncContext* slave, int64 offset, bool remove = false);
 
             void ChannelClosed(ChannelHandlerContext& ctx, ChannelStateEvent& e);
             void ChannelWritable(ChannelHandlerContext& ctx, ChannelStateEvent& e);
@@ -185,19 +276,41 @@ OP_NAMESPACE_BEGIN
 
             void SyncSlave(SlaveSyncContext* slave);
             void SendSnapshotToSlave(SlaveSyncContext* slave);
+            void SendSnapshotFrames(SlaveSyncContext* slave);
+            void SyncWALByFile(SlaveSyncContext* slave);
+            void DoSyncWAL(SlaveSyncContext* slave);
+            void MarkWALOffset();
+            uint64 OffsetLagMillis(int64 offset);
             bool IsAllSlaveSyncingCache();
+            void SendFullResync(SlaveSyncContext* slave, Snapshot* snapshot);
+            bool MatchSlaveFilter(SlaveSyncContext* slave, RedisCommandFrame& cmd);
+            void CheckDisklessSync();
+            void CheckDisklessSyncOutput();
+            void DisklessSyncData(Buffer& data);
+            void FinishDisklessSync();
             friend class ReplicationService;
+            friend struct DisklessSync;
         public:
             Master();
             int Init();
             int Routine();
             void FullResyncSlaves(Snapshot* snapshot);
+            void DisklessSyncStarted();
+            void DisklessSyncDumpDone();
+            bool WaitForAcks(Context& ctx, int64 offset, int64 numreplicas, int64 timeout, int64& acked);
+            void CancelAckWait(Context& ctx);
+            void WakeAckWaiters(bool check_timeout);
             void CloseSlaveBySnapshot(Snapshot* snapshot);
             void CloseSlave(SlaveSyncContext* slave);
 
             void AddSlave(SlaveSyncContext* slave);
             void AddSlave(Channel* slave, RedisCommandFrame& cmd);
             void SetSlavePort(Channel* slave, uint32 port);
+            void SetSlaveEngineSync(Channel* slave);
+            void SetSlaveCompressStream(Channel* slave);
+            void SetSlaveEOFCapa(Channel* slave);
+            void SetSlaveFilter(Channel* slave, const std::string& opt, const std::string& value);
+            void SendFilteredWAL(SlaveSyncContext* slave, const void* log, size_t loglen);
             void SyncWAL(SlaveSyncContext* slave);
             size_t ConnectedSlaves();
             int64 FullSyncCount()
@@ -219,9 +332,53 @@ OP_NAMESPACE_BEGIN
             {
                 return m_repl_good_slaves_count;
             }
+            uint64 SlavesSendRate() const
+            {
+                return m_slaves_send_rate;
+            }
+            uint64 SlavesMaxLagMillis() const
+            {
+                return m_slaves_max_lag_ms;
+            }
+            uint64 SlavesOutputBytes() const
+            {
+                return m_slaves_output_bytes;
+            }
             ~Master();
     };
 
+    /*
+     * Positions of change data capture consumers in the wal, committed by 'CDC COMMIT' & kept in
+     * '<repl-dir>/cdc.offsets' across restarts.
+     */
+    struct CDCPosition
+    {
+            int64 offset;
+            std::string ns; //namespace selected at the offset
+            CDCPosition() :
+                    offset(0)
+            {
+            }
+    };
+    class CDCConsumers
+    {
+        private:
+            typedef std::map<std::string, CDCPosition> PositionTable;
+            ThreadMutexLock m_lock;
+            PositionTable m_positions;
+            bool m_loaded;
+            std::string Path();
+            void Load();
+            int Save();
+        public:
+            CDCConsumers() :
+                    m_loaded(false)
+            {
+            }
+            int Commit(const std::string& consumer, const CDCPosition& pos);
+            bool Get(const std::string& consumer, CDCPosition& pos);
+    };
+
     class ReplicationService: public Thread
     {
         private:
@@ -229,6 +386,7 @@ OP_NAMESPACE_BEGIN
             Slave m_slave;
             Master m_master;
             ReplicationBacklog m_repl_backlog;
+            CDCConsumers m_cdc_consumers;
             bool m_inited;
             void Run();
             void Routine();
@@ -238,6 +396,10 @@ OP_NAMESPACE_BEGIN
             bool IsInited() const;
             ChannelService& GetIOService();
             ReplicationBacklog& GetReplLog();
+            CDCConsumers& GetCDCConsumers()
+            {
+                return m_cdc_consumers;
+            }
             Master& GetMaster();
             Slave& GetSlave();
             void StopService();
@@ -34,12 +34,16 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <string.h>
+#include <sched.h>
 #include "repl.hpp"
 #include "redis/crc64.h"
 #include "db/db.hpp"
 #include "util/concurrent_queue.hpp"
+#include "util/murmur3.h"
 
 #define MAX_REPLAY_CACHE_SIZE 1024*1024
+#define MAX_SLAVE_APPLY_QUEUE_SIZE 10000
+#define SLAVE_APPLY_SPIN_ROUNDS 1000
 
 OP_NAMESPACE_BEGIN
 
@@ -111,36 +115,81 @@ OP_NAMESPACE_BEGIN
         sync_repl_cksm = crc64(sync_repl_offset, (const unsigned char *) (buffer.GetRawReadBuffer()), buffer.ReadableBytes());
     }
 
-//    struct SlaveWorker
-//    {
-//            SPSCQueue<RedisCommandFrame*> write_queue;
-//            Context ctx;
-//            bool running;
-//            SlaveWorker() :
-//                    running(true)
-//            {
-//                ctx.flags.slave = 1;
-//                ctx.flags.no_wal = 1;
-//            }
-//            void Run()
-//            {
-//                while (running)
-//                {
-//                    RedisCommandFrame* cmd = NULL;
-//                    while(write_queue.Pop(cmd))
-//                    {
-//                        g_db->Call(ctx, *cmd);
-//                        DELETE(cmd);
-//                    }
-//                    Thread::Sleep(1, MILLIS);
-//                }
-//            }
-//            void Offer(RedisCommandFrame* cmd)
-//            {
-//                write_queue.Push(cmd);
-//            }
-//
-//    };
+    /*
+     * Replicated single key writes applied by 'slave-apply-threads' threads, a key always goes to the same worker
+     * so that writes of one key keep the order of the master.
+     */
+    struct SlaveApplyOperation
+    {
+            RedisCommandFrame cmd;
+            Data ns;
+            int64 offset; //replication offset after the command
+            SlaveApplyOperation() :
+                    offset(0)
+            {
+            }
+    };
+
+    struct SlaveApplyWorker: public Thread
+    {
+            Context ctx;
+            SPSCQueue<SlaveApplyOperation*> apply_queue;
+            volatile uint32 queue_size;
+            /*
+             * all commands of this worker before this offset are applied, only meaningful while queue_size > 0
+             */
+            volatile int64 applied_offset;
+            volatile bool running;
+            SlaveApplyWorker() :
+                    queue_size(0), applied_offset(0), running(true)
+            {
+                ctx.flags.slave = 1;
+                ctx.flags.no_wal = 1;
+                ctx.flags.no_fill_reply = 1;
+            }
+            void Run()
+            {
+                uint32 idle = 0;
+                while (running)
+                {
+                    SlaveApplyOperation* op = NULL;
+                    int count = 0;
+                    while (apply_queue.Pop(op))
+                    {
+                        count++;
+                        ctx.ns = op->ns;
+                        g_db->Call(ctx, op->cmd);
+                        applied_offset = op->offset;
+                        DELETE(op);
+                        atomic_sub_uint32(&queue_size, 1);
+                    }
+                    if (count > 0)
+                    {
+                        idle = 0;
+                    }
+                    else if (++idle < SLAVE_APPLY_SPIN_ROUNDS)
+                    {
+                        sched_yield();
+                    }
+                    else
+                    {
+                        Thread::Sleep(1, MILLIS);
+                    }
+                }
+            }
+            void Offer(SlaveApplyOperation* op)
+            {
+                atomic_add_uint32(&queue_size, 1);
+                apply_queue.Push(op);
+            }
+            void WaitApplied()
+            {
+                while (queue_size > 0)
+                {
+                    sched_yield();
+                }
+            }
+    };
 
     Slave::Slave() :
             m_client(NULL), m_clientid(0)
@@ -220,6 +269,17 @@ OP_NAMESPACE_BEGIN
             }
             if (m_ctx.sync_repl_offset == g_repl->GetReplLog().WALEndOffset())
             {
+                if (IsFiltered())
+                {
+                    /*
+                     * back to the master's offsets, the repl key is only set now so that a restart before never
+                     * continues from local offsets
+                     */
+                    m_ctx.sync_repl_offset -= m_ctx.filter_skip_drift;
+                    m_ctx.filter_skip_drift = 0;
+                    g_repl->GetReplLog().ResetWALOffsetCksm(m_ctx.sync_repl_offset, 0);
+                    g_repl->GetReplLog().SetReplKey(m_ctx.cached_master_runid);
+                }
                 m_ctx.state = SLAVE_STATE_SYNCED;
                 if (!g_repl->GetReplLog().CurrentNamespace().empty())
                 {
@@ -269,9 +329,94 @@ OP_NAMESPACE_BEGIN
         InfoMaster();
     }
 
+    /*
+     * Side namespaces left by a shadow full resync which did not complete
+     */
+    void Slave::DropShadowNameSpaces()
+    {
+        DataArray nss;
+        g_db->GetEngine()->ListNameSpaces(m_ctx.ctx, nss);
+        for (size_t i = 0; i < nss.size(); i++)
+        {
+            if (has_prefix(nss[i].AsString(), SHADOW_NAMESPACE_PREFIX))
+            {
+                g_db->FlushDB(m_ctx.ctx, nss[i], true);
+            }
+        }
+    }
+
+    /*
+     * The namespaces loaded aside take the place of the live ones, the live namespaces missing in the dump are
+     * flushed as they would be by the clear before a full resync.
+     */
+    void Slave::SwapShadowNameSpaces()
+    {
+        const StringArray& loaded = m_ctx.snapshot.LoadedNameSpaces();
+        StringTreeSet loaded_nss(loaded.begin(), loaded.end());
+        DataArray nss;
+        g_db->GetEngine()->ListNameSpaces(m_ctx.ctx, nss);
+        for (size_t i = 0; i < nss.size(); i++)
+        {
+            if (!has_prefix(nss[i].AsString(), SHADOW_NAMESPACE_PREFIX) && loaded_nss.count(nss[i].AsString()) == 0)
+            {
+                g_db->FlushDB(m_ctx.ctx, nss[i], true);
+            }
+        }
+        StringTreeSet::iterator it = loaded_nss.begin();
+        while (it != loaded_nss.end())
+        {
+            Data ns(*it, false), from(m_ctx.shadow_ns_prefix + *it, false);
+            int err = g_db->SwapNameSpace(m_ctx.ctx, ns, from);
+            if (ERR_ENTRY_NOT_EXIST == err)
+            {
+                //no key loaded into it
+                g_db->FlushDB(m_ctx.ctx, ns, true);
+            }
+            else if (0 != err)
+            {
+                ERROR_LOG("Failed to swap loaded namespace:%s in place of %s with err:%d", from.AsString().c_str(), it->c_str(), err);
+            }
+            it++;
+        }
+        INFO_LOG("Swapped %u namespaces loaded by full resync in place of the live ones.", loaded_nss.size());
+    }
+
+    bool Slave::IsFiltered()
+    {
+        return !m_ctx.server_is_redis && (!g_db->GetConf().slave_filter_namespaces.empty() || !g_db->GetConf().slave_filter_key_prefixes.empty());
+    }
+
+    /*
+     * The master dropped 'skip' bytes of its wal by the filter of this slave, the local wal jumps over them to stay in
+     * the offset space of the master. Before the wal is replayed the skip is kept in the wal, the local offsets are
+     * corrected once it's replayed.
+     */
+    void Slave::SkipFilteredWAL(RedisCommandFrame& cmd)
+    {
+        int64 skipped = 0;
+        if (!string_toint64(cmd.GetArguments()[1], skipped) || skipped <= 0)
+        {
+            WARN_LOG("Invalid replconf skip:%s", cmd.GetArguments()[1].c_str());
+            return;
+        }
+        if (SLAVE_STATE_SYNCED == m_ctx.state)
+        {
+            m_ctx.sync_repl_offset += skipped;
+            g_repl->GetReplLog().ResetWALOffsetCksm(m_ctx.sync_repl_offset, 0);
+            return;
+        }
+        int len = g_repl->GetReplLog().DirectWriteWAL(cmd);
+        m_ctx.filter_skip_drift += len - skipped;
+    }
+
     void Slave::HandleRedisCommand(Channel* ch, RedisCommandFrame& cmd)
     {
         m_ctx.cmd_recved_time = time(NULL);
+        if (cmd.GetArguments().size() == 2 && !strcasecmp(cmd.GetArguments()[0].c_str(), "skip") && !strcasecmp(cmd.GetCommand().c_str(), "replconf"))
+        {
+            SkipFilteredWAL(cmd);
+            return;
+        }
         int len = g_repl->GetReplLog().DirectWriteWAL(cmd);
         DEBUG_LOG("Recv master inline:%d cmd %s with type:%d at %lld %lld at state:%s", cmd.IsInLine(), cmd.ToString().c_str(), len, m_ctx.sync_repl_offset,
                 g_repl->GetReplLog().WALEndOffset(), state2String(m_ctx.state));
@@ -283,17 +428,104 @@ OP_NAMESPACE_BEGIN
         {
             m_ctx.ctx.flags.no_wal = 1;
             /*
-             * todo:
-             * call db may block current sync thread, maybe use more threads to exec command better.
-             * If use more threads to handle sync commands, there are several new problems:
-             * 1. Keep the commands exec order for same key
-             *    eg: lpush list a  & lpush list b must be executed in same thread  to keep exec order
-             * 2. ?
+             * Commands which can not be dispatched to the apply workers are barriers, executed in this thread
+             * after all commands before them are applied.
              */
-            g_db->Call(m_ctx.ctx, cmd);
+            if (!DispatchApply(cmd))
+            {
+                WaitApplied();
+                g_db->Call(m_ctx.ctx, cmd);
+            }
             m_ctx.UpdateSyncOffsetCksm(cmd.GetRawProtocolData());
         }
     }
+    bool Slave::DispatchApply(RedisCommandFrame& cmd)
+    {
+        if (g_db->GetConf().slave_apply_threads <= 1 || cmd.GetArguments().empty() || m_ctx.ctx.InTransaction())
+        {
+            return false;
+        }
+        Ardb::RedisCommandHandlerSetting* setting = g_db->FindRedisCommandHandlerSetting(cmd);
+        if (NULL == setting || !setting->IsSingleKeyWrite())
+        {
+            return false;
+        }
+        if (m_apply_workers.empty())
+        {
+            for (int64 i = 0; i < g_db->GetConf().slave_apply_threads; i++)
+            {
+                SlaveApplyWorker* worker = NULL;
+                NEW(worker, SlaveApplyWorker);
+                worker->Start();
+                m_apply_workers.push_back(worker);
+            }
+        }
+        const std::string& key = cmd.GetArguments()[0];
+        uint32 hash = 0;
+        MurmurHash3_x86_32(key.data(), key.size(), 0, &hash);
+        SlaveApplyWorker* worker = m_apply_workers[hash % m_apply_workers.size()];
+        while (worker->queue_size >= MAX_SLAVE_APPLY_QUEUE_SIZE)
+        {
+            sched_yield();
+        }
+        SlaveApplyOperation* op = NULL;
+        NEW(op, SlaveApplyOperation);
+        op->cmd = cmd;
+        op->ns = m_ctx.ctx.ns;
+        if (op->ns.IsString())
+        {
+            op->ns.SetString(m_ctx.ctx.ns.CStr(), m_ctx.ctx.ns.StringLength(), true);
+        }
+        op->offset = m_ctx.sync_repl_offset + cmd.GetRawProtocolData().ReadableBytes();
+        if (0 == worker->queue_size)
+        {
+            /*
+             * the worker is idle, nothing of it is pending before this command
+             */
+            worker->applied_offset = m_ctx.sync_repl_offset;
+        }
+        worker->Offer(op);
+        return true;
+    }
+
+    void Slave::WaitApplied()
+    {
+        for (size_t i = 0; i < m_apply_workers.size(); i++)
+        {
+            m_apply_workers[i]->WaitApplied();
+        }
+    }
+
+    /*
+     * Offset of the replication stream applied by all apply workers, the minimum of the workers still applying
+     * commands, acked to the master instead of the received offset.
+     */
+    int64 Slave::AppliedOffset()
+    {
+        int64 offset = m_ctx.sync_repl_offset;
+        for (size_t i = 0; i < m_apply_workers.size(); i++)
+        {
+            SlaveApplyWorker* worker = m_apply_workers[i];
+            if (worker->queue_size > 0 && worker->applied_offset < offset)
+            {
+                offset = worker->applied_offset;
+            }
+        }
+        return offset;
+    }
+
+    void Slave::StopApplyWorkers()
+    {
+        for (size_t i = 0; i < m_apply_workers.size(); i++)
+        {
+            m_apply_workers[i]->WaitApplied();
+            m_apply_workers[i]->running = false;
+            m_apply_workers[i]->Join();
+            DELETE(m_apply_workers[i]);
+        }
+        m_apply_workers.clear();
+    }
+
     void Slave::Routine()
     {
         if (g_db->GetConf().master_host.empty())
@@ -336,7 +568,7 @@ OP_NAMESPACE_BEGIN
                 Buffer buffer;
                 RedisCommandFrame ack("REPLCONF");
                 ack.AddArg("ACK");
-                ack.AddArg(stringfromll(m_ctx.sync_repl_offset));
+                ack.AddArg(stringfromll(AppliedOffset()));
                 RedisCommandEncoder::Encode(buffer, ack);
                 m_client->Write(buffer);
             }
@@ -419,7 +651,41 @@ OP_NAMESPACE_BEGIN
                     m_ctx.server_support_psync = true;
                 }
                 Buffer replconf;
-                replconf.Printf("replconf listening-port %u\r\n", g_db->GetConf().PrimaryPort());
+                replconf.Printf("replconf listening-port %u", g_db->GetConf().PrimaryPort());
+                if (!m_ctx.server_is_redis && g_db->GetEngine()->GetFeatureSet().support_checkpoint)
+                {
+                    replconf.Printf(" capa engine-%s", g_engine_name);
+                    if (get_key_codec_version() != KEY_CODEC_V1)
+                    {
+                        replconf.Printf("-keycodec%u", get_key_codec_version());
+                    }
+                }
+                if (!m_ctx.server_is_redis && g_db->GetConf().repl_compress_stream)
+                {
+                    replconf.Printf(" capa %s", REPL_STREAM_CAPA);
+                }
+                if (!m_ctx.server_is_redis)
+                {
+                    //accept dumps streamed by a diskless master, which ends with an eof mark instead of a known length
+                    replconf.Printf(" capa eof");
+                }
+                if (IsFiltered())
+                {
+                    if (!g_db->GetConf().slave_filter_namespaces.empty())
+                    {
+                        replconf.Printf(" filter-ns %s", g_db->GetConf().slave_filter_namespaces.c_str());
+                    }
+                    if (!g_db->GetConf().slave_filter_key_prefixes.empty())
+                    {
+                        replconf.Printf(" filter-prefix %s", g_db->GetConf().slave_filter_key_prefixes.c_str());
+                    }
+                    std::string ns = g_repl->GetReplLog().CurrentNamespace();
+                    if (!ns.empty())
+                    {
+                        replconf.Printf(" filter-select %s", ns.c_str());
+                    }
+                }
+                replconf.Printf("\r\n");
                 m_ctx.state = SLAVE_STATE_WAITING_REPLCONF_REPLY;
                 ch->Write(replconf);
                 break;
@@ -432,13 +698,24 @@ OP_NAMESPACE_BEGIN
                     ch->Close();
                     return;
                 }
+                if (reply.str == "OK " REPL_STREAM_CAPA)
+                {
+                    /*
+                     * master frames everything after this reply
+                     */
+                    INFO_LOG("[Slave]Replication stream compressed by master.");
+                    m_inflater.Enable();
+                }
                 if (m_ctx.server_support_psync)
                 {
                     Buffer sync;
                     if (!m_ctx.server_is_redis)
                     {
+                        /*
+                         * the wal of a filtered slave misses the dropped logs, its cksm never matches the master's
+                         */
                         sync.Printf("psync %s %lld cksm %llu\r\n", g_repl->GetReplLog().IsReplKeySelfGen() ? "?" : g_repl->GetReplLog().GetReplKey().c_str(),
-                                g_repl->GetReplLog().WALEndOffset(), g_repl->GetReplLog().WALCksm());
+                                g_repl->GetReplLog().WALEndOffset(), IsFiltered() ? 0 : g_repl->GetReplLog().WALCksm());
                     }
                     else
                     {
@@ -541,6 +818,9 @@ OP_NAMESPACE_BEGIN
             sprintf(tmp, "%s/sync-snapshot.%u.%u", g_db->GetConf().backup_dir.c_str(), getpid(), now);
             m_ctx.snapshot.OpenWriteFile(tmp);
             INFO_LOG("[Slave]Create dump file:%s, expected size:%lld, master is redis:%d", tmp, chunk.len, m_ctx.server_is_redis);
+            /*
+             * a dump streamed with eof mark has no length(-1), it's complete once the mark received
+             */
             m_ctx.snapshot.SetExpectedDataSize(chunk.len);
         }
         if (!chunk.chunk.empty())
@@ -567,18 +847,40 @@ OP_NAMESPACE_BEGIN
              */
             g_repl->GetReplLog().SetReplKey(random_hex_string(40));
             g_repl->GetReplLog().ResetWALOffsetCksm(m_ctx.cached_master_repl_offset, m_ctx.cached_master_repl_cksm);
-            if (g_db->GetConf().slave_cleardb_before_fullresync)
+            /*
+             * an engine dump replaces all data anyway, other dumps either replace it after cleared or, by a shadow full resync,
+             * are loaded into side namespaces swapped in place of the live ones once loaded.
+             */
+            m_ctx.shadow_ns_prefix.clear();
+            if (g_db->GetConf().slave_cleardb_before_fullresync && Snapshot::IsEngineDumpFile(m_ctx.snapshot.GetPath()) != 1)
             {
-                g_db->FlushAll(m_ctx.ctx);
+                if (g_db->GetConf().slave_shadow_fullresync && g_db->GetEngine()->GetFeatureSet().support_swap_namespace)
+                {
+                    DropShadowNameSpaces();
+                    m_ctx.shadow_ns_prefix = SHADOW_NAMESPACE_PREFIX + stringfromll(time(NULL)) + ".";
+                    m_ctx.shadow_loading = true;
+                }
+                else
+                {
+                    g_db->FlushAll(m_ctx.ctx);
+                }
             }
-            INFO_LOG("Start loading snapshot file.");
+            INFO_LOG("Start loading snapshot file%s.", m_ctx.shadow_loading ? " aside the live data" : "");
             m_ctx.cmd_recved_time = time(NULL);
             DBWriter load_writer;
             m_ctx.snapshot.SetDBWriter(&load_writer);
+            m_ctx.snapshot.SetLoadNameSpacePrefix(m_ctx.shadow_ns_prefix);
             int ret = m_ctx.snapshot.Reload(LoadRDBRoutine, &m_ctx);
             m_ctx.snapshot.SetDBWriter(NULL);
+            m_ctx.snapshot.SetLoadNameSpacePrefix("");
             if (0 != ret)
             {
+                if (m_ctx.shadow_loading)
+                {
+                    load_writer.Stop();
+                    DropShadowNameSpaces();
+                    m_ctx.shadow_loading = false;
+                }
                 if (NULL != m_client)
                 {
                     m_client->Close();
@@ -587,7 +889,15 @@ OP_NAMESPACE_BEGIN
                 return;
             }
             load_writer.Stop();
-            g_repl->GetReplLog().SetReplKey(m_ctx.cached_master_runid);
+            if (m_ctx.shadow_loading)
+            {
+                SwapShadowNameSpaces();
+                m_ctx.shadow_loading = false;
+            }
+            if (!IsFiltered())
+            {
+                g_repl->GetReplLog().SetReplKey(m_ctx.cached_master_runid);
+            }
             m_ctx.sync_repl_offset = m_ctx.cached_master_repl_offset;
             m_ctx.sync_repl_cksm = m_ctx.cached_master_repl_cksm;
             m_ctx.state = SLAVE_STATE_REPLAYING_WAL;
@@ -625,6 +935,10 @@ OP_NAMESPACE_BEGIN
         m_ctx.master_last_interaction_time = m_ctx.master_link_down_time = time(NULL);
         m_client = NULL;
         m_clientid = 0;
+        /*
+         * the next sync may load a snapshot or replay wal from the applied offset
+         */
+        WaitApplied();
         m_ctx.Clear();
         /*
          * Current instance is disconnect from remote master, can not accept slaves now.
@@ -655,7 +969,9 @@ OP_NAMESPACE_BEGIN
         g_repl->GetMaster().DisconnectAllSlaves();
         m_client = g_repl->GetIOService().NewClientSocketChannel();
         m_clientid = m_client->GetID();
+        m_inflater.Clear();
         m_decoder.Clear();
+        m_client->GetPipeline().AddLast("inflater", &m_inflater);
         m_client->GetPipeline().AddLast("decoder", &m_decoder);
         m_client->GetPipeline().AddLast("encoder", &m_encoder);
         m_client->GetPipeline().AddLast("handler", this);
@@ -667,7 +983,7 @@ OP_NAMESPACE_BEGIN
     }
     int64 Slave::SyncOffset()
     {
-        return m_ctx.sync_repl_offset;
+        return AppliedOffset();
     }
     int64 Slave::SyncLeftBytes()
     {
@@ -690,10 +1006,11 @@ OP_NAMESPACE_BEGIN
     bool Slave::IsLoading()
     {
         /*
-         * if slave can serve stale data, 'SLAVE_STATE_REPLAYING_WAL' would not considered as 'loading' state.
+         * if slave can serve stale data, 'SLAVE_STATE_REPLAYING_WAL' would not considered as 'loading' state, neither the
+         * loading of a shadow full resync which leaves the live data as it is.
          */
         return NULL != m_client
-                && (SLAVE_STATE_LOADING_SNAPSHOT == m_ctx.state ||
+                && ((SLAVE_STATE_LOADING_SNAPSHOT == m_ctx.state && !(m_ctx.shadow_loading && g_db->GetConf().slave_serve_stale_data)) ||
                         (!g_db->GetConf().slave_serve_stale_data && SLAVE_STATE_REPLAYING_WAL == m_ctx.state));
     }
 
@@ -710,6 +1027,7 @@ OP_NAMESPACE_BEGIN
     {
         m_ctx.state = SLAVE_STATE_INVALID;
         Close();
+        StopApplyWorkers();
     }
     void Slave::DoClose()
     {
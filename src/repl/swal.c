@@ -32,6 +32,7 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include "swal.h"
 
@@ -67,6 +68,8 @@ swal_options_t* swal_options_create()
     options->max_file_size = 1 * 1024 * 1024 * 1024LL;  //default 1G
     options->user_meta_size = 0;
     options->ring_cache_size = 0;
+    options->malloc_func = malloc;
+    options->free_func = free;
     return options;
 }
 void swal_options_destroy(swal_options_t* options)
@@ -173,7 +176,7 @@ int swal_open(const char* dir, const swal_options_t* options, swal_t** wal)
     }
     if (options->ring_cache_size > 0)
     {
-        wal_log->ring_cache = (char*) malloc(options->ring_cache_size);
+        wal_log->ring_cache = (char*) wal_log->options.malloc_func(options->ring_cache_size);
         if (NULL == wal_log->ring_cache)
         {
             swal_close(wal_log);
@@ -340,6 +343,36 @@ int swal_replay(swal_t* wal, size_t offset, int64_t limit_len, swal_replay_logfu
     }
     return 0;
 }
+int swal_locate(swal_t* wal, size_t offset, int64_t limit_len, int* fd, size_t* file_pos, size_t* len)
+{
+    if (offset < wal->meta->log_start_offset || offset > wal->meta->log_end_offset || -1 == wal->fd)
+    {
+        return SWAL_ERR_INVALID_OFFSET;
+    }
+    size_t total = wal->meta->log_end_offset - offset;
+    size_t data_len = total;
+    if (limit_len > 0 && limit_len < total)
+    {
+        total = limit_len;
+    }
+    size_t start_pos = 0;
+    if (wal->meta->log_file_pos >= data_len)
+    {
+        start_pos = wal->meta->log_file_pos - data_len;
+    }
+    else
+    {
+        start_pos = wal->options.max_file_size - data_len + wal->meta->log_file_pos;
+    }
+    if (start_pos + total > wal->options.max_file_size)
+    {
+        total = wal->options.max_file_size - start_pos;
+    }
+    *fd = wal->fd;
+    *file_pos = start_pos;
+    *len = total;
+    return 0;
+}
 int swal_clear_replay_cache(swal_t* wal)
 {
     if (NULL != wal->mmap_buf)
@@ -393,7 +426,7 @@ int swal_close(swal_t* wal)
     }
     if (NULL != wal->ring_cache)
     {
-        free(wal->ring_cache);
+        wal->options.free_func(wal->ring_cache);
     }
     if (NULL != wal->meta)
     {
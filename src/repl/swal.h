@@ -44,6 +44,8 @@ extern "C"
 {
 #endif
     typedef uint64_t swal_cksm_func(uint64_t cksm, const unsigned char* log, uint64_t len);
+    typedef void* swal_malloc_func(size_t size);
+    typedef void swal_free_func(void* ptr);
     typedef struct swal_options_t
     {
             int create_ifnotexist;
@@ -52,6 +54,8 @@ extern "C"
             size_t ring_cache_size;
             swal_cksm_func* cksm_func;
             const char* log_prefix;
+            swal_malloc_func* malloc_func; //used for the ring cache, default malloc
+            swal_free_func* free_func;     //default free
     } swal_options_t;
     swal_options_t* swal_options_create();
     void swal_options_destroy(swal_options_t* options);
@@ -65,6 +69,11 @@ extern "C"
 
     typedef int swal_replay_logfunc(const void* log, size_t loglen, void* data);
     int swal_replay(swal_t* wal, size_t offset, int64_t limit_len, swal_replay_logfunc func, void* data);
+    /*
+     * Locate the logs from 'offset' in the log file, 'len' is the length of the logs stored continuously from 'file_pos'
+     * of the file 'fd' (at most 'limit_len' if it's > 0), for sending the logs by sendfile without copying.
+     */
+    int swal_locate(swal_t* wal, size_t offset, int64_t limit_len, int* fd, size_t* file_pos, size_t* len);
     int swal_clear_replay_cache(swal_t* wal);
     int swal_reset(swal_t* wal, size_t offset, uint64_t cksm);
     uint64_t swal_cksm(swal_t* wal);
@@ -27,6 +27,10 @@
  *THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include "statistics.hpp"
+#include "thread/thread_local.hpp"
+#include "util/murmur3.h"
+#include "util/config_helper.hpp"
+#include <algorithm>
 OP_NAMESPACE_BEGIN
     static Statistics* g_singleton = NULL;
 
@@ -64,9 +68,90 @@ OP_NAMESPACE_BEGIN
         cb(str, data);
     }
 
-    CostTrack::CostTrack()
+    typedef std::vector<ThreadStatBlock*> ThreadStatBlockArray;
+    static SpinMutexLock g_stat_blocks_lock;
+    static ThreadStatBlockArray g_stat_blocks;
+    static volatile uint32_t g_cost_track_slot_seed = 0;
+
+    /*
+     * Blocks are kept in registry after thread exit, so that the thread's records are still counted.
+     */
+    struct ThreadStatBlockRef
+    {
+            ThreadStatBlock* block;
+            ThreadStatBlockRef()
+            {
+                NEW(block, ThreadStatBlock);
+                LockGuard<SpinMutexLock> guard(g_stat_blocks_lock);
+                g_stat_blocks.push_back(block);
+            }
+    };
+    static ThreadLocal<ThreadStatBlockRef> g_local_stat_block;
+
+    uint32 cost_hist_index(uint64 cost)
+    {
+        if (cost < kCostHistSubBuckets)
+        {
+            return (uint32) cost;
+        }
+        if (cost >= (1ULL << kCostHistMaxBits))
+        {
+            return kCostHistBuckets - 1;
+        }
+        uint32 msb = 63 - __builtin_clzll(cost);
+        uint32 shift = msb - 6;
+        return kCostHistSubBuckets + (shift - 1) * (kCostHistSubBuckets / 2) + (uint32) ((cost >> shift) - kCostHistSubBuckets / 2);
+    }
+    uint64 cost_hist_lowest(uint32 index)
+    {
+        if (index < kCostHistSubBuckets)
+        {
+            return index;
+        }
+        uint32 k = index - kCostHistSubBuckets;
+        uint32 shift = k / (kCostHistSubBuckets / 2) + 1;
+        return (uint64) (k % (kCostHistSubBuckets / 2) + kCostHistSubBuckets / 2) << shift;
+    }
+    uint64 cost_hist_highest(uint32 index)
+    {
+        if (index < kCostHistSubBuckets)
+        {
+            return index;
+        }
+        uint32 shift = (index - kCostHistSubBuckets) / (kCostHistSubBuckets / 2) + 1;
+        return cost_hist_lowest(index) + (1ULL << shift) - 1;
+    }
+    uint64 cost_hist_percentile(const CostHistogram& hist, double percentile)
+    {
+        uint64 count = 0;
+        for (size_t i = 0; i < hist.size(); i++)
+        {
+            count += hist[i];
+        }
+        if (0 == count)
+        {
+            return 0;
+        }
+        uint64 rank = (uint64) (percentile / 100 * count + 0.5);
+        if (rank < 1)
+        {
+            rank = 1;
+        }
+        uint64 seen = 0;
+        for (size_t i = 0; i < hist.size(); i++)
+        {
+            seen += hist[i];
+            if (seen >= rank)
+            {
+                return cost_hist_highest(i);
+            }
+        }
+        return cost_hist_highest(hist.size() - 1);
+    }
+
+    CostTrack::CostTrack() :
+            slot(atomic_add_uint32(&g_cost_track_slot_seed, 1) - 1)
     {
-        Clear();
     }
     void CostTrack::SetCostRanges(const CostRanges& ranges)
     {
@@ -75,20 +160,109 @@ OP_NAMESPACE_BEGIN
     }
     void CostTrack::AddCost(uint64 cost)
     {
-        atomic_add_uint64(&recs[0].cost, cost);
-        atomic_add_uint64(&recs[0].count, 1);
+        ThreadStatBlock& block = *(g_local_stat_block.GetValue().block);
+        if (block.costs.size() <= slot || block.costs[slot].recs.size() != ranges.size() + 1 || block.costs[slot].hist.empty())
+        {
+            LockGuard<SpinMutexLock> guard(block.lock);
+            if (block.costs.size() <= slot)
+            {
+                block.costs.resize(slot + 1);
+            }
+            block.costs[slot].recs.resize(ranges.size() + 1);
+            block.costs[slot].hist.resize(kCostHistBuckets);
+        }
+        LocalCostRecords& local = block.costs[slot];
+        local.total.cost += cost;
+        local.total.count++;
+        local.hist[cost_hist_index(cost)]++;
+        local.recs[0].cost += cost;
+        local.recs[0].count++;
         for (size_t i = 0; i < ranges.size(); i++)
         {
             if (cost >= ranges[i].min && cost <= ranges[i].max)
             {
-                atomic_add_uint64(&recs[i + 1].cost, cost);
-                atomic_add_uint64(&recs[i + 1].count, 1);
+                local.recs[i + 1].cost += cost;
+                local.recs[i + 1].count++;
                 return;
             }
         }
     }
+    void CostTrack::GetRecords(CostRecords& recs)
+    {
+        recs.clear();
+        recs.resize(ranges.size() + 1);
+        LockGuard<SpinMutexLock> guard(g_stat_blocks_lock);
+        for (size_t i = 0; i < g_stat_blocks.size(); i++)
+        {
+            ThreadStatBlock& block = *(g_stat_blocks[i]);
+            LockGuard<SpinMutexLock> block_guard(block.lock);
+            if (block.costs.size() <= slot)
+            {
+                continue;
+            }
+            const CostRecords& local = block.costs[slot].recs;
+            for (size_t j = 0; j < local.size() && j < recs.size(); j++)
+            {
+                recs[j].cost += local[j].cost;
+                recs[j].count += local[j].count;
+            }
+        }
+    }
+    void CostTrack::GetTotal(CostRecord& total)
+    {
+        total.cost = 0;
+        total.count = 0;
+        LockGuard<SpinMutexLock> guard(g_stat_blocks_lock);
+        for (size_t i = 0; i < g_stat_blocks.size(); i++)
+        {
+            ThreadStatBlock& block = *(g_stat_blocks[i]);
+            LockGuard<SpinMutexLock> block_guard(block.lock);
+            if (block.costs.size() <= slot)
+            {
+                continue;
+            }
+            total.cost += block.costs[slot].total.cost;
+            total.count += block.costs[slot].total.count;
+        }
+    }
+    void CostTrack::GetHistogram(CostHistogram& hist)
+    {
+        hist.assign(kCostHistBuckets, 0);
+        LockGuard<SpinMutexLock> guard(g_stat_blocks_lock);
+        for (size_t i = 0; i < g_stat_blocks.size(); i++)
+        {
+            ThreadStatBlock& block = *(g_stat_blocks[i]);
+            LockGuard<SpinMutexLock> block_guard(block.lock);
+            if (block.costs.size() <= slot)
+            {
+                continue;
+            }
+            const CostHistogram& local = block.costs[slot].hist;
+            for (size_t j = 0; j < local.size(); j++)
+            {
+                hist[j] += local[j];
+            }
+        }
+    }
+    void CostTrack::ClearHistogram()
+    {
+        LockGuard<SpinMutexLock> guard(g_stat_blocks_lock);
+        for (size_t i = 0; i < g_stat_blocks.size(); i++)
+        {
+            ThreadStatBlock& block = *(g_stat_blocks[i]);
+            LockGuard<SpinMutexLock> block_guard(block.lock);
+            if (block.costs.size() <= slot)
+            {
+                continue;
+            }
+            CostHistogram& local = block.costs[slot].hist;
+            std::fill(local.begin(), local.end(), 0);
+        }
+    }
     void CostTrack::Dump(TrackDumpCallback* cb, void* data)
     {
+        CostRecords recs;
+        GetRecords(recs);
         if (0 == recs[0].count)
         {
             return;
@@ -125,8 +299,444 @@ OP_NAMESPACE_BEGIN
 
     void CostTrack::Clear()
     {
-        recs.clear();
-        recs.resize(ranges.size() + 1);
+        LockGuard<SpinMutexLock> guard(g_stat_blocks_lock);
+        for (size_t i = 0; i < g_stat_blocks.size(); i++)
+        {
+            ThreadStatBlock& block = *(g_stat_blocks[i]);
+            LockGuard<SpinMutexLock> block_guard(block.lock);
+            if (block.costs.size() <= slot)
+            {
+                continue;
+            }
+            CostRecords& local = block.costs[slot].recs;
+            for (size_t j = 0; j < local.size(); j++)
+            {
+                local[j].cost = 0;
+                local[j].count = 0;
+            }
+        }
+    }
+
+    void LatencyEvent::GetSamples(std::vector<LatencySample>& all) const
+    {
+        all.clear();
+        for (uint32 i = 0; i < kLatencyHistoryLen; i++)
+        {
+            const LatencySample& sample = samples[(idx + i) % kLatencyHistoryLen];
+            if (sample.time > 0)
+            {
+                all.push_back(sample);
+            }
+        }
+    }
+
+    static LatencyMonitor* g_latency_monitor = NULL;
+    LatencyMonitor::LatencyMonitor() :
+            m_threshold(0)
+    {
+    }
+    LatencyMonitor& LatencyMonitor::GetSingleton()
+    {
+        if (NULL == g_latency_monitor)
+        {
+            g_latency_monitor = new LatencyMonitor;
+        }
+        return *g_latency_monitor;
+    }
+    void LatencyMonitor::AddSampleIfNeeded(const char* event, uint64 millis)
+    {
+        if (0 == m_threshold || millis < m_threshold)
+        {
+            return;
+        }
+        uint32 now = get_current_epoch_seconds();
+        LockGuard<SpinMutexLock> guard(m_lock);
+        LatencyEvent& ev = m_events[event];
+        if (millis > ev.max)
+        {
+            ev.max = millis;
+        }
+        uint32 prev = (ev.idx + LatencyEvent::kLatencyHistoryLen - 1) % LatencyEvent::kLatencyHistoryLen;
+        if (ev.samples[prev].time == now)
+        {
+            if (millis > ev.samples[prev].latency)
+            {
+                ev.samples[prev].latency = millis;
+            }
+            return;
+        }
+        ev.samples[ev.idx].time = now;
+        ev.samples[ev.idx].latency = millis;
+        ev.idx = (ev.idx + 1) % LatencyEvent::kLatencyHistoryLen;
+    }
+    void LatencyMonitor::GetEvents(LatencyEventTable& events)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        events = m_events;
+    }
+    size_t LatencyMonitor::Reset(const std::vector<std::string>& events)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        size_t count = 0;
+        if (events.empty())
+        {
+            count = m_events.size();
+            m_events.clear();
+            return count;
+        }
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            count += m_events.erase(events[i]);
+        }
+        return count;
+    }
+
+    struct HotKeySampler
+    {
+            uint32 calls;
+            HotKeySampler() :
+                    calls(0)
+            {
+            }
+    };
+    static ThreadLocal<HotKeySampler> g_hotkey_sampler;
+    static HotKeyTracker* g_hotkey_tracker = NULL;
+    HotKeyTracker::HotKeyTracker() :
+            m_sample_rate(0), m_bigkey_min_len(0)
+    {
+    }
+    HotKeyTracker& HotKeyTracker::GetSingleton()
+    {
+        if (NULL == g_hotkey_tracker)
+        {
+            g_hotkey_tracker = new HotKeyTracker;
+        }
+        return *g_hotkey_tracker;
+    }
+    bool HotKeyTracker::Sample()
+    {
+        uint32 rate = m_sample_rate;
+        if (0 == rate)
+        {
+            return false;
+        }
+        HotKeySampler& sampler = g_hotkey_sampler.GetValue();
+        if (++sampler.calls < rate)
+        {
+            return false;
+        }
+        sampler.calls = 0;
+        return true;
+    }
+    HotKeyTracker::NamespaceKeys& HotKeyTracker::GetNamespaceKeys(const std::string& ns)
+    {
+        NamespaceKeys*& keys = m_keys[ns];
+        if (NULL == keys)
+        {
+            keys = new NamespaceKeys;
+        }
+        return *keys;
+    }
+    void HotKeyTracker::AddHit(const std::string& ns, const std::string& key)
+    {
+        uint64 hash[2];
+        MurmurHash3_x64_128(key.data(), key.size(), 0, hash);
+        LockGuard<SpinMutexLock> guard(m_lock);
+        NamespaceKeys& keys = GetNamespaceKeys(ns);
+        keys.samples++;
+        if (keys.samples % kDecaySamples == 0)
+        {
+            for (uint32 i = 0; i < kSketchDepth; i++)
+            {
+                for (uint32 j = 0; j < kSketchWidth; j++)
+                {
+                    keys.sketch[i][j] >>= 1;
+                }
+            }
+            for (size_t i = 0; i < keys.hot.size(); i++)
+            {
+                keys.hot[i].count >>= 1;
+            }
+        }
+        /*
+         * depth hashes derived from the two halves of one murmur hash
+         */
+        uint32 estimate = UINT32_MAX;
+        for (uint32 i = 0; i < kSketchDepth; i++)
+        {
+            uint32& counter = keys.sketch[i][(hash[0] + i * hash[1]) % kSketchWidth];
+            if (counter < UINT32_MAX)
+            {
+                counter++;
+            }
+            estimate = std::min(estimate, counter);
+        }
+        size_t min_idx = 0;
+        for (size_t i = 0; i < keys.hot.size(); i++)
+        {
+            if (keys.hot[i].key == key)
+            {
+                keys.hot[i].count = estimate;
+                return;
+            }
+            if (keys.hot[i].count < keys.hot[min_idx].count)
+            {
+                min_idx = i;
+            }
+        }
+        if (keys.hot.size() < kHotKeysTopK)
+        {
+            keys.hot.resize(keys.hot.size() + 1);
+            min_idx = keys.hot.size() - 1;
+        }
+        else if (keys.hot[min_idx].count >= estimate)
+        {
+            return;
+        }
+        keys.hot[min_idx].key = key;
+        keys.hot[min_idx].count = estimate;
+    }
+    void HotKeyTracker::AddBigKey(const std::string& ns, const std::string& key, uint8 type, int64 len)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        NamespaceKeys& keys = GetNamespaceKeys(ns);
+        size_t min_idx = 0;
+        for (size_t i = 0; i < keys.big.size(); i++)
+        {
+            if (keys.big[i].key == key)
+            {
+                keys.big[i].count = len;
+                keys.big[i].type = type;
+                return;
+            }
+            if (keys.big[i].count < keys.big[min_idx].count)
+            {
+                min_idx = i;
+            }
+        }
+        if (keys.big.size() < kHotKeysTopK)
+        {
+            keys.big.resize(keys.big.size() + 1);
+            min_idx = keys.big.size() - 1;
+        }
+        else if (keys.big[min_idx].count >= (uint64) len)
+        {
+            return;
+        }
+        keys.big[min_idx].key = key;
+        keys.big[min_idx].count = len;
+        keys.big[min_idx].type = type;
+    }
+    void HotKeyTracker::GetHotKeys(HotKeyArray& all, size_t count)
+    {
+        uint32 rate = m_sample_rate > 0 ? m_sample_rate : 1;
+        {
+            LockGuard<SpinMutexLock> guard(m_lock);
+            NamespaceKeysTable::iterator it = m_keys.begin();
+            for (; it != m_keys.end(); it++)
+            {
+                for (size_t i = 0; i < it->second->hot.size(); i++)
+                {
+                    all.push_back(it->second->hot[i]);
+                    all.back().ns = it->first;
+                    all.back().count *= rate;
+                }
+            }
+        }
+        std::sort(all.begin(), all.end());
+        if (all.size() > count)
+        {
+            all.resize(count);
+        }
+    }
+    void HotKeyTracker::GetBigKeys(HotKeyArray& all, size_t count)
+    {
+        {
+            LockGuard<SpinMutexLock> guard(m_lock);
+            NamespaceKeysTable::iterator it = m_keys.begin();
+            for (; it != m_keys.end(); it++)
+            {
+                for (size_t i = 0; i < it->second->big.size(); i++)
+                {
+                    all.push_back(it->second->big[i]);
+                    all.back().ns = it->first;
+                }
+            }
+        }
+        std::sort(all.begin(), all.end());
+        if (all.size() > count)
+        {
+            all.resize(count);
+        }
+    }
+    bool HotKeyTracker::GetNamespaceSummary(const std::string& ns, uint64& samples, uint64& hottest, uint64& biggest)
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        NamespaceKeysTable::iterator found = m_keys.find(ns);
+        if (found == m_keys.end())
+        {
+            return false;
+        }
+        NamespaceKeys& keys = *(found->second);
+        samples = keys.samples;
+        hottest = biggest = 0;
+        for (size_t i = 0; i < keys.hot.size(); i++)
+        {
+            hottest = std::max(hottest, keys.hot[i].count * (m_sample_rate > 0 ? m_sample_rate : 1));
+        }
+        for (size_t i = 0; i < keys.big.size(); i++)
+        {
+            biggest = std::max(biggest, keys.big[i].count);
+        }
+        return true;
+    }
+    void HotKeyTracker::Reset()
+    {
+        LockGuard<SpinMutexLock> guard(m_lock);
+        NamespaceKeysTable::iterator it = m_keys.begin();
+        for (; it != m_keys.end(); it++)
+        {
+            delete it->second;
+        }
+        m_keys.clear();
+    }
+
+    static TenantLimiter* g_tenant_limiter = NULL;
+    TenantLimiter::TenantLimiter() :
+            m_enabled(false), m_client_rejected(0)
+    {
+    }
+    TenantLimiter& TenantLimiter::GetSingleton()
+    {
+        if (NULL == g_tenant_limiter)
+        {
+            g_tenant_limiter = new TenantLimiter;
+        }
+        return *g_tenant_limiter;
+    }
+    const QoSLimit& TenantLimiter::FindLimit(const std::string& ns)
+    {
+        static QoSLimit kNoLimit;
+        QoSLimitTable::iterator found = m_limits.find(ns);
+        if (found == m_limits.end())
+        {
+            found = m_limits.find("*");
+        }
+        return found == m_limits.end() ? kNoLimit : found->second;
+    }
+    bool TenantLimiter::SetLimits(const std::string& spec)
+    {
+        QoSLimitTable limits;
+        std::vector<std::string> entries = split_string(spec, ",");
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            std::string entry = trim_string(entries[i]);
+            if (entry.empty())
+            {
+                continue;
+            }
+            std::vector<std::string> fields = split_string(entry, ":");
+            Properties props;
+            QoSLimit limit;
+            if (fields.size() != 4)
+            {
+                return false;
+            }
+            conf_set(props, "ops", fields[1]);
+            conf_set(props, "bytes", fields[2]);
+            conf_set(props, "slow", fields[3]);
+            if (!conf_get_int64(props, "ops", limit.ops) || !conf_get_int64(props, "bytes", limit.bytes) || !conf_get_int64(props, "slow", limit.slow))
+            {
+                return false;
+            }
+            limits[trim_string(fields[0])] = limit;
+        }
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        m_limits = limits;
+        NamespaceUsageTable::iterator it = m_usages.begin();
+        for (; it != m_usages.end(); it++)
+        {
+            LockGuard<SpinMutexLock> usage_guard(it->second->lock);
+            it->second->SetLimit(FindLimit(it->first));
+        }
+        m_enabled = !m_limits.empty();
+        return true;
+    }
+    TenantLimiter::NamespaceUsage* TenantLimiter::GetUsage(const std::string& ns)
+    {
+        {
+            RWLockGuard<SpinRWLock> guard(m_lock, true);
+            NamespaceUsageTable::iterator found = m_usages.find(ns);
+            if (found != m_usages.end())
+            {
+                return found->second;
+            }
+        }
+        RWLockGuard<SpinRWLock> guard(m_lock, false);
+        NamespaceUsage*& usage = m_usages[ns];
+        if (NULL == usage)
+        {
+            usage = new NamespaceUsage;
+            usage->SetLimit(FindLimit(ns));
+        }
+        return usage;
+    }
+    QoSVerdict TenantLimiter::Admit(const std::string& ns, uint64 bytes, bool slow)
+    {
+        NamespaceUsage* usage = GetUsage(ns);
+        uint64 now = get_current_epoch_micros();
+        LockGuard<SpinMutexLock> guard(usage->lock);
+        QoSVerdict verdict = QOS_ADMIT;
+        if (!usage->ops_bucket.Allow(now))
+        {
+            verdict = QOS_OPS_EXCEEDED;
+        }
+        else if (!usage->bytes_bucket.Allow(now))
+        {
+            verdict = QOS_BYTES_EXCEEDED;
+        }
+        else if (slow && usage->limit.slow > 0 && usage->slow_running >= (uint64) usage->limit.slow)
+        {
+            verdict = QOS_SLOW_EXCEEDED;
+        }
+        if (QOS_ADMIT != verdict)
+        {
+            usage->rejected++;
+            return verdict;
+        }
+        usage->ops_bucket.Charge(1);
+        usage->bytes_bucket.Charge(bytes);
+        usage->ops++;
+        usage->bytes += bytes;
+        if (slow)
+        {
+            usage->slow_running++;
+        }
+        return QOS_ADMIT;
+    }
+    void TenantLimiter::SlowCommandDone(const std::string& ns)
+    {
+        NamespaceUsage* usage = GetUsage(ns);
+        LockGuard<SpinMutexLock> guard(usage->lock);
+        if (usage->slow_running > 0)
+        {
+            usage->slow_running--;
+        }
+    }
+    void TenantLimiter::GetUsages(std::string& info)
+    {
+        info.append("qos_client_rejected:").append(stringfromll(m_client_rejected)).append("\r\n");
+        RWLockGuard<SpinRWLock> guard(m_lock, true);
+        NamespaceUsageTable::iterator it = m_usages.begin();
+        for (; it != m_usages.end(); it++)
+        {
+            NamespaceUsage* usage = it->second;
+            LockGuard<SpinMutexLock> usage_guard(usage->lock);
+            info.append("qos_db").append(it->first).append(":ops=").append(stringfromll(usage->ops)).append(",bytes=").append(
+                    stringfromll(usage->bytes)).append(",rejected=").append(stringfromll(usage->rejected)).append(",slow_running=").append(
+                    stringfromll(usage->slow_running)).append(",ops_limit=").append(stringfromll(usage->limit.ops)).append(",bytes_limit=").append(
+                    stringfromll(usage->limit.bytes)).append(",slow_limit=").append(stringfromll(usage->limit.slow)).append("\r\n");
+        }
     }
 
     Statistics::Statistics()
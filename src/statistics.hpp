@@ -33,9 +33,12 @@
 #include "util/atomic.hpp"
 #include "util/time_helper.hpp"
 #include "thread/spin_mutex_lock.hpp"
+#include "thread/spin_rwlock.hpp"
 #include "thread/lock_guard.hpp"
 #include "util/string_helper.hpp"
+#include "context.hpp"
 #include <vector>
+#include <map>
 #define ARDB_OPS_SEC_SAMPLES 16
 
 //dump flags
@@ -89,6 +92,10 @@ OP_NAMESPACE_BEGIN
             {
                 return atomic_add_uint64(&count, inc);
             }
+            uint64_t Sub(uint64_t dec)
+            {
+                return atomic_sub_uint64(&count, dec);
+            }
             void Set(uint64_t v)
             {
                 count = v;
@@ -193,13 +200,63 @@ OP_NAMESPACE_BEGIN
     typedef std::vector<CostRange> CostRanges;
     typedef std::vector<CostRecord> CostRecords;
 
+    /*
+     * Log-linear cost histogram like a HDR histogram: costs below kCostHistSubBuckets have their own bucket, every
+     * power of 2 above is split into kCostHistSubBuckets/2 buckets, so a bucket is less than 1/64 of its costs wide.
+     * Costs are capped at 2^kCostHistMaxBits.
+     */
+    static const uint32 kCostHistSubBuckets = 128;
+    static const uint32 kCostHistMaxBits = 40;
+    static const uint32 kCostHistBuckets = kCostHistSubBuckets + (kCostHistMaxBits - 7) * kCostHistSubBuckets / 2;
+    typedef std::vector<uint64> CostHistogram;
+    uint32 cost_hist_index(uint64 cost);
+    uint64 cost_hist_lowest(uint32 index);
+    uint64 cost_hist_highest(uint32 index);
+    /*
+     * Highest cost of the bucket holding the percentile(0-100), 0 for an empty histogram.
+     */
+    uint64 cost_hist_percentile(const CostHistogram& hist, double percentile);
+
+    /*
+     * Cost records of one CostTrack written by one thread.
+     * 'total' & 'hist' are not cleared with the records, they are the lifetime calls & costs of the track.
+     */
+    struct LocalCostRecords
+    {
+            CostRecords recs;
+            CostRecord total;
+            CostHistogram hist; //allocated with the first cost
+    };
+    /*
+     * Every thread records costs into its own block without shared writes or atomic ops,
+     * blocks of all threads are summed only when the tracks are dumped.
+     */
+    struct ThreadStatBlock
+    {
+            SpinMutexLock lock; //only taken when the block is resized or read by other threads
+            std::vector<LocalCostRecords> costs; //indexed by CostTrack::slot
+    };
+
     struct CostTrack: public Track
     {
             CostRanges ranges;
-            CostRecords recs;
+            uint32 slot;
             CostTrack();
             void SetCostRanges(const CostRanges& ranges);
             void AddCost(uint64 cost);
+            /*
+             * sum of current records from all threads
+             */
+            void GetRecords(CostRecords& recs);
+            /*
+             * lifetime calls/costs which are not reset by Clear
+             */
+            void GetTotal(CostRecord& total);
+            /*
+             * sum of the lifetime histograms from all threads
+             */
+            void GetHistogram(CostHistogram& hist);
+            void ClearHistogram();
             void Dump(TrackDumpCallback* cb, void* data);
             void Clear();
             int GetType()
@@ -208,6 +265,232 @@ OP_NAMESPACE_BEGIN
             }
     };
 
+    /*
+     * Latency spikes of background work & slow paths, like the redis latency monitor(LATENCY LATEST/HISTORY/DOCTOR):
+     * every event keeps its last kLatencyHistoryLen samples at or above the threshold, one per second.
+     */
+    struct LatencySample
+    {
+            uint32 time;
+            uint32 latency; //millis
+            LatencySample() :
+                    time(0), latency(0)
+            {
+            }
+    };
+    struct LatencyEvent
+    {
+            static const uint32 kLatencyHistoryLen = 160;
+            LatencySample samples[kLatencyHistoryLen];
+            uint32 idx; //next sample slot
+            uint32 max;
+            LatencyEvent() :
+                    idx(0), max(0)
+            {
+            }
+            /*
+             * samples from the oldest to the latest
+             */
+            void GetSamples(std::vector<LatencySample>& all) const;
+    };
+    typedef std::map<std::string, LatencyEvent> LatencyEventTable;
+    class LatencyMonitor
+    {
+        private:
+            SpinMutexLock m_lock;
+            LatencyEventTable m_events;
+            volatile uint64 m_threshold; //millis, 0 disables the monitor
+            LatencyMonitor();
+        public:
+            static LatencyMonitor& GetSingleton();
+            void SetThreshold(uint64 millis)
+            {
+                m_threshold = millis;
+            }
+            bool Enabled() const
+            {
+                return m_threshold > 0;
+            }
+            void AddSampleIfNeeded(const char* event, uint64 millis);
+            void GetEvents(LatencyEventTable& events);
+            /*
+             * Drop the events(all if empty), returns the number of dropped events.
+             */
+            size_t Reset(const std::vector<std::string>& events);
+    };
+
+    /*
+     * Samples the time from construction to destruction as 'event' of the latency monitor.
+     */
+    struct LatencyMonitorScope
+    {
+            const char* event;
+            uint64 start;
+            LatencyMonitorScope(const char* e) :
+                    event(e), start(LatencyMonitor::GetSingleton().Enabled() ? get_current_epoch_millis() : 0)
+            {
+            }
+            ~LatencyMonitorScope()
+            {
+                if (start > 0)
+                {
+                    LatencyMonitor::GetSingleton().AddSampleIfNeeded(event, get_current_epoch_millis() - start);
+                }
+            }
+    };
+
+    /*
+     * Hot keys & big keys per namespace. One of 'hotkeys-sample-rate' keyed commands is sampled, its keys feed a
+     * count-min sketch whose estimates keep the kHotKeysTopK hottest keys, and the metas of at least
+     * 'bigkeys-min-length' elements read by sampled commands keep the kHotKeysTopK biggest keys.
+     */
+    struct HotKey
+    {
+            std::string ns;
+            std::string key;
+            uint64 count; //estimated hits of a hot key, elements of a big key
+            uint8 type;
+            HotKey() :
+                    count(0), type(0)
+            {
+            }
+            bool operator<(const HotKey& other) const
+            {
+                return count > other.count;
+            }
+    };
+    typedef std::vector<HotKey> HotKeyArray;
+    class HotKeyTracker
+    {
+        public:
+            static const uint32 kHotKeysTopK = 32;
+            static const uint32 kSketchDepth = 4;
+            static const uint32 kSketchWidth = 1024;
+            static const uint64 kDecaySamples = 1 << 16; //sketch & hot key counts are halved every these samples
+        private:
+            struct NamespaceKeys
+            {
+                    uint32 sketch[kSketchDepth][kSketchWidth];
+                    uint64 samples;
+                    HotKeyArray hot;
+                    HotKeyArray big;
+                    NamespaceKeys() :
+                            samples(0)
+                    {
+                        memset(sketch, 0, sizeof(sketch));
+                    }
+            };
+            typedef std::map<std::string, NamespaceKeys*> NamespaceKeysTable;
+            SpinMutexLock m_lock;
+            NamespaceKeysTable m_keys;
+            volatile uint32 m_sample_rate; //0 disables the tracker
+            volatile int64 m_bigkey_min_len;
+            NamespaceKeys& GetNamespaceKeys(const std::string& ns);
+            HotKeyTracker();
+        public:
+            static HotKeyTracker& GetSingleton();
+            void SetSampleRate(int64 rate)
+            {
+                m_sample_rate = rate > 0 ? rate : 0;
+            }
+            void SetBigKeyMinLength(int64 len)
+            {
+                m_bigkey_min_len = len;
+            }
+            /*
+             * true for one of every 'sample rate' calls on a thread, a thread local counter is all it costs
+             */
+            bool Sample();
+            bool IsBigKey(int64 len) const
+            {
+                return m_bigkey_min_len > 0 && len >= m_bigkey_min_len;
+            }
+            void AddHit(const std::string& ns, const std::string& key);
+            void AddBigKey(const std::string& ns, const std::string& key, uint8 type, int64 len);
+            /*
+             * hottest/biggest keys of all namespaces, hits are scaled back by the sample rate
+             */
+            void GetHotKeys(HotKeyArray& keys, size_t count);
+            void GetBigKeys(HotKeyArray& keys, size_t count);
+            bool GetNamespaceSummary(const std::string& ns, uint64& samples, uint64& hottest, uint64& biggest);
+            void Reset();
+    };
+
+    /*
+     * Quotas of every namespace(db) set by 'qos-namespace-limits': commands & request bytes per second, and slow
+     * commands running at once. Ardb::Call refuses the commands of clients over the quota of their db, the usage of
+     * every db is counted for INFO qos once any limit is configured.
+     */
+    struct QoSLimit
+    {
+            int64 ops;
+            int64 bytes;
+            int64 slow;
+            QoSLimit() :
+                    ops(0), bytes(0), slow(0)
+            {
+            }
+    };
+    enum QoSVerdict
+    {
+        QOS_ADMIT = 0, QOS_OPS_EXCEEDED, QOS_BYTES_EXCEEDED, QOS_SLOW_EXCEEDED
+    };
+    class TenantLimiter
+    {
+        private:
+            struct NamespaceUsage
+            {
+                    SpinMutexLock lock;
+                    QoSLimit limit;
+                    QoSBucket ops_bucket;
+                    QoSBucket bytes_bucket;
+                    uint64 ops;
+                    uint64 bytes;
+                    uint64 rejected;
+                    volatile uint32 slow_running;
+                    NamespaceUsage() :
+                            ops(0), bytes(0), rejected(0), slow_running(0)
+                    {
+                    }
+                    void SetLimit(const QoSLimit& l)
+                    {
+                        limit = l;
+                        ops_bucket.SetRate(l.ops);
+                        bytes_bucket.SetRate(l.bytes);
+                    }
+            };
+            typedef std::map<std::string, NamespaceUsage*> NamespaceUsageTable;
+            typedef std::map<std::string, QoSLimit> QoSLimitTable;
+            SpinRWLock m_lock;
+            NamespaceUsageTable m_usages;
+            QoSLimitTable m_limits; //'*' is the limit of dbs not listed
+            volatile bool m_enabled;
+            volatile uint64 m_client_rejected;
+            NamespaceUsage* GetUsage(const std::string& ns);
+            const QoSLimit& FindLimit(const std::string& ns);
+            TenantLimiter();
+        public:
+            static TenantLimiter& GetSingleton();
+            bool Enabled() const
+            {
+                return m_enabled;
+            }
+            /*
+             * 'spec' is a comma separated list of <db>:<ops/s>:<bytes/s>:<slow commands>, 0 for no limit.
+             */
+            bool SetLimits(const std::string& spec);
+            /*
+             * Charges an admitted command to its db, a slow one runs until SlowCommandDone.
+             */
+            QoSVerdict Admit(const std::string& ns, uint64 bytes, bool slow);
+            void SlowCommandDone(const std::string& ns);
+            void AddClientRejected()
+            {
+                atomic_add_uint64(&m_client_rejected, 1);
+            }
+            void GetUsages(std::string& info);
+    };
+
     class Statistics
     {
         private:
@@ -0,0 +1,460 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "db/db.hpp"
+#include "thread/thread.hpp"
+#include "thread/thread_local.hpp"
+#include "util/time_helper.hpp"
+#include "util/string_helper.hpp"
+
+/*
+ * Runs workloads directly against the storage engine compiled in, without the network & command layers.
+ */
+using namespace ardb;
+
+struct BenchOptions
+{
+        std::string conf;
+        std::string benchmarks;
+        std::string ns;
+        int64 num;
+        int64 threads;
+        int64 value_size;
+        int64 scan_len;
+        int64 hash_fields;
+        int64 ttl;
+        BenchOptions() :
+                benchmarks("fillseq,fillrandom,readrandom,fillhash,prefixscan,mergemix,ttlchurn,keycodec"), ns("bench"), num(1000000), threads(1), value_size(100), scan_len(
+                        100), hash_fields(100), ttl(1000)
+        {
+        }
+};
+
+static BenchOptions g_options;
+static Data g_ns;
+static ThreadLocal<Buffer> g_codec_buffer;
+
+static uint64 next_random(uint64& seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+static std::string bench_key(const char* prefix, uint64 idx)
+{
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "%s%016llu", prefix, (unsigned long long) idx);
+    return tmp;
+}
+
+class Benchmark;
+class BenchThread: public Thread
+{
+    private:
+        Benchmark* m_bench;
+        uint32 m_idx;
+        void Run();
+    public:
+        std::vector<uint32> latencies;
+        BenchThread(Benchmark* bench, uint32 idx) :
+                m_bench(bench), m_idx(idx)
+        {
+        }
+};
+
+class Benchmark
+{
+    private:
+        Engine* m_engine;
+        std::string m_name;
+        std::string m_value;
+        typedef void (Benchmark::*OpFunc)(Context& ctx, uint64 idx, uint64& seed);
+        OpFunc m_op;
+        int64 m_errors;
+
+        void FillSeq(Context& ctx, uint64 idx, uint64& seed)
+        {
+            Put(ctx, KeyObject(g_ns, KEY_STRING, bench_key("k", idx)));
+        }
+        void FillRandom(Context& ctx, uint64 idx, uint64& seed)
+        {
+            Put(ctx, KeyObject(g_ns, KEY_STRING, bench_key("k", next_random(seed) % g_options.num)));
+        }
+        void ReadRandom(Context& ctx, uint64 idx, uint64& seed)
+        {
+            ValueObject v;
+            int err = m_engine->Get(ctx, KeyObject(g_ns, KEY_STRING, bench_key("k", next_random(seed) % g_options.num)), v);
+            CheckErr(err);
+        }
+        void FillHash(Context& ctx, uint64 idx, uint64& seed)
+        {
+            KeyObject key(g_ns, KEY_HASH_FIELD, bench_key("h", idx / g_options.hash_fields));
+            key.SetHashField(bench_key("f", idx % g_options.hash_fields));
+            ValueObject v;
+            v.SetType(KEY_HASH_FIELD);
+            v.SetHashValue(m_value);
+            CheckErr(m_engine->Put(ctx, key, v));
+        }
+        void PrefixScan(Context& ctx, uint64 idx, uint64& seed)
+        {
+            uint64 hashs = (g_options.num + g_options.hash_fields - 1) / g_options.hash_fields;
+            KeyObject key(g_ns, KEY_HASH_FIELD, bench_key("h", next_random(seed) % hashs));
+            key.SetHashField(Data());
+            IterateOptions options;
+            options.BoundToObject(key);
+            options.prefix_only = true;
+            Iterator* iter = m_engine->Find(ctx, key, options);
+            for (int64 i = 0; NULL != iter && iter->Valid() && i < g_options.scan_len; i++)
+            {
+                iter->RawValue();
+                iter->Next();
+            }
+            DELETE(iter);
+        }
+        void MergeMix(Context& ctx, uint64 idx, uint64& seed)
+        {
+            uint64 r = next_random(seed);
+            KeyObject key(g_ns, KEY_STRING, bench_key("c", (r >> 8) % g_options.num));
+            switch (r % 10)
+            {
+                case 0:
+                case 1:
+                {
+                    ValueObject v;
+                    v.SetType(KEY_STRING);
+                    v.GetStringValue().SetInt64(0);
+                    CheckErr(m_engine->Put(ctx, key, v));
+                    break;
+                }
+                case 2:
+                case 3:
+                {
+                    ValueObject v;
+                    int err = m_engine->Get(ctx, key, v);
+                    CheckErr(err);
+                    break;
+                }
+                default:
+                {
+                    Data incr;
+                    incr.SetInt64(1);
+                    CheckErr(m_engine->Merge(ctx, key, REDIS_CMD_INCRBY, incr));
+                    break;
+                }
+            }
+        }
+        void TTLChurn(Context& ctx, uint64 idx, uint64& seed)
+        {
+            /*
+             * every write expires soon, the key written 'num / threads' writes ago by this thread is deleted
+             */
+            uint64 window = g_options.num / g_options.threads;
+            ValueObject v;
+            v.SetType(KEY_STRING);
+            v.SetTTL(get_current_epoch_millis() + g_options.ttl);
+            v.GetStringValue().SetString(m_value, false);
+            CheckErr(m_engine->Put(ctx, KeyObject(g_ns, KEY_STRING, bench_key("t", idx)), v));
+            if (idx >= window)
+            {
+                CheckErr(m_engine->Del(ctx, KeyObject(g_ns, KEY_STRING, bench_key("t", idx - window))));
+            }
+        }
+        /*
+         * Encode & decode one key of each key type in turn, no engine access.
+         */
+        void KeyCodec(Context& ctx, uint64 idx, uint64& seed)
+        {
+            static const uint8 types[] = { KEY_META, KEY_STRING, KEY_HASH_FIELD, KEY_LIST_ELEMENT, KEY_SET_MEMBER, KEY_ZSET_SORT, KEY_ZSET_SCORE, KEY_ZSET_RANK,
+                    KEY_BITMAP_CHUNK, KEY_TTL_SORT };
+            uint8 type = types[idx % arraysize(types)];
+            std::string name = bench_key("k", idx);
+            KeyObject key(g_ns, type, name);
+            switch (type)
+            {
+                case KEY_HASH_FIELD:
+                case KEY_SET_MEMBER:
+                case KEY_ZSET_SCORE:
+                {
+                    key.SetMember(Data::WrapCStr(m_value), 0);
+                    break;
+                }
+                case KEY_LIST_ELEMENT:
+                case KEY_BITMAP_CHUNK:
+                {
+                    key.SetMember(Data((int64) idx), 0);
+                    break;
+                }
+                case KEY_ZSET_SORT:
+                case KEY_ZSET_RANK:
+                {
+                    key.SetMember(Data((double) idx), 0);
+                    key.SetMember(Data::WrapCStr(m_value), 1);
+                    break;
+                }
+                case KEY_TTL_SORT:
+                {
+                    key.SetTTL(idx);
+                    key.SetTTLKeyNamespace(g_ns);
+                    key.SetTTLKey(m_value);
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+            }
+            Buffer& buffer = g_codec_buffer.GetValue();
+            buffer.Clear();
+            key.Encode(buffer, false, true);
+            KeyObject decoded;
+            if (!decoded.Decode(buffer, false, true) || decoded.GetType() != type)
+            {
+                CheckErr(-1);
+            }
+        }
+        void Put(Context& ctx, const KeyObject& key)
+        {
+            ValueObject v;
+            v.SetType(KEY_STRING);
+            v.GetStringValue().SetString(m_value, false);
+            CheckErr(m_engine->Put(ctx, key, v));
+        }
+        void CheckErr(int err)
+        {
+            if (0 != err && ERR_ENTRY_NOT_EXIST != err)
+            {
+                __sync_add_and_fetch(&m_errors, 1);
+            }
+        }
+        static void PrintLatency(const char* name, std::vector<uint32>& lats, double percentile)
+        {
+            size_t idx = (size_t) (lats.size() * percentile / 100);
+            if (idx >= lats.size())
+            {
+                idx = lats.size() - 1;
+            }
+            printf(" %s:%uus", name, lats[idx]);
+        }
+    public:
+        Benchmark(Engine* engine, const std::string& name) :
+                m_engine(engine), m_name(name), m_value(g_options.value_size, 'x'), m_op(NULL), m_errors(0)
+        {
+            for (size_t i = 0; i < m_value.size(); i++)
+            {
+                m_value[i] = 'a' + i % 26;
+            }
+            if (name == "fillseq")
+                m_op = &Benchmark::FillSeq;
+            else if (name == "fillrandom")
+                m_op = &Benchmark::FillRandom;
+            else if (name == "readrandom")
+                m_op = &Benchmark::ReadRandom;
+            else if (name == "fillhash")
+                m_op = &Benchmark::FillHash;
+            else if (name == "prefixscan")
+                m_op = &Benchmark::PrefixScan;
+            else if (name == "mergemix")
+                m_op = &Benchmark::MergeMix;
+            else if (name == "ttlchurn")
+                m_op = &Benchmark::TTLChurn;
+            else if (name == "keycodec")
+                m_op = &Benchmark::KeyCodec;
+        }
+        bool Valid()
+        {
+            return NULL != m_op;
+        }
+        /*
+         * every thread runs 'num / threads' ops over its own slice of sequential indexes
+         */
+        void RunThread(uint32 tidx, std::vector<uint32>& latencies)
+        {
+            Context ctx;
+            ctx.flags.create_if_notexist = 1;
+            uint64 per_thread = g_options.num / g_options.threads;
+            uint64 seed = 0x9E3779B97F4A7C15ULL * (tidx + 1);
+            latencies.reserve(per_thread);
+            for (uint64 i = tidx * per_thread; i < (tidx + 1) * per_thread; i++)
+            {
+                uint64 start = get_current_epoch_micros();
+                (this->*m_op)(ctx, i, seed);
+                latencies.push_back((uint32) (get_current_epoch_micros() - start));
+            }
+        }
+        void Run()
+        {
+            std::vector<BenchThread*> threads;
+            uint64 start = get_current_epoch_micros();
+            for (int64 i = 0; i < g_options.threads; i++)
+            {
+                BenchThread* t = NULL;
+                NEW(t, BenchThread(this, i));
+                t->Start();
+                threads.push_back(t);
+            }
+            std::vector<uint32> lats;
+            for (size_t i = 0; i < threads.size(); i++)
+            {
+                threads[i]->Join();
+                lats.insert(lats.end(), threads[i]->latencies.begin(), threads[i]->latencies.end());
+                DELETE(threads[i]);
+            }
+            uint64 cost = get_current_epoch_micros() - start;
+            if (lats.empty())
+            {
+                printf("%-12s: no op executed\n", m_name.c_str());
+                return;
+            }
+            std::sort(lats.begin(), lats.end());
+            uint64 total = 0;
+            for (size_t i = 0; i < lats.size(); i++)
+            {
+                total += lats[i];
+            }
+            printf("%-12s: %10.0f ops/s avg:%.2fus", m_name.c_str(), lats.size() * 1000000.0 / (cost > 0 ? cost : 1), (double) total / lats.size());
+            PrintLatency("p50", lats, 50);
+            PrintLatency("p95", lats, 95);
+            PrintLatency("p99", lats, 99);
+            PrintLatency("p99.9", lats, 99.9);
+            printf(" max:%uus errors:%lld\n", lats[lats.size() - 1], (long long) m_errors);
+        }
+};
+
+void BenchThread::Run()
+{
+    m_bench->RunThread(m_idx, latencies);
+}
+
+void usage()
+{
+    fprintf(stderr, "Usage: ./ardb-bench [/path/to/ardb.conf] [--option=value]...\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "       --benchmarks=%s\n", BenchOptions().benchmarks.c_str());
+    fprintf(stderr, "       --num=<ops of each benchmark, default 1000000>\n");
+    fprintf(stderr, "       --threads=<threads running each benchmark, default 1>\n");
+    fprintf(stderr, "       --value_size=<bytes of each value, default 100>\n");
+    fprintf(stderr, "       --scan_len=<entries visited by one prefixscan, default 100>\n");
+    fprintf(stderr, "       --hash_fields=<fields of each hash written by fillhash, default 100>\n");
+    fprintf(stderr, "       --ttl=<ms before values written by ttlchurn expire, default 1000>\n");
+    fprintf(stderr, "       --ns=<namespace benchmarks run in, default bench>\n");
+    fprintf(stderr, "Examples:\n");
+    fprintf(stderr, "       ./ardb-bench ../ardb.conf --benchmarks=fillrandom,readrandom --threads=4 --value_size=1024\n");
+    exit(1);
+}
+
+static bool parse_option(const char* arg)
+{
+    const char* eq = strchr(arg, '=');
+    if (strncmp(arg, "--", 2) != 0 || NULL == eq)
+    {
+        return false;
+    }
+    std::string name(arg + 2, eq - arg - 2);
+    std::string value(eq + 1);
+    int64 n = 0;
+    if (name == "benchmarks")
+    {
+        g_options.benchmarks = value;
+        return true;
+    }
+    if (name == "ns")
+    {
+        g_options.ns = value;
+        return true;
+    }
+    if (!string_toint64(value, n) || n <= 0)
+    {
+        return false;
+    }
+    if (name == "num")
+        g_options.num = n;
+    else if (name == "threads")
+        g_options.threads = n;
+    else if (name == "value_size")
+        g_options.value_size = n;
+    else if (name == "scan_len")
+        g_options.scan_len = n;
+    else if (name == "hash_fields")
+        g_options.hash_fields = n;
+    else if (name == "ttl")
+        g_options.ttl = n;
+    else
+        return false;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
+        {
+            usage();
+        }
+        if (argv[i][0] != '-')
+        {
+            g_options.conf = argv[i];
+        }
+        else if (!parse_option(argv[i]))
+        {
+            fprintf(stderr, "Invalid option:%s\n", argv[i]);
+            usage();
+        }
+    }
+    if (g_options.num < g_options.threads)
+    {
+        g_options.threads = g_options.num;
+    }
+    Ardb db;
+    if (0 != db.Init(g_options.conf))
+    {
+        printf("Failed to init db.\n");
+        return -1;
+    }
+    g_ns.SetString(g_options.ns, true);
+    printf("Engine:%s Benchmarks:%s Num:%lld Threads:%lld ValueSize:%lld\n", g_engine_name, g_options.benchmarks.c_str(), (long long) g_options.num,
+            (long long) g_options.threads, (long long) g_options.value_size);
+    std::vector<std::string> names = split_string(g_options.benchmarks, ",");
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        Benchmark bench(g_engine, trim_string(names[i]));
+        if (!bench.Valid())
+        {
+            fprintf(stderr, "Unknown benchmark:%s\n", names[i].c_str());
+            continue;
+        }
+        bench.Run();
+    }
+    return 0;
+}
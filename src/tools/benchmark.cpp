@@ -0,0 +1,847 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "common.hpp"
+#include "thread/thread.hpp"
+#include "util/time_helper.hpp"
+#include "util/string_helper.hpp"
+
+/*
+ * Command level load generator, drives a running server over RESP with pipelined connections.
+ * Every workload prints one JSON line, the op sequence only depends on '--seed', so two runs
+ * with the same options against two builds are directly comparable.
+ */
+using namespace ardb;
+
+struct BenchmarkOptions
+{
+        std::string host;
+        int64 port;
+        std::string workloads;
+        std::string dist;
+        std::string prefix;
+        int64 clients;
+        int64 pipeline;
+        int64 requests;
+        int64 value_size;
+        int64 keyspace;
+        int64 seed;
+        int64 read_ratio;
+        double zipf_theta;
+        double hot_keys;
+        double hot_ops;
+        bool flush;
+        BenchmarkOptions() :
+                host("127.0.0.1"), port(16379), workloads("string,hash,list,zset,bitset,hll,geo"), dist("uniform"), prefix("bm:"), clients(
+                        50), pipeline(1), requests(100000), value_size(100), keyspace(100000), seed(1), read_ratio(50), zipf_theta(0.99), hot_keys(
+                        0.2), hot_ops(0.8), flush(false)
+        {
+        }
+};
+
+static BenchmarkOptions g_options;
+
+static uint64 next_random(uint64& seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+static double next_double(uint64& seed)
+{
+    return (next_random(seed) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Picks key indexes in [0, keyspace) following '--dist'.
+ * zipfian is the YCSB generator, scrambled so that the hot keys do not sit next to each other in the engine.
+ */
+class KeyChooser
+{
+    private:
+        enum
+        {
+            DIST_UNIFORM, DIST_ZIPFIAN, DIST_HOTSPOT
+        };
+        int m_type;
+        uint64 m_n;
+        double m_theta;
+        double m_alpha;
+        double m_zetan;
+        double m_eta;
+        uint64 m_hot_n;
+        static double zeta(uint64 n, double theta)
+        {
+            double sum = 0;
+            for (uint64 i = 1; i <= n; i++)
+            {
+                sum += 1.0 / pow((double) i, theta);
+            }
+            return sum;
+        }
+        static uint64 scramble(uint64 v)
+        {
+            v ^= v >> 33;
+            v *= 0xff51afd7ed558ccdULL;
+            v ^= v >> 33;
+            v *= 0xc4ceb9fe1a85ec53ULL;
+            v ^= v >> 33;
+            return v;
+        }
+    public:
+        KeyChooser() :
+                m_type(DIST_UNIFORM), m_n(1), m_theta(0), m_alpha(0), m_zetan(0), m_eta(0), m_hot_n(1)
+        {
+        }
+        bool Init(const std::string& dist, uint64 n)
+        {
+            m_n = n;
+            if (dist == "uniform")
+            {
+                m_type = DIST_UNIFORM;
+            }
+            else if (dist == "zipfian")
+            {
+                m_type = DIST_ZIPFIAN;
+                m_theta = g_options.zipf_theta;
+                m_zetan = zeta(n, m_theta);
+                m_alpha = 1.0 / (1.0 - m_theta);
+                m_eta = (1 - pow(2.0 / n, 1 - m_theta)) / (1 - zeta(2, m_theta) / m_zetan);
+            }
+            else if (dist == "hotspot")
+            {
+                m_type = DIST_HOTSPOT;
+                m_hot_n = (uint64) (n * g_options.hot_keys);
+                if (m_hot_n == 0)
+                {
+                    m_hot_n = 1;
+                }
+            }
+            else
+            {
+                return false;
+            }
+            return true;
+        }
+        uint64 Next(uint64& seed) const
+        {
+            switch (m_type)
+            {
+                case DIST_ZIPFIAN:
+                {
+                    double u = next_double(seed);
+                    double uz = u * m_zetan;
+                    uint64 v;
+                    if (uz < 1.0)
+                    {
+                        v = 0;
+                    }
+                    else if (uz < 1.0 + pow(0.5, m_theta))
+                    {
+                        v = 1;
+                    }
+                    else
+                    {
+                        v = (uint64) (m_n * pow(m_eta * u - m_eta + 1, m_alpha));
+                    }
+                    return scramble(v) % m_n;
+                }
+                case DIST_HOTSPOT:
+                {
+                    if (m_hot_n >= m_n || next_double(seed) < g_options.hot_ops)
+                    {
+                        return next_random(seed) % m_hot_n;
+                    }
+                    return m_hot_n + next_random(seed) % (m_n - m_hot_n);
+                }
+                default:
+                {
+                    return next_random(seed) % m_n;
+                }
+            }
+        }
+};
+
+static KeyChooser g_chooser;
+
+/*
+ * Appends one RESP multi bulk request.
+ */
+class RequestBuilder
+{
+    private:
+        std::string& m_buf;
+        void Bulk(const char* s, size_t len)
+        {
+            char tmp[32];
+            int n = snprintf(tmp, sizeof(tmp), "$%u\r\n", (unsigned) len);
+            m_buf.append(tmp, n);
+            m_buf.append(s, len);
+            m_buf.append("\r\n", 2);
+        }
+    public:
+        RequestBuilder(std::string& buf, int argc) :
+                m_buf(buf)
+        {
+            char tmp[32];
+            int n = snprintf(tmp, sizeof(tmp), "*%d\r\n", argc);
+            m_buf.append(tmp, n);
+        }
+        RequestBuilder& Arg(const std::string& s)
+        {
+            Bulk(s.data(), s.size());
+            return *this;
+        }
+        RequestBuilder& Arg(const char* s)
+        {
+            Bulk(s, strlen(s));
+            return *this;
+        }
+        RequestBuilder& Arg(int64 v)
+        {
+            char tmp[32];
+            int n = snprintf(tmp, sizeof(tmp), "%lld", (long long) v);
+            Bulk(tmp, n);
+            return *this;
+        }
+        RequestBuilder& Arg(double v)
+        {
+            char tmp[64];
+            int n = snprintf(tmp, sizeof(tmp), "%.6f", v);
+            Bulk(tmp, n);
+            return *this;
+        }
+};
+
+/*
+ * A blocking RESP connection, only the reply framing is parsed, reply payloads are skipped.
+ */
+class Connection
+{
+    private:
+        int m_fd;
+        std::string m_rbuf;
+        size_t m_rpos;
+        bool Fill()
+        {
+            if (m_rpos > 0 && m_rpos == m_rbuf.size())
+            {
+                m_rbuf.clear();
+                m_rpos = 0;
+            }
+            char tmp[16 * 1024];
+            ssize_t n = ::read(m_fd, tmp, sizeof(tmp));
+            if (n < 0 && errno == EINTR)
+            {
+                return true;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            m_rbuf.append(tmp, n);
+            return true;
+        }
+        bool ReadLine(std::string& line)
+        {
+            while (true)
+            {
+                size_t pos = m_rbuf.find("\r\n", m_rpos);
+                if (pos != std::string::npos)
+                {
+                    line.assign(m_rbuf, m_rpos, pos - m_rpos);
+                    m_rpos = pos + 2;
+                    return true;
+                }
+                if (!Fill())
+                {
+                    return false;
+                }
+            }
+        }
+        bool Skip(size_t len)
+        {
+            while (m_rbuf.size() - m_rpos < len)
+            {
+                if (!Fill())
+                {
+                    return false;
+                }
+            }
+            m_rpos += len;
+            return true;
+        }
+    public:
+        Connection() :
+                m_fd(-1), m_rpos(0)
+        {
+        }
+        ~Connection()
+        {
+            Close();
+        }
+        void Close()
+        {
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+        }
+        bool Connect(const std::string& host, int port)
+        {
+            struct addrinfo hints, *res = NULL;
+            memset(&hints, 0, sizeof(hints));
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            char portstr[16];
+            snprintf(portstr, sizeof(portstr), "%d", port);
+            if (0 != getaddrinfo(host.c_str(), portstr, &hints, &res))
+            {
+                return false;
+            }
+            for (struct addrinfo* p = res; NULL != p; p = p->ai_next)
+            {
+                m_fd = ::socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+                if (m_fd < 0)
+                {
+                    continue;
+                }
+                if (0 == ::connect(m_fd, p->ai_addr, p->ai_addrlen))
+                {
+                    break;
+                }
+                Close();
+            }
+            freeaddrinfo(res);
+            if (m_fd < 0)
+            {
+                return false;
+            }
+            int yes = 1;
+            setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            return true;
+        }
+        bool Write(const std::string& buf)
+        {
+            size_t written = 0;
+            while (written < buf.size())
+            {
+                ssize_t n = ::write(m_fd, buf.data() + written, buf.size() - written);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    return false;
+                }
+                written += n;
+            }
+            return true;
+        }
+        /*
+         * Reads one complete reply, 'errors' counts the error replies met in it(including nested ones).
+         */
+        bool ReadReply(int64& errors)
+        {
+            std::string line;
+            if (!ReadLine(line) || line.empty())
+            {
+                return false;
+            }
+            int64 len = 0;
+            switch (line[0])
+            {
+                case '-':
+                {
+                    errors++;
+                    return true;
+                }
+                case '+':
+                case ':':
+                {
+                    return true;
+                }
+                case '$':
+                {
+                    if (!string_toint64(line.substr(1), len))
+                    {
+                        return false;
+                    }
+                    return len < 0 || Skip(len + 2);
+                }
+                case '*':
+                {
+                    if (!string_toint64(line.substr(1), len))
+                    {
+                        return false;
+                    }
+                    for (int64 i = 0; i < len; i++)
+                    {
+                        if (!ReadReply(errors))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+                default:
+                {
+                    return false;
+                }
+            }
+        }
+};
+
+static std::string benchmark_key(const char* type, uint64 idx)
+{
+    char tmp[128];
+    snprintf(tmp, sizeof(tmp), "%s%s:%llu", g_options.prefix.c_str(), type, (unsigned long long) idx);
+    return tmp;
+}
+
+class Workload;
+class ClientThread: public Thread
+{
+    private:
+        Workload* m_workload;
+        uint32 m_idx;
+        void Run();
+    public:
+        std::vector<uint32> latencies;
+        int64 errors;
+        int64 ops;
+        bool broken;
+        ClientThread(Workload* workload, uint32 idx) :
+                m_workload(workload), m_idx(idx), errors(0), ops(0), broken(false)
+        {
+        }
+};
+
+/*
+ * One profile per data type, each op is a write with probability '100 - read_ratio' percent, otherwise a read.
+ * Sizes of members/ranges are fixed so that the cost of an op does not drift as the keyspace fills up.
+ */
+class Workload
+{
+    private:
+        std::string m_name;
+        std::string m_value;
+        typedef void (Workload::*OpFunc)(std::string& buf, bool write, uint64& seed);
+        OpFunc m_op;
+
+        void StringOp(std::string& buf, bool write, uint64& seed)
+        {
+            std::string key = benchmark_key("str", g_chooser.Next(seed));
+            if (write)
+                RequestBuilder(buf, 3).Arg("SET").Arg(key).Arg(m_value);
+            else
+                RequestBuilder(buf, 2).Arg("GET").Arg(key);
+        }
+        void HashOp(std::string& buf, bool write, uint64& seed)
+        {
+            std::string key = benchmark_key("hash", g_chooser.Next(seed) / 16);
+            int64 field = next_random(seed) % 16;
+            if (write)
+                RequestBuilder(buf, 4).Arg("HSET").Arg(key).Arg(field).Arg(m_value);
+            else
+                RequestBuilder(buf, 3).Arg("HGET").Arg(key).Arg(field);
+        }
+        void ListOp(std::string& buf, bool write, uint64& seed)
+        {
+            std::string key = benchmark_key("list", g_chooser.Next(seed) / 16);
+            if (write)
+            {
+                RequestBuilder(buf, 3).Arg("LPUSH").Arg(key).Arg(m_value);
+            }
+            else
+            {
+                RequestBuilder(buf, 4).Arg("LRANGE").Arg(key).Arg((int64) 0).Arg((int64) 9);
+            }
+        }
+        void ZSetOp(std::string& buf, bool write, uint64& seed)
+        {
+            std::string key = benchmark_key("zset", g_chooser.Next(seed) / 128);
+            if (write)
+            {
+                int64 member = next_random(seed) % 1024;
+                RequestBuilder(buf, 4).Arg("ZADD").Arg(key).Arg((int64) (next_random(seed) % 1000000)).Arg(member);
+            }
+            else
+            {
+                RequestBuilder(buf, 4).Arg("ZREVRANGE").Arg(key).Arg((int64) 0).Arg((int64) 9);
+            }
+        }
+        void BitsetOp(std::string& buf, bool write, uint64& seed)
+        {
+            std::string key = benchmark_key("bit", g_chooser.Next(seed) / 1024);
+            if (write)
+            {
+                int64 offset = next_random(seed) % (1024 * 1024);
+                RequestBuilder(buf, 4).Arg("SETBIT").Arg(key).Arg(offset).Arg((int64) (next_random(seed) & 1));
+            }
+            else
+            {
+                RequestBuilder(buf, 2).Arg("BITCOUNT").Arg(key);
+            }
+        }
+        void HLLOp(std::string& buf, bool write, uint64& seed)
+        {
+            std::string key = benchmark_key("hll", g_chooser.Next(seed) / 1024);
+            if (write)
+                RequestBuilder(buf, 3).Arg("PFADD").Arg(key).Arg((int64) next_random(seed));
+            else
+                RequestBuilder(buf, 2).Arg("PFCOUNT").Arg(key);
+        }
+        void GeoOp(std::string& buf, bool write, uint64& seed)
+        {
+            std::string key = benchmark_key("geo", g_chooser.Next(seed) / 1024);
+            double lon = next_double(seed) * 2 - 1 + 116.0;
+            double lat = next_double(seed) * 2 - 1 + 39.0;
+            if (write)
+            {
+                RequestBuilder(buf, 5).Arg("GEOADD").Arg(key).Arg(lon).Arg(lat).Arg((int64) (next_random(seed) % 4096));
+            }
+            else
+            {
+                RequestBuilder(buf, 8).Arg("GEORADIUS").Arg(key).Arg(lon).Arg(lat).Arg((int64) 10).Arg("km").Arg("COUNT").Arg((int64) 10);
+            }
+        }
+        static void PrintLatency(const char* name, std::vector<uint32>& lats, double percentile)
+        {
+            size_t idx = (size_t) (lats.size() * percentile / 100);
+            if (idx >= lats.size())
+            {
+                idx = lats.size() - 1;
+            }
+            printf(",\"%s\":%u", name, lats[idx]);
+        }
+    public:
+        Workload(const std::string& name) :
+                m_name(name), m_value(g_options.value_size, 'x'), m_op(NULL)
+        {
+            for (size_t i = 0; i < m_value.size(); i++)
+            {
+                m_value[i] = 'a' + i % 26;
+            }
+            if (name == "string")
+                m_op = &Workload::StringOp;
+            else if (name == "hash")
+                m_op = &Workload::HashOp;
+            else if (name == "list")
+                m_op = &Workload::ListOp;
+            else if (name == "zset")
+                m_op = &Workload::ZSetOp;
+            else if (name == "bitset")
+                m_op = &Workload::BitsetOp;
+            else if (name == "hll")
+                m_op = &Workload::HLLOp;
+            else if (name == "geo")
+                m_op = &Workload::GeoOp;
+        }
+        bool Valid()
+        {
+            return NULL != m_op;
+        }
+        /*
+         * every client sends 'requests / clients' ops in batches of 'pipeline' requests,
+         * the round trip of a batch is recorded as the latency of each request in it.
+         */
+        void RunClient(ClientThread* client, uint32 cidx)
+        {
+            Connection conn;
+            if (!conn.Connect(g_options.host, g_options.port))
+            {
+                client->broken = true;
+                return;
+            }
+            uint64 per_client = g_options.requests / g_options.clients;
+            uint64 seed = 0x9E3779B97F4A7C15ULL * (cidx + 1) ^ (uint64) g_options.seed;
+            if (0 == seed)
+            {
+                seed = 1;
+            }
+            client->latencies.reserve(per_client);
+            std::string buf;
+            uint64 sent = 0;
+            while (sent < per_client)
+            {
+                uint64 batch = std::min((uint64) g_options.pipeline, per_client - sent);
+                buf.clear();
+                for (uint64 i = 0; i < batch; i++)
+                {
+                    bool write = (int64) (next_random(seed) % 100) >= g_options.read_ratio;
+                    (this->*m_op)(buf, write, seed);
+                }
+                uint64 start = get_current_epoch_micros();
+                if (!conn.Write(buf))
+                {
+                    client->broken = true;
+                    return;
+                }
+                for (uint64 i = 0; i < batch; i++)
+                {
+                    if (!conn.ReadReply(client->errors))
+                    {
+                        client->broken = true;
+                        return;
+                    }
+                }
+                uint32 cost = (uint32) (get_current_epoch_micros() - start);
+                client->latencies.insert(client->latencies.end(), batch, cost);
+                client->ops += batch;
+                sent += batch;
+            }
+        }
+        bool Run()
+        {
+            std::vector<ClientThread*> clients;
+            uint64 start = get_current_epoch_micros();
+            for (int64 i = 0; i < g_options.clients; i++)
+            {
+                ClientThread* t = NULL;
+                NEW(t, ClientThread(this, i));
+                t->Start();
+                clients.push_back(t);
+            }
+            std::vector<uint32> lats;
+            int64 errors = 0, broken = 0;
+            for (size_t i = 0; i < clients.size(); i++)
+            {
+                clients[i]->Join();
+                lats.insert(lats.end(), clients[i]->latencies.begin(), clients[i]->latencies.end());
+                errors += clients[i]->errors;
+                broken += clients[i]->broken ? 1 : 0;
+                DELETE(clients[i]);
+            }
+            uint64 cost = get_current_epoch_micros() - start;
+            if (lats.empty())
+            {
+                fprintf(stderr, "%s: no op executed, is the server at %s:%lld reachable?\n", m_name.c_str(), g_options.host.c_str(),
+                        (long long) g_options.port);
+                return false;
+            }
+            std::sort(lats.begin(), lats.end());
+            uint64 total = 0;
+            for (size_t i = 0; i < lats.size(); i++)
+            {
+                total += lats[i];
+            }
+            printf("{\"workload\":\"%s\",\"dist\":\"%s\",\"clients\":%lld,\"pipeline\":%lld,\"value_size\":%lld,\"keyspace\":%lld,"
+                    "\"read_ratio\":%lld,\"seed\":%lld,\"ops\":%llu,\"errors\":%lld,\"broken_clients\":%lld,\"elapsed_ms\":%.3f,"
+                    "\"ops_per_sec\":%.1f,\"avg_us\":%.2f", m_name.c_str(), g_options.dist.c_str(), (long long) g_options.clients,
+                    (long long) g_options.pipeline, (long long) g_options.value_size, (long long) g_options.keyspace,
+                    (long long) g_options.read_ratio, (long long) g_options.seed, (unsigned long long) lats.size(), (long long) errors,
+                    (long long) broken, cost / 1000.0, lats.size() * 1000000.0 / (cost > 0 ? cost : 1), (double) total / lats.size());
+            PrintLatency("p50_us", lats, 50);
+            PrintLatency("p95_us", lats, 95);
+            PrintLatency("p99_us", lats, 99);
+            PrintLatency("p999_us", lats, 99.9);
+            printf(",\"max_us\":%u}\n", lats[lats.size() - 1]);
+            fflush(stdout);
+            return 0 == broken;
+        }
+};
+
+void ClientThread::Run()
+{
+    m_workload->RunClient(this, m_idx);
+}
+
+static bool flush_keys()
+{
+    Connection conn;
+    int64 errors = 0;
+    std::string buf;
+    RequestBuilder(buf, 1).Arg("FLUSHALL");
+    return conn.Connect(g_options.host, g_options.port) && conn.Write(buf) && conn.ReadReply(errors) && 0 == errors;
+}
+
+void usage()
+{
+    BenchmarkOptions defaults;
+    fprintf(stderr, "Usage: ./ardb-benchmark [--option=value]...\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "       --host=<server host, default %s>\n", defaults.host.c_str());
+    fprintf(stderr, "       --port=<server port, default %lld>\n", (long long) defaults.port);
+    fprintf(stderr, "       --workloads=%s\n", defaults.workloads.c_str());
+    fprintf(stderr, "       --dist=<uniform|zipfian|hotspot, default uniform>\n");
+    fprintf(stderr, "       --clients=<parallel connections, one thread each, default 50>\n");
+    fprintf(stderr, "       --pipeline=<requests sent per round trip, default 1>\n");
+    fprintf(stderr, "       --requests=<requests of each workload, default 100000>\n");
+    fprintf(stderr, "       --value_size=<bytes of each written value, default 100>\n");
+    fprintf(stderr, "       --keyspace=<distinct key indexes, default 100000>\n");
+    fprintf(stderr, "       --read_ratio=<percent of read requests, default 50>\n");
+    fprintf(stderr, "       --seed=<seed of the op sequence, default 1>\n");
+    fprintf(stderr, "       --zipf_theta=<skew of zipfian, default 0.99>\n");
+    fprintf(stderr, "       --hot_keys=<fraction of hot keys in hotspot, default 0.2>\n");
+    fprintf(stderr, "       --hot_ops=<fraction of requests hitting hot keys in hotspot, default 0.8>\n");
+    fprintf(stderr, "       --prefix=<prefix of generated keys, default %s>\n", defaults.prefix.c_str());
+    fprintf(stderr, "       --flush=<yes|no, FLUSHALL before each workload, default no>\n");
+    fprintf(stderr, "Examples:\n");
+    fprintf(stderr, "       ./ardb-benchmark --port=16379 --workloads=string,zset --dist=zipfian --clients=32 --pipeline=16\n");
+    exit(1);
+}
+
+static bool parse_option(const char* arg)
+{
+    const char* eq = strchr(arg, '=');
+    if (strncmp(arg, "--", 2) != 0 || NULL == eq)
+    {
+        return false;
+    }
+    std::string name(arg + 2, eq - arg - 2);
+    std::string value(eq + 1);
+    int64 n = 0;
+    double d = 0;
+    if (name == "host")
+        g_options.host = value;
+    else if (name == "workloads")
+        g_options.workloads = value;
+    else if (name == "dist")
+        g_options.dist = value;
+    else if (name == "prefix")
+        g_options.prefix = value;
+    else if (name == "flush")
+    {
+        if (value != "yes" && value != "no")
+        {
+            return false;
+        }
+        g_options.flush = value == "yes";
+    }
+    else if (name == "zipf_theta" || name == "hot_keys" || name == "hot_ops")
+    {
+        if (!string_todouble(value, d) || d <= 0 || d >= 1)
+        {
+            return false;
+        }
+        if (name == "zipf_theta")
+            g_options.zipf_theta = d;
+        else if (name == "hot_keys")
+            g_options.hot_keys = d;
+        else
+            g_options.hot_ops = d;
+    }
+    else if (name == "read_ratio")
+    {
+        if (!string_toint64(value, n) || n < 0 || n > 100)
+        {
+            return false;
+        }
+        g_options.read_ratio = n;
+    }
+    else
+    {
+        if (!string_toint64(value, n) || n <= 0)
+        {
+            return false;
+        }
+        if (name == "port")
+            g_options.port = n;
+        else if (name == "clients")
+            g_options.clients = n;
+        else if (name == "pipeline")
+            g_options.pipeline = n;
+        else if (name == "requests")
+            g_options.requests = n;
+        else if (name == "value_size")
+            g_options.value_size = n;
+        else if (name == "keyspace")
+            g_options.keyspace = n;
+        else if (name == "seed")
+            g_options.seed = n;
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
+        {
+            usage();
+        }
+        if (!parse_option(argv[i]))
+        {
+            fprintf(stderr, "Invalid option:%s\n", argv[i]);
+            usage();
+        }
+    }
+    if (g_options.requests < g_options.clients)
+    {
+        g_options.clients = g_options.requests;
+    }
+    if (!g_chooser.Init(g_options.dist, g_options.keyspace))
+    {
+        fprintf(stderr, "Unknown key distribution:%s\n", g_options.dist.c_str());
+        usage();
+    }
+    int ret = 0;
+    std::vector<std::string> names = split_string(g_options.workloads, ",");
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        Workload workload(trim_string(names[i]));
+        if (!workload.Valid())
+        {
+            fprintf(stderr, "Unknown workload:%s\n", names[i].c_str());
+            ret = 1;
+            continue;
+        }
+        if (g_options.flush && !flush_keys())
+        {
+            fprintf(stderr, "Failed to flush server before workload:%s\n", names[i].c_str());
+            return 1;
+        }
+        if (!workload.Run())
+        {
+            ret = 1;
+        }
+    }
+    return ret;
+}
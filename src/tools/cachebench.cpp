@@ -0,0 +1,387 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include "common/cache/ConcurrentKeyCache.h"
+#include "thread/thread.hpp"
+#include "thread/lock_guard.hpp"
+#include "util/time_helper.hpp"
+#include "util/string_helper.hpp"
+
+/*
+ * Hammers ConcurrentKeyCache in process from N threads, with the op mix of a server whose keyspace
+ * cache sees writes(Put), deletes, EXPIREs & occasional KEYS(Get with a pattern).
+ * Every op reports its latency & the time the shard lock(s) were held, so lock waits = latency - hold.
+ */
+using namespace ardb;
+
+struct CacheBenchOptions
+{
+        int64 threads;
+        int64 num;
+        int64 keyspace;
+        int64 preload;
+        int64 put_ratio;
+        int64 delete_ratio;
+        int64 expire_ratio;
+        int64 keys_every;
+        int64 seed;
+        CacheBenchOptions() :
+                threads(8), num(1000000), keyspace(1000000), preload(500000), put_ratio(60), delete_ratio(20), expire_ratio(20), keys_every(
+                        10000), seed(1)
+        {
+        }
+};
+
+static CacheBenchOptions g_options;
+
+enum CacheOp
+{
+    OP_PUT = 0, OP_DELETE, OP_EXPIRE, OP_KEYS, OP_MAX
+};
+static const char* kOpNames[] = { "put", "delete", "expire", "keys" };
+static const char* kPatterns[] = { "user:*:profile", "session:*", "*:cart:*", "order:2016*" };
+
+static inline uint64 monotonic_nanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64 next_random(uint64& seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+/*
+ * Key shapes seen in production keyspaces: short prefixes with ids, hex session tokens, dated ids & tenant scoped keys.
+ * The shape only depends on 'idx', so a delete or expire of an index hits the key a put created.
+ */
+static void cache_key(uint64 idx, std::string& key)
+{
+    char tmp[128];
+    switch (idx % 4)
+    {
+        case 0:
+        {
+            snprintf(tmp, sizeof(tmp), "user:%llu:profile", (unsigned long long) idx);
+            break;
+        }
+        case 1:
+        {
+            uint64 h = idx * 0x9E3779B97F4A7C15ULL;
+            snprintf(tmp, sizeof(tmp), "session:%016llx%016llx", (unsigned long long) h, (unsigned long long) (h ^ (h >> 29)));
+            break;
+        }
+        case 2:
+        {
+            snprintf(tmp, sizeof(tmp), "order:2016%02llu%02llu:%llu", (unsigned long long) (idx % 12 + 1),
+                    (unsigned long long) (idx % 28 + 1), (unsigned long long) idx);
+            break;
+        }
+        default:
+        {
+            snprintf(tmp, sizeof(tmp), "tenant%llu:cart:%llu", (unsigned long long) (idx % 64), (unsigned long long) idx);
+            break;
+        }
+    }
+    key = tmp;
+}
+
+/*
+ * Same ops as ConcurrentKeyCache, with the time spent inside the shard locks measured.
+ */
+class TimedKeyCache: public ConcurrentKeyCache
+{
+    public:
+        uint64 TimedPut(const CacheEntry& entry)
+        {
+            Shard& shard = shardOf(entry.key);
+            WriteLockGuard<SpinRWLock> guard(shard.lock);
+            uint64 start = monotonic_nanos();
+            shard.cache.Put(entry);
+            return monotonic_nanos() - start;
+        }
+        uint64 TimedDelete(const KeyType& key)
+        {
+            Shard& shard = shardOf(key);
+            WriteLockGuard<SpinRWLock> guard(shard.lock);
+            uint64 start = monotonic_nanos();
+            shard.cache.Delete(key);
+            return monotonic_nanos() - start;
+        }
+        uint64 TimedExpire(const KeyType& key, TtlType ttl)
+        {
+            Shard& shard = shardOf(key);
+            WriteLockGuard<SpinRWLock> guard(shard.lock);
+            uint64 start = monotonic_nanos();
+            shard.cache.Expire(key, ttl);
+            return monotonic_nanos() - start;
+        }
+        /*
+         * returns the longest hold of one shard lock, that is what a writer of the shard may wait for
+         */
+        uint64 TimedGet(const KeyType& pattern, size_t& count)
+        {
+            uint64 max_hold = 0;
+            count = 0;
+            for (uint32_t i = 0; i < kShards; i++)
+            {
+                ReadLockGuard<SpinRWLock> guard(shards[i].lock);
+                uint64 start = monotonic_nanos();
+                count += shards[i].cache.Get(pattern).size();
+                max_hold = std::max(max_hold, monotonic_nanos() - start);
+            }
+            return max_hold;
+        }
+};
+
+static TimedKeyCache* g_cache = NULL;
+
+struct OpStats
+{
+        std::vector<uint32> latencies;
+        std::vector<uint32> holds;
+};
+
+class CacheBenchThread: public Thread
+{
+    private:
+        uint32 m_idx;
+        void Run()
+        {
+            uint64 seed = 0x9E3779B97F4A7C15ULL * (m_idx + 1) ^ (uint64) g_options.seed;
+            std::string key;
+            for (int64 i = 0; i < g_options.num; i++)
+            {
+                int op = OP_KEYS;
+                if ((i + 1) % g_options.keys_every != 0)
+                {
+                    int64 r = next_random(seed) % (g_options.put_ratio + g_options.delete_ratio + g_options.expire_ratio);
+                    op = r < g_options.put_ratio ? OP_PUT : (r < g_options.put_ratio + g_options.delete_ratio ? OP_DELETE : OP_EXPIRE);
+                }
+                uint64 hold = 0;
+                uint64 start = monotonic_nanos();
+                switch (op)
+                {
+                    case OP_PUT:
+                    {
+                        cache_key(next_random(seed) % g_options.keyspace, key);
+                        hold = g_cache->TimedPut(KeyCache::CacheEntry(key));
+                        break;
+                    }
+                    case OP_DELETE:
+                    {
+                        cache_key(next_random(seed) % g_options.keyspace, key);
+                        hold = g_cache->TimedDelete(key);
+                        break;
+                    }
+                    case OP_EXPIRE:
+                    {
+                        cache_key(next_random(seed) % g_options.keyspace, key);
+                        hold = g_cache->TimedExpire(key, get_current_epoch_millis() + 60000 + next_random(seed) % 3600000);
+                        break;
+                    }
+                    default:
+                    {
+                        size_t count = 0;
+                        hold = g_cache->TimedGet(kPatterns[next_random(seed) % arraysize(kPatterns)], count);
+                        break;
+                    }
+                }
+                uint64 cost = monotonic_nanos() - start;
+                stats[op].latencies.push_back((uint32) std::min(cost, (uint64) UINT32_MAX));
+                stats[op].holds.push_back((uint32) std::min(hold, (uint64) UINT32_MAX));
+            }
+        }
+    public:
+        OpStats stats[OP_MAX];
+        CacheBenchThread(uint32 idx) :
+                m_idx(idx)
+        {
+        }
+};
+
+static uint32 percentile(std::vector<uint32>& v, double p)
+{
+    size_t idx = (size_t) (v.size() * p / 100);
+    return v[idx >= v.size() ? v.size() - 1 : idx];
+}
+
+static double average(std::vector<uint32>& v)
+{
+    uint64 total = 0;
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        total += v[i];
+    }
+    return (double) total / v.size();
+}
+
+void usage()
+{
+    fprintf(stderr, "Usage: ./ardb-cachebench [--option=value]...\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "       --threads=<threads hitting the cache, default 8>\n");
+    fprintf(stderr, "       --num=<ops of each thread, default 1000000>\n");
+    fprintf(stderr, "       --keyspace=<distinct keys, default 1000000>\n");
+    fprintf(stderr, "       --preload=<keys put before the timed run, default 500000>\n");
+    fprintf(stderr, "       --put_ratio=<weight of put, default 60>\n");
+    fprintf(stderr, "       --delete_ratio=<weight of delete, default 20>\n");
+    fprintf(stderr, "       --expire_ratio=<weight of expire, default 20>\n");
+    fprintf(stderr, "       --keys_every=<one KEYS pattern lookup every n ops of a thread, default 10000>\n");
+    fprintf(stderr, "       --seed=<seed of the op sequence, default 1>\n");
+    exit(1);
+}
+
+static bool parse_option(const char* arg)
+{
+    const char* eq = strchr(arg, '=');
+    if (strncmp(arg, "--", 2) != 0 || NULL == eq)
+    {
+        return false;
+    }
+    std::string name(arg + 2, eq - arg - 2);
+    int64 n = 0;
+    if (!string_toint64(eq + 1, n) || n < 0)
+    {
+        return false;
+    }
+    if (name == "threads")
+        g_options.threads = n;
+    else if (name == "num")
+        g_options.num = n;
+    else if (name == "keyspace")
+        g_options.keyspace = n;
+    else if (name == "preload")
+        g_options.preload = n;
+    else if (name == "put_ratio")
+        g_options.put_ratio = n;
+    else if (name == "delete_ratio")
+        g_options.delete_ratio = n;
+    else if (name == "expire_ratio")
+        g_options.expire_ratio = n;
+    else if (name == "keys_every")
+        g_options.keys_every = n;
+    else if (name == "seed")
+        g_options.seed = n;
+    else
+        return false;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
+        {
+            usage();
+        }
+        if (!parse_option(argv[i]))
+        {
+            fprintf(stderr, "Invalid option:%s\n", argv[i]);
+            usage();
+        }
+    }
+    if (g_options.threads <= 0 || g_options.keyspace <= 0 || g_options.keys_every <= 0
+            || g_options.put_ratio + g_options.delete_ratio + g_options.expire_ratio <= 0)
+    {
+        usage();
+    }
+    NEW(g_cache, TimedKeyCache);
+    int64 empty_memory = g_cache->Memory();
+    std::string key;
+    uint64 start = monotonic_nanos();
+    for (int64 i = 0; i < g_options.preload; i++)
+    {
+        cache_key(i % g_options.keyspace, key);
+        g_cache->Put(KeyCache::CacheEntry(key));
+    }
+    uint64 preload_cost = monotonic_nanos() - start;
+    size_t preload_keys = g_cache->size();
+    int64 preload_memory = g_cache->Memory();
+    printf("{\"phase\":\"preload\",\"keys\":%llu,\"ops_per_sec\":%.1f,\"memory\":%lld,\"memory_per_key\":%.1f}\n",
+            (unsigned long long) preload_keys, g_options.preload * 1e9 / (preload_cost > 0 ? preload_cost : 1), (long long) preload_memory,
+            preload_keys > 0 ? (double) (preload_memory - empty_memory) / preload_keys : 0.0);
+
+    std::vector<CacheBenchThread*> threads;
+    start = monotonic_nanos();
+    for (int64 i = 0; i < g_options.threads; i++)
+    {
+        CacheBenchThread* t = NULL;
+        NEW(t, CacheBenchThread(i));
+        t->Start();
+        threads.push_back(t);
+    }
+    OpStats all[OP_MAX];
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i]->Join();
+        for (int op = 0; op < OP_MAX; op++)
+        {
+            OpStats& s = threads[i]->stats[op];
+            all[op].latencies.insert(all[op].latencies.end(), s.latencies.begin(), s.latencies.end());
+            all[op].holds.insert(all[op].holds.end(), s.holds.begin(), s.holds.end());
+        }
+        DELETE(threads[i]);
+    }
+    uint64 cost = monotonic_nanos() - start;
+    uint64 total_ops = 0;
+    for (int op = 0; op < OP_MAX; op++)
+    {
+        OpStats& s = all[op];
+        if (s.latencies.empty())
+        {
+            continue;
+        }
+        total_ops += s.latencies.size();
+        std::sort(s.latencies.begin(), s.latencies.end());
+        std::sort(s.holds.begin(), s.holds.end());
+        printf("{\"phase\":\"run\",\"op\":\"%s\",\"threads\":%lld,\"ops\":%llu,\"ops_per_sec\":%.1f,\"avg_ns\":%.1f,\"p50_ns\":%u,"
+                "\"p99_ns\":%u,\"max_ns\":%u,\"hold_avg_ns\":%.1f,\"hold_p99_ns\":%u,\"hold_max_ns\":%u}\n", kOpNames[op],
+                (long long) g_options.threads, (unsigned long long) s.latencies.size(), s.latencies.size() * 1e9 / (cost > 0 ? cost : 1),
+                average(s.latencies), percentile(s.latencies, 50), percentile(s.latencies, 99), s.latencies.back(), average(s.holds),
+                percentile(s.holds, 99), s.holds.back());
+    }
+    size_t keys = g_cache->size();
+    int64 memory = g_cache->Memory();
+    printf("{\"phase\":\"total\",\"threads\":%lld,\"ops\":%llu,\"ops_per_sec\":%.1f,\"keys\":%llu,\"memory\":%lld,\"memory_per_key\":%.1f}\n",
+            (long long) g_options.threads, (unsigned long long) total_ops, total_ops * 1e9 / (cost > 0 ? cost : 1), (unsigned long long) keys,
+            (long long) memory, keys > 0 ? (double) (memory - empty_memory) / keys : 0.0);
+    DELETE(g_cache);
+    return 0;
+}
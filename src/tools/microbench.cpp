@@ -0,0 +1,561 @@
+/*
+ *Copyright (c) 2013-2016, yinqiwen <yinqiwen@gmail.com>
+ *All rights reserved.
+ *
+ *Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Redis nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ *THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ *BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <new>
+#include <string>
+#include <vector>
+#include <map>
+#include "common.hpp"
+#include "db/codec.hpp"
+#include "buffer/buffer.hpp"
+#include "buffer/struct_codec_macros.hpp"
+#include "channel/all_includes.hpp"
+#include "util/time_helper.hpp"
+#include "util/string_helper.hpp"
+#ifdef USE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
+/*
+ * Microbenchmarks of the codec, buffer & protocol hot paths, in the spirit of Google Benchmark:
+ * every case runs in a loop until '--min_time' elapsed, and reports ns/op & allocations/op.
+ * Allocations are the calls of operator new issued by the case(std containers, Data clones, replies),
+ * bytes/op additionally covers raw malloc(Buffer growth) when built with jemalloc.
+ */
+using namespace ardb;
+using namespace ardb::codec;
+
+static volatile uint64 g_new_calls = 0;
+static bool g_count_allocs = false;
+
+void* operator new(size_t size)
+{
+    if (g_count_allocs)
+    {
+        g_new_calls++;
+    }
+    void* p = malloc(size > 0 ? size : 1);
+    if (NULL == p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+void operator delete(void* p) throw ()
+{
+    free(p);
+}
+void operator delete[](void* p) throw ()
+{
+    free(p);
+}
+
+static uint64 thread_allocated_bytes()
+{
+#ifdef USE_JEMALLOC
+    uint64_t v = 0;
+    size_t sz = sizeof(v);
+    if (0 == mallctl("thread.allocated", &v, &sz, NULL, 0))
+    {
+        return v;
+    }
+#endif
+    return 0;
+}
+
+static uint64 monotonic_nanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+template<typename T>
+static inline void do_not_optimize(T& v)
+{
+    asm volatile("" : : "r"(&v) : "memory");
+}
+
+struct MicroBenchOptions
+{
+        std::string filter;
+        int64 min_time;
+        bool json;
+        MicroBenchOptions() :
+                min_time(500), json(false)
+        {
+        }
+};
+static MicroBenchOptions g_options;
+
+/*
+ * Representative inputs shared by the cases, built once before any case runs.
+ */
+struct MicroBenchInputs
+{
+        Data ns;
+        std::string value;
+        Buffer encoded_key;
+        Buffer encoded_value;
+        Buffer encoded_meta;
+        std::string set_request;
+        std::string pipeline_request;
+        std::string inline_request;
+        RedisReply array_reply;
+};
+static MicroBenchInputs* g_inputs = NULL;
+
+struct CodecRecord
+{
+        int64 id;
+        std::string name;
+        std::vector<int32> scores;
+        std::map<std::string, int64> attrs;
+        ENCODE_DEFINE(id, name, scores, attrs)
+        DECODE_DEFINE(id, name, scores, attrs)
+};
+
+static void bm_key_encode_string(uint64 iters)
+{
+    Buffer buf;
+    KeyObject key(g_inputs->ns, KEY_STRING, "user:1000:profile");
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        Slice s = key.Encode(buf, false, true);
+        do_not_optimize(s);
+    }
+}
+
+static void bm_key_encode_hash_field(uint64 iters)
+{
+    Buffer buf;
+    KeyObject key(g_inputs->ns, KEY_HASH_FIELD, "user:1000:profile");
+    key.SetHashField("last_login_time");
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        Slice s = key.Encode(buf, false, true);
+        do_not_optimize(s);
+    }
+}
+
+static void bm_key_encode_zset_sort(uint64 iters)
+{
+    Buffer buf;
+    KeyObject key(g_inputs->ns, KEY_ZSET_SORT, "leaderboard:2016");
+    key.SetMember(Data(12345.5), 0);
+    key.SetMember(Data::WrapCStr("player:123456"), 1);
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        Slice s = key.Encode(buf, false, true);
+        do_not_optimize(s);
+    }
+}
+
+static void bm_key_decode_hash_field(uint64 iters)
+{
+    for (uint64 i = 0; i < iters; i++)
+    {
+        Buffer& buf = g_inputs->encoded_key;
+        buf.SetReadIndex(0);
+        KeyObject key;
+        bool ok = key.Decode(buf, false, true);
+        do_not_optimize(ok);
+    }
+}
+
+static void bm_value_encode_string(uint64 iters)
+{
+    Buffer buf;
+    ValueObject v;
+    v.SetType(KEY_STRING);
+    v.GetStringValue().SetString(g_inputs->value, false);
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        Slice s = v.Encode(buf);
+        do_not_optimize(s);
+    }
+}
+
+static void bm_value_decode_string(uint64 iters)
+{
+    for (uint64 i = 0; i < iters; i++)
+    {
+        Buffer& buf = g_inputs->encoded_value;
+        buf.SetReadIndex(0);
+        ValueObject v;
+        bool ok = v.Decode(buf, false);
+        do_not_optimize(ok);
+    }
+}
+
+static void bm_value_encode_meta(uint64 iters)
+{
+    Buffer buf;
+    ValueObject meta;
+    meta.SetType(KEY_HASH);
+    meta.SetObjectLen(100);
+    meta.SetTTL(get_current_epoch_millis() + 3600000);
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        Slice s = meta.Encode(buf);
+        do_not_optimize(s);
+    }
+}
+
+static void bm_value_decode_meta(uint64 iters)
+{
+    for (uint64 i = 0; i < iters; i++)
+    {
+        Buffer& buf = g_inputs->encoded_meta;
+        buf.SetReadIndex(0);
+        ValueObject meta;
+        bool ok = meta.DecodeMeta(buf);
+        do_not_optimize(ok);
+    }
+}
+
+static void decode_requests(const std::string& content, uint64 iters)
+{
+    RedisCommandFrame frame;
+    for (uint64 i = 0; i < iters; i++)
+    {
+        Buffer buf;
+        buf.WrapReadableContent(content.data(), content.size());
+        while (buf.Readable())
+        {
+            frame.Clear();
+            if (!RedisCommandDecoder::Decode(NULL, buf, frame))
+            {
+                abort();
+            }
+            do_not_optimize(frame);
+        }
+    }
+}
+
+static void bm_command_decode_set(uint64 iters)
+{
+    decode_requests(g_inputs->set_request, iters);
+}
+
+static void bm_command_decode_pipeline16(uint64 iters)
+{
+    decode_requests(g_inputs->pipeline_request, iters);
+}
+
+static void bm_command_decode_inline(uint64 iters)
+{
+    decode_requests(g_inputs->inline_request, iters);
+}
+
+static void bm_reply_encode_status(uint64 iters)
+{
+    Buffer buf;
+    RedisReply reply;
+    reply.SetStatusCode(STATUS_OK);
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        RedisReplyEncoder::Encode(buf, reply);
+        do_not_optimize(buf);
+    }
+}
+
+static void bm_reply_encode_bulk(uint64 iters)
+{
+    Buffer buf;
+    RedisReply reply;
+    reply.SetString(g_inputs->value);
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        RedisReplyEncoder::Encode(buf, reply);
+        do_not_optimize(buf);
+    }
+}
+
+static void bm_reply_encode_array100(uint64 iters)
+{
+    Buffer buf;
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        RedisReplyEncoder::Encode(buf, g_inputs->array_reply);
+        do_not_optimize(buf);
+    }
+}
+
+static void bm_reply_build_array100(uint64 iters)
+{
+    for (uint64 i = 0; i < iters; i++)
+    {
+        RedisReply reply;
+        reply.ReserveMember(0);
+        for (int j = 0; j < 100; j++)
+        {
+            reply.AddMember().SetString(g_inputs->value);
+        }
+        do_not_optimize(reply);
+    }
+}
+
+static void bm_buffer_grow_4k(uint64 iters)
+{
+    char chunk[64];
+    memset(chunk, 'x', sizeof(chunk));
+    for (uint64 i = 0; i < iters; i++)
+    {
+        Buffer buf;
+        for (int j = 0; j < 4096 / 64; j++)
+        {
+            buf.Write(chunk, sizeof(chunk));
+        }
+        do_not_optimize(buf);
+    }
+}
+
+static void bm_buffer_reuse_4k(uint64 iters)
+{
+    char chunk[64];
+    memset(chunk, 'x', sizeof(chunk));
+    Buffer buf;
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        for (int j = 0; j < 4096 / 64; j++)
+        {
+            buf.Write(chunk, sizeof(chunk));
+        }
+        do_not_optimize(buf);
+    }
+}
+
+static void bm_struct_codec(uint64 iters)
+{
+    CodecRecord record;
+    record.id = 1000;
+    record.name = "user:1000:profile";
+    for (int i = 0; i < 16; i++)
+    {
+        record.scores.push_back(i * 7);
+    }
+    record.attrs["age"] = 30;
+    record.attrs["level"] = 12;
+    record.attrs["score"] = 123456;
+    Buffer buf;
+    for (uint64 i = 0; i < iters; i++)
+    {
+        buf.Clear();
+        record.Encode(buf);
+        CodecRecord decoded;
+        bool ok = decoded.Decode(buf);
+        do_not_optimize(ok);
+    }
+}
+
+typedef void MicroBenchFunc(uint64 iters);
+struct MicroBenchCase
+{
+        const char* name;
+        MicroBenchFunc* func;
+};
+
+static MicroBenchCase g_cases[] = {
+    { "key_encode_string", bm_key_encode_string },
+    { "key_encode_hash_field", bm_key_encode_hash_field },
+    { "key_encode_zset_sort", bm_key_encode_zset_sort },
+    { "key_decode_hash_field", bm_key_decode_hash_field },
+    { "value_encode_string", bm_value_encode_string },
+    { "value_decode_string", bm_value_decode_string },
+    { "value_encode_meta", bm_value_encode_meta },
+    { "value_decode_meta", bm_value_decode_meta },
+    { "command_decode_set", bm_command_decode_set },
+    { "command_decode_pipeline16", bm_command_decode_pipeline16 },
+    { "command_decode_inline", bm_command_decode_inline },
+    { "reply_encode_status", bm_reply_encode_status },
+    { "reply_encode_bulk", bm_reply_encode_bulk },
+    { "reply_encode_array100", bm_reply_encode_array100 },
+    { "reply_build_array100", bm_reply_build_array100 },
+    { "buffer_grow_4k", bm_buffer_grow_4k },
+    { "buffer_reuse_4k", bm_buffer_reuse_4k },
+    { "struct_codec_roundtrip", bm_struct_codec },
+};
+
+static void init_inputs()
+{
+    NEW(g_inputs, MicroBenchInputs);
+    g_inputs->ns.SetString("0", true);
+    g_inputs->value.assign(100, 'v');
+    KeyObject key(g_inputs->ns, KEY_HASH_FIELD, "user:1000:profile");
+    key.SetHashField("last_login_time");
+    key.Encode(g_inputs->encoded_key, false, true);
+    ValueObject v;
+    v.SetType(KEY_STRING);
+    v.GetStringValue().SetString(g_inputs->value, false);
+    v.Encode(g_inputs->encoded_value);
+    ValueObject meta;
+    meta.SetType(KEY_HASH);
+    meta.SetObjectLen(100);
+    meta.SetTTL(get_current_epoch_millis() + 3600000);
+    meta.Encode(g_inputs->encoded_meta);
+    g_inputs->set_request = "*3\r\n$3\r\nSET\r\n$17\r\nuser:1000:profile\r\n$100\r\n" + g_inputs->value + "\r\n";
+    for (int i = 0; i < 16; i++)
+    {
+        g_inputs->pipeline_request.append("*2\r\n$3\r\nGET\r\n$17\r\nuser:1000:profile\r\n");
+    }
+    g_inputs->inline_request = "GET user:1000:profile\r\n";
+    for (int i = 0; i < 100; i++)
+    {
+        g_inputs->array_reply.AddMember().SetString(g_inputs->value);
+    }
+}
+
+/*
+ * Doubles the iterations until one run takes '--min_time', then reports that run.
+ */
+static void run_case(const MicroBenchCase& c)
+{
+    uint64 iters = 1;
+    while (true)
+    {
+        uint64 bytes = thread_allocated_bytes();
+        g_new_calls = 0;
+        g_count_allocs = true;
+        uint64 start = monotonic_nanos();
+        c.func(iters);
+        uint64 cost = monotonic_nanos() - start;
+        g_count_allocs = false;
+        uint64 allocs = g_new_calls;
+        bytes = thread_allocated_bytes() - bytes;
+        if (cost >= (uint64) g_options.min_time * 1000000 || iters >= (1ULL << 40))
+        {
+            double ns = (double) cost / iters;
+            if (g_options.json)
+            {
+                printf("{\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.2f,\"allocs_per_op\":%.3f,\"bytes_per_op\":%.1f}\n", c.name,
+                        (unsigned long long) iters, ns, (double) allocs / iters, (double) bytes / iters);
+            }
+            else
+            {
+                printf("%-28s %12.2f ns %12llu %12.3f %12.1f\n", c.name, ns, (unsigned long long) iters, (double) allocs / iters,
+                        (double) bytes / iters);
+            }
+            fflush(stdout);
+            return;
+        }
+        iters *= 2;
+    }
+}
+
+void usage()
+{
+    fprintf(stderr, "Usage: ./ardb-microbench [--option=value]...\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "       --filter=<run only the cases whose name contains it>\n");
+    fprintf(stderr, "       --min_time=<ms each case runs at least, default 500>\n");
+    fprintf(stderr, "       --format=<text|json, default text>\n");
+    fprintf(stderr, "Cases:\n");
+    for (size_t i = 0; i < arraysize(g_cases); i++)
+    {
+        fprintf(stderr, "       %s\n", g_cases[i].name);
+    }
+    exit(1);
+}
+
+static bool parse_option(const char* arg)
+{
+    const char* eq = strchr(arg, '=');
+    if (strncmp(arg, "--", 2) != 0 || NULL == eq)
+    {
+        return false;
+    }
+    std::string name(arg + 2, eq - arg - 2);
+    std::string value(eq + 1);
+    if (name == "filter")
+    {
+        g_options.filter = value;
+        return true;
+    }
+    if (name == "format")
+    {
+        if (value != "text" && value != "json")
+        {
+            return false;
+        }
+        g_options.json = value == "json";
+        return true;
+    }
+    if (name == "min_time")
+    {
+        return string_toint64(value, g_options.min_time) && g_options.min_time > 0;
+    }
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
+        {
+            usage();
+        }
+        if (!parse_option(argv[i]))
+        {
+            fprintf(stderr, "Invalid option:%s\n", argv[i]);
+            usage();
+        }
+    }
+    init_inputs();
+    if (!g_options.json)
+    {
+        printf("%-28s %15s %12s %12s %12s\n", "Benchmark", "Time", "Iterations", "allocs/op", "bytes/op");
+    }
+    for (size_t i = 0; i < arraysize(g_cases); i++)
+    {
+        if (!g_options.filter.empty() && NULL == strstr(g_cases[i].name, g_options.filter.c_str()))
+        {
+            continue;
+        }
+        run_case(g_cases[i]);
+    }
+    return 0;
+}
@@ -29,11 +29,17 @@
 #include <signal.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <set>
 #include "network.hpp"
 #include "db/db.hpp"
+#include "thread/thread.hpp"
+#include "thread/thread_mutex_lock.hpp"
+#include "thread/lock_guard.hpp"
+#include "util/atomic.hpp"
 #include "util/file_helper.hpp"
 
 void version()
@@ -45,13 +51,460 @@ void version()
 void usage()
 {
     fprintf(stderr, "Usage: ./ardb-repair [db_dir]\n");
+    fprintf(stderr, "       ./ardb-repair --verify [--fix] [--threads=N] [--checkpoint=file] [ardb.conf]\n");
     fprintf(stderr, "       ./ardb-repair -v or --version\n");
     fprintf(stderr, "       ./ardb-repair -h or --help\n");
     fprintf(stderr, "Examples:\n");
     fprintf(stderr, "       ./ardb-repair ./data/rocksdb\n");
+    fprintf(stderr, "       ./ardb-repair --verify --threads=16 --checkpoint=./verify.ckpt ../ardb.conf\n");
     exit(1);
 }
 
+/*
+ * Offline verification of the data of a stopped server: every namespace is split into 256 tasks by key first
+ * byte(like snapshot dumps) or by slots with KEY_CODEC_V3, each one checks the meta lengths against the element counts, elements without a
+ * meta of their type & the ttl index entries of expiring keys. A last task checks that every ttl index entry
+ * still has its key. Finished tasks are appended to the checkpoint file, a rerun with it skips them.
+ */
+using namespace ardb;
+
+struct VerifyOptions
+{
+        bool fix;
+        int64 threads;
+        std::string checkpoint;
+        std::string conf;
+        VerifyOptions() :
+                fix(false), threads(4)
+        {
+        }
+};
+
+struct VerifyStats
+{
+        volatile uint64_t keys;
+        volatile uint64_t elements;
+        volatile uint64_t bytes;
+        volatile uint64_t orphan_elements;
+        volatile uint64_t length_mismatches;
+        volatile uint64_t missing_ttl_entries;
+        volatile uint64_t stale_ttl_entries;
+        volatile uint64_t fixed;
+        volatile uint32_t finished_tasks;
+        VerifyStats() :
+                keys(0), elements(0), bytes(0), orphan_elements(0), length_mismatches(0), missing_ttl_entries(0), stale_ttl_entries(0), fixed(
+                        0), finished_tasks(0)
+        {
+        }
+        uint64 Issues() const
+        {
+            return orphan_elements + length_mismatches + missing_ttl_entries + stale_ttl_entries;
+        }
+};
+
+struct VerifyTask
+{
+        Data ns; //nil for the ttl index task
+        int lo;
+        std::string id;
+};
+
+static VerifyOptions g_verify;
+static VerifyStats g_stats;
+static std::vector<VerifyTask> g_tasks;
+static volatile uint32_t g_next_task = 0;
+static ThreadMutexLock g_checkpoint_lock;
+static FILE* g_checkpoint = NULL;
+
+static int verify_key_first_byte(const Data& key)
+{
+    if (key.IsString())
+    {
+        return key.StringLength() > 0 ? (unsigned char) key.CStr()[0] : -1;
+    }
+    std::string str = key.AsString();
+    return str.empty() ? -1 : (unsigned char) str[0];
+}
+
+static bool is_element_of(int meta_type, int ele_type)
+{
+    switch (meta_type)
+    {
+        case KEY_STRING:
+            return ele_type == KEY_BITMAP_CHUNK;
+        case KEY_HASH:
+            return ele_type == KEY_HASH_FIELD;
+        case KEY_LIST:
+            return ele_type == KEY_LIST_ELEMENT;
+        case KEY_SET:
+            return ele_type == KEY_SET_MEMBER;
+        case KEY_ZSET:
+            return ele_type == KEY_ZSET_SORT || ele_type == KEY_ZSET_SCORE || ele_type == KEY_ZSET_RANK;
+        default:
+            return false;
+    }
+}
+
+static KeyObject ttl_index_key(const Data& ns, const std::string& key, int64 ttl)
+{
+    Data tll_ns(TTL_DB_NSMAESPACE, false);
+    KeyObject ttl_key(tll_ns, KEY_TTL_SORT, "");
+    ttl_key.SetTTL(ttl);
+    ttl_key.SetTTLKeyNamespace(ns);
+    ttl_key.SetTTLKey(key);
+    return ttl_key;
+}
+
+class ObjectVerifier
+{
+    private:
+        Context m_ctx;
+        std::string m_key;
+        bool m_has_meta;
+        ValueObject m_meta;
+        int64 m_elements;
+
+        void Finish()
+        {
+            if (!m_has_meta)
+            {
+                return;
+            }
+            m_has_meta = false;
+            int type = m_meta.GetType();
+            if ((type != KEY_HASH && type != KEY_LIST && type != KEY_SET && type != KEY_ZSET) || m_meta.GetObjectId() > 0 || m_meta.IsPacked()
+                    || m_meta.GetObjectLen() < 0 || m_meta.GetObjectLen() == m_elements)
+            {
+                return;
+            }
+            atomic_add_uint64(&g_stats.length_mismatches, 1);
+            ERROR_LOG("Key:%s in db:%s has length:%lld in meta, but %lld elements.", m_key.c_str(), m_ctx.ns.AsString().c_str(),
+                    m_meta.GetObjectLen(), m_elements);
+            if (g_verify.fix)
+            {
+                m_meta.SetObjectLen(m_elements);
+                if (0 == g_engine->Put(m_ctx, KeyObject(m_ctx.ns, KEY_META, m_key), m_meta))
+                {
+                    atomic_add_uint64(&g_stats.fixed, 1);
+                }
+            }
+        }
+        void VerifyMeta(Iterator* iter)
+        {
+            m_has_meta = true;
+            m_meta = iter->Value(true);
+            m_elements = 0;
+            atomic_add_uint64(&g_stats.keys, 1);
+            if (m_meta.GetTTL() <= 0)
+            {
+                return;
+            }
+            KeyObject ttl_key = ttl_index_key(m_ctx.ns, m_key, m_meta.GetTTL());
+            ValueObject v;
+            if (0 == g_engine->Get(m_ctx, ttl_key, v))
+            {
+                return;
+            }
+            atomic_add_uint64(&g_stats.missing_ttl_entries, 1);
+            ERROR_LOG("Key:%s in db:%s expires at %lld without a ttl index entry.", m_key.c_str(), m_ctx.ns.AsString().c_str(), m_meta.GetTTL());
+            if (g_verify.fix)
+            {
+                v.SetType(KEY_TTL_SORT);
+                m_ctx.flags.create_if_notexist = 1;
+                if (0 == g_engine->Put(m_ctx, ttl_key, v))
+                {
+                    atomic_add_uint64(&g_stats.fixed, 1);
+                }
+            }
+        }
+    public:
+        ObjectVerifier(const Data& ns) :
+                m_has_meta(false), m_elements(0)
+        {
+            m_ctx.ns = ns;
+            m_ctx.flags.iterate_multi_keys = 1;
+        }
+        int VerifyRange(int lo)
+        {
+            /*
+             * keys are ordered by slot first in KEY_CODEC_V3, split by slots instead of key first byte
+             */
+            bool by_slot = get_key_codec_version() == KEY_CODEC_V3;
+            uint32 slot_hi = (lo + 1) * kClusterSlots / 256;
+            KeyObject start;
+            start.SetNameSpace(m_ctx.ns);
+            if (by_slot)
+            {
+                start = KeyObject(m_ctx.ns, KEY_META, "");
+                start.SetSlot(lo * kClusterSlots / 256);
+            }
+            else if (lo > 0)
+            {
+                start = KeyObject(m_ctx.ns, KEY_META, std::string(1, (char) lo));
+            }
+            Iterator* iter = g_engine->Find(m_ctx, start);
+            while (NULL != iter && iter->Valid())
+            {
+                KeyObject& k = iter->Key();
+                atomic_add_uint64(&g_stats.bytes, iter->RawKey().size() + iter->RawValue().size());
+                /*
+                 * elements keyed by object id have no key to find their meta by, they are left to the compaction
+                 */
+                if (k.GetObjectId() > 0)
+                {
+                    iter->Next();
+                    continue;
+                }
+                if (lo < 255 && (by_slot ? k.GetSlot() >= slot_hi : verify_key_first_byte(k.GetKey()) > lo))
+                {
+                    break;
+                }
+                const Data& key = k.GetKey();
+                bool same_key = m_key.size() == key.StringLength() && !memcmp(m_key.data(), key.CStr(), key.StringLength());
+                if (!same_key)
+                {
+                    Finish();
+                    m_key.assign(key.CStr(), key.StringLength());
+                }
+                if (k.GetType() == KEY_META)
+                {
+                    VerifyMeta(iter);
+                }
+                else if (k.GetType() == KEY_STRING)
+                {
+                    atomic_add_uint64(&g_stats.keys, 1);
+                }
+                else if (m_has_meta && is_element_of(m_meta.GetType(), k.GetType()))
+                {
+                    atomic_add_uint64(&g_stats.elements, 1);
+                    if (m_meta.GetType() != KEY_STRING && k.GetType() == element_type((KeyType) m_meta.GetType()))
+                    {
+                        m_elements++;
+                    }
+                }
+                else
+                {
+                    atomic_add_uint64(&g_stats.orphan_elements, 1);
+                    ERROR_LOG("Element with type:%d of key:%s in db:%s has no meta of its type.", k.GetType(), m_key.c_str(), m_ctx.ns.AsString().c_str());
+                    if (g_verify.fix)
+                    {
+                        iter->Del();
+                        atomic_add_uint64(&g_stats.fixed, 1);
+                    }
+                }
+                iter->Next();
+            }
+            Finish();
+            DELETE(iter);
+            return 0;
+        }
+        /*
+         * every ttl index entry must point to a key expiring at the entry's time
+         */
+        int VerifyTTLIndex()
+        {
+            Context ttl_ctx;
+            Data tll_ns(TTL_DB_NSMAESPACE, false);
+            KeyObject start(tll_ns, KEY_TTL_SORT, "");
+            start.SetTTL(0);
+            Iterator* iter = g_engine->Find(ttl_ctx, start);
+            while (NULL != iter && iter->Valid())
+            {
+                KeyObject& k = iter->Key(true);
+                if (k.GetType() != KEY_TTL_SORT)
+                {
+                    break;
+                }
+                atomic_add_uint64(&g_stats.bytes, iter->RawKey().size() + iter->RawValue().size());
+                KeyObject meta_key(k.GetElement(1), KEY_META, k.GetElement(2));
+                ValueObject meta;
+                int err = g_engine->Get(ttl_ctx, meta_key, meta);
+                bool stale = 0 != err || meta.GetTTL() != k.GetTTL();
+                if (k.IsFieldTTL())
+                {
+                    /*
+                     * entries of hash fields(HEXPIRE) point to a field expiring then
+                     */
+                    KeyObject field_key(k.GetElement(1), KEY_HASH_FIELD, k.GetElement(2));
+                    field_key.SetObjectId(meta.GetType() == KEY_HASH ? meta.GetObjectId() : 0);
+                    field_key.SetHashField(k.GetElement(3));
+                    ValueObject field_value;
+                    stale = 0 != err || 0 != g_engine->Get(ttl_ctx, field_key, field_value) || field_value.GetHashFieldTTL() != k.GetTTL();
+                }
+                if (stale)
+                {
+                    atomic_add_uint64(&g_stats.stale_ttl_entries, 1);
+                    ERROR_LOG("Ttl index entry of key:%s in db:%s at %lld has no key expiring then.", k.GetElement(2).AsString().c_str(),
+                            k.GetElement(1).AsString().c_str(), k.GetTTL());
+                    if (g_verify.fix)
+                    {
+                        iter->Del();
+                        atomic_add_uint64(&g_stats.fixed, 1);
+                    }
+                }
+                iter->Next();
+            }
+            DELETE(iter);
+            return 0;
+        }
+};
+
+class VerifyWorker: public Thread
+{
+    private:
+        void Run()
+        {
+            while (true)
+            {
+                uint32 idx = atomic_add_uint32(&g_next_task, 1) - 1;
+                if (idx >= g_tasks.size())
+                {
+                    return;
+                }
+                VerifyTask& task = g_tasks[idx];
+                ObjectVerifier verifier(task.ns);
+                if (task.ns.IsNil())
+                {
+                    verifier.VerifyTTLIndex();
+                }
+                else
+                {
+                    verifier.VerifyRange(task.lo);
+                }
+                atomic_add_uint32(&g_stats.finished_tasks, 1);
+                if (NULL != g_checkpoint)
+                {
+                    LockGuard<ThreadMutexLock> guard(g_checkpoint_lock);
+                    fprintf(g_checkpoint, "%s\n", task.id.c_str());
+                    fflush(g_checkpoint);
+                }
+            }
+        }
+};
+
+static void print_verify_progress(uint64 start_ms, size_t total)
+{
+    uint64 elapsed = get_current_epoch_millis() - start_ms;
+    double secs = elapsed > 0 ? elapsed / 1000.0 : 0.001;
+    printf("[%llus] tasks:%u/%zu keys:%llu elements:%llu issues:%llu fixed:%llu %.1fMB/s %.0fkeys/s\n", (unsigned long long) (elapsed / 1000),
+            g_stats.finished_tasks, total, (unsigned long long) g_stats.keys, (unsigned long long) g_stats.elements,
+            (unsigned long long) g_stats.Issues(), (unsigned long long) g_stats.fixed, g_stats.bytes / secs / (1024 * 1024), g_stats.keys / secs);
+    fflush(stdout);
+}
+
+static int verify()
+{
+    Ardb db;
+    if (0 != db.Init(g_verify.conf))
+    {
+        printf("Failed to init db.\n");
+        return -1;
+    }
+    std::set<std::string> finished;
+    if (!g_verify.checkpoint.empty())
+    {
+        FILE* f = fopen(g_verify.checkpoint.c_str(), "r");
+        char line[1024];
+        while (NULL != f && NULL != fgets(line, sizeof(line), f))
+        {
+            finished.insert(trim_string(line));
+        }
+        if (NULL != f)
+        {
+            fclose(f);
+        }
+        g_checkpoint = fopen(g_verify.checkpoint.c_str(), "a");
+        if (NULL == g_checkpoint)
+        {
+            printf("Failed to open checkpoint file:%s\n", g_verify.checkpoint.c_str());
+            return -1;
+        }
+    }
+    Context ctx;
+    DataArray nss;
+    g_engine->ListNameSpaces(ctx, nss);
+    for (size_t i = 0; i < nss.size(); i++)
+    {
+        if (nss[i].AsString() == TTL_DB_NSMAESPACE || nss[i].AsString() == ZSET_STORE_NAMESPACE || nss[i].AsString() == LAZYFREE_DB_NAMESPACE
+                || nss[i].AsString() == INDEX_DB_NAMESPACE)
+        {
+            continue;
+        }
+        for (int lo = 0; lo < 256; lo++)
+        {
+            VerifyTask task;
+            task.ns = nss[i];
+            task.lo = lo;
+            task.id = "db" + nss[i].AsString() + ":" + stringfromll(lo);
+            if (finished.count(task.id) == 0)
+            {
+                g_tasks.push_back(task);
+            }
+        }
+    }
+    VerifyTask ttl_task;
+    ttl_task.lo = 0;
+    ttl_task.id = "ttl-index";
+    if (finished.count(ttl_task.id) == 0)
+    {
+        g_tasks.push_back(ttl_task);
+    }
+    printf("Verifying %zu tasks(%zu done before) with %lld threads%s.\n", g_tasks.size(), finished.size(), (long long) g_verify.threads,
+            g_verify.fix ? ", fixing issues" : "");
+    uint64 start_ms = get_current_epoch_millis();
+    std::vector<VerifyWorker*> workers(g_verify.threads, (VerifyWorker*) NULL);
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        NEW(workers[i], VerifyWorker);
+        workers[i]->Start();
+    }
+    while (g_stats.finished_tasks < g_tasks.size())
+    {
+        sleep(1);
+        if ((get_current_epoch_millis() - start_ms) / 1000 % 10 == 0)
+        {
+            print_verify_progress(start_ms, g_tasks.size());
+        }
+    }
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i]->Join();
+        DELETE(workers[i]);
+    }
+    if (NULL != g_checkpoint)
+    {
+        fclose(g_checkpoint);
+    }
+    print_verify_progress(start_ms, g_tasks.size());
+    printf("Orphan elements:%llu length mismatches:%llu missing ttl entries:%llu stale ttl entries:%llu fixed:%llu\n",
+            (unsigned long long) g_stats.orphan_elements, (unsigned long long) g_stats.length_mismatches, (unsigned long long) g_stats.missing_ttl_entries,
+            (unsigned long long) g_stats.stale_ttl_entries, (unsigned long long) g_stats.fixed);
+    return g_stats.Issues() > g_stats.fixed ? 2 : 0;
+}
+
+static bool parse_verify_option(const char* arg)
+{
+    if (strcmp(arg, "--verify") == 0)
+    {
+        return true;
+    }
+    if (strcmp(arg, "--fix") == 0)
+    {
+        g_verify.fix = true;
+        return true;
+    }
+    if (strncmp(arg, "--checkpoint=", 13) == 0)
+    {
+        g_verify.checkpoint = arg + 13;
+        return true;
+    }
+    if (strncmp(arg, "--threads=", 10) == 0)
+    {
+        return string_toint64(arg + 10, g_verify.threads) && g_verify.threads > 0 && g_verify.threads <= 256;
+    }
+    return false;
+}
+
 int main(int argc, char** argv)
 {
     std::string dir;
@@ -65,6 +518,22 @@ int main(int argc, char** argv)
             version();
         if (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0)
             usage();
+        if (strcmp(argv[1], "--verify") == 0)
+        {
+            for (int i = 1; i < argc; i++)
+            {
+                if (argv[i][0] != '-')
+                {
+                    g_verify.conf = argv[i];
+                }
+                else if (!parse_verify_option(argv[i]))
+                {
+                    fprintf(stderr, "Invalid option:%s\n", argv[i]);
+                    usage();
+                }
+            }
+            return verify();
+        }
 
         /* First argument is the config file name? */
         if (argv[j][0] != '-' || argv[j][1] != '-')
@@ -82,7 +551,3 @@ int main(int argc, char** argv)
     Ardb db;
     return db.Repair(dir);
 }
-
-
-
-
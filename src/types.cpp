@@ -16,7 +16,7 @@ OP_NAMESPACE_BEGIN
 
     enum DataEncoding
     {
-        E_INT64 = 1, E_FLOAT64 = 2, E_CSTR = 3, E_SDS = 4
+        E_INT64 = 1, E_FLOAT64 = 2, E_CSTR = 3, E_SDS = 4, E_INLINE = 5 //E_INLINE is never encoded, written as E_SDS
     };
 
     Data::Data() :
@@ -65,6 +65,13 @@ OP_NAMESPACE_BEGIN
     void* Data::ReserveStringSpace(size_t size)
     {
         ToMutableStr();
+        if (StringLength() < size && (encoding == E_INLINE || IsNil()) && size <= kInlineSize)
+        {
+            memset(inline_str + StringLength(), 0, size - StringLength());
+            encoding = E_INLINE;
+            this->len = size;
+            return inline_str;
+        }
         if (StringLength() < size)
         {
             void* s = malloc(size);
@@ -78,12 +85,12 @@ OP_NAMESPACE_BEGIN
             encoding = E_SDS;
             this->len = size;
         }
-        return (void*) data;
+        return (void*) CStr();
     }
 
     void Data::Encode(Buffer& buf) const
     {
-        buf.WriteByte((char) encoding);
+        buf.WriteByte((char) (encoding == E_INLINE ? E_SDS : encoding));
         switch (encoding)
         {
             case E_FLOAT64:
@@ -95,6 +102,7 @@ OP_NAMESPACE_BEGIN
             }
             case E_CSTR:
             case E_SDS:
+            case E_INLINE:
             {
                 BufferHelper::WriteVarUInt32(buf, StringLength());
                 const char* ptr = CStr();
@@ -149,21 +157,7 @@ OP_NAMESPACE_BEGIN
                 }
                 const char* ss = buf.GetRawReadBuffer();
                 buf.AdvanceReadIndex(strlen);
-                len = strlen;
-                if (clone_str)
-                {
-                    void* s = malloc(strlen);
-                    data = (int64_t) s;
-                    memcpy(s, (char*) ss, strlen);
-                    //*(void**) (&data) = s;
-                    encoding = E_SDS;
-                }
-                else
-                {
-                    memcpy(&data, &ss, sizeof(const char*));
-                    //*(void**) (&data) = ss;
-                    encoding = E_CSTR;
-                }
+                SetString(ss, strlen, clone_str);
                 return true;
             }
             default:
@@ -176,7 +170,12 @@ OP_NAMESPACE_BEGIN
     void Data::SetString(const char* str, size_t slen, bool clone)
     {
         Clear();
-        if (clone)
+        if (clone && slen <= kInlineSize)
+        {
+            memcpy(inline_str, str, slen);
+            encoding = E_INLINE;
+        }
+        else if (clone)
         {
             void* s = malloc(slen);
             data = (int64_t) s;
@@ -244,20 +243,19 @@ OP_NAMESPACE_BEGIN
 
     void Data::Clone(const Data& other)
     {
-        Clear();
-        encoding = other.encoding;
-        len = other.len;
-        if (other.encoding == E_SDS)
+        if (this == &other)
         {
-            void* s = malloc(other.len);
-            data = (int64_t) s;
-            memcpy(s, other.CStr(), other.StringLength());
-            encoding = E_SDS;
+            return;
         }
-        else
+        if (other.encoding == E_SDS || other.encoding == E_INLINE)
         {
-            data = other.data;
+            SetString(other.CStr(), other.len, true);
+            return;
         }
+        Clear();
+        encoding = other.encoding;
+        len = other.len;
+        data = other.data;
     }
     int Data::Compare(const Data& right, bool alpha_cmp) const
     {
@@ -269,7 +267,8 @@ OP_NAMESPACE_BEGIN
         {
             if (IsInteger() && right.IsInteger())
             {
-                return GetInt64() - right.GetInt64();
+                int64 v1 = GetInt64(), v2 = right.GetInt64();
+                return v1 > v2 ? 1 : (v1 < v2 ? -1 : 0);
             }
             if (IsNumber() && right.IsNumber())
             {
@@ -351,7 +350,7 @@ OP_NAMESPACE_BEGIN
     }
     bool Data::IsString() const
     {
-        return encoding == E_SDS || encoding == E_CSTR;
+        return encoding == E_SDS || encoding == E_CSTR || encoding == E_INLINE;
     }
 
     bool Data::IsCStr() const
@@ -393,6 +392,10 @@ OP_NAMESPACE_BEGIN
                 void* ptr = (void*) data;
                 return (const char*) ptr;
             }
+            case E_INLINE:
+            {
+                return inline_str;
+            }
             default:
             {
                 return NULL;
@@ -424,6 +427,7 @@ OP_NAMESPACE_BEGIN
             }
             case E_CSTR:
             case E_SDS:
+            case E_INLINE:
             {
                 str.assign(CStr(), len);
                 break;
@@ -450,6 +454,7 @@ OP_NAMESPACE_BEGIN
                 return const_cast<char*>(CStr());
             }
             case E_SDS:
+            case E_INLINE:
             {
                 return const_cast<char*>(CStr());
             }
@@ -171,9 +171,19 @@ OP_NAMESPACE_BEGIN
         return r;
     }
 
+    /*
+     * Owned strings up to kInlineSize bytes are kept inside the Data, longer ones are malloced.
+     * Strings set/decoded without clone are borrowed: they point into the source(e.g. the current entry
+     * of an engine iterator) and are valid only as long as it is.
+     */
     struct Data
     {
-            int64_t data;
+            static const uint32 kInlineSize = 23;
+            union
+            {
+                    int64_t data;
+                    char inline_str[kInlineSize];
+            };
             uint32 len;
             uint8_t encoding;
             Data();
@@ -10,4 +10,63 @@ ardb.assert2(s == 0, s)
 s = ardb.call("getbit", "mykey", "7")
 ardb.assert2(s == 1, s)
 s = ardb.call("setbit", "mykey", "7", "0")
-ardb.assert2(s == 1, s)
\ No newline at end of file
+ardb.assert2(s == 1, s)
+
+--[[ bitmaps over 'bitmap-chunk-size' bytes are chunked --]]
+ardb.call("del", "bm1", "bm2", "bm3")
+ardb.call("setbit", "bm1", "3", "1")
+s = ardb.call("setbit", "bm1", "1000", "1")
+ardb.assert2(s == 0, s)
+s = ardb.call("setbit", "bm1", "1000", "1")
+ardb.assert2(s == 1, s)
+s = ardb.call("getbit", "bm1", "1000")
+ardb.assert2(s == 1, s)
+s = ardb.call("getbit", "bm1", "999")
+ardb.assert2(s == 0, s)
+s = ardb.call("getbit", "bm1", "3")
+ardb.assert2(s == 1, s)
+s = ardb.call("strlen", "bm1")
+ardb.assert2(s == 126, s)
+s = ardb.call("bitcount", "bm1")
+ardb.assert2(s == 2, s)
+s = ardb.call("bitcount", "bm1", "1", "-1")
+ardb.assert2(s == 1, s)
+s = ardb.call("bitpos", "bm1", "1")
+ardb.assert2(s == 3, s)
+s = ardb.call("bitpos", "bm1", "1", "1")
+ardb.assert2(s == 1000, s)
+s = ardb.call("bitpos", "bm1", "0", "0")
+ardb.assert2(s == 0, s)
+ardb.call("setbit", "bm2", "500", "1")
+ardb.call("setbit", "bm2", "1000", "1")
+s = ardb.call("bitop", "and", "bm3", "bm1", "bm2")
+ardb.assert2(s == 126, s)
+s = ardb.call("bitcount", "bm3")
+ardb.assert2(s == 1, s)
+s = ardb.call("getbit", "bm3", "1000")
+ardb.assert2(s == 1, s)
+ardb.call("bitop", "or", "bm3", "bm1", "bm2")
+s = ardb.call("bitcount", "bm3")
+ardb.assert2(s == 3, s)
+s = ardb.call("get", "bm1")
+ardb.assert2(string.len(s) == 126 and string.byte(s, 1) == 16 and string.byte(s, 126) == 128, s)
+s = ardb.call("append", "bm1", "x")
+ardb.assert2(s == 127, s)
+s = ardb.call("getbit", "bm1", "1000")
+ardb.assert2(s == 1, s)
+
+--[[ long strings --]]
+ardb.call("set", "bl1", string.rep("\255", 70) .. "\1")
+ardb.call("set", "bl2", string.rep("\15", 71))
+s = ardb.call("bitcount", "bl1")
+ardb.assert2(s == 561, s)
+s = ardb.call("bitpos", "bl1", "0")
+ardb.assert2(s == 560, s)
+s = ardb.call("bitpos", "bl2", "1", "3")
+ardb.assert2(s == 28, s)
+s = ardb.call("bitopcount", "and", "bl1", "bl2")
+ardb.assert2(s == 281, s)
+s = ardb.call("bitopcount", "xor", "bl1", "bl2")
+ardb.assert2(s == 283, s)
+s = ardb.call("bitopcount", "not", "bl2")
+ardb.assert2(s == 284, s)
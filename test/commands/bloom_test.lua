@@ -0,0 +1,53 @@
+--[[   --]]
+ardb.call("del", "mybloom", "mybloom1", "mybloom2", "mybloomstr")
+local s = ardb.call("bf.reserve", "mybloom", "0.01", "1000")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("bf.reserve", "mybloom", "0.01", "1000")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("bf.add", "mybloom", "item1")
+ardb.assert2(s == 1, s)
+s = ardb.call("bf.add", "mybloom", "item1")
+ardb.assert2(s == 0, s)
+s = ardb.call("bf.exists", "mybloom", "item1")
+ardb.assert2(s == 1, s)
+s = ardb.call("bf.exists", "mybloom", "item2")
+ardb.assert2(s == 0, s)
+s = ardb.call("bf.madd", "mybloom", "item1", "item2", "item3")
+ardb.assert2(s[1] == 0 and s[2] == 1 and s[3] == 1, s)
+s = ardb.call("bf.mexists", "mybloom", "item1", "item2", "item3", "item4")
+ardb.assert2(s[1] == 1 and s[2] == 1 and s[3] == 1 and s[4] == 0, s)
+s = ardb.call("bf.info", "mybloom")
+ardb.assert2(s[1] == "Capacity" and s[2] == 1000, s)
+ardb.assert2(s[7] == "Number of items inserted" and s[8] == 3, s)
+s = ardb.call("bf.exists", "mybloom1", "item1")
+ardb.assert2(s == 0, s)
+s = ardb.call("bf.add", "mybloom1", "item1")
+ardb.assert2(s == 1, s)
+s = ardb.call("bf.info", "mybloom1")
+ardb.assert2(s[2] == 100, s)
+s = ardb.call("bf.reserve", "mybloom2", "0.01", "1", "nonscaling")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("bf.add", "mybloom2", "item1")
+ardb.assert2(s == 1, s)
+s = ardb.call("bf.madd", "mybloom2", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j")
+local full = false
+for i = 1, table.getn(s) do
+    if type(s[i]) == "table" and s[i]["err"] ~= nil then
+        full = true
+    end
+end
+ardb.assert2(full, s)
+s = ardb.call("bf.reserve", "mybloom3", "1", "100")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("bf.reserve", "mybloom3", "0.01", "0")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("bf.reserve", "mybloom3", "0.01", "100", "expansion", "0")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("bf.reserve", "mybloom3", "0.01", "100", "foo")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("set", "mybloomstr", "hello")
+s = ardb.call("bf.add", "mybloomstr", "item1")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("bf.exists", "mybloomstr", "item1")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "mybloom", "mybloom1", "mybloom2", "mybloomstr")
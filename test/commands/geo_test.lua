@@ -18,4 +18,10 @@ ardb.assert2(s[2] == "Catania", s)
 ardb.call("geoadd", "mygeo", "13.583333", "37.316667", "Agrigento")
 s = ardb.call("GEORADIUSBYMEMBER", "mygeo", "Agrigento", "100", "km")
 ardb.assert2(s[1] == "Agrigento", s)
-ardb.assert2(s[2] == "Palermo", s)
\ No newline at end of file
+ardb.assert2(s[2] == "Palermo", s)
+s = ardb.call("GEORADIUS", "mygeo", "15", "37", "200", "km", "COUNT", "2", "WITHDIST")
+ardb.assert2(table.getn(s) == 2, s)
+ardb.assert2(s[1][1] == "Catania" and s[1][2] == "56.4413", s[1])
+ardb.assert2(s[2][1] == "Agrigento", s[2])
+s = ardb.call("GEORADIUS", "mygeo", "15", "37", "200", "km", "DESC")
+ardb.assert2(s[1] == "Palermo", s)
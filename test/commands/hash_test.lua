@@ -96,3 +96,97 @@ if ardb.is_merge_supported() then
     s = ardb.call("hget", "myhash", "f1")
     ardb.assert2(s == "32", s)
 end
+
+--small hashes are packed in the meta value, and converted to the normal layout once over the pack limits
+ardb.call("del", "myhash")
+for i = 1, 20 do
+    s = ardb.call("hset", "myhash", "f" .. string.format("%02d", i), "v" .. i)
+    ardb.assert2(s == 1, s)
+    s = ardb.call("hlen", "myhash")
+    ardb.assert2(s == i, s)
+    s = ardb.call("hget", "myhash", "f01")
+    ardb.assert2(s == "v1", s)
+end
+vs = ardb.call("hkeys", "myhash")
+ardb.assert2(#vs == 20, vs)
+ardb.assert2(vs[1] == "f01", vs)
+ardb.assert2(vs[20] == "f20", vs)
+ardb.call("del", "myhash")
+ardb.call("hmset", "myhash", "b", "2", "a", "1", "c", "3")
+vs = ardb.call("hgetall", "myhash")
+ardb.assert2(vs[1] == "a" and vs[2] == "1" and vs[5] == "c" and vs[6] == "3", vs)
+vs = ardb.call("hscan", "myhash", "0")
+ardb.assert2(vs[1] == "0", vs)
+ardb.assert2(#vs[2] == 6, vs)
+s = ardb.call("hexists", "myhash", "b")
+ardb.assert2(s == 1, s)
+s = ardb.call("hincrby", "myhash", "a", "10")
+ardb.assert2(s == 11, s)
+s = ardb.call("hset", "myhash", "long", string.rep("x", 100))
+ardb.assert2(s == 1, s)
+s = ardb.call("hget", "myhash", "long")
+ardb.assert2(s == string.rep("x", 100), s)
+s = ardb.call("hdel", "myhash", "a", "b", "c")
+ardb.assert2(s == 3, s)
+s = ardb.call("hlen", "myhash")
+ardb.assert2(s == 1, s)
+ardb.call("del", "myhash")
+ardb.call("hset", "myhash", "f0", "v0")
+s = ardb.call("hdel", "myhash", "f0")
+ardb.assert2(s == 1, s)
+s = ardb.call("exists", "myhash")
+ardb.assert2(s == 0, s)
+--hscan value filters, on a packed hash and on a hash over the pack limits
+ardb.call("del", "myhash")
+ardb.call("hmset", "myhash", "a", "1", "b", "5", "c", "10")
+vs = ardb.call("hscan", "myhash", "0", "filter", "gt", "3")
+ardb.assert2(#vs[2] == 4 and vs[2][1] == "b" and vs[2][4] == "10", vs)
+vs = ardb.call("hscan", "myhash", "0", "novalues")
+ardb.assert2(#vs[2] == 3 and vs[2][1] == "a" and vs[2][3] == "c", vs)
+vs = ardb.call("hscan", "myhash", "0", "filter", "==", "5", "novalues")
+ardb.assert2(#vs[2] == 1 and vs[2][1] == "b", vs)
+s = ardb.call("hscan", "myhash", "0", "filter", "like", "5")
+ardb.assert2(s["err"] ~= nil, s)
+for i = 1, 30 do
+    ardb.call("hset", "myhash", "f" .. string.format("%02d", i), tostring(i))
+end
+local cursor = "0"
+local fields = {}
+repeat
+    vs = ardb.call("hscan", "myhash", cursor, "filter", "ge", "25", "count", "5")
+    cursor = vs[1]
+    for i = 1, #vs[2], 2 do
+        table.insert(fields, vs[2][i])
+    end
+until cursor == "0"
+ardb.assert2(#fields == 6 and fields[1] == "f25" and fields[6] == "f30", fields)
+ardb.call("del", "myhash")
+--field ttls, a ttl already passed deletes the field
+ardb.call("del", "myhash")
+ardb.call("hmset", "myhash", "f1", "v1", "f2", "v2", "f3", "v3")
+vs = ardb.call("hexpire", "myhash", "100", "fields", "2", "f1", "nofield")
+ardb.assert2(vs[1] == 1 and vs[2] == -2, vs)
+vs = ardb.call("httl", "myhash", "fields", "3", "f1", "f2", "nofield")
+ardb.assert2(vs[1] > 90 and vs[1] <= 100, vs)
+ardb.assert2(vs[2] == -1 and vs[3] == -2, vs)
+vs = ardb.call("hpttl", "myhash", "fields", "1", "f1")
+ardb.assert2(vs[1] > 90000 and vs[1] <= 100000, vs)
+s = ardb.call("hget", "myhash", "f1")
+ardb.assert2(s == "v1", s)
+vs = ardb.call("hpexpire", "myhash", "100000", "fields", "1", "f3")
+ardb.assert2(vs[1] == 1, vs)
+vs = ardb.call("hpersist", "myhash", "fields", "3", "f1", "f2", "nofield")
+ardb.assert2(vs[1] == 1 and vs[2] == -1 and vs[3] == -2, vs)
+vs = ardb.call("httl", "myhash", "fields", "2", "f1", "f3")
+ardb.assert2(vs[1] == -1 and vs[2] > 90, vs)
+vs = ardb.call("hexpireat", "myhash", "1", "fields", "1", "f2")
+ardb.assert2(vs[1] == 2, vs)
+s = ardb.call("hget", "myhash", "f2")
+ardb.assert2(s == false, s)
+s = ardb.call("hlen", "myhash")
+ardb.assert2(s == 2, s)
+s = ardb.call("hexpire", "myhash", "100", "fields", "2", "f1")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("hexpire", "myhash", "-1", "fields", "1", "f1")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "myhash")
@@ -0,0 +1,63 @@
+--[[   --]]
+ardb.call("idx.drop", "useridx")
+ardb.call("del", "user:1", "user:2", "user:3", "other:1")
+ardb.call("hmset", "user:1", "age", "30", "city", "paris", "name", "a")
+ardb.call("hmset", "user:2", "age", "20", "city", "berlin", "name", "b")
+local s = ardb.call("idx.create", "useridx", "prefix", "user:", "schema", "age", "numeric", "city", "tag")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("idx.create", "useridx", "prefix", "user:", "schema", "age", "numeric")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("idx.create", "useridx1", "prefix", "user:", "schema", "age", "text")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("idx.create", "useridx1", "prefix", "user:", "schema", "age", "numeric", "age", "tag")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("idx.create", "useridx1", "from", "user:", "schema", "age", "numeric")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("hmset", "user:3", "age", "40", "city", "paris", "name", "c")
+ardb.call("hset", "other:1", "age", "25")
+s = ardb.call("idx.list")
+local found = false
+for i = 1, table.getn(s) do
+    if s[i][1] == "useridx" then
+        ardb.assert2(s[i][2] == "user:" and s[i][3] == "age" and s[i][4] == "NUMERIC", s[i])
+        ardb.assert2(s[i][5] == "city" and s[i][6] == "TAG", s[i])
+        found = true
+    end
+end
+ardb.assert2(found, s)
+s = ardb.call("idx.range", "useridx", "age", "-inf", "+inf")
+ardb.assert2(table.getn(s) == 3, s)
+ardb.assert2(s[1] == "user:2" and s[2] == "user:1" and s[3] == "user:3", s)
+s = ardb.call("idx.range", "useridx", "age", "25", "35")
+ardb.assert2(table.getn(s) == 1 and s[1] == "user:1", s)
+s = ardb.call("idx.range", "useridx", "age", "(20", "40")
+ardb.assert2(table.getn(s) == 2 and s[1] == "user:1" and s[2] == "user:3", s)
+s = ardb.call("idx.range", "useridx", "city", "[paris", "[paris")
+ardb.assert2(table.getn(s) == 2 and s[1] == "user:1" and s[2] == "user:3", s)
+s = ardb.call("idx.range", "useridx", "city", "-", "+", "limit", "1", "1")
+ardb.assert2(table.getn(s) == 1 and s[1] == "user:1", s)
+s = ardb.call("idx.range", "useridx", "age", "-inf", "+inf", "return", "1", "name")
+ardb.assert2(table.getn(s) == 6, s)
+ardb.assert2(s[1] == "user:2" and s[2][1] == "name" and s[2][2] == "b", s)
+ardb.assert2(s[5] == "user:3" and s[6][2] == "c", s)
+ardb.call("hset", "user:1", "age", "50")
+s = ardb.call("idx.range", "useridx", "age", "45", "+inf")
+ardb.assert2(table.getn(s) == 1 and s[1] == "user:1", s)
+s = ardb.call("idx.range", "useridx", "age", "25", "35")
+ardb.assert2(table.getn(s) == 0, s)
+ardb.call("del", "user:3")
+s = ardb.call("idx.range", "useridx", "city", "[paris", "[paris")
+ardb.assert2(table.getn(s) == 1 and s[1] == "user:1", s)
+s = ardb.call("idx.range", "useridx", "name", "-", "+")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("idx.range", "useridx", "age", "a", "b")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("idx.range", "useridx2", "age", "-inf", "+inf")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("idx.drop", "useridx")
+ardb.assert2(s == 1, s)
+s = ardb.call("idx.drop", "useridx")
+ardb.assert2(s == 0, s)
+s = ardb.call("idx.range", "useridx", "age", "-inf", "+inf")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "user:1", "user:2", "user:3", "other:1")
@@ -1,3 +1,117 @@
 --[[   --]]
 local s = ardb.call("echo", "hello,world")
-ardb.assert2(s == "hello,world", s)
\ No newline at end of file
+ardb.assert2(s == "hello,world", s)
+--scan type filters keys by the type in their meta
+ardb.call("del", "scantype:str", "scantype:hash", "scantype:set")
+ardb.call("set", "scantype:str", "v")
+ardb.call("hset", "scantype:hash", "f", "v")
+ardb.call("sadd", "scantype:set", "m")
+local function scan_all(...)
+    local cursor = "0"
+    local found = {}
+    repeat
+        local vs = ardb.call("scan", cursor, ...)
+        cursor = vs[1]
+        for i = 1, #vs[2] do
+            table.insert(found, vs[2][i])
+        end
+    until cursor == "0"
+    return found
+end
+local vs = scan_all("match", "scantype:*", "type", "hash", "count", "100")
+ardb.assert2(#vs == 1 and vs[1] == "scantype:hash", vs)
+vs = scan_all("match", "scantype:*", "type", "STRING")
+ardb.assert2(#vs == 1 and vs[1] == "scantype:str", vs)
+vs = scan_all("match", "scantype:*", "type", "list")
+ardb.assert2(#vs == 0, vs)
+vs = scan_all("match", "scantype:*")
+ardb.assert2(#vs == 3, vs)
+s = ardb.call("scan", "0", "filter", "eq", "v")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("sscan", "scantype:set", "0", "type", "set")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "scantype:str", "scantype:hash", "scantype:set")
+--flushdb async leaves the db empty at once
+ardb.call("select", "15")
+for i = 1, 100 do
+    ardb.call("set", "flushkey" .. i, "v")
+end
+ardb.call("hset", "flushhash", "f", "v")
+s = ardb.call("flushdb", "async")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("exists", "flushkey1", "flushkey100", "flushhash")
+ardb.assert2(s == 0, s)
+s = ardb.call("hget", "flushhash", "f")
+ardb.assert2(s == false, s)
+local vs = ardb.call("scan", "0", "count", "1000")
+ardb.assert2(vs[1] == "0" and #vs[2] == 0, vs)
+ardb.call("set", "flushkey1", "v1")
+s = ardb.call("get", "flushkey1")
+ardb.assert2(s == "v1", s)
+ardb.call("flushdb", "async")
+s = ardb.call("exists", "flushkey1")
+ardb.assert2(s == 0, s)
+s = ardb.call("flushdb", "lazy")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("select", "0")
+--randomkey of a db other than 0 is not served by the key cache of db 0
+ardb.call("set", "rkey0", "v")
+ardb.call("select", "15")
+ardb.call("set", "rkey15", "v")
+s = ardb.call("randomkey")
+ardb.assert2(s == "rkey15", s)
+ardb.call("del", "rkey15")
+ardb.call("select", "0")
+ardb.call("del", "rkey0")
+--exists counts every key given, unlink removes like del
+ardb.call("del", "ukey1", "ukey2", "ukey3")
+ardb.call("set", "ukey1", "v")
+ardb.call("hset", "ukey2", "f", "v")
+ardb.call("sadd", "ukey3", "m")
+s = ardb.call("exists", "ukey1", "ukey2", "ukey3", "nokey")
+ardb.assert2(s == 3, s)
+s = ardb.call("exists", "ukey1", "ukey1", "nokey")
+ardb.assert2(s == 2, s)
+s = ardb.call("unlink", "ukey1", "ukey2", "nokey")
+ardb.assert2(s == 2, s)
+s = ardb.call("exists", "ukey1", "ukey2", "ukey3")
+ardb.assert2(s == 1, s)
+s = ardb.call("hget", "ukey2", "f")
+ardb.assert2(s == false, s)
+s = ardb.call("unlink", "ukey3")
+ardb.assert2(s == 1, s)
+s = ardb.call("exists", "ukey3")
+ardb.assert2(s == 0, s)
+--a large key dumped in chunks & restored chunk by chunk
+ardb.call("del", "bigset")
+for i = 1, 2000 do
+    ardb.call("sadd", "bigset", "member" .. i)
+end
+local cursor = "0"
+local chunks = {}
+repeat
+    local vs = ardb.call("dump", "bigset", "chunk", cursor, "size", "4096")
+    cursor = vs[1]
+    table.insert(chunks, vs[2])
+until cursor == "0"
+ardb.assert2(#chunks > 1, chunks)
+ardb.call("del", "bigset")
+for i = 1, #chunks do
+    s = ardb.call("restore", "bigset", "0", chunks[i], "append")
+    ardb.assert2(s["ok"] == "OK", s)
+    if i < #chunks then
+        s = ardb.call("exists", "bigset")
+        ardb.assert2(s == 0, s)
+    end
+end
+s = ardb.call("scard", "bigset")
+ardb.assert2(s == 2000, s)
+s = ardb.call("sismember", "bigset", "member1")
+ardb.assert2(s == 1, s)
+s = ardb.call("sismember", "bigset", "member2000")
+ardb.assert2(s == 1, s)
+s = ardb.call("restore", "bigset", "0", chunks[1], "append")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("dump", "nokey", "chunk", "0")
+ardb.assert2(s == false, s)
+ardb.call("del", "bigset")
@@ -0,0 +1,11 @@
+--[[   --]]
+ardb.call("set", "waitkey", "v")
+local s = ardb.call("wait", "1", "100")
+ardb.assert2(s == 0, s)
+s = ardb.call("wait", "0", "0")
+ardb.assert2(s == 0, s)
+s = ardb.call("wait", "1", "-1")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("wait", "one", "100")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "waitkey")
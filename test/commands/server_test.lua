@@ -0,0 +1,62 @@
+--[[   --]]
+--latency monitor, spikes are only tracked over the threshold
+ardb.call("config", "set", "latency-monitor-threshold", "0")
+local s = ardb.call("latency", "doctor")
+ardb.assert2(type(s) == "string" and string.find(s, "disabled") ~= nil, s)
+ardb.call("config", "set", "latency-monitor-threshold", "1000000")
+s = ardb.call("latency", "reset")
+ardb.assert2(type(s) == "number", s)
+s = ardb.call("latency", "reset", "key-lock-wait", "compaction")
+ardb.assert2(s == 0, s)
+s = ardb.call("latency", "doctor")
+ardb.assert2(string.find(s, "No latency spikes") ~= nil, s)
+local vs = ardb.call("latency", "latest")
+ardb.assert2(type(vs) == "table" and #vs == 0, vs)
+vs = ardb.call("latency", "history", "key-lock-wait")
+ardb.assert2(type(vs) == "table" and #vs == 0, vs)
+vs = ardb.call("latency", "histogram")
+ardb.assert2(type(vs) == "table" and #vs % 2 == 0, vs)
+vs = ardb.call("latency", "histogram", "nosuchcmd")
+ardb.assert2(type(vs) == "table" and #vs == 0, vs)
+s = ardb.call("latency", "history")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("latency", "nosuchsub")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("config", "set", "latency-monitor-threshold", "0")
+--hot & big keys, every command is sampled at rate 1
+ardb.call("config", "set", "hotkeys-sample-rate", "1")
+ardb.call("config", "set", "bigkeys-min-length", "10")
+s = ardb.call("hotkeys", "reset")
+ardb.assert2(s["ok"] == "OK", s)
+ardb.call("del", "hotkey1", "hotkey2", "bigkeyset")
+for i = 1, 5 do
+    ardb.call("get", "hotkey1")
+end
+ardb.call("get", "hotkey2")
+vs = ardb.call("hotkeys", "hot", "1")
+ardb.assert2(#vs == 1 and #vs[1] == 3, vs)
+ardb.assert2(vs[1][1] == "0" and vs[1][2] == "hotkey1" and vs[1][3] >= 5, vs)
+vs = ardb.call("hotkeys", "hot")
+ardb.assert2(#vs >= 2 and #vs <= 10, vs)
+local members = {}
+for i = 1, 20 do
+    members[#members + 1] = "m" .. i
+end
+ardb.call("sadd", "bigkeyset", unpack(members))
+ardb.call("srandmember", "bigkeyset")
+vs = ardb.call("hotkeys", "big", "5")
+ardb.assert2(#vs == 1 and #vs[1] == 4, vs)
+ardb.assert2(vs[1][1] == "0" and vs[1][2] == "bigkeyset" and vs[1][3] == "set" and vs[1][4] == 20, vs)
+s = ardb.call("hotkeys", "reset")
+ardb.assert2(s["ok"] == "OK", s)
+vs = ardb.call("hotkeys", "hot")
+ardb.assert2(#vs == 0, vs)
+s = ardb.call("hotkeys", "hot", "many")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("hotkeys", "reset", "all")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("hotkeys", "cold")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("config", "set", "hotkeys-sample-rate", "0")
+ardb.call("config", "set", "bigkeys-min-length", "10000")
+ardb.call("del", "bigkeyset")
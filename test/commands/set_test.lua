@@ -100,4 +100,81 @@ vs = ardb.call("smembers", "storeset")
 ardb.assert2(table.getn(vs) == 1, vs)
 ardb.assert2(vs[1] == "c", vs)
 
-
+--[[ skewed sizes, store results overlapping sources --]]
+ardb.call("del", "bigset", "smallset", "storeset")
+for i = 1, 400 do
+    ardb.call("sadd", "bigset", tostring(i))
+end
+ardb.call("sadd", "smallset", "5", "77", "1000")
+vs = ardb.call("sinter", "bigset", "smallset")
+ardb.assert2(table.getn(vs) == 2 and vs[1] == "5" and vs[2] == "77", vs)
+s = ardb.call("sdiffcount", "smallset", "bigset")
+ardb.assert2(s == 1, s)
+s = ardb.call("sdiffcount", "bigset", "smallset")
+ardb.assert2(s == 398, s)
+s = ardb.call("sunioncount", "bigset", "smallset")
+ardb.assert2(s == 401, s)
+s = ardb.call("sinterstore", "storeset", "smallset", "nosuchset")
+ardb.assert2(s == 0, s)
+s = ardb.call("exists", "storeset")
+ardb.assert2(s == 0, s)
+s = ardb.call("sdiffstore", "smallset", "smallset", "bigset")
+ardb.assert2(s == 1, s)
+vs = ardb.call("smembers", "smallset")
+ardb.assert2(table.getn(vs) == 1 and vs[1] == "1000", vs)
+s = ardb.call("sunionstore", "smallset", "smallset", "myset1")
+ardb.assert2(s == 5, s)
+s = ardb.call("scard", "smallset")
+ardb.assert2(s == 5, s)
+ardb.call("del", "scanset")
+ardb.call("sadd", "scanset", "1", "2", "3", "10", "a")
+vs = ardb.call("sscan", "scanset", "0", "filter", "ge", "3")
+ardb.assert2(#vs[2] == 3 and vs[2][1] == "3" and vs[2][2] == "10" and vs[2][3] == "a", vs)
+vs = ardb.call("sscan", "scanset", "0", "filter", "lt", "3", "match", "1*")
+ardb.assert2(#vs[2] == 1 and vs[2][1] == "1", vs)
+vs = ardb.call("sscan", "scanset", "0", "filter", "ne", "a")
+ardb.assert2(#vs[2] == 4, vs)
+s = ardb.call("sscan", "scanset", "0", "novalues")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "scanset")
+--lazily freed set elements are not readable after the delete
+ardb.call("del", "lazyset")
+for i = 0, 11 do
+    local members = {}
+    for j = 0, 999 do
+        members[j + 1] = "m" .. (i * 1000 + j)
+    end
+    ardb.call("sadd", "lazyset", unpack(members))
+end
+s = ardb.call("scard", "lazyset")
+ardb.assert2(s == 12000, s)
+s = ardb.call("del", "lazyset")
+ardb.assert2(s == 1, s)
+s = ardb.call("sismember", "lazyset", "m11999")
+ardb.assert2(s == 0, s)
+vs = ardb.call("sscan", "lazyset", "0")
+ardb.assert2(#vs[2] == 0, vs)
+s = ardb.call("sadd", "lazyset", "x")
+ardb.assert2(s == 1, s)
+s = ardb.call("scard", "lazyset")
+ardb.assert2(s == 1, s)
+ardb.call("del", "lazyset")
+--random members of a large set are spread over it, not stuck on the members after the gaps of the byte space
+local members = {}
+for i = 0, 999 do
+    members[#members + 1] = string.format("m%04d", i)
+end
+ardb.call("del", "randset")
+ardb.call("sadd", "randset", unpack(members))
+vs = ardb.call("srandmember", "randset", "-200")
+ardb.assert2(#vs == 200, vs)
+local distinct = {}
+local ndistinct = 0
+for i = 1, #vs do
+    if not distinct[vs[i]] then
+        distinct[vs[i]] = true
+        ndistinct = ndistinct + 1
+    end
+end
+ardb.assert2(ndistinct > 100, ndistinct)
+ardb.call("del", "randset")
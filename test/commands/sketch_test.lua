@@ -0,0 +1,52 @@
+--[[   --]]
+ardb.call("del", "mycms", "mycms1", "mytopk")
+local s = ardb.call("cms.initbydim", "mycms", "2000", "5")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("cms.initbydim", "mycms", "2000", "5")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("cms.initbydim", "mycms1", "0", "5")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("cms.initbyprob", "mycms1", "1", "0.01")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("cms.initbyprob", "mycms1", "0.001", "0.01")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("cms.incrby", "mycms", "a", "5", "b", "3")
+if s["ok"] == nil then
+    ardb.assert2(s[1] == 5 and s[2] == 3, s)
+end
+ardb.call("cms.incrby", "mycms", "a", "2")
+s = ardb.call("cms.query", "mycms", "a", "b", "c")
+ardb.assert2(s[1] == 7 and s[2] == 3 and s[3] == 0, s)
+s = ardb.call("cms.info", "mycms")
+ardb.assert2(s[1] == "width" and s[2] == 2000, s)
+ardb.assert2(s[4] == 5 and s[6] == 10, s)
+s = ardb.call("cms.info", "mycms1")
+ardb.assert2(s[2] == 2000 and s[4] == 7, s)
+s = ardb.call("cms.incrby", "mycms", "a", "1", "b")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("cms.incrby", "mycms", "a", "-1")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("cms.query", "mycms2", "a")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("topk.reserve", "mytopk", "2")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("topk.reserve", "mytopk1", "0")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("topk.reserve", "mytopk1", "2", "8")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("topk.add", "mytopk", "a", "b", "a", "c", "a", "b")
+ardb.call("topk.incrby", "mytopk", "d", "1")
+s = ardb.call("topk.query", "mytopk", "a", "b", "c", "e")
+ardb.assert2(s[1] == 1 and s[2] == 1 and s[3] == 0 and s[4] == 0, s)
+s = ardb.call("topk.list", "mytopk")
+ardb.assert2(table.getn(s) == 2 and s[1] == "a" and s[2] == "b", s)
+s = ardb.call("topk.list", "mytopk", "withcount")
+ardb.assert2(s[1] == "a" and s[2] == 3 and s[3] == "b" and s[4] == 2, s)
+ardb.call("topk.incrby", "mytopk", "c", "10")
+s = ardb.call("topk.list", "mytopk")
+ardb.assert2(s[1] == "c" and s[2] == "a", s)
+s = ardb.call("topk.info", "mytopk")
+ardb.assert2(s[1] == "k" and s[2] == 2, s)
+s = ardb.call("topk.list", "mytopk1")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "mycms", "mycms1", "mytopk")
@@ -0,0 +1,78 @@
+--[[   --]]
+ardb.call("del", "mystream", "mystream1", "mystreamhash")
+local s = ardb.call("xadd", "mystream", "1-1", "a", "1")
+ardb.assert2(s == "1-1", s)
+ardb.call("xadd", "mystream", "1-2", "b", "2")
+ardb.call("xadd", "mystream", "2-0", "c", "3")
+s = ardb.call("xadd", "mystream", "3-*", "d", "4")
+ardb.assert2(s == "3-0", s)
+s = ardb.call("xadd", "mystream", "2-5", "e", "5")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("xadd", "mystream", "0-0", "e", "5")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("xadd", "mystream", "*", "e")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("xlen", "mystream")
+ardb.assert2(s == 4, s)
+s = ardb.call("xrange", "mystream", "-", "+")
+ardb.assert2(table.getn(s) == 4, s)
+ardb.assert2(s[1][1] == "1-1" and s[1][2][1] == "a" and s[1][2][2] == "1", s[1])
+ardb.assert2(s[4][1] == "3-0" and s[4][2][1] == "d", s[4])
+s = ardb.call("xrange", "mystream", "1-2", "2")
+ardb.assert2(table.getn(s) == 2 and s[1][1] == "1-2" and s[2][1] == "2-0", s)
+s = ardb.call("xrange", "mystream", "-", "+", "count", "2")
+ardb.assert2(table.getn(s) == 2 and s[2][1] == "1-2", s)
+s = ardb.call("xrevrange", "mystream", "+", "-", "count", "1")
+ardb.assert2(table.getn(s) == 1 and s[1][1] == "3-0", s)
+s = ardb.call("xrange", "mystream", "abc", "+")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("xread", "streams", "mystream", "1-2")
+ardb.assert2(s[1][1] == "mystream", s)
+ardb.assert2(table.getn(s[1][2]) == 2 and s[1][2][1][1] == "2-0", s[1][2])
+s = ardb.call("xread", "count", "1", "streams", "mystream", "0")
+ardb.assert2(table.getn(s[1][2]) == 1 and s[1][2][1][1] == "1-1", s)
+s = ardb.call("xread", "streams", "mystream", "$")
+ardb.assert2(s == false, s)
+s = ardb.call("xread", "block", "10", "streams", "mystream", "$")
+ardb.assert2(s == false, s)
+s = ardb.call("xread", "streams", "mystream", "mystream1", "0")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("xdel", "mystream", "1-1", "9-9")
+ardb.assert2(s == 1, s)
+s = ardb.call("xlen", "mystream")
+ardb.assert2(s == 3, s)
+s = ardb.call("xrange", "mystream", "-", "+")
+ardb.assert2(s[1][1] == "1-2", s)
+s = ardb.call("xtrim", "mystream", "maxlen", "1")
+ardb.assert2(s == 2, s)
+s = ardb.call("xrange", "mystream", "-", "+")
+ardb.assert2(table.getn(s) == 1 and s[1][1] == "3-0", s)
+ardb.call("xadd", "mystream", "maxlen", "2", "4-0", "e", "5")
+ardb.call("xadd", "mystream", "maxlen", "2", "5-0", "f", "6")
+s = ardb.call("xrange", "mystream", "-", "+")
+ardb.assert2(table.getn(s) == 2 and s[1][1] == "4-0" and s[2][1] == "5-0", s)
+for i = 1, 250 do
+    ardb.call("xadd", "mystream1", tostring(i) .. "-0", "f", tostring(i))
+end
+s = ardb.call("xrange", "mystream1", "150", "151")
+ardb.assert2(table.getn(s) == 2 and s[1][1] == "150-0" and s[2][2][2] == "151", s)
+s = ardb.call("xdel", "mystream1", "1-0", "120-0", "250-0")
+ardb.assert2(s == 3, s)
+s = ardb.call("xrange", "mystream1", "119", "121")
+ardb.assert2(table.getn(s) == 2 and s[1][1] == "119-0" and s[2][1] == "121-0", s)
+s = ardb.call("xrevrange", "mystream1", "+", "-", "count", "1")
+ardb.assert2(s[1][1] == "249-0", s)
+s = ardb.call("xtrim", "mystream1", "maxlen", "~", "100")
+ardb.assert2(s > 0, s)
+s = ardb.call("xlen", "mystream1")
+ardb.assert2(s >= 100, s)
+s = ardb.call("xtrim", "mystream1", "maxlen", "10")
+s = ardb.call("xrange", "mystream1", "-", "+")
+ardb.assert2(table.getn(s) == 10 and s[1][1] == "240-0" and s[10][1] == "249-0", s)
+s = ardb.call("xadd", "mystream1", "*", "g", "7")
+s = ardb.call("xlen", "mystream1")
+ardb.assert2(s == 11, s)
+ardb.call("hset", "mystreamhash", "f", "v")
+s = ardb.call("xadd", "mystreamhash", "*", "f", "v")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("del", "mystream", "mystream1", "mystreamhash")
@@ -186,3 +186,39 @@ v = ardb.call("get", "fkey")
 ardb.assert2(tonumber(v) == 1.1, v)
 
 
+--writes to chunked strings(bitmap-chunk-size > 0) in non compatible mode
+ardb.call("config", "set", "redis-compatible-mode", "no")
+ardb.call("del", "chunkstr")
+ardb.call("setbit", "chunkstr", "200", "1")
+s = ardb.call("set", "chunkstr", "v", "xx")
+s = ardb.call("get", "chunkstr")
+ardb.assert2(s == "v", s)
+s = ardb.call("getbit", "chunkstr", "200")
+ardb.assert2(s == 0, s)
+ardb.call("setbit", "chunkstr", "200", "1")
+ardb.call("append", "chunkstr", "x")
+s = ardb.call("strlen", "chunkstr")
+ardb.assert2(s == 27, s)
+s = ardb.call("get", "chunkstr")
+ardb.assert2(string.sub(s, 26) == "\128x", s)
+ardb.call("setrange", "chunkstr", "0", "ab")
+s = ardb.call("strlen", "chunkstr")
+ardb.assert2(s == 27, s)
+s = ardb.call("get", "chunkstr")
+ardb.assert2(string.sub(s, 1, 2) == "ab", s)
+s = ardb.call("incr", "chunkstr")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("set", "chunkstr", "10")
+s = ardb.call("strlen", "chunkstr")
+ardb.assert2(s == 2, s)
+s = ardb.call("getbit", "chunkstr", "200")
+ardb.assert2(s == 0, s)
+ardb.call("setbit", "chunkstr", "200", "1")
+ardb.call("mset", "chunkstr", "1")
+ardb.call("incr", "chunkstr")
+s = ardb.call("get", "chunkstr")
+ardb.assert2(s == "2", s)
+s = ardb.call("getbit", "chunkstr", "200")
+ardb.assert2(s == 0, s)
+ardb.call("del", "chunkstr")
+ardb.call("config", "set", "redis-compatible-mode", "yes")
@@ -0,0 +1,54 @@
+--[[   --]]
+ardb.call("del", "myts", "myts1")
+local s = ardb.call("ts.add", "myts", "1000", "10")
+ardb.assert2(s == 1000, s)
+ardb.call("ts.add", "myts", "2000", "20")
+ardb.call("ts.add", "myts", "3000", "30")
+ardb.call("ts.add", "myts", "4000", "40")
+s = ardb.call("ts.add", "myts", "2500", "25")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("ts.get", "myts")
+ardb.assert2(s[1] == 4000 and s[2] == "40", s)
+s = ardb.call("ts.range", "myts", "-", "+")
+ardb.assert2(table.getn(s) == 4, s)
+ardb.assert2(s[1][1] == 1000 and s[1][2] == "10", s[1])
+ardb.assert2(s[4][1] == 4000 and s[4][2] == "40", s[4])
+s = ardb.call("ts.range", "myts", "2000", "3000")
+ardb.assert2(table.getn(s) == 2, s)
+ardb.assert2(s[1][1] == 2000 and s[2][1] == 3000, s)
+s = ardb.call("ts.range", "myts", "5000", "+")
+ardb.assert2(table.getn(s) == 0, s)
+s = ardb.call("ts.range", "myts", "-", "+", "aggregation", "avg", "2000")
+ardb.assert2(table.getn(s) == 3, s)
+ardb.assert2(s[1][1] == 0 and s[1][2] == "10", s[1])
+ardb.assert2(s[2][1] == 2000 and s[2][2] == "25", s[2])
+ardb.assert2(s[3][1] == 4000 and s[3][2] == "40", s[3])
+s = ardb.call("ts.range", "myts", "-", "+", "aggregation", "sum", "2000")
+ardb.assert2(s[2][2] == "50", s)
+s = ardb.call("ts.range", "myts", "-", "+", "aggregation", "count", "2000")
+ardb.assert2(s[1][2] == "1" and s[2][2] == "2" and s[3][2] == "1", s)
+s = ardb.call("ts.range", "myts", "-", "+", "aggregation", "max", "10000")
+ardb.assert2(table.getn(s) == 1 and s[1][2] == "40", s)
+s = ardb.call("ts.info", "myts")
+ardb.assert2(s[1] == "totalSamples" and s[2] == 4, s)
+ardb.assert2(s[4] == 1000 and s[6] == 4000, s)
+s = ardb.call("ts.add", "myts", "abc", "1")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("ts.add", "myts", "5000", "abc")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("ts.range", "myts", "-", "+", "aggregation", "foo", "1000")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("ts.range", "myts", "-", "+", "aggregation", "avg", "0")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("ts.range", "myts", "-", "+", "aggregation", "avg")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("ts.create", "myts1", "retention", "1000")
+ardb.assert2(s["ok"] == "OK", s)
+s = ardb.call("ts.create", "myts1")
+ardb.assert2(s["err"] ~= nil, s)
+ardb.call("ts.add", "myts1", "1000", "1")
+ardb.call("ts.add", "myts1", "2000", "2")
+ardb.call("ts.add", "myts1", "3000", "3")
+s = ardb.call("ts.range", "myts1", "-", "+")
+ardb.assert2(table.getn(s) == 2 and s[1][1] == 2000, s)
+ardb.call("del", "myts", "myts1")
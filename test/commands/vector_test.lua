@@ -0,0 +1,59 @@
+--[[   --]]
+ardb.call("del", "myvset", "myvset1")
+local s = ardb.call("vadd", "myvset", "values", "3", "1", "0", "0", "a", "noquant")
+ardb.assert2(s == 1, s)
+s = ardb.call("vadd", "myvset", "values", "3", "0", "1", "0", "b")
+ardb.assert2(s == 1, s)
+s = ardb.call("vadd", "myvset", "values", "3", "0.9", "0.1", "0", "c")
+ardb.assert2(s == 1, s)
+s = ardb.call("vadd", "myvset", "values", "3", "1", "0", "0", "a")
+ardb.assert2(s == 0, s)
+s = ardb.call("vcard", "myvset")
+ardb.assert2(s == 3, s)
+s = ardb.call("vdim", "myvset")
+ardb.assert2(s == 3, s)
+s = ardb.call("vinfo", "myvset")
+ardb.assert2(s[1] == "quant-type" and s[2] == "f32", s)
+ardb.assert2(s[4] == 3 and s[6] == 3, s)
+s = ardb.call("vadd", "myvset", "values", "2", "1", "0", "d")
+ardb.assert2(s["err"] ~= nil and string.find(s["err"], "dimension mismatch") ~= nil, s)
+s = ardb.call("vadd", "myvset", "values", "0", "d")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("vadd", "myvset", "values", "3", "1", "x", "0", "d")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("vsim", "myvset", "values", "3", "1", "0", "0")
+ardb.assert2(table.getn(s) == 3, s)
+ardb.assert2(s[1] == "a" and s[2] == "c" and s[3] == "b", s)
+s = ardb.call("vsim", "myvset", "ele", "b", "count", "2")
+ardb.assert2(table.getn(s) == 2 and s[1] == "b" and s[2] == "c", s)
+s = ardb.call("vsim", "myvset", "ele", "a", "withscores", "count", "1")
+ardb.assert2(table.getn(s) == 2 and s[1] == "a" and tonumber(s[2]) > 0.99, s)
+s = ardb.call("vsim", "myvset", "values", "2", "1", "0")
+ardb.assert2(s["err"] ~= nil and string.find(s["err"], "dimension mismatch") ~= nil, s)
+s = ardb.call("vsim", "myvset", "ele", "d")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("vemb", "myvset", "a")
+ardb.assert2(table.getn(s) == 3 and tonumber(s[1]) == 1 and tonumber(s[2]) == 0, s)
+s = ardb.call("vemb", "myvset", "d")
+ardb.assert2(s == false, s)
+s = ardb.call("vrem", "myvset", "a")
+ardb.assert2(s == 1, s)
+s = ardb.call("vrem", "myvset", "a")
+ardb.assert2(s == 0, s)
+s = ardb.call("vcard", "myvset")
+ardb.assert2(s == 2, s)
+s = ardb.call("vsim", "myvset", "values", "3", "1", "0", "0")
+ardb.assert2(table.getn(s) == 2 and s[1] == "c" and s[2] == "b", s)
+s = ardb.call("vadd", "myvset", "values", "3", "1", "0", "0", "a")
+ardb.assert2(s == 1, s)
+s = ardb.call("vsim", "myvset", "values", "3", "1", "0", "0", "count", "1")
+ardb.assert2(table.getn(s) == 1 and s[1] == "a", s)
+s = ardb.call("vadd", "myvset1", "values", "2", "1", "1", "x")
+ardb.assert2(s == 1, s)
+s = ardb.call("vinfo", "myvset1")
+ardb.assert2(s[2] == "int8" and s[4] == 2, s)
+s = ardb.call("vdim", "myvset2")
+ardb.assert2(s["err"] ~= nil, s)
+s = ardb.call("vcard", "myvset2")
+ardb.assert2(s == 0, s)
+ardb.call("del", "myvset", "myvset1")
@@ -82,6 +82,19 @@ vs = ardb.call("zrangebylex", "myzset", "[aaa", "(g", "limit", "2", "2")
 ardb.assert2(table.getn(vs) == 2, vs)
 ardb.assert2(vs[1] == "d", vs)
 ardb.assert2(vs[2] == "e", vs)
+vs = ardb.call("zrangebylex", "myzset", "(b", "+", "limit", "1", "-1")
+ardb.assert2(table.getn(vs) == 4, vs)
+ardb.assert2(vs[1] == "d", vs)
+vs = ardb.call("zrevrangebylex", "myzset", "+", "-")
+ardb.assert2(table.getn(vs) == 7, vs)
+ardb.assert2(vs[1] == "g", vs)
+ardb.assert2(vs[7] == "a", vs)
+vs = ardb.call("zrevrangebylex", "myzset", "[c", "(a", "limit", "0", "2")
+ardb.assert2(table.getn(vs) == 2, vs)
+ardb.assert2(vs[1] == "c", vs)
+ardb.assert2(vs[2] == "b", vs)
+s = ardb.call("zlexcount", "myzset", "(a", "(c")
+ardb.assert2(s == 1, s)
 
 ardb.call("del", "myzset")
 ardb.call("zadd", "myzset", "0", "aaaa", "0", "b", "0", "c", "0", "d", "0", "e")
@@ -148,6 +161,17 @@ ardb.assert2(s==4, s)
 s = ardb.call("zrevrank", "myzset", "user4") 
 ardb.assert2(s==5, s)
 
+--a store onto one of its sources in another db is staged under a key of that db
+ardb.call("select", "2")
+ardb.call("del", "myset", "otherset")
+ardb.call("zadd", "myset", "1", "a", "2", "b")
+ardb.call("zadd", "otherset", "3", "c")
+s = ardb.call("ZUNIONSTORE", "myset", "2", "myset", "otherset")
+ardb.assert2(s == 3, s)
+vs = ardb.call("zrange", "myset", "0", "-1")
+ardb.assert2(#vs == 3 and vs[1] == "a" and vs[3] == "c", vs)
+ardb.call("del", "myset", "otherset")
+ardb.call("select", "0")
 --[[  issue #171 --]]
 ardb.call("del", "myset", "otherset")
 ardb.call("zadd", "myset","1","1","2","2","3","3")
@@ -174,4 +198,92 @@ ardb.assert2(vs[2] == "100", vs)
 ardb.assert2(vs[3] == "field2", vs)
 ardb.assert2(vs[4] == "200", vs)
 ardb.assert2(vs[5] == "field3", vs)
-ardb.assert2(vs[6] == "900", vs)
\ No newline at end of file
+ardb.assert2(vs[6] == "900", vs)
+--[[  rank index, ardb-test.conf splits it into blocks of 4 to 8 elements --]]
+ardb.call("del", "rankzset")
+for i = 1, 40 do
+    ardb.call("zadd", "rankzset", tostring(i * 10), "m" .. i)
+end
+s = ardb.call("zrank", "rankzset", "m1")
+ardb.assert2(s==0, s)
+s = ardb.call("zrank", "rankzset", "m25")
+ardb.assert2(s==24, s)
+s = ardb.call("zrevrank", "rankzset", "m25")
+ardb.assert2(s==15, s)
+vs = ardb.call("zrange", "rankzset", "17", "19")
+ardb.assert2(table.getn(vs) == 3, vs)
+ardb.assert2(vs[1] == "m18", vs)
+ardb.assert2(vs[3] == "m20", vs)
+vs = ardb.call("zrevrange", "rankzset", "0", "1")
+ardb.assert2(table.getn(vs) == 2, vs)
+ardb.assert2(vs[1] == "m40", vs)
+ardb.assert2(vs[2] == "m39", vs)
+ardb.call("zadd", "rankzset", "5", "m30")
+s = ardb.call("zrank", "rankzset", "m30")
+ardb.assert2(s==0, s)
+s = ardb.call("zrank", "rankzset", "m31")
+ardb.assert2(s==30, s)
+s = ardb.call("ZREMRANGEBYRANK", "rankzset", "5", "24")
+ardb.assert2(s==20, s)
+s = ardb.call("zrank", "rankzset", "m31")
+ardb.assert2(s==10, s)
+ardb.call("zrem", "rankzset", "m30", "m1")
+ardb.call("ZREMRANGEBYSCORE", "rankzset", "350", "380")
+vs = ardb.call("zrange", "rankzset", "11", "12")
+ardb.assert2(vs[1] == "m34", vs)
+ardb.assert2(vs[2] == "m39", vs)
+s = ardb.call("zrevrank", "rankzset", "m2")
+ardb.assert2(s==13, s)
+--[[  store with set sources, AGGREGATE MIN and the destination as a source --]]
+ardb.call("del", "zsa", "zsb", "sset", "zsd")
+ardb.call("zadd", "zsa", "1", "a", "2", "b", "3", "c")
+ardb.call("zadd", "zsb", "10", "b", "20", "c", "30", "d")
+ardb.call("sadd", "sset", "c", "d", "e")
+s = ardb.call("ZINTERSTORE", "zsd", "3", "zsa", "zsb", "sset", "WEIGHTS", "2", "1", "5")
+ardb.assert2(s==1, s)
+s = ardb.call("zscore", "zsd", "c")
+ardb.assert2(s=="31", s)
+s = ardb.call("ZUNIONSTORE", "zsd", "2", "zsb", "sset", "AGGREGATE", "MIN")
+ardb.assert2(s==4, s)
+vs = ardb.call("zrange", "zsd", "0", "-1", "WITHSCORES")
+ardb.assert2(vs[1] == "c" and vs[2] == "1", vs)
+ardb.assert2(vs[7] == "b" and vs[8] == "10", vs)
+s = ardb.call("ZUNIONSTORE", "zsa", "2", "zsa", "zsb")
+ardb.assert2(s==4, s)
+vs = ardb.call("zrange", "zsa", "0", "-1", "WITHSCORES")
+ardb.assert2(vs[1] == "a" and vs[2] == "1", vs)
+ardb.assert2(vs[3] == "b" and vs[4] == "12", vs)
+ardb.assert2(vs[7] == "d" and vs[8] == "30", vs)
+s = ardb.call("ZINTERSTORE", "zsa", "2", "zsa", "nosuchkey")
+ardb.assert2(s==0, s)
+s = ardb.call("exists", "zsa")
+ardb.assert2(s==0, s)
+ardb.call("del", "scanzset")
+ardb.call("zadd", "scanzset", "1", "a", "2", "b", "3", "c", "10", "d")
+vs = ardb.call("zscan", "scanzset", "0", "filter", "lt", "3")
+ardb.assert2(#vs[2] == 4 and vs[2][1] == "a" and vs[2][3] == "b" and vs[2][4] == "2", vs)
+vs = ardb.call("zscan", "scanzset", "0", "filter", ">=", "3")
+ardb.assert2(#vs[2] == 4 and vs[2][1] == "c" and vs[2][3] == "d", vs)
+vs = ardb.call("zscan", "scanzset", "0", "filter", "eq", "10")
+ardb.assert2(#vs[2] == 2 and vs[2][1] == "d", vs)
+ardb.call("del", "scanzset")
+--a zscan followed cursor by cursor returns every member once
+for i = 1, 50 do
+    ardb.call("zadd", "scanzset", tostring(i % 7), "m" .. string.format("%02d", i))
+end
+local cursor = "0"
+local seen = {}
+local nseen = 0
+local rounds = 0
+repeat
+    vs = ardb.call("zscan", "scanzset", cursor, "count", "8")
+    cursor = vs[1]
+    rounds = rounds + 1
+    for i = 1, #vs[2], 2 do
+        ardb.assert2(not seen[vs[2][i]], vs)
+        seen[vs[2][i]] = true
+        nseen = nseen + 1
+    end
+until cursor == "0" or rounds > 100
+ardb.assert2(nseen == 50 and rounds > 1 and seen["m07"], nseen)
+ardb.call("del", "scanzset")
@@ -35,9 +35,253 @@
 #include "db/db.hpp"
 #include "config.hpp"
 #include "common/cache/KeyCache.h"
+#include "util/string_helper.hpp"
+#include "repl/repl.hpp"
 
 using namespace ardb;
 
+/*
+ * Commands not allowed in scripts(SAVE2/IMPORT...) are tested natively after the lua files.
+ */
+static void test_call(Ardb& db, Context& ctx, const std::string& line)
+{
+    ArgumentArray args;
+    std::vector<std::string> ss = split_string(line, " ");
+    for (size_t i = 0; i < ss.size(); i++) {
+        args.push_back(ss[i]);
+    }
+    RedisCommandFrame cmd(args);
+    ctx.GetReply().Clear();
+    db.Call(ctx, cmd);
+}
+
+/*
+ * A pipelined command as the network handler runs it, joining the pipeline write batch of the connection first.
+ */
+static void pipeline_call(Ardb& db, Context& ctx, const std::string& line)
+{
+    ArgumentArray args;
+    std::vector<std::string> ss = split_string(line, " ");
+    for (size_t i = 0; i < ss.size(); i++) {
+        args.push_back(ss[i]);
+    }
+    RedisCommandFrame cmd(args);
+    ctx.GetReply().Clear();
+    db.JoinPipelineBatch(ctx, cmd);
+    db.Call(ctx, cmd);
+}
+
+#define TEST_ASSERT(expr, ...) do {\
+        if (!(expr)) {\
+            fprintf(stderr, "%s:%d assert failed:", __FILE__, __LINE__);\
+            fprintf(stderr, __VA_ARGS__);\
+            fprintf(stderr, "\n");\
+            return -1;\
+        }\
+    } while (0)
+
+static std::string latest_snapshot(Ardb& db, const std::string& prefix)
+{
+    std::deque<std::string> fs;
+    list_subfiles(db.GetConf().backup_dir, fs);
+    std::string latest;
+    for (size_t i = 0; i < fs.size(); i++) {
+        if (has_prefix(fs[i], prefix) && fs[i] > latest)
+            latest = fs[i];
+    }
+    return latest.empty() ? latest : db.GetConf().backup_dir + "/" + latest;
+}
+
+/*
+ * SAVE2 then IMPORT keys of several dbs, keys start with bytes on both sides of every dump range.
+ */
+static int snapshot_test(Ardb& db)
+{
+    Context ctx;
+    RedisReply& r = ctx.GetReply();
+    test_call(db, ctx, "flushall");
+    test_call(db, ctx, "set 0abc v");
+    test_call(db, ctx, "set zzz v");
+    for (int i = 0; i < 1000; i++) {
+        test_call(db, ctx, "set k" + stringfromll(i) + " v" + stringfromll(i));
+    }
+    test_call(db, ctx, "sadd myset a b c");
+    test_call(db, ctx, "select 1");
+    test_call(db, ctx, "set db1key v");
+    test_call(db, ctx, "hset db1hash f v");
+    test_call(db, ctx, "save2");
+    TEST_ASSERT(!r.IsErr(), "save2 %s", r.Error().c_str());
+    std::string file = latest_snapshot(db, "ardb-snapshot.");
+    TEST_ASSERT(!file.empty(), "no ardb snapshot in %s", db.GetConf().backup_dir.c_str());
+    test_call(db, ctx, "flushall");
+    test_call(db, ctx, "import " + file);
+    unlink(file.c_str());
+    TEST_ASSERT(!r.IsErr(), "import %s", r.Error().c_str());
+    test_call(db, ctx, "get db1key");
+    TEST_ASSERT(r.GetString() == "v", "db1key %s", r.GetString().c_str());
+    test_call(db, ctx, "hget db1hash f");
+    TEST_ASSERT(r.GetString() == "v", "db1hash %s", r.GetString().c_str());
+    test_call(db, ctx, "select 0");
+    test_call(db, ctx, "get 0abc");
+    TEST_ASSERT(r.GetString() == "v", "0abc %s", r.GetString().c_str());
+    test_call(db, ctx, "get zzz");
+    TEST_ASSERT(r.GetString() == "v", "zzz %s", r.GetString().c_str());
+    for (int i = 0; i < 1000; i++) {
+        test_call(db, ctx, "get k" + stringfromll(i));
+        TEST_ASSERT(r.GetString() == "v" + stringfromll(i), "k%d %s", i, r.GetString().c_str());
+    }
+    test_call(db, ctx, "scard myset");
+    TEST_ASSERT(r.GetInteger() == 3, "scard myset %lld", (long long) r.GetInteger());
+    test_call(db, ctx, "flushall");
+    return 0;
+}
+
+/*
+ * Failed commands of a pipeline write batch, a WRONGTYPE one & one rolling back its own writes, leave the writes of
+ * the other commands of the batch committed.
+ */
+static int pipeline_batch_test(Ardb& db)
+{
+    Context ctx;
+    RedisReply& r = ctx.GetReply();
+    test_call(db, ctx, "del pk0 pk1 pk2 pk3 pkw pkz");
+    test_call(db, ctx, "set pkw v");
+    test_call(db, ctx, "zadd pkz inf m");
+    pipeline_call(db, ctx, "set pk0 v0");
+    TEST_ASSERT(ctx.InPipelineBatch(), "set pk0 did not join a pipeline batch");
+    pipeline_call(db, ctx, "sadd pkw x");
+    TEST_ASSERT(r.IsErr(), "sadd on a string key did not fail");
+    pipeline_call(db, ctx, "zadd pkz incr -inf m");
+    TEST_ASSERT(r.IsErr(), "zadd incr to a nan score did not fail");
+    pipeline_call(db, ctx, "set pk1 v1");
+    pipeline_call(db, ctx, "hset pk2 f v");
+    pipeline_call(db, ctx, "set pk1 v2");
+    pipeline_call(db, ctx, "incr pk3");
+    TEST_ASSERT(ctx.InPipelineBatch(), "incr pk3 did not join a pipeline batch");
+    db.CommitPipelineBatch(ctx);
+    TEST_ASSERT(!ctx.InPipelineBatch(), "pipeline batch still open after commit");
+    test_call(db, ctx, "get pk0");
+    TEST_ASSERT(r.GetString() == "v0", "pk0 %s", r.GetString().c_str());
+    test_call(db, ctx, "get pk1");
+    TEST_ASSERT(r.GetString() == "v2", "pk1 %s", r.GetString().c_str());
+    test_call(db, ctx, "hget pk2 f");
+    TEST_ASSERT(r.GetString() == "v", "pk2 %s", r.GetString().c_str());
+    test_call(db, ctx, "get pk3");
+    TEST_ASSERT(r.GetString() == "1", "pk3 %s", r.GetString().c_str());
+    test_call(db, ctx, "get pkw");
+    TEST_ASSERT(r.GetString() == "v", "pkw %s", r.GetString().c_str());
+    test_call(db, ctx, "zcard pkz");
+    TEST_ASSERT(r.GetInteger() == 1, "zcard pkz %lld", (long long) r.GetInteger());
+    test_call(db, ctx, "zscore pkz m");
+    TEST_ASSERT(!r.IsErr() && r.GetDouble() > 1e308, "zscore pkz m %f", r.GetDouble());
+    test_call(db, ctx, "del pk0 pk1 pk2 pk3 pkw pkz");
+    return 0;
+}
+
+/*
+ * REBALANCE reply shapes & argument errors, it needs the replication backlog so no rebalance is ever started here.
+ */
+static int rebalance_test(Ardb& db)
+{
+    Context ctx;
+    RedisReply& r = ctx.GetReply();
+    test_call(db, ctx, "rebalance status");
+    TEST_ASSERT(r.type == REDIS_REPLY_STRING && r.GetString().find("rebalance_status:none") != std::string::npos, "rebalance status %s",
+            r.GetString().c_str());
+    test_call(db, ctx, "rebalance abort");
+    TEST_ASSERT(r.IsErr() && r.Error().find("no rebalance in progress") != std::string::npos, "rebalance abort %s", r.Error().c_str());
+    const char* bad_args[] = { "rebalance 127.0.0.1", "rebalance 127.0.0.1 99999", "rebalance 127.0.0.1 abc", "rebalance 127.0.0.1 1 slots 5 1",
+            "rebalance 127.0.0.1 1 slots 0 16384", "rebalance 127.0.0.1 1 maxmb -1", "rebalance 127.0.0.1 1 timeout 0", "rebalance 127.0.0.1 1 bogus" };
+    for (size_t i = 0; i < sizeof(bad_args) / sizeof(bad_args[0]); i++) {
+        test_call(db, ctx, bad_args[i]);
+        TEST_ASSERT(r.IsErr(), "%s did not fail", bad_args[i]);
+    }
+    test_call(db, ctx, "rebalance 127.0.0.1 1 slots 0 10");
+    TEST_ASSERT(r.IsErr() && r.Error().find("needs cluster-enabled") != std::string::npos, "rebalance slots %s", r.Error().c_str());
+    test_call(db, ctx, "rebalance 127.0.0.1 1 maxmb 1 maxops 100 timeout 100");
+    TEST_ASSERT(r.IsErr() && r.Error().find("needs the replication backlog") != std::string::npos, "rebalance %s", r.Error().c_str());
+    test_call(db, ctx, "rebalance status");
+    TEST_ASSERT(r.GetString().find("rebalance_status:none") != std::string::npos, "rebalance status %s", r.GetString().c_str());
+    return 0;
+}
+
+/*
+ * CDC reply shapes & argument errors over the replication backlog.
+ */
+static int cdc_test(Ardb& db)
+{
+    Context ctx;
+    RedisReply& r = ctx.GetReply();
+    test_call(db, ctx, "cdc pos");
+    TEST_ASSERT(r.MemberSize() == 3, "cdc pos %d members", (int) r.MemberSize());
+    TEST_ASSERT(r.MemberAt(0).type == REDIS_REPLY_INTEGER && r.MemberAt(1).type == REDIS_REPLY_INTEGER, "cdc pos offsets");
+    TEST_ASSERT(r.MemberAt(2).type == REDIS_REPLY_STRING, "cdc pos namespace");
+    int64 start = r.MemberAt(1).GetInteger();
+    test_call(db, ctx, "set cdckey v");
+    test_call(db, ctx, "cdc pos");
+    int64 end = r.MemberAt(1).GetInteger();
+    TEST_ASSERT(end > start, "cdc pos end %lld <= %lld", (long long) end, (long long) start);
+    test_call(db, ctx, "cdc read " + stringfromll(start) + " ns 0 count 10");
+    TEST_ASSERT(r.MemberSize() == 3, "cdc read %d members", (int) r.MemberSize());
+    TEST_ASSERT(r.MemberAt(0).GetInteger() == end && r.MemberAt(1).GetString() == "0", "cdc read next %lld",
+            (long long) r.MemberAt(0).GetInteger());
+    RedisReply& records = r.MemberAt(2);
+    TEST_ASSERT(records.MemberSize() == 1 && records.MemberAt(0).MemberSize() == 6, "cdc read %d records", (int) records.MemberSize());
+    RedisReply& record = records.MemberAt(0);
+    TEST_ASSERT(record.MemberAt(0).GetInteger() >= start && record.MemberAt(0).GetInteger() < end, "cdc record offset %lld",
+            (long long) record.MemberAt(0).GetInteger());
+    TEST_ASSERT(record.MemberAt(1).GetString() == "0" && record.MemberAt(2).GetString() == "cdckey", "cdc record key %s",
+            record.MemberAt(2).GetString().c_str());
+    TEST_ASSERT(!strcasecmp(record.MemberAt(3).GetString().c_str(), "set"), "cdc record command %s", record.MemberAt(3).GetString().c_str());
+    TEST_ASSERT(record.MemberAt(4).GetString() == "cdckey" && record.MemberAt(5).GetString() == "v", "cdc record arguments");
+    test_call(db, ctx, "cdc commit cdcconsumer " + stringfromll(end) + " 0");
+    TEST_ASSERT(!r.IsErr(), "cdc commit %s", r.Error().c_str());
+    test_call(db, ctx, "cdc offset cdcconsumer");
+    TEST_ASSERT(r.MemberSize() == 2 && r.MemberAt(0).GetInteger() == end && r.MemberAt(1).GetString() == "0", "cdc offset");
+    test_call(db, ctx, "cdc offset nosuchconsumer");
+    TEST_ASSERT(r.IsNil(), "cdc offset of an unknown consumer is not nil");
+    const char* bad_args[] = { "cdc read abc", "cdc read -1", "cdc read 0 bogus 1", "cdc commit cdcconsumer abc", "cdc bogus" };
+    for (size_t i = 0; i < sizeof(bad_args) / sizeof(bad_args[0]); i++) {
+        test_call(db, ctx, bad_args[i]);
+        TEST_ASSERT(r.IsErr(), "%s did not fail", bad_args[i]);
+    }
+    test_call(db, ctx, "cdc read " + stringfromll(end) + " count 0");
+    TEST_ASSERT(r.IsErr(), "cdc read count 0 did not fail");
+    test_call(db, ctx, "del cdckey");
+    return 0;
+}
+
+/*
+ * Lists left non-sequential by LINSERT are renumbered by the cron within its element budget, the rest stay queued.
+ */
+static int list_compact_test(Ardb& db)
+{
+    Context ctx;
+    RedisReply& r = ctx.GetReply();
+    db.CompactLists();
+    test_call(db, ctx, "del lc1 lc2 lc3");
+    test_call(db, ctx, "rpush lc1 a b c");
+    test_call(db, ctx, "rpush lc2 a b c");
+    test_call(db, ctx, "rpush lc3 a b c");
+    test_call(db, ctx, "linsert lc1 before b x");
+    test_call(db, ctx, "linsert lc2 before b x");
+    test_call(db, ctx, "linsert lc3 before b x");
+    int64 compacted = db.CompactLists(1);
+    TEST_ASSERT(compacted == 1, "compacted %lld lists with a budget of 1 element", (long long) compacted);
+    compacted = db.CompactLists(4);
+    TEST_ASSERT(compacted == 1, "compacted %lld lists with a budget of 4 elements", (long long) compacted);
+    compacted = db.CompactLists();
+    TEST_ASSERT(compacted == 1, "compacted %lld lists left", (long long) compacted);
+    compacted = db.CompactLists();
+    TEST_ASSERT(compacted == 0, "compacted %lld lists of an empty queue", (long long) compacted);
+    test_call(db, ctx, "lrange lc2 0 -1");
+    TEST_ASSERT(r.MemberSize() == 4 && r.MemberAt(1).GetString() == "x" && r.MemberAt(3).GetString() == "c", "lrange lc2");
+    test_call(db, ctx, "lindex lc3 2");
+    TEST_ASSERT(r.GetString() == "b", "lindex lc3 2 %s", r.GetString().c_str());
+    test_call(db, ctx, "del lc1 lc2 lc3");
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
     if (argc == 2 && strcmp(argv[1], "cache-interactor") == 0) {
@@ -98,6 +342,37 @@ int main(int argc, char** argv)
                 }
             }
         }
+        printf("=======================pipeline batch Test Begin============================\n");
+        if (pipeline_batch_test(db) != 0) {
+            return -1;
+        }
+        printf("=======================pipeline batch Test End============================\n\n");
+        printf("=======================list compact Test Begin============================\n");
+        if (list_compact_test(db) != 0) {
+            return -1;
+        }
+        printf("=======================list compact Test End============================\n\n");
+        printf("=======================rebalance Test Begin============================\n");
+        if (rebalance_test(db) != 0) {
+            return -1;
+        }
+        printf("=======================rebalance Test End============================\n\n");
+        /*
+         * cdc reads & snapshots record the wal offset
+         */
+        g_repl->Init();
+        printf("=======================cdc Test Begin============================\n");
+        int err = cdc_test(db);
+        if (err == 0) {
+            printf("=======================cdc Test End============================\n\n");
+            printf("=======================snapshot Test Begin============================\n");
+            err = snapshot_test(db);
+        }
+        g_repl->StopService();
+        if (err != 0) {
+            return -1;
+        }
+        printf("=======================snapshot Test End============================\n\n");
     }
     return 0;
 }